@@ -21,6 +21,16 @@
  * @file   rohc_gen_stream.c
  * @brief  Generate an (un)compressed stream for performance testing
  * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The stream is made of one or several concurrent IPv4 flows of RTP, UDP,
+ * TCP or ESP packets. The generator may end flows and start new ones while
+ * the stream goes (churn), interleave the flows in round-robin or randomly,
+ * pick random payload sizes, and lose or reorder packets of the output
+ * stream. All random choices are made by a seeded pseudo-random generator,
+ * so that the same options always generate the same stream.
+ *
+ * The generated stream is meant to be replayed by the benchmark mode of
+ * the rohc_test_performance application, that preloads it in memory.
  */
 
 #include "config.h" /* for HAVE_*_H and PACKAGE_BUGREPORT */
@@ -39,13 +49,17 @@
 #include <errno.h>
 #include <assert.h>
 #include <stdarg.h>
+#include <stdint.h>
 #include <limits.h>
 
 /* includes for network headers */
 #include <ip.h> /* for IPv4 checksum */
+#include <protocols/ip_numbers.h>
 #include <protocols/ipv4.h>
 #include <protocols/udp.h>
 #include <protocols/rtp.h>
+#include <protocols/tcp.h>
+#include <protocols/esp.h>
 
 /* include for the PCAP library */
 #if HAVE_PCAP_PCAP_H == 1
@@ -66,16 +80,82 @@ for ./configure ? If yes, check configure output and config.log"
 /** The length (in bytes) of the Ethernet header */
 #define ETHER_HDR_LEN  14
 
+/** The maximum length (in bytes) of the generated payloads */
+#define GEN_PAYLOAD_MAX_LEN  1400U
+
+/** The maximum length (in bytes) of the generated IP packets */
+#define GEN_PACKET_MAX_LEN \
+	(sizeof(struct ipv4_hdr) + sizeof(struct tcphdr) + GEN_PAYLOAD_MAX_LEN)
+
+/** The maximum number of concurrent flows */
+#define GEN_FLOWS_MAX  65536U
+
+
+/** The types of flows the generator may build */
+typedef enum
+{
+	GEN_FLOW_RTP = 0,  /**< IPv4/UDP/RTP flows */
+	GEN_FLOW_UDP = 1,  /**< IPv4/UDP flows */
+	GEN_FLOW_TCP = 2,  /**< IPv4/TCP flows */
+	GEN_FLOW_ESP = 3,  /**< IPv4/ESP flows */
+#define GEN_FLOW_TYPES_NR  4U
+} gen_flow_type_t;
+
+
+/** The configuration of the generated traffic */
+struct gen_config
+{
+	size_t flows_nr;                      /**< The number of concurrent flows */
+	unsigned int mix[GEN_FLOW_TYPES_NR];  /**< The weights of the flow types */
+	double churn;        /**< The probability that a packet starts a new flow */
+	bool is_random;      /**< Whether to interleave flows randomly or not */
+	size_t burst_len;    /**< The number of packets per flow in a row */
+	size_t payload_min;  /**< The minimum length of payloads */
+	size_t payload_max;  /**< The maximum length of payloads */
+	double loss;         /**< The probability that a packet is lost */
+	double reorder;      /**< The probability that a packet is delayed */
+	uint64_t seed;       /**< The seed of the pseudo-random generator */
+};
+
+
+/** One flow of the generated traffic */
+struct gen_flow
+{
+	gen_flow_type_t type;      /**< The type of the flow */
+	uint32_t id;               /**< The unique ID of the flow in the stream */
+	unsigned long packets_nr;  /**< The number of packets generated so far */
+	uint32_t tcp_seq;          /**< The next TCP sequence number */
+};
+
 
 /* prototypes of private functions */
 static void usage(void);
+static bool parse_mix(char *const mix_str, unsigned int mix[GEN_FLOW_TYPES_NR])
+	__attribute__((warn_unused_result, nonnull(2)));
+static bool parse_prob(const char *const prob_str, double *const prob)
+	__attribute__((warn_unused_result, nonnull(2)));
 static bool build_stream(const char *const filename,
                          const char *const stream_type,
                          const unsigned long max_packets,
                          const int use_large_cid,
                          const size_t wlsb_width,
-                         const size_t max_contexts)
-	__attribute__((warn_unused_result, nonnull(1, 2)));
+                         const size_t max_contexts,
+                         const struct gen_config *const config)
+	__attribute__((warn_unused_result, nonnull(1, 2, 7)));
+
+static void gen_flow_start(struct gen_flow *const flow,
+                           const uint32_t flow_id,
+                           const struct gen_config *const config)
+	__attribute__((nonnull(1, 3)));
+static size_t gen_build_packet(struct gen_flow *const flow,
+                               const size_t payload_len,
+                               uint8_t *const buffer)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
+static uint64_t gen_rand(void)
+	__attribute__((warn_unused_result));
+static double gen_rand_prob(void)
+	__attribute__((warn_unused_result));
 
 static void print_rohc_traces(void *const priv_ctxt,
                               const rohc_trace_level_t level,
@@ -100,6 +180,9 @@ static bool rohc_comp_rtp_cb(const unsigned char *const ip,
 /** Whether the application runs in verbose mode or not */
 static int is_verbose;
 
+/** The state of the pseudo-random generator */
+static uint64_t gen_rand_state;
+
 
 /**
  * @brief Main function for the ROHC test program
@@ -119,6 +202,18 @@ int main(int argc, char *argv[])
 	char *cid_type = NULL;
 	int max_contexts = ROHC_SMALL_CID_MAX + 1;
 	int wlsb_width = 4;
+	struct gen_config config = {
+		.flows_nr = 1,
+		.mix = { [GEN_FLOW_RTP] = 1 },
+		.churn = 0.0,
+		.is_random = false,
+		.burst_len = 1,
+		.payload_min = 20,
+		.payload_max = 20,
+		.loss = 0.0,
+		.reorder = 0.0,
+		.seed = 1,
+	};
 	int is_failure = 1;
 	int use_large_cid;
 	int args_used;
@@ -172,6 +267,125 @@ int main(int argc, char *argv[])
 			wlsb_width = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--flows"))
+		{
+			/* get the number of concurrent flows */
+			const int flows_nr = atoi(argv[1]);
+			if(flows_nr < 1 || (size_t) flows_nr > GEN_FLOWS_MAX)
+			{
+				fprintf(stderr, "the number of flows should be between 1 and %u\n",
+				        GEN_FLOWS_MAX);
+				goto error;
+			}
+			config.flows_nr = flows_nr;
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--mix"))
+		{
+			/* get the weights of the flow types */
+			if(!parse_mix(argv[1], config.mix))
+			{
+				fprintf(stderr, "invalid mix of flows '%s'\n", argv[1]);
+				goto error;
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--churn"))
+		{
+			/* get the probability that a packet starts a new flow */
+			if(!parse_prob(argv[1], &config.churn))
+			{
+				fprintf(stderr, "invalid churn rate, should be in range [0, 1]\n");
+				goto error;
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--interleave"))
+		{
+			/* get the way flows are interleaved */
+			if(argv[1] != NULL && !strcmp(argv[1], "rr"))
+			{
+				config.is_random = false;
+			}
+			else if(argv[1] != NULL && !strcmp(argv[1], "random"))
+			{
+				config.is_random = true;
+			}
+			else
+			{
+				fprintf(stderr, "invalid interleaving, only 'rr' and 'random' "
+				        "expected\n");
+				goto error;
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--burst"))
+		{
+			/* get the number of packets per flow in a row */
+			const int burst_len = atoi(argv[1]);
+			if(burst_len < 1)
+			{
+				fprintf(stderr, "the burst length shall be at least 1\n");
+				goto error;
+			}
+			config.burst_len = burst_len;
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--payload-size"))
+		{
+			/* get the range of payload lengths */
+			unsigned int payload_min;
+			unsigned int payload_max;
+			char trailing;
+			const int fields_nr = (argv[1] == NULL ? 0 :
+			                       sscanf(argv[1], "%u-%u%c", &payload_min,
+			                              &payload_max, &trailing));
+			if(fields_nr == 1)
+			{
+				payload_max = payload_min;
+			}
+			else if(fields_nr != 2)
+			{
+				fprintf(stderr, "invalid payload size, MIN or MIN-MAX expected\n");
+				goto error;
+			}
+			if(payload_min > payload_max || payload_max > GEN_PAYLOAD_MAX_LEN)
+			{
+				fprintf(stderr, "the payload size should be in range [0, %u] "
+				        "with MIN <= MAX\n", GEN_PAYLOAD_MAX_LEN);
+				goto error;
+			}
+			config.payload_min = payload_min;
+			config.payload_max = payload_max;
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--loss"))
+		{
+			/* get the probability that a packet is lost */
+			if(!parse_prob(argv[1], &config.loss))
+			{
+				fprintf(stderr, "invalid loss rate, should be in range [0, 1]\n");
+				goto error;
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--reorder"))
+		{
+			/* get the probability that a packet is delayed */
+			if(!parse_prob(argv[1], &config.reorder))
+			{
+				fprintf(stderr, "invalid reordering rate, should be in range "
+				        "[0, 1]\n");
+				goto error;
+			}
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--seed"))
+		{
+			/* get the seed of the pseudo-random generator */
+			config.seed = (argv[1] == NULL ? 0 : strtoull(argv[1], NULL, 0));
+			args_used++;
+		}
 		else if(stream_type == NULL)
 		{
 			/* get the type of the stream to perform */
@@ -273,7 +487,7 @@ int main(int argc, char *argv[])
 
 	/* test ROHC compression/decompression with the packets from the file */
 	if(!build_stream(filename, stream_type, max_packets,
-	                 use_large_cid, wlsb_width, max_contexts))
+	                 use_large_cid, wlsb_width, max_contexts, &config))
 	{
 		fprintf(stderr, "failed to build stream\n");
 		goto error;
@@ -294,8 +508,8 @@ static void usage(void)
 	printf("Generate an (un)compressed stream for performance testing\n"
 	       "\n"
 	       "Usage: rohc_gen_stream [General options]\n"
-	       "   or: rohc_gen_stream uncomp MAX OUTPUT\n"
-	       "   or: rohc_gen_stream [Compression options] comp MAX OUTPUT\n"
+	       "   or: rohc_gen_stream [Traffic options] uncomp MAX OUTPUT\n"
+	       "   or: rohc_gen_stream [Traffic options] [Compression options] comp MAX OUTPUT\n"
 	       "\n"
 	       "Options:\n"
 	       "General options:\n"
@@ -307,6 +521,31 @@ static void usage(void)
 	       "      --max-contexts NUM  The maximum number of ROHC contexts to\n"
 	       "                          simultaneously use during the test\n"
 	       "      --wlsb-width NUM    The width of the WLSB window to use\n"
+	       "Traffic options:\n"
+	       "      --flows NUM         The number of concurrent flows\n"
+	       "                          (default: 1)\n"
+	       "      --mix LIST          The weights of the flow types, as a\n"
+	       "                          list of TYPE:WEIGHT separated by commas\n"
+	       "                          with TYPE among 'rtp', 'udp', 'tcp' and\n"
+	       "                          'esp' (default: rtp:1)\n"
+	       "      --churn PROB        The probability that a packet ends its\n"
+	       "                          flow and starts a new one (default: 0)\n"
+	       "      --interleave MODE   Interleave flows in round-robin with\n"
+	       "                          'rr' or randomly with 'random'\n"
+	       "                          (default: rr)\n"
+	       "      --burst NUM         The number of packets of one flow in a\n"
+	       "                          row (default: 1)\n"
+	       "      --payload-size MIN[-MAX]\n"
+	       "                          The length of payloads, uniformly\n"
+	       "                          distributed in range [MIN, MAX]\n"
+	       "                          (default: 20)\n"
+	       "      --loss PROB         The probability that a packet of the\n"
+	       "                          output stream is lost (default: 0)\n"
+	       "      --reorder PROB      The probability that a packet of the\n"
+	       "                          output stream is swapped with the next\n"
+	       "                          one (default: 0)\n"
+	       "      --seed NUM          The seed of the pseudo-random generator\n"
+	       "                          (default: 1)\n"
 	       "Mandatory parameters:\n"
 	       "  MAX                     The number of packets to generate\n"
 	       "  OUTPUT                  The name of the output file with the\n"
@@ -318,20 +557,129 @@ static void usage(void)
 	       "  rohc_gen_stream comp 500 rohc.pcap    Generate 500 RTP packets,\n"
 	       "                                        compress them, then store\n"
 	       "                                        them in file rohc.pcap\n"
+	       "  rohc_gen_stream --flows 4096 --mix rtp:6,udp:2,tcp:1,esp:1 \\\n"
+	       "                  --interleave random --churn 0.001 \\\n"
+	       "                  --max-contexts 1024 comp 1000000 many.pcap\n"
+	       "                                        Generate 1M packets of 4096\n"
+	       "                                        mixed flows, compress them\n"
+	       "                                        with 1024 contexts, then\n"
+	       "                                        store them in many.pcap\n"
 	       "\n"
 	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n");
 }
 
 
+/**
+ * @brief Parse the weights of the flow types
+ *
+ * The weights are given as a list of TYPE:WEIGHT separated by commas, for
+ * example rtp:6,udp:2,tcp:1,esp:1. Types that are not listed get a weight
+ * of zero.
+ *
+ * @param mix_str  The string to parse, modified by the parsing
+ * @param mix      OUT: the weights of the flow types
+ * @return         true if the string is valid, false otherwise
+ */
+static bool parse_mix(char *const mix_str, unsigned int mix[GEN_FLOW_TYPES_NR])
+{
+	const char *const type_names[GEN_FLOW_TYPES_NR] = {
+		[GEN_FLOW_RTP] = "rtp",
+		[GEN_FLOW_UDP] = "udp",
+		[GEN_FLOW_TCP] = "tcp",
+		[GEN_FLOW_ESP] = "esp",
+	};
+	unsigned int total_weight = 0;
+	char *item;
+	size_t i;
+
+	if(mix_str == NULL)
+	{
+		goto error;
+	}
+
+	memset(mix, 0, sizeof(unsigned int) * GEN_FLOW_TYPES_NR);
+	for(item = strtok(mix_str, ","); item != NULL; item = strtok(NULL, ","))
+	{
+		char *const sep = strchr(item, ':');
+		char *weight_end;
+		unsigned long weight;
+
+		if(sep == NULL)
+		{
+			goto error;
+		}
+		*sep = '\0';
+		weight = strtoul(sep + 1, &weight_end, 10);
+		if(sep[1] == '\0' || (*weight_end) != '\0' || weight > 1000000)
+		{
+			goto error;
+		}
+
+		for(i = 0; i < GEN_FLOW_TYPES_NR; i++)
+		{
+			if(!strcmp(item, type_names[i]))
+			{
+				break;
+			}
+		}
+		if(i == GEN_FLOW_TYPES_NR)
+		{
+			goto error;
+		}
+		mix[i] = weight;
+	}
+
+	for(i = 0; i < GEN_FLOW_TYPES_NR; i++)
+	{
+		total_weight += mix[i];
+	}
+	if(total_weight == 0)
+	{
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Parse a probability
+ *
+ * @param prob_str  The string to parse
+ * @param prob      OUT: the probability, in range [0, 1]
+ * @return          true if the string is valid, false otherwise
+ */
+static bool parse_prob(const char *const prob_str, double *const prob)
+{
+	char *prob_end;
+
+	if(prob_str == NULL)
+	{
+		return false;
+	}
+	*prob = strtod(prob_str, &prob_end);
+
+	return (prob_end != prob_str && (*prob_end) == '\0' &&
+	        (*prob) >= 0.0 && (*prob) <= 1.0);
+}
+
+
 /**
  * @brief Build an (un)compressed stream
  *
+ * Packets are lost or reordered in the output stream, ie. after compression
+ * for compressed streams.
+ *
  * @param filename       The name of the PCAP file to output the stream
  * @param stream_type    The type of stream to generate: uncomp or comp
  * @param max_packets    The number of packets to generate
  * @param use_large_cid  Whether the compressor shall use large CIDs
  * @param max_contexts   The maximum number of ROHC contexts to use
  * @param wlsb_width     The width of the WLSB window to use
+ * @param config         The configuration of the generated traffic
  * @return               true in case of success,
  *                       false in case of failure
  */
@@ -340,7 +688,8 @@ static bool build_stream(const char *const filename,
                          const unsigned long max_packets,
                          const int use_large_cid,
                          const size_t wlsb_width,
-                         const size_t max_contexts)
+                         const size_t max_contexts,
+                         const struct gen_config *const config)
 {
 	const rohc_cid_type_t cid_type =
 		(use_large_cid ? ROHC_LARGE_CID : ROHC_SMALL_CID);
@@ -350,19 +699,47 @@ static bool build_stream(const char *const filename,
 	pcap_t *pcap;
 	pcap_dumper_t *dumper;
 
+	struct gen_flow *flows;
+	uint32_t next_flow_id;
+	size_t cur_flow;
+	size_t burst_left;
+
+	/* the packet delayed by reordering */
+	uint8_t held_buffer[ETHER_HDR_LEN + GEN_PACKET_MAX_LEN * 2];
+	size_t held_len = 0;
+
+	unsigned long lost_nr = 0;
+	unsigned long reordered_nr = 0;
 	unsigned long counter;
+	size_t i;
 
 	struct rohc_comp *comp = NULL;
 
 	printf("generate %lu %s packets in '%s'...\n", max_packets, stream_type,
 	       filename);
 
+	/* start all the flows */
+	gen_rand_state = config->seed;
+	flows = calloc(config->flows_nr, sizeof(struct gen_flow));
+	if(flows == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for %zu flows\n",
+		        config->flows_nr);
+		goto error;
+	}
+	for(next_flow_id = 0; next_flow_id < config->flows_nr; next_flow_id++)
+	{
+		gen_flow_start(&flows[next_flow_id], next_flow_id, config);
+	}
+	cur_flow = config->flows_nr - 1;
+	burst_left = 0;
+
 	/* create a PCAP context for output */
 	pcap = pcap_open_dead(DLT_EN10MB, 0 /* infinite snaplen */);
 	if(pcap == NULL)
 	{
 		fprintf(stderr, "failed to create a pcap context\n");
-		goto error;
+		goto free_flows;
 	}
 
 	/* open the PCAP dump file */
@@ -419,84 +796,59 @@ static bool build_stream(const char *const filename,
 	/* build the stream, and save it in the PCAP dump */
 	for(counter = 1; counter <= max_packets; counter++)
 	{
-		const size_t payload_len = 20;
-		const size_t packet_len = sizeof(struct ipv4_hdr) +
-		                          sizeof(struct udphdr) +
-		                          sizeof(struct rtphdr) +
-		                          payload_len;
-		uint8_t buffer[ETHER_HDR_LEN + packet_len];
+		uint8_t buffer[ETHER_HDR_LEN + GEN_PACKET_MAX_LEN];
 		struct rohc_buf packet =
-			rohc_buf_init_empty(buffer, ETHER_HDR_LEN + packet_len);
+			rohc_buf_init_empty(buffer, ETHER_HDR_LEN + GEN_PACKET_MAX_LEN);
 
-		const size_t rohc_max_len = packet_len * 2;
+		const size_t rohc_max_len = GEN_PACKET_MAX_LEN * 2;
 		uint8_t output[ETHER_HDR_LEN + rohc_max_len];
 		struct rohc_buf rohc_packet =
 			rohc_buf_init_empty(output, ETHER_HDR_LEN + rohc_max_len);
 
 		struct pcap_pkthdr header = { .ts = { .tv_sec = 0, .tv_usec = 0 } };
-		struct ipv4_hdr *ipv4;
-		struct udphdr *udp;
-		struct rtphdr *rtp;
-		size_t i;
+		struct rohc_buf *out_packet;
+		size_t payload_len;
 
-		/* skip the Ethernet header, it will be written later */
+		/* select the flow of the packet */
+		if(burst_left == 0)
+		{
+			if(config->is_random)
+			{
+				cur_flow = gen_rand() % config->flows_nr;
+			}
+			else
+			{
+				cur_flow = (cur_flow + 1) % config->flows_nr;
+			}
+			burst_left = config->burst_len;
+		}
+		burst_left--;
+
+		/* end the flow and start a new one in case of churn */
+		if(config->churn > 0.0 && gen_rand_prob() < config->churn)
+		{
+			gen_flow_start(&flows[cur_flow], next_flow_id, config);
+			next_flow_id++;
+		}
+
+		/* build the IP packet of the flow after the Ethernet header */
+		payload_len = config->payload_min;
+		if(config->payload_max > config->payload_min)
+		{
+			payload_len +=
+				gen_rand() % (config->payload_max - config->payload_min + 1);
+		}
 		packet.len += ETHER_HDR_LEN;
 		rohc_buf_pull(&packet, ETHER_HDR_LEN);
-		rohc_packet.len += ETHER_HDR_LEN;
-		rohc_buf_pull(&rohc_packet, ETHER_HDR_LEN);
-
-		/* build IPv4 header */
-		packet.len += sizeof(struct ipv4_hdr);
-		ipv4 = (struct ipv4_hdr *) rohc_buf_data(packet);
-		ipv4->version = 4;
-		ipv4->ihl = 5;
-		ipv4->tos = 0;
-		ipv4->tot_len = htons(packet.len);
-		ipv4->id = htons(42 + counter);
-		ipv4->frag_off = 0;
-		ipv4->ttl = 64;
-		ipv4->protocol = IPPROTO_UDP;
-		ipv4->check = 0;
-		ipv4->saddr = htonl(0xc0a80001);
-		ipv4->daddr = htonl(0xc0a80002);
-		ipv4->check = ip_fast_csum((uint8_t *) ipv4, ipv4->ihl);
-		rohc_buf_pull(&packet, sizeof(struct ipv4_hdr));
-
-		/* build UDP header */
-		packet.len += sizeof(struct udphdr);
-		udp = (struct udphdr *) rohc_buf_data(packet);
-		udp->source = htons(1234);
-		udp->dest = htons(1234);
-		udp->len = htons(packet.len);
-		udp->check = 0; /* UDP checksum disabled */
-		rohc_buf_pull(&packet, sizeof(struct udphdr));
-
-		/* build RTP header */
-		packet.len += sizeof(struct rtphdr);
-		rtp = (struct rtphdr *) rohc_buf_data(packet);
-		rtp->version = 2;
-		rtp->padding = 0;
-		rtp->extension = 0;
-		rtp->cc = 0;
-		rtp->m = 0;
-		rtp->pt = 0x72; /* speex */
-		rtp->sn = htons(counter);
-		rtp->timestamp = htonl(500000 + counter * 160);
-		rtp->ssrc = htonl(0x42424242);
-		rohc_buf_pull(&packet, sizeof(struct rtphdr));
-
-		/* build RTP payload */
-		for(i = 0; i < payload_len; i++)
-		{
-			rohc_buf_byte_at(packet, i) = i % 0xff;
-		}
-		packet.len += payload_len;
-		rohc_buf_pull(&packet, payload_len);
-
-		rohc_buf_push(&packet, packet_len);
+		packet.len = gen_build_packet(&flows[cur_flow], payload_len,
+		                              rohc_buf_data(packet));
 
 		if(strcmp(stream_type, "comp") == 0)
 		{
+			/* skip the Ethernet header, it will be written later */
+			rohc_packet.len += ETHER_HDR_LEN;
+			rohc_buf_pull(&rohc_packet, ETHER_HDR_LEN);
+
 			/* compress packet */
 			status = rohc_compress4(comp, packet, &rohc_packet);
 			if(status != ROHC_STATUS_OK)
@@ -512,11 +864,7 @@ static bool build_stream(const char *const filename,
 				ROHC_ETHERTYPE & 0xff;
 			rohc_buf_byte_at(rohc_packet, ETHER_HDR_LEN - 1) =
 				(ROHC_ETHERTYPE >> 8) & 0xff;
-
-			/* write the packet in the PCAP dump */
-			header.caplen = rohc_packet.len;
-			header.len = rohc_packet.len;
-			pcap_dump((u_char *) dumper, &header, rohc_buf_data(rohc_packet));
+			out_packet = &rohc_packet;
 		}
 		else
 		{
@@ -525,12 +873,64 @@ static bool build_stream(const char *const filename,
 			memset(rohc_buf_data(packet), 0, ETHER_HDR_LEN);
 			rohc_buf_byte_at(packet, ETHER_HDR_LEN - 2) = 0x80;
 			rohc_buf_byte_at(packet, ETHER_HDR_LEN - 1) = 0x00;
+			out_packet = &packet;
+		}
 
-			/* write the packet in the PCAP dump */
-			header.caplen = packet.len;
-			header.len = packet.len;
-			pcap_dump((u_char *) dumper, &header, rohc_buf_data(packet));
+		/* lose the packet? */
+		if(config->loss > 0.0 && gen_rand_prob() < config->loss)
+		{
+			lost_nr++;
+			continue;
+		}
+
+		/* delay the packet after the next one? */
+		if(held_len == 0 && config->reorder > 0.0 &&
+		   gen_rand_prob() < config->reorder)
+		{
+			assert(out_packet->len <= sizeof(held_buffer));
+			memcpy(held_buffer, rohc_buf_data(*out_packet), out_packet->len);
+			held_len = out_packet->len;
+			reordered_nr++;
+			continue;
+		}
+
+		/* write the packet in the PCAP dump */
+		header.caplen = out_packet->len;
+		header.len = out_packet->len;
+		pcap_dump((u_char *) dumper, &header, rohc_buf_data(*out_packet));
+
+		/* write the delayed packet after it */
+		if(held_len > 0)
+		{
+			header.caplen = held_len;
+			header.len = held_len;
+			pcap_dump((u_char *) dumper, &header, held_buffer);
+			held_len = 0;
+		}
+	}
+
+	/* write the delayed packet if no packet followed it */
+	if(held_len > 0)
+	{
+		struct pcap_pkthdr header = { .ts = { .tv_sec = 0, .tv_usec = 0 } };
+		header.caplen = held_len;
+		header.len = held_len;
+		pcap_dump((u_char *) dumper, &header, held_buffer);
+	}
+
+	if(config->flows_nr > 1 || next_flow_id > config->flows_nr ||
+	   lost_nr > 0 || reordered_nr > 0)
+	{
+		unsigned long flows_per_type[GEN_FLOW_TYPES_NR] = { 0 };
+		for(i = 0; i < config->flows_nr; i++)
+		{
+			flows_per_type[flows[i].type]++;
 		}
+		printf("%u flows started (%lu RTP, %lu UDP, %lu TCP and %lu ESP flows "
+		       "at the end), %lu packets lost, %lu packets reordered\n",
+		       next_flow_id, flows_per_type[GEN_FLOW_RTP],
+		       flows_per_type[GEN_FLOW_UDP], flows_per_type[GEN_FLOW_TCP],
+		       flows_per_type[GEN_FLOW_ESP], lost_nr, reordered_nr);
 	}
 
 	is_success = true;
@@ -544,11 +944,226 @@ close_dumper:
 	pcap_dump_close(dumper);
 close_pcap:
 	pcap_close(pcap);
+free_flows:
+	free(flows);
 error:
 	return is_success;
 }
 
 
+/**
+ * @brief Start a new flow
+ *
+ * The type of the flow is randomly chosen according to the weights of the
+ * flow types. The addresses, ports, SSRC and SPI of the flow are derived
+ * from its unique ID, so that every new flow requires a new ROHC context.
+ *
+ * @param flow     The flow to start
+ * @param flow_id  The unique ID of the flow in the stream
+ * @param config   The configuration of the generated traffic
+ */
+static void gen_flow_start(struct gen_flow *const flow,
+                           const uint32_t flow_id,
+                           const struct gen_config *const config)
+{
+	unsigned int total_weight = 0;
+	unsigned int weight;
+	size_t type;
+
+	for(type = 0; type < GEN_FLOW_TYPES_NR; type++)
+	{
+		total_weight += config->mix[type];
+	}
+	assert(total_weight > 0);
+
+	/* do not draw a random number if only one type of flow is possible */
+	weight = 0;
+	for(type = 0; type < GEN_FLOW_TYPES_NR; type++)
+	{
+		if(config->mix[type] == total_weight)
+		{
+			break;
+		}
+	}
+	if(type == GEN_FLOW_TYPES_NR)
+	{
+		weight = gen_rand() % total_weight;
+		for(type = 0; weight >= config->mix[type]; type++)
+		{
+			weight -= config->mix[type];
+		}
+	}
+	assert(type < GEN_FLOW_TYPES_NR);
+
+	flow->type = type;
+	flow->id = flow_id;
+	flow->packets_nr = 0;
+	flow->tcp_seq = 0x10000000 + flow_id;
+}
+
+
+/**
+ * @brief Build the next IP packet of the given flow
+ *
+ * @param flow         The flow to build the packet for
+ * @param payload_len  The length of the payload of the packet
+ * @param buffer       OUT: the IP packet
+ * @return             The length of the IP packet
+ */
+static size_t gen_build_packet(struct gen_flow *const flow,
+                               const size_t payload_len,
+                               uint8_t *const buffer)
+{
+	struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) buffer;
+	uint8_t *const next_hdr = buffer + sizeof(struct ipv4_hdr);
+	size_t hdrs_len;
+	uint8_t *payload;
+	size_t i;
+
+	assert(payload_len <= GEN_PAYLOAD_MAX_LEN);
+	flow->packets_nr++;
+
+	switch(flow->type)
+	{
+		case GEN_FLOW_RTP:
+		{
+			struct udphdr *const udp = (struct udphdr *) next_hdr;
+			struct rtphdr *const rtp = (struct rtphdr *) (udp + 1);
+
+			hdrs_len = sizeof(struct udphdr) + sizeof(struct rtphdr);
+
+			/* build UDP header */
+			udp->source = htons(1234 + flow->id);
+			udp->dest = htons(1234);
+			udp->len = htons(hdrs_len + payload_len);
+			udp->check = 0; /* UDP checksum disabled */
+
+			/* build RTP header */
+			rtp->version = 2;
+			rtp->padding = 0;
+			rtp->extension = 0;
+			rtp->cc = 0;
+			rtp->m = 0;
+			rtp->pt = 0x72; /* speex */
+			rtp->sn = htons(flow->packets_nr);
+			rtp->timestamp = htonl(500000 + flow->packets_nr * 160);
+			rtp->ssrc = htonl(0x42424242 + flow->id);
+
+			ipv4->protocol = ROHC_IPPROTO_UDP;
+			break;
+		}
+		case GEN_FLOW_UDP:
+		{
+			struct udphdr *const udp = (struct udphdr *) next_hdr;
+
+			hdrs_len = sizeof(struct udphdr);
+
+			/* build UDP header, not on the RTP port */
+			udp->source = htons(10000 + flow->id);
+			udp->dest = htons(2000);
+			udp->len = htons(hdrs_len + payload_len);
+			udp->check = 0; /* UDP checksum disabled */
+
+			ipv4->protocol = ROHC_IPPROTO_UDP;
+			break;
+		}
+		case GEN_FLOW_TCP:
+		{
+			struct tcphdr *const tcp = (struct tcphdr *) next_hdr;
+
+			hdrs_len = sizeof(struct tcphdr);
+
+			/* build TCP header of an established connection */
+			memset(tcp, 0, sizeof(struct tcphdr));
+			tcp->src_port = htons(10000 + flow->id);
+			tcp->dst_port = htons(80);
+			tcp->seq_num = htonl(flow->tcp_seq);
+			tcp->ack_num = htonl(0x20000000 + flow->id);
+			tcp->data_offset = sizeof(struct tcphdr) / sizeof(uint32_t);
+			tcp->ack_flag = 1;
+			tcp->psh_flag = (payload_len > 0);
+			tcp->window = htons(0xffff);
+			tcp->checksum = 0;
+			flow->tcp_seq += payload_len;
+
+			ipv4->protocol = ROHC_IPPROTO_TCP;
+			break;
+		}
+		case GEN_FLOW_ESP:
+		default:
+		{
+			struct esphdr *const esp = (struct esphdr *) next_hdr;
+
+			assert(flow->type == GEN_FLOW_ESP);
+			hdrs_len = sizeof(struct esphdr);
+
+			/* build ESP header */
+			esp->spi = htonl(0x1000 + flow->id);
+			esp->sn = htonl(flow->packets_nr);
+
+			ipv4->protocol = ROHC_IPPROTO_ESP;
+			break;
+		}
+	}
+
+	/* build payload */
+	payload = next_hdr + hdrs_len;
+	for(i = 0; i < payload_len; i++)
+	{
+		payload[i] = i % 0xff;
+	}
+
+	/* build IPv4 header */
+	ipv4->version = 4;
+	ipv4->ihl = 5;
+	ipv4->tos = 0;
+	ipv4->tot_len = htons(sizeof(struct ipv4_hdr) + hdrs_len + payload_len);
+	ipv4->id = htons(42 + flow->packets_nr);
+	ipv4->frag_off = 0;
+	ipv4->ttl = 64;
+	ipv4->check = 0;
+	ipv4->saddr = htonl(0xc0a80001 + (flow->id << 8));
+	ipv4->daddr = htonl(0xc0a80002 + (flow->id << 8));
+	ipv4->check = ip_fast_csum((uint8_t *) ipv4, ipv4->ihl);
+
+	return sizeof(struct ipv4_hdr) + hdrs_len + payload_len;
+}
+
+
+/**
+ * @brief Get the next pseudo-random number
+ *
+ * The xorshift64* generator is fast and gives the same numbers on all
+ * platforms for a given seed.
+ *
+ * @return  The next pseudo-random number
+ */
+static uint64_t gen_rand(void)
+{
+	/* a zero state would give zero forever */
+	if(gen_rand_state == 0)
+	{
+		gen_rand_state = 0x9e3779b97f4a7c15ULL;
+	}
+	gen_rand_state ^= gen_rand_state >> 12;
+	gen_rand_state ^= gen_rand_state << 25;
+	gen_rand_state ^= gen_rand_state >> 27;
+
+	return gen_rand_state * 0x2545f4914f6cdd1dULL;
+}
+
+
+/**
+ * @brief Get the next pseudo-random probability
+ *
+ * @return  The next pseudo-random probability, in range [0, 1[
+ */
+static double gen_rand_prob(void)
+{
+	return (gen_rand() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
 /**
  * @brief Callback to print traces of the ROHC library
  *
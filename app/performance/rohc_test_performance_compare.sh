@@ -0,0 +1,206 @@
+#!/bin/sh
+#
+# Copyright 2016 Didier Barvaux
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#
+#
+# Benchmark the compression and the decompression of the non-regression
+# captures, then either save the packet rates as a baseline or compare them
+# with a baseline saved before on the same machine.
+#
+# The compression is benchmarked with the source.pcap captures and the
+# decompression with the rohc_maxcontexts0_wlsb4_smallcid.pcap captures of
+# the same directories. The captures that the library cannot (de)compress
+# without error, like the malformed ones, are skipped.
+#
+
+TEST_BIN="${ROHC_TEST_PERFORMANCE:-$( dirname "$0" )/rohc_test_performance}"
+CAPTURES_DIR="$( dirname "$0" )/../../test/non_regression"
+THRESHOLD=10
+REPEAT=200
+
+usage()
+{
+	echo "Benchmark the non-regression captures and compare the packet rates"
+	echo "with a baseline."
+	echo
+	echo "usage: rohc_test_performance_compare.sh [options] save|check BASELINE"
+	echo
+	echo "  save              Benchmark the captures and save the results"
+	echo "                    in the BASELINE CSV file"
+	echo "  check             Benchmark the captures and fail if the packet"
+	echo "                    rate of one capture is lower than in the"
+	echo "                    BASELINE CSV file by more than the threshold"
+	echo
+	echo "options:"
+	echo "  --threshold PCT   The tolerated throughput regression in percents"
+	echo "                    (default: ${THRESHOLD})"
+	echo "  --repeat NUM      The number of timed replays of every capture"
+	echo "                    (default: ${REPEAT})"
+	echo "  --captures DIR    The directory of the non-regression captures"
+	echo "                    (default: ${CAPTURES_DIR})"
+	echo
+	echo "The ROHC_TEST_PERFORMANCE environment variable overrides the path"
+	echo "to the rohc_test_performance program (default: ${TEST_BIN})."
+}
+
+# benchmark all the captures and write the results in the given CSV file
+run_benchmarks()
+{
+	output="$1"
+	has_header=0
+
+	: > "${output}" || return 1
+	for source in $( cd "${CAPTURES_DIR}" && find . -name source.pcap | sort ) ; do
+		dir="$( dirname "${source}" )"
+		for action in comp decomp ; do
+			if [ "${action}" = "comp" ] ; then
+				capture="${source}"
+			else
+				capture="${dir}/rohc_maxcontexts0_wlsb4_smallcid.pcap"
+				[ -f "${CAPTURES_DIR}/${capture}" ] || continue
+			fi
+			results="$( cd "${CAPTURES_DIR}" && \
+			            "${test_bin}" --bench --repeat ${REPEAT} \
+			                          --output-format csv \
+			                          ${action} smallcid "${capture}" 2>/dev/null )"
+			if [ $? -ne 0 ] ; then
+				echo "skip ${action} ${capture}: benchmark failed" >&2
+				continue
+			fi
+			if [ ${has_header} -eq 0 ] ; then
+				echo "${results}" | sed -n '1p' >> "${output}"
+				has_header=1
+			fi
+			echo "${results}" | sed -n '2p' >> "${output}"
+		done
+	done
+
+	if [ ${has_header} -eq 0 ] ; then
+		echo "no capture was benchmarked successfully" >&2
+		return 1
+	fi
+	return 0
+}
+
+
+while [ $# -gt 0 ] ; do
+	case "$1" in
+		--threshold)
+			THRESHOLD="$2"
+			shift 2
+			;;
+		--repeat)
+			REPEAT="$2"
+			shift 2
+			;;
+		--captures)
+			CAPTURES_DIR="$2"
+			shift 2
+			;;
+		-h|--help)
+			usage
+			exit 0
+			;;
+		*)
+			break
+			;;
+	esac
+done
+
+mode="$1"
+baseline="$2"
+if [ -z "${mode}" ] || [ -z "${baseline}" ] || [ $# -ne 2 ] ; then
+	usage >&2
+	exit 1
+fi
+if [ "${mode}" != "save" ] && [ "${mode}" != "check" ] ; then
+	usage >&2
+	exit 1
+fi
+if [ ! -x "${TEST_BIN}" ] ; then
+	echo "${TEST_BIN} executable not found" >&2
+	exit 1
+fi
+if [ ! -d "${CAPTURES_DIR}" ] ; then
+	echo "${CAPTURES_DIR} captures directory not found" >&2
+	exit 1
+fi
+
+# the benchmarks are run from the captures directory, so that the results
+# name the captures with the same relative paths on all machines
+test_bin="$( cd "$( dirname "${TEST_BIN}" )" && pwd )/$( basename "${TEST_BIN}" )"
+
+if [ "${mode}" = "save" ] ; then
+	run_benchmarks "${baseline}" || exit 1
+	echo "baseline saved in ${baseline}"
+	exit 0
+fi
+
+if [ ! -r "${baseline}" ] ; then
+	echo "${baseline} baseline file not readable" >&2
+	exit 1
+fi
+current="$( mktemp )" || exit 1
+trap 'rm -f "${current}"' EXIT
+run_benchmarks "${current}" || exit 1
+
+# compare the packet rates of the captures found in the baseline, the
+# columns are found by their names in the CSV headers
+awk -F, -v threshold="${THRESHOLD}" '
+	FNR == 1 {
+		for(i = 1; i <= NF; i++) {
+			if(NR == 1) { bcol[$i] = i } else { ccol[$i] = i }
+		}
+		next
+	}
+	NR == FNR {
+		key = $bcol["action"] " " $bcol["capture"]
+		keys[nr++] = key
+		base[key] = $bcol["packets_per_sec"]
+		next
+	}
+	{
+		cur[$ccol["action"] " " $ccol["capture"]] = $ccol["packets_per_sec"]
+	}
+	END {
+		failed = 0
+		for(i = 0; i < nr; i++) {
+			key = keys[i]
+			if(!(key in cur)) {
+				printf("FAIL %s: not benchmarked any more\n", key)
+				failed = 1
+				continue
+			}
+			delta = (base[key] > 0 ? (cur[key] - base[key]) * 100.0 / base[key] : 0)
+			if(delta < -threshold) {
+				status = "FAIL"
+				failed = 1
+			} else {
+				status = "ok  "
+			}
+			printf("%s %s: %.0f -> %.0f packets/s (%+.1f%%)\n", status, key,
+			       base[key], cur[key], delta)
+		}
+		exit failed
+	}
+' "${baseline}" "${current}"
+if [ $? -ne 0 ] ; then
+	echo "throughput regressed by more than ${THRESHOLD}% for some captures" >&2
+	exit 1
+fi
+echo "no throughput regression above ${THRESHOLD}%"
+exit 0
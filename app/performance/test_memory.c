@@ -0,0 +1,998 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_memory.c
+ * @brief   Measure the memory footprint of the ROHC contexts
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * Introduction
+ * ------------
+ *
+ * The program measures how much memory the ROHC compressor and the ROHC
+ * decompressor use per context, for every profile and for an increasing
+ * number of contexts. It helps to size the hardware for a given number of
+ * flows.
+ *
+ * Details
+ * -------
+ *
+ * For every profile and every number of contexts N (1, 4, 16... up to the
+ * maximum number of contexts), the program:
+ *  - generates N IPv4 flows of the profile, with a few packets per flow,
+ *  - compresses them with a new compressor that only enables the profile,
+ *  - decompresses them with a new decompressor.
+ *
+ * Output
+ * ------
+ *
+ * The program prints one line per profile and per number of contexts:
+ *  - the heap memory of the empty compressor and decompressor,
+ *  - the heap memory per context, that is the context tables plus the
+ *    profile-specific blocks,
+ *  - the slab memory per context, that is the profile-specific blocks only:
+ *    the profile contexts, their W-LSB windows and their list tables,
+ *  - the resident set size of the process once the contexts are created.
+ *
+ * The slab memory is accounted with allocation callbacks given to the
+ * library. The heap memory is accounted with mallinfo2() and is not
+ * available on platforms without it. Running the program with different
+ * W-LSB widths shows the part of the W-LSB windows in the slab memory.
+ */
+
+#include "config.h" /* for HAVE_*_H and PACKAGE_BUGREPORT */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if HAVE_WINSOCK2_H == 1
+#  include <winsock2.h> /* for htons() on Windows */
+#endif
+#if HAVE_ARPA_INET_H == 1
+#  include <arpa/inet.h> /* for htons() on Linux */
+#endif
+#include <unistd.h>
+#include <assert.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <inttypes.h>
+#if HAVE_MALLOC_H == 1
+#  include <malloc.h> /* for mallinfo2() and malloc_trim() */
+#endif
+
+/* includes for network headers */
+#include <ip.h> /* for IPv4 checksum */
+#include <protocols/ip_numbers.h>
+#include <protocols/ipv4.h>
+#include <protocols/udp.h>
+#include <protocols/rtp.h>
+#include <protocols/tcp.h>
+#include <protocols/esp.h>
+
+/* ROHC includes */
+#include <rohc/rohc.h>
+#include <rohc/rohc_comp.h>
+#include <rohc/rohc_decomp.h>
+
+
+/** The default maximum number of contexts to measure */
+#define MEM_CONTEXTS_DEFAULT  16384U
+
+/** The default number of packets per flow */
+#define MEM_PACKETS_DEFAULT  3U
+
+/** The maximum length (in bytes) of the generated IP packets */
+#define MEM_IP_MAX_LEN  128U
+
+/** The maximum length (in bytes) of the ROHC packets */
+#define MEM_ROHC_MAX_LEN  (MEM_IP_MAX_LEN + 64U)
+
+/** The length (in bytes) of the payload of the generated packets */
+#define MEM_PAYLOAD_LEN  20U
+
+
+/** The profiles the program may measure */
+struct mem_profile
+{
+	const char *name;         /**< The name of the profile on the command line */
+	rohc_profile_t id;        /**< The ID of the profile */
+	uint8_t protocol;         /**< The IPv4 protocol of the generated packets */
+	bool is_rtp;              /**< Whether to generate RTP packets */
+};
+
+/** The measures of one (de)compressor */
+struct mem_measure
+{
+	size_t contexts_nr;    /**< The number of created contexts */
+	long instance_bytes;   /**< The heap of the empty (de)compressor, -1 if unknown */
+	long ctxts_bytes;      /**< The heap of all the contexts, -1 if unknown */
+	size_t slab_bytes;     /**< The slab memory of all the contexts */
+	long rss_kib;          /**< The RSS of the process, -1 if unknown */
+};
+
+/** The stored ROHC packets of one measure */
+struct mem_packets
+{
+	uint8_t *data;   /**< The ROHC packets, MEM_ROHC_MAX_LEN bytes per packet */
+	size_t *lens;    /**< The lengths of the ROHC packets */
+	size_t max;      /**< The maximum number of ROHC packets */
+	size_t nr;       /**< The number of ROHC packets */
+};
+
+
+static void usage(void);
+
+static bool measure_profile(const struct mem_profile *const profile,
+                            const size_t contexts_nr,
+                            const size_t packets_nr,
+                            const size_t wlsb_width,
+                            struct mem_packets *const packets,
+                            struct mem_measure *const comp_measure,
+                            struct mem_measure *const decomp_measure)
+	__attribute__((warn_unused_result, nonnull(1, 5, 6, 7)));
+static size_t build_packet(const struct mem_profile *const profile,
+                           const uint32_t flow_id,
+                           const uint32_t sn,
+                           uint8_t *const buffer)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+static void print_measure(const bool is_csv,
+                          const struct mem_profile *const profile,
+                          const size_t contexts_nr,
+                          const size_t wlsb_width,
+                          const char *const entity,
+                          const struct mem_measure *const measure)
+	__attribute__((nonnull(2, 5, 6)));
+
+static long mem_get_heap(void)
+	__attribute__((warn_unused_result));
+static long mem_get_rss(void)
+	__attribute__((warn_unused_result));
+static void mem_release_heap(void);
+static uint64_t mem_get_avail(void)
+	__attribute__((warn_unused_result));
+static uint64_t mem_measure_get_ctxt_bytes(const struct mem_measure *const measure)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static void * mem_alloc_cb(const size_t size, void *const priv)
+	__attribute__((warn_unused_result));
+static void mem_free_cb(void *const ptr, void *const priv);
+
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static int gen_false_random_num(const struct rohc_comp *const comp,
+                                void *const user_context)
+	__attribute__((nonnull(1)));
+static bool rohc_comp_rtp_cb(const unsigned char *const ip,
+                             const unsigned char *const udp,
+                             const unsigned char *const payload,
+                             const unsigned int payload_size,
+                             void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+
+/** The profiles the program may measure */
+static const struct mem_profile mem_profiles[] = {
+	{ "ip",      ROHC_PROFILE_IP,      ROHC_IPPROTO_RESERVED1, false },
+	{ "udp",     ROHC_PROFILE_UDP,     ROHC_IPPROTO_UDP,       false },
+	{ "rtp",     ROHC_PROFILE_RTP,     ROHC_IPPROTO_UDP,       true  },
+	{ "esp",     ROHC_PROFILE_ESP,     ROHC_IPPROTO_ESP,       false },
+	{ "tcp",     ROHC_PROFILE_TCP,     ROHC_IPPROTO_TCP,       false },
+	{ "udplite", ROHC_PROFILE_UDPLITE, ROHC_IPPROTO_UDPLITE,   false },
+};
+
+/** The number of profiles the program may measure */
+#define MEM_PROFILES_NR  (sizeof(mem_profiles) / sizeof(struct mem_profile))
+
+/** Whether the application runs in verbose mode or not */
+static bool is_verbose = false;
+
+
+/**
+ * @brief Main function for the ROHC memory test program
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code: 0 in case of success, 1 in case of error
+ */
+int main(int argc, char *argv[])
+{
+	bool profiles_enabled[MEM_PROFILES_NR] = { false };
+	bool is_profile_given = false;
+	int max_contexts = MEM_CONTEXTS_DEFAULT;
+	int packets_nr = MEM_PACKETS_DEFAULT;
+	int wlsb_width = 4;
+	bool is_csv = false;
+	struct mem_packets packets;
+	size_t i;
+	int status = 1;
+
+	/* parse program arguments, print the help message in case of failure */
+	for(argc--, argv++; argc > 0; argc--, argv++)
+	{
+		if(!strcmp(*argv, "-v") || !strcmp(*argv, "--version"))
+		{
+			/* print version */
+			printf("rohc_test_memory version %s\n", rohc_version());
+			goto error;
+		}
+		else if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			/* print help */
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "--verbose"))
+		{
+			/* enable verbose mode */
+			is_verbose = true;
+		}
+		else if(!strcmp(*argv, "--csv"))
+		{
+			/* print the results in CSV */
+			is_csv = true;
+		}
+		else if(argc > 1 && !strcmp(*argv, "--max-contexts"))
+		{
+			/* get the maximum number of contexts to measure */
+			max_contexts = atoi(argv[1]);
+			argv++;
+			argc--;
+		}
+		else if(argc > 1 && !strcmp(*argv, "--packets"))
+		{
+			/* get the number of packets per flow */
+			packets_nr = atoi(argv[1]);
+			argv++;
+			argc--;
+		}
+		else if(argc > 1 && !strcmp(*argv, "--wlsb-width"))
+		{
+			/* get the width of the WLSB window */
+			wlsb_width = atoi(argv[1]);
+			argv++;
+			argc--;
+		}
+		else if(argc > 1 && !strcmp(*argv, "--profile"))
+		{
+			/* get one profile to measure */
+			for(i = 0; i < MEM_PROFILES_NR &&
+			    strcmp(argv[1], mem_profiles[i].name) != 0; i++)
+			{
+			}
+			if(i == MEM_PROFILES_NR)
+			{
+				fprintf(stderr, "unknown profile '%s'\n", argv[1]);
+				usage();
+				goto error;
+			}
+			profiles_enabled[i] = true;
+			is_profile_given = true;
+			argv++;
+			argc--;
+		}
+		else
+		{
+			usage();
+			goto error;
+		}
+	}
+
+	/* check parameters */
+	if(max_contexts < 1 || (size_t) max_contexts > (ROHC_LARGE_CID_MAX + 1))
+	{
+		fprintf(stderr, "the maximum number of contexts should be between 1 "
+		        "and %u\n", ROHC_LARGE_CID_MAX + 1);
+		goto error;
+	}
+	if(packets_nr < 1 || packets_nr > 0xffff)
+	{
+		fprintf(stderr, "the number of packets per flow should be between 1 "
+		        "and %u\n", 0xffff);
+		goto error;
+	}
+	if(wlsb_width <= 0 || (wlsb_width & (wlsb_width - 1)) != 0)
+	{
+		fprintf(stderr, "invalid WLSB width %d: should be a positive power of "
+		        "two\n", wlsb_width);
+		goto error;
+	}
+	if(!is_profile_given)
+	{
+		for(i = 0; i < MEM_PROFILES_NR; i++)
+		{
+			profiles_enabled[i] = true;
+		}
+	}
+#if HAVE_MALLINFO2 != 1
+	fprintf(stderr, "heap memory is not available on this platform, only the "
+	        "slab memory is measured\n");
+#endif
+
+	/* allocate the storage of the ROHC packets once for all, so that it does
+	 * not disturb the measures */
+	packets.max = ((size_t) max_contexts) * packets_nr;
+	packets.nr = 0;
+	packets.data = malloc(packets.max * MEM_ROHC_MAX_LEN);
+	packets.lens = malloc(packets.max * sizeof(size_t));
+	if(packets.data == NULL || packets.lens == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for %zu packets\n",
+		        packets.max);
+		goto free_packets;
+	}
+
+	if(is_csv)
+	{
+		printf("profile,contexts,wlsb_width,entity,contexts_created,"
+		       "instance_bytes,bytes_per_context,slab_bytes_per_context,"
+		       "rss_kib\n");
+	}
+	else
+	{
+		printf("%-8s %8s %-6s %14s %14s %14s %10s\n", "profile", "contexts",
+		       "entity", "instance (B)", "heap/ctxt (B)", "slab/ctxt (B)",
+		       "RSS (KiB)");
+	}
+
+	for(i = 0; i < MEM_PROFILES_NR; i++)
+	{
+		uint64_t ctxt_max_bytes = 0;
+		size_t contexts_nr;
+
+		if(!profiles_enabled[i])
+		{
+			continue;
+		}
+
+		/* 1, 4, 16... contexts, then the maximum number of contexts */
+		for(contexts_nr = 1; ; contexts_nr *= 4)
+		{
+			struct mem_measure comp_measure;
+			struct mem_measure decomp_measure;
+			const uint64_t avail_bytes = mem_get_avail();
+
+			if(contexts_nr > (size_t) max_contexts)
+			{
+				contexts_nr = max_contexts;
+			}
+
+			/* do not run out of memory: extrapolate the memory of the next
+			 * measure from the previous one */
+			if(contexts_nr > 1 && avail_bytes > 0 &&
+			   ctxt_max_bytes * contexts_nr > avail_bytes / 10 * 8)
+			{
+				fprintf(stderr, "profile %s: stop before %zu contexts, they "
+				        "would need about %" PRIu64 " MiB of memory but only "
+				        "%" PRIu64 " MiB are available\n", mem_profiles[i].name,
+				        contexts_nr, ctxt_max_bytes * contexts_nr / 1048576U,
+				        avail_bytes / 1048576U);
+				break;
+			}
+
+			if(!measure_profile(&mem_profiles[i], contexts_nr, packets_nr,
+			                    wlsb_width, &packets, &comp_measure,
+			                    &decomp_measure))
+			{
+				fprintf(stderr, "failed to measure profile %s with %zu "
+				        "contexts\n", mem_profiles[i].name, contexts_nr);
+				goto free_packets;
+			}
+			print_measure(is_csv, &mem_profiles[i], contexts_nr, wlsb_width,
+			              "comp", &comp_measure);
+			print_measure(is_csv, &mem_profiles[i], contexts_nr, wlsb_width,
+			              "decomp", &decomp_measure);
+			ctxt_max_bytes = mem_measure_get_ctxt_bytes(&comp_measure);
+			if(mem_measure_get_ctxt_bytes(&decomp_measure) > ctxt_max_bytes)
+			{
+				ctxt_max_bytes = mem_measure_get_ctxt_bytes(&decomp_measure);
+			}
+
+			if(contexts_nr == (size_t) max_contexts)
+			{
+				break;
+			}
+		}
+	}
+
+	/* everything went fine */
+	status = 0;
+
+free_packets:
+	free(packets.lens);
+	free(packets.data);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the memory test application
+ */
+static void usage(void)
+{
+	size_t i;
+
+	printf(
+		"Measure the memory footprint of the ROHC contexts.\n"
+		"\n"
+		"Usage: rohc_test_memory [General options]\n"
+		"   or: rohc_test_memory [options]\n"
+		"\n"
+		"General options:\n"
+		"  -h, --help              Print application usage and exit\n"
+		"  -v, --version           Print version information and exit\n"
+		"Options:\n"
+		"      --verbose           Tell the application to be more verbose\n"
+		"      --profile NAME      Measure the given profile only, may be\n"
+		"                          given several times (default: all)\n"
+		"      --max-contexts NUM  The maximum number of contexts to measure\n"
+		"                          (default: %u)\n"
+		"      --packets NUM       The number of packets per flow\n"
+		"                          (default: %u)\n"
+		"      --wlsb-width NUM    The width of the WLSB windows (default: 4)\n"
+		"      --csv               Print the results in CSV\n"
+		"\n"
+		"Profiles:\n"
+		"  ", MEM_CONTEXTS_DEFAULT, MEM_PACKETS_DEFAULT);
+	for(i = 0; i < MEM_PROFILES_NR; i++)
+	{
+		printf("%s%s", (i == 0 ? "" : ", "), mem_profiles[i].name);
+	}
+	printf(
+		"\n"
+		"\n"
+		"Examples:\n"
+		"  rohc_test_memory                               measure all profiles\n"
+		"                                                 up to 16384 contexts\n"
+		"  rohc_test_memory --profile rtp --wlsb-width 16 measure the RTP profile\n"
+		"                                                 with 16-wide windows\n"
+		"\n"
+		"Report bugs to <" PACKAGE_BUGREPORT ">.\n");
+}
+
+
+/**
+ * @brief Measure the memory of one profile for the given number of contexts
+ *
+ * @param profile         The profile to measure
+ * @param contexts_nr     The number of contexts to create
+ * @param packets_nr      The number of packets per flow
+ * @param wlsb_width      The width of the WLSB windows
+ * @param packets         The storage for the ROHC packets
+ * @param comp_measure    OUT: the measures of the compressor
+ * @param decomp_measure  OUT: the measures of the decompressor
+ * @return                true if the measures succeeded, false otherwise
+ */
+static bool measure_profile(const struct mem_profile *const profile,
+                            const size_t contexts_nr,
+                            const size_t packets_nr,
+                            const size_t wlsb_width,
+                            struct mem_packets *const packets,
+                            struct mem_measure *const comp_measure,
+                            struct mem_measure *const decomp_measure)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	rohc_comp_general_info_t comp_info;
+	rohc_decomp_general_info_t decomp_info;
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	uint8_t ip_packet[MEM_IP_MAX_LEN];
+	uint8_t out_buffer[MEM_IP_MAX_LEN + MEM_ROHC_MAX_LEN];
+	long heap_before;
+	long heap_empty;
+	size_t sn;
+	size_t i;
+	bool is_success = false;
+
+	assert(contexts_nr * packets_nr <= packets->max);
+	memset(comp_measure, 0, sizeof(struct mem_measure));
+	memset(decomp_measure, 0, sizeof(struct mem_measure));
+
+	/* create a compressor with the measured profile only */
+	heap_before = mem_get_heap();
+	comp = rohc_comp_new2(ROHC_LARGE_CID, contexts_nr - 1,
+	                      gen_false_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	heap_empty = mem_get_heap();
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL) ||
+	   !rohc_comp_set_alloc_cbs(comp, mem_alloc_cb, mem_free_cb,
+	                            &comp_measure->slab_bytes) ||
+	   !rohc_comp_set_wlsb_window_width(comp, wlsb_width) ||
+	   !rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL) ||
+	   !rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED, profile->id,
+	                              -1))
+	{
+		fprintf(stderr, "failed to configure the ROHC compressor\n");
+		goto free_comp;
+	}
+
+	/* compress all the packets of all the flows, the flows are interleaved
+	 * so that all contexts are alive at the same time */
+	packets->nr = 0;
+	for(sn = 0; sn < packets_nr; sn++)
+	{
+		for(i = 0; i < contexts_nr; i++)
+		{
+			const size_t len = build_packet(profile, i, sn, ip_packet);
+			const struct rohc_buf ip_buf =
+				rohc_buf_init_full(ip_packet, len, arrival_time);
+			struct rohc_buf rohc_buf =
+				rohc_buf_init_empty(packets->data +
+				                    packets->nr * MEM_ROHC_MAX_LEN,
+				                    MEM_ROHC_MAX_LEN);
+
+			if(rohc_compress4(comp, ip_buf, &rohc_buf) != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "failed to compress packet #%zu of flow #%zu\n",
+				        sn + 1, i + 1);
+				goto free_comp;
+			}
+			packets->lens[packets->nr] = rohc_buf.len;
+			packets->nr++;
+		}
+	}
+
+	comp_info.version_major = 0;
+	comp_info.version_minor = 0;
+	if(!rohc_comp_get_general_info(comp, &comp_info))
+	{
+		fprintf(stderr, "failed to get general information on compressor\n");
+		goto free_comp;
+	}
+	comp_measure->contexts_nr = comp_info.contexts_nr;
+	if(heap_before >= 0)
+	{
+		comp_measure->instance_bytes = heap_empty - heap_before;
+		comp_measure->ctxts_bytes = mem_get_heap() - heap_empty;
+	}
+	else
+	{
+		comp_measure->instance_bytes = -1;
+		comp_measure->ctxts_bytes = -1;
+	}
+	comp_measure->rss_kib = mem_get_rss();
+	rohc_comp_free(comp);
+	comp = NULL;
+	mem_release_heap();
+
+	/* create a decompressor with the measured profile only */
+	heap_before = mem_get_heap();
+	decomp = rohc_decomp_new2(ROHC_LARGE_CID, contexts_nr - 1, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto error;
+	}
+	heap_empty = mem_get_heap();
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL) ||
+	   !rohc_decomp_set_alloc_cbs(decomp, mem_alloc_cb, mem_free_cb,
+	                              &decomp_measure->slab_bytes) ||
+	   !rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                profile->id, -1))
+	{
+		fprintf(stderr, "failed to configure the ROHC decompressor\n");
+		goto free_decomp;
+	}
+
+	/* decompress all the packets */
+	for(i = 0; i < packets->nr; i++)
+	{
+		const struct rohc_buf rohc_buf =
+			rohc_buf_init_full(packets->data + i * MEM_ROHC_MAX_LEN,
+			                   packets->lens[i], arrival_time);
+		struct rohc_buf ip_buf =
+			rohc_buf_init_empty(out_buffer, sizeof(out_buffer));
+
+		if(rohc_decompress3(decomp, rohc_buf, &ip_buf, NULL, NULL) !=
+		   ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "failed to decompress ROHC packet #%zu\n", i + 1);
+			goto free_decomp;
+		}
+	}
+
+	decomp_info.version_major = 0;
+	decomp_info.version_minor = 0;
+	if(!rohc_decomp_get_general_info(decomp, &decomp_info))
+	{
+		fprintf(stderr, "failed to get general information on decompressor\n");
+		goto free_decomp;
+	}
+	decomp_measure->contexts_nr = decomp_info.contexts_nr;
+	if(heap_before >= 0)
+	{
+		decomp_measure->instance_bytes = heap_empty - heap_before;
+		decomp_measure->ctxts_bytes = mem_get_heap() - heap_empty;
+	}
+	else
+	{
+		decomp_measure->instance_bytes = -1;
+		decomp_measure->ctxts_bytes = -1;
+	}
+	decomp_measure->rss_kib = mem_get_rss();
+
+	/* everything went fine */
+	is_success = true;
+
+free_decomp:
+	rohc_decomp_free(decomp);
+free_comp:
+	rohc_comp_free(comp);
+	mem_release_heap();
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Build one IPv4 packet of the given profile
+ *
+ * @param profile  The profile of the packet
+ * @param flow_id  The ID of the flow, that gives the addresses and ports
+ * @param sn       The sequence number of the packet in the flow
+ * @param buffer   OUT: the IPv4 packet, at least MEM_IP_MAX_LEN bytes
+ * @return         The length of the IPv4 packet
+ */
+static size_t build_packet(const struct mem_profile *const profile,
+                           const uint32_t flow_id,
+                           const uint32_t sn,
+                           uint8_t *const buffer)
+{
+	struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) buffer;
+	uint8_t *const next_hdr = buffer + sizeof(struct ipv4_hdr);
+	size_t hdrs_len = 0;
+
+	if(profile->protocol == ROHC_IPPROTO_UDP ||
+	   profile->protocol == ROHC_IPPROTO_UDPLITE)
+	{
+		struct udphdr *const udp = (struct udphdr *) next_hdr;
+
+		hdrs_len = sizeof(struct udphdr);
+		if(profile->is_rtp)
+		{
+			struct rtphdr *const rtp = (struct rtphdr *) (udp + 1);
+
+			hdrs_len += sizeof(struct rtphdr);
+			memset(rtp, 0, sizeof(struct rtphdr));
+			rtp->version = 2;
+			rtp->pt = 0x72;
+			rtp->sn = htons(sn);
+			rtp->timestamp = htonl(sn * 160);
+			rtp->ssrc = htonl(0x42424242 + flow_id);
+		}
+		udp->source = htons(10000 + (flow_id & 0x3fff));
+		udp->dest = htons(profile->is_rtp ? 1234 : 2000);
+		/* UDP-Lite: a null checksum coverage means the whole packet */
+		udp->len = (profile->protocol == ROHC_IPPROTO_UDP ?
+		            htons(hdrs_len + MEM_PAYLOAD_LEN) : 0);
+		udp->check = 0;
+	}
+	else if(profile->protocol == ROHC_IPPROTO_TCP)
+	{
+		struct tcphdr *const tcp = (struct tcphdr *) next_hdr;
+
+		hdrs_len = sizeof(struct tcphdr);
+		memset(tcp, 0, sizeof(struct tcphdr));
+		tcp->src_port = htons(10000 + (flow_id & 0x3fff));
+		tcp->dst_port = htons(80);
+		tcp->seq_num = htonl(0x10000000 + sn * MEM_PAYLOAD_LEN);
+		tcp->ack_num = htonl(0x20000000);
+		tcp->data_offset = sizeof(struct tcphdr) / sizeof(uint32_t);
+		tcp->ack_flag = 1;
+		tcp->psh_flag = 1;
+		tcp->window = htons(0xffff);
+	}
+	else if(profile->protocol == ROHC_IPPROTO_ESP)
+	{
+		struct esphdr *const esp = (struct esphdr *) next_hdr;
+
+		hdrs_len = sizeof(struct esphdr);
+		esp->spi = htonl(0x1000 + flow_id);
+		esp->sn = htonl(sn + 1);
+	}
+
+	/* build payload */
+	memset(next_hdr + hdrs_len, 0x42, MEM_PAYLOAD_LEN);
+
+	/* build IPv4 header, the source address identifies the flow */
+	ipv4->version = 4;
+	ipv4->ihl = 5;
+	ipv4->tos = 0;
+	ipv4->tot_len = htons(sizeof(struct ipv4_hdr) + hdrs_len + MEM_PAYLOAD_LEN);
+	ipv4->id = htons(sn);
+	ipv4->frag_off = 0;
+	ipv4->ttl = 64;
+	ipv4->protocol = profile->protocol;
+	ipv4->check = 0;
+	ipv4->saddr = htonl(0x0a000000 + flow_id);
+	ipv4->daddr = htonl(0xc0a80001);
+	ipv4->check = ip_fast_csum((uint8_t *) ipv4, ipv4->ihl);
+
+	return sizeof(struct ipv4_hdr) + hdrs_len + MEM_PAYLOAD_LEN;
+}
+
+
+/**
+ * @brief Print the measures of one compressor or decompressor
+ *
+ * @param is_csv       Whether to print in CSV or in plain text
+ * @param profile      The measured profile
+ * @param contexts_nr  The number of contexts the measure was run for
+ * @param wlsb_width   The width of the WLSB windows
+ * @param entity       The measured entity: "comp" or "decomp"
+ * @param measure      The measures of the entity
+ */
+static void print_measure(const bool is_csv,
+                          const struct mem_profile *const profile,
+                          const size_t contexts_nr,
+                          const size_t wlsb_width,
+                          const char *const entity,
+                          const struct mem_measure *const measure)
+{
+	const size_t ctxts_nr = (measure->contexts_nr > 0 ? measure->contexts_nr : 1);
+	char instance[32] = "n/a";
+	char per_ctxt[32] = "n/a";
+
+	if(measure->instance_bytes >= 0)
+	{
+		snprintf(instance, sizeof(instance), "%ld", measure->instance_bytes);
+		snprintf(per_ctxt, sizeof(per_ctxt), "%.1f",
+		         (double) measure->ctxts_bytes / (double) ctxts_nr);
+	}
+
+	if(is_csv)
+	{
+		printf("%s,%zu,%zu,%s,%zu,%s,%s,%.1f,", profile->name, contexts_nr,
+		       wlsb_width, entity, measure->contexts_nr,
+		       (measure->instance_bytes >= 0 ? instance : ""),
+		       (measure->instance_bytes >= 0 ? per_ctxt : ""),
+		       (double) measure->slab_bytes / (double) ctxts_nr);
+		if(measure->rss_kib >= 0)
+		{
+			printf("%ld", measure->rss_kib);
+		}
+		printf("\n");
+	}
+	else
+	{
+		printf("%-8s %8zu %-6s %14s %14s %14.1f %10ld\n", profile->name,
+		       contexts_nr, entity, instance, per_ctxt,
+		       (double) measure->slab_bytes / (double) ctxts_nr,
+		       measure->rss_kib);
+	}
+}
+
+
+/**
+ * @brief Get the heap memory in use by the process
+ *
+ * @return  The heap memory in use (in bytes), -1 if not available on the
+ *          platform
+ */
+static long mem_get_heap(void)
+{
+#if HAVE_MALLINFO2 == 1
+	const struct mallinfo2 info = mallinfo2();
+	return (long) (info.uordblks + info.hblkhd);
+#else
+	return -1;
+#endif
+}
+
+
+/**
+ * @brief Give the free heap memory back to the system
+ *
+ * The memory of the contexts of one measure shall not stay in the resident
+ * set of the process during the next measures.
+ */
+static void mem_release_heap(void)
+{
+#if HAVE_MALLOC_TRIM == 1
+	malloc_trim(0);
+#endif
+}
+
+
+/**
+ * @brief Get the resident set size of the process
+ *
+ * @return  The resident set size (in KiB), -1 if not available on the
+ *          platform
+ */
+static long mem_get_rss(void)
+{
+	long rss_kib = -1;
+	FILE *statm;
+	long size;
+	long resident;
+
+	/* the second field of /proc/self/statm is the RSS in pages */
+	statm = fopen("/proc/self/statm", "r");
+	if(statm == NULL)
+	{
+		goto error;
+	}
+	if(fscanf(statm, "%ld %ld", &size, &resident) == 2)
+	{
+		rss_kib = resident * (sysconf(_SC_PAGESIZE) / 1024);
+	}
+	fclose(statm);
+
+error:
+	return rss_kib;
+}
+
+
+/**
+ * @brief Get the physical memory available to the process
+ *
+ * @return  The available physical memory (in bytes), 0 if not available on
+ *          the platform
+ */
+static uint64_t mem_get_avail(void)
+{
+#if defined(_SC_AVPHYS_PAGES) && defined(_SC_PAGESIZE)
+	const long pages_nr = sysconf(_SC_AVPHYS_PAGES);
+	const long page_size = sysconf(_SC_PAGESIZE);
+
+	if(pages_nr > 0 && page_size > 0)
+	{
+		return ((uint64_t) pages_nr) * ((uint64_t) page_size);
+	}
+#endif
+	return 0;
+}
+
+
+/**
+ * @brief Get the memory per context of the given measure
+ *
+ * @param measure  The measure of one (de)compressor
+ * @return         The heap memory per context if known,
+ *                 the slab memory per context otherwise (in bytes)
+ */
+static uint64_t mem_measure_get_ctxt_bytes(const struct mem_measure *const measure)
+{
+	const size_t ctxts_nr = (measure->contexts_nr > 0 ? measure->contexts_nr : 1);
+
+	if(measure->ctxts_bytes > 0)
+	{
+		return ((uint64_t) measure->ctxts_bytes) / ctxts_nr;
+	}
+	return measure->slab_bytes / ctxts_nr;
+}
+
+
+/**
+ * @brief Allocate the slab memory of a (de)compressor and account for it
+ *
+ * The slab memory is only released with the (de)compressor, so the
+ * allocated bytes are the bytes in use.
+ *
+ * @param size  The size of the memory to allocate
+ * @param priv  The counter of allocated bytes
+ * @return      The allocated memory
+ */
+static void * mem_alloc_cb(const size_t size, void *const priv)
+{
+	size_t *const slab_bytes = priv;
+	void *const ptr = malloc(size);
+
+	if(ptr != NULL)
+	{
+		(*slab_bytes) += size;
+	}
+	return ptr;
+}
+
+
+/**
+ * @brief Free the slab memory of a (de)compressor
+ *
+ * @param ptr   The memory to free
+ * @param priv  The counter of allocated bytes
+ */
+static void mem_free_cb(void *const ptr, void *const priv __attribute__((unused)))
+{
+	free(ptr);
+}
+
+
+/**
+ * @brief Print traces emitted by the ROHC library in verbose mode
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
+                              const rohc_trace_level_t level __attribute__((unused)),
+                              const rohc_trace_entity_t entity __attribute__((unused)),
+                              const int profile __attribute__((unused)),
+                              const char *const format,
+                              ...)
+{
+	if(is_verbose)
+	{
+		va_list args;
+		va_start(args, format);
+		vfprintf(stderr, format, args);
+		va_end(args);
+	}
+}
+
+
+/**
+ * @brief Generate a false random number for testing the ROHC library
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              Always 0
+ */
+static int gen_false_random_num(const struct rohc_comp *const comp,
+                                void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return 0;
+}
+
+
+/**
+ * @brief The RTP detection callback
+ *
+ * @param ip           The innermost IP packet
+ * @param udp          The UDP header of the packet
+ * @param payload      The UDP payload of the packet
+ * @param payload_size The size of the UDP payload (in bytes)
+ * @param rtp_private  An optional private context
+ * @return             true if the packet is an RTP packet, false otherwise
+ */
+static bool rohc_comp_rtp_cb(const unsigned char *const ip __attribute__((unused)),
+                             const unsigned char *const udp,
+                             const unsigned char *const payload __attribute__((unused)),
+                             const unsigned int payload_size __attribute__((unused)),
+                             void *const rtp_private __attribute__((unused)))
+{
+	uint16_t udp_dport;
+
+	if(udp == NULL)
+	{
+		return false;
+	}
+
+	/* the generated RTP flows use UDP destination port 1234 */
+	memcpy(&udp_dport, udp + 2, sizeof(uint16_t));
+
+	return (ntohs(udp_dport) == 1234);
+}
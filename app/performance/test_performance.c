@@ -55,6 +55,55 @@
  *
  * The program outputs the time elapsed for (de)compression all packets, the
  * number of (de)compressed packets and the average elapsed time per packet.
+ *
+ * Benchmark mode
+ * --------------
+ *
+ * With the --bench option, the program preloads the whole capture in memory
+ * first, so that reading the capture is not timed. The packets are not
+ * copied: they are replayed from the capture mapped in memory. Then every thread replays
+ * the packets through its own (de)compressor several times. A first replay
+ * warms up the caches and is not timed. A new (de)compressor is created for
+ * every replay, so that every replay performs the same work.
+ *
+ * The program then outputs the number of packets (de)compressed per second
+ * by all the threads, the percentiles of the time elapsed per packet, and
+ * the number of CPU cycles per packet if the CPU provides a cycle counter.
+ *
+ * The --output-format option prints the results of the benchmark mode in
+ * JSON or CSV instead of plain text, for scripts. The results then also
+ * contain the configuration of the (de)compressors, the profiles of the
+ * packets, the compression ratio, the durations of the benchmark stages, the
+ * durations of the library stages if the library was configured with the
+ * --enable-rohc-perf-stats option, and the memory high-water mark of the
+ * process. See rohc_test_performance_compare.sh to compare the packet rates
+ * with a baseline.
+ *
+ * The --hugepages option allocates the contexts of every compressor from an
+ * arena of 2 MB huge pages bound to the NUMA node of the thread that drives
+ * the compressor, through the memory callbacks of the library. Transparent
+ * huge pages are used if no huge page is reserved.
+ *
+ * The --effort option sets the compression effort level of every compressor,
+ * see rohc_comp_set_effort(). Benchmark the same capture with every level to
+ * compare the packet rates and the compression ratios they trade.
+ *
+ * Impairment mode
+ * ---------------
+ *
+ * With the 'impair' action, the program compresses the IP packets of the
+ * capture, sends the ROHC packets through an impaired channel, and
+ * decompresses them. The channel loses packets according to the
+ * Gilbert-Elliott model, delays some packets so that they are overtaken by
+ * the next ones, and flips bits according to a bit error rate. The feedback
+ * of the decompressor is delivered to the compressor without impairment.
+ * The impairments are pseudo-random, the same seed gives the same run.
+ *
+ * The program then outputs the decompression rate, the CRC repairs attempted
+ * and succeeded, the feedback bytes, the bytes of IR, IR-DYN and IR-CR
+ * packets, and the goodput, ie. the uncompressed bytes delivered intact. The
+ * rate limits of feedbacks, the WLSB width and the timeouts of the periodic
+ * refreshes may be tuned against the impairments of a real link.
  */
 
 #include "config.h" /* for HAVE_*_H */
@@ -71,18 +120,24 @@
 #include <errno.h>
 #include <stdarg.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
+#include <inttypes.h>
 #include <assert.h>
-
-/* include for the PCAP library */
-#if HAVE_PCAP_PCAP_H == 1
-#  include <pcap/pcap.h>
-#elif HAVE_PCAP_H == 1
-#  include <pcap.h>
-#else
-#  error "pcap.h header not found, did you specified --enable-rohc-tests \
-for ./configure ? If yes, check configure output and config.log"
+#if HAVE_PTHREAD_H == 1
+#  include <pthread.h>
+#endif
+#if HAVE_SYS_RESOURCE_H == 1
+#  include <sys/resource.h> /* for getrusage() */
 #endif
+#if HAVE_SYS_MMAN_H == 1 && defined(__linux__)
+#  include <sys/mman.h> /* for mmap() and huge pages */
+#  include <sys/syscall.h> /* for getcpu() and mbind() */
+#  define PERF_HAVE_HUGEPAGES 1
+#endif
+
+/* the PCAP captures are loaded in memory, without libpcap */
+#include "test_capture.h"
 
 /* includes for network headers */
 #include <protocols/ipv4.h>
@@ -100,18 +155,246 @@ for ./configure ? If yes, check configure output and config.log"
 /** The maximal size for the ROHC packets */
 #define MAX_ROHC_SIZE  (5 * 1024)
 
-/** The length of the Linux Cooked Sockets header */
-#define LINUX_COOKED_HDR_LEN  16U
-
 /** The length (in bytes) of the Ethernet header */
 #define ETHER_HDR_LEN  14U
 
 /** The minimum Ethernet length (in bytes) */
 #define ETHER_FRAME_MIN_LEN  60U
 
+/** The default number of timed replays of the capture in benchmark mode */
+#define PERF_REPLAYS_DEFAULT  10U
+
+/** The maximal number of threads in benchmark mode */
+#define PERF_THREADS_MAX  256U
+
+/** The number of bits for the sub-buckets of one power of two in the
+ *  histograms of per-packet times */
+#define PERF_HIST_SUB_BITS  5U
+
+/** The number of buckets in the histograms of per-packet times */
+#define PERF_HIST_BUCKETS  ((64U - PERF_HIST_SUB_BITS + 1U) << PERF_HIST_SUB_BITS)
+
+/** The length of the huge pages the contexts are allocated on */
+#define PERF_HUGEPAGE_LEN  (2U * 1024U * 1024U)
+
+/** The memory reserved in the arena for every context */
+#define PERF_ARENA_CTXT_LEN  16384U
+
+/** The alignment of the memory served by the arena */
+#define PERF_ARENA_ALIGN  64U
+
+/** The NUMA policy that binds memory to a set of nodes, see mbind() */
+#define PERF_MPOL_BIND  2
+
+/** The maximal number of packets delayed at the same time in impairment mode */
+#define PERF_IMPAIR_DEPTH_MAX  64U
+
+/** The maximal number of library stages, for compression or decompression */
+#define PERF_STAGES_MAX \
+	((size_t) ROHC_COMP_PERF_STAGE_MAX > (size_t) ROHC_DECOMP_PERF_STAGE_MAX ? \
+	 (size_t) ROHC_COMP_PERF_STAGE_MAX : (size_t) ROHC_DECOMP_PERF_STAGE_MAX)
+
+
+/** The formats of the results of the benchmark mode */
+typedef enum
+{
+	PERF_OUTPUT_TEXT = 0,  /**< Plain text for humans */
+	PERF_OUTPUT_JSON = 1,  /**< One JSON object */
+	PERF_OUTPUT_CSV  = 2,  /**< One CSV header line and one CSV record */
+} perf_output_t;
+
+
+/** The parameters of the benchmark mode */
+struct perf_config
+{
+	const char *filename;          /**< The name of the capture to replay */
+	bool is_comp;                  /**< Whether to compress or decompress */
+	rohc_cid_type_t cid_type;      /**< The type of CIDs to use */
+	size_t wlsb_width;             /**< The width of the WLSB window */
+	size_t max_contexts;           /**< The maximum number of ROHC contexts */
+	size_t replays_nr;             /**< The number of timed replays */
+	size_t threads_nr;             /**< The number of threads */
+	perf_output_t output;          /**< The format of the results */
+	bool hugepages;                /**< Whether to allocate the contexts on
+	                                    huge pages of the local NUMA node */
+	rohc_comp_effort_t effort;     /**< The compression effort level */
+};
+
+
+/** The parameters of the impairment mode */
+struct perf_impair_config
+{
+	const char *filename;          /**< The name of the capture to replay */
+	rohc_cid_type_t cid_type;      /**< The type of CIDs to use */
+	size_t wlsb_width;             /**< The width of the WLSB window */
+	size_t max_contexts;           /**< The maximum number of ROHC contexts */
+	rohc_mode_t mode;              /**< The mode of the decompressor */
+	double loss_good_to_bad;       /**< The probability to enter the bad state */
+	double loss_bad_to_good;       /**< The probability to leave the bad state */
+	double loss_in_good;           /**< The loss probability in good state */
+	double loss_in_bad;            /**< The loss probability in bad state */
+	double reorder_rate;           /**< The probability to delay one packet */
+	size_t reorder_depth;          /**< The maximum number of packets that
+	                                    overtake one delayed packet */
+	double ber;                    /**< The bit error rate */
+	uint64_t seed;                 /**< The seed of the impairments */
+	bool crc_repair;               /**< Whether to repair upon CRC failure */
+	size_t reorder_window;         /**< The reorder window of the decompressor */
+	size_t ir_timeout;             /**< The timeout of IR refreshes, 0 for the
+	                                    default timeouts */
+	size_t fo_timeout;             /**< The timeout of FO refreshes */
+	bool has_rate_limits;          /**< Whether the rate limits are set */
+	size_t rate_limits[6];         /**< The k, n, k_1, n_1, k_2, n_2 rate limits
+	                                    of feedbacks */
+};
+
+
+/** One ROHC packet in the impaired channel */
+struct perf_impair_pkt
+{
+	uint8_t data[MAX_ROHC_SIZE];  /**< The ROHC packet */
+	size_t len;                   /**< The length of the ROHC packet */
+	size_t num;                   /**< The index of the original IP packet */
+	bool is_held;                 /**< Whether the packet is delayed */
+	size_t release_at;            /**< The number of delivered packets after
+	                                   which the delayed packet is released */
+};
+
+
+/** The impaired channel between the compressor and the decompressor */
+struct perf_impair_channel
+{
+	const struct perf_impair_config *config;  /**< The impairments */
+	uint64_t rand_state;           /**< The state of the random generator */
+	bool is_bad_state;             /**< Whether the channel is in bad state */
+	struct perf_impair_pkt *held;  /**< The delayed packets */
+	size_t delivered_nr;           /**< The number of delivered packets */
+};
+
+
+/** The statistics of the impairment mode */
+struct perf_impair_stats
+{
+	uint64_t sent_nr;         /**< The number of packets sent */
+	uint64_t lost_nr;         /**< The number of packets lost by the channel */
+	uint64_t damaged_nr;      /**< The number of packets with bit errors */
+	uint64_t reordered_nr;    /**< The number of packets delayed */
+	uint64_t delivered_nr;    /**< The number of packets decompressed */
+	uint64_t intact_nr;       /**< The number of packets decompressed intact */
+	uint64_t failed_nr;       /**< The number of packets that failed
+	                               decompression */
+	uint64_t corrupted_nr;    /**< The number of packets decompressed with
+	                               undetected errors */
+	uint64_t decomp_ns;       /**< The time of all the decompressions */
+	uint64_t uncomp_bytes;    /**< The uncompressed bytes sent */
+	uint64_t comp_bytes;      /**< The ROHC bytes sent */
+	uint64_t intact_bytes;    /**< The uncompressed bytes delivered intact */
+	uint64_t refresh_nr;      /**< The number of IR, IR-DYN and IR-CR packets */
+	uint64_t refresh_bytes;   /**< The bytes of IR, IR-DYN and IR-CR packets */
+	uint64_t feedback_nr;     /**< The number of feedbacks built */
+	uint64_t feedback_bytes;  /**< The bytes of feedbacks built */
+};
+
+
+/** The arena the contexts of one compressor are allocated from */
+struct perf_arena
+{
+	uint8_t *mem;   /**< The memory of the arena, NULL if none */
+	size_t len;     /**< The length of the arena (in bytes) */
+	size_t used;    /**< The number of bytes served so far */
+	int node;       /**< The NUMA node of the arena, -1 if not bound */
+};
+
+
+/** One packet of the capture preloaded in memory for the benchmark mode */
+struct perf_pkt
+{
+	uint8_t *data;  /**< The packet data in the capture, link layer header
+	                     excluded */
+	size_t len;     /**< The length of the packet data */
+};
+
+
+/** The statistics of per-packet times of one benchmark thread */
+struct perf_stats
+{
+	uint64_t pkts_nr;                  /**< The number of timed packets */
+	uint64_t total_ns;                 /**< The time of all timed packets */
+	uint64_t total_cycles;             /**< The CPU cycles of all timed packets */
+	uint64_t hist[PERF_HIST_BUCKETS];  /**< The histogram of per-packet times */
+
+	uint64_t setup_ns;      /**< The time to create all the (de)compressors */
+	uint64_t warmup_ns;     /**< The time of the warmup replay */
+	uint64_t uncomp_bytes;  /**< The uncompressed bytes of one replay */
+	uint64_t comp_bytes;    /**< The compressed bytes of one replay */
+	/** The number of packets per profile in one replay */
+	uint64_t profiles[ROHC_PROFILE_MAX];
+
+	/** Whether the library measured the durations of its stages */
+	bool has_stages;
+	/** The number of measures of every library stage in the timed replays */
+	uint64_t stages_nr[PERF_STAGES_MAX];
+	/** The durations of every library stage in the timed replays (in ticks) */
+	uint64_t stages_ticks[PERF_STAGES_MAX];
+};
+
+
+/** The results of the benchmark mode computed from the merged statistics */
+struct perf_results
+{
+	size_t pkts_nr;         /**< The number of packets in the capture */
+	double pkts_per_sec;    /**< The number of packets per second */
+	double ns_avg;          /**< The average time per packet (in ns) */
+	uint64_t ns_p50;        /**< The median time per packet (in ns) */
+	uint64_t ns_p99;        /**< The 99th percentile of times (in ns) */
+	uint64_t ns_p999;       /**< The 99.9th percentile of times (in ns) */
+	double cycles_avg;      /**< The average CPU cycles per packet, 0 if none */
+	uint64_t load_ns;       /**< The time to preload the capture */
+	uint64_t setup_ns;      /**< The average time to create one (de)compressor */
+	uint64_t warmup_ns;     /**< The average time of one warmup replay */
+	uint64_t elapsed_ns;    /**< The time of the whole run of the threads */
+	double comp_ratio;      /**< The compressed size over the uncompressed size */
+	long max_rss_kib;       /**< The memory high-water mark, -1 if unknown */
+};
+
+
+/** One thread of the benchmark mode, with its own (de)compressor */
+struct perf_worker
+{
+	const bool *is_verbose;        /**< Whether to print library traces */
+	const struct perf_config *config;  /**< The parameters of the benchmark */
+	const struct perf_pkt *pkts;   /**< The preloaded packets to replay */
+	size_t pkts_nr;                /**< The number of preloaded packets */
+	struct perf_stats stats;       /**< The statistics of per-packet times */
+	struct perf_arena arena;       /**< The arena of the contexts if any */
+	int status;                    /**< 0 if the thread succeeded, 1 otherwise */
+#if HAVE_PTHREAD_H == 1
+	pthread_t thread;              /**< The thread running the benchmark */
+#endif
+};
+
 
 static void usage(void);
 
+static int open_capture(const char *const filename,
+                        struct test_capture *const capture)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static size_t get_ip_packet_len(const unsigned long num_packet,
+                                const struct test_capture_pkt *const pkt,
+                                const size_t link_len)
+	__attribute__((warn_unused_result, nonnull(2)));
+
+static struct rohc_comp * create_compressor(const bool *const is_verbose,
+                                            const rohc_cid_type_t cid_type,
+                                            const size_t wlsb_width,
+                                            const size_t max_contexts)
+	__attribute__((warn_unused_result, nonnull(1)));
+static struct rohc_decomp * create_decompressor(const bool *const is_verbose,
+                                                const rohc_cid_type_t cid_type,
+                                                const size_t max_contexts,
+                                                const rohc_mode_t mode)
+	__attribute__((warn_unused_result, nonnull(1)));
+
 static int test_compression_perfs(const bool is_verbose,
                                   char *filename,
                                   const rohc_cid_type_t cid_type,
@@ -120,8 +403,7 @@ static int test_compression_perfs(const bool is_verbose,
                                   unsigned long *packet_count);
 static int time_compress_packet(struct rohc_comp *comp,
                                 unsigned long num_packet,
-                                struct pcap_pkthdr header,
-                                unsigned char *packet,
+                                const struct test_capture_pkt *const pkt,
                                 size_t link_len);
 
 static int test_decompression_perfs(const bool is_verbose,
@@ -131,11 +413,109 @@ static int test_decompression_perfs(const bool is_verbose,
                                     unsigned long *packet_count);
 static int time_decompress_packet(struct rohc_decomp *decomp,
                                   unsigned long num_packet,
-                                  struct pcap_pkthdr header,
-                                  unsigned char *packet,
+                                  const struct test_capture_pkt *const pkt,
                                   size_t link_len,
                                   const struct rohc_ts arrival_time);
 
+static int run_benchmark(const bool is_verbose,
+                         const struct perf_config *const config,
+                         unsigned long *const packet_count)
+	__attribute__((warn_unused_result, nonnull(2, 3)));
+static int load_capture(const char *const filename,
+                        const bool is_comp,
+                        struct test_capture *const capture,
+                        struct perf_pkt **const pkts,
+                        size_t *const pkts_nr)
+	__attribute__((warn_unused_result, nonnull(1, 3, 4, 5)));
+static void free_capture(struct test_capture *const capture,
+                         struct perf_pkt *const pkts)
+	__attribute__((nonnull(1)));
+static void * run_benchmark_worker(void *const worker_arg)
+	__attribute__((nonnull(1)));
+static void perf_stats_add_stages(struct perf_stats *const stats,
+                                  const struct rohc_comp *const comp,
+                                  const struct rohc_decomp *const decomp)
+	__attribute__((nonnull(1)));
+static bool perf_arena_init(struct perf_arena *const arena, const size_t len)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void perf_arena_release(struct perf_arena *const arena)
+	__attribute__((nonnull(1)));
+static void * perf_arena_alloc(const size_t size, void *const priv)
+	__attribute__((warn_unused_result));
+static void perf_arena_free(void *const ptr, void *const priv);
+static void print_benchmark_stats(const struct perf_config *const config,
+                                  const struct perf_stats *const stats,
+                                  const size_t pkts_nr,
+                                  const uint64_t load_ns,
+                                  const uint64_t elapsed_ns)
+	__attribute__((nonnull(1, 2)));
+static void print_benchmark_text(const struct perf_config *const config,
+                                 const struct perf_stats *const stats,
+                                 const struct perf_results *const results)
+	__attribute__((nonnull(1, 2, 3)));
+static void print_benchmark_json(const struct perf_config *const config,
+                                 const struct perf_stats *const stats,
+                                 const struct perf_results *const results)
+	__attribute__((nonnull(1, 2, 3)));
+static void print_benchmark_csv(const struct perf_config *const config,
+                                const struct perf_stats *const stats,
+                                const struct perf_results *const results)
+	__attribute__((nonnull(1, 2, 3)));
+static void print_escaped_string(const char *const str, const bool is_json)
+	__attribute__((nonnull(1)));
+static const char * perf_get_stage_name(const bool is_comp, const size_t stage)
+	__attribute__((warn_unused_result));
+static const char * perf_get_effort_descr(const rohc_comp_effort_t effort)
+	__attribute__((warn_unused_result, const));
+static long perf_get_max_rss(void)
+	__attribute__((warn_unused_result));
+
+static int run_impairment(const bool is_verbose,
+                          const struct perf_impair_config *const config,
+                          unsigned long *const packet_count)
+	__attribute__((warn_unused_result, nonnull(2, 3)));
+static double perf_impair_rand(struct perf_impair_channel *const channel)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool perf_impair_is_lost(struct perf_impair_channel *const channel)
+	__attribute__((warn_unused_result, nonnull(1)));
+static size_t perf_impair_damage(struct perf_impair_channel *const channel,
+                                 uint8_t *const data,
+                                 const size_t len)
+	__attribute__((nonnull(1, 2)));
+static bool perf_impair_hold(struct perf_impair_channel *const channel,
+                             const struct perf_impair_pkt *const pkt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool perf_impair_release(struct perf_impair_channel *const channel,
+                                const bool is_end,
+                                struct perf_impair_pkt *const pkt)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static bool perf_impair_deliver(struct rohc_comp *const comp,
+                                struct rohc_decomp *const decomp,
+                                const struct perf_impair_pkt *const pkt,
+                                const struct perf_pkt *const pkts,
+                                struct perf_impair_stats *const stats)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
+static void print_impairment_stats(const struct perf_impair_config *const config,
+                                   const struct perf_impair_stats *const stats,
+                                   const rohc_decomp_general_info_t *const info)
+	__attribute__((nonnull(1, 2, 3)));
+static bool parse_prob(const char *const name,
+                       const char *const str,
+                       double *const prob)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+
+static inline uint64_t perf_get_ns(void)
+	__attribute__((warn_unused_result));
+static inline uint64_t perf_get_cycles(void)
+	__attribute__((warn_unused_result));
+static size_t perf_hist_get_bucket(const uint64_t value)
+	__attribute__((warn_unused_result, const));
+static uint64_t perf_hist_get_value(const size_t bucket)
+	__attribute__((warn_unused_result, const));
+static uint64_t perf_stats_get_percentile(const struct perf_stats *const stats,
+                                          const double percentile)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
 static void print_rohc_traces(void *const is_verbose__,
                               const rohc_trace_level_t level,
                               const rohc_trace_entity_t entity,
@@ -175,6 +555,23 @@ int main(int argc, char *argv[])
 	rohc_cid_type_t cid_type;
 	unsigned long packet_count = 0;
 	bool is_verbose = false; /* set to quiet mode by default */
+	bool is_bench = false; /* run the benchmark mode or not */
+	int replays_nr = PERF_REPLAYS_DEFAULT;
+	int threads_nr = 1;
+	int reorder_depth = 0;
+	int reorder_window = 0;
+	char *mode_name = NULL;
+	bool hugepages = false;
+	char *effort_name = NULL;
+	rohc_comp_effort_t effort;
+	struct perf_impair_config impair = {
+		.mode = ROHC_U_MODE,
+		.loss_in_bad = 1.0,
+		.seed = 1,
+	};
+	bool has_impair_opts = false;
+	char *output_name = NULL;
+	perf_output_t output = PERF_OUTPUT_TEXT;
 	int status = 1;
 	int ret;
 
@@ -218,6 +615,180 @@ int main(int argc, char *argv[])
 			argv++;
 			argc--;
 		}
+		else if(!strcmp(*argv, "--bench"))
+		{
+			/* run the benchmark mode */
+			is_bench = true;
+		}
+		else if(!strcmp(*argv, "--repeat"))
+		{
+			/* get the number of replays of the capture in benchmark mode */
+			replays_nr = atoi(argv[1]);
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--threads"))
+		{
+			/* get the number of threads in benchmark mode */
+			threads_nr = atoi(argv[1]);
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--hugepages"))
+		{
+			/* allocate the contexts on huge pages in benchmark mode */
+			hugepages = true;
+		}
+		else if(!strcmp(*argv, "--effort"))
+		{
+			/* get the compression effort level in benchmark mode */
+			effort_name = argv[1];
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--output-format"))
+		{
+			/* get the format of the results in benchmark mode */
+			output_name = argv[1];
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--loss-p"))
+		{
+			/* get the probability to enter the bad state of the channel */
+			if(!parse_prob(argv[0], argv[1], &impair.loss_good_to_bad))
+			{
+				goto error;
+			}
+			has_impair_opts = true;
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--loss-r"))
+		{
+			/* get the probability to leave the bad state of the channel */
+			if(!parse_prob(argv[0], argv[1], &impair.loss_bad_to_good))
+			{
+				goto error;
+			}
+			has_impair_opts = true;
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--loss-good"))
+		{
+			/* get the loss probability in the good state of the channel */
+			if(!parse_prob(argv[0], argv[1], &impair.loss_in_good))
+			{
+				goto error;
+			}
+			has_impair_opts = true;
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--loss-bad"))
+		{
+			/* get the loss probability in the bad state of the channel */
+			if(!parse_prob(argv[0], argv[1], &impair.loss_in_bad))
+			{
+				goto error;
+			}
+			has_impair_opts = true;
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--reorder-rate"))
+		{
+			/* get the probability to delay one packet */
+			if(!parse_prob(argv[0], argv[1], &impair.reorder_rate))
+			{
+				goto error;
+			}
+			has_impair_opts = true;
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--reorder-depth"))
+		{
+			/* get the maximum number of packets that overtake one delayed
+			 * packet */
+			reorder_depth = atoi(argv[1]);
+			has_impair_opts = true;
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--ber"))
+		{
+			/* get the bit error rate of the channel */
+			if(!parse_prob(argv[0], argv[1], &impair.ber))
+			{
+				goto error;
+			}
+			has_impair_opts = true;
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--seed"))
+		{
+			/* get the seed of the impairments */
+			impair.seed = strtoull(argv[1], NULL, 10);
+			has_impair_opts = true;
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--mode"))
+		{
+			/* get the mode of the decompressor */
+			mode_name = argv[1];
+			has_impair_opts = true;
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--crc-repair"))
+		{
+			/* repair upon CRC failure */
+			impair.crc_repair = true;
+			has_impair_opts = true;
+		}
+		else if(!strcmp(*argv, "--reorder-window"))
+		{
+			/* get the reorder window of the decompressor */
+			reorder_window = atoi(argv[1]);
+			has_impair_opts = true;
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--refresh"))
+		{
+			/* get the timeouts of the periodic refreshes */
+			if(argv[1] == NULL ||
+			   sscanf(argv[1], "%zu,%zu", &impair.ir_timeout,
+			          &impair.fo_timeout) != 2)
+			{
+				fprintf(stderr, "option --refresh requires IR,FO timeouts\n");
+				goto error;
+			}
+			has_impair_opts = true;
+			argv++;
+			argc--;
+		}
+		else if(!strcmp(*argv, "--rate-limits"))
+		{
+			/* get the rate limits of feedbacks */
+			if(argv[1] == NULL ||
+			   sscanf(argv[1], "%zu,%zu,%zu,%zu,%zu,%zu", &impair.rate_limits[0],
+			          &impair.rate_limits[1], &impair.rate_limits[2],
+			          &impair.rate_limits[3], &impair.rate_limits[4],
+			          &impair.rate_limits[5]) != 6)
+			{
+				fprintf(stderr, "option --rate-limits requires K,N,K1,N1,K2,N2\n");
+				goto error;
+			}
+			impair.has_rate_limits = true;
+			has_impair_opts = true;
+			argv++;
+			argc--;
+		}
 		else if(test_type == 0)
 		{
 			/* get the name of the test */
@@ -257,6 +828,123 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* check the parameters of the benchmark mode */
+	if(replays_nr <= 0)
+	{
+		fprintf(stderr, "invalid number of replays %d: should be a positive "
+		        "integer\n", replays_nr);
+		goto error;
+	}
+	if(threads_nr <= 0 || (size_t) threads_nr > PERF_THREADS_MAX)
+	{
+		fprintf(stderr, "invalid number of threads %d: should be in range "
+		        "[1, %u]\n", threads_nr, PERF_THREADS_MAX);
+		goto error;
+	}
+	if(output_name == NULL || !strcmp(output_name, "text"))
+	{
+		output = PERF_OUTPUT_TEXT;
+	}
+	else if(!strcmp(output_name, "json"))
+	{
+		output = PERF_OUTPUT_JSON;
+	}
+	else if(!strcmp(output_name, "csv"))
+	{
+		output = PERF_OUTPUT_CSV;
+	}
+	else
+	{
+		fprintf(stderr, "invalid output format '%s', only 'text', 'json' and "
+		        "'csv' expected\n", output_name);
+		goto error;
+	}
+	if(output != PERF_OUTPUT_TEXT && !is_bench)
+	{
+		fprintf(stderr, "option --output-format requires option --bench\n");
+		goto error;
+	}
+	if(hugepages && (!is_bench || strcmp(test_type, "comp") != 0))
+	{
+		fprintf(stderr, "option --hugepages requires option --bench and the "
+		        "'comp' test\n");
+		goto error;
+	}
+	if(effort_name == NULL || !strcmp(effort_name, "default"))
+	{
+		effort = ROHC_COMP_EFFORT_DEFAULT;
+	}
+	else if(!strcmp(effort_name, "fast"))
+	{
+		effort = ROHC_COMP_EFFORT_FAST;
+	}
+	else if(!strcmp(effort_name, "best"))
+	{
+		effort = ROHC_COMP_EFFORT_BEST;
+	}
+	else
+	{
+		fprintf(stderr, "invalid effort level '%s', only 'fast', 'default' and "
+		        "'best' expected\n", effort_name);
+		goto error;
+	}
+	if(effort_name != NULL && (!is_bench || strcmp(test_type, "comp") != 0))
+	{
+		fprintf(stderr, "option --effort requires option --bench and the "
+		        "'comp' test\n");
+		goto error;
+	}
+	if(has_impair_opts && strcmp(test_type, "impair") != 0)
+	{
+		fprintf(stderr, "impairment options require the 'impair' action\n");
+		goto error;
+	}
+	if(is_bench && strcmp(test_type, "impair") == 0)
+	{
+		fprintf(stderr, "option --bench does not apply to the 'impair' "
+		        "action\n");
+		goto error;
+	}
+
+	/* check the parameters of the impairment mode */
+	if(reorder_depth < 0 || (size_t) reorder_depth > PERF_IMPAIR_DEPTH_MAX)
+	{
+		fprintf(stderr, "invalid reorder depth %d: should be in range [0, %u]\n",
+		        reorder_depth, PERF_IMPAIR_DEPTH_MAX);
+		goto error;
+	}
+	impair.reorder_depth = reorder_depth;
+	if(reorder_window < 0)
+	{
+		fprintf(stderr, "invalid reorder window %d: should be a positive "
+		        "integer\n", reorder_window);
+		goto error;
+	}
+	impair.reorder_window = reorder_window;
+	if(mode_name == NULL || !strcmp(mode_name, "u"))
+	{
+		impair.mode = ROHC_U_MODE;
+	}
+	else if(!strcmp(mode_name, "o"))
+	{
+		impair.mode = ROHC_O_MODE;
+	}
+	else
+	{
+		fprintf(stderr, "invalid mode '%s', only 'u' and 'o' expected\n",
+		        mode_name);
+		goto error;
+	}
+
+#ifndef PERF_HAVE_HUGEPAGES
+	if(hugepages)
+	{
+		fprintf(stderr, "option --hugepages is not supported on this "
+		        "platform\n");
+		goto error;
+	}
+#endif
+
 	/* check CID type */
 	if(!strcmp(cid_type_name, "smallcid"))
 	{
@@ -292,7 +980,26 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
-	if(strcmp(test_type, "comp") == 0)
+	if(is_bench &&
+	   (strcmp(test_type, "comp") == 0 || strcmp(test_type, "decomp") == 0))
+	{
+		const struct perf_config config = {
+			.filename = filename,
+			.is_comp = (strcmp(test_type, "comp") == 0),
+			.cid_type = cid_type,
+			.wlsb_width = wlsb_width,
+			.max_contexts = max_contexts,
+			.replays_nr = replays_nr,
+			.threads_nr = threads_nr,
+			.output = output,
+			.hugepages = hugepages,
+			.effort = effort,
+		};
+
+		/* benchmark ROHC (de)compression with the packets from the capture */
+		ret = run_benchmark(is_verbose, &config, &packet_count);
+	}
+	else if(strcmp(test_type, "comp") == 0)
 	{
 		/* test ROHC compression with the packets from the capture */
 		ret = test_compression_perfs(is_verbose, filename, cid_type, wlsb_width,
@@ -304,6 +1011,16 @@ int main(int argc, char *argv[])
 		ret = test_decompression_perfs(is_verbose, filename, cid_type,
 		                               max_contexts, &packet_count);
 	}
+	else if(strcmp(test_type, "impair") == 0)
+	{
+		impair.filename = filename;
+		impair.cid_type = cid_type;
+		impair.wlsb_width = wlsb_width;
+		impair.max_contexts = max_contexts;
+
+		/* replay the packets from the capture through the impaired channel */
+		ret = run_impairment(is_verbose, &impair, &packet_count);
+	}
 	else
 	{
 		fprintf(stderr, "unexpected test type '%s'\n", test_type);
@@ -318,8 +1035,15 @@ int main(int argc, char *argv[])
 	}
 
 	/* print performance statistics */
-	fprintf(stderr, "%scompression: %lu packets\n",
-	        (strcmp(test_type, "comp") == 0 ? "" : "de"), packet_count);
+	if(strcmp(test_type, "impair") == 0)
+	{
+		fprintf(stderr, "impairment: %lu packets\n", packet_count);
+	}
+	else
+	{
+		fprintf(stderr, "%scompression: %lu packets\n",
+		        (strcmp(test_type, "comp") == 0 ? "" : "de"), packet_count);
+	}
 
 	/* everything went fine */
 	status = 0;
@@ -338,12 +1062,14 @@ static void usage(void)
 		"Test the performance of the ROHC library.\n"
 		"\n"
 		"Usage: rohc_test_performance [General options]\n"
-		"   or: rohc_test_performance [ROHC options] ACTION CID_TYPE FLOW\n"
+		"   or: rohc_test_performance [ROHC options] [Benchmark options] ACTION CID_TYPE FLOW\n"
 		"\n"
 		"Options:\n"
 		"Mandatory parameters:\n"
-		"  ACTION            Run a compression test with 'comp' or a\n"
-		"                    decompression test with 'decomp'\n"
+		"  ACTION            Run a compression test with 'comp', a\n"
+		"                    decompression test with 'decomp', or a\n"
+		"                    test through an impaired channel with\n"
+		"                    'impair'\n"
 		"  CID_TYPE          Run a small CID test with 'smallcid' or a\n"
 		"                    large CID test with 'largecid'\n"
 		"  FLOW              A flow of Ethernet frames to (de)compress\n"
@@ -356,93 +1082,205 @@ static void usage(void)
 		"      --wlsb-width NUM    The width of the WLSB window to use\n"
 		"      --max-contexts NUM  The maximum number of ROHC contexts to\n"
 		"                          simultaneously use during the test\n"
+		"Benchmark options:\n"
+		"      --bench             Preload the capture in memory, replay it\n"
+		"                          several times and print the packet rate,\n"
+		"                          the percentiles of the time per packet\n"
+		"                          and the CPU cycles per packet\n"
+		"      --repeat NUM        The number of timed replays of the capture\n"
+		"                          (default: %u)\n"
+		"      --threads NUM       The number of threads that replay the\n"
+		"                          capture, each one with its own\n"
+		"                          (de)compressor (default: 1)\n"
+		"      --output-format FMT Print the results as 'text', 'json' or\n"
+		"                          'csv' (default: text)\n"
+		"      --hugepages         Allocate the contexts of every compressor\n"
+		"                          on huge pages of the NUMA node of its\n"
+		"                          thread\n"
+		"      --effort LEVEL      The compression effort level, 'fast',\n"
+		"                          'default' or 'best' (default: default)\n"
+		"Impairment options:\n"
+		"      --loss-p PROB       The probability to enter the bad state of\n"
+		"                          the Gilbert-Elliott loss model (default: 0)\n"
+		"      --loss-r PROB       The probability to leave the bad state\n"
+		"                          (default: 0)\n"
+		"      --loss-good PROB    The loss probability in good state\n"
+		"                          (default: 0)\n"
+		"      --loss-bad PROB     The loss probability in bad state\n"
+		"                          (default: 1)\n"
+		"      --reorder-rate PROB The probability to delay one packet\n"
+		"                          (default: 0)\n"
+		"      --reorder-depth NUM The maximum number of packets that\n"
+		"                          overtake one delayed packet (default: 0,\n"
+		"                          max: %u)\n"
+		"      --ber PROB          The bit error rate (default: 0)\n"
+		"      --seed NUM          The seed of the impairments (default: 1)\n"
+		"      --mode MODE         The mode of the decompressor, 'u' or 'o'\n"
+		"                          (default: u)\n"
+		"      --crc-repair        Repair the context upon CRC failure\n"
+		"      --reorder-window NUM  The reorder window of the decompressor\n"
+		"                          (default: 0)\n"
+		"      --refresh IR,FO     The timeouts of the periodic refreshes of\n"
+		"                          the compressor (in packets)\n"
+		"      --rate-limits K,N,K1,N1,K2,N2\n"
+		"                          The rate limits of the feedbacks of the\n"
+		"                          decompressor\n"
 		"\n"
 		"Examples:\n"
 		"  rohc_test_performance comp smallcid voip.pcap     test compression performances with small CIDs on the given VoIP stream\n"
 		"  rohc_test_performance decomp largecid a.pcap      test decompression performances with large CIDs on the given stream\n"
+		"  rohc_test_performance --bench --threads 4 comp smallcid voip.pcap\n"
+		"                                                    benchmark compression with 4 threads\n"
+		"  rohc_test_performance --bench --output-format json decomp smallcid rohc.pcap\n"
+		"                                                    benchmark decompression, print results in JSON\n"
+		"  rohc_test_performance --loss-p 0.01 --loss-r 0.3 --ber 1e-5 impair smallcid voip.pcap\n"
+		"                                                    decompress a VoIP stream after bursty losses and bit errors\n"
 		"\n"
-		"Report bugs to <" PACKAGE_BUGREPORT ">.\n");
+		"Report bugs to <" PACKAGE_BUGREPORT ">.\n", PERF_REPLAYS_DEFAULT,
+		PERF_IMPAIR_DEPTH_MAX);
 }
 
 
 /**
- * @brief Test the compression performance of the ROHC library
- *        with a flow of IP packets
+ * @brief Load the PCAP capture in memory and check its link layer
  *
- * @param is_verbose    Whether the test is run in verbose mode or not
- * @param filename      The name of the PCAP file that contains the IP packets
- * @param cid_type      The type of CIDs the compressor shall use
- * @param wlsb_width    The width of the WLSB window to use
- * @param max_contexts  The maximum number of ROHC contexts to use
- * @param packet_count  OUT: the number of compressed packets, undefined if
- *                      compression failed
+ * @param filename      The name of the PCAP file
+ * @param[out] capture  The capture loaded in memory
  * @return              0 in case of success, 1 otherwise
  */
-static int test_compression_perfs(const bool is_verbose,
-                                  char *filename,
-                                  const rohc_cid_type_t cid_type,
-                                  const size_t wlsb_width,
-                                  const size_t max_contexts,
-                                  unsigned long *packet_count)
+static int open_capture(const char *const filename,
+                        struct test_capture *const capture)
 {
-	pcap_t *handle;
-	char errbuf[PCAP_ERRBUF_SIZE];
-	int link_layer_type;
-	size_t link_len;
-	struct pcap_pkthdr header;
-	unsigned char *packet;
-	struct rohc_comp *comp;
-	int is_failure = 1;
-	int ret;
-
-	assert(max_contexts > 0);
+	char errbuf[TEST_CAPTURE_ERRBUF_SIZE];
 
-	/* open the PCAP file that contains the stream */
-	handle = pcap_open_offline(filename, errbuf);
-	if(handle == NULL)
+	/* load the PCAP file that contains the stream */
+	if(!test_capture_load(capture, filename, errbuf))
 	{
 		fprintf(stderr, "failed to open the pcap file: %s\n", errbuf);
-		goto exit;
+		goto error;
 	}
 
-	/* link layer in the capture must be Ethernet */
-	link_layer_type = pcap_datalink(handle);
-	if(link_layer_type != DLT_EN10MB &&
-	   link_layer_type != DLT_LINUX_SLL &&
-	   link_layer_type != DLT_RAW)
+	/* link layer in the capture must be Ethernet, Linux Cooked Sockets or
+	 * raw IP */
+	if(capture->link_type != TEST_CAPTURE_LINK_ETHER &&
+	   capture->link_type != TEST_CAPTURE_LINK_LINUX_SLL &&
+	   capture->link_type != TEST_CAPTURE_LINK_RAW)
 	{
-		fprintf(stderr, "link layer type %d not supported in capture "
-		        "(supported = %d, %d, %d)\n", link_layer_type,
-		        DLT_EN10MB, DLT_LINUX_SLL, DLT_RAW);
-		goto close_input;
+		fprintf(stderr, "link layer type %u not supported in capture "
+		        "(supported = Ethernet, Linux Cooked Sockets, raw IP)\n",
+		        capture->link_type_pcap);
+		goto unload;
 	}
 
-	if(link_layer_type == DLT_EN10MB)
-	{
-		link_len = ETHER_HDR_LEN;
-	}
-	else if(link_layer_type == DLT_LINUX_SLL)
-	{
-		link_len = LINUX_COOKED_HDR_LEN;
-	}
-	else /* DLT_RAW */
-	{
-		link_len = 0;
-	}
+	return 0;
 
-	/* create ROHC compressor */
-	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_false_random_num, NULL);
-	if(comp == NULL)
-	{
-		fprintf(stderr, "cannot create the ROHC compressor\n");
-		goto close_input;
-	}
+unload:
+	test_capture_unload(capture);
+error:
+	return 1;
+}
 
-	/* set the callback for traces */
-	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, (void *) &is_verbose))
+
+/**
+ * @brief Get the length of the IP packet within the given frame
+ *
+ * The Ethernet padding after the IP packet is excluded.
+ *
+ * @param num_packet  A number affected to the packet (traces only)
+ * @param pkt         The packet in the capture (link layer included)
+ * @param link_len    The length of the link layer header before IP data
+ * @return            The length of the IP packet, 0 if the packet is
+ *                    malformed
+ */
+static size_t get_ip_packet_len(const unsigned long num_packet,
+                                const struct test_capture_pkt *const pkt,
+                                const size_t link_len)
+{
+	size_t ip_len;
+
+	/* check Ethernet frame length */
+	if(pkt->len <= link_len || pkt->len != pkt->caplen)
 	{
-		fprintf(stderr, "failed to set the callback for traces\n");
-		goto free_compresssor;
+		fprintf(stderr, "packet %lu: bad PCAP packet (len = %u, caplen = %u)\n",
+		        num_packet, pkt->len, pkt->caplen);
+		goto error;
+	}
+	ip_len = pkt->caplen - link_len;
+
+	/* check for padding after the IP packet in the Ethernet payload */
+	if(link_len == ETHER_HDR_LEN && pkt->len == ETHER_FRAME_MIN_LEN)
+	{
+		const unsigned char *const ip_data = pkt->data + link_len;
+		uint8_t ip_version;
+		uint16_t tot_len;
+
+		/* determine the total length of the IP packet */
+		ip_version = (ip_data[0] >> 4) & 0x0f;
+		if(ip_version == 4) /* IPv4 */
+		{
+			const struct ipv4_hdr *const ip = (struct ipv4_hdr *) ip_data;
+			tot_len = ntohs(ip->tot_len);
+		}
+		else if(ip_version == 6) /* IPv6 */
+		{
+			const struct ipv6_hdr *const ip = (struct ipv6_hdr *) ip_data;
+			tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
+		}
+		else /* unknown IP version */
+		{
+			fprintf(stderr, "packet %lu: bad IP version (0x%x) "
+			        "in packet\n", num_packet, ip_version);
+			goto error;
+		}
+
+		/* update the length of the IP packet if padding is present */
+		if(tot_len < ip_len)
+		{
+			fprintf(stderr, "packet %lu: the Ethernet frame has %zu "
+			        "bytes of padding after the %u-byte IP packet!\n",
+			        num_packet, ip_len - tot_len, tot_len);
+			ip_len = tot_len;
+		}
+	}
+
+	return ip_len;
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Create a ROHC compressor with all profiles enabled
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param wlsb_width    The width of the WLSB window to use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @return              The new compressor, NULL in case of failure
+ */
+static struct rohc_comp * create_compressor(const bool *const is_verbose,
+                                            const rohc_cid_type_t cid_type,
+                                            const size_t wlsb_width,
+                                            const size_t max_contexts)
+{
+	struct rohc_comp *comp;
+
+	assert(max_contexts > 0);
+
+	/* create ROHC compressor */
+	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_false_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC compressor\n");
+		goto error;
+	}
+
+	/* set the callback for traces */
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, (void *) is_verbose))
+	{
+		fprintf(stderr, "failed to set the callback for traces\n");
+		goto free_compresssor;
 	}
 
 	/* activate all the compression profiles */
@@ -469,12 +1307,116 @@ static int test_compression_perfs(const bool is_verbose,
 		goto free_compresssor;
 	}
 
+	return comp;
+
+free_compresssor:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create a ROHC decompressor with all profiles enabled
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param cid_type      The type of CIDs the decompressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param mode          The mode of the decompressor
+ * @return              The new decompressor, NULL in case of failure
+ */
+static struct rohc_decomp * create_decompressor(const bool *const is_verbose,
+                                                const rohc_cid_type_t cid_type,
+                                                const size_t max_contexts,
+                                                const rohc_mode_t mode)
+{
+	struct rohc_decomp *decomp;
+
+	assert(max_contexts > 0);
+
+	/* create ROHC decompressor */
+	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, mode);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "cannot create the ROHC decompressor\n");
+		goto error;
+	}
+
+	/* set trace callback for decompressor in verbose mode */
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, (void *) is_verbose))
+	{
+		fprintf(stderr, "cannot set trace callback for decompressor\n");
+		goto free_decompressor;
+	}
+
+	/* activate all the decompression profiles */
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
+	                                ROHC_PROFILE_IP, ROHC_PROFILE_UDPLITE,
+	                                ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto free_decompressor;
+	}
+
+	return decomp;
+
+free_decompressor:
+	rohc_decomp_free(decomp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Test the compression performance of the ROHC library
+ *        with a flow of IP packets
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param filename      The name of the PCAP file that contains the IP packets
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param wlsb_width    The width of the WLSB window to use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param packet_count  OUT: the number of compressed packets, undefined if
+ *                      compression failed
+ * @return              0 in case of success, 1 otherwise
+ */
+static int test_compression_perfs(const bool is_verbose,
+                                  char *filename,
+                                  const rohc_cid_type_t cid_type,
+                                  const size_t wlsb_width,
+                                  const size_t max_contexts,
+                                  unsigned long *packet_count)
+{
+	struct test_capture capture;
+	struct rohc_comp *comp;
+	int is_failure = 1;
+	int ret;
+
+	assert(max_contexts > 0);
+
+	/* load the PCAP file that contains the stream */
+	if(open_capture(filename, &capture) != 0)
+	{
+		goto exit;
+	}
+
+	/* create ROHC compressor */
+	comp = create_compressor(&is_verbose, cid_type, wlsb_width, max_contexts);
+	if(comp == NULL)
+	{
+		goto close_input;
+	}
+
 	fflush(stderr);
 
 	/* for each packet in the dump */
 	*packet_count = 0;
-	while((packet = (unsigned char *) pcap_next(handle, &header)) != NULL)
+	while((*packet_count) < capture.pkts_nr)
 	{
+		const struct test_capture_pkt *const pkt =
+			&(capture.pkts[*packet_count]);
+
 		(*packet_count)++;
 		if((*packet_count) != 0 && ((*packet_count) % 100000) == 0)
 		{
@@ -483,8 +1425,7 @@ static int test_compression_perfs(const bool is_verbose,
 		}
 
 		/* compress the IP packet */
-		ret = time_compress_packet(comp, *packet_count,
-		                           header, packet, link_len);
+		ret = time_compress_packet(comp, *packet_count, pkt, capture.link_len);
 		if(ret != 0)
 		{
 			fprintf(stderr, "packet %lu: performance test failed\n",
@@ -499,7 +1440,7 @@ static int test_compression_perfs(const bool is_verbose,
 free_compresssor:
 	rohc_comp_free(comp);
 close_input:
-	pcap_close(handle);
+	test_capture_unload(&capture);
 exit:
 	return is_failure;
 }
@@ -512,21 +1453,19 @@ exit:
  * @param comp          The compressor to use to compress the IP packet
  * @param num_packet    A number affected to the IP packet to compress
  *                      (traces only)
- * @param header        The PCAP header for the packet
- * @param packet        The packet to compress (link layer included)
+ * @param pkt           The packet to compress (link layer included)
  * @param link_len      The length of the link layer header before IP data
  * @return              0 if compression is successful, 1 otherwise
  */
 static int time_compress_packet(struct rohc_comp *comp,
                                 unsigned long num_packet,
-                                struct pcap_pkthdr header,
-                                unsigned char *packet,
+                                const struct test_capture_pkt *const pkt,
                                 size_t link_len)
 {
 	/* the buffer that will contain the initial uncompressed packet */
 	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
 	struct rohc_buf ip_packet =
-		rohc_buf_init_full(packet, header.caplen, arrival_time);
+		rohc_buf_init_full(pkt->data, pkt->caplen, arrival_time);
 
 	/* the buffer that will contain the compressed ROHC packet */
 	uint8_t rohc_buffer[MAX_ROHC_SIZE];
@@ -535,56 +1474,18 @@ static int time_compress_packet(struct rohc_comp *comp,
 
 	int is_failure = 1;
 	rohc_status_t status;
+	size_t ip_len;
 
-	/* check Ethernet frame length */
-	if(header.len <= link_len || header.len != header.caplen)
+	/* check Ethernet frame length, exclude Ethernet padding */
+	ip_len = get_ip_packet_len(num_packet, pkt, link_len);
+	if(ip_len == 0)
 	{
-		fprintf(stderr, "packet %lu: bad PCAP packet (len = %u, caplen = %u)\n",
-		        num_packet, header.len, header.caplen);
 		goto error;
 	}
 
 	/* skip the link layer header */
 	rohc_buf_pull(&ip_packet, link_len);
-
-	/* check for padding after the IP packet in the Ethernet payload */
-	if(link_len == ETHER_HDR_LEN && header.len == ETHER_FRAME_MIN_LEN)
-	{
-		uint8_t ip_version;
-		uint16_t tot_len;
-
-		/* determine the total length of the IP packet */
-		ip_version = (rohc_buf_byte(ip_packet) >> 4) & 0x0f;
-		if(ip_version == 4) /* IPv4 */
-		{
-			struct ipv4_hdr *ip;
-
-			ip = (struct ipv4_hdr *) rohc_buf_data(ip_packet);
-			tot_len = ntohs(ip->tot_len);
-		}
-		else if(ip_version == 6) /* IPv6 */
-		{
-			struct ipv6_hdr *ip;
-
-			ip = (struct ipv6_hdr *) rohc_buf_data(ip_packet);
-			tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
-		}
-		else /* unknown IP version */
-		{
-			fprintf(stderr, "packet %lu: bad IP version (0x%x) "
-			        "in packet\n", num_packet, ip_version);
-			goto error;
-		}
-
-		/* update the length of the IP packet if padding is present */
-		if(tot_len < ip_packet.len)
-		{
-			fprintf(stderr, "packet %lu: the Ethernet frame has %zu "
-			        "bytes of padding after the %u-byte IP packet!\n",
-			        num_packet, ip_packet.len - tot_len, tot_len);
-			ip_packet.len = tot_len;
-		}
-	}
+	ip_packet.len = ip_len;
 
 	/* compress the packet */
 	status = rohc_compress4(comp, ip_packet, &rohc_packet);
@@ -621,82 +1522,36 @@ static int test_decompression_perfs(const bool is_verbose,
                                     unsigned long *packet_count)
 {
 	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
-	pcap_t *handle;
-	char errbuf[PCAP_ERRBUF_SIZE];
-	int link_layer_type;
-	size_t link_len;
-	struct pcap_pkthdr header;
-	unsigned char *packet;
+	struct test_capture capture;
 	struct rohc_decomp *decomp;
 	int is_failure = 1;
 	int ret;
 
 	assert(max_contexts > 0);
 
-	/* open the PCAP file that contains the stream */
-	handle = pcap_open_offline(filename, errbuf);
-	if(handle == NULL)
+	/* load the PCAP file that contains the stream */
+	if(open_capture(filename, &capture) != 0)
 	{
-		fprintf(stderr, "failed to open the pcap file: %s\n", errbuf);
 		goto exit;
 	}
 
-	/* link layer in the capture must be Ethernet */
-	link_layer_type = pcap_datalink(handle);
-	if(link_layer_type != DLT_EN10MB &&
-	   link_layer_type != DLT_LINUX_SLL &&
-	   link_layer_type != DLT_RAW)
-	{
-		fprintf(stderr, "link layer type %d not supported in capture "
-		        "(supported = %d, %d, %d)\n", link_layer_type,
-		        DLT_EN10MB, DLT_LINUX_SLL, DLT_RAW);
-		goto close_input;
-	}
-
-	if(link_layer_type == DLT_EN10MB)
-	{
-		link_len = ETHER_HDR_LEN;
-	}
-	else if(link_layer_type == DLT_LINUX_SLL)
-	{
-		link_len = LINUX_COOKED_HDR_LEN;
-	}
-	else /* DLT_RAW */
-	{
-		link_len = 0;
-	}
-
 	/* create ROHC decompressor */
-	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_U_MODE);
+	decomp = create_decompressor(&is_verbose, cid_type, max_contexts,
+	                             ROHC_U_MODE);
 	if(decomp == NULL)
 	{
-		fprintf(stderr, "cannot create the ROHC decompressor\n");
 		goto close_input;
 	}
 
-	/* set trace callback for decompressor in verbose mode */
-	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, (void *) &is_verbose))
-	{
-		fprintf(stderr, "cannot set trace callback for decompressor\n");
-		goto free_decompressor;
-	}
-
-	/* activate all the decompression profiles */
-	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
-	                                ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
-	                                ROHC_PROFILE_IP, ROHC_PROFILE_UDPLITE,
-	                                ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
-	{
-		fprintf(stderr, "failed to enable the decompression profiles\n");
-		goto free_decompressor;
-	}
-
 	fflush(stderr);
 
 	/* for each packet in the dump */
 	*packet_count = 0;
-	while((packet = (unsigned char *) pcap_next(handle, &header)) != NULL)
+	while((*packet_count) < capture.pkts_nr)
 	{
+		const struct test_capture_pkt *const pkt =
+			&(capture.pkts[*packet_count]);
+
 		(*packet_count)++;
 		if((*packet_count) != 0 && ((*packet_count) % 100000) == 0)
 		{
@@ -705,8 +1560,8 @@ static int test_decompression_perfs(const bool is_verbose,
 		}
 
 		/* decompress the ROHC packet */
-		ret = time_decompress_packet(decomp, *packet_count,
-		                             header, packet, link_len, arrival_time);
+		ret = time_decompress_packet(decomp, *packet_count, pkt,
+		                             capture.link_len, arrival_time);
 		if(ret != 0)
 		{
 			fprintf(stderr, "packet %lu: performance test failed\n",
@@ -721,7 +1576,7 @@ static int test_decompression_perfs(const bool is_verbose,
 free_decompressor:
 	rohc_decomp_free(decomp);
 close_input:
-	pcap_close(handle);
+	test_capture_unload(&capture);
 exit:
 	return is_failure;
 }
@@ -734,21 +1589,19 @@ exit:
  * @param decomp        The decompressor to use to decompress the ROHC packet
  * @param num_packet    A number affected to the ROHC packet to decompress
  *                      (traces only)
- * @param header        The PCAP header for the packet
- * @param packet        The packet to decompress (link layer included)
+ * @param pkt           The packet to decompress (link layer included)
  * @param link_len      The length of the link layer header before ROHC data
  * @return              0 if decompression is successful, 1 otherwise
  */
 static int time_decompress_packet(struct rohc_decomp *decomp,
                                   unsigned long num_packet,
-                                  struct pcap_pkthdr header,
-                                  unsigned char *packet,
+                                  const struct test_capture_pkt *const pkt,
                                   size_t link_len,
                                   const struct rohc_ts arrival_time)
 {
 	/* the buffer that will contain the compressed ROHC packet */
 	struct rohc_buf rohc_packet =
-		rohc_buf_init_full(packet, header.caplen, arrival_time);
+		rohc_buf_init_full(pkt->data, pkt->caplen, arrival_time);
 
 	/* the buffer that will contain the uncompressed packet */
 	uint8_t ip_buffer[MAX_ROHC_SIZE];
@@ -758,10 +1611,10 @@ static int time_decompress_packet(struct rohc_decomp *decomp,
 	rohc_status_t status;
 
 	/* check Ethernet frame length */
-	if(header.len <= link_len || header.len != header.caplen)
+	if(pkt->len <= link_len || pkt->len != pkt->caplen)
 	{
 		fprintf(stderr, "packet %lu: bad PCAP packet (len = %u, caplen = %u)\n",
-		        num_packet, header.len, header.caplen);
+		        num_packet, pkt->len, pkt->caplen);
 		goto error;
 	}
 
@@ -784,6 +1637,1724 @@ error:
 }
 
 
+/**
+ * @brief Benchmark the (de)compression of the packets of the given capture
+ *
+ * The capture is preloaded in memory, then every thread replays it through
+ * its own (de)compressor.
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param config        The parameters of the benchmark
+ * @param packet_count  OUT: the number of timed packets
+ * @return              0 in case of success, 1 in case of failure
+ */
+static int run_benchmark(const bool is_verbose,
+                         const struct perf_config *const config,
+                         unsigned long *const packet_count)
+{
+	const size_t threads_nr = config->threads_nr;
+	struct test_capture capture;
+	struct perf_pkt *pkts;
+	size_t pkts_nr;
+	struct perf_worker *workers;
+	struct perf_stats *stats;
+	uint64_t start_ns;
+	uint64_t load_ns;
+	uint64_t elapsed_ns;
+	size_t i;
+	int is_failure = 1;
+
+	assert(config->replays_nr > 0);
+	assert(threads_nr > 0);
+
+#if HAVE_PTHREAD_H != 1
+	if(threads_nr > 1)
+	{
+		fprintf(stderr, "multi-threaded benchmark is not supported on this "
+		        "platform\n");
+		goto error;
+	}
+#endif
+
+	/* preload the whole capture in memory */
+	start_ns = perf_get_ns();
+	if(load_capture(config->filename, config->is_comp, &capture, &pkts,
+	                &pkts_nr) != 0)
+	{
+		goto error;
+	}
+	load_ns = perf_get_ns() - start_ns;
+	if(pkts_nr == 0)
+	{
+		fprintf(stderr, "no packet to benchmark in capture\n");
+		goto free_capture;
+	}
+
+	workers = calloc(threads_nr, sizeof(struct perf_worker));
+	if(workers == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for %zu threads\n", threads_nr);
+		goto free_capture;
+	}
+	stats = calloc(1, sizeof(struct perf_stats));
+	if(stats == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for statistics\n");
+		goto free_workers;
+	}
+
+	for(i = 0; i < threads_nr; i++)
+	{
+		workers[i].is_verbose = &is_verbose;
+		workers[i].config = config;
+		workers[i].pkts = pkts;
+		workers[i].pkts_nr = pkts_nr;
+		workers[i].status = 1;
+	}
+
+	/* run all the threads */
+	start_ns = perf_get_ns();
+#if HAVE_PTHREAD_H == 1
+	for(i = 0; i < threads_nr; i++)
+	{
+		const int ret =
+			pthread_create(&workers[i].thread, NULL, run_benchmark_worker,
+			               &workers[i]);
+		if(ret != 0)
+		{
+			fprintf(stderr, "failed to create thread #%zu: %s (%d)\n", i + 1,
+			        strerror(ret), ret);
+			break;
+		}
+	}
+	while(i > 0)
+	{
+		i--;
+		pthread_join(workers[i].thread, NULL);
+	}
+#else
+	run_benchmark_worker(&workers[0]);
+#endif
+	elapsed_ns = perf_get_ns() - start_ns;
+
+	/* merge the statistics of all the threads, all the threads replay the
+	 * same packets so the sizes and profiles of the first thread are enough */
+	stats->has_stages = true;
+	for(i = 0; i < threads_nr; i++)
+	{
+		size_t bucket;
+		size_t stage;
+
+		if(workers[i].status != 0)
+		{
+			fprintf(stderr, "thread #%zu failed\n", i + 1);
+			goto free_stats;
+		}
+		stats->pkts_nr += workers[i].stats.pkts_nr;
+		stats->total_ns += workers[i].stats.total_ns;
+		stats->total_cycles += workers[i].stats.total_cycles;
+		for(bucket = 0; bucket < PERF_HIST_BUCKETS; bucket++)
+		{
+			stats->hist[bucket] += workers[i].stats.hist[bucket];
+		}
+		stats->setup_ns += workers[i].stats.setup_ns;
+		stats->warmup_ns += workers[i].stats.warmup_ns;
+		if(i == 0)
+		{
+			stats->uncomp_bytes = workers[i].stats.uncomp_bytes;
+			stats->comp_bytes = workers[i].stats.comp_bytes;
+			memcpy(stats->profiles, workers[i].stats.profiles,
+			       sizeof(stats->profiles));
+		}
+		stats->has_stages &= workers[i].stats.has_stages;
+		for(stage = 0; stage < PERF_STAGES_MAX; stage++)
+		{
+			stats->stages_nr[stage] += workers[i].stats.stages_nr[stage];
+			stats->stages_ticks[stage] += workers[i].stats.stages_ticks[stage];
+		}
+	}
+	*packet_count = stats->pkts_nr;
+
+	print_benchmark_stats(config, stats, pkts_nr, load_ns, elapsed_ns);
+
+	/* everything went fine */
+	is_failure = 0;
+
+free_stats:
+	free(stats);
+free_workers:
+	free(workers);
+free_capture:
+	free_capture(&capture, pkts);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Load all the packets of the given capture in memory
+ *
+ * The link layer headers and the Ethernet padding are removed once for all,
+ * so that the benchmark does not time them. The packets are not copied, they
+ * point into the capture loaded in memory.
+ *
+ * @param filename      The name of the PCAP file that contains the packets
+ * @param is_comp       Whether the capture contains IP or ROHC packets
+ * @param[out] capture  The capture loaded in memory
+ * @param[out] pkts     The packets loaded in memory
+ * @param[out] pkts_nr  The number of packets loaded in memory
+ * @return              0 in case of success, 1 otherwise
+ */
+static int load_capture(const char *const filename,
+                        const bool is_comp,
+                        struct test_capture *const capture,
+                        struct perf_pkt **const pkts,
+                        size_t *const pkts_nr)
+{
+	size_t i;
+
+	*pkts = NULL;
+	*pkts_nr = 0;
+
+	/* load the PCAP file that contains the stream */
+	if(open_capture(filename, capture) != 0)
+	{
+		goto error;
+	}
+	if(capture->pkts_nr == 0)
+	{
+		/* nothing to replay */
+		return 0;
+	}
+
+	*pkts = malloc(capture->pkts_nr * sizeof(struct perf_pkt));
+	if((*pkts) == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for %zu packets\n",
+		        capture->pkts_nr);
+		goto unload;
+	}
+
+	for(i = 0; i < capture->pkts_nr; i++)
+	{
+		const struct test_capture_pkt *const cap_pkt = &(capture->pkts[i]);
+		struct perf_pkt *const pkt = &((*pkts)[i]);
+
+		if(is_comp)
+		{
+			/* IP packet: remove the Ethernet padding too */
+			pkt->len = get_ip_packet_len(i + 1, cap_pkt, capture->link_len);
+			if(pkt->len == 0)
+			{
+				goto free_pkts;
+			}
+		}
+		else if(cap_pkt->len <= capture->link_len ||
+		        cap_pkt->len != cap_pkt->caplen)
+		{
+			fprintf(stderr, "packet %zu: bad PCAP packet (len = %u, caplen = %u)\n",
+			        i + 1, cap_pkt->len, cap_pkt->caplen);
+			goto free_pkts;
+		}
+		else
+		{
+			pkt->len = cap_pkt->caplen - capture->link_len;
+		}
+		pkt->data = cap_pkt->data + capture->link_len;
+	}
+	*pkts_nr = capture->pkts_nr;
+
+	return 0;
+
+free_pkts:
+	free(*pkts);
+	*pkts = NULL;
+unload:
+	test_capture_unload(capture);
+error:
+	return 1;
+}
+
+
+/**
+ * @brief Free the packets loaded in memory by \ref load_capture
+ *
+ * @param capture  The capture loaded in memory
+ * @param pkts     The packets loaded in memory
+ */
+static void free_capture(struct test_capture *const capture,
+                         struct perf_pkt *const pkts)
+{
+	free(pkts);
+	test_capture_unload(capture);
+}
+
+
+/**
+ * @brief Replay the preloaded packets through a dedicated (de)compressor
+ *
+ * A first replay warms up the caches and the branch predictors and is not
+ * timed. It also records the sizes and the profiles of the packets. A new
+ * (de)compressor is created for every replay, outside of the timed section,
+ * so that all replays perform the same work.
+ *
+ * @param worker_arg  The benchmark thread
+ * @return            Always NULL, the result is stored in the thread
+ */
+static void * run_benchmark_worker(void *const worker_arg)
+{
+	struct perf_worker *const worker = worker_arg;
+	const struct perf_config *const config = worker->config;
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	uint8_t out_buffer[MAX_ROHC_SIZE];
+	size_t replay;
+
+	worker->stats.has_stages = true;
+
+	/* the arena of the contexts is bound to the NUMA node of the thread */
+	if(config->hugepages &&
+	   !perf_arena_init(&worker->arena,
+	                    config->max_contexts * PERF_ARENA_CTXT_LEN))
+	{
+		goto error;
+	}
+
+	/* replay #0 is the warmup replay */
+	for(replay = 0; replay <= config->replays_nr; replay++)
+	{
+		struct rohc_comp *comp = NULL;
+		struct rohc_decomp *decomp = NULL;
+		uint64_t replay_start_ns;
+		size_t i;
+
+		replay_start_ns = perf_get_ns();
+		if(config->is_comp)
+		{
+			comp = create_compressor(worker->is_verbose, config->cid_type,
+			                         config->wlsb_width, config->max_contexts);
+			if(comp == NULL)
+			{
+				goto release_arena;
+			}
+			if(config->hugepages &&
+			   !rohc_comp_set_alloc_cbs(comp, perf_arena_alloc, perf_arena_free,
+			                            &worker->arena))
+			{
+				fprintf(stderr, "failed to allocate the contexts from the arena\n");
+				rohc_comp_free(comp);
+				goto release_arena;
+			}
+			if(!rohc_comp_set_effort(comp, config->effort))
+			{
+				fprintf(stderr, "failed to set the compression effort level\n");
+				rohc_comp_free(comp);
+				goto release_arena;
+			}
+		}
+		else
+		{
+			decomp = create_decompressor(worker->is_verbose, config->cid_type,
+			                             config->max_contexts, ROHC_U_MODE);
+			if(decomp == NULL)
+			{
+				goto release_arena;
+			}
+		}
+		worker->stats.setup_ns += perf_get_ns() - replay_start_ns;
+
+		replay_start_ns = perf_get_ns();
+		for(i = 0; i < worker->pkts_nr; i++)
+		{
+			const struct rohc_buf in_packet =
+				rohc_buf_init_full(worker->pkts[i].data, worker->pkts[i].len,
+				                   arrival_time);
+			struct rohc_buf out_packet =
+				rohc_buf_init_empty(out_buffer, MAX_ROHC_SIZE);
+			rohc_status_t status;
+			uint64_t start_cycles;
+			uint64_t start_ns;
+			uint64_t elapsed_cycles;
+			uint64_t elapsed_ns;
+
+			start_ns = perf_get_ns();
+			start_cycles = perf_get_cycles();
+			if(config->is_comp)
+			{
+				status = rohc_compress4(comp, in_packet, &out_packet);
+			}
+			else
+			{
+				status = rohc_decompress3(decomp, in_packet, &out_packet, NULL, NULL);
+			}
+			elapsed_cycles = perf_get_cycles() - start_cycles;
+			elapsed_ns = perf_get_ns() - start_ns;
+
+			if(status != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "packet %zu: %scompression failed\n", i + 1,
+				        config->is_comp ? "" : "de");
+				rohc_comp_free(comp);
+				rohc_decomp_free(decomp);
+				goto release_arena;
+			}
+
+			if(replay > 0)
+			{
+				worker->stats.pkts_nr++;
+				worker->stats.total_ns += elapsed_ns;
+				worker->stats.total_cycles += elapsed_cycles;
+				worker->stats.hist[perf_hist_get_bucket(elapsed_ns)]++;
+			}
+			else if(config->is_comp)
+			{
+				rohc_comp_last_packet_info2_t info = {
+					.version_major = 0,
+					.version_minor = 0,
+				};
+
+				worker->stats.uncomp_bytes += in_packet.len;
+				worker->stats.comp_bytes += out_packet.len;
+				if(rohc_comp_get_last_packet_info2(comp, &info) &&
+				   info.profile_id >= 0 && info.profile_id < ROHC_PROFILE_MAX)
+				{
+					worker->stats.profiles[info.profile_id]++;
+				}
+			}
+			else
+			{
+				rohc_decomp_last_packet_info_t info = {
+					.version_major = 0,
+					.version_minor = 0,
+				};
+
+				worker->stats.uncomp_bytes += out_packet.len;
+				worker->stats.comp_bytes += in_packet.len;
+				if(out_packet.len > 0 &&
+				   rohc_decomp_get_last_packet_info(decomp, &info) &&
+				   info.profile_id >= 0 && info.profile_id < ROHC_PROFILE_MAX)
+				{
+					worker->stats.profiles[info.profile_id]++;
+				}
+			}
+		}
+
+		if(replay == 0)
+		{
+			worker->stats.warmup_ns = perf_get_ns() - replay_start_ns;
+		}
+		else if(worker->stats.has_stages)
+		{
+			perf_stats_add_stages(&worker->stats, comp, decomp);
+		}
+
+		rohc_comp_free(comp);
+		rohc_decomp_free(decomp);
+
+		/* the compressor gave all its memory back */
+		worker->arena.used = 0;
+	}
+
+	/* everything went fine */
+	worker->status = 0;
+
+release_arena:
+	perf_arena_release(&worker->arena);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create the arena of the contexts of one compressor
+ *
+ * The arena is made of 2 MB huge pages if some are reserved, of transparent
+ * huge pages otherwise. It is bound to the NUMA node of the calling thread,
+ * so the thread that drives the compressor shall create its arena.
+ *
+ * @param arena  The arena to create
+ * @param len    The minimal length of the arena (in bytes)
+ * @return       true if the arena was created, false otherwise
+ */
+static bool perf_arena_init(struct perf_arena *const arena, const size_t len)
+{
+#ifdef PERF_HAVE_HUGEPAGES
+	unsigned int cpu;
+	unsigned int node;
+
+	arena->len = ((len + PERF_HUGEPAGE_LEN - 1) / PERF_HUGEPAGE_LEN) *
+	             PERF_HUGEPAGE_LEN;
+	arena->used = 0;
+	arena->node = -1;
+
+	arena->mem = mmap(NULL, arena->len, PROT_READ | PROT_WRITE,
+	                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+	if(arena->mem == MAP_FAILED)
+	{
+		/* no huge page reserved, fall back on transparent huge pages */
+		arena->mem = mmap(NULL, arena->len, PROT_READ | PROT_WRITE,
+		                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if(arena->mem == MAP_FAILED)
+		{
+			fprintf(stderr, "failed to map %zu bytes for the contexts: %s (%d)\n",
+			        arena->len, strerror(errno), errno);
+			arena->mem = NULL;
+			goto error;
+		}
+#ifdef MADV_HUGEPAGE
+		(void) madvise(arena->mem, arena->len, MADV_HUGEPAGE);
+#endif
+	}
+
+	/* bind the arena to the NUMA node of the thread before the pages are
+	 * touched, on a best-effort basis */
+	if(syscall(SYS_getcpu, &cpu, &node, NULL) == 0 &&
+	   node < (sizeof(unsigned long) * 8))
+	{
+		const unsigned long nodemask = 1UL << node;
+
+		if(syscall(SYS_mbind, arena->mem, arena->len, PERF_MPOL_BIND, &nodemask,
+		           sizeof(nodemask) * 8 + 1, 0) == 0)
+		{
+			arena->node = node;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+#else
+	arena->mem = NULL;
+	arena->len = len;
+	arena->used = 0;
+	arena->node = -1;
+	return false;
+#endif
+}
+
+
+/**
+ * @brief Release the arena of the contexts of one compressor
+ *
+ * @param arena  The arena to release
+ */
+static void perf_arena_release(struct perf_arena *const arena)
+{
+#ifdef PERF_HAVE_HUGEPAGES
+	if(arena->mem != NULL)
+	{
+		munmap(arena->mem, arena->len);
+		arena->mem = NULL;
+	}
+#endif
+}
+
+
+/**
+ * @brief Allocate memory for the compressor from the arena
+ *
+ * @param size  The size of the memory to allocate
+ * @param priv  The arena
+ * @return      The allocated memory, NULL if the arena is exhausted
+ */
+static void * perf_arena_alloc(const size_t size, void *const priv)
+{
+	struct perf_arena *const arena = priv;
+	const size_t len = (size + PERF_ARENA_ALIGN - 1) & ~((size_t) PERF_ARENA_ALIGN - 1);
+	void *ptr;
+
+	if(len > (arena->len - arena->used))
+	{
+		return NULL;
+	}
+	ptr = arena->mem + arena->used;
+	arena->used += len;
+
+	return ptr;
+}
+
+
+/**
+ * @brief Free memory of the compressor
+ *
+ * The memory stays in the arena, the whole arena is reused once the
+ * compressor is destroyed.
+ *
+ * @param ptr   The memory to free
+ * @param priv  The arena
+ */
+static void perf_arena_free(void *const ptr __attribute__((unused)),
+                            void *const priv __attribute__((unused)))
+{
+}
+
+
+/**
+ * @brief Add the durations of the library stages of one timed replay
+ *
+ * The durations are available only if the library was configured with the
+ * --enable-rohc-perf-stats option. The statistics are marked as without
+ * durations otherwise.
+ *
+ * @param stats   The statistics of the benchmark thread
+ * @param comp    The compressor of the replay, NULL for decompression
+ * @param decomp  The decompressor of the replay, NULL for compression
+ */
+static void perf_stats_add_stages(struct perf_stats *const stats,
+                                  const struct rohc_comp *const comp,
+                                  const struct rohc_decomp *const decomp)
+{
+	size_t stage;
+
+	if(comp != NULL)
+	{
+		struct rohc_comp_perf_stats comp_stats;
+
+		if(!rohc_comp_get_perf_stats(comp, &comp_stats))
+		{
+			stats->has_stages = false;
+			return;
+		}
+		for(stage = 0; stage < ROHC_COMP_PERF_STAGE_MAX; stage++)
+		{
+			stats->stages_nr[stage] += comp_stats.stages[stage].count;
+			stats->stages_ticks[stage] += comp_stats.stages[stage].total;
+		}
+	}
+	else
+	{
+		struct rohc_decomp_perf_stats decomp_stats;
+
+		if(!rohc_decomp_get_perf_stats(decomp, &decomp_stats))
+		{
+			stats->has_stages = false;
+			return;
+		}
+		for(stage = 0; stage < ROHC_DECOMP_PERF_STAGE_MAX; stage++)
+		{
+			stats->stages_nr[stage] += decomp_stats.stages[stage].count;
+			stats->stages_ticks[stage] += decomp_stats.stages[stage].total;
+		}
+	}
+}
+
+
+/**
+ * @brief Print the results of the benchmark in the requested format
+ *
+ * The packet rate includes the untimed warmup replay of every thread.
+ *
+ * @param config      The parameters of the benchmark
+ * @param stats       The merged statistics of all the threads
+ * @param pkts_nr     The number of packets in the capture
+ * @param load_ns     The time to preload the capture (in ns)
+ * @param elapsed_ns  The time of the whole run of the threads (in ns)
+ */
+static void print_benchmark_stats(const struct perf_config *const config,
+                                  const struct perf_stats *const stats,
+                                  const size_t pkts_nr,
+                                  const uint64_t load_ns,
+                                  const uint64_t elapsed_ns)
+{
+	const size_t replays_nr = config->replays_nr + 1;
+	struct perf_results results;
+
+	assert(stats->pkts_nr > 0);
+
+	results.pkts_nr = pkts_nr;
+	if(elapsed_ns == 0)
+	{
+		results.pkts_per_sec = 0.0;
+	}
+	else
+	{
+		results.pkts_per_sec =
+			(double) (config->threads_nr * replays_nr * pkts_nr) * 1e9 /
+			(double) elapsed_ns;
+	}
+	results.ns_avg = (double) stats->total_ns / (double) stats->pkts_nr;
+	results.ns_p50 = perf_stats_get_percentile(stats, 0.5);
+	results.ns_p99 = perf_stats_get_percentile(stats, 0.99);
+	results.ns_p999 = perf_stats_get_percentile(stats, 0.999);
+	results.cycles_avg = (double) stats->total_cycles / (double) stats->pkts_nr;
+	results.load_ns = load_ns;
+	results.setup_ns = stats->setup_ns / (config->threads_nr * replays_nr);
+	results.warmup_ns = stats->warmup_ns / config->threads_nr;
+	results.elapsed_ns = elapsed_ns;
+	if(stats->uncomp_bytes == 0)
+	{
+		results.comp_ratio = 0.0;
+	}
+	else
+	{
+		results.comp_ratio =
+			(double) stats->comp_bytes / (double) stats->uncomp_bytes;
+	}
+	results.max_rss_kib = perf_get_max_rss();
+
+	switch(config->output)
+	{
+		case PERF_OUTPUT_JSON:
+			print_benchmark_json(config, stats, &results);
+			break;
+		case PERF_OUTPUT_CSV:
+			print_benchmark_csv(config, stats, &results);
+			break;
+		case PERF_OUTPUT_TEXT:
+		default:
+			print_benchmark_text(config, stats, &results);
+			break;
+	}
+}
+
+
+/**
+ * @brief Print the results of the benchmark in plain text
+ *
+ * @param config   The parameters of the benchmark
+ * @param stats    The merged statistics of all the threads
+ * @param results  The results computed from the statistics
+ */
+static void print_benchmark_text(const struct perf_config *const config,
+                                 const struct perf_stats *const stats,
+                                 const struct perf_results *const results)
+{
+	const char *const action =
+		(config->is_comp ? "compression" : "decompression");
+	size_t profile;
+	size_t stage;
+
+	printf("%s benchmark: %zu thread(s), %zu replay(s) of %zu packet(s)\n",
+	       action, config->threads_nr, config->replays_nr, results->pkts_nr);
+	if(config->is_comp)
+	{
+		printf("%s: effort level %s\n", action,
+		       perf_get_effort_descr(config->effort));
+	}
+	printf("%s: %.0f packets/s\n", action, results->pkts_per_sec);
+	printf("%s: %.1f ns/packet on average, p50 = %" PRIu64 " ns, "
+	       "p99 = %" PRIu64 " ns, p99.9 = %" PRIu64 " ns\n", action,
+	       results->ns_avg, results->ns_p50, results->ns_p99, results->ns_p999);
+	if(results->cycles_avg > 0)
+	{
+		printf("%s: %.1f cycles/packet on average\n", action,
+		       results->cycles_avg);
+	}
+	else
+	{
+		printf("%s: cycles/packet not available on this CPU\n", action);
+	}
+	printf("%s: compression ratio %.3f (%" PRIu64 " bytes compressed, "
+	       "%" PRIu64 " bytes uncompressed per replay)\n", action,
+	       results->comp_ratio, stats->comp_bytes, stats->uncomp_bytes);
+	for(profile = 0; profile < ROHC_PROFILE_MAX; profile++)
+	{
+		if(stats->profiles[profile] > 0)
+		{
+			printf("%s: profile %s: %" PRIu64 " packet(s) per replay\n", action,
+			       rohc_get_profile_descr(profile), stats->profiles[profile]);
+		}
+	}
+	printf("%s: capture preload = %" PRIu64 " ns, setup = %" PRIu64 " ns per "
+	       "(de)compressor, warmup = %" PRIu64 " ns per thread, "
+	       "run = %" PRIu64 " ns\n", action, results->load_ns, results->setup_ns,
+	       results->warmup_ns, results->elapsed_ns);
+	if(stats->has_stages)
+	{
+		for(stage = 0; stage < PERF_STAGES_MAX; stage++)
+		{
+			if(stats->stages_nr[stage] > 0)
+			{
+				printf("%s: library stage %s: %.1f ticks on average "
+				       "(%" PRIu64 " measures)\n", action,
+				       perf_get_stage_name(config->is_comp, stage),
+				       (double) stats->stages_ticks[stage] /
+				       (double) stats->stages_nr[stage],
+				       stats->stages_nr[stage]);
+			}
+		}
+	}
+	if(results->max_rss_kib >= 0)
+	{
+		printf("%s: memory high-water mark = %ld KiB\n", action,
+		       results->max_rss_kib);
+	}
+}
+
+
+/**
+ * @brief Print the results of the benchmark as one JSON object
+ *
+ * @param config   The parameters of the benchmark
+ * @param stats    The merged statistics of all the threads
+ * @param results  The results computed from the statistics
+ */
+static void print_benchmark_json(const struct perf_config *const config,
+                                 const struct perf_stats *const stats,
+                                 const struct perf_results *const results)
+{
+	bool is_first;
+	size_t profile;
+	size_t stage;
+
+	printf("{\n");
+	printf("  \"action\": \"%s\",\n",
+	       config->is_comp ? "compression" : "decompression");
+	printf("  \"capture\": ");
+	print_escaped_string(config->filename, true);
+	printf(",\n");
+	printf("  \"library_version\": ");
+	print_escaped_string(rohc_version(), true);
+	printf(",\n");
+
+	printf("  \"config\": {\n");
+	printf("    \"cid_type\": \"%s\",\n",
+	       config->cid_type == ROHC_SMALL_CID ? "smallcid" : "largecid");
+	printf("    \"max_contexts\": %zu,\n", config->max_contexts);
+	printf("    \"wlsb_width\": %zu,\n", config->wlsb_width);
+	printf("    \"threads\": %zu,\n", config->threads_nr);
+	printf("    \"hugepages\": %s,\n", config->hugepages ? "true" : "false");
+	printf("    \"effort\": \"%s\",\n", perf_get_effort_descr(config->effort));
+	printf("    \"replays\": %zu\n", config->replays_nr);
+	printf("  },\n");
+
+	printf("  \"packets\": %zu,\n", results->pkts_nr);
+	printf("  \"timed_packets\": %" PRIu64 ",\n", stats->pkts_nr);
+	printf("  \"packets_per_sec\": %.0f,\n", results->pkts_per_sec);
+	printf("  \"ns_per_packet\": {\n");
+	printf("    \"avg\": %.1f,\n", results->ns_avg);
+	printf("    \"p50\": %" PRIu64 ",\n", results->ns_p50);
+	printf("    \"p99\": %" PRIu64 ",\n", results->ns_p99);
+	printf("    \"p99_9\": %" PRIu64 "\n", results->ns_p999);
+	printf("  },\n");
+	if(results->cycles_avg > 0)
+	{
+		printf("  \"cycles_per_packet\": %.1f,\n", results->cycles_avg);
+	}
+	else
+	{
+		printf("  \"cycles_per_packet\": null,\n");
+	}
+
+	printf("  \"stages_ns\": {\n");
+	printf("    \"load\": %" PRIu64 ",\n", results->load_ns);
+	printf("    \"setup\": %" PRIu64 ",\n", results->setup_ns);
+	printf("    \"warmup\": %" PRIu64 ",\n", results->warmup_ns);
+	printf("    \"run\": %" PRIu64 "\n", results->elapsed_ns);
+	printf("  },\n");
+	if(stats->has_stages)
+	{
+		printf("  \"library_stages\": {\n");
+#if defined(__x86_64__) || defined(__i386__)
+		printf("    \"unit\": \"cycles\"");
+#else
+		printf("    \"unit\": \"ns\"");
+#endif
+		for(stage = 0; stage < PERF_STAGES_MAX; stage++)
+		{
+			if(stats->stages_nr[stage] > 0)
+			{
+				printf(",\n    \"%s\": { \"measures\": %" PRIu64 ", "
+				       "\"avg\": %.1f }",
+				       perf_get_stage_name(config->is_comp, stage),
+				       stats->stages_nr[stage],
+				       (double) stats->stages_ticks[stage] /
+				       (double) stats->stages_nr[stage]);
+			}
+		}
+		printf("\n  },\n");
+	}
+	else
+	{
+		printf("  \"library_stages\": null,\n");
+	}
+
+	printf("  \"profiles\": {");
+	is_first = true;
+	for(profile = 0; profile < ROHC_PROFILE_MAX; profile++)
+	{
+		if(stats->profiles[profile] > 0)
+		{
+			printf("%s\n    ", is_first ? "" : ",");
+			print_escaped_string(rohc_get_profile_descr(profile), true);
+			printf(": %" PRIu64, stats->profiles[profile]);
+			is_first = false;
+		}
+	}
+	printf("%s},\n", is_first ? "" : "\n  ");
+	printf("  \"uncomp_bytes\": %" PRIu64 ",\n", stats->uncomp_bytes);
+	printf("  \"comp_bytes\": %" PRIu64 ",\n", stats->comp_bytes);
+	printf("  \"comp_ratio\": %.4f,\n", results->comp_ratio);
+	if(results->max_rss_kib >= 0)
+	{
+		printf("  \"max_rss_kib\": %ld\n", results->max_rss_kib);
+	}
+	else
+	{
+		printf("  \"max_rss_kib\": null\n");
+	}
+	printf("}\n");
+}
+
+
+/**
+ * @brief Print the results of the benchmark as one CSV header and one record
+ *
+ * The profiles and the library stages are printed as lists of name=value
+ * pairs separated by semicolons. The fields are empty if a value is not
+ * available.
+ *
+ * @param config   The parameters of the benchmark
+ * @param stats    The merged statistics of all the threads
+ * @param results  The results computed from the statistics
+ */
+static void print_benchmark_csv(const struct perf_config *const config,
+                                const struct perf_stats *const stats,
+                                const struct perf_results *const results)
+{
+	bool is_first;
+	size_t profile;
+	size_t stage;
+
+	printf("action,capture,library_version,cid_type,max_contexts,wlsb_width,"
+	       "threads,replays,effort,packets,timed_packets,packets_per_sec,ns_avg,"
+	       "ns_p50,ns_p99,ns_p99_9,cycles_avg,load_ns,setup_ns,warmup_ns,"
+	       "run_ns,uncomp_bytes,comp_bytes,comp_ratio,max_rss_kib,profiles,"
+	       "library_stages\n");
+
+	printf("%s,", config->is_comp ? "compression" : "decompression");
+	print_escaped_string(config->filename, false);
+	printf(",");
+	print_escaped_string(rohc_version(), false);
+	printf(",%s,%zu,%zu,%zu,%zu,%s,",
+	       config->cid_type == ROHC_SMALL_CID ? "smallcid" : "largecid",
+	       config->max_contexts, config->wlsb_width, config->threads_nr,
+	       config->replays_nr, perf_get_effort_descr(config->effort));
+	printf("%zu,%" PRIu64 ",%.0f,%.1f,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",",
+	       results->pkts_nr, stats->pkts_nr, results->pkts_per_sec,
+	       results->ns_avg, results->ns_p50, results->ns_p99, results->ns_p999);
+	if(results->cycles_avg > 0)
+	{
+		printf("%.1f", results->cycles_avg);
+	}
+	printf(",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",",
+	       results->load_ns, results->setup_ns, results->warmup_ns,
+	       results->elapsed_ns);
+	printf("%" PRIu64 ",%" PRIu64 ",%.4f,", stats->uncomp_bytes,
+	       stats->comp_bytes, results->comp_ratio);
+	if(results->max_rss_kib >= 0)
+	{
+		printf("%ld", results->max_rss_kib);
+	}
+	printf(",");
+
+	is_first = true;
+	for(profile = 0; profile < ROHC_PROFILE_MAX; profile++)
+	{
+		if(stats->profiles[profile] > 0)
+		{
+			printf("%s%s=%" PRIu64, is_first ? "" : ";",
+			       rohc_get_profile_descr(profile), stats->profiles[profile]);
+			is_first = false;
+		}
+	}
+	printf(",");
+
+	if(stats->has_stages)
+	{
+		is_first = true;
+		for(stage = 0; stage < PERF_STAGES_MAX; stage++)
+		{
+			if(stats->stages_nr[stage] > 0)
+			{
+				printf("%s%s=%.1f", is_first ? "" : ";",
+				       perf_get_stage_name(config->is_comp, stage),
+				       (double) stats->stages_ticks[stage] /
+				       (double) stats->stages_nr[stage]);
+				is_first = false;
+			}
+		}
+	}
+	printf("\n");
+}
+
+
+/**
+ * @brief Print one string as a JSON string or as a CSV field
+ *
+ * JSON strings are always quoted. CSV fields are quoted only if they contain
+ * a comma, a quote or a line break.
+ *
+ * @param str      The string to print
+ * @param is_json  Whether to print a JSON string or a CSV field
+ */
+static void print_escaped_string(const char *const str, const bool is_json)
+{
+	const char *c;
+
+	if(is_json)
+	{
+		putchar('"');
+		for(c = str; (*c) != '\0'; c++)
+		{
+			if((*c) == '"' || (*c) == '\\')
+			{
+				printf("\\%c", *c);
+			}
+			else if(((unsigned char) (*c)) < 0x20)
+			{
+				printf("\\u%04x", (unsigned int) (*c));
+			}
+			else
+			{
+				putchar(*c);
+			}
+		}
+		putchar('"');
+	}
+	else if(strpbrk(str, ",\"\r\n") != NULL)
+	{
+		putchar('"');
+		for(c = str; (*c) != '\0'; c++)
+		{
+			if((*c) == '"')
+			{
+				putchar('"');
+			}
+			putchar(*c);
+		}
+		putchar('"');
+	}
+	else
+	{
+		printf("%s", str);
+	}
+}
+
+
+/**
+ * @brief Get the short name of one library stage
+ *
+ * @param is_comp  Whether the stage is a compression or decompression stage
+ * @param stage    The compression or decompression stage
+ * @return         The short name of the stage
+ */
+static const char * perf_get_stage_name(const bool is_comp, const size_t stage)
+{
+	static const char *const comp_stages[ROHC_COMP_PERF_STAGE_MAX] = {
+		[ROHC_COMP_PERF_PARSE]          = "parse",
+		[ROHC_COMP_PERF_CTXT_LOOKUP]    = "ctxt_lookup",
+		[ROHC_COMP_PERF_ENCODE]         = "encode",
+		[ROHC_COMP_PERF_DETECT_CHANGES] = "detect_changes",
+		[ROHC_COMP_PERF_DECIDE_STATE]   = "decide_state",
+		[ROHC_COMP_PERF_ENCODE_FIELDS]  = "encode_fields",
+		[ROHC_COMP_PERF_DECIDE_PKT]     = "decide_pkt",
+		[ROHC_COMP_PERF_CODE_PKT]       = "code_pkt",
+		[ROHC_COMP_PERF_PAYLOAD_COPY]   = "payload_copy",
+	};
+	static const char *const decomp_stages[ROHC_DECOMP_PERF_STAGE_MAX] = {
+		[ROHC_DECOMP_PERF_DECODE_HEADER] = "decode_header",
+		[ROHC_DECOMP_PERF_CTXT_LOOKUP]   = "ctxt_lookup",
+		[ROHC_DECOMP_PERF_FAST_PATH]     = "fast_path",
+		[ROHC_DECOMP_PERF_PARSE]         = "parse",
+		[ROHC_DECOMP_PERF_CRC_CHECK]     = "crc_check",
+		[ROHC_DECOMP_PERF_DECODE]        = "decode",
+		[ROHC_DECOMP_PERF_BUILD]         = "build",
+		[ROHC_DECOMP_PERF_PAYLOAD_COPY]  = "payload_copy",
+	};
+
+	if(is_comp && stage < ROHC_COMP_PERF_STAGE_MAX)
+	{
+		return comp_stages[stage];
+	}
+	else if(!is_comp && stage < ROHC_DECOMP_PERF_STAGE_MAX)
+	{
+		return decomp_stages[stage];
+	}
+	return "unknown";
+}
+
+
+/**
+ * @brief Get the name of one compression effort level
+ *
+ * @param effort  The compression effort level
+ * @return        The name of the level, as given to the --effort option
+ */
+static const char * perf_get_effort_descr(const rohc_comp_effort_t effort)
+{
+	switch(effort)
+	{
+		case ROHC_COMP_EFFORT_FAST:
+			return "fast";
+		case ROHC_COMP_EFFORT_DEFAULT:
+			return "default";
+		case ROHC_COMP_EFFORT_BEST:
+			return "best";
+		default:
+			return "unknown";
+	}
+}
+
+
+/**
+ * @brief Get the memory high-water mark of the process
+ *
+ * @return  The maximum resident set size of the process (in KiB),
+ *          -1 if not available on the platform
+ */
+static long perf_get_max_rss(void)
+{
+#if HAVE_SYS_RESOURCE_H == 1
+	struct rusage usage;
+
+	if(getrusage(RUSAGE_SELF, &usage) == 0)
+	{
+		return usage.ru_maxrss;
+	}
+#endif
+	return -1;
+}
+
+
+/**
+ * @brief Replay the packets of the given capture through an impaired channel
+ *
+ * The IP packets of the capture are compressed, sent through the impaired
+ * channel, then decompressed. The feedback built by the decompressor is
+ * delivered to the compressor without any impairment. Only the
+ * decompression of the packets is timed.
+ *
+ * @param is_verbose    Whether the test is run in verbose mode or not
+ * @param config        The parameters of the impairment mode
+ * @param packet_count  OUT: the number of packets sent through the channel
+ * @return              0 in case of success, 1 in case of failure
+ */
+static int run_impairment(const bool is_verbose,
+                          const struct perf_impair_config *const config,
+                          unsigned long *const packet_count)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	struct perf_impair_channel channel;
+	struct perf_impair_pkt released;
+	struct perf_impair_stats stats;
+	struct test_capture capture;
+	struct perf_pkt *pkts;
+	size_t pkts_nr;
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	rohc_decomp_general_info_t info;
+	size_t i;
+	int is_failure = 1;
+
+	memset(&stats, 0, sizeof(struct perf_impair_stats));
+	memset(&channel, 0, sizeof(struct perf_impair_channel));
+	channel.config = config;
+	channel.rand_state = (config->seed == 0 ? 1 : config->seed);
+
+	/* preload the whole capture of IP packets in memory */
+	if(load_capture(config->filename, true, &capture, &pkts, &pkts_nr) != 0)
+	{
+		goto error;
+	}
+	if(pkts_nr == 0)
+	{
+		fprintf(stderr, "no packet to replay in capture\n");
+		goto free_capture;
+	}
+
+	channel.held = calloc(PERF_IMPAIR_DEPTH_MAX, sizeof(struct perf_impair_pkt));
+	if(channel.held == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the delayed packets\n");
+		goto free_capture;
+	}
+
+	/* create and configure the compressor and the decompressor */
+	comp = create_compressor(&is_verbose, config->cid_type, config->wlsb_width,
+	                         config->max_contexts);
+	if(comp == NULL)
+	{
+		goto free_held;
+	}
+	if(config->ir_timeout > 0 &&
+	   !rohc_comp_set_periodic_refreshes(comp, config->ir_timeout,
+	                                     config->fo_timeout))
+	{
+		fprintf(stderr, "failed to set the timeouts of the periodic refreshes\n");
+		goto free_compressor;
+	}
+	decomp = create_decompressor(&is_verbose, config->cid_type,
+	                             config->max_contexts, config->mode);
+	if(decomp == NULL)
+	{
+		goto free_compressor;
+	}
+	if(config->crc_repair &&
+	   !rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_CRC_REPAIR))
+	{
+		fprintf(stderr, "failed to enable the repair upon CRC failure\n");
+		goto free_decompressor;
+	}
+	if(!rohc_decomp_set_reorder_window(decomp, config->reorder_window))
+	{
+		fprintf(stderr, "failed to set the reorder window\n");
+		goto free_decompressor;
+	}
+	if(config->has_rate_limits &&
+	   !rohc_decomp_set_rate_limits(decomp, config->rate_limits[0],
+	                                config->rate_limits[1], config->rate_limits[2],
+	                                config->rate_limits[3], config->rate_limits[4],
+	                                config->rate_limits[5]))
+	{
+		fprintf(stderr, "failed to set the rate limits of feedbacks\n");
+		goto free_decompressor;
+	}
+
+	for(i = 0; i < pkts_nr; i++)
+	{
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(pkts[i].data, pkts[i].len, arrival_time);
+		rohc_comp_last_packet_info2_t comp_info = {
+			.version_major = 0,
+			.version_minor = 0,
+		};
+		struct perf_impair_pkt pkt;
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(pkt.data, MAX_ROHC_SIZE);
+		rohc_status_t status;
+
+		/* compress the IP packet */
+		status = rohc_compress4(comp, ip_packet, &rohc_packet);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "packet %zu: compression failed\n", i + 1);
+			goto free_decompressor;
+		}
+		pkt.num = i;
+		pkt.len = rohc_packet.len;
+		stats.sent_nr++;
+		stats.uncomp_bytes += ip_packet.len;
+		stats.comp_bytes += rohc_packet.len;
+		if(rohc_comp_get_last_packet_info2(comp, &comp_info) &&
+		   (comp_info.packet_type == ROHC_PACKET_IR ||
+		    comp_info.packet_type == ROHC_PACKET_IR_DYN ||
+		    comp_info.packet_type == ROHC_PACKET_IR_CR))
+		{
+			stats.refresh_nr++;
+			stats.refresh_bytes += rohc_packet.len;
+		}
+
+		/* send the ROHC packet through the impaired channel */
+		if(perf_impair_is_lost(&channel))
+		{
+			stats.lost_nr++;
+			continue;
+		}
+		if(perf_impair_damage(&channel, pkt.data, pkt.len) > 0)
+		{
+			stats.damaged_nr++;
+		}
+		if(perf_impair_hold(&channel, &pkt))
+		{
+			stats.reordered_nr++;
+			continue;
+		}
+		if(!perf_impair_deliver(comp, decomp, &pkt, pkts, &stats))
+		{
+			goto free_decompressor;
+		}
+		channel.delivered_nr++;
+
+		/* deliver the delayed packets that were overtaken enough */
+		while(perf_impair_release(&channel, false, &released))
+		{
+			if(!perf_impair_deliver(comp, decomp, &released, pkts, &stats))
+			{
+				goto free_decompressor;
+			}
+		}
+	}
+
+	/* the end of the stream delivers all the delayed packets */
+	while(perf_impair_release(&channel, true, &released))
+	{
+		if(!perf_impair_deliver(comp, decomp, &released, pkts, &stats))
+		{
+			goto free_decompressor;
+		}
+	}
+	*packet_count = stats.sent_nr;
+
+	/* get the statistics of the decompressor about CRC failures and
+	 * feedbacks */
+	info.version_major = 0;
+	info.version_minor = 3;
+	if(!rohc_decomp_get_general_info(decomp, &info))
+	{
+		fprintf(stderr, "failed to get the statistics of the decompressor\n");
+		goto free_decompressor;
+	}
+
+	print_impairment_stats(config, &stats, &info);
+
+	/* everything went fine */
+	is_failure = 0;
+
+free_decompressor:
+	rohc_decomp_free(decomp);
+free_compressor:
+	rohc_comp_free(comp);
+free_held:
+	free(channel.held);
+free_capture:
+	free_capture(&capture, pkts);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Get a pseudo-random number for the impaired channel
+ *
+ * The xorshift64* generator is used, so that the impairments are the same
+ * from one run to another with the same seed, whatever the platform.
+ *
+ * @param channel  The impaired channel
+ * @return         A pseudo-random number in range [0, 1)
+ */
+static double perf_impair_rand(struct perf_impair_channel *const channel)
+{
+	uint64_t x = channel->rand_state;
+
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	channel->rand_state = x;
+
+	return (double) ((x * UINT64_C(2685821657736338717)) >> 11) /
+	       (double) (UINT64_C(1) << 53);
+}
+
+
+/**
+ * @brief Whether the impaired channel loses the next packet
+ *
+ * The losses follow the Gilbert-Elliott model: the channel is either in the
+ * good state or in the bad state, with one loss probability per state. The
+ * channel changes state before every packet.
+ *
+ * @param channel  The impaired channel
+ * @return         true if the packet is lost, false otherwise
+ */
+static bool perf_impair_is_lost(struct perf_impair_channel *const channel)
+{
+	const struct perf_impair_config *const config = channel->config;
+
+	if(channel->is_bad_state)
+	{
+		if(perf_impair_rand(channel) < config->loss_bad_to_good)
+		{
+			channel->is_bad_state = false;
+		}
+	}
+	else if(perf_impair_rand(channel) < config->loss_good_to_bad)
+	{
+		channel->is_bad_state = true;
+	}
+
+	return (perf_impair_rand(channel) <
+	        (channel->is_bad_state ? config->loss_in_bad : config->loss_in_good));
+}
+
+
+/**
+ * @brief Flip the bits of one packet according to the bit error rate
+ *
+ * @param channel  The impaired channel
+ * @param data     The packet to damage
+ * @param len      The length of the packet
+ * @return         The number of flipped bits
+ */
+static size_t perf_impair_damage(struct perf_impair_channel *const channel,
+                                 uint8_t *const data,
+                                 const size_t len)
+{
+	size_t flipped_nr = 0;
+	size_t i;
+
+	if(channel->config->ber <= 0)
+	{
+		return 0;
+	}
+
+	for(i = 0; i < (len * 8); i++)
+	{
+		if(perf_impair_rand(channel) < channel->config->ber)
+		{
+			data[i / 8] ^= (uint8_t) (0x80 >> (i % 8));
+			flipped_nr++;
+		}
+	}
+
+	return flipped_nr;
+}
+
+
+/**
+ * @brief Delay one packet in the impaired channel if it shall be reordered
+ *
+ * A delayed packet is overtaken by 1 up to \e reorder_depth packets.
+ *
+ * @param channel  The impaired channel
+ * @param pkt      The packet to delay
+ * @return         true if the packet is delayed, false if it shall be
+ *                 delivered now
+ */
+static bool perf_impair_hold(struct perf_impair_channel *const channel,
+                             const struct perf_impair_pkt *const pkt)
+{
+	const struct perf_impair_config *const config = channel->config;
+	size_t i;
+
+	if(config->reorder_depth == 0 ||
+	   perf_impair_rand(channel) >= config->reorder_rate)
+	{
+		return false;
+	}
+
+	for(i = 0; i < config->reorder_depth; i++)
+	{
+		if(!channel->held[i].is_held)
+		{
+			memcpy(&channel->held[i], pkt, sizeof(struct perf_impair_pkt));
+			channel->held[i].is_held = true;
+			channel->held[i].release_at = channel->delivered_nr + 1 +
+				(size_t) (perf_impair_rand(channel) * config->reorder_depth);
+			return true;
+		}
+	}
+
+	/* too many delayed packets, deliver the packet in order */
+	return false;
+}
+
+
+/**
+ * @brief Release the next delayed packet of the impaired channel if any
+ *
+ * @param channel   The impaired channel
+ * @param is_end    Whether the stream ended, so that all the delayed packets
+ *                  shall be released
+ * @param[out] pkt  The released packet
+ * @return          true if one packet was released, false if none
+ */
+static bool perf_impair_release(struct perf_impair_channel *const channel,
+                                const bool is_end,
+                                struct perf_impair_pkt *const pkt)
+{
+	struct perf_impair_pkt *next = NULL;
+	size_t i;
+
+	/* release the packets in the order they shall be delivered */
+	for(i = 0; i < PERF_IMPAIR_DEPTH_MAX; i++)
+	{
+		struct perf_impair_pkt *const held = &channel->held[i];
+
+		if(held->is_held &&
+		   (is_end || held->release_at <= channel->delivered_nr) &&
+		   (next == NULL || held->release_at < next->release_at ||
+		    (held->release_at == next->release_at && held->num < next->num)))
+		{
+			next = held;
+		}
+	}
+	if(next == NULL)
+	{
+		return false;
+	}
+
+	memcpy(pkt, next, sizeof(struct perf_impair_pkt));
+	next->is_held = false;
+	channel->delivered_nr++;
+
+	return true;
+}
+
+
+/**
+ * @brief Decompress one packet delivered by the impaired channel
+ *
+ * The decompression is timed, the feedback built by the decompressor is
+ * delivered to the compressor, and the decompressed packet is compared with
+ * the original IP packet.
+ *
+ * @param comp     The ROHC compressor
+ * @param decomp   The ROHC decompressor
+ * @param pkt      The ROHC packet delivered by the channel
+ * @param pkts     The original IP packets
+ * @param stats    The statistics of the impairment mode
+ * @return         true if the test may continue, false in case of error
+ */
+static bool perf_impair_deliver(struct rohc_comp *const comp,
+                                struct rohc_decomp *const decomp,
+                                const struct perf_impair_pkt *const pkt,
+                                const struct perf_pkt *const pkts,
+                                struct perf_impair_stats *const stats)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	const struct perf_pkt *const ip_pkt = &(pkts[pkt->num]);
+	uint8_t ip_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf ip_packet = rohc_buf_init_empty(ip_buffer, MAX_ROHC_SIZE);
+	uint8_t feedback_buffer[MAX_ROHC_SIZE];
+	struct rohc_buf feedback_send =
+		rohc_buf_init_empty(feedback_buffer, MAX_ROHC_SIZE);
+	const struct rohc_buf rohc_packet =
+		rohc_buf_init_full((uint8_t *) pkt->data, pkt->len, arrival_time);
+	rohc_status_t status;
+	uint64_t start_ns;
+
+	start_ns = perf_get_ns();
+	status = rohc_decompress3(decomp, rohc_packet, &ip_packet, NULL,
+	                          &feedback_send);
+	stats->decomp_ns += perf_get_ns() - start_ns;
+	stats->delivered_nr++;
+
+	/* the feedback channel is not impaired */
+	if(feedback_send.len > 0)
+	{
+		stats->feedback_nr++;
+		stats->feedback_bytes += feedback_send.len;
+		if(!rohc_comp_deliver_feedback2(comp, feedback_send))
+		{
+			fprintf(stderr, "packet %zu: failed to deliver feedback to the "
+			        "compressor\n", pkt->num + 1);
+			goto error;
+		}
+	}
+
+	if(status != ROHC_STATUS_OK || ip_packet.len == 0)
+	{
+		stats->failed_nr++;
+	}
+	else if(ip_packet.len == ip_pkt->len &&
+	        memcmp(rohc_buf_data(ip_packet), ip_pkt->data, ip_pkt->len) == 0)
+	{
+		stats->intact_nr++;
+		stats->intact_bytes += ip_pkt->len;
+	}
+	else
+	{
+		/* damage not detected by the CRC */
+		stats->corrupted_nr++;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Print the results of the impairment mode in plain text
+ *
+ * @param config  The parameters of the impairment mode
+ * @param stats   The statistics of the impairment mode
+ * @param info    The statistics of the decompressor
+ */
+static void print_impairment_stats(const struct perf_impair_config *const config,
+                                   const struct perf_impair_stats *const stats,
+                                   const rohc_decomp_general_info_t *const info)
+{
+	printf("impairment: %s-mode, loss p = %g r = %g in good state = %g "
+	       "in bad state = %g, reorder rate = %g depth = %zu, BER = %g, "
+	       "seed = %" PRIu64 "\n", (config->mode == ROHC_O_MODE ? "O" : "U"),
+	       config->loss_good_to_bad, config->loss_bad_to_good,
+	       config->loss_in_good, config->loss_in_bad, config->reorder_rate,
+	       config->reorder_depth, config->ber, config->seed);
+	printf("channel: %" PRIu64 " packets sent, %" PRIu64 " lost, "
+	       "%" PRIu64 " damaged, %" PRIu64 " reordered\n", stats->sent_nr,
+	       stats->lost_nr, stats->damaged_nr, stats->reordered_nr);
+	printf("decompression: %" PRIu64 " packets, %" PRIu64 " intact, "
+	       "%" PRIu64 " failed, %" PRIu64 " corrupted\n", stats->delivered_nr,
+	       stats->intact_nr, stats->failed_nr, stats->corrupted_nr);
+	if(stats->decomp_ns > 0)
+	{
+		printf("decompression: %.0f packets/s, %.1f ns/packet on average\n",
+		       (double) stats->delivered_nr * 1e9 / (double) stats->decomp_ns,
+		       (double) stats->decomp_ns / (double) stats->delivered_nr);
+	}
+	printf("CRC repairs: %lu attempted, %lu succeeded (%lu SN wraparounds, "
+	       "%lu incorrect SN updates), %lu CRC failures\n", info->crc_repairs_nr,
+	       info->corrected_crc_failures, info->corrected_sn_wraparounds,
+	       info->corrected_wrong_sn_updates, info->failed_crc_nr);
+	printf("feedback: %" PRIu64 " feedbacks, %" PRIu64 " bytes (%lu ACKs, "
+	       "%lu NACKs)\n", stats->feedback_nr, stats->feedback_bytes,
+	       info->feedbacks_ack_nr, info->feedbacks_nack_nr);
+	printf("refresh: %" PRIu64 " IR/IR-DYN/IR-CR packets, %" PRIu64 " bytes "
+	       "(%.1f%% of %" PRIu64 " ROHC bytes)\n", stats->refresh_nr,
+	       stats->refresh_bytes,
+	       (stats->comp_bytes > 0 ?
+	        100.0 * (double) stats->refresh_bytes / (double) stats->comp_bytes : 0),
+	       stats->comp_bytes);
+	printf("goodput: %" PRIu64 " of %" PRIu64 " uncompressed bytes delivered "
+	       "intact (%.1f%%), %.3f intact bytes per ROHC byte sent\n",
+	       stats->intact_bytes, stats->uncomp_bytes,
+	       (stats->uncomp_bytes > 0 ?
+	        100.0 * (double) stats->intact_bytes / (double) stats->uncomp_bytes : 0),
+	       (stats->comp_bytes + stats->feedback_bytes > 0 ?
+	        (double) stats->intact_bytes /
+	        (double) (stats->comp_bytes + stats->feedback_bytes) : 0));
+}
+
+
+/**
+ * @brief Parse the probability given to one option of the impairment mode
+ *
+ * @param name       The name of the option
+ * @param str        The value given to the option
+ * @param[out] prob  The parsed probability
+ * @return           true if the probability is in range [0, 1],
+ *                   false otherwise
+ */
+static bool parse_prob(const char *const name,
+                       const char *const str,
+                       double *const prob)
+{
+	char *end;
+
+	if(str == NULL)
+	{
+		fprintf(stderr, "option %s requires a probability\n", name);
+		goto error;
+	}
+	*prob = strtod(str, &end);
+	if(end == str || (*end) != '\0' || (*prob) < 0 || (*prob) > 1)
+	{
+		fprintf(stderr, "invalid probability '%s' for option %s: should be in "
+		        "range [0, 1]\n", str, name);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the current time of a monotonic clock
+ *
+ * @return  The current time in nanoseconds
+ */
+static inline uint64_t perf_get_ns(void)
+{
+	struct timespec now;
+
+	if(clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+	{
+		return 0;
+	}
+	return ((uint64_t) now.tv_sec) * 1000000000U + now.tv_nsec;
+}
+
+
+/**
+ * @brief Get the current value of the cycle counter of the CPU
+ *
+ * @return  The current value of the cycle counter, 0 if the CPU provides
+ *          no cycle counter
+ */
+static inline uint64_t perf_get_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#else
+	return 0;
+#endif
+}
+
+
+/**
+ * @brief Get the histogram bucket for the given value
+ *
+ * Values below 2^PERF_HIST_SUB_BITS get one bucket each. Larger values share
+ * 2^PERF_HIST_SUB_BITS buckets per power of two, so the relative error is
+ * less than 1 / 2^PERF_HIST_SUB_BITS.
+ *
+ * @param value  The value to classify
+ * @return       The bucket for the value
+ */
+static size_t perf_hist_get_bucket(const uint64_t value)
+{
+	const uint64_t sub_nr = 1U << PERF_HIST_SUB_BITS;
+	size_t exp;
+
+	if(value < sub_nr)
+	{
+		return value;
+	}
+	exp = 63 - __builtin_clzll(value);
+
+	return ((exp - PERF_HIST_SUB_BITS + 1) << PERF_HIST_SUB_BITS) +
+	       ((value >> (exp - PERF_HIST_SUB_BITS)) & (sub_nr - 1));
+}
+
+
+/**
+ * @brief Get the largest value of the given histogram bucket
+ *
+ * @param bucket  The histogram bucket
+ * @return        The largest value classified in the bucket
+ */
+static uint64_t perf_hist_get_value(const size_t bucket)
+{
+	const uint64_t sub_nr = 1U << PERF_HIST_SUB_BITS;
+	size_t exp;
+
+	if(bucket < sub_nr)
+	{
+		return bucket;
+	}
+	exp = (bucket >> PERF_HIST_SUB_BITS) + PERF_HIST_SUB_BITS - 1;
+
+	return ((sub_nr + (bucket & (sub_nr - 1)) + 1) << (exp - PERF_HIST_SUB_BITS)) - 1;
+}
+
+
+/**
+ * @brief Get the given percentile of the per-packet times
+ *
+ * @param stats       The statistics of per-packet times
+ * @param percentile  The percentile to get, in range ]0, 1]
+ * @return            The per-packet time (in ns) for the percentile
+ */
+static uint64_t perf_stats_get_percentile(const struct perf_stats *const stats,
+                                          const double percentile)
+{
+	uint64_t target = (uint64_t) (percentile * (double) stats->pkts_nr);
+	uint64_t count = 0;
+	size_t bucket;
+
+	if(target < 1)
+	{
+		target = 1;
+	}
+	for(bucket = 0; bucket < PERF_HIST_BUCKETS; bucket++)
+	{
+		count += stats->hist[bucket];
+		if(count >= target)
+		{
+			return perf_hist_get_value(bucket);
+		}
+	}
+
+	return perf_hist_get_value(PERF_HIST_BUCKETS - 1);
+}
+
+
 /**
  * @brief Print traces emitted by the ROHC library in verbose mode
  *
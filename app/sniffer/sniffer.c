@@ -31,6 +31,21 @@
  *   the ROHC library with them. The packets are compressed, then decompressed,
  *   and finally compared with the original IP packets.
  *
+ * Threads:
+ *   By default, the packets are compressed and decompressed by the thread that
+ *   captures them. With the --threads option, the capture thread only copies
+ *   the packets in the rings of several worker threads. Every worker owns one
+ *   shard of a sharded ROHC compressor (ie. one range of CIDs) and one ROHC
+ *   decompressor. The flows are spread over the workers by the library, so all
+ *   the packets of one flow are handled by the same worker, in order. The
+ *   packets are dropped and counted if the ring of their worker is full.
+ *
+ * Capture:
+ *   The packets are captured with libpcap by default. On Linux, the
+ *   --capture tpacket option captures them from an AF_PACKET TPACKET_V3 ring
+ *   mapped in memory instead: the kernel fills whole blocks of packets that
+ *   are handled in place, without one system call and one copy per packet.
+ *
  * Statistics:
  *   Some statistics are gathered during the tests. There are printed on the
  *   console. More stats should be added. A better way to export them remains to
@@ -39,7 +54,10 @@
  * Post-mortem bug analysis:
  *   The program stops (assertion) if compression/decompression/comparison
  *   fails. The last library traces are recorded and printed in case of error.
- *   The last packets are recorded in PCAP files, one per context. This is
+ *   The packets are recorded in one pcapng file, every packet is tagged with
+ *   the CID of its context in its comment. The file is written by a dedicated
+ *   thread from two large buffers, so the disk never stalls the workers; the
+ *   file is rotated once it reaches 1 GiB. It is
  *   also a good idea to run the program with core enabled. Many elements are
  *   thus available to reproduce and fix the discovered problems.
  */
@@ -66,7 +84,20 @@
 #include <sys/types.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <time.h>
 #include <linux/if.h>
+#if HAVE_PTHREAD_H == 1
+#  include <pthread.h>
+#  include <sched.h>
+#endif
+#if HAVE_LINUX_IF_PACKET_H == 1
+#  include <poll.h>
+#  include <sys/ioctl.h>
+#  include <sys/mman.h>
+#  include <sys/socket.h>
+#  include <linux/if_ether.h>
+#  include <linux/if_packet.h>
+#endif
 
 /* include for the PCAP library */
 #if HAVE_PCAP_PCAP_H == 1
@@ -105,6 +136,58 @@ for ./configure ? If yes, check configure output and config.log"
 /** The minimum Ethernet length (in bytes) */
 #define ETHER_FRAME_MIN_LEN  60U
 
+/** The maximum number of worker threads */
+#define SNIFFER_THREADS_MAX  64U
+
+/** The number of packets in the ring of one worker (power of 2) */
+#define SNIFFER_RING_LEN  4096U
+
+/** The minimum length of the buffers of the ring slots (grown if needed) */
+#define SNIFFER_SLOT_MIN_LEN  2048U
+
+/** The length of one block of the TPACKET_V3 ring (multiple of page size) */
+#define SNIFFER_TPACKET_BLOCK_LEN  (1U << 20)
+
+/** The number of blocks of the TPACKET_V3 ring */
+#define SNIFFER_TPACKET_BLOCKS_NR  64U
+
+/** The nominal length of one frame of the TPACKET_V3 ring */
+#define SNIFFER_TPACKET_FRAME_LEN  2048U
+
+/** The time (in ms) after which the kernel hands a partly filled block */
+#define SNIFFER_TPACKET_TIMEOUT_MS  50U
+
+/** The name of the file the sniffed packets are dumped in */
+#define SNIFFER_DUMP_FILENAME  "./dump_stream.pcapng"
+
+/** The name of the previous dump file, once the dump file was rotated */
+#define SNIFFER_DUMP_OLD_FILENAME  "./dump_stream.old.pcapng"
+
+/** The length of the two buffers of the dump file */
+#define SNIFFER_DUMP_BUF_LEN  (4U << 20)
+
+/** The length of the dump file after which it is rotated */
+#define SNIFFER_DUMP_MAX_LEN  (1024U << 20)
+
+/** The delay (in seconds) after which the buffered packets are written */
+#define SNIFFER_DUMP_FLUSH_DELAY  1
+
+/** The pcapng link type of the raw IP packets (DLT_RAW depends on the OS) */
+#define SNIFFER_DUMP_LINKTYPE_RAW  101U
+
+/** The length of the pcapng data and options, padded to 32 bits */
+#define SNIFFER_DUMP_PAD32(len)  (((len) + 3U) & ~3U)
+
+
+/** The backends to capture the packets */
+typedef enum
+{
+	/** Capture with libpcap, one system call and one copy per packet */
+	SNIFFER_CAPTURE_PCAP,
+	/** Capture from an AF_PACKET TPACKET_V3 ring mapped in memory */
+	SNIFFER_CAPTURE_TPACKET,
+} sniffer_capture_t;
+
 
 /** Some statistics collected by the sniffer */
 struct sniffer_stats_t
@@ -155,6 +238,125 @@ struct sniffer_stats_t
 	unsigned long nr_misordered_packets;
 	/** Cumulative number of (possible) duplicated packets */
 	unsigned long nr_duplicated_packets;
+
+	/** Cumulative number of packets dropped because a worker was too slow */
+	unsigned long nr_dropped_packets;
+};
+
+
+/** One captured packet in the ring of a worker */
+struct sniffer_slot
+{
+	/** The PCAP header of the packet */
+	struct pcap_pkthdr header;
+	/** The packet (link layer included) */
+	unsigned char *data;
+	/** The length of the buffer allocated for the packet */
+	size_t max_len;
+};
+
+
+/**
+ * @brief One compressor/decompressor pair and the packets it shall handle
+ *
+ * The worker compresses the flows of one shard of the sharded compressor,
+ * ie. it uses its own range of CIDs. In multi-threaded mode, the capture
+ * thread is the only one to write the head of the ring and the worker thread
+ * is the only one to write its tail.
+ */
+struct sniffer_worker
+{
+	/** The compressor of the shard (owned by the sharded compressor) */
+	struct rohc_comp *comp;
+	/** The decompressor for the CIDs of the shard */
+	struct rohc_decomp *decomp;
+	/** The length of the link layer header before IP data */
+	size_t link_len;
+
+	/** The feedback to piggyback on the next ROHC packet */
+	struct rohc_buf feedback_send;
+	/** The memory for the feedback to piggyback */
+	uint8_t feedback_send_buffer[MAX_ROHC_SIZE];
+
+	/** The statistics of the packets handled by the worker */
+	struct sniffer_stats_t stats;
+	unsigned int nb_ok;           /**< The number of packets OK */
+	unsigned int nb_bad;          /**< The number of bad packets */
+	unsigned int nb_internal_err; /**< The number of internal errors */
+	unsigned int err_comp;        /**< The number of compression errors */
+	unsigned int err_decomp;      /**< The number of decompression errors */
+	unsigned int nb_ref;          /**< The number of comparison failures */
+
+	/** The ring of captured packets */
+	struct sniffer_slot ring[SNIFFER_RING_LEN];
+	/** The number of packets pushed in the ring (capture thread) */
+	uint32_t ring_head;
+	/** The number of packets popped from the ring (worker thread) */
+	uint32_t ring_tail;
+	/** Whether the worker shall stop once its ring is empty */
+	bool is_stopping;
+#if HAVE_PTHREAD_H == 1
+	/** The thread of the worker */
+	pthread_t thread;
+#endif
+};
+
+
+#if HAVE_LINUX_IF_PACKET_H == 1
+
+/** The AF_PACKET TPACKET_V3 ring that the kernel fills with packets */
+struct sniffer_tpacket
+{
+	/** The AF_PACKET socket */
+	int fd;
+	/** The blocks of the ring mapped in memory */
+	unsigned char *blocks;
+	/** The next block to read */
+	size_t next_block;
+};
+
+#endif /* HAVE_LINUX_IF_PACKET_H == 1 */
+
+
+/**
+ * @brief The file the sniffed packets are dumped in
+ *
+ * All the sniffed packets are dumped in one pcapng file, every packet is
+ * tagged with the CID of its context in the comment of its pcapng block.
+ * The workers append the packets to the active buffer, the writer thread
+ * writes the full buffers in the file (or the partly filled ones after
+ * \ref SNIFFER_DUMP_FLUSH_DELAY seconds), so that the workers never wait for
+ * the disk: the packets are not dumped if both buffers are full.
+ */
+struct sniffer_dump
+{
+	/** The dump file, -1 if not opened */
+	int fd;
+	/** The pcapng link type of the packets */
+	uint16_t link_type;
+	/** The number of bytes written in the dump file */
+	size_t file_len;
+
+	/** The two buffers of packets */
+	unsigned char *bufs[2];
+	/** The number of bytes in every buffer, the buffer that is not active
+	 *  is owned by the writer thread as long as it is not empty */
+	size_t lens[2];
+	/** The buffer the workers append the packets to */
+	size_t active;
+	/** The number of packets not dumped because both buffers were full */
+	unsigned long dropped_nr;
+
+#if HAVE_PTHREAD_H == 1
+	/** The lock of the buffers, shared by the workers and the writer */
+	pthread_mutex_t lock;
+	/** The condition the writer thread waits for full buffers on */
+	pthread_cond_t cond;
+	/** Whether the writer thread shall stop once the buffers are empty */
+	bool is_stopping;
+	/** The writer thread */
+	pthread_t writer;
+#endif
 };
 
 
@@ -166,16 +368,88 @@ static void sniffer_print_stats(int signum);
 
 static bool sniff(const rohc_cid_type_t cid_type,
                   const size_t max_contexts,
+                  const size_t threads_nr,
+                  const sniffer_capture_t capture,
                   const int enabled_profiles[],
                   const char *const device_name)
-	__attribute__((warn_unused_result, nonnull(4)));
+	__attribute__((warn_unused_result, nonnull(5, 6)));
+static void sniffer_handle_packet(struct rohc_comp_shards *const shards,
+                                  struct sniffer_worker *const workers,
+                                  const size_t threads_nr,
+                                  struct pcap_pkthdr header,
+                                  unsigned char *const packet)
+	__attribute__((nonnull(1, 2, 5)));
+
+#if HAVE_LINUX_IF_PACKET_H == 1
+static bool sniffer_tpacket_open(struct sniffer_tpacket *const ring,
+                                 const char *const device_name)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void sniffer_tpacket_close(struct sniffer_tpacket *const ring)
+	__attribute__((nonnull(1)));
+static bool sniffer_tpacket_capture(struct sniffer_tpacket *const ring,
+                                    struct rohc_comp_shards *const shards,
+                                    struct sniffer_worker *const workers,
+                                    const size_t threads_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+#endif
+
+static bool sniffer_worker_init(struct sniffer_worker *const worker,
+                                struct rohc_comp *const comp,
+                                const rohc_cid_type_t cid_type,
+                                const size_t max_contexts,
+                                const int enabled_profiles[],
+                                const size_t link_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5)));
+static void sniffer_worker_free(struct sniffer_worker *const worker)
+	__attribute__((nonnull(1)));
+static bool sniffer_worker_enqueue(struct sniffer_worker *const worker,
+                                   const struct pcap_pkthdr *const header,
+                                   const unsigned char *const packet)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+#if HAVE_PTHREAD_H == 1
+static void * sniffer_worker_run(void *arg)
+	__attribute__((nonnull(1)));
+#endif
+static void sniffer_worker_process(struct sniffer_worker *const worker,
+                                   struct pcap_pkthdr header,
+                                   unsigned char *packet)
+	__attribute__((nonnull(1, 3)));
+
+static bool sniffer_dump_open(struct sniffer_dump *const dump,
+                              const int link_type)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void sniffer_dump_close(struct sniffer_dump *const dump)
+	__attribute__((nonnull(1)));
+static bool sniffer_dump_create(struct sniffer_dump *const dump)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void sniffer_dump_write(struct sniffer_dump *const dump,
+                               const unsigned char *const buf,
+                               const size_t len)
+	__attribute__((nonnull(1, 2)));
+static void sniffer_dump_packet(struct sniffer_dump *const dump,
+                                const struct pcap_pkthdr *const header,
+                                const unsigned char *const packet,
+                                const char *const comment)
+	__attribute__((nonnull(1, 2, 3, 4)));
+#if HAVE_PTHREAD_H == 1
+static void * sniffer_dump_run(void *arg)
+	__attribute__((nonnull(1)));
+#endif
+static void sniffer_dump_crash(const struct sniffer_dump *const dump)
+	__attribute__((nonnull(1)));
+
+static void sniffer_stats_rescale(struct sniffer_stats_t *const stats,
+                                  const unsigned long unit_size)
+	__attribute__((nonnull(1)));
+static void sniffer_stats_merge(struct sniffer_stats_t *const total,
+                                const struct sniffer_stats_t *const stats)
+	__attribute__((nonnull(1, 2)));
 static int compress_decompress(struct rohc_comp *comp,
                                struct rohc_decomp *decomp,
                                struct pcap_pkthdr header,
                                unsigned char *packet,
                                size_t link_len_src,
-                               pcap_t *handle,
-                               pcap_dumper_t *dumpers[],
+                               struct sniffer_dump *const dump,
                                struct rohc_buf *const feedback_send,
                                unsigned int *const cid,
                                struct sniffer_stats_t *stats);
@@ -213,9 +487,14 @@ static bool write_pid_file(const char *const path)
 /** Whether the application shall stop or not */
 static bool stop_program;
 
-/** Some statistics collected by the sniffer */
+/** Some statistics collected by the capture thread */
 static struct sniffer_stats_t sniffer_stats;
 
+/** The workers that compress/decompress the sniffed packets */
+static struct sniffer_worker *sniffer_workers;
+/** The number of workers */
+static size_t sniffer_workers_nr;
+
 /** Whether the application runs in daemon mode or not */
 static bool is_daemon;
 
@@ -225,8 +504,8 @@ static bool is_verbose;
 /** Whether the application prints stats at regular interval of time or not */
 static bool do_print_stat;
 
-/** The PCAP dumpers */
-static pcap_dumper_t *sniffer_dumpers[ROHC_LARGE_CID_MAX + 1] = { 0 };
+/** The file the sniffed packets are dumped in, shared by the workers */
+static struct sniffer_dump sniffer_dump = { .fd = -1 };
 
 /** The maximum number of traces to keep */
 #define MAX_LAST_TRACES  5000
@@ -239,6 +518,10 @@ static char last_traces[MAX_LAST_TRACES][MAX_LAST_TRACES + 1];
 static int last_traces_first;
 /** The index of the last trace */
 static int last_traces_last;
+#if HAVE_PTHREAD_H == 1
+/** The lock of the ring buffer for the last traces, shared by the workers */
+static pthread_mutex_t last_traces_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 /** Whether to print traces on stderr or not */
 static bool do_print_stderr = true;
@@ -275,6 +558,8 @@ int main(int argc, char *argv[])
 	char *cid_type_name = NULL;
 	char *device_name = NULL;
 	int max_contexts = ROHC_SMALL_CID_MAX + 1;
+	int threads_nr = 0;
+	sniffer_capture_t capture = SNIFFER_CAPTURE_PCAP;
 	rohc_cid_type_t cid_type;
 	int args_used;
 	int ret;
@@ -366,6 +651,44 @@ int main(int argc, char *argv[])
 			max_contexts = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--threads"))
+		{
+			/* get the number of worker threads */
+			threads_nr = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--capture"))
+		{
+			/* get the backend to capture packets */
+			if(argc <= 1)
+			{
+				SNIFFER_LOG(LOG_WARNING, "option --capture takes one argument");
+				usage();
+				goto error;
+			}
+			if(!strcmp(argv[1], "pcap"))
+			{
+				capture = SNIFFER_CAPTURE_PCAP;
+			}
+			else if(!strcmp(argv[1], "tpacket"))
+			{
+#if HAVE_LINUX_IF_PACKET_H == 1
+				capture = SNIFFER_CAPTURE_TPACKET;
+#else
+				SNIFFER_LOG(LOG_WARNING, "the TPACKET_V3 capture is not "
+				            "supported on this platform");
+				goto error;
+#endif
+			}
+			else
+			{
+				SNIFFER_LOG(LOG_WARNING, "invalid capture backend, only 'pcap' "
+				            "and 'tpacket' expected");
+				usage();
+				goto error;
+			}
+			args_used++;
+		}
 		else if(!strcmp(*argv, "--disable"))
 		{
 			/* disable the given ROHC profile */
@@ -443,6 +766,26 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* the number of worker threads should be valid, every worker needs at
+	 * least one ROHC context */
+	if(threads_nr < 0 || (size_t) threads_nr > SNIFFER_THREADS_MAX ||
+	   threads_nr > max_contexts)
+	{
+		SNIFFER_LOG(LOG_WARNING, "the number of worker threads should be "
+		            "between 0 and %u, and not greater than the maximum number "
+		            "of ROHC contexts", SNIFFER_THREADS_MAX);
+		usage();
+		goto error;
+	}
+#if HAVE_PTHREAD_H != 1
+	if(threads_nr > 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "worker threads are not supported on this "
+		            "platform");
+		goto error;
+	}
+#endif
+
 	/* the source filename is mandatory */
 	if(device_name == NULL)
 	{
@@ -530,7 +873,8 @@ int main(int argc, char *argv[])
 	}
 
 	/* test ROHC compression/decompression with the packets from the file */
-	if(!sniff(cid_type, max_contexts, enabled_profiles, device_name))
+	if(!sniff(cid_type, max_contexts, threads_nr, capture, enabled_profiles,
+	          device_name))
 	{
 		goto error;
 	}
@@ -589,6 +933,14 @@ static void usage(void)
 	       "                          (may be specified several times)\n"
 	       "      --verbose           Make the test more verbose\n"
 	       "      --stat              Print statistics at regular interval of time\n"
+	       "      --threads NUM       Compress/decompress the packets in NUM\n"
+	       "                          worker threads, one range of CIDs per\n"
+	       "                          thread (default: 0, ie. in the capture\n"
+	       "                          thread)\n"
+	       "      --capture BACKEND   The backend to capture packets among\n"
+	       "                          'pcap' and 'tpacket' (TPACKET_V3 ring\n"
+	       "                          mapped in memory, Linux only, IP\n"
+	       "                          packets only) (default: pcap)\n"
 	       "\n"
 	       "Examples:\n"
 	       "  rohc_sniffer smallcid eth0          compress traffic from eth0\n"
@@ -596,6 +948,11 @@ static void usage(void)
 	       "  rohc_sniffer -m 450 largecid wlan0  compress traffic from\n"
 	       "                                      wlan0 with large CIDs, no\n"
 	       "                                      more than 450 streams\n"
+	       "  rohc_sniffer --threads 4 largecid eth0\n"
+	       "                                      compress traffic from eth0\n"
+	       "                                      in 4 worker threads\n"
+	       "  rohc_sniffer --capture tpacket --threads 4 largecid eth0\n"
+	       "                                      same from a TPACKET_V3 ring\n"
 	       "\n"
 	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n");
 }
@@ -612,12 +969,11 @@ static void sniffer_interrupt(int signum)
 	SNIFFER_LOG(LOG_NOTICE, "signal %d catched", signum);
 	stop_program = true;
 
-	/* for SIGSEGV/SIGABRT, close the PCAP dumps, print the last debug traces,
-	 * then kill the program */
+	/* for SIGSEGV/SIGABRT, write the dumped packets, print the last debug
+	 * traces, then kill the program */
 	if(signum == SIGSEGV || signum == SIGABRT)
 	{
 		int i;
-		size_t j;
 
 		if(signum == SIGSEGV)
 		{
@@ -630,15 +986,10 @@ static void sniffer_interrupt(int signum)
 			            sniffer_stats.total_packets);
 		}
 
-		/* close PCAP dumpers */
-		for(j = 0; j <= ROHC_LARGE_CID_MAX; j++)
-		{
-			if(sniffer_dumpers[j] != NULL)
-			{
-				SNIFFER_LOG(LOG_INFO, "close dump file for context with ID %zu", j);
-				pcap_dump_close(sniffer_dumpers[j]);
-			}
-		}
+		/* write the packets still buffered in the dump file */
+		SNIFFER_LOG(LOG_INFO, "write the buffered packets in dump file '%s'",
+		            SNIFFER_DUMP_FILENAME);
+		sniffer_dump_crash(&sniffer_dump);
 
 		/* print last debug traces */
 		if(last_traces_first == -1 || last_traces_last == -1)
@@ -718,148 +1069,163 @@ static unsigned long long compute_percent(const unsigned long value,
  */
 static void sniffer_print_stats(int signum __attribute__((unused)))
 {
+	struct sniffer_stats_t stats;
 	unsigned long total;
+	size_t j;
 	int i;
 
+	/* merge the statistics of the workers, they are read while the workers
+	 * update them, so they are only approximate in multi-threaded mode */
+	memset(&stats, 0, sizeof(struct sniffer_stats_t));
+	stats.comp_unit_size = 1;
+	for(j = 0; j < sniffer_workers_nr; j++)
+	{
+		sniffer_stats_merge(&stats, &sniffer_workers[j].stats);
+	}
+
 	SNIFFER_LOG(LOG_INFO, "dump ROHC sniffer statistics...");
 
 	/* general */
 	SNIFFER_LOG(LOG_INFO, "general:");
 	SNIFFER_LOG(LOG_INFO, "  total packets: %lu packets",
-	            sniffer_stats.total_packets);
+	            stats.total_packets);
+	SNIFFER_LOG(LOG_INFO, "  dropped packets: %lu packets (%llu%%)",
+	            sniffer_stats.nr_dropped_packets,
+	            compute_percent(sniffer_stats.nr_dropped_packets,
+	                            sniffer_stats.total_packets));
 	SNIFFER_LOG(LOG_INFO, "  bad packets: %lu packets (%llu%%)",
-	            sniffer_stats.bad_packets,
-	            compute_percent(sniffer_stats.bad_packets, sniffer_stats.total_packets));
+	            stats.bad_packets,
+	            compute_percent(stats.bad_packets, stats.total_packets));
 	SNIFFER_LOG(LOG_INFO, "  loss (estim.):");
 	SNIFFER_LOG(LOG_INFO, "    %lu packets among %lu bursts (%llu%%)",
-	            sniffer_stats.nr_lost_packets, sniffer_stats.nr_loss_bursts,
-	            compute_percent(sniffer_stats.nr_lost_packets, sniffer_stats.total_packets));
+	            stats.nr_lost_packets, stats.nr_loss_bursts,
+	            compute_percent(stats.nr_lost_packets, stats.total_packets));
 	SNIFFER_LOG(LOG_INFO, "    packets per burst: max %lu, avg %lu, min %lu",
-	            sniffer_stats.max_loss_burst_len, (sniffer_stats.nr_loss_bursts != 0 ?
-	            sniffer_stats.nr_lost_packets / sniffer_stats.nr_loss_bursts : 0),
-	            sniffer_stats.min_loss_burst_len);
+	            stats.max_loss_burst_len, (stats.nr_loss_bursts != 0 ?
+	            stats.nr_lost_packets / stats.nr_loss_bursts : 0),
+	            stats.min_loss_burst_len);
 	SNIFFER_LOG(LOG_INFO, "  mis-ordered packets (estim.): %lu packets "
-	            "(%llu%%)", sniffer_stats.nr_misordered_packets,
-	            compute_percent(sniffer_stats.nr_misordered_packets, sniffer_stats.total_packets));
+	            "(%llu%%)", stats.nr_misordered_packets,
+	            compute_percent(stats.nr_misordered_packets, stats.total_packets));
 	SNIFFER_LOG(LOG_INFO, "  duplicated packets (estim.): %lu packets "
-	            "(%llu%%)", sniffer_stats.nr_duplicated_packets,
-	            compute_percent(sniffer_stats.nr_duplicated_packets, sniffer_stats.total_packets));
+	            "(%llu%%)", stats.nr_duplicated_packets,
+	            compute_percent(stats.nr_duplicated_packets, stats.total_packets));
 
 	/* compression gain */
 	SNIFFER_LOG(LOG_INFO, "compression gain:");
-	if(sniffer_stats.comp_unit_size == 1)
+	if(stats.comp_unit_size == 1)
 	{
 		SNIFFER_LOG(LOG_INFO, "  pre-compress: %lu bytes (incl. %lu KB of headers)",
-		            sniffer_stats.comp_pre_nr_bytes, sniffer_stats.comp_pre_nr_hdr_bytes / 1000);
+		            stats.comp_pre_nr_bytes, stats.comp_pre_nr_hdr_bytes / 1000);
 	}
 	else
 	{
 		SNIFFER_LOG(LOG_INFO, "  pre-compress: %lu %s (incl. %lu KB of headers)",
-		            sniffer_stats.comp_pre_nr_units,
-		            sniffer_stats.comp_unit_size == 1000 ? "KB" :
-		            (sniffer_stats.comp_unit_size == 1000*1000 ? "MB" :
-		             (sniffer_stats.comp_unit_size == 1000*1000*1000 ? "GB" : "?")),
-		            sniffer_stats.comp_pre_nr_hdr_bytes / 1000);
+		            stats.comp_pre_nr_units,
+		            stats.comp_unit_size == 1000 ? "KB" :
+		            (stats.comp_unit_size == 1000*1000 ? "MB" :
+		             (stats.comp_unit_size == 1000*1000*1000 ? "GB" : "?")),
+		            stats.comp_pre_nr_hdr_bytes / 1000);
 	}
-	if(sniffer_stats.comp_unit_size == 1)
+	if(stats.comp_unit_size == 1)
 	{
 		SNIFFER_LOG(LOG_INFO, "  post-compress: %lu bytes (incl. %lu KB of headers)",
-		            sniffer_stats.comp_post_nr_bytes, sniffer_stats.comp_post_nr_hdr_bytes / 1000);
+		            stats.comp_post_nr_bytes, stats.comp_post_nr_hdr_bytes / 1000);
 	}
 	else
 	{
 		SNIFFER_LOG(LOG_INFO, "  post-compress: %lu %s (incl. %lu KB of headers)",
-		            sniffer_stats.comp_post_nr_units,
-		            sniffer_stats.comp_unit_size == 1000 ? "KB" :
-		            (sniffer_stats.comp_unit_size == 1000*1000 ? "MB" :
-		             (sniffer_stats.comp_unit_size == 1000*1000*1000 ? "GB" : "?")),
-		            sniffer_stats.comp_post_nr_hdr_bytes / 1000);
+		            stats.comp_post_nr_units,
+		            stats.comp_unit_size == 1000 ? "KB" :
+		            (stats.comp_unit_size == 1000*1000 ? "MB" :
+		             (stats.comp_unit_size == 1000*1000*1000 ? "GB" : "?")),
+		            stats.comp_post_nr_hdr_bytes / 1000);
 	}
-	if(sniffer_stats.comp_unit_size == 1)
+	if(stats.comp_unit_size == 1)
 	{
 		SNIFFER_LOG(LOG_INFO, "  compress ratio: %llu%% of total, ie. %llu%% "
 		            "of gain",
-		            compute_percent(sniffer_stats.comp_post_nr_bytes, sniffer_stats.comp_pre_nr_bytes),
-		            100 - compute_percent(sniffer_stats.comp_post_nr_bytes, sniffer_stats.comp_pre_nr_bytes));
+		            compute_percent(stats.comp_post_nr_bytes, stats.comp_pre_nr_bytes),
+		            100 - compute_percent(stats.comp_post_nr_bytes, stats.comp_pre_nr_bytes));
 	}
 	else
 	{
 		SNIFFER_LOG(LOG_INFO, "  compress ratio: %llu%% of total packets, ie. %llu%% "
 		            "of gain on full packets",
-		            compute_percent(sniffer_stats.comp_post_nr_units, sniffer_stats.comp_pre_nr_units),
-		            100 - compute_percent(sniffer_stats.comp_post_nr_units, sniffer_stats.comp_pre_nr_units));
+		            compute_percent(stats.comp_post_nr_units, stats.comp_pre_nr_units),
+		            100 - compute_percent(stats.comp_post_nr_units, stats.comp_pre_nr_units));
 	}
 	SNIFFER_LOG(LOG_INFO, "  compress ratio: %llu%% of total headers, ie. %llu%% "
 	            "of gain on headers alone",
-	            compute_percent(sniffer_stats.comp_post_nr_hdr_bytes, sniffer_stats.comp_pre_nr_hdr_bytes),
-	            100 - compute_percent(sniffer_stats.comp_post_nr_hdr_bytes, sniffer_stats.comp_pre_nr_hdr_bytes));
+	            compute_percent(stats.comp_post_nr_hdr_bytes, stats.comp_pre_nr_hdr_bytes),
+	            100 - compute_percent(stats.comp_post_nr_hdr_bytes, stats.comp_pre_nr_hdr_bytes));
 	SNIFFER_LOG(LOG_INFO, "  used and re-used contexts: %lu",
-	            sniffer_stats.comp_nr_reused_cid);
+	            stats.comp_nr_reused_cid);
 
 	/* packets per profile */
-	total = sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UNCOMPRESSED] +
-	        sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_RTP] +
-	        sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDP] +
-	        sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_IP] +
-	        sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_TCP] +
-	        sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDPLITE];
+	total = stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UNCOMPRESSED] +
+	        stats.comp_nr_pkts_per_profile[ROHC_PROFILE_RTP] +
+	        stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDP] +
+	        stats.comp_nr_pkts_per_profile[ROHC_PROFILE_IP] +
+	        stats.comp_nr_pkts_per_profile[ROHC_PROFILE_TCP] +
+	        stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDPLITE];
 	SNIFFER_LOG(LOG_INFO, "packets per profile:");
 	SNIFFER_LOG(LOG_INFO, "  Uncompressed profile: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UNCOMPRESSED],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UNCOMPRESSED],
+	            stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UNCOMPRESSED],
+	            compute_percent(stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UNCOMPRESSED],
 	                            total));
 	SNIFFER_LOG(LOG_INFO, "  IP/UDP/RTP profile: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_RTP],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_RTP], total));
+	            stats.comp_nr_pkts_per_profile[ROHC_PROFILE_RTP],
+	            compute_percent(stats.comp_nr_pkts_per_profile[ROHC_PROFILE_RTP], total));
 	SNIFFER_LOG(LOG_INFO, "  IP/UDP profile: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDP],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDP], total));
+	            stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDP],
+	            compute_percent(stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDP], total));
 	SNIFFER_LOG(LOG_INFO, "  IP-only profile: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_IP],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_IP], total));
+	            stats.comp_nr_pkts_per_profile[ROHC_PROFILE_IP],
+	            compute_percent(stats.comp_nr_pkts_per_profile[ROHC_PROFILE_IP], total));
 	SNIFFER_LOG(LOG_INFO, "  IP/TCP profile: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_TCP],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_TCP], total));
+	            stats.comp_nr_pkts_per_profile[ROHC_PROFILE_TCP],
+	            compute_percent(stats.comp_nr_pkts_per_profile[ROHC_PROFILE_TCP], total));
 	SNIFFER_LOG(LOG_INFO, "  IP/UDP-Lite profile: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDPLITE],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDPLITE], total));
+	            stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDPLITE],
+	            compute_percent(stats.comp_nr_pkts_per_profile[ROHC_PROFILE_UDPLITE], total));
 
 	/* packets per mode */
-	total = sniffer_stats.comp_nr_pkts_per_mode[ROHC_U_MODE] +
-	        sniffer_stats.comp_nr_pkts_per_mode[ROHC_O_MODE] +
-	        sniffer_stats.comp_nr_pkts_per_mode[ROHC_R_MODE];
+	total = stats.comp_nr_pkts_per_mode[ROHC_U_MODE] +
+	        stats.comp_nr_pkts_per_mode[ROHC_O_MODE] +
+	        stats.comp_nr_pkts_per_mode[ROHC_R_MODE];
 	SNIFFER_LOG(LOG_INFO, "packets per mode:");
 	SNIFFER_LOG(LOG_INFO, "  U-mode: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_mode[ROHC_U_MODE],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_mode[ROHC_U_MODE], total));
+	            stats.comp_nr_pkts_per_mode[ROHC_U_MODE],
+	            compute_percent(stats.comp_nr_pkts_per_mode[ROHC_U_MODE], total));
 	SNIFFER_LOG(LOG_INFO, "  O-mode: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_mode[ROHC_O_MODE],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_mode[ROHC_O_MODE], total));
+	            stats.comp_nr_pkts_per_mode[ROHC_O_MODE],
+	            compute_percent(stats.comp_nr_pkts_per_mode[ROHC_O_MODE], total));
 	SNIFFER_LOG(LOG_INFO, "  R-mode: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_mode[ROHC_R_MODE],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_mode[ROHC_R_MODE], total));
+	            stats.comp_nr_pkts_per_mode[ROHC_R_MODE],
+	            compute_percent(stats.comp_nr_pkts_per_mode[ROHC_R_MODE], total));
 
 	/* packets per state */
-	total = sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_IR] +
-	        sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_FO] +
-	        sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_SO];
+	total = stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_IR] +
+	        stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_FO] +
+	        stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_SO];
 	SNIFFER_LOG(LOG_INFO, "packets per state:");
 	SNIFFER_LOG(LOG_INFO, "  IR state: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_IR],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_IR], total));
+	            stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_IR],
+	            compute_percent(stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_IR], total));
 	SNIFFER_LOG(LOG_INFO, "  FO state: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_FO],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_FO], total));
+	            stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_FO],
+	            compute_percent(stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_FO], total));
 	SNIFFER_LOG(LOG_INFO, "  SO state: %lu packets (%llu%%)",
-	            sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_SO],
-	            compute_percent(sniffer_stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_SO], total));
+	            stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_SO],
+	            compute_percent(stats.comp_nr_pkts_per_state[ROHC_COMP_STATE_SO], total));
 
 	/* packets per packet type */
 	SNIFFER_LOG(LOG_INFO, "packets per packet type:");
 	total = 0;
 	for(i = ROHC_PACKET_IR; i < ROHC_PACKET_MAX; i++)
 	{
-		total += sniffer_stats.comp_nr_pkts_per_pkt_type[i];
+		total += stats.comp_nr_pkts_per_pkt_type[i];
 	}
 	for(i = ROHC_PACKET_IR; i < ROHC_PACKET_MAX; i++)
 	{
@@ -868,8 +1234,8 @@ static void sniffer_print_stats(int signum __attribute__((unused)))
 		{
 			SNIFFER_LOG(LOG_INFO, "  packet type %s: %lu packets (%llu%%)",
 			            rohc_get_packet_descr(i),
-			            sniffer_stats.comp_nr_pkts_per_pkt_type[i],
-			            compute_percent(sniffer_stats.comp_nr_pkts_per_pkt_type[i], total));
+			            stats.comp_nr_pkts_per_pkt_type[i],
+			            compute_percent(stats.comp_nr_pkts_per_pkt_type[i], total));
 		}
 	}
 
@@ -877,58 +1243,202 @@ static void sniffer_print_stats(int signum __attribute__((unused)))
 }
 
 
+/**
+ * @brief Merge the compression statistics of one worker in the total
+ *
+ * @param total  IN/OUT: The merged statistics
+ * @param stats  The statistics of one worker
+ */
+static void sniffer_stats_merge(struct sniffer_stats_t *const total,
+                                const struct sniffer_stats_t *const stats)
+{
+	struct sniffer_stats_t worker_stats;
+	int i;
+
+	/* count the bytes of both statistics with the same unit */
+	memcpy(&worker_stats, stats, sizeof(struct sniffer_stats_t));
+	if(worker_stats.comp_unit_size > total->comp_unit_size)
+	{
+		sniffer_stats_rescale(total, worker_stats.comp_unit_size);
+	}
+	else
+	{
+		sniffer_stats_rescale(&worker_stats, total->comp_unit_size);
+	}
+	total->comp_pre_nr_units += worker_stats.comp_pre_nr_units;
+	total->comp_pre_nr_bytes += worker_stats.comp_pre_nr_bytes;
+	total->comp_post_nr_units += worker_stats.comp_post_nr_units;
+	total->comp_post_nr_bytes += worker_stats.comp_post_nr_bytes;
+	if(total->comp_unit_size > 1)
+	{
+		total->comp_pre_nr_units +=
+			total->comp_pre_nr_bytes / total->comp_unit_size;
+		total->comp_pre_nr_bytes %= total->comp_unit_size;
+		total->comp_post_nr_units +=
+			total->comp_post_nr_bytes / total->comp_unit_size;
+		total->comp_post_nr_bytes %= total->comp_unit_size;
+	}
+	total->comp_pre_nr_hdr_bytes += worker_stats.comp_pre_nr_hdr_bytes;
+	total->comp_post_nr_hdr_bytes += worker_stats.comp_post_nr_hdr_bytes;
+
+	for(i = 0; i <= ROHC_PROFILE_UDPLITE; i++)
+	{
+		total->comp_nr_pkts_per_profile[i] +=
+			worker_stats.comp_nr_pkts_per_profile[i];
+	}
+	for(i = 0; i <= ROHC_R_MODE; i++)
+	{
+		total->comp_nr_pkts_per_mode[i] += worker_stats.comp_nr_pkts_per_mode[i];
+	}
+	for(i = 0; i <= ROHC_COMP_STATE_SO; i++)
+	{
+		total->comp_nr_pkts_per_state[i] += worker_stats.comp_nr_pkts_per_state[i];
+	}
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		total->comp_nr_pkts_per_pkt_type[i] +=
+			worker_stats.comp_nr_pkts_per_pkt_type[i];
+	}
+	total->comp_nr_reused_cid += worker_stats.comp_nr_reused_cid;
+
+	total->total_packets += worker_stats.total_packets;
+	total->bad_packets += worker_stats.bad_packets;
+	total->nr_lost_packets += worker_stats.nr_lost_packets;
+	total->nr_loss_bursts += worker_stats.nr_loss_bursts;
+	total->max_loss_burst_len =
+		max(total->max_loss_burst_len, worker_stats.max_loss_burst_len);
+	if(total->min_loss_burst_len == 0 ||
+	   (worker_stats.min_loss_burst_len != 0 &&
+	    worker_stats.min_loss_burst_len < total->min_loss_burst_len))
+	{
+		total->min_loss_burst_len = worker_stats.min_loss_burst_len;
+	}
+	total->nr_misordered_packets += worker_stats.nr_misordered_packets;
+	total->nr_duplicated_packets += worker_stats.nr_duplicated_packets;
+}
+
+
+/**
+ * @brief Count the compressed/uncompressed bytes with a greater unit
+ *
+ * @param stats      IN/OUT: The statistics to rescale
+ * @param unit_size  The new size of one unit, a power of 1000 greater than
+ *                   or equal to the current one
+ */
+static void sniffer_stats_rescale(struct sniffer_stats_t *const stats,
+                                  const unsigned long unit_size)
+{
+	if(unit_size == stats->comp_unit_size)
+	{
+		return;
+	}
+	assert(unit_size > stats->comp_unit_size);
+
+	if(stats->comp_unit_size == 1)
+	{
+		stats->comp_pre_nr_units = stats->comp_pre_nr_bytes / unit_size;
+		stats->comp_pre_nr_bytes %= unit_size;
+		stats->comp_post_nr_units = stats->comp_post_nr_bytes / unit_size;
+		stats->comp_post_nr_bytes %= unit_size;
+	}
+	else
+	{
+		const unsigned long factor = unit_size / stats->comp_unit_size;
+		unsigned long rest;
+
+		rest = stats->comp_pre_nr_units % factor;
+		stats->comp_pre_nr_units /= factor;
+		stats->comp_pre_nr_bytes += rest * stats->comp_unit_size;
+		rest = stats->comp_post_nr_units % factor;
+		stats->comp_post_nr_units /= factor;
+		stats->comp_post_nr_bytes += rest * stats->comp_unit_size;
+	}
+	stats->comp_unit_size = unit_size;
+}
+
+
 /**
  * @brief Test the ROHC library with a sniffed flow of IP packets going
- *        through one compressor/decompressor pair
+ *        through one or several compressor/decompressor pairs
+ *
+ * Without worker threads, the packets are compressed/decompressed by the
+ * capture thread. Otherwise, the capture thread selects the shard of every
+ * packet and copies the packet in the ring of the worker of the shard.
  *
  * @param cid_type          The type of CIDs that the compressor shall use
  * @param max_contexts      The maximum number of ROHC contexts to use
+ * @param threads_nr        The number of worker threads, 0 to handle the
+ *                          packets in the capture thread
+ * @param capture           The backend to capture the packets
  * @param enabled_profiles  The ROHC profiles to enable
  * @param device_name       The name of the network device
  * @return                  Whether the sniffer setup was OK
  */
 static bool sniff(const rohc_cid_type_t cid_type,
                   const size_t max_contexts,
+                  const size_t threads_nr,
+                  const sniffer_capture_t capture,
                   const int enabled_profiles[],
                   const char *const device_name)
 {
+	const size_t workers_nr = max(threads_nr, 1);
 	char errbuf[PCAP_ERRBUF_SIZE];
 	pcap_t *handle;
 	int link_layer_type_src;
 	int link_len_src;
 	struct pcap_pkthdr header;
 	unsigned char *packet;
+#if HAVE_LINUX_IF_PACKET_H == 1
+	struct sniffer_tpacket ring = { .fd = -1, .blocks = NULL, .next_block = 0 };
+#endif
 
-	struct rohc_comp *comp;
-	struct rohc_decomp *decomp;
-
-	uint8_t feedback_send_buffer[MAX_ROHC_SIZE];
-	struct rohc_buf feedback_send =
-		rohc_buf_init_empty(feedback_send_buffer, MAX_ROHC_SIZE);
+	struct rohc_comp_shards *shards;
+	struct sniffer_worker *workers;
+	size_t workers_init_nr;
+	size_t threads_started_nr = 0;
 
-	int ret;
 	unsigned int i;
 
-	/* statistics */
-	unsigned int nb_ok = 0;
-	unsigned int nb_bad = 0;
-	unsigned int nb_internal_err = 0;
-	unsigned int err_comp = 0;
-	unsigned int err_decomp = 0;
-	unsigned int nb_ref = 0;
-
 	/* init status */
 	bool status = false;
 
 	assert(device_name != NULL);
+	assert(workers_nr <= max_contexts);
 
-	/* open the network device */
-	handle = pcap_open_live(device_name, DEV_MTU, 0, 0, errbuf);
-	if(handle == NULL)
+	if(capture == SNIFFER_CAPTURE_TPACKET)
 	{
-		SNIFFER_LOG(LOG_WARNING, "failed to open network device '%s': %s",
-		            device_name, errbuf);
+#if HAVE_LINUX_IF_PACKET_H == 1
+		/* map the ring of the network device */
+		if(!sniffer_tpacket_open(&ring, device_name))
+		{
+			goto error;
+		}
+
+		/* the ring gives the IP packets without their link layer, the PCAP
+		 * handler is only used to get the link type of the dump file */
+		handle = pcap_open_dead(DLT_RAW, DEV_MTU);
+		if(handle == NULL)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to create the PCAP handler for "
+			            "the dump files");
+			goto close_ring;
+		}
+#else
+		SNIFFER_LOG(LOG_WARNING, "the TPACKET_V3 capture is not supported on "
+		            "this platform");
 		goto error;
+#endif
+	}
+	else
+	{
+		/* open the network device */
+		handle = pcap_open_live(device_name, DEV_MTU, 0, 0, errbuf);
+		if(handle == NULL)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to open network device '%s': %s",
+			            device_name, errbuf);
+			goto error;
+		}
 	}
 
 	/* link layer in the source dump must be Ethernet */
@@ -956,167 +1466,88 @@ static bool sniff(const rohc_cid_type_t cid_type,
 		link_len_src = 0;
 	}
 
-	/* create the ROHC compressor */
-	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_false_random_num, NULL);
-	if(comp == NULL)
+	/* create the ROHC compressor, one shard (ie. one range of CIDs) for
+	 * every worker */
+	shards = rohc_comp_shards_new(cid_type, max_contexts - 1, workers_nr,
+	                              gen_false_random_num, NULL);
+	if(shards == NULL)
 	{
 		SNIFFER_LOG(LOG_WARNING, "failed to create the ROHC compressor");
 		goto close_input;
 	}
 
-	/* set the callback for traces on compressor */
-	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	/* create the workers */
+	workers = calloc(workers_nr, sizeof(struct sniffer_worker));
+	if(workers == NULL)
 	{
-		SNIFFER_LOG(LOG_WARNING, "failed to set the trace callback for the "
-		            "compressor");
+		SNIFFER_LOG(LOG_WARNING, "failed to allocate memory for %zu workers",
+		            workers_nr);
 		goto destroy_comp;
 	}
-
-	/* enable the compression profiles */
-	for(i = ROHC_PROFILE_UNCOMPRESSED; i <= ROHC_PROFILE_UDPLITE; i++)
+	for(workers_init_nr = 0; workers_init_nr < workers_nr; workers_init_nr++)
 	{
-		if(enabled_profiles[i] == 1 && !rohc_comp_enable_profile(comp, i))
-		{
-			SNIFFER_LOG(LOG_WARNING, "failed to enable compression profile "
-			            "0x%04x", i);
-			goto destroy_comp;
-		}
-		else if(enabled_profiles[i] == 0 && !rohc_comp_disable_profile(comp, i))
+		struct rohc_comp *const comp =
+			rohc_comp_shards_get(shards, workers_init_nr);
+		assert(comp != NULL);
+
+		if(!sniffer_worker_init(&workers[workers_init_nr], comp, cid_type,
+		                        max_contexts, enabled_profiles, link_len_src))
 		{
-			SNIFFER_LOG(LOG_WARNING, "failed to disable compression profile "
-			            "0x%04x", i);
-			goto destroy_comp;
+			goto destroy_workers;
 		}
 	}
 
-	/* set the callback for RTP stream detection */
-	if(!rohc_comp_set_rtp_detection_cb(comp, rtp_detect_cb, NULL))
-	{
-		SNIFFER_LOG(LOG_WARNING, "failed to set the RTP stream detection "
-		            "callback for compressor");
-		goto destroy_comp;
-	}
-
-	/* create the decompressor (bi-directional mode) */
-	decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_O_MODE);
-	if(decomp == NULL)
+	/* open the file the sniffed packets are dumped in, it is shared by all
+	 * the workers */
+	if(!sniffer_dump_open(&sniffer_dump, link_layer_type_src))
 	{
-		SNIFFER_LOG(LOG_WARNING, "failed to create the decompressor");
-		goto destroy_comp;
+		goto destroy_workers;
 	}
 
-	/* set the callback for traces on decompressor */
-	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
-	{
-		SNIFFER_LOG(LOG_WARNING, "failed to set trace callback for "
-		            "decompressor");
-		goto destroy_decomp;
-	}
+	/* publish the workers for statistics */
+	sniffer_workers = workers;
+	sniffer_workers_nr = workers_nr;
 
-	/* enable the decompression profiles */
-	for(i = ROHC_PROFILE_UNCOMPRESSED; i <= ROHC_PROFILE_UDPLITE; i++)
+#if HAVE_PTHREAD_H == 1
+	for(threads_started_nr = 0; threads_started_nr < threads_nr;
+	    threads_started_nr++)
 	{
-		if(enabled_profiles[i] == 1 && !rohc_decomp_enable_profile(decomp, i))
-		{
-			SNIFFER_LOG(LOG_WARNING, "failed to enable decompression profile "
-			            "0x%04x", i);
-			goto destroy_decomp;
-		}
-		else if(enabled_profiles[i] == 0 &&
-		        !rohc_decomp_disable_profile(decomp, i))
+		const int ret =
+			pthread_create(&workers[threads_started_nr].thread, NULL,
+			               sniffer_worker_run, &workers[threads_started_nr]);
+		if(ret != 0)
 		{
-			SNIFFER_LOG(LOG_WARNING, "failed to disable decompression profile "
-			            "0x%04x", i);
-			goto destroy_decomp;
+			SNIFFER_LOG(LOG_WARNING, "failed to create worker thread #%zu: "
+			            "%s (%d)", threads_started_nr + 1, strerror(ret), ret);
+			goto stop_threads;
 		}
 	}
-
-	/* reset the PCAP dumpers (used to save sniffed packets in several PCAP
-	 * files, one per Context ID) */
-	bzero(sniffer_dumpers, sizeof(pcap_dumper_t *) * max_contexts);
+#endif
 
 	SNIFFER_LOG(LOG_INFO, "ROHC sniffer successfully started");
 	SNIFFER_LOG(LOG_INFO, "start processing captured packets");
 
 	/* for each sniffed packet */
 	sniffer_stats.total_packets = 0;
-	while(!stop_program)
+	status = true;
+	while(!stop_program && status)
 	{
-		unsigned int cid = 0;
-
-		/* try to capture a packet */
-		packet = (unsigned char *) pcap_next(handle, &header);
-		if(packet == NULL)
+		if(capture == SNIFFER_CAPTURE_TPACKET)
 		{
-			/* no packet captured, re-try */
-			continue;
+#if HAVE_LINUX_IF_PACKET_H == 1
+			/* handle all the packets of the next block filled by the kernel */
+			status = sniffer_tpacket_capture(&ring, shards, workers, threads_nr);
+#endif
 		}
-
-		sniffer_stats.total_packets++;
-
-		if(!is_daemon &&
-		   (sniffer_stats.total_packets == 1 || (sniffer_stats.total_packets % 100) == 0))
+		else
 		{
-			if(sniffer_stats.total_packets > 1)
-			{
-				printf("\r");
-			}
-			printf("packet #%lu", sniffer_stats.total_packets);
-			fflush(stdout);
-
-			if(do_print_stat && (sniffer_stats.total_packets % 1000) == 0)
+			/* try to capture a packet */
+			packet = (unsigned char *) pcap_next(handle, &header);
+			if(packet != NULL)
 			{
-				printf("\n\n");
-				fprintf(stderr, "================================================\n");
-				sniffer_print_stats(SIGUSR1);
-				fprintf(stderr, "================================================\n");
-				fprintf(stderr, "\n");
-				fflush(stderr);
+				sniffer_handle_packet(shards, workers, threads_nr, header, packet);
 			}
 		}
-
-		/* compress & decompress from compressor to decompressor */
-		ret = compress_decompress(comp, decomp, header, packet,
-		                          link_len_src, handle, sniffer_dumpers,
-		                          &feedback_send, &cid, &sniffer_stats);
-		if(ret == -1)
-		{
-			err_comp++;
-		}
-		else if(ret == -2)
-		{
-			err_decomp++;
-		}
-		else if(ret == 0)
-		{
-			nb_ref++;
-		}
-		else if(ret == 1)
-		{
-			nb_ok++;
-		}
-		else if(ret == -3)
-		{
-			nb_bad++;
-			sniffer_stats.bad_packets++;
-		}
-		else
-		{
-			nb_internal_err++;
-		}
-
-		/* in case of problem (ignore bad packets), just die! */
-		if(ret != 1 && ret != -3)
-		{
-			SNIFFER_LOG(LOG_WARNING, "packet #%lu, CID %u: stats OK, ERR(COMP), "
-			            "ERR(DECOMP), ERR(REF), ERR(BAD), ERR(INTERNAL)  =  "
-			            "%u  %u  %u  %u  %u  %u", sniffer_stats.total_packets,
-			            cid, nb_ok, err_comp, err_decomp, nb_ref, nb_bad,
-			            nb_internal_err);
-
-			/* last debug traces are recorded in SIGABRT handler */
-			assert(0);
-		}
 	}
 
 	if(stop_program)
@@ -1124,29 +1555,1018 @@ static bool sniff(const rohc_cid_type_t cid_type,
 		SNIFFER_LOG(LOG_INFO, "program stopped by signal");
 	}
 
-	status = true;
-
-	/* close PCAP dumpers */
-	for(i = 0; i < max_contexts; i++)
+#if HAVE_PTHREAD_H == 1
+stop_threads:
+	/* let the workers handle the packets left in their rings, then stop */
+	for(i = 0; i < threads_started_nr; i++)
 	{
-		if(sniffer_dumpers[i] != NULL)
-		{
-			SNIFFER_LOG(LOG_INFO, "close dump file for context with ID %u", i);
-			pcap_dump_close(sniffer_dumpers[i]);
-		}
+		__atomic_store_n(&workers[i].is_stopping, true, __ATOMIC_RELEASE);
+	}
+	for(i = 0; i < threads_started_nr; i++)
+	{
+		pthread_join(workers[i].thread, NULL);
+	}
+#endif
+	if(threads_started_nr != threads_nr)
+	{
+		status = false;
 	}
 
-destroy_decomp:
-	rohc_decomp_free(decomp);
+	/* write the buffered packets and close the dump file */
+	sniffer_dump_close(&sniffer_dump);
+
+	sniffer_workers_nr = 0;
+	sniffer_workers = NULL;
+destroy_workers:
+	while(workers_init_nr > 0)
+	{
+		workers_init_nr--;
+		sniffer_worker_free(&workers[workers_init_nr]);
+	}
+	free(workers);
 destroy_comp:
-	rohc_comp_free(comp);
+	rohc_comp_shards_free(shards);
 close_input:
 	pcap_close(handle);
+#if HAVE_LINUX_IF_PACKET_H == 1
+close_ring:
+	if(capture == SNIFFER_CAPTURE_TPACKET)
+	{
+		sniffer_tpacket_close(&ring);
+	}
+#endif
 error:
 	return status;
 }
 
 
+/**
+ * @brief Handle one captured packet
+ *
+ * Without worker threads, the packet is compressed/decompressed right away.
+ * Otherwise, it is copied in the ring of the worker of its shard.
+ *
+ * @param shards      The sharded ROHC compressor
+ * @param workers     The workers
+ * @param threads_nr  The number of worker threads, 0 if none
+ * @param header      The PCAP header for the packet
+ * @param packet      The packet (link layer included)
+ */
+static void sniffer_handle_packet(struct rohc_comp_shards *const shards,
+                                  struct sniffer_worker *const workers,
+                                  const size_t threads_nr,
+                                  struct pcap_pkthdr header,
+                                  unsigned char *const packet)
+{
+	const size_t link_len = workers[0].link_len;
+
+	sniffer_stats.total_packets++;
+
+	if(!is_daemon &&
+	   (sniffer_stats.total_packets == 1 || (sniffer_stats.total_packets % 100) == 0))
+	{
+		if(sniffer_stats.total_packets > 1)
+		{
+			printf("\r");
+		}
+		printf("packet #%lu", sniffer_stats.total_packets);
+		fflush(stdout);
+
+		if(do_print_stat && (sniffer_stats.total_packets % 1000) == 0)
+		{
+			printf("\n\n");
+			fprintf(stderr, "================================================\n");
+			sniffer_print_stats(SIGUSR1);
+			fprintf(stderr, "================================================\n");
+			fprintf(stderr, "\n");
+			fflush(stderr);
+		}
+	}
+
+	if(threads_nr == 0)
+	{
+		/* compress & decompress from compressor to decompressor */
+		sniffer_worker_process(&workers[0], header, packet);
+	}
+	else
+	{
+		size_t shard_id = 0;
+
+		/* all the packets of one flow go to the same worker, packets too
+		 * short for an IP header are handled by the first worker */
+		if(header.caplen > link_len)
+		{
+			const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+			const struct rohc_buf ip_packet =
+				rohc_buf_init_full(packet + link_len, header.caplen - link_len,
+				                   arrival_time);
+
+			if(!rohc_comp_shards_select(shards, ip_packet, &shard_id))
+			{
+				SNIFFER_LOG(LOG_WARNING, "failed to select the worker of "
+				            "packet #%lu", sniffer_stats.total_packets);
+				assert(0);
+			}
+		}
+
+		if(!sniffer_worker_enqueue(&workers[shard_id], &header, packet))
+		{
+			sniffer_stats.nr_dropped_packets++;
+		}
+	}
+}
+
+
+/**
+ * @brief Create the decompressor of one worker and configure the compressor
+ *        of its shard
+ *
+ * @param worker            The worker to initialize
+ * @param comp              The compressor of the shard of the worker
+ * @param cid_type          The type of CIDs that the compressor shall use
+ * @param max_contexts      The maximum number of ROHC contexts to use
+ * @param enabled_profiles  The ROHC profiles to enable
+ * @param link_len          The length of the link layer header before IP data
+ * @return                  Whether the worker was successfully initialized
+ */
+static bool sniffer_worker_init(struct sniffer_worker *const worker,
+                                struct rohc_comp *const comp,
+                                const rohc_cid_type_t cid_type,
+                                const size_t max_contexts,
+                                const int enabled_profiles[],
+                                const size_t link_len)
+{
+	const struct rohc_buf feedback_send =
+		rohc_buf_init_empty(worker->feedback_send_buffer, MAX_ROHC_SIZE);
+	unsigned int i;
+
+	worker->comp = comp;
+	worker->link_len = link_len;
+	worker->feedback_send = feedback_send;
+	memset(&worker->stats, 0, sizeof(struct sniffer_stats_t));
+	worker->stats.comp_unit_size = 1;
+
+	/* set the callback for traces on compressor */
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to set the trace callback for the "
+		            "compressor");
+		goto error;
+	}
+
+	/* enable the compression profiles */
+	for(i = ROHC_PROFILE_UNCOMPRESSED; i <= ROHC_PROFILE_UDPLITE; i++)
+	{
+		if(enabled_profiles[i] == 1 && !rohc_comp_enable_profile(comp, i))
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to enable compression profile "
+			            "0x%04x", i);
+			goto error;
+		}
+		else if(enabled_profiles[i] == 0 && !rohc_comp_disable_profile(comp, i))
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to disable compression profile "
+			            "0x%04x", i);
+			goto error;
+		}
+	}
+
+	/* set the callback for RTP stream detection */
+	if(!rohc_comp_set_rtp_detection_cb(comp, rtp_detect_cb, NULL))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to set the RTP stream detection "
+		            "callback for compressor");
+		goto error;
+	}
+
+	/* create the decompressor (bi-directional mode) */
+	worker->decomp = rohc_decomp_new2(cid_type, max_contexts - 1, ROHC_O_MODE);
+	if(worker->decomp == NULL)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to create the decompressor");
+		goto error;
+	}
+
+	/* set the callback for traces on decompressor */
+	if(!rohc_decomp_set_traces_cb2(worker->decomp, print_rohc_traces, NULL))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to set trace callback for "
+		            "decompressor");
+		goto destroy_decomp;
+	}
+
+	/* enable the decompression profiles */
+	for(i = ROHC_PROFILE_UNCOMPRESSED; i <= ROHC_PROFILE_UDPLITE; i++)
+	{
+		if(enabled_profiles[i] == 1 &&
+		   !rohc_decomp_enable_profile(worker->decomp, i))
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to enable decompression profile "
+			            "0x%04x", i);
+			goto destroy_decomp;
+		}
+		else if(enabled_profiles[i] == 0 &&
+		        !rohc_decomp_disable_profile(worker->decomp, i))
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to disable decompression profile "
+			            "0x%04x", i);
+			goto destroy_decomp;
+		}
+	}
+
+	return true;
+
+destroy_decomp:
+	rohc_decomp_free(worker->decomp);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Release the decompressor and the ring of one worker
+ *
+ * @param worker  The worker to release
+ */
+static void sniffer_worker_free(struct sniffer_worker *const worker)
+{
+	size_t i;
+
+	for(i = 0; i < SNIFFER_RING_LEN; i++)
+	{
+		free(worker->ring[i].data);
+	}
+	rohc_decomp_free(worker->decomp);
+}
+
+
+/**
+ * @brief Copy one captured packet in the ring of one worker
+ *
+ * Called by the capture thread only.
+ *
+ * @param worker  The worker that shall handle the packet
+ * @param header  The PCAP header for the packet
+ * @param packet  The packet to copy (link layer included)
+ * @return        true if the packet was queued,
+ *                false if the ring is full or the packet cannot be copied
+ */
+static bool sniffer_worker_enqueue(struct sniffer_worker *const worker,
+                                   const struct pcap_pkthdr *const header,
+                                   const unsigned char *const packet)
+{
+	const uint32_t head = worker->ring_head;
+	const uint32_t tail = __atomic_load_n(&worker->ring_tail, __ATOMIC_ACQUIRE);
+	struct sniffer_slot *slot;
+
+	if((head - tail) >= SNIFFER_RING_LEN)
+	{
+		return false;
+	}
+
+	/* the slot is free, so the capture thread may grow its buffer */
+	slot = &worker->ring[head % SNIFFER_RING_LEN];
+	if(header->caplen > slot->max_len)
+	{
+		const size_t new_len = max(header->caplen, SNIFFER_SLOT_MIN_LEN);
+		unsigned char *const new_data = realloc(slot->data, new_len);
+		if(new_data == NULL)
+		{
+			return false;
+		}
+		slot->data = new_data;
+		slot->max_len = new_len;
+	}
+	memcpy(slot->data, packet, header->caplen);
+	memcpy(&slot->header, header, sizeof(struct pcap_pkthdr));
+
+	__atomic_store_n(&worker->ring_head, head + 1, __ATOMIC_RELEASE);
+
+	return true;
+}
+
+
+#if HAVE_PTHREAD_H == 1
+
+/**
+ * @brief Compress/decompress the packets of the ring of one worker
+ *
+ * The worker stops once asked to and its ring is empty.
+ *
+ * @param arg  The worker
+ * @return     Always NULL
+ */
+static void * sniffer_worker_run(void *arg)
+{
+	struct sniffer_worker *const worker = arg;
+	uint32_t tail = worker->ring_tail;
+
+	for(;;)
+	{
+		/* read the stop flag before the head, so that all the packets pushed
+		 * before the stop request are handled */
+		const bool is_stopping =
+			__atomic_load_n(&worker->is_stopping, __ATOMIC_ACQUIRE);
+		const uint32_t head =
+			__atomic_load_n(&worker->ring_head, __ATOMIC_ACQUIRE);
+
+		if(head == tail)
+		{
+			if(is_stopping)
+			{
+				break;
+			}
+			sched_yield();
+			continue;
+		}
+
+		while(tail != head)
+		{
+			struct sniffer_slot *const slot =
+				&worker->ring[tail % SNIFFER_RING_LEN];
+
+			sniffer_worker_process(worker, slot->header, slot->data);
+			tail++;
+			__atomic_store_n(&worker->ring_tail, tail, __ATOMIC_RELEASE);
+		}
+	}
+
+	return NULL;
+}
+
+#endif /* HAVE_PTHREAD_H == 1 */
+
+
+/**
+ * @brief Compress and decompress one captured packet with the
+ *        compressor/decompressor pair of one worker
+ *
+ * The program dies in case of problem (bad packets are ignored), the last
+ * debug traces are then printed by the SIGABRT handler.
+ *
+ * @param worker  The worker that handles the packet
+ * @param header  The PCAP header for the packet
+ * @param packet  The packet to compress/decompress (link layer included)
+ */
+static void sniffer_worker_process(struct sniffer_worker *const worker,
+                                   struct pcap_pkthdr header,
+                                   unsigned char *packet)
+{
+	unsigned int cid = 0;
+	int ret;
+
+	worker->stats.total_packets++;
+
+	/* compress & decompress from compressor to decompressor */
+	ret = compress_decompress(worker->comp, worker->decomp, header, packet,
+	                          worker->link_len, &sniffer_dump,
+	                          &worker->feedback_send, &cid, &worker->stats);
+	if(ret == -1)
+	{
+		worker->err_comp++;
+	}
+	else if(ret == -2)
+	{
+		worker->err_decomp++;
+	}
+	else if(ret == 0)
+	{
+		worker->nb_ref++;
+	}
+	else if(ret == 1)
+	{
+		worker->nb_ok++;
+	}
+	else if(ret == -3)
+	{
+		worker->nb_bad++;
+		worker->stats.bad_packets++;
+	}
+	else
+	{
+		worker->nb_internal_err++;
+	}
+
+	/* in case of problem (ignore bad packets), just die! */
+	if(ret != 1 && ret != -3)
+	{
+		SNIFFER_LOG(LOG_WARNING, "packet #%lu, CID %u: stats OK, ERR(COMP), "
+		            "ERR(DECOMP), ERR(REF), ERR(BAD), ERR(INTERNAL)  =  "
+		            "%u  %u  %u  %u  %u  %u", worker->stats.total_packets,
+		            cid, worker->nb_ok, worker->err_comp, worker->err_decomp,
+		            worker->nb_ref, worker->nb_bad, worker->nb_internal_err);
+
+		/* last debug traces are recorded in SIGABRT handler */
+		assert(0);
+	}
+}
+
+
+/**
+ * @brief Open the file the sniffed packets are dumped in
+ *
+ * The previous dump file is overwritten. The writer thread is started if
+ * threads are supported.
+ *
+ * @param dump       The dump to open
+ * @param link_type  The PCAP link type of the sniffed packets
+ * @return           Whether the dump was successfully opened
+ */
+static bool sniffer_dump_open(struct sniffer_dump *const dump,
+                              const int link_type)
+{
+	size_t i;
+
+	/* DLT_RAW is not the same on all the OS, the other PCAP link types are
+	 * the pcapng ones */
+	dump->link_type = (link_type == DLT_RAW ? SNIFFER_DUMP_LINKTYPE_RAW :
+	                   (uint16_t) link_type);
+	dump->active = 0;
+	dump->dropped_nr = 0;
+	for(i = 0; i < 2; i++)
+	{
+		dump->lens[i] = 0;
+		dump->bufs[i] = malloc(SNIFFER_DUMP_BUF_LEN);
+		if(dump->bufs[i] == NULL)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to allocate the buffers of the "
+			            "dump file");
+			goto free_bufs;
+		}
+	}
+
+	if(!sniffer_dump_create(dump))
+	{
+		goto free_bufs;
+	}
+
+#if HAVE_PTHREAD_H == 1
+	{
+		int ret;
+
+		dump->is_stopping = false;
+		pthread_mutex_init(&dump->lock, NULL);
+		pthread_cond_init(&dump->cond, NULL);
+		ret = pthread_create(&dump->writer, NULL, sniffer_dump_run, dump);
+		if(ret != 0)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to create the writer thread of the "
+			            "dump file: %s (%d)", strerror(ret), ret);
+			pthread_cond_destroy(&dump->cond);
+			pthread_mutex_destroy(&dump->lock);
+			goto close_file;
+		}
+	}
+#endif
+
+	SNIFFER_LOG(LOG_INFO, "dump the sniffed packets in file '%s'",
+	            SNIFFER_DUMP_FILENAME);
+
+	return true;
+
+#if HAVE_PTHREAD_H == 1
+close_file:
+	close(dump->fd);
+	dump->fd = -1;
+#endif
+free_bufs:
+	for(i = 0; i < 2; i++)
+	{
+		free(dump->bufs[i]);
+		dump->bufs[i] = NULL;
+	}
+	return false;
+}
+
+
+/**
+ * @brief Write the buffered packets and close the dump file
+ *
+ * @param dump  The dump to close
+ */
+static void sniffer_dump_close(struct sniffer_dump *const dump)
+{
+	size_t i;
+
+	if(dump->fd < 0)
+	{
+		return;
+	}
+
+#if HAVE_PTHREAD_H == 1
+	/* the writer thread writes the buffered packets before stopping */
+	pthread_mutex_lock(&dump->lock);
+	dump->is_stopping = true;
+	pthread_cond_signal(&dump->cond);
+	pthread_mutex_unlock(&dump->lock);
+	pthread_join(dump->writer, NULL);
+	pthread_cond_destroy(&dump->cond);
+	pthread_mutex_destroy(&dump->lock);
+#else
+	sniffer_dump_write(dump, dump->bufs[dump->active], dump->lens[dump->active]);
+	dump->lens[dump->active] = 0;
+#endif
+
+	if(dump->dropped_nr > 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "%lu packets were not dumped in file '%s' "
+		            "because the disk was too slow", dump->dropped_nr,
+		            SNIFFER_DUMP_FILENAME);
+	}
+	SNIFFER_LOG(LOG_INFO, "close dump file '%s'", SNIFFER_DUMP_FILENAME);
+	close(dump->fd);
+	dump->fd = -1;
+
+	for(i = 0; i < 2; i++)
+	{
+		free(dump->bufs[i]);
+		dump->bufs[i] = NULL;
+	}
+}
+
+
+/**
+ * @brief Create the dump file and write its pcapng section and interface
+ *
+ * @param dump  The dump
+ * @return      Whether the dump file was successfully created
+ */
+static bool sniffer_dump_create(struct sniffer_dump *const dump)
+{
+	/* the Section Header Block (28 bytes) then the Interface Description
+	 * Block (20 bytes), in host byte order as allowed by pcapng */
+	const uint32_t shb[7] = { 0x0a0d0d0a, 28, 0x1a2b3c4d, 1 /* v1.0 */,
+	                          0xffffffff, 0xffffffff /* unknown length */, 28 };
+	const uint32_t idb[5] = { 1, 20, dump->link_type, DEV_MTU, 20 };
+	unsigned char hdrs[sizeof(shb) + sizeof(idb)];
+	ssize_t ret;
+
+	memcpy(hdrs, shb, sizeof(shb));
+	memcpy(hdrs + sizeof(shb), idb, sizeof(idb));
+
+	dump->fd = open(SNIFFER_DUMP_FILENAME, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if(dump->fd < 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to create dump file '%s': %s (%d)",
+		            SNIFFER_DUMP_FILENAME, strerror(errno), errno);
+		goto error;
+	}
+
+	ret = write(dump->fd, hdrs, sizeof(hdrs));
+	if(ret != sizeof(hdrs))
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to write the headers of dump file "
+		            "'%s'", SNIFFER_DUMP_FILENAME);
+		goto close_file;
+	}
+	dump->file_len = sizeof(hdrs);
+
+	return true;
+
+close_file:
+	close(dump->fd);
+	dump->fd = -1;
+error:
+	return false;
+}
+
+
+/**
+ * @brief Write the given pcapng blocks in the dump file
+ *
+ * The dump file is rotated once it reaches \ref SNIFFER_DUMP_MAX_LEN bytes:
+ * the previous dump file is kept as \ref SNIFFER_DUMP_OLD_FILENAME. The
+ * blocks are lost if the dump file cannot be written.
+ *
+ * @param dump  The dump
+ * @param buf   The pcapng blocks to write
+ * @param len   The length of the pcapng blocks
+ */
+static void sniffer_dump_write(struct sniffer_dump *const dump,
+                               const unsigned char *const buf,
+                               const size_t len)
+{
+	size_t written_len = 0;
+
+	if(dump->fd < 0 || len == 0)
+	{
+		return;
+	}
+
+	/* rotate the dump file if it is too large */
+	if((dump->file_len + len) > SNIFFER_DUMP_MAX_LEN)
+	{
+		close(dump->fd);
+		dump->fd = -1;
+		if(rename(SNIFFER_DUMP_FILENAME, SNIFFER_DUMP_OLD_FILENAME) != 0)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to rename dump file '%s' to '%s': "
+			            "%s (%d)", SNIFFER_DUMP_FILENAME,
+			            SNIFFER_DUMP_OLD_FILENAME, strerror(errno), errno);
+		}
+		if(!sniffer_dump_create(dump))
+		{
+			return;
+		}
+	}
+
+	while(written_len < len)
+	{
+		const ssize_t ret =
+			write(dump->fd, buf + written_len, len - written_len);
+		if(ret < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		else if(ret <= 0)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to write %zu bytes in dump file "
+			            "'%s': %s (%d)", len - written_len, SNIFFER_DUMP_FILENAME,
+			            strerror(errno), errno);
+			break;
+		}
+		written_len += ret;
+	}
+	dump->file_len += written_len;
+}
+
+
+/**
+ * @brief Append one sniffed packet to the buffered pcapng blocks
+ *
+ * The packet is recorded in one pcapng Enhanced Packet Block, with the given
+ * comment. The packet is not dumped if the two buffers are full.
+ *
+ * @param dump     The dump
+ * @param header   The PCAP header of the packet
+ * @param packet   The packet (link layer included)
+ * @param comment  The comment of the packet, eg. its CID
+ */
+static void sniffer_dump_packet(struct sniffer_dump *const dump,
+                                const struct pcap_pkthdr *const header,
+                                const unsigned char *const packet,
+                                const char *const comment)
+{
+	const uint64_t ts = ((uint64_t) header->ts.tv_sec) * 1000000U +
+	                    header->ts.tv_usec;
+	const size_t comment_len = strlen(comment);
+	const size_t block_len = 7 * sizeof(uint32_t) +
+	                         SNIFFER_DUMP_PAD32(header->caplen) +
+	                         sizeof(uint32_t) + SNIFFER_DUMP_PAD32(comment_len) +
+	                         sizeof(uint32_t) + sizeof(uint32_t);
+	const uint32_t epb[7] = { 6, block_len, 0 /* interface */,
+	                          ts >> 32, ts & 0xffffffff, header->caplen,
+	                          header->len };
+	const uint16_t opt_comment[2] = { 1, comment_len };
+	const uint32_t opt_end = 0;
+	const uint32_t trailer = block_len;
+	unsigned char *block;
+
+	if(dump->fd < 0 || block_len > SNIFFER_DUMP_BUF_LEN)
+	{
+		return;
+	}
+
+#if HAVE_PTHREAD_H == 1
+	pthread_mutex_lock(&dump->lock);
+#endif
+
+	/* switch to the other buffer when the active one is full, the packet
+	 * is lost if the other buffer was not written yet */
+	if((dump->lens[dump->active] + block_len) > SNIFFER_DUMP_BUF_LEN)
+	{
+#if HAVE_PTHREAD_H == 1
+		const size_t other = 1 - dump->active;
+
+		if(dump->lens[other] != 0)
+		{
+			dump->dropped_nr++;
+			pthread_mutex_unlock(&dump->lock);
+			return;
+		}
+		dump->active = other;
+		pthread_cond_signal(&dump->cond);
+#else
+		sniffer_dump_write(dump, dump->bufs[dump->active],
+		                   dump->lens[dump->active]);
+		dump->lens[dump->active] = 0;
+#endif
+	}
+
+	block = dump->bufs[dump->active] + dump->lens[dump->active];
+	memcpy(block, epb, sizeof(epb));
+	block += sizeof(epb);
+	memcpy(block, packet, header->caplen);
+	memset(block + header->caplen, 0,
+	       SNIFFER_DUMP_PAD32(header->caplen) - header->caplen);
+	block += SNIFFER_DUMP_PAD32(header->caplen);
+	memcpy(block, opt_comment, sizeof(opt_comment));
+	block += sizeof(opt_comment);
+	memcpy(block, comment, comment_len);
+	memset(block + comment_len, 0,
+	       SNIFFER_DUMP_PAD32(comment_len) - comment_len);
+	block += SNIFFER_DUMP_PAD32(comment_len);
+	memcpy(block, &opt_end, sizeof(opt_end));
+	block += sizeof(opt_end);
+	memcpy(block, &trailer, sizeof(trailer));
+	dump->lens[dump->active] += block_len;
+
+#if HAVE_PTHREAD_H == 1
+	pthread_mutex_unlock(&dump->lock);
+#endif
+}
+
+
+#if HAVE_PTHREAD_H == 1
+
+/**
+ * @brief The main loop of the thread that writes the dump file
+ *
+ * The full buffers are written as soon as the workers switch to the other
+ * buffer, the partly filled ones after \ref SNIFFER_DUMP_FLUSH_DELAY
+ * seconds. All the buffered packets are written before the thread stops.
+ *
+ * @param arg  The dump
+ * @return     NULL
+ */
+static void * sniffer_dump_run(void *arg)
+{
+	struct sniffer_dump *const dump = arg;
+
+	pthread_mutex_lock(&dump->lock);
+	while(true)
+	{
+		const size_t pending = 1 - dump->active;
+
+		if(dump->lens[pending] != 0)
+		{
+			/* write the full buffer without blocking the workers */
+			const size_t len = dump->lens[pending];
+
+			pthread_mutex_unlock(&dump->lock);
+			sniffer_dump_write(dump, dump->bufs[pending], len);
+			pthread_mutex_lock(&dump->lock);
+			dump->lens[pending] = 0;
+		}
+		else if(dump->is_stopping)
+		{
+			if(dump->lens[dump->active] == 0)
+			{
+				break;
+			}
+			dump->active = pending;
+		}
+		else
+		{
+			struct timespec deadline;
+
+			clock_gettime(CLOCK_REALTIME, &deadline);
+			deadline.tv_sec += SNIFFER_DUMP_FLUSH_DELAY;
+			if(pthread_cond_timedwait(&dump->cond, &dump->lock,
+			                          &deadline) == ETIMEDOUT &&
+			   dump->lens[1 - dump->active] == 0 &&
+			   dump->lens[dump->active] != 0)
+			{
+				/* flush the partly filled buffer */
+				dump->active = 1 - dump->active;
+			}
+		}
+	}
+	pthread_mutex_unlock(&dump->lock);
+
+	return NULL;
+}
+
+#endif /* HAVE_PTHREAD_H == 1 */
+
+
+/**
+ * @brief Write the buffered packets when the program crashes
+ *
+ * Called by the SIGSEGV/SIGABRT handler: the locks are not taken and the
+ * dump file is not rotated.
+ *
+ * @param dump  The dump
+ */
+static void sniffer_dump_crash(const struct sniffer_dump *const dump)
+{
+	const size_t pending = 1 - dump->active;
+	ssize_t ret;
+
+	if(dump->fd < 0)
+	{
+		return;
+	}
+	if(dump->lens[pending] != 0)
+	{
+		ret = write(dump->fd, dump->bufs[pending], dump->lens[pending]);
+		(void) ret;
+	}
+	if(dump->lens[dump->active] != 0)
+	{
+		ret = write(dump->fd, dump->bufs[dump->active], dump->lens[dump->active]);
+		(void) ret;
+	}
+}
+
+
+#if HAVE_LINUX_IF_PACKET_H == 1
+
+/**
+ * @brief Map the AF_PACKET TPACKET_V3 ring of one network device
+ *
+ * The socket is a SOCK_DGRAM one, so the ring gives the IP packets without
+ * their link layer, whatever the type of the network device.
+ *
+ * @param ring         OUT: The ring
+ * @param device_name  The name of the network device
+ * @return             Whether the ring was successfully mapped
+ */
+static bool sniffer_tpacket_open(struct sniffer_tpacket *const ring,
+                                 const char *const device_name)
+{
+	const size_t ring_len = SNIFFER_TPACKET_BLOCK_LEN * SNIFFER_TPACKET_BLOCKS_NR;
+	const int version = TPACKET_V3;
+	struct tpacket_req3 req;
+	struct sockaddr_ll addr;
+	struct ifreq ifr;
+	int ret;
+
+	ring->fd = socket(AF_PACKET, SOCK_DGRAM, htons(ETH_P_ALL));
+	if(ring->fd < 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to create AF_PACKET socket: %s (%d)",
+		            strerror(errno), errno);
+		goto error;
+	}
+
+	/* get the index of the network device */
+	memset(&ifr, 0, sizeof(struct ifreq));
+	strncpy(ifr.ifr_name, device_name, IFNAMSIZ - 1);
+	ret = ioctl(ring->fd, SIOCGIFINDEX, &ifr);
+	if(ret != 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to get the index of network device "
+		            "'%s': %s (%d)", device_name, strerror(errno), errno);
+		goto close_socket;
+	}
+
+	/* ask for a TPACKET_V3 ring made of large blocks of variable-length
+	 * frames, the kernel hands one block once full or after a timeout */
+	ret = setsockopt(ring->fd, SOL_PACKET, PACKET_VERSION, &version,
+	                 sizeof(int));
+	if(ret != 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to enable TPACKET_V3: %s (%d)",
+		            strerror(errno), errno);
+		goto close_socket;
+	}
+	memset(&req, 0, sizeof(struct tpacket_req3));
+	req.tp_block_size = SNIFFER_TPACKET_BLOCK_LEN;
+	req.tp_block_nr = SNIFFER_TPACKET_BLOCKS_NR;
+	req.tp_frame_size = SNIFFER_TPACKET_FRAME_LEN;
+	req.tp_frame_nr = ring_len / SNIFFER_TPACKET_FRAME_LEN;
+	req.tp_retire_blk_tov = SNIFFER_TPACKET_TIMEOUT_MS;
+	ret = setsockopt(ring->fd, SOL_PACKET, PACKET_RX_RING, &req,
+	                 sizeof(struct tpacket_req3));
+	if(ret != 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to create the TPACKET_V3 ring: %s (%d)",
+		            strerror(errno), errno);
+		goto close_socket;
+	}
+
+	ring->blocks = mmap(NULL, ring_len, PROT_READ | PROT_WRITE, MAP_SHARED,
+	                    ring->fd, 0);
+	if(ring->blocks == MAP_FAILED)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to map the TPACKET_V3 ring: %s (%d)",
+		            strerror(errno), errno);
+		goto close_socket;
+	}
+	ring->next_block = 0;
+
+	/* capture the packets of the network device only */
+	memset(&addr, 0, sizeof(struct sockaddr_ll));
+	addr.sll_family = AF_PACKET;
+	addr.sll_protocol = htons(ETH_P_ALL);
+	addr.sll_ifindex = ifr.ifr_ifindex;
+	ret = bind(ring->fd, (struct sockaddr *) &addr, sizeof(struct sockaddr_ll));
+	if(ret != 0)
+	{
+		SNIFFER_LOG(LOG_WARNING, "failed to bind to network device '%s': "
+		            "%s (%d)", device_name, strerror(errno), errno);
+		goto unmap_ring;
+	}
+
+	return true;
+
+unmap_ring:
+	munmap(ring->blocks, ring_len);
+close_socket:
+	close(ring->fd);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Unmap the AF_PACKET TPACKET_V3 ring
+ *
+ * @param ring  The ring
+ */
+static void sniffer_tpacket_close(struct sniffer_tpacket *const ring)
+{
+	munmap(ring->blocks, SNIFFER_TPACKET_BLOCK_LEN * SNIFFER_TPACKET_BLOCKS_NR);
+	close(ring->fd);
+}
+
+
+/**
+ * @brief Handle all the packets of the next block of the TPACKET_V3 ring
+ *
+ * Wait for a while if the kernel did not hand the block yet. The packets are
+ * handled in place in the block, then the block is given back to the kernel.
+ * The packets that are not IPv4 nor IPv6 are ignored. The packets dropped by
+ * the kernel because the ring was full are counted as dropped packets.
+ *
+ * @param ring        The ring
+ * @param shards      The sharded ROHC compressor
+ * @param workers     The workers
+ * @param threads_nr  The number of worker threads, 0 if none
+ * @return            false if the ring cannot be polled any more,
+ *                    true otherwise
+ */
+static bool sniffer_tpacket_capture(struct sniffer_tpacket *const ring,
+                                    struct rohc_comp_shards *const shards,
+                                    struct sniffer_worker *const workers,
+                                    const size_t threads_nr)
+{
+	struct tpacket_block_desc *const block = (struct tpacket_block_desc *)
+		(ring->blocks + ring->next_block * SNIFFER_TPACKET_BLOCK_LEN);
+	struct tpacket3_hdr *frame;
+	struct tpacket_stats_v3 kernel_stats;
+	socklen_t kernel_stats_len = sizeof(struct tpacket_stats_v3);
+	uint32_t i;
+
+	if((__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) &
+	    TP_STATUS_USER) == 0)
+	{
+		struct pollfd pfd = { .fd = ring->fd, .events = POLLIN, .revents = 0 };
+
+		/* wake up regularly to check whether the program shall stop */
+		if(poll(&pfd, 1, 100) < 0 && errno != EINTR)
+		{
+			SNIFFER_LOG(LOG_WARNING, "failed to poll the TPACKET_V3 ring: "
+			            "%s (%d)", strerror(errno), errno);
+			return false;
+		}
+		return true;
+	}
+
+	frame = (struct tpacket3_hdr *)
+		(((unsigned char *) block) + block->hdr.bh1.offset_to_first_pkt);
+	for(i = 0; i < block->hdr.bh1.num_pkts; i++)
+	{
+		const struct sockaddr_ll *const sll = (const struct sockaddr_ll *)
+			(((const unsigned char *) frame) +
+			 TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+
+		if(sll->sll_protocol == htons(ETH_P_IP) ||
+		   sll->sll_protocol == htons(ETH_P_IPV6))
+		{
+			struct pcap_pkthdr header;
+
+			header.ts.tv_sec = frame->tp_sec;
+			header.ts.tv_usec = frame->tp_nsec / 1000;
+			header.caplen = frame->tp_snaplen;
+			header.len = frame->tp_len;
+			sniffer_handle_packet(shards, workers, threads_nr, header,
+			                      ((unsigned char *) frame) + frame->tp_mac);
+		}
+
+		frame = (struct tpacket3_hdr *)
+			(((unsigned char *) frame) + frame->tp_next_offset);
+	}
+
+	/* give the block back to the kernel */
+	__atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL,
+	                 __ATOMIC_RELEASE);
+	ring->next_block = (ring->next_block + 1) % SNIFFER_TPACKET_BLOCKS_NR;
+
+	/* the kernel resets its counters every time they are read */
+	if(getsockopt(ring->fd, SOL_PACKET, PACKET_STATISTICS, &kernel_stats,
+	              &kernel_stats_len) == 0)
+	{
+		sniffer_stats.nr_dropped_packets += kernel_stats.tp_drops;
+	}
+
+	return true;
+}
+
+#endif /* HAVE_LINUX_IF_PACKET_H == 1 */
+
+
 /**
  * @brief Compress and decompress one uncompressed IP packet with the given
  *        compressor and decompressor
@@ -1156,8 +2576,7 @@ error:
  * @param header         The PCAP header for the packet
  * @param packet         The packet to compress/decompress (link layer included)
  * @param link_len_src   The length of the link layer header before IP data
- * @param handle         The PCAP handler that sniffed the packet
- * @param dumpers        The PCAP dumpers, one per context
+ * @param dump           The file the packet is dumped in
  * @param cid            OUT: the CID used for the last packet
  * @param stats          IN/OUT: The sniffer stats
  * @return               1 if the process is successful
@@ -1173,12 +2592,12 @@ static int compress_decompress(struct rohc_comp *comp,
                                struct pcap_pkthdr header,
                                unsigned char *packet,
                                size_t link_len_src,
-                               pcap_t *handle,
-                               pcap_dumper_t *dumpers[],
+                               struct sniffer_dump *const dump,
                                struct rohc_buf *const feedback_send,
                                unsigned int *const cid,
                                struct sniffer_stats_t *stats)
 {
+	char dump_comment[64];
 	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
 	struct rohc_buf ip_packet =
 		rohc_buf_init_full(packet, header.caplen, arrival_time);
@@ -1265,29 +2684,12 @@ static int compress_decompress(struct rohc_comp *comp,
 	status = rohc_compress4(comp, ip_packet, &rohc_packet);
 	if(status != ROHC_STATUS_OK)
 	{
-		pcap_dumper_t *dumper;
-
 		SNIFFER_LOG(LOG_WARNING, "compression failed");
 		ret = -1;
-		rohc_buf_push(&ip_packet, link_len_src);
-
-		/* open the new dumper */
-		dumper = pcap_dump_open(handle, "./dump_stream_default.pcap");
-		if(dumper == NULL)
-		{
-			SNIFFER_LOG(LOG_WARNING, "failed to open new dump file '%s'",
-			            "./dump_stream_default.pcap");
-			assert(0);
-			goto error;
-		}
 
-		/* dump the IP packet */
-		SNIFFER_LOG(LOG_INFO, "dump packet in file '%s'",
-		            "./dump_stream_default.pcap");
-		pcap_dump((u_char *) dumper, &header, packet);
-
-		SNIFFER_LOG(LOG_INFO, "close dump file");
-		pcap_dump_close(dumper);
+		/* dump the IP packet without CID */
+		SNIFFER_LOG(LOG_INFO, "dump packet in file '%s'", SNIFFER_DUMP_FILENAME);
+		sniffer_dump_packet(dump, &header, packet, "compression-failed");
 
 		goto error;
 	}
@@ -1366,47 +2768,20 @@ static int compress_decompress(struct rohc_comp *comp,
 		stats->comp_nr_reused_cid++;
 	}
 
-	/* open a new dumper if none exists or the stream changed */
+	/* dump the IP packet tagged with its CID, the first packet of a new
+	 * stream is also tagged so that the stream of one context may be
+	 * extracted from the dump file */
 	if(comp_last_packet_info.is_context_init)
 	{
-		char dump_filename[1024];
-
-		snprintf(dump_filename, 1024, "./dump_stream_cid_%u.pcap",
+		snprintf(dump_comment, sizeof(dump_comment), "cid=%u,new-context",
 		         comp_last_packet_info.context_id);
-		/* TODO: check result */
-
-		/* close the previous dumper and remove its file if one was opened */
-		if(dumpers[comp_last_packet_info.context_id] != NULL)
-		{
-			if(is_verbose)
-			{
-				SNIFFER_LOG(LOG_INFO, "replace dump file '%s' for context with "
-				            "ID %u", dump_filename,
-				            comp_last_packet_info.context_id);
-			}
-			pcap_dump_close(dumpers[comp_last_packet_info.context_id]);
-			unlink(dump_filename);
-			/* TODO: check result */
-		}
-
-		/* open the new dumper */
-		dumpers[comp_last_packet_info.context_id] =
-			pcap_dump_open(handle, dump_filename);
-		if(dumpers[comp_last_packet_info.context_id] == NULL)
-		{
-			SNIFFER_LOG(LOG_WARNING, "failed to open new dump file '%s' for "
-			            "context with ID %u", dump_filename,
-			            comp_last_packet_info.context_id);
-			assert(0);
-			goto error;
-		}
 	}
-
-	/* dump the IP packet */
-	rohc_buf_push(&ip_packet, link_len_src);
-	pcap_dump((u_char *) dumpers[comp_last_packet_info.context_id],
-	          &header, packet);
-	rohc_buf_pull(&ip_packet, link_len_src);
+	else
+	{
+		snprintf(dump_comment, sizeof(dump_comment), "cid=%u",
+		         comp_last_packet_info.context_id);
+	}
+	sniffer_dump_packet(dump, &header, packet, dump_comment);
 
 	/* record the CID */
 	*cid = comp_last_packet_info.context_id;
@@ -1730,6 +3105,9 @@ static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
 		}
 	}
 
+#if HAVE_PTHREAD_H == 1
+	pthread_mutex_lock(&last_traces_lock);
+#endif
 	if(last_traces_last == -1)
 	{
 		last_traces_last = 0;
@@ -1760,6 +3138,9 @@ static void print_rohc_traces(void *const priv_ctxt __attribute__((unused)),
 	{
 		last_traces_first = (last_traces_first + 1) % MAX_LAST_TRACES;
 	}
+#if HAVE_PTHREAD_H == 1
+	pthread_mutex_unlock(&last_traces_lock);
+#endif
 }
 
 
@@ -24,6 +24,12 @@
  *
  * The program takes a flow of IP packets as input (in the PCAP format) and
  * generate some ROHC compression statistics with them.
+ *
+ * In estimate mode, the program takes many flows of IP packets (or
+ * directories of flows) and only sums the sizes of their ROHC packets per
+ * profile and per packet type: the compressors run in estimate mode (no CRC,
+ * no copy of the payloads) and the flows are processed in parallel by several
+ * threads.
  */
 
 #include "config.h" /* for HAVE_*_H */
@@ -41,20 +47,19 @@
 #include <assert.h>
 #include <time.h> /* for time(2) */
 #include <stdarg.h>
+#if HAVE_PTHREAD_H == 1
+#  include <pthread.h>
+#endif
+#if HAVE_DIRENT_H == 1
+#  include <dirent.h>
+#endif
 
 /* includes for network headers */
 #include <protocols/ipv4.h>
 #include <protocols/ipv6.h>
 
-/* include for the PCAP library */
-#if HAVE_PCAP_PCAP_H == 1
-#  include <pcap/pcap.h>
-#elif HAVE_PCAP_H == 1
-#  include <pcap.h>
-#else
-#  error "pcap.h header not found, did you specified --enable-rohc-tests \
-for ./configure ? If yes, check configure output and config.log"
-#endif
+/* the PCAP captures are loaded in memory, without libpcap */
+#include "test_capture.h"
 
 /* ROHC includes */
 #include <rohc.h>
@@ -65,9 +70,6 @@ for ./configure ? If yes, check configure output and config.log"
 /** The maximal size for the ROHC packets */
 #define MAX_ROHC_SIZE  0xffffU
 
-/** The length of the Linux Cooked Sockets header */
-#define LINUX_COOKED_HDR_LEN  16U
-
 /** The length (in bytes) of the Ethernet header */
 #define ETHER_HDR_LEN  14U
 
@@ -79,16 +81,106 @@ for ./configure ? If yes, check configure output and config.log"
 static bool is_verbose = false;
 
 
+/** The estimated sizes of the ROHC packets of one bucket of a histogram */
+struct estimate_bucket
+{
+	unsigned long pkts_nr;                  /**< The number of packets */
+	unsigned long long uncomp_hdr_size;     /**< The uncompressed header bytes */
+	unsigned long long comp_hdr_size;       /**< The compressed header bytes */
+};
+
+/** The estimated sizes of the ROHC packets of one flow */
+struct estimate_stats
+{
+	unsigned long pkts_nr;                  /**< The number of packets */
+	unsigned long long uncomp_size;         /**< The uncompressed bytes */
+	unsigned long long uncomp_hdr_size;     /**< The uncompressed header bytes */
+	unsigned long long comp_size;           /**< The compressed bytes */
+	unsigned long long comp_hdr_size;       /**< The compressed header bytes */
+	/** The histogram of the packets per compression profile */
+	struct estimate_bucket profiles[ROHC_PROFILE_MAX];
+	/** The histogram of the packets per ROHC packet type */
+	struct estimate_bucket pkt_types[ROHC_PACKET_MAX];
+	int status;                             /**< 0 if the flow succeeded */
+};
+
+/** The list of the flows to estimate */
+struct estimate_flows
+{
+	char **names;                           /**< The names of the flows */
+	size_t nr;                              /**< The number of flows */
+	size_t max;                             /**< The room for flow names */
+};
+
+/** One thread of the estimate mode, with one compressor per flow */
+struct estimate_worker
+{
+	rohc_cid_type_t cid_type;               /**< The type of CIDs */
+	unsigned int max_contexts;              /**< The maximum number of contexts */
+	const char *const *filenames;           /**< The names of all the flows */
+	struct estimate_stats *stats;           /**< The statistics of all the flows */
+	size_t flows_nr;                        /**< The number of flows */
+	size_t first_flow;                      /**< The first flow of the thread */
+	size_t flows_step;                      /**< The step between its flows */
+#if HAVE_PTHREAD_H == 1
+	pthread_t thread;                       /**< The thread running the worker */
+#endif
+};
+
+
 /* prototypes of private functions */
 static void usage(void);
+static struct rohc_comp * create_compressor(const rohc_cid_type_t cid_type,
+                                            const unsigned int max_contexts,
+                                            const rohc_comp_features_t features)
+	__attribute__((warn_unused_result));
+static int open_capture(const char *const filename,
+                        struct test_capture *const capture)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool get_ip_packet(const unsigned long num_packet,
+                          const struct test_capture_pkt *const pkt,
+                          const size_t link_len,
+                          struct rohc_buf *const ip_packet)
+	__attribute__((warn_unused_result, nonnull(2, 4)));
 static int generate_comp_stats_all(const rohc_cid_type_t cid_type,
                                    const unsigned int max_contexts,
                                    const char *filename);
 static int generate_comp_stats_one(struct rohc_comp *comp,
                                    const unsigned long num_packet,
-                                   const struct pcap_pkthdr header,
-                                   const unsigned char *packet,
-                                   const int link_len);
+                                   const struct test_capture_pkt *const pkt,
+                                   const size_t link_len);
+static int generate_comp_estimates(const rohc_cid_type_t cid_type,
+                                   const unsigned int max_contexts,
+                                   const char *const *const paths,
+                                   const size_t paths_nr,
+                                   const size_t jobs_nr)
+	__attribute__((warn_unused_result, nonnull(3)));
+static int collect_flows(const char *const path,
+                         struct estimate_flows *const flows)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static int add_flow(struct estimate_flows *const flows,
+                    const char *const dirname,
+                    const char *const filename)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static int compare_flows(const void *const flow1, const void *const flow2)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void * run_estimate_worker(void *const arg)
+	__attribute__((nonnull(1)));
+static int estimate_flow(const rohc_cid_type_t cid_type,
+                         const unsigned int max_contexts,
+                         const char *const filename,
+                         struct estimate_stats *const stats)
+	__attribute__((warn_unused_result, nonnull(3, 4)));
+static void add_estimate(struct estimate_bucket *const bucket,
+                         const size_t uncomp_hdr_size,
+                         const size_t comp_hdr_size)
+	__attribute__((nonnull(1)));
+static void merge_estimate(struct estimate_stats *const total,
+                           const struct estimate_stats *const stats)
+	__attribute__((nonnull(1, 2)));
+static void print_estimate(const char *const name,
+                           const struct estimate_stats *const stats)
+	__attribute__((nonnull(1, 2)));
 static void print_rohc_traces(void *const priv_ctxt,
                               const rohc_trace_level_t level,
                               const rohc_trace_entity_t entity,
@@ -120,7 +212,10 @@ static bool rohc_comp_rtp_cb(const unsigned char *const ip,
 int main(int argc, char *argv[])
 {
 	char *cid_type_name = NULL;
-	char *source_filename = NULL;
+	const char **source_filenames;
+	size_t source_filenames_nr = 0;
+	bool is_estimate = false;
+	int jobs_nr = 1;
 	int status = 1;
 	int max_contexts = ROHC_SMALL_CID_MAX + 1;
 	size_t max_possible_contexts = ROHC_SMALL_CID_MAX + 1;
@@ -134,6 +229,14 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* there are fewer flows than arguments */
+	source_filenames = calloc(argc, sizeof(const char *));
+	if(source_filenames == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the flow names\n");
+		goto error;
+	}
+
 	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
 	{
 		args_used = 1;
@@ -142,13 +245,13 @@ int main(int argc, char *argv[])
 		{
 			/* print help */
 			usage();
-			goto error;
+			goto free_filenames;
 		}
 		else if(!strcmp(*argv, "-v") || !strcmp(*argv, "--version"))
 		{
 			/* print version */
 			printf("rohc_stats version %s\n", rohc_version());
-			goto error;
+			goto free_filenames;
 		}
 		else if(!strcmp(*argv, "--verbose"))
 		{
@@ -158,9 +261,32 @@ int main(int argc, char *argv[])
 		else if(!strcmp(*argv, "--max-contexts"))
 		{
 			/* get the maximum number of contexts the test should use */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --max-contexts takes one argument\n\n");
+				usage();
+				goto free_filenames;
+			}
 			max_contexts = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--estimate"))
+		{
+			/* only estimate the sizes of the ROHC packets */
+			is_estimate = true;
+		}
+		else if(!strcmp(*argv, "--jobs"))
+		{
+			/* get the number of flows to estimate in parallel */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --jobs takes one argument\n\n");
+				usage();
+				goto free_filenames;
+			}
+			jobs_nr = atoi(argv[1]);
+			args_used++;
+		}
 		else if(cid_type_name == NULL)
 		{
 			/* get the type of CID to use within the ROHC library */
@@ -181,19 +307,14 @@ int main(int argc, char *argv[])
 				fprintf(stderr, "invalid CID type '%s', only 'smallcid' and "
 				        "'largecid' expected\n", cid_type_name);
 				usage();
-				goto error;
+				goto free_filenames;
 			}
 		}
-		else if(source_filename == NULL)
-		{
-			/* get the name of the file that contains the packets to compress */
-			source_filename = argv[0];
-		}
 		else
 		{
-			/* do not accept more than one filename without option name */
-			usage();
-			goto error;
+			/* get the name of one file that contains the packets to compress */
+			source_filenames[source_filenames_nr] = argv[0];
+			source_filenames_nr++;
 		}
 	}
 
@@ -202,7 +323,7 @@ int main(int argc, char *argv[])
 	{
 		fprintf(stderr, "parameter CID_TYPE is mandatory\n");
 		usage();
-		goto error;
+		goto free_filenames;
 	}
 
 	/* the maximum number of ROHC contexts should be valid wrt CID type */
@@ -211,20 +332,50 @@ int main(int argc, char *argv[])
 		fprintf(stderr, "the maximum number of ROHC contexts should be "
 		        "between 1 and %zu\n\n", max_possible_contexts);
 		usage();
-		goto error;
+		goto free_filenames;
 	}
 
 	/* the source filename is mandatory */
-	if(source_filename == NULL)
+	if(source_filenames_nr == 0)
 	{
 		fprintf(stderr, "source filename is mandatory\n");
 		usage();
-		goto error;
+		goto free_filenames;
 	}
 
-	/* generate ROHC compression statistics with the packets from the file */
-	status = generate_comp_stats_all(cid_type, max_contexts, source_filename);
+	if(is_estimate)
+	{
+		/* the number of jobs should be valid */
+		if(jobs_nr < 1)
+		{
+			fprintf(stderr, "the number of jobs should be at least 1\n\n");
+			usage();
+			goto free_filenames;
+		}
+
+		/* estimate the sizes of the ROHC packets of all the files */
+		status = generate_comp_estimates(cid_type, max_contexts,
+		                                 source_filenames, source_filenames_nr,
+		                                 jobs_nr);
+	}
+	else
+	{
+		/* do not accept more than one filename without estimate mode */
+		if(source_filenames_nr > 1)
+		{
+			fprintf(stderr, "only one source filename is accepted without "
+			        "option --estimate\n\n");
+			usage();
+			goto free_filenames;
+		}
 
+		/* generate ROHC compression statistics with the packets from the file */
+		status = generate_comp_stats_all(cid_type, max_contexts,
+		                                 source_filenames[0]);
+	}
+
+free_filenames:
+	free(source_filenames);
 error:
 	return status;
 }
@@ -252,10 +403,35 @@ static void usage(void)
 	       "  * compressed packet size (bytes)\n\n"
 	       "  * compressed header size (bytes)\n\n"
 	       "\n"
+	       "In estimate mode, the compressor only sizes the ROHC packets\n"
+	       "(no CRC, no copy of the payloads, the ROHC packets cannot be\n"
+	       "decompressed) and the rohc_stats tool outputs one line per flow\n"
+	       "and one line for all the flows with the following tab-separated\n"
+	       "fields:\n\n"
+	       "  * keyword 'ESTIMATE'\n\n"
+	       "  * flow name, or 'total' for all the flows\n\n"
+	       "  * number of packets\n\n"
+	       "  * uncompressed packets size (bytes)\n\n"
+	       "  * uncompressed headers size (bytes)\n\n"
+	       "  * compressed packets size (bytes)\n\n"
+	       "  * compressed headers size (bytes)\n\n"
+	       "\n"
+	       "In estimate mode, the histograms of every flow and of all the\n"
+	       "flows per profile and per packet type are also output with the\n"
+	       "following tab-separated fields:\n\n"
+	       "  * keyword 'PROFILE' or 'PACKET_TYPE'\n\n"
+	       "  * flow name, or 'total' for all the flows\n\n"
+	       "  * profile or packet type (numeric ID)\n\n"
+	       "  * profile or packet type (string)\n\n"
+	       "  * number of packets\n\n"
+	       "  * uncompressed headers size (bytes)\n\n"
+	       "  * compressed headers size (bytes)\n\n"
+	       "\n"
 	       "The shell script rohc_stats.sh could be used to generate a HTML\n"
 	       "report.\n"
 	       "\n"
 	       "Usage: rohc_stats [OPTIONS] CID_TYPE FLOW\n"
+	       "       rohc_stats --estimate [OPTIONS] CID_TYPE FLOW...\n"
 	       "\n"
 	       "Options:\n"
 	       "  -v, --version           Print version information and exit\n"
@@ -263,90 +439,50 @@ static void usage(void)
 	       "      --verbose           Be more verbose\n"
 	       "      --max-contexts NUM  The maximum number of ROHC contexts to\n"
 	       "                          simultaneously use during the test\n"
+	       "      --estimate          Only estimate the sizes of the ROHC\n"
+	       "                          packets of one or more flows\n"
+	       "      --jobs NUM          The number of flows to estimate in\n"
+	       "                          parallel (default: 1)\n"
 	       "\n"
 	       "With:\n"
 	       "  CID_TYPE                The type of CID to use among 'smallcid'\n"
 	       "                          and 'largecid'\n"
 	       "  FLOW                    The flow of Ethernet frames to compress\n"
-	       "                          (in PCAP format)\n"
+	       "                          (in PCAP format), or in estimate mode a\n"
+	       "                          directory of such flows\n"
 	       "\n"
 	       "Examples:\n"
 	       "  rohc_stats smallcid /tmp/rtp.pcap   Generate statistics\n"
 	       "  rohc_stats largecid ~/lan.pcap      Generate statistics\n"
+	       "  rohc_stats --estimate --jobs 8 largecid ~/day*.pcap\n"
+	       "                                      Estimate the header savings\n"
+	       "  rohc_stats --estimate --jobs 8 largecid ~/captures/\n"
+	       "                                      Estimate the header savings\n"
 	       "\n"
 	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n");
 }
 
 
 /**
- * @brief Generate ROHC compression statistics with a flow of IP packets
+ * @brief Create one ROHC compressor with all the profiles enabled
  *
- * @param cid_type       The type of CIDs the compressor shall use
- * @param max_contexts   The maximum number of ROHC contexts to use
- * @param filename       The name of the PCAP file that contains the IP packets
- * @return               0 in case of success,
- *                       1 in case of failure
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param features      The features to enable in the compressor
+ * @return              The compressor if successful, NULL otherwise
  */
-static int generate_comp_stats_all(const rohc_cid_type_t cid_type,
-                                   const unsigned int max_contexts,
-                                   const char *filename)
+static struct rohc_comp * create_compressor(const rohc_cid_type_t cid_type,
+                                            const unsigned int max_contexts,
+                                            const rohc_comp_features_t features)
 {
-	char errbuf[PCAP_ERRBUF_SIZE];
-	pcap_t *handle;
-	int link_layer_type;
-	int link_len;
-
 	struct rohc_comp *comp;
 
-	unsigned long num_packet;
-	struct pcap_pkthdr header;
-	unsigned char *packet;
-
-	int is_failure = 1;
-
-	/* open the source PCAP file */
-	handle = pcap_open_offline(filename, errbuf);
-	if(handle == NULL)
-	{
-		fprintf(stderr, "failed to open the source pcap file: %s\n", errbuf);
-		goto error;
-	}
-
-	/* link layer in the source PCAP file must be Ethernet */
-	link_layer_type = pcap_datalink(handle);
-	if(link_layer_type != DLT_EN10MB &&
-	   link_layer_type != DLT_LINUX_SLL &&
-	   link_layer_type != DLT_RAW)
-	{
-		fprintf(stderr, "link layer type %d not supported in source PCAP file "
-		        "(supported = %d, %d, %d)\n", link_layer_type, DLT_EN10MB,
-		        DLT_LINUX_SLL, DLT_RAW);
-		goto close_input;
-	}
-
-	/* determine the size of the link layer header */
-	if(link_layer_type == DLT_EN10MB)
-	{
-		link_len = ETHER_HDR_LEN;
-	}
-	else if(link_layer_type == DLT_LINUX_SLL)
-	{
-		link_len = LINUX_COOKED_HDR_LEN;
-	}
-	else /* DLT_RAW */
-	{
-		link_len = 0;
-	}
-
-	/* initialize the random generator */
-	srand(time(NULL));
-
 	/* create the ROHC compressor */
 	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_random_num, NULL);
 	if(comp == NULL)
 	{
 		fprintf(stderr, "cannot create the ROHC compressor\n");
-		goto close_input;
+		goto error;
 	}
 
 	/* set the callback for traces on compressor */
@@ -357,6 +493,13 @@ static int generate_comp_stats_all(const rohc_cid_type_t cid_type,
 		goto destroy_comp;
 	}
 
+	/* enable features */
+	if(!rohc_comp_set_features(comp, features))
+	{
+		fprintf(stderr, "failed to enable the compression features\n");
+		goto destroy_comp;
+	}
+
 	/* enable profiles */
 	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
 	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
@@ -370,9 +513,164 @@ static int generate_comp_stats_all(const rohc_cid_type_t cid_type,
 	/* set UDP ports dedicated to RTP traffic */
 	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
 	{
+		fprintf(stderr, "failed to set the RTP detection callback\n");
 		goto destroy_comp;
 	}
 
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Load one PCAP file in memory
+ *
+ * @param filename      The name of the PCAP file
+ * @param[out] capture  The loaded capture
+ * @return              0 in case of success,
+ *                      1 in case of failure
+ */
+static int open_capture(const char *const filename,
+                        struct test_capture *const capture)
+{
+	char errbuf[TEST_CAPTURE_ERRBUF_SIZE];
+
+	/* load the source PCAP file in memory */
+	if(!test_capture_load(capture, filename, errbuf))
+	{
+		fprintf(stderr, "failed to open the source pcap file: %s\n", errbuf);
+		goto error;
+	}
+
+	/* link layer in the source PCAP file must be Ethernet, Linux Cooked
+	 * Sockets or raw IP */
+	if(capture->link_type != TEST_CAPTURE_LINK_ETHER &&
+	   capture->link_type != TEST_CAPTURE_LINK_LINUX_SLL &&
+	   capture->link_type != TEST_CAPTURE_LINK_RAW)
+	{
+		fprintf(stderr, "link layer type %u not supported in source PCAP file "
+		        "(supported = Ethernet, Linux Cooked Sockets, raw IP)\n",
+		        capture->link_type_pcap);
+		goto close_input;
+	}
+
+	return 0;
+
+close_input:
+	test_capture_unload(capture);
+error:
+	return 1;
+}
+
+
+/**
+ * @brief Get the IP packet of one captured frame
+ *
+ * Skip the link layer header and the Ethernet padding after the IP packet.
+ *
+ * @param num_packet     A number affected to the captured frame
+ * @param pkt            The captured frame (link layer included)
+ * @param link_len       The length of the link layer header before IP data
+ * @param[out] ip_packet The IP packet
+ * @return               true if the frame contains one IP packet,
+ *                       false if the frame is malformed
+ */
+static bool get_ip_packet(const unsigned long num_packet,
+                          const struct test_capture_pkt *const pkt,
+                          const size_t link_len,
+                          struct rohc_buf *const ip_packet)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	const struct rohc_buf frame =
+		rohc_buf_init_full(pkt->data, pkt->caplen, arrival_time);
+
+	/* check frame length */
+	if(pkt->len <= link_len || pkt->len != pkt->caplen)
+	{
+		fprintf(stderr, "packet #%lu: bad PCAP packet (len = %u, caplen = %u)\n",
+		        num_packet, pkt->len, pkt->caplen);
+		goto error;
+	}
+
+	/* skip the link layer header */
+	*ip_packet = frame;
+	rohc_buf_pull(ip_packet, link_len);
+
+	/* check for padding after the IP packet in the Ethernet payload */
+	if(link_len == ETHER_HDR_LEN && pkt->len == ETHER_FRAME_MIN_LEN)
+	{
+		uint8_t version;
+		uint16_t tot_len;
+
+		version = (rohc_buf_byte(*ip_packet) >> 4) & 0x0f;
+		if(version == 4)
+		{
+			const struct ipv4_hdr *const ip =
+				(struct ipv4_hdr *) rohc_buf_data(*ip_packet);
+			tot_len = ntohs(ip->tot_len);
+		}
+		else
+		{
+			const struct ipv6_hdr *const ip =
+				(struct ipv6_hdr *) rohc_buf_data(*ip_packet);
+			tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
+		}
+
+		if(tot_len < ip_packet->len)
+		{
+			/* the Ethernet frame has some bytes of padding after the IP packet */
+			ip_packet->len = tot_len;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Generate ROHC compression statistics with a flow of IP packets
+ *
+ * @param cid_type       The type of CIDs the compressor shall use
+ * @param max_contexts   The maximum number of ROHC contexts to use
+ * @param filename       The name of the PCAP file that contains the IP packets
+ * @return               0 in case of success,
+ *                       1 in case of failure
+ */
+static int generate_comp_stats_all(const rohc_cid_type_t cid_type,
+                                   const unsigned int max_contexts,
+                                   const char *filename)
+{
+	struct test_capture capture;
+
+	struct rohc_comp *comp;
+
+	unsigned long num_packet;
+
+	int is_failure = 1;
+
+	/* load the source PCAP file in memory */
+	if(open_capture(filename, &capture) != 0)
+	{
+		goto error;
+	}
+
+	/* initialize the random generator */
+	srand(time(NULL));
+
+	/* create the ROHC compressor */
+	comp = create_compressor(cid_type, max_contexts, ROHC_COMP_FEATURE_NONE);
+	if(comp == NULL)
+	{
+		goto close_input;
+	}
+
 	/* output the statistics columns names */
 	printf("STAT\t"
 	       "\"packet number\"\t"
@@ -389,15 +687,14 @@ static int generate_comp_stats_all(const rohc_cid_type_t cid_type,
 	fflush(stdout);
 
 	/* for each packet extracted from the PCAP file */
-	num_packet = 0;
-	while((packet = (unsigned char *) pcap_next(handle, &header)) != NULL)
+	for(num_packet = 1; num_packet <= capture.pkts_nr; num_packet++)
 	{
 		int ret;
 
-		num_packet++;
-
 		/* compress the packet and generate statistics */
-		ret = generate_comp_stats_one(comp, num_packet, header, packet, link_len);
+		ret = generate_comp_stats_one(comp, num_packet,
+		                              &(capture.pkts[num_packet - 1]),
+		                              capture.link_len);
 		if(ret != 0)
 		{
 			fprintf(stderr, "packet %lu: failed to compress or generate stats "
@@ -412,7 +709,7 @@ static int generate_comp_stats_all(const rohc_cid_type_t cid_type,
 destroy_comp:
 	rohc_comp_free(comp);
 close_input:
-	pcap_close(handle);
+	test_capture_unload(&capture);
 error:
 	return is_failure;
 }
@@ -424,65 +721,29 @@ error:
  *
  * @param comp        The compressor to use to compress the IP packet
  * @param num_packet  A number affected to the IP packet to compress
- * @param header      The PCAP header for the packet
- * @param packet      The packet to compress (link layer included)
+ * @param pkt         The packet to compress (link layer included)
  * @param link_len    The length of the link layer header before IP data
  * @return            0 in case of success,
  *                    1 in case of failure
  */
 static int generate_comp_stats_one(struct rohc_comp *comp,
                                    const unsigned long num_packet,
-                                   const struct pcap_pkthdr header,
-                                   const unsigned char *packet,
-                                   const int link_len)
+                                   const struct test_capture_pkt *const pkt,
+                                   const size_t link_len)
 {
-	struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
-	struct rohc_buf ip_packet =
-		rohc_buf_init_full((unsigned char *) packet, header.caplen, arrival_time);
+	struct rohc_buf ip_packet;
 	uint8_t rohc_buffer[MAX_ROHC_SIZE];
 	struct rohc_buf rohc_packet =
 		rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
 	rohc_comp_last_packet_info2_t last_packet_info;
 	rohc_status_t status;
 
-	/* check frame length */
-	if(header.len <= link_len || header.len != header.caplen)
+	/* skip the link layer header and the Ethernet padding */
+	if(!get_ip_packet(num_packet, pkt, link_len, &ip_packet))
 	{
-		fprintf(stderr, "packet #%lu: bad PCAP packet (len = %u, caplen = %u)\n",
-		        num_packet, header.len, header.caplen);
 		goto error;
 	}
 
-	/* skip the link layer header */
-	rohc_buf_pull(&ip_packet, link_len);
-
-	/* check for padding after the IP packet in the Ethernet payload */
-	if(link_len == ETHER_HDR_LEN && header.len == ETHER_FRAME_MIN_LEN)
-	{
-		uint8_t version;
-		uint16_t tot_len;
-
-		version = (rohc_buf_byte(ip_packet) >> 4) & 0x0f;
-		if(version == 4)
-		{
-			const struct ipv4_hdr *const ip =
-				(struct ipv4_hdr *) rohc_buf_data(ip_packet);
-			tot_len = ntohs(ip->tot_len);
-		}
-		else
-		{
-			const struct ipv6_hdr *const ip =
-				(struct ipv6_hdr *) rohc_buf_data(ip_packet);
-			tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
-		}
-
-		if(tot_len < ip_packet.len)
-		{
-			/* the Ethernet frame has some bytes of padding after the IP packet */
-			ip_packet.len = tot_len;
-		}
-	}
-
 	/* compress the IP packet */
 	status = rohc_compress4(comp, ip_packet, &rohc_packet);
 	if(status != ROHC_STATUS_OK)
@@ -523,6 +784,524 @@ error:
 }
 
 
+/**
+ * @brief Estimate the sizes of the ROHC packets of many flows of IP packets
+ *
+ * Every flow is compressed by its own compressor in estimate mode, the flows
+ * are shared between \e jobs_nr threads. Every path is either one PCAP file
+ * or one directory whose PCAP files are all estimated.
+ *
+ * @param cid_type      The type of CIDs the compressors shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param paths         The names of the PCAP files or of the directories
+ *                      that contain the flows
+ * @param paths_nr      The number of paths
+ * @param jobs_nr       The number of flows to estimate in parallel
+ * @return              0 in case of success,
+ *                      1 in case of failure
+ */
+static int generate_comp_estimates(const rohc_cid_type_t cid_type,
+                                   const unsigned int max_contexts,
+                                   const char *const *const paths,
+                                   const size_t paths_nr,
+                                   const size_t jobs_nr)
+{
+	struct estimate_flows flows = { .names = NULL, .nr = 0, .max = 0 };
+	const char *const *filenames;
+	struct estimate_worker *workers;
+	struct estimate_stats *stats;
+	struct estimate_stats total;
+	size_t workers_nr;
+	size_t flows_nr;
+	size_t i;
+	int is_failure = 1;
+
+	assert(paths_nr > 0);
+	assert(jobs_nr > 0);
+
+	/* list the flows of all the files and directories */
+	for(i = 0; i < paths_nr; i++)
+	{
+		if(collect_flows(paths[i], &flows) != 0)
+		{
+			goto free_flows;
+		}
+	}
+	if(flows.nr == 0)
+	{
+		fprintf(stderr, "no PCAP file to estimate\n");
+		goto free_flows;
+	}
+	filenames = (const char *const *) flows.names;
+	flows_nr = flows.nr;
+	workers_nr = (jobs_nr < flows_nr ? jobs_nr : flows_nr);
+
+#if HAVE_PTHREAD_H != 1
+	if(workers_nr > 1)
+	{
+		fprintf(stderr, "parallel estimates are not supported on this "
+		        "platform\n");
+		goto free_flows;
+	}
+#endif
+
+	workers = calloc(workers_nr, sizeof(struct estimate_worker));
+	if(workers == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for %zu jobs\n", workers_nr);
+		goto free_flows;
+	}
+	stats = calloc(flows_nr, sizeof(struct estimate_stats));
+	if(stats == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for statistics\n");
+		goto free_workers;
+	}
+
+	/* initialize the random generator */
+	srand(time(NULL));
+
+	/* every worker estimates one flow out of workers_nr */
+	for(i = 0; i < flows_nr; i++)
+	{
+		stats[i].status = 1;
+	}
+	for(i = 0; i < workers_nr; i++)
+	{
+		workers[i].cid_type = cid_type;
+		workers[i].max_contexts = max_contexts;
+		workers[i].filenames = filenames;
+		workers[i].stats = stats;
+		workers[i].flows_nr = flows_nr;
+		workers[i].first_flow = i;
+		workers[i].flows_step = workers_nr;
+	}
+
+	/* run all the threads */
+#if HAVE_PTHREAD_H == 1
+	for(i = 0; i < workers_nr; i++)
+	{
+		const int ret =
+			pthread_create(&workers[i].thread, NULL, run_estimate_worker,
+			               &workers[i]);
+		if(ret != 0)
+		{
+			fprintf(stderr, "failed to create thread #%zu: %s (%d)\n", i + 1,
+			        strerror(ret), ret);
+			break;
+		}
+	}
+	while(i > 0)
+	{
+		i--;
+		pthread_join(workers[i].thread, NULL);
+	}
+#else
+	run_estimate_worker(&workers[0]);
+#endif
+
+	/* output the estimates of every flow, then of all the flows */
+	printf("ESTIMATE\t"
+	       "\"flow\"\t"
+	       "\"packets\"\t"
+	       "\"uncompressed packets size (bytes)\"\t"
+	       "\"uncompressed headers size (bytes)\"\t"
+	       "\"compressed packets size (bytes)\"\t"
+	       "\"compressed headers size (bytes)\"\n");
+	printf("PROFILE\t"
+	       "\"flow\"\t"
+	       "\"profile\"\t"
+	       "\"profile (string)\"\t"
+	       "\"packets\"\t"
+	       "\"uncompressed headers size (bytes)\"\t"
+	       "\"compressed headers size (bytes)\"\n");
+	printf("PACKET_TYPE\t"
+	       "\"flow\"\t"
+	       "\"packet type\"\t"
+	       "\"packet type (string)\"\t"
+	       "\"packets\"\t"
+	       "\"uncompressed headers size (bytes)\"\t"
+	       "\"compressed headers size (bytes)\"\n");
+	memset(&total, 0, sizeof(struct estimate_stats));
+	for(i = 0; i < flows_nr; i++)
+	{
+		if(stats[i].status != 0)
+		{
+			fprintf(stderr, "failed to estimate flow '%s'\n", filenames[i]);
+			goto free_stats;
+		}
+		print_estimate(filenames[i], &stats[i]);
+		merge_estimate(&total, &stats[i]);
+	}
+	print_estimate("total", &total);
+	fflush(stdout);
+
+	/* everything went fine */
+	is_failure = 0;
+
+free_stats:
+	free(stats);
+free_workers:
+	free(workers);
+free_flows:
+	for(i = 0; i < flows.nr; i++)
+	{
+		free(flows.names[i]);
+	}
+	free(flows.names);
+	return is_failure;
+}
+
+
+/**
+ * @brief List the flows of one PCAP file or of one directory
+ *
+ * The flows of one directory are all its files with the .pcap extension,
+ * sorted by name. The sub-directories are ignored.
+ *
+ * @param path   The name of the PCAP file or of the directory
+ * @param flows  The list of flows to complete
+ * @return       0 in case of success,
+ *               1 in case of failure
+ */
+static int collect_flows(const char *const path,
+                         struct estimate_flows *const flows)
+{
+#if HAVE_DIRENT_H == 1
+	const size_t ext_len = strlen(".pcap");
+	const size_t first_flow = flows->nr;
+	const struct dirent *entry;
+	DIR *dir;
+
+	/* the path is one PCAP file if it is not a directory */
+	dir = opendir(path);
+	if(dir == NULL)
+	{
+		return add_flow(flows, NULL, path);
+	}
+
+	while((entry = readdir(dir)) != NULL)
+	{
+		const size_t name_len = strlen(entry->d_name);
+
+		if(name_len > ext_len &&
+		   strcmp(entry->d_name + name_len - ext_len, ".pcap") == 0 &&
+		   add_flow(flows, path, entry->d_name) != 0)
+		{
+			closedir(dir);
+			goto error;
+		}
+	}
+	closedir(dir);
+
+	/* the flows of the directory are estimated in the order of their names */
+	qsort(flows->names + first_flow, flows->nr - first_flow, sizeof(char *),
+	      compare_flows);
+
+	return 0;
+
+error:
+	return 1;
+#else
+	return add_flow(flows, NULL, path);
+#endif
+}
+
+
+/**
+ * @brief Add one flow to the list of flows to estimate
+ *
+ * @param flows     The list of flows to complete
+ * @param dirname   The directory of the PCAP file, NULL if \e filename is
+ *                  the full path of the PCAP file
+ * @param filename  The name of the PCAP file
+ * @return          0 in case of success,
+ *                  1 in case of failure
+ */
+static int add_flow(struct estimate_flows *const flows,
+                    const char *const dirname,
+                    const char *const filename)
+{
+	size_t name_len;
+	char *name;
+
+	/* make room for one more flow */
+	if(flows->nr >= flows->max)
+	{
+		const size_t new_max = (flows->max == 0 ? 64 : flows->max * 2);
+		char **const new_names = realloc(flows->names, new_max * sizeof(char *));
+		if(new_names == NULL)
+		{
+			fprintf(stderr, "failed to allocate memory for %zu flows\n", new_max);
+			goto error;
+		}
+		flows->names = new_names;
+		flows->max = new_max;
+	}
+
+	/* build the full path of the PCAP file */
+	name_len = strlen(filename) + 1;
+	if(dirname != NULL)
+	{
+		name_len += strlen(dirname) + 1;
+	}
+	name = malloc(name_len);
+	if(name == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for flow '%s'\n", filename);
+		goto error;
+	}
+	if(dirname != NULL)
+	{
+		snprintf(name, name_len, "%s/%s", dirname, filename);
+	}
+	else
+	{
+		snprintf(name, name_len, "%s", filename);
+	}
+
+	flows->names[flows->nr] = name;
+	flows->nr++;
+
+	return 0;
+
+error:
+	return 1;
+}
+
+
+/**
+ * @brief Compare the names of two flows for qsort()
+ *
+ * @param flow1  The name of the first flow
+ * @param flow2  The name of the second flow
+ * @return       The result of strcmp() on the two names
+ */
+static int compare_flows(const void *const flow1, const void *const flow2)
+{
+	return strcmp(*((const char *const *) flow1),
+	              *((const char *const *) flow2));
+}
+
+
+/**
+ * @brief Estimate the flows of one thread
+ *
+ * @param arg  The worker of the thread
+ * @return     Always NULL
+ */
+static void * run_estimate_worker(void *const arg)
+{
+	struct estimate_worker *const worker = (struct estimate_worker *) arg;
+	size_t i;
+
+	for(i = worker->first_flow; i < worker->flows_nr; i += worker->flows_step)
+	{
+		worker->stats[i].status =
+			estimate_flow(worker->cid_type, worker->max_contexts,
+			              worker->filenames[i], &worker->stats[i]);
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Estimate the sizes of the ROHC packets of one flow of IP packets
+ *
+ * Only the ROHC headers are built, the payloads are not copied: the sizes
+ * of the ROHC packets are computed from the offsets of the payloads.
+ *
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param filename      The name of the PCAP file that contains the flow
+ * @param[out] stats    The estimated sizes of the flow
+ * @return              0 in case of success,
+ *                      1 in case of failure
+ */
+static int estimate_flow(const rohc_cid_type_t cid_type,
+                         const unsigned int max_contexts,
+                         const char *const filename,
+                         struct estimate_stats *const stats)
+{
+	rohc_comp_last_packet_info2_t last_packet_info;
+	struct test_capture capture;
+	struct rohc_comp *comp;
+	unsigned long num_packet;
+	int is_failure = 1;
+
+	/* load the source PCAP file in memory */
+	if(open_capture(filename, &capture) != 0)
+	{
+		goto error;
+	}
+
+	/* create the ROHC compressor that only sizes the ROHC packets */
+	comp = create_compressor(cid_type, max_contexts, ROHC_COMP_FEATURE_ESTIMATE);
+	if(comp == NULL)
+	{
+		goto close_input;
+	}
+
+	/* for each packet extracted from the PCAP file */
+	for(num_packet = 1; num_packet <= capture.pkts_nr; num_packet++)
+	{
+		uint8_t rohc_buffer[MAX_ROHC_SIZE];
+		struct rohc_buf rohc_hdr =
+			rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+		struct rohc_buf ip_packet;
+		size_t payload_offset;
+		rohc_status_t status;
+
+		/* skip the link layer header and the Ethernet padding */
+		if(!get_ip_packet(num_packet, &(capture.pkts[num_packet - 1]),
+		                  capture.link_len, &ip_packet))
+		{
+			goto destroy_comp;
+		}
+
+		/* compress the headers of the IP packet only */
+		status = rohc_compress_hdr(comp, ip_packet, &rohc_hdr, &payload_offset);
+		if(status != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "%s: packet #%lu: compression failed\n", filename,
+			        num_packet);
+			goto destroy_comp;
+		}
+
+		/* get the profile and the packet type of the ROHC packet */
+		last_packet_info.version_major = 0;
+		last_packet_info.version_minor = 0;
+		if(!rohc_comp_get_last_packet_info2(comp, &last_packet_info))
+		{
+			fprintf(stderr, "%s: packet #%lu: cannot get stats about the last "
+			        "compressed packet\n", filename, num_packet);
+			goto destroy_comp;
+		}
+		if(last_packet_info.profile_id < 0 ||
+		   last_packet_info.profile_id >= ROHC_PROFILE_MAX ||
+		   last_packet_info.packet_type < 0 ||
+		   last_packet_info.packet_type >= ROHC_PACKET_MAX)
+		{
+			fprintf(stderr, "%s: packet #%lu: unexpected profile %d or packet "
+			        "type %d\n", filename, num_packet,
+			        last_packet_info.profile_id, last_packet_info.packet_type);
+			goto destroy_comp;
+		}
+
+		stats->pkts_nr++;
+		stats->uncomp_size += ip_packet.len;
+		stats->uncomp_hdr_size += payload_offset;
+		stats->comp_size += rohc_hdr.len + ip_packet.len - payload_offset;
+		stats->comp_hdr_size += rohc_hdr.len;
+		add_estimate(&stats->profiles[last_packet_info.profile_id],
+		             payload_offset, rohc_hdr.len);
+		add_estimate(&stats->pkt_types[last_packet_info.packet_type],
+		             payload_offset, rohc_hdr.len);
+	}
+
+	/* everything went fine */
+	is_failure = 0;
+
+destroy_comp:
+	rohc_comp_free(comp);
+close_input:
+	test_capture_unload(&capture);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Account for one ROHC packet in one bucket of a histogram
+ *
+ * @param bucket           The bucket of the histogram
+ * @param uncomp_hdr_size  The size of the uncompressed headers (bytes)
+ * @param comp_hdr_size    The size of the ROHC header (bytes)
+ */
+static void add_estimate(struct estimate_bucket *const bucket,
+                         const size_t uncomp_hdr_size,
+                         const size_t comp_hdr_size)
+{
+	bucket->pkts_nr++;
+	bucket->uncomp_hdr_size += uncomp_hdr_size;
+	bucket->comp_hdr_size += comp_hdr_size;
+}
+
+
+/**
+ * @brief Add the estimated sizes of one flow to the ones of all the flows
+ *
+ * @param total  The estimated sizes of all the flows
+ * @param stats  The estimated sizes of one flow
+ */
+static void merge_estimate(struct estimate_stats *const total,
+                           const struct estimate_stats *const stats)
+{
+	size_t i;
+
+	total->pkts_nr += stats->pkts_nr;
+	total->uncomp_size += stats->uncomp_size;
+	total->uncomp_hdr_size += stats->uncomp_hdr_size;
+	total->comp_size += stats->comp_size;
+	total->comp_hdr_size += stats->comp_hdr_size;
+
+	for(i = 0; i < ROHC_PROFILE_MAX; i++)
+	{
+		total->profiles[i].pkts_nr += stats->profiles[i].pkts_nr;
+		total->profiles[i].uncomp_hdr_size += stats->profiles[i].uncomp_hdr_size;
+		total->profiles[i].comp_hdr_size += stats->profiles[i].comp_hdr_size;
+	}
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		total->pkt_types[i].pkts_nr += stats->pkt_types[i].pkts_nr;
+		total->pkt_types[i].uncomp_hdr_size += stats->pkt_types[i].uncomp_hdr_size;
+		total->pkt_types[i].comp_hdr_size += stats->pkt_types[i].comp_hdr_size;
+	}
+}
+
+
+/**
+ * @brief Output the estimated sizes of one flow or of all the flows
+ *
+ * One ESTIMATE line is output, then one PROFILE line per profile and one
+ * PACKET_TYPE line per packet type used by the flow.
+ *
+ * @param name   The name of the flow, or 'total' for all the flows
+ * @param stats  The estimated sizes
+ */
+static void print_estimate(const char *const name,
+                           const struct estimate_stats *const stats)
+{
+	size_t i;
+
+	printf("ESTIMATE\t%s\t%lu\t%llu\t%llu\t%llu\t%llu\n", name,
+	       stats->pkts_nr, stats->uncomp_size, stats->uncomp_hdr_size,
+	       stats->comp_size, stats->comp_hdr_size);
+
+	for(i = 0; i < ROHC_PROFILE_MAX; i++)
+	{
+		if(stats->profiles[i].pkts_nr > 0)
+		{
+			printf("PROFILE\t%s\t%zu\t%s\t%lu\t%llu\t%llu\n", name, i,
+			       rohc_get_profile_descr(i), stats->profiles[i].pkts_nr,
+			       stats->profiles[i].uncomp_hdr_size,
+			       stats->profiles[i].comp_hdr_size);
+		}
+	}
+	for(i = 0; i < ROHC_PACKET_MAX; i++)
+	{
+		if(stats->pkt_types[i].pkts_nr > 0)
+		{
+			printf("PACKET_TYPE\t%s\t%zu\t%s\t%lu\t%llu\t%llu\n", name, i,
+			       rohc_get_packet_descr(i), stats->pkt_types[i].pkts_nr,
+			       stats->pkt_types[i].uncomp_hdr_size,
+			       stats->pkt_types[i].comp_hdr_size);
+		}
+	}
+}
+
+
 /**
  * @brief Callback to print traces of the ROHC library
  *
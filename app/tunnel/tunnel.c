@@ -0,0 +1,1346 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   tunnel.c
+ * @brief  ROHC tunnel between two hosts over UDP or Ethernet
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * Objectives:
+ *   Run the library on a real bidirectional datapath, and measure it with
+ *   real traffic: the IP packets that the applications of the host send
+ *   through the tunnel interface.
+ *
+ * How it works:
+ *   The program creates one TUN interface. The IP packets that the host
+ *   routes through the interface are compressed and sent to the remote
+ *   tunnel endpoint, the ROHC packets received from the remote endpoint are
+ *   decompressed and given back to the host through the interface. Every
+ *   endpoint runs one ROHC compressor and one ROHC decompressor: the feedback
+ *   generated by the local decompressor is sent to the remote compressor,
+ *   and the feedback received from the remote decompressor is delivered to
+ *   the local compressor.
+ *
+ * Links:
+ *   The ROHC packets are carried in UDP datagrams, or in Ethernet frames with
+ *   the ROHC EtherType 0x22f1 on one network interface. The packets are sent
+ *   with sendmmsg() and received with recvmmsg(), one burst per system call.
+ *
+ * Batching:
+ *   One read() on a TUN interface returns one IP packet. Once the interface
+ *   is readable, the packets are read until none is waiting or until the
+ *   burst is full, then the burst is compressed at once with
+ *   rohc_compress_burst() and sent with one system call. The ROHC packets
+ *   received at once are decompressed with rohc_decompress_burst().
+ *
+ * Feedback:
+ *   The feedback generated for one burst of ROHC packets is sent as one
+ *   feedback-only ROHC packet, or piggybacked ahead of the next ROHC packets
+ *   with the --piggyback option if the traffic is bidirectional.
+ *
+ * Statistics:
+ *   The number of packets and bytes, and the time spent in the library per
+ *   packet are printed at the end of the run, and at regular interval of
+ *   time with the --stat option.
+ */
+
+#ifndef _GNU_SOURCE
+#  define _GNU_SOURCE /* for sendmmsg() and recvmmsg() */
+#endif
+
+#include "config.h" /* for PACKAGE_BUGREPORT */
+
+/* include files for ROHC library */
+#include <rohc/rohc.h>
+#include <rohc/rohc_comp.h>
+#include <rohc/rohc_decomp.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <assert.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <netdb.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <linux/if_tun.h>
+#include <linux/if_packet.h>
+#include <linux/if_ether.h>
+
+
+/** The EtherType of the Ethernet frames that carry ROHC packets */
+#define ETHER_TYPE_ROHC  0x22f1U
+
+/** The default number of packets read/sent at once */
+#define TUNNEL_BURST_DEFAULT  32U
+/** The maximum number of packets read/sent at once */
+#define TUNNEL_BURST_MAX  64U
+
+/** The maximum length of the IP and ROHC packets */
+#define TUNNEL_PKT_MAX_LEN  4096U
+
+/** The length of the socket buffers of the link, enough for several bursts
+ *  of packets to wait while the previous one is handled */
+#define TUNNEL_LINK_BUF_LEN  (4U * 1024U * 1024U)
+
+/** The maximum length of the feedback generated for one burst */
+#define TUNNEL_FEEDBACK_MAX_LEN  1024U
+
+/** The interval of time between two prints of the statistics (in ms) */
+#define TUNNEL_STAT_INTERVAL  1000
+
+
+/** The links the ROHC packets are carried on */
+typedef enum
+{
+	TUNNEL_LINK_UDP,    /**< UDP datagrams */
+	TUNNEL_LINK_ETHER,  /**< Ethernet frames with the ROHC EtherType */
+} tunnel_link_t;
+
+
+/** The statistics of the tunnel */
+struct tunnel_stats
+{
+	uint64_t tun_rx_pkts;       /**< The IP packets read from the interface */
+	uint64_t tun_tx_pkts;       /**< The IP packets written to the interface */
+	uint64_t link_rx_pkts;      /**< The ROHC packets received on the link */
+	uint64_t link_tx_pkts;      /**< The ROHC packets sent on the link */
+	uint64_t comp_failed;       /**< The IP packets the library rejected */
+	uint64_t comp_bytes_in;     /**< The bytes of the compressed IP packets */
+	uint64_t comp_bytes_out;    /**< The bytes of the built ROHC packets */
+	uint64_t comp_ns;           /**< The time spent in compression (ns) */
+	uint64_t decomp_failed;     /**< The ROHC packets the library rejected */
+	uint64_t decomp_bytes_in;   /**< The bytes of the decompressed ROHC packets */
+	uint64_t decomp_bytes_out;  /**< The bytes of the rebuilt IP packets */
+	uint64_t decomp_ns;         /**< The time spent in decompression (ns) */
+	uint64_t feedback_rx;       /**< The feedback received from the remote */
+	uint64_t feedback_tx;       /**< The feedback sent to the remote */
+	uint64_t dropped_pkts;      /**< The packets dropped by the system calls
+	                                 or coming from an unknown sender */
+};
+
+
+/** The tunnel */
+struct tunnel
+{
+	/** The file descriptor of the TUN interface */
+	int tun_fd;
+	/** The socket of the link */
+	int link_fd;
+	/** The type of link */
+	tunnel_link_t link_type;
+	/** The address of the remote endpoint */
+	struct sockaddr_storage remote;
+	/** The length of the address of the remote endpoint */
+	socklen_t remote_len;
+	/** The number of packets per burst */
+	size_t burst;
+	/** Whether the feedback is piggybacked or sent alone */
+	bool do_piggyback;
+	/** Print stats at regular interval */
+	bool do_print_stat;
+
+	/** The ROHC compressor for the packets read from the interface */
+	struct rohc_comp *comp;
+	/** The ROHC decompressor for the packets received on the link */
+	struct rohc_decomp *decomp;
+
+	/** The memory of the packets of one burst in every direction */
+	uint8_t *mem;
+	/** The IP packets read from the interface */
+	struct rohc_buf ip_pkts[TUNNEL_BURST_MAX];
+	/** The ROHC packets to send on the link */
+	struct rohc_buf rohc_pkts[TUNNEL_BURST_MAX];
+	/** The ROHC packets received on the link */
+	struct rohc_buf rx_pkts[TUNNEL_BURST_MAX];
+	/** The IP packets to write to the interface */
+	struct rohc_buf uncomp_pkts[TUNNEL_BURST_MAX];
+	/** The status of the packets of one burst */
+	rohc_status_t status[TUNNEL_BURST_MAX];
+
+	/** The messages of the system calls */
+	struct mmsghdr msgs[TUNNEL_BURST_MAX];
+	/** The data of the messages of the system calls */
+	struct iovec iovs[TUNNEL_BURST_MAX];
+	/** The senders of the received messages */
+	struct sockaddr_storage senders[TUNNEL_BURST_MAX];
+
+	/** The statistics of the tunnel */
+	struct tunnel_stats stats;
+};
+
+
+/** Whether the application shall stop or not */
+static volatile bool stop_program;
+
+
+/* prototypes of private functions */
+
+static void usage(void);
+static void tunnel_interrupt(int signum);
+
+static int tunnel_tun_open(const char *const name)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool tunnel_udp_open(struct tunnel *const tunnel,
+                            const char *const local,
+                            const char *const remote)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static bool tunnel_ether_open(struct tunnel *const tunnel,
+                              const char *const ifname,
+                              const char *const remote_mac)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static bool tunnel_parse_addr(const char *const str,
+                              struct sockaddr_storage *const addr,
+                              socklen_t *const addr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+static bool tunnel_run(struct tunnel *const tunnel)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool tunnel_tun_to_link(struct tunnel *const tunnel)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool tunnel_link_to_tun(struct tunnel *const tunnel)
+	__attribute__((warn_unused_result, nonnull(1)));
+static size_t tunnel_send(struct tunnel *const tunnel,
+                          const struct rohc_buf pkts[],
+                          const size_t pkts_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool tunnel_is_from_remote(const struct tunnel *const tunnel,
+                                  const struct mmsghdr *const msg)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static void tunnel_print_stats(const struct tunnel *const tunnel)
+	__attribute__((nonnull(1)));
+
+static struct rohc_ts tunnel_get_time(void)
+	__attribute__((warn_unused_result));
+static uint64_t tunnel_get_ns(void)
+	__attribute__((warn_unused_result));
+static int tunnel_random_num(const struct rohc_comp *const comp,
+                             void *const user_context)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Main function for the ROHC tunnel
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	struct tunnel tunnel;
+	char *tun_name = NULL;
+	char *link_name = NULL;
+	char *link_args[2] = { NULL, NULL };
+	char *cid_type_name = "smallcid";
+	char *mode_name = "O";
+	int max_contexts = ROHC_SMALL_CID_MAX + 1;
+	int burst = TUNNEL_BURST_DEFAULT;
+	const int link_buf_len = TUNNEL_LINK_BUF_LEN;
+	rohc_cid_type_t cid_type;
+	rohc_mode_t mode;
+	int args_used;
+	int status = 1;
+
+	memset(&tunnel, 0, sizeof(struct tunnel));
+	tunnel.tun_fd = -1;
+	tunnel.link_fd = -1;
+
+	/* by default, we don't stop */
+	stop_program = false;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc <= 1)
+	{
+		usage();
+		goto error;
+	}
+
+	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
+	{
+		args_used = 1;
+
+		if(!strcmp(*argv, "-v") || !strcmp(*argv, "--version"))
+		{
+			/* print version */
+			printf("rohc_tunnel version %s\n", rohc_version());
+			status = 0;
+			goto error;
+		}
+		else if(!strcmp(*argv, "-h") || !strcmp(*argv, "--help"))
+		{
+			/* print help */
+			usage();
+			status = 0;
+			goto error;
+		}
+		else if(!strcmp(*argv, "--stat"))
+		{
+			/* enable stat mode */
+			tunnel.do_print_stat = true;
+		}
+		else if(!strcmp(*argv, "--piggyback"))
+		{
+			/* piggyback the feedback ahead of the ROHC packets */
+			tunnel.do_piggyback = true;
+		}
+		else if(argc > 1 &&
+		        (!strcmp(*argv, "-m") || !strcmp(*argv, "--max-contexts")))
+		{
+			/* get the maximum number of contexts the tunnel should use */
+			max_contexts = atoi(argv[1]);
+			args_used++;
+		}
+		else if(argc > 1 && !strcmp(*argv, "--cid-type"))
+		{
+			/* get the type of CID to use within the ROHC library */
+			cid_type_name = argv[1];
+			args_used++;
+		}
+		else if(argc > 1 && !strcmp(*argv, "--mode"))
+		{
+			/* get the mode of the decompressor */
+			mode_name = argv[1];
+			args_used++;
+		}
+		else if(argc > 1 && !strcmp(*argv, "--burst"))
+		{
+			/* get the number of packets per burst */
+			burst = atoi(argv[1]);
+			args_used++;
+		}
+		else if(tun_name == NULL)
+		{
+			/* get the name of the TUN interface */
+			tun_name = argv[0];
+		}
+		else if(link_name == NULL)
+		{
+			/* get the type of link */
+			link_name = argv[0];
+		}
+		else if(link_args[0] == NULL)
+		{
+			/* get the local address or the network interface */
+			link_args[0] = argv[0];
+		}
+		else if(link_args[1] == NULL)
+		{
+			/* get the remote address */
+			link_args[1] = argv[0];
+		}
+		else
+		{
+			/* do not accept more than four parameters without option name */
+			usage();
+			goto error;
+		}
+	}
+
+	/* check the parameters of the link */
+	if(tun_name == NULL || link_name == NULL ||
+	   link_args[0] == NULL || link_args[1] == NULL)
+	{
+		fprintf(stderr, "missing mandatory TUN_NAME, LINK, LOCAL or REMOTE "
+		        "parameter\n");
+		usage();
+		goto error;
+	}
+	else if(!strcmp(link_name, "udp"))
+	{
+		tunnel.link_type = TUNNEL_LINK_UDP;
+	}
+	else if(!strcmp(link_name, "ether"))
+	{
+		tunnel.link_type = TUNNEL_LINK_ETHER;
+	}
+	else
+	{
+		fprintf(stderr, "invalid link '%s', only 'udp' and 'ether' expected\n",
+		        link_name);
+		goto error;
+	}
+
+	/* check CID type */
+	if(!strcmp(cid_type_name, "smallcid"))
+	{
+		cid_type = ROHC_SMALL_CID;
+
+		/* the maximum number of ROHC contexts should be valid */
+		if(max_contexts < 1 || (size_t) max_contexts > (ROHC_SMALL_CID_MAX + 1))
+		{
+			fprintf(stderr, "the maximum number of ROHC contexts should be "
+			        "between 1 and %u\n", ROHC_SMALL_CID_MAX + 1);
+			usage();
+			goto error;
+		}
+	}
+	else if(!strcmp(cid_type_name, "largecid"))
+	{
+		cid_type = ROHC_LARGE_CID;
+
+		/* the maximum number of ROHC contexts should be valid */
+		if(max_contexts < 1 || (size_t) max_contexts > (ROHC_LARGE_CID_MAX + 1))
+		{
+			fprintf(stderr, "the maximum number of ROHC contexts should be "
+			        "between 1 and %u\n", ROHC_LARGE_CID_MAX + 1);
+			usage();
+			goto error;
+		}
+	}
+	else
+	{
+		fprintf(stderr, "invalid CID type '%s', only 'smallcid' and 'largecid' "
+		        "expected\n", cid_type_name);
+		goto error;
+	}
+
+	/* check the mode of the decompressor */
+	if(!strcmp(mode_name, "U"))
+	{
+		mode = ROHC_U_MODE;
+	}
+	else if(!strcmp(mode_name, "O"))
+	{
+		mode = ROHC_O_MODE;
+	}
+	else if(!strcmp(mode_name, "R"))
+	{
+		mode = ROHC_R_MODE;
+	}
+	else
+	{
+		fprintf(stderr, "invalid mode '%s', only 'U', 'O' and 'R' expected\n",
+		        mode_name);
+		goto error;
+	}
+
+	/* check the burst */
+	if(burst < 1 || burst > (int) TUNNEL_BURST_MAX)
+	{
+		fprintf(stderr, "the number of packets per burst should be between 1 "
+		        "and %u\n", TUNNEL_BURST_MAX);
+		goto error;
+	}
+	tunnel.burst = burst;
+
+	/* the packets of one burst in every direction */
+	tunnel.mem = malloc(4 * TUNNEL_BURST_MAX * TUNNEL_PKT_MAX_LEN);
+	if(tunnel.mem == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for the packets\n");
+		goto error;
+	}
+
+	/* create the ROHC compressor and decompressor of the endpoint */
+	tunnel.comp = rohc_comp_new2(cid_type, max_contexts - 1,
+	                             tunnel_random_num, NULL);
+	if(tunnel.comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto free_mem;
+	}
+	if(!rohc_comp_enable_profiles(tunnel.comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
+	                              ROHC_PROFILE_ESP, ROHC_PROFILE_IP,
+	                              ROHC_PROFILE_TCP, ROHC_PROFILE_UDPLITE, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto free_comp;
+	}
+	tunnel.decomp = rohc_decomp_new2(cid_type, max_contexts - 1, mode);
+	if(tunnel.decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto free_comp;
+	}
+	if(!rohc_decomp_enable_profiles(tunnel.decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
+	                                ROHC_PROFILE_ESP, ROHC_PROFILE_IP,
+	                                ROHC_PROFILE_TCP, ROHC_PROFILE_UDPLITE, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto free_decomp;
+	}
+
+	/* create the TUN interface and the link */
+	tunnel.tun_fd = tunnel_tun_open(tun_name);
+	if(tunnel.tun_fd < 0)
+	{
+		goto free_decomp;
+	}
+	if(tunnel.link_type == TUNNEL_LINK_UDP)
+	{
+		if(!tunnel_udp_open(&tunnel, link_args[0], link_args[1]))
+		{
+			goto close_tun;
+		}
+	}
+	else if(!tunnel_ether_open(&tunnel, link_args[0], link_args[1]))
+	{
+		goto close_tun;
+	}
+	if(setsockopt(tunnel.link_fd, SOL_SOCKET, SO_RCVBUF, &link_buf_len,
+	              sizeof(int)) < 0 ||
+	   setsockopt(tunnel.link_fd, SOL_SOCKET, SO_SNDBUF, &link_buf_len,
+	              sizeof(int)) < 0)
+	{
+		fprintf(stderr, "failed to set the length of the socket buffers of the "
+		        "link: %s (%d)\n", strerror(errno), errno);
+		goto close_link;
+	}
+
+	/* stop the tunnel with CTRL+C */
+	signal(SIGINT, tunnel_interrupt);
+	signal(SIGTERM, tunnel_interrupt);
+
+	printf("tunnel %s over %s from %s to %s with %s in %s-mode\n", tun_name,
+	       (tunnel.link_type == TUNNEL_LINK_UDP ? "UDP" : "Ethernet"),
+	       link_args[0], link_args[1],
+	       (cid_type == ROHC_SMALL_CID ? "small CIDs" : "large CIDs"), mode_name);
+	fflush(stdout);
+
+	if(tunnel_run(&tunnel))
+	{
+		status = 0;
+	}
+	tunnel_print_stats(&tunnel);
+
+close_link:
+	close(tunnel.link_fd);
+close_tun:
+	close(tunnel.tun_fd);
+free_decomp:
+	rohc_decomp_free(tunnel.decomp);
+free_comp:
+	rohc_comp_free(tunnel.comp);
+free_mem:
+	free(tunnel.mem);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the tunnel application
+ */
+static void usage(void)
+{
+	printf("The ROHC tunnel compresses the IP packets routed through one TUN\n"
+	       "interface towards a remote tunnel endpoint, and decompresses the\n"
+	       "ROHC packets received from it\n"
+	       "\n"
+	       "Usage: rohc_tunnel [OPTIONS] TUN_NAME udp LOCAL_ADDR:PORT REMOTE_ADDR:PORT\n"
+	       "   or: rohc_tunnel [OPTIONS] TUN_NAME ether IFNAME REMOTE_MAC\n"
+	       "\n"
+	       "Options:\n"
+	       "  TUN_NAME                The name of the TUN interface to create\n"
+	       "  LOCAL_ADDR:PORT         The IPv4 or [IPv6] address and the UDP\n"
+	       "                          port to receive the ROHC packets on\n"
+	       "  REMOTE_ADDR:PORT        The IPv4 or [IPv6] address and the UDP\n"
+	       "                          port of the remote tunnel endpoint\n"
+	       "  IFNAME                  The network interface to send and receive\n"
+	       "                          the Ethernet frames on\n"
+	       "  REMOTE_MAC              The MAC address of the remote tunnel\n"
+	       "                          endpoint\n"
+	       "  -v, --version           Print version information and exit\n"
+	       "  -h, --help              Print this usage and exit\n"
+	       "  -m, --max-contexts NUM  The maximum number of ROHC contexts to\n"
+	       "                          simultaneously use in every direction\n"
+	       "      --cid-type TYPE     The type of CID to use among 'smallcid'\n"
+	       "                          and 'largecid' (default: smallcid)\n"
+	       "      --mode MODE         The mode of the decompressor among 'U',\n"
+	       "                          'O' and 'R' (default: O)\n"
+	       "      --burst NUM         The number of packets read or received\n"
+	       "                          at once (default: %u, max: %u)\n"
+	       "      --piggyback         Piggyback the feedback ahead of the ROHC\n"
+	       "                          packets instead of sending it alone, for\n"
+	       "                          bidirectional traffic\n"
+	       "      --stat              Print statistics at regular interval of time\n"
+	       "\n"
+	       "Examples:\n"
+	       "  rohc_tunnel rohc0 udp 192.168.0.1:5000 192.168.0.2:5000\n"
+	       "                          tunnel the IP packets routed through\n"
+	       "                          rohc0 to 192.168.0.2 over UDP\n"
+	       "  rohc_tunnel --mode U rohc0 ether eth1 00:11:22:33:44:55\n"
+	       "                          tunnel the IP packets routed through\n"
+	       "                          rohc0 over eth1 without feedback\n"
+	       "\n"
+	       "The TUN interface is created by the program, configure its\n"
+	       "addresses and routes once it is started, eg. with ip(8).\n"
+	       "\n"
+	       "Report bugs to <" PACKAGE_BUGREPORT ">.\n",
+	       TUNNEL_BURST_DEFAULT, TUNNEL_BURST_MAX);
+}
+
+
+/**
+ * @brief Handle UNIX signals that interrupt the program
+ *
+ * @param signum  The received signal
+ */
+static void tunnel_interrupt(int signum __attribute__((unused)))
+{
+	/* the tunnel ends the program after its current burst */
+	stop_program = true;
+}
+
+
+/**
+ * @brief Create the TUN interface
+ *
+ * The interface carries IP packets without the packet information header.
+ * It is non-blocking, so that all the packets waiting on it may be read at
+ * once.
+ *
+ * @param name  The name of the TUN interface
+ * @return      The file descriptor of the interface, -1 in case of failure
+ */
+static int tunnel_tun_open(const char *const name)
+{
+	struct ifreq ifr;
+	int fd;
+
+	if(strlen(name) >= IFNAMSIZ)
+	{
+		fprintf(stderr, "TUN name '%s' is too long\n", name);
+		goto error;
+	}
+
+	fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK);
+	if(fd < 0)
+	{
+		fprintf(stderr, "failed to open /dev/net/tun: %s (%d)\n",
+		        strerror(errno), errno);
+		goto error;
+	}
+
+	memset(&ifr, 0, sizeof(struct ifreq));
+	ifr.ifr_flags = IFF_TUN | IFF_NO_PI;
+	strncpy(ifr.ifr_name, name, IFNAMSIZ - 1);
+	if(ioctl(fd, TUNSETIFF, (void *) &ifr) < 0)
+	{
+		fprintf(stderr, "failed to create TUN interface '%s': %s (%d)\n",
+		        name, strerror(errno), errno);
+		goto close_fd;
+	}
+
+	return fd;
+
+close_fd:
+	close(fd);
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Create the UDP link of the tunnel
+ *
+ * @param tunnel  The tunnel
+ * @param local   The local address and port, as ADDR:PORT
+ * @param remote  The remote address and port, as ADDR:PORT
+ * @return        true if the link was created, false otherwise
+ */
+static bool tunnel_udp_open(struct tunnel *const tunnel,
+                            const char *const local,
+                            const char *const remote)
+{
+	struct sockaddr_storage local_addr;
+	socklen_t local_len;
+
+	if(!tunnel_parse_addr(local, &local_addr, &local_len))
+	{
+		fprintf(stderr, "invalid local address '%s'\n", local);
+		goto error;
+	}
+	if(!tunnel_parse_addr(remote, &tunnel->remote, &tunnel->remote_len))
+	{
+		fprintf(stderr, "invalid remote address '%s'\n", remote);
+		goto error;
+	}
+	if(local_addr.ss_family != tunnel->remote.ss_family)
+	{
+		fprintf(stderr, "local and remote addresses are not of the same "
+		        "family\n");
+		goto error;
+	}
+
+	tunnel->link_fd = socket(local_addr.ss_family, SOCK_DGRAM, IPPROTO_UDP);
+	if(tunnel->link_fd < 0)
+	{
+		fprintf(stderr, "failed to create UDP socket: %s (%d)\n",
+		        strerror(errno), errno);
+		goto error;
+	}
+	if(bind(tunnel->link_fd, (struct sockaddr *) &local_addr, local_len) < 0)
+	{
+		fprintf(stderr, "failed to bind UDP socket on '%s': %s (%d)\n", local,
+		        strerror(errno), errno);
+		goto close_fd;
+	}
+
+	return true;
+
+close_fd:
+	close(tunnel->link_fd);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Create the Ethernet link of the tunnel
+ *
+ * The frames are built and parsed by the kernel: the packet socket sends and
+ * receives the ROHC packets only.
+ *
+ * @param tunnel      The tunnel
+ * @param ifname      The network interface to send and receive frames on
+ * @param remote_mac  The MAC address of the remote endpoint
+ * @return            true if the link was created, false otherwise
+ */
+static bool tunnel_ether_open(struct tunnel *const tunnel,
+                              const char *const ifname,
+                              const char *const remote_mac)
+{
+	struct sockaddr_ll *const remote = (struct sockaddr_ll *) &tunnel->remote;
+	struct sockaddr_ll local;
+	unsigned int mac[ETH_ALEN];
+	unsigned int ifindex;
+	size_t i;
+
+	ifindex = if_nametoindex(ifname);
+	if(ifindex == 0)
+	{
+		fprintf(stderr, "unknown network interface '%s'\n", ifname);
+		goto error;
+	}
+	if(sscanf(remote_mac, "%x:%x:%x:%x:%x:%x", &mac[0], &mac[1], &mac[2],
+	          &mac[3], &mac[4], &mac[5]) != ETH_ALEN)
+	{
+		fprintf(stderr, "invalid remote MAC address '%s'\n", remote_mac);
+		goto error;
+	}
+
+	memset(&local, 0, sizeof(struct sockaddr_ll));
+	local.sll_family = AF_PACKET;
+	local.sll_protocol = htons(ETHER_TYPE_ROHC);
+	local.sll_ifindex = ifindex;
+
+	memset(&tunnel->remote, 0, sizeof(struct sockaddr_storage));
+	remote->sll_family = AF_PACKET;
+	remote->sll_protocol = htons(ETHER_TYPE_ROHC);
+	remote->sll_ifindex = ifindex;
+	remote->sll_halen = ETH_ALEN;
+	for(i = 0; i < ETH_ALEN; i++)
+	{
+		if(mac[i] > 0xff)
+		{
+			fprintf(stderr, "invalid remote MAC address '%s'\n", remote_mac);
+			goto error;
+		}
+		remote->sll_addr[i] = mac[i];
+	}
+	tunnel->remote_len = sizeof(struct sockaddr_ll);
+
+	tunnel->link_fd = socket(AF_PACKET, SOCK_DGRAM, htons(ETHER_TYPE_ROHC));
+	if(tunnel->link_fd < 0)
+	{
+		fprintf(stderr, "failed to create packet socket: %s (%d)\n",
+		        strerror(errno), errno);
+		goto error;
+	}
+	if(bind(tunnel->link_fd, (struct sockaddr *) &local,
+	        sizeof(struct sockaddr_ll)) < 0)
+	{
+		fprintf(stderr, "failed to bind packet socket on '%s': %s (%d)\n",
+		        ifname, strerror(errno), errno);
+		goto close_fd;
+	}
+
+	return true;
+
+close_fd:
+	close(tunnel->link_fd);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Parse one IPv4 or IPv6 address and UDP port
+ *
+ * @param str            The address and port, as ADDR:PORT or [ADDR]:PORT
+ * @param[out] addr      The parsed address and port
+ * @param[out] addr_len  The length of the parsed address
+ * @return               true if the address was parsed, false otherwise
+ */
+static bool tunnel_parse_addr(const char *const str,
+                              struct sockaddr_storage *const addr,
+                              socklen_t *const addr_len)
+{
+	struct addrinfo hints;
+	struct addrinfo *res;
+	char host[INET6_ADDRSTRLEN];
+	const char *host_begin = str;
+	const char *port;
+	size_t host_len;
+
+	/* the port follows the last colon, the IPv6 addresses are bracketed */
+	port = strrchr(str, ':');
+	if(port == NULL || port == str || port[1] == '\0')
+	{
+		goto error;
+	}
+	host_len = port - str;
+	port++;
+	if(str[0] == '[' && host_len >= 2 && str[host_len - 1] == ']')
+	{
+		host_begin++;
+		host_len -= 2;
+	}
+	if(host_len == 0 || host_len >= sizeof(host))
+	{
+		goto error;
+	}
+	memcpy(host, host_begin, host_len);
+	host[host_len] = '\0';
+
+	memset(&hints, 0, sizeof(struct addrinfo));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_DGRAM;
+	hints.ai_flags = AI_NUMERICHOST | AI_NUMERICSERV;
+	if(getaddrinfo(host, port, &hints, &res) != 0)
+	{
+		goto error;
+	}
+	memcpy(addr, res->ai_addr, res->ai_addrlen);
+	*addr_len = res->ai_addrlen;
+	freeaddrinfo(res);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Run the tunnel until it is interrupted
+ *
+ * @param tunnel  The tunnel
+ * @return        true if the tunnel was interrupted,
+ *                false if an unrecoverable error occurred
+ */
+static bool tunnel_run(struct tunnel *const tunnel)
+{
+	struct pollfd fds[2];
+	uint64_t last_stat_ns = tunnel_get_ns();
+
+	fds[0].fd = tunnel->tun_fd;
+	fds[0].events = POLLIN;
+	fds[1].fd = tunnel->link_fd;
+	fds[1].events = POLLIN;
+
+	while(!stop_program)
+	{
+		const int ret = poll(fds, 2, TUNNEL_STAT_INTERVAL);
+
+		if(ret < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+			fprintf(stderr, "failed to poll the TUN interface and the link: "
+			        "%s (%d)\n", strerror(errno), errno);
+			goto error;
+		}
+
+		/* the IP packets routed through the TUN interface */
+		if((fds[0].revents & POLLIN) != 0 && !tunnel_tun_to_link(tunnel))
+		{
+			goto error;
+		}
+		/* the ROHC packets received from the remote endpoint */
+		if((fds[1].revents & POLLIN) != 0 && !tunnel_link_to_tun(tunnel))
+		{
+			goto error;
+		}
+		if(((fds[0].revents | fds[1].revents) & (POLLERR | POLLHUP)) != 0)
+		{
+			fprintf(stderr, "the TUN interface or the link was closed\n");
+			goto error;
+		}
+
+		if(tunnel->do_print_stat)
+		{
+			const uint64_t now_ns = tunnel_get_ns();
+
+			if((now_ns - last_stat_ns) >= (TUNNEL_STAT_INTERVAL * 1000000ULL))
+			{
+				tunnel_print_stats(tunnel);
+				last_stat_ns = now_ns;
+			}
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Compress the IP packets waiting on the TUN interface
+ *
+ * The IP packets are read one by one until none is waiting or until the
+ * burst is full, compressed at once and sent on the link at once.
+ *
+ * @param tunnel  The tunnel
+ * @return        true if the burst was handled, even if some packets were
+ *                dropped, false if the interface cannot be read any more
+ */
+static bool tunnel_tun_to_link(struct tunnel *const tunnel)
+{
+	uint8_t *const ip_mem = tunnel->mem;
+	uint8_t *const rohc_mem = ip_mem + TUNNEL_BURST_MAX * TUNNEL_PKT_MAX_LEN;
+	const struct rohc_ts now = tunnel_get_time();
+	size_t ok_nr = 0;
+	size_t pkts_nr;
+	size_t handled_nr;
+	size_t i;
+	uint64_t begin_ns;
+
+	/* read the IP packets waiting on the interface */
+	for(pkts_nr = 0; pkts_nr < tunnel->burst; pkts_nr++)
+	{
+		uint8_t *const data = ip_mem + pkts_nr * TUNNEL_PKT_MAX_LEN;
+		const ssize_t ret = read(tunnel->tun_fd, data, TUNNEL_PKT_MAX_LEN);
+
+		if(ret < 0)
+		{
+			if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+			{
+				break;
+			}
+			fprintf(stderr, "failed to read the TUN interface: %s (%d)\n",
+			        strerror(errno), errno);
+			goto error;
+		}
+		tunnel->ip_pkts[pkts_nr].time = now;
+		tunnel->ip_pkts[pkts_nr].data = data;
+		tunnel->ip_pkts[pkts_nr].max_len = TUNNEL_PKT_MAX_LEN;
+		tunnel->ip_pkts[pkts_nr].offset = 0;
+		tunnel->ip_pkts[pkts_nr].len = ret;
+
+		tunnel->rohc_pkts[pkts_nr].time = now;
+		tunnel->rohc_pkts[pkts_nr].data = rohc_mem + pkts_nr * TUNNEL_PKT_MAX_LEN;
+		tunnel->rohc_pkts[pkts_nr].max_len = TUNNEL_PKT_MAX_LEN;
+		tunnel->rohc_pkts[pkts_nr].offset = 0;
+		tunnel->rohc_pkts[pkts_nr].len = 0;
+	}
+	if(pkts_nr == 0)
+	{
+		goto skip;
+	}
+	tunnel->stats.tun_rx_pkts += pkts_nr;
+
+	/* compress all the IP packets at once */
+	begin_ns = tunnel_get_ns();
+	handled_nr = rohc_compress_burst(tunnel->comp, tunnel->ip_pkts,
+	                                 tunnel->rohc_pkts, tunnel->status, pkts_nr);
+	tunnel->stats.comp_ns += tunnel_get_ns() - begin_ns;
+
+	/* send the ROHC packets that were built, in order */
+	for(i = 0; i < handled_nr; i++)
+	{
+		if(tunnel->status[i] != ROHC_STATUS_OK)
+		{
+			tunnel->stats.comp_failed++;
+			continue;
+		}
+		tunnel->stats.comp_bytes_in += tunnel->ip_pkts[i].len;
+		tunnel->stats.comp_bytes_out += tunnel->rohc_pkts[i].len;
+		tunnel->rohc_pkts[ok_nr] = tunnel->rohc_pkts[i];
+		ok_nr++;
+	}
+	tunnel->stats.comp_failed += pkts_nr - handled_nr;
+	tunnel->stats.link_tx_pkts += tunnel_send(tunnel, tunnel->rohc_pkts, ok_nr);
+
+skip:
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Decompress the ROHC packets waiting on the link
+ *
+ * The ROHC packets are received at once, decompressed at once, and the IP
+ * packets are written to the TUN interface one by one. The feedback received
+ * in the ROHC packets is delivered to the compressor, the feedback generated
+ * for them is sent to the remote endpoint.
+ *
+ * @param tunnel  The tunnel
+ * @return        true if the burst was handled, even if some packets were
+ *                dropped, false if the link cannot be read any more
+ */
+static bool tunnel_link_to_tun(struct tunnel *const tunnel)
+{
+	uint8_t *const rx_mem = tunnel->mem + 2 * TUNNEL_BURST_MAX * TUNNEL_PKT_MAX_LEN;
+	uint8_t *const uncomp_mem = rx_mem + TUNNEL_BURST_MAX * TUNNEL_PKT_MAX_LEN;
+	uint8_t rcvd_feedback_buf[TUNNEL_FEEDBACK_MAX_LEN];
+	struct rohc_buf rcvd_feedback =
+		rohc_buf_init_empty(rcvd_feedback_buf, TUNNEL_FEEDBACK_MAX_LEN);
+	uint8_t feedback_send_buf[TUNNEL_FEEDBACK_MAX_LEN];
+	struct rohc_buf feedback_send =
+		rohc_buf_init_empty(feedback_send_buf, TUNNEL_FEEDBACK_MAX_LEN);
+	const struct rohc_ts now = tunnel_get_time();
+	size_t pkts_nr = 0;
+	size_t handled_nr;
+	size_t i;
+	uint64_t begin_ns;
+	int ret;
+
+	/* receive all the ROHC packets waiting on the link at once */
+	for(i = 0; i < tunnel->burst; i++)
+	{
+		tunnel->iovs[i].iov_base = rx_mem + i * TUNNEL_PKT_MAX_LEN;
+		tunnel->iovs[i].iov_len = TUNNEL_PKT_MAX_LEN;
+		memset(&tunnel->msgs[i], 0, sizeof(struct mmsghdr));
+		tunnel->msgs[i].msg_hdr.msg_iov = &tunnel->iovs[i];
+		tunnel->msgs[i].msg_hdr.msg_iovlen = 1;
+		tunnel->msgs[i].msg_hdr.msg_name = &tunnel->senders[i];
+		tunnel->msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+	}
+	ret = recvmmsg(tunnel->link_fd, tunnel->msgs, tunnel->burst, MSG_DONTWAIT,
+	               NULL);
+	if(ret < 0)
+	{
+		if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+		{
+			goto skip;
+		}
+		fprintf(stderr, "failed to receive from the link: %s (%d)\n",
+		        strerror(errno), errno);
+		goto error;
+	}
+
+	/* keep the packets from the remote endpoint only */
+	for(i = 0; i < (size_t) ret; i++)
+	{
+		if(!tunnel_is_from_remote(tunnel, &tunnel->msgs[i]) ||
+		   tunnel->msgs[i].msg_len == 0 ||
+		   (tunnel->msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0)
+		{
+			tunnel->stats.dropped_pkts++;
+			continue;
+		}
+		tunnel->rx_pkts[pkts_nr].time = now;
+		tunnel->rx_pkts[pkts_nr].data = tunnel->iovs[i].iov_base;
+		tunnel->rx_pkts[pkts_nr].max_len = TUNNEL_PKT_MAX_LEN;
+		tunnel->rx_pkts[pkts_nr].offset = 0;
+		tunnel->rx_pkts[pkts_nr].len = tunnel->msgs[i].msg_len;
+
+		tunnel->uncomp_pkts[pkts_nr].time = now;
+		tunnel->uncomp_pkts[pkts_nr].data = uncomp_mem + pkts_nr * TUNNEL_PKT_MAX_LEN;
+		tunnel->uncomp_pkts[pkts_nr].max_len = TUNNEL_PKT_MAX_LEN;
+		tunnel->uncomp_pkts[pkts_nr].offset = 0;
+		tunnel->uncomp_pkts[pkts_nr].len = 0;
+		pkts_nr++;
+	}
+	if(pkts_nr == 0)
+	{
+		goto skip;
+	}
+	tunnel->stats.link_rx_pkts += pkts_nr;
+
+	/* decompress all the ROHC packets at once */
+	begin_ns = tunnel_get_ns();
+	handled_nr = rohc_decompress_burst(tunnel->decomp, tunnel->rx_pkts,
+	                                   tunnel->uncomp_pkts, tunnel->status,
+	                                   pkts_nr, &rcvd_feedback, &feedback_send);
+	tunnel->stats.decomp_ns += tunnel_get_ns() - begin_ns;
+
+	/* give the IP packets back to the host, in order */
+	for(i = 0; i < handled_nr; i++)
+	{
+		if(tunnel->status[i] != ROHC_STATUS_OK)
+		{
+			tunnel->stats.decomp_failed++;
+			continue;
+		}
+		if(rohc_buf_is_empty(tunnel->uncomp_pkts[i]))
+		{
+			/* feedback-only packet or non-final segment */
+			continue;
+		}
+		tunnel->stats.decomp_bytes_in += tunnel->rx_pkts[i].len;
+		tunnel->stats.decomp_bytes_out += tunnel->uncomp_pkts[i].len;
+		if(write(tunnel->tun_fd, rohc_buf_data(tunnel->uncomp_pkts[i]),
+		         tunnel->uncomp_pkts[i].len) < 0)
+		{
+			tunnel->stats.dropped_pkts++;
+			continue;
+		}
+		tunnel->stats.tun_tx_pkts++;
+	}
+	tunnel->stats.decomp_failed += pkts_nr - handled_nr;
+
+	/* the feedback of the remote decompressor is for the local compressor */
+	if(!rohc_buf_is_empty(rcvd_feedback))
+	{
+		tunnel->stats.feedback_rx++;
+		if(!rohc_comp_deliver_feedback2(tunnel->comp, rcvd_feedback))
+		{
+			tunnel->stats.dropped_pkts++;
+		}
+	}
+
+	/* the feedback of the local decompressor is for the remote compressor:
+	 * piggyback it ahead of the next ROHC packets if asked for and if it
+	 * fits, send it alone as one feedback-only ROHC packet otherwise */
+	if(!rohc_buf_is_empty(feedback_send))
+	{
+		tunnel->stats.feedback_tx++;
+		if(!tunnel->do_piggyback ||
+		   !rohc_comp_piggyback_feedback(tunnel->comp, feedback_send))
+		{
+			tunnel->stats.link_tx_pkts += tunnel_send(tunnel, &feedback_send, 1);
+		}
+	}
+
+skip:
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Send the given ROHC packets to the remote endpoint at once
+ *
+ * @param tunnel   The tunnel
+ * @param pkts     The ROHC packets to send
+ * @param pkts_nr  The number of ROHC packets to send
+ * @return         The number of ROHC packets that were sent
+ */
+static size_t tunnel_send(struct tunnel *const tunnel,
+                          const struct rohc_buf pkts[],
+                          const size_t pkts_nr)
+{
+	size_t done_nr = 0;
+	size_t sent_nr = 0;
+	size_t i;
+
+	for(i = 0; i < pkts_nr; i++)
+	{
+		tunnel->iovs[i].iov_base = rohc_buf_data(pkts[i]);
+		tunnel->iovs[i].iov_len = pkts[i].len;
+		memset(&tunnel->msgs[i], 0, sizeof(struct mmsghdr));
+		tunnel->msgs[i].msg_hdr.msg_iov = &tunnel->iovs[i];
+		tunnel->msgs[i].msg_hdr.msg_iovlen = 1;
+		tunnel->msgs[i].msg_hdr.msg_name = &tunnel->remote;
+		tunnel->msgs[i].msg_hdr.msg_namelen = tunnel->remote_len;
+	}
+
+	/* the system call may send a part of the packets only */
+	while(done_nr < pkts_nr)
+	{
+		const int ret = sendmmsg(tunnel->link_fd, tunnel->msgs + done_nr,
+		                         pkts_nr - done_nr, 0);
+
+		if(ret < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+			/* drop the packet that cannot be sent, eg. too large for the
+			 * link, and go on with the next ones */
+			tunnel->stats.dropped_pkts++;
+			done_nr++;
+			continue;
+		}
+		done_nr += ret;
+		sent_nr += ret;
+	}
+
+	return sent_nr;
+}
+
+
+/**
+ * @brief Whether the given message was received from the remote endpoint
+ *
+ * @param tunnel  The tunnel
+ * @param msg     The received message
+ * @return        true if the message was sent by the remote endpoint,
+ *                false if it was sent by another host, or if it is one of the
+ *                frames the packet socket sees leaving the host
+ */
+static bool tunnel_is_from_remote(const struct tunnel *const tunnel,
+                                  const struct mmsghdr *const msg)
+{
+	const struct sockaddr_storage *const sender = msg->msg_hdr.msg_name;
+	bool is_from_remote;
+
+	if(tunnel->link_type == TUNNEL_LINK_ETHER)
+	{
+		const struct sockaddr_ll *const ll_sender =
+			(const struct sockaddr_ll *) sender;
+		const struct sockaddr_ll *const ll_remote =
+			(const struct sockaddr_ll *) &tunnel->remote;
+
+		is_from_remote = (ll_sender->sll_pkttype != PACKET_OUTGOING &&
+		                  ll_sender->sll_halen == ETH_ALEN &&
+		                  memcmp(ll_sender->sll_addr, ll_remote->sll_addr,
+		                         ETH_ALEN) == 0);
+	}
+	else if(sender->ss_family == AF_INET)
+	{
+		const struct sockaddr_in *const in_sender =
+			(const struct sockaddr_in *) sender;
+		const struct sockaddr_in *const in_remote =
+			(const struct sockaddr_in *) &tunnel->remote;
+
+		is_from_remote = (in_sender->sin_port == in_remote->sin_port &&
+		                  in_sender->sin_addr.s_addr == in_remote->sin_addr.s_addr);
+	}
+	else if(sender->ss_family == AF_INET6)
+	{
+		const struct sockaddr_in6 *const in6_sender =
+			(const struct sockaddr_in6 *) sender;
+		const struct sockaddr_in6 *const in6_remote =
+			(const struct sockaddr_in6 *) &tunnel->remote;
+
+		is_from_remote = (in6_sender->sin6_port == in6_remote->sin6_port &&
+		                  memcmp(&in6_sender->sin6_addr, &in6_remote->sin6_addr,
+		                         sizeof(struct in6_addr)) == 0);
+	}
+	else
+	{
+		is_from_remote = false;
+	}
+
+	return is_from_remote;
+}
+
+
+/**
+ * @brief Print the statistics of the tunnel
+ *
+ * @param tunnel  The tunnel
+ */
+static void tunnel_print_stats(const struct tunnel *const tunnel)
+{
+	const struct tunnel_stats *const stats = &tunnel->stats;
+	const uint64_t comp_nr = stats->tun_rx_pkts;
+	const uint64_t decomp_nr = stats->link_rx_pkts;
+
+	printf("packets: %" PRIu64 " read from TUN, %" PRIu64 " written to TUN, "
+	       "%" PRIu64 " received, %" PRIu64 " sent, %" PRIu64 " dropped\n",
+	       stats->tun_rx_pkts, stats->tun_tx_pkts, stats->link_rx_pkts,
+	       stats->link_tx_pkts, stats->dropped_pkts);
+	printf("compression: %" PRIu64 " failures, %" PRIu64 " bytes -> "
+	       "%" PRIu64 " bytes, %" PRIu64 " ns/packet\n", stats->comp_failed,
+	       stats->comp_bytes_in, stats->comp_bytes_out,
+	       (comp_nr == 0 ? 0 : stats->comp_ns / comp_nr));
+	printf("decompression: %" PRIu64 " failures, %" PRIu64 " bytes -> "
+	       "%" PRIu64 " bytes, %" PRIu64 " ns/packet\n", stats->decomp_failed,
+	       stats->decomp_bytes_in, stats->decomp_bytes_out,
+	       (decomp_nr == 0 ? 0 : stats->decomp_ns / decomp_nr));
+	printf("feedback: %" PRIu64 " received, %" PRIu64 " sent\n",
+	       stats->feedback_rx, stats->feedback_tx);
+	fflush(stdout);
+}
+
+
+/**
+ * @brief Get the current time for the library
+ *
+ * @return  The current time
+ */
+static struct rohc_ts tunnel_get_time(void)
+{
+	struct rohc_ts now = { .sec = 0, .nsec = 0 };
+	struct timespec ts;
+
+	if(clock_gettime(CLOCK_MONOTONIC_COARSE, &ts) == 0)
+	{
+		now.sec = ts.tv_sec;
+		now.nsec = ts.tv_nsec;
+	}
+
+	return now;
+}
+
+
+/**
+ * @brief Get the current time to measure the time spent in the library
+ *
+ * @return  The current time (in ns)
+ */
+static uint64_t tunnel_get_ns(void)
+{
+	struct timespec ts;
+
+	if(clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+	{
+		return 0;
+	}
+
+	return ((uint64_t) ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int tunnel_random_num(const struct rohc_comp *const comp,
+                             void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return rand();
+}
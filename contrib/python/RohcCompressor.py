@@ -36,6 +36,7 @@ from rohc import ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, \
                  rohc_comp_set_rtp_detection_cb, rohc_compress4, \
                  rohc_comp_deliver_feedback2, rohc_get_profile_descr, \
                  gen_false_random_num, print_rohc_traces, rohc_comp_rtp_cb, \
+                 rohc_comp_compress_many, rohc_comp_compress_pcap, \
                  rohc_ts, rohc_buf
 
 
@@ -51,7 +52,7 @@ class RohcCompressor(object):
     verbose = None
 
     _buf_max_len = 0xffff * 2
-    _buf = b""
+    _buf = None
 
     def __init__(self, cid_type=ROHC_SMALL_CID, cid_max=ROHC_SMALL_CID_MAX, \
                  wlsb_width=4, profiles=[ROHC_PROFILE_UNCOMPRESSED], verbose=False):
@@ -100,19 +101,22 @@ class RohcCompressor(object):
             return None
 
         # create the output buffers
-        self._buf = b""
-        for _ in range(0, self._buf_max_len):
-            self._buf += b'\x00'
+        self._buf = bytearray(self._buf_max_len)
 
-    def compress(self, uncomp_pkt):
+    def compress(self, uncomp_pkt, out=None):
         """ Compress the given uncompressed packet
 
         Keyword arguments:
-        uncomp_pkt -- the uncompressed packet (str)
+        uncomp_pkt -- the uncompressed packet (bytes, bytearray, memoryview or
+                      any object that supports the buffer protocol)
+        out        -- the writable buffer (bytearray, memoryview...) to write
+                      the compressed packet in without copy, or None to get
+                      a copy of the compressed packet (bytes)
 
         Return tuple (return_code, compressed_packet):
         status   -- a value among ROHC_STATUS_*
-        comp_pkt -- the compressed packet (str) or None wrt status_code
+        comp_pkt -- the compressed packet or None wrt status_code: a
+                    memoryview on out if out is given, bytes otherwise
         """
 
         status = ROHC_STATUS_ERROR
@@ -120,16 +124,20 @@ class RohcCompressor(object):
         timestamp = rohc_ts(0, 0)
 
         # create the input buffer for the uncompressed packet
-        if isinstance(uncomp_pkt, bytes) is not True:
-            raise TypeError("compress(): argument 'uncomp_pkt' shall be "\
-                            "'bytes' not '%s'" % type(uncomp_pkt))
-        uncomp_pkt_len = len(uncomp_pkt)
+        try:
+            uncomp_pkt_len = memoryview(uncomp_pkt).nbytes
+        except TypeError:
+            raise TypeError("compress(): argument 'uncomp_pkt' shall support "\
+                            "the buffer protocol, not '%s'" % type(uncomp_pkt))
         buf_uncomp = rohc_buf(uncomp_pkt, uncomp_pkt_len, timestamp)
         if buf_uncomp is None:
             return (status, None)
 
         # create the output buffer for the compressed ROHC packet
-        buf_comp = rohc_buf(self._buf, 0, timestamp)
+        if out is None:
+            buf_comp = rohc_buf(self._buf, 0, timestamp)
+        else:
+            buf_comp = rohc_buf(out, 0, timestamp)
         if buf_comp is None:
             return (status, None)
 
@@ -138,7 +146,58 @@ class RohcCompressor(object):
         if status != ROHC_STATUS_OK:
             return (status, None)
 
-        return (status, self._buf[:buf_comp.len])
+        if out is None:
+            return (status, bytes(self._buf[:buf_comp.len]))
+        return (status, memoryview(out)[:buf_comp.len])
+
+    def compress_many(self, uncomp_pkts, headroom=0):
+        """ Compress the given uncompressed packets in one single batch
+
+        The Python GIL is released while the packets are compressed, the
+        compressor shall not be used by other threads in the meantime.
+
+        Keyword arguments:
+        uncomp_pkts -- the sequence of uncompressed packets (bytes, bytearray,
+                       memoryview or any object that supports the buffer
+                       protocol)
+        headroom    -- the room for the ROHC headers of every packet in bytes,
+                       0 for the default room
+
+        Return the list of (status, comp_pkt) tuples of the packets that were
+        handled, comp_pkt being a memoryview on one output buffer shared by
+        all the compressed packets or None wrt status. The list is shorter
+        than uncomp_pkts if one packet requires ROHC segmentation, the next
+        packets shall be given again.
+        """
+
+        return rohc_comp_compress_many(self.comp, uncomp_pkts, headroom)
+
+    def compress_pcap(self, filename):
+        """ Compress all the packets of the given PCAP capture
+
+        The capture is read and compressed in C with one single call, the
+        Python GIL being released in the meantime. The compressor shall not
+        be used by other threads in the meantime. Only the classic PCAP
+        format is read, see pcap.py for PCAP-NG captures.
+
+        Keyword arguments:
+        filename -- the path to the PCAP capture of uncompressed packets
+
+        Return the dictionary of statistics:
+        packets      -- the number of packets in the capture
+        ok           -- the number of packets successfully compressed
+        errors       -- the number of packets that failed to be compressed
+        uncomp_bytes -- the number of bytes of all the uncompressed packets
+        comp_bytes   -- the number of bytes of the ROHC packets
+        status       -- the ROHC_STATUS_* of every packet
+        packet_types -- the ROHC_PACKET_* of every packet
+        uncomp_sizes -- the size of every uncompressed packet
+        comp_sizes   -- the size of every ROHC packet
+        The per-packet values are memoryviews of C integers that
+        numpy.frombuffer() or array.array may use without copy.
+        """
+
+        return rohc_comp_compress_pcap(self.comp, filename)
 
     def deliver_feedback(self, feedback):
         """ Deliver the given feedback packet to the ROHC compressor
@@ -153,10 +212,12 @@ class RohcCompressor(object):
         timestamp = rohc_ts(0, 0)
 
         # create the buffer for the feedback data
-        if isinstance(feedback, bytes) is not True:
-            raise TypeError("compress(): argument 'feedback' shall be "\
-                            "'bytes' not '%s'" % type(feedback))
-        feedback_len = len(feedback)
+        try:
+            feedback_len = memoryview(feedback).nbytes
+        except TypeError:
+            raise TypeError("deliver_feedback(): argument 'feedback' shall "\
+                            "support the buffer protocol, not '%s'" % \
+                            type(feedback))
         buf_feedback = rohc_buf(feedback, feedback_len, timestamp)
         if buf_feedback is None:
             return False
@@ -34,6 +34,7 @@ from rohc import ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, \
                  rohc_decomp_new2, rohc_decomp_set_traces_cb2, \
                  rohc_decomp_enable_profile, rohc_decompress3, \
                  rohc_get_profile_descr, print_rohc_traces, \
+                 rohc_decomp_decompress_many, rohc_decomp_decompress_pcap, \
                  rohc_ts, rohc_buf
 from struct import pack
 
@@ -50,9 +51,9 @@ class RohcDecompressor(object):
     verbose = None
 
     _buf_max_len = 0xffff
-    _buf1 = b""
-    _buf2 = b""
-    _buf3 = b""
+    _buf1 = None
+    _buf2 = None
+    _buf3 = None
 
     def __init__(self, cid_type=ROHC_SMALL_CID, cid_max=ROHC_SMALL_CID_MAX, \
                  mode=ROHC_U_MODE, profiles=[ROHC_PROFILE_UNCOMPRESSED], \
@@ -91,43 +92,46 @@ class RohcDecompressor(object):
                 return None
 
         # create the output buffers
-        self._buf1 = b""
-        for _ in range(0, self._buf_max_len):
-            self._buf1 += b'\0'
-        self._buf2 = b""
-        for _ in range(0, self._buf_max_len):
-            self._buf2 += b'\0'
-        self._buf3 = b""
-        for _ in range(0, self._buf_max_len):
-            self._buf3 += b'\0'
-
-    def decompress(self, comp_pkt):
+        self._buf1 = bytearray(self._buf_max_len)
+        self._buf2 = bytearray(self._buf_max_len)
+        self._buf3 = bytearray(self._buf_max_len)
+
+    def decompress(self, comp_pkt, out=None):
         """ Decompress the given compressed ROHC packet
 
         Keyword arguments:
-        comp_pkt -- the compressed ROHC packet (str)
+        comp_pkt -- the compressed ROHC packet (bytes, bytearray, memoryview
+                    or any object that supports the buffer protocol)
+        out      -- the writable buffer (bytearray, memoryview...) to write the
+                    decompressed packet in without copy, or None to get a
+                    copy of the decompressed packet (bytes)
 
         Return tuple:
         status           -- a value among ROHC_STATUS_*
-        decomp_pkt       -- the decompressed packet (str) or None wrt status_code
-        feedback_recv    -- the feedback (str) received with the compressed packet
-        feedback_to_send -- the feedback (str) to send with the associated compressor
+        decomp_pkt       -- the decompressed packet or None wrt status_code:
+                            a memoryview on out if out is given, bytes otherwise
+        feedback_recv    -- the feedback (bytes) received with the compressed packet
+        feedback_to_send -- the feedback (bytes) to send with the associated compressor
         """
 
         status = ROHC_STATUS_ERROR
         timestamp = rohc_ts(0, 0)
 
         # create the input buffer for the compressed ROHC packet
-        if isinstance(comp_pkt, bytes) is not True:
-            raise TypeError("compress(): argument 'comp_pkt' shall be "\
-                            "'bytes' not '%s'" % type(comp_pkt))
-        comp_pkt_len = len(comp_pkt)
+        try:
+            comp_pkt_len = memoryview(comp_pkt).nbytes
+        except TypeError:
+            raise TypeError("decompress(): argument 'comp_pkt' shall support "\
+                            "the buffer protocol, not '%s'" % type(comp_pkt))
         buf_comp = rohc_buf(comp_pkt, comp_pkt_len, timestamp)
         if buf_comp is None:
             return (status, None, None, None)
 
         # create the output buffer for the decompressed packet
-        buf_decomp = rohc_buf(self._buf1, 0, timestamp)
+        if out is None:
+            buf_decomp = rohc_buf(self._buf1, 0, timestamp)
+        else:
+            buf_decomp = rohc_buf(out, 0, timestamp)
         if buf_decomp is None:
             return (status, None, None, None)
 
@@ -145,7 +149,65 @@ class RohcDecompressor(object):
         if status != ROHC_STATUS_OK:
             return (status, None, None, None)
 
-        return (status, self._buf1[:buf_decomp.len], \
-                self._buf2[:buf_feedback_recv.len], \
-                self._buf3[:buf_feedback_to_send.len])
+        if out is None:
+            decomp_pkt = bytes(self._buf1[:buf_decomp.len])
+        else:
+            decomp_pkt = memoryview(out)[:buf_decomp.len]
+        return (status, decomp_pkt, \
+                bytes(self._buf2[:buf_feedback_recv.len]), \
+                bytes(self._buf3[:buf_feedback_to_send.len]))
+
+    def decompress_many(self, comp_pkts, headroom=0):
+        """ Decompress the given compressed ROHC packets in one single batch
+
+        The Python GIL is released while the packets are decompressed, the
+        decompressor shall not be used by other threads in the meantime.
+
+        Keyword arguments:
+        comp_pkts -- the sequence of compressed ROHC packets (bytes, bytearray,
+                     memoryview or any object that supports the buffer
+                     protocol)
+        headroom  -- the room for the uncompressed headers of every packet in
+                     bytes, 0 for the default room
+
+        Return tuple:
+        results          -- the list of (status, decomp_pkt) tuples of the
+                            packets, decomp_pkt being a memoryview on one
+                            output buffer shared by all the decompressed
+                            packets or None wrt status
+        feedback_recv    -- the feedback (memoryview) received with the
+                            compressed packets
+        feedback_to_send -- the feedback (memoryview) to send with the
+                            associated compressor
+        """
+
+        return rohc_decomp_decompress_many(self.decomp, comp_pkts, headroom)
+
+    def decompress_pcap(self, filename):
+        """ Decompress all the packets of the given PCAP capture
+
+        The capture is read and decompressed in C with one single call, the
+        Python GIL being released in the meantime. The decompressor shall not
+        be used by other threads in the meantime. No feedback is sent nor
+        received. Only the classic PCAP format is read, see pcap.py for
+        PCAP-NG captures.
+
+        Keyword arguments:
+        filename -- the path to the PCAP capture of ROHC packets
+
+        Return the dictionary of statistics:
+        packets      -- the number of packets in the capture
+        ok           -- the number of packets successfully decompressed
+        errors       -- the number of packets that failed to be decompressed
+        comp_bytes   -- the number of bytes of all the ROHC packets
+        decomp_bytes -- the number of bytes of the decompressed packets
+        status       -- the ROHC_STATUS_* of every packet
+        packet_types -- the ROHC_PACKET_* of every packet
+        comp_sizes   -- the size of every ROHC packet
+        decomp_sizes -- the size of every decompressed packet
+        The per-packet values are memoryviews of C integers that
+        numpy.frombuffer() or array.array may use without copy.
+        """
+
+        return rohc_decomp_decompress_pcap(self.decomp, filename)
 
@@ -178,6 +178,33 @@ if verbose_level == 0:
     print()
 print("all %i packets were successfully compressed" % pkts_nr)
 
+# compress/decompress the packets again, in one single batch with a new
+# compressor/decompressor pair
+print("compress/decompress the packets again in one batch")
+comp = RohcCompressor(cid_type=ROHC_LARGE_CID, profiles=[ROHC_PROFILE_RTP], \
+        verbose=verbose_rohc)
+decomp = RohcDecompressor(cid_type=ROHC_LARGE_CID, profiles=[ROHC_PROFILE_RTP], \
+        verbose=verbose_rohc)
+comp_results = comp.compress_many(uncomp_pkts)
+if len(comp_results) != len(uncomp_pkts):
+    print("failed to compress the batch of packets")
+    sys.exit(1)
+for (status, _) in comp_results:
+    if status != ROHC_STATUS_OK:
+        print("failed to compress packet: %s (%i)" % (rohc_strerror(status), status))
+        sys.exit(1)
+(decomp_results, _, _) = \
+    decomp.decompress_many([comp_pkt for (_, comp_pkt) in comp_results])
+for (uncomp_pkt, (status, decomp_pkt)) in zip(uncomp_pkts, decomp_results):
+    if status != ROHC_STATUS_OK:
+        print("failed to decompress packet: %s (%i)" \
+              % (rohc_strerror(status), status))
+        sys.exit(1)
+    if decomp_pkt != uncomp_pkt:
+        print("decompressed packet does not match original packet")
+        sys.exit(1)
+print("all %i packets were successfully compressed in one batch" % pkts_nr)
+
 gain = uncomp_len - comp_len
 gain_percent = 100 - comp_len * 100 / uncomp_len
 if gain == 0:
@@ -58,9 +58,21 @@
    }
 };
 
-%typemap(in) (uint8_t *data, size_t max_len) %{
-   $1 = PyBytes_AsString($input);
-   $2 = PyBytes_Size($input);
+/* any object that supports the buffer protocol may back a rohc_buf without
+ * copy, eg. bytes, bytearray or memoryview; the object shall outlive the
+ * rohc_buf and shall not be resized in the meantime */
+%typemap(in) (uint8_t *data, size_t max_len) (Py_buffer view) %{
+   if(PyObject_GetBuffer($input, &view, PyBUF_WRITABLE) != 0)
+   {
+      PyErr_Clear();
+      if(PyObject_GetBuffer($input, &view, PyBUF_SIMPLE) != 0)
+      {
+         SWIG_fail;
+      }
+   }
+   $1 = view.buf;
+   $2 = view.len;
+   PyBuffer_Release(&view);
 %}
 %include "rohc/rohc_buf.h"
 %extend rohc_buf
@@ -56,5 +56,942 @@ bool rohc_comp_add_rtp_port(const unsigned int new_port)
 }
 
 
+/** The room for the ROHC headers of every packet compressed in batch */
+#define ROHC_COMP_MANY_HEADROOM 512U
+
+/** The room for the uncompressed headers of every packet decompressed in batch */
+#define ROHC_DECOMP_MANY_HEADROOM 2048U
+
+/** The maximum length of the feedback produced by a batch decompression */
+#define ROHC_DECOMP_MANY_FEEDBACK_MAX_LEN 0xffffU
+
+
+/**
+ * @brief Get a memoryview on the given packet of one output buffer
+ *
+ * @param output_view  The memoryview on the whole output buffer
+ * @param output_data  The beginning of the output buffer
+ * @param packet       The packet written in the output buffer
+ * @return             The memoryview on the packet, NULL in case of error
+ */
+static PyObject * rohc_many_view(PyObject *const output_view,
+                                 const uint8_t *const output_data,
+                                 const struct rohc_buf packet)
+{
+	const Py_ssize_t offset = rohc_buf_data(packet) - output_data;
+	PyObject *start;
+	PyObject *stop;
+	PyObject *slice = NULL;
+	PyObject *view = NULL;
+
+	start = PyLong_FromSsize_t(offset);
+	stop = PyLong_FromSsize_t(offset + packet.len);
+	if(start != NULL && stop != NULL)
+	{
+		slice = PySlice_New(start, stop, NULL);
+	}
+	Py_XDECREF(start);
+	Py_XDECREF(stop);
+	if(slice != NULL)
+	{
+		view = PyObject_GetItem(output_view, slice);
+		Py_DECREF(slice);
+	}
+
+	return view;
+}
+
+
+/**
+ * @brief Get the results of the packets of one output buffer
+ *
+ * @param output_view  The memoryview on the whole output buffer
+ * @param output_data  The beginning of the output buffer
+ * @param packets      The packets written in the output buffer
+ * @param status       The status of every packet
+ * @param packets_nr   The number of packets
+ * @return             The list of (status, packet) tuples, packet being a
+ *                     memoryview on the output buffer or None if the status
+ *                     is not ROHC_STATUS_OK, NULL in case of error
+ */
+static PyObject * rohc_many_results(PyObject *const output_view,
+                                    const uint8_t *const output_data,
+                                    const struct rohc_buf packets[],
+                                    const rohc_status_t status[],
+                                    const size_t packets_nr)
+{
+	PyObject *results;
+	size_t i;
+
+	results = PyList_New(packets_nr);
+	if(results == NULL)
+	{
+		goto error;
+	}
+
+	for(i = 0; i < packets_nr; i++)
+	{
+		PyObject *packet;
+		PyObject *result;
+
+		if(status[i] == ROHC_STATUS_OK)
+		{
+			packet = rohc_many_view(output_view, output_data, packets[i]);
+			if(packet == NULL)
+			{
+				goto free_results;
+			}
+		}
+		else
+		{
+			Py_INCREF(Py_None);
+			packet = Py_None;
+		}
+		result = Py_BuildValue("(iN)", status[i], packet);
+		if(result == NULL)
+		{
+			goto free_results;
+		}
+		PyList_SET_ITEM(results, i, result);
+	}
+
+	return results;
+
+free_results:
+	Py_DECREF(results);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Get the buffers of the given Python packets without copying them
+ *
+ * @param packets        The sequence of objects that support the buffer
+ *                       protocol, eg. bytes, bytearray or memoryview
+ * @param[out] views     The buffer views, to be released by the caller
+ * @param[out] views_nr  The number of buffer views got
+ * @return               true if all the buffers were got, false otherwise
+ */
+static bool rohc_many_get_buffers(PyObject *const packets,
+                                  Py_buffer views[],
+                                  size_t *const views_nr)
+{
+	const size_t packets_nr = PySequence_Fast_GET_SIZE(packets);
+
+	for(*views_nr = 0; (*views_nr) < packets_nr; (*views_nr)++)
+	{
+		PyObject *const packet = PySequence_Fast_GET_ITEM(packets, *views_nr);
+		if(PyObject_GetBuffer(packet, &views[*views_nr], PyBUF_SIMPLE) != 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Compress a batch of packets
+ *
+ * The packets are compressed by one call to rohc_compress_burst() without
+ * the Python GIL, so that other Python threads may run in the meantime. The
+ * compressor shall not be used by other threads at the same time.
+ *
+ * The uncompressed packets are not copied. The ROHC packets are written in
+ * one single bytearray and returned as memoryviews on it.
+ *
+ * @param comp      The ROHC compressor
+ * @param packets   The sequence of uncompressed packets, every packet is an
+ *                  object that supports the buffer protocol
+ * @param headroom  The room for the ROHC headers of every packet, 0 for the
+ *                  default room
+ * @return          The list of (status, ROHC packet) tuples of the packets
+ *                  that were handled, NULL in case of error. The list is
+ *                  shorter than the batch if one packet requires ROHC
+ *                  segmentation, the next packets shall be given again.
+ */
+PyObject * rohc_comp_compress_many(struct rohc_comp *const comp,
+                                   PyObject *const packets,
+                                   const size_t headroom)
+{
+	const size_t room = (headroom == 0 ? ROHC_COMP_MANY_HEADROOM : headroom);
+	struct rohc_buf *uncomp_packets = NULL;
+	struct rohc_buf *rohc_packets = NULL;
+	rohc_status_t *status = NULL;
+	Py_buffer *views = NULL;
+	size_t views_nr = 0;
+	PyObject *results = NULL;
+	PyObject *output = NULL;
+	PyObject *output_view;
+	PyObject *seq;
+	uint8_t *output_data;
+	size_t output_len = 0;
+	size_t handled_nr;
+	size_t packets_nr;
+	size_t i;
+
+	seq = PySequence_Fast(packets, "packets shall be a sequence of buffers");
+	if(seq == NULL)
+	{
+		goto error;
+	}
+	packets_nr = PySequence_Fast_GET_SIZE(seq);
+
+	views = PyMem_Calloc(packets_nr + 1, sizeof(Py_buffer));
+	uncomp_packets = PyMem_Calloc(packets_nr + 1, sizeof(struct rohc_buf));
+	rohc_packets = PyMem_Calloc(packets_nr + 1, sizeof(struct rohc_buf));
+	status = PyMem_Calloc(packets_nr + 1, sizeof(rohc_status_t));
+	if(views == NULL || uncomp_packets == NULL || rohc_packets == NULL ||
+	   status == NULL)
+	{
+		PyErr_NoMemory();
+		goto free_arrays;
+	}
+
+	/* the uncompressed packets are used in place */
+	if(!rohc_many_get_buffers(seq, views, &views_nr))
+	{
+		goto release_views;
+	}
+	for(i = 0; i < packets_nr; i++)
+	{
+		uncomp_packets[i].data = views[i].buf;
+		uncomp_packets[i].max_len = views[i].len;
+		uncomp_packets[i].len = views[i].len;
+		output_len += views[i].len + room;
+	}
+
+	/* the ROHC packets are written in one single output buffer */
+	output = PyByteArray_FromStringAndSize(NULL, output_len);
+	if(output == NULL)
+	{
+		goto release_views;
+	}
+	output_data = (uint8_t *) PyByteArray_AS_STRING(output);
+	for(i = 0; i < packets_nr; i++)
+	{
+		rohc_packets[i].data = output_data;
+		rohc_packets[i].max_len = views[i].len + room;
+		output_data += rohc_packets[i].max_len;
+	}
+
+	Py_BEGIN_ALLOW_THREADS
+	handled_nr = rohc_compress_burst(comp, uncomp_packets, rohc_packets, status,
+	                                 packets_nr);
+	Py_END_ALLOW_THREADS
+
+	output_view = PyMemoryView_FromObject(output);
+	if(output_view != NULL)
+	{
+		results = rohc_many_results(output_view,
+		                            (uint8_t *) PyByteArray_AS_STRING(output),
+		                            rohc_packets, status, handled_nr);
+		Py_DECREF(output_view);
+	}
+
+	Py_DECREF(output);
+release_views:
+	for(i = 0; i < views_nr; i++)
+	{
+		PyBuffer_Release(&views[i]);
+	}
+free_arrays:
+	PyMem_Free(status);
+	PyMem_Free(rohc_packets);
+	PyMem_Free(uncomp_packets);
+	PyMem_Free(views);
+	Py_DECREF(seq);
+error:
+	return results;
+}
+
+
+/**
+ * @brief Decompress a batch of ROHC packets
+ *
+ * The packets are decompressed by one call to rohc_decompress_burst()
+ * without the Python GIL, so that other Python threads may run in the
+ * meantime. The decompressor shall not be used by other threads at the same
+ * time.
+ *
+ * The ROHC packets are not copied. The decompressed packets are written in
+ * one single bytearray and returned as memoryviews on it.
+ *
+ * @param decomp    The ROHC decompressor
+ * @param packets   The sequence of ROHC packets, every packet is an object
+ *                  that supports the buffer protocol
+ * @param headroom  The room for the uncompressed headers of every packet, 0
+ *                  for the default room
+ * @return          The (results, feedback_recv, feedback_to_send) tuple with
+ *                  the list of (status, decompressed packet) tuples of the
+ *                  packets, the feedback received with the ROHC packets and
+ *                  the feedback to send with the associated compressor,
+ *                  NULL in case of error
+ */
+PyObject * rohc_decomp_decompress_many(struct rohc_decomp *const decomp,
+                                       PyObject *const packets,
+                                       const size_t headroom)
+{
+	const size_t room = (headroom == 0 ? ROHC_DECOMP_MANY_HEADROOM : headroom);
+	struct rohc_buf *uncomp_packets = NULL;
+	struct rohc_buf *rohc_packets = NULL;
+	struct rohc_buf rcvd_feedback;
+	struct rohc_buf feedback_send;
+	rohc_status_t *status = NULL;
+	Py_buffer *views = NULL;
+	size_t views_nr = 0;
+	PyObject *results = NULL;
+	PyObject *output = NULL;
+	PyObject *output_view;
+	PyObject *list;
+	PyObject *feedback_recv_view;
+	PyObject *feedback_send_view;
+	PyObject *seq;
+	uint8_t *output_data;
+	size_t output_len = 0;
+	size_t rohc_len = 0;
+	size_t handled_nr;
+	size_t packets_nr;
+	size_t i;
+
+	seq = PySequence_Fast(packets, "packets shall be a sequence of buffers");
+	if(seq == NULL)
+	{
+		goto error;
+	}
+	packets_nr = PySequence_Fast_GET_SIZE(seq);
+
+	views = PyMem_Calloc(packets_nr + 1, sizeof(Py_buffer));
+	uncomp_packets = PyMem_Calloc(packets_nr + 1, sizeof(struct rohc_buf));
+	rohc_packets = PyMem_Calloc(packets_nr + 1, sizeof(struct rohc_buf));
+	status = PyMem_Calloc(packets_nr + 1, sizeof(rohc_status_t));
+	if(views == NULL || uncomp_packets == NULL || rohc_packets == NULL ||
+	   status == NULL)
+	{
+		PyErr_NoMemory();
+		goto free_arrays;
+	}
+
+	/* the ROHC packets are used in place */
+	if(!rohc_many_get_buffers(seq, views, &views_nr))
+	{
+		goto release_views;
+	}
+	for(i = 0; i < packets_nr; i++)
+	{
+		rohc_packets[i].data = views[i].buf;
+		rohc_packets[i].max_len = views[i].len;
+		rohc_packets[i].len = views[i].len;
+		rohc_len += views[i].len;
+		output_len += views[i].len + room;
+	}
+
+	/* the decompressed packets and the feedbacks are written in one single
+	 * output buffer: the received feedback cannot be larger than the ROHC
+	 * packets */
+	output = PyByteArray_FromStringAndSize(NULL, output_len + rohc_len +
+	                                       ROHC_DECOMP_MANY_FEEDBACK_MAX_LEN);
+	if(output == NULL)
+	{
+		goto release_views;
+	}
+	output_data = (uint8_t *) PyByteArray_AS_STRING(output);
+	for(i = 0; i < packets_nr; i++)
+	{
+		uncomp_packets[i].data = output_data;
+		uncomp_packets[i].max_len = views[i].len + room;
+		output_data += uncomp_packets[i].max_len;
+	}
+	memset(&rcvd_feedback, 0, sizeof(struct rohc_buf));
+	rcvd_feedback.data = output_data;
+	rcvd_feedback.max_len = rohc_len;
+	output_data += rcvd_feedback.max_len;
+	memset(&feedback_send, 0, sizeof(struct rohc_buf));
+	feedback_send.data = output_data;
+	feedback_send.max_len = ROHC_DECOMP_MANY_FEEDBACK_MAX_LEN;
+
+	Py_BEGIN_ALLOW_THREADS
+	handled_nr = rohc_decompress_burst(decomp, rohc_packets, uncomp_packets,
+	                                   status, packets_nr, &rcvd_feedback,
+	                                   &feedback_send);
+	Py_END_ALLOW_THREADS
+
+	output_view = PyMemoryView_FromObject(output);
+	if(output_view == NULL)
+	{
+		goto free_output;
+	}
+	output_data = (uint8_t *) PyByteArray_AS_STRING(output);
+	list = rohc_many_results(output_view, output_data, uncomp_packets, status,
+	                         handled_nr);
+	feedback_recv_view = rohc_many_view(output_view, output_data, rcvd_feedback);
+	feedback_send_view = rohc_many_view(output_view, output_data, feedback_send);
+	if(list != NULL && feedback_recv_view != NULL && feedback_send_view != NULL)
+	{
+		results = PyTuple_Pack(3, list, feedback_recv_view, feedback_send_view);
+	}
+	Py_XDECREF(feedback_send_view);
+	Py_XDECREF(feedback_recv_view);
+	Py_XDECREF(list);
+	Py_DECREF(output_view);
+free_output:
+	Py_DECREF(output);
+release_views:
+	for(i = 0; i < views_nr; i++)
+	{
+		PyBuffer_Release(&views[i]);
+	}
+free_arrays:
+	PyMem_Free(status);
+	PyMem_Free(rohc_packets);
+	PyMem_Free(uncomp_packets);
+	PyMem_Free(views);
+	Py_DECREF(seq);
+error:
+	return results;
+}
+
+
+/** The maximum length of the packets read from PCAP captures */
+#define ROHC_PCAP_PKT_MAX_LEN 0xffffU
+
+/** The room for the headers of every packet written in a PCAP loop */
+#define ROHC_PCAP_HEADROOM 2048U
+
+/** The length of the Ethernet header */
+#define ROHC_PCAP_ETHER_HDR_LEN 14U
+
+/** The minimal length of Ethernet frames, padding included */
+#define ROHC_PCAP_ETHER_FRAME_MIN_LEN 60U
+
+
+/** A PCAP capture read without the Python glue */
+struct rohc_pcap
+{
+	FILE *file;          /**< The PCAP file */
+	bool is_swapped;     /**< Whether the PCAP fields shall be byte-swapped */
+	bool is_nsec;        /**< Whether timestamps are in nanoseconds */
+	size_t link_len;     /**< The length of the link layer header */
+	bool is_ethernet;    /**< Whether the link layer is Ethernet */
+};
+
+
+/** The results of every packet of one PCAP capture */
+struct rohc_pcap_results
+{
+	int *status;              /**< The status of every packet */
+	int *packet_types;        /**< The ROHC packet type of every packet */
+	unsigned int *in_sizes;   /**< The input size of every packet */
+	unsigned int *out_sizes;  /**< The output size of every packet */
+	size_t nr;                /**< The number of packets */
+	size_t max_nr;            /**< The room in the arrays */
+	size_t ok_nr;             /**< The number of packets handled successfully */
+	unsigned long long in_bytes;   /**< The number of input bytes */
+	unsigned long long out_bytes;  /**< The number of output bytes */
+};
+
+
+/**
+ * @brief Swap the bytes of a 32-bit PCAP field if required
+ *
+ * @param pcap   The PCAP capture
+ * @param value  The field as read in the capture
+ * @return       The field in host byte order
+ */
+static uint32_t rohc_pcap_u32(const struct rohc_pcap *const pcap,
+                              const uint32_t value)
+{
+	return (pcap->is_swapped ? __builtin_bswap32(value) : value);
+}
+
+
+/**
+ * @brief Open a PCAP capture
+ *
+ * Only the classic PCAP format is read, not the PCAP-NG one. The Ethernet,
+ * raw IP, IPv4 and IPv6 link layers are handled, as in pcap.py.
+ *
+ * @param filename   The path to the PCAP capture
+ * @param[out] pcap  The opened PCAP capture
+ * @return           true if the capture was opened, false with a Python
+ *                   exception otherwise
+ */
+static bool rohc_pcap_open(const char *const filename,
+                           struct rohc_pcap *const pcap)
+{
+	uint32_t hdr[6];
+	uint32_t link_type;
+
+	pcap->file = fopen(filename, "rb");
+	if(pcap->file == NULL)
+	{
+		PyErr_SetFromErrnoWithFilename(PyExc_IOError, filename);
+		goto error;
+	}
+	if(fread(hdr, sizeof(hdr), 1, pcap->file) != 1)
+	{
+		PyErr_Format(PyExc_ValueError, "%s: file too small for PCAP", filename);
+		goto close_file;
+	}
+
+	/* magic number, microsecond or nanosecond timestamps */
+	switch(hdr[0])
+	{
+		case 0xa1b2c3d4:
+		case 0xd4c3b2a1:
+			pcap->is_nsec = false;
+			break;
+		case 0xa1b23c4d:
+		case 0x4d3cb2a1:
+			pcap->is_nsec = true;
+			break;
+		default:
+			PyErr_Format(PyExc_ValueError, "%s: not a PCAP file (PCAP-NG files "
+			             "shall be read with pcap.py)", filename);
+			goto close_file;
+	}
+	pcap->is_swapped = (hdr[0] == 0xd4c3b2a1 || hdr[0] == 0x4d3cb2a1);
+
+	/* link layer */
+	link_type = rohc_pcap_u32(pcap, hdr[5]);
+	switch(link_type)
+	{
+		case 1: /* Ethernet */
+			pcap->link_len = ROHC_PCAP_ETHER_HDR_LEN;
+			pcap->is_ethernet = true;
+			break;
+		case 12:  /* raw IP */
+		case 101: /* IPv4 */
+		case 31:  /* IPv6 */
+			pcap->link_len = 0;
+			pcap->is_ethernet = false;
+			break;
+		default:
+			PyErr_Format(PyExc_ValueError, "%s: unknown PCAP link type %u",
+			             filename, link_type);
+			goto close_file;
+	}
+
+	return true;
+
+close_file:
+	fclose(pcap->file);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Read the next packet of a PCAP capture
+ *
+ * The link layer header is skipped. The padding of the short Ethernet
+ * frames is removed according to the length of the IP packet, as in
+ * test_non_regression.py.
+ *
+ * The function does not require the Python GIL.
+ *
+ * @param pcap         The PCAP capture
+ * @param[out] packet  The packet, its data shall be large enough for
+ *                     \ref ROHC_PCAP_PKT_MAX_LEN bytes
+ * @return             1 if one packet was read,
+ *                     0 at the end of the capture,
+ *                     -1 if the capture is malformed
+ */
+static int rohc_pcap_next(const struct rohc_pcap *const pcap,
+                          struct rohc_buf *const packet)
+{
+	uint32_t hdr[4];
+	size_t len;
+
+	if(fread(hdr, sizeof(hdr), 1, pcap->file) != 1)
+	{
+		return (feof(pcap->file) ? 0 : -1);
+	}
+	len = rohc_pcap_u32(pcap, hdr[2]);
+	if(len < pcap->link_len || len > ROHC_PCAP_PKT_MAX_LEN ||
+	   fread(packet->data, 1, len, pcap->file) != len)
+	{
+		return -1;
+	}
+
+	packet->time.sec = rohc_pcap_u32(pcap, hdr[0]);
+	packet->time.nsec = rohc_pcap_u32(pcap, hdr[1]) * (pcap->is_nsec ? 1 : 1000);
+	packet->offset = pcap->link_len;
+	packet->len = len - pcap->link_len;
+
+	if(pcap->is_ethernet &&
+	   len == ROHC_PCAP_ETHER_FRAME_MIN_LEN && packet->len >= 6)
+	{
+		const uint8_t *const ip = rohc_buf_data(*packet);
+		size_t ip_len = packet->len;
+
+		if((ip[0] >> 4) == 4)
+		{
+			ip_len = (ip[2] << 8) + ip[3];
+		}
+		else if((ip[0] >> 4) == 6)
+		{
+			ip_len = 40 + (ip[4] << 8) + ip[5];
+		}
+		if(ip_len < packet->len)
+		{
+			packet->len = ip_len;
+		}
+	}
+
+	return 1;
+}
+
+
+/**
+ * @brief Record the result of one packet of a PCAP capture
+ *
+ * The function does not require the Python GIL.
+ *
+ * @param results      The results of the capture
+ * @param status       The status of the packet
+ * @param packet_type  The ROHC packet type of the packet
+ * @param in_size      The input size of the packet
+ * @param out_size     The output size of the packet, 0 if not handled
+ * @return             true if the result was recorded,
+ *                     false if memory is missing
+ */
+static bool rohc_pcap_results_add(struct rohc_pcap_results *const results,
+                                  const rohc_status_t status,
+                                  const rohc_packet_t packet_type,
+                                  const size_t in_size,
+                                  const size_t out_size)
+{
+	if(results->nr == results->max_nr)
+	{
+		const size_t max_nr = (results->max_nr == 0 ? 1024 : results->max_nr * 2);
+		int *status_arr;
+		int *types_arr;
+		unsigned int *in_arr;
+		unsigned int *out_arr;
+
+		status_arr = PyMem_RawRealloc(results->status, max_nr * sizeof(int));
+		if(status_arr == NULL)
+		{
+			return false;
+		}
+		results->status = status_arr;
+		types_arr = PyMem_RawRealloc(results->packet_types, max_nr * sizeof(int));
+		if(types_arr == NULL)
+		{
+			return false;
+		}
+		results->packet_types = types_arr;
+		in_arr = PyMem_RawRealloc(results->in_sizes, max_nr * sizeof(unsigned int));
+		if(in_arr == NULL)
+		{
+			return false;
+		}
+		results->in_sizes = in_arr;
+		out_arr = PyMem_RawRealloc(results->out_sizes, max_nr * sizeof(unsigned int));
+		if(out_arr == NULL)
+		{
+			return false;
+		}
+		results->out_sizes = out_arr;
+		results->max_nr = max_nr;
+	}
+
+	results->status[results->nr] = status;
+	results->packet_types[results->nr] = packet_type;
+	results->in_sizes[results->nr] = in_size;
+	results->out_sizes[results->nr] = out_size;
+	results->nr++;
+	results->in_bytes += in_size;
+	if(status == ROHC_STATUS_OK)
+	{
+		results->out_bytes += out_size;
+		results->ok_nr++;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Free the arrays of the results of a PCAP capture
+ *
+ * @param results  The results of the capture
+ */
+static void rohc_pcap_results_free(struct rohc_pcap_results *const results)
+{
+	PyMem_RawFree(results->out_sizes);
+	PyMem_RawFree(results->in_sizes);
+	PyMem_RawFree(results->packet_types);
+	PyMem_RawFree(results->status);
+}
+
+
+/**
+ * @brief Get one array of the results of a PCAP capture for Python
+ *
+ * @param array   The array of values
+ * @param nr      The number of values
+ * @param format  The struct format of the values, "i" or "I"
+ * @return        The memoryview on a copy of the values, usable as is by
+ *                numpy.frombuffer() or array.array, NULL in case of error
+ */
+static PyObject * rohc_pcap_array(const void *const array,
+                                  const size_t nr,
+                                  const char *const format)
+{
+	PyObject *bytes;
+	PyObject *view;
+	PyObject *cast = NULL;
+
+	bytes = PyBytes_FromStringAndSize(array, nr * sizeof(int));
+	if(bytes == NULL)
+	{
+		goto error;
+	}
+	view = PyMemoryView_FromObject(bytes);
+	Py_DECREF(bytes);
+	if(view == NULL)
+	{
+		goto error;
+	}
+	cast = PyObject_CallMethod(view, "cast", "s", format);
+	Py_DECREF(view);
+
+error:
+	return cast;
+}
+
+
+/**
+ * @brief Get the results of a PCAP capture for Python
+ *
+ * @param results   The results of the capture
+ * @param in_name   The name of the input packets, eg. "uncomp" or "comp"
+ * @param out_name  The name of the output packets, eg. "comp" or "decomp"
+ * @return          The dictionary of statistics and per-packet arrays,
+ *                  NULL in case of error
+ */
+static PyObject * rohc_pcap_results_dict(const struct rohc_pcap_results *const results,
+                                         const char *const in_name,
+                                         const char *const out_name)
+{
+	char in_bytes_key[32];
+	char out_bytes_key[32];
+	char in_sizes_key[32];
+	char out_sizes_key[32];
+
+	snprintf(in_bytes_key, sizeof(in_bytes_key), "%s_bytes", in_name);
+	snprintf(out_bytes_key, sizeof(out_bytes_key), "%s_bytes", out_name);
+	snprintf(in_sizes_key, sizeof(in_sizes_key), "%s_sizes", in_name);
+	snprintf(out_sizes_key, sizeof(out_sizes_key), "%s_sizes", out_name);
+
+	return Py_BuildValue("{s:n,s:n,s:n,s:K,s:K,s:N,s:N,s:N,s:N}",
+	                     "packets", (Py_ssize_t) results->nr,
+	                     "ok", (Py_ssize_t) results->ok_nr,
+	                     "errors", (Py_ssize_t) (results->nr - results->ok_nr),
+	                     in_bytes_key, results->in_bytes,
+	                     out_bytes_key, results->out_bytes,
+	                     "status",
+	                     rohc_pcap_array(results->status, results->nr, "i"),
+	                     "packet_types",
+	                     rohc_pcap_array(results->packet_types, results->nr, "i"),
+	                     in_sizes_key,
+	                     rohc_pcap_array(results->in_sizes, results->nr, "I"),
+	                     out_sizes_key,
+	                     rohc_pcap_array(results->out_sizes, results->nr, "I"));
+}
+
+
+/**
+ * @brief Compress all the packets of a PCAP capture
+ *
+ * The capture is read and every packet is compressed in C without the
+ * Python GIL, so that the whole capture costs one single Python call. The
+ * compressor shall not be used by other threads at the same time. The ROHC
+ * packets are not kept, only their sizes and types.
+ *
+ * @param comp      The ROHC compressor
+ * @param filename  The path to the PCAP capture of uncompressed packets
+ * @return          The dictionary with the number of packets ('packets',
+ *                  'ok' and 'errors'), the number of bytes ('uncomp_bytes'
+ *                  and 'comp_bytes' for the successful packets) and the
+ *                  per-packet arrays ('status', 'packet_types',
+ *                  'uncomp_sizes' and 'comp_sizes') as memoryviews of C
+ *                  integers, NULL in case of error
+ */
+PyObject * rohc_comp_compress_pcap(struct rohc_comp *const comp,
+                                   const char *const filename)
+{
+	struct rohc_pcap_results results;
+	struct rohc_pcap pcap;
+	uint8_t *buffers = NULL;
+	PyObject *dict = NULL;
+	bool is_nomem = false;
+	int ret = 0;
+
+	memset(&results, 0, sizeof(struct rohc_pcap_results));
+
+	if(!rohc_pcap_open(filename, &pcap))
+	{
+		goto error;
+	}
+	buffers = PyMem_Malloc(ROHC_PCAP_PKT_MAX_LEN * 2 + ROHC_PCAP_HEADROOM);
+	if(buffers == NULL)
+	{
+		PyErr_NoMemory();
+		goto close_pcap;
+	}
+
+	Py_BEGIN_ALLOW_THREADS
+	while(!is_nomem)
+	{
+		struct rohc_buf uncomp_packet =
+			rohc_buf_init_empty(buffers, ROHC_PCAP_PKT_MAX_LEN);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(buffers + ROHC_PCAP_PKT_MAX_LEN,
+			                    ROHC_PCAP_PKT_MAX_LEN + ROHC_PCAP_HEADROOM);
+		rohc_comp_last_packet_info2_t info;
+		rohc_status_t status;
+
+		ret = rohc_pcap_next(&pcap, &uncomp_packet);
+		if(ret <= 0)
+		{
+			break;
+		}
+
+		status = rohc_compress4(comp, uncomp_packet, &rohc_packet);
+		info.version_major = 0;
+		info.version_minor = 0;
+		if(status != ROHC_STATUS_OK ||
+		   !rohc_comp_get_last_packet_info2(comp, &info))
+		{
+			info.packet_type = ROHC_PACKET_UNKNOWN;
+		}
+		is_nomem = !rohc_pcap_results_add(&results, status, info.packet_type,
+		                                  uncomp_packet.len, rohc_packet.len);
+	}
+	Py_END_ALLOW_THREADS
+
+	if(is_nomem)
+	{
+		PyErr_NoMemory();
+	}
+	else if(ret < 0)
+	{
+		PyErr_Format(PyExc_ValueError, "%s: malformed PCAP packet #%zu",
+		             filename, results.nr + 1);
+	}
+	else
+	{
+		dict = rohc_pcap_results_dict(&results, "uncomp", "comp");
+	}
+
+	PyMem_Free(buffers);
+close_pcap:
+	fclose(pcap.file);
+	rohc_pcap_results_free(&results);
+error:
+	return dict;
+}
+
+
+/**
+ * @brief Decompress all the packets of a PCAP capture
+ *
+ * The capture is read and every packet is decompressed in C without the
+ * Python GIL, so that the whole capture costs one single Python call. The
+ * decompressor shall not be used by other threads at the same time. The
+ * decompressed packets and the feedback are not kept, only the sizes and
+ * types of the packets.
+ *
+ * @param decomp    The ROHC decompressor
+ * @param filename  The path to the PCAP capture of ROHC packets
+ * @return          The dictionary with the number of packets ('packets',
+ *                  'ok' and 'errors'), the number of bytes ('comp_bytes'
+ *                  and 'decomp_bytes' for the successful packets) and the
+ *                  per-packet arrays ('status', 'packet_types', 'comp_sizes'
+ *                  and 'decomp_sizes') as memoryviews of C integers, NULL in
+ *                  case of error
+ */
+PyObject * rohc_decomp_decompress_pcap(struct rohc_decomp *const decomp,
+                                       const char *const filename)
+{
+	struct rohc_pcap_results results;
+	struct rohc_pcap pcap;
+	uint8_t *buffers = NULL;
+	PyObject *dict = NULL;
+	bool is_nomem = false;
+	int ret = 0;
+
+	memset(&results, 0, sizeof(struct rohc_pcap_results));
+
+	if(!rohc_pcap_open(filename, &pcap))
+	{
+		goto error;
+	}
+	buffers = PyMem_Malloc(ROHC_PCAP_PKT_MAX_LEN * 2 + ROHC_PCAP_HEADROOM);
+	if(buffers == NULL)
+	{
+		PyErr_NoMemory();
+		goto close_pcap;
+	}
+
+	Py_BEGIN_ALLOW_THREADS
+	while(!is_nomem)
+	{
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(buffers, ROHC_PCAP_PKT_MAX_LEN);
+		struct rohc_buf uncomp_packet =
+			rohc_buf_init_empty(buffers + ROHC_PCAP_PKT_MAX_LEN,
+			                    ROHC_PCAP_PKT_MAX_LEN + ROHC_PCAP_HEADROOM);
+		rohc_decomp_last_packet_info_t info;
+		rohc_status_t status;
+
+		ret = rohc_pcap_next(&pcap, &rohc_packet);
+		if(ret <= 0)
+		{
+			break;
+		}
+
+		status = rohc_decompress3(decomp, rohc_packet, &uncomp_packet,
+		                          NULL, NULL);
+		info.version_major = 0;
+		info.version_minor = 1;
+		if(status != ROHC_STATUS_OK ||
+		   !rohc_decomp_get_last_packet_info(decomp, &info))
+		{
+			info.packet_type = ROHC_PACKET_UNKNOWN;
+		}
+		is_nomem = !rohc_pcap_results_add(&results, status, info.packet_type,
+		                                  rohc_packet.len, uncomp_packet.len);
+	}
+	Py_END_ALLOW_THREADS
+
+	if(is_nomem)
+	{
+		PyErr_NoMemory();
+	}
+	else if(ret < 0)
+	{
+		PyErr_Format(PyExc_ValueError, "%s: malformed PCAP packet #%zu",
+		             filename, results.nr + 1);
+	}
+	else
+	{
+		dict = rohc_pcap_results_dict(&results, "comp", "decomp");
+	}
+
+	PyMem_Free(buffers);
+close_pcap:
+	fclose(pcap.file);
+	rohc_pcap_results_free(&results);
+error:
+	return dict;
+}
+
+
 #endif /* ROHC_HELPERS2_H */
 
@@ -47,11 +47,15 @@ MODULE_DESCRIPTION(PACKAGE_NAME
  */
 
 EXPORT_SYMBOL_GPL(rohc_version);
+EXPORT_SYMBOL_GPL(rohc_get_cpu_features);
 EXPORT_SYMBOL_GPL(rohc_get_mode_descr);
 EXPORT_SYMBOL_GPL(rohc_get_profile_descr);
 EXPORT_SYMBOL_GPL(rohc_get_packet_descr);
 EXPORT_SYMBOL_GPL(rohc_get_ext_descr);
 EXPORT_SYMBOL_GPL(rohc_get_packet_type);
+EXPORT_SYMBOL_GPL(rohc_trace_ring_init);
+EXPORT_SYMBOL_GPL(rohc_trace_ring_read);
+EXPORT_SYMBOL_GPL(rohc_trace_event_get_descr);
 
 EXPORT_SYMBOL_GPL(rohc_buf_is_malformed);
 EXPORT_SYMBOL_GPL(rohc_buf_is_empty);
@@ -72,20 +76,54 @@ EXPORT_SYMBOL_GPL(rohc_buf_reset);
 
 /* general */
 EXPORT_SYMBOL_GPL(rohc_comp_new2);
+EXPORT_SYMBOL_GPL(rohc_comp_new3);
+EXPORT_SYMBOL_GPL(rohc_comp_new_static);
+EXPORT_SYMBOL_GPL(rohc_comp_mem_size);
 EXPORT_SYMBOL_GPL(rohc_comp_free);
 EXPORT_SYMBOL_GPL(rohc_compress4);
+EXPORT_SYMBOL_GPL(rohc_compress_burst);
+EXPORT_SYMBOL_GPL(rohc_compress_burst_hinted);
+EXPORT_SYMBOL_GPL(rohc_compress_hdr);
+EXPORT_SYMBOL_GPL(rohc_compress_hdr_burst);
+EXPORT_SYMBOL_GPL(rohc_compress_hinted);
+EXPORT_SYMBOL_GPL(rohc_compress_inplace);
+EXPORT_SYMBOL_GPL(rohc_comp_predict_size);
 EXPORT_SYMBOL_GPL(rohc_comp_force_contexts_reinit);
+EXPORT_SYMBOL_GPL(rohc_comp_save_contexts);
+EXPORT_SYMBOL_GPL(rohc_comp_restore_contexts);
+EXPORT_SYMBOL_GPL(rohc_comp_move_context);
+EXPORT_SYMBOL_GPL(rohc_comp_provision_context);
+EXPORT_SYMBOL_GPL(rohc_comp_get_store_len);
+EXPORT_SYMBOL_GPL(rohc_comp_sync_store);
+EXPORT_SYMBOL_GPL(rohc_comp_takeover_store);
 
 /* segment */
 EXPORT_SYMBOL_GPL(rohc_comp_get_segment2);
+EXPORT_SYMBOL_GPL(rohc_comp_get_segments);
 
 /* feedback */
 EXPORT_SYMBOL_GPL(rohc_comp_deliver_feedback2);
+EXPORT_SYMBOL_GPL(rohc_comp_deliver_feedbacks);
+EXPORT_SYMBOL_GPL(rohc_comp_enqueue_feedback);
+EXPORT_SYMBOL_GPL(rohc_comp_piggyback_feedback);
+EXPORT_SYMBOL_GPL(rohc_comp_set_piggyback_max_len);
+EXPORT_SYMBOL_GPL(rohc_comp_shards_new);
+EXPORT_SYMBOL_GPL(rohc_comp_shards_free);
+EXPORT_SYMBOL_GPL(rohc_comp_shards_get);
+EXPORT_SYMBOL_GPL(rohc_comp_shards_select);
+EXPORT_SYMBOL_GPL(rohc_comp_shards_select_cid);
+EXPORT_SYMBOL_GPL(rohc_comp_shards_enqueue_feedback);
+EXPORT_SYMBOL_GPL(rohc_comp_engine_new);
+EXPORT_SYMBOL_GPL(rohc_comp_engine_free);
+EXPORT_SYMBOL_GPL(rohc_comp_engine_new_channel);
+EXPORT_SYMBOL_GPL(rohc_comp_engine_get_channels_nr);
 
 /* statistics */
 EXPORT_SYMBOL_GPL(rohc_comp_get_state_descr);
 EXPORT_SYMBOL_GPL(rohc_comp_get_general_info);
+EXPORT_SYMBOL_GPL(rohc_comp_get_contexts);
 EXPORT_SYMBOL_GPL(rohc_comp_get_last_packet_info2);
+EXPORT_SYMBOL_GPL(rohc_comp_get_perf_stats);
 
 /* configuration */
 EXPORT_SYMBOL_GPL(rohc_comp_profile_enabled);
@@ -98,12 +136,40 @@ EXPORT_SYMBOL_GPL(rohc_comp_get_mrru);
 EXPORT_SYMBOL_GPL(rohc_comp_get_max_cid);
 EXPORT_SYMBOL_GPL(rohc_comp_get_cid_type);
 EXPORT_SYMBOL_GPL(rohc_comp_set_wlsb_window_width);
+EXPORT_SYMBOL_GPL(rohc_comp_get_wlsb_window_width);
 EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes);
+EXPORT_SYMBOL_GPL(rohc_comp_get_periodic_refreshes);
+EXPORT_SYMBOL_GPL(rohc_comp_set_periodic_refreshes_time);
+EXPORT_SYMBOL_GPL(rohc_comp_get_periodic_refreshes_time);
+EXPORT_SYMBOL_GPL(rohc_comp_set_ir_pacing);
+EXPORT_SYMBOL_GPL(rohc_comp_set_ctxt_idle_timeout);
+EXPORT_SYMBOL_GPL(rohc_comp_set_closed_ctxt_linger);
+EXPORT_SYMBOL_GPL(rohc_comp_set_mem_budget);
+EXPORT_SYMBOL_GPL(rohc_comp_get_mem_usage);
+EXPORT_SYMBOL_GPL(rohc_comp_set_overload);
+EXPORT_SYMBOL_GPL(rohc_comp_set_load);
+EXPORT_SYMBOL_GPL(rohc_comp_get_cfg);
+EXPORT_SYMBOL_GPL(rohc_comp_publish_cfg);
 EXPORT_SYMBOL_GPL(rohc_comp_set_traces_cb2);
+EXPORT_SYMBOL_GPL(rohc_comp_set_trace_ring);
+EXPORT_SYMBOL_GPL(rohc_comp_set_trace_events);
+EXPORT_SYMBOL_GPL(rohc_comp_trace_filter_add_cid);
+EXPORT_SYMBOL_GPL(rohc_comp_trace_filter_add_profile);
+EXPORT_SYMBOL_GPL(rohc_comp_trace_filter_add_packet_type);
+EXPORT_SYMBOL_GPL(rohc_comp_trace_filter_add_flow);
+EXPORT_SYMBOL_GPL(rohc_comp_trace_filter_clear);
 EXPORT_SYMBOL_GPL(rohc_comp_set_features);
+EXPORT_SYMBOL_GPL(rohc_comp_set_effort);
+EXPORT_SYMBOL_GPL(rohc_comp_set_alloc_cbs);
 
 /* RTP-specific configuration */
+EXPORT_SYMBOL_GPL(rohc_comp_set_priority_cb);
+EXPORT_SYMBOL_GPL(rohc_comp_set_compress_min_priority);
 EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_detection_cb);
+EXPORT_SYMBOL_GPL(rohc_comp_add_rtp_ports);
+EXPORT_SYMBOL_GPL(rohc_comp_remove_rtp_ports);
+EXPORT_SYMBOL_GPL(rohc_comp_reset_rtp_ports);
+EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_ts_timer);
 
 
 /*
@@ -112,14 +178,31 @@ EXPORT_SYMBOL_GPL(rohc_comp_set_rtp_detection_cb);
 
 /* general */
 EXPORT_SYMBOL_GPL(rohc_decomp_new2);
+EXPORT_SYMBOL_GPL(rohc_decomp_new3);
+EXPORT_SYMBOL_GPL(rohc_decomp_new_static);
+EXPORT_SYMBOL_GPL(rohc_decomp_mem_size);
 EXPORT_SYMBOL_GPL(rohc_decomp_free);
 EXPORT_SYMBOL_GPL(rohc_decompress3);
+EXPORT_SYMBOL_GPL(rohc_decompress_burst);
+EXPORT_SYMBOL_GPL(rohc_decompress_inplace);
+EXPORT_SYMBOL_GPL(rohc_decompress_fields);
+EXPORT_SYMBOL_GPL(rohc_decomp_provision_context);
+EXPORT_SYMBOL_GPL(rohc_decomp_shards_new);
+EXPORT_SYMBOL_GPL(rohc_decomp_shards_free);
+EXPORT_SYMBOL_GPL(rohc_decomp_shards_get);
+EXPORT_SYMBOL_GPL(rohc_decomp_shards_select);
+EXPORT_SYMBOL_GPL(rohc_decomp_engine_new);
+EXPORT_SYMBOL_GPL(rohc_decomp_engine_free);
+EXPORT_SYMBOL_GPL(rohc_decomp_engine_new_channel);
+EXPORT_SYMBOL_GPL(rohc_decomp_engine_get_channels_nr);
 
 /* statistics */
 EXPORT_SYMBOL_GPL(rohc_decomp_get_state_descr);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_general_info);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_context_info);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_contexts);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_last_packet_info);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_perf_stats);
 
 /* configuration */
 EXPORT_SYMBOL_GPL(rohc_decomp_profile_enabled);
@@ -133,8 +216,28 @@ EXPORT_SYMBOL_GPL(rohc_decomp_set_mrru);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_mrru);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_rate_limits);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_rate_limits);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_feedback_rates);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_feedback_rates);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_prtt);
 EXPORT_SYMBOL_GPL(rohc_decomp_get_prtt);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_reorder_window);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_reorder_window);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_ctxt_idle_timeout);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_mem_budget);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_mem_usage);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_overload);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_load);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_cfg);
+EXPORT_SYMBOL_GPL(rohc_decomp_publish_cfg);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_traces_cb2);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_trace_ring);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_trace_events);
+EXPORT_SYMBOL_GPL(rohc_decomp_trace_filter_add_cid);
+EXPORT_SYMBOL_GPL(rohc_decomp_trace_filter_add_profile);
+EXPORT_SYMBOL_GPL(rohc_decomp_trace_filter_add_packet_type);
+EXPORT_SYMBOL_GPL(rohc_decomp_trace_filter_clear);
+EXPORT_SYMBOL_GPL(rohc_decomp_get_flight);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_flight_cb);
 EXPORT_SYMBOL_GPL(rohc_decomp_set_features);
+EXPORT_SYMBOL_GPL(rohc_decomp_set_alloc_cbs);
 
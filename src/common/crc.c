@@ -30,6 +30,7 @@
  */
 
 #include "crc.h"
+#include "rohc_cpu.h"
 #include "protocols/ip_numbers.h"
 #include "protocols/ip.h"
 #include "protocols/ipv4.h"
@@ -39,85 +40,823 @@
 #include "protocols/esp.h"
 #include "protocols/tcp.h"
 
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
 #include <stdlib.h>
 #include <assert.h>
 
+#if ROHC_CRC_HAVE_PCLMUL == 1
+#  include <immintrin.h>
+#endif
+#if ROHC_CRC_HAVE_ARM_CRC32 == 1
+#  include <arm_acle.h>
+#endif
+
 
 /**
- * @brief The pre-computed table for 32-bit Frame Check Sequence (FCS)
+ * @brief The pre-computed tables for 32-bit Frame Check Sequence (FCS)
  *
  *   x**0 + x**1 + x**2 + x**4 + x**5 +
  *   x**7 + x**8 + x**10 + x**11 + x**12 + x**16 +
  *   x**22 + x**23 + x**26 + x**32
  *
- * Copied from RFC 1662, appendix C.3
- */
-static const uint32_t crc_table_fcs32[256] =
-{
-	0x00000000, 0x77073096, 0xee0e612c, 0x990951ba,
-	0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3,
-	0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988,
-	0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91,
-	0x1db71064, 0x6ab020f2, 0xf3b97148, 0x84be41de,
-	0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
-	0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec,
-	0x14015c4f, 0x63066cd9, 0xfa0f3d63, 0x8d080df5,
-	0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172,
-	0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b,
-	0x35b5a8fa, 0x42b2986c, 0xdbbbc9d6, 0xacbcf940,
-	0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
-	0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116,
-	0x21b4f4b5, 0x56b3c423, 0xcfba9599, 0xb8bda50f,
-	0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924,
-	0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d,
-	0x76dc4190, 0x01db7106, 0x98d220bc, 0xefd5102a,
-	0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
-	0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818,
-	0x7f6a0dbb, 0x086d3d2d, 0x91646c97, 0xe6635c01,
-	0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e,
-	0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457,
-	0x65b0d9c6, 0x12b7e950, 0x8bbeb8ea, 0xfcb9887c,
-	0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
-	0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2,
-	0x4adfa541, 0x3dd895d7, 0xa4d1c46d, 0xd3d6f4fb,
-	0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0,
-	0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9,
-	0x5005713c, 0x270241aa, 0xbe0b1010, 0xc90c2086,
-	0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
-	0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4,
-	0x59b33d17, 0x2eb40d81, 0xb7bd5c3b, 0xc0ba6cad,
-	0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a,
-	0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683,
-	0xe3630b12, 0x94643b84, 0x0d6d6a3e, 0x7a6a5aa8,
-	0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
-	0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe,
-	0xf762575d, 0x806567cb, 0x196c3671, 0x6e6b06e7,
-	0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc,
-	0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5,
-	0xd6d6a3e8, 0xa1d1937e, 0x38d8c2c4, 0x4fdff252,
-	0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
-	0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60,
-	0xdf60efc3, 0xa867df55, 0x316e8eef, 0x4669be79,
-	0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236,
-	0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f,
-	0xc5ba3bbe, 0xb2bd0b28, 0x2bb45a92, 0x5cb36a04,
-	0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
-	0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a,
-	0x9c0906a9, 0xeb0e363f, 0x72076785, 0x05005713,
-	0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38,
-	0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21,
-	0x86d3d2d4, 0xf1d4e242, 0x68ddb3f8, 0x1fda836e,
-	0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
-	0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c,
-	0x8f659eff, 0xf862ae69, 0x616bffd3, 0x166ccf45,
-	0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2,
-	0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db,
-	0xaed16a4a, 0xd9d65adc, 0x40df0b66, 0x37d83bf0,
-	0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
-	0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6,
-	0xbad03605, 0xcdd70693, 0x54de5729, 0x23d967bf,
-	0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
-	0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
+ * The first table is copied from RFC 1662, appendix C.3. Table n gives the
+ * FCS of one byte followed by n zero bytes, so that 4 bytes may be processed
+ * at once (slicing-by-4).
+ */
+static const uint32_t crc_table_fcs32[4][256] =
+{
+	{
+		0x00000000, 0x77073096, 0xee0e612c, 0x990951ba,
+		0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3,
+		0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988,
+		0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91,
+		0x1db71064, 0x6ab020f2, 0xf3b97148, 0x84be41de,
+		0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
+		0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec,
+		0x14015c4f, 0x63066cd9, 0xfa0f3d63, 0x8d080df5,
+		0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172,
+		0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b,
+		0x35b5a8fa, 0x42b2986c, 0xdbbbc9d6, 0xacbcf940,
+		0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
+		0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116,
+		0x21b4f4b5, 0x56b3c423, 0xcfba9599, 0xb8bda50f,
+		0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924,
+		0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d,
+		0x76dc4190, 0x01db7106, 0x98d220bc, 0xefd5102a,
+		0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
+		0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818,
+		0x7f6a0dbb, 0x086d3d2d, 0x91646c97, 0xe6635c01,
+		0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e,
+		0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457,
+		0x65b0d9c6, 0x12b7e950, 0x8bbeb8ea, 0xfcb9887c,
+		0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
+		0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2,
+		0x4adfa541, 0x3dd895d7, 0xa4d1c46d, 0xd3d6f4fb,
+		0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0,
+		0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9,
+		0x5005713c, 0x270241aa, 0xbe0b1010, 0xc90c2086,
+		0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
+		0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4,
+		0x59b33d17, 0x2eb40d81, 0xb7bd5c3b, 0xc0ba6cad,
+		0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a,
+		0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683,
+		0xe3630b12, 0x94643b84, 0x0d6d6a3e, 0x7a6a5aa8,
+		0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
+		0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe,
+		0xf762575d, 0x806567cb, 0x196c3671, 0x6e6b06e7,
+		0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc,
+		0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5,
+		0xd6d6a3e8, 0xa1d1937e, 0x38d8c2c4, 0x4fdff252,
+		0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
+		0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60,
+		0xdf60efc3, 0xa867df55, 0x316e8eef, 0x4669be79,
+		0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236,
+		0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f,
+		0xc5ba3bbe, 0xb2bd0b28, 0x2bb45a92, 0x5cb36a04,
+		0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
+		0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a,
+		0x9c0906a9, 0xeb0e363f, 0x72076785, 0x05005713,
+		0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38,
+		0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21,
+		0x86d3d2d4, 0xf1d4e242, 0x68ddb3f8, 0x1fda836e,
+		0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
+		0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c,
+		0x8f659eff, 0xf862ae69, 0x616bffd3, 0x166ccf45,
+		0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2,
+		0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db,
+		0xaed16a4a, 0xd9d65adc, 0x40df0b66, 0x37d83bf0,
+		0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
+		0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6,
+		0xbad03605, 0xcdd70693, 0x54de5729, 0x23d967bf,
+		0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94,
+		0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
+	},
+	{
+		0x00000000, 0x191b3141, 0x32366282, 0x2b2d53c3,
+		0x646cc504, 0x7d77f445, 0x565aa786, 0x4f4196c7,
+		0xc8d98a08, 0xd1c2bb49, 0xfaefe88a, 0xe3f4d9cb,
+		0xacb54f0c, 0xb5ae7e4d, 0x9e832d8e, 0x87981ccf,
+		0x4ac21251, 0x53d92310, 0x78f470d3, 0x61ef4192,
+		0x2eaed755, 0x37b5e614, 0x1c98b5d7, 0x05838496,
+		0x821b9859, 0x9b00a918, 0xb02dfadb, 0xa936cb9a,
+		0xe6775d5d, 0xff6c6c1c, 0xd4413fdf, 0xcd5a0e9e,
+		0x958424a2, 0x8c9f15e3, 0xa7b24620, 0xbea97761,
+		0xf1e8e1a6, 0xe8f3d0e7, 0xc3de8324, 0xdac5b265,
+		0x5d5daeaa, 0x44469feb, 0x6f6bcc28, 0x7670fd69,
+		0x39316bae, 0x202a5aef, 0x0b07092c, 0x121c386d,
+		0xdf4636f3, 0xc65d07b2, 0xed705471, 0xf46b6530,
+		0xbb2af3f7, 0xa231c2b6, 0x891c9175, 0x9007a034,
+		0x179fbcfb, 0x0e848dba, 0x25a9de79, 0x3cb2ef38,
+		0x73f379ff, 0x6ae848be, 0x41c51b7d, 0x58de2a3c,
+		0xf0794f05, 0xe9627e44, 0xc24f2d87, 0xdb541cc6,
+		0x94158a01, 0x8d0ebb40, 0xa623e883, 0xbf38d9c2,
+		0x38a0c50d, 0x21bbf44c, 0x0a96a78f, 0x138d96ce,
+		0x5ccc0009, 0x45d73148, 0x6efa628b, 0x77e153ca,
+		0xbabb5d54, 0xa3a06c15, 0x888d3fd6, 0x91960e97,
+		0xded79850, 0xc7cca911, 0xece1fad2, 0xf5facb93,
+		0x7262d75c, 0x6b79e61d, 0x4054b5de, 0x594f849f,
+		0x160e1258, 0x0f152319, 0x243870da, 0x3d23419b,
+		0x65fd6ba7, 0x7ce65ae6, 0x57cb0925, 0x4ed03864,
+		0x0191aea3, 0x188a9fe2, 0x33a7cc21, 0x2abcfd60,
+		0xad24e1af, 0xb43fd0ee, 0x9f12832d, 0x8609b26c,
+		0xc94824ab, 0xd05315ea, 0xfb7e4629, 0xe2657768,
+		0x2f3f79f6, 0x362448b7, 0x1d091b74, 0x04122a35,
+		0x4b53bcf2, 0x52488db3, 0x7965de70, 0x607eef31,
+		0xe7e6f3fe, 0xfefdc2bf, 0xd5d0917c, 0xcccba03d,
+		0x838a36fa, 0x9a9107bb, 0xb1bc5478, 0xa8a76539,
+		0x3b83984b, 0x2298a90a, 0x09b5fac9, 0x10aecb88,
+		0x5fef5d4f, 0x46f46c0e, 0x6dd93fcd, 0x74c20e8c,
+		0xf35a1243, 0xea412302, 0xc16c70c1, 0xd8774180,
+		0x9736d747, 0x8e2de606, 0xa500b5c5, 0xbc1b8484,
+		0x71418a1a, 0x685abb5b, 0x4377e898, 0x5a6cd9d9,
+		0x152d4f1e, 0x0c367e5f, 0x271b2d9c, 0x3e001cdd,
+		0xb9980012, 0xa0833153, 0x8bae6290, 0x92b553d1,
+		0xddf4c516, 0xc4eff457, 0xefc2a794, 0xf6d996d5,
+		0xae07bce9, 0xb71c8da8, 0x9c31de6b, 0x852aef2a,
+		0xca6b79ed, 0xd37048ac, 0xf85d1b6f, 0xe1462a2e,
+		0x66de36e1, 0x7fc507a0, 0x54e85463, 0x4df36522,
+		0x02b2f3e5, 0x1ba9c2a4, 0x30849167, 0x299fa026,
+		0xe4c5aeb8, 0xfdde9ff9, 0xd6f3cc3a, 0xcfe8fd7b,
+		0x80a96bbc, 0x99b25afd, 0xb29f093e, 0xab84387f,
+		0x2c1c24b0, 0x350715f1, 0x1e2a4632, 0x07317773,
+		0x4870e1b4, 0x516bd0f5, 0x7a468336, 0x635db277,
+		0xcbfad74e, 0xd2e1e60f, 0xf9ccb5cc, 0xe0d7848d,
+		0xaf96124a, 0xb68d230b, 0x9da070c8, 0x84bb4189,
+		0x03235d46, 0x1a386c07, 0x31153fc4, 0x280e0e85,
+		0x674f9842, 0x7e54a903, 0x5579fac0, 0x4c62cb81,
+		0x8138c51f, 0x9823f45e, 0xb30ea79d, 0xaa1596dc,
+		0xe554001b, 0xfc4f315a, 0xd7626299, 0xce7953d8,
+		0x49e14f17, 0x50fa7e56, 0x7bd72d95, 0x62cc1cd4,
+		0x2d8d8a13, 0x3496bb52, 0x1fbbe891, 0x06a0d9d0,
+		0x5e7ef3ec, 0x4765c2ad, 0x6c48916e, 0x7553a02f,
+		0x3a1236e8, 0x230907a9, 0x0824546a, 0x113f652b,
+		0x96a779e4, 0x8fbc48a5, 0xa4911b66, 0xbd8a2a27,
+		0xf2cbbce0, 0xebd08da1, 0xc0fdde62, 0xd9e6ef23,
+		0x14bce1bd, 0x0da7d0fc, 0x268a833f, 0x3f91b27e,
+		0x70d024b9, 0x69cb15f8, 0x42e6463b, 0x5bfd777a,
+		0xdc656bb5, 0xc57e5af4, 0xee530937, 0xf7483876,
+		0xb809aeb1, 0xa1129ff0, 0x8a3fcc33, 0x9324fd72
+	},
+	{
+		0x00000000, 0x01c26a37, 0x0384d46e, 0x0246be59,
+		0x0709a8dc, 0x06cbc2eb, 0x048d7cb2, 0x054f1685,
+		0x0e1351b8, 0x0fd13b8f, 0x0d9785d6, 0x0c55efe1,
+		0x091af964, 0x08d89353, 0x0a9e2d0a, 0x0b5c473d,
+		0x1c26a370, 0x1de4c947, 0x1fa2771e, 0x1e601d29,
+		0x1b2f0bac, 0x1aed619b, 0x18abdfc2, 0x1969b5f5,
+		0x1235f2c8, 0x13f798ff, 0x11b126a6, 0x10734c91,
+		0x153c5a14, 0x14fe3023, 0x16b88e7a, 0x177ae44d,
+		0x384d46e0, 0x398f2cd7, 0x3bc9928e, 0x3a0bf8b9,
+		0x3f44ee3c, 0x3e86840b, 0x3cc03a52, 0x3d025065,
+		0x365e1758, 0x379c7d6f, 0x35dac336, 0x3418a901,
+		0x3157bf84, 0x3095d5b3, 0x32d36bea, 0x331101dd,
+		0x246be590, 0x25a98fa7, 0x27ef31fe, 0x262d5bc9,
+		0x23624d4c, 0x22a0277b, 0x20e69922, 0x2124f315,
+		0x2a78b428, 0x2bbade1f, 0x29fc6046, 0x283e0a71,
+		0x2d711cf4, 0x2cb376c3, 0x2ef5c89a, 0x2f37a2ad,
+		0x709a8dc0, 0x7158e7f7, 0x731e59ae, 0x72dc3399,
+		0x7793251c, 0x76514f2b, 0x7417f172, 0x75d59b45,
+		0x7e89dc78, 0x7f4bb64f, 0x7d0d0816, 0x7ccf6221,
+		0x798074a4, 0x78421e93, 0x7a04a0ca, 0x7bc6cafd,
+		0x6cbc2eb0, 0x6d7e4487, 0x6f38fade, 0x6efa90e9,
+		0x6bb5866c, 0x6a77ec5b, 0x68315202, 0x69f33835,
+		0x62af7f08, 0x636d153f, 0x612bab66, 0x60e9c151,
+		0x65a6d7d4, 0x6464bde3, 0x662203ba, 0x67e0698d,
+		0x48d7cb20, 0x4915a117, 0x4b531f4e, 0x4a917579,
+		0x4fde63fc, 0x4e1c09cb, 0x4c5ab792, 0x4d98dda5,
+		0x46c49a98, 0x4706f0af, 0x45404ef6, 0x448224c1,
+		0x41cd3244, 0x400f5873, 0x4249e62a, 0x438b8c1d,
+		0x54f16850, 0x55330267, 0x5775bc3e, 0x56b7d609,
+		0x53f8c08c, 0x523aaabb, 0x507c14e2, 0x51be7ed5,
+		0x5ae239e8, 0x5b2053df, 0x5966ed86, 0x58a487b1,
+		0x5deb9134, 0x5c29fb03, 0x5e6f455a, 0x5fad2f6d,
+		0xe1351b80, 0xe0f771b7, 0xe2b1cfee, 0xe373a5d9,
+		0xe63cb35c, 0xe7fed96b, 0xe5b86732, 0xe47a0d05,
+		0xef264a38, 0xeee4200f, 0xeca29e56, 0xed60f461,
+		0xe82fe2e4, 0xe9ed88d3, 0xebab368a, 0xea695cbd,
+		0xfd13b8f0, 0xfcd1d2c7, 0xfe976c9e, 0xff5506a9,
+		0xfa1a102c, 0xfbd87a1b, 0xf99ec442, 0xf85cae75,
+		0xf300e948, 0xf2c2837f, 0xf0843d26, 0xf1465711,
+		0xf4094194, 0xf5cb2ba3, 0xf78d95fa, 0xf64fffcd,
+		0xd9785d60, 0xd8ba3757, 0xdafc890e, 0xdb3ee339,
+		0xde71f5bc, 0xdfb39f8b, 0xddf521d2, 0xdc374be5,
+		0xd76b0cd8, 0xd6a966ef, 0xd4efd8b6, 0xd52db281,
+		0xd062a404, 0xd1a0ce33, 0xd3e6706a, 0xd2241a5d,
+		0xc55efe10, 0xc49c9427, 0xc6da2a7e, 0xc7184049,
+		0xc25756cc, 0xc3953cfb, 0xc1d382a2, 0xc011e895,
+		0xcb4dafa8, 0xca8fc59f, 0xc8c97bc6, 0xc90b11f1,
+		0xcc440774, 0xcd866d43, 0xcfc0d31a, 0xce02b92d,
+		0x91af9640, 0x906dfc77, 0x922b422e, 0x93e92819,
+		0x96a63e9c, 0x976454ab, 0x9522eaf2, 0x94e080c5,
+		0x9fbcc7f8, 0x9e7eadcf, 0x9c381396, 0x9dfa79a1,
+		0x98b56f24, 0x99770513, 0x9b31bb4a, 0x9af3d17d,
+		0x8d893530, 0x8c4b5f07, 0x8e0de15e, 0x8fcf8b69,
+		0x8a809dec, 0x8b42f7db, 0x89044982, 0x88c623b5,
+		0x839a6488, 0x82580ebf, 0x801eb0e6, 0x81dcdad1,
+		0x8493cc54, 0x8551a663, 0x8717183a, 0x86d5720d,
+		0xa9e2d0a0, 0xa820ba97, 0xaa6604ce, 0xaba46ef9,
+		0xaeeb787c, 0xaf29124b, 0xad6fac12, 0xacadc625,
+		0xa7f18118, 0xa633eb2f, 0xa4755576, 0xa5b73f41,
+		0xa0f829c4, 0xa13a43f3, 0xa37cfdaa, 0xa2be979d,
+		0xb5c473d0, 0xb40619e7, 0xb640a7be, 0xb782cd89,
+		0xb2cddb0c, 0xb30fb13b, 0xb1490f62, 0xb08b6555,
+		0xbbd72268, 0xba15485f, 0xb853f606, 0xb9919c31,
+		0xbcde8ab4, 0xbd1ce083, 0xbf5a5eda, 0xbe9834ed
+	},
+	{
+		0x00000000, 0xb8bc6765, 0xaa09c88b, 0x12b5afee,
+		0x8f629757, 0x37def032, 0x256b5fdc, 0x9dd738b9,
+		0xc5b428ef, 0x7d084f8a, 0x6fbde064, 0xd7018701,
+		0x4ad6bfb8, 0xf26ad8dd, 0xe0df7733, 0x58631056,
+		0x5019579f, 0xe8a530fa, 0xfa109f14, 0x42acf871,
+		0xdf7bc0c8, 0x67c7a7ad, 0x75720843, 0xcdce6f26,
+		0x95ad7f70, 0x2d111815, 0x3fa4b7fb, 0x8718d09e,
+		0x1acfe827, 0xa2738f42, 0xb0c620ac, 0x087a47c9,
+		0xa032af3e, 0x188ec85b, 0x0a3b67b5, 0xb28700d0,
+		0x2f503869, 0x97ec5f0c, 0x8559f0e2, 0x3de59787,
+		0x658687d1, 0xdd3ae0b4, 0xcf8f4f5a, 0x7733283f,
+		0xeae41086, 0x525877e3, 0x40edd80d, 0xf851bf68,
+		0xf02bf8a1, 0x48979fc4, 0x5a22302a, 0xe29e574f,
+		0x7f496ff6, 0xc7f50893, 0xd540a77d, 0x6dfcc018,
+		0x359fd04e, 0x8d23b72b, 0x9f9618c5, 0x272a7fa0,
+		0xbafd4719, 0x0241207c, 0x10f48f92, 0xa848e8f7,
+		0x9b14583d, 0x23a83f58, 0x311d90b6, 0x89a1f7d3,
+		0x1476cf6a, 0xaccaa80f, 0xbe7f07e1, 0x06c36084,
+		0x5ea070d2, 0xe61c17b7, 0xf4a9b859, 0x4c15df3c,
+		0xd1c2e785, 0x697e80e0, 0x7bcb2f0e, 0xc377486b,
+		0xcb0d0fa2, 0x73b168c7, 0x6104c729, 0xd9b8a04c,
+		0x446f98f5, 0xfcd3ff90, 0xee66507e, 0x56da371b,
+		0x0eb9274d, 0xb6054028, 0xa4b0efc6, 0x1c0c88a3,
+		0x81dbb01a, 0x3967d77f, 0x2bd27891, 0x936e1ff4,
+		0x3b26f703, 0x839a9066, 0x912f3f88, 0x299358ed,
+		0xb4446054, 0x0cf80731, 0x1e4da8df, 0xa6f1cfba,
+		0xfe92dfec, 0x462eb889, 0x549b1767, 0xec277002,
+		0x71f048bb, 0xc94c2fde, 0xdbf98030, 0x6345e755,
+		0x6b3fa09c, 0xd383c7f9, 0xc1366817, 0x798a0f72,
+		0xe45d37cb, 0x5ce150ae, 0x4e54ff40, 0xf6e89825,
+		0xae8b8873, 0x1637ef16, 0x048240f8, 0xbc3e279d,
+		0x21e91f24, 0x99557841, 0x8be0d7af, 0x335cb0ca,
+		0xed59b63b, 0x55e5d15e, 0x47507eb0, 0xffec19d5,
+		0x623b216c, 0xda874609, 0xc832e9e7, 0x708e8e82,
+		0x28ed9ed4, 0x9051f9b1, 0x82e4565f, 0x3a58313a,
+		0xa78f0983, 0x1f336ee6, 0x0d86c108, 0xb53aa66d,
+		0xbd40e1a4, 0x05fc86c1, 0x1749292f, 0xaff54e4a,
+		0x322276f3, 0x8a9e1196, 0x982bbe78, 0x2097d91d,
+		0x78f4c94b, 0xc048ae2e, 0xd2fd01c0, 0x6a4166a5,
+		0xf7965e1c, 0x4f2a3979, 0x5d9f9697, 0xe523f1f2,
+		0x4d6b1905, 0xf5d77e60, 0xe762d18e, 0x5fdeb6eb,
+		0xc2098e52, 0x7ab5e937, 0x680046d9, 0xd0bc21bc,
+		0x88df31ea, 0x3063568f, 0x22d6f961, 0x9a6a9e04,
+		0x07bda6bd, 0xbf01c1d8, 0xadb46e36, 0x15080953,
+		0x1d724e9a, 0xa5ce29ff, 0xb77b8611, 0x0fc7e174,
+		0x9210d9cd, 0x2aacbea8, 0x38191146, 0x80a57623,
+		0xd8c66675, 0x607a0110, 0x72cfaefe, 0xca73c99b,
+		0x57a4f122, 0xef189647, 0xfdad39a9, 0x45115ecc,
+		0x764dee06, 0xcef18963, 0xdc44268d, 0x64f841e8,
+		0xf92f7951, 0x41931e34, 0x5326b1da, 0xeb9ad6bf,
+		0xb3f9c6e9, 0x0b45a18c, 0x19f00e62, 0xa14c6907,
+		0x3c9b51be, 0x842736db, 0x96929935, 0x2e2efe50,
+		0x2654b999, 0x9ee8defc, 0x8c5d7112, 0x34e11677,
+		0xa9362ece, 0x118a49ab, 0x033fe645, 0xbb838120,
+		0xe3e09176, 0x5b5cf613, 0x49e959fd, 0xf1553e98,
+		0x6c820621, 0xd43e6144, 0xc68bceaa, 0x7e37a9cf,
+		0xd67f4138, 0x6ec3265d, 0x7c7689b3, 0xc4caeed6,
+		0x591dd66f, 0xe1a1b10a, 0xf3141ee4, 0x4ba87981,
+		0x13cb69d7, 0xab770eb2, 0xb9c2a15c, 0x017ec639,
+		0x9ca9fe80, 0x241599e5, 0x36a0360b, 0x8e1c516e,
+		0x866616a7, 0x3eda71c2, 0x2c6fde2c, 0x94d3b949,
+		0x090481f0, 0xb1b8e695, 0xa30d497b, 0x1bb12e1e,
+		0x43d23e48, 0xfb6e592d, 0xe9dbf6c3, 0x516791a6,
+		0xccb0a91f, 0x740cce7a, 0x66b96194, 0xde0506f1
+	}
+};
+
+
+/**
+ * @brief The pre-computed table for the 3-bit CRC
+ *
+ *   x**0 + x**1 + x**3
+ *
+ * Slice 0 gives the CRC of every byte value, slice n the CRC of every byte
+ * value followed by n zero bytes (see \ref crc_calc_sliced).
+ */
+const uint8_t rohc_crc_table_3[ROHC_CRC_TABLE_LEN] =
+{
+	/* slice 0 */
+	0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+	0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+	0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+	0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+	0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+	0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06,
+	0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+	0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+	0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06,
+	0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+	0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+	0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+	0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+	0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+	0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+	0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+	0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+	0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+	0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06,
+	0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+	0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+	0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+	0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+	0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+	0x05, 0x03, 0x04, 0x02, 0x07, 0x01, 0x06, 0x00,
+	0x01, 0x07, 0x00, 0x06, 0x03, 0x05, 0x02, 0x04,
+	0x00, 0x06, 0x01, 0x07, 0x02, 0x04, 0x03, 0x05,
+	0x04, 0x02, 0x05, 0x03, 0x06, 0x00, 0x07, 0x01,
+	0x02, 0x04, 0x03, 0x05, 0x00, 0x06, 0x01, 0x07,
+	0x06, 0x00, 0x07, 0x01, 0x04, 0x02, 0x05, 0x03,
+	0x07, 0x01, 0x06, 0x00, 0x05, 0x03, 0x04, 0x02,
+	0x03, 0x05, 0x02, 0x04, 0x01, 0x07, 0x00, 0x06,
+	/* slice 1 */
+	0x00, 0x03, 0x06, 0x05, 0x01, 0x02, 0x07, 0x04,
+	0x02, 0x01, 0x04, 0x07, 0x03, 0x00, 0x05, 0x06,
+	0x04, 0x07, 0x02, 0x01, 0x05, 0x06, 0x03, 0x00,
+	0x06, 0x05, 0x00, 0x03, 0x07, 0x04, 0x01, 0x02,
+	0x05, 0x06, 0x03, 0x00, 0x04, 0x07, 0x02, 0x01,
+	0x07, 0x04, 0x01, 0x02, 0x06, 0x05, 0x00, 0x03,
+	0x01, 0x02, 0x07, 0x04, 0x00, 0x03, 0x06, 0x05,
+	0x03, 0x00, 0x05, 0x06, 0x02, 0x01, 0x04, 0x07,
+	0x07, 0x04, 0x01, 0x02, 0x06, 0x05, 0x00, 0x03,
+	0x05, 0x06, 0x03, 0x00, 0x04, 0x07, 0x02, 0x01,
+	0x03, 0x00, 0x05, 0x06, 0x02, 0x01, 0x04, 0x07,
+	0x01, 0x02, 0x07, 0x04, 0x00, 0x03, 0x06, 0x05,
+	0x02, 0x01, 0x04, 0x07, 0x03, 0x00, 0x05, 0x06,
+	0x00, 0x03, 0x06, 0x05, 0x01, 0x02, 0x07, 0x04,
+	0x06, 0x05, 0x00, 0x03, 0x07, 0x04, 0x01, 0x02,
+	0x04, 0x07, 0x02, 0x01, 0x05, 0x06, 0x03, 0x00,
+	0x03, 0x00, 0x05, 0x06, 0x02, 0x01, 0x04, 0x07,
+	0x01, 0x02, 0x07, 0x04, 0x00, 0x03, 0x06, 0x05,
+	0x07, 0x04, 0x01, 0x02, 0x06, 0x05, 0x00, 0x03,
+	0x05, 0x06, 0x03, 0x00, 0x04, 0x07, 0x02, 0x01,
+	0x06, 0x05, 0x00, 0x03, 0x07, 0x04, 0x01, 0x02,
+	0x04, 0x07, 0x02, 0x01, 0x05, 0x06, 0x03, 0x00,
+	0x02, 0x01, 0x04, 0x07, 0x03, 0x00, 0x05, 0x06,
+	0x00, 0x03, 0x06, 0x05, 0x01, 0x02, 0x07, 0x04,
+	0x04, 0x07, 0x02, 0x01, 0x05, 0x06, 0x03, 0x00,
+	0x06, 0x05, 0x00, 0x03, 0x07, 0x04, 0x01, 0x02,
+	0x00, 0x03, 0x06, 0x05, 0x01, 0x02, 0x07, 0x04,
+	0x02, 0x01, 0x04, 0x07, 0x03, 0x00, 0x05, 0x06,
+	0x01, 0x02, 0x07, 0x04, 0x00, 0x03, 0x06, 0x05,
+	0x03, 0x00, 0x05, 0x06, 0x02, 0x01, 0x04, 0x07,
+	0x05, 0x06, 0x03, 0x00, 0x04, 0x07, 0x02, 0x01,
+	0x07, 0x04, 0x01, 0x02, 0x06, 0x05, 0x00, 0x03,
+	/* slice 2 */
+	0x00, 0x07, 0x03, 0x04, 0x06, 0x01, 0x05, 0x02,
+	0x01, 0x06, 0x02, 0x05, 0x07, 0x00, 0x04, 0x03,
+	0x02, 0x05, 0x01, 0x06, 0x04, 0x03, 0x07, 0x00,
+	0x03, 0x04, 0x00, 0x07, 0x05, 0x02, 0x06, 0x01,
+	0x04, 0x03, 0x07, 0x00, 0x02, 0x05, 0x01, 0x06,
+	0x05, 0x02, 0x06, 0x01, 0x03, 0x04, 0x00, 0x07,
+	0x06, 0x01, 0x05, 0x02, 0x00, 0x07, 0x03, 0x04,
+	0x07, 0x00, 0x04, 0x03, 0x01, 0x06, 0x02, 0x05,
+	0x05, 0x02, 0x06, 0x01, 0x03, 0x04, 0x00, 0x07,
+	0x04, 0x03, 0x07, 0x00, 0x02, 0x05, 0x01, 0x06,
+	0x07, 0x00, 0x04, 0x03, 0x01, 0x06, 0x02, 0x05,
+	0x06, 0x01, 0x05, 0x02, 0x00, 0x07, 0x03, 0x04,
+	0x01, 0x06, 0x02, 0x05, 0x07, 0x00, 0x04, 0x03,
+	0x00, 0x07, 0x03, 0x04, 0x06, 0x01, 0x05, 0x02,
+	0x03, 0x04, 0x00, 0x07, 0x05, 0x02, 0x06, 0x01,
+	0x02, 0x05, 0x01, 0x06, 0x04, 0x03, 0x07, 0x00,
+	0x07, 0x00, 0x04, 0x03, 0x01, 0x06, 0x02, 0x05,
+	0x06, 0x01, 0x05, 0x02, 0x00, 0x07, 0x03, 0x04,
+	0x05, 0x02, 0x06, 0x01, 0x03, 0x04, 0x00, 0x07,
+	0x04, 0x03, 0x07, 0x00, 0x02, 0x05, 0x01, 0x06,
+	0x03, 0x04, 0x00, 0x07, 0x05, 0x02, 0x06, 0x01,
+	0x02, 0x05, 0x01, 0x06, 0x04, 0x03, 0x07, 0x00,
+	0x01, 0x06, 0x02, 0x05, 0x07, 0x00, 0x04, 0x03,
+	0x00, 0x07, 0x03, 0x04, 0x06, 0x01, 0x05, 0x02,
+	0x02, 0x05, 0x01, 0x06, 0x04, 0x03, 0x07, 0x00,
+	0x03, 0x04, 0x00, 0x07, 0x05, 0x02, 0x06, 0x01,
+	0x00, 0x07, 0x03, 0x04, 0x06, 0x01, 0x05, 0x02,
+	0x01, 0x06, 0x02, 0x05, 0x07, 0x00, 0x04, 0x03,
+	0x06, 0x01, 0x05, 0x02, 0x00, 0x07, 0x03, 0x04,
+	0x07, 0x00, 0x04, 0x03, 0x01, 0x06, 0x02, 0x05,
+	0x04, 0x03, 0x07, 0x00, 0x02, 0x05, 0x01, 0x06,
+	0x05, 0x02, 0x06, 0x01, 0x03, 0x04, 0x00, 0x07,
+	/* slice 3 */
+	0x00, 0x05, 0x07, 0x02, 0x03, 0x06, 0x04, 0x01,
+	0x06, 0x03, 0x01, 0x04, 0x05, 0x00, 0x02, 0x07,
+	0x01, 0x04, 0x06, 0x03, 0x02, 0x07, 0x05, 0x00,
+	0x07, 0x02, 0x00, 0x05, 0x04, 0x01, 0x03, 0x06,
+	0x02, 0x07, 0x05, 0x00, 0x01, 0x04, 0x06, 0x03,
+	0x04, 0x01, 0x03, 0x06, 0x07, 0x02, 0x00, 0x05,
+	0x03, 0x06, 0x04, 0x01, 0x00, 0x05, 0x07, 0x02,
+	0x05, 0x00, 0x02, 0x07, 0x06, 0x03, 0x01, 0x04,
+	0x04, 0x01, 0x03, 0x06, 0x07, 0x02, 0x00, 0x05,
+	0x02, 0x07, 0x05, 0x00, 0x01, 0x04, 0x06, 0x03,
+	0x05, 0x00, 0x02, 0x07, 0x06, 0x03, 0x01, 0x04,
+	0x03, 0x06, 0x04, 0x01, 0x00, 0x05, 0x07, 0x02,
+	0x06, 0x03, 0x01, 0x04, 0x05, 0x00, 0x02, 0x07,
+	0x00, 0x05, 0x07, 0x02, 0x03, 0x06, 0x04, 0x01,
+	0x07, 0x02, 0x00, 0x05, 0x04, 0x01, 0x03, 0x06,
+	0x01, 0x04, 0x06, 0x03, 0x02, 0x07, 0x05, 0x00,
+	0x05, 0x00, 0x02, 0x07, 0x06, 0x03, 0x01, 0x04,
+	0x03, 0x06, 0x04, 0x01, 0x00, 0x05, 0x07, 0x02,
+	0x04, 0x01, 0x03, 0x06, 0x07, 0x02, 0x00, 0x05,
+	0x02, 0x07, 0x05, 0x00, 0x01, 0x04, 0x06, 0x03,
+	0x07, 0x02, 0x00, 0x05, 0x04, 0x01, 0x03, 0x06,
+	0x01, 0x04, 0x06, 0x03, 0x02, 0x07, 0x05, 0x00,
+	0x06, 0x03, 0x01, 0x04, 0x05, 0x00, 0x02, 0x07,
+	0x00, 0x05, 0x07, 0x02, 0x03, 0x06, 0x04, 0x01,
+	0x01, 0x04, 0x06, 0x03, 0x02, 0x07, 0x05, 0x00,
+	0x07, 0x02, 0x00, 0x05, 0x04, 0x01, 0x03, 0x06,
+	0x00, 0x05, 0x07, 0x02, 0x03, 0x06, 0x04, 0x01,
+	0x06, 0x03, 0x01, 0x04, 0x05, 0x00, 0x02, 0x07,
+	0x03, 0x06, 0x04, 0x01, 0x00, 0x05, 0x07, 0x02,
+	0x05, 0x00, 0x02, 0x07, 0x06, 0x03, 0x01, 0x04,
+	0x02, 0x07, 0x05, 0x00, 0x01, 0x04, 0x06, 0x03,
+	0x04, 0x01, 0x03, 0x06, 0x07, 0x02, 0x00, 0x05,
+};
+
+
+/**
+ * @brief The pre-computed table for the 7-bit CRC
+ *
+ *   x**0 + x**1 + x**2 + x**3 + x**6 + x**7
+ *
+ * Slice 0 gives the CRC of every byte value, slice n the CRC of every byte
+ * value followed by n zero bytes (see \ref crc_calc_sliced).
+ */
+const uint8_t rohc_crc_table_7[ROHC_CRC_TABLE_LEN] =
+{
+	/* slice 0 */
+	0x00, 0x40, 0x73, 0x33, 0x15, 0x55, 0x66, 0x26,
+	0x2a, 0x6a, 0x59, 0x19, 0x3f, 0x7f, 0x4c, 0x0c,
+	0x54, 0x14, 0x27, 0x67, 0x41, 0x01, 0x32, 0x72,
+	0x7e, 0x3e, 0x0d, 0x4d, 0x6b, 0x2b, 0x18, 0x58,
+	0x5b, 0x1b, 0x28, 0x68, 0x4e, 0x0e, 0x3d, 0x7d,
+	0x71, 0x31, 0x02, 0x42, 0x64, 0x24, 0x17, 0x57,
+	0x0f, 0x4f, 0x7c, 0x3c, 0x1a, 0x5a, 0x69, 0x29,
+	0x25, 0x65, 0x56, 0x16, 0x30, 0x70, 0x43, 0x03,
+	0x45, 0x05, 0x36, 0x76, 0x50, 0x10, 0x23, 0x63,
+	0x6f, 0x2f, 0x1c, 0x5c, 0x7a, 0x3a, 0x09, 0x49,
+	0x11, 0x51, 0x62, 0x22, 0x04, 0x44, 0x77, 0x37,
+	0x3b, 0x7b, 0x48, 0x08, 0x2e, 0x6e, 0x5d, 0x1d,
+	0x1e, 0x5e, 0x6d, 0x2d, 0x0b, 0x4b, 0x78, 0x38,
+	0x34, 0x74, 0x47, 0x07, 0x21, 0x61, 0x52, 0x12,
+	0x4a, 0x0a, 0x39, 0x79, 0x5f, 0x1f, 0x2c, 0x6c,
+	0x60, 0x20, 0x13, 0x53, 0x75, 0x35, 0x06, 0x46,
+	0x79, 0x39, 0x0a, 0x4a, 0x6c, 0x2c, 0x1f, 0x5f,
+	0x53, 0x13, 0x20, 0x60, 0x46, 0x06, 0x35, 0x75,
+	0x2d, 0x6d, 0x5e, 0x1e, 0x38, 0x78, 0x4b, 0x0b,
+	0x07, 0x47, 0x74, 0x34, 0x12, 0x52, 0x61, 0x21,
+	0x22, 0x62, 0x51, 0x11, 0x37, 0x77, 0x44, 0x04,
+	0x08, 0x48, 0x7b, 0x3b, 0x1d, 0x5d, 0x6e, 0x2e,
+	0x76, 0x36, 0x05, 0x45, 0x63, 0x23, 0x10, 0x50,
+	0x5c, 0x1c, 0x2f, 0x6f, 0x49, 0x09, 0x3a, 0x7a,
+	0x3c, 0x7c, 0x4f, 0x0f, 0x29, 0x69, 0x5a, 0x1a,
+	0x16, 0x56, 0x65, 0x25, 0x03, 0x43, 0x70, 0x30,
+	0x68, 0x28, 0x1b, 0x5b, 0x7d, 0x3d, 0x0e, 0x4e,
+	0x42, 0x02, 0x31, 0x71, 0x57, 0x17, 0x24, 0x64,
+	0x67, 0x27, 0x14, 0x54, 0x72, 0x32, 0x01, 0x41,
+	0x4d, 0x0d, 0x3e, 0x7e, 0x58, 0x18, 0x2b, 0x6b,
+	0x33, 0x73, 0x40, 0x00, 0x26, 0x66, 0x55, 0x15,
+	0x19, 0x59, 0x6a, 0x2a, 0x0c, 0x4c, 0x7f, 0x3f,
+	/* slice 1 */
+	0x00, 0x45, 0x79, 0x3c, 0x01, 0x44, 0x78, 0x3d,
+	0x02, 0x47, 0x7b, 0x3e, 0x03, 0x46, 0x7a, 0x3f,
+	0x04, 0x41, 0x7d, 0x38, 0x05, 0x40, 0x7c, 0x39,
+	0x06, 0x43, 0x7f, 0x3a, 0x07, 0x42, 0x7e, 0x3b,
+	0x08, 0x4d, 0x71, 0x34, 0x09, 0x4c, 0x70, 0x35,
+	0x0a, 0x4f, 0x73, 0x36, 0x0b, 0x4e, 0x72, 0x37,
+	0x0c, 0x49, 0x75, 0x30, 0x0d, 0x48, 0x74, 0x31,
+	0x0e, 0x4b, 0x77, 0x32, 0x0f, 0x4a, 0x76, 0x33,
+	0x10, 0x55, 0x69, 0x2c, 0x11, 0x54, 0x68, 0x2d,
+	0x12, 0x57, 0x6b, 0x2e, 0x13, 0x56, 0x6a, 0x2f,
+	0x14, 0x51, 0x6d, 0x28, 0x15, 0x50, 0x6c, 0x29,
+	0x16, 0x53, 0x6f, 0x2a, 0x17, 0x52, 0x6e, 0x2b,
+	0x18, 0x5d, 0x61, 0x24, 0x19, 0x5c, 0x60, 0x25,
+	0x1a, 0x5f, 0x63, 0x26, 0x1b, 0x5e, 0x62, 0x27,
+	0x1c, 0x59, 0x65, 0x20, 0x1d, 0x58, 0x64, 0x21,
+	0x1e, 0x5b, 0x67, 0x22, 0x1f, 0x5a, 0x66, 0x23,
+	0x20, 0x65, 0x59, 0x1c, 0x21, 0x64, 0x58, 0x1d,
+	0x22, 0x67, 0x5b, 0x1e, 0x23, 0x66, 0x5a, 0x1f,
+	0x24, 0x61, 0x5d, 0x18, 0x25, 0x60, 0x5c, 0x19,
+	0x26, 0x63, 0x5f, 0x1a, 0x27, 0x62, 0x5e, 0x1b,
+	0x28, 0x6d, 0x51, 0x14, 0x29, 0x6c, 0x50, 0x15,
+	0x2a, 0x6f, 0x53, 0x16, 0x2b, 0x6e, 0x52, 0x17,
+	0x2c, 0x69, 0x55, 0x10, 0x2d, 0x68, 0x54, 0x11,
+	0x2e, 0x6b, 0x57, 0x12, 0x2f, 0x6a, 0x56, 0x13,
+	0x30, 0x75, 0x49, 0x0c, 0x31, 0x74, 0x48, 0x0d,
+	0x32, 0x77, 0x4b, 0x0e, 0x33, 0x76, 0x4a, 0x0f,
+	0x34, 0x71, 0x4d, 0x08, 0x35, 0x70, 0x4c, 0x09,
+	0x36, 0x73, 0x4f, 0x0a, 0x37, 0x72, 0x4e, 0x0b,
+	0x38, 0x7d, 0x41, 0x04, 0x39, 0x7c, 0x40, 0x05,
+	0x3a, 0x7f, 0x43, 0x06, 0x3b, 0x7e, 0x42, 0x07,
+	0x3c, 0x79, 0x45, 0x00, 0x3d, 0x78, 0x44, 0x01,
+	0x3e, 0x7b, 0x47, 0x02, 0x3f, 0x7a, 0x46, 0x03,
+	/* slice 2 */
+	0x00, 0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70,
+	0x73, 0x63, 0x53, 0x43, 0x33, 0x23, 0x13, 0x03,
+	0x15, 0x05, 0x35, 0x25, 0x55, 0x45, 0x75, 0x65,
+	0x66, 0x76, 0x46, 0x56, 0x26, 0x36, 0x06, 0x16,
+	0x2a, 0x3a, 0x0a, 0x1a, 0x6a, 0x7a, 0x4a, 0x5a,
+	0x59, 0x49, 0x79, 0x69, 0x19, 0x09, 0x39, 0x29,
+	0x3f, 0x2f, 0x1f, 0x0f, 0x7f, 0x6f, 0x5f, 0x4f,
+	0x4c, 0x5c, 0x6c, 0x7c, 0x0c, 0x1c, 0x2c, 0x3c,
+	0x54, 0x44, 0x74, 0x64, 0x14, 0x04, 0x34, 0x24,
+	0x27, 0x37, 0x07, 0x17, 0x67, 0x77, 0x47, 0x57,
+	0x41, 0x51, 0x61, 0x71, 0x01, 0x11, 0x21, 0x31,
+	0x32, 0x22, 0x12, 0x02, 0x72, 0x62, 0x52, 0x42,
+	0x7e, 0x6e, 0x5e, 0x4e, 0x3e, 0x2e, 0x1e, 0x0e,
+	0x0d, 0x1d, 0x2d, 0x3d, 0x4d, 0x5d, 0x6d, 0x7d,
+	0x6b, 0x7b, 0x4b, 0x5b, 0x2b, 0x3b, 0x0b, 0x1b,
+	0x18, 0x08, 0x38, 0x28, 0x58, 0x48, 0x78, 0x68,
+	0x5b, 0x4b, 0x7b, 0x6b, 0x1b, 0x0b, 0x3b, 0x2b,
+	0x28, 0x38, 0x08, 0x18, 0x68, 0x78, 0x48, 0x58,
+	0x4e, 0x5e, 0x6e, 0x7e, 0x0e, 0x1e, 0x2e, 0x3e,
+	0x3d, 0x2d, 0x1d, 0x0d, 0x7d, 0x6d, 0x5d, 0x4d,
+	0x71, 0x61, 0x51, 0x41, 0x31, 0x21, 0x11, 0x01,
+	0x02, 0x12, 0x22, 0x32, 0x42, 0x52, 0x62, 0x72,
+	0x64, 0x74, 0x44, 0x54, 0x24, 0x34, 0x04, 0x14,
+	0x17, 0x07, 0x37, 0x27, 0x57, 0x47, 0x77, 0x67,
+	0x0f, 0x1f, 0x2f, 0x3f, 0x4f, 0x5f, 0x6f, 0x7f,
+	0x7c, 0x6c, 0x5c, 0x4c, 0x3c, 0x2c, 0x1c, 0x0c,
+	0x1a, 0x0a, 0x3a, 0x2a, 0x5a, 0x4a, 0x7a, 0x6a,
+	0x69, 0x79, 0x49, 0x59, 0x29, 0x39, 0x09, 0x19,
+	0x25, 0x35, 0x05, 0x15, 0x65, 0x75, 0x45, 0x55,
+	0x56, 0x46, 0x76, 0x66, 0x16, 0x06, 0x36, 0x26,
+	0x30, 0x20, 0x10, 0x00, 0x70, 0x60, 0x50, 0x40,
+	0x43, 0x53, 0x63, 0x73, 0x03, 0x13, 0x23, 0x33,
+	/* slice 3 */
+	0x00, 0x54, 0x5b, 0x0f, 0x45, 0x11, 0x1e, 0x4a,
+	0x79, 0x2d, 0x22, 0x76, 0x3c, 0x68, 0x67, 0x33,
+	0x01, 0x55, 0x5a, 0x0e, 0x44, 0x10, 0x1f, 0x4b,
+	0x78, 0x2c, 0x23, 0x77, 0x3d, 0x69, 0x66, 0x32,
+	0x02, 0x56, 0x59, 0x0d, 0x47, 0x13, 0x1c, 0x48,
+	0x7b, 0x2f, 0x20, 0x74, 0x3e, 0x6a, 0x65, 0x31,
+	0x03, 0x57, 0x58, 0x0c, 0x46, 0x12, 0x1d, 0x49,
+	0x7a, 0x2e, 0x21, 0x75, 0x3f, 0x6b, 0x64, 0x30,
+	0x04, 0x50, 0x5f, 0x0b, 0x41, 0x15, 0x1a, 0x4e,
+	0x7d, 0x29, 0x26, 0x72, 0x38, 0x6c, 0x63, 0x37,
+	0x05, 0x51, 0x5e, 0x0a, 0x40, 0x14, 0x1b, 0x4f,
+	0x7c, 0x28, 0x27, 0x73, 0x39, 0x6d, 0x62, 0x36,
+	0x06, 0x52, 0x5d, 0x09, 0x43, 0x17, 0x18, 0x4c,
+	0x7f, 0x2b, 0x24, 0x70, 0x3a, 0x6e, 0x61, 0x35,
+	0x07, 0x53, 0x5c, 0x08, 0x42, 0x16, 0x19, 0x4d,
+	0x7e, 0x2a, 0x25, 0x71, 0x3b, 0x6f, 0x60, 0x34,
+	0x08, 0x5c, 0x53, 0x07, 0x4d, 0x19, 0x16, 0x42,
+	0x71, 0x25, 0x2a, 0x7e, 0x34, 0x60, 0x6f, 0x3b,
+	0x09, 0x5d, 0x52, 0x06, 0x4c, 0x18, 0x17, 0x43,
+	0x70, 0x24, 0x2b, 0x7f, 0x35, 0x61, 0x6e, 0x3a,
+	0x0a, 0x5e, 0x51, 0x05, 0x4f, 0x1b, 0x14, 0x40,
+	0x73, 0x27, 0x28, 0x7c, 0x36, 0x62, 0x6d, 0x39,
+	0x0b, 0x5f, 0x50, 0x04, 0x4e, 0x1a, 0x15, 0x41,
+	0x72, 0x26, 0x29, 0x7d, 0x37, 0x63, 0x6c, 0x38,
+	0x0c, 0x58, 0x57, 0x03, 0x49, 0x1d, 0x12, 0x46,
+	0x75, 0x21, 0x2e, 0x7a, 0x30, 0x64, 0x6b, 0x3f,
+	0x0d, 0x59, 0x56, 0x02, 0x48, 0x1c, 0x13, 0x47,
+	0x74, 0x20, 0x2f, 0x7b, 0x31, 0x65, 0x6a, 0x3e,
+	0x0e, 0x5a, 0x55, 0x01, 0x4b, 0x1f, 0x10, 0x44,
+	0x77, 0x23, 0x2c, 0x78, 0x32, 0x66, 0x69, 0x3d,
+	0x0f, 0x5b, 0x54, 0x00, 0x4a, 0x1e, 0x11, 0x45,
+	0x76, 0x22, 0x2d, 0x79, 0x33, 0x67, 0x68, 0x3c,
+};
+
+
+/**
+ * @brief The pre-computed table for the 8-bit CRC
+ *
+ *   x**0 + x**1 + x**2 + x**8
+ *
+ * Slice 0 gives the CRC of every byte value, slice n the CRC of every byte
+ * value followed by n zero bytes (see \ref crc_calc_sliced).
+ */
+const uint8_t rohc_crc_table_8[ROHC_CRC_TABLE_LEN] =
+{
+	/* slice 0 */
+	0x00, 0x91, 0xe3, 0x72, 0x07, 0x96, 0xe4, 0x75,
+	0x0e, 0x9f, 0xed, 0x7c, 0x09, 0x98, 0xea, 0x7b,
+	0x1c, 0x8d, 0xff, 0x6e, 0x1b, 0x8a, 0xf8, 0x69,
+	0x12, 0x83, 0xf1, 0x60, 0x15, 0x84, 0xf6, 0x67,
+	0x38, 0xa9, 0xdb, 0x4a, 0x3f, 0xae, 0xdc, 0x4d,
+	0x36, 0xa7, 0xd5, 0x44, 0x31, 0xa0, 0xd2, 0x43,
+	0x24, 0xb5, 0xc7, 0x56, 0x23, 0xb2, 0xc0, 0x51,
+	0x2a, 0xbb, 0xc9, 0x58, 0x2d, 0xbc, 0xce, 0x5f,
+	0x70, 0xe1, 0x93, 0x02, 0x77, 0xe6, 0x94, 0x05,
+	0x7e, 0xef, 0x9d, 0x0c, 0x79, 0xe8, 0x9a, 0x0b,
+	0x6c, 0xfd, 0x8f, 0x1e, 0x6b, 0xfa, 0x88, 0x19,
+	0x62, 0xf3, 0x81, 0x10, 0x65, 0xf4, 0x86, 0x17,
+	0x48, 0xd9, 0xab, 0x3a, 0x4f, 0xde, 0xac, 0x3d,
+	0x46, 0xd7, 0xa5, 0x34, 0x41, 0xd0, 0xa2, 0x33,
+	0x54, 0xc5, 0xb7, 0x26, 0x53, 0xc2, 0xb0, 0x21,
+	0x5a, 0xcb, 0xb9, 0x28, 0x5d, 0xcc, 0xbe, 0x2f,
+	0xe0, 0x71, 0x03, 0x92, 0xe7, 0x76, 0x04, 0x95,
+	0xee, 0x7f, 0x0d, 0x9c, 0xe9, 0x78, 0x0a, 0x9b,
+	0xfc, 0x6d, 0x1f, 0x8e, 0xfb, 0x6a, 0x18, 0x89,
+	0xf2, 0x63, 0x11, 0x80, 0xf5, 0x64, 0x16, 0x87,
+	0xd8, 0x49, 0x3b, 0xaa, 0xdf, 0x4e, 0x3c, 0xad,
+	0xd6, 0x47, 0x35, 0xa4, 0xd1, 0x40, 0x32, 0xa3,
+	0xc4, 0x55, 0x27, 0xb6, 0xc3, 0x52, 0x20, 0xb1,
+	0xca, 0x5b, 0x29, 0xb8, 0xcd, 0x5c, 0x2e, 0xbf,
+	0x90, 0x01, 0x73, 0xe2, 0x97, 0x06, 0x74, 0xe5,
+	0x9e, 0x0f, 0x7d, 0xec, 0x99, 0x08, 0x7a, 0xeb,
+	0x8c, 0x1d, 0x6f, 0xfe, 0x8b, 0x1a, 0x68, 0xf9,
+	0x82, 0x13, 0x61, 0xf0, 0x85, 0x14, 0x66, 0xf7,
+	0xa8, 0x39, 0x4b, 0xda, 0xaf, 0x3e, 0x4c, 0xdd,
+	0xa6, 0x37, 0x45, 0xd4, 0xa1, 0x30, 0x42, 0xd3,
+	0xb4, 0x25, 0x57, 0xc6, 0xb3, 0x22, 0x50, 0xc1,
+	0xba, 0x2b, 0x59, 0xc8, 0xbd, 0x2c, 0x5e, 0xcf,
+	/* slice 1 */
+	0x00, 0x6d, 0xda, 0xb7, 0x75, 0x18, 0xaf, 0xc2,
+	0xea, 0x87, 0x30, 0x5d, 0x9f, 0xf2, 0x45, 0x28,
+	0x15, 0x78, 0xcf, 0xa2, 0x60, 0x0d, 0xba, 0xd7,
+	0xff, 0x92, 0x25, 0x48, 0x8a, 0xe7, 0x50, 0x3d,
+	0x2a, 0x47, 0xf0, 0x9d, 0x5f, 0x32, 0x85, 0xe8,
+	0xc0, 0xad, 0x1a, 0x77, 0xb5, 0xd8, 0x6f, 0x02,
+	0x3f, 0x52, 0xe5, 0x88, 0x4a, 0x27, 0x90, 0xfd,
+	0xd5, 0xb8, 0x0f, 0x62, 0xa0, 0xcd, 0x7a, 0x17,
+	0x54, 0x39, 0x8e, 0xe3, 0x21, 0x4c, 0xfb, 0x96,
+	0xbe, 0xd3, 0x64, 0x09, 0xcb, 0xa6, 0x11, 0x7c,
+	0x41, 0x2c, 0x9b, 0xf6, 0x34, 0x59, 0xee, 0x83,
+	0xab, 0xc6, 0x71, 0x1c, 0xde, 0xb3, 0x04, 0x69,
+	0x7e, 0x13, 0xa4, 0xc9, 0x0b, 0x66, 0xd1, 0xbc,
+	0x94, 0xf9, 0x4e, 0x23, 0xe1, 0x8c, 0x3b, 0x56,
+	0x6b, 0x06, 0xb1, 0xdc, 0x1e, 0x73, 0xc4, 0xa9,
+	0x81, 0xec, 0x5b, 0x36, 0xf4, 0x99, 0x2e, 0x43,
+	0xa8, 0xc5, 0x72, 0x1f, 0xdd, 0xb0, 0x07, 0x6a,
+	0x42, 0x2f, 0x98, 0xf5, 0x37, 0x5a, 0xed, 0x80,
+	0xbd, 0xd0, 0x67, 0x0a, 0xc8, 0xa5, 0x12, 0x7f,
+	0x57, 0x3a, 0x8d, 0xe0, 0x22, 0x4f, 0xf8, 0x95,
+	0x82, 0xef, 0x58, 0x35, 0xf7, 0x9a, 0x2d, 0x40,
+	0x68, 0x05, 0xb2, 0xdf, 0x1d, 0x70, 0xc7, 0xaa,
+	0x97, 0xfa, 0x4d, 0x20, 0xe2, 0x8f, 0x38, 0x55,
+	0x7d, 0x10, 0xa7, 0xca, 0x08, 0x65, 0xd2, 0xbf,
+	0xfc, 0x91, 0x26, 0x4b, 0x89, 0xe4, 0x53, 0x3e,
+	0x16, 0x7b, 0xcc, 0xa1, 0x63, 0x0e, 0xb9, 0xd4,
+	0xe9, 0x84, 0x33, 0x5e, 0x9c, 0xf1, 0x46, 0x2b,
+	0x03, 0x6e, 0xd9, 0xb4, 0x76, 0x1b, 0xac, 0xc1,
+	0xd6, 0xbb, 0x0c, 0x61, 0xa3, 0xce, 0x79, 0x14,
+	0x3c, 0x51, 0xe6, 0x8b, 0x49, 0x24, 0x93, 0xfe,
+	0xc3, 0xae, 0x19, 0x74, 0xb6, 0xdb, 0x6c, 0x01,
+	0x29, 0x44, 0xf3, 0x9e, 0x5c, 0x31, 0x86, 0xeb,
+	/* slice 2 */
+	0x00, 0xd0, 0x61, 0xb1, 0xc2, 0x12, 0xa3, 0x73,
+	0x45, 0x95, 0x24, 0xf4, 0x87, 0x57, 0xe6, 0x36,
+	0x8a, 0x5a, 0xeb, 0x3b, 0x48, 0x98, 0x29, 0xf9,
+	0xcf, 0x1f, 0xae, 0x7e, 0x0d, 0xdd, 0x6c, 0xbc,
+	0xd5, 0x05, 0xb4, 0x64, 0x17, 0xc7, 0x76, 0xa6,
+	0x90, 0x40, 0xf1, 0x21, 0x52, 0x82, 0x33, 0xe3,
+	0x5f, 0x8f, 0x3e, 0xee, 0x9d, 0x4d, 0xfc, 0x2c,
+	0x1a, 0xca, 0x7b, 0xab, 0xd8, 0x08, 0xb9, 0x69,
+	0x6b, 0xbb, 0x0a, 0xda, 0xa9, 0x79, 0xc8, 0x18,
+	0x2e, 0xfe, 0x4f, 0x9f, 0xec, 0x3c, 0x8d, 0x5d,
+	0xe1, 0x31, 0x80, 0x50, 0x23, 0xf3, 0x42, 0x92,
+	0xa4, 0x74, 0xc5, 0x15, 0x66, 0xb6, 0x07, 0xd7,
+	0xbe, 0x6e, 0xdf, 0x0f, 0x7c, 0xac, 0x1d, 0xcd,
+	0xfb, 0x2b, 0x9a, 0x4a, 0x39, 0xe9, 0x58, 0x88,
+	0x34, 0xe4, 0x55, 0x85, 0xf6, 0x26, 0x97, 0x47,
+	0x71, 0xa1, 0x10, 0xc0, 0xb3, 0x63, 0xd2, 0x02,
+	0xd6, 0x06, 0xb7, 0x67, 0x14, 0xc4, 0x75, 0xa5,
+	0x93, 0x43, 0xf2, 0x22, 0x51, 0x81, 0x30, 0xe0,
+	0x5c, 0x8c, 0x3d, 0xed, 0x9e, 0x4e, 0xff, 0x2f,
+	0x19, 0xc9, 0x78, 0xa8, 0xdb, 0x0b, 0xba, 0x6a,
+	0x03, 0xd3, 0x62, 0xb2, 0xc1, 0x11, 0xa0, 0x70,
+	0x46, 0x96, 0x27, 0xf7, 0x84, 0x54, 0xe5, 0x35,
+	0x89, 0x59, 0xe8, 0x38, 0x4b, 0x9b, 0x2a, 0xfa,
+	0xcc, 0x1c, 0xad, 0x7d, 0x0e, 0xde, 0x6f, 0xbf,
+	0xbd, 0x6d, 0xdc, 0x0c, 0x7f, 0xaf, 0x1e, 0xce,
+	0xf8, 0x28, 0x99, 0x49, 0x3a, 0xea, 0x5b, 0x8b,
+	0x37, 0xe7, 0x56, 0x86, 0xf5, 0x25, 0x94, 0x44,
+	0x72, 0xa2, 0x13, 0xc3, 0xb0, 0x60, 0xd1, 0x01,
+	0x68, 0xb8, 0x09, 0xd9, 0xaa, 0x7a, 0xcb, 0x1b,
+	0x2d, 0xfd, 0x4c, 0x9c, 0xef, 0x3f, 0x8e, 0x5e,
+	0xe2, 0x32, 0x83, 0x53, 0x20, 0xf0, 0x41, 0x91,
+	0xa7, 0x77, 0xc6, 0x16, 0x65, 0xb5, 0x04, 0xd4,
+	/* slice 3 */
+	0x00, 0x8c, 0xd9, 0x55, 0x73, 0xff, 0xaa, 0x26,
+	0xe6, 0x6a, 0x3f, 0xb3, 0x95, 0x19, 0x4c, 0xc0,
+	0x0d, 0x81, 0xd4, 0x58, 0x7e, 0xf2, 0xa7, 0x2b,
+	0xeb, 0x67, 0x32, 0xbe, 0x98, 0x14, 0x41, 0xcd,
+	0x1a, 0x96, 0xc3, 0x4f, 0x69, 0xe5, 0xb0, 0x3c,
+	0xfc, 0x70, 0x25, 0xa9, 0x8f, 0x03, 0x56, 0xda,
+	0x17, 0x9b, 0xce, 0x42, 0x64, 0xe8, 0xbd, 0x31,
+	0xf1, 0x7d, 0x28, 0xa4, 0x82, 0x0e, 0x5b, 0xd7,
+	0x34, 0xb8, 0xed, 0x61, 0x47, 0xcb, 0x9e, 0x12,
+	0xd2, 0x5e, 0x0b, 0x87, 0xa1, 0x2d, 0x78, 0xf4,
+	0x39, 0xb5, 0xe0, 0x6c, 0x4a, 0xc6, 0x93, 0x1f,
+	0xdf, 0x53, 0x06, 0x8a, 0xac, 0x20, 0x75, 0xf9,
+	0x2e, 0xa2, 0xf7, 0x7b, 0x5d, 0xd1, 0x84, 0x08,
+	0xc8, 0x44, 0x11, 0x9d, 0xbb, 0x37, 0x62, 0xee,
+	0x23, 0xaf, 0xfa, 0x76, 0x50, 0xdc, 0x89, 0x05,
+	0xc5, 0x49, 0x1c, 0x90, 0xb6, 0x3a, 0x6f, 0xe3,
+	0x68, 0xe4, 0xb1, 0x3d, 0x1b, 0x97, 0xc2, 0x4e,
+	0x8e, 0x02, 0x57, 0xdb, 0xfd, 0x71, 0x24, 0xa8,
+	0x65, 0xe9, 0xbc, 0x30, 0x16, 0x9a, 0xcf, 0x43,
+	0x83, 0x0f, 0x5a, 0xd6, 0xf0, 0x7c, 0x29, 0xa5,
+	0x72, 0xfe, 0xab, 0x27, 0x01, 0x8d, 0xd8, 0x54,
+	0x94, 0x18, 0x4d, 0xc1, 0xe7, 0x6b, 0x3e, 0xb2,
+	0x7f, 0xf3, 0xa6, 0x2a, 0x0c, 0x80, 0xd5, 0x59,
+	0x99, 0x15, 0x40, 0xcc, 0xea, 0x66, 0x33, 0xbf,
+	0x5c, 0xd0, 0x85, 0x09, 0x2f, 0xa3, 0xf6, 0x7a,
+	0xba, 0x36, 0x63, 0xef, 0xc9, 0x45, 0x10, 0x9c,
+	0x51, 0xdd, 0x88, 0x04, 0x22, 0xae, 0xfb, 0x77,
+	0xb7, 0x3b, 0x6e, 0xe2, 0xc4, 0x48, 0x1d, 0x91,
+	0x46, 0xca, 0x9f, 0x13, 0x35, 0xb9, 0xec, 0x60,
+	0xa0, 0x2c, 0x79, 0xf5, 0xd3, 0x5f, 0x0a, 0x86,
+	0x4b, 0xc7, 0x92, 0x1e, 0x38, 0xb4, 0xe1, 0x6d,
+	0xad, 0x21, 0x74, 0xf8, 0xde, 0x52, 0x07, 0x8b,
+};
+
+
+/**
+ * @brief The length (in bytes) of the blocks of the block-interleaved CRCs
+ *
+ * The CRC of every block is computed from zero as an independent stream, then
+ * chained to the CRC of the previous blocks with one lookup in a skip table.
+ */
+#define ROHC_CRC_BLOCK_LEN  32U
+
+
+/**
+ * @brief The table that skips one block of zero bytes for the 3-bit CRC
+ *
+ * Entry n gives the CRC of \ref ROHC_CRC_BLOCK_LEN zero bytes computed with
+ * the initial value n (see \ref crc_calc_sliced).
+ */
+static const uint8_t crc_skip_table_3[8] =
+{
+	0x00, 0x05, 0x07, 0x02, 0x03, 0x06, 0x04, 0x01,
+};
+
+
+/**
+ * @brief The table that skips one block of zero bytes for the 7-bit CRC
+ *
+ * Entry n gives the CRC of \ref ROHC_CRC_BLOCK_LEN zero bytes computed with
+ * the initial value n (see \ref crc_calc_sliced).
+ */
+static const uint8_t crc_skip_table_7[128] =
+{
+	0x00, 0x54, 0x5b, 0x0f, 0x45, 0x11, 0x1e, 0x4a,
+	0x79, 0x2d, 0x22, 0x76, 0x3c, 0x68, 0x67, 0x33,
+	0x01, 0x55, 0x5a, 0x0e, 0x44, 0x10, 0x1f, 0x4b,
+	0x78, 0x2c, 0x23, 0x77, 0x3d, 0x69, 0x66, 0x32,
+	0x02, 0x56, 0x59, 0x0d, 0x47, 0x13, 0x1c, 0x48,
+	0x7b, 0x2f, 0x20, 0x74, 0x3e, 0x6a, 0x65, 0x31,
+	0x03, 0x57, 0x58, 0x0c, 0x46, 0x12, 0x1d, 0x49,
+	0x7a, 0x2e, 0x21, 0x75, 0x3f, 0x6b, 0x64, 0x30,
+	0x04, 0x50, 0x5f, 0x0b, 0x41, 0x15, 0x1a, 0x4e,
+	0x7d, 0x29, 0x26, 0x72, 0x38, 0x6c, 0x63, 0x37,
+	0x05, 0x51, 0x5e, 0x0a, 0x40, 0x14, 0x1b, 0x4f,
+	0x7c, 0x28, 0x27, 0x73, 0x39, 0x6d, 0x62, 0x36,
+	0x06, 0x52, 0x5d, 0x09, 0x43, 0x17, 0x18, 0x4c,
+	0x7f, 0x2b, 0x24, 0x70, 0x3a, 0x6e, 0x61, 0x35,
+	0x07, 0x53, 0x5c, 0x08, 0x42, 0x16, 0x19, 0x4d,
+	0x7e, 0x2a, 0x25, 0x71, 0x3b, 0x6f, 0x60, 0x34,
+};
+
+
+/**
+ * @brief The table that skips one block of zero bytes for the 8-bit CRC
+ *
+ * Entry n gives the CRC of \ref ROHC_CRC_BLOCK_LEN zero bytes computed with
+ * the initial value n (see \ref crc_calc_sliced).
+ */
+static const uint8_t crc_skip_table_8[256] =
+{
+	0x00, 0x70, 0xe0, 0x90, 0x01, 0x71, 0xe1, 0x91,
+	0x02, 0x72, 0xe2, 0x92, 0x03, 0x73, 0xe3, 0x93,
+	0x04, 0x74, 0xe4, 0x94, 0x05, 0x75, 0xe5, 0x95,
+	0x06, 0x76, 0xe6, 0x96, 0x07, 0x77, 0xe7, 0x97,
+	0x08, 0x78, 0xe8, 0x98, 0x09, 0x79, 0xe9, 0x99,
+	0x0a, 0x7a, 0xea, 0x9a, 0x0b, 0x7b, 0xeb, 0x9b,
+	0x0c, 0x7c, 0xec, 0x9c, 0x0d, 0x7d, 0xed, 0x9d,
+	0x0e, 0x7e, 0xee, 0x9e, 0x0f, 0x7f, 0xef, 0x9f,
+	0x10, 0x60, 0xf0, 0x80, 0x11, 0x61, 0xf1, 0x81,
+	0x12, 0x62, 0xf2, 0x82, 0x13, 0x63, 0xf3, 0x83,
+	0x14, 0x64, 0xf4, 0x84, 0x15, 0x65, 0xf5, 0x85,
+	0x16, 0x66, 0xf6, 0x86, 0x17, 0x67, 0xf7, 0x87,
+	0x18, 0x68, 0xf8, 0x88, 0x19, 0x69, 0xf9, 0x89,
+	0x1a, 0x6a, 0xfa, 0x8a, 0x1b, 0x6b, 0xfb, 0x8b,
+	0x1c, 0x6c, 0xfc, 0x8c, 0x1d, 0x6d, 0xfd, 0x8d,
+	0x1e, 0x6e, 0xfe, 0x8e, 0x1f, 0x6f, 0xff, 0x8f,
+	0x20, 0x50, 0xc0, 0xb0, 0x21, 0x51, 0xc1, 0xb1,
+	0x22, 0x52, 0xc2, 0xb2, 0x23, 0x53, 0xc3, 0xb3,
+	0x24, 0x54, 0xc4, 0xb4, 0x25, 0x55, 0xc5, 0xb5,
+	0x26, 0x56, 0xc6, 0xb6, 0x27, 0x57, 0xc7, 0xb7,
+	0x28, 0x58, 0xc8, 0xb8, 0x29, 0x59, 0xc9, 0xb9,
+	0x2a, 0x5a, 0xca, 0xba, 0x2b, 0x5b, 0xcb, 0xbb,
+	0x2c, 0x5c, 0xcc, 0xbc, 0x2d, 0x5d, 0xcd, 0xbd,
+	0x2e, 0x5e, 0xce, 0xbe, 0x2f, 0x5f, 0xcf, 0xbf,
+	0x30, 0x40, 0xd0, 0xa0, 0x31, 0x41, 0xd1, 0xa1,
+	0x32, 0x42, 0xd2, 0xa2, 0x33, 0x43, 0xd3, 0xa3,
+	0x34, 0x44, 0xd4, 0xa4, 0x35, 0x45, 0xd5, 0xa5,
+	0x36, 0x46, 0xd6, 0xa6, 0x37, 0x47, 0xd7, 0xa7,
+	0x38, 0x48, 0xd8, 0xa8, 0x39, 0x49, 0xd9, 0xa9,
+	0x3a, 0x4a, 0xda, 0xaa, 0x3b, 0x4b, 0xdb, 0xab,
+	0x3c, 0x4c, 0xdc, 0xac, 0x3d, 0x4d, 0xdd, 0xad,
+	0x3e, 0x4e, 0xde, 0xae, 0x3f, 0x4f, 0xdf, 0xaf,
 };
 
 
@@ -125,26 +864,72 @@ static const uint32_t crc_table_fcs32[256] =
  * Prototypes of private functions
  */
 
-static uint8_t ipv6_ext_calc_crc_static(const uint8_t *const ip,
-                                        const rohc_crc_type_t crc_type,
-                                        const uint8_t init_val,
-                                        const uint8_t *const crc_table)
-	__attribute__((warn_unused_result, nonnull(1, 4)));
+/** The CRC-STATIC bytes of one packet, gathered before the CRC is computed */
+struct crc_static_bytes
+{
+	/** The CRC-STATIC bytes gathered so far */
+	uint8_t data[ROHC_CRC_STATIC_CACHE_LEN];
+	/** The number of CRC-STATIC bytes gathered so far */
+	size_t len;
+	/** Whether the CRC-STATIC bytes are too long to be gathered */
+	bool is_too_long;
+	/** The type of CRC */
+	rohc_crc_type_t crc_type;
+	/** The initial CRC value */
+	uint8_t init_val;
+	/** The CRC computed on the fly if the bytes are too long */
+	uint8_t crc;
+	/** The pre-computed table for fast CRC computation */
+	const uint8_t *crc_table;
+};
+
+static void crc_static_start(struct crc_static_bytes *const bytes,
+                             const rohc_crc_type_t crc_type,
+                             const uint8_t init_val,
+                             const uint8_t *const crc_table)
+	__attribute__((nonnull(1, 4)));
+static void crc_static_add(struct crc_static_bytes *const bytes,
+                           const uint8_t *const data,
+                           const size_t len)
+	__attribute__((nonnull(1, 2)));
+static void crc_static_add_ips(struct crc_static_bytes *const bytes,
+                               const uint8_t *const outer_ip,
+                               const uint8_t *const inner_ip,
+                               struct crc_static_cache *const cache)
+	__attribute__((nonnull(1, 2)));
+static void crc_static_add_ip(struct crc_static_bytes *const bytes,
+                              const uint8_t *const ip,
+                              struct crc_ah_spans *const ah_spans)
+	__attribute__((nonnull(1, 2)));
+static uint8_t crc_static_end(const struct crc_static_bytes *const bytes,
+                              struct crc_static_cache *const cache)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void crc_static_cache_init_crcs(struct crc_static_cache *const cache)
+	__attribute__((nonnull(1)));
+
 static uint8_t ipv6_ext_calc_crc_dyn(const uint8_t *const ip,
                                      const rohc_crc_type_t crc_type,
                                      const uint8_t init_val,
-                                     const uint8_t *const crc_table)
+                                     const uint8_t *const crc_table,
+                                     const struct crc_ah_spans *const ah_spans)
 	__attribute__((warn_unused_result, nonnull(1, 4)));
 static uint8_t * ipv6_get_first_extension(const uint8_t *const ip,
                                           uint8_t *const type)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
 
-static bool rohc_crc_get_polynom(const rohc_crc_type_t crc_type,
-                                 uint8_t *const polynom)
-	__attribute__((nonnull(2), warn_unused_result));
-
-
+static inline uint8_t crc_calc_block(const uint8_t *const buf,
+                                     const uint8_t init_val,
+                                     const uint8_t mask,
+                                     const uint8_t *const crc_table)
+	__attribute__((nonnull(1, 4), warn_unused_result, pure));
+static inline uint8_t crc_calc_sliced(const uint8_t *const buf,
+                                      const size_t size,
+                                      const uint8_t init_val,
+                                      const uint8_t mask,
+                                      const uint8_t *const crc_table,
+                                      const uint8_t *const skip_table)
+	__attribute__((nonnull(1, 5, 6), warn_unused_result, pure));
 static inline uint8_t crc_calc_8(const uint8_t *const buf,
                                  const size_t size,
                                  const uint8_t init_val,
@@ -169,55 +954,16 @@ static inline uint8_t crc_calc_3(const uint8_t *const buf,
 
 
 /**
- * @brief Initialize a CRC table given a 256-byte table and the CRC type to use
+ * @brief Initialize an empty CRC-STATIC cache
  *
- * @param table     IN/OUT: The 256-byte table to initialize
- * @param crc_type  The type of CRC to initialize the table for
- * @return          true in case of success, false in case of failure
+ * @param cache  The CRC-STATIC cache to initialize
  */
-bool rohc_crc_init_table(uint8_t *const table,
-                         const rohc_crc_type_t crc_type)
+void crc_static_cache_init(struct crc_static_cache *const cache)
 {
-	uint8_t crc;
-	uint8_t polynom;
-	bool is_fine;
-	int i, j;
-
-	/* sanity check */
-	assert(table != NULL);
-
-	/* determine the polynom to use */
-	is_fine = rohc_crc_get_polynom(crc_type, &polynom);
-	if(is_fine != true)
-	{
-		goto error;
-	}
-
-	/* fill the CRC table */
-	for(i = 0; i < 256; i++)
-	{
-		crc = i;
-
-		for(j = 0; j < 8; j++)
-		{
-			if(crc & 1)
-			{
-				crc = (crc >> 1) ^ polynom;
-			}
-			else
-			{
-				crc = crc >> 1;
-			}
-		}
-
-		table[i] = crc;
-	}
-
-	/* everything went fine */
-	return true;
-
-error:
-	return false;
+	cache->bytes_nr = 0;
+	crc_static_cache_init_crcs(cache);
+	cache->ah_spans[0].ip = NULL;
+	cache->ah_spans[1].ip = NULL;
 }
 
 
@@ -264,7 +1010,7 @@ uint8_t crc_calculate(const rohc_crc_type_t crc_type,
 
 
 /**
- * @brief Optimized CRC FCS-32 calculation using a table
+ * @brief Compute the CRC FCS-32 with the fastest kernel for the CPU
  *
  * @param data      The data to compute the CRC for
  * @param length    The size of the data
@@ -274,19 +1020,210 @@ uint8_t crc_calculate(const rohc_crc_type_t crc_type,
 uint32_t crc_calc_fcs32(const uint8_t *const data,
                         const size_t length,
                         const uint32_t init_val)
+{
+	return rohc_cpu_get_kernels()->crc_fcs32(data, length, init_val);
+}
+
+
+/**
+ * @brief Optimized CRC FCS-32 calculation using a table
+ *
+ * The data is processed 4 bytes at once with the slicing-by-4 tables, the
+ * remaining bytes are processed one by one. The kernel runs on every CPU.
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The size of the data
+ * @param init_val  The initial value of the CRC
+ * @return          The 32-bit CRC
+ */
+uint32_t crc_calc_fcs32_generic(const uint8_t *const data,
+                                const size_t length,
+                                const uint32_t init_val)
 {
 	uint32_t crc = init_val;
 	size_t i;
 
-	for(i = 0; i < length; i++)
+	for(i = 0; (i + 4) <= length; i += 4)
+	{
+		crc ^= ((uint32_t) data[i]) |
+		       (((uint32_t) data[i + 1]) << 8) |
+		       (((uint32_t) data[i + 2]) << 16) |
+		       (((uint32_t) data[i + 3]) << 24);
+		crc = crc_table_fcs32[3][crc & 0xff] ^
+		      crc_table_fcs32[2][(crc >> 8) & 0xff] ^
+		      crc_table_fcs32[1][(crc >> 16) & 0xff] ^
+		      crc_table_fcs32[0][crc >> 24];
+	}
+	for(; i < length; i++)
 	{
-		crc = (crc >> 8) ^ crc_table_fcs32[(crc ^ data[i]) & 0xff];
+		crc = (crc >> 8) ^ crc_table_fcs32[0][(crc ^ data[i]) & 0xff];
 	}
 
 	return crc;
 }
 
 
+#if ROHC_CRC_HAVE_PCLMUL == 1
+
+/**
+ * @brief CRC FCS-32 calculation using the x86 carry-less multiplication
+ *
+ * The data is folded 64 bytes at once with the PCLMULQDQ instruction, then
+ * reduced to 32 bits with the Barrett reduction, as described in the paper
+ * "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+ * Instruction" from Intel. The constants are the ones of the bit-reflected
+ * FCS-32 polynomial. The data shorter than 64 bytes and the last bytes that
+ * do not fill 16 bytes are processed with the tables.
+ *
+ * The CPU shall support the PCLMULQDQ and SSE4.1 instructions.
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The size of the data
+ * @param init_val  The initial value of the CRC
+ * @return          The 32-bit CRC
+ */
+__attribute__((target("pclmul,sse4.1")))
+uint32_t crc_calc_fcs32_pclmul(const uint8_t *const data,
+                               const size_t length,
+                               const uint32_t init_val)
+{
+	const size_t folded_len = length & ~((size_t) 15);
+	const uint8_t *buf = data;
+	size_t len = folded_len;
+	__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+	uint32_t crc;
+
+	if(length < 64)
+	{
+		return crc_calc_fcs32_generic(data, length, init_val);
+	}
+
+	/* load the first 64 bytes */
+	x1 = _mm_loadu_si128((const __m128i *) (buf + 0x00));
+	x2 = _mm_loadu_si128((const __m128i *) (buf + 0x10));
+	x3 = _mm_loadu_si128((const __m128i *) (buf + 0x20));
+	x4 = _mm_loadu_si128((const __m128i *) (buf + 0x30));
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int) init_val));
+	buf += 64;
+	len -= 64;
+
+	/* fold 64 bytes at once */
+	x0 = _mm_set_epi64x(0x01c6e41596LL, 0x0154442bd4LL);
+	while(len >= 64)
+	{
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+		x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5),
+		                   _mm_loadu_si128((const __m128i *) (buf + 0x00)));
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6),
+		                   _mm_loadu_si128((const __m128i *) (buf + 0x10)));
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7),
+		                   _mm_loadu_si128((const __m128i *) (buf + 0x20)));
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8),
+		                   _mm_loadu_si128((const __m128i *) (buf + 0x30)));
+		buf += 64;
+		len -= 64;
+	}
+
+	/* fold the 4 blocks into one block of 16 bytes */
+	x0 = _mm_set_epi64x(0x00ccaa009eLL, 0x01751997d0LL);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+	/* fold the remaining blocks of 16 bytes */
+	while(len >= 16)
+	{
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i *) buf)),
+		                   x5);
+		buf += 16;
+		len -= 16;
+	}
+
+	/* fold 128 bits into 64 bits */
+	x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+	x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+	x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+	x0 = _mm_set_epi64x(0, 0x0163cd6124LL);
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, x3);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	/* Barrett reduction into 32 bits */
+	x0 = _mm_set_epi64x(0x01f7011641LL, 0x01db710641LL);
+	x2 = _mm_and_si128(x1, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+	x2 = _mm_and_si128(x2, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+	crc = (uint32_t) _mm_extract_epi32(x1, 1);
+
+	/* the last bytes that do not fill one block of 16 bytes */
+	return crc_calc_fcs32_generic(data + folded_len, length - folded_len, crc);
+}
+
+#endif /* ROHC_CRC_HAVE_PCLMUL */
+
+
+#if ROHC_CRC_HAVE_ARM_CRC32 == 1
+
+/**
+ * @brief CRC FCS-32 calculation using the ARMv8 CRC32 instructions
+ *
+ * The CRC32 instructions of ARMv8 use the bit-reflected FCS-32 polynomial:
+ * the data is processed 8 bytes at once, the remaining bytes one by one.
+ *
+ * The CPU shall support the CRC32 instructions.
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The size of the data
+ * @param init_val  The initial value of the CRC
+ * @return          The 32-bit CRC
+ */
+#if defined(__clang__)
+__attribute__((target("crc")))
+#else
+__attribute__((target("+crc")))
+#endif
+uint32_t crc_calc_fcs32_arm(const uint8_t *const data,
+                            const size_t length,
+                            const uint32_t init_val)
+{
+	uint32_t crc = init_val;
+	size_t i;
+
+	for(i = 0; (i + 8) <= length; i += 8)
+	{
+		uint64_t word;
+		memcpy(&word, data + i, sizeof(uint64_t));
+		crc = __crc32d(crc, word);
+	}
+	for(; i < length; i++)
+	{
+		crc = __crc32b(crc, data[i]);
+	}
+
+	return crc;
+}
+
+#endif /* ROHC_CRC_HAVE_ARM_CRC32 */
+
+
 /**
  * @brief Compute the CRC-STATIC part of an IP header
  *
@@ -304,6 +1241,7 @@ uint32_t crc_calc_fcs32(const uint8_t *const data,
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
  * @param crc_table   The pre-computed table for fast CRC computation
+ * @param cache       The CRC-STATIC cache of the context, NULL if none
  * @return            The checksum
  */
 uint8_t compute_crc_static(const uint8_t *const outer_ip,
@@ -311,76 +1249,15 @@ uint8_t compute_crc_static(const uint8_t *const outer_ip,
                            const uint8_t *const next_header __attribute__((unused)),
                            const rohc_crc_type_t crc_type,
                            const uint8_t init_val,
-                           const uint8_t *const crc_table)
+                           const uint8_t *const crc_table,
+                           struct crc_static_cache *const cache)
 {
-	const struct ip_hdr *const outer_ip_hdr = (struct ip_hdr *) outer_ip;
-	uint8_t crc = init_val;
-
-	/* first IPv4 header */
-	if(outer_ip_hdr->version == IPV4)
-	{
-		const struct ipv4_hdr *ip_hdr = (struct ipv4_hdr *) outer_ip;
-
-		/* bytes 1-2 (Version, Header length, TOS) */
-		crc = crc_calculate(crc_type, (uint8_t *)(ip_hdr), 2,
-		                    crc, crc_table);
-		/* bytes 7-10 (Flags, Fragment Offset, TTL, Protocol) */
-		crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->frag_off), 4,
-		                    crc, crc_table);
-		/* bytes 13-20 (Source Address, Destination Address) */
-		crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->saddr), 8,
-		                    crc, crc_table);
-	}
-	else /* first IPv6 header */
-	{
-		const struct ipv6_hdr *ip_hdr = (struct ipv6_hdr *) outer_ip;
-
-		/* bytes 1-4 (Version, TC, Flow Label) */
-		crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->version_tc_flow), 4,
-		                    crc, crc_table);
-		/* bytes 7-40 (Next Header, Hop Limit, Source Address, Destination Address) */
-		crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->nh), 34,
-		                    crc, crc_table);
-		/* IPv6 extensions */
-		crc = ipv6_ext_calc_crc_static(outer_ip, crc_type, crc, crc_table);
-	}
-
-	/* second header */
-	if(inner_ip != NULL)
-	{
-		const struct ip_hdr *const inner_ip_hdr = (struct ip_hdr *) inner_ip;
-
-		/* IPv4 */
-		if(inner_ip_hdr->version == IPV4)
-		{
-			const struct ipv4_hdr *ip_hdr = (struct ipv4_hdr *) inner_ip;
-
-			/* bytes 1-2 (Version, Header length, TOS) */
-			crc = crc_calculate(crc_type, (uint8_t *)(ip_hdr), 2,
-			                    crc, crc_table);
-			/* bytes 7-10 (Flags, Fragment Offset, TTL, Protocol) */
-			crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->frag_off), 4,
-			                    crc, crc_table);
-			/* bytes 13-20 (Source Address, Destination Address) */
-			crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->saddr), 8,
-			                    crc, crc_table);
-		}
-		else /* IPv6 */
-		{
-			const struct ipv6_hdr *ip_hdr = (struct ipv6_hdr *) inner_ip;
+	struct crc_static_bytes bytes;
 
-			/* bytes 1-4 (Version, TC, Flow Label) */
-			crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->version_tc_flow), 4,
-			                    crc, crc_table);
-			/* bytes 7-40 (Next Header, Hop Limit, Source Address, Destination Address) */
-			crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->nh), 34,
-			                    crc, crc_table);
-			/* IPv6 extensions */
-			crc = ipv6_ext_calc_crc_static(inner_ip, crc_type, crc, crc_table);
-		}
-	}
+	crc_static_start(&bytes, crc_type, init_val, crc_table);
+	crc_static_add_ips(&bytes, outer_ip, inner_ip, cache);
 
-	return crc;
+	return crc_static_end(&bytes, cache);
 }
 
 
@@ -397,6 +1274,9 @@ uint8_t compute_crc_static(const uint8_t *const outer_ip,
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
  * @param crc_table   The pre-computed table for fast CRC computation
+ * @param cache       The CRC-STATIC cache of the context, with the AH headers
+ *                    located by the CRC-STATIC part of the same packet,
+ *                    NULL if none
  * @return            The checksum
  */
 uint8_t compute_crc_dynamic(const uint8_t *const outer_ip,
@@ -404,7 +1284,8 @@ uint8_t compute_crc_dynamic(const uint8_t *const outer_ip,
                             const uint8_t *const next_header __attribute__((unused)),
                             const rohc_crc_type_t crc_type,
                             const uint8_t init_val,
-                            const uint8_t *const crc_table)
+                            const uint8_t *const crc_table,
+                            const struct crc_static_cache *const cache)
 {
 	const struct ip_hdr *const outer_ip_hdr = (struct ip_hdr *) outer_ip;
 	uint8_t crc = init_val;
@@ -427,7 +1308,8 @@ uint8_t compute_crc_dynamic(const uint8_t *const outer_ip,
 		crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->plen), 2,
 		                    crc, crc_table);
 		/* IPv6 extensions (only AH is CRC-DYNAMIC) */
-		crc = ipv6_ext_calc_crc_dyn(outer_ip, crc_type, crc, crc_table);
+		crc = ipv6_ext_calc_crc_dyn(outer_ip, crc_type, crc, crc_table,
+		                            cache == NULL ? NULL : &cache->ah_spans[0]);
 	}
 
 	/* second_header */
@@ -453,7 +1335,8 @@ uint8_t compute_crc_dynamic(const uint8_t *const outer_ip,
 			crc = crc_calculate(crc_type, (uint8_t *)(&ip_hdr->plen), 2,
 			                    crc, crc_table);
 			/* IPv6 extensions (only AH is CRC-DYNAMIC) */
-			crc = ipv6_ext_calc_crc_dyn(inner_ip, crc_type, crc, crc_table);
+			crc = ipv6_ext_calc_crc_dyn(inner_ip, crc_type, crc, crc_table,
+			                            cache == NULL ? NULL : &cache->ah_spans[1]);
 		}
 	}
 
@@ -474,6 +1357,7 @@ uint8_t compute_crc_dynamic(const uint8_t *const outer_ip,
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
  * @param crc_table   The pre-computed table for fast CRC computation
+ * @param cache       The CRC-STATIC cache of the context, NULL if none
  * @return            The checksum
  */
 uint8_t udp_compute_crc_static(const uint8_t *const outer_ip,
@@ -481,23 +1365,20 @@ uint8_t udp_compute_crc_static(const uint8_t *const outer_ip,
                                const uint8_t *const next_header,
                                const rohc_crc_type_t crc_type,
                                const uint8_t init_val,
-                               const uint8_t *const crc_table)
+                               const uint8_t *const crc_table,
+                               struct crc_static_cache *const cache)
 {
-	uint8_t crc = init_val;
-	const struct udphdr *udp;
+	const struct udphdr *const udp = (struct udphdr *) next_header;
+	struct crc_static_bytes bytes;
 
-	/* compute the CRC-STATIC value for IP and IP2 headers */
-	crc = compute_crc_static(outer_ip, inner_ip, next_header,
-	                         crc_type, crc, crc_table);
-
-	/* get the start of UDP header */
-	udp = (struct udphdr *) next_header;
+	/* the CRC-STATIC fields of IP and IP2 headers */
+	crc_static_start(&bytes, crc_type, init_val, crc_table);
+	crc_static_add_ips(&bytes, outer_ip, inner_ip, cache);
 
 	/* bytes 1-4 (Source Port, Destination Port) */
-	crc = crc_calculate(crc_type, (uint8_t *)(&udp->source), 4,
-	                    crc, crc_table);
+	crc_static_add(&bytes, (uint8_t *)(&udp->source), 4);
 
-	return crc;
+	return crc_static_end(&bytes, cache);
 }
 
 
@@ -513,6 +1394,9 @@ uint8_t udp_compute_crc_static(const uint8_t *const outer_ip,
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
  * @param crc_table   The pre-computed table for fast CRC computation
+ * @param cache       The CRC-STATIC cache of the context, with the AH headers
+ *                    located by the CRC-STATIC part of the same packet,
+ *                    NULL if none
  * @return            The checksum
  */
 uint8_t udp_compute_crc_dynamic(const uint8_t *const outer_ip,
@@ -520,14 +1404,15 @@ uint8_t udp_compute_crc_dynamic(const uint8_t *const outer_ip,
                                 const uint8_t *const next_header,
                                 const rohc_crc_type_t crc_type,
                                 const uint8_t init_val,
-                                const uint8_t *const crc_table)
+                                const uint8_t *const crc_table,
+                                const struct crc_static_cache *const cache)
 {
 	uint8_t crc = init_val;
 	const struct udphdr *udp;
 
 	/* compute the CRC-DYNAMIC value for IP and IP2 headers */
 	crc = compute_crc_dynamic(outer_ip, inner_ip, next_header,
-	                          crc_type, crc, crc_table);
+	                          crc_type, crc, crc_table, cache);
 
 	/* get the start of UDP header */
 	udp = (struct udphdr *) next_header;
@@ -553,6 +1438,7 @@ uint8_t udp_compute_crc_dynamic(const uint8_t *const outer_ip,
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
  * @param crc_table   The pre-computed table for fast CRC computation
+ * @param cache       The CRC-STATIC cache of the context, NULL if none
  * @return            The checksum
  */
 uint8_t esp_compute_crc_static(const uint8_t *const outer_ip,
@@ -560,23 +1446,20 @@ uint8_t esp_compute_crc_static(const uint8_t *const outer_ip,
                                const uint8_t *const next_header,
                                const rohc_crc_type_t crc_type,
                                const uint8_t init_val,
-                               const uint8_t *const crc_table)
+                               const uint8_t *const crc_table,
+                               struct crc_static_cache *const cache)
 {
-	uint8_t crc = init_val;
-	const struct esphdr *esp;
+	const struct esphdr *const esp = (struct esphdr *) next_header;
+	struct crc_static_bytes bytes;
 
-	/* compute the CRC-STATIC value for IP and IP2 headers */
-	crc = compute_crc_static(outer_ip, inner_ip, next_header,
-	                         crc_type, crc, crc_table);
-
-	/* get the start of ESP header */
-	esp = (struct esphdr *) next_header;
+	/* the CRC-STATIC fields of IP and IP2 headers */
+	crc_static_start(&bytes, crc_type, init_val, crc_table);
+	crc_static_add_ips(&bytes, outer_ip, inner_ip, cache);
 
 	/* bytes 1-4 (Security parameters index) */
-	crc = crc_calculate(crc_type, (uint8_t *)(&esp->spi), 4,
-	                    crc, crc_table);
+	crc_static_add(&bytes, (uint8_t *)(&esp->spi), 4);
 
-	return crc;
+	return crc_static_end(&bytes, cache);
 }
 
 
@@ -592,6 +1475,9 @@ uint8_t esp_compute_crc_static(const uint8_t *const outer_ip,
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
  * @param crc_table   The pre-computed table for fast CRC computation
+ * @param cache       The CRC-STATIC cache of the context, with the AH headers
+ *                    located by the CRC-STATIC part of the same packet,
+ *                    NULL if none
  * @return            The checksum
  */
 uint8_t esp_compute_crc_dynamic(const uint8_t *const outer_ip,
@@ -599,14 +1485,15 @@ uint8_t esp_compute_crc_dynamic(const uint8_t *const outer_ip,
                                 const uint8_t *const next_header,
                                 const rohc_crc_type_t crc_type,
                                 const uint8_t init_val,
-                                const uint8_t *const crc_table)
+                                const uint8_t *const crc_table,
+                                const struct crc_static_cache *const cache)
 {
 	uint8_t crc = init_val;
 	const struct esphdr *esp;
 
 	/* compute the CRC-DYNAMIC value for IP and IP2 headers */
 	crc = compute_crc_dynamic(outer_ip, inner_ip, next_header,
-	                          crc_type, crc, crc_table);
+	                          crc_type, crc, crc_table, cache);
 
 	/* get the start of ESP header */
 	esp = (struct esphdr *) next_header;
@@ -632,6 +1519,7 @@ uint8_t esp_compute_crc_dynamic(const uint8_t *const outer_ip,
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
  * @param crc_table   The pre-computed table for fast CRC computation
+ * @param cache       The CRC-STATIC cache of the context, NULL if none
  * @return            The checksum
  */
 uint8_t rtp_compute_crc_static(const uint8_t *const outer_ip,
@@ -639,28 +1527,30 @@ uint8_t rtp_compute_crc_static(const uint8_t *const outer_ip,
                                const uint8_t *const next_header,
                                const rohc_crc_type_t crc_type,
                                const uint8_t init_val,
-                               const uint8_t *const crc_table)
+                               const uint8_t *const crc_table,
+                               struct crc_static_cache *const cache)
 {
-	uint8_t crc = init_val;
-	const struct rtphdr *rtp;
+	const struct udphdr *const udp = (struct udphdr *) next_header;
+	const struct rtphdr *const rtp =
+		(struct rtphdr *) (next_header + sizeof(struct udphdr));
+	struct crc_static_bytes bytes;
 
-	/* compute the CRC-STATIC value for IP, IP2 and UDP headers */
-	crc = udp_compute_crc_static(outer_ip, inner_ip, next_header,
-	                             crc_type, crc, crc_table);
+	/* the CRC-STATIC fields of IP and IP2 headers */
+	crc_static_start(&bytes, crc_type, init_val, crc_table);
+	crc_static_add_ips(&bytes, outer_ip, inner_ip, cache);
 
-	/* get the start of RTP header */
-	rtp = (struct rtphdr *) (next_header + sizeof(struct udphdr));
+	/* UDP bytes 1-4 (Source Port, Destination Port) */
+	crc_static_add(&bytes, (uint8_t *)(&udp->source), 4);
 
-	/* byte 1 (Version, P, X, CC) */
-	crc = crc_calculate(crc_type, (uint8_t *)rtp, 1, crc, crc_table);
+	/* RTP byte 1 (Version, P, X, CC) */
+	crc_static_add(&bytes, (uint8_t *) rtp, 1);
 
-	/* bytes 9-12 (SSRC identifier) */
-	crc = crc_calculate(crc_type, (uint8_t *)(&rtp->ssrc), 4,
-	                    crc, crc_table);
+	/* RTP bytes 9-12 (SSRC identifier) */
+	crc_static_add(&bytes, (uint8_t *)(&rtp->ssrc), 4);
 
 	/* TODO: CSRC identifiers */
 
-	return crc;
+	return crc_static_end(&bytes, cache);
 }
 
 
@@ -676,6 +1566,9 @@ uint8_t rtp_compute_crc_static(const uint8_t *const outer_ip,
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
  * @param crc_table   The pre-computed table for fast CRC computation
+ * @param cache       The CRC-STATIC cache of the context, with the AH headers
+ *                    located by the CRC-STATIC part of the same packet,
+ *                    NULL if none
  * @return            The checksum
  */
 uint8_t rtp_compute_crc_dynamic(const uint8_t *const outer_ip,
@@ -683,14 +1576,15 @@ uint8_t rtp_compute_crc_dynamic(const uint8_t *const outer_ip,
                                 const uint8_t *const next_header,
                                 const rohc_crc_type_t crc_type,
                                 const uint8_t init_val,
-                                const uint8_t *const crc_table)
+                                const uint8_t *const crc_table,
+                                const struct crc_static_cache *const cache)
 {
 	uint8_t crc = init_val;
 	const struct rtphdr *rtp;
 
 	/* compute the CRC-DYNAMIC value for IP, IP2 and UDP headers */
 	crc = udp_compute_crc_dynamic(outer_ip, inner_ip, next_header,
-	                              crc_type, crc, crc_table);
+	                              crc_type, crc, crc_table, cache);
 
 	/* get the start of RTP header */
 	rtp = (struct rtphdr *) (next_header + sizeof(struct udphdr));
@@ -703,62 +1597,315 @@ uint8_t rtp_compute_crc_dynamic(const uint8_t *const outer_ip,
 }
 
 
+/**
+ * @brief Compute the CRC-3 on the control fields of the ROHCv2 profiles
+ *
+ * The control_crc3 field of the co_common and co_repair packets protects
+ * the control fields of the context that are not part of the uncompressed
+ * headers (RFC 5225, §6.6.11): the reorder ratio and the IP-ID behaviors
+ * on one octet each, and the MSN on two octets in network byte order.
+ *
+ * @param reorder_ratio       The reorder ratio
+ * @param msn                 The Master Sequence Number (MSN)
+ * @param ip_id_behaviors     The IP-ID behaviors of the IPv4 headers
+ * @param ip_id_behaviors_nr  The number of IP-ID behaviors
+ * @return                    The CRC-3
+ */
+uint8_t compute_crc_ctrl_fields(const uint8_t reorder_ratio,
+                                const uint16_t msn,
+                                const uint8_t ip_id_behaviors[],
+                                const size_t ip_id_behaviors_nr)
+{
+	const uint8_t ctrl_fields[3] = {
+		reorder_ratio & 0x03, (msn >> 8) & 0xff, msn & 0xff
+	};
+	uint8_t crc;
+
+	crc = crc_calculate(ROHC_CRC_TYPE_3, ctrl_fields, 3, CRC_INIT_3,
+	                    rohc_crc_table_3);
+	if(ip_id_behaviors_nr > 0)
+	{
+		crc = crc_calculate(ROHC_CRC_TYPE_3, ip_id_behaviors, ip_id_behaviors_nr,
+		                    crc, rohc_crc_table_3);
+	}
+
+	return crc;
+}
+
+
 /**
  * Private functions
  */
 
 /**
- * @brief Compute the CRC-STATIC part of IPv6 extensions
+ * @brief Add the CRC-STATIC fields of the IP headers to the CRC-STATIC bytes
  *
- * All extensions are concerned except entire AH header.
+ * @param bytes     The CRC-STATIC bytes to complete
+ * @param outer_ip  The outer IP header
+ * @param inner_ip  The inner IP header if any, NULL otherwise
+ * @param cache     The CRC-STATIC cache of the context to record the AH
+ *                  headers in, NULL if none
+ */
+static void crc_static_add_ips(struct crc_static_bytes *const bytes,
+                               const uint8_t *const outer_ip,
+                               const uint8_t *const inner_ip,
+                               struct crc_static_cache *const cache)
+{
+	crc_static_add_ip(bytes, outer_ip,
+	                  cache == NULL ? NULL : &cache->ah_spans[0]);
+	if(inner_ip != NULL)
+	{
+		crc_static_add_ip(bytes, inner_ip,
+		                  cache == NULL ? NULL : &cache->ah_spans[1]);
+	}
+}
+
+
+/**
+ * @brief Add the CRC-STATIC fields of one IP header to the CRC-STATIC bytes
  *
- * @param ip          The IPv6 packet
- * @param crc_type    The type of CRC
- * @param init_val    The initial CRC value
- * @param crc_table   The pre-computed table for fast CRC computation
- * @return            The checksum
+ * Concerned fields are:
+ *   - bytes 1-2, 7-10, 13-20 in original IPv4 header
+ *   - bytes 1-4, 7-40 in original IPv6 header
+ *   - all IPv6 extensions except entire AH header
+ *
+ * The consecutive IPv6 extensions other than AH are added as one span. The
+ * AH headers are recorded for the CRC-DYNAMIC part.
+ *
+ * @param bytes     The CRC-STATIC bytes to complete
+ * @param ip        The IP header
+ * @param ah_spans  The AH headers to record, NULL not to record them
  */
-static uint8_t ipv6_ext_calc_crc_static(const uint8_t *const ip,
-                                        const rohc_crc_type_t crc_type,
-                                        const uint8_t init_val,
-                                        const uint8_t *const crc_table)
+static void crc_static_add_ip(struct crc_static_bytes *const bytes,
+                              const uint8_t *const ip,
+                              struct crc_ah_spans *const ah_spans)
 {
-	uint8_t crc = init_val;
-	const uint8_t *ext;
-	uint8_t ext_type;
+	const struct ip_hdr *const ip_hdr = (struct ip_hdr *) ip;
 
-	assert(ip != NULL);
+	if(ip_hdr->version == IPV4)
+	{
+		const struct ipv4_hdr *const ipv4_hdr = (struct ipv4_hdr *) ip;
 
-	ext = ipv6_get_first_extension(ip, &ext_type);
-	while(ext != NULL)
+		/* bytes 1-2 (Version, Header length, TOS) */
+		crc_static_add(bytes, ip, 2);
+		/* bytes 7-10 (Flags, Fragment Offset, TTL, Protocol) */
+		crc_static_add(bytes, (uint8_t *)(&ipv4_hdr->frag_off), 4);
+		/* bytes 13-20 (Source Address, Destination Address) */
+		crc_static_add(bytes, (uint8_t *)(&ipv4_hdr->saddr), 8);
+	}
+	else
 	{
-		if(ext_type != ROHC_IPPROTO_AH)
+		const struct ipv6_hdr *const ipv6_hdr = (struct ipv6_hdr *) ip;
+		const uint8_t *span = NULL;
+		size_t span_len = 0;
+		const uint8_t *ext;
+		uint8_t ext_type;
+
+		/* bytes 1-4 (Version, TC, Flow Label) */
+		crc_static_add(bytes, (uint8_t *)(&ipv6_hdr->version_tc_flow), 4);
+		/* bytes 7-40 (Next Header, Hop Limit, Source Address, Destination Address) */
+		crc_static_add(bytes, (uint8_t *)(&ipv6_hdr->nh), 34);
+
+		/* IPv6 extensions, the AH headers split them in spans */
+		if(ah_spans != NULL)
 		{
-			crc = crc_calculate(crc_type, ext, ip_get_extension_size(ext),
-			                    crc, crc_table);
+			ah_spans->ip = ip;
+			ah_spans->spans_nr = 0;
+		}
+		ext = ipv6_get_first_extension(ip, &ext_type);
+		while(ext != NULL)
+		{
+			const size_t ext_len = ip_get_extension_size(ext);
+
+			if(ext_type != ROHC_IPPROTO_AH)
+			{
+				if(span_len == 0)
+				{
+					span = ext;
+				}
+				span_len += ext_len;
+			}
+			else
+			{
+				if(span_len > 0)
+				{
+					crc_static_add(bytes, span, span_len);
+					span_len = 0;
+				}
+				if(ah_spans != NULL && ah_spans->ip != NULL)
+				{
+					if(ah_spans->spans_nr < ROHC_CRC_AH_SPANS_MAX)
+					{
+						ah_spans->spans[ah_spans->spans_nr].offset = ext - ip;
+						ah_spans->spans[ah_spans->spans_nr].len = ext_len;
+						ah_spans->spans_nr++;
+					}
+					else
+					{
+						/* too many AH headers, walk the extensions again */
+						ah_spans->ip = NULL;
+					}
+				}
+			}
+			ext = ip_get_next_ext_from_ext(ext, &ext_type);
+		}
+		if(span_len > 0)
+		{
+			crc_static_add(bytes, span, span_len);
 		}
-		ext = ip_get_next_ext_from_ext(ext, &ext_type);
 	}
+}
 
-	return crc;
+
+/**
+ * @brief Start gathering the CRC-STATIC bytes of one packet
+ *
+ * @param bytes      The CRC-STATIC bytes to initialize
+ * @param crc_type   The type of CRC
+ * @param init_val   The initial CRC value
+ * @param crc_table  The pre-computed table for fast CRC computation
+ */
+static void crc_static_start(struct crc_static_bytes *const bytes,
+                             const rohc_crc_type_t crc_type,
+                             const uint8_t init_val,
+                             const uint8_t *const crc_table)
+{
+	bytes->len = 0;
+	bytes->is_too_long = false;
+	bytes->crc_type = crc_type;
+	bytes->init_val = init_val;
+	bytes->crc = init_val;
+	bytes->crc_table = crc_table;
+}
+
+
+/**
+ * @brief Add some CRC-STATIC bytes
+ *
+ * Bytes are copied as long as they fit in the buffer. Once they do not fit
+ * any more, the CRC is computed on the fly and nothing will be cached.
+ *
+ * @param bytes  The CRC-STATIC bytes to complete
+ * @param data   The bytes to add
+ * @param len    The number of bytes to add
+ */
+static void crc_static_add(struct crc_static_bytes *const bytes,
+                           const uint8_t *const data,
+                           const size_t len)
+{
+	if(!bytes->is_too_long && (bytes->len + len) <= ROHC_CRC_STATIC_CACHE_LEN)
+	{
+		memcpy(bytes->data + bytes->len, data, len);
+		bytes->len += len;
+		return;
+	}
+
+	if(!bytes->is_too_long)
+	{
+		bytes->crc = crc_calculate(bytes->crc_type, bytes->data, bytes->len,
+		                           bytes->init_val, bytes->crc_table);
+		bytes->is_too_long = true;
+	}
+	bytes->crc = crc_calculate(bytes->crc_type, data, len, bytes->crc,
+	                           bytes->crc_table);
+}
+
+
+/**
+ * @brief Compute the CRC on the gathered CRC-STATIC bytes
+ *
+ * The CRC is taken from the cache if the CRC-STATIC bytes did not change
+ * since the CRC was computed for the previous packet.
+ *
+ * @param bytes  The CRC-STATIC bytes of the packet
+ * @param cache  The CRC-STATIC cache of the context, NULL if none
+ * @return       The checksum
+ */
+static uint8_t crc_static_end(const struct crc_static_bytes *const bytes,
+                              struct crc_static_cache *const cache)
+{
+	struct crc_static_cached_crc *cached_crc;
+
+	if(bytes->is_too_long)
+	{
+		return bytes->crc;
+	}
+	if(cache == NULL)
+	{
+		return crc_calculate(bytes->crc_type, bytes->data, bytes->len,
+		                     bytes->init_val, bytes->crc_table);
+	}
+
+	/* forget the cached CRCs if the CRC-STATIC bytes changed */
+	if(cache->bytes_nr != bytes->len ||
+	   memcmp(cache->bytes, bytes->data, bytes->len) != 0)
+	{
+		memcpy(cache->bytes, bytes->data, bytes->len);
+		cache->bytes_nr = bytes->len;
+		crc_static_cache_init_crcs(cache);
+	}
+
+	switch(bytes->crc_type)
+	{
+		case ROHC_CRC_TYPE_3:
+			cached_crc = &cache->crc_3;
+			break;
+		case ROHC_CRC_TYPE_7:
+			cached_crc = &cache->crc_7;
+			break;
+		case ROHC_CRC_TYPE_8:
+			cached_crc = &cache->crc_8;
+			break;
+		case ROHC_CRC_TYPE_NONE:
+		default:
+			assert(0);
+			return bytes->init_val;
+	}
+	if(!cached_crc->is_valid || cached_crc->init_val != bytes->init_val)
+	{
+		cached_crc->crc = crc_calculate(bytes->crc_type, bytes->data, bytes->len,
+		                                bytes->init_val, bytes->crc_table);
+		cached_crc->init_val = bytes->init_val;
+		cached_crc->is_valid = true;
+	}
+
+	return cached_crc->crc;
+}
+
+
+/**
+ * @brief Forget all the CRCs of the given CRC-STATIC cache
+ *
+ * @param cache  The CRC-STATIC cache
+ */
+static void crc_static_cache_init_crcs(struct crc_static_cache *const cache)
+{
+	cache->crc_3.is_valid = false;
+	cache->crc_7.is_valid = false;
+	cache->crc_8.is_valid = false;
 }
 
 
 /**
  * @brief Compute the CRC-DYNAMIC part of IPv6 extensions
  *
- * Only entire AH header is concerned.
+ * Only entire AH header is concerned. The AH headers located by the
+ * CRC-STATIC part of the same IP header are used if any, the extensions are
+ * walked otherwise.
  *
  * @param ip          The IPv6 packet
  * @param crc_type    The type of CRC
  * @param init_val    The initial CRC value
  * @param crc_table   The pre-computed table for fast CRC computation
+ * @param ah_spans    The AH headers located by the CRC-STATIC part, NULL if
+ *                    none
  * @return            The checksum
  */
 static uint8_t ipv6_ext_calc_crc_dyn(const uint8_t *const ip,
                                      const rohc_crc_type_t crc_type,
                                      const uint8_t init_val,
-                                     const uint8_t *const crc_table)
+                                     const uint8_t *const crc_table,
+                                     const struct crc_ah_spans *const ah_spans)
 {
 	uint8_t crc = init_val;
 	const uint8_t *ext;
@@ -766,6 +1913,18 @@ static uint8_t ipv6_ext_calc_crc_dyn(const uint8_t *const ip,
 
 	assert(ip != NULL);
 
+	if(ah_spans != NULL && ah_spans->ip == ip)
+	{
+		size_t i;
+
+		for(i = 0; i < ah_spans->spans_nr; i++)
+		{
+			crc = crc_calculate(crc_type, ip + ah_spans->spans[i].offset,
+			                    ah_spans->spans[i].len, crc, crc_table);
+		}
+		return crc;
+	}
+
 	ext = ipv6_get_first_extension(ip, &ext_type);
 	while(ext != NULL)
 	{
@@ -781,46 +1940,6 @@ static uint8_t ipv6_ext_calc_crc_dyn(const uint8_t *const ip,
 }
 
 
-/**
- * @brief Get the polynom for the given CRC type
- *
- * @param crc_type The CRC type
- * @param polynom  IN/OUT: the polynom for the requested CRC type
- * @return         true in case of success, false otherwise
- */
-static bool rohc_crc_get_polynom(const rohc_crc_type_t crc_type,
-                                 uint8_t *const polynom)
-{
-	/* sanity check */
-	assert(polynom != NULL);
-
-	/* determine the polynom for CRC */
-	switch(crc_type)
-	{
-		case ROHC_CRC_TYPE_3:
-			*polynom = 0x6;
-			break;
-		case ROHC_CRC_TYPE_7:
-			*polynom = 0x79;
-			break;
-		case ROHC_CRC_TYPE_8:
-			*polynom = 0xe0;
-			break;
-		case ROHC_CRC_TYPE_NONE:
-		default:
-			/* unknown CRC type, should not happen */
-			assert(0);
-			goto error;
-	}
-
-	/* everything went fine */
-	return true;
-
-error:
-	return false;
-}
-
-
 /**
  * @brief Get the first extension in an IPv6 packet
  *
@@ -853,25 +1972,28 @@ static uint8_t * ipv6_get_first_extension(const uint8_t *const ip,
 
 
 /**
- * @brief Optimized CRC-8 calculation using a table
+ * @brief Compute the CRC-3, CRC-7 or CRC-8 of one block with sliced tables
  *
- * @param buf        The data to compute the CRC for
- * @param size       The size of the data
+ * @param buf        The block of \ref ROHC_CRC_BLOCK_LEN bytes
  * @param init_val   The initial CRC value
+ * @param mask       The mask for the bits of the CRC
  * @param crc_table  The pre-computed table for fast CRC computation
  * @return           The CRC byte
  */
-static inline uint8_t crc_calc_8(const uint8_t *const buf,
-                                 const size_t size,
-                                 const uint8_t init_val,
-                                 const uint8_t *const crc_table)
+static inline uint8_t crc_calc_block(const uint8_t *const buf,
+                                     const uint8_t init_val,
+                                     const uint8_t mask,
+                                     const uint8_t *const crc_table)
 {
 	uint8_t crc = init_val;
 	size_t i;
 
-	for(i = 0; i < size; i++)
+	for(i = 0; i < ROHC_CRC_BLOCK_LEN; i += 4)
 	{
-		crc = crc_table[buf[i] ^ crc];
+		crc = crc_table[3 * 256 + (buf[i] ^ (crc & mask))] ^
+		      crc_table[2 * 256 + buf[i + 1]] ^
+		      crc_table[1 * 256 + buf[i + 2]] ^
+		      crc_table[buf[i + 3]];
 	}
 
 	return crc;
@@ -879,7 +2001,66 @@ static inline uint8_t crc_calc_8(const uint8_t *const buf,
 
 
 /**
- * @brief Optimized CRC-7 calculation using a table
+ * @brief Optimized CRC-3, CRC-7 or CRC-8 calculation using sliced tables
+ *
+ * The data is processed 4 bytes at once with the 4 slices of the table, the
+ * remaining bytes are processed one by one with the first slice.
+ *
+ * The long data (full uncompressed headers, IR packets...) is first processed
+ * by blocks of \ref ROHC_CRC_BLOCK_LEN bytes. The CRC being linear, the CRC
+ * of the data up to the end of one block is the CRC of the block computed
+ * from zero, XOR'ed with the CRC of the previous blocks advanced over the
+ * zero bytes of the block by the skip table. The CRCs of the blocks do not
+ * depend on each other, so the CPU computes them in parallel: only one
+ * lookup per block remains in the dependency chain, instead of one per 4
+ * bytes.
+ *
+ * @param buf         The data to compute the CRC for
+ * @param size        The size of the data
+ * @param init_val    The initial CRC value
+ * @param mask        The mask for the bits of the CRC
+ * @param crc_table   The pre-computed table for fast CRC computation
+ * @param skip_table  The pre-computed table that skips one block of zeroes
+ * @return            The CRC byte
+ */
+static inline uint8_t crc_calc_sliced(const uint8_t *const buf,
+                                      const size_t size,
+                                      const uint8_t init_val,
+                                      const uint8_t mask,
+                                      const uint8_t *const crc_table,
+                                      const uint8_t *const skip_table)
+{
+	uint8_t crc = init_val;
+	size_t i = 0;
+
+	if(size >= (2 * ROHC_CRC_BLOCK_LEN))
+	{
+		crc = crc_calc_block(buf, crc, mask, crc_table);
+		for(i = ROHC_CRC_BLOCK_LEN; (i + ROHC_CRC_BLOCK_LEN) <= size;
+		    i += ROHC_CRC_BLOCK_LEN)
+		{
+			crc = skip_table[crc & mask] ^
+			      crc_calc_block(buf + i, 0, mask, crc_table);
+		}
+	}
+	for(; (i + 4) <= size; i += 4)
+	{
+		crc = crc_table[3 * 256 + (buf[i] ^ (crc & mask))] ^
+		      crc_table[2 * 256 + buf[i + 1]] ^
+		      crc_table[1 * 256 + buf[i + 2]] ^
+		      crc_table[buf[i + 3]];
+	}
+	for(; i < size; i++)
+	{
+		crc = crc_table[buf[i] ^ (crc & mask)];
+	}
+
+	return crc;
+}
+
+
+/**
+ * @brief Optimized CRC-8 calculation using a table
  *
  * @param buf        The data to compute the CRC for
  * @param size       The size of the data
@@ -887,20 +2068,32 @@ static inline uint8_t crc_calc_8(const uint8_t *const buf,
  * @param crc_table  The pre-computed table for fast CRC computation
  * @return           The CRC byte
  */
-static inline uint8_t crc_calc_7(const uint8_t *const buf,
+static inline uint8_t crc_calc_8(const uint8_t *const buf,
                                  const size_t size,
                                  const uint8_t init_val,
                                  const uint8_t *const crc_table)
 {
-	uint8_t crc = init_val;
-	size_t i;
+	return crc_calc_sliced(buf, size, init_val, 0xff, crc_table,
+	                       crc_skip_table_8);
+}
 
-	for(i = 0; i < size; i++)
-	{
-		crc = crc_table[buf[i] ^ (crc & 127)];
-	}
 
-	return crc;
+/**
+ * @brief Optimized CRC-7 calculation using a table
+ *
+ * @param buf        The data to compute the CRC for
+ * @param size       The size of the data
+ * @param init_val   The initial CRC value
+ * @param crc_table  The pre-computed table for fast CRC computation
+ * @return           The CRC byte
+ */
+static inline uint8_t crc_calc_7(const uint8_t *const buf,
+                                 const size_t size,
+                                 const uint8_t init_val,
+                                 const uint8_t *const crc_table)
+{
+	return crc_calc_sliced(buf, size, init_val, 127, crc_table,
+	                       crc_skip_table_7);
 }
 
 
@@ -918,14 +2111,7 @@ static inline uint8_t crc_calc_3(const uint8_t *const buf,
                                  const uint8_t init_val,
                                  const uint8_t *const crc_table)
 {
-	uint8_t crc = init_val;
-	size_t i;
-
-	for(i = 0; i < size; i++)
-	{
-		crc = crc_table[buf[i] ^ (crc & 7)];
-	}
-
-	return crc;
+	return crc_calc_sliced(buf, size, init_val, 7, crc_table,
+	                       crc_skip_table_3);
 }
 
@@ -47,11 +47,34 @@
 /// The CRC-8 initial value
 #define CRC_INIT_8 0xff
 
+/** Whether the FCS-32 may be computed with the x86 carry-less multiplication */
+#if !defined(__KERNEL__) && defined(__GNUC__) && defined(__x86_64__)
+#  define ROHC_CRC_HAVE_PCLMUL 1
+#else
+#  define ROHC_CRC_HAVE_PCLMUL 0
+#endif
+
+/** Whether the FCS-32 may be computed with the ARMv8 CRC32 instructions */
+#if !defined(__KERNEL__) && defined(__aarch64__) && !defined(__AARCH64EB__) && \
+    (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 9))
+#  define ROHC_CRC_HAVE_ARM_CRC32 1
+#else
+#  define ROHC_CRC_HAVE_ARM_CRC32 0
+#endif
+
 /** The FCS-32 initial value */
 #define CRC_INIT_FCS32 0xffffffff
 /** The length (in bytes) of the FCS-32 CRC */
 #define CRC_FCS32_LEN  4U
 
+/** The number of slices of 256 bytes in one CRC-3, CRC-7 or CRC-8 table */
+#define ROHC_CRC_TABLE_SLICES  4U
+/** The length (in bytes) of one CRC-3, CRC-7 or CRC-8 table */
+#define ROHC_CRC_TABLE_LEN  (ROHC_CRC_TABLE_SLICES * 256U)
+
+/** The maximum number of CRC-STATIC bytes one context may cache */
+#define ROHC_CRC_STATIC_CACHE_LEN  96U
+
 /** The different types of CRC used to protect ROHC headers */
 typedef enum
 {
@@ -62,13 +85,78 @@ typedef enum
 } rohc_crc_type_t;
 
 
+/** One CRC computed on the cached CRC-STATIC bytes */
+struct crc_static_cached_crc
+{
+	uint8_t init_val;  /**< The initial value the CRC was computed with */
+	uint8_t crc;       /**< The CRC computed on the CRC-STATIC bytes */
+	bool is_valid;     /**< Whether the CRC was computed or not */
+};
+
+
+/** The maximum number of AH headers recorded per IP header */
+#define ROHC_CRC_AH_SPANS_MAX  2U
+
+
+/**
+ * @brief The AH headers in the IPv6 extensions of one IP header
+ *
+ * The AH headers are the only IPv6 extensions that are CRC-DYNAMIC. They are
+ * located when the extensions are walked for the CRC-STATIC part, so that
+ * the CRC-DYNAMIC part is computed on them without walking the extensions
+ * again.
+ */
+struct crc_ah_spans
+{
+	/** The IP header the AH headers were located in, NULL if none */
+	const uint8_t *ip;
+	/** The number of AH headers */
+	size_t spans_nr;
+	/** The AH headers, as offsets and lengths from the IP header */
+	struct
+	{
+		uint16_t offset;  /**< The offset of the AH header */
+		uint16_t len;     /**< The length of the AH header */
+	} spans[ROHC_CRC_AH_SPANS_MAX];
+};
+
+
+/**
+ * @brief The CRC-STATIC bytes of the last packet of one context
+ *
+ * The CRC-STATIC fields of one flow seldom change, so the CRC computed on
+ * them is kept as long as the fields stay the same. Only the CRC-DYNAMIC
+ * fields then need to be hashed for every packet.
+ */
+struct crc_static_cache
+{
+	/** The CRC-STATIC bytes the cached CRCs were computed on */
+	uint8_t bytes[ROHC_CRC_STATIC_CACHE_LEN];
+	/** The number of CRC-STATIC bytes, 0 if none was cached yet */
+	size_t bytes_nr;
+	struct crc_static_cached_crc crc_3;  /**< The cached CRC-3 */
+	struct crc_static_cached_crc crc_7;  /**< The cached CRC-7 */
+	struct crc_static_cached_crc crc_8;  /**< The cached CRC-8 */
+	/** The AH headers of the outer and inner IP headers of the last packet */
+	struct crc_ah_spans ah_spans[2];
+};
+
+
+/*
+ * The pre-computed CRC tables, shared by all compressors and decompressors
+ */
+
+extern const uint8_t rohc_crc_table_3[ROHC_CRC_TABLE_LEN];
+extern const uint8_t rohc_crc_table_7[ROHC_CRC_TABLE_LEN];
+extern const uint8_t rohc_crc_table_8[ROHC_CRC_TABLE_LEN];
+
+
 /*
  * Function prototypes.
  */
 
-bool rohc_crc_init_table(uint8_t *const table,
-                         const rohc_crc_type_t crc_type)
-	__attribute__((nonnull(1), warn_unused_result));
+void crc_static_cache_init(struct crc_static_cache *const cache)
+	__attribute__((nonnull(1)));
 
 uint8_t crc_calculate(const rohc_crc_type_t crc_type,
                       const uint8_t *const data,
@@ -82,19 +170,40 @@ uint32_t crc_calc_fcs32(const uint8_t *const data,
                         const uint32_t init_val)
 	__attribute__((nonnull(1), warn_unused_result, pure));
 
+uint32_t crc_calc_fcs32_generic(const uint8_t *const data,
+                                const size_t length,
+                                const uint32_t init_val)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+
+#if ROHC_CRC_HAVE_PCLMUL == 1
+uint32_t crc_calc_fcs32_pclmul(const uint8_t *const data,
+                               const size_t length,
+                               const uint32_t init_val)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+#endif
+
+#if ROHC_CRC_HAVE_ARM_CRC32 == 1
+uint32_t crc_calc_fcs32_arm(const uint8_t *const data,
+                            const size_t length,
+                            const uint32_t init_val)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+#endif
+
 uint8_t compute_crc_static(const uint8_t *const outer_ip,
                            const uint8_t *const inner_ip,
                            const uint8_t *const next_header,
                            const rohc_crc_type_t crc_type,
                            const uint8_t init_val,
-                           const uint8_t *const crc_table)
+                           const uint8_t *const crc_table,
+                           struct crc_static_cache *const cache)
 	__attribute__((nonnull(1, 6), warn_unused_result));
 uint8_t compute_crc_dynamic(const uint8_t *const outer_ip,
                             const uint8_t *const inner_ip,
                             const uint8_t *const next_header,
                             const rohc_crc_type_t crc_type,
                             const uint8_t init_val,
-                            const uint8_t *const crc_table)
+                            const uint8_t *const crc_table,
+                            const struct crc_static_cache *const cache)
 	__attribute__((nonnull(1, 6), warn_unused_result));
 
 uint8_t udp_compute_crc_static(const uint8_t *const outer_ip,
@@ -102,14 +211,16 @@ uint8_t udp_compute_crc_static(const uint8_t *const outer_ip,
                                const uint8_t *const next_header,
                                const rohc_crc_type_t crc_type,
                                const uint8_t init_val,
-                               const uint8_t *const crc_table)
+                               const uint8_t *const crc_table,
+                               struct crc_static_cache *const cache)
 	__attribute__((nonnull(1, 3, 6), warn_unused_result));
 uint8_t udp_compute_crc_dynamic(const uint8_t *const outer_ip,
                                 const uint8_t *const inner_ip,
                                 const uint8_t *const next_header,
                                 const rohc_crc_type_t crc_type,
                                 const uint8_t init_val,
-                                const uint8_t *const crc_table)
+                                const uint8_t *const crc_table,
+                                const struct crc_static_cache *const cache)
 	__attribute__((nonnull(1, 3, 6), warn_unused_result));
 
 uint8_t esp_compute_crc_static(const uint8_t *const outer_ip,
@@ -117,14 +228,16 @@ uint8_t esp_compute_crc_static(const uint8_t *const outer_ip,
                                const uint8_t *const next_header,
                                const rohc_crc_type_t crc_type,
                                const uint8_t init_val,
-                               const uint8_t *const crc_table)
+                               const uint8_t *const crc_table,
+                               struct crc_static_cache *const cache)
 	__attribute__((nonnull(1, 3, 6), warn_unused_result));
 uint8_t esp_compute_crc_dynamic(const uint8_t *const outer_ip,
                                 const uint8_t *const inner_ip,
                                 const uint8_t *const next_header,
                                 const rohc_crc_type_t crc_type,
                                 const uint8_t init_val,
-                                const uint8_t *const crc_table)
+                                const uint8_t *const crc_table,
+                                const struct crc_static_cache *const cache)
 	__attribute__((nonnull(1, 3, 6), warn_unused_result));
 
 uint8_t rtp_compute_crc_static(const uint8_t *const outer_ip,
@@ -132,15 +245,23 @@ uint8_t rtp_compute_crc_static(const uint8_t *const outer_ip,
                                const uint8_t *const next_header,
                                const rohc_crc_type_t crc_type,
                                const uint8_t init_val,
-                               const uint8_t *const crc_table)
+                               const uint8_t *const crc_table,
+                               struct crc_static_cache *const cache)
 	__attribute__((nonnull(1, 3, 6), warn_unused_result));
 uint8_t rtp_compute_crc_dynamic(const uint8_t *const outer_ip,
                                 const uint8_t *const inner_ip,
                                 const uint8_t *const next_header,
                                 const rohc_crc_type_t crc_type,
                                 const uint8_t init_val,
-                                const uint8_t *const crc_table)
+                                const uint8_t *const crc_table,
+                                const struct crc_static_cache *const cache)
 	__attribute__((nonnull(1, 3, 6), warn_unused_result));
 
+uint8_t compute_crc_ctrl_fields(const uint8_t reorder_ratio,
+                                const uint16_t msn,
+                                const uint8_t ip_id_behaviors[],
+                                const size_t ip_id_behaviors_nr)
+	__attribute__((nonnull(3), warn_unused_result));
+
 #endif
 
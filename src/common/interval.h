@@ -45,6 +45,7 @@ typedef enum
 #define ROHC_LSB_SHIFT_TCP_TS_1B  ROHC_LSB_SHIFT_SN /**< real value for TCP TS */
 #define ROHC_LSB_SHIFT_TCP_TS_2B  ROHC_LSB_SHIFT_SN /**< real value for TCP TS */
 	ROHC_LSB_SHIFT_IP_ID      =  0,      /**< real value for IP-ID */
+	ROHC_LSB_SHIFT_ROHCV2_MSN =  1,      /**< real value for ROHCv2 MSN */
 	ROHC_LSB_SHIFT_TCP_TTL    =  3,      /**< real value for TCP TTL/HL */
 #define ROHC_LSB_SHIFT_TCP_ACK_SCALED  ROHC_LSB_SHIFT_TCP_TTL
 	ROHC_LSB_SHIFT_TCP_SN     =  4,      /**< real value for TCP MSN */
@@ -197,6 +198,7 @@ static inline int32_t rohc_interval_compute_p(const size_t k,
 
 		case ROHC_LSB_SHIFT_SN:
 		case ROHC_LSB_SHIFT_IP_ID:
+		case ROHC_LSB_SHIFT_ROHCV2_MSN:
 		case ROHC_LSB_SHIFT_TCP_TTL:
 		case ROHC_LSB_SHIFT_TCP_SN:
 		case ROHC_LSB_SHIFT_TCP_SEQ_SCALED:
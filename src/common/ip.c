@@ -191,6 +191,95 @@ error:
 }
 
 
+/**
+ * @brief Create an IP packet from raw data and the known location of its
+ *        next layer
+ *
+ * Create the IP packet as \ref ip_create does, but take the location and
+ * the protocol of the next layer from the caller instead of walking the
+ * IPv6 extension headers. The given location is checked against the IP
+ * header, but the IPv6 extension headers in between are trusted.
+ *
+ * @param ip         OUT: The IP packet to create
+ * @param packet     The IP packet data
+ * @param size       The length of the IP packet data
+ * @param nl_offset  The offset of the next layer in the IP packet data,
+ *                   after the IPv6 extension headers if any
+ * @param nl_proto   The protocol of the next layer
+ * @return           true if the IP packet was created, false if it is not
+ *                   one well-formed IPv4 or IPv6 packet or if the next layer
+ *                   does not match the IP header
+ */
+bool ip_create_hinted(struct ip_packet *const ip,
+                      const uint8_t *const packet,
+                      const size_t size,
+                      const size_t nl_offset,
+                      const uint8_t nl_proto)
+{
+	if(size < sizeof(struct ip_hdr) || nl_offset > size)
+	{
+		goto error;
+	}
+	ip->version = ((const struct ip_hdr *) packet)->version;
+
+	if(ip->version == IPV4)
+	{
+		/* no IPv4 extension headers, the next layer is the next header */
+		if(size < sizeof(struct ipv4_hdr))
+		{
+			goto error;
+		}
+		memcpy(&ip->header.v4, packet, sizeof(struct ipv4_hdr));
+		if(ip_get_hdrlen(ip) < sizeof(struct ipv4_hdr) ||
+		   ip_get_hdrlen(ip) != nl_offset ||
+		   ip->header.v4.protocol != nl_proto ||
+		   ip_get_totlen(ip) != size)
+		{
+			goto error;
+		}
+		ip->nh.proto = nl_proto;
+		ip->nh.data = ((uint8_t *) packet) + nl_offset;
+		ip->nh.len = size - nl_offset;
+	}
+	else if(ip->version == IPV6)
+	{
+		/* the extension headers, if any, are between the IPv6 header and
+		 * the next layer */
+		if(size < sizeof(struct ipv6_hdr) || nl_offset < sizeof(struct ipv6_hdr))
+		{
+			goto error;
+		}
+		memcpy(&ip->header.v6, packet, sizeof(struct ipv6_hdr));
+		if(ip_get_totlen(ip) != size || rohc_is_ipv6_opt(nl_proto))
+		{
+			goto error;
+		}
+		if(nl_offset == sizeof(struct ipv6_hdr) ?
+		   ip->header.v6.nh != nl_proto : !rohc_is_ipv6_opt(ip->header.v6.nh))
+		{
+			goto error;
+		}
+		ip->nh.proto = ip->header.v6.nh;
+		ip->nh.data = ((uint8_t *) packet) + sizeof(struct ipv6_hdr);
+		ip->nh.len = size - sizeof(struct ipv6_hdr);
+	}
+	else
+	{
+		goto error;
+	}
+	ip->data = packet;
+	ip->size = size;
+	ip->nl.proto = nl_proto;
+	ip->nl.data = ((uint8_t *) packet) + nl_offset;
+	ip->nl.len = size - nl_offset;
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Get the IP raw data (header + payload)
  *
@@ -378,6 +467,21 @@ unsigned short ip_get_total_extension_size(const struct ip_packet *const ip)
 }
 
 
+/**
+ * @brief Get the length of the extension list found while parsing the packet
+ *
+ * Same as \ref ip_get_total_extension_size, but without walking through the
+ * extension headers again.
+ *
+ * @param ip The packet to analyse
+ * @return   The length of the extension list, 0 if there is none
+ */
+size_t ip_get_exts_len(const struct ip_packet *const ip)
+{
+	return (ip->nh.len - ip->nl.len);
+}
+
+
 /**
  * @brief Whether the IP packet is an IP fragment or not
  *
@@ -283,6 +283,38 @@ out:
 #endif /* __KERNEL__ */
 
 
+static inline uint16_t ip_csum_replace2(const uint16_t check,
+                                        const uint16_t old_word,
+                                        const uint16_t new_word)
+	__attribute__((warn_unused_result, const));
+
+/**
+ * @brief Update an Internet checksum after one 16-bit word changed
+ *
+ * The checksum is updated incrementally as in equation 3 of RFC 1624:
+ * HC' = ~(~HC + ~m + m'), so that the other bytes are not read again. The
+ * checksum and the words shall be in the same byte order.
+ *
+ * @param check     The checksum before the change
+ * @param old_word  The 16-bit word before the change
+ * @param new_word  The 16-bit word after the change
+ * @return          The checksum after the change
+ */
+static inline uint16_t ip_csum_replace2(const uint16_t check,
+                                        const uint16_t old_word,
+                                        const uint16_t new_word)
+{
+	uint32_t sum = (uint16_t) ~check;
+
+	sum += (uint16_t) ~old_word;
+	sum += new_word;
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+
+	return (uint16_t) ~sum;
+}
+
+
 /*
  * Function prototypes.
  */
@@ -293,6 +325,12 @@ bool ip_create(struct ip_packet *const ip,
                const uint8_t *const packet,
                const size_t size)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+bool ip_create_hinted(struct ip_packet *const ip,
+                      const uint8_t *const packet,
+                      const size_t size,
+                      const size_t nl_offset,
+                      const uint8_t nl_proto)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 bool ip_get_inner_packet(const struct ip_packet *const outer,
                          struct ip_packet *const inner)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
@@ -376,6 +414,8 @@ unsigned short ip_get_extension_size(const uint8_t *const ext)
 	__attribute__((warn_unused_result, nonnull(1), pure));
 unsigned short ip_get_total_extension_size(const struct ip_packet *const ip)
 	__attribute__((warn_unused_result, nonnull(1)));
+size_t ip_get_exts_len(const struct ip_packet *const ip)
+	__attribute__((warn_unused_result, nonnull(1), pure));
 
 
 #endif
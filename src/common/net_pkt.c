@@ -28,12 +28,45 @@
 #include "protocols/ip_numbers.h"
 #include "rohc_traces_internal.h"
 
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
+
+
+static void net_pkt_parse_hdrs(struct net_pkt_hdrs *const hdrs,
+                               const uint8_t *const data,
+                               const size_t len)
+	__attribute__((nonnull(1)));
+
+static bool net_pkt_parse_hints(struct net_pkt *const packet,
+                                const struct net_pkt_hints *const hints)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static uint8_t net_pkt_get_ip_anomalies(const struct ip_packet *const ip,
+                                        const bool csum_good)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static rohc_ctxt_key_t net_pkt_get_flow_key(const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static uint32_t net_pkt_hash_ip_addrs(uint32_t hash,
+                                      const struct ip_packet *const ip)
+	__attribute__((warn_unused_result, nonnull(2), pure));
+
+static inline uint32_t net_pkt_hash_mix(const uint32_t hash,
+                                        const uint32_t value)
+	__attribute__((warn_unused_result, const));
+
 
 /**
  * @brief Parse a network packet
  *
  * @param[out] packet    The parsed packet
  * @param data           The data to parse
+ * @param flow_key       Whether to build the key of the packet from the whole
+ *                       flow (addresses, protocol, ports or SPI and inner IP
+ *                       header) or from the outer IP addresses only, the key
+ *                       of ESP packets is always built from the whole flow
  * @param trace_cb       The function to call for printing traces
  * @param trace_cb_priv  An optional private context, may be NULL
  * @param trace_entity   The entity that emits the traces
@@ -43,27 +76,82 @@
  */
 bool net_pkt_parse(struct net_pkt *const packet,
                    const struct rohc_buf data,
+                   const bool flow_key,
                    rohc_trace_callback2_t trace_cb,
                    void *const trace_cb_priv,
                    rohc_trace_entity_t trace_entity)
 {
+	return net_pkt_parse_hinted(packet, data, NULL, flow_key, trace_cb,
+	                            trace_cb_priv, trace_entity);
+}
+
+
+/**
+ * @brief Parse a network packet with the help of the caller
+ *
+ * Parse the packet as \ref net_pkt_parse does, but take the locations of
+ * the headers and the state of the IPv4 checksums from the given hints if
+ * any, instead of finding them again.
+ *
+ * @param[out] packet    The parsed packet
+ * @param data           The data to parse
+ * @param hints          The locations of the headers known beforehand,
+ *                       NULL if none
+ * @param flow_key       See \ref net_pkt_parse
+ * @param trace_cb       The function to call for printing traces
+ * @param trace_cb_priv  An optional private context, may be NULL
+ * @param trace_entity   The entity that emits the traces
+ * @return               true if the packet was successfully parsed,
+ *                       false if a problem occurred (a malformed packet is
+ *                       not considered as an error)
+ */
+bool net_pkt_parse_hinted(struct net_pkt *const packet,
+                          const struct rohc_buf data,
+                          const struct net_pkt_hints *const hints,
+                          const bool flow_key,
+                          rohc_trace_callback2_t trace_cb,
+                          void *const trace_cb_priv,
+                          rohc_trace_entity_t trace_entity)
+{
+	const bool csum_good = (hints != NULL && hints->ipv4_csums_good);
+	bool is_hinted = false;
+
 	packet->data = rohc_buf_data(data);
 	packet->len = data.len;
 	packet->ip_hdr_nr = 0;
+	packet->ip_anomalies = 0;
 	packet->key = 0;
+	packet->time = data.time;
 
 	/* traces */
 	packet->trace_callback = trace_cb;
 	packet->trace_callback_priv = trace_cb_priv;
 
-	/* create the outer IP packet from raw data */
-	if(!ip_create(&packet->outer_ip, rohc_buf_data(data), data.len))
+	/* locate all the headers once for all, unless they are already known */
+	if(hints != NULL && hints->has_offsets)
 	{
-		rohc_warning(packet, trace_entity, ROHC_PROFILE_GENERAL,
-		             "cannot create the outer IP header");
-		goto error;
+		is_hinted = net_pkt_parse_hints(packet, hints);
+		if(!is_hinted)
+		{
+			rohc_debug(packet, trace_entity, ROHC_PROFILE_GENERAL,
+			           "given header offsets do not match the packet, parse it");
+		}
+	}
+	if(!is_hinted)
+	{
+		net_pkt_parse_hdrs(&packet->hdrs, rohc_buf_data(data), data.len);
+
+		/* create the outer IP packet from raw data */
+		if(!ip_create(&packet->outer_ip, rohc_buf_data(data), data.len))
+		{
+			rohc_warning(packet, trace_entity, ROHC_PROFILE_GENERAL,
+			             "cannot create the outer IP header");
+			goto error;
+		}
 	}
 	packet->ip_hdr_nr++;
+	packet->ip_anomalies |=
+		net_pkt_get_ip_anomalies(&packet->outer_ip, csum_good);
 	rohc_debug(packet, trace_entity, ROHC_PROFILE_GENERAL,
 	           "outer IP header: %u bytes", ip_get_totlen(&packet->outer_ip));
 	rohc_debug(packet, trace_entity, ROHC_PROFILE_GENERAL,
@@ -82,23 +170,26 @@ bool net_pkt_parse(struct net_pkt *const packet,
 	}
 
 	/* build the hash key for the packet */
-	if(ip_get_version(&packet->outer_ip) == IPV4)
-	{
-		packet->key ^= ipv4_get_saddr(&packet->outer_ip);
-		packet->key ^= ipv4_get_daddr(&packet->outer_ip);
-	}
-	else if(ip_get_version(&packet->outer_ip) == IPV6)
+	if(!flow_key)
 	{
-		const struct ipv6_addr *const saddr = ipv6_get_saddr(&packet->outer_ip);
-		const struct ipv6_addr *const daddr = ipv6_get_daddr(&packet->outer_ip);
-		packet->key ^= saddr->u32[0];
-		packet->key ^= saddr->u32[1];
-		packet->key ^= saddr->u32[2];
-		packet->key ^= saddr->u32[3];
-		packet->key ^= daddr->u32[0];
-		packet->key ^= daddr->u32[1];
-		packet->key ^= daddr->u32[2];
-		packet->key ^= daddr->u32[3];
+		if(ip_get_version(&packet->outer_ip) == IPV4)
+		{
+			packet->key ^= ipv4_get_saddr(&packet->outer_ip);
+			packet->key ^= ipv4_get_daddr(&packet->outer_ip);
+		}
+		else if(ip_get_version(&packet->outer_ip) == IPV6)
+		{
+			const struct ipv6_addr *const saddr = ipv6_get_saddr(&packet->outer_ip);
+			const struct ipv6_addr *const daddr = ipv6_get_daddr(&packet->outer_ip);
+			packet->key ^= saddr->u32[0];
+			packet->key ^= saddr->u32[1];
+			packet->key ^= saddr->u32[2];
+			packet->key ^= saddr->u32[3];
+			packet->key ^= daddr->u32[0];
+			packet->key ^= daddr->u32[1];
+			packet->key ^= daddr->u32[2];
+			packet->key ^= daddr->u32[3];
+		}
 	}
 
 	/* get the transport protocol */
@@ -107,14 +198,17 @@ bool net_pkt_parse(struct net_pkt *const packet,
 	/* is there any inner IP header? */
 	if(rohc_is_tunneling(packet->transport->proto))
 	{
-		/* create the second IP header */
-		if(!ip_get_inner_packet(&packet->outer_ip, &packet->inner_ip))
+		/* create the second IP header, unless it is already created */
+		if(!is_hinted &&
+		   !ip_get_inner_packet(&packet->outer_ip, &packet->inner_ip))
 		{
 			rohc_warning(packet, trace_entity, ROHC_PROFILE_GENERAL,
 			             "cannot create the inner IP header");
 			goto error;
 		}
 		packet->ip_hdr_nr++;
+		packet->ip_anomalies |=
+			net_pkt_get_ip_anomalies(&packet->inner_ip, csum_good);
 		rohc_debug(packet, trace_entity, ROHC_PROFILE_GENERAL,
 		           "inner IP header: %u bytes", ip_get_totlen(&packet->inner_ip));
 		rohc_debug(packet, trace_entity, ROHC_PROFILE_GENERAL,
@@ -136,6 +230,14 @@ bool net_pkt_parse(struct net_pkt *const packet,
 		packet->transport = &packet->inner_ip.nl;
 	}
 
+	/* build the hash key for the whole flow once all headers are parsed, the
+	 * SPI is always part of the key of ESP packets since the many SAs of
+	 * IPsec tunnels are usually established between the same gateways */
+	if(flow_key || packet->transport->proto == ROHC_IPPROTO_ESP)
+	{
+		packet->key = net_pkt_get_flow_key(packet);
+	}
+
 	return true;
 
 error:
@@ -171,3 +273,344 @@ size_t net_pkt_get_payload_offset(const struct net_pkt *const packet)
 	return payload_offset;
 }
 
+
+/**
+ * @brief Locate all the headers of a network packet
+ *
+ * The IP headers and their IPv6 extension headers are walked until the
+ * transport header is reached. The walk stops without reaching it if the
+ * packet is too short for one header, if one IP version is unknown, or if
+ * there are more than \ref NET_PKT_IP_HDRS_MAX IP headers.
+ *
+ * @param[out] hdrs  The locations of the headers
+ * @param data       The packet data
+ * @param len        The length (in bytes) of the packet data
+ */
+static void net_pkt_parse_hdrs(struct net_pkt_hdrs *const hdrs,
+                               const uint8_t *const data,
+                               const size_t len)
+{
+	uint8_t proto = ROHC_IPPROTO_IPIP;
+	size_t offset = 0;
+
+	hdrs->ip_nr = 0;
+	hdrs->is_complete = false;
+
+	while(rohc_is_tunneling(proto) && hdrs->ip_nr < NET_PKT_IP_HDRS_MAX)
+	{
+		struct net_pkt_ip_hdr *const ip = &hdrs->ip[hdrs->ip_nr];
+
+		if(offset >= len)
+		{
+			return;
+		}
+		ip->offset = offset;
+		ip->version = (data[offset] >> 4) & 0x0f;
+		ip->exts_len = 0;
+
+		if(ip->version == IPV4)
+		{
+			const struct ipv4_hdr *const ipv4 =
+				(const struct ipv4_hdr *) (data + offset);
+			size_t hdr_len;
+
+			if((len - offset) < sizeof(struct ipv4_hdr))
+			{
+				return;
+			}
+			hdr_len = ipv4->ihl * sizeof(uint32_t);
+			if(hdr_len < sizeof(struct ipv4_hdr) || hdr_len > (len - offset))
+			{
+				return;
+			}
+			proto = ipv4->protocol;
+			offset += hdr_len;
+		}
+		else if(ip->version == IPV6)
+		{
+			const struct ipv6_hdr *const ipv6 =
+				(const struct ipv6_hdr *) (data + offset);
+			size_t exts_offset;
+
+			if((len - offset) < sizeof(struct ipv6_hdr))
+			{
+				return;
+			}
+			proto = ipv6->nh;
+			offset += sizeof(struct ipv6_hdr);
+
+			/* skip the IPv6 extension headers */
+			exts_offset = offset;
+			while(rohc_is_ipv6_opt(proto))
+			{
+				const struct ipv6_opt *const opt =
+					(const struct ipv6_opt *) (data + offset);
+				size_t opt_len;
+
+				if((len - offset) < (sizeof(struct ipv6_opt) - 1))
+				{
+					return;
+				}
+				opt_len = ipv6_opt_get_length(opt);
+				if(opt_len > (len - offset))
+				{
+					return;
+				}
+				proto = opt->next_header;
+				offset += opt_len;
+			}
+			ip->exts_len = offset - exts_offset;
+		}
+		else
+		{
+			return;
+		}
+		ip->next_proto = proto;
+		hdrs->ip_nr++;
+	}
+
+	/* too many IP headers */
+	if(rohc_is_tunneling(proto))
+	{
+		return;
+	}
+
+	hdrs->transport_proto = proto;
+	hdrs->transport_offset = offset;
+	hdrs->is_complete = true;
+}
+
+
+/**
+ * @brief Locate all the headers of a network packet from the given hints
+ *
+ * The outer and inner IP headers are created from the given offsets, see
+ * \ref ip_create_hinted, without walking their IPv6 extension headers. At
+ * most two IP headers may be given.
+ *
+ * @param[in,out] packet  The packet to locate the headers of
+ * @param hints           The locations of the headers
+ * @return                true if the hints match the packet,
+ *                        false if the packet shall be parsed as usual
+ */
+static bool net_pkt_parse_hints(struct net_pkt *const packet,
+                                const struct net_pkt_hints *const hints)
+{
+	struct net_pkt_hdrs *const hdrs = &packet->hdrs;
+	const size_t inner_offset = hints->inner_ip_offset;
+	const size_t transport_offset = hints->transport_offset;
+	size_t i;
+
+	if(rohc_is_tunneling(hints->transport_proto) ||
+	   transport_offset > packet->len ||
+	   (inner_offset != 0 && inner_offset >= transport_offset))
+	{
+		goto error;
+	}
+
+	if(inner_offset == 0)
+	{
+		if(!ip_create_hinted(&packet->outer_ip, packet->data, packet->len,
+		                     transport_offset, hints->transport_proto))
+		{
+			goto error;
+		}
+		hdrs->ip_nr = 1;
+	}
+	else
+	{
+		const uint8_t inner_version = (packet->data[inner_offset] >> 4) & 0x0f;
+		const uint8_t inner_proto =
+			(inner_version == IPV4 ? ROHC_IPPROTO_IPIP : ROHC_IPPROTO_IPV6);
+
+		if(!ip_create_hinted(&packet->outer_ip, packet->data, packet->len,
+		                     inner_offset, inner_proto) ||
+		   !ip_create_hinted(&packet->inner_ip, packet->outer_ip.nl.data,
+		                     packet->outer_ip.nl.len,
+		                     transport_offset - inner_offset,
+		                     hints->transport_proto))
+		{
+			goto error;
+		}
+		hdrs->ip_nr = 2;
+	}
+
+	/* the same locations as net_pkt_parse_hdrs() would find */
+	hdrs->ip[0].offset = 0;
+	hdrs->ip[1].offset = inner_offset;
+	for(i = 0; i < hdrs->ip_nr; i++)
+	{
+		const struct ip_packet *const ip =
+			(i == 0 ? &packet->outer_ip : &packet->inner_ip);
+
+		hdrs->ip[i].version = ip->version;
+		hdrs->ip[i].next_proto = ip->nl.proto;
+		hdrs->ip[i].exts_len = (ip->version == IPV6 ?
+		                        (ip->nl.data - ip->nh.data) : 0);
+	}
+	hdrs->transport_proto = hints->transport_proto;
+	hdrs->transport_offset = transport_offset;
+	hdrs->is_complete = true;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Find the anomalies of one IP header that prevent its compression
+ *
+ * The IP fragments, the IPv4 options and the bad IPv4 checksums are rejected
+ * by all the compression profiles but the Uncompressed one: they are found
+ * once for all the profiles.
+ *
+ * @param ip         The IP header to check
+ * @param csum_good  Whether the checksum of the IPv4 header is known to be
+ *                   good, so that it is not computed again
+ * @return           The anomalies found, see \ref NET_PKT_IP_FRAGMENT,
+ *                   \ref NET_PKT_IPV4_OPTIONS and \ref NET_PKT_IPV4_BAD_CSUM
+ */
+static uint8_t net_pkt_get_ip_anomalies(const struct ip_packet *const ip,
+                                        const bool csum_good)
+{
+	uint8_t anomalies = 0;
+
+	if(ip->version == IPV4)
+	{
+		if(ip_get_hdrlen(ip) != sizeof(struct ipv4_hdr))
+		{
+			anomalies |= NET_PKT_IPV4_OPTIONS;
+		}
+		else if(!csum_good &&
+		        ip_fast_csum(ip->data,
+		                     sizeof(struct ipv4_hdr) / sizeof(uint32_t)) != 0)
+		{
+			anomalies |= NET_PKT_IPV4_BAD_CSUM;
+		}
+		if(ipv4_is_fragment(&ip->header.v4))
+		{
+			anomalies |= NET_PKT_IP_FRAGMENT;
+		}
+	}
+
+	return anomalies;
+}
+
+
+/**
+ * @brief Build the key of a network packet from its whole flow
+ *
+ * The key is a hash of the IP addresses of all the IP headers, of the
+ * transport protocol, and of the transport ports (UDP, UDP-Lite, TCP) or
+ * SPI (ESP) if available. Packets that belong to the same ROHC context
+ * always get the same key, while packets of different flows between the
+ * same hosts most probably get different keys.
+ *
+ * @param packet  The parsed packet
+ * @return        The key of the packet
+ */
+static rohc_ctxt_key_t net_pkt_get_flow_key(const struct net_pkt *const packet)
+{
+	uint32_t hash = 0;
+
+	/* IP addresses of outer and inner IP headers */
+	hash = net_pkt_hash_ip_addrs(hash, &packet->outer_ip);
+	if(packet->ip_hdr_nr > 1)
+	{
+		hash = net_pkt_hash_ip_addrs(hash, &packet->inner_ip);
+	}
+
+	/* transport protocol, then ports or SPI of non-fragmented packets */
+	hash = net_pkt_hash_mix(hash, packet->transport->proto);
+	if(packet->transport->data != NULL &&
+	   packet->transport->len >= sizeof(uint32_t) &&
+	   !ip_is_fragment(&packet->outer_ip) &&
+	   (packet->ip_hdr_nr == 1 || !ip_is_fragment(&packet->inner_ip)))
+	{
+		uint32_t ports_or_spi;
+
+		switch(packet->transport->proto)
+		{
+			case ROHC_IPPROTO_UDP:
+			case ROHC_IPPROTO_UDPLITE:
+			case ROHC_IPPROTO_TCP:
+			case ROHC_IPPROTO_ESP:
+				/* source and destination ports, or SPI */
+				memcpy(&ports_or_spi, packet->transport->data, sizeof(uint32_t));
+				hash = net_pkt_hash_mix(hash, ports_or_spi);
+				break;
+			default:
+				break;
+		}
+	}
+
+	/* final avalanche (MurmurHash3 finalizer) */
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bU;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35U;
+	hash ^= hash >> 16;
+
+	return hash;
+}
+
+
+/**
+ * @brief Add the IP addresses of one IP header to a flow hash
+ *
+ * @param hash  The current hash value
+ * @param ip    The IP header
+ * @return      The updated hash value
+ */
+static uint32_t net_pkt_hash_ip_addrs(uint32_t hash,
+                                      const struct ip_packet *const ip)
+{
+	if(ip_get_version(ip) == IPV4)
+	{
+		hash = net_pkt_hash_mix(hash, ipv4_get_saddr(ip));
+		hash = net_pkt_hash_mix(hash, ipv4_get_daddr(ip));
+	}
+	else if(ip_get_version(ip) == IPV6)
+	{
+		const struct ipv6_addr *const saddr = ipv6_get_saddr(ip);
+		const struct ipv6_addr *const daddr = ipv6_get_daddr(ip);
+		size_t i;
+
+		for(i = 0; i < 4; i++)
+		{
+			hash = net_pkt_hash_mix(hash, saddr->u32[i]);
+		}
+		for(i = 0; i < 4; i++)
+		{
+			hash = net_pkt_hash_mix(hash, daddr->u32[i]);
+		}
+	}
+
+	return hash;
+}
+
+
+/**
+ * @brief Mix one 32-bit value into a flow hash
+ *
+ * One round of the MurmurHash3 32-bit body.
+ *
+ * @param hash   The current hash value
+ * @param value  The value to mix into the hash
+ * @return       The updated hash value
+ */
+static inline uint32_t net_pkt_hash_mix(const uint32_t hash,
+                                        const uint32_t value)
+{
+	uint32_t k = value * 0xcc9e2d51U;
+	uint32_t h;
+
+	k = (k << 15) | (k >> 17);
+	k *= 0x1b873593U;
+	h = hash ^ k;
+	h = (h << 13) | (h >> 19);
+
+	return (h * 5 + 0xe6546b64U);
+}
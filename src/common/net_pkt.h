@@ -29,12 +29,76 @@
 #include <rohc/rohc_buf.h>
 #include "ip.h"
 #include "rohc_traces.h"
+#include "protocols/tcp.h"
 
 
 /** The key to help identify (not quaranted unique) a compression context */
 typedef uint32_t rohc_ctxt_key_t;
 
 
+/** The maximal number of IP headers in \ref net_pkt_hdrs */
+#define NET_PKT_IP_HDRS_MAX  ROHC_TCP_MAX_IP_HDRS
+
+
+/** The outer or inner IP header is an IP fragment */
+#define NET_PKT_IP_FRAGMENT    0x01U
+/** The outer or inner IPv4 header contains IP options */
+#define NET_PKT_IPV4_OPTIONS   0x02U
+/** The outer or inner IPv4 header has a bad checksum */
+#define NET_PKT_IPV4_BAD_CSUM  0x04U
+
+
+/** The location of one IP header within a network packet */
+struct net_pkt_ip_hdr
+{
+	uint32_t offset;     /**< The offset of the IP header in the packet */
+	uint32_t exts_len;   /**< The length of the IPv6 extension headers if any */
+	uint8_t version;     /**< The version of the IP header */
+	uint8_t next_proto;  /**< The protocol after the IP header and its
+	                          IPv6 extension headers if any */
+};
+
+
+/**
+ * @brief The locations of all the headers of a network packet
+ *
+ * The descriptor is built once with every network packet, so that the
+ * profiles may reach every header without parsing the previous ones again.
+ * The lengths of the headers are checked against the length of the packet,
+ * their fields are not checked.
+ */
+struct net_pkt_hdrs
+{
+	/** The IP headers, from the outermost to the innermost */
+	struct net_pkt_ip_hdr ip[NET_PKT_IP_HDRS_MAX];
+	size_t ip_nr;               /**< The number of IP headers */
+	bool is_complete;           /**< Whether the transport header was reached */
+	uint8_t transport_proto;    /**< The protocol of the transport header */
+	uint32_t transport_offset;  /**< The offset of the transport header */
+};
+
+
+/**
+ * @brief The locations of the headers of a network packet known beforehand
+ *
+ * The caller, eg. the NIC that received the packet, may already know where
+ * the headers are and whether the IPv4 checksums are good: the packet is
+ * then not walked nor checked again. The locations are lightly checked
+ * against the IP headers, the packet is parsed as usual if they do not
+ * match.
+ */
+struct net_pkt_hints
+{
+	bool has_offsets;          /**< Whether the offsets below are known */
+	uint32_t inner_ip_offset;  /**< The offset of the inner IP header,
+	                                0 if there is none */
+	uint32_t transport_offset; /**< The offset of the transport header */
+	uint8_t transport_proto;   /**< The protocol of the transport header */
+	bool ipv4_csums_good;      /**< Whether the checksums of all the IPv4
+	                                headers are known to be good */
+};
+
+
 /** One network packet */
 struct net_pkt
 {
@@ -47,8 +111,17 @@ struct net_pkt
 
 	struct net_hdr *transport;   /**< The transport layer of the packet if any */
 
+	struct net_pkt_hdrs hdrs;    /**< The locations of all the headers */
+
+	/** The anomalies of the outer and inner IP headers found once for all
+	 *  the profiles, see \ref NET_PKT_IP_FRAGMENT, \ref NET_PKT_IPV4_OPTIONS
+	 *  and \ref NET_PKT_IPV4_BAD_CSUM */
+	uint8_t ip_anomalies;
+
 	rohc_ctxt_key_t key;         /**< The hash key of the packet */
 
+	struct rohc_ts time;         /**< The arrival time of the packet */
+
 	/** The callback function used to manage traces */
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
@@ -58,11 +131,21 @@ struct net_pkt
 
 bool net_pkt_parse(struct net_pkt *const packet,
                    const struct rohc_buf data,
+                   const bool flow_key,
                    rohc_trace_callback2_t trace_cb,
                    void *const trace_cb_priv,
                    rohc_trace_entity_t trace_entity)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+bool net_pkt_parse_hinted(struct net_pkt *const packet,
+                          const struct rohc_buf data,
+                          const struct net_pkt_hints *const hints,
+                          const bool flow_key,
+                          rohc_trace_callback2_t trace_cb,
+                          void *const trace_cb_priv,
+                          rohc_trace_entity_t trace_entity)
+	__attribute__((warn_unused_result, nonnull(1)));
+
 size_t net_pkt_get_payload_offset(const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1)));
 
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rfc5225.h
+ * @brief  Definitions shared by the ROHCv2 profiles (RFC 5225)
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#ifndef ROHC_PROTOCOLS_RFC5225_H
+#define ROHC_PROTOCOLS_RFC5225_H
+
+#include "tcp.h" /* for the IR packet type and the IP-ID behaviors */
+
+
+/* See RFC5225 §6.8.2 */
+
+#define ROHCV2_PACKET_TYPE_CO_COMMON  0xFA
+#define ROHCV2_PACKET_TYPE_CO_REPAIR  0xFB
+
+
+/**
+ * @brief The maximum number of IP headers supported by the ROHCv2 profiles
+ *
+ * The ROHCv2 profiles support any number of IP headers, but the library
+ * supports one outer IP header at most for the moment.
+ */
+#define ROHC_RFC5225_MAX_IP_HDRS  2U
+
+
+/** The reordering ratios of the ROHCv2 profiles (RFC5225 §6.6.12) */
+typedef enum
+{
+	ROHC_RFC5225_REORDERING_NONE          = 0, /**< No reordering */
+	ROHC_RFC5225_REORDERING_QUARTER       = 1, /**< Reordering of 1/4 window */
+	ROHC_RFC5225_REORDERING_HALF          = 2, /**< Reordering of 1/2 window */
+	ROHC_RFC5225_REORDERING_THREEQUARTERS = 3, /**< Reordering of 3/4 window */
+} rohc_rfc5225_reorder_ratio_t;
+
+#endif /* ROHC_PROTOCOLS_RFC5225_H */
+
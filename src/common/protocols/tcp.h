@@ -43,6 +43,7 @@
 
 #define ROHC_PACKET_TYPE_IR      0xFD
 #define ROHC_PACKET_TYPE_IR_DYN  0xF8
+#define ROHC_PACKET_TYPE_IR_CR   0xFC
 
 
 /************************************************************************
@@ -60,6 +60,12 @@ extern "C"
 #  define ROHC_EXPORT
 #endif
 
+/* the public API stays visible when the library is built with
+ * -fvisibility=hidden */
+#if defined(__GNUC__) && __GNUC__ >= 4
+#  pragma GCC visibility push(default)
+#endif
+
 
 /**
  * @brief The Ethertype assigned to the ROHC protocol by the IEEE
@@ -233,9 +239,93 @@ typedef enum
 
 	ROHC_PROFILE_MAX          = 0x0009,
 
+	/** The ROHCv2 IP-only profile (RFC 5225, section 6), the other ROHCv2
+	 *  profiles (RTP, UDP, ESP, UDP-Lite/RTP and UDP-Lite) are not supported
+	 *  yet */
+	ROHCv2_PROFILE_IP         = 0x0104,
+
+	ROHCv2_PROFILE_MAX        = 0x0105,
+
 } rohc_profile_t;
 
 
+/**
+ * @brief The functions a ROHC compressor or decompressor allocates memory with
+ *
+ * The memory operations are given at the creation of the compressor or
+ * decompressor, see \ref rohc_comp_new3 and \ref rohc_decomp_new3. All the
+ * memory of the instance is then allocated and freed with them: the
+ * instance itself, its contexts, its indexes and its buffers. They may be
+ * used to place the instance on a given NUMA node or on huge pages, or to
+ * account for its memory.
+ *
+ * The memory allocated with \e alloc or with \e aligned_alloc is freed with
+ * \e free. The functions may be called from the functions of the instance
+ * that process packets, they shall thus not sleep in a kernel.
+ *
+ * @ingroup rohc
+ */
+struct rohc_mem_ops
+{
+	/** The function to allocate memory with, mandatory */
+	void * (*alloc)(const size_t size, void *const priv);
+	/** The function to allocate aligned memory with, NULL to use \e alloc */
+	void * (*aligned_alloc)(const size_t alignment, const size_t size,
+	                        void *const priv);
+	/** The function to free memory with, mandatory */
+	void (*free)(void *const ptr, void *const priv);
+	/** Private data that will be given to the functions, may be NULL */
+	void *priv;
+};
+
+
+/**
+ * @brief The load of the core that runs a ROHC compressor or decompressor
+ *
+ * The library reads no clock and sees no queue: the user measures the load
+ * of the core and gives it before a burst of packets, see
+ * \ref rohc_comp_set_load and \ref rohc_decomp_set_load. The same
+ * structure gives the limits beyond which the instance sheds work, see
+ * \ref rohc_comp_set_overload and \ref rohc_decomp_set_overload.
+ *
+ * @ingroup rohc
+ */
+struct rohc_load
+{
+	/** The number of packets waiting to be processed behind the burst */
+	size_t queue_depth;
+	/** The time (in microseconds) the previous burst took, or the time
+	 *  budget of one burst for the limits */
+	uint32_t burst_time_us;
+};
+
+
+
+/**
+ * @brief The CPU features the ROHC library uses at runtime
+ *
+ * The library detects the features of the CPU once per process, then picks
+ * the fastest variant of its kernels (CRC...) that the CPU supports. One
+ * binary of the library thus runs on all the CPUs of one architecture.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_get_cpu_features
+ */
+typedef enum
+{
+	/** No CPU feature is used, the portable kernels are active */
+	ROHC_CPU_FEATURE_NONE      = 0,
+	/** The x86 carry-less multiplication (PCLMULQDQ and SSE4.1) computes
+	 *  the 32-bit FCS of the segmented packets */
+	ROHC_CPU_FEATURE_PCLMUL    = (1 << 0),
+	/** The ARMv8 CRC32 instructions compute the 32-bit FCS of the segmented
+	 *  packets */
+	ROHC_CPU_FEATURE_ARM_CRC32 = (1 << 1),
+
+} rohc_cpu_features_t;
+
+
 
 /*
  * Prototypes of public functions
@@ -244,6 +334,9 @@ typedef enum
 char * ROHC_EXPORT rohc_version(void)
 	__attribute__((warn_unused_result, const));
 
+rohc_cpu_features_t ROHC_EXPORT rohc_get_cpu_features(void)
+	__attribute__((warn_unused_result));
+
 const char * ROHC_EXPORT rohc_strerror(const rohc_status_t status)
 	__attribute__((warn_unused_result, const));
 
@@ -255,6 +348,10 @@ const char * ROHC_EXPORT rohc_get_profile_descr(const rohc_profile_t profile)
 
 
 
+#if defined(__GNUC__) && __GNUC__ >= 4
+#  pragma GCC visibility pop
+#endif
+
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
 #ifdef __cplusplus
@@ -0,0 +1,309 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    rohc_bit_stream.h
+ * @brief   Read and write the bit fields of ROHC headers
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * The bit reader and the bit writer handle the bit fields of ROHC headers in
+ * network bit order (MSB first), through a 64-bit cache that is loaded from
+ * or stored to the packet 8 bytes at a time whenever possible.
+ *
+ * The reader and the writer do not check the bounds of the packet at every
+ * field: the caller checks once that the packet is large enough for the
+ * whole header (see \ref rohc_bit_reader_avail), then reads or writes the
+ * fields without any check.
+ *
+ * The first byte of every ROHC packet is separated from the rest of the
+ * packet by the large CID: the reader skips the large CID transparently.
+ */
+
+#ifndef ROHC_BIT_STREAM_H
+#define ROHC_BIT_STREAM_H
+
+#include "rohc_bit_ops.h" /* for WORDS_BIGENDIAN */
+
+#include <stdint.h>
+#include <stdlib.h>
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
+#include <assert.h>
+
+
+/** The reader of the bit fields of one ROHC header */
+struct rohc_bit_reader
+{
+	uint64_t cache;         /**< The bits loaded but not read yet, MSB first */
+	size_t cache_bits;      /**< The number of bits in the cache */
+	const uint8_t *data;    /**< The bytes not loaded in the cache yet */
+	size_t len;             /**< The number of bytes not loaded yet */
+	size_t read_bits;       /**< The number of bits read so far */
+};
+
+
+/** The writer of the bit fields of one ROHC header */
+struct rohc_bit_writer
+{
+	uint64_t cache;         /**< The bits written but not stored yet, MSB first */
+	size_t cache_bits;      /**< The number of bits in the cache */
+	uint8_t *data;          /**< Where to store the next bytes */
+	size_t len;             /**< The number of bytes left in the buffer */
+	size_t written;         /**< The number of bytes stored so far */
+};
+
+
+/**
+ * @brief Load 8 bytes in network byte order
+ *
+ * @param data  The 8 bytes to load
+ * @return      The 8 bytes in host byte order
+ */
+static inline uint64_t rohc_bit_load_be64(const uint8_t *const data)
+{
+	uint64_t word;
+	memcpy(&word, data, sizeof(uint64_t));
+#if WORDS_BIGENDIAN != 1
+	word = __builtin_bswap64(word);
+#endif
+	return word;
+}
+
+
+/**
+ * @brief Store 8 bytes in network byte order
+ *
+ * @param data  The buffer to store the 8 bytes in
+ * @param word  The 8 bytes in host byte order
+ */
+static inline void rohc_bit_store_be64(uint8_t *const data, uint64_t word)
+{
+#if WORDS_BIGENDIAN != 1
+	word = __builtin_bswap64(word);
+#endif
+	memcpy(data, &word, sizeof(uint64_t));
+}
+
+
+/**
+ * @brief Init the bit reader on the given ROHC packet
+ *
+ * @param reader         The bit reader to init
+ * @param rohc_packet    The ROHC packet to read, first byte included
+ * @param rohc_length    The length of the ROHC packet (in bytes)
+ * @param large_cid_len  The length of the large CID that follows the first
+ *                       byte, the large CID is skipped
+ */
+static inline void rohc_bit_reader_init(struct rohc_bit_reader *const reader,
+                                        const uint8_t *const rohc_packet,
+                                        const size_t rohc_length,
+                                        const size_t large_cid_len)
+{
+	assert(rohc_length >= (1 + large_cid_len));
+	reader->cache = ((uint64_t) rohc_packet[0]) << 56;
+	reader->cache_bits = 8;
+	reader->data = rohc_packet + 1 + large_cid_len;
+	reader->len = rohc_length - 1 - large_cid_len;
+	reader->read_bits = 0;
+}
+
+
+/**
+ * @brief Get the number of bytes that remain to be read
+ *
+ * Call it once before reading a header of known length.
+ *
+ * @param reader  The bit reader
+ * @return        The number of whole bytes that remain to be read
+ */
+static inline size_t rohc_bit_reader_avail(const struct rohc_bit_reader *const reader)
+{
+	return (reader->cache_bits / 8 + reader->len);
+}
+
+
+/**
+ * @brief Get the number of bytes read so far
+ *
+ * The large CID is not counted.
+ *
+ * @param reader  The bit reader
+ * @return        The number of bytes read so far, rounded up
+ */
+static inline size_t rohc_bit_reader_offset(const struct rohc_bit_reader *const reader)
+{
+	return ((reader->read_bits + 7) / 8);
+}
+
+
+/**
+ * @brief Load as many bytes as possible in the cache of the bit reader
+ *
+ * @param reader  The bit reader
+ */
+static inline void rohc_bit_reader_refill(struct rohc_bit_reader *const reader)
+{
+	if(reader->len >= sizeof(uint64_t))
+	{
+		/* load 8 bytes at once, keep the whole bytes that fit in the cache */
+		const size_t bytes_nr = (64 - reader->cache_bits) / 8;
+		const size_t unused_bits = 64 - reader->cache_bits - bytes_nr * 8;
+		const uint64_t word = rohc_bit_load_be64(reader->data);
+
+		reader->cache |= (word >> reader->cache_bits) & ((~((uint64_t) 0)) << unused_bits);
+		reader->cache_bits += bytes_nr * 8;
+		reader->data += bytes_nr;
+		reader->len -= bytes_nr;
+	}
+	else
+	{
+		/* the end of packet is near, load the last bytes one by one */
+		while(reader->len > 0 && reader->cache_bits <= 56)
+		{
+			reader->cache |= ((uint64_t) reader->data[0]) << (56 - reader->cache_bits);
+			reader->cache_bits += 8;
+			reader->data++;
+			reader->len--;
+		}
+	}
+}
+
+
+/**
+ * @brief Read the next bits of the ROHC header
+ *
+ * The caller shall have checked that enough bits remain to be read.
+ *
+ * @param reader  The bit reader
+ * @param bits_nr The number of bits to read, in range [1, 32]
+ * @return        The bits read
+ */
+static inline uint32_t rohc_bit_read(struct rohc_bit_reader *const reader,
+                                     const size_t bits_nr)
+{
+	uint32_t value;
+
+	assert(bits_nr >= 1 && bits_nr <= 32);
+	if(reader->cache_bits < bits_nr)
+	{
+		rohc_bit_reader_refill(reader);
+	}
+	assert(reader->cache_bits >= bits_nr);
+
+	value = reader->cache >> (64 - bits_nr);
+	reader->cache <<= bits_nr;
+	reader->cache_bits -= bits_nr;
+	reader->read_bits += bits_nr;
+
+	return value;
+}
+
+
+/**
+ * @brief Init the bit writer on the given buffer
+ *
+ * @param writer   The bit writer to init
+ * @param data     The buffer to write the header in
+ * @param max_len  The length of the buffer (in bytes)
+ */
+static inline void rohc_bit_writer_init(struct rohc_bit_writer *const writer,
+                                        uint8_t *const data,
+                                        const size_t max_len)
+{
+	writer->cache = 0;
+	writer->cache_bits = 0;
+	writer->data = data;
+	writer->len = max_len;
+	writer->written = 0;
+}
+
+
+/**
+ * @brief Store the whole bytes of the cache of the bit writer
+ *
+ * @param writer  The bit writer
+ */
+static inline void rohc_bit_writer_flush(struct rohc_bit_writer *const writer)
+{
+	const size_t bytes_nr = writer->cache_bits / 8;
+
+	assert(bytes_nr <= writer->len);
+	if(writer->len >= sizeof(uint64_t))
+	{
+		/* store 8 bytes at once, the bytes beyond the whole bytes of the cache
+		 * will be overwritten later */
+		rohc_bit_store_be64(writer->data, writer->cache);
+	}
+	else
+	{
+		size_t i;
+		for(i = 0; i < bytes_nr; i++)
+		{
+			writer->data[i] = writer->cache >> (56 - i * 8);
+		}
+	}
+	writer->data += bytes_nr;
+	writer->len -= bytes_nr;
+	writer->written += bytes_nr;
+	writer->cache = (bytes_nr == 8 ? 0 : (writer->cache << (bytes_nr * 8)));
+	writer->cache_bits -= bytes_nr * 8;
+}
+
+
+/**
+ * @brief Write the next bits of the ROHC header
+ *
+ * The caller shall have checked that the buffer is large enough.
+ *
+ * @param writer  The bit writer
+ * @param value   The value to write, only its \e bits_nr LSB are written
+ * @param bits_nr The number of bits to write, in range [1, 32]
+ */
+static inline void rohc_bit_write(struct rohc_bit_writer *const writer,
+                                  const uint32_t value,
+                                  const size_t bits_nr)
+{
+	const uint64_t bits = value & ((~((uint64_t) 0)) >> (64 - bits_nr));
+
+	assert(bits_nr >= 1 && bits_nr <= 32);
+	if((writer->cache_bits + bits_nr) > 64)
+	{
+		rohc_bit_writer_flush(writer);
+	}
+	writer->cache |= bits << (64 - writer->cache_bits - bits_nr);
+	writer->cache_bits += bits_nr;
+}
+
+
+/**
+ * @brief Store the bits of the ROHC header that remain in the cache
+ *
+ * @param writer  The bit writer
+ * @return        The number of bytes written in the buffer
+ */
+static inline size_t rohc_bit_writer_finish(struct rohc_bit_writer *const writer)
+{
+	/* the ROHC headers are made of whole bytes */
+	assert((writer->cache_bits % 8) == 0);
+	rohc_bit_writer_flush(writer);
+	return writer->written;
+}
+
+#endif /* ROHC_BIT_STREAM_H */
+
@@ -111,6 +111,73 @@ struct rohc_buf
 };
 
 
+/** The maximal number of segments of one vectored network buffer */
+#define ROHC_BUF_VEC_MAX_SEGS  4U
+
+
+/**
+ * @brief A vectored network buffer for the ROHC library
+ *
+ * May represent one packet whose data is spread over several network
+ * buffers, eg. the ROHC header built by \ref rohc_compress_hdr followed by
+ * the payload that is still in the uncompressed packet. The segments are
+ * not copied: the vectored buffer only points to them, so that it may be
+ * given to a scatter-gather I/O.
+ *
+ * \code
+   struct rohc_buf_vec packet;
+   ...
+   status = rohc_compress_hdr(comp, ip_packet, &rohc_hdr, &payload_offset);
+   ...
+   rohc_buf_vec_init_hdr(&packet, rohc_hdr, ip_packet, payload_offset);
+   ...
+\endcode
+ *
+ * @ingroup rohc
+ */
+struct rohc_buf_vec
+{
+	struct rohc_buf segs[ROHC_BUF_VEC_MAX_SEGS];  /**< The segments */
+	size_t segs_nr;                              /**< The number of segments */
+};
+
+
+/**
+ * @brief An arena of memory to carve network buffers from
+ *
+ * The arena hands out network buffers from one memory area given by the
+ * user, eg. a static array or a memory area allocated once. It is reset
+ * as a whole once the buffers are not used any more, eg. after every burst
+ * of packets: no heap allocation is required per buffer.
+ *
+ * \code
+   uint8_t mem[32 * 2048];
+   struct rohc_buf_arena arena;
+   struct rohc_buf rohc_packets[32];
+   ...
+   rohc_buf_arena_init(&arena, mem, sizeof(mem));
+   ...
+   if(!rohc_buf_arena_alloc_burst(&arena, rohc_packets, 32, 2048))
+   ...
+   nr = rohc_compress_burst(comp, ip_packets, rohc_packets, status, 32);
+   ...
+   rohc_buf_arena_reset(&arena);
+\endcode
+ *
+ * @ingroup rohc
+ */
+struct rohc_buf_arena
+{
+	uint8_t *mem;    /**< The memory area of the arena */
+	size_t max_len;  /**< The length (in bytes) of the memory area */
+	size_t used;     /**< The number of bytes handed out so far */
+};
+
+
+/** The alignment of the network buffers carved from an arena */
+#define ROHC_BUF_ARENA_ALIGN  8U
+
+
 /**
  * @brief Initialize the given network buffer with no data
  *
@@ -233,6 +300,38 @@ static inline void rohc_buf_append_buf(struct rohc_buf *const dst,
 static inline void rohc_buf_reset(struct rohc_buf *const buf)
 	__attribute__((nonnull(1)));
 
+static inline void rohc_buf_vec_init(struct rohc_buf_vec *const vec)
+	__attribute__((nonnull(1)));
+static inline bool rohc_buf_vec_add(struct rohc_buf_vec *const vec,
+                                    const struct rohc_buf seg)
+	__attribute__((warn_unused_result, nonnull(1)));
+static inline void rohc_buf_vec_init_hdr(struct rohc_buf_vec *const vec,
+                                         const struct rohc_buf rohc_hdr,
+                                         const struct rohc_buf uncomp_packet,
+                                         const size_t payload_offset)
+	__attribute__((nonnull(1)));
+static inline size_t rohc_buf_vec_len(const struct rohc_buf_vec *const vec)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static inline bool rohc_buf_vec_linearize(const struct rohc_buf_vec *const vec,
+                                          struct rohc_buf *const dst)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static inline void rohc_buf_arena_init(struct rohc_buf_arena *const arena,
+                                       uint8_t *const mem,
+                                       const size_t max_len)
+	__attribute__((nonnull(1, 2)));
+static inline bool rohc_buf_arena_alloc(struct rohc_buf_arena *const arena,
+                                        const size_t max_len,
+                                        struct rohc_buf *const buf)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static inline bool rohc_buf_arena_alloc_burst(struct rohc_buf_arena *const arena,
+                                              struct rohc_buf bufs[],
+                                              const size_t bufs_nr,
+                                              const size_t max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static inline void rohc_buf_arena_reset(struct rohc_buf_arena *const arena)
+	__attribute__((nonnull(1)));
+
 
 /**
  * @brief Is the given network buffer malformed?
@@ -436,6 +535,237 @@ static inline void rohc_buf_reset(struct rohc_buf *const buf)
 }
 
 
+/**
+ * @brief Initialize the given vectored network buffer with no segment
+ *
+ * @param vec  The vectored network buffer to initialize
+ *
+ * @ingroup rohc
+ */
+static inline void rohc_buf_vec_init(struct rohc_buf_vec *const vec)
+{
+	vec->segs_nr = 0;
+}
+
+
+/**
+ * @brief Add a segment at the end of the given vectored network buffer
+ *
+ * The data of the segment is not copied. Empty segments are ignored.
+ *
+ * @param vec  The vectored network buffer to add the segment to
+ * @param seg  The segment to add
+ * @return     true if the segment was added,
+ *             false if the vectored network buffer has no free segment
+ *
+ * @ingroup rohc
+ */
+static inline bool rohc_buf_vec_add(struct rohc_buf_vec *const vec,
+                                    const struct rohc_buf seg)
+{
+	if(rohc_buf_is_empty(seg))
+	{
+		return true;
+	}
+	if(vec->segs_nr >= ROHC_BUF_VEC_MAX_SEGS)
+	{
+		return false;
+	}
+	vec->segs[vec->segs_nr] = seg;
+	vec->segs_nr++;
+	return true;
+}
+
+
+/**
+ * @brief Initialize a vectored network buffer with a ROHC header and payload
+ *
+ * Initialize the given vectored network buffer with the ROHC header and the
+ * offset of the payload given by \ref rohc_compress_hdr: the ROHC header is
+ * the head segment and the payload of the uncompressed packet is the second
+ * segment.
+ *
+ * @param vec             The vectored network buffer to initialize
+ * @param rohc_hdr        The ROHC header
+ * @param uncomp_packet   The uncompressed packet
+ * @param payload_offset  The offset of the payload in \e uncomp_packet
+ *
+ * @ingroup rohc
+ */
+static inline void rohc_buf_vec_init_hdr(struct rohc_buf_vec *const vec,
+                                         const struct rohc_buf rohc_hdr,
+                                         const struct rohc_buf uncomp_packet,
+                                         const size_t payload_offset)
+{
+	struct rohc_buf payload = uncomp_packet;
+
+	rohc_buf_pull(&payload, payload_offset);
+	vec->segs[0] = rohc_hdr;
+	vec->segs[1] = payload;
+	vec->segs_nr = 2;
+}
+
+
+/**
+ * @brief Get the length of the data of the given vectored network buffer
+ *
+ * @param vec  The vectored network buffer
+ * @return     The length (in bytes) of the data of all the segments
+ *
+ * @ingroup rohc
+ */
+static inline size_t rohc_buf_vec_len(const struct rohc_buf_vec *const vec)
+{
+	size_t len = 0;
+	size_t i;
+
+	for(i = 0; i < vec->segs_nr; i++)
+	{
+		len += vec->segs[i].len;
+	}
+	return len;
+}
+
+
+/**
+ * @brief Copy the data of a vectored network buffer in one network buffer
+ *
+ * The data of all the segments is appended to the given network buffer,
+ * eg. for an I/O that does not support scatter-gather.
+ *
+ * @param vec  The vectored network buffer to copy data from
+ * @param dst  The network buffer to append data to
+ * @return     true if the data was copied,
+ *             false if \e dst is too small
+ *
+ * @ingroup rohc
+ */
+static inline bool rohc_buf_vec_linearize(const struct rohc_buf_vec *const vec,
+                                          struct rohc_buf *const dst)
+{
+	size_t i;
+
+	if((dst->len + rohc_buf_vec_len(vec)) > rohc_buf_avail_len(*dst))
+	{
+		return false;
+	}
+	for(i = 0; i < vec->segs_nr; i++)
+	{
+		rohc_buf_append_buf(dst, vec->segs[i]);
+	}
+	return true;
+}
+
+
+/**
+ * @brief Initialize the given arena on the given memory area
+ *
+ * @param arena    The arena to initialize
+ * @param mem      The memory area to carve network buffers from
+ * @param max_len  The length (in bytes) of the memory area
+ *
+ * @ingroup rohc
+ */
+static inline void rohc_buf_arena_init(struct rohc_buf_arena *const arena,
+                                       uint8_t *const mem,
+                                       const size_t max_len)
+{
+	arena->mem = mem;
+	arena->max_len = max_len;
+	arena->used = 0;
+}
+
+
+/**
+ * @brief Carve one empty network buffer from the given arena
+ *
+ * @param arena    The arena to carve the network buffer from
+ * @param max_len  The maximum length (in bytes) of the network buffer
+ * @param[out] buf The empty network buffer
+ * @return         true if the network buffer was carved,
+ *                 false if the arena is exhausted
+ *
+ * @ingroup rohc
+ */
+static inline bool rohc_buf_arena_alloc(struct rohc_buf_arena *const arena,
+                                        const size_t max_len,
+                                        struct rohc_buf *const buf)
+{
+	const size_t aligned_len =
+		(max_len + ROHC_BUF_ARENA_ALIGN - 1) & ~((size_t) ROHC_BUF_ARENA_ALIGN - 1);
+
+	if(max_len == 0 || max_len > (arena->max_len - arena->used))
+	{
+		return false;
+	}
+	buf->time.sec = 0;
+	buf->time.nsec = 0;
+	buf->data = arena->mem + arena->used;
+	buf->max_len = max_len;
+	buf->offset = 0;
+	buf->len = 0;
+	/* the next buffer starts aligned, if any room is left */
+	if(aligned_len > (arena->max_len - arena->used))
+	{
+		arena->used = arena->max_len;
+	}
+	else
+	{
+		arena->used += aligned_len;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Carve the empty network buffers of a burst from the given arena
+ *
+ * Carve the output buffers of \ref rohc_compress_burst or
+ * \ref rohc_decompress_burst for example. No buffer is carved if the arena
+ * cannot hold all of them.
+ *
+ * @param arena    The arena to carve the network buffers from
+ * @param bufs     The empty network buffers
+ * @param bufs_nr  The number of network buffers to carve
+ * @param max_len  The maximum length (in bytes) of every network buffer
+ * @return         true if all the network buffers were carved,
+ *                 false if the arena is exhausted
+ *
+ * @ingroup rohc
+ */
+static inline bool rohc_buf_arena_alloc_burst(struct rohc_buf_arena *const arena,
+                                              struct rohc_buf bufs[],
+                                              const size_t bufs_nr,
+                                              const size_t max_len)
+{
+	const size_t used = arena->used;
+	size_t i;
+
+	for(i = 0; i < bufs_nr; i++)
+	{
+		if(!rohc_buf_arena_alloc(arena, max_len, &bufs[i]))
+		{
+			arena->used = used;
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * @brief Give all the network buffers carved from the given arena back
+ *
+ * @param arena  The arena to reset
+ *
+ * @ingroup rohc
+ */
+static inline void rohc_buf_arena_reset(struct rohc_buf_arena *const arena)
+{
+	arena->used = 0;
+}
+
+
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
 #ifdef __cplusplus
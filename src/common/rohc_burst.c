@@ -0,0 +1,88 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_burst.c
+ * @brief  Group the packets of a burst by context
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_burst.h"
+
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
+#include <assert.h>
+
+
+/**
+ * @brief Compute the order in which the packets of a burst are handled
+ *
+ * Every packet with a key is followed by the next packets with the same key,
+ * up to the next packet without key. The packets with the same key keep
+ * their order, and no packet is moved across a packet without key.
+ *
+ * @param keys        The key of the context of every packet
+ * @param has_key     Whether every packet has a key, the packets without key
+ *                    keep their position
+ * @param pkts_nr     The number of packets, at most \ref ROHC_BURST_GROUP_MAX
+ * @param[out] order  The indexes of the packets in the order to handle them
+ */
+void rohc_burst_group(const uint32_t keys[],
+                      const bool has_key[],
+                      const size_t pkts_nr,
+                      size_t order[])
+{
+	bool is_placed[ROHC_BURST_GROUP_MAX];
+	size_t placed_nr = 0;
+	size_t i;
+
+	assert(pkts_nr <= ROHC_BURST_GROUP_MAX);
+	memset(is_placed, 0, sizeof(is_placed));
+
+	for(i = 0; i < pkts_nr; i++)
+	{
+		size_t j;
+
+		if(is_placed[i])
+		{
+			continue;
+		}
+		order[placed_nr] = i;
+		placed_nr++;
+		is_placed[i] = true;
+
+		if(!has_key[i])
+		{
+			continue;
+		}
+
+		/* bring the next packets of the same context next to the packet */
+		for(j = i + 1; j < pkts_nr && has_key[j]; j++)
+		{
+			if(!is_placed[j] && keys[j] == keys[i])
+			{
+				order[placed_nr] = j;
+				placed_nr++;
+				is_placed[j] = true;
+			}
+		}
+	}
+	assert(placed_nr == pkts_nr);
+}
+
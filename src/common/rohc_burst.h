@@ -0,0 +1,55 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_burst.h
+ * @brief  Group the packets of a burst by context
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The burst functions of the compressor and of the decompressor may handle
+ * the packets of one context one after the other, so that the context is
+ * loaded in cache once for all its packets. The order of the packets of one
+ * context is kept, only the packets of different contexts are swapped. The
+ * packets without key, eg. the ROHC segments, keep their position: no packet
+ * crosses them.
+ */
+
+#ifndef ROHC_COMMON_BURST_H
+#define ROHC_COMMON_BURST_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/** The maximum number of packets grouped together */
+#define ROHC_BURST_GROUP_MAX  32U
+
+
+/*
+ * Function prototypes
+ */
+
+void rohc_burst_group(const uint32_t keys[],
+                      const bool has_key[],
+                      const size_t pkts_nr,
+                      size_t order[])
+	__attribute__((nonnull(1, 2, 4)));
+
+#endif
+
@@ -165,7 +165,10 @@ const char * rohc_get_profile_descr(const rohc_profile_t profile)
 			return "IP/UDP-Lite/RTP";
 		case ROHC_PROFILE_UDPLITE:
 			return "IP/UDP-Lite";
+		case ROHCv2_PROFILE_IP:
+			return "IP-only (v2)";
 		case ROHC_PROFILE_MAX:
+		case ROHCv2_PROFILE_MAX:
 		default:
 			return "no description";
 	}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_cpu.c
+ * @brief  Pick the kernels of the library that fit the CPU at runtime
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_cpu.h"
+#include "crc.h"
+
+#if ROHC_CRC_HAVE_ARM_CRC32 == 1 && defined(__linux__)
+#  include <sys/auxv.h>
+#endif
+
+
+/** The bit of the ARMv8 CRC32 instructions in the hardware capabilities */
+#ifndef HWCAP_CRC32
+#  define HWCAP_CRC32  (1 << 7)
+#endif
+
+
+/** The portable kernels, they run on every CPU */
+static const struct rohc_cpu_kernels rohc_cpu_kernels_generic =
+{
+	.features = ROHC_CPU_FEATURE_NONE,
+	.crc_fcs32 = crc_calc_fcs32_generic,
+};
+
+#if ROHC_CRC_HAVE_PCLMUL == 1
+/** The kernels for the x86 CPUs with the carry-less multiplication */
+static const struct rohc_cpu_kernels rohc_cpu_kernels_pclmul =
+{
+	.features = ROHC_CPU_FEATURE_PCLMUL,
+	.crc_fcs32 = crc_calc_fcs32_pclmul,
+};
+#endif
+
+#if ROHC_CRC_HAVE_ARM_CRC32 == 1 && defined(__linux__)
+/** The kernels for the ARMv8 CPUs with the CRC32 instructions */
+static const struct rohc_cpu_kernels rohc_cpu_kernels_arm_crc32 =
+{
+	.features = ROHC_CPU_FEATURE_ARM_CRC32,
+	.crc_fcs32 = crc_calc_fcs32_arm,
+};
+#endif
+
+/** The kernels picked for the CPU, NULL until the CPU is detected */
+static const struct rohc_cpu_kernels *rohc_cpu_kernels = NULL;
+
+
+static const struct rohc_cpu_kernels * rohc_cpu_detect(void)
+	__attribute__((warn_unused_result, returns_nonnull));
+
+
+/**
+ * @brief Get the CPU features the ROHC library uses at runtime
+ *
+ * The features of the CPU are detected the first time this function or
+ * one compression or decompression function is called. The function may
+ * be called at any time from any thread, eg. to check in production which
+ * kernels are active on every host.
+ *
+ * @return  The CPU features the kernels of the library use,
+ *          \ref ROHC_CPU_FEATURE_NONE if only the portable kernels are used
+ *
+ * @ingroup rohc
+ */
+rohc_cpu_features_t rohc_get_cpu_features(void)
+{
+	return rohc_cpu_get_kernels()->features;
+}
+
+
+/**
+ * @brief Get the kernels of the library picked for the CPU
+ *
+ * The CPU is detected the first time the kernels are needed. Several
+ * threads may detect the CPU at the same time: they all pick the same
+ * read-only kernels, so the last one to record them does not matter.
+ *
+ * @return  The kernels picked for the CPU
+ */
+const struct rohc_cpu_kernels * rohc_cpu_get_kernels(void)
+{
+	const struct rohc_cpu_kernels *kernels =
+		__atomic_load_n(&rohc_cpu_kernels, __ATOMIC_ACQUIRE);
+
+	if(kernels == NULL)
+	{
+		kernels = rohc_cpu_detect();
+		__atomic_store_n(&rohc_cpu_kernels, kernels, __ATOMIC_RELEASE);
+	}
+
+	return kernels;
+}
+
+
+/**
+ * @brief Detect the features of the CPU and pick the kernels that fit
+ *
+ * @return  The fastest kernels the CPU supports
+ */
+static const struct rohc_cpu_kernels * rohc_cpu_detect(void)
+{
+#if ROHC_CRC_HAVE_PCLMUL == 1
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1"))
+	{
+		return &rohc_cpu_kernels_pclmul;
+	}
+#endif
+
+#if ROHC_CRC_HAVE_ARM_CRC32 == 1 && defined(__linux__)
+	if((getauxval(AT_HWCAP) & HWCAP_CRC32) != 0)
+	{
+		return &rohc_cpu_kernels_arm_crc32;
+	}
+#endif
+
+	return &rohc_cpu_kernels_generic;
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_cpu.h
+ * @brief  Pick the kernels of the library that fit the CPU at runtime
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The features of the CPU are detected once per process, the first time a
+ * kernel is needed. The kernels that fit the CPU are then recorded in one
+ * read-only table shared by all the compressors and decompressors.
+ *
+ * The Linux kernel module always uses the portable kernels: the SIMD
+ * registers are not available in kernel land without saving them first.
+ */
+
+#ifndef ROHC_COMMON_CPU_H
+#define ROHC_COMMON_CPU_H
+
+#include "rohc.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/** The kernels of the library picked for the CPU */
+struct rohc_cpu_kernels
+{
+	/** The CPU features the kernels use */
+	rohc_cpu_features_t features;
+	/** Compute the 32-bit FCS of the given data, see \ref crc_calc_fcs32 */
+	uint32_t (*crc_fcs32)(const uint8_t *const data,
+	                      const size_t length,
+	                      const uint32_t init_val);
+};
+
+
+const struct rohc_cpu_kernels * rohc_cpu_get_kernels(void)
+	__attribute__((warn_unused_result, returns_nonnull));
+
+#endif
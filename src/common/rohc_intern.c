@@ -0,0 +1,326 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_intern.c
+ * @brief  A store of the static header fragments shared by the contexts
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_intern.h"
+#include "rohc_mem.h"
+#include "rohc_mem_block.h"
+
+#include <string.h>
+#include <stddef.h>
+#include <assert.h>
+
+
+/** One static header fragment shared by several contexts */
+struct rohc_intern_entry
+{
+	/** The next fragment in the same bucket of the hash table */
+	struct rohc_intern_entry *next;
+	/** The hash of the fragment */
+	uint32_t hash;
+	/** The number of references to the fragment */
+	uint32_t refs;
+	/** The length of the fragment */
+	size_t len;
+	/** The bytes of the fragment */
+	uint8_t data[];
+};
+
+
+static uint32_t rohc_intern_hash(const uint8_t *const data, const size_t len)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static void rohc_intern_grow(struct rohc_intern *const store)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Initialize an empty store of static header fragments
+ *
+ * @param store    The store to initialize
+ * @param slab     The slab to allocate the fragments from
+ * @param mem_ops  The memory operations to allocate the hash table with
+ */
+void rohc_intern_init(struct rohc_intern *const store,
+                      struct rohc_slab *const slab,
+                      const struct rohc_mem_ops *const mem_ops)
+{
+	store->buckets = NULL;
+	store->mask = 0;
+	store->entries_nr = 0;
+	store->slab = slab;
+	store->mem_ops = mem_ops;
+}
+
+
+/**
+ * @brief Get a reference to the interned copy of the given fragment
+ *
+ * The fragment is copied into the store if no context references it yet.
+ *
+ * @param store  The store of fragments
+ * @param data   The bytes of the fragment
+ * @param len    The length of the fragment
+ * @return       The interned copy of the fragment, to give back with
+ *               \ref rohc_intern_put, NULL if memory is missing
+ */
+const void * rohc_intern_get(struct rohc_intern *const store,
+                             const void *const data,
+                             const size_t len)
+{
+	const uint32_t hash = rohc_intern_hash(data, len);
+	struct rohc_intern_entry *entry;
+
+	/* create the hash table with the first fragment, then keep at most one
+	 * fragment per bucket on average */
+	if(store->entries_nr >= (store->buckets == NULL ? 0 : store->mask + 1))
+	{
+		rohc_intern_grow(store);
+		if(store->buckets == NULL)
+		{
+			goto error;
+		}
+	}
+
+	for(entry = store->buckets[hash & store->mask];
+	    entry != NULL; entry = entry->next)
+	{
+		if(entry->hash == hash && entry->len == len &&
+		   memcmp(entry->data, data, len) == 0)
+		{
+			entry->refs++;
+			return entry->data;
+		}
+	}
+
+	entry = rohc_slab_alloc(store->slab, sizeof(struct rohc_intern_entry) + len);
+	if(entry == NULL)
+	{
+		goto error;
+	}
+	entry->hash = hash;
+	entry->refs = 1;
+	entry->len = len;
+	memcpy(entry->data, data, len);
+	entry->next = store->buckets[hash & store->mask];
+	store->buckets[hash & store->mask] = entry;
+	store->entries_nr++;
+
+	return entry->data;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Get one more reference to an interned fragment
+ *
+ * @param data  The interned fragment given by \ref rohc_intern_get
+ * @return      The interned fragment
+ */
+const void * rohc_intern_ref(const void *const data)
+{
+	struct rohc_intern_entry *const entry = (struct rohc_intern_entry *)
+		(((uint8_t *) data) - offsetof(struct rohc_intern_entry, data));
+
+	entry->refs++;
+
+	return data;
+}
+
+
+/**
+ * @brief Give back one reference to an interned fragment
+ *
+ * The fragment is freed once its last reference is given back.
+ *
+ * @param store  The store of fragments
+ * @param data   The interned fragment given by \ref rohc_intern_get or
+ *               \ref rohc_intern_ref, NULL to do nothing
+ */
+void rohc_intern_put(struct rohc_intern *const store, const void *const data)
+{
+	struct rohc_intern_entry *entry;
+	struct rohc_intern_entry **prev;
+
+	if(data == NULL)
+	{
+		return;
+	}
+	entry = (struct rohc_intern_entry *)
+		(((uint8_t *) data) - offsetof(struct rohc_intern_entry, data));
+	assert(entry->refs > 0);
+	entry->refs--;
+	if(entry->refs > 0)
+	{
+		return;
+	}
+
+	for(prev = &(store->buckets[entry->hash & store->mask]);
+	    (*prev) != entry; prev = &((*prev)->next))
+	{
+		assert((*prev) != NULL);
+	}
+	*prev = entry->next;
+	store->entries_nr--;
+	rohc_slab_free(entry);
+}
+
+
+/**
+ * @brief Get the number of bytes of the hash table of the store
+ *
+ * The fragments are counted with the slab they are allocated from.
+ *
+ * @param store  The store of fragments
+ * @return       The number of bytes of the hash table
+ */
+size_t rohc_intern_mem_len(const struct rohc_intern *const store)
+{
+	return (store->buckets == NULL ? 0 :
+	        (store->mask + 1) * sizeof(struct rohc_intern_entry *));
+}
+
+
+/**
+ * @brief Get the maximum length one fragment takes in a memory block
+ *
+ * @param len  The length of the fragment
+ * @return     The maximum number of bytes of the memory block the fragment
+ *             takes in the slab, see \ref rohc_slab_block_mem_max
+ */
+size_t rohc_intern_entry_mem_max(const size_t len)
+{
+	return rohc_slab_block_mem_max(sizeof(struct rohc_intern_entry) + len);
+}
+
+
+/**
+ * @brief Get the maximum length the hash table takes in a memory block
+ *
+ * Every hash table the store grew from is counted, since the memory they
+ * leave may be too small to be used again.
+ *
+ * @param entries_nr  The maximum number of fragments in the store
+ * @return            The maximum number of bytes of the memory block the
+ *                    hash tables of the store take
+ */
+size_t rohc_intern_mem_max(const size_t entries_nr)
+{
+	size_t buckets_nr = ROHC_INTERN_BUCKETS_MIN;
+	size_t mem_len;
+
+	if(entries_nr == 0)
+	{
+		return 0;
+	}
+
+	mem_len = rohc_mem_block_len(buckets_nr * sizeof(struct rohc_intern_entry *));
+	while(buckets_nr < entries_nr)
+	{
+		buckets_nr *= 2;
+		mem_len += rohc_mem_block_len(buckets_nr * sizeof(struct rohc_intern_entry *));
+	}
+
+	return mem_len;
+}
+
+
+/**
+ * @brief Release the hash table of the store
+ *
+ * The fragments are released with the slab they are allocated from.
+ *
+ * @param store  The store of fragments
+ */
+void rohc_intern_release(struct rohc_intern *const store)
+{
+	rohc_mem_free(store->mem_ops, store->buckets);
+	store->buckets = NULL;
+	store->mask = 0;
+	store->entries_nr = 0;
+}
+
+
+/**
+ * @brief Hash the given fragment with the FNV-1a algorithm
+ *
+ * @param data  The bytes of the fragment
+ * @param len   The length of the fragment
+ * @return      The hash of the fragment
+ */
+static uint32_t rohc_intern_hash(const uint8_t *const data, const size_t len)
+{
+	uint32_t hash = 2166136261U;
+	size_t i;
+
+	for(i = 0; i < len; i++)
+	{
+		hash ^= data[i];
+		hash *= 16777619U;
+	}
+
+	return hash;
+}
+
+
+/**
+ * @brief Double the number of buckets of the hash table
+ *
+ * The store keeps its current hash table if memory is missing.
+ *
+ * @param store  The store of fragments
+ */
+static void rohc_intern_grow(struct rohc_intern *const store)
+{
+	const size_t buckets_nr = (store->buckets == NULL ?
+	                           0 : store->mask + 1);
+	const size_t new_buckets_nr = (buckets_nr == 0 ?
+	                               ROHC_INTERN_BUCKETS_MIN : buckets_nr * 2);
+	struct rohc_intern_entry **new_buckets;
+	size_t i;
+
+	new_buckets = rohc_mem_calloc(store->mem_ops, new_buckets_nr,
+	                              sizeof(struct rohc_intern_entry *));
+	if(new_buckets == NULL)
+	{
+		return;
+	}
+
+	for(i = 0; i < buckets_nr; i++)
+	{
+		while(store->buckets[i] != NULL)
+		{
+			struct rohc_intern_entry *const entry = store->buckets[i];
+			const size_t new_i = entry->hash & (new_buckets_nr - 1);
+
+			store->buckets[i] = entry->next;
+			entry->next = new_buckets[new_i];
+			new_buckets[new_i] = entry;
+		}
+	}
+
+	rohc_mem_free(store->mem_ops, store->buckets);
+	store->buckets = new_buckets;
+	store->mask = new_buckets_nr - 1;
+}
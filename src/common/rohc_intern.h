@@ -0,0 +1,102 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_intern.h
+ * @brief  A store of the static header fragments shared by the contexts
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * Many contexts share the same static header fragments: the addresses of
+ * the same IPv6 hosts, the same outer tunnel headers... The store keeps one
+ * copy of every fragment, the contexts only reference it. Every fragment
+ * counts its references and is freed once no context uses it anymore.
+ *
+ * The fragments are allocated from the slab of the contexts, the hash table
+ * that finds them is allocated with the memory operations of the ROHC
+ * instance. Interned fragments are compared by address: two contexts share
+ * the same fragment if and only if they point to the same bytes.
+ */
+
+#ifndef ROHC_COMMON_INTERN_H
+#define ROHC_COMMON_INTERN_H
+
+#include "rohc_slab.h"
+#include "rohc.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+
+
+/** The initial number of buckets of the hash table of one store */
+#define ROHC_INTERN_BUCKETS_MIN  64U
+
+
+struct rohc_intern_entry;
+
+
+/** A store of static header fragments */
+struct rohc_intern
+{
+	/** The buckets of the hash table, NULL until the first fragment */
+	struct rohc_intern_entry **buckets;
+	/** The mask to apply on hashes to get buckets (= buckets - 1) */
+	size_t mask;
+	/** The number of fragments in the store */
+	size_t entries_nr;
+
+	/** The slab the fragments are allocated from */
+	struct rohc_slab *slab;
+	/** The memory operations the hash table is allocated with */
+	const struct rohc_mem_ops *mem_ops;
+};
+
+
+/*
+ * Function prototypes
+ */
+
+void rohc_intern_init(struct rohc_intern *const store,
+                      struct rohc_slab *const slab,
+                      const struct rohc_mem_ops *const mem_ops)
+	__attribute__((nonnull(1, 2, 3)));
+
+const void * rohc_intern_get(struct rohc_intern *const store,
+                             const void *const data,
+                             const size_t len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+const void * rohc_intern_ref(const void *const data)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void rohc_intern_put(struct rohc_intern *const store, const void *const data)
+	__attribute__((nonnull(1)));
+
+size_t rohc_intern_mem_len(const struct rohc_intern *const store)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+size_t rohc_intern_entry_mem_max(const size_t len)
+	__attribute__((warn_unused_result, const));
+
+size_t rohc_intern_mem_max(const size_t entries_nr)
+	__attribute__((warn_unused_result, const));
+
+void rohc_intern_release(struct rohc_intern *const store)
+	__attribute__((nonnull(1)));
+
+#endif
+
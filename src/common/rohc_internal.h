@@ -117,6 +117,8 @@
 
 #include "rohc.h"
 
+#include <stdbool.h>
+
 
 /**
  * @brief ROHC medium (CID characteristics)
@@ -131,5 +133,49 @@ struct rohc_medium
 };
 
 
+/**
+ * @brief Whether the given profile is one of the ROHCv2 profiles (RFC 5225)
+ *
+ * @param profile  The ID of the profile
+ * @return         true if the profile is a ROHCv2 profile, false otherwise
+ */
+static inline bool rohc_profile_is_rohcv2(const rohc_profile_t profile)
+{
+	return ((profile & 0xff00) == 0x0100);
+}
+
+
+/**
+ * @brief Whether the given profile is one of the profiles of RFC 3095
+ *
+ * The IP-only, UDP, UDP-Lite, ESP and RTP profiles share the packet formats
+ * of RFC 3095, and so its three operational modes.
+ *
+ * @param profile  The ID of the profile
+ * @return         true if the profile is a RFC 3095 profile, false otherwise
+ */
+static inline bool rohc_profile_is_rfc3095(const rohc_profile_t profile)
+{
+	return (profile == ROHC_PROFILE_RTP || profile == ROHC_PROFILE_UDP ||
+	        profile == ROHC_PROFILE_ESP || profile == ROHC_PROFILE_IP ||
+	        profile == ROHC_PROFILE_UDPLITE);
+}
+
+
+/**
+ * @brief Get the ROHCv1 counterpart of a ROHCv2 profile, and vice versa
+ *
+ * The IR packets carry only the 8 LSB of the profile ID (RFC 5225, §5.1.1),
+ * so one profile and its counterpart cannot be enabled together.
+ *
+ * @param profile  The ID of the profile
+ * @return         The ID of the profile of the other ROHC version
+ */
+static inline rohc_profile_t rohc_profile_get_other_version(const rohc_profile_t profile)
+{
+	return (rohc_profile_t) (profile ^ 0x0100);
+}
+
+
 #endif
 
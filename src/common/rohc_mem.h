@@ -0,0 +1,149 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_mem.h
+ * @brief  Allocate memory with the memory operations of one ROHC instance
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * Every ROHC compressor or decompressor allocates its memory with the
+ * memory operations given at its creation, or with malloc() and free() if
+ * none was given.
+ */
+
+#ifndef ROHC_COMMON_MEM_H
+#define ROHC_COMMON_MEM_H
+
+#include "rohc.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
+
+
+/** The alignment of the structures of the ROHC instances */
+#define ROHC_MEM_CACHE_LINE_LEN  64U
+
+
+/**
+ * @brief Check the memory operations given by the user
+ *
+ * @param ops  The memory operations, NULL for malloc() and free()
+ * @return     true if the operations are usable, false otherwise
+ */
+static inline bool rohc_mem_ops_check(const struct rohc_mem_ops *const ops)
+{
+	return (ops == NULL || (ops->alloc != NULL && ops->free != NULL));
+}
+
+
+/**
+ * @brief Allocate memory with the given memory operations
+ *
+ * @param ops   The memory operations of the ROHC instance
+ * @param size  The number of bytes to allocate
+ * @return      The allocated memory, NULL if allocation failed
+ */
+static inline void * rohc_mem_alloc(const struct rohc_mem_ops *const ops,
+                                    const size_t size)
+{
+	if(ops->alloc != NULL)
+	{
+		return ops->alloc(size, ops->priv);
+	}
+	return malloc(size);
+}
+
+
+/**
+ * @brief Allocate zeroed memory for an array with the given memory operations
+ *
+ * @param ops    The memory operations of the ROHC instance
+ * @param nmemb  The number of elements of the array
+ * @param size   The length of one element of the array
+ * @return       The allocated memory, NULL if allocation failed
+ */
+static inline void * rohc_mem_calloc(const struct rohc_mem_ops *const ops,
+                                     const size_t nmemb,
+                                     const size_t size)
+{
+	void *ptr;
+
+	if(size != 0 && nmemb > (SIZE_MAX / size))
+	{
+		return NULL;
+	}
+	ptr = rohc_mem_alloc(ops, nmemb * size);
+	if(ptr != NULL)
+	{
+		memset(ptr, 0, nmemb * size);
+	}
+	return ptr;
+}
+
+
+/**
+ * @brief Allocate aligned memory with the given memory operations
+ *
+ * The alignment is only a hint: without an aligned allocation function,
+ * memory is allocated with the regular allocation function.
+ *
+ * @param ops        The memory operations of the ROHC instance
+ * @param alignment  The alignment of the memory, a power of 2
+ * @param size       The number of bytes to allocate
+ * @return           The allocated memory, NULL if allocation failed
+ */
+static inline void * rohc_mem_aligned_alloc(const struct rohc_mem_ops *const ops,
+                                            const size_t alignment,
+                                            const size_t size)
+{
+	if(ops->aligned_alloc != NULL)
+	{
+		return ops->aligned_alloc(alignment, size, ops->priv);
+	}
+	return rohc_mem_alloc(ops, size);
+}
+
+
+/**
+ * @brief Free memory with the given memory operations
+ *
+ * @param ops  The memory operations of the ROHC instance
+ * @param ptr  The memory to free, may be NULL
+ */
+static inline void rohc_mem_free(const struct rohc_mem_ops *const ops,
+                                 void *const ptr)
+{
+	if(ptr == NULL)
+	{
+		return;
+	}
+	if(ops->free != NULL)
+	{
+		ops->free(ptr, ops->priv);
+	}
+	else
+	{
+		free(ptr);
+	}
+}
+
+#endif
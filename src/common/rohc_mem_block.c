@@ -0,0 +1,241 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_mem_block.c
+ * @brief  Carve all the memory of one ROHC instance from one memory block
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_mem_block.h"
+
+#include <stdint.h>
+#include <assert.h>
+
+
+/** Round the given length up to the alignment of the areas */
+#define ROHC_MEM_BLOCK_ROUND(len) \
+	(((len) + ROHC_MEM_BLOCK_ALIGN - 1) & ~((size_t) ROHC_MEM_BLOCK_ALIGN - 1))
+
+
+/**
+ * @brief The header stored in front of every area of a memory block
+ *
+ * The header takes one full alignment unit, so that the memory given to the
+ * user is aligned on cache lines too.
+ */
+struct rohc_mem_area
+{
+	/** The length of the area, header included */
+	size_t len;
+	/** The next free area by address if the area is free */
+	struct rohc_mem_area *next_free;
+};
+
+/** The length of the header of the areas, padded for alignment */
+#define ROHC_MEM_AREA_HDR_LEN  ROHC_MEM_BLOCK_ROUND(sizeof(struct rohc_mem_area))
+
+
+/** The state of the allocator, stored at the beginning of the block */
+struct rohc_mem_block
+{
+	/** The free areas of the block, sorted by address */
+	struct rohc_mem_area *free_areas;
+	/** The number of bytes of the block that are served */
+	size_t len;
+};
+
+/** The length of the state of the allocator, padded for alignment */
+#define ROHC_MEM_BLOCK_HDR_LEN  ROHC_MEM_BLOCK_ROUND(sizeof(struct rohc_mem_block))
+
+
+/**
+ * @brief Initialize the allocator of the given memory block
+ *
+ * The whole block is free once initialized. The block is not released by the
+ * allocator: it remains owned by the caller.
+ *
+ * @param mem      The memory block, aligned or not
+ * @param mem_len  The length of the memory block
+ * @return         The allocator of the block,
+ *                 NULL if the block is too small to serve any area
+ */
+struct rohc_mem_block * rohc_mem_block_init(void *const mem,
+                                            const size_t mem_len)
+{
+	const size_t pad_len =
+		(ROHC_MEM_BLOCK_ALIGN - (((uintptr_t) mem) % ROHC_MEM_BLOCK_ALIGN)) %
+		ROHC_MEM_BLOCK_ALIGN;
+	struct rohc_mem_block *block;
+	struct rohc_mem_area *area;
+	size_t areas_len;
+
+	if(mem == NULL ||
+	   mem_len < (pad_len + ROHC_MEM_BLOCK_HDR_LEN + rohc_mem_block_len(1)))
+	{
+		goto error;
+	}
+	areas_len = mem_len - pad_len - ROHC_MEM_BLOCK_HDR_LEN;
+	areas_len -= areas_len % ROHC_MEM_BLOCK_ALIGN;
+
+	block = (struct rohc_mem_block *) (((uint8_t *) mem) + pad_len);
+	area = (struct rohc_mem_area *) (((uint8_t *) block) + ROHC_MEM_BLOCK_HDR_LEN);
+	area->len = areas_len;
+	area->next_free = NULL;
+	block->free_areas = area;
+	block->len = areas_len;
+
+	return block;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Allocate memory from the given memory block
+ *
+ * The signature matches the \e alloc function of \ref rohc_mem_ops.
+ *
+ * @param size  The number of bytes to allocate
+ * @param priv  The allocator of the memory block
+ * @return      The allocated memory aligned on cache lines,
+ *              NULL if no free area is large enough
+ */
+void * rohc_mem_block_alloc(const size_t size, void *const priv)
+{
+	struct rohc_mem_block *const block = priv;
+	struct rohc_mem_area **prev_next = &block->free_areas;
+	struct rohc_mem_area *area;
+	size_t area_len;
+
+	if(size > (block->len - ROHC_MEM_AREA_HDR_LEN))
+	{
+		goto error;
+	}
+	area_len = rohc_mem_block_len(size);
+
+	/* first fit: the areas at the beginning of the block are used first */
+	for(area = block->free_areas; area != NULL && area->len < area_len;
+	    area = area->next_free)
+	{
+		prev_next = &area->next_free;
+	}
+	if(area == NULL)
+	{
+		goto error;
+	}
+
+	/* keep the end of the area free if one more area fits in */
+	if((area->len - area_len) >= rohc_mem_block_len(1))
+	{
+		struct rohc_mem_area *const rest =
+			(struct rohc_mem_area *) (((uint8_t *) area) + area_len);
+		rest->len = area->len - area_len;
+		rest->next_free = area->next_free;
+		area->len = area_len;
+		*prev_next = rest;
+	}
+	else
+	{
+		*prev_next = area->next_free;
+	}
+	area->next_free = NULL;
+
+	return ((uint8_t *) area) + ROHC_MEM_AREA_HDR_LEN;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Give memory back to the given memory block
+ *
+ * The signature matches the \e free function of \ref rohc_mem_ops.
+ *
+ * @param ptr   The memory to give back
+ * @param priv  The allocator of the memory block
+ */
+void rohc_mem_block_free(void *const ptr, void *const priv)
+{
+	struct rohc_mem_block *const block = priv;
+	struct rohc_mem_area *const area =
+		(struct rohc_mem_area *) (((uint8_t *) ptr) - ROHC_MEM_AREA_HDR_LEN);
+	struct rohc_mem_area *prev = NULL;
+	struct rohc_mem_area *next;
+
+	/* find the free neighbours of the area */
+	for(next = block->free_areas; next != NULL && next < area;
+	    next = next->next_free)
+	{
+		prev = next;
+	}
+	assert(next != area);
+
+	/* merge the area with the next free area if they touch */
+	if(next != NULL && (((uint8_t *) area) + area->len) == ((uint8_t *) next))
+	{
+		area->len += next->len;
+		area->next_free = next->next_free;
+	}
+	else
+	{
+		area->next_free = next;
+	}
+
+	/* merge the area with the previous free area if they touch */
+	if(prev == NULL)
+	{
+		block->free_areas = area;
+	}
+	else if((((uint8_t *) prev) + prev->len) == ((uint8_t *) area))
+	{
+		prev->len += area->len;
+		prev->next_free = area->next_free;
+	}
+	else
+	{
+		prev->next_free = area;
+	}
+}
+
+
+/**
+ * @brief Get the number of bytes one allocation takes in a memory block
+ *
+ * @param size  The number of bytes allocated
+ * @return      The number of bytes of the block used by the allocation
+ */
+size_t rohc_mem_block_len(const size_t size)
+{
+	return (ROHC_MEM_AREA_HDR_LEN + ROHC_MEM_BLOCK_ROUND(size == 0 ? 1 : size));
+}
+
+
+/**
+ * @brief Get the length of the memory block that serves the given areas
+ *
+ * @param areas_len  The total length of the areas, see \ref rohc_mem_block_len
+ * @return           The length of the memory block, whatever its alignment
+ */
+size_t rohc_mem_block_size(const size_t areas_len)
+{
+	return (ROHC_MEM_BLOCK_ALIGN - 1 + ROHC_MEM_BLOCK_HDR_LEN + areas_len);
+}
+
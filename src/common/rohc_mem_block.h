@@ -0,0 +1,68 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_mem_block.h
+ * @brief  Carve all the memory of one ROHC instance from one memory block
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The ROHC instances created with \ref rohc_comp_new_static and
+ * \ref rohc_decomp_new_static allocate all their memory from one block given
+ * by the user, never from the heap. The block starts with the state of the
+ * allocator, the rest of the block is served by first fit in the list of the
+ * free areas sorted by address, and the areas given back are merged with
+ * their free neighbours. All the areas are aligned on cache lines.
+ */
+
+#ifndef ROHC_COMMON_MEM_BLOCK_H
+#define ROHC_COMMON_MEM_BLOCK_H
+
+#include "rohc_mem.h"
+
+#include <stdlib.h>
+
+
+/** The alignment of the areas served from a memory block */
+#define ROHC_MEM_BLOCK_ALIGN  ROHC_MEM_CACHE_LINE_LEN
+
+
+struct rohc_mem_block;
+
+
+/*
+ * Function prototypes
+ */
+
+struct rohc_mem_block * rohc_mem_block_init(void *const mem,
+                                            const size_t mem_len)
+	__attribute__((warn_unused_result));
+
+void * rohc_mem_block_alloc(const size_t size, void *const priv)
+	__attribute__((warn_unused_result, nonnull(2)));
+
+void rohc_mem_block_free(void *const ptr, void *const priv)
+	__attribute__((nonnull(1, 2)));
+
+size_t rohc_mem_block_len(const size_t size)
+	__attribute__((warn_unused_result, const));
+
+size_t rohc_mem_block_size(const size_t areas_len)
+	__attribute__((warn_unused_result, const));
+
+#endif
+
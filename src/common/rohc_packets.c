@@ -55,6 +55,8 @@ const char * rohc_get_packet_descr(const rohc_packet_t packet_type)
 			return "IR";
 		case ROHC_PACKET_IR_DYN:
 			return "IR-DYN";
+		case ROHC_PACKET_IR_CR:
+			return "IR-CR";
 
 		case ROHC_PACKET_UO_0:
 			return "UO-0";
@@ -117,6 +119,24 @@ const char * rohc_get_packet_descr(const rohc_packet_t packet_type)
 		case ROHC_PACKET_TCP_SEQ_8:
 			return "TCP/seq_8";
 
+		case ROHC_PACKET_CO_REPAIR:
+			return "co_repair";
+		case ROHC_PACKET_PT_0_CRC3:
+			return "pt_0_crc3";
+		case ROHC_PACKET_NORTP_PT_0_CRC7:
+			return "NoRTP/pt_0_crc7";
+		case ROHC_PACKET_NORTP_PT_1_SEQ_ID:
+			return "NoRTP/pt_1_seq_id";
+		case ROHC_PACKET_NORTP_PT_2_SEQ_ID:
+			return "NoRTP/pt_2_seq_id";
+		case ROHC_PACKET_CO_COMMON:
+			return "co_common";
+
+		case ROHC_PACKET_R_0:
+			return "R-0";
+		case ROHC_PACKET_R_0_CRC:
+			return "R-0-CRC";
+
 		case ROHC_PACKET_UNKNOWN:
 		case ROHC_PACKET_MAX:
 		default:
@@ -179,6 +199,10 @@ rohc_packet_t rohc_get_packet_type(const char *const packet_id)
 	{
 		return ROHC_PACKET_IR_DYN;
 	}
+	else if(strcmp(packet_id, "ircr") == 0)
+	{
+		return ROHC_PACKET_IR_CR;
+	}
 	else if(strcmp(packet_id, "uo0") == 0)
 	{
 		return ROHC_PACKET_UO_0;
@@ -287,6 +311,38 @@ rohc_packet_t rohc_get_packet_type(const char *const packet_id)
 	{
 		return ROHC_PACKET_TCP_SEQ_8;
 	}
+	else if(strcmp(packet_id, "co-repair") == 0)
+	{
+		return ROHC_PACKET_CO_REPAIR;
+	}
+	else if(strcmp(packet_id, "pt-0-crc3") == 0)
+	{
+		return ROHC_PACKET_PT_0_CRC3;
+	}
+	else if(strcmp(packet_id, "nortp-pt-0-crc7") == 0)
+	{
+		return ROHC_PACKET_NORTP_PT_0_CRC7;
+	}
+	else if(strcmp(packet_id, "nortp-pt-1-seq-id") == 0)
+	{
+		return ROHC_PACKET_NORTP_PT_1_SEQ_ID;
+	}
+	else if(strcmp(packet_id, "nortp-pt-2-seq-id") == 0)
+	{
+		return ROHC_PACKET_NORTP_PT_2_SEQ_ID;
+	}
+	else if(strcmp(packet_id, "co-common") == 0)
+	{
+		return ROHC_PACKET_CO_COMMON;
+	}
+	else if(strcmp(packet_id, "r0") == 0)
+	{
+		return ROHC_PACKET_R_0;
+	}
+	else if(strcmp(packet_id, "r0-crc") == 0)
+	{
+		return ROHC_PACKET_R_0_CRC;
+	}
 	else
 	{
 		return ROHC_PACKET_UNKNOWN;
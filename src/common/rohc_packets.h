@@ -38,6 +38,12 @@ extern "C"
 #  define ROHC_EXPORT
 #endif
 
+/* the public API stays visible when the library is built with
+ * -fvisibility=hidden */
+#if defined(__GNUC__) && __GNUC__ >= 4
+#  pragma GCC visibility push(default)
+#endif
+
 
 
 /**
@@ -93,6 +99,21 @@ typedef enum
 	ROHC_PACKET_TCP_SEQ_7     = 30, /**< TCP seq_7 packet */
 	ROHC_PACKET_TCP_SEQ_8     = 31, /**< TCP seq_8 packet */
 
+	/* IR-CR packet (context replication, TCP profile only) */
+	ROHC_PACKET_IR_CR         = 32, /**< ROHC IR-CR packet */
+
+	/* packets for ROHCv2 profiles (RFC 5225) */
+	ROHC_PACKET_CO_REPAIR           = 33, /**< ROHCv2 co_repair packet */
+	ROHC_PACKET_PT_0_CRC3           = 34, /**< ROHCv2 pt_0_crc3 packet */
+	ROHC_PACKET_NORTP_PT_0_CRC7     = 35, /**< ROHCv2 non-RTP pt_0_crc7 packet */
+	ROHC_PACKET_NORTP_PT_1_SEQ_ID   = 36, /**< ROHCv2 non-RTP pt_1_seq_id packet */
+	ROHC_PACKET_NORTP_PT_2_SEQ_ID   = 37, /**< ROHCv2 non-RTP pt_2_seq_id packet */
+	ROHC_PACKET_CO_COMMON           = 38, /**< ROHCv2 co_common packet */
+
+	/* R-mode packets (RFC 3095, §5.7.1) */
+	ROHC_PACKET_R_0                 = 39, /**< ROHC R-0 packet */
+	ROHC_PACKET_R_0_CRC             = 40, /**< ROHC R-0-CRC packet */
+
 	ROHC_PACKET_MAX                 /**< The number of packet types */
 } rohc_packet_t;
 
@@ -128,6 +149,10 @@ rohc_packet_t ROHC_EXPORT rohc_get_packet_type(const char *const packet_id)
 	__attribute__((warn_unused_result, nonnull(1)));
 
 
+#if defined(__GNUC__) && __GNUC__ >= 4
+#  pragma GCC visibility pop
+#endif
+
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
 #ifdef __cplusplus
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    rohc_perf_internal.h
+ * @brief   ROHC internal functions to measure the duration of processing stages
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * The measures are built only if the library is configured with the
+ * --enable-rohc-perf-stats option. Otherwise, the macros expand to nothing.
+ *
+ * The compressor and the decompressor hold a \e perf member made of the
+ * \e stats histograms of all their stages and of the \e begin timestamps of
+ * the stages being measured.
+ */
+
+#ifndef ROHC_PERF_INTERNAL_H
+#define ROHC_PERF_INTERNAL_H
+
+#include "rohc_time.h" /* for public definition of struct rohc_perf_hist */
+
+#include "config.h" /* for ROHC_PERF_STATS */
+
+#include <stdlib.h>
+
+#if ROHC_PERF_STATS == 1
+
+#ifdef __KERNEL__
+#  include <linux/timex.h>
+#elif !defined(__i386__) && !defined(__x86_64__)
+#  include <time.h>
+#endif
+
+
+/** Start the measure of one processing stage */
+#define rohc_perf_begin(entity_struct, stage) \
+	do { \
+		(entity_struct)->perf.begin[stage] = rohc_perf_now(); \
+	} while(0)
+
+/** Stop the measure of one processing stage and record its duration */
+#define rohc_perf_end(entity_struct, stage) \
+	do { \
+		rohc_perf_hist_add(&(entity_struct)->perf.stats.stages[stage], \
+		                   rohc_perf_now() - (entity_struct)->perf.begin[stage]); \
+	} while(0)
+
+
+static inline uint64_t rohc_perf_now(void)
+	__attribute__((warn_unused_result));
+
+static inline void rohc_perf_hist_add(struct rohc_perf_hist *const hist,
+                                      const uint64_t duration)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Get the current value of the fastest clock of the platform
+ *
+ * @return  The number of CPU cycles on x86 or in the Linux kernel,
+ *          the number of nanoseconds of the monotonic clock otherwise
+ */
+static inline uint64_t rohc_perf_now(void)
+{
+#if defined(__KERNEL__)
+	return get_cycles();
+#elif defined(__i386__) || defined(__x86_64__)
+	return __builtin_ia32_rdtsc();
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((uint64_t) now.tv_sec) * 1000000000UL + now.tv_nsec;
+#endif
+}
+
+
+/**
+ * @brief Record one duration in the histogram of a processing stage
+ *
+ * @param hist      The histogram of the processing stage
+ * @param duration  The duration to record (in ticks)
+ */
+static inline void rohc_perf_hist_add(struct rohc_perf_hist *const hist,
+                                      const uint64_t duration)
+{
+	size_t bucket = 0;
+
+	if(duration > 1)
+	{
+		bucket = 63 - __builtin_clzll(duration);
+		if(bucket >= ROHC_PERF_HIST_BUCKETS_NR)
+		{
+			bucket = ROHC_PERF_HIST_BUCKETS_NR - 1;
+		}
+	}
+	hist->buckets[bucket]++;
+	hist->count++;
+	hist->total += duration;
+	if(duration > hist->max)
+	{
+		hist->max = duration;
+	}
+}
+
+#else /* ROHC_PERF_STATS == 0 */
+
+/** Start the measure of one processing stage (disabled at build time) */
+#define rohc_perf_begin(entity_struct, stage) \
+	do { } while(0)
+
+/** Stop the measure of one processing stage (disabled at build time) */
+#define rohc_perf_end(entity_struct, stage) \
+	do { } while(0)
+
+#endif /* ROHC_PERF_STATS */
+
+#endif /* ROHC_PERF_INTERNAL_H */
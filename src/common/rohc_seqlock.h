@@ -0,0 +1,112 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_seqlock.h
+ * @brief  Sequence counters that protect data with one writer and many readers
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The writer makes the sequence number odd before it modifies the protected
+ * data, then makes it even again once it is done. It never waits for the
+ * readers. The readers copy the protected data, then copy it again if the
+ * sequence number was odd or if it changed in the meantime.
+ *
+ * The compressors and decompressors protect their statistics this way, so
+ * that one monitoring thread may read them while another thread compresses
+ * or decompresses packets.
+ */
+
+#ifndef ROHC_COMMON_SEQLOCK_H
+#define ROHC_COMMON_SEQLOCK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+static inline void rohc_seqlock_write_begin(uint32_t *const seq)
+	__attribute__((nonnull(1)));
+static inline void rohc_seqlock_write_end(uint32_t *const seq)
+	__attribute__((nonnull(1)));
+static inline uint32_t rohc_seqlock_read_begin(const uint32_t *const seq)
+	__attribute__((warn_unused_result, nonnull(1)));
+static inline bool rohc_seqlock_read_retry(const uint32_t *const seq,
+                                           const uint32_t start)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+
+/**
+ * @brief Start modifying the data protected by the given sequence number
+ *
+ * @param seq  The sequence number, only modified by the writer
+ */
+static inline void rohc_seqlock_write_begin(uint32_t *const seq)
+{
+	__atomic_store_n(seq, (*seq) + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Stop modifying the data protected by the given sequence number
+ *
+ * @param seq  The sequence number, only modified by the writer
+ */
+static inline void rohc_seqlock_write_end(uint32_t *const seq)
+{
+	__atomic_store_n(seq, (*seq) + 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Start reading the data protected by the given sequence number
+ *
+ * Wait for the writer to complete the modification in progress, if any.
+ *
+ * @param seq  The sequence number
+ * @return     The sequence number to give to \ref rohc_seqlock_read_retry
+ */
+static inline uint32_t rohc_seqlock_read_begin(const uint32_t *const seq)
+{
+	uint32_t start;
+
+	do
+	{
+		start = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+	}
+	while((start & 1) != 0);
+
+	return start;
+}
+
+
+/**
+ * @brief Whether the data read shall be read again
+ *
+ * @param seq    The sequence number
+ * @param start  The sequence number given by \ref rohc_seqlock_read_begin
+ * @return       true if the writer modified the data while it was read,
+ *               false if the data read is consistent
+ */
+static inline bool rohc_seqlock_read_retry(const uint32_t *const seq,
+                                           const uint32_t start)
+{
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	return (__atomic_load_n(seq, __ATOMIC_RELAXED) != start);
+}
+
+#endif
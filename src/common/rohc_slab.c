@@ -0,0 +1,416 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_slab.c
+ * @brief  A simple slab allocator for the per-context memory blocks
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_slab.h"
+#include "rohc_mem_block.h"
+
+#include <stdint.h>
+#include <assert.h>
+
+
+/** The class index of the blocks that are not carved from chunks */
+#define ROHC_SLAB_NO_CLASS  UINT32_MAX
+
+/** Round the given length up to the alignment of the slab blocks */
+#define ROHC_SLAB_ROUND(len) \
+	(((len) + ROHC_SLAB_ALIGN - 1) & ~((size_t) ROHC_SLAB_ALIGN - 1))
+
+
+/**
+ * @brief The header stored in front of every block
+ *
+ * The header records where the block comes from, so that blocks may be
+ * given back without knowing their slab nor their size.
+ */
+struct rohc_slab_hdr
+{
+	union
+	{
+		/** The slab the block in use belongs to, NULL if heap memory */
+		struct rohc_slab *slab;
+		/** The next free block of the class if the block is not in use */
+		struct rohc_slab_hdr *next_free;
+	} u;
+	/** The index of the class of the block */
+	uint32_t class_idx;
+	/** The length of the block, header included */
+	uint32_t block_len;
+};
+
+/** The length of the header of the blocks, padded for alignment */
+#define ROHC_SLAB_HDR_LEN  ROHC_SLAB_ROUND(sizeof(struct rohc_slab_hdr))
+
+
+/** The header stored in front of every chunk */
+struct rohc_slab_chunk
+{
+	/** The next chunk of the slab */
+	struct rohc_slab_chunk *next;
+	/** The length of the chunk, header included */
+	size_t len;
+};
+
+/** The length of the header of the chunks, padded for alignment */
+#define ROHC_SLAB_CHUNK_HDR_LEN  ROHC_SLAB_ROUND(sizeof(struct rohc_slab_chunk))
+
+
+static void * rohc_slab_mem_alloc(struct rohc_slab *const slab,
+                                  const size_t size)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void rohc_slab_mem_free(struct rohc_slab *const slab,
+                               void *const ptr,
+                               const size_t size)
+	__attribute__((nonnull(1, 2)));
+
+static bool rohc_slab_grow(struct rohc_slab *const slab,
+                           struct rohc_slab_class *const class)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+
+/**
+ * @brief Initialize an empty slab that allocates with malloc() and free()
+ *
+ * @param slab  The slab to initialize
+ */
+void rohc_slab_init(struct rohc_slab *const slab)
+{
+	slab->classes_nr = 0;
+	slab->chunks = NULL;
+	slab->mem_len = 0;
+	slab->alloc_cb = NULL;
+	slab->free_cb = NULL;
+	slab->cb_priv = NULL;
+}
+
+
+/**
+ * @brief Set the functions the slab allocates its memory with
+ *
+ * The functions may only be changed while the slab does not hold any memory.
+ * Give NULL for both functions to come back to malloc() and free().
+ *
+ * @param slab      The slab
+ * @param alloc_cb  The function to allocate memory with
+ * @param free_cb   The function to free memory with
+ * @param priv      Private data that will be given to the callbacks
+ * @return          true if the functions were changed,
+ *                  false if the slab holds memory or if only one function
+ *                  was given
+ */
+bool rohc_slab_set_cbs(struct rohc_slab *const slab,
+                       rohc_slab_alloc_t alloc_cb,
+                       rohc_slab_free_t free_cb,
+                       void *const priv)
+{
+	if((alloc_cb == NULL) != (free_cb == NULL))
+	{
+		goto error;
+	}
+	if(slab->chunks != NULL)
+	{
+		goto error;
+	}
+
+	slab->alloc_cb = alloc_cb;
+	slab->free_cb = free_cb;
+	slab->cb_priv = priv;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get one block of memory from the slab
+ *
+ * The block is not initialized. Blocks of one given size are all served by
+ * the same class. Once all the classes are in use, blocks of new sizes are
+ * directly allocated with the slab functions.
+ *
+ * @param slab  The slab, may be NULL to allocate the block from the heap
+ * @param size  The size of the block
+ * @return      The block, NULL if no memory is available
+ */
+void * rohc_slab_alloc(struct rohc_slab *const slab, const size_t size)
+{
+	const size_t block_len = ROHC_SLAB_ROUND(ROHC_SLAB_HDR_LEN + size);
+	struct rohc_slab_class *class = NULL;
+	struct rohc_slab_hdr *hdr;
+	size_t class_idx;
+
+	if(slab == NULL)
+	{
+		hdr = malloc(block_len);
+		if(hdr == NULL)
+		{
+			goto error;
+		}
+		hdr->u.slab = NULL;
+		hdr->class_idx = ROHC_SLAB_NO_CLASS;
+		hdr->block_len = block_len;
+		goto ok;
+	}
+
+	/* search for the class of the block size, create it if needed */
+	for(class_idx = 0; class_idx < slab->classes_nr &&
+	    slab->classes[class_idx].block_len != block_len; class_idx++)
+	{
+	}
+	if(class_idx == slab->classes_nr && slab->classes_nr < ROHC_SLAB_CLASSES_MAX)
+	{
+		class = &(slab->classes[class_idx]);
+		class->block_len = block_len;
+		class->blocks_per_chunk = ROHC_SLAB_CHUNK_LEN / block_len;
+		if(class->blocks_per_chunk == 0)
+		{
+			class->blocks_per_chunk = 1;
+		}
+		else if(class->blocks_per_chunk > ROHC_SLAB_CHUNK_BLOCKS_MAX)
+		{
+			class->blocks_per_chunk = ROHC_SLAB_CHUNK_BLOCKS_MAX;
+		}
+		class->free_blocks = NULL;
+		slab->classes_nr++;
+	}
+	else if(class_idx < slab->classes_nr)
+	{
+		class = &(slab->classes[class_idx]);
+	}
+
+	if(class == NULL)
+	{
+		/* all classes are in use, do not share the block */
+		hdr = rohc_slab_mem_alloc(slab, block_len);
+		if(hdr == NULL)
+		{
+			goto error;
+		}
+		class_idx = ROHC_SLAB_NO_CLASS;
+	}
+	else
+	{
+		if(class->free_blocks == NULL && !rohc_slab_grow(slab, class))
+		{
+			goto error;
+		}
+		hdr = class->free_blocks;
+		class->free_blocks = hdr->u.next_free;
+	}
+	hdr->u.slab = slab;
+	hdr->class_idx = class_idx;
+	hdr->block_len = block_len;
+
+ok:
+	return ((unsigned char *) hdr) + ROHC_SLAB_HDR_LEN;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Give one block of memory back to its slab
+ *
+ * @param ptr  The block to give back, may be NULL
+ */
+void rohc_slab_free(void *const ptr)
+{
+	struct rohc_slab_hdr *hdr;
+	struct rohc_slab *slab;
+
+	if(ptr == NULL)
+	{
+		return;
+	}
+	hdr = (struct rohc_slab_hdr *) (((unsigned char *) ptr) - ROHC_SLAB_HDR_LEN);
+	slab = hdr->u.slab;
+
+	if(slab == NULL)
+	{
+		free(hdr);
+	}
+	else if(hdr->class_idx == ROHC_SLAB_NO_CLASS)
+	{
+		rohc_slab_mem_free(slab, hdr, hdr->block_len);
+	}
+	else
+	{
+		struct rohc_slab_class *const class = &(slab->classes[hdr->class_idx]);
+
+		assert(hdr->class_idx < slab->classes_nr);
+		hdr->u.next_free = class->free_blocks;
+		class->free_blocks = hdr;
+	}
+}
+
+
+/**
+ * @brief Release all the memory held by the slab
+ *
+ * All the blocks served by the slab shall have been given back before.
+ * The slab may be used again afterwards.
+ *
+ * @param slab  The slab to release
+ */
+void rohc_slab_release(struct rohc_slab *const slab)
+{
+	while(slab->chunks != NULL)
+	{
+		struct rohc_slab_chunk *const chunk = slab->chunks;
+		slab->chunks = chunk->next;
+		rohc_slab_mem_free(slab, chunk, chunk->len);
+	}
+	slab->classes_nr = 0;
+}
+
+
+/**
+ * @brief Get the maximum length one block takes in a memory block
+ *
+ * The length is the one of the block in the chunk, plus its share of the
+ * header of the chunk and of the area of the chunk in the memory block, see
+ * \ref rohc_mem_block_len. The free blocks of the chunks that are not full
+ * are not included, see \ref rohc_slab_mem_max.
+ *
+ * @param size  The size of the block
+ * @return      The maximum number of bytes of the memory block the block of
+ *              the slab takes
+ */
+size_t rohc_slab_block_mem_max(const size_t size)
+{
+	return (ROHC_SLAB_ROUND(ROHC_SLAB_HDR_LEN + size) + ROHC_SLAB_CHUNK_HDR_LEN +
+	        rohc_mem_block_len(1) - 1);
+}
+
+
+/**
+ * @brief Get the maximum length the free blocks of a slab take in a memory block
+ *
+ * Every class of blocks has at most one chunk that is not full, and the
+ * chunks with more than one block are not longer than
+ * \ref ROHC_SLAB_CHUNK_LEN.
+ *
+ * @return  The maximum number of bytes of the memory block taken by the
+ *          free blocks of the chunks of one slab
+ */
+size_t rohc_slab_mem_max(void)
+{
+	return (ROHC_SLAB_CLASSES_MAX *
+	        rohc_mem_block_len(ROHC_SLAB_CHUNK_HDR_LEN + ROHC_SLAB_CHUNK_LEN));
+}
+
+
+/**
+ * @brief Add one chunk of free blocks to the given class
+ *
+ * @param slab   The slab
+ * @param class  The class to grow
+ * @return       true if the class got new free blocks, false otherwise
+ */
+static bool rohc_slab_grow(struct rohc_slab *const slab,
+                           struct rohc_slab_class *const class)
+{
+	const size_t chunk_len = ROHC_SLAB_CHUNK_HDR_LEN +
+	                         class->blocks_per_chunk * class->block_len;
+	struct rohc_slab_chunk *chunk;
+	unsigned char *block;
+	size_t i;
+
+	chunk = rohc_slab_mem_alloc(slab, chunk_len);
+	if(chunk == NULL)
+	{
+		return false;
+	}
+	chunk->len = chunk_len;
+	chunk->next = slab->chunks;
+	slab->chunks = chunk;
+
+	/* put all the blocks of the chunk in the free list of the class */
+	block = ((unsigned char *) chunk) + ROHC_SLAB_CHUNK_HDR_LEN;
+	for(i = 0; i < class->blocks_per_chunk; i++)
+	{
+		struct rohc_slab_hdr *const hdr = (struct rohc_slab_hdr *) block;
+		hdr->u.next_free = class->free_blocks;
+		class->free_blocks = hdr;
+		block += class->block_len;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Allocate memory with the functions of the slab
+ *
+ * @param slab  The slab
+ * @param size  The size of the memory to allocate
+ * @return      The allocated memory, NULL if no memory is available
+ */
+static void * rohc_slab_mem_alloc(struct rohc_slab *const slab,
+                                  const size_t size)
+{
+	void *ptr;
+
+	if(slab->alloc_cb != NULL)
+	{
+		ptr = slab->alloc_cb(size, slab->cb_priv);
+	}
+	else
+	{
+		ptr = malloc(size);
+	}
+	if(ptr != NULL)
+	{
+		slab->mem_len += size;
+	}
+
+	return ptr;
+}
+
+
+/**
+ * @brief Free memory with the functions of the slab
+ *
+ * @param slab  The slab
+ * @param ptr   The memory to free
+ * @param size  The size of the memory to free
+ */
+static void rohc_slab_mem_free(struct rohc_slab *const slab,
+                               void *const ptr,
+                               const size_t size)
+{
+	assert(slab->mem_len >= size);
+	slab->mem_len -= size;
+	if(slab->free_cb != NULL)
+	{
+		slab->free_cb(ptr, slab->cb_priv);
+	}
+	else
+	{
+		free(ptr);
+	}
+}
+
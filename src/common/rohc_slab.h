@@ -0,0 +1,131 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_slab.h
+ * @brief  A simple slab allocator for the per-context memory blocks
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The slab serves blocks of a few fixed sizes (the sizes of the profile
+ * contexts, of the W-LSB windows...). Every size gets its own class with a
+ * list of free blocks. Blocks are carved from bigger chunks that are only
+ * released when the whole slab is released. Chunks are allocated with the
+ * user-supplied callbacks, or with malloc() and free() by default.
+ */
+
+#ifndef ROHC_COMMON_SLAB_H
+#define ROHC_COMMON_SLAB_H
+
+#include <stdlib.h>
+#include <stdbool.h>
+
+
+/** The maximum number of different block sizes a slab may serve */
+#define ROHC_SLAB_CLASSES_MAX  16U
+
+/** The alignment of the blocks served by a slab */
+#define ROHC_SLAB_ALIGN  16U
+
+/** The targeted length (in bytes) of one chunk of blocks */
+#define ROHC_SLAB_CHUNK_LEN  16384U
+
+/** The maximum number of blocks in one chunk */
+#define ROHC_SLAB_CHUNK_BLOCKS_MAX  64U
+
+
+/** Give one block back to its slab and reset the pointer to it */
+#define rohc_slab_zfree(pointer) \
+	do { \
+		rohc_slab_free(pointer); \
+		pointer = NULL; \
+	} while(0)
+
+
+/** The function to call to allocate the chunks of a slab */
+typedef void * (*rohc_slab_alloc_t)(const size_t size, void *const priv);
+
+/** The function to call to free the chunks of a slab */
+typedef void (*rohc_slab_free_t)(void *const ptr, void *const priv);
+
+
+struct rohc_slab_chunk;
+
+
+/** One class of blocks of the same size */
+struct rohc_slab_class
+{
+	/** The length of the blocks of the class (header included) */
+	size_t block_len;
+	/** The number of blocks carved from every chunk of the class */
+	size_t blocks_per_chunk;
+	/** The free blocks of the class */
+	void *free_blocks;
+};
+
+
+/** A slab of memory blocks */
+struct rohc_slab
+{
+	/** The classes of blocks, one per served block size */
+	struct rohc_slab_class classes[ROHC_SLAB_CLASSES_MAX];
+	/** The number of classes in use */
+	size_t classes_nr;
+
+	/** The chunks allocated for the blocks of all the classes */
+	struct rohc_slab_chunk *chunks;
+	/** The number of bytes held by the slab: chunks and unshared blocks */
+	size_t mem_len;
+
+	/** The function to call to allocate chunks */
+	rohc_slab_alloc_t alloc_cb;
+	/** The function to call to free chunks */
+	rohc_slab_free_t free_cb;
+	/** Private data that will be given to the callbacks */
+	void *cb_priv;
+};
+
+
+/*
+ * Function prototypes
+ */
+
+void rohc_slab_init(struct rohc_slab *const slab)
+	__attribute__((nonnull(1)));
+
+bool rohc_slab_set_cbs(struct rohc_slab *const slab,
+                       rohc_slab_alloc_t alloc_cb,
+                       rohc_slab_free_t free_cb,
+                       void *const priv)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void * rohc_slab_alloc(struct rohc_slab *const slab, const size_t size)
+	__attribute__((warn_unused_result));
+
+void rohc_slab_free(void *const ptr);
+
+void rohc_slab_release(struct rohc_slab *const slab)
+	__attribute__((nonnull(1)));
+
+size_t rohc_slab_block_mem_max(const size_t size)
+	__attribute__((warn_unused_result, const));
+
+size_t rohc_slab_mem_max(void)
+	__attribute__((warn_unused_result, const));
+
+#endif
+
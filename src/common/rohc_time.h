@@ -54,6 +54,29 @@ struct rohc_ts
 	uint64_t nsec;  /**< The nanoseconds part of the timestamp */
 };
 
+
+/** The number of buckets of one histogram of durations */
+#define ROHC_PERF_HIST_BUCKETS_NR  32U
+
+/**
+ * @brief A histogram of the durations of one processing stage
+ *
+ * The durations are measured in ticks of the fastest clock of the platform:
+ * CPU cycles (TSC) on x86, nanoseconds on other platforms. Bucket #0 counts
+ * the durations of 0 or 1 tick, bucket #i counts the durations in range
+ * [2^i ; 2^(i+1)[ ticks. The last bucket also counts all longer durations.
+ *
+ * @ingroup rohc
+ */
+struct rohc_perf_hist
+{
+	uint64_t count;  /**< The number of measured durations */
+	uint64_t total;  /**< The sum of the measured durations (in ticks) */
+	uint64_t max;    /**< The longest measured duration (in ticks) */
+	/** The number of measured durations per power of 2 of ticks */
+	uint64_t buckets[ROHC_PERF_HIST_BUCKETS_NR];
+};
+
 #ifdef __cplusplus
 }
 #endif
@@ -31,8 +31,11 @@
 
 #include "rohc_time.h" /* for public definition of struct rohc_ts */
 
-#ifndef __KERNEL__
+#ifdef __KERNEL__
+#  include <linux/types.h>
+#else
 #  include <sys/time.h>
+#  include <stdbool.h>
 #endif
 
 
@@ -40,6 +43,12 @@ static inline uint64_t rohc_time_interval(const struct rohc_ts begin,
                                           const struct rohc_ts end)
 	__attribute__((warn_unused_result, const));
 
+static inline uint32_t rohc_time_ms(const struct rohc_ts ts)
+	__attribute__((warn_unused_result, const));
+
+static inline bool rohc_time_is_known(const struct rohc_ts ts)
+	__attribute__((warn_unused_result, const));
+
 
 /**
  * @brief Compute the interval of time between 2 timestamps
@@ -63,5 +72,34 @@ static inline uint64_t rohc_time_interval(const struct rohc_ts begin,
 }
 
 
+/**
+ * @brief Convert a timestamp in milliseconds
+ *
+ * The milliseconds wrap around every 2^32 ms (about 49 days), so only the
+ * differences between two converted timestamps are meaningful.
+ *
+ * @param ts  The timestamp (in seconds and nanoseconds)
+ * @return    The timestamp in milliseconds (modulo 2^32)
+ */
+static inline uint32_t rohc_time_ms(const struct rohc_ts ts)
+{
+	return ((uint32_t) ts.sec) * 1000U + (uint32_t) (ts.nsec / 1000000UL);
+}
+
+
+/**
+ * @brief Whether the given timestamp is known or not
+ *
+ * The null timestamp stands for an unknown time.
+ *
+ * @param ts  The timestamp (in seconds and nanoseconds)
+ * @return    true if the timestamp is known, false if it is null
+ */
+static inline bool rohc_time_is_known(const struct rohc_ts ts)
+{
+	return (ts.sec != 0 || ts.nsec != 0);
+}
+
+
 #endif /* ROHC_TIME_INTERNAL_H */
 
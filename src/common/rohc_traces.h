@@ -34,6 +34,23 @@ extern "C"
 {
 #endif
 
+/** Macro that handles DLL export declarations gracefully */
+#ifdef DLL_EXPORT /* passed by autotools on command line */
+#  define ROHC_EXPORT __declspec(dllexport)
+#else
+#  define ROHC_EXPORT
+#endif
+
+/* the public API stays visible when the library is built with
+ * -fvisibility=hidden */
+#if defined(__GNUC__) && __GNUC__ >= 4
+#  pragma GCC visibility push(default)
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
 
 /**
  * @brief A general profile number used for traces not related to a specific
@@ -132,6 +149,207 @@ typedef void (*rohc_trace_callback2_t) (void *const priv_ctxt,
 #endif
 
 
+/**
+ * @brief The different events recorded in binary trace rings
+ *
+ * Used for the \e event field of the \ref rohc_trace_record records.
+ *
+ * If you add a new event, please also add the corresponding textual
+ * description in \ref rohc_trace_event_get_descr.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_trace_record
+ * @see rohc_trace_event_get_descr
+ */
+typedef enum
+{
+	/** One packet was compressed
+	 *  (args: uncompressed length, ROHC length, ROHC header length) */
+	ROHC_TRACE_EVENT_COMP_PKT         = 0,
+	/** One packet failed to be compressed (args: uncompressed length) */
+	ROHC_TRACE_EVENT_COMP_FAILURE     = 1,
+	/** One compression context was created
+	 *  (args: number of contexts in use) */
+	ROHC_TRACE_EVENT_COMP_CTXT_NEW    = 2,
+	/** One packet was decompressed
+	 *  (args: ROHC length, uncompressed length) */
+	ROHC_TRACE_EVENT_DECOMP_PKT       = 3,
+	/** One packet failed to be decompressed
+	 *  (args: ROHC length, \ref rohc_status_t status) */
+	ROHC_TRACE_EVENT_DECOMP_FAILURE   = 4,
+	/** One decompression context was created
+	 *  (args: number of contexts in use) */
+	ROHC_TRACE_EVENT_DECOMP_CTXT_NEW  = 5,
+	/** One compression context was destroyed to make room or because it
+	 *  was unused (args: \ref rohc_trace_evict_t reason, number of contexts
+	 *  in use) */
+	ROHC_TRACE_EVENT_COMP_CTXT_EVICT  = 6,
+	/** One compression context changed its state
+	 *  (args: old \ref rohc_comp_state_t, new \ref rohc_comp_state_t) */
+	ROHC_TRACE_EVENT_COMP_STATE       = 7,
+	/** One compression context changed its mode
+	 *  (args: old \ref rohc_mode_t, new \ref rohc_mode_t) */
+	ROHC_TRACE_EVENT_COMP_MODE        = 8,
+	/** One compression context received a NACK or a STATIC-NACK that reports
+	 *  a CRC failure (args: 1 for NACK, 2 for STATIC-NACK) */
+	ROHC_TRACE_EVENT_COMP_NACK        = 9,
+	/** One decompression context was destroyed to make room or because it
+	 *  was unused (args: \ref rohc_trace_evict_t reason, number of contexts
+	 *  in use) */
+	ROHC_TRACE_EVENT_DECOMP_CTXT_EVICT = 10,
+	/** One decompression context changed its state
+	 *  (args: old \ref rohc_decomp_state_t, new \ref rohc_decomp_state_t) */
+	ROHC_TRACE_EVENT_DECOMP_STATE     = 11,
+	/** One decompression context changed its mode
+	 *  (args: old \ref rohc_mode_t, new \ref rohc_mode_t) */
+	ROHC_TRACE_EVENT_DECOMP_MODE      = 12,
+	/** One packet failed the CRC check of its decompression context
+	 *  (args: ROHC length, \ref rohc_decomp_state_t state) */
+	ROHC_TRACE_EVENT_DECOMP_CRC       = 13,
+	ROHC_TRACE_EVENT_MAX                 /**< The number of events */
+} rohc_trace_event_t;
+
+
+/** The bit of one event in the mask of the recorded events */
+#define ROHC_TRACE_EVENT_BIT(event)  (1U << (event))
+
+/** The mask of all the events, the events recorded by default */
+#define ROHC_TRACE_EVENTS_ALL  (ROHC_TRACE_EVENT_BIT(ROHC_TRACE_EVENT_MAX) - 1U)
+
+/** The mask of the events of the life of the contexts, without the events
+ *  recorded for every packet */
+#define ROHC_TRACE_EVENTS_CTXT \
+	(ROHC_TRACE_EVENTS_ALL & \
+	 ~(ROHC_TRACE_EVENT_BIT(ROHC_TRACE_EVENT_COMP_PKT) | \
+	   ROHC_TRACE_EVENT_BIT(ROHC_TRACE_EVENT_DECOMP_PKT)))
+
+
+/**
+ * @brief The reasons why a context is destroyed, recorded with the
+ *        \ref ROHC_TRACE_EVENT_COMP_CTXT_EVICT and
+ *        \ref ROHC_TRACE_EVENT_DECOMP_CTXT_EVICT events
+ *
+ * @ingroup rohc
+ */
+typedef enum
+{
+	/** The context was recycled for a new flow or replaced by a new one */
+	ROHC_TRACE_EVICT_RECYCLED = 0,
+	/** The context was unused for longer than the idle timeout */
+	ROHC_TRACE_EVICT_IDLE     = 1,
+	/** The flow of the context ended for longer than the linger time */
+	ROHC_TRACE_EVICT_CLOSED   = 2,
+	/** The memory budget of the instance was exhausted */
+	ROHC_TRACE_EVICT_MEM      = 3,
+} rohc_trace_evict_t;
+
+
+/** The CID of binary trace records that are not related to a context */
+#define ROHC_TRACE_RECORD_NO_CID  0xffffU
+
+/** The number of integer arguments in one binary trace record */
+#define ROHC_TRACE_RECORD_ARGS_NR  3U
+
+/**
+ * @brief The maximal number of values of one criterion of a trace filter
+ *
+ * A trace filter holds at most this number of CIDs, of profiles and of flows,
+ * see \ref rohc_comp_trace_filter_add_cid or
+ * \ref rohc_decomp_trace_filter_add_cid for example.
+ */
+#define ROHC_TRACE_FILTER_MAX  16U
+
+
+/**
+ * @brief One binary trace record
+ *
+ * Binary trace records are fixed-size, so that they are cheap enough to be
+ * recorded at line rate. They do not contain any text: the meaning of the
+ * integer arguments depends on the event, see \ref rohc_trace_event_t.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_trace_ring
+ * @see rohc_trace_ring_read
+ */
+struct rohc_trace_record
+{
+	/** The sequence number of the record in the ring */
+	uint32_t seq;
+	/** The recorded event, see \ref rohc_trace_event_t */
+	uint16_t event;
+	/** The profile concerned by the event or \ref ROHC_PROFILE_GENERAL */
+	uint16_t profile;
+	/** The CID concerned by the event or \ref ROHC_TRACE_RECORD_NO_CID */
+	uint16_t cid;
+	/** The entity that recorded the event, see \ref rohc_trace_entity_t */
+	uint8_t entity;
+	/** The packet concerned by the event, see \ref rohc_packet_t */
+	uint8_t packet_type;
+	/** The integer arguments of the event */
+	uint32_t args[ROHC_TRACE_RECORD_ARGS_NR];
+};
+
+
+/**
+ * @brief A ring of binary trace records
+ *
+ * The ring and its records are allocated by the application, then the ring
+ * is initialized with \ref rohc_trace_ring_init and given to a ROHC
+ * compressor or decompressor. The ROHC library is the only writer of the
+ * ring: when the ring is full, the oldest records are overwritten.
+ *
+ * The ring is lock-free: the records may be retrieved with
+ * \ref rohc_trace_ring_read from another thread while the compressor or
+ * decompressor records new ones. The ring is made of plain memory, so it
+ * may also be dumped as is and decoded offline.
+ *
+ * One ring shall not be shared by several compressors or decompressors.
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_trace_ring_init
+ * @see rohc_trace_ring_read
+ * @see rohc_comp_set_trace_ring
+ * @see rohc_decomp_set_trace_ring
+ */
+struct rohc_trace_ring
+{
+	/** The records of the ring */
+	struct rohc_trace_record *records;
+	/** The number of records in the ring minus one (a power of 2 minus 1) */
+	uint32_t mask;
+	/** The number of records ever written in the ring */
+	uint32_t head;
+};
+
+
+/*
+ * Prototypes of public functions
+ */
+
+bool ROHC_EXPORT rohc_trace_ring_init(struct rohc_trace_ring *const ring,
+                                      struct rohc_trace_record *const records,
+                                      const size_t records_nr)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_trace_ring_read(const struct rohc_trace_ring *const ring,
+                                        uint32_t *const next_seq,
+                                        struct rohc_trace_record *const records,
+                                        const size_t records_max)
+	__attribute__((warn_unused_result));
+
+const char * ROHC_EXPORT rohc_trace_event_get_descr(const rohc_trace_event_t event)
+	__attribute__((warn_unused_result, const));
+
+
+#if defined(__GNUC__) && __GNUC__ >= 4
+#  pragma GCC visibility pop
+#endif
+
+#undef ROHC_EXPORT /* do not pollute outside this header */
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,6 +29,9 @@
 #include "rohc_traces_internal.h"
 #include "rohc_utils.h"
 
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
 #include <stdio.h> /* for snprintf(3) */
 #include <assert.h>
 
@@ -138,3 +141,340 @@ void rohc_dump_buf(const rohc_trace_callback2_t trace_cb,
 	}
 }
 
+
+
+/**
+ * @brief Initialize a ring of binary trace records
+ *
+ * The records are allocated by the application. They shall remain valid as
+ * long as the ring is used by one ROHC compressor or decompressor.
+ *
+ * @param ring        The ring to initialize
+ * @param records     The records of the ring
+ * @param records_nr  The number of records of the ring, a power of 2
+ * @return            true if the ring was successfully initialized,
+ *                    false if one parameter is invalid
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_trace_ring_read
+ * @see rohc_comp_set_trace_ring
+ * @see rohc_decomp_set_trace_ring
+ */
+bool rohc_trace_ring_init(struct rohc_trace_ring *const ring,
+                          struct rohc_trace_record *const records,
+                          const size_t records_nr)
+{
+	if(ring == NULL || records == NULL)
+	{
+		goto error;
+	}
+
+	/* the number of records shall be a power of 2, so that the position of
+	 * one record in the ring is a simple mask of its sequence number */
+	if(records_nr == 0 ||
+	   records_nr > (1U << 31) ||
+	   (records_nr & (records_nr - 1)) != 0)
+	{
+		goto error;
+	}
+
+	memset(records, 0, records_nr * sizeof(struct rohc_trace_record));
+	ring->records = records;
+	ring->mask = records_nr - 1;
+	ring->head = 0;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Retrieve the binary trace records recorded since the last call
+ *
+ * May be called from another thread than the one that runs the ROHC
+ * compressor or decompressor that records in the ring. The records that are
+ * overwritten before they are read are lost: they are detected with the gaps
+ * in the sequence numbers of the retrieved records.
+ *
+ * @param ring              The ring to read records from
+ * @param[in,out] next_seq  in: the sequence number of the first record to
+ *                          read, 0 on first call;
+ *                          out: the sequence number of the first record to
+ *                          read on next call
+ * @param[out] records      The retrieved records
+ * @param records_max       The maximum number of records to retrieve
+ * @return                  The number of retrieved records
+ *
+ * @ingroup rohc
+ *
+ * @see rohc_trace_ring_init
+ */
+size_t rohc_trace_ring_read(const struct rohc_trace_ring *const ring,
+                            uint32_t *const next_seq,
+                            struct rohc_trace_record *const records,
+                            const size_t records_max)
+{
+	const uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	uint32_t seq = (*next_seq);
+	size_t records_nr = 0;
+
+	/* skip the records that were already overwritten */
+	if((head - seq) > (ring->mask + 1))
+	{
+		seq = head - (ring->mask + 1);
+	}
+
+	for(; seq != head && records_nr < records_max; seq++)
+	{
+		const struct rohc_trace_record *const record =
+			&ring->records[seq & ring->mask];
+
+		/* skip the record if it is being overwritten, or if it was
+		 * overwritten while it was copied */
+		if(__atomic_load_n(&record->seq, __ATOMIC_ACQUIRE) != seq)
+		{
+			continue;
+		}
+		records[records_nr] = (*record);
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if(__atomic_load_n(&record->seq, __ATOMIC_RELAXED) != seq)
+		{
+			continue;
+		}
+		records_nr++;
+	}
+	(*next_seq) = seq;
+
+	return records_nr;
+}
+
+
+/**
+ * @brief Give a description for the given event of binary trace records
+ *
+ * The descriptions are not part of the API. They may change between
+ * releases without any warning. Do NOT use them for other means that
+ * providing to users a textual description of the events recorded by the
+ * library. If unsure, ask on the mailing list.
+ *
+ * @param event  The event to get a description for
+ * @return       A string that describes the given event
+ *
+ * @ingroup rohc
+ */
+const char * rohc_trace_event_get_descr(const rohc_trace_event_t event)
+{
+	switch(event)
+	{
+		case ROHC_TRACE_EVENT_COMP_PKT:
+			return "packet compressed";
+		case ROHC_TRACE_EVENT_COMP_FAILURE:
+			return "compression failed";
+		case ROHC_TRACE_EVENT_COMP_CTXT_NEW:
+			return "compression context created";
+		case ROHC_TRACE_EVENT_DECOMP_PKT:
+			return "packet decompressed";
+		case ROHC_TRACE_EVENT_DECOMP_FAILURE:
+			return "decompression failed";
+		case ROHC_TRACE_EVENT_DECOMP_CTXT_NEW:
+			return "decompression context created";
+		case ROHC_TRACE_EVENT_COMP_CTXT_EVICT:
+			return "compression context destroyed";
+		case ROHC_TRACE_EVENT_COMP_STATE:
+			return "compression state changed";
+		case ROHC_TRACE_EVENT_COMP_MODE:
+			return "compression mode changed";
+		case ROHC_TRACE_EVENT_COMP_NACK:
+			return "negative feedback received";
+		case ROHC_TRACE_EVENT_DECOMP_CTXT_EVICT:
+			return "decompression context destroyed";
+		case ROHC_TRACE_EVENT_DECOMP_STATE:
+			return "decompression state changed";
+		case ROHC_TRACE_EVENT_DECOMP_MODE:
+			return "decompression mode changed";
+		case ROHC_TRACE_EVENT_DECOMP_CRC:
+			return "decompression CRC failure";
+		case ROHC_TRACE_EVENT_MAX:
+		default:
+			return "no description";
+	}
+}
+
+
+/**
+ * @brief Record one event in the given ring of binary trace records
+ *
+ * The caller is the only writer of the ring. Every record is invalidated
+ * before it is written, so that readers never use a partially written
+ * record (see \ref rohc_trace_ring_read).
+ *
+ * @param ring         The ring to record the event in
+ * @param entity       The entity that records the event
+ * @param event        The event to record
+ * @param profile      The profile concerned by the event
+ * @param cid          The CID concerned by the event
+ * @param packet_type  The packet concerned by the event
+ * @param arg1         The first integer argument of the event
+ * @param arg2         The second integer argument of the event
+ * @param arg3         The third integer argument of the event
+ */
+void rohc_trace_ring_push(struct rohc_trace_ring *const ring,
+                          const rohc_trace_entity_t entity,
+                          const rohc_trace_event_t event,
+                          const int profile,
+                          const size_t cid,
+                          const rohc_packet_t packet_type,
+                          const uint32_t arg1,
+                          const uint32_t arg2,
+                          const uint32_t arg3)
+{
+	const uint32_t seq = ring->head;
+	struct rohc_trace_record *const record = &ring->records[seq & ring->mask];
+
+	/* the new sequence number invalidates the record for all the readers that
+	 * expect the old one, the ring head tells them when the new one is
+	 * fully written */
+	__atomic_store_n(&record->seq, seq, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+
+	record->event = event;
+	record->profile = profile;
+	record->cid = cid;
+	record->entity = entity;
+	record->packet_type = packet_type;
+	record->args[0] = arg1;
+	record->args[1] = arg2;
+	record->args[2] = arg3;
+
+	__atomic_store_n(&ring->head, seq + 1, __ATOMIC_RELEASE);
+}
+
+
+/**
+ * @brief Initialize or clear the given trace filter
+ *
+ * The filter is inactive once initialized: all the traces are given to the
+ * callback.
+ *
+ * @param filter    The trace filter to initialize
+ * @param callback  The callback function used to manage traces
+ */
+void rohc_trace_filter_init(struct rohc_trace_filter *const filter,
+                            const rohc_trace_callback2_t callback)
+{
+	memset(filter, 0, sizeof(struct rohc_trace_filter));
+	filter->callback = callback;
+}
+
+
+/**
+ * @brief Add one value to one criterion of the given trace filter
+ *
+ * The filter becomes active. Adding a value twice is not an error.
+ *
+ * @param filter     The trace filter
+ * @param values     The values of the criterion
+ * @param values_nr  The number of values of the criterion
+ * @param value      The value to add to the criterion
+ * @return           true if the value was added,
+ *                   false if the criterion already holds
+ *                   \ref ROHC_TRACE_FILTER_MAX values
+ */
+bool rohc_trace_filter_add(struct rohc_trace_filter *const filter,
+                           uint32_t *const values,
+                           uint8_t *const values_nr,
+                           const uint32_t value)
+{
+	size_t i;
+
+	for(i = 0; i < (*values_nr); i++)
+	{
+		if(values[i] == value)
+		{
+			goto added;
+		}
+	}
+	if((*values_nr) >= ROHC_TRACE_FILTER_MAX)
+	{
+		goto error;
+	}
+	values[*values_nr] = value;
+	(*values_nr)++;
+
+added:
+	filter->is_active = true;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Whether one value matches one criterion of a trace filter
+ *
+ * @param values     The values of the criterion
+ * @param values_nr  The number of values of the criterion, 0 if the
+ *                   criterion is not used
+ * @param value      The value to check
+ * @return           true if the criterion is not used or if it holds the
+ *                   value, false otherwise
+ */
+static bool rohc_trace_filter_match_one(const uint32_t *const values,
+                                        const size_t values_nr,
+                                        const uint32_t value)
+{
+	size_t i;
+
+	if(values_nr == 0)
+	{
+		return true;
+	}
+	for(i = 0; i < values_nr; i++)
+	{
+		if(values[i] == value)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/**
+ * @brief Whether the given context matches the given trace filter
+ *
+ * @param filter       The trace filter
+ * @param cid          The CID of the context
+ * @param profile      The profile of the context
+ * @param packet_type  The type of the packet of the context,
+ *                     \ref ROHC_PACKET_UNKNOWN if not known yet
+ * @param has_key      Whether the context is identified by a flow key
+ * @param key          The flow key of the context if \e has_key is true
+ * @return             true if the traces of the context shall be given to
+ *                     the callback, false if they shall be dropped
+ */
+bool rohc_trace_filter_match(const struct rohc_trace_filter *const filter,
+                             const size_t cid,
+                             const int profile,
+                             const rohc_packet_t packet_type,
+                             const bool has_key,
+                             const uint32_t key)
+{
+	if(filter->packet_types != 0 &&
+	   (packet_type >= ROHC_PACKET_MAX ||
+	    (filter->packet_types & (((uint64_t) 1) << packet_type)) == 0))
+	{
+		return false;
+	}
+	if(has_key && !rohc_trace_filter_match_one(filter->keys, filter->keys_nr, key))
+	{
+		return false;
+	}
+	return (rohc_trace_filter_match_one(filter->cids, filter->cids_nr, cid) &&
+	        rohc_trace_filter_match_one(filter->profiles, filter->profiles_nr,
+	                                    profile));
+}
@@ -32,8 +32,13 @@
 
 #include "rohc_traces.h"
 #include <rohc/rohc_buf.h>
+#include <rohc/rohc_packets.h>
+
+#include "config.h" /* for ROHC_DEBUG_TRACES */
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <assert.h>
 
 
@@ -57,11 +62,32 @@
 		             format, ##__VA_ARGS__); \
 	} while(0)
 
+#if !defined(ROHC_DEBUG_TRACES) || ROHC_DEBUG_TRACES == 1
+
 /** Print debug messages prefixed with the function name */
 #define rohc_debug(entity_struct, entity, profile, format, ...) \
 	rohc_print(entity_struct, ROHC_TRACE_DEBUG, entity, profile, \
 	           format, ##__VA_ARGS__)
 
+#else
+
+/**
+ * @brief Print debug messages prefixed with the function name
+ *
+ * Debug traces are removed at build time (see configure option
+ * --disable-rohc-debug-traces): the trace is still type-checked and its
+ * arguments still count as used, but no code is generated for it.
+ */
+#define rohc_debug(entity_struct, entity, profile, format, ...) \
+	do { \
+		if(0) { \
+			rohc_print(entity_struct, ROHC_TRACE_DEBUG, entity, profile, \
+			           format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+#endif
+
 /** Print information prefixed with the function name */
 #define rohc_info(entity_struct, entity, profile, format, ...) \
 	rohc_print(entity_struct, ROHC_TRACE_INFO, entity, profile, \
@@ -97,6 +123,116 @@
 		} \
 	} while(0)
 
+/**
+ * @brief Record one event in the binary trace ring of the given entity
+ *
+ * Nothing is done if no binary trace ring was given to the entity, or if
+ * the event is not in the mask of the events the entity records.
+ */
+#define rohc_trace_event(entity_struct, entity, event, profile, cid, \
+                         packet_type, arg1, arg2, arg3) \
+	do { \
+		if((entity_struct)->trace_ring != NULL && \
+		   ((entity_struct)->trace_events & ROHC_TRACE_EVENT_BIT(event)) != 0) { \
+			rohc_trace_ring_push((entity_struct)->trace_ring, entity, event, \
+			                     profile, cid, packet_type, arg1, arg2, arg3); \
+		} \
+	} while(0)
+
+/**
+ * @brief The filter that restricts the text traces to some contexts
+ *
+ * The filter is active once one criterion was given. While the filter is
+ * active, the trace callback of the compressor or decompressor is NULL, so
+ * that every trace is dropped before it is formatted. The callback is
+ * restored while one context that matches the filter is handled, see
+ * \ref rohc_trace_filter_select.
+ *
+ * The context matches the filter if it matches every given criterion, and it
+ * matches one criterion if it matches one of its values.
+ */
+struct rohc_trace_filter
+{
+	/** The callback function used to manage traces, set by the user */
+	rohc_trace_callback2_t callback;
+	/** The packet types to trace, one bit per \ref rohc_packet_t */
+	uint64_t packet_types;
+	/** The CIDs of the contexts to trace */
+	uint32_t cids[ROHC_TRACE_FILTER_MAX];
+	/** The profiles of the contexts to trace */
+	uint32_t profiles[ROHC_TRACE_FILTER_MAX];
+	/** The keys of the flows to trace */
+	uint32_t keys[ROHC_TRACE_FILTER_MAX];
+	/** The number of CIDs to trace */
+	uint8_t cids_nr;
+	/** The number of profiles to trace */
+	uint8_t profiles_nr;
+	/** The number of keys of flows to trace */
+	uint8_t keys_nr;
+	/** Whether the filter is active or not */
+	bool is_active;
+};
+
+
+/**
+ * @brief Drop the text traces of the given entity until one context is
+ *        selected by its trace filter
+ *
+ * Nothing is done if no trace filter is active for the entity.
+ */
+#define rohc_trace_filter_mute(entity_struct) \
+	do { \
+		if((entity_struct)->trace_filter.is_active) { \
+			(entity_struct)->trace_callback = NULL; \
+		} \
+	} while(0)
+
+/**
+ * @brief Enable or drop the text traces of the given entity depending on
+ *        whether the given context matches its trace filter
+ *
+ * Nothing is done if no trace filter is active for the entity.
+ */
+#define rohc_trace_filter_select(entity_struct, cid, profile, packet_type, \
+                                 has_key, key) \
+	do { \
+		if((entity_struct)->trace_filter.is_active) { \
+			(entity_struct)->trace_callback = \
+				rohc_trace_filter_match(&(entity_struct)->trace_filter, cid, \
+				                        profile, packet_type, has_key, key) ? \
+				(entity_struct)->trace_filter.callback : NULL; \
+		} \
+	} while(0)
+
+
+void rohc_trace_filter_init(struct rohc_trace_filter *const filter,
+                            const rohc_trace_callback2_t callback)
+	__attribute__((nonnull(1)));
+
+bool rohc_trace_filter_add(struct rohc_trace_filter *const filter,
+                           uint32_t *const values,
+                           uint8_t *const values_nr,
+                           const uint32_t value)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+bool rohc_trace_filter_match(const struct rohc_trace_filter *const filter,
+                             const size_t cid,
+                             const int profile,
+                             const rohc_packet_t packet_type,
+                             const bool has_key,
+                             const uint32_t key)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+void rohc_trace_ring_push(struct rohc_trace_ring *const ring,
+                          const rohc_trace_entity_t entity,
+                          const rohc_trace_event_t event,
+                          const int profile,
+                          const size_t cid,
+                          const rohc_packet_t packet_type,
+                          const uint32_t arg1,
+                          const uint32_t arg2,
+                          const uint32_t arg3)
+	__attribute__((nonnull(1)));
 
 void rohc_dump_packet(const rohc_trace_callback2_t trace_cb,
                       void *const trace_cb_priv,
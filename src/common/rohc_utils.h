@@ -25,6 +25,12 @@
 #ifndef ROHC_UTILS_H
 #define ROHC_UTILS_H
 
+#ifdef __KERNEL__
+#  include <endian.h>
+#else
+#  include "config.h" /* for WORDS_BIGENDIAN */
+#endif
+
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -50,13 +56,13 @@ typedef enum
 static inline unsigned int rohc_b2u(const bool boolean)
 	__attribute__((warn_unused_result, const));
 
-uint32_t rohc_ntoh32(const uint32_t net32)
+static inline uint32_t rohc_ntoh32(const uint32_t net32)
 	__attribute__((warn_unused_result, const));
-uint16_t rohc_ntoh16(const uint16_t net16)
+static inline uint16_t rohc_ntoh16(const uint16_t net16)
 	__attribute__((warn_unused_result, const));
-uint32_t rohc_hton32(const uint32_t host32)
+static inline uint32_t rohc_hton32(const uint32_t host32)
 	__attribute__((warn_unused_result, const));
-uint16_t rohc_hton16(const uint16_t host16)
+static inline uint16_t rohc_hton16(const uint16_t host16)
 	__attribute__((warn_unused_result, const));
 
 
@@ -73,5 +79,61 @@ static inline unsigned int rohc_b2u(const bool boolean)
 	return (boolean ? 1 : 0);
 }
 
+
+/**
+ * @brief Convert a 32-bit long integer from network to host byte orders
+ *
+ * @param net32  The 32-bit long integer in network byte order
+ * @return       The 32-bit long integer converted in host byte order
+ */
+static inline uint32_t rohc_ntoh32(const uint32_t net32)
+{
+#if WORDS_BIGENDIAN == 1
+	return net32;
+#else
+	return __builtin_bswap32(net32);
+#endif
+}
+
+
+/**
+ * @brief Convert a 16-bit short integer from network to host byte orders
+ *
+ * @param net16  The 16-bit short integer in network byte order
+ * @return       The 16-bit short integer converted in host byte order
+ */
+static inline uint16_t rohc_ntoh16(const uint16_t net16)
+{
+#if WORDS_BIGENDIAN == 1
+	return net16;
+#else
+	return __builtin_bswap16(net16);
+#endif
+}
+
+
+/**
+ * @brief Convert a 32-bit long integer from host to network byte orders
+ *
+ * @param host32  The 32-bit long integer in host byte order
+ * @return        The 32-bit long integer converted in network byte order
+ */
+static inline uint32_t rohc_hton32(const uint32_t host32)
+{
+	return rohc_ntoh32(host32);
+}
+
+
+/**
+ * @brief Convert a 16-bit short integer from host to network byte orders
+ *
+ * @param host16  The 16-bit short integer in host byte order
+ * @return        The 16-bit short integer converted in network byte order
+ */
+static inline uint16_t rohc_hton16(const uint16_t host16)
+{
+	return rohc_ntoh16(host16);
+}
+
 #endif
 
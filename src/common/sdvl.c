@@ -25,50 +25,71 @@
  */
 
 #include "sdvl.h"
-#include "rohc_bit_ops.h"
 
 #include <assert.h>
 
 
-/** The maximum values that can be SDVL-encoded in 1, 2, 3 and 4 bytes */
-typedef enum
-{
-	/** Maximum value in 1 SDVL-encoded byte */
-	ROHC_SDVL_MAX_VALUE_IN_1_BYTE = ((1 << ROHC_SDVL_MAX_BITS_IN_1_BYTE) - 1),
-	/** Maximum value in 2 SDVL-encoded byte */
-	ROHC_SDVL_MAX_VALUE_IN_2_BYTES = ((1 << ROHC_SDVL_MAX_BITS_IN_2_BYTES) - 1),
-	/** Maximum value in 3 SDVL-encoded byte */
-	ROHC_SDVL_MAX_VALUE_IN_3_BYTES = ((1 << ROHC_SDVL_MAX_BITS_IN_3_BYTES) - 1),
-	/** Maximum value in 4 SDVL-encoded byte */
-	ROHC_SDVL_MAX_VALUE_IN_4_BYTES = ((1 << ROHC_SDVL_MAX_BITS_IN_4_BYTES) - 1),
-} rohc_sdvl_max_value_t;
-
-
 /**
- * @brief Can the given value be encoded with SDVL?
- *
- * See 4.5.6 in the RFC 3095 for details about SDVL encoding.
+ * @brief The number of SDVL bytes for every number of bits to encode
  *
- * @param value  The value to encode
- * @return       Whether the value can be encoded with SDVL or not
+ * Index 0 is 1 byte, indexes 30 to 32 are 5 bytes (not encodable).
  */
-bool sdvl_can_value_be_encoded(const uint32_t value)
+static const uint8_t rohc_sdvl_len_by_bits[33] =
 {
-	return (value <= ROHC_SDVL_MAX_VALUE_IN_4_BYTES);
-}
+	1, 1, 1, 1, 1, 1, 1, 1,    /* 0 to 7 bits */
+	2, 2, 2, 2, 2, 2, 2,       /* 8 to 14 bits */
+	3, 3, 3, 3, 3, 3, 3,       /* 15 to 21 bits */
+	4, 4, 4, 4, 4, 4, 4, 4,    /* 22 to 29 bits */
+	5, 5, 5                    /* 30 to 32 bits */
+};
+
+/** The max numbers of bits for every number of SDVL bytes */
+static const uint8_t rohc_sdvl_bits_by_len[6] =
+{
+	0,
+	ROHC_SDVL_MAX_BITS_IN_1_BYTE,
+	ROHC_SDVL_MAX_BITS_IN_2_BYTES,
+	ROHC_SDVL_MAX_BITS_IN_3_BYTES,
+	ROHC_SDVL_MAX_BITS_IN_4_BYTES,
+	0
+};
+
+/** The number of SDVL bytes for the 3 most significant bits of the 1st byte */
+static const uint8_t rohc_sdvl_len_by_prefix[8] =
+{
+	1, 1, 1, 1, /* 0xx */
+	2, 2,       /* 10x */
+	3,          /* 110 */
+	4           /* 111 */
+};
+
+/** The masks of the value bits in the 1st byte for every SDVL length */
+static const uint8_t rohc_sdvl_mask_by_len[5] =
+{
+	0x00, 0x7f, 0x3f, 0x1f, 0x1f
+};
+
+/** The discriminator bits in the 1st byte for every SDVL length */
+static const uint8_t rohc_sdvl_disc_by_len[5] =
+{
+	0x00, 0x00, 0x80, 0xc0, 0xe0
+};
+
+
+static inline size_t rohc_sdvl_bits_nr(const uint32_t value)
+	__attribute__((warn_unused_result, const));
 
 
 /**
- * @brief Is the given length (in bits) compatible with SDVL?
+ * @brief Get the number of bits of the given value
  *
- * See 4.5.6 in the RFC 3095 for details about SDVL encoding.
- *
- * @param bits_nr  The length (in bits) of the value to encode
- * @return         Whether the value can be encoded with SDVL or not
+ * @param value  The value
+ * @return       The position of the most significant bit set plus one,
+ *               0 for value 0
  */
-bool sdvl_can_length_be_encoded(const size_t bits_nr)
+static inline size_t rohc_sdvl_bits_nr(const uint32_t value)
 {
-	return (bits_nr <= ROHC_SDVL_MAX_BITS_IN_4_BYTES);
+	return (value == 0 ? 0 : (32 - __builtin_clz(value)));
 }
 
 
@@ -97,23 +118,7 @@ size_t sdvl_get_min_len(const size_t nr_min_required,
 		const size_t remaining = nr_min_required - nr_encoded;
 
 		assert(remaining <= ROHC_SDVL_MAX_BITS_IN_4_BYTES);
-
-		if(remaining <= ROHC_SDVL_MAX_BITS_IN_1_BYTE)
-		{
-			nr_needed = ROHC_SDVL_MAX_BITS_IN_1_BYTE;
-		}
-		else if(remaining <= ROHC_SDVL_MAX_BITS_IN_2_BYTES)
-		{
-			nr_needed = ROHC_SDVL_MAX_BITS_IN_2_BYTES;
-		}
-		else if(remaining <= ROHC_SDVL_MAX_BITS_IN_3_BYTES)
-		{
-			nr_needed = ROHC_SDVL_MAX_BITS_IN_3_BYTES;
-		}
-		else
-		{
-			nr_needed = ROHC_SDVL_MAX_BITS_IN_4_BYTES;
-		}
+		nr_needed = rohc_sdvl_bits_by_len[rohc_sdvl_len_by_bits[remaining]];
 	}
 
 	assert((nr_encoded + nr_needed) >= nr_min_required);
@@ -122,46 +127,6 @@ size_t sdvl_get_min_len(const size_t nr_min_required,
 }
 
 
-/**
- * @brief Find out how many bytes are needed to represent the value using
- *        Self-Describing Variable-Length (SDVL) encoding
- *
- * See 4.5.6 in the RFC 3095 for details about SDVL encoding.
- *
- * @param value  The value to encode
- * @return       The size needed to represent the SDVL-encoded value
- */
-size_t sdvl_get_encoded_len(const uint32_t value)
-{
-	size_t size;
-
-	/* find the length for SDVL-encoding */
-	if(value <= ROHC_SDVL_MAX_VALUE_IN_1_BYTE)
-	{
-		size = 1;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_2_BYTES)
-	{
-		size = 2;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_3_BYTES)
-	{
-		size = 3;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_4_BYTES)
-	{
-		size = 4;
-	}
-	else
-	{
-		/* value is too large for SDVL-encoding */
-		size = 5;
-	}
-
-	return size;
-}
-
-
 /**
  * @brief Encode a value using Self-Describing Variable-Length (SDVL) encoding
  *
@@ -183,68 +148,47 @@ bool sdvl_encode(uint8_t *const sdvl_bytes,
                  const uint32_t value,
                  const size_t bits_nr)
 {
+	size_t len;
+
 	/* encoding 0 bit is an error */
 	assert(bits_nr > 0);
 
-	/* encode the value according to the number of available bits */
-	if(bits_nr <= ROHC_SDVL_MAX_BITS_IN_1_BYTE)
-	{
-		*sdvl_bytes_nr = 1;
-		if(sdvl_bytes_max_nr < (*sdvl_bytes_nr))
-		{
-			/* number of bytes needed is too large for buffer */
-			goto error;
-		}
-
-		/* bit pattern 0 */
-		sdvl_bytes[0] = value & 0x7f;
-	}
-	else if(bits_nr <= ROHC_SDVL_MAX_BITS_IN_2_BYTES)
+	/* the number of bytes is given by the number of bits to encode */
+	if(bits_nr > ROHC_SDVL_MAX_BITS_IN_4_BYTES)
 	{
-		*sdvl_bytes_nr = 2;
-		if(sdvl_bytes_max_nr < (*sdvl_bytes_nr))
-		{
-			/* number of bytes needed is too large for buffer */
-			goto error;
-		}
-
-		/* 2 = bit pattern 10 */
-		sdvl_bytes[0] = ((2 << 6) | ((value >> 8) & 0x3f)) & 0xff;
-		sdvl_bytes[1] = value & 0xff;
-	}
-	else if(bits_nr <= ROHC_SDVL_MAX_BITS_IN_3_BYTES)
-	{
-		*sdvl_bytes_nr = 3;
-		if(sdvl_bytes_max_nr < (*sdvl_bytes_nr))
-		{
-			/* number of bytes needed is too large for buffer */
-			goto error;
-		}
-
-		/* 6 = bit pattern 110 */
-		sdvl_bytes[0] = ((6 << 5) | ((value >> 16) & 0x1f)) & 0xff;
-		sdvl_bytes[1] = (value >> 8) & 0xff;
-		sdvl_bytes[2] = value & 0xff;
+		/* number of bytes needed is too large (value must be < 2^29) */
+		goto error;
 	}
-	else if(bits_nr <= ROHC_SDVL_MAX_BITS_IN_4_BYTES)
+	len = rohc_sdvl_len_by_bits[bits_nr];
+	*sdvl_bytes_nr = len;
+	if(sdvl_bytes_max_nr < len)
 	{
-		*sdvl_bytes_nr = 4;
-		if(sdvl_bytes_max_nr < (*sdvl_bytes_nr))
-		{
-			/* number of bytes needed is too large for buffer */
-			goto error;
-		}
-
-		/* 7 = bit pattern 111 */
-		sdvl_bytes[0] = ((7 << 5) | ((value >> 24) & 0x1f)) & 0xff;
-		sdvl_bytes[1] = (value >> 16) & 0xff;
-		sdvl_bytes[2] = (value >> 8) & 0xff;
-		sdvl_bytes[3] = value & 0xff;
+		/* number of bytes needed is too large for buffer */
+		goto error;
 	}
-	else
+
+	/* write the bytes from the last one, the 1st byte holds the bit pattern
+	 * 0, 10, 110 or 111 */
+	switch(len)
 	{
-		/* number of bytes needed is too large (value must be < 2^29) */
-		goto error;
+		case 4:
+			sdvl_bytes[3] = value & 0xff;
+			sdvl_bytes[2] = (value >> 8) & 0xff;
+			sdvl_bytes[1] = (value >> 16) & 0xff;
+			sdvl_bytes[0] = rohc_sdvl_disc_by_len[4] | ((value >> 24) & 0x1f);
+			break;
+		case 3:
+			sdvl_bytes[2] = value & 0xff;
+			sdvl_bytes[1] = (value >> 8) & 0xff;
+			sdvl_bytes[0] = rohc_sdvl_disc_by_len[3] | ((value >> 16) & 0x1f);
+			break;
+		case 2:
+			sdvl_bytes[1] = value & 0xff;
+			sdvl_bytes[0] = rohc_sdvl_disc_by_len[2] | ((value >> 8) & 0x3f);
+			break;
+		default:
+			sdvl_bytes[0] = value & 0x7f;
+			break;
 	}
 
 	return true;
@@ -273,26 +217,10 @@ bool sdvl_encode_full(uint8_t *const sdvl_bytes,
                       size_t *const sdvl_bytes_nr,
                       const uint32_t value)
 {
-	size_t bits_nr;
+	const size_t len = rohc_sdvl_len_by_bits[rohc_sdvl_bits_nr(value)];
+	const size_t bits_nr = rohc_sdvl_bits_by_len[len];
 
-	/* find the number of bits for SDVL-encoding */
-	if(value <= ROHC_SDVL_MAX_VALUE_IN_1_BYTE)
-	{
-		bits_nr = ROHC_SDVL_MAX_BITS_IN_1_BYTE;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_2_BYTES)
-	{
-		bits_nr = ROHC_SDVL_MAX_BITS_IN_2_BYTES;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_3_BYTES)
-	{
-		bits_nr = ROHC_SDVL_MAX_BITS_IN_3_BYTES;
-	}
-	else if(value <= ROHC_SDVL_MAX_VALUE_IN_4_BYTES)
-	{
-		bits_nr = ROHC_SDVL_MAX_BITS_IN_4_BYTES;
-	}
-	else
+	if(bits_nr == 0)
 	{
 		/* value is too large for SDVL-encoding */
 		goto error;
@@ -324,6 +252,7 @@ size_t sdvl_decode(const uint8_t *const data,
                    size_t *const bits_nr)
 {
 	size_t sdvl_len;
+	uint32_t decoded;
 
 	if(length < 1)
 	{
@@ -331,50 +260,31 @@ size_t sdvl_decode(const uint8_t *const data,
 		goto error;
 	}
 
-	if(!GET_BIT_7(data)) /* bit == 0 */
-	{
-		*value = GET_BIT_0_6(data);
-		*bits_nr = ROHC_SDVL_MAX_BITS_IN_1_BYTE;
-		sdvl_len = 1;
-	}
-	else if(GET_BIT_6_7(data) == (0x8 >> 2)) /* bits == 0b10 */
-	{
-		if(length < 2)
-		{
-			/* packet too small to decode SDVL field */
-			goto error;
-		}
-		*value = (GET_BIT_0_5(data) << 8 | GET_BIT_0_7(data + 1));
-		*bits_nr = ROHC_SDVL_MAX_BITS_IN_2_BYTES;
-		sdvl_len = 2;
-	}
-	else if(GET_BIT_5_7(data) == (0xc >> 1)) /* bits == 0b110 */
+	/* the length is given by the bit pattern 0, 10, 110 or 111 */
+	sdvl_len = rohc_sdvl_len_by_prefix[data[0] >> 5];
+	if(length < sdvl_len)
 	{
-		if(length < 3)
-		{
-			/* packet too small to decode SDVL field */
-			goto error;
-		}
-		*value = (GET_BIT_0_4(data) << 16 |
-		          GET_BIT_0_7(data + 1) << 8 |
-		          GET_BIT_0_7(data + 2));
-		*bits_nr = ROHC_SDVL_MAX_BITS_IN_3_BYTES;
-		sdvl_len = 3;
+		/* packet too small to decode SDVL field */
+		goto error;
 	}
-	else /* bits == 0b111 */
+
+	decoded = data[0] & rohc_sdvl_mask_by_len[sdvl_len];
+	switch(sdvl_len)
 	{
-		if(length < 4)
-		{
-			/* packet too small to decode SDVL field */
-			goto error;
-		}
-		*value = (GET_BIT_0_4(data) << 24 |
-		          GET_BIT_0_7(data + 1) << 16 |
-		          GET_BIT_0_7(data + 2) << 8 |
-		          GET_BIT_0_7(data + 3));
-		*bits_nr = ROHC_SDVL_MAX_BITS_IN_4_BYTES;
-		sdvl_len = 4;
+		case 4:
+			decoded = (decoded << 24) | (data[1] << 16) | (data[2] << 8) | data[3];
+			break;
+		case 3:
+			decoded = (decoded << 16) | (data[1] << 8) | data[2];
+			break;
+		case 2:
+			decoded = (decoded << 8) | data[1];
+			break;
+		default:
+			break;
 	}
+	*value = decoded;
+	*bits_nr = rohc_sdvl_bits_by_len[sdvl_len];
 
 	return sdvl_len;
 
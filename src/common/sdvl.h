@@ -55,19 +55,33 @@ typedef enum
 } rohc_sdvl_max_bits_t;
 
 
+/** The maximum values that can be SDVL-encoded in 1, 2, 3 and 4 bytes */
+typedef enum
+{
+	/** Maximum value in 1 SDVL-encoded byte */
+	ROHC_SDVL_MAX_VALUE_IN_1_BYTE = ((1 << ROHC_SDVL_MAX_BITS_IN_1_BYTE) - 1),
+	/** Maximum value in 2 SDVL-encoded byte */
+	ROHC_SDVL_MAX_VALUE_IN_2_BYTES = ((1 << ROHC_SDVL_MAX_BITS_IN_2_BYTES) - 1),
+	/** Maximum value in 3 SDVL-encoded byte */
+	ROHC_SDVL_MAX_VALUE_IN_3_BYTES = ((1 << ROHC_SDVL_MAX_BITS_IN_3_BYTES) - 1),
+	/** Maximum value in 4 SDVL-encoded byte */
+	ROHC_SDVL_MAX_VALUE_IN_4_BYTES = ((1 << ROHC_SDVL_MAX_BITS_IN_4_BYTES) - 1),
+} rohc_sdvl_max_value_t;
+
+
 /*
  * Function prototypes.
  */
 
-bool sdvl_can_value_be_encoded(const uint32_t value)
+static inline bool sdvl_can_value_be_encoded(const uint32_t value)
 	__attribute__((warn_unused_result, const));
-bool sdvl_can_length_be_encoded(const size_t bits_nr)
+static inline bool sdvl_can_length_be_encoded(const size_t bits_nr)
 	__attribute__((warn_unused_result, const));
 
 size_t sdvl_get_min_len(const size_t nr_min_required, const size_t nr_encoded)
 	__attribute__((warn_unused_result, const));
 
-size_t sdvl_get_encoded_len(const uint32_t value)
+static inline size_t sdvl_get_encoded_len(const uint32_t value)
 	__attribute__((warn_unused_result, const));
 
 bool sdvl_encode(uint8_t *const packet,
@@ -89,5 +103,52 @@ size_t sdvl_decode(const uint8_t *const data,
                    size_t *const bits_nr)
 	__attribute__((warn_unused_result, nonnull(1, 3, 4)));
 
+
+/**
+ * @brief Can the given value be encoded with SDVL?
+ *
+ * See 4.5.6 in the RFC 3095 for details about SDVL encoding.
+ *
+ * @param value  The value to encode
+ * @return       Whether the value can be encoded with SDVL or not
+ */
+static inline bool sdvl_can_value_be_encoded(const uint32_t value)
+{
+	return (value <= ROHC_SDVL_MAX_VALUE_IN_4_BYTES);
+}
+
+
+/**
+ * @brief Is the given length (in bits) compatible with SDVL?
+ *
+ * See 4.5.6 in the RFC 3095 for details about SDVL encoding.
+ *
+ * @param bits_nr  The length (in bits) of the value to encode
+ * @return         Whether the value can be encoded with SDVL or not
+ */
+static inline bool sdvl_can_length_be_encoded(const size_t bits_nr)
+{
+	return (bits_nr <= ROHC_SDVL_MAX_BITS_IN_4_BYTES);
+}
+
+
+/**
+ * @brief Find out how many bytes are needed to represent the value using
+ *        Self-Describing Variable-Length (SDVL) encoding
+ *
+ * See 4.5.6 in the RFC 3095 for details about SDVL encoding.
+ *
+ * @param value  The value to encode
+ * @return       The size needed to represent the SDVL-encoded value,
+ *               5 if the value cannot be encoded
+ */
+static inline size_t sdvl_get_encoded_len(const uint32_t value)
+{
+	return (1 + (value > ROHC_SDVL_MAX_VALUE_IN_1_BYTE) +
+	        (value > ROHC_SDVL_MAX_VALUE_IN_2_BYTES) +
+	        (value > ROHC_SDVL_MAX_VALUE_IN_3_BYTES) +
+	        (value > ROHC_SDVL_MAX_VALUE_IN_4_BYTES));
+}
+
 #endif
 
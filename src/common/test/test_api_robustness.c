@@ -25,6 +25,7 @@
 #include "rohc.h"
 #include <rohc/rohc_buf.h>
 #include "rohc_packets.h"
+#include "rohc_traces.h"
 #include "protocols/ip_numbers.h"
 #include "protocols/tcp.h"
 
@@ -147,6 +148,9 @@ int main(int argc, char *argv[])
 		CHECK(strcmp(rohc_get_profile_descr(ROHC_PROFILE_UDPLITE), "") != 0);
 		CHECK(strcmp(rohc_get_profile_descr(ROHC_PROFILE_UDPLITE), unknown) != 0);
 		CHECK(strcmp(rohc_get_profile_descr(ROHC_PROFILE_UDPLITE + 1), unknown) == 0);
+		CHECK(strcmp(rohc_get_profile_descr(ROHCv2_PROFILE_IP), "") != 0);
+		CHECK(strcmp(rohc_get_profile_descr(ROHCv2_PROFILE_IP), unknown) != 0);
+		CHECK(strcmp(rohc_get_profile_descr(ROHCv2_PROFILE_IP + 1), unknown) == 0);
 	}
 
 	/* rohc_get_packet_descr() */
@@ -219,7 +223,20 @@ int main(int argc, char *argv[])
 		CHECK(strcmp(rohc_get_packet_descr(ROHC_PACKET_TCP_SEQ_8), "") != 0);
 		CHECK(strcmp(rohc_get_packet_descr(ROHC_PACKET_TCP_SEQ_8), unknown) != 0);
 
-		CHECK(strcmp(rohc_get_packet_descr(ROHC_PACKET_TCP_SEQ_8 + 1), unknown) == 0);
+		CHECK(strcmp(rohc_get_packet_descr(ROHC_PACKET_IR_CR), "") != 0);
+		CHECK(strcmp(rohc_get_packet_descr(ROHC_PACKET_IR_CR), unknown) != 0);
+
+		CHECK(strcmp(rohc_get_packet_descr(ROHC_PACKET_CO_REPAIR), "") != 0);
+		CHECK(strcmp(rohc_get_packet_descr(ROHC_PACKET_CO_REPAIR), unknown) != 0);
+		CHECK(strcmp(rohc_get_packet_descr(ROHC_PACKET_CO_COMMON), "") != 0);
+		CHECK(strcmp(rohc_get_packet_descr(ROHC_PACKET_CO_COMMON), unknown) != 0);
+
+		CHECK(strcmp(rohc_get_packet_descr(ROHC_PACKET_R_0), "") != 0);
+		CHECK(strcmp(rohc_get_packet_descr(ROHC_PACKET_R_0), unknown) != 0);
+		CHECK(strcmp(rohc_get_packet_descr(ROHC_PACKET_R_0_CRC), "") != 0);
+		CHECK(strcmp(rohc_get_packet_descr(ROHC_PACKET_R_0_CRC), unknown) != 0);
+
+		CHECK(strcmp(rohc_get_packet_descr(ROHC_PACKET_R_0_CRC + 1), unknown) == 0);
 		CHECK(strcmp(rohc_get_packet_descr(ROHC_PACKET_UNKNOWN), unknown) == 0);
 	}
 
@@ -241,6 +258,36 @@ int main(int argc, char *argv[])
 		CHECK(strcmp(rohc_get_ext_descr(ROHC_EXT_NONE + 1), unknown) == 0);
 	}
 
+	/* rohc_trace_ring_init() and rohc_trace_ring_read() */
+	{
+		struct rohc_trace_record records[8];
+		struct rohc_trace_record read_records[8];
+		struct rohc_trace_ring ring;
+		uint32_t next_seq = 0;
+
+		CHECK(rohc_trace_ring_init(NULL, records, 8) == false);
+		CHECK(rohc_trace_ring_init(&ring, NULL, 8) == false);
+		CHECK(rohc_trace_ring_init(&ring, records, 0) == false);
+		CHECK(rohc_trace_ring_init(&ring, records, 6) == false);
+		CHECK(rohc_trace_ring_init(&ring, records, 1) == true);
+		CHECK(rohc_trace_ring_init(&ring, records, 8) == true);
+		CHECK(rohc_trace_ring_read(&ring, &next_seq, read_records, 8) == 0);
+		CHECK(next_seq == 0);
+	}
+
+	/* rohc_trace_event_get_descr() */
+	{
+		const char unknown[] = "no description";
+		rohc_trace_event_t event;
+
+		for(event = ROHC_TRACE_EVENT_COMP_PKT; event < ROHC_TRACE_EVENT_MAX; event++)
+		{
+			CHECK(strcmp(rohc_trace_event_get_descr(event), "") != 0);
+			CHECK(strcmp(rohc_trace_event_get_descr(event), unknown) != 0);
+		}
+		CHECK(strcmp(rohc_trace_event_get_descr(ROHC_TRACE_EVENT_MAX), unknown) == 0);
+	}
+
 	/* rohc_get_packet_type() */
 	{
 		const char *const packet_type_names[ROHC_PACKET_MAX] = {
@@ -256,6 +303,10 @@ int main(int argc, char *argv[])
 			"tcp-rnd-5", "tcp-rnd-6", "tcp-rnd-7", "tcp-rnd-8",
 			"tcp-seq-1", "tcp-seq-2", "tcp-seq-3", "tcp-seq-4",
 			"tcp-seq-5", "tcp-seq-6", "tcp-seq-7", "tcp-seq-8",
+			"ircr",
+			"co-repair", "pt-0-crc3", "nortp-pt-0-crc7",
+			"nortp-pt-1-seq-id", "nortp-pt-2-seq-id", "co-common",
+			"r0", "r0-crc",
 		};
 		rohc_packet_t packet_type;
 
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_bit_stream.c
+ * @brief   Test the bit reader and the bit writer of ROHC headers
+ * @author  Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_bit_stream.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/**
+ * @brief Test the bit reader and the bit writer of ROHC headers
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the bit reader and the bit writer of ROHC headers\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* write then read a seq_8-like header: 4+4+1+7+4+1+3+1+15+2+14 bits */
+	{
+		const uint8_t exp_bytes[7] = { 0xb5, 0xa5, 0x9b, 0x7f, 0xfe, 0x7f, 0xff };
+		const size_t widths[] = { 4, 4, 1, 7, 4, 1, 3, 1, 15, 2, 14 };
+		const uint32_t values[] = { 0xb, 0x5, 1, 0x25, 0x9, 1, 0x3, 0, 0x7ffe, 1, 0x3fff };
+		const size_t fields_nr = sizeof(widths) / sizeof(size_t);
+		size_t max_len;
+
+		/* short buffers store the bytes one by one, long buffers 8 at a time */
+		for(max_len = sizeof(exp_bytes); max_len <= 16; max_len++)
+		{
+			uint8_t bytes[16];
+			struct rohc_bit_writer writer;
+			struct rohc_bit_reader reader;
+			size_t i;
+
+			memset(bytes, 0xaa, sizeof(bytes));
+			rohc_bit_writer_init(&writer, bytes, max_len);
+			for(i = 0; i < fields_nr; i++)
+			{
+				rohc_bit_write(&writer, values[i], widths[i]);
+			}
+			CHECK(rohc_bit_writer_finish(&writer) == sizeof(exp_bytes));
+			CHECK(memcmp(bytes, exp_bytes, sizeof(exp_bytes)) == 0);
+
+			rohc_bit_reader_init(&reader, bytes, max_len, 0);
+			CHECK(rohc_bit_reader_avail(&reader) == max_len);
+			for(i = 0; i < fields_nr; i++)
+			{
+				CHECK(rohc_bit_read(&reader, widths[i]) == values[i]);
+			}
+			CHECK(rohc_bit_reader_offset(&reader) == sizeof(exp_bytes));
+			CHECK(rohc_bit_reader_avail(&reader) == (max_len - sizeof(exp_bytes)));
+		}
+	}
+
+	/* the large CID between the first byte and the other bytes is skipped */
+	{
+		const uint8_t large_cid[2] = { 0x81, 0x02 };
+		size_t large_cid_len;
+
+		for(large_cid_len = 0; large_cid_len <= 2; large_cid_len++)
+		{
+			uint8_t packet[6];
+			struct rohc_bit_reader reader;
+
+			packet[0] = 0xba;
+			memcpy(packet + 1, large_cid, large_cid_len);
+			packet[1 + large_cid_len] = 0xbc;
+			packet[2 + large_cid_len] = 0xde;
+			packet[3 + large_cid_len] = 0xf0;
+
+			rohc_bit_reader_init(&reader, packet, 4 + large_cid_len, large_cid_len);
+			CHECK(rohc_bit_reader_avail(&reader) == 4);
+			CHECK(rohc_bit_read(&reader, 6) == 0x2e);
+			CHECK(rohc_bit_read(&reader, 18) == 0x2bcde);
+			CHECK(rohc_bit_read(&reader, 8) == 0xf0);
+			CHECK(rohc_bit_reader_offset(&reader) == 4);
+			CHECK(rohc_bit_reader_avail(&reader) == 0);
+		}
+	}
+
+	/* 32-bit fields across the 64-bit cache */
+	{
+		uint8_t bytes[24];
+		struct rohc_bit_writer writer;
+		struct rohc_bit_reader reader;
+		uint32_t value;
+		size_t i;
+
+		rohc_bit_writer_init(&writer, bytes, sizeof(bytes));
+		rohc_bit_write(&writer, 0x5, 3);
+		for(value = 0x89abcdef, i = 0; i < 5; i++, value = ~value)
+		{
+			rohc_bit_write(&writer, value, 32);
+		}
+		rohc_bit_write(&writer, 0x1f, 5);
+		CHECK(rohc_bit_writer_finish(&writer) == 21);
+
+		rohc_bit_reader_init(&reader, bytes, 21, 0);
+		CHECK(rohc_bit_read(&reader, 3) == 0x5);
+		for(value = 0x89abcdef, i = 0; i < 5; i++, value = ~value)
+		{
+			CHECK(rohc_bit_read(&reader, 32) == value);
+		}
+		CHECK(rohc_bit_read(&reader, 5) == 0x1f);
+		CHECK(rohc_bit_reader_avail(&reader) == 0);
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_buf_vec.c
+ * @brief   Test the vectored network buffers and the arenas of network buffers
+ * @author  Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_buf.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/**
+ * @brief Test the vectored network buffers and the arenas of network buffers
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the vectored network buffers and the arenas of network "
+		       "buffers\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* a ROHC header followed by the payload of the uncompressed packet */
+	{
+		const struct rohc_ts time = { .sec = 0, .nsec = 0 };
+		uint8_t ip_data[8] = { 0x45, 0x00, 0x00, 0x08, 0xde, 0xad, 0xbe, 0xef };
+		uint8_t hdr_data[2] = { 0xfd, 0x42 };
+		const uint8_t exp_bytes[6] = { 0xfd, 0x42, 0xde, 0xad, 0xbe, 0xef };
+		const struct rohc_buf ip_packet =
+			rohc_buf_init_full(ip_data, sizeof(ip_data), time);
+		const struct rohc_buf rohc_hdr =
+			rohc_buf_init_full(hdr_data, sizeof(hdr_data), time);
+		uint8_t out_data[8];
+		struct rohc_buf out = rohc_buf_init_empty(out_data, sizeof(out_data));
+		struct rohc_buf_vec vec;
+
+		rohc_buf_vec_init_hdr(&vec, rohc_hdr, ip_packet, 4);
+		CHECK(vec.segs_nr == 2);
+		CHECK(rohc_buf_vec_len(&vec) == sizeof(exp_bytes));
+		CHECK(rohc_buf_vec_linearize(&vec, &out));
+		CHECK(out.len == sizeof(exp_bytes));
+		CHECK(memcmp(rohc_buf_data(out), exp_bytes, sizeof(exp_bytes)) == 0);
+
+		/* the output buffer is too small for a second copy */
+		CHECK(!rohc_buf_vec_linearize(&vec, &out));
+		CHECK(out.len == sizeof(exp_bytes));
+
+		/* empty segments are ignored, the number of segments is limited */
+		rohc_buf_vec_init(&vec);
+		rohc_buf_reset(&out);
+		CHECK(rohc_buf_vec_add(&vec, out));
+		CHECK(vec.segs_nr == 0);
+		while(vec.segs_nr < ROHC_BUF_VEC_MAX_SEGS)
+		{
+			CHECK(rohc_buf_vec_add(&vec, rohc_hdr));
+		}
+		CHECK(!rohc_buf_vec_add(&vec, rohc_hdr));
+		CHECK(rohc_buf_vec_len(&vec) == (ROHC_BUF_VEC_MAX_SEGS * sizeof(hdr_data)));
+	}
+
+	/* carve the buffers of bursts from one arena */
+	{
+		uint8_t mem[100];
+		struct rohc_buf_arena arena;
+		struct rohc_buf bufs[4];
+		struct rohc_buf buf;
+
+		rohc_buf_arena_init(&arena, mem, sizeof(mem));
+
+		/* 3 buffers of 20 bytes take 24 bytes each */
+		CHECK(rohc_buf_arena_alloc_burst(&arena, bufs, 3, 20));
+		CHECK(bufs[0].data == mem);
+		CHECK(bufs[1].data == (mem + 24));
+		CHECK(bufs[2].data == (mem + 48));
+		CHECK(bufs[2].max_len == 20 && bufs[2].len == 0 && bufs[2].offset == 0);
+		CHECK(arena.used == 72);
+
+		/* the arena cannot hold 2 more buffers: none is carved */
+		CHECK(!rohc_buf_arena_alloc_burst(&arena, bufs, 2, 20));
+		CHECK(arena.used == 72);
+		CHECK(rohc_buf_arena_alloc(&arena, 28, &buf));
+		CHECK(buf.data == (mem + 72));
+		CHECK(!rohc_buf_arena_alloc(&arena, 1, &buf));
+
+		/* all the buffers are given back at once */
+		rohc_buf_arena_reset(&arena);
+		CHECK(!rohc_buf_arena_alloc_burst(&arena, bufs, 4, 25));
+		CHECK(rohc_buf_arena_alloc_burst(&arena, bufs, 4, 24));
+		CHECK(bufs[3].data == (mem + 72));
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
@@ -0,0 +1,138 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_burst.c
+ * @brief   Test the grouping of the packets of a burst by context
+ * @author  Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_burst.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/**
+ * @brief Test the grouping of the packets of a burst by context
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	size_t order[ROHC_BURST_GROUP_MAX];
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the grouping of the packets of a burst by context\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* interleaved contexts are grouped, every context keeps its order */
+	{
+		const uint32_t keys[] = { 1, 2, 1, 3, 2, 1 };
+		const bool has_key[] = { true, true, true, true, true, true };
+		const size_t expected[] = { 0, 2, 5, 1, 4, 3 };
+
+		rohc_burst_group(keys, has_key, 6, order);
+		CHECK(memcmp(order, expected, sizeof(expected)) == 0);
+	}
+
+	/* no packet crosses a packet without key */
+	{
+		const uint32_t keys[] = { 1, 2, 1, 0, 1, 2, 2 };
+		const bool has_key[] = { true, true, true, false, true, true, true };
+		const size_t expected[] = { 0, 2, 1, 3, 4, 5, 6 };
+
+		rohc_burst_group(keys, has_key, 7, order);
+		CHECK(memcmp(order, expected, sizeof(expected)) == 0);
+	}
+
+	/* the packets without key are never grouped together */
+	{
+		const uint32_t keys[] = { 0, 5, 0 };
+		const bool has_key[] = { false, true, false };
+		const size_t expected[] = { 0, 1, 2 };
+
+		rohc_burst_group(keys, has_key, 3, order);
+		CHECK(memcmp(order, expected, sizeof(expected)) == 0);
+	}
+
+	/* every packet is placed once in the largest groups */
+	{
+		uint32_t keys[ROHC_BURST_GROUP_MAX];
+		bool has_key[ROHC_BURST_GROUP_MAX];
+		size_t i;
+
+		for(i = 0; i < ROHC_BURST_GROUP_MAX; i++)
+		{
+			keys[i] = i % 3;
+			has_key[i] = true;
+		}
+		rohc_burst_group(keys, has_key, ROHC_BURST_GROUP_MAX, order);
+		for(i = 1; i < ROHC_BURST_GROUP_MAX; i++)
+		{
+			CHECK(keys[order[i - 1]] < keys[order[i]] ||
+			      (keys[order[i - 1]] == keys[order[i]] && order[i - 1] < order[i]));
+		}
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
@@ -0,0 +1,319 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_crc.c
+ * @brief   Test the CRC routines against bit-by-bit implementations
+ * @author  Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "crc.h"
+#include "rohc_cpu.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+static uint8_t crc_bitwise(const uint8_t *const data,
+                           const size_t length,
+                           const uint8_t init_val,
+                           const uint8_t polynom,
+                           const uint8_t mask)
+	__attribute__((warn_unused_result));
+
+static uint32_t fcs32_bitwise(const uint8_t *const data,
+                              const size_t length,
+                              const uint32_t init_val)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Test the CRC routines
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	const struct
+	{
+		rohc_crc_type_t type;
+		uint8_t polynom;
+		uint8_t mask;
+		uint8_t init_val;
+		const uint8_t *table;
+	} crcs[] = {
+		{ ROHC_CRC_TYPE_3, 0x6,  0x07, CRC_INIT_3, rohc_crc_table_3 },
+		{ ROHC_CRC_TYPE_7, 0x79, 0x7f, CRC_INIT_7, rohc_crc_table_7 },
+		{ ROHC_CRC_TYPE_8, 0xe0, 0xff, CRC_INIT_8, rohc_crc_table_8 },
+	};
+	const size_t crcs_nr = sizeof(crcs) / sizeof(crcs[0]);
+	const uint8_t check_data[] = "123456789";
+	uint8_t data[300];
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the CRC routines\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* some data with all byte values */
+	for(i = 0; i < sizeof(data); i++)
+	{
+		data[i] = (i * 151 + 7) & 0xff;
+	}
+
+	/* crc_calculate() for every length and alignment */
+	for(i = 0; i < crcs_nr; i++)
+	{
+		const uint8_t *const table = crcs[i].table;
+		size_t off;
+		size_t len;
+
+		for(off = 0; off < 4; off++)
+		{
+			for(len = 0; len <= 160; len++)
+			{
+				CHECK(crc_calculate(crcs[i].type, data + off, len, crcs[i].init_val,
+				                    table) ==
+				      crc_bitwise(data + off, len, crcs[i].init_val,
+				                  crcs[i].polynom, crcs[i].mask));
+			}
+		}
+		CHECK(crc_calculate(crcs[i].type, data, sizeof(data), crcs[i].init_val,
+		                    table) ==
+		      crc_bitwise(data, sizeof(data), crcs[i].init_val,
+		                  crcs[i].polynom, crcs[i].mask));
+
+		/* the CRC may be computed in several steps */
+		{
+			uint8_t crc;
+			crc = crc_calculate(crcs[i].type, data, 13, crcs[i].init_val, table);
+			crc = crc_calculate(crcs[i].type, data + 13, 50, crc, table);
+			CHECK(crc == crc_calculate(crcs[i].type, data, 63, crcs[i].init_val,
+			                           table));
+		}
+	}
+
+	/* the CRC-STATIC cache gives the same CRCs as the uncached computation */
+	{
+		/* IPv4/UDP/RTP headers */
+		uint8_t pkt[20 + 8 + 12] = {
+			0x45, 0x00, 0x00, 0x28, 0x12, 0x34, 0x40, 0x00,
+			0x40, 0x11, 0x00, 0x00, 0xc0, 0xa8, 0x00, 0x01,
+			0xc0, 0xa8, 0x00, 0x02, 0x04, 0xd2, 0x16, 0x2e,
+			0x00, 0x14, 0x00, 0x00, 0x80, 0x00, 0x00, 0x01,
+			0x00, 0x00, 0x00, 0xa0, 0x01, 0x02, 0x03, 0x04,
+		};
+		struct crc_static_cache cache;
+		uint8_t static_bytes[23];
+		size_t round;
+
+		crc_static_cache_init(&cache);
+		for(round = 0; round < 6; round++)
+		{
+			for(i = 0; i < crcs_nr; i++)
+			{
+				CHECK(rtp_compute_crc_static(pkt, NULL, pkt + 20, crcs[i].type,
+				                             crcs[i].init_val, crcs[i].table,
+				                             &cache) ==
+				      rtp_compute_crc_static(pkt, NULL, pkt + 20, crcs[i].type,
+				                             crcs[i].init_val, crcs[i].table,
+				                             NULL));
+				CHECK(udp_compute_crc_static(pkt, NULL, pkt + 20, crcs[i].type,
+				                             crcs[i].init_val, crcs[i].table,
+				                             &cache) ==
+				      udp_compute_crc_static(pkt, NULL, pkt + 20, crcs[i].type,
+				                             crcs[i].init_val, crcs[i].table,
+				                             NULL));
+
+				/* IPv4 bytes 1-2, 7-10, 13-20, UDP bytes 1-4, RTP bytes 1, 9-12 */
+				memcpy(static_bytes, pkt, 2);
+				memcpy(static_bytes + 2, pkt + 6, 4);
+				memcpy(static_bytes + 6, pkt + 12, 8);
+				memcpy(static_bytes + 14, pkt + 20, 4);
+				static_bytes[18] = pkt[28];
+				memcpy(static_bytes + 19, pkt + 36, 4);
+				CHECK(rtp_compute_crc_static(pkt, NULL, pkt + 20, crcs[i].type,
+				                             crcs[i].init_val, crcs[i].table,
+				                             &cache) ==
+				      crc_bitwise(static_bytes, 23, crcs[i].init_val,
+				                  crcs[i].polynom, crcs[i].mask));
+			}
+
+			/* change one dynamic field, then one static field */
+			if(round % 2 == 0)
+			{
+				pkt[5]++; /* IP-ID */
+			}
+			else
+			{
+				pkt[8]--; /* TTL */
+			}
+		}
+	}
+
+	/* crc_calc_fcs32() */
+	CHECK((crc_calc_fcs32(check_data, 9, CRC_INIT_FCS32) ^ 0xffffffff) ==
+	      0xcbf43926);
+	{
+		size_t off;
+		size_t len;
+
+		for(off = 0; off < 4; off++)
+		{
+			for(len = 0; (off + len) <= sizeof(data); len++)
+			{
+				const uint32_t expected =
+					fcs32_bitwise(data + off, len, CRC_INIT_FCS32);
+
+				CHECK(crc_calc_fcs32(data + off, len, CRC_INIT_FCS32) == expected);
+				CHECK(crc_calc_fcs32_generic(data + off, len, CRC_INIT_FCS32) ==
+				      expected);
+#if ROHC_CRC_HAVE_PCLMUL == 1
+				if(rohc_get_cpu_features() & ROHC_CPU_FEATURE_PCLMUL)
+				{
+					CHECK(crc_calc_fcs32_pclmul(data + off, len, CRC_INIT_FCS32) ==
+					      expected);
+				}
+#endif
+#if ROHC_CRC_HAVE_ARM_CRC32 == 1
+				if(rohc_get_cpu_features() & ROHC_CPU_FEATURE_ARM_CRC32)
+				{
+					CHECK(crc_calc_fcs32_arm(data + off, len, CRC_INIT_FCS32) ==
+					      expected);
+				}
+#endif
+			}
+		}
+		CHECK(crc_calc_fcs32(data, sizeof(data), CRC_INIT_FCS32) ==
+		      fcs32_bitwise(data, sizeof(data), CRC_INIT_FCS32));
+	}
+
+	/* rohc_get_cpu_features() */
+	trace(verbose, "CPU features in use: 0x%x\n",
+	      (unsigned int) rohc_get_cpu_features());
+	CHECK((rohc_get_cpu_features() &
+	       ~(ROHC_CPU_FEATURE_PCLMUL | ROHC_CPU_FEATURE_ARM_CRC32)) == 0);
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Compute one CRC-3, CRC-7 or CRC-8 bit by bit
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The length of the data
+ * @param init_val  The initial CRC value
+ * @param polynom   The reversed polynom of the CRC
+ * @param mask      The mask for the bits of the CRC
+ * @return          The CRC
+ */
+static uint8_t crc_bitwise(const uint8_t *const data,
+                           const size_t length,
+                           const uint8_t init_val,
+                           const uint8_t polynom,
+                           const uint8_t mask)
+{
+	uint8_t crc = init_val & mask;
+	size_t i;
+	size_t j;
+
+	for(i = 0; i < length; i++)
+	{
+		crc ^= data[i];
+		for(j = 0; j < 8; j++)
+		{
+			crc = (crc & 1) ? ((crc >> 1) ^ polynom) : (crc >> 1);
+		}
+	}
+
+	return crc;
+}
+
+
+/**
+ * @brief Compute one FCS-32 bit by bit
+ *
+ * @param data      The data to compute the CRC for
+ * @param length    The length of the data
+ * @param init_val  The initial CRC value
+ * @return          The CRC
+ */
+static uint32_t fcs32_bitwise(const uint8_t *const data,
+                              const size_t length,
+                              const uint32_t init_val)
+{
+	uint32_t crc = init_val;
+	size_t i;
+	size_t j;
+
+	for(i = 0; i < length; i++)
+	{
+		crc ^= data[i];
+		for(j = 0; j < 8; j++)
+		{
+			crc = (crc & 1) ? ((crc >> 1) ^ 0xedb88320) : (crc >> 1);
+		}
+	}
+
+	return crc;
+}
+
@@ -0,0 +1,171 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_intern.c
+ * @brief   Test the store of the static header fragments shared by contexts
+ * @author  Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_intern.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/**
+ * @brief Test the store of the static header fragments shared by contexts
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	const struct rohc_mem_ops mem_ops = { NULL, NULL, NULL, NULL };
+	struct rohc_slab slab;
+	struct rohc_intern store;
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the store of the static header fragments shared by "
+		       "contexts\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	rohc_slab_init(&slab);
+	rohc_intern_init(&store, &slab, &mem_ops);
+	CHECK(rohc_intern_mem_len(&store) == 0);
+
+	/* the same bytes are stored once, whatever the buffer they come from */
+	{
+		const uint8_t addrs1[32] = { 0x20, 0x01, 0x0d, 0xb8, [31] = 0x01 };
+		const uint8_t addrs2[32] = { 0x20, 0x01, 0x0d, 0xb8, [31] = 0x01 };
+		const uint8_t addrs3[32] = { 0x20, 0x01, 0x0d, 0xb8, [31] = 0x02 };
+		const uint8_t *frag1;
+		const uint8_t *frag2;
+		const uint8_t *frag3;
+
+		frag1 = rohc_intern_get(&store, addrs1, sizeof(addrs1));
+		CHECK(frag1 != NULL);
+		CHECK(frag1 != addrs1);
+		CHECK(memcmp(frag1, addrs1, sizeof(addrs1)) == 0);
+		frag2 = rohc_intern_get(&store, addrs2, sizeof(addrs2));
+		CHECK(frag2 == frag1);
+		frag3 = rohc_intern_get(&store, addrs3, sizeof(addrs3));
+		CHECK(frag3 != NULL);
+		CHECK(frag3 != frag1);
+		CHECK(store.entries_nr == 2);
+		CHECK(rohc_intern_mem_len(&store) > 0);
+
+		/* the same bytes with another length are another fragment */
+		CHECK(rohc_intern_get(&store, addrs1, 16) != frag1);
+		CHECK(store.entries_nr == 3);
+		rohc_intern_put(&store, rohc_intern_get(&store, addrs1, 16));
+		CHECK(store.entries_nr == 3);
+
+		/* a fragment stays in the store until its last reference is put */
+		CHECK(rohc_intern_ref(frag1) == frag1);
+		rohc_intern_put(&store, frag1);
+		rohc_intern_put(&store, frag2);
+		CHECK(store.entries_nr == 3);
+		CHECK(memcmp(frag1, addrs1, sizeof(addrs1)) == 0);
+		rohc_intern_put(&store, frag1);
+		CHECK(store.entries_nr == 2);
+		rohc_intern_put(&store, frag3);
+		CHECK(store.entries_nr == 1);
+
+		/* putting no fragment does nothing */
+		rohc_intern_put(&store, NULL);
+		CHECK(store.entries_nr == 1);
+	}
+
+	/* the hash table grows with the number of fragments */
+	{
+		const uint8_t *frags[ROHC_INTERN_BUCKETS_MIN * 4];
+		const size_t frags_nr = sizeof(frags) / sizeof(frags[0]);
+		size_t i;
+
+		for(i = 0; i < frags_nr; i++)
+		{
+			uint32_t key = i;
+			frags[i] = rohc_intern_get(&store, &key, sizeof(key));
+			CHECK(frags[i] != NULL);
+		}
+		CHECK(store.entries_nr == (frags_nr + 1));
+		CHECK(store.mask >= (frags_nr - 1));
+
+		/* all fragments are still found after the table grew */
+		for(i = 0; i < frags_nr; i++)
+		{
+			uint32_t key = i;
+			const uint8_t *const frag = rohc_intern_get(&store, &key, sizeof(key));
+			CHECK(frag == frags[i]);
+			rohc_intern_put(&store, frag);
+			rohc_intern_put(&store, frags[i]);
+		}
+		CHECK(store.entries_nr == 1);
+	}
+
+	/* the fragments that remain are freed with the store */
+	rohc_intern_release(&store);
+	CHECK(store.entries_nr == 0);
+	CHECK(rohc_intern_mem_len(&store) == 0);
+	rohc_slab_release(&slab);
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_mem_block.c
+ * @brief   Test the allocator that carves memory from one memory block
+ * @author  Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "rohc_mem_block.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+/** Improved assert() */
+#define CHECK(condition) \
+	do { \
+		trace(verbose, "test '%s'\n", #condition); \
+		fflush(stdout); \
+		assert(condition); \
+	} while(0)
+
+
+/**
+ * @brief Test the allocator that carves memory from one memory block
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	const size_t areas_len = 4 * rohc_mem_block_len(100);
+	uint8_t mem[4096];
+	struct rohc_mem_block *block;
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the allocator that carves memory from one memory block\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	CHECK(rohc_mem_block_size(areas_len) <= (sizeof(mem) - 1));
+
+	/* the block shall be large enough for one area at least */
+	CHECK(rohc_mem_block_init(NULL, sizeof(mem)) == NULL);
+	CHECK(rohc_mem_block_init(mem, rohc_mem_block_size(0)) == NULL);
+	CHECK(rohc_mem_block_init(mem, rohc_mem_block_size(rohc_mem_block_len(1))) != NULL);
+
+	/* a block of the computed size serves the areas whatever its alignment */
+	block = rohc_mem_block_init(mem + 1, rohc_mem_block_size(areas_len));
+	CHECK(block != NULL);
+	{
+		uint8_t *areas[5];
+		size_t i;
+
+		for(i = 0; i < 4; i++)
+		{
+			areas[i] = rohc_mem_block_alloc(100, block);
+			CHECK(areas[i] != NULL);
+			CHECK((((uintptr_t) areas[i]) % ROHC_MEM_BLOCK_ALIGN) == 0);
+			CHECK(areas[i] > (mem + 1));
+			CHECK((areas[i] + 100) <= (mem + 1 + rohc_mem_block_size(areas_len)));
+			memset(areas[i], i, 100);
+		}
+		CHECK(areas[0] < areas[1] && areas[1] < areas[2] && areas[2] < areas[3]);
+
+		/* the block is full */
+		CHECK(rohc_mem_block_alloc(1, block) == NULL);
+		CHECK(rohc_mem_block_alloc(areas_len, block) == NULL);
+
+		/* the area given back is used again first */
+		rohc_mem_block_free(areas[1], block);
+		CHECK(rohc_mem_block_alloc(200, block) == NULL);
+		areas[4] = rohc_mem_block_alloc(50, block);
+		CHECK(areas[4] == areas[1]);
+		CHECK(areas[0][99] == 0 && areas[2][0] == 2);
+		rohc_mem_block_free(areas[4], block);
+
+		/* the areas given back are merged with their free neighbours */
+		rohc_mem_block_free(areas[3], block);
+		rohc_mem_block_free(areas[2], block);
+		areas[4] = rohc_mem_block_alloc(3 * rohc_mem_block_len(100) -
+		                                rohc_mem_block_len(1) +
+		                                ROHC_MEM_BLOCK_ALIGN, block);
+		CHECK(areas[4] == areas[1]);
+		rohc_mem_block_free(areas[4], block);
+		rohc_mem_block_free(areas[0], block);
+
+		/* the whole block is free again */
+		areas[4] = rohc_mem_block_alloc(areas_len - rohc_mem_block_len(1) +
+		                                ROHC_MEM_BLOCK_ALIGN, block);
+		CHECK(areas[4] == areas[0]);
+		rohc_mem_block_free(areas[4], block);
+	}
+
+	/* allocations of zero byte take one area too */
+	CHECK(rohc_mem_block_len(0) == rohc_mem_block_len(1));
+	CHECK(rohc_mem_block_len(ROHC_MEM_BLOCK_ALIGN + 1) ==
+	      rohc_mem_block_len(1) + ROHC_MEM_BLOCK_ALIGN);
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
@@ -69,6 +69,8 @@ struct sc_esp_context
 static bool c_esp_create(struct rohc_comp_ctxt *const context,
                          const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static size_t c_esp_mem_max(const size_t wlsb_width)
+	__attribute__((warn_unused_result, const));
 
 static bool c_esp_check_profile(const struct rohc_comp *const comp,
                                 const struct net_pkt *const packet)
@@ -107,6 +109,26 @@ static size_t esp_code_dynamic_esp_part(const struct rohc_comp_ctxt *const conte
  * Private function definitions
  */
 
+/** The handlers of the ESP profile for the generic RFC3095-based code */
+static const struct rohc_comp_rfc3095_ops c_esp_rfc3095_ops =
+{
+	.encode_uncomp_fields = NULL,
+	.decide_state         = rohc_comp_rfc3095_decide_state,
+	.decide_FO_packet     = c_ip_decide_FO_packet,
+	.decide_SO_packet     = c_ip_decide_SO_packet,
+	.decide_extension     = decide_extension,
+	.init_at_IR           = NULL,
+	.get_next_sn          = c_esp_get_next_sn,
+	.code_static_part     = esp_code_static_esp_part,
+	.code_dynamic_part    = esp_code_dynamic_esp_part,
+	.code_ir_remainder    = NULL,
+	.code_UO_packet_head  = NULL,
+	.code_uo_remainder    = NULL,
+	.compute_crc_static   = esp_compute_crc_static,
+	.compute_crc_dynamic  = esp_compute_crc_dynamic,
+};
+
+
 /**
  * @brief Create a new ESP context and initialize it thanks to the given IP/ESP
  *        packet.
@@ -130,7 +152,8 @@ static bool c_esp_create(struct rohc_comp_ctxt *const context,
 	assert(packet != NULL);
 
 	/* create and initialize the generic part of the profile context */
-	if(!rohc_comp_rfc3095_create(context, ROHC_LSB_SHIFT_ESP_SN, packet))
+	if(!rohc_comp_rfc3095_create(context, &c_esp_rfc3095_ops,
+	                             ROHC_LSB_SHIFT_ESP_SN, packet))
 	{
 		rohc_comp_warn(context, "generic context creation failed");
 		goto quit;
@@ -148,7 +171,8 @@ static bool c_esp_create(struct rohc_comp_ctxt *const context,
 	                "packet = %u", rfc3095_ctxt->sn);
 
 	/* create the ESP part of the profile context */
-	esp_context = malloc(sizeof(struct sc_esp_context));
+	esp_context = rohc_slab_alloc(context->compressor->ctxt_slab,
+	                              sizeof(struct sc_esp_context));
 	if(esp_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -162,20 +186,6 @@ static bool c_esp_create(struct rohc_comp_ctxt *const context,
 
 	/* init the ESP-specific variables and functions */
 	rfc3095_ctxt->next_header_len = sizeof(struct esphdr);
-	rfc3095_ctxt->encode_uncomp_fields = NULL;
-	rfc3095_ctxt->decide_state = rohc_comp_rfc3095_decide_state;
-	rfc3095_ctxt->decide_FO_packet = c_ip_decide_FO_packet;
-	rfc3095_ctxt->decide_SO_packet = c_ip_decide_SO_packet;
-	rfc3095_ctxt->decide_extension = decide_extension;
-	rfc3095_ctxt->init_at_IR = NULL;
-	rfc3095_ctxt->get_next_sn = c_esp_get_next_sn;
-	rfc3095_ctxt->code_static_part = esp_code_static_esp_part;
-	rfc3095_ctxt->code_dynamic_part = esp_code_dynamic_esp_part;
-	rfc3095_ctxt->code_ir_remainder = NULL;
-	rfc3095_ctxt->code_UO_packet_head = NULL;
-	rfc3095_ctxt->code_uo_remainder = NULL;
-	rfc3095_ctxt->compute_crc_static = esp_compute_crc_static;
-	rfc3095_ctxt->compute_crc_dynamic = esp_compute_crc_dynamic;
 
 	return true;
 
@@ -448,6 +458,20 @@ static size_t esp_code_dynamic_esp_part(const struct rohc_comp_ctxt *const conte
 }
 
 
+/**
+ * @brief Get the maximum length one ESP context takes in a memory block
+ *
+ * @param wlsb_width  The width of the W-LSB sliding windows
+ * @return            The maximum number of bytes of the memory block the
+ *                    profile-specific part of the context takes
+ */
+static size_t c_esp_mem_max(const size_t wlsb_width)
+{
+	return (rohc_comp_rfc3095_mem_max(wlsb_width) +
+	        rohc_slab_block_mem_max(sizeof(struct sc_esp_context)));
+}
+
+
 /**
  * @brief Define the compression part of the ESP profile as described
  *        in the RFC 3095.
@@ -463,5 +487,7 @@ const struct rohc_comp_profile c_esp_profile =
 	.encode         = c_esp_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.prefetch       = rohc_comp_rfc3095_prefetch,
+	.get_mem_max    = c_esp_mem_max,
 };
 
@@ -48,6 +48,26 @@ static bool rohc_ip_ctxt_create(struct rohc_comp_ctxt *const context,
  * Definitions of public functions
  */
 
+/** The handlers of the IP-only profile for the generic RFC3095-based code */
+static const struct rohc_comp_rfc3095_ops c_ip_rfc3095_ops =
+{
+	.encode_uncomp_fields = NULL,
+	.decide_state         = rohc_comp_rfc3095_decide_state,
+	.decide_FO_packet     = c_ip_decide_FO_packet,
+	.decide_SO_packet     = c_ip_decide_SO_packet,
+	.decide_extension     = decide_extension,
+	.init_at_IR           = NULL,
+	.get_next_sn          = c_ip_get_next_sn,
+	.code_static_part     = NULL,
+	.code_dynamic_part    = NULL,
+	.code_ir_remainder    = c_ip_code_ir_remainder,
+	.code_UO_packet_head  = NULL,
+	.code_uo_remainder    = NULL,
+	.compute_crc_static   = compute_crc_static,
+	.compute_crc_dynamic  = compute_crc_dynamic,
+};
+
+
 /**
  * @brief Create a new context and initialize it thanks to the given IP packet.
  *
@@ -65,7 +85,8 @@ static bool rohc_ip_ctxt_create(struct rohc_comp_ctxt *const context,
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
 
 	/* call the generic function for all IP-based profiles */
-	if(!rohc_comp_rfc3095_create(context, ROHC_LSB_SHIFT_SN, packet))
+	if(!rohc_comp_rfc3095_create(context, &c_ip_rfc3095_ops,
+	                             ROHC_LSB_SHIFT_SN, packet))
 	{
 		rohc_comp_warn(context, "generic context creation failed");
 		goto error;
@@ -77,13 +98,6 @@ static bool rohc_ip_ctxt_create(struct rohc_comp_ctxt *const context,
 	rohc_comp_debug(context, "initialize context(SN) = random() = %u",
 	                rfc3095_ctxt->sn);
 
-	/* init the IP-only-specific variables and functions */
-	rfc3095_ctxt->decide_FO_packet = c_ip_decide_FO_packet;
-	rfc3095_ctxt->decide_SO_packet = c_ip_decide_SO_packet;
-	rfc3095_ctxt->decide_extension = decide_extension;
-	rfc3095_ctxt->get_next_sn = c_ip_get_next_sn;
-	rfc3095_ctxt->code_ir_remainder = c_ip_code_ir_remainder;
-
 	return true;
 
 error:
@@ -126,7 +140,7 @@ bool c_ip_check_context(const struct rohc_comp_ctxt *const context,
 
 	rfc3095_ctxt = (struct rohc_comp_rfc3095_ctxt *) context->specific;
 	outer_ip_flags = &rfc3095_ctxt->outer_ip_flags;
-	inner_ip_flags = &rfc3095_ctxt->inner_ip_flags;
+	inner_ip_flags = rfc3095_ctxt->inner_ip_flags;
 
 	/* check the IP version of the first header */
 	version = ip_get_version(&packet->outer_ip);
@@ -248,8 +262,8 @@ rohc_packet_t c_ip_decide_FO_packet(const struct rohc_comp_ctxt *context)
 	if((rfc3095_ctxt->outer_ip_flags.version == IPV4 &&
 	    rfc3095_ctxt->outer_ip_flags.info.v4.sid_count < MAX_FO_COUNT) ||
 	   (rfc3095_ctxt->ip_hdr_nr > 1 &&
-	    rfc3095_ctxt->inner_ip_flags.version == IPV4 &&
-	    rfc3095_ctxt->inner_ip_flags.info.v4.sid_count < MAX_FO_COUNT))
+	    rfc3095_ctxt->inner_ip_flags->version == IPV4 &&
+	    rfc3095_ctxt->inner_ip_flags->info.v4.sid_count < MAX_FO_COUNT))
 	{
 		packet = ROHC_PACKET_IR_DYN;
 		rohc_comp_debug(context, "choose packet IR-DYN because at least one "
@@ -371,11 +385,11 @@ rohc_packet_t c_ip_decide_SO_packet(const struct rohc_comp_ctxt *context)
 			assert(rfc3095_ctxt->outer_ip_flags.info.v4.rnd_count >= MAX_FO_COUNT);
 			assert(rfc3095_ctxt->outer_ip_flags.info.v4.nbo_count >= MAX_FO_COUNT);
 		}
-		if(rfc3095_ctxt->inner_ip_flags.version == IPV4)
+		if(rfc3095_ctxt->inner_ip_flags->version == IPV4)
 		{
-			assert(rfc3095_ctxt->inner_ip_flags.info.v4.sid_count >= MAX_FO_COUNT);
-			assert(rfc3095_ctxt->inner_ip_flags.info.v4.rnd_count >= MAX_FO_COUNT);
-			assert(rfc3095_ctxt->inner_ip_flags.info.v4.nbo_count >= MAX_FO_COUNT);
+			assert(rfc3095_ctxt->inner_ip_flags->info.v4.sid_count >= MAX_FO_COUNT);
+			assert(rfc3095_ctxt->inner_ip_flags->info.v4.rnd_count >= MAX_FO_COUNT);
+			assert(rfc3095_ctxt->inner_ip_flags->info.v4.nbo_count >= MAX_FO_COUNT);
 		}
 
 		if(rohc_comp_rfc3095_is_sn_possible(rfc3095_ctxt, 4, 0) &&
@@ -444,6 +458,36 @@ uint32_t c_ip_get_next_sn(const struct rohc_comp_ctxt *const context,
 }
 
 
+/**
+ * @brief Get the SN of the last packet
+ *
+ * @param context  The compression context
+ * @return         The SN of the last packet
+ */
+uint32_t c_ip_get_msn(const struct rohc_comp_ctxt *const context)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	return rfc3095_ctxt->sn;
+}
+
+
+/**
+ * @brief Force the SN of the next packet
+ *
+ * Used to restore a saved context: the SN of the packet replayed in the
+ * context shall be the SN of the saved context.
+ *
+ * @param context  The compression context
+ * @param msn      The SN of the next packet
+ */
+void c_ip_set_next_msn(struct rohc_comp_ctxt *const context,
+                       const uint32_t msn)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	rfc3095_ctxt->sn = (msn - 1) & 0xffff;
+}
+
+
 /**
  * @brief Code the remainder header for the IR or IR-DYN packets
  *
@@ -515,5 +559,9 @@ const struct rohc_comp_profile c_ip_profile =
 	.encode         = rohc_comp_rfc3095_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.get_msn        = c_ip_get_msn,
+	.set_next_msn   = c_ip_set_next_msn,
+	.prefetch       = rohc_comp_rfc3095_prefetch,
+	.get_mem_max    = rohc_comp_rfc3095_mem_max,
 };
 
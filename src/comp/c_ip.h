@@ -44,6 +44,12 @@ uint32_t c_ip_get_next_sn(const struct rohc_comp_ctxt *const context,
                           const struct net_pkt *const uncomp_pkt)
 	__attribute__((warn_unused_result, nonnull(1, 2), pure));
 
+uint32_t c_ip_get_msn(const struct rohc_comp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+void c_ip_set_next_msn(struct rohc_comp_ctxt *const context,
+                       const uint32_t msn)
+	__attribute__((nonnull(1)));
+
 int c_ip_code_ir_remainder(const struct rohc_comp_ctxt *const context,
                            uint8_t *const dest,
                            const size_t dest_max_len,
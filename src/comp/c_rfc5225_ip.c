@@ -0,0 +1,2381 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   c_rfc5225_ip.c
+ * @brief  ROHC compression context for the ROHCv2 IP-only profile
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The profile compresses one or two IP headers without IPv6 extension
+ * headers (RFC 5225, §6). The reorder ratio of the flows is always
+ * REORDERING_NONE, the IP-ID of the outer IPv4 header is either zero or
+ * random.
+ *
+ * The other ROHCv2 profiles of RFC 5225 (RTP, UDP, ESP, UDP-Lite/RTP and
+ * UDP-Lite) are not implemented.
+ */
+
+#include "rohc_comp_internals.h"
+#include "rohc_traces_internal.h"
+#include "rohc_utils.h"
+#include "rohc_packets.h"
+#include "net_pkt.h"
+#include "protocols/ip.h"
+#include "protocols/ipv4.h"
+#include "protocols/ipv6.h"
+#include "protocols/rfc5225.h"
+#include "schemes/cid.h"
+#include "schemes/ip_id_offset.h"
+#include "crc.h"
+#include "rohc_bit_stream.h"
+
+#include <assert.h>
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
+
+
+/** The LSB shift parameter of the innermost IP-ID offset with k bits
+ *  (RFC 5225, §6.6.7: ip_id_lsb) */
+#define RFC5225_IP_ID_LSB_P(k)  ((1 << (k)) / 4 - 1)
+
+/** The length of the largest static chain of one IP header */
+#define RFC5225_IP_STATIC_MAX_LEN  (3 + 1 + 2 * sizeof(struct ipv6_addr))
+
+/** The length of the largest dynamic chain of one IP header */
+#define RFC5225_IP_DYN_MAX_LEN  ((size_t) (1 + 1 + 1 + 2 + 2))
+
+/** The length of the largest irregular chain of one IP header */
+#define RFC5225_IP_IRREG_MAX_LEN  ((size_t) (2 + 1 + 1))
+
+/** The length of the largest co_common base header */
+#define RFC5225_IP_CO_COMMON_MAX_LEN  ((size_t) (1 + 1 + 1 + 1 + 1 + 1 + 1 + 2))
+
+
+/** The compression context of one IP header */
+struct rfc5225_ip_hdr_ctxt
+{
+	uint8_t version;         /**< The IP version */
+	uint8_t next_proto;      /**< The protocol after the IP header */
+	uint8_t tos_tc;          /**< The IPv4 TOS or the IPv6 Traffic Class */
+	uint8_t ttl_hopl;        /**< The IPv4 TTL or the IPv6 Hop Limit */
+	uint8_t df;              /**< The IPv4 Don't Fragment (DF) flag */
+	uint8_t ip_id_behavior;  /**< The behavior of the IPv4 IP-ID */
+	uint16_t last_ip_id;     /**< The IPv4 IP-ID of the last packet (HBO) */
+	uint32_t saddr;          /**< The IPv4 source address */
+	uint32_t daddr;          /**< The IPv4 destination address */
+	uint32_t flow_label;     /**< The IPv6 Flow Label */
+	/** The interned IPv6 source and destination addresses */
+	const struct ipv6_addr *addrs;
+};
+
+
+/** The temporary variables computed for one single packet */
+struct rfc5225_ip_tmp_variables
+{
+	/** The IP-ID behaviors of the IP headers in the current packet */
+	uint8_t ip_id_behaviors[ROHC_RFC5225_MAX_IP_HDRS];
+
+	/** The minimal number of bits required to encode the MSN */
+	size_t nr_msn_bits;
+
+	/** Whether the innermost IP-ID is sequential */
+	bool ip_id_is_seq;
+	/** The offset between the innermost IP-ID and the MSN */
+	uint16_t ip_id_offset;
+	/** Whether the innermost IP-ID offset did not change at all */
+	bool ip_id_offset_unchanged;
+	/** The minimal number of bits required to encode the innermost IP-ID
+	 *  offset with k = 4, 6 and 8 */
+	size_t nr_ip_id_bits_4;
+	size_t nr_ip_id_bits_6;
+	size_t nr_ip_id_bits_8;
+};
+
+
+/** The compression context of the ROHCv2 IP-only profile */
+struct rohc_comp_rfc5225_ip_ctxt
+{
+	uint16_t msn;               /**< The Master Sequence Number (MSN) */
+	struct c_wlsb *msn_wlsb;    /**< The W-LSB encoding context for MSN */
+	/** The W-LSB encoding context for the innermost IP-ID offset, it shares
+	 *  the rows of the MSN window */
+	struct c_wlsb *ip_id_wlsb;
+
+	/** The number of co_repair packets (or IR packets) sent since the outer
+	 *  IP header changed */
+	size_t co_repair_count;
+	/** The number of co_common packets (or IR or co_repair packets) sent since
+	 *  the innermost IP header changed */
+	size_t co_common_count;
+	/** The number of co_common packets (or IR or co_repair packets) that
+	 *  transmitted the TOS/TC and TTL/HL of the outer IP header since they
+	 *  changed */
+	size_t outer_ip_count;
+
+	/** The temporary variables for the current packet */
+	struct rfc5225_ip_tmp_variables tmp;
+
+	size_t ip_hdrs_nr;  /**< The number of IP headers */
+	/** The contexts of the IP headers, from the outermost to the innermost */
+	struct rfc5225_ip_hdr_ctxt ip_hdrs[ROHC_RFC5225_MAX_IP_HDRS];
+};
+
+
+/*
+ * Private function prototypes
+ */
+
+static bool c_rfc5225_ip_create(struct rohc_comp_ctxt *const context,
+                                const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static size_t c_rfc5225_ip_mem_max(const size_t wlsb_width)
+	__attribute__((warn_unused_result, const));
+static void c_rfc5225_ip_destroy(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+static void c_rfc5225_ip_put_ip_addrs(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+
+static bool c_rfc5225_ip_check_profile(const struct rohc_comp *const comp,
+                                       const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool c_rfc5225_ip_check_context(const struct rohc_comp_ctxt *const context,
+                                       const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static int c_rfc5225_ip_encode(struct rohc_comp_ctxt *const context,
+                               const struct net_pkt *const uncomp_pkt,
+                               uint8_t *const rohc_pkt,
+                               const size_t rohc_pkt_max_len,
+                               rohc_packet_t *const packet_type,
+                               size_t *const payload_offset)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5, 6)));
+
+static void c_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const context,
+                                        const struct net_pkt *const uncomp_pkt)
+	__attribute__((nonnull(1, 2)));
+static uint8_t c_rfc5225_ip_detect_ip_id_behavior(const struct rohc_comp_ctxt *const context,
+                                                  const struct rfc5225_ip_hdr_ctxt *const ip_ctxt,
+                                                  const bool is_innermost,
+                                                  const uint16_t ip_id)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void c_rfc5225_ip_decide_state(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+static void c_rfc5225_ip_encode_uncomp_fields(struct rohc_comp_ctxt *const context,
+                                              const struct net_pkt *const uncomp_pkt)
+	__attribute__((nonnull(1, 2)));
+static rohc_packet_t c_rfc5225_ip_decide_pkt(struct rohc_comp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1)));
+static rohc_packet_t c_rfc5225_ip_decide_SO_pkt(const struct rohc_comp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static int c_rfc5225_ip_code_IR_pkt(const struct rohc_comp_ctxt *const context,
+                                    const struct net_pkt *const uncomp_pkt,
+                                    uint8_t *const rohc_pkt,
+                                    const size_t rohc_pkt_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static int c_rfc5225_ip_code_CO_pkt(const struct rohc_comp_ctxt *const context,
+                                    const struct net_pkt *const uncomp_pkt,
+                                    uint8_t *const rohc_pkt,
+                                    const size_t rohc_pkt_max_len,
+                                    const rohc_packet_t packet_type)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static int c_rfc5225_ip_code_co_repair(const struct rohc_comp_ctxt *const context,
+                                       const uint8_t crc,
+                                       uint8_t *const rohc_data,
+                                       const size_t rohc_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static int c_rfc5225_ip_code_co_common(const struct rohc_comp_ctxt *const context,
+                                       const struct net_pkt *const uncomp_pkt,
+                                       const uint8_t crc,
+                                       uint8_t *const rohc_data,
+                                       const size_t rohc_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+static int c_rfc5225_ip_code_pt(const struct rohc_comp_ctxt *const context,
+                                const rohc_packet_t packet_type,
+                                const uint8_t crc,
+                                uint8_t *const rohc_data,
+                                const size_t rohc_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+
+static int c_rfc5225_ip_code_static_chain(const struct rohc_comp_ctxt *const context,
+                                          const struct net_pkt *const uncomp_pkt,
+                                          uint8_t *const rohc_data,
+                                          const size_t rohc_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static int c_rfc5225_ip_code_dyn_chain(const struct rohc_comp_ctxt *const context,
+                                       const struct net_pkt *const uncomp_pkt,
+                                       uint8_t *const rohc_data,
+                                       const size_t rohc_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static int c_rfc5225_ip_code_irreg_chain(const struct rohc_comp_ctxt *const context,
+                                         const struct net_pkt *const uncomp_pkt,
+                                         const bool outer_ip_flag,
+                                         uint8_t *const rohc_data,
+                                         const size_t rohc_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+static uint8_t c_rfc5225_ip_ctrl_crc3(const struct rohc_comp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static void c_rfc5225_ip_update_ctxt(struct rohc_comp_ctxt *const context,
+                                     const struct net_pkt *const uncomp_pkt,
+                                     const rohc_packet_t packet_type)
+	__attribute__((nonnull(1, 2)));
+
+static bool c_rfc5225_ip_feedback(struct rohc_comp_ctxt *const context,
+                                  const enum rohc_feedback_type feedback_type,
+                                  const uint8_t *const packet,
+                                  const size_t packet_len,
+                                  const uint8_t *const feedback_data,
+                                  const size_t feedback_data_len)
+	__attribute__((warn_unused_result, nonnull(1, 3, 5)));
+static bool c_rfc5225_ip_feedback_2(struct rohc_comp_ctxt *const context,
+                                    const uint8_t *const packet,
+                                    const size_t packet_len,
+                                    const uint8_t *const feedback_data,
+                                    const size_t feedback_data_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+static void c_rfc5225_ip_feedback_ack(struct rohc_comp_ctxt *const context,
+                                      const uint32_t sn_bits,
+                                      const size_t sn_bits_nr,
+                                      const bool sn_not_valid)
+	__attribute__((nonnull(1)));
+static void c_rfc5225_ip_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                        const size_t width)
+	__attribute__((nonnull(1)));
+
+static uint32_t c_rfc5225_ip_get_msn(const struct rohc_comp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void c_rfc5225_ip_set_next_msn(struct rohc_comp_ctxt *const context,
+                                      const uint32_t msn)
+	__attribute__((nonnull(1)));
+static void c_rfc5225_ip_prefetch(const struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+
+
+/*
+ * Definitions of private functions
+ */
+
+/**
+ * @brief Create a new ROHCv2 IP-only context and initialize it thanks to the
+ *        given IP packet
+ *
+ * This function is one of the functions that must exist in one profile for
+ * the framework to work.
+ *
+ * @param context  The compression context
+ * @param packet   The IP packet given to initialize the new context
+ * @return         true if successful, false otherwise
+ */
+static bool c_rfc5225_ip_create(struct rohc_comp_ctxt *const context,
+                                const struct net_pkt *const packet)
+{
+	const struct rohc_comp *const comp = context->compressor;
+	struct rohc_slab *const slab = context->compressor->ctxt_slab;
+	struct rohc_comp_rfc5225_ip_ctxt *rfc5225_ctxt;
+	size_t ip_hdr_pos;
+
+	/* create the ROHCv2 IP-only part of the profile context */
+	rfc5225_ctxt = rohc_slab_alloc(slab, sizeof(struct rohc_comp_rfc5225_ip_ctxt));
+	if(rfc5225_ctxt == NULL)
+	{
+		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		           "no memory for the ROHCv2 IP-only part of the profile context");
+		goto error;
+	}
+	memset(rfc5225_ctxt, 0, sizeof(struct rohc_comp_rfc5225_ip_ctxt));
+	context->specific = rfc5225_ctxt;
+
+	/* record the static and dynamic fields of the IP headers, the headers were
+	 * checked by c_rfc5225_ip_check_profile() */
+	assert(packet->hdrs.ip_nr > 0);
+	assert(packet->hdrs.ip_nr <= ROHC_RFC5225_MAX_IP_HDRS);
+	for(ip_hdr_pos = 0; ip_hdr_pos < packet->hdrs.ip_nr; ip_hdr_pos++)
+	{
+		const struct net_pkt_ip_hdr *const ip_hdr = &packet->hdrs.ip[ip_hdr_pos];
+		const uint8_t *const ip_data = packet->data + ip_hdr->offset;
+		struct rfc5225_ip_hdr_ctxt *const ip_ctxt =
+			&(rfc5225_ctxt->ip_hdrs[ip_hdr_pos]);
+
+		rohc_comp_debug(context, "found IPv%u", ip_hdr->version);
+		ip_ctxt->version = ip_hdr->version;
+		ip_ctxt->next_proto = ip_hdr->next_proto;
+
+		if(ip_hdr->version == IPV4)
+		{
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip_data;
+
+			ip_ctxt->tos_tc = ipv4->tos;
+			ip_ctxt->ttl_hopl = ipv4->ttl;
+			ip_ctxt->df = ipv4->df;
+			ip_ctxt->last_ip_id = rohc_ntoh16(ipv4->id);
+			ip_ctxt->ip_id_behavior = IP_ID_BEHAVIOR_SEQ;
+			ip_ctxt->saddr = ipv4->saddr;
+			ip_ctxt->daddr = ipv4->daddr;
+		}
+		else
+		{
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip_data;
+
+			assert(ip_hdr->version == IPV6);
+			ip_ctxt->tos_tc = ipv6_get_tc(ipv6);
+			ip_ctxt->ttl_hopl = ipv6->hl;
+			ip_ctxt->ip_id_behavior = IP_ID_BEHAVIOR_RAND;
+			ip_ctxt->flow_label = ipv6_get_flow_label(ipv6);
+			ip_ctxt->addrs =
+				rohc_intern_get(context->compressor->static_store, &ipv6->saddr,
+				                sizeof(struct ipv6_addr) * 2);
+			if(ip_ctxt->addrs == NULL)
+			{
+				rohc_error(context->compressor, ROHC_TRACE_COMP,
+				           context->profile->id, "no memory for the IPv6 "
+				           "addresses of the profile context");
+				goto free_context;
+			}
+		}
+		rfc5225_ctxt->ip_hdrs_nr++;
+	}
+
+	/* MSN and innermost IP-ID offset: both are added with every packet, so
+	 * they share the rows of one window */
+	{
+		const size_t bits[2] = { 16, 16 };
+		const rohc_lsb_shift_t ps[2] = {
+			ROHC_LSB_SHIFT_ROHCV2_MSN, ROHC_LSB_SHIFT_VAR
+		};
+
+		rfc5225_ctxt->msn_wlsb =
+			c_create_wlsb_multi(slab, 2, bits, comp->wlsb_window_width, ps);
+		if(rfc5225_ctxt->msn_wlsb == NULL)
+		{
+			rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+			           "failed to create W-LSB context for MSN and IP-ID offset");
+			goto free_context;
+		}
+		rfc5225_ctxt->ip_id_wlsb = c_wlsb_get_field(rfc5225_ctxt->msn_wlsb, 1);
+	}
+
+	/* init the Master Sequence Number to a random value */
+	rfc5225_ctxt->msn = comp->random_cb(comp, comp->random_cb_ctxt) & 0xffff;
+	rohc_comp_debug(context, "MSN = 0x%04x / %u", rfc5225_ctxt->msn,
+	                rfc5225_ctxt->msn);
+
+	return true;
+
+free_context:
+	c_rfc5225_ip_put_ip_addrs(context);
+	rohc_slab_free(rfc5225_ctxt);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Destroy the ROHCv2 IP-only context
+ *
+ * This function is one of the functions that must exist in one profile for
+ * the framework to work.
+ *
+ * @param context  The ROHCv2 IP-only compression context to destroy
+ */
+static void c_rfc5225_ip_destroy(struct rohc_comp_ctxt *const context)
+{
+	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+
+	/* the IP-ID offset shares the MSN window */
+	c_destroy_wlsb(rfc5225_ctxt->msn_wlsb);
+	c_rfc5225_ip_put_ip_addrs(context);
+	rohc_slab_free(rfc5225_ctxt);
+}
+
+
+/**
+ * @brief Give back the IPv6 addresses of the context to the store
+ *
+ * @param context  The ROHCv2 IP-only compression context
+ */
+static void c_rfc5225_ip_put_ip_addrs(struct rohc_comp_ctxt *const context)
+{
+	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	size_t ip_hdr_pos;
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc5225_ctxt->ip_hdrs_nr; ip_hdr_pos++)
+	{
+		struct rfc5225_ip_hdr_ctxt *const ip_ctxt =
+			&(rfc5225_ctxt->ip_hdrs[ip_hdr_pos]);
+
+		if(ip_ctxt->version == IPV6)
+		{
+			rohc_intern_put(context->compressor->static_store, ip_ctxt->addrs);
+			ip_ctxt->addrs = NULL;
+		}
+	}
+}
+
+
+/**
+ * @brief Check if the given packet corresponds to the ROHCv2 IP-only profile
+ *
+ * Conditions are:
+ *  \li there are 1 or 2 IP headers, each of them is IPv4 or IPv6
+ *  \li the IPv4 headers are not fragmented, have no option and no reserved
+ *      flag
+ *  \li the IPv6 headers have no extension header
+ *  \li the length fields of the IP headers match the length of the packet
+ *
+ * This function is one of the functions that must exist in one profile for the
+ * framework to work.
+ *
+ * @param comp    The ROHC compressor
+ * @param packet  The packet to check
+ * @return        Whether the IP packet corresponds to the profile:
+ *                  \li true if the IP packet corresponds to the profile,
+ *                  \li false if the IP packet does not correspond to
+ *                      the profile
+ */
+static bool c_rfc5225_ip_check_profile(const struct rohc_comp *const comp,
+                                       const struct net_pkt *const packet)
+{
+	const struct net_pkt_hdrs *const hdrs = &packet->hdrs;
+	size_t ip_hdr_pos;
+
+	/* the IP headers were located while parsing the packet */
+	if(!hdrs->is_complete)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "IP headers are malformed or too many IP headers");
+		goto bad_profile;
+	}
+	if(hdrs->ip_nr == 0 || hdrs->ip_nr > ROHC_RFC5225_MAX_IP_HDRS)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "too many IP headers for the ROHCv2 IP-only profile (%u "
+		           "headers max)", ROHC_RFC5225_MAX_IP_HDRS);
+		goto bad_profile;
+	}
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < hdrs->ip_nr; ip_hdr_pos++)
+	{
+		const struct net_pkt_ip_hdr *const ip_hdr = &hdrs->ip[ip_hdr_pos];
+		const uint8_t *const ip_data = packet->data + ip_hdr->offset;
+		const size_t ip_len = packet->len - ip_hdr->offset;
+
+		if(ip_hdr->version == IPV4)
+		{
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip_data;
+
+			if(ipv4->ihl != (sizeof(struct ipv4_hdr) / sizeof(uint32_t)))
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "IPv4 header #%zu has options", ip_hdr_pos + 1);
+				goto bad_profile;
+			}
+			if(ipv4_is_fragment(ipv4) ||
+			   (rohc_ntoh16(ipv4->frag_off) & IPV4_RF) != 0)
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "IPv4 header #%zu is fragmented or has the reserved "
+				           "flag set", ip_hdr_pos + 1);
+				goto bad_profile;
+			}
+			if(rohc_ntoh16(ipv4->tot_len) != ip_len)
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "IPv4 header #%zu: total length %u does not match the "
+				           "%zu-byte packet", ip_hdr_pos + 1,
+				           rohc_ntoh16(ipv4->tot_len), ip_len);
+				goto bad_profile;
+			}
+		}
+		else if(ip_hdr->version == IPV6)
+		{
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip_data;
+
+			if(ip_hdr->exts_len != 0)
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "IPv6 header #%zu has extension headers",
+				           ip_hdr_pos + 1);
+				goto bad_profile;
+			}
+			if(rohc_ntoh16(ipv6->plen) != (ip_len - sizeof(struct ipv6_hdr)))
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "IPv6 header #%zu: payload length %u does not match "
+				           "the %zu-byte packet", ip_hdr_pos + 1,
+				           rohc_ntoh16(ipv6->plen), ip_len);
+				goto bad_profile;
+			}
+		}
+		else
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "unsupported IP version %u for header #%zu",
+			           ip_hdr->version, ip_hdr_pos + 1);
+			goto bad_profile;
+		}
+	}
+
+	return true;
+
+bad_profile:
+	return false;
+}
+
+
+/**
+ * @brief Check if the IP packet belongs to the ROHCv2 IP-only context
+ *
+ * Conditions are:
+ *  - the number of IP headers must be the same as in context
+ *  - the versions, addresses and next protocols of the IP headers must be
+ *    the same as in context
+ *  - the Flow Labels of the IPv6 headers must be the same as in context
+ *
+ * This function is one of the functions that must exist in one profile for
+ * the framework to work.
+ *
+ * @param context  The compression context
+ * @param packet   The IP packet to check
+ * @return         true if the IP packet belongs to the context,
+ *                 false if it does not belong to the context
+ */
+static bool c_rfc5225_ip_check_context(const struct rohc_comp_ctxt *const context,
+                                       const struct net_pkt *const packet)
+{
+	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	const struct net_pkt_hdrs *const hdrs = &packet->hdrs;
+	size_t ip_hdr_pos;
+
+	if(hdrs->ip_nr != rfc5225_ctxt->ip_hdrs_nr)
+	{
+		rohc_comp_debug(context, "  not the same number of IP headers");
+		goto bad_context;
+	}
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < hdrs->ip_nr; ip_hdr_pos++)
+	{
+		const struct net_pkt_ip_hdr *const ip_hdr = &hdrs->ip[ip_hdr_pos];
+		const uint8_t *const ip_data = packet->data + ip_hdr->offset;
+		const struct rfc5225_ip_hdr_ctxt *const ip_ctxt =
+			&(rfc5225_ctxt->ip_hdrs[ip_hdr_pos]);
+
+		if(ip_hdr->version != ip_ctxt->version)
+		{
+			rohc_comp_debug(context, "  not same IP version");
+			goto bad_context;
+		}
+		if(ip_hdr->next_proto != ip_ctxt->next_proto)
+		{
+			rohc_comp_debug(context, "  IPv%u not same protocol", ip_hdr->version);
+			goto bad_context;
+		}
+
+		if(ip_hdr->version == IPV4)
+		{
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip_data;
+
+			if(ipv4->saddr != ip_ctxt->saddr || ipv4->daddr != ip_ctxt->daddr)
+			{
+				rohc_comp_debug(context, "  not same IPv4 addresses");
+				goto bad_context;
+			}
+		}
+		else
+		{
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip_data;
+
+			if(memcmp(&ipv6->saddr, ip_ctxt->addrs,
+			          sizeof(struct ipv6_addr) * 2) != 0)
+			{
+				rohc_comp_debug(context, "  not same IPv6 addresses");
+				goto bad_context;
+			}
+			if(ipv6_get_flow_label(ipv6) != ip_ctxt->flow_label)
+			{
+				rohc_comp_debug(context, "  not same IPv6 flow label");
+				goto bad_context;
+			}
+		}
+	}
+
+	return true;
+
+bad_context:
+	return false;
+}
+
+
+/**
+ * @brief Encode an IP packet according to the ROHCv2 IP-only profile
+ *
+ * 1. Detect the changes of the IP headers and the IP-ID behaviors.\n
+ * 2. Decide in which state to go (IR, FO or SO).\n
+ * 3. Decide how many bits are needed to send the MSN and IP-ID fields and
+ *    update the sliding windows.\n
+ * 4. Decide which packet type to send.\n
+ * 5. Code the packet.\n
+ *
+ * This function is one of the functions that must exist in one profile for
+ * the framework to work.
+ *
+ * @param context           The compression context
+ * @param uncomp_pkt        The uncompressed packet to encode
+ * @param rohc_pkt          OUT: The ROHC packet
+ * @param rohc_pkt_max_len  The maximum length of the ROHC packet
+ * @param packet_type       OUT: The type of ROHC packet that is created
+ * @param payload_offset    OUT: The offset for the payload in the IP packet
+ * @return                  The length of the ROHC packet if successful,
+ *                          -1 otherwise
+ */
+static int c_rfc5225_ip_encode(struct rohc_comp_ctxt *const context,
+                               const struct net_pkt *const uncomp_pkt,
+                               uint8_t *const rohc_pkt,
+                               const size_t rohc_pkt_max_len,
+                               rohc_packet_t *const packet_type,
+                               size_t *const payload_offset)
+{
+	int counter;
+
+	*packet_type = ROHC_PACKET_UNKNOWN;
+
+	/* detect changes between new uncompressed packet and context */
+	rohc_perf_begin(context->compressor, ROHC_COMP_PERF_DETECT_CHANGES);
+	c_rfc5225_ip_detect_changes(context, uncomp_pkt);
+	rohc_perf_end(context->compressor, ROHC_COMP_PERF_DETECT_CHANGES);
+
+	/* decide in which state to go */
+	rohc_perf_begin(context->compressor, ROHC_COMP_PERF_DECIDE_STATE);
+	c_rfc5225_ip_decide_state(context);
+	rohc_perf_end(context->compressor, ROHC_COMP_PERF_DECIDE_STATE);
+
+	/* compute how many bits are needed to send header fields */
+	rohc_perf_begin(context->compressor, ROHC_COMP_PERF_ENCODE_FIELDS);
+	c_rfc5225_ip_encode_uncomp_fields(context, uncomp_pkt);
+	rohc_perf_end(context->compressor, ROHC_COMP_PERF_ENCODE_FIELDS);
+
+	/* decide which packet to send */
+	rohc_perf_begin(context->compressor, ROHC_COMP_PERF_DECIDE_PKT);
+	*packet_type = c_rfc5225_ip_decide_pkt(context);
+	rohc_perf_end(context->compressor, ROHC_COMP_PERF_DECIDE_PKT);
+
+	/* code the chosen packet */
+	rohc_perf_begin(context->compressor, ROHC_COMP_PERF_CODE_PKT);
+	if((*packet_type) == ROHC_PACKET_IR)
+	{
+		counter = c_rfc5225_ip_code_IR_pkt(context, uncomp_pkt, rohc_pkt,
+		                                   rohc_pkt_max_len);
+		if(counter < 0)
+		{
+			rohc_comp_warn(context, "failed to build IR packet");
+			goto error;
+		}
+	}
+	else
+	{
+		counter = c_rfc5225_ip_code_CO_pkt(context, uncomp_pkt, rohc_pkt,
+		                                   rohc_pkt_max_len, *packet_type);
+		if(counter < 0)
+		{
+			rohc_comp_warn(context, "failed to build CO packet");
+			goto error;
+		}
+	}
+	rohc_perf_end(context->compressor, ROHC_COMP_PERF_CODE_PKT);
+	rohc_comp_dump_buf(context, "current ROHC packet", rohc_pkt, counter);
+
+	/* the payload starts after the IP headers */
+	*payload_offset = uncomp_pkt->hdrs.transport_offset;
+	rohc_comp_debug(context, "payload_offset = %zu", *payload_offset);
+
+	/* update the context with the new headers */
+	c_rfc5225_ip_update_ctxt(context, uncomp_pkt, *packet_type);
+
+	return counter;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Detect the changes of the IP headers with respect to the context
+ *
+ * Compute the new MSN and the IP-ID behaviors of the IP headers, then reset
+ * the counters of the packets that transmit the changed fields.
+ *
+ * @param context     The compression context
+ * @param uncomp_pkt  The uncompressed packet
+ */
+static void c_rfc5225_ip_detect_changes(struct rohc_comp_ctxt *const context,
+                                        const struct net_pkt *const uncomp_pkt)
+{
+	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	size_t ip_hdr_pos;
+
+	/* the MSN is incremented for every packet */
+	rfc5225_ctxt->msn = (rfc5225_ctxt->msn + 1) & 0xffff;
+	rohc_comp_debug(context, "MSN = 0x%04x / %u", rfc5225_ctxt->msn,
+	                rfc5225_ctxt->msn);
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc5225_ctxt->ip_hdrs_nr; ip_hdr_pos++)
+	{
+		const struct net_pkt_ip_hdr *const ip_hdr =
+			&uncomp_pkt->hdrs.ip[ip_hdr_pos];
+		const uint8_t *const ip_data = uncomp_pkt->data + ip_hdr->offset;
+		const struct rfc5225_ip_hdr_ctxt *const ip_ctxt =
+			&(rfc5225_ctxt->ip_hdrs[ip_hdr_pos]);
+		const bool is_innermost = !!(ip_hdr_pos + 1 == rfc5225_ctxt->ip_hdrs_nr);
+		uint8_t *const ip_id_behavior =
+			&(rfc5225_ctxt->tmp.ip_id_behaviors[ip_hdr_pos]);
+		uint8_t tos_tc;
+		uint8_t ttl_hopl;
+		bool df_changed = false;
+
+		if(ip_hdr->version == IPV4)
+		{
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip_data;
+
+			*ip_id_behavior =
+				c_rfc5225_ip_detect_ip_id_behavior(context, ip_ctxt, is_innermost,
+				                                   rohc_ntoh16(ipv4->id));
+			df_changed = !!(ipv4->df != ip_ctxt->df);
+			tos_tc = ipv4->tos;
+			ttl_hopl = ipv4->ttl;
+		}
+		else
+		{
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip_data;
+
+			*ip_id_behavior = IP_ID_BEHAVIOR_RAND;
+			tos_tc = ipv6_get_tc(ipv6);
+			ttl_hopl = ipv6->hl;
+		}
+
+		if(is_innermost)
+		{
+			/* the innermost fields are transmitted by co_common */
+			if(df_changed ||
+			   (*ip_id_behavior) != ip_ctxt->ip_id_behavior ||
+			   tos_tc != ip_ctxt->tos_tc ||
+			   ttl_hopl != ip_ctxt->ttl_hopl)
+			{
+				rohc_comp_debug(context, "  innermost IPv%u header changed, send "
+				                "co_common packets", ip_hdr->version);
+				rfc5225_ctxt->co_common_count = 0;
+			}
+		}
+		else if(df_changed || (*ip_id_behavior) != ip_ctxt->ip_id_behavior)
+		{
+			/* the outer DF flag and IP-ID behavior are transmitted by the
+			 * dynamic chain only */
+			rohc_comp_debug(context, "  DF or IP-ID behavior of outer IPv%u header "
+			                "changed, send co_repair packets", ip_hdr->version);
+			rfc5225_ctxt->co_repair_count = 0;
+		}
+		else if(tos_tc != ip_ctxt->tos_tc || ttl_hopl != ip_ctxt->ttl_hopl)
+		{
+			/* the outer TOS/TC and TTL/HL are transmitted in the irregular chain
+			 * of co_common */
+			rohc_comp_debug(context, "  TOS/TC or TTL/HL of outer IPv%u header "
+			                "changed, send co_common packets", ip_hdr->version);
+			rfc5225_ctxt->outer_ip_count = 0;
+			rfc5225_ctxt->co_common_count = 0;
+		}
+	}
+}
+
+
+/**
+ * @brief Detect the behavior of the IP-ID of one IPv4 header
+ *
+ * The innermost IP-ID may be sequential, sequential byte-swapped, random or
+ * zero. The outer IP-ID is either zero or random.
+ *
+ * @param context       The compression context
+ * @param ip_ctxt       The context of the IPv4 header
+ * @param is_innermost  Whether the IPv4 header is the innermost IP header
+ * @param ip_id         The IP-ID of the current packet (in HBO)
+ * @return              The behavior of the IP-ID
+ */
+static uint8_t c_rfc5225_ip_detect_ip_id_behavior(const struct rohc_comp_ctxt *const context,
+                                                  const struct rfc5225_ip_hdr_ctxt *const ip_ctxt,
+                                                  const bool is_innermost,
+                                                  const uint16_t ip_id)
+{
+	const bool is_first_pkt = !!(context->num_sent_packets == 0);
+	uint8_t behavior;
+
+	if(!is_innermost)
+	{
+		if(ip_id == 0 &&
+		   (is_first_pkt || ip_ctxt->ip_id_behavior == IP_ID_BEHAVIOR_ZERO))
+		{
+			behavior = IP_ID_BEHAVIOR_ZERO;
+		}
+		else
+		{
+			behavior = IP_ID_BEHAVIOR_RAND;
+		}
+	}
+	else if(is_first_pkt)
+	{
+		behavior = (ip_id == 0 ? IP_ID_BEHAVIOR_ZERO : IP_ID_BEHAVIOR_SEQ);
+	}
+	else if(is_ip_id_increasing(ip_ctxt->last_ip_id, ip_id))
+	{
+		behavior = IP_ID_BEHAVIOR_SEQ;
+	}
+	else if(is_ip_id_increasing(swab16(ip_ctxt->last_ip_id), swab16(ip_id)))
+	{
+		behavior = IP_ID_BEHAVIOR_SEQ_SWAP;
+	}
+	else if(ip_id == 0)
+	{
+		behavior = IP_ID_BEHAVIOR_ZERO;
+	}
+	else
+	{
+		behavior = IP_ID_BEHAVIOR_RAND;
+	}
+	rohc_comp_debug(context, "  IP-ID 0x%04x: behavior %s", ip_id,
+	                tcp_ip_id_behavior_get_descr(behavior));
+
+	return behavior;
+}
+
+
+/**
+ * @brief Decide the state that should be used for the next packet
+ *
+ * The three states are:\n
+ *  - Initialization and Refresh (IR),\n
+ *  - First Order (FO),\n
+ *  - Second Order (SO).
+ *
+ * @param context  The compression context
+ */
+static void c_rfc5225_ip_decide_state(struct rohc_comp_ctxt *const context)
+{
+	const rohc_comp_state_t curr_state = context->state;
+	rohc_comp_state_t next_state;
+
+	if(curr_state == ROHC_COMP_STATE_IR)
+	{
+		if(context->ir_count < MAX_IR_COUNT)
+		{
+			rohc_comp_debug(context, "no enough packets transmitted in IR state "
+			                "for the moment (%zu/%u), so stay in IR state",
+			                context->ir_count, MAX_IR_COUNT);
+			next_state = ROHC_COMP_STATE_IR;
+		}
+		else
+		{
+			rohc_comp_debug(context, "enough packets transmitted in IR state "
+			                "(%zu/%u), go to SO state", context->ir_count,
+			                MAX_IR_COUNT);
+			next_state = ROHC_COMP_STATE_SO;
+		}
+	}
+	else if(curr_state == ROHC_COMP_STATE_FO)
+	{
+		if(context->fo_count < MAX_FO_COUNT)
+		{
+			rohc_comp_debug(context, "no enough packets transmitted in FO state "
+			                "for the moment (%zu/%u), so stay in FO state",
+			                context->fo_count, MAX_FO_COUNT);
+			next_state = ROHC_COMP_STATE_FO;
+		}
+		else
+		{
+			rohc_comp_debug(context, "enough packets transmitted in FO state "
+			                "(%zu/%u), go to SO state", context->fo_count,
+			                MAX_FO_COUNT);
+			next_state = ROHC_COMP_STATE_SO;
+		}
+	}
+	else
+	{
+		assert(curr_state == ROHC_COMP_STATE_SO);
+		rohc_comp_debug(context, "stay in SO state");
+		next_state = ROHC_COMP_STATE_SO;
+	}
+
+	rohc_comp_change_state(context, next_state);
+
+	/* periodic context refreshes (RFC 5225, §5.1.1) */
+	if(context->mode == ROHC_U_MODE)
+	{
+		rohc_comp_periodic_down_transition(context);
+	}
+}
+
+
+/**
+ * @brief Encode the MSN and the innermost IP-ID with the W-LSB encoding
+ *
+ * @param context     The compression context
+ * @param uncomp_pkt  The uncompressed packet to encode
+ */
+static void c_rfc5225_ip_encode_uncomp_fields(struct rohc_comp_ctxt *const context,
+                                              const struct net_pkt *const uncomp_pkt)
+{
+	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	struct rfc5225_ip_tmp_variables *const tmp = &rfc5225_ctxt->tmp;
+	const size_t innermost_pos = rfc5225_ctxt->ip_hdrs_nr - 1;
+	const struct net_pkt_ip_hdr *const innermost_hdr =
+		&uncomp_pkt->hdrs.ip[innermost_pos];
+	const uint8_t innermost_behavior = tmp->ip_id_behaviors[innermost_pos];
+
+	/* how many bits are required to encode the new MSN? */
+	tmp->nr_msn_bits = wlsb_get_k_16bits(rfc5225_ctxt->msn_wlsb, rfc5225_ctxt->msn);
+	rohc_comp_debug(context, "%zu bits are required to encode new MSN 0x%04x",
+	                tmp->nr_msn_bits, rfc5225_ctxt->msn);
+
+	/* how many bits are required to encode the new innermost IP-ID offset? */
+	tmp->ip_id_is_seq =
+		!!(innermost_hdr->version == IPV4 &&
+		   (innermost_behavior == IP_ID_BEHAVIOR_SEQ ||
+		    innermost_behavior == IP_ID_BEHAVIOR_SEQ_SWAP));
+	if(tmp->ip_id_is_seq)
+	{
+		const struct ipv4_hdr *const ipv4 =
+			(struct ipv4_hdr *) (uncomp_pkt->data + innermost_hdr->offset);
+		const uint16_t ip_id = rohc_ntoh16(ipv4->id);
+
+		if(innermost_behavior == IP_ID_BEHAVIOR_SEQ_SWAP)
+		{
+			tmp->ip_id_offset = swab16(ip_id) - rfc5225_ctxt->msn;
+		}
+		else
+		{
+			tmp->ip_id_offset = ip_id - rfc5225_ctxt->msn;
+		}
+		tmp->ip_id_offset_unchanged =
+			!!(wlsb_get_kp_16bits(rfc5225_ctxt->ip_id_wlsb, tmp->ip_id_offset, 0) == 0);
+		tmp->nr_ip_id_bits_4 =
+			wlsb_get_kp_16bits(rfc5225_ctxt->ip_id_wlsb, tmp->ip_id_offset,
+			                   RFC5225_IP_ID_LSB_P(4));
+		tmp->nr_ip_id_bits_6 =
+			wlsb_get_kp_16bits(rfc5225_ctxt->ip_id_wlsb, tmp->ip_id_offset,
+			                   RFC5225_IP_ID_LSB_P(6));
+		tmp->nr_ip_id_bits_8 =
+			wlsb_get_kp_16bits(rfc5225_ctxt->ip_id_wlsb, tmp->ip_id_offset,
+			                   RFC5225_IP_ID_LSB_P(8));
+		rohc_comp_debug(context, "innermost IP-ID offset 0x%04x: %sunchanged, "
+		                "%zu/%zu/%zu bits required with k = 4/6/8",
+		                tmp->ip_id_offset, tmp->ip_id_offset_unchanged ? "" : "not ",
+		                tmp->nr_ip_id_bits_4, tmp->nr_ip_id_bits_6,
+		                tmp->nr_ip_id_bits_8);
+	}
+	else
+	{
+		/* the IP-ID is transmitted in the irregular chain or not at all */
+		tmp->ip_id_offset = 0;
+		tmp->ip_id_offset_unchanged = true;
+		tmp->nr_ip_id_bits_4 = 0;
+		tmp->nr_ip_id_bits_6 = 0;
+		tmp->nr_ip_id_bits_8 = 0;
+	}
+
+	/* add the MSN and the IP-ID offset to their shared window at once */
+	{
+		const uint32_t values[2] = { rfc5225_ctxt->msn, tmp->ip_id_offset };
+		c_add_wlsb_multi(rfc5225_ctxt->msn_wlsb, rfc5225_ctxt->msn, values);
+	}
+}
+
+
+/**
+ * @brief Decide which packet to send in the current state
+ *
+ * @param context  The compression context
+ * @return         The type of packet to send
+ */
+static rohc_packet_t c_rfc5225_ip_decide_pkt(struct rohc_comp_ctxt *const context)
+{
+	rohc_packet_t packet_type;
+
+	switch(context->state)
+	{
+		case ROHC_COMP_STATE_IR:
+			rohc_comp_debug(context, "code IR packet");
+			packet_type = ROHC_PACKET_IR;
+			context->ir_count++;
+			break;
+		case ROHC_COMP_STATE_FO:
+			/* the co_repair packet updates the whole dynamic part of the context
+			 * after a NACK */
+			rohc_comp_debug(context, "code co_repair packet");
+			packet_type = ROHC_PACKET_CO_REPAIR;
+			context->fo_count++;
+			break;
+		case ROHC_COMP_STATE_SO:
+			packet_type = c_rfc5225_ip_decide_SO_pkt(context);
+			context->so_count++;
+			break;
+		case ROHC_COMP_STATE_UNKNOWN:
+		default:
+#if defined(NDEBUG) || defined(__KERNEL__) || defined(ENABLE_DEAD_CODE)
+			packet_type = ROHC_PACKET_UNKNOWN;
+#endif
+			assert(0); /* should not happen */
+			break;
+	}
+
+	return packet_type;
+}
+
+
+/**
+ * @brief Decide which packet to send in the SO state
+ *
+ * The co_repair and co_common packets are repeated \ref MAX_FO_COUNT times
+ * once the fields they transmit changed. Otherwise, the smallest pt_* packet
+ * that transmits enough MSN and IP-ID bits is chosen.
+ *
+ * @param context  The compression context
+ * @return         The type of packet to send
+ */
+static rohc_packet_t c_rfc5225_ip_decide_SO_pkt(const struct rohc_comp_ctxt *const context)
+{
+	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	const struct rfc5225_ip_tmp_variables *const tmp = &rfc5225_ctxt->tmp;
+	rohc_packet_t packet_type;
+
+	if(rfc5225_ctxt->co_repair_count < MAX_FO_COUNT || tmp->nr_msn_bits > 8)
+	{
+		packet_type = ROHC_PACKET_CO_REPAIR;
+	}
+	else if(rfc5225_ctxt->co_common_count < MAX_FO_COUNT)
+	{
+		packet_type = ROHC_PACKET_CO_COMMON;
+	}
+	else if(!tmp->ip_id_is_seq || tmp->ip_id_offset_unchanged)
+	{
+		/* no IP-ID bit to transmit */
+		if(tmp->nr_msn_bits <= 4)
+		{
+			packet_type = ROHC_PACKET_PT_0_CRC3;
+		}
+		else if(tmp->nr_msn_bits <= 6)
+		{
+			packet_type = ROHC_PACKET_NORTP_PT_0_CRC7;
+		}
+		else
+		{
+			packet_type = ROHC_PACKET_CO_COMMON;
+		}
+	}
+	else if(tmp->nr_msn_bits <= 6 && tmp->nr_ip_id_bits_4 <= 4)
+	{
+		packet_type = ROHC_PACKET_NORTP_PT_1_SEQ_ID;
+	}
+	else if(tmp->nr_msn_bits <= 8 && tmp->nr_ip_id_bits_6 <= 6)
+	{
+		packet_type = ROHC_PACKET_NORTP_PT_2_SEQ_ID;
+	}
+	else
+	{
+		packet_type = ROHC_PACKET_CO_COMMON;
+	}
+	rohc_comp_debug(context, "code %s packet", rohc_get_packet_descr(packet_type));
+
+	return packet_type;
+}
+
+
+/**
+ * @brief Encode an IP packet as IR packet
+ *
+\verbatim
+
+      0   1   2   3   4   5   6   7
+     --- --- --- --- --- --- --- ---
+    :         Add-CID octet         : if for small CIDs and (CID != 0)
+    +---+---+---+---+---+---+---+---+
+    | 1   1   1   1   1   1   0   1 | IR type octet
+    +---+---+---+---+---+---+---+---+
+    :                               :
+    /       0-2 octets of CID       / 1-2 octets if for large CIDs
+    :                               :
+    +---+---+---+---+---+---+---+---+
+    |            Profile            | 1 octet
+    +---+---+---+---+---+---+---+---+
+    |              CRC              | 1 octet
+    +---+---+---+---+---+---+---+---+
+    |                               |
+    /         Static chain          / variable length
+    |                               |
+     - - - - - - - - - - - - - - - -
+    |                               |
+    /         Dynamic chain         / variable length
+    |                               |
+     - - - - - - - - - - - - - - - -
+
+\endverbatim
+ *
+ * @param context           The compression context
+ * @param uncomp_pkt        The uncompressed packet to encode
+ * @param rohc_pkt          OUT: The ROHC packet
+ * @param rohc_pkt_max_len  The maximum length of the ROHC packet
+ * @return                  The length of the ROHC packet if successful,
+ *                          -1 otherwise
+ */
+static int c_rfc5225_ip_code_IR_pkt(const struct rohc_comp_ctxt *const context,
+                                    const struct net_pkt *const uncomp_pkt,
+                                    uint8_t *const rohc_pkt,
+                                    const size_t rohc_pkt_max_len)
+{
+	uint8_t *rohc_remain_data = rohc_pkt;
+	size_t rohc_remain_len = rohc_pkt_max_len;
+	size_t first_position;
+	size_t crc_position;
+	size_t rohc_hdr_len = 0;
+	int ret;
+
+	/* Add-CID or large CID */
+	ret = code_cid_values(&(context->cid_hdr), rohc_remain_data, rohc_remain_len,
+	                      &first_position);
+	if(ret < 1)
+	{
+		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the %zu-byte "
+		               "ROHC buffer is too small",
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
+		               "small" : "large", context->cid, rohc_remain_len);
+		goto error;
+	}
+	rohc_remain_data += ret;
+	rohc_remain_len -= ret;
+	rohc_hdr_len += ret;
+
+	/* type of packet */
+	rohc_pkt[first_position] = ROHC_PACKET_TYPE_IR;
+
+	/* enough room for profile ID and CRC? */
+	if(rohc_remain_len < 2)
+	{
+		rohc_comp_warn(context, "ROHC buffer too small for IR packet: 2 bytes "
+		               "required for profile ID and CRC, but only %zu bytes "
+		               "available", rohc_remain_len);
+		goto error;
+	}
+
+	/* profile ID: the 8 LSB of the ROHCv2 profile ID */
+	rohc_remain_data[0] = context->profile->id & 0xff;
+	rohc_remain_data++;
+	rohc_remain_len--;
+	rohc_hdr_len++;
+
+	/* the CRC is computed later over the whole header with an empty CRC */
+	crc_position = rohc_hdr_len;
+	rohc_remain_data[0] = 0;
+	rohc_remain_data++;
+	rohc_remain_len--;
+	rohc_hdr_len++;
+
+	/* static chain */
+	ret = c_rfc5225_ip_code_static_chain(context, uncomp_pkt, rohc_remain_data,
+	                                     rohc_remain_len);
+	if(ret < 0)
+	{
+		rohc_comp_warn(context, "failed to build the static chain of the IR "
+		               "packet");
+		goto error;
+	}
+	rohc_remain_data += ret;
+	rohc_remain_len -= ret;
+	rohc_hdr_len += ret;
+
+	/* dynamic chain */
+	ret = c_rfc5225_ip_code_dyn_chain(context, uncomp_pkt, rohc_remain_data,
+	                                  rohc_remain_len);
+	if(ret < 0)
+	{
+		rohc_comp_warn(context, "failed to build the dynamic chain of the IR "
+		               "packet");
+		goto error;
+	}
+	rohc_hdr_len += ret;
+
+	/* IR header was successfully built, compute the CRC */
+	if((c_features(context->compressor) & ROHC_COMP_FEATURE_ESTIMATE) == 0)
+	{
+		rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt,
+		                                       rohc_hdr_len, CRC_INIT_8,
+		                                       rohc_crc_table_8);
+	}
+	rohc_comp_debug(context, "CRC (header length = %zu, crc = 0x%x)",
+	                rohc_hdr_len, rohc_pkt[crc_position]);
+
+	return rohc_hdr_len;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Encode an IP packet as CO packet
+ *
+ * The CO packet is made of the base header, then of the dynamic chain for
+ * the co_repair packet or of the irregular chain for the other packets.
+ *
+ * @param context           The compression context
+ * @param uncomp_pkt        The uncompressed packet to encode
+ * @param rohc_pkt          OUT: The ROHC packet
+ * @param rohc_pkt_max_len  The maximum length of the ROHC packet
+ * @param packet_type       The type of ROHC packet to create
+ * @return                  The length of the ROHC packet if successful,
+ *                          -1 otherwise
+ */
+static int c_rfc5225_ip_code_CO_pkt(const struct rohc_comp_ctxt *const context,
+                                    const struct net_pkt *const uncomp_pkt,
+                                    uint8_t *const rohc_pkt,
+                                    const size_t rohc_pkt_max_len,
+                                    const rohc_packet_t packet_type)
+{
+	const size_t hdrs_len = uncomp_pkt->hdrs.transport_offset;
+	uint8_t *rohc_remain_data = rohc_pkt;
+	size_t rohc_remain_len = rohc_pkt_max_len;
+	size_t pos_1st_byte;
+	size_t pos_2nd_byte;
+	uint8_t save_first_byte;
+	uint8_t crc_computed;
+	int ret;
+
+	/* the CRC is computed on the uncompressed IP headers */
+	if((c_features(context->compressor) & ROHC_COMP_FEATURE_ESTIMATE) != 0)
+	{
+		/* the packets are only sized in estimate mode */
+		crc_computed = 0;
+	}
+	else if(packet_type == ROHC_PACKET_PT_0_CRC3 ||
+	        packet_type == ROHC_PACKET_NORTP_PT_1_SEQ_ID)
+	{
+		crc_computed = crc_calculate(ROHC_CRC_TYPE_3, uncomp_pkt->data, hdrs_len,
+		                             CRC_INIT_3, rohc_crc_table_3);
+		rohc_comp_debug(context, "CRC-3 on %zu-byte uncompressed header = 0x%x",
+		                hdrs_len, crc_computed);
+	}
+	else
+	{
+		crc_computed = crc_calculate(ROHC_CRC_TYPE_7, uncomp_pkt->data, hdrs_len,
+		                             CRC_INIT_7, rohc_crc_table_7);
+		rohc_comp_debug(context, "CRC-7 on %zu-byte uncompressed header = 0x%x",
+		                hdrs_len, crc_computed);
+	}
+
+	/* write Add-CID or large CID bytes: 'pos_1st_byte' indicates the location
+	 * where first header byte shall be written, 'pos_2nd_byte' indicates the
+	 * location where the next header bytes shall be written */
+	ret = code_cid_values(&(context->cid_hdr), rohc_remain_data, rohc_remain_len,
+	                      &pos_1st_byte);
+	if(ret < 1)
+	{
+		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
+		               "%zu-byte ROHC buffer is too small",
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
+		               "small" : "large", context->cid, rohc_remain_len);
+		goto error;
+	}
+	pos_2nd_byte = ret;
+	rohc_remain_data += ret;
+	rohc_remain_len -= ret;
+
+	/* the CO headers are written as a contiguous block, the last CID octet is
+	 * saved before and restored afterwards in case of large CIDs (see the
+	 * code_CO_packet() function of the TCP profile) */
+	save_first_byte = rohc_remain_data[-1];
+	rohc_remain_data--;
+	rohc_remain_len++;
+
+	/* base header */
+	switch(packet_type)
+	{
+		case ROHC_PACKET_CO_REPAIR:
+			ret = c_rfc5225_ip_code_co_repair(context, crc_computed,
+			                                  rohc_remain_data, rohc_remain_len);
+			break;
+		case ROHC_PACKET_CO_COMMON:
+			ret = c_rfc5225_ip_code_co_common(context, uncomp_pkt, crc_computed,
+			                                  rohc_remain_data, rohc_remain_len);
+			break;
+		case ROHC_PACKET_PT_0_CRC3:
+		case ROHC_PACKET_NORTP_PT_0_CRC7:
+		case ROHC_PACKET_NORTP_PT_1_SEQ_ID:
+		case ROHC_PACKET_NORTP_PT_2_SEQ_ID:
+			ret = c_rfc5225_ip_code_pt(context, packet_type, crc_computed,
+			                           rohc_remain_data, rohc_remain_len);
+			break;
+		default:
+			rohc_comp_warn(context, "unexpected packet type %d", packet_type);
+			assert(0);
+			goto error;
+	}
+	if(ret < 0)
+	{
+		rohc_comp_warn(context, "failed to build the %s base header",
+		               rohc_get_packet_descr(packet_type));
+		goto error;
+	}
+	rohc_remain_data += ret;
+	rohc_remain_len -= ret;
+
+	/* dynamic chain for co_repair, irregular chain otherwise */
+	if(packet_type == ROHC_PACKET_CO_REPAIR)
+	{
+		ret = c_rfc5225_ip_code_dyn_chain(context, uncomp_pkt, rohc_remain_data,
+		                                  rohc_remain_len);
+	}
+	else
+	{
+		const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt =
+			context->specific;
+		const bool outer_ip_flag =
+			!!(packet_type == ROHC_PACKET_CO_COMMON &&
+			   rfc5225_ctxt->outer_ip_count < MAX_FO_COUNT);
+		ret = c_rfc5225_ip_code_irreg_chain(context, uncomp_pkt, outer_ip_flag,
+		                                    rohc_remain_data, rohc_remain_len);
+	}
+	if(ret < 0)
+	{
+		rohc_comp_warn(context, "failed to build the %s chain of the CO packet",
+		               packet_type == ROHC_PACKET_CO_REPAIR ? "dynamic" : "irregular");
+		goto error;
+	}
+	rohc_remain_len -= ret;
+
+	/* end of workaround: restore the saved octet */
+	if(c_cid_type(context->compressor) != ROHC_SMALL_CID)
+	{
+		rohc_pkt[pos_1st_byte] = rohc_pkt[pos_2nd_byte - 1];
+		rohc_pkt[pos_2nd_byte - 1] = save_first_byte;
+	}
+
+	return (rohc_pkt_max_len - rohc_remain_len);
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Build the co_repair base header
+ *
+\verbatim
+
+      0   1   2   3   4   5   6   7
+    +---+---+---+---+---+---+---+---+
+    | 1   1   1   1   1   0   1   1 | discriminator
+    +---+---+---+---+---+---+---+---+
+    | 0 |          CRC-7            |
+    +---+---+---+---+---+---+---+---+
+    | 0   0   0   0   0 |  CRC-3    | control CRC
+    +---+---+---+---+---+---+---+---+
+
+\endverbatim
+ *
+ * @param context         The compression context
+ * @param crc             The CRC-7 on the uncompressed headers
+ * @param rohc_data       The ROHC packet being built
+ * @param rohc_max_len    The max remaining length in the ROHC buffer
+ * @return                The length appended in the ROHC buffer if positive,
+ *                        -1 in case of error
+ */
+static int c_rfc5225_ip_code_co_repair(const struct rohc_comp_ctxt *const context,
+                                       const uint8_t crc,
+                                       uint8_t *const rohc_data,
+                                       const size_t rohc_max_len)
+{
+	const size_t co_repair_len = 3;
+
+	if(rohc_max_len < co_repair_len)
+	{
+		rohc_comp_warn(context, "ROHC buffer too small for the co_repair base "
+		               "header: %zu bytes required, but only %zu bytes available",
+		               co_repair_len, rohc_max_len);
+		goto error;
+	}
+
+	rohc_data[0] = ROHCV2_PACKET_TYPE_CO_REPAIR;
+	rohc_data[1] = crc & 0x7f;
+	rohc_data[2] = c_rfc5225_ip_ctrl_crc3(context) & 0x07;
+
+	return co_repair_len;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Build the co_common base header
+ *
+\verbatim
+
+      0   1   2   3   4   5   6   7
+    +---+---+---+---+---+---+---+---+
+    | 1   1   1   1   1   0   1   0 | discriminator
+    +---+---+---+---+---+---+---+---+
+    |ind|          CRC-7            | ind = IP-ID indicator
+    +---+---+---+---+---+---+---+---+
+    | 1 | 1 | 1 |  RR   |  CRC-3    | flags, TTL/HL, TOS/TC indicators,
+    +---+---+---+---+---+---+---+---+ reorder ratio, control CRC
+    |out|DF |  beh  | 0   0   0   0 | outer IP indicator, DF, IP-ID behavior
+    +---+---+---+---+---+---+---+---+
+    |            TOS/TC             |
+    +---+---+---+---+---+---+---+---+
+    |            TTL/HL             |
+    +---+---+---+---+---+---+---+---+
+    |             MSN               | 8 LSB
+    +---+---+---+---+---+---+---+---+
+    :            IP-ID              : 0, 1 or 2 octets
+    +---+---+---+---+---+---+---+---+
+
+\endverbatim
+ *
+ * The flags, TOS/TC and TTL/HL are always transmitted.
+ *
+ * @param context         The compression context
+ * @param uncomp_pkt      The uncompressed packet to encode
+ * @param crc             The CRC-7 on the uncompressed headers
+ * @param rohc_data       The ROHC packet being built
+ * @param rohc_max_len    The max remaining length in the ROHC buffer
+ * @return                The length appended in the ROHC buffer if positive,
+ *                        -1 in case of error
+ */
+static int c_rfc5225_ip_code_co_common(const struct rohc_comp_ctxt *const context,
+                                       const struct net_pkt *const uncomp_pkt,
+                                       const uint8_t crc,
+                                       uint8_t *const rohc_data,
+                                       const size_t rohc_max_len)
+{
+	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	const struct rfc5225_ip_tmp_variables *const tmp = &rfc5225_ctxt->tmp;
+	const size_t innermost_pos = rfc5225_ctxt->ip_hdrs_nr - 1;
+	const struct net_pkt_ip_hdr *const innermost_hdr =
+		&uncomp_pkt->hdrs.ip[innermost_pos];
+	const uint8_t *const innermost_data = uncomp_pkt->data + innermost_hdr->offset;
+	const bool outer_ip_flag =
+		!!(rfc5225_ctxt->ip_hdrs_nr > 1 &&
+		   rfc5225_ctxt->outer_ip_count < MAX_FO_COUNT);
+	struct rohc_bit_writer writer;
+	uint8_t ip_id_ind = 0;
+	size_t ip_id_len = 0;
+	uint8_t df = 0;
+	uint8_t tos_tc;
+	uint8_t ttl_hopl;
+
+	if(innermost_hdr->version == IPV4)
+	{
+		const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) innermost_data;
+		df = ipv4->df;
+		tos_tc = ipv4->tos;
+		ttl_hopl = ipv4->ttl;
+	}
+	else
+	{
+		const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) innermost_data;
+		tos_tc = ipv6_get_tc(ipv6);
+		ttl_hopl = ipv6->hl;
+	}
+
+	/* the sequential IP-ID is transmitted as an 8-bit offset if possible,
+	 * in full otherwise */
+	if(tmp->ip_id_is_seq)
+	{
+		if(tmp->nr_ip_id_bits_8 <= 8)
+		{
+			ip_id_len = 1;
+		}
+		else
+		{
+			ip_id_ind = 1;
+			ip_id_len = 2;
+		}
+	}
+
+	if(rohc_max_len < (7 + ip_id_len))
+	{
+		rohc_comp_warn(context, "ROHC buffer too small for the co_common base "
+		               "header: %zu bytes required, but only %zu bytes available",
+		               7 + ip_id_len, rohc_max_len);
+		goto error;
+	}
+
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, ROHCV2_PACKET_TYPE_CO_COMMON, 8);
+	rohc_bit_write(&writer, ip_id_ind, 1);
+	rohc_bit_write(&writer, crc, 7);
+	rohc_bit_write(&writer, 1, 1); /* flags_ind */
+	rohc_bit_write(&writer, 1, 1); /* ttl_hopl_ind */
+	rohc_bit_write(&writer, 1, 1); /* tos_tc_ind */
+	rohc_bit_write(&writer, ROHC_RFC5225_REORDERING_NONE, 2);
+	rohc_bit_write(&writer, c_rfc5225_ip_ctrl_crc3(context), 3);
+	rohc_bit_write(&writer, outer_ip_flag, 1);
+	rohc_bit_write(&writer, df, 1);
+	rohc_bit_write(&writer, tmp->ip_id_behaviors[innermost_pos], 2);
+	rohc_bit_write(&writer, 0, 4);
+	rohc_bit_write(&writer, tos_tc, 8);
+	rohc_bit_write(&writer, ttl_hopl, 8);
+	rohc_bit_write(&writer, rfc5225_ctxt->msn & 0xff, 8);
+	if(ip_id_len == 1)
+	{
+		rohc_bit_write(&writer, tmp->ip_id_offset & 0xff, 8);
+	}
+	else if(ip_id_len == 2)
+	{
+		const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) innermost_data;
+		rohc_bit_write(&writer, rohc_ntoh16(ipv4->id), 16);
+	}
+	rohc_comp_debug(context, "co_common: IP-ID indicator = %u, outer IP "
+	                "indicator = %d, %zu-byte IP-ID", ip_id_ind,
+	                GET_REAL(outer_ip_flag), ip_id_len);
+
+	return rohc_bit_writer_finish(&writer);
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Build the pt_0_crc3, pt_0_crc7, pt_1_seq_id or pt_2_seq_id base
+ *        header
+ *
+\verbatim
+
+ pt_0_crc3:    '0'   MSN (4)  CRC-3
+ pt_0_crc7:    '100' MSN (6)  CRC-7
+ pt_1_seq_id:  '101' CRC-3    MSN (6)    IP-ID (4)
+ pt_2_seq_id:  '110' IP-ID (6) CRC-7     MSN (8)
+
+\endverbatim
+ *
+ * @param context         The compression context
+ * @param packet_type     The type of packet to build
+ * @param crc             The CRC-3 or CRC-7 on the uncompressed headers
+ * @param rohc_data       The ROHC packet being built
+ * @param rohc_max_len    The max remaining length in the ROHC buffer
+ * @return                The length appended in the ROHC buffer if positive,
+ *                        -1 in case of error
+ */
+static int c_rfc5225_ip_code_pt(const struct rohc_comp_ctxt *const context,
+                                const rohc_packet_t packet_type,
+                                const uint8_t crc,
+                                uint8_t *const rohc_data,
+                                const size_t rohc_max_len)
+{
+	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	const uint16_t msn = rfc5225_ctxt->msn;
+	const uint16_t ip_id_offset = rfc5225_ctxt->tmp.ip_id_offset;
+	const size_t pt_len = (packet_type == ROHC_PACKET_PT_0_CRC3 ? 1 :
+	                       (packet_type == ROHC_PACKET_NORTP_PT_2_SEQ_ID ? 3 : 2));
+	struct rohc_bit_writer writer;
+
+	if(rohc_max_len < pt_len)
+	{
+		rohc_comp_warn(context, "ROHC buffer too small for the %s base header: "
+		               "%zu bytes required, but only %zu bytes available",
+		               rohc_get_packet_descr(packet_type), pt_len, rohc_max_len);
+		goto error;
+	}
+
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	switch(packet_type)
+	{
+		case ROHC_PACKET_PT_0_CRC3:
+			rohc_bit_write(&writer, 0, 1);
+			rohc_bit_write(&writer, msn, 4);
+			rohc_bit_write(&writer, crc, 3);
+			break;
+		case ROHC_PACKET_NORTP_PT_0_CRC7:
+			rohc_bit_write(&writer, 0x4, 3);
+			rohc_bit_write(&writer, msn, 6);
+			rohc_bit_write(&writer, crc, 7);
+			break;
+		case ROHC_PACKET_NORTP_PT_1_SEQ_ID:
+			rohc_bit_write(&writer, 0x5, 3);
+			rohc_bit_write(&writer, crc, 3);
+			rohc_bit_write(&writer, msn, 6);
+			rohc_bit_write(&writer, ip_id_offset, 4);
+			break;
+		case ROHC_PACKET_NORTP_PT_2_SEQ_ID:
+			rohc_bit_write(&writer, 0x6, 3);
+			rohc_bit_write(&writer, ip_id_offset, 6);
+			rohc_bit_write(&writer, crc, 7);
+			rohc_bit_write(&writer, msn, 8);
+			break;
+		default:
+			assert(0);
+			goto error;
+	}
+
+	return rohc_bit_writer_finish(&writer);
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Build the static chain of the IR packet
+ *
+\verbatim
+
+ IPv4:  '0' inner '000000' | protocol | source (4) | destination (4)
+ IPv6:  '1' inner '0' disc flow label (4 or 20) | next header |
+        source (16) | destination (16)
+
+\endverbatim
+ *
+ * The innermost flag is set in the static part of the innermost IP header.
+ * The flow label discriminator is set if the flow label is not zero.
+ *
+ * @param context         The compression context
+ * @param uncomp_pkt      The uncompressed packet to encode
+ * @param rohc_data       The ROHC packet being built
+ * @param rohc_max_len    The max remaining length in the ROHC buffer
+ * @return                The length appended in the ROHC buffer if positive,
+ *                        -1 in case of error
+ */
+static int c_rfc5225_ip_code_static_chain(const struct rohc_comp_ctxt *const context,
+                                          const struct net_pkt *const uncomp_pkt,
+                                          uint8_t *const rohc_data,
+                                          const size_t rohc_max_len)
+{
+	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	uint8_t *rohc_remain_data = rohc_data;
+	size_t rohc_remain_len = rohc_max_len;
+	size_t ip_hdr_pos;
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc5225_ctxt->ip_hdrs_nr; ip_hdr_pos++)
+	{
+		const struct net_pkt_ip_hdr *const ip_hdr =
+			&uncomp_pkt->hdrs.ip[ip_hdr_pos];
+		const uint8_t *const ip_data = uncomp_pkt->data + ip_hdr->offset;
+		const uint8_t innermost = !!(ip_hdr_pos + 1 == rfc5225_ctxt->ip_hdrs_nr);
+		struct rohc_bit_writer writer;
+		size_t written;
+
+		if(rohc_remain_len < RFC5225_IP_STATIC_MAX_LEN)
+		{
+			rohc_comp_warn(context, "ROHC buffer too small for the IP static part: "
+			               "up to %zu bytes required, but only %zu bytes "
+			               "available", RFC5225_IP_STATIC_MAX_LEN, rohc_remain_len);
+			goto error;
+		}
+		rohc_bit_writer_init(&writer, rohc_remain_data, rohc_remain_len);
+
+		if(ip_hdr->version == IPV4)
+		{
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip_data;
+
+			rohc_bit_write(&writer, 0, 1);
+			rohc_bit_write(&writer, innermost, 1);
+			rohc_bit_write(&writer, 0, 6);
+			rohc_bit_write(&writer, ipv4->protocol, 8);
+			rohc_bit_write(&writer, rohc_ntoh32(ipv4->saddr), 32);
+			rohc_bit_write(&writer, rohc_ntoh32(ipv4->daddr), 32);
+		}
+		else
+		{
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip_data;
+			const uint32_t flow_label = ipv6_get_flow_label(ipv6);
+			size_t i;
+
+			rohc_bit_write(&writer, 1, 1);
+			rohc_bit_write(&writer, innermost, 1);
+			rohc_bit_write(&writer, 0, 1);
+			if(flow_label == 0)
+			{
+				rohc_bit_write(&writer, 0, 5);
+			}
+			else
+			{
+				rohc_bit_write(&writer, 1, 1);
+				rohc_bit_write(&writer, flow_label, 20);
+			}
+			rohc_bit_write(&writer, ipv6->nh, 8);
+			for(i = 0; i < 4; i++)
+			{
+				rohc_bit_write(&writer, rohc_ntoh32(ipv6->saddr.u32[i]), 32);
+			}
+			for(i = 0; i < 4; i++)
+			{
+				rohc_bit_write(&writer, rohc_ntoh32(ipv6->daddr.u32[i]), 32);
+			}
+		}
+
+		written = rohc_bit_writer_finish(&writer);
+		rohc_comp_dump_buf(context, "IP static part", rohc_remain_data, written);
+		rohc_remain_data += written;
+		rohc_remain_len -= written;
+	}
+
+	return (rohc_max_len - rohc_remain_len);
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Build the dynamic chain of the IR and co_repair packets
+ *
+\verbatim
+
+ outer IPv4:      '00000' DF behavior | TOS | TTL | IP-ID (0 or 2)
+ innermost IPv4:  '000' RR DF behavior | TOS | TTL | IP-ID (0 or 2) | MSN (2)
+ outer IPv6:      TC | HL
+ innermost IPv6:  TC | HL | '000000' RR | MSN (2)
+
+\endverbatim
+ *
+ * @param context         The compression context
+ * @param uncomp_pkt      The uncompressed packet to encode
+ * @param rohc_data       The ROHC packet being built
+ * @param rohc_max_len    The max remaining length in the ROHC buffer
+ * @return                The length appended in the ROHC buffer if positive,
+ *                        -1 in case of error
+ */
+static int c_rfc5225_ip_code_dyn_chain(const struct rohc_comp_ctxt *const context,
+                                       const struct net_pkt *const uncomp_pkt,
+                                       uint8_t *const rohc_data,
+                                       const size_t rohc_max_len)
+{
+	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	uint8_t *rohc_remain_data = rohc_data;
+	size_t rohc_remain_len = rohc_max_len;
+	size_t ip_hdr_pos;
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc5225_ctxt->ip_hdrs_nr; ip_hdr_pos++)
+	{
+		const struct net_pkt_ip_hdr *const ip_hdr =
+			&uncomp_pkt->hdrs.ip[ip_hdr_pos];
+		const uint8_t *const ip_data = uncomp_pkt->data + ip_hdr->offset;
+		const bool is_innermost = !!(ip_hdr_pos + 1 == rfc5225_ctxt->ip_hdrs_nr);
+		const uint8_t behavior = rfc5225_ctxt->tmp.ip_id_behaviors[ip_hdr_pos];
+		struct rohc_bit_writer writer;
+		size_t written;
+
+		if(rohc_remain_len < RFC5225_IP_DYN_MAX_LEN)
+		{
+			rohc_comp_warn(context, "ROHC buffer too small for the IP dynamic part: "
+			               "up to %zu bytes required, but only %zu bytes "
+			               "available", RFC5225_IP_DYN_MAX_LEN, rohc_remain_len);
+			goto error;
+		}
+		rohc_bit_writer_init(&writer, rohc_remain_data, rohc_remain_len);
+
+		if(ip_hdr->version == IPV4)
+		{
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip_data;
+
+			if(is_innermost)
+			{
+				rohc_bit_write(&writer, 0, 3);
+				rohc_bit_write(&writer, ROHC_RFC5225_REORDERING_NONE, 2);
+			}
+			else
+			{
+				rohc_bit_write(&writer, 0, 5);
+			}
+			rohc_bit_write(&writer, ipv4->df, 1);
+			rohc_bit_write(&writer, behavior, 2);
+			rohc_bit_write(&writer, ipv4->tos, 8);
+			rohc_bit_write(&writer, ipv4->ttl, 8);
+			if(behavior != IP_ID_BEHAVIOR_ZERO)
+			{
+				rohc_bit_write(&writer, rohc_ntoh16(ipv4->id), 16);
+			}
+		}
+		else
+		{
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip_data;
+
+			rohc_bit_write(&writer, ipv6_get_tc(ipv6), 8);
+			rohc_bit_write(&writer, ipv6->hl, 8);
+			if(is_innermost)
+			{
+				rohc_bit_write(&writer, 0, 6);
+				rohc_bit_write(&writer, ROHC_RFC5225_REORDERING_NONE, 2);
+			}
+		}
+		if(is_innermost)
+		{
+			rohc_bit_write(&writer, rfc5225_ctxt->msn, 16);
+		}
+
+		written = rohc_bit_writer_finish(&writer);
+		rohc_comp_dump_buf(context, "IP dynamic part", rohc_remain_data, written);
+		rohc_remain_data += written;
+		rohc_remain_len -= written;
+	}
+
+	return (rohc_max_len - rohc_remain_len);
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Build the irregular chain of the co_common and pt_* packets
+ *
+\verbatim
+
+ outer IPv4:      IP-ID (0 or 2) | TOS (0 or 1) | TTL (0 or 1)
+ innermost IPv4:  IP-ID (0 or 2)
+ outer IPv6:      TC (0 or 1) | HL (0 or 1)
+ innermost IPv6:  (empty)
+
+\endverbatim
+ *
+ * The IP-ID is transmitted if random. The TOS/TC and TTL/HL of the outer IP
+ * header are transmitted if the outer IP indicator of the co_common packet is
+ * set.
+ *
+ * @param context         The compression context
+ * @param uncomp_pkt      The uncompressed packet to encode
+ * @param outer_ip_flag   Whether the outer IP indicator is set
+ * @param rohc_data       The ROHC packet being built
+ * @param rohc_max_len    The max remaining length in the ROHC buffer
+ * @return                The length appended in the ROHC buffer if positive,
+ *                        -1 in case of error
+ */
+static int c_rfc5225_ip_code_irreg_chain(const struct rohc_comp_ctxt *const context,
+                                         const struct net_pkt *const uncomp_pkt,
+                                         const bool outer_ip_flag,
+                                         uint8_t *const rohc_data,
+                                         const size_t rohc_max_len)
+{
+	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	uint8_t *rohc_remain_data = rohc_data;
+	size_t rohc_remain_len = rohc_max_len;
+	size_t ip_hdr_pos;
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc5225_ctxt->ip_hdrs_nr; ip_hdr_pos++)
+	{
+		const struct net_pkt_ip_hdr *const ip_hdr =
+			&uncomp_pkt->hdrs.ip[ip_hdr_pos];
+		const uint8_t *const ip_data = uncomp_pkt->data + ip_hdr->offset;
+		const bool is_innermost = !!(ip_hdr_pos + 1 == rfc5225_ctxt->ip_hdrs_nr);
+		const uint8_t behavior = rfc5225_ctxt->tmp.ip_id_behaviors[ip_hdr_pos];
+		size_t irreg_len = 0;
+
+		if(rohc_remain_len < RFC5225_IP_IRREG_MAX_LEN)
+		{
+			rohc_comp_warn(context, "ROHC buffer too small for the IP irregular "
+			               "part: up to %zu bytes required, but only %zu bytes "
+			               "available", RFC5225_IP_IRREG_MAX_LEN, rohc_remain_len);
+			goto error;
+		}
+
+		if(ip_hdr->version == IPV4)
+		{
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip_data;
+
+			if(behavior == IP_ID_BEHAVIOR_RAND)
+			{
+				memcpy(rohc_remain_data + irreg_len, &ipv4->id, sizeof(uint16_t));
+				irreg_len += sizeof(uint16_t);
+			}
+			if(!is_innermost && outer_ip_flag)
+			{
+				rohc_remain_data[irreg_len] = ipv4->tos;
+				irreg_len++;
+				rohc_remain_data[irreg_len] = ipv4->ttl;
+				irreg_len++;
+			}
+		}
+		else if(!is_innermost && outer_ip_flag)
+		{
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip_data;
+
+			rohc_remain_data[irreg_len] = ipv6_get_tc(ipv6);
+			irreg_len++;
+			rohc_remain_data[irreg_len] = ipv6->hl;
+			irreg_len++;
+		}
+
+		rohc_remain_data += irreg_len;
+		rohc_remain_len -= irreg_len;
+	}
+
+	return (rohc_max_len - rohc_remain_len);
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Compute the control CRC-3 of the CO packets
+ *
+ * The control CRC covers the reorder ratio, the MSN and the IP-ID behaviors
+ * of the IPv4 headers (RFC 5225, §6.6.11).
+ *
+ * @param context  The compression context
+ * @return         The control CRC-3
+ */
+static uint8_t c_rfc5225_ip_ctrl_crc3(const struct rohc_comp_ctxt *const context)
+{
+	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	uint8_t ip_id_behaviors[ROHC_RFC5225_MAX_IP_HDRS];
+	size_t ip_id_behaviors_nr = 0;
+	size_t ip_hdr_pos;
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc5225_ctxt->ip_hdrs_nr; ip_hdr_pos++)
+	{
+		if(rfc5225_ctxt->ip_hdrs[ip_hdr_pos].version == IPV4)
+		{
+			ip_id_behaviors[ip_id_behaviors_nr] =
+				rfc5225_ctxt->tmp.ip_id_behaviors[ip_hdr_pos];
+			ip_id_behaviors_nr++;
+		}
+	}
+
+	return compute_crc_ctrl_fields(ROHC_RFC5225_REORDERING_NONE,
+	                               rfc5225_ctxt->msn, ip_id_behaviors,
+	                               ip_id_behaviors_nr);
+}
+
+
+/**
+ * @brief Update the context with the headers of the packet just compressed
+ *
+ * @param context      The compression context
+ * @param uncomp_pkt   The uncompressed packet that was compressed
+ * @param packet_type  The type of ROHC packet that was created
+ */
+static void c_rfc5225_ip_update_ctxt(struct rohc_comp_ctxt *const context,
+                                     const struct net_pkt *const uncomp_pkt,
+                                     const rohc_packet_t packet_type)
+{
+	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	size_t ip_hdr_pos;
+
+	/* the IR and co_repair packets transmit all the dynamic fields, the
+	 * co_common packets transmit the innermost ones and maybe the outer TOS/TC
+	 * and TTL/HL */
+	if(packet_type == ROHC_PACKET_IR || packet_type == ROHC_PACKET_CO_REPAIR)
+	{
+		if(rfc5225_ctxt->co_repair_count < MAX_FO_COUNT)
+		{
+			rfc5225_ctxt->co_repair_count++;
+		}
+	}
+	if(packet_type == ROHC_PACKET_IR || packet_type == ROHC_PACKET_CO_REPAIR ||
+	   packet_type == ROHC_PACKET_CO_COMMON)
+	{
+		if(rfc5225_ctxt->co_common_count < MAX_FO_COUNT)
+		{
+			rfc5225_ctxt->co_common_count++;
+		}
+		if(rfc5225_ctxt->outer_ip_count < MAX_FO_COUNT)
+		{
+			rfc5225_ctxt->outer_ip_count++;
+		}
+	}
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc5225_ctxt->ip_hdrs_nr; ip_hdr_pos++)
+	{
+		const struct net_pkt_ip_hdr *const ip_hdr =
+			&uncomp_pkt->hdrs.ip[ip_hdr_pos];
+		const uint8_t *const ip_data = uncomp_pkt->data + ip_hdr->offset;
+		struct rfc5225_ip_hdr_ctxt *const ip_ctxt =
+			&(rfc5225_ctxt->ip_hdrs[ip_hdr_pos]);
+
+		ip_ctxt->ip_id_behavior = rfc5225_ctxt->tmp.ip_id_behaviors[ip_hdr_pos];
+		if(ip_hdr->version == IPV4)
+		{
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip_data;
+
+			ip_ctxt->tos_tc = ipv4->tos;
+			ip_ctxt->ttl_hopl = ipv4->ttl;
+			ip_ctxt->df = ipv4->df;
+			ip_ctxt->last_ip_id = rohc_ntoh16(ipv4->id);
+		}
+		else
+		{
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip_data;
+
+			ip_ctxt->tos_tc = ipv6_get_tc(ipv6);
+			ip_ctxt->ttl_hopl = ipv6->hl;
+		}
+	}
+}
+
+
+/**
+ * @brief Update the profile when feedback is received
+ *
+ * This function is one of the functions that must exist in one profile for
+ * the framework to work.
+ *
+ * @param context            The compression context
+ * @param feedback_type      The feedback type
+ * @param packet             The whole feedback packet with CID bits
+ * @param packet_len         The length of the whole feedback packet with CID bits
+ * @param feedback_data      The feedback data without the CID bits
+ * @param feedback_data_len  The length of the feedback data without the CID bits
+ * @return                   true if the feedback was successfully handled,
+ *                           false if the feedback could not be taken into account
+ */
+static bool c_rfc5225_ip_feedback(struct rohc_comp_ctxt *const context,
+                                  const enum rohc_feedback_type feedback_type,
+                                  const uint8_t *const packet,
+                                  const size_t packet_len,
+                                  const uint8_t *const feedback_data,
+                                  const size_t feedback_data_len)
+{
+	if(feedback_type == ROHC_FEEDBACK_1)
+	{
+		const bool sn_not_valid = false;
+		uint32_t sn_bits;
+		size_t sn_bits_nr;
+
+		rohc_comp_debug(context, "FEEDBACK-1 received");
+		assert(feedback_data_len == 1);
+
+		/* get the 8 LSB bits of the acknowledged SN */
+		sn_bits = feedback_data[0] & 0xff;
+		sn_bits_nr = 8;
+
+		rohc_comp_debug(context, "ACK received (CID = %zu, %zu-bit SN = 0x%02x)",
+		                context->cid, sn_bits_nr, sn_bits);
+
+		/* the compressor received a positive ACK */
+		c_rfc5225_ip_feedback_ack(context, sn_bits, sn_bits_nr, sn_not_valid);
+	}
+	else if(feedback_type == ROHC_FEEDBACK_2)
+	{
+		rohc_comp_debug(context, "FEEDBACK-2 received");
+
+		if(!c_rfc5225_ip_feedback_2(context, packet, packet_len, feedback_data,
+		                            feedback_data_len))
+		{
+			rohc_comp_warn(context, "failed to handle FEEDBACK-2");
+			goto error;
+		}
+	}
+	else /* not FEEDBACK-1 nor FEEDBACK-2 */
+	{
+		rohc_comp_warn(context, "feedback type not implemented (%d)", feedback_type);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Update the profile when FEEDBACK-2 is received
+ *
+ * The ROHCv2 profiles use the FEEDBACK-2 format of RFC 6846 (RFC 5225, §6.9).
+ *
+ * @param context            The compression context
+ * @param packet             The whole feedback packet with CID bits
+ * @param packet_len         The length of the whole feedback packet with CID bits
+ * @param feedback_data      The feedback data without the CID bits
+ * @param feedback_data_len  The length of the feedback data without the CID bits
+ * @return                   true if the feedback was successfully handled,
+ *                           false if the feedback could not be taken into account
+ */
+static bool c_rfc5225_ip_feedback_2(struct rohc_comp_ctxt *const context,
+                                    const uint8_t *const packet,
+                                    const size_t packet_len,
+                                    const uint8_t *const feedback_data,
+                                    const size_t feedback_data_len)
+{
+	const uint8_t *remain_data = feedback_data;
+	size_t remain_len = feedback_data_len;
+	const struct rohc_feedback_2_rfc6846 *feedback2;
+
+	size_t opts_present[ROHC_FEEDBACK_OPT_MAX] = { 0 };
+
+	uint8_t crc_in_packet;
+	size_t crc_pos_from_end;
+
+	uint32_t sn_bits;
+	size_t sn_bits_nr;
+
+	/* retrieve acked MSN */
+	if(remain_len < sizeof(struct rohc_feedback_2_rfc6846))
+	{
+		rohc_comp_warn(context, "malformed FEEDBACK-2: packet too short for the "
+		               "minimal %zu-byte header, only %zu bytes remaining",
+		               sizeof(struct rohc_feedback_2_rfc6846), remain_len);
+		goto error;
+	}
+	feedback2 = (const struct rohc_feedback_2_rfc6846 *) feedback_data;
+	sn_bits = (feedback2->sn1 << 8) | feedback2->sn2;
+	sn_bits_nr = 6 + 8;
+	crc_in_packet = feedback2->crc;
+	crc_pos_from_end = remain_len - 2;
+	remain_data += 3;
+	remain_len -= 3;
+
+	/* parse FEEDBACK-2 options */
+	if(!rohc_comp_feedback_parse_opts(context, packet, packet_len,
+	                                  remain_data, remain_len,
+	                                  opts_present, &sn_bits, &sn_bits_nr,
+	                                  crc_in_packet, crc_pos_from_end))
+	{
+		rohc_comp_warn(context, "malformed FEEDBACK-2: failed to parse options");
+		goto error;
+	}
+
+	/* change from U- to O-mode once feedback channel is established */
+	rohc_comp_change_mode(context, ROHC_O_MODE);
+
+	/* act according to the type of feedback */
+	switch(feedback2->ack_type)
+	{
+		case ROHC_FEEDBACK_ACK:
+		{
+			const bool sn_not_valid = !!(opts_present[ROHC_FEEDBACK_OPT_SN_NOT_VALID] > 0);
+
+			rohc_comp_debug(context, "ACK received (CID = %zu, %zu-bit SN = 0x%x, "
+			                "SN-not-valid = %d)", context->cid, sn_bits_nr, sn_bits,
+			                GET_REAL(sn_not_valid));
+
+			/* the compressor received a positive ACK */
+			c_rfc5225_ip_feedback_ack(context, sn_bits, sn_bits_nr, sn_not_valid);
+			break;
+		}
+		case ROHC_FEEDBACK_NACK:
+		{
+			/* RFC 5225, §5.2.2.2: the dynamic part of the context is repaired
+			 * with the co_repair packets of the FO state */
+			rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+			          "NACK received for CID %zu", context->cid);
+			rohc_trace_event(context->compressor, ROHC_TRACE_COMP,
+			                 ROHC_TRACE_EVENT_COMP_NACK, context->profile->id,
+			                 context->cid, ROHC_PACKET_UNKNOWN,
+			                 ROHC_FEEDBACK_NACK, 0, 0);
+			if(context->state == ROHC_COMP_STATE_SO)
+			{
+				rohc_comp_change_state(context, ROHC_COMP_STATE_FO);
+			}
+			/* packets were lost or damaged, refresh the context more often */
+			rohc_comp_periodic_refreshes_nack(context);
+			/* packets were lost or damaged, widen the W-LSB windows again */
+			if((c_features(context->compressor) &
+			    ROHC_COMP_FEATURE_ADAPTIVE_WLSB) != 0)
+			{
+				c_rfc5225_ip_set_wlsb_width(context, rohc_comp_wlsb_width_nack(context));
+			}
+			break;
+		}
+		case ROHC_FEEDBACK_STATIC_NACK:
+		{
+			/* RFC 5225, §5.2.2.3: the static part of the context is repaired
+			 * with the IR packets */
+			rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+			          "STATIC-NACK received for CID %zu", context->cid);
+			rohc_trace_event(context->compressor, ROHC_TRACE_COMP,
+			                 ROHC_TRACE_EVENT_COMP_NACK, context->profile->id,
+			                 context->cid, ROHC_PACKET_UNKNOWN,
+			                 ROHC_FEEDBACK_STATIC_NACK, 0, 0);
+			rohc_comp_change_state(context, ROHC_COMP_STATE_IR);
+			/* packets were lost or damaged, refresh the context more often */
+			rohc_comp_periodic_refreshes_nack(context);
+			/* packets were lost or damaged, widen the W-LSB windows again */
+			if((c_features(context->compressor) &
+			    ROHC_COMP_FEATURE_ADAPTIVE_WLSB) != 0)
+			{
+				c_rfc5225_ip_set_wlsb_width(context, rohc_comp_wlsb_width_nack(context));
+			}
+			break;
+		}
+		case ROHC_FEEDBACK_RESERVED:
+		{
+			/* RFC 6846 §8.3.2: reserved (MUST NOT be used for parseability) */
+			rohc_comp_warn(context, "malformed FEEDBACK-2: reserved ACK type used");
+			goto error;
+		}
+		default:
+		{
+			/* impossible value */
+			rohc_comp_warn(context, "malformed FEEDBACK-2: unknown ACK type %u",
+			               feedback2->ack_type);
+			goto error;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Perform the required actions after the reception of a positive ACK
+ *
+ * @param context       The compression context that received a positive ACK
+ * @param sn_bits       The LSB bits of the acknowledged MSN
+ * @param sn_bits_nr    The number of LSB bits of the acknowledged MSN
+ * @param sn_not_valid  Whether the received MSN may be considered as valid or not
+ */
+static void c_rfc5225_ip_feedback_ack(struct rohc_comp_ctxt *const context,
+                                      const uint32_t sn_bits,
+                                      const size_t sn_bits_nr,
+                                      const bool sn_not_valid)
+{
+	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+
+	/* positive ACKs remove older values from the W-LSB windows */
+	if(!sn_not_valid)
+	{
+		size_t acked_nr;
+
+		/* ack MSN and innermost IP-ID offset at once */
+		acked_nr = wlsb_ack(rfc5225_ctxt->msn_wlsb, sn_bits, sn_bits_nr);
+		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
+		                "from MSN and innermost IP-ID offset W-LSB", acked_nr);
+
+		/* O- and R-modes: size the W-LSB windows from the packets in flight
+		 * between the acknowledged packet and the latest one */
+		if((c_features(context->compressor) & ROHC_COMP_FEATURE_ADAPTIVE_WLSB) != 0 &&
+		   context->mode != ROHC_U_MODE)
+		{
+			const size_t width =
+				rohc_comp_wlsb_width_ack(context, rfc5225_ctxt->msn, sn_bits,
+				                         sn_bits_nr);
+			c_rfc5225_ip_set_wlsb_width(context, width);
+		}
+	}
+}
+
+
+/**
+ * @brief Set the number of entries kept in the W-LSB windows of the context
+ *
+ * @param context  The compression context
+ * @param width    The number of entries to keep in the W-LSB windows
+ */
+static void c_rfc5225_ip_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                        const size_t width)
+{
+	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+
+	/* the IP-ID offset shares the MSN window */
+	c_wlsb_set_width(rfc5225_ctxt->msn_wlsb, width);
+}
+
+
+/**
+ * @brief Get the MSN of the last packet compressed in the context
+ *
+ * This function is one of the functions that must exist in one profile for the
+ * framework to work.
+ *
+ * @param context  The compression context
+ * @return         The MSN
+ */
+static uint32_t c_rfc5225_ip_get_msn(const struct rohc_comp_ctxt *const context)
+{
+	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+	return rfc5225_ctxt->msn;
+}
+
+
+/**
+ * @brief Force the MSN of the next packet
+ *
+ * Used to restore a saved context: the MSN of the packet replayed in the
+ * context shall be the MSN of the saved context.
+ *
+ * @param context  The compression context
+ * @param msn      The MSN of the next packet
+ */
+static void c_rfc5225_ip_set_next_msn(struct rohc_comp_ctxt *const context,
+                                      const uint32_t msn)
+{
+	struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+
+	/* see c_rfc5225_ip_detect_changes(): the MSN is incremented before the
+	 * packet is compressed */
+	rfc5225_ctxt->msn = (msn - 1) & 0xffff;
+}
+
+
+/**
+ * @brief Prefetch the W-LSB windows used by every packet of the context
+ *
+ * Called by the compressor when it compresses a burst of packets, before the
+ * next packet is compressed in the context.
+ *
+ * @param context  The compression context
+ */
+static void c_rfc5225_ip_prefetch(const struct rohc_comp_ctxt *const context)
+{
+	const struct rohc_comp_rfc5225_ip_ctxt *const rfc5225_ctxt = context->specific;
+
+	c_wlsb_prefetch(rfc5225_ctxt->msn_wlsb);
+	c_wlsb_prefetch(rfc5225_ctxt->ip_id_wlsb);
+}
+
+
+/**
+ * @brief Get the maximum length one ROHCv2 IP-only context takes in a memory block
+ *
+ * @param wlsb_width  The width of the W-LSB sliding windows
+ * @return            The maximum number of bytes of the memory block the
+ *                    profile-specific part of the context takes
+ */
+static size_t c_rfc5225_ip_mem_max(const size_t wlsb_width)
+{
+	/* the profile part, the window of the MSN and IP-ID offset, and the
+	 * addresses of the IPv6 headers if they are not shared */
+	return (rohc_slab_block_mem_max(sizeof(struct rohc_comp_rfc5225_ip_ctxt)) +
+	        c_wlsb_mem_max(2, wlsb_width) +
+	        ROHC_RFC5225_MAX_IP_HDRS *
+	        rohc_intern_entry_mem_max(sizeof(struct ipv6_addr) * 2));
+}
+
+
+/**
+ * @brief Define the compression part of the ROHCv2 IP-only profile as
+ *        described in the RFC 5225
+ */
+const struct rohc_comp_profile c_rfc5225_ip_profile =
+{
+	.id             = ROHCv2_PROFILE_IP, /* profile ID (see RFC 5225) */
+	.protocol       = 0,                 /* IP protocol */
+	.create         = c_rfc5225_ip_create, /* profile handlers */
+	.destroy        = c_rfc5225_ip_destroy,
+	.check_profile  = c_rfc5225_ip_check_profile,
+	.check_context  = c_rfc5225_ip_check_context,
+	.encode         = c_rfc5225_ip_encode,
+	.reinit_context = rohc_comp_reinit_context,
+	.feedback       = c_rfc5225_ip_feedback,
+	.get_msn        = c_rfc5225_ip_get_msn,
+	.set_next_msn   = c_rfc5225_ip_set_next_msn,
+	.prefetch       = c_rfc5225_ip_prefetch,
+	.get_mem_max    = c_rfc5225_ip_mem_max,
+};
+
@@ -46,6 +46,97 @@
  * Constants and macros
  */
 
+/* the candidate packets in SO state, in the order they are tested */
+#define SO_ROW_UO_0          (1U << 0)
+#define SO_ROW_UO_1_RTP      (1U << 1)
+#define SO_ROW_UO_1_ID       (1U << 2)
+#define SO_ROW_UO_1_TS       (1U << 3)
+#define SO_ROW_UO_1_ID_EXT   (1U << 4)
+#define SO_ROW_UOR_2_RTP     (1U << 5)
+#define SO_ROW_UOR_2_ID      (1U << 6)
+#define SO_ROW_UOR_2_TS      (1U << 7)
+#define SO_ROW_IR_DYN        (1U << 8)
+#define SO_ROWS_ALL          0x1ffU
+
+/* the candidate packets with less than 4 SN bits, and without extension */
+#define SO_ROWS_UO  (SO_ROW_UO_0 | SO_ROW_UO_1_RTP | SO_ROW_UO_1_ID | SO_ROW_UO_1_TS)
+/* the candidate UOR-2* packets */
+#define SO_ROWS_UOR_2  (SO_ROW_UOR_2_RTP | SO_ROW_UOR_2_ID | SO_ROW_UOR_2_TS)
+
+/** The packet type of every candidate row in SO state */
+static const rohc_packet_t c_rtp_so_rows[] =
+{
+	ROHC_PACKET_UO_0, ROHC_PACKET_UO_1_RTP, ROHC_PACKET_UO_1_ID,
+	ROHC_PACKET_UO_1_TS, ROHC_PACKET_UO_1_ID, ROHC_PACKET_UOR_2_RTP,
+	ROHC_PACKET_UOR_2_ID, ROHC_PACKET_UOR_2_TS, ROHC_PACKET_IR_DYN
+};
+
+/**
+ * @brief The tables that decide the packet type in SO state
+ *
+ * Every entry is the mask of the candidate packets that the input allows,
+ * see \ref ROHC_COMP_BITS_TABLE. IR-DYN is always allowed. Every row of the
+ * resulting mask is a valid packet, not only the first one, see
+ * \ref ROHC_COMP_FEATURE_SMALLEST_PACKETS.
+ */
+static const struct
+{
+	/** Indexed by whether the SN fits in 4 bits (bit 0), in 4+8 bits (bit 1)
+	 *  and in 6+8 bits (bit 2) */
+	uint16_t sn[8];
+	/** Indexed by whether some IPv4 header has a non-random IP-ID, and by the
+	 *  number of such headers with IP-ID bits to transmit (up to 2) */
+	uint16_t ipv4_non_rnd[2][3];
+	/** Indexed by the number of IP-ID bits of the innermost IPv4 header */
+	uint16_t inner_ip_id[ROHC_COMP_BITS_NR];
+	/** Indexed by the number of TS bits */
+	uint16_t ts[ROHC_COMP_BITS_NR];
+	/** Indexed by whether TS is scaled */
+	uint16_t ts_scaled[2];
+	/** Indexed by whether no TS bit shall be transmitted, or TS is deducible
+	 *  from SN */
+	uint16_t ts_implicit[2];
+	/** Indexed by whether the RTP Marker bit is set */
+	uint16_t marker[2];
+} c_rtp_so_table =
+{
+#define SO_SN(i) \
+	(((i) & 1 ? SO_ROWS_UO : 0U) | ((i) & 2 ? SO_ROW_UO_1_ID_EXT : 0U) | \
+	 ((i) & 4 ? SO_ROWS_UOR_2 : 0U) | SO_ROW_IR_DYN)
+	.sn = { SO_SN(0), SO_SN(1), SO_SN(2), SO_SN(3),
+	        SO_SN(4), SO_SN(5), SO_SN(6), SO_SN(7) },
+#undef SO_SN
+	.ipv4_non_rnd = {
+		/* no IPv4 header with non-random IP-ID, so no IP-ID bit at all, and
+		 * no T bit to distinguish the -ID packets from the -TS packets */
+		{ SO_ROWS_ALL & ~(SO_ROW_UO_1_ID | SO_ROW_UO_1_TS | SO_ROW_UO_1_ID_EXT |
+		                  SO_ROW_UOR_2_ID | SO_ROW_UOR_2_TS),
+		  SO_ROW_IR_DYN, SO_ROW_IR_DYN },
+		/* at least one IPv4 header with non-random IP-ID, with 0, 1 or 2
+		 * headers with IP-ID bits to transmit */
+		{ SO_ROW_UO_0 | SO_ROW_UO_1_TS | SO_ROW_UOR_2_TS | SO_ROW_IR_DYN,
+		  SO_ROW_UO_1_ID | SO_ROW_UO_1_ID_EXT | SO_ROW_UOR_2_ID |
+		  SO_ROW_UOR_2_TS | SO_ROW_IR_DYN,
+		  SO_ROW_UO_1_ID_EXT | SO_ROW_UOR_2_ID | SO_ROW_UOR_2_TS | SO_ROW_IR_DYN },
+	},
+#define SO_INNER_IP_ID(v) \
+	(ROHC_COMP_ROWS_IF(v, 0, 5, SO_ROW_UO_1_ID) | (SO_ROWS_ALL & ~SO_ROW_UO_1_ID))
+	.inner_ip_id = ROHC_COMP_BITS_TABLE(SO_INNER_IP_ID),
+#undef SO_INNER_IP_ID
+#define SO_TS(v) \
+	(ROHC_COMP_ROWS_IF(v, 0, 6, SO_ROW_UO_1_RTP) | \
+	 ROHC_COMP_ROWS_IF(v, 0, 5, SO_ROW_UO_1_TS) | \
+	 ROHC_COMP_ROWS_IF(v, 0, ROHC_SDVL_MAX_BITS_IN_4_BYTES, \
+	                   SO_ROW_UO_1_ID_EXT | SO_ROW_UOR_2_ID) | \
+	 (SO_ROWS_ALL & ~(SO_ROW_UO_1_RTP | SO_ROW_UO_1_TS | \
+	                  SO_ROW_UO_1_ID_EXT | SO_ROW_UOR_2_ID)))
+	.ts = ROHC_COMP_BITS_TABLE(SO_TS),
+#undef SO_TS
+	.ts_scaled = { SO_ROWS_ALL & ~SO_ROWS_UO, SO_ROWS_ALL },
+	.ts_implicit = { SO_ROWS_ALL & ~(SO_ROW_UO_0 | SO_ROW_UO_1_ID), SO_ROWS_ALL },
+	.marker = { SO_ROWS_ALL, SO_ROWS_ALL & ~(SO_ROW_UO_0 | SO_ROW_UO_1_ID) },
+};
+
 
 /*
  * Private function prototypes.
@@ -54,12 +145,17 @@
 static bool c_rtp_create(struct rohc_comp_ctxt *const context,
                          const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static size_t c_rtp_mem_max(const size_t wlsb_width)
+	__attribute__((warn_unused_result, const));
 static void c_rtp_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
 static bool c_rtp_check_profile(const struct rohc_comp *const comp,
                                 const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static inline bool c_rtp_is_rtp_port(const struct rohc_comp *const comp,
+                                     const uint16_t port)
+	__attribute__((warn_unused_result, nonnull(1), pure));
 
 static bool c_rtp_check_context(const struct rohc_comp_ctxt *const context,
                                 const struct net_pkt *const packet)
@@ -73,38 +169,32 @@ static int c_rtp_encode(struct rohc_comp_ctxt *const context,
                         size_t *const payload_offset)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5, 6)));
 
-static void rtp_decide_state(struct rohc_comp_ctxt *const context);
-
-static rohc_packet_t c_rtp_decide_FO_packet(const struct rohc_comp_ctxt *context);
-static rohc_packet_t c_rtp_decide_SO_packet(const struct rohc_comp_ctxt *context);
-static rohc_ext_t c_rtp_decide_extension(const struct rohc_comp_ctxt *context);
-
-static uint32_t c_rtp_get_next_sn(const struct rohc_comp_ctxt *const context,
-                                  const struct net_pkt *const uncomp_pkt)
-	__attribute__((warn_unused_result, nonnull(1, 2)));
-
-static bool rtp_encode_uncomp_fields(struct rohc_comp_ctxt *const context,
-                                     const struct net_pkt *const uncomp_pkt)
-	__attribute__((warn_unused_result, nonnull(1, 2)));
-
-static size_t rtp_code_static_rtp_part(const struct rohc_comp_ctxt *const context,
-                                       const uint8_t *const next_header,
-                                       uint8_t *const dest,
-                                       const size_t counter)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
-
-static size_t rtp_code_dynamic_rtp_part(const struct rohc_comp_ctxt *const context,
-                                        const uint8_t *const next_header,
-                                        uint8_t *const dest,
-                                        const size_t counter)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
-
 static int rtp_changed_rtp_dynamic(const struct rohc_comp_ctxt *const context,
                                    const struct udphdr *const udp,
                                    const struct rtphdr *const rtp)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
 
+/** The handlers of the RTP profile for the generic RFC3095-based code */
+static const struct rohc_comp_rfc3095_ops c_rtp_rfc3095_ops =
+{
+	.encode_uncomp_fields = rtp_encode_uncomp_fields,
+	.decide_state         = rtp_decide_state,
+	.decide_FO_packet     = c_rtp_decide_FO_packet,
+	.decide_SO_packet     = c_rtp_decide_SO_packet,
+	.decide_extension     = c_rtp_decide_extension,
+	.init_at_IR           = NULL,
+	.get_next_sn          = c_rtp_get_next_sn,
+	.code_static_part     = rtp_code_static_rtp_part,
+	.code_dynamic_part    = rtp_code_dynamic_rtp_part,
+	.code_ir_remainder    = NULL,
+	.code_UO_packet_head  = NULL,
+	.code_uo_remainder    = udp_code_uo_remainder,
+	.compute_crc_static   = rtp_compute_crc_static,
+	.compute_crc_dynamic  = rtp_compute_crc_dynamic,
+};
+
+
 /**
  * @brief Create a new RTP context and initialize it thanks to the given
  *        IP/UDP/RTP packet.
@@ -128,7 +218,8 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	assert(context->profile != NULL);
 
 	/* create and initialize the generic part of the profile context */
-	if(!rohc_comp_rfc3095_create(context, ROHC_LSB_SHIFT_RTP_SN, packet))
+	if(!rohc_comp_rfc3095_create(context, &c_rtp_rfc3095_ops,
+	                             ROHC_LSB_SHIFT_RTP_SN, packet))
 	{
 		rohc_comp_warn(context, "generic context creation failed");
 		goto quit;
@@ -148,7 +239,8 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	                "packet = %u", rfc3095_ctxt->sn);
 
 	/* create the RTP part of the profile context */
-	rtp_context = malloc(sizeof(struct sc_rtp_context));
+	rtp_context = rohc_slab_alloc(context->compressor->ctxt_slab,
+	                              sizeof(struct sc_rtp_context));
 	if(rtp_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -166,7 +258,10 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 	rtp_context->rtp_extension_change_count = 0;
 	memcpy(&rtp_context->old_rtp, rtp, sizeof(struct rtphdr));
 	if(!c_create_sc(&rtp_context->ts_sc,
+	                context->compressor->ctxt_slab,
 	                context->compressor->wlsb_window_width,
+	                context->compressor->rtp_ts_timer,
+	                context->compressor->rtp_ts_max_jitter_cd,
 	                context->compressor->trace_callback,
 	                context->compressor->trace_callback_priv))
 	{
@@ -188,20 +283,12 @@ static bool c_rtp_create(struct rohc_comp_ctxt *const context,
 
 	/* init the RTP-specific variables and functions */
 	rfc3095_ctxt->next_header_len = sizeof(struct udphdr) + sizeof(struct rtphdr);
-	rfc3095_ctxt->encode_uncomp_fields = rtp_encode_uncomp_fields;
-	rfc3095_ctxt->decide_state = rtp_decide_state;
-	rfc3095_ctxt->decide_FO_packet = c_rtp_decide_FO_packet;
-	rfc3095_ctxt->decide_SO_packet = c_rtp_decide_SO_packet;
-	rfc3095_ctxt->decide_extension = c_rtp_decide_extension;
-	rfc3095_ctxt->init_at_IR = NULL;
-	rfc3095_ctxt->get_next_sn = c_rtp_get_next_sn;
-	rfc3095_ctxt->code_static_part = rtp_code_static_rtp_part;
-	rfc3095_ctxt->code_dynamic_part = rtp_code_dynamic_rtp_part;
-	rfc3095_ctxt->code_ir_remainder = NULL;
-	rfc3095_ctxt->code_UO_packet_head = NULL;
-	rfc3095_ctxt->code_uo_remainder = udp_code_uo_remainder;
-	rfc3095_ctxt->compute_crc_static = rtp_compute_crc_static;
-	rfc3095_ctxt->compute_crc_dynamic = rtp_compute_crc_dynamic;
+
+	/* the generic code calls the RTP handlers directly for the most common
+	 * case: one single IPv4 header followed by the UDP and RTP headers */
+	rfc3095_ctxt->is_ipv4_udp_rtp =
+		(rfc3095_ctxt->ip_hdr_nr == 1 &&
+		 rfc3095_ctxt->outer_ip_flags.version == IPV4);
 
 	return true;
 
@@ -300,7 +387,23 @@ static bool c_rtp_check_profile(const struct rohc_comp *const comp,
 	}
 
 	/* check if the IP/UDP packet is a RTP packet */
-	if(comp->rtp_callback != NULL)
+	if(comp->rtp_ports_nr > 0 && c_rtp_is_rtp_port(comp, udp_header->dest))
+	{
+		const struct rtphdr *const rtp = (struct rtphdr *) udp_payload;
+
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "RTP packet detected by the UDP destination port");
+
+		/* RTP packets with one or more CSRC items cannot be compressed by the
+		 * RTP profile for the moment */
+		if(rtp->cc != 0)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "compression of CSRC items is not supported yet by RTP profile");
+			goto bad_profile;
+		}
+	}
+	else if(comp->rtp_callback != NULL)
 	{
 		const struct rtphdr *rtp;
 
@@ -358,6 +461,24 @@ bad_profile:
 }
 
 
+/**
+ * @brief Is the given UDP port dedicated for RTP traffic?
+ *
+ * @param comp  The ROHC compressor
+ * @param port  The UDP port (in network byte order)
+ * @return      true if the UDP port is dedicated for RTP traffic,
+ *              false otherwise
+ *
+ * @see rohc_comp_add_rtp_ports
+ */
+static inline bool c_rtp_is_rtp_port(const struct rohc_comp *const comp,
+                                     const uint16_t port)
+{
+	const uint16_t port_h = rohc_ntoh16(port);
+	return !!((comp->rtp_ports[port_h / 64] >> (port_h % 64)) & 1);
+}
+
+
 /**
  * @brief Check if the IP/UDP/RTP packet belongs to the context
  *
@@ -432,7 +553,7 @@ bad_context:
  *                 - ROHC_PACKET_UOR_2_ID
  *                 - ROHC_PACKET_IR_DYN
  */
-static rohc_packet_t c_rtp_decide_FO_packet(const struct rohc_comp_ctxt *context)
+rohc_packet_t c_rtp_decide_FO_packet(const struct rohc_comp_ctxt *context)
 {
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
 	struct sc_rtp_context *rtp_context;
@@ -458,8 +579,8 @@ static rohc_packet_t c_rtp_decide_FO_packet(const struct rohc_comp_ctxt *context
 	else if((rfc3095_ctxt->outer_ip_flags.version == IPV4 &&
 	         rfc3095_ctxt->outer_ip_flags.info.v4.sid_count < MAX_FO_COUNT) ||
 	        (nr_of_ip_hdr > 1 &&
-	         rfc3095_ctxt->inner_ip_flags.version == IPV4 &&
-	         rfc3095_ctxt->inner_ip_flags.info.v4.sid_count < MAX_FO_COUNT))
+	         rfc3095_ctxt->inner_ip_flags->version == IPV4 &&
+	         rfc3095_ctxt->inner_ip_flags->info.v4.sid_count < MAX_FO_COUNT))
 	{
 		packet = ROHC_PACKET_IR_DYN;
 		rohc_comp_debug(context, "choose packet IR-DYN because at least one "
@@ -559,7 +680,7 @@ static rohc_packet_t c_rtp_decide_FO_packet(const struct rohc_comp_ctxt *context
  *                 - ROHC_PACKET_UOR_2_ID
  *                 - ROHC_PACKET_IR_DYN
  */
-static rohc_packet_t c_rtp_decide_SO_packet(const struct rohc_comp_ctxt *context)
+rohc_packet_t c_rtp_decide_SO_packet(const struct rohc_comp_ctxt *context)
 {
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
 	struct sc_rtp_context *rtp_context;
@@ -599,11 +720,11 @@ static rohc_packet_t c_rtp_decide_SO_packet(const struct rohc_comp_ctxt *context
 		assert(rfc3095_ctxt->outer_ip_flags.info.v4.rnd_count >= MAX_FO_COUNT);
 		assert(rfc3095_ctxt->outer_ip_flags.info.v4.nbo_count >= MAX_FO_COUNT);
 	}
-	if(nr_of_ip_hdr > 1 && rfc3095_ctxt->inner_ip_flags.version == IPV4)
+	if(nr_of_ip_hdr > 1 && rfc3095_ctxt->inner_ip_flags->version == IPV4)
 	{
-		assert(rfc3095_ctxt->inner_ip_flags.info.v4.sid_count >= MAX_FO_COUNT);
-		assert(rfc3095_ctxt->inner_ip_flags.info.v4.rnd_count >= MAX_FO_COUNT);
-		assert(rfc3095_ctxt->inner_ip_flags.info.v4.nbo_count >= MAX_FO_COUNT);
+		assert(rfc3095_ctxt->inner_ip_flags->info.v4.sid_count >= MAX_FO_COUNT);
+		assert(rfc3095_ctxt->inner_ip_flags->info.v4.rnd_count >= MAX_FO_COUNT);
+		assert(rfc3095_ctxt->inner_ip_flags->info.v4.nbo_count >= MAX_FO_COUNT);
 	}
 	assert(rfc3095_ctxt->tmp.send_static == 0);
 	assert(rfc3095_ctxt->tmp.send_dynamic == 0);
@@ -624,10 +745,10 @@ static rohc_packet_t c_rtp_decide_SO_packet(const struct rohc_comp_ctxt *context
 			nr_ipv4_non_rnd_with_bits++;
 		}
 	}
-	if(nr_of_ip_hdr >= 1)
+	if(nr_of_ip_hdr > 1)
 	{
-		const int is_ip2_v4 = (rfc3095_ctxt->inner_ip_flags.version == IPV4);
-		const int is_rnd2 = rfc3095_ctxt->inner_ip_flags.info.v4.rnd;
+		const int is_ip2_v4 = (rfc3095_ctxt->inner_ip_flags->version == IPV4);
+		const int is_rnd2 = rfc3095_ctxt->inner_ip_flags->info.v4.rnd;
 		const size_t nr_ip_id_bits2 = rfc3095_ctxt->tmp.nr_ip_id_bits2;
 		const bool is_inner_ipv4_non_rnd = (is_ip2_v4 && !is_rnd2);
 
@@ -661,118 +782,58 @@ static rohc_packet_t c_rtp_decide_SO_packet(const struct rohc_comp_ctxt *context
 		rohc_comp_debug(context, "choose packet IR-DYN because RTP Version "
 		                "changed");
 	}
-	else if(rohc_comp_rfc3095_is_sn_possible(rfc3095_ctxt, 4, 0) &&
-	        nr_ipv4_non_rnd_with_bits == 0 &&
-	        is_ts_scaled &&
-	        (is_ts_deducible ||
-	         (rtp_context->tmp.nr_ts_bits_less_equal_than_2 == 0 &&
-	          rtp_context->tmp.nr_ts_bits_more_than_2 == 0)) &&
-	        !rtp_context->tmp.is_marker_bit_set)
-	{
-		packet = ROHC_PACKET_UO_0;
-		rohc_comp_debug(context, "choose packet UO-0 because less than 4 SN bits "
-		                "must be transmitted, neither of the %zd IP header(s) "
-		                "are IPv4 with non-random IP-ID with some IP-ID bits "
-		                "to transmit, ( no TS bit must be transmitted, "
-		                "or TS bits are deducible from SN ), and RTP M bit is "
-		                "not set", nr_of_ip_hdr);
-	}
-	else if(rohc_comp_rfc3095_is_sn_possible(rfc3095_ctxt, 4, 0) &&
-	        nr_ipv4_non_rnd == 0 &&
-	        is_ts_scaled && rtp_context->tmp.nr_ts_bits_more_than_2 <= 6)
-	{
-		packet = ROHC_PACKET_UO_1_RTP;
-		rohc_comp_debug(context, "choose packet UO-1-RTP because neither of "
-		                "the %zd IP header(s) are 'IPv4 with non-random IP-ID', "
-		                "less than 4 SN bits must be transmitted, and "
-		                "%zu <= 6 TS bits must be transmitted", nr_of_ip_hdr,
-		                rtp_context->tmp.nr_ts_bits_more_than_2);
-	}
-	else if(rohc_comp_rfc3095_is_sn_possible(rfc3095_ctxt, 4, 0) &&
-	        nr_ipv4_non_rnd_with_bits == 1 && nr_innermost_ip_id_bits <= 5 &&
-	        is_ts_scaled &&
-	        (is_ts_deducible ||
-	         (rtp_context->tmp.nr_ts_bits_less_equal_than_2 == 0 &&
-	          rtp_context->tmp.nr_ts_bits_more_than_2 == 0)) &&
-	        !rtp_context->tmp.is_marker_bit_set)
-	{
-		/* UO-1-ID without extension */
-		packet = ROHC_PACKET_UO_1_ID;
-		rohc_comp_debug(context, "choose packet UO-1-ID because only one of the "
-		                "%zd IP header(s) is IPv4 with non-random IP-ID with "
-		                "%zd <= 5 IP-ID bits to transmit, less than 4 SN bits "
-		                "must be transmitted, ( no TS bit must be transmitted, "
-		                "or TS bits are deducible from SN ), and RTP M bit is not "
-		                "set", nr_of_ip_hdr, nr_innermost_ip_id_bits);
-	}
-	else if(rohc_comp_rfc3095_is_sn_possible(rfc3095_ctxt, 4, 0) &&
-	        nr_ipv4_non_rnd_with_bits == 0 &&
-	        is_ts_scaled && rtp_context->tmp.nr_ts_bits_more_than_2 <= 5)
-	{
-		packet = ROHC_PACKET_UO_1_TS;
-		rohc_comp_debug(context, "choose packet UO-1-TS because neither of the "
-		                "%zd IP header(s) are IPv4 with non-random IP-ID with "
-		                "some IP-ID bits to to transmit for that IP header, "
-		                "less than 4 SN bits must be transmitted, and "
-		                "%zu <= 6 TS bits must be transmitted", nr_of_ip_hdr,
-		                rtp_context->tmp.nr_ts_bits_more_than_2);
-	}
-	else if(rohc_comp_rfc3095_is_sn_possible(rfc3095_ctxt, 4, 8) &&
-	        nr_ipv4_non_rnd_with_bits >= 1 &&
-	        sdvl_can_length_be_encoded(rtp_context->tmp.nr_ts_bits_more_than_2))
+	else
 	{
-		/* UO-1-ID packet with extension can be used only if SN stand on
-		 * <= 12 bits (4 bits in base header + 8 bits in extension 3) */
-
-		packet = ROHC_PACKET_UO_1_ID;
-		rohc_comp_debug(context, "choose packet UO-1-ID because at least "
-		                "one of the %zd IP header(s) is IPv4 with "
-		                "non-random IP-ID with at least 1 bit of IP-ID to "
-		                "transmit, less than 12 SN bits must be transmitted, "
-		                "and %zu TS bits can be SDVL-encoded", nr_of_ip_hdr,
+		/* look up the packet type in the pre-computed tables: UO-0, then
+		 * UO-1-RTP, UO-1-ID, UO-1-TS, UO-1-ID with extension, UOR-2-RTP,
+		 * UOR-2-ID, UOR-2-TS, and IR-DYN */
+		const size_t sn_idx =
+			(rohc_comp_rfc3095_is_sn_possible(rfc3095_ctxt, 4, 0) ? 1 : 0) |
+			(rohc_comp_rfc3095_is_sn_possible(rfc3095_ctxt, 4, 8) ? 2 : 0) |
+			(rohc_comp_rfc3095_is_sn_possible(rfc3095_ctxt, 6, 8) ? 4 : 0);
+		const bool is_ts_implicit =
+			(is_ts_deducible ||
+			 (rtp_context->tmp.nr_ts_bits_less_equal_than_2 == 0 &&
+			  rtp_context->tmp.nr_ts_bits_more_than_2 == 0));
+		unsigned int rows;
+
+		rows = c_rtp_so_table.sn[sn_idx];
+		rows &= c_rtp_so_table.ipv4_non_rnd[nr_ipv4_non_rnd > 0]
+		                                   [rohc_min(nr_ipv4_non_rnd_with_bits, 2)];
+		rows &= c_rtp_so_table.inner_ip_id[rohc_comp_bits_idx(nr_innermost_ip_id_bits)];
+		rows &= c_rtp_so_table.ts[rohc_comp_bits_idx(rtp_context->tmp.nr_ts_bits_more_than_2)];
+		rows &= c_rtp_so_table.ts_scaled[is_ts_scaled];
+		rows &= c_rtp_so_table.ts_implicit[is_ts_implicit];
+		rows &= c_rtp_so_table.marker[rtp_context->tmp.is_marker_bit_set];
+		assert((rows & SO_ROW_IR_DYN) != 0);
+		packet = c_rtp_so_rows[__builtin_ctz(rows)];
+
+		rohc_comp_debug(context, "choose packet %s for %zu IP header(s), with "
+		                "%zu <= 4 / %zu > 4 SN bits, %u IPv4 header(s) with "
+		                "non-random IP-ID, %u of them with IP-ID bits, %zu "
+		                "innermost IP-ID bits, and %zu TS bits",
+		                rohc_get_packet_descr(packet), nr_of_ip_hdr,
+		                rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4,
+		                rfc3095_ctxt->tmp.nr_sn_bits_more_than_4,
+		                nr_ipv4_non_rnd, nr_ipv4_non_rnd_with_bits,
+		                nr_innermost_ip_id_bits,
 		                rtp_context->tmp.nr_ts_bits_more_than_2);
-	}
-	else if(rohc_comp_rfc3095_is_sn_possible(rfc3095_ctxt, 6, 8))
-	{
-		/* UOR-2* packets can be used only if SN stand on <= 14 bits (6 bits
-		 * in base header + 8 bits in extension 3): determine which UOR-2*
-		 * packet to choose */
 
-		/* what UOR-2* packet do we choose? */
-		/* TODO: the 3 next if/else could be merged with the ones from
-		 * c_rtp_decide_FO_packet */
-		if(nr_ipv4_non_rnd == 0)
+		/* all the UO* rows that fit compete on their actual size if the
+		 * compressor favours the smallest packets */
+		if((c_features(context->compressor) &
+		    ROHC_COMP_FEATURE_SMALLEST_PACKETS) != 0 ||
+		   context->compressor->effort == ROHC_COMP_EFFORT_BEST)
 		{
-			packet = ROHC_PACKET_UOR_2_RTP;
-			rohc_comp_debug(context, "choose packet UOR-2-RTP because neither "
-			                "of the %zd IP header(s) are IPv4 with non-random "
-			                "IP-ID", nr_of_ip_hdr);
-		}
-		else if(nr_ipv4_non_rnd_with_bits >= 1 &&
-		        sdvl_can_length_be_encoded(rtp_context->tmp.nr_ts_bits_more_than_2))
-		{
-			packet = ROHC_PACKET_UOR_2_ID;
-			rohc_comp_debug(context, "choose packet UOR-2-ID because at least "
-			                "one of the %zd IP header(s) is IPv4 with non-random "
-			                "IP-ID with at least 1 bit of IP-ID to transmit, "
-			                "and %zu TS bits can be SDVL-encoded", nr_of_ip_hdr,
-			                rtp_context->tmp.nr_ts_bits_more_than_2);
-		}
-		else
-		{
-			packet = ROHC_PACKET_UOR_2_TS;
-			rohc_comp_debug(context, "choose packet UOR-2-TS because at least "
-			                "one of the %zd IP header(s) is IPv4 with "
-			                "non-random IP-ID", nr_of_ip_hdr);
+			rows &= ~SO_ROW_IR_DYN;
+			while(rows != 0)
+			{
+				rfc3095_ctxt->tmp.packet_candidates |=
+					(1U << c_rtp_so_rows[__builtin_ctz(rows)]);
+				rows &= rows - 1;
+			}
 		}
 	}
-	else
-	{
-		/* UOR-2* packets can not be used, use IR-DYN instead */
-		packet = ROHC_PACKET_IR_DYN;
-		rohc_comp_debug(context, "choose packet IR-DYN because more than 14 SN "
-		                "bits must be transmitted");
-	}
 
 	return packet;
 }
@@ -788,7 +849,7 @@ static rohc_packet_t c_rtp_decide_SO_packet(const struct rohc_comp_ctxt *context
  *                ROHC_EXT_1 and ROHC_EXT_3 if successful,
  *                ROHC_EXT_UNKNOWN otherwise
  */
-static rohc_ext_t c_rtp_decide_extension(const struct rohc_comp_ctxt *context)
+rohc_ext_t c_rtp_decide_extension(const struct rohc_comp_ctxt *context)
 {
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
 	struct sc_rtp_context *rtp_context;
@@ -904,7 +965,7 @@ quit:
  *
  * @param context The compression context
  */
-static void rtp_decide_state(struct rohc_comp_ctxt *const context)
+void rtp_decide_state(struct rohc_comp_ctxt *const context)
 {
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
 	struct sc_rtp_context *rtp_context;
@@ -952,8 +1013,8 @@ static void rtp_decide_state(struct rohc_comp_ctxt *const context)
  * @param uncomp_pkt  The uncompressed packet to encode
  * @return            The SN
  */
-static uint32_t c_rtp_get_next_sn(const struct rohc_comp_ctxt *const context __attribute__((unused)),
-                                  const struct net_pkt *const uncomp_pkt)
+uint32_t c_rtp_get_next_sn(const struct rohc_comp_ctxt *const context __attribute__((unused)),
+                           const struct net_pkt *const uncomp_pkt)
 {
 	const struct udphdr *const udp = (struct udphdr *) uncomp_pkt->transport->data;
 	const struct rtphdr *const rtp = (struct rtphdr *) (udp + 1);
@@ -975,8 +1036,8 @@ static uint32_t c_rtp_get_next_sn(const struct rohc_comp_ctxt *const context __a
  * @param uncomp_pkt  The uncompressed packet to encode
  * @return            true in case of success, false otherwise
  */
-static bool rtp_encode_uncomp_fields(struct rohc_comp_ctxt *const context,
-                                     const struct net_pkt *const uncomp_pkt)
+bool rtp_encode_uncomp_fields(struct rohc_comp_ctxt *const context,
+                              const struct net_pkt *const uncomp_pkt)
 {
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
 	struct sc_rtp_context *rtp_context;
@@ -995,7 +1056,8 @@ static bool rtp_encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 
 	/* add new TS value to context */
 	assert(rfc3095_ctxt->sn <= 0xffff);
-	c_add_ts(&rtp_context->ts_sc, rohc_ntoh32(rtp->timestamp), rfc3095_ctxt->sn);
+	c_add_ts(&rtp_context->ts_sc, rohc_ntoh32(rtp->timestamp), rfc3095_ctxt->sn,
+	         uncomp_pkt->time);
 
 	/* determine the number of TS bits to send wrt compression state */
 	if(rtp_context->ts_sc.state == INIT_TS ||
@@ -1026,9 +1088,9 @@ static bool rtp_encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 		               &rtp_context->tmp.nr_ts_bits_less_equal_than_2,
 		               &rtp_context->tmp.nr_ts_bits_more_than_2);
 
-		/* save the new unscaled and TS_SCALED values */
+		/* save the new TS_SCALED value, the unscaled value is saved from it
+		 * only if the SEND_SCALED state is left */
 		assert(rfc3095_ctxt->sn <= 0xffff);
-		add_unscaled(&rtp_context->ts_sc, rfc3095_ctxt->sn);
 		add_scaled(&rtp_context->ts_sc, rfc3095_ctxt->sn);
 		rohc_comp_debug(context, "TS_SCALED = %u on %zu/2 bits or %zu/32 bits",
 		                rtp_context->tmp.ts_send,
@@ -1078,10 +1140,10 @@ static bool rtp_encode_uncomp_fields(struct rohc_comp_ctxt *const context,
  *
  * @see udp_code_static_udp_part
  */
-static size_t rtp_code_static_rtp_part(const struct rohc_comp_ctxt *const context,
-                                       const uint8_t *const next_header,
-                                       uint8_t *const dest,
-                                       const size_t counter)
+size_t rtp_code_static_rtp_part(const struct rohc_comp_ctxt *const context,
+                                const uint8_t *const next_header,
+                                uint8_t *const dest,
+                                const size_t counter)
 {
 	const struct udphdr *const udp = (struct udphdr *) next_header;
 	const struct rtphdr *const rtp = (struct rtphdr *) (udp + 1);
@@ -1133,7 +1195,7 @@ static size_t rtp_code_static_rtp_part(const struct rohc_comp_ctxt *const contex
 
 \endverbatim
  *
- * Parts 6 & 9 are not supported yet. The TIS flag in part 7 is not supported.
+ * Part 6 is not supported yet.
  *
  * @param context     The compression context
  * @param next_header The UDP/RTP headers
@@ -1141,10 +1203,10 @@ static size_t rtp_code_static_rtp_part(const struct rohc_comp_ctxt *const contex
  * @param counter     The current position in the rohc-packet-under-build buffer
  * @return            The new position in the rohc-packet-under-build buffer
  */
-static size_t rtp_code_dynamic_rtp_part(const struct rohc_comp_ctxt *const context,
-                                        const uint8_t *const next_header,
-                                        uint8_t *const dest,
-                                        const size_t counter)
+size_t rtp_code_dynamic_rtp_part(const struct rohc_comp_ctxt *const context,
+                                 const uint8_t *const next_header,
+                                 uint8_t *const dest,
+                                 const size_t counter)
 {
 	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
 	struct sc_rtp_context *rtp_context;
@@ -1221,15 +1283,13 @@ static size_t rtp_code_dynamic_rtp_part(const struct rohc_comp_ctxt *const conte
 		int tss;
 
 		/* part 7 */
-		tis = 0; /* TIS flag not supported yet */
 		tss = (rtp_context->ts_sc.state == INIT_STRIDE);
+		tis = (tss && rtp_context->ts_sc.is_timer_enabled);
 
 		byte = 0;
 		byte |= (rtp->extension & 0x01) << 4;
 		byte |= (context->mode & 0x03) << 2;
-#if 0 /* TODO: handle TIS */
 		byte |= (tis & 0x01) << 1;
-#endif
 		byte |= tss & 0x01;
 		dest[counter + nr_written] = byte;
 		rohc_comp_debug(context, "(X = %u, Mode = %u, TIS = %u, TSS = %u) = 0x%02x",
@@ -1281,7 +1341,25 @@ static size_t rtp_code_dynamic_rtp_part(const struct rohc_comp_ctxt *const conte
 			}
 		}
 
-		/* part 9 not supported yet */
+		/* part 9 */
+		if(tis)
+		{
+			const uint32_t time_stride = get_time_stride(&rtp_context->ts_sc);
+			size_t time_stride_sdvl_len;
+
+			/* encode TIME_STRIDE in SDVL and write it to packet, 0 if the
+			 * timer-based compression shall not be used with TS_STRIDE */
+			if(!sdvl_encode_full(dest + counter + nr_written, 4U,
+			                     &time_stride_sdvl_len, time_stride))
+			{
+				rohc_comp_warn(context, "failed to SDVL-encode TIME_STRIDE %u",
+				               time_stride);
+				assert(0);
+			}
+			rohc_comp_debug(context, "send TIME_STRIDE = %u ms encoded with SDVL "
+			                "on %zu bytes", time_stride, time_stride_sdvl_len);
+			nr_written += time_stride_sdvl_len;
+		}
 	}
 
 	return counter + nr_written;
@@ -1470,6 +1548,21 @@ static int rtp_changed_rtp_dynamic(const struct rohc_comp_ctxt *const context,
 }
 
 
+/**
+ * @brief Get the maximum length one RTP context takes in a memory block
+ *
+ * @param wlsb_width  The width of the W-LSB sliding windows
+ * @return            The maximum number of bytes of the memory block the
+ *                    profile-specific part of the context takes
+ */
+static size_t c_rtp_mem_max(const size_t wlsb_width)
+{
+	return (rohc_comp_rfc3095_mem_max(wlsb_width) +
+	        rohc_slab_block_mem_max(sizeof(struct sc_rtp_context)) +
+	        c_sc_mem_max(wlsb_width));
+}
+
+
 /**
  * @brief Define the compression part of the RTP profile as described
  *        in the RFC 3095.
@@ -1485,5 +1578,7 @@ const struct rohc_comp_profile c_rtp_profile =
 	.encode         = c_rtp_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.prefetch       = rohc_comp_rfc3095_prefetch,
+	.get_mem_max    = c_rtp_mem_max,
 };
 
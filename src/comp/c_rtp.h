@@ -131,7 +131,35 @@ struct sc_rtp_context
  * Function prototypes.
  */
 
-/* no public function */
+void rtp_decide_state(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+
+rohc_packet_t c_rtp_decide_FO_packet(const struct rohc_comp_ctxt *context)
+	__attribute__((warn_unused_result, nonnull(1)));
+rohc_packet_t c_rtp_decide_SO_packet(const struct rohc_comp_ctxt *context)
+	__attribute__((warn_unused_result, nonnull(1)));
+rohc_ext_t c_rtp_decide_extension(const struct rohc_comp_ctxt *context)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+uint32_t c_rtp_get_next_sn(const struct rohc_comp_ctxt *const context,
+                           const struct net_pkt *const uncomp_pkt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+bool rtp_encode_uncomp_fields(struct rohc_comp_ctxt *const context,
+                              const struct net_pkt *const uncomp_pkt)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+size_t rtp_code_static_rtp_part(const struct rohc_comp_ctxt *const context,
+                                const uint8_t *const next_header,
+                                uint8_t *const dest,
+                                const size_t counter)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+size_t rtp_code_dynamic_rtp_part(const struct rohc_comp_ctxt *const context,
+                                 const uint8_t *const next_header,
+                                 uint8_t *const dest,
+                                 const size_t counter)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
 #endif
 
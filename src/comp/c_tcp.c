@@ -43,6 +43,8 @@
 #include "sdvl.h"
 #include "crc.h"
 #include "rohc_bit_ops.h"
+#include "rohc_bit_stream.h"
+#include "rohc_mem.h"
 
 #include <assert.h>
 #include <stdlib.h>
@@ -58,6 +60,39 @@
 #define TRACE_GOTO_CHOICE \
 	rohc_comp_debug(context, "Compressed format choice LINE %d", __LINE__ )
 
+/** The number of recent contexts searched for one IR-CR base context */
+#define C_TCP_REPLICATE_SEARCH_MAX  16U
+
+/** The max length of the cached static chain: 2 IPv6 headers and TCP */
+#define C_TCP_STATIC_CHAIN_MAX_LEN  80U
+
+
+/** The fields whose W-LSB encoding is evaluated on demand */
+typedef enum
+{
+	TCP_LSB_MSN        = (1U << 0), /**< The MSN */
+	TCP_LSB_IP_ID      = (1U << 1), /**< The innermost IP-ID / SN delta */
+	TCP_LSB_TTL_HOPL   = (1U << 2), /**< The innermost TTL or Hop Limit */
+	TCP_LSB_WINDOW     = (1U << 3), /**< The TCP window */
+	TCP_LSB_SEQ        = (1U << 4), /**< The TCP sequence number */
+	TCP_LSB_SEQ_SCALED = (1U << 5), /**< The scaled TCP sequence number */
+	TCP_LSB_ACK        = (1U << 6), /**< The TCP ACK number */
+	TCP_LSB_ACK_SCALED = (1U << 7), /**< The scaled TCP ACK number */
+	TCP_LSB_TS         = (1U << 8), /**< The TCP TS option */
+} tcp_lsb_field_t;
+
+
+/** The fields of the W-LSB window of the fields updated with every packet */
+typedef enum
+{
+	TCP_WLSB_MSN       = 0, /**< The MSN */
+	TCP_WLSB_TTL_HOPL  = 1, /**< The innermost TTL or Hop Limit */
+	TCP_WLSB_WINDOW    = 2, /**< The TCP window */
+	TCP_WLSB_SEQ       = 3, /**< The TCP sequence number */
+	TCP_WLSB_ACK       = 4, /**< The TCP ACK number */
+	TCP_WLSB_FIELDS_NR = 5, /**< The number of fields of the window */
+} tcp_wlsb_field_t;
+
 
 /**
  * @brief Define the TCP-specific temporary variables in the profile
@@ -82,6 +117,10 @@ struct tcp_tmp_variables
 	/* the length of the TCP payload (headers and options excluded) */
 	size_t payload_len;
 
+	/** The fields whose numbers of LSB bits were already computed for the
+	 *  current packet, see \ref tcp_lsb_field_t */
+	unsigned int lsb_fields_done;
+
 	/** The minimal number of bits required to encode the MSN value */
 	size_t nr_msn_bits;
 
@@ -160,6 +199,9 @@ struct tcp_tmp_variables
 
 	/** Whether the ecn_used flag changed or not */
 	bool ecn_used_changed;
+
+	/** The CID of the base context replicated by the IR-CR packet */
+	rohc_cid_t replicate_base_cid;
 };
 
 
@@ -215,6 +257,8 @@ typedef struct __attribute__((packed)) ipv4_context
 	uint8_t ip_id_behavior;
 	uint8_t last_ip_id_behavior;
 	uint16_t last_ip_id;
+	/** The number of consecutive packets that confirmed the IP-ID behavior */
+	uint8_t ip_id_behavior_confidence;
 
 	uint32_t src_addr;
 	uint32_t dst_addr;
@@ -252,8 +296,9 @@ typedef struct __attribute__((packed)) ipv6_context
 
 	uint32_t flow_label:20;
 
-	uint32_t src_addr[4];
-	uint32_t dest_addr[4];
+	/** The source then destination addresses, shared with the other contexts
+	 *  through the store of static fragments of the compressor */
+	const struct ipv6_addr *addrs;
 
 } ipv6_context_t;
 
@@ -272,61 +317,80 @@ typedef struct
 	} ctxt;
 
 	size_t opts_nr;
-	ip_option_context_t opts[ROHC_TCP_MAX_IP_EXT_HDRS];
+	/** The contexts of the IPv6 extension headers, allocated with the first
+	 *  extension header only, NULL before */
+	ip_option_context_t *opts;
 
 } ip_context_t;
 
 
-/** Define the TCP part of the profile decompression context */
-struct sc_tcp_context
+/** The static chain of the IR packets, cached by the first IR packet */
+struct sc_tcp_static_chain
 {
-	/// The number of times the sequence number field was added to the compressed header
-	int tcp_seq_num_change_count;
-	/** The number of times the window field was added to the compressed header */
-	size_t tcp_window_change_count;
+	/** The static chain */
+	uint8_t data[C_TCP_STATIC_CHAIN_MAX_LEN];
+	/** The length of the static chain, 0 if it shall be built again */
+	size_t len;
+	/** The CRC-8 of the IR header up to the end of the static chain */
+	uint8_t crc;
+};
 
+
+/**
+ * @brief Define the TCP part of the profile compression context
+ *
+ * The fields read or written for every packet come first, so that they
+ * share the first cache lines of the context. The contexts of the IPv6
+ * extension headers and the cached static chain are cold: they are allocated
+ * on first use only.
+ */
+struct sc_tcp_context
+{
+	uint16_t msn;               /**< The Master Sequence Number (MSN) */
+	uint16_t ack_stride;
+	uint16_t ack_num_residue;
 	/** Explicit Congestion Notification used */
 	bool ecn_used;
-	/** The number of times the ECN fields were added to the compressed header */
-	size_t ecn_used_change_count;
-	/** The number of times the ECN fields were not needed */
-	size_t ecn_used_zero_count;
 
+	uint32_t seq_num;
+	uint32_t seq_num_scaled;
+	uint32_t seq_num_residue;
 	uint32_t tcp_last_seq_num;
+	uint32_t ack_num;
+	uint32_t ack_num_scaled;
+	/// The number of times the sequence number field was added to the compressed header
+	int tcp_seq_num_change_count;
 
-	uint16_t msn;               /**< The Master Sequence Number (MSN) */
-	struct c_wlsb *msn_wlsb;    /**< The W-LSB decoding context for MSN */
-
-	struct c_wlsb *ttl_hopl_wlsb;
-	size_t ttl_hopl_change_count;
+	/** The last scaling of the sequence number */
+	struct c_field_scaling_cache seq_scaling;
+	/** The last scaling of the ACK number */
+	struct c_field_scaling_cache ack_scaling;
 
+	/** The W-LSB decoding context for MSN, its rows are shared with the TTL,
+	 *  window, sequence and ACK numbers fields below that are updated with
+	 *  every packet */
+	struct c_wlsb *msn_wlsb;
 	struct c_wlsb *ip_id_wlsb;
-
+	struct c_wlsb *ttl_hopl_wlsb;
 // lsb(15, 16383)
 	struct c_wlsb *window_wlsb; /**< The W-LSB decoding context for TCP window */
-
-	uint32_t seq_num;
 	struct c_wlsb *seq_wlsb;
 	struct c_wlsb *seq_scaled_wlsb;
-
-	uint32_t seq_num_scaled;
-	uint32_t seq_num_residue;
-	size_t seq_num_factor;
-	size_t seq_num_scaling_nr;
-
-	uint32_t ack_num;
 	struct c_wlsb *ack_wlsb;
 	struct c_wlsb *ack_scaled_wlsb;
 
-	size_t ack_deltas_next;
-	uint16_t ack_deltas_width[20];
-	uint16_t ack_stride;
-	uint32_t ack_num_scaled;
-	uint16_t ack_num_residue;
+	size_t seq_num_factor;
+	size_t seq_num_scaling_nr;
 	size_t ack_num_scaling_nr;
+	size_t ttl_hopl_change_count;
+	/** The number of times the window field was added to the compressed header */
+	size_t tcp_window_change_count;
+	/** The number of times the ECN fields were added to the compressed header */
+	size_t ecn_used_change_count;
+	/** The number of times the ECN fields were not needed */
+	size_t ecn_used_zero_count;
 
-	/** The compression context for TCP options */
-	struct c_tcp_opts_ctxt tcp_opts;
+	size_t ip_contexts_nr;
 
 	/// The previous TCP header
 	struct tcphdr old_tcphdr;
@@ -335,10 +399,26 @@ struct sc_tcp_context
 	///        compression of packet
 	struct tcp_tmp_variables tmp;
 
-	size_t ip_contexts_nr;
+	/* the ACK deltas of the last packets, only used when the ACK number
+	 * changes */
+	size_t ack_deltas_next;
+	uint16_t ack_deltas_width[20];
+	/** The number of times \e ack_stride is in \e ack_deltas_width */
+	size_t ack_stride_count;
+
+	/** The compression context for TCP options */
+	struct c_tcp_opts_ctxt tcp_opts;
+
 	ip_context_t ip_contexts[ROHC_TCP_MAX_IP_HDRS];
+
+	/** The static chain of the IR packets, NULL if not cached yet */
+	struct sc_tcp_static_chain *static_chain;
 };
 
+/* the fields read or written for every packet fit in 4 cache lines */
+_Static_assert(offsetof(struct sc_tcp_context, tmp) <= 4 * ROHC_MEM_CACHE_LINE_LEN,
+               "the hot part of the TCP compression context is too large");
+
 
 /*
  * Private function prototypes.
@@ -347,9 +427,13 @@ struct sc_tcp_context
 static bool c_tcp_create(struct rohc_comp_ctxt *const context,
                          const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static size_t c_tcp_mem_max(const size_t wlsb_width)
+	__attribute__((warn_unused_result, const));
 
 static void c_tcp_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
+static void c_tcp_put_ip_ctxts(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
 
 static bool c_tcp_check_profile(const struct rohc_comp *const comp,
                                 const struct net_pkt *const packet)
@@ -369,6 +453,13 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 
 static uint16_t c_tcp_get_next_msn(const struct rohc_comp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
+static uint32_t c_tcp_get_msn(const struct rohc_comp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static void c_tcp_set_next_msn(struct rohc_comp_ctxt *const context,
+                               const uint32_t msn)
+	__attribute__((nonnull(1)));
+static void c_tcp_prefetch(const struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
 
 static bool rohc_comp_tcp_are_ipv6_exts_acceptable(const struct rohc_comp *const comp,
                                                    uint8_t *const next_proto,
@@ -404,11 +495,28 @@ static bool tcp_encode_uncomp_ip_fields(struct rohc_comp_ctxt *const context,
 static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
                                          const struct tcphdr *const tcp)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void tcp_encode_lsb_fields(const struct rohc_comp_ctxt *const context,
+                                  const struct tcphdr *const tcp,
+                                  const unsigned int fields)
+	__attribute__((nonnull(1, 2)));
+static unsigned int tcp_get_pkt_lsb_fields(const rohc_packet_t packet_type)
+	__attribute__((warn_unused_result, const));
+static void tcp_update_lsb_windows(struct rohc_comp_ctxt *const context,
+                                   const struct tcphdr *const tcp)
+	__attribute__((nonnull(1, 2)));
 
 static rohc_packet_t tcp_decide_packet(struct rohc_comp_ctxt *const context,
                                        const ip_context_t *const ip_inner_context,
                                        const struct tcphdr *const tcp)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static rohc_packet_t tcp_decide_IR_packet(struct rohc_comp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1)));
+static const struct rohc_comp_ctxt *
+	tcp_find_replicate_base(const struct rohc_comp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool tcp_is_replicable(const struct sc_tcp_context *const tcp_context,
+                              const struct sc_tcp_context *const base)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 static rohc_packet_t tcp_decide_FO_packet(const struct rohc_comp_ctxt *const context,
                                           const ip_context_t *const ip_inner_context,
                                           const struct tcphdr *const tcp)
@@ -541,6 +649,13 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
                           const rohc_packet_t packet_type,
                           size_t *const payload_offset)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 6)));
+static int code_IR_CR_packet(struct rohc_comp_ctxt *const context,
+                             const struct ip_packet *const ip,
+                             const struct tcphdr *const tcp,
+                             uint8_t *const rohc_pkt,
+                             const size_t rohc_pkt_max_len,
+                             size_t *const payload_offset)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 static int code_CO_packet(struct rohc_comp_ctxt *const context,
                           const struct ip_packet *ip,
@@ -746,6 +861,10 @@ static int c_tcp_build_co_common(const struct rohc_comp_ctxt *const context,
 static tcp_ip_id_behavior_t tcp_detect_ip_id_behavior(const uint16_t last_ip_id,
                                                       const uint16_t new_ip_id)
 	__attribute__((warn_unused_result, const));
+static bool tcp_is_ip_id_behavior_confirmed(const tcp_ip_id_behavior_t behavior,
+                                            const uint16_t last_ip_id,
+                                            const uint16_t new_ip_id)
+	__attribute__((warn_unused_result, const));
 
 static void tcp_detect_ecn_used_behavior(struct rohc_comp_ctxt *const context,
                                          const uint8_t pkt_ecn_vals,
@@ -791,6 +910,9 @@ static void c_tcp_feedback_ack(struct rohc_comp_ctxt *const context,
                                const size_t sn_bits_nr,
                                const bool sn_not_valid)
 	__attribute__((nonnull(1)));
+static void c_tcp_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                 const size_t width)
+	__attribute__((nonnull(1)));
 
 
 /**
@@ -811,6 +933,7 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
                          const struct net_pkt *const packet)
 {
 	const struct rohc_comp *const comp = context->compressor;
+	struct rohc_slab *const slab = context->compressor->ctxt_slab;
 	struct sc_tcp_context *tcp_context;
 	const uint8_t *remain_data = packet->outer_ip.data;
 	size_t remain_len = packet->outer_ip.size;
@@ -819,7 +942,7 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 	size_t i;
 
 	/* create the TCP part of the profile context */
-	tcp_context = malloc(sizeof(struct sc_tcp_context));
+	tcp_context = rohc_slab_alloc(slab, sizeof(struct sc_tcp_context));
 	if(tcp_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -856,6 +979,7 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 				rohc_comp_debug(context, "IP-ID 0x%04x", ip_context->ctxt.v4.last_ip_id);
 				ip_context->ctxt.v4.last_ip_id_behavior = IP_ID_BEHAVIOR_SEQ;
 				ip_context->ctxt.v4.ip_id_behavior = IP_ID_BEHAVIOR_SEQ;
+				ip_context->ctxt.v4.ip_id_behavior_confidence = 0;
 				ip_context->ctxt.v4.protocol = proto;
 				ip_context->ctxt.v4.dscp = ipv4->dscp;
 				ip_context->ctxt.v4.df = ipv4->df;
@@ -878,10 +1002,16 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 				ip_context->ctxt.v6.dscp = remain_data[1];
 				ip_context->ctxt.v6.ttl_hopl = ipv6->hl;
 				ip_context->ctxt.v6.flow_label = ipv6_get_flow_label(ipv6);
-				memcpy(ip_context->ctxt.v6.src_addr, &ipv6->saddr,
-				       sizeof(struct ipv6_addr));
-				memcpy(ip_context->ctxt.v6.dest_addr, &ipv6->daddr,
-				       sizeof(struct ipv6_addr));
+				ip_context->ctxt.v6.addrs =
+					rohc_intern_get(context->compressor->static_store, &ipv6->saddr,
+					                sizeof(struct ipv6_addr) * 2);
+				if(ip_context->ctxt.v6.addrs == NULL)
+				{
+					rohc_error(context->compressor, ROHC_TRACE_COMP,
+					           context->profile->id, "no memory for the IPv6 "
+					           "addresses of the profile context");
+					goto free_context;
+				}
 
 				remain_data += sizeof(struct ipv6_hdr);
 				remain_len -= sizeof(struct ipv6_hdr);
@@ -929,25 +1059,48 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 	tcp_context->ecn_used_change_count = MAX_FO_COUNT;
 	tcp_context->ecn_used_zero_count = 0;
 	tcp_context->tcp_last_seq_num = -1;
+	tcp_context->static_chain = NULL;
 
 	/* TCP header begins just after the IP headers */
 	assert(remain_len >= sizeof(struct tcphdr));
 	tcp = (struct tcphdr *) remain_data;
 	memcpy(&(tcp_context->old_tcphdr), tcp, sizeof(struct tcphdr));
 
-	/* MSN */
-	tcp_context->msn_wlsb =
-		c_create_wlsb(16, comp->wlsb_window_width, ROHC_LSB_SHIFT_TCP_SN);
-	if(tcp_context->msn_wlsb == NULL)
+	/* MSN, innermost IPv4 TTL or IPv6 Hop Limit, TCP window, TCP sequence
+	 * number and TCP acknowledgment (ACK) number: all of them are added with
+	 * every packet, so they share the rows of one window */
 	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for MSN");
-		goto free_context;
+		const size_t bits[TCP_WLSB_FIELDS_NR] = { 16, 8, 16, 32, 32 };
+		const rohc_lsb_shift_t ps[TCP_WLSB_FIELDS_NR] = {
+			ROHC_LSB_SHIFT_TCP_SN, ROHC_LSB_SHIFT_TCP_TTL, ROHC_LSB_SHIFT_TCP_WINDOW,
+			ROHC_LSB_SHIFT_VAR, ROHC_LSB_SHIFT_VAR
+		};
+
+		tcp_context->msn_wlsb =
+			c_create_wlsb_multi(slab, TCP_WLSB_FIELDS_NR, bits,
+			                    comp->wlsb_window_width, ps);
+		if(tcp_context->msn_wlsb == NULL)
+		{
+			rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+			           "failed to create W-LSB context for MSN, TTL/Hop Limit, "
+			           "TCP window, sequence and ACK numbers");
+			goto free_context;
+		}
+		tcp_context->ttl_hopl_wlsb =
+			c_wlsb_get_field(tcp_context->msn_wlsb, TCP_WLSB_TTL_HOPL);
+		tcp_context->window_wlsb =
+			c_wlsb_get_field(tcp_context->msn_wlsb, TCP_WLSB_WINDOW);
+		tcp_context->seq_wlsb =
+			c_wlsb_get_field(tcp_context->msn_wlsb, TCP_WLSB_SEQ);
+		tcp_context->ack_wlsb =
+			c_wlsb_get_field(tcp_context->msn_wlsb, TCP_WLSB_ACK);
 	}
+	tcp_context->seq_num = rohc_ntoh32(tcp->seq_num);
+	tcp_context->ack_num = rohc_ntoh32(tcp->ack_num);
 
 	/* IP-ID offset */
 	tcp_context->ip_id_wlsb =
-		c_create_wlsb(16, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
+		c_create_wlsb(slab, 16, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
 	if(tcp_context->ip_id_wlsb == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -955,69 +1108,32 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 		goto free_wlsb_msn;
 	}
 
-	/* innermost IPv4 TTL or IPv6 Hop Limit */
-	tcp_context->ttl_hopl_wlsb =
-		c_create_wlsb(8, comp->wlsb_window_width, ROHC_LSB_SHIFT_TCP_TTL);
-	if(tcp_context->ttl_hopl_wlsb == NULL)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for innermost IPv4 TTL or "
-		           "IPv6 Hop Limit");
-		goto free_wlsb_ip_id;
-	}
-
-	/* TCP window */
-	tcp_context->window_wlsb =
-		c_create_wlsb(16, comp->wlsb_window_width, ROHC_LSB_SHIFT_TCP_WINDOW);
-	if(tcp_context->window_wlsb == NULL)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP window");
-		goto free_wlsb_ttl_hopl;
-	}
-
-	/* TCP sequence number */
-	tcp_context->seq_num = rohc_ntoh32(tcp->seq_num);
-	tcp_context->seq_wlsb =
-		c_create_wlsb(32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
-	if(tcp_context->seq_wlsb == NULL)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP sequence number");
-		goto free_wlsb_window;
-	}
-	tcp_context->seq_scaled_wlsb = c_create_wlsb(32, 4, 7);
+	/* TCP scaled sequence number */
+	tcp_context->seq_scaled_wlsb = c_create_wlsb(slab, 32, 4, 7);
 	if(tcp_context->seq_scaled_wlsb == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		           "failed to create W-LSB context for TCP scaled sequence "
 		           "number");
-		goto free_wlsb_seq;
+		goto free_wlsb_ip_id;
 	}
 
-	/* TCP acknowledgment (ACK) number */
-	tcp_context->ack_num = rohc_ntoh32(tcp->ack_num);
-	tcp_context->ack_wlsb =
-		c_create_wlsb(32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
-	if(tcp_context->ack_wlsb == NULL)
-	{
-		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
-		           "failed to create W-LSB context for TCP ACK number");
-		goto free_wlsb_seq_scaled;
-	}
-	tcp_context->ack_scaled_wlsb = c_create_wlsb(32, 4, 3);
+	/* TCP scaled acknowledgment (ACK) number */
+	tcp_context->ack_scaled_wlsb = c_create_wlsb(slab, 32, 4, 3);
 	if(tcp_context->ack_scaled_wlsb == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		           "failed to create W-LSB context for TCP scaled ACK number");
-		goto free_wlsb_ack;
+		goto free_wlsb_seq_scaled;
 	}
 
 	/* init the Master Sequence Number to a random value */
 	tcp_context->msn = comp->random_cb(comp, comp->random_cb_ctxt) & 0xffff;
 	rohc_comp_debug(context, "MSN = 0x%04x / %u", tcp_context->msn, tcp_context->msn);
 
+	/* the ACK deltas are all 0 at the beginning */
 	tcp_context->ack_stride = 0;
+	tcp_context->ack_stride_count = 20;
 
 	/* init the last list of TCP options */
 	tcp_context->tcp_opts.structure_nr_trans = 0;
@@ -1028,11 +1144,14 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 		tcp_context->tcp_opts.list[i].used = false;
 	}
 
+	/* no TCP option SACK encoded yet */
+	tcp_context->tcp_opts.sack_cache.is_valid = false;
+
 	/* no TCP option Timestamp received yet */
 	tcp_context->tcp_opts.is_timestamp_init = false;
 	/* TCP option Timestamp (request) */
 	tcp_context->tcp_opts.ts_req_wlsb =
-		c_create_wlsb(32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
+		c_create_wlsb(slab, 32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
 	if(tcp_context->tcp_opts.ts_req_wlsb == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -1042,7 +1161,7 @@ static bool c_tcp_create(struct rohc_comp_ctxt *const context,
 	}
 	/* TCP option Timestamp (reply) */
 	tcp_context->tcp_opts.ts_reply_wlsb =
-		c_create_wlsb(32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
+		c_create_wlsb(slab, 32, comp->wlsb_window_width, ROHC_LSB_SHIFT_VAR);
 	if(tcp_context->tcp_opts.ts_reply_wlsb == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -1057,22 +1176,15 @@ free_wlsb_opt_ts_req:
 	c_destroy_wlsb(tcp_context->tcp_opts.ts_req_wlsb);
 free_wlsb_ack_scaled:
 	c_destroy_wlsb(tcp_context->ack_scaled_wlsb);
-free_wlsb_ack:
-	c_destroy_wlsb(tcp_context->ack_wlsb);
 free_wlsb_seq_scaled:
 	c_destroy_wlsb(tcp_context->seq_scaled_wlsb);
-free_wlsb_seq:
-	c_destroy_wlsb(tcp_context->seq_wlsb);
-free_wlsb_window:
-	c_destroy_wlsb(tcp_context->window_wlsb);
-free_wlsb_ttl_hopl:
-	c_destroy_wlsb(tcp_context->ttl_hopl_wlsb);
 free_wlsb_ip_id:
 	c_destroy_wlsb(tcp_context->ip_id_wlsb);
 free_wlsb_msn:
 	c_destroy_wlsb(tcp_context->msn_wlsb);
 free_context:
-	free(tcp_context);
+	c_tcp_put_ip_ctxts(context);
+	rohc_slab_free(tcp_context);
 error:
 	return false;
 }
@@ -1090,14 +1202,53 @@ static void c_tcp_destroy(struct rohc_comp_ctxt *const context)
 	c_destroy_wlsb(tcp_context->tcp_opts.ts_reply_wlsb);
 	c_destroy_wlsb(tcp_context->tcp_opts.ts_req_wlsb);
 	c_destroy_wlsb(tcp_context->ack_scaled_wlsb);
-	c_destroy_wlsb(tcp_context->ack_wlsb);
 	c_destroy_wlsb(tcp_context->seq_scaled_wlsb);
-	c_destroy_wlsb(tcp_context->seq_wlsb);
-	c_destroy_wlsb(tcp_context->window_wlsb);
 	c_destroy_wlsb(tcp_context->ip_id_wlsb);
-	c_destroy_wlsb(tcp_context->ttl_hopl_wlsb);
+	/* the TTL, window, sequence and ACK numbers share the MSN window */
 	c_destroy_wlsb(tcp_context->msn_wlsb);
-	free(tcp_context);
+	c_tcp_put_ip_ctxts(context);
+	if(tcp_context->static_chain != NULL)
+	{
+		rohc_slab_free(tcp_context->static_chain);
+	}
+	rohc_slab_free(tcp_context);
+}
+
+
+/**
+ * @brief Give back the IPv6 addresses of the context to the store and free
+ *        the contexts of the IPv6 extension headers
+ *
+ * @param context  The TCP compression context
+ */
+static void c_tcp_put_ip_ctxts(struct rohc_comp_ctxt *const context)
+{
+	struct sc_tcp_context *const tcp_context = context->specific;
+	size_t ip_hdr_pos;
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < tcp_context->ip_contexts_nr; ip_hdr_pos++)
+	{
+		ip_context_t *const ip_context = &(tcp_context->ip_contexts[ip_hdr_pos]);
+
+		if(ip_context->version == IPV6)
+		{
+			rohc_intern_put(context->compressor->static_store,
+			                ip_context->ctxt.v6.addrs);
+			ip_context->ctxt.v6.addrs = NULL;
+		}
+	}
+
+	/* the IP headers beyond the current ones may have kept their contexts of
+	 * extension headers */
+	for(ip_hdr_pos = 0; ip_hdr_pos < ROHC_TCP_MAX_IP_HDRS; ip_hdr_pos++)
+	{
+		ip_context_t *const ip_context = &(tcp_context->ip_contexts[ip_hdr_pos]);
+
+		if(ip_context->opts != NULL)
+		{
+			rohc_slab_zfree(ip_context->opts);
+		}
+	}
 }
 
 
@@ -1198,7 +1349,7 @@ static bool c_tcp_check_profile(const struct rohc_comp *const comp,
 			}
 
 			/* check if the checksum of the IPv4 header is correct */
-			if((comp->features & ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == 0 &&
+			if((c_features(comp) & ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == 0 &&
 			   ip_fast_csum(remain_data, ipv4_min_words_nr) != 0)
 			{
 				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -1508,36 +1659,47 @@ static bool c_tcp_check_context(const struct rohc_comp_ctxt *const context,
                                 const struct net_pkt *const packet)
 {
 	struct sc_tcp_context *const tcp_context = context->specific;
-	const uint8_t *remain_data = packet->outer_ip.data;
-	size_t remain_len = packet->outer_ip.size;
+	const struct net_pkt_hdrs *const hdrs = &packet->hdrs;
 	size_t ip_hdr_pos;
-	uint8_t next_proto = ROHC_IPPROTO_IPIP;
 	const struct tcphdr *tcp;
 	bool is_tcp_same;
 
-	/* parse the IP headers (lengths already checked while checking profile) */
-	for(ip_hdr_pos = 0;
-	    ip_hdr_pos < tcp_context->ip_contexts_nr && rohc_is_tunneling(next_proto);
-	    ip_hdr_pos++)
+	/* the IP headers were located while parsing the packet (lengths already
+	 * checked while checking profile) */
+	if(!hdrs->is_complete)
 	{
-		const struct ip_hdr *const ip = (struct ip_hdr *) remain_data;
+		rohc_comp_debug(context, "  transport header not found");
+		goto bad_context;
+	}
+	if(hdrs->ip_nr < tcp_context->ip_contexts_nr)
+	{
+		rohc_comp_debug(context, "  less IP headers than context");
+		goto bad_context;
+	}
+	if(hdrs->ip_nr > tcp_context->ip_contexts_nr)
+	{
+		rohc_comp_debug(context, "  more IP headers than context");
+		goto bad_context;
+	}
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < hdrs->ip_nr; ip_hdr_pos++)
+	{
+		const struct net_pkt_ip_hdr *const ip_hdr = &hdrs->ip[ip_hdr_pos];
+		const uint8_t *const ip_data = packet->data + ip_hdr->offset;
 		const ip_context_t *const ip_context = &(tcp_context->ip_contexts[ip_hdr_pos]);
-		size_t ip_ext_pos;
+		const uint8_t next_proto = ip_hdr->next_proto;
 
 		/* retrieve IP version */
-		assert(remain_len >= sizeof(struct ip_hdr));
-		rohc_comp_debug(context, "found IPv%d", ip->version);
-		if(ip->version != ip_context->version)
+		rohc_comp_debug(context, "found IPv%d", ip_hdr->version);
+		if(ip_hdr->version != ip_context->version)
 		{
 			rohc_comp_debug(context, "  not same IP version");
 			goto bad_context;
 		}
 
-		if(ip->version == IPV4)
+		if(ip_hdr->version == IPV4)
 		{
-			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) remain_data;
-
-			assert(remain_len >= sizeof(struct ipv4_hdr));
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip_data;
 
 			/* check source and destination addresses */
 			if(ipv4->saddr != ip_context->ctxt.v4.src_addr ||
@@ -1549,29 +1711,20 @@ static bool c_tcp_check_context(const struct rohc_comp_ctxt *const context,
 			rohc_comp_debug(context, "  same IPv4 addresses");
 
 			/* check transport protocol */
-			next_proto = ipv4->protocol;
 			if(next_proto != ip_context->ctxt.v4.protocol)
 			{
 				rohc_comp_debug(context, "  IPv4 not same protocol");
 				goto bad_context;
 			}
 			rohc_comp_debug(context, "  IPv4 same protocol %d", next_proto);
-
-			/* skip IPv4 header */
-			remain_data += sizeof(struct ipv4_hdr);
-			remain_len -= sizeof(struct ipv4_hdr);
 		}
-		else if(ip->version == IPV6)
+		else if(ip_hdr->version == IPV6)
 		{
-			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) remain_data;
-
-			assert(remain_len >= sizeof(struct ipv6_hdr));
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip_data;
 
 			/* check source and destination addresses */
-			if(memcmp(&ipv6->saddr, ip_context->ctxt.v6.src_addr,
-			          sizeof(struct ipv6_addr)) != 0 ||
-			   memcmp(&ipv6->daddr, ip_context->ctxt.v6.dest_addr,
-			          sizeof(struct ipv6_addr)) != 0)
+			if(memcmp(&ipv6->saddr, ip_context->ctxt.v6.addrs,
+			          sizeof(struct ipv6_addr) * 2) != 0)
 			{
 				rohc_comp_debug(context, "  not same IPv6 addresses");
 				goto bad_context;
@@ -1586,24 +1739,7 @@ static bool c_tcp_check_context(const struct rohc_comp_ctxt *const context,
 			}
 			rohc_comp_debug(context, "  same IPv6 flow label");
 
-			/* skip IPv6 base header */
-			remain_data += sizeof(struct ipv6_hdr);
-			remain_len -= sizeof(struct ipv6_hdr);
-
-			/* find transport header/protocol, skip any IPv6 extension headers */
-			next_proto = ipv6->nh;
-			for(ip_ext_pos = 0; rohc_is_ipv6_opt(next_proto); ip_ext_pos++)
-			{
-				const struct ipv6_opt *const ipv6_opt = (struct ipv6_opt *) remain_data;
-				size_t opt_len;
-				assert(remain_len >= sizeof(struct ipv6_opt));
-				opt_len = ipv6_opt_get_length(ipv6_opt);
-				remain_data += opt_len;
-				remain_len -= opt_len;
-				next_proto = ipv6_opt->next_header;
-			}
-
-			/* check transport header protocol */
+			/* check transport header protocol (IPv6 extension headers skipped) */
 			if(next_proto != ip_context->ctxt.v6.next_header)
 			{
 				rohc_comp_debug(context, "  IPv6 not same protocol %u", next_proto);
@@ -1614,26 +1750,14 @@ static bool c_tcp_check_context(const struct rohc_comp_ctxt *const context,
 		else
 		{
 			rohc_comp_warn(context, "unsupported version %u for header #%zu",
-			               ip->version, ip_hdr_pos + 1);
+			               ip_hdr->version, ip_hdr_pos + 1);
 			assert(0);
 			goto bad_context;
 		}
 	}
 
-	if(ip_hdr_pos < tcp_context->ip_contexts_nr)
-	{
-		rohc_comp_debug(context, "  less IP headers than context");
-		goto bad_context;
-	}
-
-	if(rohc_is_tunneling(next_proto))
-	{
-		rohc_comp_debug(context, "  more IP headers than context");
-		goto bad_context;
-	}
-
-	assert(remain_len >= sizeof(struct tcphdr));
-	tcp = (struct tcphdr *) remain_data;
+	assert((packet->len - hdrs->transport_offset) >= sizeof(struct tcphdr));
+	tcp = (struct tcphdr *) (packet->data + hdrs->transport_offset);
 	is_tcp_same = tcp_context->old_tcphdr.src_port == tcp->src_port &&
 	              tcp_context->old_tcphdr.dst_port == tcp->dst_port;
 	rohc_comp_debug(context, "  TCP %ssame Source and Destination ports",
@@ -1694,32 +1818,55 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 	}
 
 	/* detect changes between new uncompressed packet and context */
+	rohc_perf_begin(context->compressor, ROHC_COMP_PERF_DETECT_CHANGES);
 	if(!tcp_detect_changes(context, uncomp_pkt, &ip_inner_context, &tcp))
 	{
 		rohc_comp_warn(context, "failed to detect changes in uncompressed packet");
 		goto error;
 	}
+	rohc_perf_end(context->compressor, ROHC_COMP_PERF_DETECT_CHANGES);
 
 	/* decide in which state to go */
+	rohc_perf_begin(context->compressor, ROHC_COMP_PERF_DECIDE_STATE);
 	tcp_decide_state(context);
+	rohc_perf_end(context->compressor, ROHC_COMP_PERF_DECIDE_STATE);
 
 	/* compute how many bits are needed to send header fields */
+	rohc_perf_begin(context->compressor, ROHC_COMP_PERF_ENCODE_FIELDS);
 	if(!tcp_encode_uncomp_fields(context, uncomp_pkt, tcp))
 	{
 		rohc_comp_warn(context, "failed to compute how many bits are needed to "
 		               "transmit all changes in header fields");
 		goto error;
 	}
+	rohc_perf_end(context->compressor, ROHC_COMP_PERF_ENCODE_FIELDS);
 
 	/* decide which packet to send */
+	rohc_perf_begin(context->compressor, ROHC_COMP_PERF_DECIDE_PKT);
 	*packet_type = tcp_decide_packet(context, ip_inner_context, tcp);
+	rohc_perf_end(context->compressor, ROHC_COMP_PERF_DECIDE_PKT);
+
+	/* compute the LSB widths the chosen packet relies on, if the decision
+	 * did not need them */
+	tcp_encode_lsb_fields(context, tcp, tcp_get_pkt_lsb_fields(*packet_type));
 
 	/* code the chosen packet */
+	rohc_perf_begin(context->compressor, ROHC_COMP_PERF_CODE_PKT);
 	if((*packet_type) == ROHC_PACKET_UNKNOWN)
 	{
 		rohc_comp_warn(context, "failed to find the packet type to encode");
 		goto error;
 	}
+	else if((*packet_type) == ROHC_PACKET_IR_CR)
+	{
+		counter = code_IR_CR_packet(context, &uncomp_pkt->outer_ip, tcp, rohc_pkt,
+		                            rohc_pkt_max_len, payload_offset);
+		if(counter < 0)
+		{
+			rohc_comp_warn(context, "failed to build IR-CR packet");
+			goto error;
+		}
+	}
 	else if((*packet_type) != ROHC_PACKET_IR &&
 	        (*packet_type) != ROHC_PACKET_IR_DYN)
 	{
@@ -1745,12 +1892,16 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 			goto error;
 		}
 	}
+	rohc_perf_end(context->compressor, ROHC_COMP_PERF_CODE_PKT);
 	rohc_comp_dump_buf(context, "current ROHC packet", rohc_pkt, counter);
 
 	rohc_comp_debug(context, "payload_offset = %zu", *payload_offset);
 
 	rohc_comp_debug(context, "update context:");
 
+	/* add the new values to the W-LSB windows */
+	tcp_update_lsb_windows(context, tcp);
+
 	/* update the context with the new numbers of IP extension headers */
 	{
 		size_t ip_hdr_pos;
@@ -1768,6 +1919,18 @@ static int c_tcp_encode(struct rohc_comp_ctxt *const context,
 	/* update the context with the new TCP header */
 	memcpy(&(tcp_context->old_tcphdr), tcp, sizeof(struct tcphdr));
 	tcp_context->seq_num = rohc_ntoh32(tcp->seq_num);
+
+	/* the connection ends once the FIN or RST flag is sent, only the last ACK
+	 * or retransmissions may follow ; a SYN flag starts a new connection with
+	 * the same ports */
+	if((tcp->rsf_flags & (RSF_RST_ONLY | RSF_FIN_ONLY)) != 0)
+	{
+		context->closed = true;
+	}
+	else if((tcp->rsf_flags & RSF_SYN_ONLY) != 0)
+	{
+		context->closed = false;
+	}
 	tcp_context->ack_num = rohc_ntoh32(tcp->ack_num);
 
 	/* sequence number sent once more, count the number of transmissions to
@@ -1819,25 +1982,26 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
                           const rohc_packet_t packet_type,
                           size_t *const payload_offset)
 {
+	struct sc_tcp_context *const tcp_context = context->specific;
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
 	size_t first_position;
 	size_t crc_position;
 	size_t rohc_hdr_len = 0;
+	size_t static_end = 0;
 	int ret;
 
 	/* parts 1 and 3:
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter'
 	 */
-	ret = code_cid_values(context->compressor->medium.cid_type,
-	                      context->cid, rohc_remain_data, rohc_remain_len,
+	ret = code_cid_values(&(context->cid_hdr), rohc_remain_data, rohc_remain_len,
 	                      &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the %zu-byte "
 		               "ROHC buffer is too small",
-		               context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 		               "small" : "large", context->cid, rohc_remain_len);
 		goto error;
 	}
@@ -1845,7 +2009,7 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	rohc_remain_len -= ret;
 	rohc_hdr_len += ret;
 	rohc_comp_debug(context, "%s CID %zu encoded on %d byte(s)",
-	                context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+	                c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 	                "small" : "large", context->cid, ret - 1);
 
 	/* type of packet */
@@ -1884,8 +2048,27 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	rohc_remain_len--;
 	rohc_hdr_len++;
 
-	/* add static chain for IR packet only */
-	if(packet_type == ROHC_PACKET_IR)
+	/* add static chain for IR packet only: it is built by the first IR packet
+	 * then copied with the CRC of the IR header so far */
+	if(packet_type == ROHC_PACKET_IR && tcp_context->static_chain != NULL &&
+	   tcp_context->static_chain->len > 0)
+	{
+		const struct sc_tcp_static_chain *const static_chain =
+			tcp_context->static_chain;
+
+		if(rohc_remain_len < static_chain->len)
+		{
+			rohc_comp_warn(context, "ROHC buffer too small for the %zu-byte "
+			               "static chain", static_chain->len);
+			goto error;
+		}
+		memcpy(rohc_remain_data, static_chain->data, static_chain->len);
+		rohc_remain_data += static_chain->len;
+		rohc_remain_len -= static_chain->len;
+		rohc_hdr_len += static_chain->len;
+		static_end = rohc_hdr_len;
+	}
+	else if(packet_type == ROHC_PACKET_IR)
 	{
 		ret = tcp_code_static_part(context, ip, rohc_remain_data, rohc_remain_len);
 		if(ret < 0)
@@ -1894,6 +2077,24 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 			               "IR(-DYN) packet");
 			goto error;
 		}
+		/* the static chain of many IP headers is not worth caching, the
+		 * static chain is built again if no memory is available to cache it */
+		if(((size_t) ret) <= C_TCP_STATIC_CHAIN_MAX_LEN &&
+		   tcp_context->static_chain == NULL)
+		{
+			tcp_context->static_chain =
+				rohc_slab_alloc(context->compressor->ctxt_slab,
+				                sizeof(struct sc_tcp_static_chain));
+		}
+		if(((size_t) ret) <= C_TCP_STATIC_CHAIN_MAX_LEN &&
+		   tcp_context->static_chain != NULL)
+		{
+			memcpy(tcp_context->static_chain->data, rohc_remain_data, ret);
+			tcp_context->static_chain->len = ret;
+			tcp_context->static_chain->crc =
+				crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, rohc_hdr_len + ret,
+				              CRC_INIT_8, rohc_crc_table_8);
+		}
 		rohc_remain_data += ret;
 		rohc_remain_len -= ret;
 		rohc_hdr_len += ret;
@@ -1919,9 +2120,23 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	                   rohc_pkt, rohc_hdr_len);
 
 	/* IR(-DYN) header was successfully built, compute the CRC */
-	rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt,
-	                                       rohc_hdr_len, CRC_INIT_8,
-	                                       context->compressor->crc_table_8);
+	if((c_features(context->compressor) & ROHC_COMP_FEATURE_ESTIMATE) != 0)
+	{
+		/* the packets are only sized in estimate mode */
+	}
+	else if(static_end > 0)
+	{
+		rohc_pkt[crc_position] =
+			crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt + static_end,
+			              rohc_hdr_len - static_end, tcp_context->static_chain->crc,
+			              rohc_crc_table_8);
+	}
+	else
+	{
+		rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt,
+		                                       rohc_hdr_len, CRC_INIT_8,
+		                                       rohc_crc_table_8);
+	}
 	rohc_comp_debug(context, "CRC (header length = %zu, crc = 0x%x)",
 	                rohc_hdr_len, rohc_pkt[crc_position]);
 
@@ -1936,31 +2151,189 @@ error:
 
 
 /**
- * @brief Code the static part of an IR packet
+ * @brief Encode an IP/TCP packet as IR-CR packet
+ *
+ * The IR-CR packet replicates the static part of the base context chosen by
+ * \ref tcp_find_replicate_base: only the TCP ports and the dynamic chain are
+ * transmitted. See \ref d_tcp_parse_ir_cr for the format of the packet.
  *
  * @param context           The compression context
  * @param ip                The outer IP header
+ * @param tcp               The TCP header
  * @param rohc_pkt          OUT: The ROHC packet
  * @param rohc_pkt_max_len  The maximum length of the ROHC packet
+ * @param payload_offset    OUT: The offset for the payload in the IP packet
  * @return                  The length of the ROHC packet if successful,
  *                          -1 otherwise
  */
-static int tcp_code_static_part(struct rohc_comp_ctxt *const context,
-                                const struct ip_packet *const ip,
-                                uint8_t *const rohc_pkt,
-                                const size_t rohc_pkt_max_len)
+static int code_IR_CR_packet(struct rohc_comp_ctxt *const context,
+                             const struct ip_packet *const ip,
+                             const struct tcphdr *const tcp,
+                             uint8_t *const rohc_pkt,
+                             const size_t rohc_pkt_max_len,
+                             size_t *const payload_offset)
 {
-	struct sc_tcp_context *const tcp_context = context->specific;
-
-	const uint8_t *remain_data = ip->data;
-	size_t remain_len = ip->size;
-
+	const struct sc_tcp_context *const tcp_context = context->specific;
+	const rohc_cid_t base_cid = tcp_context->tmp.replicate_base_cid;
 	uint8_t *rohc_remain_data = rohc_pkt;
 	size_t rohc_remain_len = rohc_pkt_max_len;
+	size_t first_position;
+	size_t crc_position;
+	size_t crc7_position;
+	size_t rohc_hdr_len = 0;
+	int ret;
+
+	ret = code_cid_values(&(context->cid_hdr), rohc_remain_data, rohc_remain_len,
+	                      &first_position);
+	if(ret < 1)
+	{
+		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the %zu-byte "
+		               "ROHC buffer is too small",
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
+		               "small" : "large", context->cid, rohc_remain_len);
+		goto error;
+	}
+	rohc_remain_data += ret;
+	rohc_remain_len -= ret;
+	rohc_hdr_len += ret;
+
+	/* type of packet */
+	rohc_pkt[first_position] = ROHC_PACKET_TYPE_IR_CR;
+	rohc_comp_debug(context, "packet type = 0x%02x", rohc_pkt[first_position]);
+
+	/* enough room for profile ID, CRC, B flag + CRC7 and base CID? */
+	if(rohc_remain_len < 5)
+	{
+		rohc_comp_warn(context, "ROHC buffer too small for IR-CR packet: "
+		               "5 bytes required for profile ID, CRCs and base CID, but "
+		               "only %zu bytes available", rohc_remain_len);
+		goto error;
+	}
+
+	/* profile ID */
+	rohc_remain_data[0] = context->profile->id;
+	rohc_remain_data++;
+	rohc_remain_len--;
+	rohc_hdr_len++;
+
+	/* the CRC is computed later since it must be computed over the whole packet
+	 * with an empty CRC field */
+	crc_position = rohc_hdr_len;
+	rohc_remain_data[0] = 0;
+	rohc_remain_data++;
+	rohc_remain_len--;
+	rohc_hdr_len++;
+
+	/* B flag is always set, the CRC7 is computed later since it covers the
+	 * uncompressed headers */
+	crc7_position = rohc_hdr_len;
+	rohc_remain_data[0] = 0x80;
+	rohc_remain_data++;
+	rohc_remain_len--;
+	rohc_hdr_len++;
+
+	/* base CID */
+	if(c_cid_type(context->compressor) == ROHC_SMALL_CID)
+	{
+		assert(base_cid <= ROHC_SMALL_CID_MAX);
+		rohc_remain_data[0] = base_cid & 0x0f;
+		ret = 1;
+	}
+	else
+	{
+		size_t base_cid_len;
+
+		if(!sdvl_encode_full(rohc_remain_data, rohc_remain_len, &base_cid_len,
+		                     base_cid))
+		{
+			rohc_comp_warn(context, "failed to SDVL-encode the large base CID %zu",
+			               base_cid);
+			goto error;
+		}
+		ret = base_cid_len;
+	}
+	rohc_comp_debug(context, "base CID %zu encoded on %d byte(s)", base_cid, ret);
+	rohc_remain_data += ret;
+	rohc_remain_len -= ret;
+	rohc_hdr_len += ret;
+
+	/* TCP ports, the only static fields that are not replicated */
+	ret = tcp_code_static_tcp_part(context, tcp, rohc_remain_data, rohc_remain_len);
+	if(ret < 0)
+	{
+		rohc_comp_warn(context, "failed to build the TCP ports of the IR-CR "
+		               "packet");
+		goto error;
+	}
+	rohc_remain_data += ret;
+	rohc_remain_len -= ret;
+	rohc_hdr_len += ret;
+
+	/* add dynamic chain */
+	ret = tcp_code_dyn_part(context, ip, rohc_remain_data,
+	                        rohc_remain_len, payload_offset);
+	if(ret < 0)
+	{
+		rohc_comp_warn(context, "failed to build the dynamic chain of the "
+		               "IR-CR packet");
+		goto error;
+	}
+#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
+	rohc_remain_data += ret;
+	rohc_remain_len -= ret;
+#endif
+	rohc_hdr_len += ret;
+
+	/* the CRC7 covers the uncompressed headers, then the CRC covers the IR-CR
+	 * header with the CRC7 */
+	if((c_features(context->compressor) & ROHC_COMP_FEATURE_ESTIMATE) == 0)
+	{
+		rohc_pkt[crc7_position] |=
+			crc_calculate(ROHC_CRC_TYPE_7, ip->data, *payload_offset, CRC_INIT_7,
+			              rohc_crc_table_7);
+		rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt,
+		                                       rohc_hdr_len, CRC_INIT_8,
+		                                       rohc_crc_table_8);
+	}
+	rohc_comp_debug(context, "CRC7 = 0x%02x, CRC = 0x%02x",
+	                rohc_pkt[crc7_position] & 0x7f, rohc_pkt[crc_position]);
+
+	rohc_comp_debug(context, "IR-CR packet, length %zu", rohc_hdr_len);
+	rohc_comp_dump_buf(context, "current ROHC packet", rohc_pkt, rohc_hdr_len);
+
+	return rohc_hdr_len;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Code the static part of an IR packet
+ *
+ * @param context           The compression context
+ * @param ip                The outer IP header
+ * @param rohc_pkt          OUT: The ROHC packet
+ * @param rohc_pkt_max_len  The maximum length of the ROHC packet
+ * @return                  The length of the ROHC packet if successful,
+ *                          -1 otherwise
+ */
+static int tcp_code_static_part(struct rohc_comp_ctxt *const context,
+                                const struct ip_packet *const ip,
+                                uint8_t *const rohc_pkt,
+                                const size_t rohc_pkt_max_len)
+{
+	struct sc_tcp_context *const tcp_context = context->specific;
+
+	const uint8_t *remain_data = ip->data;
+	size_t remain_len = ip->size;
+
+	uint8_t *rohc_remain_data = rohc_pkt;
+	size_t rohc_remain_len = rohc_pkt_max_len;
+
+	size_t ip_hdr_pos;
+	int ret;
 
-	size_t ip_hdr_pos;
-	int ret;
-
 	/* add IP parts of static chain */
 	for(ip_hdr_pos = 0; ip_hdr_pos < tcp_context->ip_contexts_nr; ip_hdr_pos++)
 	{
@@ -3526,19 +3899,24 @@ static int code_CO_packet(struct rohc_comp_ctxt *const context,
 
 	/* we have just identified the IP and TCP headers (options included), so
 	 * let's compute the CRC on uncompressed headers */
-	if(packet_type == ROHC_PACKET_TCP_SEQ_8 ||
-	   packet_type == ROHC_PACKET_TCP_RND_8 ||
-	   packet_type == ROHC_PACKET_TCP_CO_COMMON)
+	if((c_features(context->compressor) & ROHC_COMP_FEATURE_ESTIMATE) != 0)
+	{
+		/* the packets are only sized in estimate mode */
+		crc_computed = 0;
+	}
+	else if(packet_type == ROHC_PACKET_TCP_SEQ_8 ||
+	        packet_type == ROHC_PACKET_TCP_RND_8 ||
+	        packet_type == ROHC_PACKET_TCP_CO_COMMON)
 	{
 		crc_computed = crc_calculate(ROHC_CRC_TYPE_7, ip->data, *payload_offset,
-		                             CRC_INIT_7, context->compressor->crc_table_7);
+		                             CRC_INIT_7, rohc_crc_table_7);
 		rohc_comp_debug(context, "CRC-7 on %zu-byte uncompressed header = 0x%x",
 		                *payload_offset, crc_computed);
 	}
 	else
 	{
 		crc_computed = crc_calculate(ROHC_CRC_TYPE_3, ip->data, *payload_offset,
-		                             CRC_INIT_3, context->compressor->crc_table_3);
+		                             CRC_INIT_3, rohc_crc_table_3);
 		rohc_comp_debug(context, "CRC-3 on %zu-byte uncompressed header = 0x%x",
 		                *payload_offset, crc_computed);
 	}
@@ -3546,13 +3924,13 @@ static int code_CO_packet(struct rohc_comp_ctxt *const context,
 	/* write Add-CID or large CID bytes: 'pos_1st_byte' indicates the location
 	 * where first header byte shall be written, 'pos_2nd_byte' indicates the
 	 * location where the next header bytes shall be written */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
+	ret = code_cid_values(&(context->cid_hdr),
 	                      rohc_remain_data, rohc_remain_len, &pos_1st_byte);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
 		               "%zu-byte ROHC buffer is too small",
-		               context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 		               "small" : "large", context->cid, rohc_remain_len);
 		goto error;
 	}
@@ -3560,7 +3938,7 @@ static int code_CO_packet(struct rohc_comp_ctxt *const context,
 	rohc_remain_data += ret;
 	rohc_remain_len -= ret;
 	rohc_comp_debug(context, "%s CID %zu encoded on %d byte(s)",
-	                context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+	                c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 	                "small" : "large", context->cid, ret - 1);
 
 	/* The CO headers are written as a contiguous block. There is a problem in
@@ -3600,7 +3978,7 @@ static int code_CO_packet(struct rohc_comp_ctxt *const context,
 	rohc_remain_len -= ret;
 
 	/* end of workaround: restore the saved octet */
-	if(context->compressor->medium.cid_type != ROHC_SMALL_CID)
+	if(c_cid_type(context->compressor) != ROHC_SMALL_CID)
 	{
 		rohc_pkt[pos_1st_byte] = rohc_pkt[pos_2nd_byte - 1];
 		rohc_pkt[pos_2nd_byte - 1] = save_first_byte;
@@ -3793,7 +4171,7 @@ static int c_tcp_build_rnd_1(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_1_t *const rnd1 = (rnd_1_t *) rohc_data;
+	struct rohc_bit_writer writer;
 	uint32_t seq_num;
 
 	if(rohc_max_len < sizeof(rnd_1_t))
@@ -3804,15 +4182,15 @@ static int c_tcp_build_rnd_1(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	rnd1->discriminator = 0x2e; /* '101110' */
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x2e, 6); /* discriminator '101110' */
 	seq_num = rohc_ntoh32(tcp->seq_num) & 0x3ffff;
-	rnd1->seq_num1 = (seq_num >> 16) & 0x3;
-	rnd1->seq_num2 = rohc_hton16(seq_num & 0xffff);
-	rnd1->msn = tcp_context->msn & 0xf;
-	rnd1->psh_flag = tcp->psh_flag;
-	rnd1->header_crc = crc;
+	rohc_bit_write(&writer, seq_num, 18);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
+	rohc_bit_write(&writer, crc, 3);
 
-	return sizeof(rnd_1_t);
+	return rohc_bit_writer_finish(&writer);
 
 error:
 	return -1;
@@ -3841,7 +4219,7 @@ static int c_tcp_build_rnd_2(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_2_t *const rnd2 = (rnd_2_t *) rohc_data;
+	struct rohc_bit_writer writer;
 
 	if(rohc_max_len < sizeof(rnd_2_t))
 	{
@@ -3851,13 +4229,14 @@ static int c_tcp_build_rnd_2(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	rnd2->discriminator = 0x0c; /* '1100' */
-	rnd2->seq_num_scaled = tcp_context->seq_num_scaled & 0xf;
-	rnd2->msn = tcp_context->msn & 0xf;
-	rnd2->psh_flag = tcp->psh_flag;
-	rnd2->header_crc = crc;
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x0c, 4); /* discriminator '1100' */
+	rohc_bit_write(&writer, tcp_context->seq_num_scaled, 4);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
+	rohc_bit_write(&writer, crc, 3);
 
-	return sizeof(rnd_2_t);
+	return rohc_bit_writer_finish(&writer);
 
 error:
 	return -1;
@@ -3886,7 +4265,7 @@ static int c_tcp_build_rnd_3(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_3_t *const rnd3 = (rnd_3_t *) rohc_data;
+	struct rohc_bit_writer writer;
 	uint16_t ack_num;
 
 	if(rohc_max_len < sizeof(rnd_3_t))
@@ -3897,17 +4276,16 @@ static int c_tcp_build_rnd_3(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	rnd3->discriminator = 0x0; /* '0' */
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x0, 1); /* discriminator '0' */
 	ack_num = rohc_ntoh32(tcp->ack_num) & 0x7fff;
-	rnd3->ack_num1 = (ack_num >> 8) & 0x7f;
-	rnd3->ack_num2 = ack_num & 0xff;
-	rohc_comp_debug(context, "ack_number = 0x%04x (0x%02x 0x%02x)",
-	                ack_num, rnd3->ack_num1, rnd3->ack_num2);
-	rnd3->msn = tcp_context->msn & 0xf;
-	rnd3->psh_flag = tcp->psh_flag;
-	rnd3->header_crc = crc;
+	rohc_comp_debug(context, "ack_number = 0x%04x", ack_num);
+	rohc_bit_write(&writer, ack_num, 15);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
+	rohc_bit_write(&writer, crc, 3);
 
-	return sizeof(rnd_3_t);
+	return rohc_bit_writer_finish(&writer);
 
 error:
 	return -1;
@@ -3936,7 +4314,7 @@ static int c_tcp_build_rnd_4(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_4_t *const rnd4 = (rnd_4_t *) rohc_data;
+	struct rohc_bit_writer writer;
 
 	assert(tcp_context->ack_stride != 0);
 
@@ -3948,13 +4326,14 @@ static int c_tcp_build_rnd_4(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	rnd4->discriminator = 0x0d; /* '1101' */
-	rnd4->ack_num_scaled = tcp_context->ack_num_scaled & 0xf;
-	rnd4->msn = tcp_context->msn & 0xf;
-	rnd4->psh_flag = tcp->psh_flag;
-	rnd4->header_crc = crc;
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x0d, 4); /* discriminator '1101' */
+	rohc_bit_write(&writer, tcp_context->ack_num_scaled, 4);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
+	rohc_bit_write(&writer, crc, 3);
 
-	return sizeof(rnd_4_t);
+	return rohc_bit_writer_finish(&writer);
 
 error:
 	return -1;
@@ -3983,7 +4362,7 @@ static int c_tcp_build_rnd_5(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_5_t *const rnd5 = (rnd_5_t *) rohc_data;
+	struct rohc_bit_writer writer;
 	uint16_t seq_num;
 	uint16_t ack_num;
 
@@ -3995,27 +4374,23 @@ static int c_tcp_build_rnd_5(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	rnd5->discriminator = 0x04; /* '100' */
-	rnd5->psh_flag = tcp->psh_flag;
-	rnd5->msn = tcp_context->msn & 0xf;
-	rnd5->header_crc = crc;
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x04, 3); /* discriminator '100' */
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, crc, 3);
 
 	/* sequence number */
 	seq_num = rohc_ntoh32(tcp->seq_num) & 0x3fff;
-	rnd5->seq_num1 = (seq_num >> 9) & 0x1f;
-	rnd5->seq_num2 = (seq_num >> 1) & 0xff;
-	rnd5->seq_num3 = seq_num & 0x01;
-	rohc_comp_debug(context, "seq_number = 0x%04x (0x%02x 0x%02x 0x%02x)",
-	                seq_num, rnd5->seq_num1, rnd5->seq_num2, rnd5->seq_num3);
+	rohc_comp_debug(context, "seq_number = 0x%04x", seq_num);
+	rohc_bit_write(&writer, seq_num, 14);
 
 	/* ACK number */
 	ack_num = rohc_ntoh32(tcp->ack_num) & 0x7fff;
-	rnd5->ack_num1 = (ack_num >> 8) & 0x7f;
-	rnd5->ack_num2 = ack_num & 0xff;
-	rohc_comp_debug(context, "ack_number = 0x%04x (0x%02x 0x%02x)",
-	                ack_num, rnd5->ack_num1, rnd5->ack_num2);
+	rohc_comp_debug(context, "ack_number = 0x%04x", ack_num);
+	rohc_bit_write(&writer, ack_num, 15);
 
-	return sizeof(rnd_5_t);
+	return rohc_bit_writer_finish(&writer);
 
 error:
 	return -1;
@@ -4044,7 +4419,7 @@ static int c_tcp_build_rnd_6(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_6_t *const rnd6 = (rnd_6_t *) rohc_data;
+	struct rohc_bit_writer writer;
 
 	if(rohc_max_len < sizeof(rnd_6_t))
 	{
@@ -4054,14 +4429,15 @@ static int c_tcp_build_rnd_6(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	rnd6->discriminator = 0x0a; /* '1010' */
-	rnd6->header_crc = crc;
-	rnd6->psh_flag = tcp->psh_flag;
-	rnd6->ack_num = rohc_hton16(rohc_ntoh32(tcp->ack_num) & 0xffff);
-	rnd6->msn = tcp_context->msn & 0xf;
-	rnd6->seq_num_scaled = tcp_context->seq_num_scaled & 0xf;
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x0a, 4); /* discriminator '1010' */
+	rohc_bit_write(&writer, crc, 3);
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
+	rohc_bit_write(&writer, rohc_ntoh32(tcp->ack_num), 16);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, tcp_context->seq_num_scaled, 4);
 
-	return sizeof(rnd_6_t);
+	return rohc_bit_writer_finish(&writer);
 
 error:
 	return -1;
@@ -4090,7 +4466,7 @@ static int c_tcp_build_rnd_7(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_7_t *const rnd7 = (rnd_7_t *) rohc_data;
+	struct rohc_bit_writer writer;
 	uint32_t ack_num;
 
 	if(rohc_max_len < sizeof(rnd_7_t))
@@ -4101,16 +4477,16 @@ static int c_tcp_build_rnd_7(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	rnd7->discriminator = 0x2f; /* '101111' */
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x2f, 6); /* discriminator '101111' */
 	ack_num = rohc_ntoh32(tcp->ack_num) & 0x3ffff;
-	rnd7->ack_num1 = (ack_num >> 16) & 0x03;
-	rnd7->ack_num2 = rohc_hton16(ack_num & 0xffff);
-	rnd7->window = tcp->window;
-	rnd7->msn = tcp_context->msn & 0xf;
-	rnd7->psh_flag = tcp->psh_flag;
-	rnd7->header_crc = crc;
+	rohc_bit_write(&writer, ack_num, 18);
+	rohc_bit_write(&writer, rohc_ntoh16(tcp->window), 16);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
+	rohc_bit_write(&writer, crc, 3);
 
-	return sizeof(rnd_7_t);
+	return rohc_bit_writer_finish(&writer);
 
 error:
 	return -1;
@@ -4145,11 +4521,12 @@ static int c_tcp_build_rnd_8(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	rnd_8_t *const rnd8 = (rnd_8_t *) rohc_data;
+	struct rohc_bit_writer writer;
+	bool is_list_present;
+	size_t rnd_8_len;
 	uint32_t seq_num;
 	size_t comp_opts_len;
 	uint8_t ttl_hl;
-	uint8_t msn;
 	int ret;
 
 	if(rohc_max_len < sizeof(rnd_8_t))
@@ -4160,18 +4537,20 @@ static int c_tcp_build_rnd_8(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	rnd8->discriminator = 0x16; /* '10110' */
-	rnd8->rsf_flags = rsf_index_enc(tcp->rsf_flags);
-	rnd8->list_present = 0; /* options are set later */
-	rnd8->header_crc = crc;
-	rohc_comp_debug(context, "CRC 0x%x", rnd8->header_crc);
-
-	/* MSN */
-	msn = tcp_context->msn & 0xf;
-	rnd8->msn1 = (msn >> 3) & 0x01;
-	rnd8->msn2 = msn & 0x07;
-
-	rnd8->psh_flag = tcp->psh_flag;
+	/* include the list of TCP options if the structure of the list changed
+	 * or if some static options changed (irregular chain cannot transmit
+	 * static options) */
+	is_list_present = (tcp_context->tcp_opts.tmp.do_list_struct_changed ||
+	                   tcp_context->tcp_opts.tmp.do_list_static_changed);
+
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x16, 5); /* discriminator '10110' */
+	rohc_bit_write(&writer, rsf_index_enc(tcp->rsf_flags), 2);
+	rohc_bit_write(&writer, rohc_b2u(is_list_present), 1);
+	rohc_comp_debug(context, "CRC 0x%x", crc);
+	rohc_bit_write(&writer, crc, 7);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
 
 	/* TTL/HL */
 	assert(inner_ip_hdr_len >= 1);
@@ -4190,30 +4569,26 @@ static int c_tcp_build_rnd_8(const struct rohc_comp_ctxt *const context,
 		assert(inner_ip_ctxt->ctxt.vx.version == IPV6);
 		ttl_hl = ipv6->hl;
 	}
-	rnd8->ttl_hopl = ttl_hl & 0x7;
-	rnd8->ecn_used = GET_REAL(tcp_context->ecn_used);
+	rohc_bit_write(&writer, ttl_hl, 3);
+	rohc_bit_write(&writer, GET_REAL(tcp_context->ecn_used), 1);
 
 	/* sequence number */
 	seq_num = rohc_ntoh32(tcp->seq_num) & 0xffff;
-	rnd8->seq_num = rohc_hton16(seq_num);
 	rohc_comp_debug(context, "16 bits of sequence number = 0x%04x", seq_num);
+	rohc_bit_write(&writer, seq_num, 16);
 
 	/* ACK number */
-	rnd8->ack_num = rohc_hton16(rohc_ntoh32(tcp->ack_num) & 0xffff);
+	rohc_bit_write(&writer, rohc_ntoh32(tcp->ack_num), 16);
+	rnd_8_len = rohc_bit_writer_finish(&writer);
 
-	/* include the list of TCP options if the structure of the list changed
-	 * or if some static options changed (irregular chain cannot transmit
-	 * static options) */
-	if(tcp_context->tcp_opts.tmp.do_list_struct_changed ||
-	   tcp_context->tcp_opts.tmp.do_list_static_changed)
+	if(is_list_present)
 	{
 		/* the structure of the list of TCP options changed or at least one of
 		 * the static option changed, compress them */
-		rnd8->list_present = 1;
 		ret = c_tcp_code_tcp_opts_list_item(context, tcp, tcp_context->msn,
 		                                    false, &tcp_context->tcp_opts,
-		                                    rnd8->options,
-		                                    rohc_max_len - sizeof(rnd_8_t));
+		                                    rohc_data + rnd_8_len,
+		                                    rohc_max_len - rnd_8_len);
 		if(ret < 0)
 		{
 			rohc_comp_warn(context, "failed to compress TCP options");
@@ -4225,11 +4600,10 @@ static int c_tcp_build_rnd_8(const struct rohc_comp_ctxt *const context,
 	{
 		/* the structure of the list of TCP options didn't change */
 		rohc_comp_debug(context, "compressed list of TCP options: list not present");
-		rnd8->list_present = 0;
 		comp_opts_len = 0;
 	}
 
-	return (sizeof(rnd_8_t) + comp_opts_len);
+	return (rnd_8_len + comp_opts_len);
 
 error:
 	return -1;
@@ -4264,7 +4638,7 @@ static int c_tcp_build_seq_1(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_1_t *const seq1 = (seq_1_t *) rohc_data;
+	struct rohc_bit_writer writer;
 	uint32_t seq_num;
 
 	assert(inner_ip_ctxt->ctxt.vx.version == IPV4);
@@ -4279,16 +4653,18 @@ static int c_tcp_build_seq_1(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	seq1->discriminator = 0x0a; /* '1010' */
-	seq1->ip_id = tcp_context->tmp.ip_id_delta & 0x0f;
-	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x", seq1->ip_id);
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x0a, 4); /* discriminator '1010' */
+	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x",
+	                tcp_context->tmp.ip_id_delta & 0x0f);
+	rohc_bit_write(&writer, tcp_context->tmp.ip_id_delta, 4);
 	seq_num = rohc_ntoh32(tcp->seq_num) & 0xffff;
-	seq1->seq_num = rohc_hton16(seq_num);
-	seq1->msn = tcp_context->msn & 0xf;
-	seq1->psh_flag = tcp->psh_flag;
-	seq1->header_crc = crc;
+	rohc_bit_write(&writer, seq_num, 16);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
+	rohc_bit_write(&writer, crc, 3);
 
-	return sizeof(seq_1_t);
+	return rohc_bit_writer_finish(&writer);
 
 error:
 	return -1;
@@ -4323,7 +4699,7 @@ static int c_tcp_build_seq_2(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_2_t *const seq2 = (seq_2_t *) rohc_data;
+	struct rohc_bit_writer writer;
 
 	assert(inner_ip_ctxt->ctxt.vx.version == IPV4);
 	assert(inner_ip_hdr_len >= sizeof(struct ipv4_hdr));
@@ -4337,16 +4713,17 @@ static int c_tcp_build_seq_2(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	seq2->discriminator = 0x1a; /* '11010' */
-	seq2->ip_id1 = (tcp_context->tmp.ip_id_delta >> 4) & 0x7;
-	seq2->ip_id2 = tcp_context->tmp.ip_id_delta & 0xf;
-	rohc_comp_debug(context, "7-bit IP-ID offset 0x%x%x", seq2->ip_id1, seq2->ip_id2);
-	seq2->seq_num_scaled = tcp_context->seq_num_scaled & 0xf;
-	seq2->msn = tcp_context->msn & 0xf;
-	seq2->psh_flag = tcp->psh_flag;
-	seq2->header_crc = crc;
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x1a, 5); /* discriminator '11010' */
+	rohc_comp_debug(context, "7-bit IP-ID offset 0x%x",
+	                tcp_context->tmp.ip_id_delta & 0x7f);
+	rohc_bit_write(&writer, tcp_context->tmp.ip_id_delta, 7);
+	rohc_bit_write(&writer, tcp_context->seq_num_scaled, 4);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
+	rohc_bit_write(&writer, crc, 3);
 
-	return sizeof(seq_2_t);
+	return rohc_bit_writer_finish(&writer);
 
 error:
 	return -1;
@@ -4381,7 +4758,7 @@ static int c_tcp_build_seq_3(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_3_t *const seq3 = (seq_3_t *) rohc_data;
+	struct rohc_bit_writer writer;
 
 	assert(inner_ip_ctxt->ctxt.vx.version == IPV4);
 	assert(inner_ip_hdr_len >= sizeof(struct ipv4_hdr));
@@ -4395,15 +4772,17 @@ static int c_tcp_build_seq_3(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	seq3->discriminator = 0x09; /* '1001' */
-	seq3->ip_id = tcp_context->tmp.ip_id_delta & 0xf;
-	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x", seq3->ip_id);
-	seq3->ack_num = rohc_hton16(rohc_ntoh32(tcp->ack_num) & 0xffff);
-	seq3->msn = tcp_context->msn & 0xf;
-	seq3->psh_flag = tcp->psh_flag;
-	seq3->header_crc = crc;
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x09, 4); /* discriminator '1001' */
+	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x",
+	                tcp_context->tmp.ip_id_delta & 0xf);
+	rohc_bit_write(&writer, tcp_context->tmp.ip_id_delta, 4);
+	rohc_bit_write(&writer, rohc_ntoh32(tcp->ack_num), 16);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
+	rohc_bit_write(&writer, crc, 3);
 
-	return sizeof(seq_3_t);
+	return rohc_bit_writer_finish(&writer);
 
 error:
 	return -1;
@@ -4438,7 +4817,7 @@ static int c_tcp_build_seq_4(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_4_t *const seq4 = (seq_4_t *) rohc_data;
+	struct rohc_bit_writer writer;
 
 	assert(inner_ip_ctxt->ctxt.vx.version == IPV4);
 	assert(inner_ip_hdr_len >= sizeof(struct ipv4_hdr));
@@ -4453,15 +4832,17 @@ static int c_tcp_build_seq_4(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	seq4->discriminator = 0x00; /* '0' */
-	seq4->ack_num_scaled = tcp_context->ack_num_scaled & 0xf;
-	seq4->ip_id = tcp_context->tmp.ip_id_delta & 0x7;
-	rohc_comp_debug(context, "3-bit IP-ID offset 0x%x", seq4->ip_id);
-	seq4->msn = tcp_context->msn & 0xf;
-	seq4->psh_flag = tcp->psh_flag;
-	seq4->header_crc = crc;
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x00, 1); /* discriminator '0' */
+	rohc_bit_write(&writer, tcp_context->ack_num_scaled, 4);
+	rohc_comp_debug(context, "3-bit IP-ID offset 0x%x",
+	                tcp_context->tmp.ip_id_delta & 0x7);
+	rohc_bit_write(&writer, tcp_context->tmp.ip_id_delta, 3);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
+	rohc_bit_write(&writer, crc, 3);
 
-	return sizeof(seq_4_t);
+	return rohc_bit_writer_finish(&writer);
 
 error:
 	return -1;
@@ -4496,7 +4877,7 @@ static int c_tcp_build_seq_5(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_5_t *const seq5 = (seq_5_t *) rohc_data;
+	struct rohc_bit_writer writer;
 	uint32_t seq_num;
 
 	assert(inner_ip_ctxt->ctxt.vx.version == IPV4);
@@ -4511,17 +4892,19 @@ static int c_tcp_build_seq_5(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	seq5->discriminator = 0x08; /* '1000' */
-	seq5->ip_id = tcp_context->tmp.ip_id_delta & 0xf;
-	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x", seq5->ip_id);
-	seq5->ack_num = rohc_hton16(rohc_ntoh32(tcp->ack_num) & 0xffff);
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x08, 4); /* discriminator '1000' */
+	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x",
+	                tcp_context->tmp.ip_id_delta & 0xf);
+	rohc_bit_write(&writer, tcp_context->tmp.ip_id_delta, 4);
+	rohc_bit_write(&writer, rohc_ntoh32(tcp->ack_num), 16);
 	seq_num = rohc_ntoh32(tcp->seq_num) & 0xffff;
-	seq5->seq_num = rohc_hton16(seq_num);
-	seq5->msn = tcp_context->msn & 0xf;
-	seq5->psh_flag = tcp->psh_flag;
-	seq5->header_crc = crc;
+	rohc_bit_write(&writer, seq_num, 16);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
+	rohc_bit_write(&writer, crc, 3);
 
-	return sizeof(seq_5_t);
+	return rohc_bit_writer_finish(&writer);
 
 error:
 	return -1;
@@ -4555,8 +4938,7 @@ static int c_tcp_build_seq_6(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_6_t *const seq6 = (seq_6_t *) rohc_data;
-	uint8_t seq_num_scaled;
+	struct rohc_bit_writer writer;
 
 	assert(inner_ip_ctxt->ctxt.vx.version == IPV4);
 	assert(inner_ip_hdr_len >= sizeof(struct ipv4_hdr));
@@ -4570,22 +4952,18 @@ static int c_tcp_build_seq_6(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	seq6->discriminator = 0x1b; /* '11011' */
-
-	/* scaled sequence number */
-	seq_num_scaled = tcp_context->seq_num_scaled & 0xf;
-	seq6->seq_num_scaled1 = (seq_num_scaled >> 1) & 0x07;
-	seq6->seq_num_scaled2 = seq_num_scaled & 0x01;
-
-	/* IP-ID */
-	seq6->ip_id = tcp_context->tmp.ip_id_delta & 0x7f;
-	rohc_comp_debug(context, "7-bit IP-ID offset 0x%x", seq6->ip_id);
-	seq6->ack_num = rohc_hton16(rohc_ntoh32(tcp->ack_num) & 0xffff);
-	seq6->msn = tcp_context->msn & 0xf;
-	seq6->psh_flag = tcp->psh_flag;
-	seq6->header_crc = crc;
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x1b, 5); /* discriminator '11011' */
+	rohc_bit_write(&writer, tcp_context->seq_num_scaled, 4);
+	rohc_comp_debug(context, "7-bit IP-ID offset 0x%x",
+	                tcp_context->tmp.ip_id_delta & 0x7f);
+	rohc_bit_write(&writer, tcp_context->tmp.ip_id_delta, 7);
+	rohc_bit_write(&writer, rohc_ntoh32(tcp->ack_num), 16);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
+	rohc_bit_write(&writer, crc, 3);
 
-	return sizeof(seq_6_t);
+	return rohc_bit_writer_finish(&writer);
 
 error:
 	return -1;
@@ -4620,7 +4998,7 @@ static int c_tcp_build_seq_7(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_7_t *const seq7 = (seq_7_t *) rohc_data;
+	struct rohc_bit_writer writer;
 	uint16_t window;
 
 	assert(inner_ip_ctxt->ctxt.vx.version == IPV4);
@@ -4635,23 +5013,19 @@ static int c_tcp_build_seq_7(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	seq7->discriminator = 0x0c; /* '1100' */
-
-	/* window */
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x0c, 4); /* discriminator '1100' */
 	window = rohc_ntoh16(tcp->window) & 0x7fff;
-	seq7->window1 = (window >> 11) & 0x0f;
-	seq7->window2 = (window >> 3) & 0xff;
-	seq7->window3 = window & 0x07;
-
-	/* IP-ID */
-	seq7->ip_id = tcp_context->tmp.ip_id_delta & 0x1f;
-	rohc_comp_debug(context, "5-bit IP-ID offset 0x%x", seq7->ip_id);
-	seq7->ack_num = rohc_hton16(rohc_ntoh32(tcp->ack_num) & 0xffff);
-	seq7->msn = tcp_context->msn & 0xf;
-	seq7->psh_flag = tcp->psh_flag;
-	seq7->header_crc = crc;
+	rohc_bit_write(&writer, window, 15);
+	rohc_comp_debug(context, "5-bit IP-ID offset 0x%x",
+	                tcp_context->tmp.ip_id_delta & 0x1f);
+	rohc_bit_write(&writer, tcp_context->tmp.ip_id_delta, 5);
+	rohc_bit_write(&writer, rohc_ntoh32(tcp->ack_num), 16);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
+	rohc_bit_write(&writer, crc, 3);
 
-	return sizeof(seq_7_t);
+	return rohc_bit_writer_finish(&writer);
 
 error:
 	return -1;
@@ -4686,7 +5060,9 @@ static int c_tcp_build_seq_8(const struct rohc_comp_ctxt *const context,
                              uint8_t *const rohc_data,
                              const size_t rohc_max_len)
 {
-	seq_8_t *const seq8 = (seq_8_t *) rohc_data;
+	struct rohc_bit_writer writer;
+	bool is_list_present;
+	size_t seq_8_len;
 	const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) inner_ip_hdr;
 	size_t comp_opts_len;
 	uint16_t ack_num;
@@ -4705,53 +5081,53 @@ static int c_tcp_build_seq_8(const struct rohc_comp_ctxt *const context,
 		goto error;
 	}
 
-	seq8->discriminator = 0x0b; /* '1011' */
+	/* include the list of TCP options if the structure of the list changed
+	 * or if some static options changed (irregular chain cannot transmit
+	 * static options) */
+	is_list_present = (tcp_context->tcp_opts.tmp.do_list_struct_changed ||
+	                   tcp_context->tcp_opts.tmp.do_list_static_changed);
+
+	rohc_bit_writer_init(&writer, rohc_data, rohc_max_len);
+	rohc_bit_write(&writer, 0x0b, 4); /* discriminator '1011' */
 
 	/* IP-ID */
-	seq8->ip_id = tcp_context->tmp.ip_id_delta & 0xf;
-	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x", seq8->ip_id);
+	rohc_comp_debug(context, "4-bit IP-ID offset 0x%x",
+	                tcp_context->tmp.ip_id_delta & 0xf);
+	rohc_bit_write(&writer, tcp_context->tmp.ip_id_delta, 4);
 
-	seq8->list_present = 0; /* options are set later */
-	seq8->header_crc = crc;
-	rohc_comp_debug(context, "CRC = 0x%x", seq8->header_crc);
-	seq8->msn = tcp_context->msn & 0xf;
-	seq8->psh_flag = tcp->psh_flag;
+	rohc_bit_write(&writer, rohc_b2u(is_list_present), 1);
+	rohc_comp_debug(context, "CRC = 0x%x", crc);
+	rohc_bit_write(&writer, crc, 7);
+	rohc_bit_write(&writer, tcp_context->msn, 4);
+	rohc_bit_write(&writer, tcp->psh_flag, 1);
 
 	/* TTL/HL */
-	seq8->ttl_hopl = ipv4->ttl & 0x7;
+	rohc_bit_write(&writer, ipv4->ttl, 3);
 
 	/* ecn_used */
-	seq8->ecn_used = GET_REAL(tcp_context->ecn_used);
+	rohc_bit_write(&writer, GET_REAL(tcp_context->ecn_used), 1);
 
 	/* ACK number */
 	ack_num = rohc_ntoh32(tcp->ack_num) & 0x7fff;
-	seq8->ack_num1 = (ack_num >> 8) & 0x7f;
-	seq8->ack_num2 = ack_num & 0xff;
-	rohc_comp_debug(context, "ack_number = 0x%04x (0x%02x 0x%02x)",
-	                ack_num, seq8->ack_num1, seq8->ack_num2);
+	rohc_comp_debug(context, "ack_number = 0x%04x", ack_num);
+	rohc_bit_write(&writer, ack_num, 15);
 
-	seq8->rsf_flags = rsf_index_enc(tcp->rsf_flags);
+	rohc_bit_write(&writer, rsf_index_enc(tcp->rsf_flags), 2);
 
 	/* sequence number */
 	seq_num = rohc_ntoh32(tcp->seq_num) & 0x3fff;
-	seq8->seq_num1 = (seq_num >> 8) & 0x3f;
-	seq8->seq_num2 = seq_num & 0xff;
-	rohc_comp_debug(context, "seq_number = 0x%04x (0x%02x 0x%02x)",
-	                seq_num, seq8->seq_num1, seq8->seq_num2);
+	rohc_comp_debug(context, "seq_number = 0x%04x", seq_num);
+	rohc_bit_write(&writer, seq_num, 14);
+	seq_8_len = rohc_bit_writer_finish(&writer);
 
-	/* include the list of TCP options if the structure of the list changed
-	 * or if some static options changed (irregular chain cannot transmit
-	 * static options) */
-	if(tcp_context->tcp_opts.tmp.do_list_struct_changed ||
-	   tcp_context->tcp_opts.tmp.do_list_static_changed)
+	if(is_list_present)
 	{
 		/* the structure of the list of TCP options changed or at least one of
 		 * the static option changed, compress them */
-		seq8->list_present = 1;
 		ret = c_tcp_code_tcp_opts_list_item(context, tcp, tcp_context->msn,
 		                                    false, &tcp_context->tcp_opts,
-		                                    seq8->options,
-		                                    rohc_max_len - sizeof(rnd_8_t));
+		                                    rohc_data + seq_8_len,
+		                                    rohc_max_len - seq_8_len);
 		if(ret < 0)
 		{
 			rohc_comp_warn(context, "failed to compress TCP options");
@@ -4763,11 +5139,10 @@ static int c_tcp_build_seq_8(const struct rohc_comp_ctxt *const context,
 	{
 		/* the structure of the list of TCP options didn't change */
 		rohc_comp_debug(context, "compressed list of TCP options: list not present");
-		seq8->list_present = 0;
 		comp_opts_len = 0;
 	}
 
-	return (sizeof(seq_8_t) + comp_opts_len);
+	return (seq_8_len + comp_opts_len);
 
 error:
 	return -1;
@@ -5267,11 +5642,31 @@ static bool tcp_detect_changes(struct rohc_comp_ctxt *const context,
 		{
 			/* first packet, be optimistic: choose sequential behavior */
 			(*ip_inner_ctxt)->ctxt.v4.ip_id_behavior = IP_ID_BEHAVIOR_SEQ;
+			(*ip_inner_ctxt)->ctxt.v4.ip_id_behavior_confidence = 0;
+		}
+		else if((*ip_inner_ctxt)->ctxt.v4.ip_id_behavior_confidence >=
+		        ROHC_IP_ID_BEHAVIOR_CONFIDENCE &&
+		        tcp_is_ip_id_behavior_confirmed((*ip_inner_ctxt)->ctxt.v4.ip_id_behavior,
+		                                        (*ip_inner_ctxt)->ctxt.v4.last_ip_id,
+		                                        ip_id))
+		{
+			/* the trusted behavior is confirmed, skip the detection */
 		}
 		else
 		{
-			(*ip_inner_ctxt)->ctxt.v4.ip_id_behavior =
+			const tcp_ip_id_behavior_t behavior =
 				tcp_detect_ip_id_behavior((*ip_inner_ctxt)->ctxt.v4.last_ip_id, ip_id);
+
+			if(behavior != (*ip_inner_ctxt)->ctxt.v4.ip_id_behavior)
+			{
+				(*ip_inner_ctxt)->ctxt.v4.ip_id_behavior = behavior;
+				(*ip_inner_ctxt)->ctxt.v4.ip_id_behavior_confidence = 0;
+			}
+			else if((*ip_inner_ctxt)->ctxt.v4.ip_id_behavior_confidence <
+			        ROHC_IP_ID_BEHAVIOR_CONFIDENCE)
+			{
+				(*ip_inner_ctxt)->ctxt.v4.ip_id_behavior_confidence++;
+			}
 		}
 		rohc_comp_debug(context, "IP-ID now behaves as %s",
 		                tcp_ip_id_behavior_get_descr((*ip_inner_ctxt)->ctxt.v4.ip_id_behavior));
@@ -5324,6 +5719,21 @@ static bool tcp_detect_changes_ipv6_exts(struct rohc_comp_ctxt *const context,
 	(*exts_nr) = 0;
 	(*exts_len) = 0;
 
+	/* the contexts of the extension headers are allocated with the first
+	 * extension header */
+	if(rohc_is_ipv6_opt(*protocol) && ip_context->opts == NULL)
+	{
+		ip_context->opts =
+			rohc_slab_alloc(context->compressor->ctxt_slab,
+			                sizeof(ip_option_context_t) * ROHC_TCP_MAX_IP_EXT_HDRS);
+		if(ip_context->opts == NULL)
+		{
+			rohc_comp_warn(context, "no memory for the contexts of the IPv6 "
+			               "extension headers");
+			goto error;
+		}
+	}
+
 	for(ext_pos = 0;
 	    rohc_is_ipv6_opt(*protocol) && ext_pos < ROHC_TCP_MAX_IP_EXT_HDRS;
 	    ext_pos++)
@@ -5441,6 +5851,10 @@ static bool tcp_detect_changes_ipv6_exts(struct rohc_comp_ctxt *const context,
 	{
 		rohc_comp_debug(context, "  IPv6 extension headers changed too much, static "
 		                "chain is required");
+		if(tcp_context->static_chain != NULL)
+		{
+			tcp_context->static_chain->len = 0;
+		}
 	}
 	else if(tcp_context->tmp.is_ipv6_exts_list_dyn_changed)
 	{
@@ -5476,6 +5890,57 @@ static uint16_t c_tcp_get_next_msn(const struct rohc_comp_ctxt *const context)
 }
 
 
+/**
+ * @brief Get the MSN of the last packet
+ *
+ * @param context  The compression context
+ * @return         The MSN of the last packet
+ */
+static uint32_t c_tcp_get_msn(const struct rohc_comp_ctxt *const context)
+{
+	const struct sc_tcp_context *const tcp_context = context->specific;
+	return tcp_context->msn;
+}
+
+
+/**
+ * @brief Force the MSN of the next packet
+ *
+ * Used to restore a saved context: the MSN of the packet replayed in the
+ * context shall be the MSN of the saved context.
+ *
+ * @param context  The compression context
+ * @param msn      The MSN of the next packet
+ */
+static void c_tcp_set_next_msn(struct rohc_comp_ctxt *const context,
+                               const uint32_t msn)
+{
+	struct sc_tcp_context *const tcp_context = context->specific;
+
+	/* see c_tcp_get_next_msn(): the MSN wraps around after 0xfffe */
+	tcp_context->msn = (msn == 0 ? 0xfffe : ((msn - 1) & 0xffff));
+}
+
+
+/**
+ * @brief Prefetch the W-LSB windows used by every packet of the context
+ *
+ * Called by the compressor when it compresses a burst of packets, before the
+ * next packet is compressed in the context.
+ *
+ * @param context  The compression context
+ */
+static void c_tcp_prefetch(const struct rohc_comp_ctxt *const context)
+{
+	const struct sc_tcp_context *const tcp_context = context->specific;
+
+	c_wlsb_prefetch(tcp_context->msn_wlsb);
+	c_wlsb_prefetch(tcp_context->ip_id_wlsb);
+	c_wlsb_prefetch(tcp_context->seq_wlsb);
+	c_wlsb_prefetch(tcp_context->ack_wlsb);
+}
+
+
 /**
  * @brief Decide the state that should be used for the next packet.
  *
@@ -5550,6 +6015,11 @@ static void tcp_decide_state(struct rohc_comp_ctxt *const context)
 /**
  * @brief Encode uncompressed fields with the corresponding encoding scheme
  *
+ * Only the fields that every packet type depends on are encoded here: the
+ * change flags, the scaling of the sequence and ACK numbers. The numbers of
+ * LSB bits required by the compressed packets are computed on demand by
+ * \ref tcp_encode_lsb_fields once the packet type decision needs them.
+ *
  * @param context      The compression context
  * @param uncomp_pkt   The uncompressed packet to encode
  * @param tcp          The uncompressed TCP header to encode
@@ -5562,14 +6032,8 @@ static bool tcp_encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 {
 	struct sc_tcp_context *const tcp_context = context->specific;
 
-	/* how many bits are required to encode the new SN ? */
-	tcp_context->tmp.nr_msn_bits =
-		wlsb_get_k_16bits(tcp_context->msn_wlsb, tcp_context->msn);
-	rohc_comp_debug(context, "%zu bits are required to encode new MSN 0x%04x",
-	                tcp_context->tmp.nr_msn_bits, tcp_context->msn);
-	/* add the new MSN to the W-LSB encoding object */
-	/* TODO: move this after successful packet compression */
-	c_add_wlsb(tcp_context->msn_wlsb, tcp_context->msn, tcp_context->msn);
+	/* no LSB encoding evaluated yet for the new packet */
+	tcp_context->tmp.lsb_fields_done = 0;
 
 	if(!tcp_encode_uncomp_ip_fields(context, uncomp_pkt))
 	{
@@ -5605,48 +6069,40 @@ static bool tcp_encode_uncomp_ip_fields(struct rohc_comp_ctxt *const context,
 {
 	struct sc_tcp_context *const tcp_context = context->specific;
 
-	const uint8_t *remain_data = uncomp_pkt->data;
-	size_t remain_len = uncomp_pkt->len;
+	const struct net_pkt_hdrs *const hdrs = &uncomp_pkt->hdrs;
 
 	const ip_context_t *inner_ip_ctxt = NULL;
 	const uint8_t *inner_ip_hdr = NULL;
 	ip_version inner_ip_version = IP_UNKNOWN;
 
-	uint8_t protocol;
 	size_t ip_hdr_pos;
 
-	/* there is at least one IP header otherwise it won't be the IP/TCP profile */
+	/* there is at least one IP header otherwise it won't be the IP/TCP profile,
+	 * the IP headers were located while parsing the packet */
 	assert(tcp_context->ip_contexts_nr > 0);
+	assert(hdrs->is_complete);
+	assert(hdrs->ip_nr == tcp_context->ip_contexts_nr);
 
 	/* parse IP headers */
 	tcp_context->tmp.ttl_irreg_chain_flag = 0;
 	for(ip_hdr_pos = 0; ip_hdr_pos < tcp_context->ip_contexts_nr; ip_hdr_pos++)
 	{
-		const struct ip_hdr *const ip = (struct ip_hdr *) remain_data;
+		const struct net_pkt_ip_hdr *const ip_hdr = &hdrs->ip[ip_hdr_pos];
+		const uint8_t *const ip_data = uncomp_pkt->data + ip_hdr->offset;
 		const ip_context_t *const ip_context = &(tcp_context->ip_contexts[ip_hdr_pos]);
 		const bool is_innermost = !!(ip_hdr_pos + 1 == tcp_context->ip_contexts_nr);
 		uint8_t ttl_hopl;
-		size_t ip_ext_pos;
 
 		/* retrieve IP version */
-		assert(remain_len >= sizeof(struct ip_hdr));
-		rohc_comp_debug(context, "found IPv%d", ip->version);
+		rohc_comp_debug(context, "found IPv%d", ip_hdr->version);
 
 		inner_ip_ctxt = ip_context;
-		inner_ip_hdr = remain_data;
-		inner_ip_version = ip->version;
+		inner_ip_hdr = ip_data;
+		inner_ip_version = ip_hdr->version;
 
-		if(ip->version == IPV4)
+		if(ip_hdr->version == IPV4)
 		{
-			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) remain_data;
-			size_t ipv4_hdr_len;
-
-			assert(remain_len >= sizeof(struct ipv4_hdr));
-			ipv4_hdr_len = ipv4->ihl * sizeof(uint32_t);
-			assert(remain_len >= ipv4_hdr_len);
-
-			/* get the transport protocol */
-			protocol = ipv4->protocol;
+			const struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) ip_data;
 
 			/* irregular chain? */
 			ttl_hopl = ipv4->ttl;
@@ -5658,21 +6114,10 @@ static bool tcp_encode_uncomp_ip_fields(struct rohc_comp_ctxt *const context,
 				                ip_context->ctxt.v4.ttl_hopl, ttl_hopl,
 				                tcp_context->tmp.ttl_irreg_chain_flag);
 			}
-
-			/* skip IPv4 header */
-			rohc_comp_debug(context, "skip %zu-byte IPv4 header with "
-			                "Protocol 0x%02x", ipv4_hdr_len, protocol);
-			remain_data += ipv4_hdr_len;
-			remain_len -= ipv4_hdr_len;
 		}
-		else if(ip->version == IPV6)
+		else if(ip_hdr->version == IPV6)
 		{
-			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) remain_data;
-
-			assert(remain_len >= sizeof(struct ipv6_hdr));
-
-			/* get the transport protocol */
-			protocol = ipv6->nh;
+			const struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) ip_data;
 
 			/* irregular chain? */
 			ttl_hopl = ipv6->hl;
@@ -5684,24 +6129,6 @@ static bool tcp_encode_uncomp_ip_fields(struct rohc_comp_ctxt *const context,
 				                ip_context->ctxt.v6.ttl_hopl, ttl_hopl,
 				                tcp_context->tmp.ttl_irreg_chain_flag);
 			}
-
-			/* skip IPv6 header */
-			rohc_comp_debug(context, "skip %zd-byte IPv6 header with Next "
-			                "Header 0x%02x", sizeof(struct ipv6_hdr), protocol);
-			remain_data += sizeof(struct ipv6_hdr);
-			remain_len -= sizeof(struct ipv6_hdr);
-
-			/* skip IPv6 extension headers */
-			for(ip_ext_pos = 0; rohc_is_ipv6_opt(protocol); ip_ext_pos++)
-			{
-				const struct ipv6_opt *const ipv6_opt = (struct ipv6_opt *) remain_data;
-				const size_t opt_len = ipv6_opt_get_length(ipv6_opt);
-				rohc_comp_debug(context, "  skip %zu-byte IPv6 extension header "
-				                "with Next Header 0x%02x", opt_len, protocol);
-				remain_data += opt_len;
-				remain_len -= opt_len;
-				protocol = ipv6_opt->next_header;
-			}
 		}
 		else
 		{
@@ -5746,39 +6173,6 @@ static bool tcp_encode_uncomp_ip_fields(struct rohc_comp_ctxt *const context,
 			tcp_context->tmp.ip_id_delta = 0; /* unused */
 		}
 
-		/* how many bits are required to encode the new IP-ID / SN delta ? */
-		if(inner_ip_ctxt->ctxt.v4.ip_id_behavior != IP_ID_BEHAVIOR_SEQ &&
-		   inner_ip_ctxt->ctxt.v4.ip_id_behavior != IP_ID_BEHAVIOR_SEQ_SWAP)
-		{
-			/* send all bits if IP-ID behavior is not sequential */
-			tcp_context->tmp.nr_ip_id_bits_3 = 16;
-			tcp_context->tmp.nr_ip_id_bits_1 = 16;
-			rohc_comp_debug(context, "force using 16 bits to encode new IP-ID delta "
-			                "(non-sequential)");
-		}
-		else
-		{
-			/* send only required bits in FO or SO states */
-			tcp_context->tmp.nr_ip_id_bits_3 =
-				wlsb_get_kp_16bits(tcp_context->ip_id_wlsb,
-				                   tcp_context->tmp.ip_id_delta, 3);
-			rohc_comp_debug(context, "%zu bits are required to encode new innermost "
-			                "IP-ID delta 0x%04x with p = 3",
-			                tcp_context->tmp.nr_ip_id_bits_3,
-			                tcp_context->tmp.ip_id_delta);
-			tcp_context->tmp.nr_ip_id_bits_1 =
-				wlsb_get_kp_16bits(tcp_context->ip_id_wlsb,
-				                   tcp_context->tmp.ip_id_delta, 1);
-			rohc_comp_debug(context, "%zu bits are required to encode new innermost "
-			                "IP-ID delta 0x%04x with p = 1",
-			                tcp_context->tmp.nr_ip_id_bits_1,
-			                tcp_context->tmp.ip_id_delta);
-		}
-		/* add the new IP-ID / SN delta to the W-LSB encoding object */
-		/* TODO: move this after successful packet compression */
-		c_add_wlsb(tcp_context->ip_id_wlsb, tcp_context->msn,
-		           tcp_context->tmp.ip_id_delta);
-
 		tcp_context->tmp.ip_df_changed =
 			!!(inner_ipv4->df != inner_ip_ctxt->ctxt.v4.df);
 		tcp_field_descr_change(context, "DF", tcp_context->tmp.ip_df_changed, 0);
@@ -5796,8 +6190,6 @@ static bool tcp_encode_uncomp_ip_fields(struct rohc_comp_ctxt *const context,
 		/* no IP-ID for IPv6 */
 		tcp_context->tmp.ip_id_delta = 0;
 		tcp_context->tmp.ip_id_behavior_changed = false;
-		tcp_context->tmp.nr_ip_id_bits_3 = 0;
-		tcp_context->tmp.nr_ip_id_bits_1 = 0;
 
 		tcp_context->tmp.ip_df_changed = false; /* no DF for IPv6 */
 
@@ -5808,7 +6200,7 @@ static bool tcp_encode_uncomp_ip_fields(struct rohc_comp_ctxt *const context,
 		tcp_context->tmp.ttl_hopl = inner_ipv6->hl;
 	}
 
-	/* encode innermost IPv4 TTL or IPv6 Hop Limit */
+	/* innermost IPv4 TTL or IPv6 Hop Limit */
 	if(tcp_context->tmp.ttl_hopl != inner_ip_ctxt->ctxt.vx.ttl_hopl)
 	{
 		tcp_context->tmp.ttl_hopl_changed = true;
@@ -5823,16 +6215,6 @@ static bool tcp_encode_uncomp_ip_fields(struct rohc_comp_ctxt *const context,
 	{
 		tcp_context->tmp.ttl_hopl_changed = false;
 	}
-	tcp_context->tmp.nr_ttl_hopl_bits =
-		wlsb_get_k_8bits(tcp_context->ttl_hopl_wlsb, tcp_context->tmp.ttl_hopl);
-	rohc_comp_debug(context, "%zu bits are required to encode new innermost "
-	                "TTL/Hop Limit 0x%02x with p = 3",
-	                tcp_context->tmp.nr_ttl_hopl_bits,
-	                tcp_context->tmp.ttl_hopl);
-	/* add the new TTL/Hop Limit to the W-LSB encoding object */
-	/* TODO: move this after successful packet compression */
-	c_add_wlsb(tcp_context->ttl_hopl_wlsb, tcp_context->msn,
-	           tcp_context->tmp.ttl_hopl);
 
 	return true;
 
@@ -5891,7 +6273,7 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 		rohc_comp_debug(context, "RSF flags is set in current packet");
 	}
 
-	/* how many bits are required to encode the new TCP window? */
+	/* did the TCP window change? */
 	if(tcp->window != tcp_context->old_tcphdr.window)
 	{
 		tcp_context->tmp.tcp_window_changed = true;
@@ -5908,14 +6290,6 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 	}
 	tcp_field_descr_change(context, "TCP window", tcp_context->tmp.tcp_window_changed,
 	                       tcp_context->tcp_window_change_count);
-	tcp_context->tmp.nr_window_bits_16383 =
-		wlsb_get_kp_16bits(tcp_context->window_wlsb, rohc_ntoh16(tcp->window),
-		                   ROHC_LSB_SHIFT_TCP_WINDOW);
-	rohc_comp_debug(context, "%zu bits are required to encode new TCP window "
-	                "0x%04x with p = %d", tcp_context->tmp.nr_window_bits_16383,
-	                rohc_ntoh16(tcp->window), ROHC_LSB_SHIFT_TCP_WINDOW);
-	/* TODO: move this after successful packet compression */
-	c_add_wlsb(tcp_context->window_wlsb, tcp_context->msn, rohc_ntoh16(tcp->window));
 
 	/* compute new scaled TCP sequence number */
 	{
@@ -5923,8 +6297,8 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 		uint32_t seq_num_scaled;
 		uint32_t seq_num_residue;
 
-		c_field_scaling(&seq_num_scaled, &seq_num_residue, seq_num_factor,
-		                seq_num_hbo);
+		c_field_scaling_cached(&tcp_context->seq_scaling, &seq_num_scaled,
+		                       &seq_num_residue, seq_num_factor, seq_num_hbo);
 		rohc_comp_debug(context, "seq_num = 0x%x, scaled = 0x%x, factor = %zu, "
 		                "residue = 0x%x", seq_num_hbo, seq_num_scaled,
 		                seq_num_factor, seq_num_residue);
@@ -5965,6 +6339,8 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 		}
 		else
 		{
+			const uint16_t old_delta =
+				tcp_context->ack_deltas_width[tcp_context->ack_deltas_next];
 			size_t ack_stride_count = 0;
 			size_t i;
 			size_t j;
@@ -5973,7 +6349,30 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 			tcp_context->ack_deltas_width[tcp_context->ack_deltas_next] = ack_delta;
 			tcp_context->ack_deltas_next = (tcp_context->ack_deltas_next + 1) % 20;
 
-			for(i = 0; i < 20; i++)
+			/* keep track of the occurrences of the current ack_stride */
+			if(old_delta == tcp_context->ack_stride)
+			{
+				tcp_context->ack_stride_count--;
+			}
+			if(((uint16_t) ack_delta) == tcp_context->ack_stride)
+			{
+				tcp_context->ack_stride_count++;
+			}
+
+			/* the current ack_stride is still the most used ACK delta if it
+			 * is used in more than half of the last 20 packets, the search
+			 * below would find it again */
+			if(tcp_context->ack_stride_count > (20/2))
+			{
+				ack_stride = tcp_context->ack_stride;
+				ack_stride_count = tcp_context->ack_stride_count;
+				i = 20;
+			}
+			else
+			{
+				i = 0;
+			}
+			for( ; i < 20; i++)
 			{
 				const uint16_t val =
 					tcp_context->ack_deltas_width[(tcp_context->ack_deltas_next + i) % 20];
@@ -5999,10 +6398,12 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 			}
 			rohc_comp_debug(context, "ack_stride 0x%04x was used %zu times in the "
 			                "last 20 packets", ack_stride, ack_stride_count);
+			tcp_context->ack_stride_count = ack_stride_count;
 		}
 
 		/* compute new scaled ACK number & residue */
-		c_field_scaling(&ack_num_scaled, &ack_num_residue, ack_stride, ack_num_hbo);
+		c_field_scaling_cached(&tcp_context->ack_scaling, &ack_num_scaled,
+		                       &ack_num_residue, ack_stride, ack_num_hbo);
 		rohc_comp_debug(context, "ack_number = 0x%x, scaled = 0x%x, factor = %u, "
 		                "residue = 0x%x", ack_num_hbo, ack_num_scaled,
 		                ack_stride, ack_num_residue);
@@ -6031,36 +6432,137 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 		tcp_context->ack_stride = ack_stride;
 	}
 
-	/* how many bits are required to encode the new sequence number? */
+	/* did the sequence and ACK numbers change? */
 	tcp_context->tmp.tcp_seq_num_changed =
 		(tcp->seq_num != tcp_context->old_tcphdr.seq_num);
-	tcp_context->tmp.nr_seq_bits_65535 =
-		wlsb_get_kp_32bits(tcp_context->seq_wlsb, seq_num_hbo, 65535);
-	rohc_comp_debug(context, "%zd bits are required to encode new sequence "
-	                "number 0x%08x with p = 65535",
-	                tcp_context->tmp.nr_seq_bits_65535, seq_num_hbo);
-	tcp_context->tmp.nr_seq_bits_32767 =
-		wlsb_get_kp_32bits(tcp_context->seq_wlsb, seq_num_hbo, 32767);
-	rohc_comp_debug(context, "%zd bits are required to encode new sequence "
-	                "number 0x%08x with p = 32767",
-	                tcp_context->tmp.nr_seq_bits_32767, seq_num_hbo);
-	tcp_context->tmp.nr_seq_bits_16383 =
-		wlsb_get_kp_32bits(tcp_context->seq_wlsb, seq_num_hbo, 16383);
-	rohc_comp_debug(context, "%zd bits are required to encode new sequence "
-	                "number 0x%08x with p = 16383",
-	                tcp_context->tmp.nr_seq_bits_16383, seq_num_hbo);
-	tcp_context->tmp.nr_seq_bits_8191 =
-		wlsb_get_kp_32bits(tcp_context->seq_wlsb, seq_num_hbo, 8191);
-	rohc_comp_debug(context, "%zd bits are required to encode new sequence "
-	                "number 0x%08x with p = 8191",
-	                tcp_context->tmp.nr_seq_bits_8191, seq_num_hbo);
-	tcp_context->tmp.nr_seq_bits_63 =
-		wlsb_get_kp_32bits(tcp_context->seq_wlsb, seq_num_hbo, 63);
-	rohc_comp_debug(context, "%zd bits are required to encode new sequence "
-	                "number 0x%08x with p = 63",
-	                tcp_context->tmp.nr_seq_bits_63, seq_num_hbo);
-	if(tcp_context->seq_num_factor == 0 ||
-	   tcp_context->seq_num_scaling_nr < ROHC_INIT_TS_STRIDE_MIN)
+	tcp_context->tmp.tcp_ack_num_changed =
+		(tcp->ack_num != tcp_context->old_tcphdr.ack_num);
+
+	return true;
+}
+
+
+/**
+ * @brief Compute how many LSB bits are required to encode the given fields
+ *
+ * The W-LSB windows are browsed only for the fields that the packet type
+ * decision or the chosen packet type depend on, and only once per packet:
+ * the fields already evaluated for the current packet are skipped. The new
+ * values are added to the W-LSB windows once the packet is built, see
+ * \ref tcp_update_lsb_windows.
+ *
+ * @param context  The compression context
+ * @param tcp      The uncompressed TCP header to encode
+ * @param fields   The fields to evaluate, see \ref tcp_lsb_field_t
+ */
+static void tcp_encode_lsb_fields(const struct rohc_comp_ctxt *const context,
+                                  const struct tcphdr *const tcp,
+                                  const unsigned int fields)
+{
+	struct sc_tcp_context *const tcp_context = context->specific;
+	const ip_context_t *const inner_ip_ctxt =
+		&(tcp_context->ip_contexts[tcp_context->ip_contexts_nr - 1]);
+	const unsigned int todo = fields & ~tcp_context->tmp.lsb_fields_done;
+
+	/* how many bits are required to encode the new SN ? */
+	if((todo & TCP_LSB_MSN) != 0)
+	{
+		tcp_context->tmp.nr_msn_bits =
+			wlsb_get_k_16bits(tcp_context->msn_wlsb, tcp_context->msn);
+		rohc_comp_debug(context, "%zu bits are required to encode new MSN 0x%04x",
+		                tcp_context->tmp.nr_msn_bits, tcp_context->msn);
+	}
+
+	/* how many bits are required to encode the new IP-ID / SN delta ? */
+	if((todo & TCP_LSB_IP_ID) == 0)
+	{
+		/* not requested or already computed */
+	}
+	else if(inner_ip_ctxt->version != IPV4)
+	{
+		/* no IP-ID for IPv6 */
+		tcp_context->tmp.nr_ip_id_bits_3 = 0;
+		tcp_context->tmp.nr_ip_id_bits_1 = 0;
+	}
+	else if(inner_ip_ctxt->ctxt.v4.ip_id_behavior != IP_ID_BEHAVIOR_SEQ &&
+	        inner_ip_ctxt->ctxt.v4.ip_id_behavior != IP_ID_BEHAVIOR_SEQ_SWAP)
+	{
+		/* send all bits if IP-ID behavior is not sequential */
+		tcp_context->tmp.nr_ip_id_bits_3 = 16;
+		tcp_context->tmp.nr_ip_id_bits_1 = 16;
+		rohc_comp_debug(context, "force using 16 bits to encode new IP-ID delta "
+		                "(non-sequential)");
+	}
+	else
+	{
+		/* send only required bits in FO or SO states */
+		tcp_context->tmp.nr_ip_id_bits_3 =
+			wlsb_get_kp_16bits(tcp_context->ip_id_wlsb,
+			                   tcp_context->tmp.ip_id_delta, 3);
+		rohc_comp_debug(context, "%zu bits are required to encode new innermost "
+		                "IP-ID delta 0x%04x with p = 3",
+		                tcp_context->tmp.nr_ip_id_bits_3,
+		                tcp_context->tmp.ip_id_delta);
+		tcp_context->tmp.nr_ip_id_bits_1 =
+			wlsb_get_kp_16bits(tcp_context->ip_id_wlsb,
+			                   tcp_context->tmp.ip_id_delta, 1);
+		rohc_comp_debug(context, "%zu bits are required to encode new innermost "
+		                "IP-ID delta 0x%04x with p = 1",
+		                tcp_context->tmp.nr_ip_id_bits_1,
+		                tcp_context->tmp.ip_id_delta);
+	}
+
+	/* how many bits are required to encode the innermost IPv4 TTL or IPv6
+	 * Hop Limit? */
+	if((todo & TCP_LSB_TTL_HOPL) != 0)
+	{
+		tcp_context->tmp.nr_ttl_hopl_bits =
+			wlsb_get_k_8bits(tcp_context->ttl_hopl_wlsb, tcp_context->tmp.ttl_hopl);
+		rohc_comp_debug(context, "%zu bits are required to encode new innermost "
+		                "TTL/Hop Limit 0x%02x with p = 3",
+		                tcp_context->tmp.nr_ttl_hopl_bits,
+		                tcp_context->tmp.ttl_hopl);
+	}
+
+	/* how many bits are required to encode the new TCP window? */
+	if((todo & TCP_LSB_WINDOW) != 0)
+	{
+		tcp_context->tmp.nr_window_bits_16383 =
+			wlsb_get_kp_16bits(tcp_context->window_wlsb, rohc_ntoh16(tcp->window),
+			                   ROHC_LSB_SHIFT_TCP_WINDOW);
+		rohc_comp_debug(context, "%zu bits are required to encode new TCP window "
+		                "0x%04x with p = %d", tcp_context->tmp.nr_window_bits_16383,
+		                rohc_ntoh16(tcp->window), ROHC_LSB_SHIFT_TCP_WINDOW);
+	}
+
+	/* how many bits are required to encode the new sequence number? */
+	if((todo & TCP_LSB_SEQ) != 0)
+	{
+		const uint32_t seq_num_hbo = rohc_ntoh32(tcp->seq_num);
+		const rohc_lsb_shift_t ps[] = { 65535, 32767, 16383, 8191, 63 };
+		size_t bits_nr[sizeof(ps) / sizeof(rohc_lsb_shift_t)];
+		size_t i;
+
+		/* browse the window once for all the shift parameters */
+		wlsb_get_kps_32bits(tcp_context->seq_wlsb, seq_num_hbo, ps,
+		                    sizeof(ps) / sizeof(rohc_lsb_shift_t), bits_nr);
+		tcp_context->tmp.nr_seq_bits_65535 = bits_nr[0];
+		tcp_context->tmp.nr_seq_bits_32767 = bits_nr[1];
+		tcp_context->tmp.nr_seq_bits_16383 = bits_nr[2];
+		tcp_context->tmp.nr_seq_bits_8191 = bits_nr[3];
+		tcp_context->tmp.nr_seq_bits_63 = bits_nr[4];
+		for(i = 0; i < (sizeof(ps) / sizeof(rohc_lsb_shift_t)); i++)
+		{
+			rohc_comp_debug(context, "%zd bits are required to encode new sequence "
+			                "number 0x%08x with p = %d", bits_nr[i], seq_num_hbo, ps[i]);
+		}
+	}
+	if((todo & TCP_LSB_SEQ_SCALED) == 0)
+	{
+		/* not requested or already computed */
+	}
+	else if(tcp_context->seq_num_factor == 0 ||
+	        tcp_context->seq_num_scaling_nr < ROHC_INIT_TS_STRIDE_MIN)
 	{
 		tcp_context->tmp.nr_seq_scaled_bits = 32;
 	}
@@ -6072,45 +6574,35 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 		                "sequence number 0x%08x", tcp_context->tmp.nr_seq_scaled_bits,
 		                tcp_context->seq_num_scaled);
 	}
-	/* TODO: move this after successful packet compression */
-	c_add_wlsb(tcp_context->seq_wlsb, tcp_context->msn, seq_num_hbo);
-	if(tcp_context->seq_num_factor != 0)
-	{
-		/* TODO: move this after successful packet compression */
-		c_add_wlsb(tcp_context->seq_scaled_wlsb, tcp_context->msn,
-		           tcp_context->seq_num_scaled);
-	}
 
 	/* how many bits are required to encode the new ACK number? */
-	tcp_context->tmp.tcp_ack_num_changed =
-		(tcp->ack_num != tcp_context->old_tcphdr.ack_num);
-	tcp_context->tmp.nr_ack_bits_65535 =
-		wlsb_get_kp_32bits(tcp_context->ack_wlsb, ack_num_hbo, 65535);
-	rohc_comp_debug(context, "%zd bits are required to encode new ACK "
-	                "number 0x%08x with p = 65535",
-	                tcp_context->tmp.nr_ack_bits_65535, ack_num_hbo);
-	tcp_context->tmp.nr_ack_bits_32767 =
-		wlsb_get_kp_32bits(tcp_context->ack_wlsb, ack_num_hbo, 32767);
-	rohc_comp_debug(context, "%zd bits are required to encode new ACK "
-	                "number 0x%08x with p = 32767",
-	                tcp_context->tmp.nr_ack_bits_32767, ack_num_hbo);
-	tcp_context->tmp.nr_ack_bits_16383 =
-		wlsb_get_kp_32bits(tcp_context->ack_wlsb, ack_num_hbo, 16383);
-	rohc_comp_debug(context, "%zd bits are required to encode new ACK "
-	                "number 0x%08x with p = 16383",
-	                tcp_context->tmp.nr_ack_bits_16383, ack_num_hbo);
-	tcp_context->tmp.nr_ack_bits_8191 =
-		wlsb_get_kp_32bits(tcp_context->ack_wlsb, ack_num_hbo, 8191);
-	rohc_comp_debug(context, "%zd bits are required to encode new ACK "
-	                "number 0x%08x with p = 8191",
-	                tcp_context->tmp.nr_ack_bits_8191, ack_num_hbo);
-	tcp_context->tmp.nr_ack_bits_63 =
-		wlsb_get_kp_32bits(tcp_context->ack_wlsb, ack_num_hbo, 63);
-	rohc_comp_debug(context, "%zd bits are required to encode new ACK "
-	                "number 0x%08x with p = 63",
-	                tcp_context->tmp.nr_ack_bits_63, ack_num_hbo);
-	if(!tcp_is_ack_scaled_possible(tcp_context->ack_stride,
-	                               tcp_context->ack_num_scaling_nr))
+	if((todo & TCP_LSB_ACK) != 0)
+	{
+		const uint32_t ack_num_hbo = rohc_ntoh32(tcp->ack_num);
+		const rohc_lsb_shift_t ps[] = { 65535, 32767, 16383, 8191, 63 };
+		size_t bits_nr[sizeof(ps) / sizeof(rohc_lsb_shift_t)];
+		size_t i;
+
+		/* browse the window once for all the shift parameters */
+		wlsb_get_kps_32bits(tcp_context->ack_wlsb, ack_num_hbo, ps,
+		                    sizeof(ps) / sizeof(rohc_lsb_shift_t), bits_nr);
+		tcp_context->tmp.nr_ack_bits_65535 = bits_nr[0];
+		tcp_context->tmp.nr_ack_bits_32767 = bits_nr[1];
+		tcp_context->tmp.nr_ack_bits_16383 = bits_nr[2];
+		tcp_context->tmp.nr_ack_bits_8191 = bits_nr[3];
+		tcp_context->tmp.nr_ack_bits_63 = bits_nr[4];
+		for(i = 0; i < (sizeof(ps) / sizeof(rohc_lsb_shift_t)); i++)
+		{
+			rohc_comp_debug(context, "%zd bits are required to encode new ACK "
+			                "number 0x%08x with p = %d", bits_nr[i], ack_num_hbo, ps[i]);
+		}
+	}
+	if((todo & TCP_LSB_ACK_SCALED) == 0)
+	{
+		/* not requested or already computed */
+	}
+	else if(!tcp_is_ack_scaled_possible(tcp_context->ack_stride,
+	                                    tcp_context->ack_num_scaling_nr))
 	{
 		tcp_context->tmp.nr_ack_scaled_bits = 32;
 	}
@@ -6122,18 +6614,14 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 		                "ACK number 0x%08x", tcp_context->tmp.nr_ack_scaled_bits,
 		                tcp_context->ack_num_scaled);
 	}
-	/* TODO: move this after successful packet compression */
-	c_add_wlsb(tcp_context->ack_wlsb, tcp_context->msn, ack_num_hbo);
-	if(tcp_context->ack_stride != 0)
-	{
-		/* TODO: move this after successful packet compression */
-		c_add_wlsb(tcp_context->ack_scaled_wlsb, tcp_context->msn,
-		           tcp_context->ack_num_scaled);
-	}
 
 	/* how many bits are required to encode the new timestamp echo request and
 	 * timestamp echo reply? */
-	if(!tcp_context->tcp_opts.tmp.opt_ts_present)
+	if((todo & TCP_LSB_TS) == 0)
+	{
+		/* not requested or already computed */
+	}
+	else if(!tcp_context->tcp_opts.tmp.opt_ts_present)
 	{
 		/* no bit to send */
 		tcp_context->tcp_opts.tmp.nr_opt_ts_req_bits_minus_1 = 0;
@@ -6161,75 +6649,117 @@ static bool tcp_encode_uncomp_tcp_fields(struct rohc_comp_ctxt *const context,
 	else
 	{
 		/* send only required bits in FO or SO states */
+		const rohc_lsb_shift_t ps[] = {
+			ROHC_LSB_SHIFT_TCP_TS_1B, ROHC_LSB_SHIFT_TCP_TS_3B, ROHC_LSB_SHIFT_TCP_TS_4B
+		};
+		size_t req_bits_nr[C_TCP_TS_PS_NR];
+		size_t reply_bits_nr[C_TCP_TS_PS_NR];
+		size_t i;
 
 		/* how many bits are required to encode the timestamp echo request
-		 * with p = -1 ? */
-		tcp_context->tcp_opts.tmp.nr_opt_ts_req_bits_minus_1 =
-			wlsb_get_kp_32bits(tcp_context->tcp_opts.ts_req_wlsb,
-			                   tcp_context->tcp_opts.tmp.ts_req,
-			                   ROHC_LSB_SHIFT_TCP_TS_1B);
-		rohc_comp_debug(context, "%zu bits are required to encode new "
-		                "timestamp echo request 0x%08x with p = %d",
-		                tcp_context->tcp_opts.tmp.nr_opt_ts_req_bits_minus_1,
-		                tcp_context->tcp_opts.tmp.ts_req, ROHC_LSB_SHIFT_TCP_TS_1B);
+		 * and reply with p = -1, 0x40000 and 0x4000000? the windows are not
+		 * browsed while the deltas of the timestamps are predictable */
+		c_tcp_ts_get_lsb_bits(&tcp_context->tcp_opts.ts_req_pred,
+		                      tcp_context->tcp_opts.ts_req_wlsb,
+		                      tcp_context->tcp_opts.tmp.ts_req, req_bits_nr);
+		c_tcp_ts_get_lsb_bits(&tcp_context->tcp_opts.ts_reply_pred,
+		                      tcp_context->tcp_opts.ts_reply_wlsb,
+		                      tcp_context->tcp_opts.tmp.ts_reply, reply_bits_nr);
+		tcp_context->tcp_opts.tmp.nr_opt_ts_req_bits_minus_1 = req_bits_nr[0];
+		tcp_context->tcp_opts.tmp.nr_opt_ts_req_bits_0x40000 = req_bits_nr[1];
+		tcp_context->tcp_opts.tmp.nr_opt_ts_req_bits_0x4000000 = req_bits_nr[2];
+		tcp_context->tcp_opts.tmp.nr_opt_ts_reply_bits_minus_1 = reply_bits_nr[0];
+		tcp_context->tcp_opts.tmp.nr_opt_ts_reply_bits_0x40000 = reply_bits_nr[1];
+		tcp_context->tcp_opts.tmp.nr_opt_ts_reply_bits_0x4000000 = reply_bits_nr[2];
+		for(i = 0; i < (sizeof(ps) / sizeof(rohc_lsb_shift_t)); i++)
+		{
+			rohc_comp_debug(context, "%zu bits are required to encode new "
+			                "timestamp echo request 0x%08x with p = 0x%x",
+			                req_bits_nr[i], tcp_context->tcp_opts.tmp.ts_req, ps[i]);
+			rohc_comp_debug(context, "%zu bits are required to encode new "
+			                "timestamp echo reply 0x%08x with p = 0x%x",
+			                reply_bits_nr[i], tcp_context->tcp_opts.tmp.ts_reply, ps[i]);
+		}
+	}
 
-		/* how many bits are required to encode the timestamp echo request
-		 * with p = 0x40000 ? */
-		tcp_context->tcp_opts.tmp.nr_opt_ts_req_bits_0x40000 =
-			wlsb_get_kp_32bits(tcp_context->tcp_opts.ts_req_wlsb,
-			                   tcp_context->tcp_opts.tmp.ts_req,
-			                   ROHC_LSB_SHIFT_TCP_TS_3B);
-		rohc_comp_debug(context, "%zu bits are required to encode new "
-		                "timestamp echo request 0x%08x with p = 0x%x",
-		                tcp_context->tcp_opts.tmp.nr_opt_ts_req_bits_0x40000,
-		                tcp_context->tcp_opts.tmp.ts_req, ROHC_LSB_SHIFT_TCP_TS_3B);
-
-		/* how many bits are required to encode the timestamp echo reply
-		 * with p = 0x4000000 ? */
-		tcp_context->tcp_opts.tmp.nr_opt_ts_req_bits_0x4000000 =
-			wlsb_get_kp_32bits(tcp_context->tcp_opts.ts_req_wlsb,
-			                   tcp_context->tcp_opts.tmp.ts_req,
-			                   ROHC_LSB_SHIFT_TCP_TS_4B);
-		rohc_comp_debug(context, "%zu bits are required to encode new "
-		                "timestamp echo request 0x%08x with p = 0x%x",
-		                tcp_context->tcp_opts.tmp.nr_opt_ts_req_bits_0x4000000,
-		                tcp_context->tcp_opts.tmp.ts_req, ROHC_LSB_SHIFT_TCP_TS_4B);
-
-		/* how many bits are required to encode the timestamp echo reply
-		 * with p = -1 ? */
-		tcp_context->tcp_opts.tmp.nr_opt_ts_reply_bits_minus_1 =
-			wlsb_get_kp_32bits(tcp_context->tcp_opts.ts_reply_wlsb,
-			                   tcp_context->tcp_opts.tmp.ts_reply,
-			                   ROHC_LSB_SHIFT_TCP_TS_1B);
-		rohc_comp_debug(context, "%zu bits are required to encode new "
-		                "timestamp echo reply 0x%08x with p = %d",
-		                tcp_context->tcp_opts.tmp.nr_opt_ts_reply_bits_minus_1,
-		                tcp_context->tcp_opts.tmp.ts_reply, ROHC_LSB_SHIFT_TCP_TS_1B);
-
-		/* how many bits are required to encode the timestamp echo reply
-		 * with p = 0x40000 ? */
-		tcp_context->tcp_opts.tmp.nr_opt_ts_reply_bits_0x40000 =
-			wlsb_get_kp_32bits(tcp_context->tcp_opts.ts_reply_wlsb,
-			                   tcp_context->tcp_opts.tmp.ts_reply,
-			                   ROHC_LSB_SHIFT_TCP_TS_3B);
-		rohc_comp_debug(context, "%zu bits are required to encode new "
-		                "timestamp echo reply 0x%08x with p = 0x%x",
-		                tcp_context->tcp_opts.tmp.nr_opt_ts_reply_bits_0x40000,
-		                tcp_context->tcp_opts.tmp.ts_reply, ROHC_LSB_SHIFT_TCP_TS_3B);
-
-		/* how many bits are required to encode the timestamp echo reply
-		 * with p = 0x4000000 ? */
-		tcp_context->tcp_opts.tmp.nr_opt_ts_reply_bits_0x4000000 =
-			wlsb_get_kp_32bits(tcp_context->tcp_opts.ts_reply_wlsb,
-			                   tcp_context->tcp_opts.tmp.ts_reply,
-			                   ROHC_LSB_SHIFT_TCP_TS_4B);
-		rohc_comp_debug(context, "%zu bits are required to encode new "
-		                "timestamp echo reply 0x%08x with p = 0x%x",
-		                tcp_context->tcp_opts.tmp.nr_opt_ts_reply_bits_0x4000000,
-		                tcp_context->tcp_opts.tmp.ts_reply, ROHC_LSB_SHIFT_TCP_TS_4B);
+	tcp_context->tmp.lsb_fields_done |= todo;
+}
+
+
+/**
+ * @brief Get the fields the given packet type encodes with W-LSB widths
+ *
+ * @param packet_type  The type of ROHC packet to build
+ * @return             The fields to evaluate with \ref tcp_encode_lsb_fields
+ *                     before building the packet
+ */
+static unsigned int tcp_get_pkt_lsb_fields(const rohc_packet_t packet_type)
+{
+	unsigned int fields;
+
+	if(packet_type == ROHC_PACKET_IR ||
+	   packet_type == ROHC_PACKET_IR_CR ||
+	   packet_type == ROHC_PACKET_IR_DYN)
+	{
+		/* all fields are sent uncompressed */
+		fields = 0;
+	}
+	else if(packet_type == ROHC_PACKET_TCP_CO_COMMON)
+	{
+		/* variable_length_32_enc() of sequence and ACK numbers,
+		 * optional_ip_id_lsb() of innermost IP-ID, TS option in the
+		 * irregular chain */
+		fields = TCP_LSB_SEQ | TCP_LSB_ACK | TCP_LSB_IP_ID | TCP_LSB_TS;
+	}
+	else
+	{
+		/* seq_X and rnd_X packets use fixed LSB widths, only the TS option in
+		 * the irregular chain depends on the W-LSB windows */
+		fields = TCP_LSB_TS;
 	}
 
-	return true;
+	return fields;
+}
+
+
+/**
+ * @brief Add the values of the current packet to the W-LSB windows
+ *
+ * Called once the packet is built, so that the numbers of LSB bits required
+ * by the current packet were all computed against the previous values.
+ *
+ * @param context  The compression context
+ * @param tcp      The uncompressed TCP header that was compressed
+ */
+static void tcp_update_lsb_windows(struct rohc_comp_ctxt *const context,
+                                   const struct tcphdr *const tcp)
+{
+	struct sc_tcp_context *const tcp_context = context->specific;
+	const ip_context_t *const inner_ip_ctxt =
+		&(tcp_context->ip_contexts[tcp_context->ip_contexts_nr - 1]);
+	const uint16_t msn = tcp_context->msn;
+	const uint32_t values[TCP_WLSB_FIELDS_NR] = {
+		[TCP_WLSB_MSN] = msn,
+		[TCP_WLSB_TTL_HOPL] = tcp_context->tmp.ttl_hopl,
+		[TCP_WLSB_WINDOW] = rohc_ntoh16(tcp->window),
+		[TCP_WLSB_SEQ] = rohc_ntoh32(tcp->seq_num),
+		[TCP_WLSB_ACK] = rohc_ntoh32(tcp->ack_num),
+	};
+
+	/* the fields updated with every packet share one row */
+	c_add_wlsb_multi(tcp_context->msn_wlsb, msn, values);
+	if(inner_ip_ctxt->version == IPV4)
+	{
+		c_add_wlsb(tcp_context->ip_id_wlsb, msn, tcp_context->tmp.ip_id_delta);
+	}
+	if(tcp_context->seq_num_factor != 0)
+	{
+		c_add_wlsb(tcp_context->seq_scaled_wlsb, msn, tcp_context->seq_num_scaled);
+	}
+	if(tcp_context->ack_stride != 0)
+	{
+		c_add_wlsb(tcp_context->ack_scaled_wlsb, msn, tcp_context->ack_num_scaled);
+	}
 }
 
 
@@ -6254,8 +6784,7 @@ static rohc_packet_t tcp_decide_packet(struct rohc_comp_ctxt *const context,
 	switch(context->state)
 	{
 		case ROHC_COMP_STATE_IR: /* The Initialization and Refresh (IR) state */
-			rohc_comp_debug(context, "code IR packet");
-			packet_type = ROHC_PACKET_IR;
+			packet_type = tcp_decide_IR_packet(context);
 			context->ir_count++;
 			break;
 		case ROHC_COMP_STATE_FO: /* The First Order (FO) state */
@@ -6279,6 +6808,138 @@ static rohc_packet_t tcp_decide_packet(struct rohc_comp_ctxt *const context,
 }
 
 
+/**
+ * @brief Decide which packet to send when in IR state.
+ *
+ * The first packets of the context are IR-CR packets if context replication
+ * is enabled and if one recent TCP context may be replicated, IR packets
+ * otherwise. The refreshes of the context are always IR packets, since the
+ * base context might be gone at decompressor.
+ *
+ * @param context  The compression context
+ * @return         ROHC_PACKET_IR or ROHC_PACKET_IR_CR
+ */
+static rohc_packet_t tcp_decide_IR_packet(struct rohc_comp_ctxt *const context)
+{
+	struct sc_tcp_context *const tcp_context = context->specific;
+
+	if((c_features(context->compressor) & ROHC_COMP_FEATURE_CONTEXT_REPLICATION) != 0 &&
+	   context->num_sent_packets < MAX_IR_COUNT)
+	{
+		const struct rohc_comp_ctxt *const base_ctxt =
+			tcp_find_replicate_base(context);
+
+		if(base_ctxt != NULL)
+		{
+			rohc_comp_debug(context, "code IR-CR packet that replicates the base "
+			                "context with CID %zu", base_ctxt->cid);
+			tcp_context->tmp.replicate_base_cid = base_ctxt->cid;
+			return ROHC_PACKET_IR_CR;
+		}
+	}
+
+	rohc_comp_debug(context, "code IR packet");
+	return ROHC_PACKET_IR;
+}
+
+
+/**
+ * @brief Find one recent TCP context that an IR-CR packet may replicate
+ *
+ * Only the \ref C_TCP_REPLICATE_SEARCH_MAX most recently used contexts are
+ * searched. The base context shall be out of the IR state, so that the
+ * decompressor most probably knows it, and shall have the same static part
+ * as the context, TCP ports excepted. Flows with IPv6 extension headers are
+ * not replicated.
+ *
+ * @param context  The compression context
+ * @return         The base context if found, NULL otherwise
+ */
+static const struct rohc_comp_ctxt *
+	tcp_find_replicate_base(const struct rohc_comp_ctxt *const context)
+{
+	const struct sc_tcp_context *const tcp_context = context->specific;
+	const struct rohc_comp_ctxt *base_ctxt;
+	size_t searched_nr = 0;
+	size_t ip_hdr_pos;
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < tcp_context->ip_contexts_nr; ip_hdr_pos++)
+	{
+		if(tcp_context->tmp.ip_exts_nr[ip_hdr_pos] != 0)
+		{
+			return NULL;
+		}
+	}
+
+	for(base_ctxt = context->compressor->lru_first;
+	    base_ctxt != NULL && searched_nr < C_TCP_REPLICATE_SEARCH_MAX;
+	    base_ctxt = base_ctxt->lru_next, searched_nr++)
+	{
+		if(base_ctxt != context &&
+		   base_ctxt->profile == context->profile &&
+		   base_ctxt->state != ROHC_COMP_STATE_IR &&
+		   tcp_is_replicable(tcp_context, base_ctxt->specific))
+		{
+			return base_ctxt;
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Whether the static part of the base context matches the context
+ *
+ * @param tcp_context  The TCP part of the compression context
+ * @param base         The TCP part of the candidate base context
+ * @return             true if the IP headers of both contexts have the same
+ *                     static fields, false otherwise
+ */
+static bool tcp_is_replicable(const struct sc_tcp_context *const tcp_context,
+                              const struct sc_tcp_context *const base)
+{
+	size_t ip_hdr_pos;
+
+	if(base->ip_contexts_nr != tcp_context->ip_contexts_nr)
+	{
+		return false;
+	}
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < tcp_context->ip_contexts_nr; ip_hdr_pos++)
+	{
+		const ip_context_t *const ip_ctxt = &(tcp_context->ip_contexts[ip_hdr_pos]);
+		const ip_context_t *const base_ip_ctxt = &(base->ip_contexts[ip_hdr_pos]);
+
+		if(base_ip_ctxt->version != ip_ctxt->version ||
+		   base_ip_ctxt->opts_nr != 0)
+		{
+			return false;
+		}
+		if(ip_ctxt->version == IPV4)
+		{
+			if(base_ip_ctxt->ctxt.v4.protocol != ip_ctxt->ctxt.v4.protocol ||
+			   base_ip_ctxt->ctxt.v4.src_addr != ip_ctxt->ctxt.v4.src_addr ||
+			   base_ip_ctxt->ctxt.v4.dst_addr != ip_ctxt->ctxt.v4.dst_addr)
+			{
+				return false;
+			}
+		}
+		else
+		{
+			if(base_ip_ctxt->ctxt.v6.next_header != ip_ctxt->ctxt.v6.next_header ||
+			   base_ip_ctxt->ctxt.v6.flow_label != ip_ctxt->ctxt.v6.flow_label ||
+			   base_ip_ctxt->ctxt.v6.addrs != ip_ctxt->ctxt.v6.addrs)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
 /**
  * @brief Decide which packet to send when in FO state.
  *
@@ -6343,6 +7004,9 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 	struct sc_tcp_context *const tcp_context = context->specific;
 	rohc_packet_t packet_type;
 
+	/* the TCP TS option and the MSN tell whether a CO packet is possible */
+	tcp_encode_lsb_fields(context, tcp, TCP_LSB_TS | TCP_LSB_MSN);
+
 	if(tcp_context->tmp.is_ipv6_exts_list_static_changed)
 	{
 		rohc_comp_debug(context, "force packet IR because at least one IPv6 option "
@@ -6392,6 +7056,12 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 		TRACE_GOTO_CHOICE;
 		packet_type = ROHC_PACKET_TCP_CO_COMMON;
 	}
+	else if(context->compressor->effort == ROHC_COMP_EFFORT_FAST)
+	{
+		/* co_common fits all the changes, do not search for a smaller packet */
+		TRACE_GOTO_CHOICE;
+		packet_type = ROHC_PACKET_TCP_CO_COMMON;
+	}
 	else if(tcp_context->tmp.ecn_used_changed ||
 	        tcp_context->tmp.ttl_hopl_changed)
 	{
@@ -6400,6 +7070,8 @@ static rohc_packet_t tcp_decide_FO_SO_packet(const struct rohc_comp_ctxt *const
 		 *  - use common if too many LSB of sequence number are required
 		 *  - use common if too many LSB of innermost TTL/Hop Limit are required
 		 *  - use common if window changed */
+		tcp_encode_lsb_fields(context, tcp, TCP_LSB_IP_ID | TCP_LSB_SEQ |
+		                      TCP_LSB_ACK | TCP_LSB_TTL_HOPL);
 		if(ip_inner_context->ctxt.vx.ip_id_behavior <= IP_ID_BEHAVIOR_SEQ_SWAP &&
 		   tcp_context->tmp.nr_ip_id_bits_3 <= 4 &&
 		   tcp_context->tmp.nr_seq_bits_8191 <= 14 &&
@@ -6487,6 +7159,8 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 		 *  - at most 15 LSB of the TCP ACK number are required,
 		 *  - at most 4 LSBs of IP-ID must be transmitted
 		 * otherwise use co_common packet */
+		tcp_encode_lsb_fields(context, tcp, TCP_LSB_IP_ID | TCP_LSB_SEQ |
+		                      TCP_LSB_ACK | TCP_LSB_TTL_HOPL);
 		if(tcp_context->tmp.nr_ip_id_bits_3 <= 4 &&
 		   tcp_context->tmp.nr_seq_bits_8191 <= 14 &&
 		   tcp_context->tmp.nr_ack_bits_8191 <= 15 &&
@@ -6506,6 +7180,8 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 	else if(tcp_context->tmp.tcp_window_changed)
 	{
 		/* seq_7 or co_common */
+		tcp_encode_lsb_fields(context, tcp, TCP_LSB_WINDOW | TCP_LSB_IP_ID |
+		                      TCP_LSB_ACK);
 		if(!crc7_at_least &&
 		   tcp_context->tmp.nr_window_bits_16383 <= 15 &&
 		   tcp_context->tmp.nr_ip_id_bits_3 <= 5 &&
@@ -6526,6 +7202,8 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 	else if(tcp->ack_flag == 0 || !tcp_context->tmp.tcp_ack_num_changed)
 	{
 		/* seq_2, seq_1 or co_common */
+		tcp_encode_lsb_fields(context, tcp, TCP_LSB_IP_ID | TCP_LSB_SEQ |
+		                      TCP_LSB_SEQ_SCALED | TCP_LSB_ACK);
 		if(!crc7_at_least &&
 		   tcp_context->tmp.nr_ip_id_bits_3 <= 7 &&
 		   tcp_context->seq_num_scaling_nr >= ROHC_INIT_TS_STRIDE_MIN &&
@@ -6561,6 +7239,8 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 	else if(!tcp_context->tmp.tcp_seq_num_changed)
 	{
 		/* seq_4, seq_3, or co_common */
+		tcp_encode_lsb_fields(context, tcp, TCP_LSB_IP_ID | TCP_LSB_SEQ |
+		                      TCP_LSB_ACK | TCP_LSB_ACK_SCALED);
 		if(!crc7_at_least &&
 		   tcp_context->tmp.nr_ip_id_bits_1 <= 3 &&
 		   tcp_is_ack_scaled_possible(tcp_context->ack_stride,
@@ -6595,6 +7275,9 @@ static rohc_packet_t tcp_decide_FO_SO_packet_seq(const struct rohc_comp_ctxt *co
 	{
 		/* sequence and acknowledgment numbers changed:
 		 * seq_6, seq_5, seq_8 or co_common */
+		tcp_encode_lsb_fields(context, tcp, TCP_LSB_IP_ID | TCP_LSB_SEQ |
+		                      TCP_LSB_SEQ_SCALED | TCP_LSB_ACK |
+		                      TCP_LSB_TTL_HOPL);
 		if(!crc7_at_least &&
 		   tcp_context->tmp.nr_ip_id_bits_3 <= 4 &&
 		   tcp_context->seq_num_scaling_nr >= ROHC_INIT_TS_STRIDE_MIN &&
@@ -6660,6 +7343,7 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 	   tcp_context->tcp_opts.tmp.do_list_struct_changed ||
 	   tcp_context->tcp_opts.tmp.do_list_static_changed)
 	{
+		tcp_encode_lsb_fields(context, tcp, TCP_LSB_SEQ | TCP_LSB_ACK);
 		if(!tcp_context->tmp.tcp_window_changed &&
 		   tcp_context->tmp.nr_seq_bits_65535 <= 16 &&
 		   tcp_context->tmp.nr_ack_bits_16383 <= 16)
@@ -6675,6 +7359,8 @@ static rohc_packet_t tcp_decide_FO_SO_packet_rnd(const struct rohc_comp_ctxt *co
 	}
 	else /* unchanged structure of the list of TCP options */
 	{
+		tcp_encode_lsb_fields(context, tcp, TCP_LSB_SEQ | TCP_LSB_SEQ_SCALED |
+		                      TCP_LSB_ACK | TCP_LSB_ACK_SCALED);
 		if(tcp->rsf_flags != 0)
 		{
 			if(!tcp_context->tmp.tcp_window_changed &&
@@ -6834,6 +7520,48 @@ static tcp_ip_id_behavior_t tcp_detect_ip_id_behavior(const uint16_t last_ip_id,
 }
 
 
+/**
+ * @brief Whether the IPv4 Identification field still behaves as predicted
+ *
+ * Only the given behavior is checked, so the function is cheaper than
+ * \ref tcp_detect_ip_id_behavior. It never confirms a behavior that the full
+ * detection would not return. The random behavior cannot be confirmed
+ * without the full detection.
+ *
+ * @param behavior    The IP-ID behavior predicted by the context
+ * @param last_ip_id  The IP-ID value of the previous packet (in HBO)
+ * @param new_ip_id   The IP-ID value of the current packet (in HBO)
+ * @return            true if the IP-ID behaves as predicted,
+ *                    false if the behavior shall be detected again
+ */
+static bool tcp_is_ip_id_behavior_confirmed(const tcp_ip_id_behavior_t behavior,
+                                            const uint16_t last_ip_id,
+                                            const uint16_t new_ip_id)
+{
+	bool is_confirmed;
+
+	switch(behavior)
+	{
+		case IP_ID_BEHAVIOR_SEQ:
+			is_confirmed = is_ip_id_increasing(last_ip_id, new_ip_id);
+			break;
+		case IP_ID_BEHAVIOR_SEQ_SWAP:
+			is_confirmed = (!is_ip_id_increasing(last_ip_id, new_ip_id) &&
+			                is_ip_id_increasing(swab16(last_ip_id), swab16(new_ip_id)));
+			break;
+		case IP_ID_BEHAVIOR_ZERO:
+			is_confirmed = (new_ip_id == 0 && last_ip_id == 0);
+			break;
+		case IP_ID_BEHAVIOR_RAND:
+		default:
+			is_confirmed = false;
+			break;
+	}
+
+	return is_confirmed;
+}
+
+
 /**
  * @brief Detect the behavior of the IP/TCP ECN flags and TCP RES flags
  *
@@ -7144,11 +7872,23 @@ static bool c_tcp_feedback_2(struct rohc_comp_ctxt *const context,
 			/* RFC3095 §5.4.1.1.1: NACKs, downward transition */
 			rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 			          "NACK received for CID %zu", context->cid);
+			rohc_trace_event(context->compressor, ROHC_TRACE_COMP,
+			                 ROHC_TRACE_EVENT_COMP_NACK, context->profile->id,
+			                 context->cid, ROHC_PACKET_UNKNOWN,
+			                 ROHC_FEEDBACK_NACK, 0, 0);
 			/* the compressor transits back to the FO state */
 			if(context->state == ROHC_COMP_STATE_SO)
 			{
 				rohc_comp_change_state(context, ROHC_COMP_STATE_FO);
 			}
+			/* packets were lost or damaged, refresh the context more often */
+			rohc_comp_periodic_refreshes_nack(context);
+			/* packets were lost or damaged, widen the W-LSB windows again */
+			if((c_features(context->compressor) &
+			    ROHC_COMP_FEATURE_ADAPTIVE_WLSB) != 0)
+			{
+				c_tcp_set_wlsb_width(context, rohc_comp_wlsb_width_nack(context));
+			}
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -7158,8 +7898,20 @@ static bool c_tcp_feedback_2(struct rohc_comp_ctxt *const context,
 			/* RFC3095 §5.4.1.1.1: NACKs, downward transition */
 			rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 			          "STATIC-NACK received for CID %zu", context->cid);
+			rohc_trace_event(context->compressor, ROHC_TRACE_COMP,
+			                 ROHC_TRACE_EVENT_COMP_NACK, context->profile->id,
+			                 context->cid, ROHC_PACKET_UNKNOWN,
+			                 ROHC_FEEDBACK_STATIC_NACK, 0, 0);
 			/* the compressor transits back to the IR state */
 			rohc_comp_change_state(context, ROHC_COMP_STATE_IR);
+			/* packets were lost or damaged, refresh the context more often */
+			rohc_comp_periodic_refreshes_nack(context);
+			/* packets were lost or damaged, widen the W-LSB windows again */
+			if((c_features(context->compressor) &
+			    ROHC_COMP_FEATURE_ADAPTIVE_WLSB) != 0)
+			{
+				c_tcp_set_wlsb_width(context, rohc_comp_wlsb_width_nack(context));
+			}
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -7225,29 +7977,15 @@ static void c_tcp_feedback_ack(struct rohc_comp_ctxt *const context,
 	{
 		size_t acked_nr;
 
-		/* ack TTL or Hop Limit */
-		acked_nr = wlsb_ack(tcp_context->ttl_hopl_wlsb, sn_bits, sn_bits_nr);
-		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-		                "from TTL or Hop Limit W-LSB", acked_nr);
 		/* ack innermost IP-ID */
 		acked_nr = wlsb_ack(tcp_context->ip_id_wlsb, sn_bits, sn_bits_nr);
 		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
 		                "from innermost IP-ID W-LSB", acked_nr);
-		/* ack TCP window */
-		acked_nr = wlsb_ack(tcp_context->window_wlsb, sn_bits, sn_bits_nr);
-		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-		                "from TCP window W-LSB", acked_nr);
-		/* ack TCP (scaled) sequence number */
-		acked_nr = wlsb_ack(tcp_context->seq_wlsb, sn_bits, sn_bits_nr);
-		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-		                "from TCP sequence number W-LSB", acked_nr);
+		/* ack TCP scaled sequence number */
 		acked_nr = wlsb_ack(tcp_context->seq_scaled_wlsb, sn_bits, sn_bits_nr);
 		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
 		                "from TCP scaled sequence number W-LSB", acked_nr);
-		/* ack TCP (scaled) acknowledgment number */
-		acked_nr = wlsb_ack(tcp_context->ack_wlsb, sn_bits, sn_bits_nr);
-		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-		                "from TCP acknowledgment number W-LSB", acked_nr);
+		/* ack TCP scaled acknowledgment number */
 		acked_nr = wlsb_ack(tcp_context->ack_scaled_wlsb, sn_bits, sn_bits_nr);
 		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
 		                "from TCP scaled acknowledgment number W-LSB", acked_nr);
@@ -7258,14 +7996,70 @@ static void c_tcp_feedback_ack(struct rohc_comp_ctxt *const context,
 		acked_nr = wlsb_ack(tcp_context->tcp_opts.ts_reply_wlsb, sn_bits, sn_bits_nr);
 		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
 		                "from TCP TS reply W-LSB", acked_nr);
-		/* ack SN */
+		/* ack SN, TTL or Hop Limit, TCP window, sequence and ACK numbers at
+		 * once since they share the same rows */
 		acked_nr = wlsb_ack(tcp_context->msn_wlsb, sn_bits, sn_bits_nr);
 		rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu values "
-		                "from SN W-LSB", acked_nr);
+		                "from SN, TTL or Hop Limit, TCP window, sequence and "
+		                "ACK numbers W-LSB", acked_nr);
+
+		/* O- and R-modes: size the W-LSB windows from the packets in flight
+		 * between the acknowledged packet and the latest one */
+		if((c_features(context->compressor) & ROHC_COMP_FEATURE_ADAPTIVE_WLSB) != 0 &&
+		   context->mode != ROHC_U_MODE)
+		{
+			const size_t width =
+				rohc_comp_wlsb_width_ack(context, tcp_context->msn, sn_bits, sn_bits_nr);
+			c_tcp_set_wlsb_width(context, width);
+		}
 	}
 }
 
 
+/**
+ * @brief Set the number of entries kept in the W-LSB windows of the context
+ *
+ * @param context  The compression context
+ * @param width    The number of entries to keep in the W-LSB windows
+ */
+static void c_tcp_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                 const size_t width)
+{
+	struct sc_tcp_context *const tcp_context = context->specific;
+
+	c_wlsb_set_width(tcp_context->ip_id_wlsb, width);
+	c_wlsb_set_width(tcp_context->seq_scaled_wlsb, width);
+	c_wlsb_set_width(tcp_context->ack_scaled_wlsb, width);
+	c_wlsb_set_width(tcp_context->tcp_opts.ts_req_wlsb, width);
+	c_wlsb_set_width(tcp_context->tcp_opts.ts_reply_wlsb, width);
+	/* the TTL, window, sequence and ACK numbers share the MSN window */
+	c_wlsb_set_width(tcp_context->msn_wlsb, width);
+}
+
+
+/**
+ * @brief Get the maximum length one TCP context takes in a memory block
+ *
+ * @param wlsb_width  The width of the W-LSB sliding windows
+ * @return            The maximum number of bytes of the memory block the
+ *                    profile-specific part of the context takes
+ */
+static size_t c_tcp_mem_max(const size_t wlsb_width)
+{
+	/* the profile part, its windows, the cache of the static chain, then the
+	 * contexts of the IPv6 extension headers and the addresses of every IPv6
+	 * header if they are not shared */
+	return (rohc_slab_block_mem_max(sizeof(struct sc_tcp_context)) +
+	        c_wlsb_mem_max(TCP_WLSB_FIELDS_NR, wlsb_width) +
+	        3 * c_wlsb_mem_max(1, wlsb_width) + 2 * c_wlsb_mem_max(1, 4) +
+	        rohc_slab_block_mem_max(sizeof(struct sc_tcp_static_chain)) +
+	        ROHC_TCP_MAX_IP_HDRS *
+	        (rohc_slab_block_mem_max(sizeof(ip_option_context_t) *
+	                                 ROHC_TCP_MAX_IP_EXT_HDRS) +
+	         rohc_intern_entry_mem_max(sizeof(struct ipv6_addr) * 2)));
+}
+
+
 /**
  * @brief Define the compression part of the TCP profile as described
  *        in the RFC 3095.
@@ -7281,5 +8075,9 @@ const struct rohc_comp_profile c_tcp_profile =
 	.encode         = c_tcp_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = c_tcp_feedback,
+	.get_msn        = c_tcp_get_msn,
+	.set_next_msn   = c_tcp_set_next_msn,
+	.prefetch       = c_tcp_prefetch,
+	.get_mem_max    = c_tcp_mem_max,
 };
 
@@ -39,6 +39,20 @@
 /** The length of the table mapping for TCP options */
 #define TCP_LIST_ITEM_MAP_LEN  16U
 
+/**
+ * @brief The maximum length (in bytes) of the TCP option EOL
+ *
+ * The TCP profile encodes the length of the EOL option in bits (minus the
+ * first 8 type bits) in a 8-bit field.
+ */
+#define TCP_OLEN_EOL_MAX  ((0xffU + 8U) / 8U)
+
+/** The minimum length (in bytes) of the TCP option SACK: one SACK block */
+#define TCP_OLEN_SACK_MIN  (2U + sizeof(sack_block_t))
+
+/** The maximum length (in bytes) of the TCP option SACK */
+#define TCP_OLEN_SACK_MAX  (2U + TCP_SACK_BLOCKS_MAX_NR * sizeof(sack_block_t))
+
 
 /** The definition of one TCP option for the compressor */
 struct c_tcp_opt
@@ -48,14 +62,40 @@ struct c_tcp_opt
 	uint8_t kind;         /**< The type of the option */
 	char descr[255];      /**< A text description of the option */
 
+	/** Whether the option is a 'static option' or not, ie. whether its changes
+	 *  cannot be transmitted in the irregular chain */
+	bool is_static;
+	/** Whether the list item of the option is empty in CO headers or not */
+	bool is_item_empty;
+	/** The minimal length (in bytes) of the option */
+	uint8_t min_len;
+	/** The maximal length (in bytes) of the option */
+	uint8_t max_len;
+	/** The step (in bytes) between two acceptable lengths of the option */
+	uint8_t len_step;
+
 	/** The function to code the list item for the TCP option */
 	int (*build_list_item)(const struct rohc_comp_ctxt *const context,
 	                       const struct tcphdr *const tcp,
+	                       struct c_tcp_opts_ctxt *const opts_ctxt,
 	                       const uint8_t *const uncomp_opt,
 	                       const uint8_t uncomp_opt_len,
 	                       uint8_t *const comp_opt,
 	                       const size_t comp_opt_max_len)
-		__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+		__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
+
+	/** The function to code the irregular part for the TCP option */
+	int (*build_irreg)(const struct rohc_comp_ctxt *const context,
+	                   const struct tcphdr *const tcp,
+	                   const uint16_t msn,
+	                   struct c_tcp_opts_ctxt *const opts_ctxt,
+	                   const uint8_t opt_idx,
+	                   const uint8_t *const uncomp_opts,
+	                   const size_t uncomp_opt_offset,
+	                   const uint8_t uncomp_opt_len,
+	                   uint8_t *const comp_opt,
+	                   const size_t comp_opt_max_len)
+		__attribute__((warn_unused_result, nonnull(1, 2, 4, 6, 9)));
 };
 
 
@@ -114,120 +154,343 @@ bool c_tcp_is_list_item_needed(const struct rohc_comp_ctxt *const context,
 
 static int c_tcp_build_nop_list_item(const struct rohc_comp_ctxt *const context,
                                      const struct tcphdr *const tcp,
+                                     struct c_tcp_opts_ctxt *const opts_ctxt,
                                      const uint8_t *const uncomp_opt,
                                      const uint8_t uncomp_opt_len,
                                      uint8_t *const comp_opt,
                                      const size_t comp_opt_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 static int c_tcp_build_eol_list_item(const struct rohc_comp_ctxt *const context,
                                      const struct tcphdr *const tcp,
+                                     struct c_tcp_opts_ctxt *const opts_ctxt,
                                      const uint8_t *const uncomp_opt,
                                      const uint8_t uncomp_opt_len,
                                      uint8_t *const comp_opt,
                                      const size_t comp_opt_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 static int c_tcp_build_mss_list_item(const struct rohc_comp_ctxt *const context,
                                      const struct tcphdr *const tcp,
+                                     struct c_tcp_opts_ctxt *const opts_ctxt,
                                      const uint8_t *const uncomp_opt,
                                      const uint8_t uncomp_opt_len,
                                      uint8_t *const comp_opt,
                                      const size_t comp_opt_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 static int c_tcp_build_ws_list_item(const struct rohc_comp_ctxt *const context,
                                     const struct tcphdr *const tcp,
+                                    struct c_tcp_opts_ctxt *const opts_ctxt,
                                     const uint8_t *const uncomp_opt,
                                     const uint8_t uncomp_opt_len,
                                     uint8_t *const comp_opt,
                                     const size_t comp_opt_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 static int c_tcp_build_ts_list_item(const struct rohc_comp_ctxt *const context,
                                     const struct tcphdr *const tcp,
+                                    struct c_tcp_opts_ctxt *const opts_ctxt,
                                     const uint8_t *const uncomp_opt,
                                     const uint8_t uncomp_opt_len,
                                     uint8_t *const comp_opt,
                                     const size_t comp_opt_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 static int c_tcp_build_sack_perm_list_item(const struct rohc_comp_ctxt *const context,
                                            const struct tcphdr *const tcp,
+                                           struct c_tcp_opts_ctxt *const opts_ctxt,
                                            const uint8_t *const uncomp_opt,
                                            const uint8_t uncomp_opt_len,
                                            uint8_t *const comp_opt,
                                            const size_t comp_opt_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 static int c_tcp_build_sack_list_item(const struct rohc_comp_ctxt *const context,
                                       const struct tcphdr *const tcp,
+                                      struct c_tcp_opts_ctxt *const opts_ctxt,
                                       const uint8_t *const uncomp_opt,
                                       const uint8_t uncomp_opt_len,
                                       uint8_t *const comp_opt,
                                       const size_t comp_opt_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
 
 static int c_tcp_build_generic_list_item(const struct rohc_comp_ctxt *const context,
                                          const struct tcphdr *const tcp,
+                                         struct c_tcp_opts_ctxt *const opts_ctxt,
                                          const uint8_t *const uncomp_opt,
                                          const uint8_t uncomp_opt_len,
                                          uint8_t *const comp_opt,
                                          const size_t comp_opt_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 6)));
+
+static int c_tcp_build_no_irreg(const struct rohc_comp_ctxt *const context,
+                                const struct tcphdr *const tcp,
+                                const uint16_t msn,
+                                struct c_tcp_opts_ctxt *const opts_ctxt,
+                                const uint8_t opt_idx,
+                                const uint8_t *const uncomp_opts,
+                                const size_t uncomp_opt_offset,
+                                const uint8_t uncomp_opt_len,
+                                uint8_t *const comp_opt,
+                                const size_t comp_opt_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 6, 9)));
+
+static int c_tcp_build_ts_irreg(const struct rohc_comp_ctxt *const context,
+                                const struct tcphdr *const tcp,
+                                const uint16_t msn,
+                                struct c_tcp_opts_ctxt *const opts_ctxt,
+                                const uint8_t opt_idx,
+                                const uint8_t *const uncomp_opts,
+                                const size_t uncomp_opt_offset,
+                                const uint8_t uncomp_opt_len,
+                                uint8_t *const comp_opt,
+                                const size_t comp_opt_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 6, 9)));
+
+static int c_tcp_build_sack_irreg(const struct rohc_comp_ctxt *const context,
+                                  const struct tcphdr *const tcp,
+                                  const uint16_t msn,
+                                  struct c_tcp_opts_ctxt *const opts_ctxt,
+                                  const uint8_t opt_idx,
+                                  const uint8_t *const uncomp_opts,
+                                  const size_t uncomp_opt_offset,
+                                  const uint8_t uncomp_opt_len,
+                                  uint8_t *const comp_opt,
+                                  const size_t comp_opt_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 6, 9)));
+
+static int c_tcp_build_generic_irreg(const struct rohc_comp_ctxt *const context,
+                                     const struct tcphdr *const tcp,
+                                     const uint16_t msn,
+                                     struct c_tcp_opts_ctxt *const opts_ctxt,
+                                     const uint8_t opt_idx,
+                                     const uint8_t *const uncomp_opts,
+                                     const size_t uncomp_opt_offset,
+                                     const uint8_t uncomp_opt_len,
+                                     uint8_t *const comp_opt,
+                                     const size_t comp_opt_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 6, 9)));
 
 
-/* The definitions of all the TCP options supported by the compressor */
-static struct c_tcp_opt c_tcp_opts[MAX_TCP_OPTION_INDEX + 1] =
+/**
+ * @brief The definitions of all the TCP options supported by the compressor
+ *
+ * The table is indexed by the compression index of the TCP options, use
+ * \e c_tcp_type2index to get the index of a well-known TCP option from its
+ * type. All the options without a reserved index share the generic
+ * descriptors.
+ */
+static const struct c_tcp_opt c_tcp_opts[MAX_TCP_OPTION_INDEX + 1] =
 {
-	[TCP_INDEX_NOP]       = { TCP_INDEX_NOP, true, TCP_OPT_NOP,
-	                          "No Operation (NOP)",
-	                          c_tcp_build_nop_list_item },
-	[TCP_INDEX_EOL]       = { TCP_INDEX_EOL, true, TCP_OPT_EOL,
-	                          "End of Option List (EOL)",
-	                          c_tcp_build_eol_list_item },
-	[TCP_INDEX_MSS]       = { TCP_INDEX_MSS, true, TCP_OPT_MSS,
-	                          "Maximum Segment Size (MSS)",
-	                          c_tcp_build_mss_list_item },
-	[TCP_INDEX_WS]        = { TCP_INDEX_WS, true, TCP_OPT_WS,
-	                          "Window Scale (WS)",
-	                          c_tcp_build_ws_list_item },
-	[TCP_INDEX_TS]        = { TCP_INDEX_TS, true, TCP_OPT_TS,
-	                          "Timestamps (TS)",
-	                          c_tcp_build_ts_list_item },
-	[TCP_INDEX_SACK_PERM] = { TCP_INDEX_SACK_PERM, true, TCP_OPT_SACK_PERM,
-	                          "Selective Acknowledgment Permitted (SACK)",
-	                          c_tcp_build_sack_perm_list_item },
-	[TCP_INDEX_SACK]      = { TCP_INDEX_SACK, true, TCP_OPT_SACK,
-	                          "Selective Acknowledgment (SACK)",
-	                          c_tcp_build_sack_list_item },
-	[TCP_INDEX_GENERIC7]  = { TCP_INDEX_GENERIC7, false, 0,
-	                          "generic index 7",
-	                          c_tcp_build_generic_list_item },
-	[TCP_INDEX_GENERIC8]  = { TCP_INDEX_GENERIC8, false, 0,
-	                          "generic index 8",
-	                          c_tcp_build_generic_list_item },
-	[TCP_INDEX_GENERIC9]  = { TCP_INDEX_GENERIC9, false, 0,
-	                          "generic index 9",
-	                          c_tcp_build_generic_list_item },
-	[TCP_INDEX_GENERIC10] = { TCP_INDEX_GENERIC10, false, 0,
-	                          "generic index 10",
-	                          c_tcp_build_generic_list_item },
-	[TCP_INDEX_GENERIC11] = { TCP_INDEX_GENERIC11, false, 0,
-	                          "generic index 11",
-	                          c_tcp_build_generic_list_item },
-	[TCP_INDEX_GENERIC12] = { TCP_INDEX_GENERIC12, false, 0,
-	                          "generic index 12",
-	                          c_tcp_build_generic_list_item },
-	[TCP_INDEX_GENERIC13] = { TCP_INDEX_GENERIC13, false, 0,
-	                          "generic index 13",
-	                          c_tcp_build_generic_list_item },
-	[TCP_INDEX_GENERIC14] = { TCP_INDEX_GENERIC14, false, 0,
-	                          "generic index 14",
-	                          c_tcp_build_generic_list_item },
-	[TCP_INDEX_GENERIC15] = { TCP_INDEX_GENERIC15, false, 0,
-	                          "generic index 15",
-	                          c_tcp_build_generic_list_item },
+	[TCP_INDEX_NOP] = {
+		.index = TCP_INDEX_NOP,
+		.is_well_known = true,
+		.kind = TCP_OPT_NOP,
+		.descr = "No Operation (NOP)",
+		.is_static = false,
+		.is_item_empty = true,
+		.min_len = 1U,
+		.max_len = 1U,
+		.len_step = 1U,
+		.build_list_item = c_tcp_build_nop_list_item,
+		.build_irreg = c_tcp_build_no_irreg,
+	},
+	[TCP_INDEX_EOL] = {
+		.index = TCP_INDEX_EOL,
+		.is_well_known = true,
+		.kind = TCP_OPT_EOL,
+		.descr = "End of Option List (EOL)",
+		.is_static = true,
+		.is_item_empty = false,
+		.min_len = 1U,
+		.max_len = TCP_OLEN_EOL_MAX,
+		.len_step = 1U,
+		.build_list_item = c_tcp_build_eol_list_item,
+		.build_irreg = c_tcp_build_no_irreg,
+	},
+	[TCP_INDEX_MSS] = {
+		.index = TCP_INDEX_MSS,
+		.is_well_known = true,
+		.kind = TCP_OPT_MSS,
+		.descr = "Maximum Segment Size (MSS)",
+		.is_static = true,
+		.is_item_empty = false,
+		.min_len = TCP_OLEN_MSS,
+		.max_len = TCP_OLEN_MSS,
+		.len_step = 1U,
+		.build_list_item = c_tcp_build_mss_list_item,
+		.build_irreg = c_tcp_build_no_irreg,
+	},
+	[TCP_INDEX_WS] = {
+		.index = TCP_INDEX_WS,
+		.is_well_known = true,
+		.kind = TCP_OPT_WS,
+		.descr = "Window Scale (WS)",
+		.is_static = true,
+		.is_item_empty = false,
+		.min_len = TCP_OLEN_WS,
+		.max_len = TCP_OLEN_WS,
+		.len_step = 1U,
+		.build_list_item = c_tcp_build_ws_list_item,
+		.build_irreg = c_tcp_build_no_irreg,
+	},
+	[TCP_INDEX_TS] = {
+		.index = TCP_INDEX_TS,
+		.is_well_known = true,
+		.kind = TCP_OPT_TS,
+		.descr = "Timestamps (TS)",
+		.is_static = false,
+		.is_item_empty = false,
+		.min_len = TCP_OLEN_TS,
+		.max_len = TCP_OLEN_TS,
+		.len_step = 1U,
+		.build_list_item = c_tcp_build_ts_list_item,
+		.build_irreg = c_tcp_build_ts_irreg,
+	},
+	[TCP_INDEX_SACK_PERM] = {
+		.index = TCP_INDEX_SACK_PERM,
+		.is_well_known = true,
+		.kind = TCP_OPT_SACK_PERM,
+		.descr = "Selective Acknowledgment Permitted (SACK)",
+		.is_static = false,
+		.is_item_empty = true,
+		.min_len = TCP_OLEN_SACK_PERM,
+		.max_len = TCP_OLEN_SACK_PERM,
+		.len_step = 1U,
+		.build_list_item = c_tcp_build_sack_perm_list_item,
+		.build_irreg = c_tcp_build_no_irreg,
+	},
+	[TCP_INDEX_SACK] = {
+		.index = TCP_INDEX_SACK,
+		.is_well_known = true,
+		.kind = TCP_OPT_SACK,
+		.descr = "Selective Acknowledgment (SACK)",
+		.is_static = false,
+		.is_item_empty = false,
+		.min_len = TCP_OLEN_SACK_MIN,
+		.max_len = TCP_OLEN_SACK_MAX,
+		.len_step = sizeof(sack_block_t),
+		.build_list_item = c_tcp_build_sack_list_item,
+		.build_irreg = c_tcp_build_sack_irreg,
+	},
+	[TCP_INDEX_GENERIC7] = {
+		.index = TCP_INDEX_GENERIC7,
+		.is_well_known = false,
+		.kind = 0,
+		.descr = "generic index 7",
+		.is_static = false,
+		.is_item_empty = false,
+		.min_len = 2U,
+		.max_len = 0xffU,
+		.len_step = 1U,
+		.build_list_item = c_tcp_build_generic_list_item,
+		.build_irreg = c_tcp_build_generic_irreg,
+	},
+	[TCP_INDEX_GENERIC8] = {
+		.index = TCP_INDEX_GENERIC8,
+		.is_well_known = false,
+		.kind = 0,
+		.descr = "generic index 8",
+		.is_static = false,
+		.is_item_empty = false,
+		.min_len = 2U,
+		.max_len = 0xffU,
+		.len_step = 1U,
+		.build_list_item = c_tcp_build_generic_list_item,
+		.build_irreg = c_tcp_build_generic_irreg,
+	},
+	[TCP_INDEX_GENERIC9] = {
+		.index = TCP_INDEX_GENERIC9,
+		.is_well_known = false,
+		.kind = 0,
+		.descr = "generic index 9",
+		.is_static = false,
+		.is_item_empty = false,
+		.min_len = 2U,
+		.max_len = 0xffU,
+		.len_step = 1U,
+		.build_list_item = c_tcp_build_generic_list_item,
+		.build_irreg = c_tcp_build_generic_irreg,
+	},
+	[TCP_INDEX_GENERIC10] = {
+		.index = TCP_INDEX_GENERIC10,
+		.is_well_known = false,
+		.kind = 0,
+		.descr = "generic index 10",
+		.is_static = false,
+		.is_item_empty = false,
+		.min_len = 2U,
+		.max_len = 0xffU,
+		.len_step = 1U,
+		.build_list_item = c_tcp_build_generic_list_item,
+		.build_irreg = c_tcp_build_generic_irreg,
+	},
+	[TCP_INDEX_GENERIC11] = {
+		.index = TCP_INDEX_GENERIC11,
+		.is_well_known = false,
+		.kind = 0,
+		.descr = "generic index 11",
+		.is_static = false,
+		.is_item_empty = false,
+		.min_len = 2U,
+		.max_len = 0xffU,
+		.len_step = 1U,
+		.build_list_item = c_tcp_build_generic_list_item,
+		.build_irreg = c_tcp_build_generic_irreg,
+	},
+	[TCP_INDEX_GENERIC12] = {
+		.index = TCP_INDEX_GENERIC12,
+		.is_well_known = false,
+		.kind = 0,
+		.descr = "generic index 12",
+		.is_static = false,
+		.is_item_empty = false,
+		.min_len = 2U,
+		.max_len = 0xffU,
+		.len_step = 1U,
+		.build_list_item = c_tcp_build_generic_list_item,
+		.build_irreg = c_tcp_build_generic_irreg,
+	},
+	[TCP_INDEX_GENERIC13] = {
+		.index = TCP_INDEX_GENERIC13,
+		.is_well_known = false,
+		.kind = 0,
+		.descr = "generic index 13",
+		.is_static = false,
+		.is_item_empty = false,
+		.min_len = 2U,
+		.max_len = 0xffU,
+		.len_step = 1U,
+		.build_list_item = c_tcp_build_generic_list_item,
+		.build_irreg = c_tcp_build_generic_irreg,
+	},
+	[TCP_INDEX_GENERIC14] = {
+		.index = TCP_INDEX_GENERIC14,
+		.is_well_known = false,
+		.kind = 0,
+		.descr = "generic index 14",
+		.is_static = false,
+		.is_item_empty = false,
+		.min_len = 2U,
+		.max_len = 0xffU,
+		.len_step = 1U,
+		.build_list_item = c_tcp_build_generic_list_item,
+		.build_irreg = c_tcp_build_generic_irreg,
+	},
+	[TCP_INDEX_GENERIC15] = {
+		.index = TCP_INDEX_GENERIC15,
+		.is_well_known = false,
+		.kind = 0,
+		.descr = "generic index 15",
+		.is_static = false,
+		.is_item_empty = false,
+		.min_len = 2U,
+		.max_len = 0xffU,
+		.len_step = 1U,
+		.build_list_item = c_tcp_build_generic_list_item,
+		.build_irreg = c_tcp_build_generic_irreg,
+	},
 };
 
 
@@ -289,7 +552,7 @@ bool rohc_comp_tcp_are_options_acceptable(const struct rohc_comp *const comp,
                                           const size_t data_offset)
 {
 	const size_t opts_len = data_offset * sizeof(uint32_t) - sizeof(struct tcphdr);
-	uint8_t opt_types_count[TCP_OPT_MAX + 1] = { 0 };
+	uint32_t opt_types_seen[(TCP_OPT_MAX + 1) / 32] = { 0 };
 	size_t opts_offset;
 	size_t opt_pos;
 	uint8_t opt_len;
@@ -299,6 +562,8 @@ bool rohc_comp_tcp_are_options_acceptable(const struct rohc_comp *const comp,
 	    opt_pos < ROHC_TCP_OPTS_MAX_PROTO && opts_offset < opts_len;
 	    opt_pos++, opts_offset += opt_len)
 	{
+		const struct c_tcp_opt *opt_descr;
+		uint32_t opt_type_bit;
 		uint8_t opt_type;
 
 		/* get type and length of the next TCP option */
@@ -314,118 +579,54 @@ bool rohc_comp_tcp_are_options_acceptable(const struct rohc_comp *const comp,
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "TCP option %u found", opt_type);
 
-		if(opt_types_count[opt_type] >= 255)
+		/* TCP options shall occur at most once, except EOL and NOP */
+		opt_type_bit = 1U << (opt_type % 32);
+		if((opt_types_seen[opt_type / 32] & opt_type_bit) != 0 &&
+		   opt_type != TCP_OPT_EOL && opt_type != TCP_OPT_NOP)
 		{
 			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "too many TCP options of type %u", opt_type);
+			           "malformed TCP options: TCP option '%s' (%u) should "
+			           "occur at most once", tcp_opt_get_descr(opt_type), opt_type);
 			goto bad_opts;
 		}
-		opt_types_count[opt_type]++;
+		opt_types_seen[opt_type / 32] |= opt_type_bit;
 
-		/* check the well-known options in order to avoid using the TCP profile with
-		 * malformed TCP packets */
-		switch(opt_type)
+		/* check the length of the well-known options in order to avoid using
+		 * the TCP profile with malformed TCP packets */
+		if(opt_type < TCP_LIST_ITEM_MAP_LEN && c_tcp_type2index[opt_type] >= 0)
 		{
-			case TCP_OPT_EOL:
-			{
-				const size_t max_eol_opt_len = (0xff + 8) / 8;
-				size_t i;
+			opt_descr = &(c_tcp_opts[c_tcp_type2index[opt_type]]);
+		}
+		else
+		{
+			opt_descr = &(c_tcp_opts[TCP_INDEX_GENERIC7]);
+		}
+		if(opt_len < opt_descr->min_len || opt_len > opt_descr->max_len ||
+		   ((opt_len - opt_descr->min_len) % opt_descr->len_step) != 0)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "malformed TCP option #%zu: unexpected length for %s "
+			           "option: %u found in packet while [%u-%u] expected",
+			           opt_pos + 1, tcp_opt_get_descr(opt_type), opt_len,
+			           opt_descr->min_len, opt_descr->max_len);
+			goto bad_opts;
+		}
 
-				/* the TCP profile encodes the length of the EOL option in bits
-				 * (minus the first 8 type bits) in a 8-bit field, so reject TCP
-				 * packets with a large EOL option */
-				if(opt_len > max_eol_opt_len)
-				{
-					rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-					           "unexpected TCP header: %u-byte option EOL cannot be "
-					           "compressed with the TCP profile (%zu bytes max)",
-					           opt_len, max_eol_opt_len);
-					goto bad_opts;
-				}
+		/* TCP option EOL bytes shall all be zeroes */
+		if(opt_type == TCP_OPT_EOL)
+		{
+			size_t i;
 
-				/* TCP option EOL bytes shall all be zeroes */
-				for(i = 0; i < opt_len; i++)
-				{
-					if(opts[opts_offset + i] != TCP_OPT_EOL)
-					{
-						rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-						           "malformed TCP header: malformed option padding: "
-						           "padding byte #%zu is 0x%02x while it should be 0x00",
-						           i + 1, opts[opts_offset + i]);
-						goto bad_opts;
-					}
-				}
-				break;
-			}
-			case TCP_OPT_MSS:
-			{
-				if(opt_len != TCP_OLEN_MSS)
-				{
-					rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-					           "malformed TCP option #%zu: unexpected length for MSS "
-					           "option: %u found in packet while %u expected",
-					           opt_pos + 1, opt_len, TCP_OLEN_MSS);
-					goto bad_opts;
-				}
-				break;
-			}
-			case TCP_OPT_WS:
-			{
-				if(opt_len != TCP_OLEN_WS)
-				{
-					rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-					           "malformed TCP option #%zu: unexpected length for WS "
-					           "option: %u found in packet while %u expected",
-					           opt_pos + 1, opt_len, TCP_OLEN_WS);
-					goto bad_opts;
-				}
-				break;
-			}
-			case TCP_OPT_SACK_PERM:
+			for(i = 0; i < opt_len; i++)
 			{
-				if(opt_len != TCP_OLEN_SACK_PERM)
+				if(opts[opts_offset + i] != TCP_OPT_EOL)
 				{
 					rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-					           "malformed TCP option #%zu: unexpected length for SACK "
-					           "Permitted option: %u found in packet while %u expected",
-					           opt_pos + 1, opt_len, TCP_OLEN_SACK_PERM);
+					           "malformed TCP header: malformed option padding: "
+					           "padding byte #%zu is 0x%02x while it should be 0x00",
+					           i + 1, opts[opts_offset + i]);
 					goto bad_opts;
 				}
-				break;
-			}
-			case TCP_OPT_SACK:
-			{
-				size_t sack_blocks_remain = (opt_len - 2) % sizeof(sack_block_t);
-				size_t sack_blocks_nr = (opt_len - 2) / sizeof(sack_block_t);
-				if(sack_blocks_remain != 0 ||
-				   sack_blocks_nr == 0 ||
-				   sack_blocks_nr > TCP_SACK_BLOCKS_MAX_NR)
-				{
-					rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-					           "malformed TCP option #%zu: unexpected length for "
-					           "SACK option: %u found in packet while 2 + [1-4] "
-					           "* %zu expected", opt_pos + 1, opt_len,
-					           sizeof(sack_block_t));
-					goto bad_opts;
-				}
-				break;
-			}
-			case TCP_OPT_TS:
-			{
-				if(opt_len != TCP_OLEN_TS)
-				{
-					rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-					           "malformed TCP option #%zu: unexpected length for TS "
-					           "option: %u found in packet while %u expected",
-					           opt_pos + 1, opt_len, TCP_OLEN_TS);
-					goto bad_opts;
-				}
-				break;
-			}
-			default:
-			{
-				/* nothing to check for other options */
-				break;
 			}
 		}
 	}
@@ -440,26 +641,6 @@ bool rohc_comp_tcp_are_options_acceptable(const struct rohc_comp *const comp,
 		goto bad_opts;
 	}
 
-	/* TCP options shall occur at most once, except EOL and NOP */
-	{
-		unsigned int opt_type;
-
-		for(opt_type = 0; opt_type <= TCP_OPT_MAX; opt_type++)
-		{
-			if(opt_type != TCP_OPT_EOL &&
-			   opt_type != TCP_OPT_NOP &&
-			   opt_types_count[opt_type] > 1)
-			{
-				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				           "malformed TCP options: TCP option '%s' (%u) should "
-				           "occur at most once, but it was found %u times",
-				           tcp_opt_get_descr(opt_type), opt_type,
-				           opt_types_count[opt_type]);
-				goto bad_opts;
-			}
-		}
-	}
-
 	return true;
 
 bad_opts:
@@ -483,6 +664,7 @@ bool tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
                                 size_t *const opts_len)
 {
 	bool indexes_in_use[MAX_TCP_OPTION_INDEX + 1] = { false };
+	uint8_t structure[ROHC_TCP_OPTS_MAX];
 	uint8_t *opts;
 	size_t opt_pos;
 	uint8_t opt_len;
@@ -545,7 +727,7 @@ bool tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 		 * transmitted in irregular chain if their value changed, so the compressor
 		 * needs to detect such changes and to select a packet type that can
 		 * transmit their changes, ie. IR, IR-DYN, co_common, rnd_8 or seq_8 */
-		if(opt_type == TCP_OPT_EOL || opt_type == TCP_OPT_MSS || opt_type == TCP_OPT_WS)
+		if(c_tcp_opts[opt_idx].is_static)
 		{
 			if(opts_ctxt->list[opt_idx].used &&
 			   c_tcp_opt_changed(opts_ctxt, opt_idx, opts + opts_offset, opt_len))
@@ -584,23 +766,8 @@ bool tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 			opts_ctxt->tmp.idx_max = opt_idx;
 		}
 
-		/* was the TCP option present at the very same location in previous
-		 * packet? */
-		if(opt_pos >= opts_ctxt->structure_nr ||
-		   opts_ctxt->structure[opt_pos] != opt_type)
-		{
-			rohc_comp_debug(context, "    option was not present at the very "
-			                "same location in previous packet");
-			opts_ctxt->tmp.do_list_struct_changed = true;
-		}
-		else
-		{
-			rohc_comp_debug(context, "    option was at the very same location "
-			                "in previous packet");
-		}
-
-		/* record the structure of the current list TCP options in context */
-		opts_ctxt->structure[opt_pos] = opt_type;
+		/* record the structure of the current list of TCP options */
+		structure[opt_pos] = opt_type;
 	}
 	if(opt_pos >= ROHC_TCP_OPTS_MAX && opts_offset != (*opts_len))
 	{
@@ -611,20 +778,18 @@ bool tcp_detect_options_changes(struct rohc_comp_ctxt *const context,
 	}
 	opts_nr = opt_pos;
 
-	/* fewer options than in previous packet? */
-	for(opt_pos = opts_nr; opt_pos < opts_ctxt->structure_nr; opt_pos++)
-	{
-		rohc_comp_debug(context, "  TCP option %d is not present anymore",
-		                opts_ctxt->structure[opt_pos]);
-		opts_ctxt->tmp.do_list_struct_changed = true;
-	}
-
-	if(opts_ctxt->tmp.do_list_struct_changed)
+	/* were the very same TCP options present at the very same locations in
+	 * previous packet? the list of option types is the packed signature of the
+	 * structure of the list, so one comparison is enough */
+	if(opts_nr != opts_ctxt->structure_nr ||
+	   memcmp(structure, opts_ctxt->structure, opts_nr) != 0)
 	{
 		/* the new structure has never been transmitted yet */
 		rohc_comp_debug(context, "structure of TCP options list changed, "
 		                "compressed list must be transmitted in the compressed "
 		                "base header");
+		opts_ctxt->tmp.do_list_struct_changed = true;
+		memcpy(opts_ctxt->structure, structure, opts_nr);
 		opts_ctxt->structure_nr = opts_nr;
 		opts_ctxt->structure_nr_trans = 0;
 	}
@@ -810,7 +975,8 @@ int c_tcp_code_tcp_opts_list_item(const struct rohc_comp_ctxt *const context,
 		}
 
 		/* write the item field for the TCP option if transmission is needed */
-		ret = c_tcp_opts[opt_idx].build_list_item(context, tcp, options, opt_len,
+		ret = c_tcp_opts[opt_idx].build_list_item(context, tcp, opts_ctxt,
+		                                          options, opt_len,
 		                                          items_remain_data, items_remain_len);
 		if(ret < 0)
 		{
@@ -838,8 +1004,10 @@ int c_tcp_code_tcp_opts_list_item(const struct rohc_comp_ctxt *const context,
 			const struct tcp_option_timestamp *const opt_ts =
 				(struct tcp_option_timestamp *) (options + 2);
 			opts_ctxt->is_timestamp_init = true;
-			c_add_wlsb(opts_ctxt->ts_req_wlsb, msn, rohc_ntoh32(opt_ts->ts));
-			c_add_wlsb(opts_ctxt->ts_reply_wlsb, msn, rohc_ntoh32(opt_ts->ts_reply));
+			c_tcp_ts_pred_add(&opts_ctxt->ts_req_pred, opts_ctxt->ts_req_wlsb,
+			                  msn, rohc_ntoh32(opt_ts->ts));
+			c_tcp_ts_pred_add(&opts_ctxt->ts_reply_pred, opts_ctxt->ts_reply_wlsb,
+			                  msn, rohc_ntoh32(opt_ts->ts_reply));
 		}
 	}
 	if(opt_pos >= ROHC_TCP_OPTS_MAX && i != 0)
@@ -872,8 +1040,6 @@ error:
  * @param comp_opts_max_len  The max remaining length in the ROHC buffer
  * @return                   The length (in bytes) of compressed TCP options
  *                           in case of success, -1 in case of failure
- *
- * @todo TODO: defines 'options profiles' the same way as for decompressor
  */
 int c_tcp_code_tcp_opts_irreg(const struct rohc_comp_ctxt *const context,
                               const struct tcphdr *const tcp,
@@ -892,7 +1058,6 @@ int c_tcp_code_tcp_opts_irreg(const struct rohc_comp_ctxt *const context,
 	size_t opts_offset;
 	size_t opt_pos;
 
-	bool is_ok;
 	int ret;
 
 	rohc_comp_debug(context, "irregular chain: encode irregular content for all "
@@ -904,7 +1069,7 @@ int c_tcp_code_tcp_opts_irreg(const struct rohc_comp_ctxt *const context,
 	    opt_pos++, opts_offset += opt_len)
 	{
 		const uint8_t opt_idx = opts_ctxt->tmp.position2index[opt_pos];
-		size_t comp_opt_len = 0;
+		size_t comp_opt_len;
 		uint8_t opt_type;
 
 		/* the TCP option index shall be in use */
@@ -933,124 +1098,19 @@ int c_tcp_code_tcp_opts_irreg(const struct rohc_comp_ctxt *const context,
 		                "TCP option %u", opt_type);
 
 		/* encode the TCP option in its irregular form */
-		if(opt_type == TCP_OPT_TS)
-		{
-			const struct tcp_option_timestamp *const opt_ts =
-				(struct tcp_option_timestamp *) (opts + opts_offset + 2);
-			size_t encoded_ts_lsb_len;
-
-			/* encode TS with ts_lsb() */
-			is_ok = c_tcp_ts_lsb_code(context, rohc_ntoh32(opt_ts->ts),
-			                          opts_ctxt->tmp.nr_opt_ts_req_bits_minus_1,
-			                          opts_ctxt->tmp.nr_opt_ts_req_bits_0x40000,
-			                          opts_ctxt->tmp.nr_opt_ts_req_bits_0x4000000,
-			                          rohc_remain_data, rohc_remain_len,
-			                          &encoded_ts_lsb_len);
-			if(!is_ok)
-			{
-				rohc_comp_warn(context, "irregular chain: failed to encode echo "
-				               "request of TCP Timestamp option");
-				goto error;
-			}
-			rohc_remain_data += encoded_ts_lsb_len;
-			rohc_remain_len -= encoded_ts_lsb_len;
-			comp_opt_len += encoded_ts_lsb_len;
-
-			/* encode TS reply with ts_lsb()*/
-			is_ok = c_tcp_ts_lsb_code(context, rohc_ntoh32(opt_ts->ts_reply),
-			                          opts_ctxt->tmp.nr_opt_ts_reply_bits_minus_1,
-			                          opts_ctxt->tmp.nr_opt_ts_reply_bits_0x40000,
-			                          opts_ctxt->tmp.nr_opt_ts_reply_bits_0x4000000,
-			                          rohc_remain_data, rohc_remain_len,
-			                          &encoded_ts_lsb_len);
-			if(!is_ok)
-			{
-				rohc_comp_warn(context, "irregular chain: failed to encode echo "
-				               "reply of TCP Timestamp option");
-				goto error;
-			}
-			rohc_remain_data += encoded_ts_lsb_len;
-			rohc_remain_len -= encoded_ts_lsb_len;
-			comp_opt_len += encoded_ts_lsb_len;
-
-			/* TODO: move at the very end of compression to avoid altering
-			 *       context in case of compression failure */
-			opts_ctxt->is_timestamp_init = true;
-			c_add_wlsb(opts_ctxt->ts_req_wlsb, msn, rohc_ntoh32(opt_ts->ts));
-			c_add_wlsb(opts_ctxt->ts_reply_wlsb, msn, rohc_ntoh32(opt_ts->ts_reply));
-		}
-		else if(opt_type == TCP_OPT_SACK)
+		ret = c_tcp_opts[opt_idx].build_irreg(context, tcp, msn, opts_ctxt, opt_idx,
+		                                      opts, opts_offset, opt_len,
+		                                      rohc_remain_data, rohc_remain_len);
+		if(ret < 0)
 		{
-			const sack_block_t *const sack_blocks =
-				(sack_block_t *) (opts + opts_offset + 2);
-			const bool is_sack_unchanged =
-				!c_tcp_opt_changed(opts_ctxt, opt_idx, opts + opts_offset, opt_len);
-
-			ret = c_tcp_opt_sack_code(context, rohc_ntoh32(tcp->ack_num),
-			                          sack_blocks, opt_len - 2, is_sack_unchanged,
-			                          rohc_remain_data, rohc_remain_len);
-			if(ret < 0)
-			{
-				rohc_comp_warn(context, "failed to encode TCP option SACK");
-				goto error;
-			}
-			rohc_remain_data += ret;
-			rohc_remain_len -= ret;
-			comp_opt_len += ret;
+			rohc_comp_warn(context, "irregular chain: failed to encode TCP option "
+			               "'%s' with index %u", c_tcp_opts[opt_idx].descr, opt_idx);
+			goto error;
 		}
-		else if(opt_type != TCP_OPT_EOL &&
-		        opt_type != TCP_OPT_NOP &&
-		        opt_type != TCP_OPT_MSS &&
-		        opt_type != TCP_OPT_WS &&
-		        opt_type != TCP_OPT_SACK_PERM)
-		{
-			/* generic encoding */
-			/* TODO: in what case option_static could be set to 1 ? */
-
-			uint8_t discriminator;
-			size_t contents_len;
-
-			if(c_tcp_opt_changed(opts_ctxt, opt_idx, opts + opts_offset,
-			                     opt_len - opts_offset))
-			{
-				/* generic_full_irregular: the item that is assumed to change
-				 * constantly. Length is not allowed to change here, since a length
-				 * change is most likely to cause new NOPs or an EOL length change. */
-				discriminator = 0x00;
-				contents_len = opt_len - 2;
-			}
-			else
-			{
-				/* generic_stable_irregular: the item that can change, but currently
-				 * is unchanged */
-				discriminator = 0xff;
-				contents_len = 0;
-			}
-
-			if(rohc_remain_len < (1 + contents_len))
-			{
-				rohc_comp_warn(context, "ROHC buffer too small for the TCP irregular "
-				               "part: %zu bytes required for TCP generic option, but "
-				               "only %zu bytes available", 1 + contents_len,
-				               rohc_remain_len);
-				goto error;
-			}
-
-			/* discriminator byte */
-			rohc_remain_data[0] = discriminator;
-			rohc_remain_data++;
-			rohc_remain_len--;
-			comp_opt_len++;
+		rohc_remain_data += ret;
+		rohc_remain_len -= ret;
+		comp_opt_len = ret;
 
-			/* option contents, if any */
-			if(contents_len > 0)
-			{
-				memcpy(rohc_remain_data, opts + opts_offset + 2, contents_len);
-				rohc_remain_data += contents_len;
-				rohc_remain_len -= contents_len;
-				comp_opt_len += contents_len;
-			}
-		}
 		rohc_comp_debug(context, "irregular chain: added %zu bytes of irregular "
 		                "content for TCP option %u", comp_opt_len, opt_type);
 		comp_opts_len += comp_opt_len;
@@ -1471,7 +1531,7 @@ bool c_tcp_is_list_item_needed(const struct rohc_comp_ctxt *const context,
 		                "transmitted", tcp_opt_get_descr(opt_type));
 		item_needed = true;
 	}
-	else if(opt_idx == TCP_INDEX_NOP || opt_idx == TCP_INDEX_SACK_PERM)
+	else if(c_tcp_opts[opt_idx].is_item_empty)
 	{
 		/* in CO headers, NOP and SACK Permitted options have empty items,
 		 * so transmitting them is useless */
@@ -1522,6 +1582,7 @@ bool c_tcp_is_list_item_needed(const struct rohc_comp_ctxt *const context,
  *
  * @param context           The compression context
  * @param tcp               The TCP header
+ * @param opts_ctxt         The compression context for TCP options
  * @param uncomp_opt        The uncompressed TCP option to compress
  * @param uncomp_opt_len    The length of the uncompressed TCP option to compress
  * @param[out] comp_opt     The compressed TCP option
@@ -1531,6 +1592,7 @@ bool c_tcp_is_list_item_needed(const struct rohc_comp_ctxt *const context,
  */
 static int c_tcp_build_nop_list_item(const struct rohc_comp_ctxt *const context __attribute__((unused)),
                                      const struct tcphdr *const tcp __attribute__((unused)),
+                                     struct c_tcp_opts_ctxt *const opts_ctxt __attribute__((unused)),
                                      const uint8_t *const uncomp_opt __attribute__((unused)),
                                      const uint8_t uncomp_opt_len __attribute__((unused)),
                                      uint8_t *const comp_opt __attribute__((unused)),
@@ -1552,6 +1614,7 @@ static int c_tcp_build_nop_list_item(const struct rohc_comp_ctxt *const context
  *
  * @param context           The compression context
  * @param tcp               The TCP header
+ * @param opts_ctxt         The compression context for TCP options
  * @param uncomp_opt        The uncompressed TCP option to compress
  * @param uncomp_opt_len    The length of the uncompressed TCP option to compress
  * @param[out] comp_opt     The compressed TCP option
@@ -1561,6 +1624,7 @@ static int c_tcp_build_nop_list_item(const struct rohc_comp_ctxt *const context
  */
 static int c_tcp_build_eol_list_item(const struct rohc_comp_ctxt *const context,
                                      const struct tcphdr *const tcp __attribute__((unused)),
+                                     struct c_tcp_opts_ctxt *const opts_ctxt __attribute__((unused)),
                                      const uint8_t *const uncomp_opt __attribute__((unused)),
                                      const uint8_t uncomp_opt_len,
                                      uint8_t *const comp_opt,
@@ -1606,6 +1670,7 @@ error:
  *
  * @param context           The compression context
  * @param tcp               The TCP header
+ * @param opts_ctxt         The compression context for TCP options
  * @param uncomp_opt        The uncompressed TCP option to compress
  * @param uncomp_opt_len    The length of the uncompressed TCP option to compress
  * @param[out] comp_opt     The compressed TCP option
@@ -1615,6 +1680,7 @@ error:
  */
 static int c_tcp_build_mss_list_item(const struct rohc_comp_ctxt *const context,
                                      const struct tcphdr *const tcp __attribute__((unused)),
+                                     struct c_tcp_opts_ctxt *const opts_ctxt __attribute__((unused)),
                                      const uint8_t *const uncomp_opt,
                                      const uint8_t uncomp_opt_len __attribute__((unused)),
                                      uint8_t *const comp_opt,
@@ -1651,6 +1717,7 @@ error:
  *
  * @param context           The compression context
  * @param tcp               The TCP header
+ * @param opts_ctxt         The compression context for TCP options
  * @param uncomp_opt        The uncompressed TCP option to compress
  * @param uncomp_opt_len    The length of the uncompressed TCP option to compress
  * @param[out] comp_opt     The compressed TCP option
@@ -1660,6 +1727,7 @@ error:
  */
 static int c_tcp_build_ws_list_item(const struct rohc_comp_ctxt *const context,
                                     const struct tcphdr *const tcp __attribute__((unused)),
+                                    struct c_tcp_opts_ctxt *const opts_ctxt __attribute__((unused)),
                                     const uint8_t *const uncomp_opt,
                                     const uint8_t uncomp_opt_len __attribute__((unused)),
                                     uint8_t *const comp_opt,
@@ -1697,6 +1765,7 @@ error:
  *
  * @param context           The compression context
  * @param tcp               The TCP header
+ * @param opts_ctxt         The compression context for TCP options
  * @param uncomp_opt        The uncompressed TCP option to compress
  * @param uncomp_opt_len    The length of the uncompressed TCP option to compress
  * @param[out] comp_opt     The compressed TCP option
@@ -1706,6 +1775,7 @@ error:
  */
 static int c_tcp_build_ts_list_item(const struct rohc_comp_ctxt *const context,
                                     const struct tcphdr *const tcp __attribute__((unused)),
+                                    struct c_tcp_opts_ctxt *const opts_ctxt __attribute__((unused)),
                                     const uint8_t *const uncomp_opt,
                                     const uint8_t uncomp_opt_len __attribute__((unused)),
                                     uint8_t *const comp_opt,
@@ -1738,6 +1808,7 @@ error:
  *
  * @param context           The compression context
  * @param tcp               The TCP header
+ * @param opts_ctxt         The compression context for TCP options
  * @param uncomp_opt        The uncompressed TCP option to compress
  * @param uncomp_opt_len    The length of the uncompressed TCP option to compress
  * @param[out] comp_opt     The compressed TCP option
@@ -1747,6 +1818,7 @@ error:
  */
 static int c_tcp_build_sack_perm_list_item(const struct rohc_comp_ctxt *const context __attribute__((unused)),
                                            const struct tcphdr *const tcp __attribute__((unused)),
+                                           struct c_tcp_opts_ctxt *const opts_ctxt __attribute__((unused)),
                                            const uint8_t *const uncomp_opt __attribute__((unused)),
                                            const uint8_t uncomp_opt_len __attribute__((unused)),
                                            uint8_t *const comp_opt __attribute__((unused)),
@@ -1764,6 +1836,7 @@ static int c_tcp_build_sack_perm_list_item(const struct rohc_comp_ctxt *const co
  *
  * @param context           The compression context
  * @param tcp               The TCP header
+ * @param opts_ctxt         The compression context for TCP options
  * @param uncomp_opt        The uncompressed TCP option to compress
  * @param uncomp_opt_len    The length of the uncompressed TCP option to compress
  * @param[out] comp_opt     The compressed TCP option
@@ -1773,6 +1846,7 @@ static int c_tcp_build_sack_perm_list_item(const struct rohc_comp_ctxt *const co
  */
 static int c_tcp_build_sack_list_item(const struct rohc_comp_ctxt *const context,
                                       const struct tcphdr *const tcp,
+                                      struct c_tcp_opts_ctxt *const opts_ctxt,
                                       const uint8_t *const uncomp_opt,
                                       const uint8_t uncomp_opt_len,
                                       uint8_t *const comp_opt,
@@ -1784,7 +1858,7 @@ static int c_tcp_build_sack_list_item(const struct rohc_comp_ctxt *const context
 
 	return c_tcp_opt_sack_code(context, rohc_ntoh32(tcp->ack_num),
 	                           opt_sack, uncomp_opt_len - 2, is_sack_unchanged,
-	                           comp_opt, comp_opt_max_len);
+	                           &opts_ctxt->sack_cache, comp_opt, comp_opt_max_len);
 }
 
 
@@ -1803,6 +1877,7 @@ static int c_tcp_build_sack_list_item(const struct rohc_comp_ctxt *const context
  *
  * @param context           The compression context
  * @param tcp               The TCP header
+ * @param opts_ctxt         The compression context for TCP options
  * @param uncomp_opt        The uncompressed TCP option to compress
  * @param uncomp_opt_len    The length of the uncompressed TCP option to compress
  * @param[out] comp_opt     The compressed TCP option
@@ -1812,6 +1887,7 @@ static int c_tcp_build_sack_list_item(const struct rohc_comp_ctxt *const context
  */
 static int c_tcp_build_generic_list_item(const struct rohc_comp_ctxt *const context,
                                          const struct tcphdr *const tcp __attribute__((unused)),
+                                         struct c_tcp_opts_ctxt *const opts_ctxt __attribute__((unused)),
                                          const uint8_t *const uncomp_opt,
                                          const uint8_t uncomp_opt_len,
                                          uint8_t *const comp_opt,
@@ -1852,3 +1928,248 @@ error:
 	return -1;
 }
 
+
+
+/**
+ * @brief Build the irregular part for the TCP options without irregular part
+ *
+ * The EOL, NOP, MSS, WS and SACK Permitted options have no irregular part:
+ * they are either unchanged or transmitted in the compressed list.
+ *
+ * @param context            The compression context
+ * @param tcp                The TCP header
+ * @param msn                The Master Sequence Number (MSN) of the packet
+ * @param[in,out] opts_ctxt  The compression context for TCP options
+ * @param opt_idx            The index of the TCP option in the context
+ * @param uncomp_opts        The uncompressed TCP options
+ * @param uncomp_opt_offset  The offset of the TCP option in the TCP options
+ * @param uncomp_opt_len     The length of the uncompressed TCP option
+ * @param[out] comp_opt      The irregular part of the TCP option
+ * @param comp_opt_max_len   The max remaining length in the ROHC buffer
+ * @return                   The length (in bytes) of the irregular part
+ *                           in case of success, -1 in case of failure
+ */
+static int c_tcp_build_no_irreg(const struct rohc_comp_ctxt *const context __attribute__((unused)),
+                                const struct tcphdr *const tcp __attribute__((unused)),
+                                const uint16_t msn __attribute__((unused)),
+                                struct c_tcp_opts_ctxt *const opts_ctxt __attribute__((unused)),
+                                const uint8_t opt_idx __attribute__((unused)),
+                                const uint8_t *const uncomp_opts __attribute__((unused)),
+                                const size_t uncomp_opt_offset __attribute__((unused)),
+                                const uint8_t uncomp_opt_len __attribute__((unused)),
+                                uint8_t *const comp_opt __attribute__((unused)),
+                                const size_t comp_opt_max_len __attribute__((unused)))
+{
+	/* no irregular part */
+	return 0;
+}
+
+
+/**
+ * @brief Build the irregular part for the TCP TS option
+ *
+ * See RFC4996 page 65
+ *
+ * @param context            The compression context
+ * @param tcp                The TCP header
+ * @param msn                The Master Sequence Number (MSN) of the packet
+ * @param[in,out] opts_ctxt  The compression context for TCP options
+ * @param opt_idx            The index of the TCP option in the context
+ * @param uncomp_opts        The uncompressed TCP options
+ * @param uncomp_opt_offset  The offset of the TCP option in the TCP options
+ * @param uncomp_opt_len     The length of the uncompressed TCP option
+ * @param[out] comp_opt      The irregular part of the TCP option
+ * @param comp_opt_max_len   The max remaining length in the ROHC buffer
+ * @return                   The length (in bytes) of the irregular part
+ *                           in case of success, -1 in case of failure
+ */
+static int c_tcp_build_ts_irreg(const struct rohc_comp_ctxt *const context,
+                                const struct tcphdr *const tcp __attribute__((unused)),
+                                const uint16_t msn,
+                                struct c_tcp_opts_ctxt *const opts_ctxt,
+                                const uint8_t opt_idx __attribute__((unused)),
+                                const uint8_t *const uncomp_opts,
+                                const size_t uncomp_opt_offset,
+                                const uint8_t uncomp_opt_len __attribute__((unused)),
+                                uint8_t *const comp_opt,
+                                const size_t comp_opt_max_len)
+{
+	const struct tcp_option_timestamp *const opt_ts =
+		(struct tcp_option_timestamp *) (uncomp_opts + uncomp_opt_offset + 2);
+	uint8_t *rohc_remain_data = comp_opt;
+	size_t rohc_remain_len = comp_opt_max_len;
+	size_t encoded_ts_lsb_len;
+	bool is_ok;
+
+	/* encode TS with ts_lsb() */
+	is_ok = c_tcp_ts_lsb_code(context, rohc_ntoh32(opt_ts->ts),
+	                          opts_ctxt->tmp.nr_opt_ts_req_bits_minus_1,
+	                          opts_ctxt->tmp.nr_opt_ts_req_bits_0x40000,
+	                          opts_ctxt->tmp.nr_opt_ts_req_bits_0x4000000,
+	                          rohc_remain_data, rohc_remain_len,
+	                          &encoded_ts_lsb_len);
+	if(!is_ok)
+	{
+		rohc_comp_warn(context, "irregular chain: failed to encode echo "
+		               "request of TCP Timestamp option");
+		goto error;
+	}
+	rohc_remain_data += encoded_ts_lsb_len;
+	rohc_remain_len -= encoded_ts_lsb_len;
+
+	/* encode TS reply with ts_lsb()*/
+	is_ok = c_tcp_ts_lsb_code(context, rohc_ntoh32(opt_ts->ts_reply),
+	                          opts_ctxt->tmp.nr_opt_ts_reply_bits_minus_1,
+	                          opts_ctxt->tmp.nr_opt_ts_reply_bits_0x40000,
+	                          opts_ctxt->tmp.nr_opt_ts_reply_bits_0x4000000,
+	                          rohc_remain_data, rohc_remain_len,
+	                          &encoded_ts_lsb_len);
+	if(!is_ok)
+	{
+		rohc_comp_warn(context, "irregular chain: failed to encode echo "
+		               "reply of TCP Timestamp option");
+		goto error;
+	}
+	rohc_remain_data += encoded_ts_lsb_len;
+
+	/* TODO: move at the very end of compression to avoid altering
+	 *       context in case of compression failure */
+	opts_ctxt->is_timestamp_init = true;
+	c_tcp_ts_pred_add(&opts_ctxt->ts_req_pred, opts_ctxt->ts_req_wlsb,
+	                  msn, rohc_ntoh32(opt_ts->ts));
+	c_tcp_ts_pred_add(&opts_ctxt->ts_reply_pred, opts_ctxt->ts_reply_wlsb,
+	                  msn, rohc_ntoh32(opt_ts->ts_reply));
+
+	return (rohc_remain_data - comp_opt);
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Build the irregular part for the TCP SACK option
+ *
+ * See RFC4996 page 67
+ *
+ * @param context            The compression context
+ * @param tcp                The TCP header
+ * @param msn                The Master Sequence Number (MSN) of the packet
+ * @param[in,out] opts_ctxt  The compression context for TCP options
+ * @param opt_idx            The index of the TCP option in the context
+ * @param uncomp_opts        The uncompressed TCP options
+ * @param uncomp_opt_offset  The offset of the TCP option in the TCP options
+ * @param uncomp_opt_len     The length of the uncompressed TCP option
+ * @param[out] comp_opt      The irregular part of the TCP option
+ * @param comp_opt_max_len   The max remaining length in the ROHC buffer
+ * @return                   The length (in bytes) of the irregular part
+ *                           in case of success, -1 in case of failure
+ */
+static int c_tcp_build_sack_irreg(const struct rohc_comp_ctxt *const context,
+                                  const struct tcphdr *const tcp,
+                                  const uint16_t msn __attribute__((unused)),
+                                  struct c_tcp_opts_ctxt *const opts_ctxt,
+                                  const uint8_t opt_idx,
+                                  const uint8_t *const uncomp_opts,
+                                  const size_t uncomp_opt_offset,
+                                  const uint8_t uncomp_opt_len,
+                                  uint8_t *const comp_opt,
+                                  const size_t comp_opt_max_len)
+{
+	const uint8_t *const uncomp_opt = uncomp_opts + uncomp_opt_offset;
+	const sack_block_t *const sack_blocks = (sack_block_t *) (uncomp_opt + 2);
+	const bool is_sack_unchanged =
+		!c_tcp_opt_changed(opts_ctxt, opt_idx, uncomp_opt, uncomp_opt_len);
+	int ret;
+
+	ret = c_tcp_opt_sack_code(context, rohc_ntoh32(tcp->ack_num),
+	                          sack_blocks, uncomp_opt_len - 2, is_sack_unchanged,
+	                          &opts_ctxt->sack_cache, comp_opt, comp_opt_max_len);
+	if(ret < 0)
+	{
+		rohc_comp_warn(context, "failed to encode TCP option SACK");
+		goto error;
+	}
+
+	return ret;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Build the irregular part for the generic TCP options
+ *
+ * See RFC4996 page 69
+ *
+ * @param context            The compression context
+ * @param tcp                The TCP header
+ * @param msn                The Master Sequence Number (MSN) of the packet
+ * @param[in,out] opts_ctxt  The compression context for TCP options
+ * @param opt_idx            The index of the TCP option in the context
+ * @param uncomp_opts        The uncompressed TCP options
+ * @param uncomp_opt_offset  The offset of the TCP option in the TCP options
+ * @param uncomp_opt_len     The length of the uncompressed TCP option
+ * @param[out] comp_opt      The irregular part of the TCP option
+ * @param comp_opt_max_len   The max remaining length in the ROHC buffer
+ * @return                   The length (in bytes) of the irregular part
+ *                           in case of success, -1 in case of failure
+ */
+static int c_tcp_build_generic_irreg(const struct rohc_comp_ctxt *const context,
+                                     const struct tcphdr *const tcp __attribute__((unused)),
+                                     const uint16_t msn __attribute__((unused)),
+                                     struct c_tcp_opts_ctxt *const opts_ctxt,
+                                     const uint8_t opt_idx,
+                                     const uint8_t *const uncomp_opts,
+                                     const size_t uncomp_opt_offset,
+                                     const uint8_t uncomp_opt_len,
+                                     uint8_t *const comp_opt,
+                                     const size_t comp_opt_max_len)
+{
+	const uint8_t *const uncomp_opt = uncomp_opts + uncomp_opt_offset;
+	uint8_t discriminator;
+	size_t contents_len;
+
+	/* TODO: in what case option_static could be set to 1 ? */
+
+	if(c_tcp_opt_changed(opts_ctxt, opt_idx, uncomp_opt,
+	                     uncomp_opt_len - uncomp_opt_offset))
+	{
+		/* generic_full_irregular: the item that is assumed to change
+		 * constantly. Length is not allowed to change here, since a length
+		 * change is most likely to cause new NOPs or an EOL length change. */
+		discriminator = 0x00;
+		contents_len = uncomp_opt_len - 2;
+	}
+	else
+	{
+		/* generic_stable_irregular: the item that can change, but currently
+		 * is unchanged */
+		discriminator = 0xff;
+		contents_len = 0;
+	}
+
+	if(comp_opt_max_len < (1 + contents_len))
+	{
+		rohc_comp_warn(context, "ROHC buffer too small for the TCP irregular "
+		               "part: %zu bytes required for TCP generic option, but "
+		               "only %zu bytes available", 1 + contents_len,
+		               comp_opt_max_len);
+		goto error;
+	}
+
+	/* discriminator byte */
+	comp_opt[0] = discriminator;
+
+	/* option contents, if any */
+	if(contents_len > 0)
+	{
+		memcpy(comp_opt + 1, uncomp_opt + 2, contents_len);
+	}
+
+	return (1 + contents_len);
+
+error:
+	return -1;
+}
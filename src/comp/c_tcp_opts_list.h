@@ -31,6 +31,8 @@
 
 #include "rohc_comp_internals.h"
 #include "protocols/tcp.h"
+#include "schemes/tcp_sack.h"
+#include "schemes/tcp_ts.h"
 
 #include <stdint.h>
 #include <stddef.h>
@@ -121,6 +123,13 @@ struct c_tcp_opts_ctxt
 	bool is_timestamp_init;
 	struct c_wlsb *ts_req_wlsb;
 	struct c_wlsb *ts_reply_wlsb;
+	/** The prediction of the TS echo request */
+	struct c_tcp_ts_pred ts_req_pred;
+	/** The prediction of the TS echo reply */
+	struct c_tcp_ts_pred ts_reply_pred;
+
+	/** The last TCP option SACK that was encoded */
+	struct c_tcp_sack_cache sack_cache;
 
 	/** The temporary part of the context, shall be reset between 2 packets */
 	struct c_tcp_opts_ctxt_tmp tmp;
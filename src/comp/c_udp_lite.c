@@ -111,6 +111,8 @@ struct sc_udp_lite_context
 static bool c_udp_lite_create(struct rohc_comp_ctxt *const context,
                               const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static size_t c_udp_lite_mem_max(const size_t wlsb_width)
+	__attribute__((warn_unused_result, const));
 
 static bool c_udp_lite_check_profile(const struct rohc_comp *const comp,
                                      const struct net_pkt *const packet)
@@ -156,6 +158,26 @@ static void udp_lite_init_cc(struct rohc_comp_ctxt *const context,
 
 
 
+/** The handlers of the UDP-Lite profile for the generic RFC3095-based code */
+static const struct rohc_comp_rfc3095_ops c_udp_lite_rfc3095_ops =
+{
+	.encode_uncomp_fields = NULL,
+	.decide_state         = rohc_comp_rfc3095_decide_state,
+	.decide_FO_packet     = c_ip_decide_FO_packet,
+	.decide_SO_packet     = c_ip_decide_SO_packet,
+	.decide_extension     = decide_extension,
+	.init_at_IR           = udp_lite_init_cc,
+	.get_next_sn          = c_ip_get_next_sn,
+	.code_static_part     = udp_code_static_udp_part,
+	.code_dynamic_part    = udp_lite_code_dynamic_udplite_part,
+	.code_ir_remainder    = c_ip_code_ir_remainder,
+	.code_UO_packet_head  = udp_lite_build_cce_packet,
+	.code_uo_remainder    = udp_lite_code_uo_remainder,
+	.compute_crc_static   = udp_compute_crc_static,
+	.compute_crc_dynamic  = udp_compute_crc_dynamic,
+};
+
+
 /**
  * @brief Create a new UDP-Lite context and initialize it thanks to the given
  *        IP/UDP-Lite packet.
@@ -176,7 +198,8 @@ static bool c_udp_lite_create(struct rohc_comp_ctxt *const context,
 	const struct udphdr *udp_lite;
 
 	/* create and initialize the generic part of the profile context */
-	if(!rohc_comp_rfc3095_create(context, ROHC_LSB_SHIFT_SN, packet))
+	if(!rohc_comp_rfc3095_create(context, &c_udp_lite_rfc3095_ops,
+	                             ROHC_LSB_SHIFT_SN, packet))
 	{
 		rohc_comp_warn(context, "generic context creation failed");
 		goto quit;
@@ -194,7 +217,8 @@ static bool c_udp_lite_create(struct rohc_comp_ctxt *const context,
 	udp_lite = (struct udphdr *) packet->transport->data;
 
 	/* create the UDP-Lite part of the profile context */
-	udp_lite_context = malloc(sizeof(struct sc_udp_lite_context));
+	udp_lite_context = rohc_slab_alloc(context->compressor->ctxt_slab,
+	                                   sizeof(struct sc_udp_lite_context));
 	if(udp_lite_context == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -219,19 +243,6 @@ static bool c_udp_lite_create(struct rohc_comp_ctxt *const context,
 
 	/* init the UDP-Lite-specific variables and functions */
 	rfc3095_ctxt->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->decide_state = rohc_comp_rfc3095_decide_state;
-	rfc3095_ctxt->decide_FO_packet = c_ip_decide_FO_packet;
-	rfc3095_ctxt->decide_SO_packet = c_ip_decide_SO_packet;
-	rfc3095_ctxt->decide_extension = decide_extension;
-	rfc3095_ctxt->init_at_IR = udp_lite_init_cc;
-	rfc3095_ctxt->get_next_sn = c_ip_get_next_sn;
-	rfc3095_ctxt->code_static_part = udp_code_static_udp_part; /* same as UDP */
-	rfc3095_ctxt->code_dynamic_part = udp_lite_code_dynamic_udplite_part;
-	rfc3095_ctxt->code_ir_remainder = c_ip_code_ir_remainder;
-	rfc3095_ctxt->code_UO_packet_head = udp_lite_build_cce_packet;
-	rfc3095_ctxt->code_uo_remainder = udp_lite_code_uo_remainder;
-	rfc3095_ctxt->compute_crc_static = udp_compute_crc_static;
-	rfc3095_ctxt->compute_crc_dynamic = udp_compute_crc_dynamic;
 
 	return true;
 
@@ -822,6 +833,20 @@ static bool udp_lite_send_cce_packet(const struct rohc_comp_ctxt *const context,
 }
 
 
+/**
+ * @brief Get the maximum length one UDP-Lite context takes in a memory block
+ *
+ * @param wlsb_width  The width of the W-LSB sliding windows
+ * @return            The maximum number of bytes of the memory block the
+ *                    profile-specific part of the context takes
+ */
+static size_t c_udp_lite_mem_max(const size_t wlsb_width)
+{
+	return (rohc_comp_rfc3095_mem_max(wlsb_width) +
+	        rohc_slab_block_mem_max(sizeof(struct sc_udp_lite_context)));
+}
+
+
 /**
  * @brief Define the compression part of the UDP-Lite profile as described
  *        in the RFC 4019.
@@ -837,5 +862,9 @@ const struct rohc_comp_profile c_udp_lite_profile =
 	.encode         = c_udp_lite_encode,
 	.reinit_context = rohc_comp_reinit_context,
 	.feedback       = rohc_comp_rfc3095_feedback,
+	.get_msn        = c_ip_get_msn,
+	.set_next_msn   = c_ip_set_next_msn,
+	.prefetch       = rohc_comp_rfc3095_prefetch,
+	.get_mem_max    = c_udp_lite_mem_max,
 };
 
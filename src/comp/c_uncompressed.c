@@ -42,6 +42,8 @@
 static bool c_uncompressed_create(struct rohc_comp_ctxt *const context,
                                   const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static size_t c_uncompressed_mem_max(const size_t wlsb_width __attribute__((unused)))
+	__attribute__((warn_unused_result, const));
 static void c_uncompressed_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 static bool c_uncompressed_check_profile(const struct rohc_comp *const comp,
@@ -470,19 +472,19 @@ static int uncompressed_code_IR_packet(const struct rohc_comp_ctxt *context,
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter'
 	 */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
+	ret = code_cid_values(&(context->cid_hdr),
 	                      rohc_pkt, rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
 		               "%zu-byte ROHC buffer is too small",
-		               context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 		               "small" : "large", context->cid, rohc_pkt_max_len);
 		goto error;
 	}
 	counter = ret;
 	rohc_comp_debug(context, "%s CID %zu encoded on %zu byte(s)",
-	                context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+	                c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 	                "small" : "large", context->cid, counter - 1);
 
 	/* part 2 */
@@ -504,9 +506,11 @@ static int uncompressed_code_IR_packet(const struct rohc_comp_ctxt *context,
 
 	/* part 5 */
 	rohc_pkt[counter] = 0;
-	rohc_pkt[counter] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, counter,
-	                                  CRC_INIT_8,
-	                                  context->compressor->crc_table_8);
+	if((c_features(context->compressor) & ROHC_COMP_FEATURE_ESTIMATE) == 0)
+	{
+		rohc_pkt[counter] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, counter,
+		                                  CRC_INIT_8, rohc_crc_table_8);
+	}
 	rohc_comp_debug(context, "CRC on %zu bytes = 0x%02x", counter,
 	                rohc_pkt[counter]);
 	counter++;
@@ -570,19 +574,19 @@ static int uncompressed_code_normal_packet(const struct rohc_comp_ctxt *context,
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter'
 	 */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
+	ret = code_cid_values(&(context->cid_hdr),
 	                      rohc_pkt, rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
 		               "%zu-byte ROHC buffer is too small",
-		               context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 		               "small" : "large", context->cid, rohc_pkt_max_len);
 		goto error;
 	}
 	counter = ret;
 	rohc_comp_debug(context, "%s CID %zu encoded on %zu byte(s)",
-	                context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+	                c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 	                "small" : "large", context->cid, counter - 1);
 
 	/* part 2 */
@@ -599,6 +603,20 @@ error:
 }
 
 
+/**
+ * @brief Get the maximum length one Uncompressed context takes in a memory block
+ *
+ * @param wlsb_width  The width of the W-LSB sliding windows
+ * @return            The maximum number of bytes of the memory block the
+ *                    profile-specific part of the context takes
+ */
+static size_t c_uncompressed_mem_max(const size_t wlsb_width __attribute__((unused)))
+{
+	/* the contexts of the profile allocate no memory */
+	return 0;
+}
+
+
 /**
  * @brief Define the compression part of the Uncompressed profile as described
  *        in the RFC 3095.
@@ -614,5 +632,6 @@ const struct rohc_comp_profile c_uncompressed_profile =
 	.encode         = c_uncompressed_encode,
 	.reinit_context = c_uncompressed_reinit_context,
 	.feedback       = uncomp_feedback,
+	.get_mem_max    = c_uncompressed_mem_max,
 };
 
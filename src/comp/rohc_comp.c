@@ -47,6 +47,9 @@
 #include "rohc_time_internal.h"
 #include "rohc_debug.h"
 #include "rohc_utils.h"
+#include "rohc_mem.h"
+#include "rohc_mem_block.h"
+#include "rohc_burst.h"
 #include "sdvl.h"
 #include "rohc_add_cid.h"
 #include "rohc_bit_ops.h"
@@ -54,6 +57,8 @@
 #include "crc.h"
 #include "protocols/udp.h"
 #include "protocols/ip_numbers.h"
+#include "protocols/tcp.h"
+#include "protocols/rfc5225.h"
 #include "feedback_parse.h"
 
 #include "config.h" /* for PACKAGE_(NAME|URL|VERSION) */
@@ -77,6 +82,7 @@ extern const struct rohc_comp_profile c_rtp_profile,
                                       c_esp_profile,
                                       c_tcp_profile,
                                       c_ip_profile,
+                                      c_rfc5225_ip_profile,
                                       c_uncompressed_profile;
 
 /**
@@ -89,23 +95,204 @@ static const struct rohc_comp_profile *const rohc_comp_profiles[C_NUM_PROFILES]
 {
 	&c_rtp_profile,
 	&c_udp_profile,  /* must be declared after RTP profile */
+#if ROHC_BUILD_PROFILE_UDPLITE == 1
 	&c_udp_lite_profile,
+#endif
+#if ROHC_BUILD_PROFILE_ESP == 1
 	&c_esp_profile,
+#endif
+#if ROHC_BUILD_PROFILE_TCP == 1
 	&c_tcp_profile,
+#endif
 	&c_ip_profile,  /* must be declared after all IP-based profiles */
+	&c_rfc5225_ip_profile, /* disabled when the IP-only v1 profile is enabled */
 	&c_uncompressed_profile, /* must be declared last */
 };
 
+/** The indexes of the profiles in \ref rohc_comp_profiles */
+enum
+{
+	ROHC_COMP_PROFILE_IDX_RTP,
+	ROHC_COMP_PROFILE_IDX_UDP,
+#if ROHC_BUILD_PROFILE_UDPLITE == 1
+	ROHC_COMP_PROFILE_IDX_UDPLITE,
+#endif
+#if ROHC_BUILD_PROFILE_ESP == 1
+	ROHC_COMP_PROFILE_IDX_ESP,
+#endif
+#if ROHC_BUILD_PROFILE_TCP == 1
+	ROHC_COMP_PROFILE_IDX_TCP,
+#endif
+	ROHC_COMP_PROFILE_IDX_IP,
+	ROHC_COMP_PROFILE_IDX_RFC5225_IP,
+	ROHC_COMP_PROFILE_IDX_UNCOMP,
+	/** The index of the ROHC profiles that are not supported */
+	ROHC_COMP_PROFILE_IDX_NONE,
+};
+
+_Static_assert(ROHC_COMP_PROFILE_IDX_NONE == C_NUM_PROFILES,
+               "the indexes of the profiles shall match the built profiles");
+
+/** The magic number at the beginning of the saved contexts ("RCKP") */
+#define ROHC_COMP_CKPT_MAGIC  0x52434b50U
+/** The version of the format of the saved contexts */
+#define ROHC_COMP_CKPT_VERSION  1U
+/** The length of the header of the saved contexts */
+#define ROHC_COMP_CKPT_HDR_LEN  7U
+/** The length of the fields of one saved context before its packets */
+#define ROHC_COMP_CKPT_CTXT_HDR_LEN  7U
+/** The length of the fields of one saved packet before its headers */
+#define ROHC_COMP_CKPT_PKT_HDR_LEN  5U
+/** The maximum length of one saved context */
+#define ROHC_COMP_CKPT_CTXT_MAX_LEN \
+	(ROHC_COMP_CKPT_CTXT_HDR_LEN + \
+	 ROHC_COMP_CKPT_PKTS_NR * (ROHC_COMP_CKPT_PKT_HDR_LEN + ROHC_COMP_CKPT_HDRS_MAX))
+/** The length of the buffer for the ROHC packets replayed to restore one
+ *  context (the ROHC packets are dropped) */
+#define ROHC_COMP_CKPT_ROHC_MAX_LEN  (ROHC_COMP_CKPT_HDRS_MAX * 4U)
+/** The length of the buffer to rebuild and encode one saved packet */
+#define ROHC_COMP_CKPT_BUF_LEN \
+	(ROHC_COMP_CKPT_HDRS_MAX + 0xffffU + ROHC_COMP_CKPT_ROHC_MAX_LEN)
+
+/** The magic number at the beginning of the context store ("RCST") */
+#define ROHC_COMP_STORE_MAGIC  0x52435354U
+/** The version of the layout of the context store */
+#define ROHC_COMP_STORE_VERSION  1U
+/** The length of the header of the context store */
+#define ROHC_COMP_STORE_HDR_LEN  16U
+/** The length of the fields of one slot of the context store before its
+ *  saved context: the sequence number (4 bytes in host byte order) and the
+ *  length of the saved context (2 bytes, 2 bytes reserved) */
+#define ROHC_COMP_STORE_SLOT_HDR_LEN  8U
+/** The length of one slot of the context store, a multiple of 8 bytes */
+#define ROHC_COMP_STORE_SLOT_LEN \
+	((ROHC_COMP_STORE_SLOT_HDR_LEN + ROHC_COMP_CKPT_CTXT_MAX_LEN + 7U) & ~7U)
+/** The number of times one slot modified while it is read is read again */
+#define ROHC_COMP_STORE_READ_TRIES  3U
+
+/**
+ * @brief The indexes of the compression parts of the ROHC profiles
+ *
+ * The indexes in \ref rohc_comp_profiles are given by profile ID, so that the
+ * profiles are found without searching them one by one. The table is
+ * read-only, so it is shared by all the compressors.
+ */
+static const uint8_t rohc_comp_profiles_idx[ROHC_PROFILE_MAX] =
+{
+	[ROHC_PROFILE_UNCOMPRESSED]  = ROHC_COMP_PROFILE_IDX_UNCOMP,
+	[ROHC_PROFILE_RTP]           = ROHC_COMP_PROFILE_IDX_RTP,
+	[ROHC_PROFILE_UDP]           = ROHC_COMP_PROFILE_IDX_UDP,
+#if ROHC_BUILD_PROFILE_ESP == 1
+	[ROHC_PROFILE_ESP]           = ROHC_COMP_PROFILE_IDX_ESP,
+#else
+	[ROHC_PROFILE_ESP]           = ROHC_COMP_PROFILE_IDX_NONE,
+#endif
+	[ROHC_PROFILE_IP]            = ROHC_COMP_PROFILE_IDX_IP,
+	[ROHC_PROFILE_RTP_LLA]       = ROHC_COMP_PROFILE_IDX_NONE,
+#if ROHC_BUILD_PROFILE_TCP == 1
+	[ROHC_PROFILE_TCP]           = ROHC_COMP_PROFILE_IDX_TCP,
+#else
+	[ROHC_PROFILE_TCP]           = ROHC_COMP_PROFILE_IDX_NONE,
+#endif
+	[ROHC_PROFILE_UDPLITE_RTP]   = ROHC_COMP_PROFILE_IDX_NONE,
+#if ROHC_BUILD_PROFILE_UDPLITE == 1
+	[ROHC_PROFILE_UDPLITE]       = ROHC_COMP_PROFILE_IDX_UDPLITE,
+#else
+	[ROHC_PROFILE_UDPLITE]       = ROHC_COMP_PROFILE_IDX_NONE,
+#endif
+};
+
+/** The indexes of the compression parts of the ROHCv2 profiles, given by the
+ *  8 LSB of their profile IDs */
+static const uint8_t rohc_comp_profiles_v2_idx[ROHCv2_PROFILE_MAX & 0xff] =
+{
+	[ROHC_PROFILE_UNCOMPRESSED]  = ROHC_COMP_PROFILE_IDX_NONE,
+	[ROHC_PROFILE_RTP]           = ROHC_COMP_PROFILE_IDX_NONE,
+	[ROHC_PROFILE_UDP]           = ROHC_COMP_PROFILE_IDX_NONE,
+	[ROHC_PROFILE_ESP]           = ROHC_COMP_PROFILE_IDX_NONE,
+	[ROHCv2_PROFILE_IP & 0xff]   = ROHC_COMP_PROFILE_IDX_RFC5225_IP,
+};
+
+
+/*
+ * Prototypes of private functions related to packet compression
+ */
+
+static bool rohc_comp_check_bufs(const struct rohc_comp *const comp,
+                                 const struct rohc_buf uncomp_packet,
+                                 const struct rohc_buf *const rohc_packet)
+	__attribute__((warn_unused_result, nonnull(1)));
+static bool rohc_comp_parse_pkt(struct rohc_comp *const comp,
+                                const struct rohc_buf uncomp_packet,
+                                const struct rohc_comp_pkt_hints *const hints,
+                                struct net_pkt *const ip_pkt)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+static bool rohc_comp_prepare_pkt(struct rohc_comp *const comp,
+                                  const struct rohc_buf uncomp_packet,
+                                  const struct rohc_comp_pkt_hints *const hints,
+                                  const struct rohc_buf *const rohc_packet,
+                                  struct net_pkt *const ip_pkt,
+                                  int *const profile_id)
+	__attribute__((warn_unused_result, nonnull(1, 4, 5, 6)));
+static rohc_status_t rohc_comp_encode_pkt(struct rohc_comp *const comp,
+                                          const struct rohc_buf uncomp_packet,
+                                          const struct net_pkt *const ip_pkt,
+                                          const int profile_id_hint,
+                                          struct rohc_buf *const rohc_packet,
+                                          size_t *const payload_offset_out)
+	__attribute__((warn_unused_result, nonnull(1, 3, 5)));
+static void rohc_comp_prepare_group(struct rohc_comp *const comp,
+                                    const struct rohc_buf uncomp_packets[],
+                                    const struct rohc_comp_pkt_hints hints[],
+                                    const struct rohc_buf rohc_packets[],
+                                    const size_t pkts_nr,
+                                    bool is_parsed[ROHC_COMP_BURST_GROUP],
+                                    int profile_ids[ROHC_COMP_BURST_GROUP],
+                                    uint32_t hashes[ROHC_COMP_BURST_GROUP],
+                                    size_t order[ROHC_COMP_BURST_GROUP])
+	__attribute__((nonnull(1, 2, 4, 6, 7, 8, 9)));
+static void rohc_comp_prefetch_ctxt_data(const struct rohc_comp *const comp,
+                                         const struct net_pkt *const ip_pkt,
+                                         const int profile_id,
+                                         const uint32_t hash)
+	__attribute__((nonnull(1, 2)));
+static size_t rohc_comp_encode_burst(struct rohc_comp *const comp,
+                                     const struct rohc_buf uncomp_packets[],
+                                     const struct rohc_comp_pkt_hints hints[],
+                                     struct rohc_buf rohc_packets[],
+                                     size_t payload_offsets[],
+                                     rohc_status_t status[],
+                                     const size_t pkts_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 6)));
+static void rohc_comp_rru_read(const struct rohc_comp *const comp,
+                               const size_t off,
+                               size_t len,
+                               uint8_t *dst)
+	__attribute__((nonnull(1, 4)));
+static void rohc_comp_rru_view(const struct rohc_comp *const comp,
+                               const size_t off,
+                               size_t len,
+                               struct rohc_buf_vec *const vec)
+	__attribute__((nonnull(1, 4)));
+static struct rohc_buf rohc_comp_buf_view(const uint8_t *const data,
+                                          const size_t len)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Prototypes of private functions related to ROHC compression profiles
  */
 
+static size_t rohc_comp_get_profile_idx(const rohc_profile_t profile_id)
+	__attribute__((warn_unused_result, const));
+
 static const struct rohc_comp_profile *
 	rohc_get_profile_from_id(const struct rohc_comp *comp,
 	                         const rohc_profile_t profile_id)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+static unsigned int rohc_comp_get_profiles_for_proto(const uint8_t proto)
+	__attribute__((warn_unused_result, const));
 static const struct rohc_comp_profile *
 	c_get_profile_from_packet(const struct rohc_comp *const comp,
 	                          const struct net_pkt *const packet)
@@ -121,12 +308,138 @@ static bool c_create_contexts(struct rohc_comp *const comp)
 static void c_destroy_contexts(struct rohc_comp *const comp)
 	__attribute__((nonnull(1)));
 
+static void c_destroy_context(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+
+static void c_cid_set_used(struct rohc_comp *const comp, const rohc_cid_t cid)
+	__attribute__((nonnull(1)));
+static void c_cid_set_unused(struct rohc_comp *const comp, const rohc_cid_t cid)
+	__attribute__((nonnull(1)));
+static rohc_cid_t c_cid_first_unused(const struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static uint32_t c_ctxt_index_mix(const rohc_profile_t profile_id,
+                                 const rohc_ctxt_key_t key)
+	__attribute__((warn_unused_result, const));
+static void c_ctxt_index_mix_group(const uint32_t profile_ids[ROHC_COMP_BURST_GROUP],
+                                   const rohc_ctxt_key_t keys[ROHC_COMP_BURST_GROUP],
+                                   uint32_t hashes[ROHC_COMP_BURST_GROUP])
+	__attribute__((nonnull(1, 2, 3)));
+static size_t c_ctxt_index_hash(const struct rohc_comp *const comp,
+                                const rohc_profile_t profile_id,
+                                const rohc_ctxt_key_t key)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static bool c_ctxt_index_reserve(struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void c_ctxt_index_add(struct rohc_comp *const comp,
+                             const struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_ctxt_index_remove(struct rohc_comp *const comp,
+                                const struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+
+static inline struct rohc_comp_ctxt *
+	c_ctxt_at(const struct rohc_comp *const comp, const rohc_cid_t cid)
+	__attribute__((nonnull(1), warn_unused_result, pure));
+static struct rohc_comp_ctxt *
+	c_alloc_ctxt(struct rohc_comp *const comp, const rohc_cid_t cid)
+	__attribute__((nonnull(1), warn_unused_result));
+
+static void c_ctxt_lru_push(struct rohc_comp *const comp,
+                            struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_ctxt_lru_unlink(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_expire_contexts(struct rohc_comp *const comp,
+                              const struct rohc_ts arrival_time)
+	__attribute__((nonnull(1)));
+static void c_ctxt_closed_update(struct rohc_comp *const comp,
+                                 struct rohc_comp_ctxt *const context,
+                                 const struct rohc_ts arrival_time)
+	__attribute__((nonnull(1, 2)));
+static void c_ctxt_closed_unlink(struct rohc_comp *const comp,
+                                 struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_release_closed_contexts(struct rohc_comp *const comp,
+                                      const struct rohc_ts arrival_time)
+	__attribute__((nonnull(1)));
+static size_t c_mem_usage(const struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static bool c_ctxts_full(const struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+static struct rohc_comp_ctxt *
+	c_ctxt_to_recycle(const struct rohc_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1)));
+static size_t c_uncomp_cache_slot(const rohc_ctxt_key_t key)
+	__attribute__((warn_unused_result, const));
+static bool c_uncomp_cache_has(const struct rohc_comp *const comp,
+                               const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void c_uncomp_cache_add(struct rohc_comp *const comp,
+                               const struct net_pkt *const packet)
+	__attribute__((nonnull(1, 2)));
+static struct rohc_comp_ctxt *
+	c_recent_ctxts_find(struct rohc_comp *const comp,
+	                    const struct rohc_comp_profile *const profile,
+	                    const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static void c_recent_ctxts_push(struct rohc_comp *const comp,
+                                struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void c_ctxt_touch(struct rohc_comp *const comp,
+                         struct rohc_comp_ctxt *const context,
+                         const struct rohc_ts arrival_time)
+	__attribute__((nonnull(1, 2)));
+static struct rohc_comp_ctxt *
+	c_get_shared_uncomp_ctxt(struct rohc_comp *const comp,
+	                         const struct net_pkt *const packet,
+	                         const struct rohc_ts arrival_time)
+	__attribute__((nonnull(1, 2), warn_unused_result));
+static bool c_ir_pacing_allows(struct rohc_comp *const comp,
+                               const struct rohc_ts arrival_time)
+	__attribute__((nonnull(1), warn_unused_result));
+static void c_trace_filter_select(struct rohc_comp *const comp,
+                                  const struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
 static struct rohc_comp_ctxt *
 	c_create_context(struct rohc_comp *const comp,
 	                 const struct rohc_comp_profile *const profile,
 	                 const struct net_pkt *const packet,
-	                 const struct rohc_ts arrival_time)
+	                 const struct rohc_ts arrival_time,
+	                 const unsigned int priority)
 	__attribute__((nonnull(1, 2, 3), warn_unused_result));
+static bool c_init_context(struct rohc_comp *const comp,
+                           struct rohc_comp_ctxt *const c,
+                           const rohc_cid_t cid,
+                           const struct rohc_comp_profile *const profile,
+                           const struct net_pkt *const packet,
+                           const struct rohc_ts arrival_time)
+	__attribute__((nonnull(1, 2, 4, 5), warn_unused_result));
+static void c_ctxt_record_pkt(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const context,
+                              const uint8_t *const hdrs,
+                              const size_t hdrs_len,
+                              const size_t payload_len)
+	__attribute__((nonnull(1, 2, 3)));
+static size_t c_save_context(const struct rohc_comp_ctxt *const context,
+                             uint8_t *const rec)
+	__attribute__((nonnull(1), warn_unused_result));
+static bool c_check_saved_context(const uint8_t *const rec,
+                                  const size_t max_len,
+                                  size_t *const rec_len)
+	__attribute__((nonnull(1, 3), warn_unused_result));
+static bool c_restore_context(struct rohc_comp *const comp,
+                              const rohc_cid_t cid,
+                              const rohc_profile_t profile_id,
+                              const rohc_mode_t mode,
+                              const rohc_comp_state_t state,
+                              const uint8_t *const pkts,
+                              const size_t pkts_nr,
+                              uint8_t *const buf)
+	__attribute__((nonnull(1, 6, 8), warn_unused_result));
 static struct rohc_comp_ctxt *
 	rohc_comp_find_ctxt(struct rohc_comp *const comp,
 	                    const struct net_pkt *const packet,
@@ -142,10 +455,38 @@ static struct rohc_comp_ctxt *
  * Prototypes of private functions related to ROHC feedback
  */
 
-static bool __rohc_comp_deliver_feedback(struct rohc_comp *const comp,
-                                         const uint8_t *const packet,
-                                         const size_t size)
+static bool rohc_comp_feedback_locate(struct rohc_comp *const comp,
+                                      const uint8_t *const packet,
+                                      const size_t size,
+                                      struct rohc_comp_feedback_item *const item)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+static uint32_t rohc_comp_feedback_ack_kind(const struct rohc_comp_ctxt *const context,
+                                            const uint8_t *const feedback_data,
+                                            const size_t feedback_data_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static size_t rohc_comp_feedback_apply(struct rohc_comp *const comp,
+                                       struct rohc_comp_feedback_item items[],
+                                       const size_t items_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool rohc_comp_feedback_queue_push(struct rohc_comp_feedback_queue *const queue,
+                                          const struct rohc_buf feedback)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static void rohc_comp_drain_feedback(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
+
+static bool rohc_comp_check_cfg(const struct rohc_comp *const comp,
+                                const struct rohc_comp_cfg *const cfg)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void rohc_comp_take_cfg(struct rohc_comp *const comp)
+	__attribute__((nonnull(1)));
+
+static size_t rohc_comp_piggyback_write(const struct rohc_comp *const comp,
+                                        struct rohc_buf *const rohc_packet,
+                                        const size_t hdrs_len,
+                                        size_t *const items_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
 
 static bool rohc_comp_feedback_parse_cid(const struct rohc_comp *const comp,
                                          const uint8_t *const feedback,
@@ -227,12 +568,59 @@ static bool rohc_comp_feedback_check_opts(const struct rohc_comp_ctxt *const con
  * @see rohc_comp_set_wlsb_window_width
  * @see rohc_comp_set_periodic_refreshes
  * @see rohc_comp_set_rtp_detection_cb
+ * @see rohc_comp_new3
  */
 struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
                                   const rohc_cid_t max_cid,
                                   const rohc_comp_random_cb_t rand_cb,
                                   void *const rand_priv)
 {
+	return rohc_comp_new3(cid_type, max_cid, rand_cb, rand_priv, NULL);
+}
+
+
+/**
+ * @brief Create a new ROHC compressor that allocates with the given functions
+ *
+ * Create a new ROHC compressor like \ref rohc_comp_new2 does, but allocate
+ * all its memory with the given memory operations: the compressor itself,
+ * its contexts, its indexes and its buffers. The compressor structure is
+ * allocated with the \e aligned_alloc function if any, aligned on a cache
+ * line.
+ *
+ * The contexts are allocated with the same functions, unless other ones are
+ * set with \ref rohc_comp_set_alloc_cbs.
+ *
+ * @param cid_type  The type of Context IDs (CID) that the ROHC compressor
+ *                  shall operate with, see \ref rohc_comp_new2
+ * @param max_cid   The maximum value that the ROHC compressor should use for
+ *                  context IDs (CID), see \ref rohc_comp_new2
+ * @param rand_cb   The random callback to set
+ * @param rand_priv Private data that will be given to the callback, may be
+ *                  used as a context by user
+ * @param mem_ops   The functions to allocate and free memory with, NULL to
+ *                  use malloc() and free(); the structure is copied
+ * @return          The created compressor if successful,
+ *                  NULL if creation failed
+ *
+ * @warning Don't forget to free compressor memory with \ref rohc_comp_free
+ *          if \e rohc_comp_new3 succeeded
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_new2
+ * @see rohc_comp_free
+ * @see rohc_comp_set_alloc_cbs
+ */
+struct rohc_comp * rohc_comp_new3(const rohc_cid_type_t cid_type,
+                                  const rohc_cid_t max_cid,
+                                  const rohc_comp_random_cb_t rand_cb,
+                                  void *const rand_priv,
+                                  const struct rohc_mem_ops *const mem_ops)
+{
+	const struct rohc_mem_ops default_mem_ops = { NULL, NULL, NULL, NULL };
+	const struct rohc_mem_ops *const ops =
+		(mem_ops != NULL ? mem_ops : &default_mem_ops);
 	const size_t wlsb_width = 4; /* default window width for W-LSB encoding */
 	struct rohc_comp *comp;
 	bool is_fine;
@@ -260,25 +648,65 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 		/* unexpected CID type */
 		goto error;
 	}
+#ifdef ROHC_FIXED_CID_TYPE
+	if(cid_type != ROHC_FIXED_CID_TYPE)
+	{
+		/* the library is built for the other CID type only */
+		goto error;
+	}
+#endif
 	if(rand_cb == NULL)
 	{
 		return NULL;
 	}
+	if(!rohc_mem_ops_check(mem_ops))
+	{
+		goto error;
+	}
 
 	/* allocate memory for the ROHC compressor */
-	comp = malloc(sizeof(struct rohc_comp));
+	comp = rohc_mem_aligned_alloc(ops, ROHC_MEM_CACHE_LINE_LEN,
+	                              sizeof(struct rohc_comp));
 	if(comp == NULL)
 	{
 		goto error;
 	}
 	memset(comp, 0, sizeof(struct rohc_comp));
+	comp->mem_ops = *ops;
+
+	/* the contexts are allocated with the same functions by default */
+	rohc_slab_init(&comp->ctxt_slab_own);
+	if(ops->alloc != NULL &&
+	   !rohc_slab_set_cbs(&comp->ctxt_slab_own, ops->alloc, ops->free, ops->priv))
+	{
+		goto destroy_comp;
+	}
+	rohc_intern_init(&comp->static_store_own, &comp->ctxt_slab_own,
+	                 &comp->mem_ops);
+	comp->ctxt_slab = &comp->ctxt_slab_own;
+	comp->static_store = &comp->static_store_own;
+	comp->engine = NULL;
 
 	comp->medium.cid_type = cid_type;
 	comp->medium.max_cid = max_cid;
+#ifdef ROHC_FIXED_COMP_FEATURES
+	comp->features = ROHC_FIXED_COMP_FEATURES;
+#else
+	comp->features = ROHC_COMP_FEATURE_NONE;
+#endif
+	comp->effort = ROHC_COMP_EFFORT_DEFAULT;
 	comp->mrru = 0; /* no segmentation by default */
+	comp->piggyback_max_len = ROHC_COMP_PIGGYBACK_MAX_LEN_DEFAULT;
+	comp->rru = NULL; /* allocated only if segmentation is enabled */
+	comp->rru_payload = NULL;
+	comp->rru_payload_off = 0;
+	comp->rru_payload_len = 0;
 	comp->random_cb = rand_cb;
 	comp->random_cb_ctxt = rand_priv;
 
+	/* all the events are recorded once a ring of binary traces is given */
+	comp->trace_events = ROHC_TRACE_EVENTS_ALL;
+
 	/* all compression profiles are disabled by default */
 	for(i = 0; i < C_NUM_PROFILES; i++)
 	{
@@ -286,10 +714,22 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 	}
 
 	/* reset statistics */
+	comp->stats_seq = 0;
+	comp->has_last_pkt_info = false;
 	comp->num_packets = 0;
+#if ROHC_COMP_STATS == 1
 	comp->total_compressed_size = 0;
 	comp->total_uncompressed_size = 0;
+#endif
+	comp->ctxts_recycled_nr = 0;
+	comp->feedbacks_nr = 0;
+	memset(comp->packet_types_nr, 0, sizeof(comp->packet_types_nr));
+	comp->overloads_nr = 0;
+	comp->overload_pkts_nr = 0;
+	comp->overload_flows_nr = 0;
+	comp->overload_refreshes_nr = 0;
 	comp->last_context = NULL;
+	memset(comp->recent_ctxts, 0, sizeof(comp->recent_ctxts));
 
 	/* set the default W-LSB window width */
 	is_fine = rohc_comp_set_wlsb_window_width(comp, wlsb_width);
@@ -306,6 +746,8 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 	{
 		goto destroy_comp;
 	}
+	comp->periodic_refreshes_ir_time = 0;
+	comp->periodic_refreshes_fo_time = 0;
 
 	/* set the default number of uncompressed transmissions for list
 	 * compression */
@@ -315,35 +757,213 @@ struct rohc_comp * rohc_comp_new2(const rohc_cid_type_t cid_type,
 		goto destroy_comp;
 	}
 
-	/* init the tables for fast CRC computation */
-	is_fine = rohc_crc_init_table(comp->crc_table_3, ROHC_CRC_TYPE_3);
-	if(is_fine != true)
+	/* contexts never expire by default */
+	comp->ctxt_idle_timeout = 0;
+
+	/* the contexts of the ended flows are kept until recycled by default */
+	comp->closed_ctxt_linger = 0;
+
+	/* no memory budget by default */
+	comp->mem_budget = 0;
+
+	/* never overloaded by default */
+	comp->overload_limits.queue_depth = 0;
+	comp->overload_limits.burst_time_us = 0;
+	comp->is_overloaded = false;
+
+	/* create room for the MAX_CID + 1 contexts, they are allocated on demand */
+	if(!c_create_contexts(comp))
 	{
 		goto destroy_comp;
 	}
-	is_fine = rohc_crc_init_table(comp->crc_table_7, ROHC_CRC_TYPE_7);
-	if(is_fine != true)
+
+	return comp;
+
+destroy_comp:
+	rohc_mem_free(ops, comp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create a new ROHC compressor in the given memory block
+ *
+ * Create a new ROHC compressor like \ref rohc_comp_new2 does, but carve all
+ * its memory from the given memory block: the compressor itself, its
+ * contexts, its indexes and its buffers. The compressor never allocates
+ * memory from the heap, so its memory usage is bounded by the length of the
+ * block. A block of \ref rohc_comp_mem_size bytes is large enough to
+ * compress packets with all the MAX_CID + 1 contexts, so no allocation ever
+ * fails while packets are compressed.
+ *
+ * The block remains owned by the caller: it shall stay valid until the
+ * compressor is destroyed with \ref rohc_comp_free, and it may be used
+ * again afterwards. The memory functions of the compressor cannot be changed
+ * with \ref rohc_comp_set_alloc_cbs.
+ *
+ * @param cid_type  The type of Context IDs (CID) that the ROHC compressor
+ *                  shall operate with, see \ref rohc_comp_new2
+ * @param max_cid   The maximum value that the ROHC compressor should use for
+ *                  context IDs (CID), see \ref rohc_comp_new2
+ * @param rand_cb   The random callback to set
+ * @param rand_priv Private data that will be given to the callback, may be
+ *                  used as a context by user
+ * @param mem       The memory block to carve the compressor from, aligned
+ *                  or not
+ * @param mem_len   The length of the memory block
+ * @return          The created compressor if successful,
+ *                  NULL if creation failed or if the block is too small
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_mem_size
+ * @see rohc_comp_free
+ */
+struct rohc_comp * rohc_comp_new_static(const rohc_cid_type_t cid_type,
+                                        const rohc_cid_t max_cid,
+                                        const rohc_comp_random_cb_t rand_cb,
+                                        void *const rand_priv,
+                                        void *const mem,
+                                        const size_t mem_len)
+{
+	struct rohc_mem_block *block;
+	struct rohc_mem_ops mem_ops;
+
+	block = rohc_mem_block_init(mem, mem_len);
+	if(block == NULL)
 	{
-		goto destroy_comp;
+		goto error;
 	}
-	is_fine = rohc_crc_init_table(comp->crc_table_8, ROHC_CRC_TYPE_8);
-	if(is_fine != true)
+	mem_ops.alloc = rohc_mem_block_alloc;
+	mem_ops.aligned_alloc = NULL; /* all the areas are aligned on cache lines */
+	mem_ops.free = rohc_mem_block_free;
+	mem_ops.priv = block;
+
+	return rohc_comp_new3(cid_type, max_cid, rand_cb, rand_priv, &mem_ops);
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Get the length of the memory block a static ROHC compressor needs
+ *
+ * The length is the worst case for a compressor created with
+ * \ref rohc_comp_new_static that uses all its MAX_CID + 1 contexts with the
+ * given profiles and W-LSB window width: every context is counted with the
+ * largest profile, every IPv6 address with its own copy, and the slab of
+ * contexts with one partly-used chunk per size of block. The length depends
+ * only on the parameters, not on the traffic.
+ *
+ * The length covers the default configuration of the compressor: enabling
+ * segmentation with \ref rohc_comp_set_mrru or the
+ * \ref ROHC_COMP_FEATURE_CHECKPOINT feature needs more memory, and so do
+ * other profiles or a larger W-LSB window width. A smaller block may be
+ * given together with a memory budget, see \ref rohc_comp_set_mem_budget.
+ *
+ * @param cid_type     The type of Context IDs (CID) of the compressor
+ * @param max_cid      The maximum CID of the compressor
+ * @param profiles     The profiles the compressor shall enable
+ * @param profiles_nr  The number of profiles in \e profiles
+ * @param wlsb_width   The W-LSB window width of the compressor, see
+ *                     \ref rohc_comp_set_wlsb_window_width
+ * @return             The length (in bytes) of the memory block,
+ *                     0 if the parameters are invalid or if one profile
+ *                     is not supported
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_new_static
+ */
+size_t rohc_comp_mem_size(const rohc_cid_type_t cid_type,
+                          const rohc_cid_t max_cid,
+                          const rohc_profile_t profiles[],
+                          const size_t profiles_nr,
+                          const size_t wlsb_width)
+{
+	const size_t ctxts_nr = max_cid + 1;
+	const size_t pages_nr =
+		(max_cid + ROHC_COMP_CTXT_PAGE_LEN) / ROHC_COMP_CTXT_PAGE_LEN;
+	size_t ctxt_mem_max = 0;
+	size_t interned_nr = 0;
+	size_t index_len;
+	size_t mem_len;
+	size_t i;
+
+	/* check input parameters */
+	if(!((cid_type == ROHC_SMALL_CID && max_cid <= ROHC_SMALL_CID_MAX) ||
+	     (cid_type == ROHC_LARGE_CID && max_cid <= ROHC_LARGE_CID_MAX)))
 	{
-		goto destroy_comp;
+		goto error;
+	}
+	if(profiles == NULL || profiles_nr == 0)
+	{
+		goto error;
+	}
+	if(wlsb_width == 0 || (wlsb_width & (wlsb_width - 1)) != 0)
+	{
+		goto error;
 	}
 
-	/* create the MAX_CID + 1 contexts */
-	if(!c_create_contexts(comp))
+	/* every context is counted with the largest profile */
+	for(i = 0; i < profiles_nr; i++)
 	{
-		goto destroy_comp;
+		const size_t profile_idx = rohc_comp_get_profile_idx(profiles[i]);
+		const struct rohc_comp_profile *profile;
+
+		if(profile_idx == ROHC_COMP_PROFILE_IDX_NONE)
+		{
+			goto error;
+		}
+		profile = rohc_comp_profiles[profile_idx];
+		ctxt_mem_max = rohc_max(ctxt_mem_max, profile->get_mem_max(wlsb_width));
+
+		/* the contexts of the TCP and ROHCv2 IP-only profiles share the IPv6
+		 * addresses of their IP headers */
+		if(profile->id == ROHC_PROFILE_TCP)
+		{
+			interned_nr = rohc_max(interned_nr, ROHC_TCP_MAX_IP_HDRS);
+		}
+		else if(profile->id == ROHCv2_PROFILE_IP)
+		{
+			interned_nr = rohc_max(interned_nr, ROHC_RFC5225_MAX_IP_HDRS);
+		}
 	}
 
-	return comp;
+	/* the compressor, the array of pages of contexts, the bitmap of the used
+	 * CIDs, and every hash index of contexts the largest one grows from */
+	mem_len = rohc_mem_block_len(sizeof(struct rohc_comp)) +
+	          rohc_mem_block_len(pages_nr * sizeof(struct rohc_comp_ctxt *)) +
+	          rohc_mem_block_len((max_cid / ROHC_COMP_CIDS_WORD_LEN + 1) *
+	                             sizeof(uint64_t));
+	index_len = ROHC_COMP_CTXT_INDEX_MIN_LEN;
+	mem_len += rohc_mem_block_len(index_len * sizeof(rohc_cid_t));
+	while(index_len < (2 * ctxts_nr))
+	{
+		index_len *= 2;
+		mem_len += rohc_mem_block_len(index_len * sizeof(rohc_cid_t));
+	}
+
+	/* the pages of contexts and the profile-specific parts of the contexts,
+	 * all allocated from the slab of contexts */
+	mem_len += pages_nr *
+	           rohc_slab_block_mem_max(ROHC_COMP_CTXT_PAGE_LEN *
+	                                   sizeof(struct rohc_comp_ctxt));
+	mem_len += ctxts_nr * ctxt_mem_max;
+	mem_len += rohc_slab_mem_max();
+
+	/* the hash table of the IPv6 addresses shared by the contexts */
+	mem_len += rohc_intern_mem_max(ctxts_nr * interned_nr);
+
+	/* the configuration snapshots published by the control plane */
+	mem_len += 2 * rohc_mem_block_len(sizeof(struct rohc_comp_cfg));
+
+	return rohc_mem_block_size(mem_len);
 
-destroy_comp:
-	zfree(comp);
 error:
-	return NULL;
+	return 0;
 }
 
 
@@ -374,14 +994,32 @@ void rohc_comp_free(struct rohc_comp *const comp)
 {
 	if(comp != NULL)
 	{
+		/* the memory operations are stored in the compressor itself */
+		const struct rohc_mem_ops mem_ops = comp->mem_ops;
+		struct rohc_comp_engine *const engine = comp->engine;
+
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "free ROHC compressor");
 
 		/* free memory used by contexts */
 		c_destroy_contexts(comp);
+		rohc_intern_release(&comp->static_store_own);
+		rohc_slab_release(&comp->ctxt_slab_own);
+
+		/* free the Reconstructed Reception Unit (RRU) if any */
+		rohc_mem_free(&comp->mem_ops, comp->rru);
+
+		/* free the configuration published but not taken yet if any */
+		rohc_mem_free(&comp->mem_ops, comp->cfg_pending);
 
 		/* free the compressor */
-		free(comp);
+		rohc_mem_free(&mem_ops, comp);
+
+		/* the last channel of a freed engine releases the engine */
+		if(engine != NULL)
+		{
+			rohc_comp_engine_put(engine);
+		}
 	}
 }
 
@@ -448,8 +1086,10 @@ bool rohc_comp_set_traces_cb2(struct rohc_comp *const comp,
 		goto error;
 	}
 
-	/* replace current trace callback by the new one */
-	comp->trace_callback = callback;
+	/* replace current trace callback by the new one, the trace filter
+	 * restores it only for the contexts it selects */
+	comp->trace_filter.callback = callback;
+	comp->trace_callback = (comp->trace_filter.is_active ? NULL : callback);
 	comp->trace_callback_priv = priv_ctxt;
 
 	return true;
@@ -460,89 +1100,5062 @@ error:
 
 
 /**
- * @brief Compress the given uncompressed packet into a ROHC packet
+ * @brief Set the ring of binary trace records of the compressor
  *
- * Compress the given uncompressed packet into a ROHC packet. The compression
- * may succeed into two different ways:
- *   \li return \ref ROHC_STATUS_OK and a full ROHC packet,
- *   \li return \ref ROHC_STATUS_SEGMENT and no ROHC data if ROHC segmentation
- *       is required.
+ * Once set, the compressor records one fixed-size binary record in the ring
+ * for every compressed packet, every compression failure, and every event
+ * in the life of the compression contexts: creation, destruction, change of
+ * state or mode, and negative feedback. Unlike the trace callback, no text
+ * is formatted, so the binary traces may stay enabled at line rate. The
+ * recorded events may be filtered with \ref rohc_comp_set_trace_events.
  *
- * Notes:
- *   \li ROHC segmentation:
- *       The ROHC compressor has to use ROHC segmentation if the output buffer
- *       rohc_packet was too small for the compressed ROHC packet and if the
- *       Maximum Reconstructed Reception Unit (MRRU) configured with the
- *       function \ref rohc_comp_set_mrru was not exceeded. If ROHC segmentation
- *       is used, one may use the \ref rohc_comp_get_segment2 function to
- *       retrieve all the ROHC segments one by one.
- *   \li Time-related features in the ROHC protocol:
- *       Set the \e uncomp_packet.time parameter to 0 if arrival time of the
- *       uncompressed packet is unknown or to disable the time-related features
- *       in the ROHC protocol.
+ * The ring may be changed or disabled at any time between two packets.
  *
- * @param comp              The ROHC compressor
- * @param uncomp_packet     The uncompressed packet to compress
- * @param[out] rohc_packet  The resulting compressed ROHC packet
- * @return                  Possible return values:
- *                          \li \ref ROHC_STATUS_OK if a ROHC packet is
- *                              returned
- *                          \li \ref ROHC_STATUS_SEGMENT if no ROHC data is
- *                              returned and ROHC segments can be retrieved
- *                              with successive calls to
- *                              \ref rohc_comp_get_segment2
- *                          \li \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the
- *                              output buffer is too small for the compressed
- *                              packet
- *                          \li \ref ROHC_STATUS_ERROR if an error occurred
+ * @param comp  The ROHC compressor
+ * @param ring  Two possible cases:
+ *                \li The ring initialized with \ref rohc_trace_ring_init
+ *                \li NULL to stop recording binary traces
+ * @return      true on success, false otherwise
  *
  * @ingroup rohc_comp
  *
- * \par Example:
- * \snippet simple_rohc_program.c define ROHC compressor
- * \snippet simple_rohc_program.c define IP and ROHC packets
- * \code
-	...
-\endcode
- * \snippet simple_rohc_program.c compress IP packet #1
- * \snippet simple_rohc_program.c compress IP packet #2
- * \code
-		...
-\endcode
- * \snippet simple_rohc_program.c compress IP packet #3
- * \code
-		...
-\endcode
- * \snippet simple_rohc_program.c compress IP packet #4
- * \code
-		...
-\endcode
- * \snippet simple_rohc_program.c compress IP packet #5
- * \code
-	...
-\endcode
- *
- * @see rohc_comp_set_mrru
- * @see rohc_comp_get_segment2
+ * @see rohc_trace_ring_init
+ * @see rohc_trace_ring_read
  */
-rohc_status_t rohc_compress4(struct rohc_comp *const comp,
-                             const struct rohc_buf uncomp_packet,
-                             struct rohc_buf *const rohc_packet)
+bool rohc_comp_set_trace_ring(struct rohc_comp *const comp,
+                              struct rohc_trace_ring *const ring)
 {
-	struct net_pkt ip_pkt;
-	struct rohc_comp_ctxt *c;
-	rohc_packet_t packet_type;
-	int rohc_hdr_size;
-	size_t payload_size;
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	comp->trace_ring = ring;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the events recorded in the ring of binary trace records
+ *
+ * All the events are recorded by default. Monitoring the life of the
+ * contexts with \ref ROHC_TRACE_EVENTS_CTXT records nothing while the
+ * contexts do not change, so the ring may be polled instead of the
+ * information on every compressed packet.
+ *
+ * The events may be changed at any time between two packets.
+ *
+ * @param comp    The ROHC compressor
+ * @param events  The mask of the events to record, made of
+ *                \ref ROHC_TRACE_EVENT_BIT of every event, eg.
+ *                \ref ROHC_TRACE_EVENTS_ALL or \ref ROHC_TRACE_EVENTS_CTXT
+ * @return        true on success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_trace_ring
+ */
+bool rohc_comp_set_trace_events(struct rohc_comp *const comp,
+                                const uint32_t events)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if((events & ~ROHC_TRACE_EVENTS_ALL) != 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unknown events in mask 0x%08x", events);
+		goto error;
+	}
+
+	comp->trace_events = events;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Trace only the compression context with the given CID
+ *
+ * Once one criterion is given to the trace filter of the compressor, the
+ * text traces are given to the trace callback only while one context that
+ * matches the filter compresses one packet or handles one feedback. The other
+ * traces are dropped before they are formatted, so that debugging one flow
+ * among many costs almost nothing to the other flows. The traces that are
+ * not related to one context are dropped too.
+ *
+ * One context matches the filter if it matches every criterion given to the
+ * filter. One context matches one criterion if it matches one of the values
+ * given for the criterion: several CIDs may be traced for example. Every
+ * criterion holds at most \ref ROHC_TRACE_FILTER_MAX values.
+ *
+ * The filter may be changed at any time between two packets. It does not
+ * apply to the binary trace records, see \ref rohc_comp_set_trace_events.
+ *
+ * @param comp  The ROHC compressor
+ * @param cid   The CID of the context to trace
+ * @return      true if the CID was added to the filter,
+ *              false if the compressor is invalid, the CID is out of range
+ *              or the filter already holds \ref ROHC_TRACE_FILTER_MAX CIDs
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_trace_filter_add_profile
+ * @see rohc_comp_trace_filter_add_packet_type
+ * @see rohc_comp_trace_filter_add_flow
+ * @see rohc_comp_trace_filter_clear
+ */
+bool rohc_comp_trace_filter_add_cid(struct rohc_comp *const comp,
+                                    const rohc_cid_t cid)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(cid > comp->medium.max_cid)
+	{
+		__rohc_print(comp->trace_filter.callback, comp->trace_callback_priv,
+		             ROHC_TRACE_WARNING, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unable to trace CID %zu: CID is greater than MAX_CID %zu",
+		             cid, comp->medium.max_cid);
+		goto error;
+	}
+	if(!rohc_trace_filter_add(&comp->trace_filter, comp->trace_filter.cids,
+	                          &comp->trace_filter.cids_nr, cid))
+	{
+		__rohc_print(comp->trace_filter.callback, comp->trace_callback_priv,
+		             ROHC_TRACE_WARNING, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unable to trace CID %zu: too many CIDs to trace", cid);
+		goto error;
+	}
+	comp->trace_callback = NULL;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Trace only the compression contexts of the given profile
+ *
+ * See \ref rohc_comp_trace_filter_add_cid for the trace filter.
+ *
+ * @param comp     The ROHC compressor
+ * @param profile  The profile of the contexts to trace
+ * @return         true if the profile was added to the filter,
+ *                 false if the compressor is invalid, the profile is unknown
+ *                 or the filter already holds \ref ROHC_TRACE_FILTER_MAX
+ *                 profiles
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_trace_filter_add_profile(struct rohc_comp *const comp,
+                                        const rohc_profile_t profile)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(rohc_comp_get_profile_idx(profile) == ROHC_COMP_PROFILE_IDX_NONE)
+	{
+		__rohc_print(comp->trace_filter.callback, comp->trace_callback_priv,
+		             ROHC_TRACE_WARNING, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unable to trace unknown profile 0x%04x", profile);
+		goto error;
+	}
+	if(!rohc_trace_filter_add(&comp->trace_filter, comp->trace_filter.profiles,
+	                          &comp->trace_filter.profiles_nr, profile))
+	{
+		__rohc_print(comp->trace_filter.callback, comp->trace_callback_priv,
+		             ROHC_TRACE_WARNING, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unable to trace profile 0x%04x: too many profiles to "
+		             "trace", profile);
+		goto error;
+	}
+	comp->trace_callback = NULL;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Trace only the compression contexts that sent the given packet type
+ *
+ * One context matches the criterion if the last ROHC packet it built is of
+ * the given type, or if it is created with the criterion holding the IR
+ * packet type. Tracing the contexts that send IR packets helps to find the
+ * flows that never reach the higher compression states for example.
+ *
+ * See \ref rohc_comp_trace_filter_add_cid for the trace filter.
+ *
+ * @param comp         The ROHC compressor
+ * @param packet_type  The packet type to trace
+ * @return             true if the packet type was added to the filter,
+ *                     false if the compressor or the packet type is invalid
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_trace_filter_add_packet_type(struct rohc_comp *const comp,
+                                            const rohc_packet_t packet_type)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(packet_type >= ROHC_PACKET_MAX || packet_type == ROHC_PACKET_UNKNOWN)
+	{
+		__rohc_print(comp->trace_filter.callback, comp->trace_callback_priv,
+		             ROHC_TRACE_WARNING, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unable to trace invalid packet type %d", packet_type);
+		goto error;
+	}
+
+	comp->trace_filter.packet_types |= ((uint64_t) 1) << packet_type;
+	comp->trace_filter.is_active = true;
+	comp->trace_callback = NULL;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Trace only the compression contexts of the flow of the given packet
+ *
+ * The packet is parsed as if it were compressed, and the flow key of the
+ * packet is added to the filter. The flow key is a hash of the headers that
+ * identify the flow (see \ref ROHC_COMP_FEATURE_FLOW_KEY): several flows may
+ * share the same key, so a few more contexts than expected might be traced.
+ * Set the features of the compressor before the flow.
+ *
+ * See \ref rohc_comp_trace_filter_add_cid for the trace filter.
+ *
+ * @param comp    The ROHC compressor
+ * @param packet  One uncompressed packet of the flow to trace
+ * @return        true if the flow was added to the filter,
+ *                false if the compressor is invalid, the packet is malformed
+ *                or the filter already holds \ref ROHC_TRACE_FILTER_MAX flows
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_trace_filter_add_flow(struct rohc_comp *const comp,
+                                     const struct rohc_buf packet)
+{
+	struct net_pkt ip_pkt;
+
+	if(comp == NULL || rohc_buf_is_malformed(packet) || rohc_buf_is_empty(packet))
+	{
+		goto error;
+	}
+
+	/* parse the packet without any trace, as the compressor would do */
+	if(!net_pkt_parse(&ip_pkt, packet,
+	                  !!(c_features(comp) & ROHC_COMP_FEATURE_FLOW_KEY),
+	                  NULL, NULL, ROHC_TRACE_COMP))
+	{
+		__rohc_print(comp->trace_filter.callback, comp->trace_callback_priv,
+		             ROHC_TRACE_WARNING, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unable to trace flow: failed to parse packet");
+		goto error;
+	}
+
+	if(!rohc_trace_filter_add(&comp->trace_filter, comp->trace_filter.keys,
+	                          &comp->trace_filter.keys_nr, ip_pkt.key))
+	{
+		__rohc_print(comp->trace_filter.callback, comp->trace_callback_priv,
+		             ROHC_TRACE_WARNING, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unable to trace flow with key 0x%08x: too many flows to "
+		             "trace", ip_pkt.key);
+		goto error;
+	}
+	comp->trace_callback = NULL;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Remove all the criteria of the trace filter of the compressor
+ *
+ * All the text traces are given to the trace callback again.
+ *
+ * @param comp  The ROHC compressor
+ * @return      true if the filter was cleared, false if the compressor is
+ *              invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_trace_filter_add_cid
+ */
+bool rohc_comp_trace_filter_clear(struct rohc_comp *const comp)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	rohc_trace_filter_init(&comp->trace_filter, comp->trace_filter.callback);
+	comp->trace_callback = comp->trace_filter.callback;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Compress the given uncompressed packet into a ROHC packet
+ *
+ * Compress the given uncompressed packet into a ROHC packet. The compression
+ * may succeed into two different ways:
+ *   \li return \ref ROHC_STATUS_OK and a full ROHC packet,
+ *   \li return \ref ROHC_STATUS_SEGMENT and no ROHC data if ROHC segmentation
+ *       is required.
+ *
+ * Notes:
+ *   \li ROHC segmentation:
+ *       The ROHC compressor has to use ROHC segmentation if the output buffer
+ *       rohc_packet was too small for the compressed ROHC packet and if the
+ *       Maximum Reconstructed Reception Unit (MRRU) configured with the
+ *       function \ref rohc_comp_set_mrru was not exceeded. If ROHC segmentation
+ *       is used, one may use the \ref rohc_comp_get_segment2 function to
+ *       retrieve all the ROHC segments one by one.
+ *   \li Time-related features in the ROHC protocol:
+ *       Set the \e uncomp_packet.time parameter to 0 if arrival time of the
+ *       uncompressed packet is unknown or to disable the time-related features
+ *       in the ROHC protocol.
+ *   \li Feedback piggybacking:
+ *       The feedback registered with \ref rohc_comp_piggyback_feedback is
+ *       written ahead of the ROHC header in \e rohc_packet. It is kept for
+ *       the next packet if the packet is segmented or if compression fails.
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param[out] rohc_packet  The resulting compressed ROHC packet
+ * @return                  Possible return values:
+ *                          \li \ref ROHC_STATUS_OK if a ROHC packet is
+ *                              returned
+ *                          \li \ref ROHC_STATUS_SEGMENT if no ROHC data is
+ *                              returned and ROHC segments can be retrieved
+ *                              with successive calls to
+ *                              \ref rohc_comp_get_segment2
+ *                          \li \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the
+ *                              output buffer is too small for the compressed
+ *                              packet
+ *                          \li \ref ROHC_STATUS_ERROR if an error occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * \par Example:
+ * \snippet simple_rohc_program.c define ROHC compressor
+ * \snippet simple_rohc_program.c define IP and ROHC packets
+ * \code
+	...
+\endcode
+ * \snippet simple_rohc_program.c compress IP packet #1
+ * \snippet simple_rohc_program.c compress IP packet #2
+ * \code
+		...
+\endcode
+ * \snippet simple_rohc_program.c compress IP packet #3
+ * \code
+		...
+\endcode
+ * \snippet simple_rohc_program.c compress IP packet #4
+ * \code
+		...
+\endcode
+ * \snippet simple_rohc_program.c compress IP packet #5
+ * \code
+	...
+\endcode
+ *
+ * @see rohc_comp_set_mrru
+ * @see rohc_comp_get_segment2
+ */
+rohc_status_t rohc_compress4(struct rohc_comp *const comp,
+                             const struct rohc_buf uncomp_packet,
+                             struct rohc_buf *const rohc_packet)
+{
+	struct net_pkt ip_pkt;
+
+	/* check inputs validity */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(!rohc_comp_check_bufs(comp, uncomp_packet, rohc_packet))
+	{
+		goto error;
+	}
+
+	/* take the configuration published by another thread if any, then
+	 * deliver the feedback enqueued by another thread if any */
+	rohc_comp_take_cfg(comp);
+	rohc_comp_drain_feedback(comp);
+
+	/* parse the uncompressed packet */
+	if(!rohc_comp_parse_pkt(comp, uncomp_packet, NULL, &ip_pkt))
+	{
+		goto error;
+	}
+
+	/* compress the packet with the best profile */
+	return rohc_comp_encode_pkt(comp, uncomp_packet, &ip_pkt, -1, rohc_packet,
+	                            NULL);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Compress the given uncompressed packet with the help of hints
+ *
+ * Compress the given uncompressed packet as \ref rohc_compress4 does, but
+ * take the locations of its headers and the state of its IPv4 checksums from
+ * the given hints, eg. from the packet type and header lengths given by the
+ * NIC, instead of finding them again. The IPv6 extension headers are not
+ * walked and the IPv4 checksums known to be good are not computed again.
+ *
+ * The offsets are lightly checked against the IP headers: the packet is
+ * parsed as \ref rohc_compress4 does if they do not match. The profiles
+ * still check the packet before compressing it.
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param hints             The hints about the uncompressed packet
+ * @param[out] rohc_packet  The resulting compressed ROHC packet
+ * @return                  See \ref rohc_compress4
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ * @see rohc_compress_burst_hinted
+ */
+rohc_status_t rohc_compress_hinted(struct rohc_comp *const comp,
+                                   const struct rohc_buf uncomp_packet,
+                                   const struct rohc_comp_pkt_hints *const hints,
+                                   struct rohc_buf *const rohc_packet)
+{
+	struct net_pkt ip_pkt;
+
+	/* check inputs validity */
+	if(comp == NULL || hints == NULL)
+	{
+		goto error;
+	}
+	if(!rohc_comp_check_bufs(comp, uncomp_packet, rohc_packet))
+	{
+		goto error;
+	}
+
+	/* take the configuration published by another thread if any, then
+	 * deliver the feedback enqueued by another thread if any */
+	rohc_comp_take_cfg(comp);
+	rohc_comp_drain_feedback(comp);
+
+	/* locate the headers of the uncompressed packet */
+	if(!rohc_comp_parse_pkt(comp, uncomp_packet, hints, &ip_pkt))
+	{
+		goto error;
+	}
+
+	/* compress the packet with the best profile */
+	return rohc_comp_encode_pkt(comp, uncomp_packet, &ip_pkt, -1, rohc_packet,
+	                            NULL);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Compress a burst of packets
+ *
+ * Compress the given uncompressed packets into ROHC packets, as if
+ * \ref rohc_compress4 was called for every packet in order. The checks of
+ * the compressor are done only once for the whole burst, and the next packets
+ * are parsed and their contexts, profile-specific data and W-LSB windows
+ * included, are prefetched while the current one is compressed.
+ *
+ * The status of every packet is given in \e status. The burst stops after the
+ * first packet that requires ROHC segmentation, so that the segments may be
+ * retrieved with \ref rohc_comp_get_segment2 before the remaining packets are
+ * given again.
+ *
+ * @param comp                The ROHC compressor
+ * @param uncomp_packets      The uncompressed packets to compress
+ * @param[out] rohc_packets   The resulting compressed ROHC packets
+ * @param[out] status         The status of every packet, see
+ *                            \ref rohc_compress4 for possible values
+ * @param pkts_nr             The number of packets in the burst
+ * @return                    The number of packets that were handled, a
+ *                            status is given for each of them
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ * @see rohc_comp_get_segment2
+ */
+size_t rohc_compress_burst(struct rohc_comp *const comp,
+                           const struct rohc_buf uncomp_packets[],
+                           struct rohc_buf rohc_packets[],
+                           rohc_status_t status[],
+                           const size_t pkts_nr)
+{
+	/* check inputs validity */
+	if(comp == NULL || uncomp_packets == NULL || rohc_packets == NULL ||
+	   status == NULL || pkts_nr == 0)
+	{
+		goto error;
+	}
+
+	return rohc_comp_encode_burst(comp, uncomp_packets, NULL, rohc_packets,
+	                              NULL, status, pkts_nr);
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Compress a burst of packets with the help of hints
+ *
+ * Compress the given uncompressed packets as \ref rohc_compress_burst does,
+ * but take the locations of the headers of every packet and the state of
+ * their IPv4 checksums from the given hints, see \ref rohc_compress_hinted.
+ *
+ * @param comp                The ROHC compressor
+ * @param uncomp_packets      The uncompressed packets to compress
+ * @param hints               The hints about every uncompressed packet
+ * @param[out] rohc_packets   The resulting compressed ROHC packets
+ * @param[out] status         The status of every packet, see
+ *                            \ref rohc_compress4 for possible values
+ * @param pkts_nr             The number of packets in the burst
+ * @return                    The number of packets that were handled, a
+ *                            status is given for each of them
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress_burst
+ * @see rohc_compress_hinted
+ */
+size_t rohc_compress_burst_hinted(struct rohc_comp *const comp,
+                                  const struct rohc_buf uncomp_packets[],
+                                  const struct rohc_comp_pkt_hints hints[],
+                                  struct rohc_buf rohc_packets[],
+                                  rohc_status_t status[],
+                                  const size_t pkts_nr)
+{
+	/* check inputs validity */
+	if(comp == NULL || uncomp_packets == NULL || hints == NULL ||
+	   rohc_packets == NULL || status == NULL || pkts_nr == 0)
+	{
+		goto error;
+	}
+
+	return rohc_comp_encode_burst(comp, uncomp_packets, hints, rohc_packets,
+	                              NULL, status, pkts_nr);
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Compress the headers of the given uncompressed packet
+ *
+ * Compress the given uncompressed packet into a ROHC packet as
+ * \ref rohc_compress4 does, but do not copy the payload after the ROHC
+ * header. Only the ROHC header is written in \e rohc_hdr, and the offset of
+ * the payload in \e uncomp_packet is returned in \e payload_offset. The ROHC
+ * packet is made of the ROHC header followed by the bytes of \e uncomp_packet
+ * starting at \e payload_offset, so that it may be transmitted with a
+ * scatter-gather I/O without copying the payload.
+ *
+ * The payload is not copied, so the ROHC packet cannot be segmented: the
+ * \ref ROHC_STATUS_SEGMENT status is never returned by this function.
+ *
+ * @param comp                 The ROHC compressor
+ * @param uncomp_packet        The uncompressed packet to compress
+ * @param[out] rohc_hdr        The resulting ROHC header
+ * @param[out] payload_offset  The offset of the payload in \e uncomp_packet
+ * @return                     Possible return values:
+ *                             \li \ref ROHC_STATUS_OK if a ROHC header is
+ *                                 returned
+ *                             \li \ref ROHC_STATUS_OUTPUT_TOO_SMALL if the
+ *                                 output buffer is too small for the ROHC
+ *                                 header
+ *                             \li \ref ROHC_STATUS_ERROR if an error
+ *                                 occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ */
+rohc_status_t rohc_compress_hdr(struct rohc_comp *const comp,
+                                const struct rohc_buf uncomp_packet,
+                                struct rohc_buf *const rohc_hdr,
+                                size_t *const payload_offset)
+{
+	struct net_pkt ip_pkt;
+
+	/* check inputs validity */
+	if(comp == NULL || payload_offset == NULL)
+	{
+		goto error;
+	}
+	if(!rohc_comp_check_bufs(comp, uncomp_packet, rohc_hdr))
+	{
+		goto error;
+	}
+
+	/* take the configuration published by another thread if any, then
+	 * deliver the feedback enqueued by another thread if any */
+	rohc_comp_take_cfg(comp);
+	rohc_comp_drain_feedback(comp);
+
+	/* parse the uncompressed packet */
+	if(!rohc_comp_parse_pkt(comp, uncomp_packet, NULL, &ip_pkt))
+	{
+		goto error;
+	}
+
+	/* compress the headers of the packet with the best profile */
+	return rohc_comp_encode_pkt(comp, uncomp_packet, &ip_pkt, -1, rohc_hdr,
+	                            payload_offset);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Compress the headers of a burst of packets
+ *
+ * Compress the headers of the given uncompressed packets as if
+ * \ref rohc_compress_hdr was called for every packet in order, with the
+ * checks and the prefetching of \ref rohc_compress_burst. The payloads of
+ * the packets are never read nor copied: this is the path for the packets
+ * of one IPsec SA that arrive back-to-back with large encrypted payloads.
+ *
+ * The ROHC packets cannot be segmented: the \ref ROHC_STATUS_SEGMENT status
+ * is never given.
+ *
+ * @param comp                  The ROHC compressor
+ * @param uncomp_packets        The uncompressed packets to compress
+ * @param[out] rohc_hdrs        The resulting ROHC headers
+ * @param[out] payload_offsets  The offset of the payload in every
+ *                              uncompressed packet
+ * @param[out] status           The status of every packet, see
+ *                              \ref rohc_compress_hdr for possible values
+ * @param pkts_nr               The number of packets in the burst
+ * @return                      The number of packets that were handled, a
+ *                              status is given for each of them
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress_hdr
+ * @see rohc_compress_burst
+ */
+size_t rohc_compress_hdr_burst(struct rohc_comp *const comp,
+                               const struct rohc_buf uncomp_packets[],
+                               struct rohc_buf rohc_hdrs[],
+                               size_t payload_offsets[],
+                               rohc_status_t status[],
+                               const size_t pkts_nr)
+{
+	/* check inputs validity */
+	if(comp == NULL || uncomp_packets == NULL || rohc_hdrs == NULL ||
+	   payload_offsets == NULL || status == NULL || pkts_nr == 0)
+	{
+		goto error;
+	}
+
+	return rohc_comp_encode_burst(comp, uncomp_packets, NULL, rohc_hdrs,
+	                              payload_offsets, status, pkts_nr);
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Compress the given uncompressed packet in place
+ *
+ * Compress the given uncompressed packet as \ref rohc_compress_hdr does, but
+ * write the ROHC header in the same buffer, right in front of the payload.
+ * The payload is never copied: the resulting ROHC packet is a view of the
+ * buffer of the uncompressed packet. With the Uncompressed profile, only the
+ * few bytes of the CID and packet type are written in front of the IP packet.
+ *
+ * The uncompressed packet shall be given with some headroom, ie. with a
+ * non-zero \e packet->offset. The ROHC header is first built in the
+ * headroom, then moved in front of the payload over the uncompressed
+ * headers: the headroom shall thus be large enough for the ROHC header,
+ * otherwise \ref ROHC_STATUS_OUTPUT_TOO_SMALL is returned.
+ *
+ * The payload is not copied, so the ROHC packet cannot be segmented: the
+ * \ref ROHC_STATUS_SEGMENT status is never returned by this function.
+ *
+ * @param comp            The ROHC compressor
+ * @param[in,out] packet  IN:  The uncompressed packet to compress, with some
+ *                             headroom in front of it
+ *                        OUT: The resulting ROHC packet, in the same buffer,
+ *                             if compression is successful; left unchanged
+ *                             otherwise
+ * @return                See \ref rohc_compress_hdr
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress_hdr
+ * @see rohc_decompress_inplace
+ */
+rohc_status_t rohc_compress_inplace(struct rohc_comp *const comp,
+                                    struct rohc_buf *const packet)
+{
+	struct rohc_buf rohc_hdr;
 	size_t payload_offset;
+	size_t rohc_offset;
+	rohc_status_t status;
+
+	/* check inputs validity */
+	if(comp == NULL || packet == NULL)
+	{
+		goto error;
+	}
+	if(packet->offset == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given packet has no headroom for the ROHC header");
+		goto error;
+	}
+
+	/* the ROHC header is built in the headroom */
+	rohc_hdr.time = packet->time;
+	rohc_hdr.data = packet->data;
+	rohc_hdr.max_len = packet->offset;
+	rohc_hdr.offset = 0;
+	rohc_hdr.len = 0;
+
+	status = rohc_compress_hdr(comp, *packet, &rohc_hdr, &payload_offset);
+	if(status == ROHC_STATUS_OK)
+	{
+		/* move the ROHC header right in front of the payload, over the
+		 * uncompressed headers */
+		assert(rohc_hdr.offset == 0);
+		assert(rohc_hdr.len <= (packet->offset + payload_offset));
+		rohc_offset = packet->offset + payload_offset - rohc_hdr.len;
+		memmove(packet->data + rohc_offset, rohc_hdr.data, rohc_hdr.len);
+		packet->len -= payload_offset;
+		packet->len += rohc_hdr.len;
+		packet->offset = rohc_offset;
+	}
+
+	return status;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Predict the largest ROHC packet for one uncompressed packet
+ *
+ * Give an upper bound of the length of the ROHC packet that
+ * \ref rohc_compress4 will build for the given uncompressed packet, so that
+ * the output buffer may be sized right before compressing the packet, eg. by
+ * a pool of buffers or for the header room of NIC descriptors.
+ *
+ * The bound holds for every packet type, IR included, whatever the state of
+ * the context of the packet: the type of the next packet depends on the
+ * encoding itself (the W-LSB windows, the periodic refreshes, the feedback)
+ * and it cannot be known without compressing the packet. The payload is
+ * never compressed, so the bound only exceeds the length of the
+ * uncompressed packet by a few bytes per header.
+ *
+ * The piggybacked feedback is not counted: it is only written in the room
+ * that remains in the output buffer, see \ref rohc_comp_piggyback_feedback.
+ *
+ * The compressor is not modified.
+ *
+ * @param comp               The ROHC compressor
+ * @param uncomp_packet      The uncompressed packet to compress
+ * @param[out] rohc_max_len  The largest length of the ROHC packet
+ * @return                   true if the length was predicted,
+ *                           false if the packet cannot be compressed or
+ *                           one parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress4
+ */
+bool rohc_comp_predict_size(const struct rohc_comp *const comp,
+                            const struct rohc_buf uncomp_packet,
+                            size_t *const rohc_max_len)
+{
+	struct net_pkt ip_pkt;
+	size_t growth = ROHC_COMP_HDRS_GROWTH_MAX;
+	size_t i;
+
+	if(comp == NULL || rohc_max_len == NULL)
+	{
+		goto error;
+	}
+	if(rohc_buf_is_malformed(uncomp_packet) || rohc_buf_is_empty(uncomp_packet))
+	{
+		goto error;
+	}
+
+	/* locate the IP headers of the packet, they may grow a bit */
+	if(!net_pkt_parse(&ip_pkt, uncomp_packet, false, NULL, NULL,
+	                  ROHC_TRACE_COMP))
+	{
+		goto error;
+	}
+	for(i = 0; i < ip_pkt.hdrs.ip_nr; i++)
+	{
+		/* the IPv6 extension headers are at least 8-byte long, they are
+		 * compressed in lists with at most one index byte for each of them */
+		growth += ROHC_COMP_IP_HDR_GROWTH_MAX + ip_pkt.hdrs.ip[i].exts_len / 8;
+	}
+
+	*rohc_max_len = uncomp_packet.len + growth;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the next ROHC segment if any
+ *
+ * Get the next ROHC segment if any.
+ *
+ * To get all the segments of one ROHC packet, call this function until
+ * \ref ROHC_STATUS_OK or \ref ROHC_STATUS_ERROR is returned.
+ *
+ * @param comp          The ROHC compressor
+ * @param[out] segment  The buffer where to store the ROHC segment
+ * @return              Possible return values:
+ *                       \li \ref ROHC_STATUS_SEGMENT if a ROHC segment is
+ *                           returned and more segments are available,
+ *                       \li \ref ROHC_STATUS_OK if a ROHC segment is returned
+ *                           and no more ROHC segment is available
+ *                       \li \ref ROHC_STATUS_ERROR if an error occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * \par Example:
+ * \snippet test_segment.c define ROHC compressor
+ * \code
+        ...
+        // compress the IP packet with a small ROHC buffer
+\endcode
+ * \snippet test_segment.c segment ROHC packet #1
+ * \snippet test_segment.c segment ROHC packet #2
+ * \code
+                        ...
+                        // decompress the ROHC segment here, the function
+                        // rohc_decompress3 shall return ROHC_STATUS_OK
+                        // and no decompressed packet
+                        ...
+\endcode
+ * \snippet test_segment.c segment ROHC packet #3
+ * \code
+                // decompress the final ROHC segment here, the function
+                // rohc_decompress4 shall return ROHC_STATUS_OK
+\endcode
+ * \snippet test_segment.c segment ROHC packet #4
+ * \code
+                // handle compression error here
+                ...
+\endcode
+ *
+ * @see rohc_comp_get_mrru
+ * @see rohc_comp_set_mrru
+ * @see rohc_compress4
+ */
+rohc_status_t rohc_comp_get_segment2(struct rohc_comp *const comp,
+                                     struct rohc_buf *const segment)
+
+{
+	const size_t segment_type_len = 1; /* segment type byte */
+	size_t max_data_len;
+	rohc_status_t status;
+
+	/* check input parameters */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(segment == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given segment cannot be NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*segment))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given segment is malformed");
+		goto error;
+	}
+	if(!rohc_buf_is_empty(*segment))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given segment is not empty");
+		goto error;
+	}
+
+	/* no segment yet */
+	segment->len = 0;
+
+	/* abort if no RRU is available in the compressor */
+	if(comp->rru_len == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "no RRU available in given compressor");
+		goto error;
+	}
+
+	/* abort is the given output buffer is too small for RRU */
+	if(rohc_buf_avail_len(*segment) <= segment_type_len)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "output buffer is too small for RRU, more than %zd bytes "
+		             "are required", segment_type_len);
+		goto error;
+	}
+
+	/* how many bytes of ROHC packet can we put in that new segment? */
+	max_data_len = rohc_min(rohc_buf_avail_len(*segment) - segment_type_len,
+	                        comp->rru_len);
+	assert(max_data_len > 0);
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "copy %zd bytes of the remaining %zd bytes of ROHC packet and "
+	           "CRC in the segment", max_data_len, comp->rru_len);
+
+	/* set segment type with F bit set only for last segment */
+	rohc_buf_byte_at(*segment, 0) = 0xfe | (max_data_len == comp->rru_len);
+	segment->len++;
+	rohc_buf_pull(segment, 1);
+
+	/* copy remaining ROHC data (CRC included) */
+	rohc_comp_rru_read(comp, comp->rru_off, max_data_len,
+	                   rohc_buf_data_at(*segment, segment->len));
+	segment->len += max_data_len;
+	rohc_buf_pull(segment, max_data_len);
+	comp->rru_off += max_data_len;
+	comp->rru_len -= max_data_len;
+
+	/* set status wrt to (non-)final segment */
+	if(comp->rru_len == 0)
+	{
+		/* final segment, no more segment available */
+		status = ROHC_STATUS_OK;
+		/* reset context for next RRU */
+		comp->rru_off = 0;
+		comp->rru_payload = NULL;
+		comp->rru_payload_off = 0;
+		comp->rru_payload_len = 0;
+	}
+	else
+	{
+		/* non-final segment, more segments to available */
+		status = ROHC_STATUS_SEGMENT;
+	}
+
+	/* shift backward the RRU data, header and the feedback data */
+	rohc_buf_push(segment, max_data_len + 1);
+
+	return status;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Get all the remaining ROHC segments at once
+ *
+ * Split the remaining bytes of the RRU into segments of at most
+ * \e max_segment_len bytes, segment type byte included, in one call. The
+ * segments are not copied: every segment is a vectored network buffer made
+ * of the segment type byte, then of the bytes of the RRU, ie. the ROHC
+ * header, the payload and the FCS-32 that was computed once at compression
+ * time. Give the views to the link layer as scatter/gather descriptors, or
+ * copy them with \ref rohc_buf_vec_linearize.
+ *
+ * The views point to the memory of the compressor, and to the uncompressed
+ * packet if the \ref ROHC_COMP_FEATURE_SEGMENT_NO_COPY feature is enabled:
+ * they remain valid until the next packet is compressed, or until the
+ * uncompressed packet is released.
+ *
+ * The function is equivalent to calling \ref rohc_comp_get_segment2 with
+ * output buffers of \e max_segment_len bytes until \ref ROHC_STATUS_OK is
+ * returned. The RRU is entirely consumed on success, and left untouched on
+ * failure.
+ *
+ * @param comp             The ROHC compressor
+ * @param max_segment_len  The maximum length of one segment (in bytes),
+ *                         segment type byte included
+ * @param[out] segments    The views of the segments, the last one is the
+ *                         final segment
+ * @param segments_max     The number of views the array may hold
+ * @return                 The number of segments,
+ *                         0 if no RRU is available, if \e segments_max is
+ *                         too small for all the segments or if one parameter
+ *                         is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * \par Example:
+ * \code
+        struct rohc_buf_vec segments[64];
+        size_t segments_nr;
+        ...
+        status = rohc_compress4(comp, ip_packet, &rohc_packet);
+        if(status == ROHC_STATUS_SEGMENT)
+        {
+                segments_nr = rohc_comp_get_segments(comp, link_mtu, segments, 64);
+                // give the segments to the link layer in one batch
+                ...
+        }
+\endcode
+ *
+ * @see rohc_comp_get_segment2
+ * @see rohc_comp_set_mrru
+ */
+size_t rohc_comp_get_segments(struct rohc_comp *const comp,
+                              const size_t max_segment_len,
+                              struct rohc_buf_vec segments[],
+                              const size_t segments_max)
+{
+	const size_t segment_type_len = 1; /* segment type byte */
+	size_t max_data_len;
+	size_t segments_nr;
+	size_t i;
+
+	/* check input parameters */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(segments == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "given segments cannot be NULL");
+		goto error;
+	}
+	if(max_segment_len <= segment_type_len)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "segments are too small for RRU, more than %zu bytes are "
+		             "required", segment_type_len);
+		goto error;
+	}
+
+	/* abort if no RRU is available in the compressor */
+	if(comp->rru_len == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "no RRU available in given compressor");
+		goto error;
+	}
+
+	/* all the segments shall fit in the given array */
+	max_data_len = max_segment_len - segment_type_len;
+	segments_nr = (comp->rru_len + max_data_len - 1) / max_data_len;
+	if(segments_nr > segments_max)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "%zu segments are required for the remaining %zu bytes of "
+		             "RRU, only %zu may be returned", segments_nr,
+		             comp->rru_len, segments_max);
+		goto error;
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "split the remaining %zu bytes of ROHC packet and CRC in %zu "
+	           "segments", comp->rru_len, segments_nr);
+
+	/* segment type with F bit set only for last segment */
+	comp->rru_seg_types[0] = 0xfe;
+	comp->rru_seg_types[1] = 0xff;
+	for(i = 0; i < segments_nr; i++)
+	{
+		const size_t data_len = rohc_min(max_data_len, comp->rru_len);
+		const bool is_final = (data_len == comp->rru_len);
+
+		segments[i].segs[0] =
+			rohc_comp_buf_view(&comp->rru_seg_types[is_final], segment_type_len);
+		segments[i].segs_nr = 1;
+		rohc_comp_rru_view(comp, comp->rru_off, data_len, &segments[i]);
+		comp->rru_off += data_len;
+		comp->rru_len -= data_len;
+	}
+	assert(comp->rru_len == 0);
+
+	/* reset context for next RRU */
+	comp->rru_off = 0;
+	comp->rru_payload = NULL;
+	comp->rru_payload_off = 0;
+	comp->rru_payload_len = 0;
+
+	return segments_nr;
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Force the compressor to re-initialize all its contexts
+ *
+ * Make all contexts restart their initialization with decompressor, ie. they
+ * go in the lowest compression state. This function can be used once the
+ * ROHC channel is established again after an interruption.
+ *
+ * The function implements the CONTEXT_REINITIALIZATION signal described by
+ * RFC 3095 at §6.3.1 as:
+ * \verbatim
+   CONTEXT_REINITIALIZATION -- signal
+   This parameter triggers a reinitialization of the entire context at
+   the decompressor, both the static and the dynamic part.  The
+   compressor MUST, when CONTEXT_REINITIALIZATION is triggered, back off
+   to the IR state and fully reinitialize the context by sending IR
+   packets with both the static and dynamic chains covering the entire
+   uncompressed headers until it is reasonably confident that the
+   decompressor contexts are reinitialized.  The context
+   reinitialization MUST be done for all contexts at the compressor.
+   This parameter may for instance be used to do context relocation at,
+   e.g., a cellular handover that results in a change of compression
+   point in the radio access network.
+\endverbatim
+ *
+ * @param comp  The ROHC compressor
+ * @return      true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_force_contexts_reinit(struct rohc_comp *const comp)
+{
+	rohc_cid_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "force re-initialization for all %zu contexts",
+	          comp->num_contexts_used);
+
+	for(i = 0; i <= comp->medium.max_cid; i++)
+	{
+		struct rohc_comp_ctxt *const context = c_get_context(comp, i);
+
+		if(context != NULL)
+		{
+			if(!context->profile->reinit_context(context))
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to force re-initialization for CID %zu", i);
+				goto error;
+			}
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Save the compression contexts in a binary blob
+ *
+ * Save the contexts of the compressor, so that they may be restored in a new
+ * compressor by \ref rohc_comp_restore_contexts, eg. after a restart or an
+ * upgrade of the process. The restored contexts go on with the decompressor
+ * in their saved mode and state, so no burst of IR packets is sent to the
+ * decompressor after the restart.
+ *
+ * A context is saved as its mode, its state and the headers and MSN of its
+ * last packets. The headers are recorded only if the
+ * \ref ROHC_COMP_FEATURE_CHECKPOINT feature is enabled, the contexts with no
+ * recorded headers, eg. the contexts of the Uncompressed profile or the
+ * contexts with headers larger than 128 bytes, are not saved.
+ *
+ * The blob is made of a 5-byte header (magic number and version) and the
+ * 2-byte number of contexts. Every context is made of the CID (2 bytes), the
+ * profile ID (2 bytes), the mode (1 byte), the state (1 byte) and the number
+ * of packets (1 byte). Every packet is made of the MSN (2 bytes), the length
+ * of the headers (1 byte), the length of the payload (2 bytes) and the
+ * headers. All fields are in network byte order.
+ *
+ * @param comp               The ROHC compressor
+ * @param[out] blob          The buffer to save the contexts in, may be NULL
+ *                           to get the required length only
+ * @param blob_max_len       The length of the buffer (in bytes)
+ * @param[out] blob_len      The length of the saved contexts (in bytes), or
+ *                           the required length if the buffer is too small
+ * @return                   true if the contexts were saved,
+ *                           false if the buffer is too small or if a
+ *                           parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_restore_contexts
+ */
+bool rohc_comp_save_contexts(const struct rohc_comp *const comp,
+                             uint8_t *const blob,
+                             const size_t blob_max_len,
+                             size_t *const blob_len)
+{
+	const bool do_write = (blob != NULL);
+	size_t ctxts_nr = 0;
+	size_t len;
+	rohc_cid_t cid;
+
+	if(comp == NULL || blob_len == NULL)
+	{
+		goto error;
+	}
+
+	/* compute the length of the saved contexts first, then write them only
+	 * if the buffer is large enough */
+	len = ROHC_COMP_CKPT_HDR_LEN;
+	for(cid = comp->min_cid; cid <= comp->medium.max_cid; cid++)
+	{
+		const struct rohc_comp_ctxt *const page =
+			comp->ctxt_pages[cid / ROHC_COMP_CTXT_PAGE_LEN];
+		const struct rohc_comp_ctxt *context;
+
+		if(page == NULL)
+		{
+			/* skip the CIDs of the page that was never allocated */
+			cid += ROHC_COMP_CTXT_PAGE_LEN - 1 - (cid % ROHC_COMP_CTXT_PAGE_LEN);
+			continue;
+		}
+		context = &page[cid % ROHC_COMP_CTXT_PAGE_LEN];
+		if(context->used)
+		{
+			const size_t ctxt_len = c_save_context(context, NULL);
+			len += ctxt_len;
+			ctxts_nr += (ctxt_len > 0);
+		}
+	}
+	*blob_len = len;
+	if(!do_write || blob_max_len < len)
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		          "%zu bytes are required to save %zu contexts", len, ctxts_nr);
+		goto error;
+	}
+
+	/* header: magic number, version and number of contexts */
+	blob[0] = (ROHC_COMP_CKPT_MAGIC >> 24) & 0xff;
+	blob[1] = (ROHC_COMP_CKPT_MAGIC >> 16) & 0xff;
+	blob[2] = (ROHC_COMP_CKPT_MAGIC >> 8) & 0xff;
+	blob[3] = ROHC_COMP_CKPT_MAGIC & 0xff;
+	blob[4] = ROHC_COMP_CKPT_VERSION;
+	blob[5] = (ctxts_nr >> 8) & 0xff;
+	blob[6] = ctxts_nr & 0xff;
+	len = ROHC_COMP_CKPT_HDR_LEN;
+
+	/* contexts */
+	for(cid = comp->min_cid; cid <= comp->medium.max_cid; cid++)
+	{
+		const struct rohc_comp_ctxt *const page =
+			comp->ctxt_pages[cid / ROHC_COMP_CTXT_PAGE_LEN];
+		const struct rohc_comp_ctxt *context;
+
+		if(page == NULL)
+		{
+			cid += ROHC_COMP_CTXT_PAGE_LEN - 1 - (cid % ROHC_COMP_CTXT_PAGE_LEN);
+			continue;
+		}
+		context = &page[cid % ROHC_COMP_CTXT_PAGE_LEN];
+		if(context->used)
+		{
+			len += c_save_context(context, blob + len);
+		}
+	}
+	assert(len == (*blob_len));
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "%zu contexts saved in %zu bytes", ctxts_nr, len);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Restore the compression contexts saved in a binary blob
+ *
+ * Restore the contexts saved by \ref rohc_comp_save_contexts in a new
+ * compressor, before any packet is compressed. The compressor shall be
+ * configured like the compressor that saved the contexts: same CID type,
+ * same MAX_CID, same profiles and same features.
+ *
+ * Every context is created again at its saved CID from its saved packets,
+ * then it is put back in its saved mode and state: the next packets of the
+ * flow are compressed as if the compressor was never restarted. The contexts
+ * that cannot be restored (eg. profile disabled or CID out of range) are
+ * skipped, their flows restart with IR packets.
+ *
+ * @param comp      The new ROHC compressor
+ * @param blob      The saved contexts
+ * @param blob_len  The length of the saved contexts (in bytes)
+ * @return          true if the contexts were restored,
+ *                  false if the blob is malformed, if the compressor is
+ *                  already in use or if a parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_save_contexts
+ */
+bool rohc_comp_restore_contexts(struct rohc_comp *const comp,
+                                const uint8_t *const blob,
+                                const size_t blob_len)
+{
+	uint8_t *buf = NULL;
+	size_t ctxts_nr;
+	size_t restored_nr = 0;
+	size_t len;
+	size_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(blob == NULL || blob_len < ROHC_COMP_CKPT_HDR_LEN)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to restore contexts: blob too short");
+		goto error;
+	}
+	if(comp->num_contexts_used != 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to restore contexts: compressor already has %zu "
+		             "contexts", comp->num_contexts_used);
+		goto error;
+	}
+	if(((((uint32_t) blob[0]) << 24) | (blob[1] << 16) | (blob[2] << 8) |
+	    blob[3]) != ROHC_COMP_CKPT_MAGIC ||
+	   blob[4] != ROHC_COMP_CKPT_VERSION)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to restore contexts: unknown blob format");
+		goto error;
+	}
+	ctxts_nr = (blob[5] << 8) | blob[6];
+	len = ROHC_COMP_CKPT_HDR_LEN;
+
+	/* the buffer to rebuild the saved packets and to encode them */
+	buf = rohc_mem_alloc(&comp->mem_ops, ROHC_COMP_CKPT_BUF_LEN);
+	if(buf == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to restore contexts: no memory for packets");
+		goto error;
+	}
+
+	for(i = 0; i < ctxts_nr; i++)
+	{
+		const uint8_t *const rec = blob + len;
+		size_t rec_len;
+
+		/* check the length of the context and of its packets */
+		if(!c_check_saved_context(rec, blob_len - len, &rec_len))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to restore contexts: context #%zu is truncated "
+			             "or malformed", i + 1);
+			goto free_buf;
+		}
+
+		if(c_restore_context(comp, (rec[0] << 8) | rec[1], (rec[2] << 8) | rec[3],
+		                     rec[4], rec[5], rec + ROHC_COMP_CKPT_CTXT_HDR_LEN,
+		                     rec[6], buf))
+		{
+			restored_nr++;
+		}
+		len += rec_len;
+	}
+	if(len != blob_len)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "%zu unexpected bytes at the end of the saved contexts",
+		             blob_len - len);
+	}
+	rohc_mem_free(&comp->mem_ops, buf);
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "%zu/%zu contexts restored", restored_nr, ctxts_nr);
+
+	return true;
+
+free_buf:
+	rohc_mem_free(&comp->mem_ops, buf);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the length of the context store of the compressor
+ *
+ * The context store holds one slot of fixed length for every CID of the
+ * compressor, see \ref rohc_comp_sync_store.
+ *
+ * @param comp      The ROHC compressor
+ * @param[out] len  The length of the context store (in bytes)
+ * @return          true if the length is given,
+ *                  false if a parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_sync_store
+ */
+bool rohc_comp_get_store_len(const struct rohc_comp *const comp,
+                             size_t *const len)
+{
+	if(comp == NULL || len == NULL)
+	{
+		goto error;
+	}
+
+	*len = ROHC_COMP_STORE_HDR_LEN +
+	       (comp->medium.max_cid + 1) * ROHC_COMP_STORE_SLOT_LEN;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Synchronize the compression contexts to a context store
+ *
+ * Write the contexts of the compressor in the given context store, so that
+ * a standby compressor may take them over with \ref rohc_comp_takeover_store
+ * if the compressor fails, eg. in an active/standby pair of gateways. The
+ * store is meant to be placed in a memory segment shared with the standby
+ * process: its layout is made of offsets only, so every process may map it
+ * at its own address.
+ *
+ * The store is made of a 16-byte header (magic number, version, number of
+ * slots and length of one slot), then one slot of fixed length per CID.
+ * Every slot is made of a sequence number, the length of the saved context
+ * and the context saved as \ref rohc_comp_save_contexts does. The sequence
+ * number is odd while the slot is written, so that the standby never takes
+ * a slot that was half written.
+ *
+ * Every call is a sync point: only the slots of the contexts that compressed
+ * packets or changed mode or state since the previous sync point, and the
+ * slots of the destroyed contexts, are written. The store is formatted
+ * with the first call, or if it was formatted for another compressor. The
+ * state of the contexts newer than the last sync point is lost on failover.
+ *
+ * The contexts are saved only if the \ref ROHC_COMP_FEATURE_CHECKPOINT
+ * feature is enabled, see \ref rohc_comp_save_contexts. The function shall
+ * be called by the thread of the compressor.
+ *
+ * @param comp       The ROHC compressor
+ * @param store      The context store, aligned on 4 bytes
+ * @param store_len  The length of the context store (in bytes), see
+ *                   \ref rohc_comp_get_store_len
+ * @return           true if the contexts were synchronized,
+ *                   false if the store is too small or misaligned, or if a
+ *                   parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_store_len
+ * @see rohc_comp_takeover_store
+ */
+bool rohc_comp_sync_store(struct rohc_comp *const comp,
+                          uint8_t *const store,
+                          const size_t store_len)
+{
+	size_t slots_nr;
+	size_t synced_nr = 0;
+	bool is_new_store;
+	rohc_cid_t cid;
+
+	if(comp == NULL || store == NULL)
+	{
+		goto error;
+	}
+	slots_nr = comp->medium.max_cid + 1;
+	if((((uintptr_t) store) % sizeof(uint32_t)) != 0 ||
+	   store_len < (ROHC_COMP_STORE_HDR_LEN + slots_nr * ROHC_COMP_STORE_SLOT_LEN))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to sync contexts: the %zu-byte store is too small "
+		             "or misaligned", store_len);
+		goto error;
+	}
+
+	/* format the store if it was never used or used by another compressor */
+	is_new_store =
+		(((((uint32_t) store[0]) << 24) | (store[1] << 16) | (store[2] << 8) |
+		  store[3]) != ROHC_COMP_STORE_MAGIC ||
+		 store[4] != ROHC_COMP_STORE_VERSION ||
+		 ((((uint32_t) store[8]) << 24) | (store[9] << 16) | (store[10] << 8) |
+		  store[11]) != slots_nr ||
+		 ((((uint32_t) store[12]) << 24) | (store[13] << 16) | (store[14] << 8) |
+		  store[15]) != ROHC_COMP_STORE_SLOT_LEN);
+	if(is_new_store)
+	{
+		memset(store, 0, ROHC_COMP_STORE_HDR_LEN + slots_nr * ROHC_COMP_STORE_SLOT_LEN);
+		store[0] = (ROHC_COMP_STORE_MAGIC >> 24) & 0xff;
+		store[1] = (ROHC_COMP_STORE_MAGIC >> 16) & 0xff;
+		store[2] = (ROHC_COMP_STORE_MAGIC >> 8) & 0xff;
+		store[3] = ROHC_COMP_STORE_MAGIC & 0xff;
+		store[4] = ROHC_COMP_STORE_VERSION;
+		store[8] = (slots_nr >> 24) & 0xff;
+		store[9] = (slots_nr >> 16) & 0xff;
+		store[10] = (slots_nr >> 8) & 0xff;
+		store[11] = slots_nr & 0xff;
+		store[12] = (ROHC_COMP_STORE_SLOT_LEN >> 24) & 0xff;
+		store[13] = (ROHC_COMP_STORE_SLOT_LEN >> 16) & 0xff;
+		store[14] = (ROHC_COMP_STORE_SLOT_LEN >> 8) & 0xff;
+		store[15] = ROHC_COMP_STORE_SLOT_LEN & 0xff;
+	}
+
+	for(cid = 0; cid < slots_nr; cid++)
+	{
+		uint8_t *const slot =
+			store + ROHC_COMP_STORE_HDR_LEN + cid * ROHC_COMP_STORE_SLOT_LEN;
+		uint8_t *const rec = slot + ROHC_COMP_STORE_SLOT_HDR_LEN;
+		const size_t slot_rec_len = (slot[4] << 8) | slot[5];
+		struct rohc_comp_ctxt *const context = c_get_context(comp, cid);
+		size_t rec_len;
+
+		if(context == NULL)
+		{
+			if(slot_rec_len == 0)
+			{
+				continue;
+			}
+			rec_len = 0;
+		}
+		else if(!is_new_store &&
+		        context->store_synced_pkts == context->num_sent_packets &&
+		        (slot_rec_len == 0 ||
+		         (rec[4] == context->mode && rec[5] == context->state)))
+		{
+			/* nothing changed since the previous sync point */
+			continue;
+		}
+		else
+		{
+			rec_len = c_save_context(context, NULL);
+			context->store_synced_pkts = context->num_sent_packets;
+			if(rec_len == 0 && slot_rec_len == 0)
+			{
+				continue;
+			}
+		}
+
+		rohc_seqlock_write_begin((uint32_t *) slot);
+		if(rec_len > 0)
+		{
+			rec_len = c_save_context(context, rec);
+		}
+		slot[4] = (rec_len >> 8) & 0xff;
+		slot[5] = rec_len & 0xff;
+		rohc_seqlock_write_end((uint32_t *) slot);
+		synced_nr++;
+	}
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "%zu slots of the context store written", synced_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Take over the compression contexts of a context store
+ *
+ * Restore the contexts synchronized in the given context store by
+ * \ref rohc_comp_sync_store, eg. when the standby compressor of an
+ * active/standby pair takes over after the failure of the active one. The
+ * compressor shall be configured like the active compressor (same CID
+ * type, same MAX_CID, same profiles and same features) and shall not have
+ * compressed any packet yet. The contexts are restored as
+ * \ref rohc_comp_restore_contexts does: the flows go on without IR packets.
+ *
+ * The slots that were being written when the active compressor failed and
+ * the slots that cannot be restored are skipped, their flows restart with
+ * IR packets. The store is not modified.
+ *
+ * @param comp       The ROHC compressor
+ * @param store      The context store, aligned on 4 bytes
+ * @param store_len  The length of the context store (in bytes)
+ * @return           true if the contexts were taken over,
+ *                   false if the store is malformed, if the compressor is
+ *                   already in use or if a parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_sync_store
+ */
+bool rohc_comp_takeover_store(struct rohc_comp *const comp,
+                              const uint8_t *const store,
+                              const size_t store_len)
+{
+	uint8_t rec[ROHC_COMP_CKPT_CTXT_MAX_LEN];
+	size_t restored_nr = 0;
+	size_t slots_nr;
+	uint8_t *buf;
+	size_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(store == NULL || (((uintptr_t) store) % sizeof(uint32_t)) != 0 ||
+	   store_len < ROHC_COMP_STORE_HDR_LEN)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to take over contexts: store too short or "
+		             "misaligned");
+		goto error;
+	}
+	if(comp->num_contexts_used != 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to take over contexts: compressor already has %zu "
+		             "contexts", comp->num_contexts_used);
+		goto error;
+	}
+	slots_nr = (((uint32_t) store[8]) << 24) | (store[9] << 16) |
+	           (store[10] << 8) | store[11];
+	if(((((uint32_t) store[0]) << 24) | (store[1] << 16) | (store[2] << 8) |
+	    store[3]) != ROHC_COMP_STORE_MAGIC ||
+	   store[4] != ROHC_COMP_STORE_VERSION ||
+	   ((((uint32_t) store[12]) << 24) | (store[13] << 16) | (store[14] << 8) |
+	    store[15]) != ROHC_COMP_STORE_SLOT_LEN ||
+	   slots_nr > ((store_len - ROHC_COMP_STORE_HDR_LEN) / ROHC_COMP_STORE_SLOT_LEN))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to take over contexts: unknown store format");
+		goto error;
+	}
+
+	/* the buffer to rebuild the saved packets and to encode them */
+	buf = rohc_mem_alloc(&comp->mem_ops, ROHC_COMP_CKPT_BUF_LEN);
+	if(buf == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to take over contexts: no memory for packets");
+		goto error;
+	}
+
+	for(i = 0; i < slots_nr; i++)
+	{
+		const uint8_t *const slot =
+			store + ROHC_COMP_STORE_HDR_LEN + i * ROHC_COMP_STORE_SLOT_LEN;
+		const uint32_t *const seq = (const uint32_t *) slot;
+		bool is_consistent = false;
+		size_t rec_len = 0;
+		size_t tries;
+
+		/* copy the slot, again if the active compressor is still writing it;
+		 * a slot left odd by a failed compressor is never consistent */
+		for(tries = 0; !is_consistent && tries < ROHC_COMP_STORE_READ_TRIES; tries++)
+		{
+			const uint32_t start = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+
+			if((start & 1) != 0)
+			{
+				continue;
+			}
+			rec_len = (slot[4] << 8) | slot[5];
+			if(rec_len > ROHC_COMP_CKPT_CTXT_MAX_LEN)
+			{
+				rec_len = ROHC_COMP_CKPT_CTXT_MAX_LEN + 1;
+			}
+			else
+			{
+				memcpy(rec, slot + ROHC_COMP_STORE_SLOT_HDR_LEN, rec_len);
+			}
+			is_consistent = !rohc_seqlock_read_retry(seq, start);
+		}
+		if(!is_consistent)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "slot #%zu of the context store was being written, "
+			             "context skipped", i);
+			continue;
+		}
+		if(rec_len == 0)
+		{
+			continue;
+		}
+		if(rec_len > ROHC_COMP_CKPT_CTXT_MAX_LEN ||
+		   !c_check_saved_context(rec, rec_len, &rec_len))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "slot #%zu of the context store is malformed, context "
+			             "skipped", i);
+			continue;
+		}
+
+		if(c_restore_context(comp, (rec[0] << 8) | rec[1], (rec[2] << 8) | rec[3],
+		                     rec[4], rec[5], rec + ROHC_COMP_CKPT_CTXT_HDR_LEN,
+		                     rec[6], buf))
+		{
+			restored_nr++;
+		}
+	}
+	rohc_mem_free(&comp->mem_ops, buf);
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "%zu contexts taken over from the context store", restored_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Move one compression context to another compressor
+ *
+ * Move the context of one flow from one compressor to another one, eg. to
+ * rebalance the flows between the shards of a sharded compressor (see
+ * \ref rohc_comp_shards_new) or between the compressors of several threads.
+ * The context is restored in the destination compressor like
+ * \ref rohc_comp_restore_contexts does: the last packets of the context are
+ * replayed, so that the profile-specific part of the context (W-LSB windows,
+ * lists of extension headers, etc.) is rebuilt in the memory of the
+ * destination compressor. The context is then destroyed in the source
+ * compressor.
+ *
+ * If the context keeps its CID, the destination compressor shall send its
+ * packets to the same decompressor as the source compressor: the context
+ * goes on in its mode and state. If the context gets a new CID, the
+ * decompressor has no context for the new CID yet: the context restarts in
+ * the IR state and in U-mode.
+ *
+ * The headers of the last packets of the context shall have been recorded,
+ * so the \ref ROHC_COMP_FEATURE_CHECKPOINT feature shall be enabled in the
+ * source compressor. The destination compressor shall be configured like
+ * the source compressor (same profiles, same features).
+ *
+ * @param from      The ROHC compressor that holds the context
+ * @param from_cid  The CID of the context in the source compressor
+ * @param to        The ROHC compressor to move the context to
+ * @param to_cid    The CID of the context in the destination compressor,
+ *                  it shall be unused
+ * @return          true if the context was moved,
+ *                  false if the context cannot be moved, the context is
+ *                  then left unchanged in the source compressor
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_save_contexts
+ */
+bool rohc_comp_move_context(struct rohc_comp *const from,
+                            const rohc_cid_t from_cid,
+                            struct rohc_comp *const to,
+                            const rohc_cid_t to_cid)
+{
+	uint8_t rec[ROHC_COMP_CKPT_CTXT_MAX_LEN];
+	struct rohc_comp_ctxt *context;
+	rohc_mode_t mode;
+	rohc_comp_state_t state;
+	uint8_t *buf;
+
+	if(from == NULL || to == NULL)
+	{
+		goto error;
+	}
+
+	context = c_get_context(from, from_cid);
+	if(context == NULL)
+	{
+		rohc_warning(from, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to move context with CID %zu: no such context",
+		             from_cid);
+		goto error;
+	}
+	if(c_save_context(context, rec) == 0)
+	{
+		rohc_warning(from, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to move context with CID %zu: no headers recorded "
+		             "for the context", from_cid);
+		goto error;
+	}
+
+	/* a context with a new CID is unknown to the decompressor */
+	if(to_cid == from_cid)
+	{
+		mode = context->mode;
+		state = context->state;
+	}
+	else
+	{
+		mode = ROHC_U_MODE;
+		state = ROHC_COMP_STATE_IR;
+	}
+
+	buf = rohc_mem_alloc(&from->mem_ops, ROHC_COMP_CKPT_BUF_LEN);
+	if(buf == NULL)
+	{
+		rohc_warning(from, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to move context with CID %zu: no memory for "
+		             "packets", from_cid);
+		goto error;
+	}
+	if(!c_restore_context(to, to_cid, context->profile->id, mode, state,
+	                      rec + ROHC_COMP_CKPT_CTXT_HDR_LEN, rec[6], buf))
+	{
+		rohc_warning(from, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to move context with CID %zu to CID %zu",
+		             from_cid, to_cid);
+		goto free_buf;
+	}
+	rohc_mem_free(&from->mem_ops, buf);
+
+	rohc_info(from, ROHC_TRACE_COMP, context->profile->id, "context with CID "
+	          "%zu moved to CID %zu of another compressor", from_cid, to_cid);
+	c_destroy_context(from, context);
+
+	return true;
+
+free_buf:
+	rohc_mem_free(&from->mem_ops, buf);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Provision one compression context out of band
+ *
+ * Create the context of one known long-lived flow, eg. a fixed backhaul
+ * tunnel or a signalling link, from its first packets instead of from the
+ * IR packets sent on the link. The context is created at the given CID with
+ * the given profile, the packets are encoded as the IR packets the
+ * compressor would send for the new flow, then the context goes directly to
+ * the SO state: the next packets of the flow are compressed as if the IR
+ * packets were already received by the decompressor.
+ *
+ * The compressor sends MAX_IR_COUNT (3) IR packets for a new flow before it
+ * is confident that the decompressor knows every field of the context, so
+ * up to 3 packets may be given. With less packets, the fields that are
+ * repeated in the IR packets of a new flow, eg. the behaviour of the IP-ID,
+ * are repeated in the first compressed packets instead.
+ *
+ * The IR header built for the last packet is given back in \e descr: it is
+ * the description of the context to provision in the remote decompressor
+ * with \ref rohc_decomp_provision_context, eg. through the configuration of
+ * both endpoints. Both contexts share the same CID, profile, static and
+ * initial dynamic state, so no IR byte is sent on the link when it is
+ * brought up.
+ *
+ * The context starts in U-mode, like any new context. Periodic refreshes,
+ * if enabled, are sent as usual.
+ *
+ * @param comp        The ROHC compressor
+ * @param cid         The CID of the context, it shall be unused
+ * @param profile_id  The profile of the context, it shall be enabled
+ * @param pkts        The first uncompressed packets of the flow, in order
+ * @param pkts_nr     The number of packets, from 1 to 3
+ * @param[out] descr  The description of the context for the remote
+ *                    decompressor, the buffer shall be empty
+ * @return            true if the context was provisioned,
+ *                    false if the packets do not match the profile, if the
+ *                    CID is invalid or already in use, or if a parameter
+ *                    is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_decomp_provision_context
+ */
+bool rohc_comp_provision_context(struct rohc_comp *const comp,
+                                 const rohc_cid_t cid,
+                                 const rohc_profile_t profile_id,
+                                 const struct rohc_buf pkts[],
+                                 const size_t pkts_nr,
+                                 struct rohc_buf *const descr)
+{
+	const struct rohc_comp_profile *profile;
+	struct rohc_comp_ctxt *c = NULL;
+	int rohc_hdr_size = 0;
+	size_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(pkts == NULL || pkts_nr == 0 || pkts_nr > MAX_IR_COUNT)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "cannot provision context with CID %zu: 1 to %u packets "
+		             "expected", cid, MAX_IR_COUNT);
+		goto error;
+	}
+	for(i = 0; i < pkts_nr; i++)
+	{
+		if(!rohc_comp_check_bufs(comp, pkts[i], descr))
+		{
+			goto error;
+		}
+	}
+	if(cid < comp->min_cid || cid > comp->medium.max_cid)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "cannot provision context with CID %zu: CID out of range "
+		             "[%zu, %zu]", cid, comp->min_cid, comp->medium.max_cid);
+		goto error;
+	}
+	profile = rohc_get_profile_from_id(comp, profile_id);
+	if(profile == NULL || profile_id == ROHC_PROFILE_UNCOMPRESSED)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "cannot provision context with CID %zu: profile 0x%04x is "
+		             "not enabled or has no context to provision", cid,
+		             profile_id);
+		goto error;
+	}
+
+	for(i = 0; i < pkts_nr; i++)
+	{
+		struct net_pkt ip_pkt;
+		rohc_packet_t packet_type;
+		size_t payload_offset;
+
+		if(!net_pkt_parse(&ip_pkt, pkts[i],
+		                  !!(c_features(comp) & ROHC_COMP_FEATURE_FLOW_KEY),
+		                  comp->trace_callback, comp->trace_callback_priv,
+		                  ROHC_TRACE_COMP))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "cannot provision context with CID %zu: malformed "
+			             "packet #%zu", cid, i + 1);
+			goto destroy_ctxt;
+		}
+
+		if(c == NULL)
+		{
+			/* create the context at the given CID with the first packet */
+			if(!profile->check_profile(comp, &ip_pkt))
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "cannot provision context with CID %zu: packet does "
+				             "not match profile '%s'", cid,
+				             rohc_get_profile_descr(profile_id));
+				goto error;
+			}
+			c = c_alloc_ctxt(comp, cid);
+			if(c == NULL || c->used)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "cannot provision context with CID %zu: no memory or "
+				             "CID already in use", cid);
+				goto error;
+			}
+			if(!c_init_context(comp, c, cid, profile, &ip_pkt, pkts[i].time))
+			{
+				goto error;
+			}
+		}
+		else if(ip_pkt.key != c->key || !profile->check_context(c, &ip_pkt))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "cannot provision context with CID %zu: packet #%zu "
+			             "does not belong to the flow", cid, i + 1);
+			goto destroy_ctxt;
+		}
+
+		/* encode the packet in the IR packet the compressor would have sent,
+		 * the IR header of the last packet is the description */
+		rohc_hdr_size = profile->encode(c, &ip_pkt, rohc_buf_data(*descr),
+		                                rohc_buf_avail_len(*descr), &packet_type,
+		                                &payload_offset);
+		if(rohc_hdr_size < 0)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "cannot provision context with CID %zu: failed to "
+			             "encode packet #%zu", cid, i + 1);
+			goto destroy_ctxt;
+		}
+		if(packet_type != ROHC_PACKET_IR)
+		{
+			/* eg. an IR-CR packet that refers to another context */
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "cannot provision context with CID %zu: packet #%zu "
+			             "encoded as %s instead of IR", cid, i + 1,
+			             rohc_get_packet_descr(packet_type));
+			goto destroy_ctxt;
+		}
+		c->packet_type = packet_type;
+		c->num_sent_packets++;
+		if((c_features(comp) & ROHC_COMP_FEATURE_CHECKPOINT) != 0)
+		{
+			c_ctxt_record_pkt(comp, c, rohc_buf_data(pkts[i]), payload_offset,
+			                  pkts[i].len - payload_offset);
+		}
+	}
+	descr->len = rohc_hdr_size;
+
+	/* the decompressor is provisioned with the same context */
+	rohc_comp_change_state(c, ROHC_COMP_STATE_SO);
+
+	rohc_info(comp, ROHC_TRACE_COMP, profile_id, "context with CID %zu "
+	          "provisioned in state SO from %zu packets with a %d-byte "
+	          "description", cid, pkts_nr, rohc_hdr_size);
+
+	return true;
+
+destroy_ctxt:
+	if(c != NULL)
+	{
+		c_destroy_context(comp, c);
+	}
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the window width for the W-LSB encoding scheme
+ *
+ * Set the window width for the Window-based Least Significant Bits (W-LSB)
+ * encoding. See section 4.5.2 of RFC 3095 for more details about the encoding
+ * scheme.
+ *
+ * The width of the W-LSB window is set to 4 by default.
+ *
+ * The value may be modified while the compressor is in use, eg. to tune a
+ * live link: the new width applies to the contexts created afterwards, the
+ * existing contexts keep their W-LSB windows.
+ *
+ * @warning The value must be a power of 2
+ *
+ * @param comp   The ROHC compressor
+ * @param width  The width of the W-LSB sliding window
+ * @return       true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_wlsb_window_width(struct rohc_comp *const comp,
+                                     const size_t width)
+{
+	/* we need a valid compressor and a positive non-zero window width */
+	if(comp == NULL)
+	{
+		return false;
+	}
+	if(width == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "set width of W-LSB sliding window to %zd: window width "
+		             "must be a non-null positive integer", width);
+		return false;
+	}
+
+	/* window width must be a power of 2 */
+	if((width & (width - 1)) != 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
+		             "set width of W-LSB sliding window to %zd: window width "
+		             "must be a power of 2", width);
+		return false;
+	}
+
+	comp->wlsb_window_width = width;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "width of W-LSB sliding window set to %zd", width);
+
+	return true;
+}
+
+
+/**
+ * @brief Get the window width for the W-LSB encoding scheme
+ *
+ * @param comp        The ROHC compressor
+ * @param[out] width  The width of the W-LSB sliding window for the new
+ *                    contexts
+ * @return            true if the width was successfully retrieved,
+ *                    false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_wlsb_window_width
+ */
+bool rohc_comp_get_wlsb_window_width(const struct rohc_comp *const comp,
+                                     size_t *const width)
+{
+	if(comp == NULL || width == NULL)
+	{
+		goto error;
+	}
+
+	*width = comp->wlsb_window_width;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the timeout values for IR and FO periodic refreshes
+ *
+ * Set the timeout values for IR and FO periodic refreshes. The IR timeout
+ * shall be greater than the FO timeout. Both timeouts are expressed in
+ * number of compressed packets.
+ *
+ * The IR timeout is set to \ref CHANGE_TO_IR_COUNT by default.
+ * The FO timeout is set to \ref CHANGE_TO_FO_COUNT by default.
+ *
+ * The values may be modified while the compressor is in use, eg. to tune a
+ * live link: the new timeouts apply to all the contexts from the next
+ * compressed packet.
+ *
+ * @param comp        The ROHC compressor
+ * @param ir_timeout  The number of packets to compress before going back
+ *                    to IR state to force a context refresh
+ * @param fo_timeout  The number of packets to compress before going back
+ *                    to FO state to force a context refresh
+ * @return            true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_periodic_refreshes(struct rohc_comp *const comp,
+                                      const size_t ir_timeout,
+                                      const size_t fo_timeout)
+{
+	/* we need a valid compressor, positive non-zero timeouts,
+	 * and IR timeout > FO timeout */
+	if(comp == NULL)
+	{
+		return false;
+	}
+	if(ir_timeout == 0 || fo_timeout == 0 || ir_timeout <= fo_timeout)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "invalid "
+		             "timeouts for context periodic refreshes (IR timeout = %zd, "
+		             "FO timeout = %zd)", ir_timeout, fo_timeout);
+		return false;
+	}
+
+	comp->periodic_refreshes_ir_timeout = ir_timeout;
+	comp->periodic_refreshes_fo_timeout = fo_timeout;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "IR timeout for "
+	          "context periodic refreshes set to %zd", ir_timeout);
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "FO timeout for "
+	          "context periodic refreshes set to %zd", fo_timeout);
+
+	return true;
+}
+
+
+/**
+ * @brief Get the timeout values for IR and FO periodic refreshes
+ *
+ * @param comp             The ROHC compressor
+ * @param[out] ir_timeout  The number of packets to compress before going
+ *                         back to IR state to force a context refresh
+ * @param[out] fo_timeout  The number of packets to compress before going
+ *                         back to FO state to force a context refresh
+ * @return                 true if the timeouts were successfully retrieved,
+ *                         false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_periodic_refreshes
+ */
+bool rohc_comp_get_periodic_refreshes(const struct rohc_comp *const comp,
+                                      size_t *const ir_timeout,
+                                      size_t *const fo_timeout)
+{
+	if(comp == NULL || ir_timeout == NULL || fo_timeout == NULL)
+	{
+		goto error;
+	}
+
+	*ir_timeout = comp->periodic_refreshes_ir_timeout;
+	*fo_timeout = comp->periodic_refreshes_fo_timeout;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the timeout values for IR and FO periodic refreshes in time
+ *
+ * Set the timeout values for IR and FO periodic refreshes in milliseconds,
+ * measured with the arrival times of the packets given to the compressor.
+ * The contexts are refreshed when either the packet timeouts set by
+ * \ref rohc_comp_set_periodic_refreshes or the time timeouts expire. The IR
+ * timeout shall be greater than the FO timeout.
+ *
+ * Both timeouts are set to 0 by default, ie. time-based refreshes are
+ * disabled. Set both timeouts to 0 to disable them again.
+ *
+ * The values may be modified while the compressor is in use: the new
+ * timeouts apply to all the contexts from the next compressed packet.
+ *
+ * @param comp        The ROHC compressor
+ * @param ir_timeout  The time (in milliseconds) spent in FO or SO state
+ *                    before going back to IR state to force a context refresh
+ * @param fo_timeout  The time (in milliseconds) spent in SO state before
+ *                    going back to FO state to force a context refresh
+ * @return            true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_periodic_refreshes
+ * @see rohc_comp_get_periodic_refreshes_time
+ */
+bool rohc_comp_set_periodic_refreshes_time(struct rohc_comp *const comp,
+                                           const size_t ir_timeout,
+                                           const size_t fo_timeout)
+{
+	/* we need a valid compressor, and either both timeouts disabled or
+	 * positive non-zero timeouts with IR timeout > FO timeout */
+	if(comp == NULL)
+	{
+		return false;
+	}
+	if((ir_timeout != 0 || fo_timeout != 0) &&
+	   (fo_timeout == 0 || ir_timeout <= fo_timeout ||
+	    ir_timeout > (UINT32_MAX >> ROHC_COMP_REFRESH_SCALE_MAX)))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "invalid "
+		             "times for context periodic refreshes (IR timeout = %zu ms, "
+		             "FO timeout = %zu ms)", ir_timeout, fo_timeout);
+		return false;
+	}
+
+	comp->periodic_refreshes_ir_time = ir_timeout;
+	comp->periodic_refreshes_fo_time = fo_timeout;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "IR time for "
+	          "context periodic refreshes set to %zu ms", ir_timeout);
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "FO time for "
+	          "context periodic refreshes set to %zu ms", fo_timeout);
+
+	return true;
+}
+
+
+/**
+ * @brief Get the timeout values for IR and FO periodic refreshes in time
+ *
+ * @param comp             The ROHC compressor
+ * @param[out] ir_timeout  The time (in milliseconds) spent in FO or SO state
+ *                         before going back to IR state, 0 if disabled
+ * @param[out] fo_timeout  The time (in milliseconds) spent in SO state before
+ *                         going back to FO state, 0 if disabled
+ * @return                 true if the timeouts were successfully retrieved,
+ *                         false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_periodic_refreshes_time
+ */
+bool rohc_comp_get_periodic_refreshes_time(const struct rohc_comp *const comp,
+                                           size_t *const ir_timeout,
+                                           size_t *const fo_timeout)
+{
+	if(comp == NULL || ir_timeout == NULL || fo_timeout == NULL)
+	{
+		goto error;
+	}
+
+	*ir_timeout = comp->periodic_refreshes_ir_time;
+	*fo_timeout = comp->periodic_refreshes_fo_time;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Pace the IR packets of the compressor
+ *
+ * Limit the bytes of IR and IR-DYN headers sent per interval of time,
+ * measured with the arrival times of the packets given to the compressor.
+ * When many flows start at once or after \ref rohc_comp_force_contexts_reinit,
+ * the contexts that shall send an IR packet once the budget of the interval
+ * is spent send their packets uncompressed through one Uncompressed context
+ * shared by all of them, until the next interval. The Uncompressed profile
+ * shall be enabled, otherwise the IR packets are not paced.
+ *
+ * The IR packets are not paced by default. Set both parameters to 0 to
+ * disable the pacing again.
+ *
+ * The values may be modified while the compressor is in use: the new budget
+ * applies from the next compressed packet.
+ *
+ * @param comp      The ROHC compressor
+ * @param budget    The bytes of IR and IR-DYN headers allowed per interval
+ * @param interval  The length (in milliseconds) of the interval
+ * @return          true in case of success, false in case of failure
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_ir_pacing(struct rohc_comp *const comp,
+                             const size_t budget,
+                             const size_t interval)
+{
+	/* we need a valid compressor, and either the pacing disabled or a
+	 * positive non-zero budget per positive non-zero interval */
+	if(comp == NULL)
+	{
+		return false;
+	}
+	if((budget == 0) != (interval == 0) || interval > (UINT32_MAX >> 1))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "invalid "
+		             "IR pacing (%zu bytes every %zu ms)", budget, interval);
+		return false;
+	}
+
+	comp->ir_pacing_budget = budget;
+	comp->ir_pacing_interval = interval;
+	comp->ir_pacing_left = budget;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "IR packets paced "
+	          "to %zu bytes of headers every %zu ms", budget, interval);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the number of uncompressed transmissions for list compression
+ *
+ * Set the number of transmissions required for list compression. This matches
+ * the L parameter described in RFC 3095 and 4815. The compressor sends the
+ * list items uncompressed L times before compressing them. The compressor
+ * also sends the list structure L times before compressing it out.
+ *
+ * The L parameter is set to \ref ROHC_LIST_DEFAULT_L by default.
+ *
+ * @warning The value can not be modified after library initialization
+ *
+ * @param comp           The ROHC compressor
+ * @param list_trans_nr  The number of times the list items or the list itself
+ *                       are sent uncompressed before being sent compressed
+ * @return               true if the new value is accepted,
+ *                       false if the value is rejected
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_list_trans_nr(struct rohc_comp *const comp,
+                                 const size_t list_trans_nr)
+{
+	/* we need a valid compressor and a positive non-zero value for L */
+	if(comp == NULL)
+	{
+		return false;
+	}
+	if(list_trans_nr == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "invalid "
+		             "value for uncompressed transmissions of list compression "
+		             "(%zu)", list_trans_nr);
+		return false;
+	}
+
+	/* refuse to set values if compressor is in use */
+	if(comp->num_packets > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unable to modify the value for uncompressed transmissions"
+		             " of list compression after initialization");
+		return false;
+	}
+
+	comp->list_trans_nr = list_trans_nr;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "uncompressed "
+	          "transmissions of list compression set to %zu", list_trans_nr);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the timeout after which unused contexts are destroyed
+ *
+ * By default, the contexts are destroyed only when all the CIDs are in use
+ * and a new flow needs one: the least recently used context is recycled.
+ * Until then, the contexts of the flows that ended keep their memory.
+ *
+ * With an idle timeout, the contexts that did not compress any packet for
+ * \e timeout seconds are destroyed before the next packet is compressed,
+ * and their memory is given back for the next contexts. The timeout is
+ * compared to the arrival times of the packets: the contexts never expire
+ * if the arrival times are not given (zero).
+ *
+ * The contexts are expired from the end of the list of the least recently
+ * used contexts, so the expiry costs nothing while no context expires.
+ *
+ * The timeout shall be larger than the timeout of the decompressor (see
+ * \ref rohc_decomp_set_ctxt_idle_timeout), so that a flow that restarts
+ * after a pause is compressed with IR packets if the decompressor lost its
+ * context.
+ *
+ * @param comp     The ROHC compressor
+ * @param timeout  The number of seconds a context may stay unused,
+ *                 0 to never expire the contexts (default)
+ * @return         true if the new value is accepted,
+ *                 false if the value is rejected
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_ctxt_idle_timeout(struct rohc_comp *const comp,
+                                     const size_t timeout)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	comp->ctxt_idle_timeout = timeout;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "idle timeout of "
+	          "contexts set to %zu seconds", timeout);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the time the contexts of the ended flows are kept
+ *
+ * The profiles that detect the end of their flows mark the contexts of the
+ * ended flows as closed: the TCP profile marks the context of one TCP
+ * connection as closed once the FIN or RST flag was sent. The closed
+ * contexts are always recycled before the other contexts when all the CIDs
+ * are in use.
+ *
+ * With a linger time, the closed contexts are also destroyed \e linger
+ * seconds after the end of their flows, before the next packet is
+ * compressed, and their memory is given back for the next contexts. The
+ * linger time shall be long enough for the last packets of the flow, eg.
+ * the final TCP ACK or the retransmissions of the TCP FIN. A TCP SYN sent in
+ * a closed context re-opens it. Like the idle timeout (see
+ * \ref rohc_comp_set_ctxt_idle_timeout), the linger time is compared to
+ * the arrival times of the packets.
+ *
+ * The closed contexts are kept in the order their flows ended, so the
+ * release costs nothing while no linger time expires.
+ *
+ * @param comp    The ROHC compressor
+ * @param linger  The number of seconds the contexts of the ended flows are
+ *                kept, 0 to keep them until they are recycled (default)
+ * @return        true if the new value is accepted,
+ *                false if the value is rejected
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_closed_ctxt_linger(struct rohc_comp *const comp,
+                                      const size_t linger)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	comp->closed_ctxt_linger = linger;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "contexts of the "
+	          "ended flows kept for %zu seconds", linger);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the maximum number of bytes the compressor should use
+ *
+ * The memory of the compressor grows with the number of contexts in use:
+ * pages of contexts, profile-specific parts of the contexts, W-LSB windows,
+ * translation tables of lists, TCP options... Without budget, it grows until
+ * all the CIDs up to MAX_CID are in use.
+ *
+ * With a budget, the compressor stops growing once it uses \e budget bytes:
+ * new flows then recycle the least recently used contexts, as if all the
+ * CIDs were in use. The memory of the recycled contexts is reused for the
+ * new contexts. The budget is a soft limit: the compressor may exceed it by
+ * the memory of one context, eg. the first context of a new profile.
+ *
+ * The budget may be changed at any time. A budget smaller than the memory
+ * already in use does not free any memory, but no new memory is used until
+ * the usage falls below the budget.
+ *
+ * @param comp    The ROHC compressor
+ * @param budget  The maximum number of bytes the compressor should use,
+ *                0 for no limit (default)
+ * @return        true if the new value is accepted,
+ *                false if the value is rejected
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_mem_usage
+ */
+bool rohc_comp_set_mem_budget(struct rohc_comp *const comp,
+                              const size_t budget)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	comp->mem_budget = budget;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "memory budget "
+	          "set to %zu bytes (%zu bytes in use)", budget, c_mem_usage(comp));
+
+	return true;
+}
+
+
+/**
+ * @brief Get the number of bytes the compressor uses
+ *
+ * The memory allocated with the callbacks given to
+ * \ref rohc_comp_set_alloc_cbs is counted.
+ *
+ * @param comp        The ROHC compressor
+ * @param[out] usage  The number of bytes the compressor uses
+ * @return            true if the usage was successfully retrieved,
+ *                    false if a parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_mem_budget
+ */
+bool rohc_comp_get_mem_usage(const struct rohc_comp *const comp,
+                             size_t *const usage)
+{
+	if(comp == NULL || usage == NULL)
+	{
+		goto error;
+	}
+
+	*usage = c_mem_usage(comp);
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the load beyond which the compressor sheds work
+ *
+ * When a core is saturated, degrading compression is better than dropping
+ * packets. Once the load given with \ref rohc_comp_set_load exceeds one of
+ * the limits, the compressor enters the overload mode until a load within
+ * the limits is given:
+ *  - the packets of the new flows are sent through one Uncompressed context
+ *    shared by such flows, so that they cost no context creation, no IR
+ *    packet and no change detection; the flow gets a context of its own
+ *    with its first packet after the overload (the Uncompressed profile
+ *    shall be enabled);
+ *  - the periodic refreshes of the contexts are deferred until the
+ *    overload is over.
+ *
+ * A limit of 0 disables the corresponding criterion. The compressor is
+ * never overloaded by default.
+ *
+ * @param comp    The ROHC compressor
+ * @param limits  The load beyond which the compressor sheds work,
+ *                NULL to never shed work
+ * @return        true if the new limits are accepted,
+ *                false if the compressor is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_load
+ */
+bool rohc_comp_set_overload(struct rohc_comp *const comp,
+                            const struct rohc_load *const limits)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	if(limits == NULL)
+	{
+		comp->overload_limits.queue_depth = 0;
+		comp->overload_limits.burst_time_us = 0;
+	}
+	else
+	{
+		comp->overload_limits = *limits;
+	}
+	comp->is_overloaded = false;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "overload beyond "
+	          "%zu queued packets or %u us per burst",
+	          comp->overload_limits.queue_depth,
+	          comp->overload_limits.burst_time_us);
+
+	return true;
+}
+
+
+/**
+ * @brief Give the current load of the core to the compressor
+ *
+ * Call the function before a burst of packets, eg. with the depth of the
+ * queue the packets are taken from and the time the previous burst took.
+ * The compressor enters or leaves the overload mode according to the limits
+ * set with \ref rohc_comp_set_overload.
+ *
+ * @param comp  The ROHC compressor
+ * @param load  The current load of the core
+ * @return      true if the load is accepted,
+ *              false if a parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_overload
+ */
+bool rohc_comp_set_load(struct rohc_comp *const comp,
+                        const struct rohc_load *const load)
+{
+	bool is_overloaded;
+
+	if(comp == NULL || load == NULL)
+	{
+		return false;
+	}
+
+	is_overloaded =
+		((comp->overload_limits.queue_depth != 0 &&
+		  load->queue_depth > comp->overload_limits.queue_depth) ||
+		 (comp->overload_limits.burst_time_us != 0 &&
+		  load->burst_time_us > comp->overload_limits.burst_time_us));
+	if(is_overloaded && !comp->is_overloaded)
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "enter overload "
+		          "mode (%zu queued packets, %u us per burst)",
+		          load->queue_depth, load->burst_time_us);
+		rohc_seqlock_write_begin(&comp->stats_seq);
+		comp->overloads_nr++;
+		rohc_seqlock_write_end(&comp->stats_seq);
+	}
+	else if(!is_overloaded && comp->is_overloaded)
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "leave overload "
+		          "mode (%zu queued packets, %u us per burst)",
+		          load->queue_depth, load->burst_time_us);
+	}
+	comp->is_overloaded = is_overloaded;
+
+	return true;
+}
+
+
+/**
+ * @brief Get the runtime configuration of the compressor
+ *
+ * Copy the runtime tunables in use by the compressor, eg. to modify some of
+ * them and publish the result with \ref rohc_comp_publish_cfg. The function
+ * may be called by another thread than the thread of the compressor. A
+ * configuration published but not taken by the compressor yet is not
+ * returned.
+ *
+ * @param comp      The ROHC compressor
+ * @param[out] cfg  The runtime configuration of the compressor
+ * @return          true if the configuration is copied,
+ *                  false if a parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_publish_cfg
+ */
+bool rohc_comp_get_cfg(const struct rohc_comp *const comp,
+                       struct rohc_comp_cfg *const cfg)
+{
+	uint32_t seq;
+
+	if(comp == NULL || cfg == NULL)
+	{
+		goto error;
+	}
+
+	/* copied again if the compressor took a new configuration meanwhile */
+	do
+	{
+		seq = rohc_seqlock_read_begin(&comp->stats_seq);
+		cfg->features = c_features(comp);
+		cfg->refresh_ir_timeout = comp->periodic_refreshes_ir_timeout;
+		cfg->refresh_fo_timeout = comp->periodic_refreshes_fo_timeout;
+		cfg->refresh_ir_time = comp->periodic_refreshes_ir_time;
+		cfg->refresh_fo_time = comp->periodic_refreshes_fo_time;
+		cfg->ir_pacing_budget = comp->ir_pacing_budget;
+		cfg->ir_pacing_interval = comp->ir_pacing_interval;
+		cfg->ctxt_idle_timeout = comp->ctxt_idle_timeout;
+		cfg->closed_ctxt_linger = comp->closed_ctxt_linger;
+		cfg->mem_budget = comp->mem_budget;
+		cfg->compress_min_priority = comp->compress_min_priority;
+		cfg->overload_limits = comp->overload_limits;
+		cfg->effort = comp->effort;
+	}
+	while(rohc_seqlock_read_retry(&comp->stats_seq, seq));
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Publish a new runtime configuration for the compressor
+ *
+ * Retune a running compressor without locking it: the given configuration
+ * is checked, then copied in an immutable snapshot that replaces the
+ * pending one atomically. The compressor takes the snapshot at the
+ * beginning of the next call to \ref rohc_compress4,
+ * \ref rohc_compress_burst or \ref rohc_compress_hdr, so that every packet
+ * or burst is compressed with one consistent configuration. The cost for
+ * the thread of the compressor is one load per packet or burst when no
+ * configuration is pending.
+ *
+ * The function is meant to be called by another thread than the thread of
+ * the compressor, eg. the thread of the control plane. No lock is required
+ * as long as only one thread publishes configurations for the compressor.
+ * A snapshot published while another one is still pending supersedes it.
+ *
+ * The parameters that size the contexts, eg. the width of the W-LSB
+ * windows, cannot be changed this way, see \ref rohc_comp_set_wlsb_window_width
+ * and \ref rohc_comp_set_list_trans_nr.
+ *
+ * @param comp  The ROHC compressor
+ * @param cfg   The new runtime configuration, see \ref rohc_comp_get_cfg
+ * @return      true if the configuration is published,
+ *              false if a parameter is invalid or if the snapshot cannot
+ *              be allocated
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_cfg
+ */
+bool rohc_comp_publish_cfg(struct rohc_comp *const comp,
+                           const struct rohc_comp_cfg *const cfg)
+{
+	struct rohc_comp_cfg *snapshot;
+	struct rohc_comp_cfg *superseded;
+
+	if(comp == NULL || cfg == NULL)
+	{
+		goto error;
+	}
+	if(!rohc_comp_check_cfg(comp, cfg))
+	{
+		goto error;
+	}
+
+	snapshot = rohc_mem_alloc(&comp->mem_ops, sizeof(struct rohc_comp_cfg));
+	if(snapshot == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to allocate the configuration snapshot");
+		goto error;
+	}
+	*snapshot = *cfg;
+
+	/* the snapshot is never modified once published: the compressor owns it
+	 * once taken, the publisher owns the pending snapshot it replaced */
+	superseded = __atomic_exchange_n(&comp->cfg_pending, snapshot,
+	                                 __ATOMIC_ACQ_REL);
+	rohc_mem_free(&comp->mem_ops, superseded);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the callback function for the priority classes of flows
+ *
+ * Set or replace the callback function that the ROHC library calls for the
+ * first packet of every new flow to classify the flow. The classes change
+ * how the contexts are recycled when all the CIDs are in use:
+ *  - the context to recycle is the one of lowest class among the
+ *    \ref ROHC_COMP_RECYCLE_CANDIDATES least recently used contexts, the
+ *    one with the fewest packets among the ones of the same class;
+ *  - a new flow of lower class than that context does not recycle it, it is
+ *    sent through one Uncompressed context shared by such flows instead (if
+ *    the Uncompressed profile is enabled).
+ *
+ * Special value NULL disables the priority classes: the least recently used
+ * context is recycled. There is no callback by default.
+ *
+ * @param comp       The ROHC compressor
+ * @param callback   The callback function used to classify the flows
+ * @param priv_ctxt  A pointer to an external memory area provided and used
+ *                   by the callback user
+ * @return           true on success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_priority_callback_t
+ * @see rohc_comp_set_compress_min_priority
+ */
+bool rohc_comp_set_priority_cb(struct rohc_comp *const comp,
+                               rohc_comp_priority_callback_t callback,
+                               void *const priv_ctxt)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	comp->priority_callback = callback;
+	comp->priority_private = priv_ctxt;
+
+	return true;
+}
+
+
+/**
+ * @brief Set the lowest priority class of the flows to compress
+ *
+ * The flows classified by the callback set with \ref rohc_comp_set_priority_cb
+ * in a lower class are not worth a context of their own, eg. the one-packet
+ * DNS flows: they are all sent through one context of the Uncompressed
+ * profile, so that they do not recycle the contexts of the other flows nor
+ * cost IR packets. The Uncompressed profile shall be enabled.
+ *
+ * The lowest priority class is 0 by default, ie. all the flows are
+ * compressed.
+ *
+ * @param comp          The ROHC compressor
+ * @param min_priority  The lowest priority class of the flows to compress
+ * @return              true on success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_priority_cb
+ */
+bool rohc_comp_set_compress_min_priority(struct rohc_comp *const comp,
+                                         const unsigned int min_priority)
+{
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	comp->compress_min_priority = min_priority;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "flows of priority "
+	          "class lower than %u are not compressed", min_priority);
+
+	return true;
+}
+
+
+/**
+ * @brief Set the RTP detection callback function
+ *
+ * Set or replace the callback function that the ROHC library will call to
+ * detect RTP streams among other UDP streams.
+ *
+ * The function is called once per UDP packet to compress, with the IP and
+ * UDP headers and the UDP payload. If the callback function returns true, the
+ * RTP profile is used for compression, otherwise the IP/UDP profile is used
+ * instead.
+ *
+ * Special value NULL may be used to disable the detection of RTP streams with
+ * the callback method. The detection will then be based on the list of UDP
+ * ports dedicated for RTP streams only.
+ *
+ * The UDP ports dedicated for RTP streams are checked first: the callback is
+ * called only for the UDP packets whose destination port is not in the list.
+ *
+ * @param comp        The ROHC compressor
+ * @param callback    The callback function used to detect RTP packets
+ *                    The callback is deactivated if NULL is given as parameter
+ * @param rtp_private A pointer to an external memory area
+ *                    provided and used by the callback user
+ * @return            true on success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * \par Example:
+ * \snippet rtp_detection.c define RTP detection callback
+ * \code
+        ...
+\endcode
+ * \snippet simple_rohc_program.c define ROHC compressor
+ * \code
+        ...
+\endcode
+ * \snippet simple_rohc_program.c create ROHC compressor
+ * \code
+        ...
+\endcode
+ * \snippet rtp_detection.c set RTP detection callback
+ * \code
+        ...
+\endcode
+ * \snippet simple_rohc_program.c destroy ROHC compressor
+ *
+ * @see rohc_rtp_detection_callback_t
+ * @see rohc_comp_add_rtp_ports
+ * @see rohc_comp_remove_rtp_ports
+ * @see rohc_comp_reset_rtp_ports
+ */
+bool rohc_comp_set_rtp_detection_cb(struct rohc_comp *const comp,
+                                    rohc_rtp_detection_callback_t callback,
+                                    void *const rtp_private)
+{
+	/* sanity check on compressor */
+	if(comp == NULL)
+	{
+		return false;
+	}
+
+	/* set RTP detection callback */
+	comp->rtp_callback = callback;
+	comp->rtp_private = rtp_private;
+
+	return true;
+}
+
+
+/**
+ * @brief Add a range of UDP ports to the list of ports dedicated for RTP
+ *
+ * The UDP packets whose destination port is in the list are compressed with
+ * the RTP profile (if enabled). The list is a bitmap of all the UDP ports, so
+ * that the detection of RTP packets is one bit test per packet. The UDP
+ * packets whose destination port is not in the list are given to the RTP
+ * detection callback if one is set.
+ *
+ * The list is empty by default.
+ *
+ * @param comp        The ROHC compressor
+ * @param first_port  The first UDP port of the range
+ * @param last_port   The last UDP port of the range (included)
+ * @return            true if the ports were added to the list,
+ *                    false if one parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_remove_rtp_ports
+ * @see rohc_comp_reset_rtp_ports
+ * @see rohc_comp_set_rtp_detection_cb
+ */
+bool rohc_comp_add_rtp_ports(struct rohc_comp *const comp,
+                             const uint16_t first_port,
+                             const uint16_t last_port)
+{
+	size_t port;
+
+	if(comp == NULL || first_port > last_port)
+	{
+		goto error;
+	}
+
+	for(port = first_port; port <= last_port; port++)
+	{
+		const uint64_t bit = ((uint64_t) 1) << (port % 64);
+
+		if((comp->rtp_ports[port / 64] & bit) == 0)
+		{
+			comp->rtp_ports[port / 64] |= bit;
+			comp->rtp_ports_nr++;
+		}
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "UDP ports [%u, %u] added to the ports dedicated for RTP, %zu "
+	           "ports are now dedicated for RTP", first_port, last_port,
+	           comp->rtp_ports_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Remove a range of UDP ports from the list of ports dedicated for RTP
+ *
+ * @param comp        The ROHC compressor
+ * @param first_port  The first UDP port of the range
+ * @param last_port   The last UDP port of the range (included)
+ * @return            true if the ports were removed from the list,
+ *                    false if one parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_add_rtp_ports
+ * @see rohc_comp_reset_rtp_ports
+ */
+bool rohc_comp_remove_rtp_ports(struct rohc_comp *const comp,
+                                const uint16_t first_port,
+                                const uint16_t last_port)
+{
+	size_t port;
+
+	if(comp == NULL || first_port > last_port)
+	{
+		goto error;
+	}
+
+	for(port = first_port; port <= last_port; port++)
+	{
+		const uint64_t bit = ((uint64_t) 1) << (port % 64);
+
+		if((comp->rtp_ports[port / 64] & bit) != 0)
+		{
+			comp->rtp_ports[port / 64] &= ~bit;
+			comp->rtp_ports_nr--;
+		}
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "UDP ports [%u, %u] removed from the ports dedicated for RTP, "
+	           "%zu ports are now dedicated for RTP", first_port, last_port,
+	           comp->rtp_ports_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Empty the list of UDP ports dedicated for RTP
+ *
+ * @param comp  The ROHC compressor
+ * @return      true if the list was emptied, false if the compressor is
+ *              invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_add_rtp_ports
+ * @see rohc_comp_remove_rtp_ports
+ */
+bool rohc_comp_reset_rtp_ports(struct rohc_comp *const comp)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	memset(comp->rtp_ports, 0, sizeof(comp->rtp_ports));
+	comp->rtp_ports_nr = 0;
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "no UDP port is dedicated for RTP anymore");
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Enable or disable the timer-based compression of the RTP TimeStamp
+ *
+ * Timer-based compression of RTP TS (see RFC 3095, section 4.5.4) reduces
+ * the number of TS bits transmitted after the RTP source stopped sending
+ * packets for a while, eg. during silence periods of a voice stream. The
+ * decompressor approximates the RTP TS from the arrival time of the packets.
+ *
+ * The arrival time of every packet shall be given to the compressor in the
+ * \e time field of the uncompressed packet buffer. Packets without arrival
+ * time disable the timer-based compression until a new TIME_STRIDE is
+ * transmitted. The decompressor shall be configured for timer-based
+ * compression too, see \ref ROHC_DECOMP_FEATURE_TS_TIMER.
+ *
+ * The timer-based compression is disabled by default.
+ *
+ * The function can not be called anymore once the compressor compressed
+ * its first packet.
+ *
+ * @param comp           The ROHC compressor
+ * @param enabled        Whether the timer-based compression of the RTP TS
+ *                       shall be enabled or not
+ * @param max_jitter_cd  The maximum jitter (in milliseconds) of the delay
+ *                       between the compressor and the decompressor
+ * @return               true if the setting was applied,
+ *                       false if the compressor is invalid or in use
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_set_rtp_ts_timer(struct rohc_comp *const comp,
+                                const bool enabled,
+                                const size_t max_jitter_cd)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* refuse to set a value if compressor is in use */
+	if(comp->num_packets > 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
+		             "modify the timer-based compression of RTP TS after "
+		             "initialization");
+		goto error;
+	}
+
+	comp->rtp_ts_timer = enabled;
+	comp->rtp_ts_max_jitter_cd = max_jitter_cd;
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "timer-based compression of RTP TS %s (max jitter between "
+	          "compressor and decompressor = %zu ms)",
+	          (enabled ? "enabled" : "disabled"), max_jitter_cd);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Is the given compression profile enabled for a compressor?
+ *
+ * Is the given compression profile enabled or disabled for a compressor?
+ *
+ * @param comp     The ROHC compressor
+ * @param profile  The profile to ask status for
+ * @return         Possible return values:
+ *                  \li true if the profile exists and is enabled,
+ *                  \li false if the compressor is not valid, the profile
+ *                      does not exist, or the profile is disabled
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_enable_profile
+ * @see rohc_comp_enable_profiles
+ * @see rohc_comp_disable_profile
+ * @see rohc_comp_disable_profiles
+ */
+bool rohc_comp_profile_enabled(const struct rohc_comp *const comp,
+                               const rohc_profile_t profile)
+{
+	size_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* get the profile location */
+	i = rohc_comp_get_profile_idx(profile);
+	if(i == ROHC_COMP_PROFILE_IDX_NONE)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unknown ROHC compression profile (ID = %d)", profile);
+		goto error;
+	}
+
+	/* return profile status */
+	return comp->enabled_profiles[i];
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Enable a compression profile for a compressor
+ *
+ * Enable a compression profiles for a compressor.
+ *
+ * The ROHC compressor does not use the compression profiles that are not
+ * enabled. Thus not enabling a profile might affect compression performances.
+ * Compression will fail if no profile at all is enabled.
+ *
+ * If the profile is already enabled, nothing is performed and success is
+ * reported.
+ *
+ * A ROHCv1 profile and its ROHCv2 counterpart (eg. \ref ROHC_PROFILE_IP and
+ * \ref ROHCv2_PROFILE_IP) cannot be enabled at the same time.
+ *
+ * @param comp     The ROHC compressor
+ * @param profile  The profile to enable
+ * @return         true if the profile exists,
+ *                 false if the profile does not exist or if its counterpart
+ *                 of the other ROHC version is already enabled
+ *
+ * @ingroup rohc_comp
+ *
+ * \par Example:
+ * \snippet simple_rohc_program.c define ROHC compressor
+ * \code
+        ...
+\endcode
+ * \snippet simple_rohc_program.c enable ROHC compression profile
+ * \code
+        ...
+\endcode
+ *
+ * @see rohc_comp_enable_profiles
+ * @see rohc_comp_disable_profile
+ * @see rohc_comp_disable_profiles
+ */
+bool rohc_comp_enable_profile(struct rohc_comp *const comp,
+                              const rohc_profile_t profile)
+{
+	size_t other_i;
+	size_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* get the profile location */
+	i = rohc_comp_get_profile_idx(profile);
+	if(i == ROHC_COMP_PROFILE_IDX_NONE)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unknown ROHC compression profile (ID = %d)", profile);
+		goto error;
+	}
+
+	/* the IR packets carry only the 8 LSB of the profile ID, so a ROHCv1
+	 * profile and its ROHCv2 counterpart cannot be enabled together */
+	other_i = rohc_comp_get_profile_idx(rohc_profile_get_other_version(profile));
+	if(other_i != ROHC_COMP_PROFILE_IDX_NONE && comp->enabled_profiles[other_i])
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "cannot enable ROHC compression profile (ID = 0x%04x) "
+		             "while profile 0x%04x is enabled", profile,
+		             rohc_profile_get_other_version(profile));
+		goto error;
+	}
+
+	/* mark the profile as enabled */
+	comp->enabled_profiles[i] = true;
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "ROHC compression profile (ID = %d) enabled", profile);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Disable a compression profile for a compressor
+ *
+ * Disable a compression profile for a compressor.
+ *
+ * The ROHC compressor does not use the compression profiles that were
+ * disabled. Thus disabling a profile might affect compression performances.
+ * Compression will fail if no profile at all is enabled.
+ *
+ * If the profile is already disabled, nothing is performed and success is
+ * reported.
+ *
+ * @param comp     The ROHC compressor
+ * @param profile  The profile to disable
+ * @return         true if the profile exists,
+ *                 false if the profile does not exist
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_enable_profile
+ * @see rohc_comp_enable_profiles
+ * @see rohc_comp_disable_profiles
+ */
+bool rohc_comp_disable_profile(struct rohc_comp *const comp,
+                               const rohc_profile_t profile)
+{
+	size_t i;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* get the profile location */
+	i = rohc_comp_get_profile_idx(profile);
+	if(i == ROHC_COMP_PROFILE_IDX_NONE)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unknown ROHC compression profile (ID = %d)", profile);
+		goto error;
+	}
+
+	/* mark the profile as disabled */
+	comp->enabled_profiles[i] = false;
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "ROHC compression profile (ID = %d) disabled", profile);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Enable several compression profiles for a compressor
+ *
+ * Enable several compression profiles for a compressor. The list of profiles
+ * to enable shall stop with -1.
+ *
+ * The ROHC compressor does not use the compression profiles that are not
+ * enabled. Thus not enabling a profile might affect compression performances.
+ * Compression will fail if no profile at all is enabled.
+ *
+ * If one or more of the profiles are already enabled, nothing is performed
+ * and success is reported.
+ *
+ * @param comp  The ROHC compressor
+ * @param ...   The sequence of compression profiles to enable, the sequence
+ *              shall be terminated by -1
+ * @return      true if all of the profiles exist,
+ *              false if at least one of the profiles does not exist
+ *
+ * @ingroup rohc_comp
+ *
+ * \par Example:
+ * \snippet simple_rohc_program.c define ROHC compressor
+ * \code
+        ...
+\endcode
+ * \snippet simple_rohc_program.c enable ROHC compression profiles
+ * \code
+        ...
+\endcode
+ *
+ * @see rohc_comp_enable_profile
+ * @see rohc_comp_disable_profile
+ * @see rohc_comp_disable_profiles
+ */
+bool rohc_comp_enable_profiles(struct rohc_comp *const comp,
+                               ...)
+{
+	va_list profiles;
+	int profile_id;
+	size_t err_nr = 0;
+	bool is_ok;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	va_start(profiles, comp);
+
+	while((profile_id = va_arg(profiles, int)) >= 0)
+	{
+		is_ok = rohc_comp_enable_profile(comp, profile_id);
+		if(!is_ok)
+		{
+			err_nr++;
+		}
+	}
+
+	va_end(profiles);
+
+	return (err_nr == 0);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Disable several compression profiles for a compressor
+ *
+ * Disable several compression profiles for a compressor. The list of profiles
+ * to disable shall stop with -1.
+ *
+ * The ROHC compressor does not use the compression profiles that were
+ * disabled. Thus disabling a profile might affect compression performances.
+ * Compression will fail if no profile at all is enabled.
+ *
+ * If one or more of the profiles are already disabled, nothing is performed
+ * and success is reported.
+ *
+ * @param comp  The ROHC compressor
+ * @param ...   The sequence of compression profiles to disable, the sequence
+ *              shall be terminated by -1
+ * @return      true if all of the profiles exist,
+ *              false if at least one of the profiles does not exist
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_enable_profile
+ * @see rohc_comp_enable_profiles
+ * @see rohc_comp_disable_profile
+ */
+bool rohc_comp_disable_profiles(struct rohc_comp *const comp,
+                                ...)
+{
+	va_list profiles;
+	int profile_id;
+	size_t err_nr = 0;
+	bool is_ok;
+
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	va_start(profiles, comp);
+
+	while((profile_id = va_arg(profiles, int)) >= 0)
+	{
+		is_ok = rohc_comp_disable_profile(comp, profile_id);
+		if(!is_ok)
+		{
+			err_nr++;
+		}
+	}
+
+	va_end(profiles);
+
+	return (err_nr == 0);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the Maximum Reconstructed Reception Unit (MRRU).
+ *
+ * Set the Maximum Reconstructed Reception Unit (MRRU).
+ *
+ * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
+ * that are parts of the same ROHC packet. In short, the ROHC decompressor
+ * does not expect to reassemble ROHC segments whose total length is larger
+ * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
+ * than the MRRU.
+ *
+ * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
+ * MRRU includes the 32-bit CRC that protects it.
+ * If set to 0, segmentation is disabled as no segment headers are allowed
+ * on the channel. No segment will be generated.
+ *
+ * If segmentation is enabled and used by the compressor, the function
+ * \ref rohc_comp_get_segment2 can be used to retrieve ROHC segments.
+ *
+ * @param comp  The ROHC compressor
+ * @param mrru  The new MRRU value (in bytes)
+ * @return      true if the MRRU was successfully set, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * \par Example:
+ * \snippet test_segment.c define ROHC compressor
+ * \code
+        size_t mrru = 500;
+        ...
+\endcode
+ * \snippet test_segment.c set compressor MRRU
+ * \code
+        ...
+\endcode
+ *
+ * @see rohc_comp_get_mrru
+ * @see rohc_comp_get_segment2
+ * @see rohc_decomp_set_mrru
+ */
+bool rohc_comp_set_mrru(struct rohc_comp *const comp,
+                        const size_t mrru)
+{
+	/* compressor must be valid */
+	if(comp == NULL)
+	{
+		/* cannot print a trace without a valid compressor */
+		goto error;
+	}
+
+	/* new MRRU value must be in range [0, ROHC_MAX_MRRU] */
+	if(mrru > ROHC_MAX_MRRU)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "unexpected MRRU value: must be in range [0, %d]",
+		             ROHC_MAX_MRRU);
+		goto error;
+	}
+
+	/* resize the buffer for the Reconstructed Reception Unit (RRU): it is
+	 * allocated only if segmentation is enabled */
+	if(mrru != comp->mrru)
+	{
+		uint8_t *rru = NULL;
+
+		if(mrru > 0)
+		{
+			rru = rohc_mem_alloc(&comp->mem_ops, mrru);
+			if(rru == NULL)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "failed to allocate %zu bytes for the RRU", mrru);
+				goto error;
+			}
+		}
+		if(comp->rru_len > mrru)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "erase the %zu bytes of RRU that were not retrieved "
+			             "yet: they exceed the new MRRU", comp->rru_len);
+			comp->rru_len = 0;
+		}
+		else if(comp->rru_len > 0)
+		{
+			/* the payload of the RRU, if not copied yet, is copied now */
+			rohc_comp_rru_read(comp, comp->rru_off, comp->rru_len, rru);
+		}
+		comp->rru_off = 0;
+		comp->rru_payload = NULL;
+		comp->rru_payload_off = 0;
+		comp->rru_payload_len = 0;
+		rohc_mem_free(&comp->mem_ops, comp->rru);
+		comp->rru = rru;
+	}
+
+	/* set new MRRU */
+	comp->mrru = mrru;
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "MRRU is now set to %zd", comp->mrru);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the Maximum Reconstructed Reception Unit (MRRU).
+ *
+ * Get the current Maximum Reconstructed Reception Unit (MRRU).
+ *
+ * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
+ * that are parts of the same ROHC packet. In short, the ROHC decompressor
+ * does not expect to reassemble ROHC segments whose total length is larger
+ * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
+ * than the MRRU.
+ *
+ * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
+ * MRRU includes the 32-bit CRC that protects it.
+ * If MRRU value is 0, segmentation is disabled.
+ *
+ * If segmentation is enabled and used by the compressor, the function
+ * \ref rohc_comp_get_segment2 can be used to retrieve ROHC segments.
+ *
+ * @param comp       The ROHC compressor
+ * @param[out] mrru  The current MRRU value (in bytes)
+ * @return           true if MRRU was successfully retrieved, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * \par Example:
+ * \snippet test_segment.c define ROHC compressor
+ * \code
+        size_t mrru;
+        ...
+\endcode
+ * \snippet test_non_regression.c get compressor MRRU
+ * \code
+        printf("the current MMRU at compressor is %zu bytes\n", mrru);
+        ...
+\endcode
+ *
+ * @see rohc_comp_set_mrru
+ * @see rohc_comp_get_segment2
+ * @see rohc_decomp_set_mrru
+ * @see rohc_decomp_get_mrru
+ */
+bool rohc_comp_get_mrru(const struct rohc_comp *const comp,
+                        size_t *const mrru)
+{
+	if(comp == NULL || mrru == NULL)
+	{
+		goto error;
+	}
+
+	*mrru = comp->mrru;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the maximal CID value the compressor uses
+ *
+ * Get the maximal CID value the compressor uses, ie. the \e MAX_CID parameter
+ * defined in RFC 3095.
+ *
+ * @param comp          The ROHC compressor
+ * @param[out] max_cid  The current maximal CID value
+ * @return              true if MAX_CID was successfully retrieved,
+ *                      false otherwise
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_get_max_cid(const struct rohc_comp *const comp,
+                           size_t *const max_cid)
+{
+	if(comp == NULL || max_cid == NULL)
+	{
+		goto error;
+	}
+
+	*max_cid = comp->medium.max_cid;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the CID type that the compressor uses
+ *
+ * Get the CID type that the compressor currently uses.
+ *
+ * @param comp           The ROHC compressor
+ * @param[out] cid_type  The current CID type among \ref ROHC_SMALL_CID and
+ *                       \ref ROHC_LARGE_CID
+ * @return               true if the CID type was successfully retrieved,
+ *                       false otherwise
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_get_cid_type(const struct rohc_comp *const comp,
+                            rohc_cid_type_t *const cid_type)
+{
+	if(comp == NULL || cid_type == NULL)
+	{
+		goto error;
+	}
+
+	*cid_type = c_cid_type(comp);
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Enable/disable features for ROHC compressor
+ *
+ * Enable/disable features for ROHC compressor. Features control whether
+ * mechanisms defined as optional by RFCs are enabled or not.
+ *
+ * Available features are listed by \ref rohc_comp_features_t. They may be
+ * combined by XOR'ing them together.
+ *
+ * @warning Changing the feature set while library is used is not supported
+ *
+ * @param comp      The ROHC compressor
+ * @param features  The feature set to enable/disable
+ * @return          true if the feature set was successfully enabled/disabled,
+ *                  false if a problem occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_features_t
+ */
+bool rohc_comp_set_features(struct rohc_comp *const comp,
+                            const rohc_comp_features_t features)
+{
+	const rohc_comp_features_t all_features = ROHC_COMP_FEATURES_ALL;
+
+	/* compressor must be valid */
+	if(comp == NULL)
+	{
+		/* cannot print a trace without a valid compressor */
+		goto error;
+	}
+
+	/* reject unsupported features */
+	if((features & all_features) != features)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "feature set 0x%x is not supported (supported features "
+		             "set is 0x%x)", features, all_features);
+		goto error;
+	}
+#ifdef ROHC_FIXED_COMP_FEATURES
+	if(features != ROHC_FIXED_COMP_FEATURES)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "feature set 0x%x is not supported (library built for "
+		             "feature set 0x%x only)", features,
+		             ROHC_FIXED_COMP_FEATURES);
+		goto error;
+	}
+#endif
+
+	/* record new feature set */
+	comp->features = features;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the compression effort level of the ROHC compressor
+ *
+ * The effort level trades CPU per packet for the size of the ROHC headers,
+ * like the levels of general-purpose compressors:
+ *  \li \ref ROHC_COMP_EFFORT_FAST skips the searches for the smallest
+ *       packet types in the FO and SO states,
+ *  \li \ref ROHC_COMP_EFFORT_DEFAULT sends the first packet type that fits
+ *       the RFC rules,
+ *  \li \ref ROHC_COMP_EFFORT_BEST encodes every packet type that fits and
+ *       sends the smallest one.
+ *
+ * All the levels build packets that any decompressor handles. The effort
+ * level is \ref ROHC_COMP_EFFORT_DEFAULT by default. It may be changed at
+ * any time, the next packets are compressed with the new level.
+ *
+ * @param comp    The ROHC compressor
+ * @param effort  The compression effort level
+ * @return        true if the effort level was successfully set,
+ *                false if the effort level is not supported
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_effort_t
+ */
+bool rohc_comp_set_effort(struct rohc_comp *const comp,
+                          const rohc_comp_effort_t effort)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(effort != ROHC_COMP_EFFORT_FAST &&
+	   effort != ROHC_COMP_EFFORT_DEFAULT &&
+	   effort != ROHC_COMP_EFFORT_BEST)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "effort level %d is not supported", effort);
+		goto error;
+	}
+
+	comp->effort = effort;
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	          "compression effort level set to %d", effort);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the functions the ROHC compressor allocates context memory with
+ *
+ * The compression contexts and their profile-specific parts are allocated
+ * from a slab owned by the compressor: the memory of recycled contexts is
+ * kept for the next contexts instead of being freed. The slab allocates
+ * memory by chunks of several contexts with the memory operations given to
+ * \ref rohc_comp_new3, or with malloc() by default. This function sets other
+ * functions to allocate and free the chunks, eg. to use a cache of objects.
+ *
+ * The contexts of a compressor may thus be placed on the memory of one
+ * NUMA node, or on huge pages to reduce the TLB misses when many contexts
+ * are in use: the functions may carve the chunks from huge pages bound to
+ * the NUMA node of the thread that drives the compressor. Create the
+ * compressor from that thread too, so that its own structure is allocated
+ * on the same node.
+ *
+ * Give NULL for both functions to come back to the memory operations given
+ * to \ref rohc_comp_new3, or to malloc() and free() if none was given.
+ *
+ * @warning The functions may only be changed before the first packet is
+ *          compressed
+ *
+ * @param comp      The ROHC compressor
+ * @param alloc_cb  The function to allocate memory with
+ * @param free_cb   The function to free memory with
+ * @param priv      Private data that will be given to the callbacks, may be
+ *                  NULL
+ * @return          true if the functions were successfully set,
+ *                  false if a problem occurred
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_alloc_cb_t
+ * @see rohc_comp_free_cb_t
+ */
+bool rohc_comp_set_alloc_cbs(struct rohc_comp *const comp,
+                             rohc_comp_alloc_cb_t alloc_cb,
+                             rohc_comp_free_cb_t free_cb,
+                             void *priv)
+{
+	/* compressor must be valid */
+	if(comp == NULL)
+	{
+		/* cannot print a trace without a valid compressor */
+		goto error;
+	}
+
+	/* come back to the memory operations of the compressor if no function
+	 * is given */
+	if(alloc_cb == NULL && free_cb == NULL)
+	{
+		alloc_cb = comp->mem_ops.alloc;
+		free_cb = comp->mem_ops.free;
+		priv = comp->mem_ops.priv;
+	}
+
+	/* the functions cannot be changed once memory was allocated with them */
+	if(comp->num_contexts_used > 0 || comp->engine != NULL ||
+	   comp->mem_ops.alloc == rohc_mem_block_alloc ||
+	   !rohc_slab_set_cbs(comp->ctxt_slab, alloc_cb, free_cb, priv))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to set the functions for memory allocation: "
+		             "both functions shall be given, contexts shall not be "
+		             "created yet, and the compressor shall not be one "
+		             "channel of an engine nor be carved from a memory "
+		             "block");
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Locate the context of one feedback item
+ *
+ * The feedback item is bound to its compression context, but it is not
+ * applied yet, see \ref rohc_comp_feedback_apply.
+ *
+ * @param comp        The ROHC compressor
+ * @param packet      The feedback data
+ * @param size        The length of the feedback packet
+ * @param[out] item   The located feedback item
+ * @return            true if the context of the feedback was found,
+ *                    false if the feedback could not be taken into account
+ */
+static bool rohc_comp_feedback_locate(struct rohc_comp *const comp,
+                                      const uint8_t *const packet,
+                                      const size_t size,
+                                      struct rohc_comp_feedback_item *const item)
+{
+	struct rohc_comp_ctxt *context;
+	const uint8_t *remain_data = packet;
+	size_t remain_len = size;
+	rohc_cid_t cid;
+	size_t cid_len;
+
+	/* the traces are dropped until the context of the feedback is known */
+	rohc_trace_filter_mute(comp);
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "deliver %zu byte(s) of feedback to the right context", size);
+	rohc_seqlock_write_begin(&comp->stats_seq);
+	comp->feedbacks_nr++;
+	rohc_seqlock_write_end(&comp->stats_seq);
+
+	/* extract the CID from feedback */
+	if(!rohc_comp_feedback_parse_cid(comp, remain_data, remain_len, &cid, &cid_len))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to deliver feedback: failed to extract CID from "
+		             "feedback");
+		goto error;
+	}
+	remain_data += cid_len;
+	remain_len -= cid_len;
+
+	/* find context */
+	context = c_get_context(comp, cid);
+	if(context == NULL)
+	{
+		/* context was not found */
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to deliver feedback: context with CID = %zu not found",
+		             cid);
+		goto error;
+	}
+	assert(context->cid == cid);
+	assert(context->used == 1);
+	c_trace_filter_select(comp, context);
+
+	if(remain_len == 0)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to deliver feedback: empty feedback data");
+		goto error;
+	}
+
+	item->data = packet;
+	item->context = context;
+	item->len = size;
+	item->cid_len = cid_len;
+	item->is_superseded = false;
+	item->ack_kind = rohc_comp_feedback_ack_kind(context, remain_data, remain_len);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the kind of ACK of one feedback item
+ *
+ * One ACK makes the previous ACKs of the same kind useless, since the
+ * acknowledgement of one packet is also the acknowledgement of the previous
+ * packets: it removes at least the same values from the W-LSB windows. The
+ * ACKs of different kinds do not supersede each other, eg. one FEEDBACK-2
+ * ACK of a RFC 3095 profile that requests one mode is not superseded by one
+ * that requests another mode.
+ *
+ * @param context            The compression context the feedback is for
+ * @param feedback_data      The feedback data without the CID bits
+ * @param feedback_data_len  The length of the feedback data without the CID bits
+ * @return                   The kind of ACK, one bit per kind,
+ *                           0 if the feedback is not an ACK
+ */
+static uint32_t rohc_comp_feedback_ack_kind(const struct rohc_comp_ctxt *const context,
+                                            const uint8_t *const feedback_data,
+                                            const size_t feedback_data_len)
+{
+	const rohc_profile_t profile_id = context->profile->id;
+	uint32_t ack_kind;
+
+	if(feedback_data_len == 1)
+	{
+		/* FEEDBACK-1 is always one ACK */
+		ack_kind = (1U << 4);
+	}
+	else if(profile_id == ROHC_PROFILE_UNCOMPRESSED ||
+	        ((feedback_data[0] >> 6) & 0x03) != ROHC_FEEDBACK_ACK)
+	{
+		/* NACK, STATIC-NACK, or FEEDBACK-2 for one profile that does not
+		 * handle it */
+		ack_kind = 0;
+	}
+	else if(rohc_profile_is_rfc3095(profile_id))
+	{
+		/* FEEDBACK-2 ACK of RFC 3095, the kind depends on the requested mode */
+		ack_kind = (1U << ((feedback_data[0] >> 4) & 0x03));
+	}
+	else
+	{
+		/* FEEDBACK-2 ACK of RFC 5225 and RFC 6846 */
+		ack_kind = (1U << 5);
+	}
+
+	return ack_kind;
+}
+
+
+/**
+ * @brief Apply the located feedback items context by context
+ *
+ * The feedback items are grouped by context, so that every context is
+ * loaded in cache once for all its feedback items. The feedback items of
+ * one context keep their order.
+ *
+ * Among the consecutive ACKs of one context, only the newest ACK of every
+ * kind is applied: the previous ones would remove from the W-LSB windows
+ * values that the newest one removes anyway. One NACK or STATIC-NACK
+ * between two ACKs prevents the ACK before it from being superseded.
+ *
+ * @param comp           The ROHC compressor
+ * @param items          The located feedback items
+ * @param items_nr       The number of feedback items,
+ *                       at most \ref ROHC_COMP_FEEDBACK_BATCH
+ * @return               The number of feedback items that could not be
+ *                       taken into account
+ */
+static size_t rohc_comp_feedback_apply(struct rohc_comp *const comp,
+                                       struct rohc_comp_feedback_item items[],
+                                       const size_t items_nr)
+{
+	uint32_t cids[ROHC_COMP_FEEDBACK_BATCH];
+	bool has_cid[ROHC_COMP_FEEDBACK_BATCH];
+	size_t order[ROHC_COMP_FEEDBACK_BATCH];
+	const struct rohc_comp_ctxt *later_context = NULL;
+	uint32_t later_acks = 0;
+	size_t nr_failures = 0;
+	size_t i;
+
+	assert(items_nr <= ROHC_COMP_FEEDBACK_BATCH);
+
+	/* group the feedback items by context, the unused lanes are never read */
+	for(i = 0; i < ROHC_COMP_FEEDBACK_BATCH; i++)
+	{
+		has_cid[i] = (i < items_nr);
+		cids[i] = (has_cid[i] ? items[i].context->cid : 0);
+	}
+	rohc_burst_group(cids, has_cid, items_nr, order);
+
+	/* walk every group from its newest feedback item to find the ACKs that
+	 * later ACKs of the same kind supersede */
+	for(i = items_nr; i > 0; i--)
+	{
+		struct rohc_comp_feedback_item *const item = &items[order[i - 1]];
+
+		if(item->context != later_context)
+		{
+			later_context = item->context;
+			later_acks = 0;
+		}
+		if(item->ack_kind == 0)
+		{
+			later_acks = 0;
+		}
+		else if((later_acks & item->ack_kind) != 0)
+		{
+			item->is_superseded = true;
+		}
+		else
+		{
+			later_acks |= item->ack_kind;
+		}
+	}
+
+	/* deliver the remaining feedback items to the profiles of their contexts */
+	for(i = 0; i < items_nr; i++)
+	{
+		const struct rohc_comp_feedback_item *const item = &items[order[i]];
+		struct rohc_comp_ctxt *const context = item->context;
+		const uint8_t *const remain_data = item->data + item->cid_len;
+		const size_t remain_len = item->len - item->cid_len;
+		const enum rohc_feedback_type feedback_type =
+			(remain_len == 1 ? ROHC_FEEDBACK_1 : ROHC_FEEDBACK_2);
+
+		c_trace_filter_select(comp, context);
+
+		if(item->is_superseded)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "FEEDBACK-%d ACK for CID %zu superseded by a later ACK, "
+			           "skip it", feedback_type, context->cid);
+			continue;
+		}
+
+		/* deliver feedback to profile with the context */
+		context->refresh_feedback = true;
+		if(!context->profile->feedback(context, feedback_type, item->data,
+		                               item->len, remain_data, remain_len))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to deliver feedback for CID %zu: failed to handle "
+			             "FEEDBACK-%d", context->cid, feedback_type);
+			nr_failures++;
+			continue;
+		}
+
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "FEEDBACK-%d data successfully handled", feedback_type);
+	}
+
+	return nr_failures;
+}
+
+
+/**
+ * @brief Deliver a feedback packet to the compressor
+ *
+ * When feedback data is received by a decompressor, this function may be
+ * called to deliver the feedback data to the corresponding profile/context
+ * on the same-side associated compressor.
+ *
+ * @param comp      The ROHC compressor
+ * @param feedback  The feedback data
+ * @return          true if the feedback was successfully taken into account,
+ *                  false if the feedback could not be taken into account
+ *
+ * @ingroup rohc_comp
+ */
+bool rohc_comp_deliver_feedback2(struct rohc_comp *const comp,
+                                 const struct rohc_buf feedback)
+{
+	struct rohc_comp_feedback_item items[ROHC_COMP_FEEDBACK_BATCH];
+	struct rohc_buf remain_data = feedback;
+	size_t items_nr = 0;
+	size_t feedbacks_nr = 0;
+	size_t nr_failures = 0;
+
+	/* sanity checks */
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(rohc_buf_is_malformed(remain_data))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to deliver feedback: feedback is malformed");
+		goto error;
+	}
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "deliver %zu byte(s) of feedback to the right context",
+	           remain_data.len);
+
+	/* there is nothing for compressor if feedback contains no byte at all */
+	if(rohc_buf_is_empty(remain_data))
+	{
+		goto ignore;
+	}
+
+	/* parse as much feedback data as possible, locate the context of every
+	 * feedback item, then apply the feedback items context by context */
+	while(remain_data.len > 0 &&
+	      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+	{
+		size_t feedback_hdr_len;
+		size_t feedback_data_len;
+		size_t feedback_len;
+
+		feedbacks_nr++;
+
+		if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
+		                           &feedback_data_len))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to parse a feedback item");
+			goto malformed;
+		}
+		feedback_len = feedback_hdr_len + feedback_data_len;
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "feedback found (header = %zu bytes, data = %zu bytes)",
+		           feedback_hdr_len, feedback_data_len);
+
+		/* reject feedback item if it doesn't fit in the available data */
+		if(feedback_len > remain_data.len)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "the %zu-byte feedback is too large for the %zu-byte "
+			             "remaining ROHC data", feedback_len, remain_data.len);
+			goto malformed;
+		}
+
+		/* skip the feedback header */
+		rohc_buf_pull(&remain_data, feedback_hdr_len);
+
+		/* locate the context of the feedback data */
+		if(!rohc_comp_feedback_locate(comp, rohc_buf_data(remain_data),
+		                              feedback_data_len, &items[items_nr]))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to deliver feedback item #%zu", feedbacks_nr);
+			nr_failures++;
+		}
+		else
+		{
+			items_nr++;
+			if(items_nr == ROHC_COMP_FEEDBACK_BATCH)
+			{
+				nr_failures += rohc_comp_feedback_apply(comp, items, items_nr);
+				items_nr = 0;
+			}
+		}
+
+		/* skip the feedback data */
+		rohc_buf_pull(&remain_data, feedback_data_len);
+	}
+	nr_failures += rohc_comp_feedback_apply(comp, items, items_nr);
+
+	return (nr_failures == 0);
+
+ignore:
+	return true;
+
+malformed:
+	/* the feedback items before the malformed one are applied anyway */
+	nr_failures += rohc_comp_feedback_apply(comp, items, items_nr);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Deliver several feedback packets to the compressor
+ *
+ * Deliver all the given feedback packets to the compressor in one call, as
+ * \ref rohc_comp_deliver_feedback2 does for every one of them. A feedback
+ * packet that cannot be taken into account does not prevent the next ones
+ * from being delivered.
+ *
+ * On a trusted and lossless feedback channel, enable the
+ * \ref ROHC_COMP_FEATURE_TRUSTED_FEEDBACK feature to skip the checks of the
+ * feedback options and CRCs.
+ *
+ * @param comp          The ROHC compressor
+ * @param feedbacks     The feedback packets
+ * @param feedbacks_nr  The number of feedback packets
+ * @return              true if all the feedback packets were successfully
+ *                      taken into account,
+ *                      false if one of them could not be taken into account
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_deliver_feedback2
+ */
+bool rohc_comp_deliver_feedbacks(struct rohc_comp *const comp,
+                                 const struct rohc_buf *const feedbacks,
+                                 const size_t feedbacks_nr)
+{
+	size_t nr_failures = 0;
+	size_t i;
+
+	if(comp == NULL || (feedbacks == NULL && feedbacks_nr > 0))
+	{
+		goto error;
+	}
+
+	for(i = 0; i < feedbacks_nr; i++)
+	{
+		if(!rohc_comp_deliver_feedback2(comp, feedbacks[i]))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to deliver feedback packet #%zu of %zu", i + 1,
+			             feedbacks_nr);
+			nr_failures++;
+		}
+	}
+
+	return (nr_failures == 0);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Enqueue a feedback packet for the compressor
+ *
+ * Enqueue the given feedback data in the feedback queue of the compressor.
+ * The feedback data is delivered to the compressor, as
+ * \ref rohc_comp_deliver_feedback2 does, at the beginning of the next call to
+ * \ref rohc_compress4, \ref rohc_compress_burst or \ref rohc_compress_hdr.
+ *
+ * The function is meant to be called by another thread than the thread of
+ * the compressor, eg. the thread of the same-side associated decompressor
+ * that received the feedback data. No lock is required as long as only one
+ * thread enqueues feedback data for the compressor.
+ *
+ * The queue holds up to 16 feedback packets of up to 128 bytes each.
+ *
+ * @param comp      The ROHC compressor
+ * @param feedback  The feedback data
+ * @return          true if the feedback was enqueued,
+ *                  false if the queue is full or the feedback is too large
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_deliver_feedback2
+ */
+bool rohc_comp_enqueue_feedback(struct rohc_comp *const comp,
+                                const struct rohc_buf feedback)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	return rohc_comp_feedback_queue_push(&comp->feedback_queue, feedback);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Register feedback to piggyback ahead of the next ROHC packets
+ *
+ * Register the given feedback data, eg. the feedback generated by the
+ * same-side associated decompressor, to be sent to the remote decompressor.
+ * The feedback is written directly ahead of the ROHC header of the next
+ * ROHC packets built by \ref rohc_compress4, \ref rohc_compress_burst,
+ * \ref rohc_compress_hdr or \ref rohc_compress_hdr_burst, so that the
+ * application does not need to prepend it to the output buffer itself.
+ *
+ * The feedback items are piggybacked in order, as many as the per-packet
+ * budget set with \ref rohc_comp_set_piggyback_max_len allows. The feedback
+ * is not part of the ROHC packet protected by the MRRU: if the packet is
+ * segmented, or if its compression fails, the feedback remains registered
+ * for the next packet.
+ *
+ * The function may be called by another thread than the thread of the
+ * compressor, as \ref rohc_comp_enqueue_feedback. The queue holds up to 16
+ * feedback packets of up to 128 bytes each.
+ *
+ * @param comp      The ROHC compressor
+ * @param feedback  The feedback data to send, feedback header included
+ * @return          true if the feedback was registered,
+ *                  false if the queue is full or the feedback is empty or
+ *                  too large
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_piggyback_max_len
+ */
+bool rohc_comp_piggyback_feedback(struct rohc_comp *const comp,
+                                  const struct rohc_buf feedback)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+	if(rohc_buf_is_empty(feedback))
+	{
+		goto error;
+	}
+
+	return rohc_comp_feedback_queue_push(&comp->piggyback_queue, feedback);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the maximal number of bytes of feedback piggybacked per packet
+ *
+ * Set the maximal number of bytes of the feedback registered with
+ * \ref rohc_comp_piggyback_feedback that are written ahead of one ROHC
+ * packet. The feedback items are never split: the items that do not fit in
+ * the budget are kept for the next packets. Set 0 to stop piggybacking
+ * feedback.
+ *
+ * The default budget is 2048 bytes, ie. the whole queue of feedback.
+ *
+ * @param comp     The ROHC compressor
+ * @param max_len  The maximal number of bytes of feedback per ROHC packet
+ * @return         true if the budget was set, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_piggyback_feedback
+ */
+bool rohc_comp_set_piggyback_max_len(struct rohc_comp *const comp,
+                                     const size_t max_len)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	comp->piggyback_max_len = max_len;
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "up to %zu bytes of feedback are now piggybacked per packet",
+	           comp->piggyback_max_len);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Push one feedback packet in the given feedback queue
+ *
+ * @param queue     The feedback queue
+ * @param feedback  The feedback data
+ * @return          true if the feedback was enqueued,
+ *                  false if the queue is full or the feedback is too large
+ */
+static bool rohc_comp_feedback_queue_push(struct rohc_comp_feedback_queue *const queue,
+                                          const struct rohc_buf feedback)
+{
+	uint32_t head;
+	uint32_t tail;
+
+	if(rohc_buf_is_malformed(feedback) ||
+	   feedback.len > ROHC_COMP_FEEDBACK_QUEUE_ITEM_MAX_LEN)
+	{
+		goto error;
+	}
+
+	/* the head is written by the producer only, the tail is written by the
+	 * compressor when it consumes the enqueued feedback */
+	head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+	tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+	if((head - tail) >= ROHC_COMP_FEEDBACK_QUEUE_LEN)
+	{
+		goto error;
+	}
+
+	/* copy the feedback, then publish it to the compressor */
+	queue->items[head % ROHC_COMP_FEEDBACK_QUEUE_LEN].len = feedback.len;
+	memcpy(queue->items[head % ROHC_COMP_FEEDBACK_QUEUE_LEN].data,
+	       rohc_buf_data(feedback), feedback.len);
+	__atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Deliver the feedback enqueued by another thread to the compressor
+ *
+ * @param comp  The ROHC compressor
+ *
+ * @see rohc_comp_enqueue_feedback
+ */
+static void rohc_comp_drain_feedback(struct rohc_comp *const comp)
+{
+	struct rohc_comp_feedback_queue *const queue = &comp->feedback_queue;
+	const uint32_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+	uint32_t tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+
+	while(tail != head)
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		const struct rohc_buf feedback =
+			rohc_buf_init_full(queue->items[tail % ROHC_COMP_FEEDBACK_QUEUE_LEN].data,
+			                   queue->items[tail % ROHC_COMP_FEEDBACK_QUEUE_LEN].len,
+			                   ts);
+
+		/* failures are traced, they shall not prevent the packets from being
+		 * compressed */
+		if(!rohc_comp_deliver_feedback2(comp, feedback))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to deliver the enqueued feedback");
+		}
+
+		/* give the slot back to the producer */
+		tail++;
+		__atomic_store_n(&queue->tail, tail, __ATOMIC_RELEASE);
+	}
+}
+
+
+/**
+ * @brief Check a runtime configuration before it is published
+ *
+ * @param comp  The ROHC compressor
+ * @param cfg   The runtime configuration to check
+ * @return      true if the configuration is valid, false otherwise
+ *
+ * @see rohc_comp_publish_cfg
+ */
+static bool rohc_comp_check_cfg(const struct rohc_comp *const comp,
+                                const struct rohc_comp_cfg *const cfg)
+{
+	/* same rules as rohc_comp_set_features(), rohc_comp_set_effort(),
+	 * rohc_comp_set_periodic_refreshes(),
+	 * rohc_comp_set_periodic_refreshes_time() and rohc_comp_set_ir_pacing() */
+	if((cfg->features & ROHC_COMP_FEATURES_ALL) != cfg->features
+#ifdef ROHC_FIXED_COMP_FEATURES
+	   || cfg->features != ROHC_FIXED_COMP_FEATURES
+#endif
+	  )
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "feature set 0x%x is not supported", cfg->features);
+		goto error;
+	}
+	if(cfg->effort != ROHC_COMP_EFFORT_FAST &&
+	   cfg->effort != ROHC_COMP_EFFORT_DEFAULT &&
+	   cfg->effort != ROHC_COMP_EFFORT_BEST)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "effort level %d is not supported", cfg->effort);
+		goto error;
+	}
+	if(cfg->refresh_ir_timeout == 0 || cfg->refresh_fo_timeout == 0 ||
+	   cfg->refresh_ir_timeout <= cfg->refresh_fo_timeout)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "invalid "
+		             "timeouts for context periodic refreshes (IR timeout = %zu, "
+		             "FO timeout = %zu)", cfg->refresh_ir_timeout,
+		             cfg->refresh_fo_timeout);
+		goto error;
+	}
+	if((cfg->refresh_ir_time != 0 || cfg->refresh_fo_time != 0) &&
+	   (cfg->refresh_fo_time == 0 ||
+	    cfg->refresh_ir_time <= cfg->refresh_fo_time ||
+	    cfg->refresh_ir_time > (UINT32_MAX >> ROHC_COMP_REFRESH_SCALE_MAX)))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "invalid "
+		             "times for context periodic refreshes (IR timeout = %zu ms, "
+		             "FO timeout = %zu ms)", cfg->refresh_ir_time,
+		             cfg->refresh_fo_time);
+		goto error;
+	}
+	if((cfg->ir_pacing_budget == 0) != (cfg->ir_pacing_interval == 0) ||
+	   cfg->ir_pacing_interval > (UINT32_MAX >> 1))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "invalid "
+		             "IR pacing (%zu bytes every %zu ms)", cfg->ir_pacing_budget,
+		             cfg->ir_pacing_interval);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Take the runtime configuration published by another thread
+ *
+ * The pending snapshot, if any, is taken atomically, applied and released.
+ * The configuration is applied between rohc_seqlock_write_begin() and
+ * rohc_seqlock_write_end() on \e stats_seq, so that \ref rohc_comp_get_cfg
+ * never returns a mix of two configurations.
+ *
+ * @param comp  The ROHC compressor
+ *
+ * @see rohc_comp_publish_cfg
+ */
+static void rohc_comp_take_cfg(struct rohc_comp *const comp)
+{
+	struct rohc_comp_cfg *cfg;
+
+	/* the configuration rarely changes, avoid the atomic exchange */
+	if(__builtin_expect(__atomic_load_n(&comp->cfg_pending, __ATOMIC_RELAXED) == NULL, 1))
+	{
+		return;
+	}
+	cfg = __atomic_exchange_n(&comp->cfg_pending, NULL, __ATOMIC_ACQUIRE);
+	assert(cfg != NULL);
+
+	rohc_seqlock_write_begin(&comp->stats_seq);
+	comp->features = cfg->features;
+	comp->periodic_refreshes_ir_timeout = cfg->refresh_ir_timeout;
+	comp->periodic_refreshes_fo_timeout = cfg->refresh_fo_timeout;
+	comp->periodic_refreshes_ir_time = cfg->refresh_ir_time;
+	comp->periodic_refreshes_fo_time = cfg->refresh_fo_time;
+	if(cfg->ir_pacing_budget != comp->ir_pacing_budget ||
+	   cfg->ir_pacing_interval != comp->ir_pacing_interval)
+	{
+		comp->ir_pacing_budget = cfg->ir_pacing_budget;
+		comp->ir_pacing_interval = cfg->ir_pacing_interval;
+		comp->ir_pacing_left = cfg->ir_pacing_budget;
+	}
+	comp->ctxt_idle_timeout = cfg->ctxt_idle_timeout;
+	comp->closed_ctxt_linger = cfg->closed_ctxt_linger;
+	comp->mem_budget = cfg->mem_budget;
+	comp->compress_min_priority = cfg->compress_min_priority;
+	comp->effort = cfg->effort;
+	if(cfg->overload_limits.queue_depth != comp->overload_limits.queue_depth ||
+	   cfg->overload_limits.burst_time_us != comp->overload_limits.burst_time_us)
+	{
+		comp->overload_limits = cfg->overload_limits;
+		comp->is_overloaded = false;
+	}
+	rohc_seqlock_write_end(&comp->stats_seq);
+
+	rohc_mem_free(&comp->mem_ops, cfg);
+
+	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "new runtime "
+	          "configuration taken");
+}
+
+
+/**
+ * @brief Write the feedback to piggyback ahead of the next ROHC header
+ *
+ * The oldest feedback items registered with \ref rohc_comp_piggyback_feedback
+ * are copied at the beginning of the ROHC packet, as long as they fit in the
+ * per-packet budget and leave room for the ROHC header. The feedback is then
+ * hidden from the ROHC packet, so that the ROHC header is written right
+ * after it. The items are not removed from the queue: the caller removes
+ * them once the ROHC packet is built.
+ *
+ * @param comp             The ROHC compressor
+ * @param rohc_packet      The ROHC packet being built, empty
+ * @param hdrs_len         The length of the uncompressed headers, payload
+ *                         included if it is copied after the ROHC header
+ * @param[out] items_nr    The number of feedback items written
+ * @return                 The number of bytes of feedback written
+ */
+static size_t rohc_comp_piggyback_write(const struct rohc_comp *const comp,
+                                        struct rohc_buf *const rohc_packet,
+                                        const size_t hdrs_len,
+                                        size_t *const items_nr)
+{
+	const struct rohc_comp_feedback_queue *const queue = &comp->piggyback_queue;
+	const uint32_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+	const uint32_t tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+	const size_t hdr_room = hdrs_len + ROHC_COMP_PIGGYBACK_HDR_ROOM;
+	size_t max_len;
+	size_t len = 0;
+	uint32_t i;
+
+	*items_nr = 0;
+
+	if(tail == head || rohc_buf_avail_len(*rohc_packet) <= hdr_room)
+	{
+		goto skip;
+	}
+	max_len = rohc_min(comp->piggyback_max_len,
+	                   rohc_buf_avail_len(*rohc_packet) - hdr_room);
+
+	/* copy the items in order, stop at the first one that does not fit */
+	for(i = tail; i != head; i++)
+	{
+		const size_t item_len = queue->items[i % ROHC_COMP_FEEDBACK_QUEUE_LEN].len;
+
+		if((len + item_len) > max_len)
+		{
+			break;
+		}
+		memcpy(rohc_buf_data_at(*rohc_packet, len),
+		       queue->items[i % ROHC_COMP_FEEDBACK_QUEUE_LEN].data, item_len);
+		len += item_len;
+		(*items_nr)++;
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "piggyback %zu feedback item(s) of %zu bytes, %u item(s) left",
+	           *items_nr, len, (unsigned int) (head - tail - *items_nr));
+
+	/* the ROHC header will be written after the feedback */
+	rohc_packet->len += len;
+	rohc_buf_pull(rohc_packet, len);
+
+skip:
+	return len;
+}
+
+
+/**
+ * @brief Get some information about the last compressed packet
+ *
+ * Get some information about the last compressed packet.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_comp_last_packet_info2_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * See the \ref rohc_comp_last_packet_info2_t structure for details about
+ * fields that are supported in the above versions.
+ *
+ * The function may be called by a monitoring thread while another thread
+ * compresses packets with the compressor: the information is copied without
+ * any lock, again if the compressor modified it in the meantime.
+ *
+ * @param comp          The ROHC compressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_last_packet_info2_t
+ */
+bool rohc_comp_get_last_packet_info2(const struct rohc_comp *const comp,
+                                     rohc_comp_last_packet_info2_t *const info)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(info == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for last packet information is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(info->version_major == 0)
+	{
+		const unsigned short version_minor = info->version_minor;
+		bool has_last_pkt_info;
+		uint32_t seq;
+
+		/* new fields added by minor versions */
+		if(version_minor > 0)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "last packet information", version_minor);
+			goto error;
+		}
+
+		/* base fields for major version 0, copied again if the compressor
+		 * modified them in the meantime */
+		do
+		{
+			seq = rohc_seqlock_read_begin(&comp->stats_seq);
+			has_last_pkt_info = comp->has_last_pkt_info;
+			*info = comp->last_pkt_info;
+		}
+		while(rohc_seqlock_read_retry(&comp->stats_seq, seq));
+		info->version_major = 0;
+		info->version_minor = version_minor;
+
+		if(!has_last_pkt_info)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "last context found in compressor is not valid");
+			goto error;
+		}
+	}
+	else
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for last "
+		           "packet information", info->version_major);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the durations of the compression stages
+ *
+ * Get the histograms of the durations of every compression stage measured
+ * since the creation of the compressor. See \ref rohc_comp_perf_stage_t for
+ * the list of stages.
+ *
+ * The durations are measured only if the library was configured with the
+ * --enable-rohc-perf-stats option. The function fails otherwise.
+ *
+ * @param comp          The ROHC compressor to get the durations from
+ * @param[out] stats    The durations of the compression stages
+ * @return              true in case of success,
+ *                      false if the library measures no duration or
+ *                      if one parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_perf_stage_t
+ */
+bool rohc_comp_get_perf_stats(const struct rohc_comp *const comp,
+                              struct rohc_comp_perf_stats *const stats)
+{
+	if(comp == NULL || stats == NULL)
+	{
+		goto error;
+	}
+
+#if ROHC_PERF_STATS == 1
+	memcpy(stats, &comp->perf.stats, sizeof(struct rohc_comp_perf_stats));
+	return true;
+#else
+	rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "library was built without performance statistics, configure "
+	           "it with --enable-rohc-perf-stats");
+#endif
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get some general information about the compressor
+ *
+ * Get some general information about the compressor.
+ *
+ * To use the function, call it with a pointer on a pre-allocated
+ * \ref rohc_comp_general_info_t structure with the \e version_major and
+ * \e version_minor fields set to one of the following supported versions:
+ *  - Major 0, minor 0
+ *
+ * See the \ref rohc_comp_general_info_t structure for details about fields
+ * that are supported in the above versions.
+ *
+ * The function may be called by a monitoring thread while another thread
+ * compresses packets with the compressor: the information is copied without
+ * any lock, again if the compressor modified it in the meantime.
+ *
+ * @param comp          The ROHC compressor to get information from
+ * @param[in,out] info  The structure where information will be stored
+ * @return              true in case of success, false otherwise
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_general_info_t
+ */
+bool rohc_comp_get_general_info(const struct rohc_comp *const comp,
+                                rohc_comp_general_info_t *const info)
+{
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	if(info == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "structure for general information is not valid");
+		goto error;
+	}
+
+	/* check compatibility version */
+	if(info->version_major == 0)
+	{
+		uint32_t seq;
+
+		if(info->version_minor > 2)
+		{
+			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "general information", info->version_minor);
+			goto error;
+		}
+
+		/* the statistics are copied again if the compressor modified them
+		 * in the meantime */
+		do
+		{
+			seq = rohc_seqlock_read_begin(&comp->stats_seq);
+
+			/* base fields for major version 0 */
+			info->contexts_nr = comp->num_contexts_used;
+			info->packets_nr = comp->num_packets;
+#if ROHC_COMP_STATS == 1
+			info->uncomp_bytes_nr = comp->total_uncompressed_size;
+			info->comp_bytes_nr = comp->total_compressed_size;
+#else
+			info->uncomp_bytes_nr = 0;
+			info->comp_bytes_nr = 0;
+#endif
+
+			/* new fields added by minor versions */
+			if(info->version_minor >= 1)
+			{
+				/* new fields in 0.1 */
+				size_t i;
+
+				info->contexts_recycled_nr = comp->ctxts_recycled_nr;
+				info->feedbacks_nr = comp->feedbacks_nr;
+				for(i = 0; i < ROHC_PACKET_MAX; i++)
+				{
+					info->packet_types_nr[i] = comp->packet_types_nr[i];
+				}
+			}
+			if(info->version_minor >= 2)
+			{
+				/* new fields in 0.2 */
+				info->overloads_nr = comp->overloads_nr;
+				info->overload_pkts_nr = comp->overload_pkts_nr;
+				info->overload_flows_nr = comp->overload_flows_nr;
+				info->overload_refreshes_nr = comp->overload_refreshes_nr;
+			}
+		}
+		while(rohc_seqlock_read_retry(&comp->stats_seq, seq));
+	}
+	else
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "unsupported major version (%u) of the structure for "
+		           "general information", info->version_major);
+		goto error;
+	}
 
-	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+	return true;
 
-	/* check inputs validity */
-	if(comp == NULL)
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the records of all the compression contexts in use
+ *
+ * Fill the given array with one compact record per compression context in
+ * use, from the most recently used context to the least recently used one.
+ * The contexts are walked once, so the records of thousands of contexts are
+ * retrieved much faster than with one call per CID.
+ *
+ * The function does not lock the compressor: call it from the thread that
+ * compresses the packets, or while no packet is being compressed. The
+ * records are a copy of the statistics of the contexts, so they may then be
+ * processed from another thread, eg. a monitoring thread, without any
+ * impact on the compression.
+ *
+ * If the compressor uses more contexts than \e records_max, only the
+ * records of the \e records_max most recently used contexts are given.
+ * The number of contexts in use is given by \ref rohc_comp_get_general_info.
+ *
+ * @param comp          The ROHC compressor to get the records from
+ * @param[out] records  The records of the contexts in use
+ * @param records_max   The maximum number of records that \e records may
+ *                      hold
+ * @return              The number of records written in \e records,
+ *                      0 if no context is in use or in case of error
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_ctxt_record
+ * @see rohc_comp_get_general_info
+ */
+size_t rohc_comp_get_contexts(const struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt_record records[],
+                              const size_t records_max)
+{
+	const struct rohc_comp_ctxt *context;
+	size_t records_nr = 0;
+
+	if(comp == NULL || records == NULL)
 	{
 		goto error;
 	}
+
+	for(context = comp->lru_first;
+	    context != NULL && records_nr < records_max;
+	    context = context->lru_next)
+	{
+		struct rohc_comp_ctxt_record *const record = &records[records_nr];
+
+		record->packets_nr = context->num_sent_packets;
+#if ROHC_COMP_STATS == 1
+		record->uncomp_bytes_nr = context->stats.total_uncompressed_size;
+		record->comp_bytes_nr = context->stats.total_compressed_size;
+#else
+		record->uncomp_bytes_nr = 0;
+		record->comp_bytes_nr = 0;
+#endif
+		record->cid = context->cid;
+		record->profile = context->profile->id;
+		record->mode = context->mode;
+		record->state = context->state;
+		records_nr++;
+	}
+
+	return records_nr;
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Give a description for the given ROHC compression context state
+ *
+ * Give a description for the given ROHC compression context state.
+ *
+ * The descriptions are not part of the API. They may change between
+ * releases without any warning. Do NOT use them for other means that
+ * providing to users a textual description of compression context states
+ * used by the library. If unsure, ask on the mailing list.
+ *
+ * @param state  The compression context state to get a description for
+ * @return       A string that describes the given compression context state
+ *
+ * @ingroup rohc_comp
+ */
+const char * rohc_comp_get_state_descr(const rohc_comp_state_t state)
+{
+	switch(state)
+	{
+		case ROHC_COMP_STATE_IR:
+			return "IR";
+		case ROHC_COMP_STATE_FO:
+			return "FO";
+		case ROHC_COMP_STATE_SO:
+			return "SO";
+		case ROHC_COMP_STATE_UNKNOWN:
+		default:
+			return "no description";
+	}
+}
+
+
+/*
+ * Definitions of private functions
+ */
+
+
+/**
+ * @brief Check the buffers given to one of the compression functions
+ *
+ * @param comp           The ROHC compressor
+ * @param uncomp_packet  The uncompressed packet to compress
+ * @param rohc_packet    The buffer for the compressed ROHC packet
+ * @return               true if the buffers are valid, false otherwise
+ */
+static bool rohc_comp_check_bufs(const struct rohc_comp *const comp,
+                                 const struct rohc_buf uncomp_packet,
+                                 const struct rohc_buf *const rohc_packet)
+{
 	if(rohc_buf_is_malformed(uncomp_packet))
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -574,8 +6187,31 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		goto error;
 	}
 
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Parse one uncompressed packet
+ *
+ * @param comp           The ROHC compressor
+ * @param uncomp_packet  The uncompressed packet to parse
+ * @param hints          The hints about the uncompressed packet, NULL if none
+ * @param[out] ip_pkt    The parsed packet
+ * @return               true if the packet was parsed, false otherwise
+ */
+static bool rohc_comp_parse_pkt(struct rohc_comp *const comp,
+                                const struct rohc_buf uncomp_packet,
+                                const struct rohc_comp_pkt_hints *const hints,
+                                struct net_pkt *const ip_pkt)
+{
+	struct net_pkt_hints pkt_hints;
+
 	/* print uncompressed bytes */
-	if((comp->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0)
+	if((c_features(comp) & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0)
 	{
 		rohc_dump_packet(comp->trace_callback, comp->trace_callback_priv,
 		                 ROHC_TRACE_COMP, ROHC_TRACE_DEBUG,
@@ -583,16 +6219,400 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 	}
 
 	/* parse the uncompressed packet */
-	if(!net_pkt_parse(&ip_pkt, uncomp_packet, comp->trace_callback,
-	                  comp->trace_callback_priv, ROHC_TRACE_COMP))
+	rohc_perf_begin(comp, ROHC_COMP_PERF_PARSE);
+	rohc_trace_filter_mute(comp);
+	if(hints != NULL)
+	{
+		pkt_hints.has_offsets = !!(hints->flags & ROHC_COMP_HINT_OFFSETS);
+		pkt_hints.inner_ip_offset = hints->inner_ip_offset;
+		pkt_hints.transport_offset = hints->transport_offset;
+		pkt_hints.transport_proto = hints->transport_proto;
+		pkt_hints.ipv4_csums_good = !!(hints->flags & ROHC_COMP_HINT_IP_CSUM_GOOD);
+	}
+	if(!net_pkt_parse_hinted(ip_pkt, uncomp_packet,
+	                         hints != NULL ? &pkt_hints : NULL,
+	                         !!(c_features(comp) & ROHC_COMP_FEATURE_FLOW_KEY),
+	                         comp->trace_callback, comp->trace_callback_priv,
+	                         ROHC_TRACE_COMP))
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		             "failed to parse uncompressed packet");
 		goto error;
 	}
+	rohc_perf_end(comp, ROHC_COMP_PERF_PARSE);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Check, parse and select the profile of one packet of a burst
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param hints             The hints about the uncompressed packet, NULL if
+ *                          none
+ * @param rohc_packet       The buffer for the compressed ROHC packet
+ * @param[out] ip_pkt       The parsed packet
+ * @param[out] profile_id   The ID of the profile for the packet, -1 if no
+ *                          profile was found yet
+ * @return                  true if the packet may be compressed,
+ *                          false otherwise
+ */
+static bool rohc_comp_prepare_pkt(struct rohc_comp *const comp,
+                                  const struct rohc_buf uncomp_packet,
+                                  const struct rohc_comp_pkt_hints *const hints,
+                                  const struct rohc_buf *const rohc_packet,
+                                  struct net_pkt *const ip_pkt,
+                                  int *const profile_id)
+{
+	const struct rohc_comp_profile *profile;
+
+	*profile_id = -1;
+
+	if(!rohc_comp_check_bufs(comp, uncomp_packet, rohc_packet))
+	{
+		goto error;
+	}
+	if(!rohc_comp_parse_pkt(comp, uncomp_packet, hints, ip_pkt))
+	{
+		goto error;
+	}
+
+	/* select the profile now, the context lookup will then start with the
+	 * prefetched index slot; if no profile is found, let the compression
+	 * report the error */
+	profile = c_get_profile_from_packet(comp, ip_pkt);
+	if(profile != NULL)
+	{
+		*profile_id = profile->id;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Parse, hash and prefetch one group of packets of a burst
+ *
+ * The packets of the group are parsed first, then the keys of their flows
+ * are gathered and hashed together, see \ref c_ctxt_index_mix_group. The
+ * index slots of all the packets are then prefetched before their first
+ * candidate contexts, so that the memory loads of the whole group overlap
+ * instead of waiting for each other.
+ *
+ * With \ref ROHC_COMP_FEATURE_BURST_GROUPING, the packets of one flow are
+ * then compressed one after the other, see \ref rohc_burst_group.
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_packets    The uncompressed packets of the group
+ * @param hints             The hints about the uncompressed packets of the
+ *                          group, NULL if none
+ * @param rohc_packets      The buffers for the compressed ROHC packets
+ * @param pkts_nr           The number of packets in the group,
+ *                          at most \ref ROHC_COMP_BURST_GROUP
+ * @param[out] is_parsed    Whether every packet may be compressed
+ * @param[out] profile_ids  The ID of the profile for every packet, -1 if no
+ *                          profile was found yet
+ * @param[out] hashes       The hash of the flow of every packet in the index
+ *                          of contexts, before it is reduced to one slot
+ * @param[out] order        The indexes of the packets in the order to
+ *                          compress them
+ */
+static void rohc_comp_prepare_group(struct rohc_comp *const comp,
+                                    const struct rohc_buf uncomp_packets[],
+                                    const struct rohc_comp_pkt_hints hints[],
+                                    const struct rohc_buf rohc_packets[],
+                                    const size_t pkts_nr,
+                                    bool is_parsed[ROHC_COMP_BURST_GROUP],
+                                    int profile_ids[ROHC_COMP_BURST_GROUP],
+                                    uint32_t hashes[ROHC_COMP_BURST_GROUP],
+                                    size_t order[ROHC_COMP_BURST_GROUP])
+{
+	struct net_pkt *const ip_pkts = comp->burst_pkts;
+	uint32_t profiles[ROHC_COMP_BURST_GROUP];
+	rohc_ctxt_key_t keys[ROHC_COMP_BURST_GROUP];
+	bool has_key[ROHC_COMP_BURST_GROUP];
+	size_t i;
+
+	assert(pkts_nr <= ROHC_COMP_BURST_GROUP);
+
+	/* parse the packets and gather the keys of their flows, the unused lanes
+	 * are hashed too but never looked up */
+	for(i = 0; i < ROHC_COMP_BURST_GROUP; i++)
+	{
+		is_parsed[i] = (i < pkts_nr &&
+		                rohc_comp_prepare_pkt(comp, uncomp_packets[i],
+		                                      hints != NULL ? &hints[i] : NULL,
+		                                      &rohc_packets[i], &ip_pkts[i],
+		                                      &profile_ids[i]));
+		if(!is_parsed[i])
+		{
+			profile_ids[i] = -1;
+		}
+		profiles[i] = (uint32_t) profile_ids[i];
+		keys[i] = (profile_ids[i] < 0 ? 0 : ip_pkts[i].key);
+	}
+
+	c_ctxt_index_mix_group(profiles, keys, hashes);
+
+	/* prefetch the index slots of the whole group, then the first candidate
+	 * context of every packet */
+	for(i = 0; i < pkts_nr; i++)
+	{
+		if(profile_ids[i] >= 0)
+		{
+			assert(hashes[i] == c_ctxt_index_mix(profile_ids[i], keys[i]));
+			__builtin_prefetch(&comp->ctxts_index[hashes[i] & comp->ctxts_index_mask]);
+		}
+	}
+	for(i = 0; i < pkts_nr; i++)
+	{
+		if(profile_ids[i] >= 0)
+		{
+			const size_t slot = hashes[i] & comp->ctxts_index_mask;
+			if(comp->ctxts_index[slot] != ROHC_COMP_CTXT_INDEX_EMPTY)
+			{
+				__builtin_prefetch(c_ctxt_at(comp, comp->ctxts_index[slot]));
+			}
+		}
+	}
+
+	/* group the packets by flow if asked by the user, unless the ROHC
+	 * segments shall be retrieved right after their packet; the packets
+	 * that cannot be compressed keep their position */
+	if((c_features(comp) & ROHC_COMP_FEATURE_BURST_GROUPING) != 0 &&
+	   comp->mrru == 0)
+	{
+		for(i = 0; i < pkts_nr; i++)
+		{
+			has_key[i] = (profile_ids[i] >= 0);
+		}
+		rohc_burst_group(hashes, has_key, pkts_nr, order);
+	}
+	else
+	{
+		for(i = 0; i < pkts_nr; i++)
+		{
+			order[i] = i;
+		}
+	}
+}
+
+
+/**
+ * @brief Prefetch the profile-specific data of the context of one packet
+ *
+ * The context itself was prefetched when the packet was parsed, see
+ * \ref rohc_comp_prepare_group, so it is expected to be in cache now: the
+ * profile-specific data it points to, eg. the W-LSB windows, are prefetched
+ * in turn. Only the first candidate context of the packet is considered.
+ *
+ * @param comp        The ROHC compressor
+ * @param ip_pkt      The parsed packet
+ * @param profile_id  The ID of the profile for the packet, -1 if no profile
+ *                    was found
+ * @param hash        The hash of the flow of the packet, see
+ *                    \ref c_ctxt_index_mix
+ */
+static void rohc_comp_prefetch_ctxt_data(const struct rohc_comp *const comp,
+                                         const struct net_pkt *const ip_pkt,
+                                         const int profile_id,
+                                         const uint32_t hash)
+{
+	const struct rohc_comp_ctxt *ctxt;
+	size_t slot;
+
+	if(profile_id < 0)
+	{
+		return;
+	}
+
+	/* the index may have grown since the hash was computed */
+	slot = hash & comp->ctxts_index_mask;
+	if(comp->ctxts_index[slot] == ROHC_COMP_CTXT_INDEX_EMPTY)
+	{
+		return;
+	}
+	ctxt = c_ctxt_at(comp, comp->ctxts_index[slot]);
+	if(ctxt->profile->id != (rohc_profile_t) profile_id ||
+	   ctxt->key != ip_pkt->key)
+	{
+		return;
+	}
+
+	__builtin_prefetch(ctxt->specific);
+	if(ctxt->profile->prefetch != NULL)
+	{
+		ctxt->profile->prefetch(ctxt);
+	}
+}
+
+
+/**
+ * @brief Compress a burst of packets
+ *
+ * The packets are handled in groups of \ref ROHC_COMP_BURST_GROUP packets:
+ * the packets of one group are parsed, hashed and their contexts prefetched
+ * together, see \ref rohc_comp_prepare_group, then they are compressed one
+ * by one while the profile-specific data of the context of the next packet
+ * are prefetched. The burst stops after the first packet that requires ROHC
+ * segmentation.
+ *
+ * With \ref ROHC_COMP_FEATURE_BURST_GROUPING, the packets of one group are
+ * compressed flow by flow, but every ROHC packet and every status is still
+ * written in the slot of its uncompressed packet.
+ *
+ * @param comp                  The ROHC compressor
+ * @param uncomp_packets        The uncompressed packets to compress
+ * @param hints                 The hints about the uncompressed packets,
+ *                              NULL if none
+ * @param[out] rohc_packets     The resulting compressed ROHC packets
+ * @param[out] payload_offsets  NULL to copy the payloads after the ROHC
+ *                              headers, otherwise only the ROHC headers are
+ *                              written and the offsets of the payloads in
+ *                              the uncompressed packets are returned
+ * @param[out] status           The status of every packet
+ * @param pkts_nr               The number of packets in the burst
+ * @return                      The number of packets that were handled
+ */
+static size_t rohc_comp_encode_burst(struct rohc_comp *const comp,
+                                     const struct rohc_buf uncomp_packets[],
+                                     const struct rohc_comp_pkt_hints hints[],
+                                     struct rohc_buf rohc_packets[],
+                                     size_t payload_offsets[],
+                                     rohc_status_t status[],
+                                     const size_t pkts_nr)
+{
+	const struct net_pkt *const ip_pkts = comp->burst_pkts;
+	bool is_parsed[ROHC_COMP_BURST_GROUP];
+	int profile_ids[ROHC_COMP_BURST_GROUP];
+	uint32_t hashes[ROHC_COMP_BURST_GROUP];
+	size_t order[ROHC_COMP_BURST_GROUP];
+	size_t group_nr;
+	size_t i;
+
+	/* take the configuration published by another thread if any, then
+	 * deliver the feedback enqueued by another thread if any */
+	rohc_comp_take_cfg(comp);
+	rohc_comp_drain_feedback(comp);
+
+	for(i = 0; i < pkts_nr; i += group_nr)
+	{
+		size_t k;
+
+		group_nr = rohc_min(pkts_nr - i, ROHC_COMP_BURST_GROUP);
+		rohc_comp_prepare_group(comp, &uncomp_packets[i],
+		                        hints != NULL ? &hints[i] : NULL,
+		                        &rohc_packets[i], group_nr, is_parsed,
+		                        profile_ids, hashes, order);
+
+		for(k = 0; k < group_nr; k++)
+		{
+			const size_t j = order[k];
+
+			/* prefetch the data of the context of the next packet, while the
+			 * current packet is not compressed yet */
+			if((k + 1) < group_nr && is_parsed[order[k + 1]])
+			{
+				const size_t next = order[k + 1];
+				rohc_comp_prefetch_ctxt_data(comp, &ip_pkts[next],
+				                             profile_ids[next], hashes[next]);
+			}
+
+			/* compress the current packet */
+			if(!is_parsed[j])
+			{
+				status[i + j] = ROHC_STATUS_ERROR;
+				continue;
+			}
+			status[i + j] =
+				rohc_comp_encode_pkt(comp, uncomp_packets[i + j], &ip_pkts[j],
+				                     profile_ids[j], &rohc_packets[i + j],
+				                     payload_offsets == NULL ? NULL :
+				                     &payload_offsets[i + j]);
+			if(status[i + j] == ROHC_STATUS_SEGMENT)
+			{
+				/* segments shall be retrieved before the next packets */
+				return (i + j + 1);
+			}
+		}
+	}
+
+	return pkts_nr;
+}
+
+
+/**
+ * @brief Compress one parsed packet
+ *
+ * @param comp              The ROHC compressor
+ * @param uncomp_packet     The uncompressed packet to compress
+ * @param ip_pkt            The parsed uncompressed packet
+ * @param profile_id_hint   The ID of the profile to use, -1 to select the
+ *                          best profile for the packet
+ * @param[out] rohc_packet  The resulting compressed ROHC packet
+ * @param[out] payload_offset_out  NULL to copy the payload after the ROHC
+ *                                 header, otherwise only the ROHC header is
+ *                                 written and the offset of the payload in
+ *                                 the uncompressed packet is returned
+ * @return                  See \ref rohc_compress4
+ */
+static rohc_status_t rohc_comp_encode_pkt(struct rohc_comp *const comp,
+                                          const struct rohc_buf uncomp_packet,
+                                          const struct net_pkt *const ip_pkt,
+                                          const int profile_id_hint,
+                                          struct rohc_buf *const rohc_packet,
+                                          size_t *const payload_offset_out)
+{
+	struct rohc_comp_ctxt *c;
+	rohc_packet_t packet_type;
+	int rohc_hdr_size;
+	size_t payload_size;
+	size_t payload_offset;
+	size_t rohc_len;
+	size_t hdrs_len;
+	size_t feedback_len = 0;
+	size_t feedback_items_nr = 0;
+	int profile_id = profile_id_hint;
+
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+
+	/* the traces are dropped until the context of the packet is known */
+	rohc_trace_filter_mute(comp);
+
+	/* destroy the contexts that were not used for too long */
+	if(comp->ctxt_idle_timeout != 0)
+	{
+		c_expire_contexts(comp, uncomp_packet.time);
+	}
+
+	/* destroy the contexts of the flows that ended long enough ago */
+	if(comp->closed_ctxt_linger != 0)
+	{
+		c_release_closed_contexts(comp, uncomp_packet.time);
+	}
+
+	/* the flows already sent with the Uncompressed profile skip the probing
+	 * of the compression profiles */
+	if(profile_id < 0 && (c_features(comp) & ROHC_COMP_FEATURE_UNCOMP_CACHE) != 0 &&
+	   c_uncomp_cache_has(comp, ip_pkt))
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "flow already sent uncompressed, skip the profile probing");
+		profile_id = ROHC_PROFILE_UNCOMPRESSED;
+	}
 
 	/* find the best context for the packet */
-	c = rohc_comp_find_ctxt(comp, &ip_pkt, -1, uncomp_packet.time);
+	rohc_perf_begin(comp, ROHC_COMP_PERF_CTXT_LOOKUP);
+	c = rohc_comp_find_ctxt(comp, ip_pkt, profile_id, uncomp_packet.time);
+	rohc_perf_end(comp, ROHC_COMP_PERF_CTXT_LOOKUP);
 	if(c == NULL)
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
@@ -601,16 +6621,57 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		goto error;
 	}
 
-	/* create the ROHC packet: */
+	/* pace the IR packets: once the IR budget of the interval is spent, the
+	 * contexts in IR state wait for the next interval and send their packets
+	 * through the shared Uncompressed context meanwhile */
+	if(comp->ir_pacing_budget != 0 && c->state == ROHC_COMP_STATE_IR &&
+	   c->profile->id != ROHC_PROFILE_UNCOMPRESSED &&
+	   rohc_comp_profile_enabled(comp, ROHC_PROFILE_UNCOMPRESSED) &&
+	   !c_ir_pacing_allows(comp, uncomp_packet.time))
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "IR budget spent, context with CID %zu waits for the next "
+		           "interval, send the packet uncompressed", c->cid);
+		c = c_get_shared_uncomp_ctxt(comp, ip_pkt, uncomp_packet.time);
+		if(c == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to create the shared Uncompressed context");
+			goto error;
+		}
+	}
+	c_trace_filter_select(comp, c);
+
+	/* create the ROHC packet: the feedback to piggyback if any, then the
+	 * ROHC header; the whole packet is accounted for if the payload is
+	 * copied or if its headers are not well-formed IPv4/IPv6 headers */
+	if(payload_offset_out != NULL &&
+	   (ip_get_version(&ip_pkt->outer_ip) == IPV4 ||
+	    ip_get_version(&ip_pkt->outer_ip) == IPV6) &&
+	   (ip_pkt->ip_hdr_nr == 1 ||
+	    ip_get_version(&ip_pkt->inner_ip) == IPV4 ||
+	    ip_get_version(&ip_pkt->inner_ip) == IPV6))
+	{
+		hdrs_len = net_pkt_get_payload_offset(ip_pkt);
+	}
+	else
+	{
+		hdrs_len = ip_pkt->len;
+	}
 	rohc_packet->len = 0;
+	feedback_len = rohc_comp_piggyback_write(comp, rohc_packet, hdrs_len,
+	                                         &feedback_items_nr);
 
 	/* use profile to compress packet */
 	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "compress the packet #%d", comp->num_packets + 1);
+	           "compress the packet #%lu",
+	           (unsigned long) (comp->num_packets + 1));
+	rohc_perf_begin(comp, ROHC_COMP_PERF_ENCODE);
 	rohc_hdr_size =
-		c->profile->encode(c, &ip_pkt, rohc_buf_data(*rohc_packet),
+		c->profile->encode(c, ip_pkt, rohc_buf_data(*rohc_packet),
 		                   rohc_buf_avail_len(*rohc_packet),
 		                   &packet_type, &payload_offset);
+	rohc_perf_end(comp, ROHC_COMP_PERF_ENCODE);
 	if(rohc_hdr_size < 0)
 	{
 		/* error while compressing, use the Uncompressed profile */
@@ -621,14 +6682,11 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		/* free context if it was just created */
 		if(c->num_sent_packets <= 1)
 		{
-			c->profile->destroy(c);
-			c->used = 0;
-			assert(comp->num_contexts_used > 0);
-			comp->num_contexts_used--;
+			c_destroy_context(comp, c);
 		}
 
 		/* find the best context for the Uncompressed profile */
-		c = rohc_comp_find_ctxt(comp, &ip_pkt, ROHC_PROFILE_UNCOMPRESSED,
+		c = rohc_comp_find_ctxt(comp, ip_pkt, ROHC_PROFILE_UNCOMPRESSED,
 		                        uncomp_packet.time);
 		if(c == NULL)
 		{
@@ -637,10 +6695,11 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 			             "create a new Uncompressed context");
 			goto error;
 		}
+		c_trace_filter_select(comp, c);
 
 		/* use the Uncompressed profile to compress the packet */
 		rohc_hdr_size =
-			c->profile->encode(c, &ip_pkt, rohc_buf_data(*rohc_packet),
+			c->profile->encode(c, ip_pkt, rohc_buf_data(*rohc_packet),
 			                   rohc_buf_avail_len(*rohc_packet),
 			                   &packet_type, &payload_offset);
 		if(rohc_hdr_size < 0)
@@ -653,13 +6712,48 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 	}
 	rohc_packet->len += rohc_hdr_size;
 
+	/* the profile may have detected the end of the flow */
+	c_ctxt_closed_update(comp, c, uncomp_packet.time);
+
+	/* the IR, IR-DYN and IR-CR headers consume the IR budget of the interval */
+	if(comp->ir_pacing_budget != 0 &&
+	   c->profile->id != ROHC_PROFILE_UNCOMPRESSED &&
+	   (packet_type == ROHC_PACKET_IR || packet_type == ROHC_PACKET_IR_DYN ||
+	    packet_type == ROHC_PACKET_IR_CR))
+	{
+		comp->ir_pacing_left -=
+			rohc_min(comp->ir_pacing_left, (size_t) rohc_hdr_size);
+	}
+
+	/* remember the flows sent in their own Uncompressed context */
+	if((c_features(comp) & ROHC_COMP_FEATURE_UNCOMP_CACHE) != 0 &&
+	   c->profile->id == ROHC_PROFILE_UNCOMPRESSED && c->key == ip_pkt->key &&
+	   c != comp->shared_uncomp_ctxt)
+	{
+		c_uncomp_cache_add(comp, ip_pkt);
+	}
+
 	/* the payload starts after the header, skip it */
 	rohc_buf_pull(rohc_packet, rohc_hdr_size);
-	payload_size = ip_pkt.len - payload_offset;
+	payload_size = ip_pkt->len - payload_offset;
+
+	if(payload_offset_out != NULL)
+	{
+		/* the payload is not copied, it is given back to the caller */
+		rohc_buf_push(rohc_packet, rohc_hdr_size);
+		*payload_offset_out = payload_offset;
+		rohc_len = rohc_hdr_size + payload_size;
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "ROHC size = %zu bytes (header = %d, payload = %zu at "
+		           "offset %zu of the uncompressed packet)", rohc_len,
+		           rohc_hdr_size, payload_size, payload_offset);
 
-	/* is packet too large for output buffer? */
-	if(payload_size > rohc_buf_avail_len(*rohc_packet))
+		/* report to user that compression was successful */
+		status = ROHC_STATUS_OK;
+	}
+	else if(payload_size > rohc_buf_avail_len(*rohc_packet))
 	{
+		/* packet is too large for output buffer */
 		const size_t max_rohc_buf_len =
 			rohc_buf_avail_len(*rohc_packet) + rohc_hdr_size;
 		uint32_t rru_crc;
@@ -675,7 +6769,7 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 
 		/* in order to be segmented, a ROHC packet shall be <= MRRU
 		 * (remember that MRRU includes the CRC length) */
-		if((payload_size + CRC_FCS32_LEN) > comp->mrru)
+		if((rohc_hdr_size + payload_size + CRC_FCS32_LEN) > comp->mrru)
 		{
 			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 			             "%s ROHC packet cannot be segmented: too large (%d + "
@@ -703,22 +6797,34 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		}
 		comp->rru_len = 0;
 		comp->rru_off = 0;
+		comp->rru_payload = NULL;
+		comp->rru_payload_off = 0;
+		comp->rru_payload_len = 0;
 		/* ROHC header */
 		rohc_buf_push(rohc_packet, rohc_hdr_size);
-		memcpy(comp->rru + comp->rru_off, rohc_buf_data(*rohc_packet),
-		       rohc_hdr_size);
-		comp->rru_len += rohc_hdr_size;
-		/* ROHC payload */
-		memcpy(comp->rru + comp->rru_off + comp->rru_len,
-		       rohc_buf_data_at(uncomp_packet, payload_offset), payload_size);
-		comp->rru_len += payload_size;
+		memcpy(comp->rru, rohc_buf_data(*rohc_packet), rohc_hdr_size);
 		/* compute FCS-32 CRC over header and payload (optional feedbacks and
 		   the CRC field itself are excluded) */
-		rru_crc = crc_calc_fcs32(comp->rru + comp->rru_off, comp->rru_len,
-		                         CRC_INIT_FCS32);
-		memcpy(comp->rru + comp->rru_off + comp->rru_len, &rru_crc,
-		       CRC_FCS32_LEN);
-		comp->rru_len += CRC_FCS32_LEN;
+		rru_crc = crc_calc_fcs32(comp->rru, rohc_hdr_size, CRC_INIT_FCS32);
+		rru_crc = crc_calc_fcs32(rohc_buf_data_at(uncomp_packet, payload_offset),
+		                         payload_size, rru_crc);
+		/* ROHC payload: copied in the RRU buffer or read from the uncompressed
+		 * packet when the segments are retrieved */
+		if((c_features(comp) & ROHC_COMP_FEATURE_SEGMENT_NO_COPY) != 0)
+		{
+			comp->rru_payload = rohc_buf_data_at(uncomp_packet, payload_offset);
+			comp->rru_payload_off = rohc_hdr_size;
+			comp->rru_payload_len = payload_size;
+			memcpy(comp->rru + rohc_hdr_size, &rru_crc, CRC_FCS32_LEN);
+		}
+		else
+		{
+			memcpy(comp->rru + rohc_hdr_size,
+			       rohc_buf_data_at(uncomp_packet, payload_offset), payload_size);
+			memcpy(comp->rru + rohc_hdr_size + payload_size, &rru_crc,
+			       CRC_FCS32_LEN);
+		}
+		comp->rru_len = rohc_hdr_size + payload_size + CRC_FCS32_LEN;
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "RRU 32-bit FCS CRC = 0x%08x", rohc_ntoh32(rru_crc));
 		/* computed RRU must be <= MRRU */
@@ -726,6 +6832,7 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 
 		/* reset the length of the ROHC packet: it shall be 0 for users */
 		rohc_packet->len = 0;
+		rohc_len = 0;
 
 		/* report to users that segmentation is possible */
 		status = ROHC_STATUS_SEGMENT;
@@ -735,12 +6842,15 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		/* copy full payload after ROHC header */
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "copy full %zd-byte payload", payload_size);
+		rohc_perf_begin(comp, ROHC_COMP_PERF_PAYLOAD_COPY);
 		rohc_buf_append(rohc_packet,
 		                rohc_buf_data_at(uncomp_packet, payload_offset),
 		                payload_size);
+		rohc_perf_end(comp, ROHC_COMP_PERF_PAYLOAD_COPY);
 
 		/* unhide the ROHC header */
 		rohc_buf_push(rohc_packet, rohc_hdr_size);
+		rohc_len = rohc_packet->len;
 		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "ROHC size = %zd bytes (header = %d, payload = %zu), output "
 		           "buffer size = %zu", rohc_packet->len, rohc_hdr_size,
@@ -750,26 +6860,84 @@ rohc_status_t rohc_compress4(struct rohc_comp *const comp,
 		status = ROHC_STATUS_OK;
 	}
 
+	/* unhide the piggybacked feedback: it is sent with a full ROHC packet,
+	 * otherwise it is kept for the next packet */
+	rohc_buf_push(rohc_packet, feedback_len);
+	if(status == ROHC_STATUS_OK)
+	{
+		struct rohc_comp_feedback_queue *const queue = &comp->piggyback_queue;
+		const uint32_t tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+
+		/* give the slots of the piggybacked items back to the producer */
+		__atomic_store_n(&queue->tail, tail + feedback_items_nr, __ATOMIC_RELEASE);
+	}
+	else
+	{
+		rohc_packet->len = 0;
+	}
+
 	/* update some statistics:
 	 *  - compressor statistics
 	 *  - context statistics (global + last packet + last 16 packets) */
+	c->packet_type = packet_type;
+	c->num_sent_packets++;
+
+	rohc_seqlock_write_begin(&comp->stats_seq);
 	comp->num_packets++;
+#if ROHC_COMP_STATS == 1
 	comp->total_uncompressed_size += uncomp_packet.len;
-	comp->total_compressed_size += rohc_packet->len;
+	comp->total_compressed_size += rohc_len;
+#endif
 	comp->last_context = c;
+	c_recent_ctxts_push(comp, c);
+	comp->packet_types_nr[packet_type]++;
+	if(comp->is_overloaded)
+	{
+		comp->overload_pkts_nr++;
+	}
+	comp->last_pkt_info.context_id = c->cid;
+	comp->last_pkt_info.is_context_init = (c->num_sent_packets == 1);
+	comp->last_pkt_info.context_mode = c->mode;
+	comp->last_pkt_info.context_state = c->state;
+	comp->last_pkt_info.context_used = true;
+	comp->last_pkt_info.profile_id = c->profile->id;
+	comp->last_pkt_info.packet_type = packet_type;
+#if ROHC_COMP_STATS == 1
+	comp->last_pkt_info.total_last_uncomp_size = uncomp_packet.len;
+	comp->last_pkt_info.header_last_uncomp_size = payload_offset;
+	comp->last_pkt_info.total_last_comp_size = rohc_len;
+	comp->last_pkt_info.header_last_comp_size = rohc_hdr_size;
+#else
+	comp->last_pkt_info.total_last_uncomp_size = 0;
+	comp->last_pkt_info.header_last_uncomp_size = 0;
+	comp->last_pkt_info.total_last_comp_size = 0;
+	comp->last_pkt_info.header_last_comp_size = 0;
+#endif
+	comp->has_last_pkt_info = true;
+	rohc_seqlock_write_end(&comp->stats_seq);
 
-	c->packet_type = packet_type;
+	/* record the headers of the packet to save the context later */
+	if((c_features(comp) & ROHC_COMP_FEATURE_CHECKPOINT) != 0)
+	{
+		c_ctxt_record_pkt(comp, c, rohc_buf_data(uncomp_packet), payload_offset,
+		                  payload_size);
+	}
 
-	c->total_uncompressed_size += uncomp_packet.len;
-	c->total_compressed_size += rohc_packet->len;
-	c->header_uncompressed_size += payload_offset;
-	c->header_compressed_size += rohc_hdr_size;
-	c->num_sent_packets++;
+#if ROHC_COMP_STATS == 1
+	c->stats.total_uncompressed_size += uncomp_packet.len;
+	c->stats.total_compressed_size += rohc_len;
+	c->stats.header_uncompressed_size += payload_offset;
+	c->stats.header_compressed_size += rohc_hdr_size;
 
-	c->total_last_uncompressed_size = uncomp_packet.len;
-	c->total_last_compressed_size = rohc_packet->len;
-	c->header_last_uncompressed_size = payload_offset;
-	c->header_last_compressed_size = rohc_hdr_size;
+	c->stats.total_last_uncompressed_size = uncomp_packet.len;
+	c->stats.total_last_compressed_size = rohc_len;
+	c->stats.header_last_uncompressed_size = payload_offset;
+	c->stats.header_last_compressed_size = rohc_hdr_size;
+#endif
+
+	rohc_trace_event(comp, ROHC_TRACE_COMP, ROHC_TRACE_EVENT_COMP_PKT,
+	                 c->profile->id, c->cid, packet_type, uncomp_packet.len,
+	                 rohc_len, rohc_hdr_size);
 
 	/* compression is successful */
 	return status;
@@ -778,644 +6946,680 @@ error_free_new_context:
 	/* free context if it was just created */
 	if(c->num_sent_packets <= 1)
 	{
-		c->profile->destroy(c);
-		c->used = 0;
-		assert(comp->num_contexts_used > 0);
-		comp->num_contexts_used--;
+		c_destroy_context(comp, c);
 	}
 error:
+	/* the feedback is kept for the next packet */
+	rohc_buf_push(rohc_packet, feedback_len);
+	rohc_packet->len = 0;
+	rohc_trace_event(comp, ROHC_TRACE_COMP, ROHC_TRACE_EVENT_COMP_FAILURE,
+	                 ROHC_PROFILE_GENERAL, ROHC_TRACE_RECORD_NO_CID,
+	                 ROHC_PACKET_UNKNOWN, uncomp_packet.len, 0, 0);
 	return ROHC_STATUS_ERROR;
 }
 
 
 /**
- * @brief Get the next ROHC segment if any
+ * @brief Read bytes of the RRU waiting to be split into segments
  *
- * Get the next ROHC segment if any.
- *
- * To get all the segments of one ROHC packet, call this function until
- * \ref ROHC_STATUS_OK or \ref ROHC_STATUS_ERROR is returned.
- *
- * @param comp          The ROHC compressor
- * @param[out] segment  The buffer where to store the ROHC segment
- * @return              Possible return values:
- *                       \li \ref ROHC_STATUS_SEGMENT if a ROHC segment is
- *                           returned and more segments are available,
- *                       \li \ref ROHC_STATUS_OK if a ROHC segment is returned
- *                           and no more ROHC segment is available
- *                       \li \ref ROHC_STATUS_ERROR if an error occurred
- *
- * @ingroup rohc_comp
- *
- * \par Example:
- * \snippet test_segment.c define ROHC compressor
- * \code
-        ...
-        // compress the IP packet with a small ROHC buffer
-\endcode
- * \snippet test_segment.c segment ROHC packet #1
- * \snippet test_segment.c segment ROHC packet #2
- * \code
-                        ...
-                        // decompress the ROHC segment here, the function
-                        // rohc_decompress3 shall return ROHC_STATUS_OK
-                        // and no decompressed packet
-                        ...
-\endcode
- * \snippet test_segment.c segment ROHC packet #3
- * \code
-                // decompress the final ROHC segment here, the function
-                // rohc_decompress4 shall return ROHC_STATUS_OK
-\endcode
- * \snippet test_segment.c segment ROHC packet #4
- * \code
-                // handle compression error here
-                ...
-\endcode
+ * The RRU is made of the ROHC header, the payload and the FCS-32. The payload
+ * is stored in the RRU buffer, or in the uncompressed packet if it was not
+ * copied (see \ref ROHC_COMP_FEATURE_SEGMENT_NO_COPY).
  *
- * @see rohc_comp_get_mrru
- * @see rohc_comp_set_mrru
- * @see rohc_compress4
+ * @param comp      The ROHC compressor
+ * @param off       The offset of the bytes to read in the RRU
+ * @param len       The number of bytes to read
+ * @param[out] dst  The buffer to copy the bytes to
  */
-rohc_status_t rohc_comp_get_segment2(struct rohc_comp *const comp,
-                                     struct rohc_buf *const segment)
-
+static void rohc_comp_rru_read(const struct rohc_comp *const comp,
+                               const size_t off,
+                               size_t len,
+                               uint8_t *dst)
 {
-	const size_t segment_type_len = 1; /* segment type byte */
-	size_t max_data_len;
-	rohc_status_t status;
+	const size_t payload_begin = comp->rru_payload_off;
+	const size_t payload_end = payload_begin + comp->rru_payload_len;
+	size_t pos = off;
 
-	/* check input parameters */
-	if(comp == NULL)
-	{
-		goto error;
-	}
-	if(segment == NULL)
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given segment cannot be NULL");
-		goto error;
-	}
-	if(rohc_buf_is_malformed(*segment))
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given segment is malformed");
-		goto error;
-	}
-	if(!rohc_buf_is_empty(*segment))
+	/* the bytes of the ROHC header before the payload that was not copied */
+	if(pos < payload_begin && len > 0)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "given segment is not empty");
-		goto error;
+		const size_t n = rohc_min(len, payload_begin - pos);
+		memcpy(dst, comp->rru + pos, n);
+		dst += n;
+		pos += n;
+		len -= n;
 	}
 
-	/* no segment yet */
-	segment->len = 0;
-
-	/* abort if no RRU is available in the compressor */
-	if(comp->rru_len == 0)
+	/* the bytes of the payload that was not copied */
+	if(pos < payload_end && len > 0)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "no RRU available in given compressor");
-		goto error;
+		const size_t n = rohc_min(len, payload_end - pos);
+		memcpy(dst, comp->rru_payload + pos - payload_begin, n);
+		dst += n;
+		pos += n;
+		len -= n;
 	}
 
-	/* abort is the given output buffer is too small for RRU */
-	if(rohc_buf_avail_len(*segment) <= segment_type_len)
+	/* the other bytes are stored in the RRU buffer */
+	if(len > 0)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "output buffer is too small for RRU, more than %zd bytes "
-		             "are required", segment_type_len);
-		goto error;
+		memcpy(dst, comp->rru + pos - comp->rru_payload_len, len);
 	}
+}
 
-	/* how many bytes of ROHC packet can we put in that new segment? */
-	max_data_len = rohc_min(rohc_buf_avail_len(*segment) - segment_type_len,
-	                        comp->rru_len);
-	assert(max_data_len > 0);
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "copy %zd bytes of the remaining %zd bytes of ROHC packet and "
-	           "CRC in the segment", max_data_len, comp->rru_len);
 
-	/* set segment type with F bit set only for last segment */
-	rohc_buf_byte_at(*segment, 0) = 0xfe | (max_data_len == comp->rru_len);
-	segment->len++;
-	rohc_buf_pull(segment, 1);
+/**
+ * @brief View bytes of the RRU waiting to be split into segments
+ *
+ * The same as \ref rohc_comp_rru_read, but the bytes are not copied: one view
+ * is added to the vectored network buffer for the ROHC header, the payload
+ * that was not copied and the FCS-32 each.
+ *
+ * @param comp      The ROHC compressor
+ * @param off       The offset of the bytes to view in the RRU
+ * @param len       The number of bytes to view
+ * @param[out] vec  The vectored network buffer to add the views to, with
+ *                  room for 3 more views
+ */
+static void rohc_comp_rru_view(const struct rohc_comp *const comp,
+                               const size_t off,
+                               size_t len,
+                               struct rohc_buf_vec *const vec)
+{
+	const size_t payload_begin = comp->rru_payload_off;
+	const size_t payload_end = payload_begin + comp->rru_payload_len;
+	size_t pos = off;
 
-	/* copy remaining ROHC data (CRC included) */
-	rohc_buf_append(segment, comp->rru + comp->rru_off, max_data_len);
-	rohc_buf_pull(segment, max_data_len);
-	comp->rru_off += max_data_len;
-	comp->rru_len -= max_data_len;
+	assert((vec->segs_nr + 3) <= ROHC_BUF_VEC_MAX_SEGS);
 
-	/* set status wrt to (non-)final segment */
-	if(comp->rru_len == 0)
+	/* the bytes of the ROHC header before the payload that was not copied */
+	if(pos < payload_begin && len > 0)
 	{
-		/* final segment, no more segment available */
-		status = ROHC_STATUS_OK;
-		/* reset context for next RRU */
-		comp->rru_off = 0;
+		const size_t n = rohc_min(len, payload_begin - pos);
+		vec->segs[vec->segs_nr++] = rohc_comp_buf_view(comp->rru + pos, n);
+		pos += n;
+		len -= n;
 	}
-	else
+
+	/* the bytes of the payload that was not copied */
+	if(pos < payload_end && len > 0)
 	{
-		/* non-final segment, more segments to available */
-		status = ROHC_STATUS_SEGMENT;
+		const size_t n = rohc_min(len, payload_end - pos);
+		vec->segs[vec->segs_nr++] =
+			rohc_comp_buf_view(comp->rru_payload + pos - payload_begin, n);
+		pos += n;
+		len -= n;
 	}
 
-	/* shift backward the RRU data, header and the feedback data */
-	rohc_buf_push(segment, max_data_len + 1);
-
-	return status;
-
-error:
-	return ROHC_STATUS_ERROR;
+	/* the other bytes are stored in the RRU buffer */
+	if(len > 0)
+	{
+		vec->segs[vec->segs_nr++] =
+			rohc_comp_buf_view(comp->rru + pos - comp->rru_payload_len, len);
+	}
 }
 
 
 /**
- * @brief Force the compressor to re-initialize all its contexts
+ * @brief Build a network buffer that views the given bytes
  *
- * Make all contexts restart their initialization with decompressor, ie. they
- * go in the lowest compression state. This function can be used once the
- * ROHC channel is established again after an interruption.
- *
- * The function implements the CONTEXT_REINITIALIZATION signal described by
- * RFC 3095 at §6.3.1 as:
- * \verbatim
-   CONTEXT_REINITIALIZATION -- signal
-   This parameter triggers a reinitialization of the entire context at
-   the decompressor, both the static and the dynamic part.  The
-   compressor MUST, when CONTEXT_REINITIALIZATION is triggered, back off
-   to the IR state and fully reinitialize the context by sending IR
-   packets with both the static and dynamic chains covering the entire
-   uncompressed headers until it is reasonably confident that the
-   decompressor contexts are reinitialized.  The context
-   reinitialization MUST be done for all contexts at the compressor.
-   This parameter may for instance be used to do context relocation at,
-   e.g., a cellular handover that results in a change of compression
-   point in the radio access network.
-\endverbatim
- *
- * @param comp  The ROHC compressor
- * @return      true in case of success, false otherwise
- *
- * @ingroup rohc_comp
+ * @param data  The bytes to view
+ * @param len   The number of bytes to view
+ * @return      The network buffer, full and without headroom nor tailroom
  */
-bool rohc_comp_force_contexts_reinit(struct rohc_comp *const comp)
+static struct rohc_buf rohc_comp_buf_view(const uint8_t *const data,
+                                          const size_t len)
 {
-	rohc_cid_t i;
+	struct rohc_buf buf;
 
-	if(comp == NULL)
-	{
-		goto error;
-	}
+	buf.time.sec = 0;
+	buf.time.nsec = 0;
+	buf.data = (uint8_t *) data;
+	buf.max_len = len;
+	buf.offset = 0;
+	buf.len = len;
 
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	          "force re-initialization for all %zu contexts",
-	          comp->num_contexts_used);
+	return buf;
+}
 
-	for(i = 0; i <= comp->medium.max_cid; i++)
+
+/**
+ * @brief Find out a ROHC profile given a profile ID
+ *
+ * @param comp       The ROHC compressor
+ * @param profile_id The ID of the ROHC profile to find out
+ * @return           The ROHC profile if found, NULL otherwise
+ */
+static const struct rohc_comp_profile *
+	rohc_get_profile_from_id(const struct rohc_comp *comp,
+	                         const rohc_profile_t profile_id)
+{
+	const size_t i = rohc_comp_get_profile_idx(profile_id);
+
+	/* if the profile is supported and enabled */
+	if(i == ROHC_COMP_PROFILE_IDX_NONE || !comp->enabled_profiles[i])
 	{
-		if(comp->contexts[i].used)
-		{
-			if(!comp->contexts[i].profile->reinit_context(&(comp->contexts[i])))
-			{
-				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-				             "failed to force re-initialization for CID %zu", i);
-				goto error;
-			}
-		}
+		return NULL;
 	}
 
-	return true;
-
-error:
-	return false;
+	return rohc_comp_profiles[i];
 }
 
 
 /**
- * @brief Set the window width for the W-LSB encoding scheme
- *
- * Set the window width for the Window-based Least Significant Bits (W-LSB)
- * encoding. See section 4.5.2 of RFC 3095 for more details about the encoding
- * scheme.
- *
- * The width of the W-LSB window is set to 4 by default.
- *
- * @warning The value must be a power of 2
- *
- * @warning The value can not be modified after library initialization
+ * @brief Get the index of a ROHC profile given a profile ID
  *
- * @param comp   The ROHC compressor
- * @param width  The width of the W-LSB sliding window
- * @return       true in case of success, false in case of failure
- *
- * @ingroup rohc_comp
+ * @param profile_id The ID of the ROHC profile
+ * @return           The index of the ROHC profile in \ref rohc_comp_profiles,
+ *                   \ref ROHC_COMP_PROFILE_IDX_NONE if not supported
  */
-bool rohc_comp_set_wlsb_window_width(struct rohc_comp *const comp,
-                                     const size_t width)
+static size_t rohc_comp_get_profile_idx(const rohc_profile_t profile_id)
 {
-	/* we need a valid compressor and a positive non-zero window width */
-	if(comp == NULL)
-	{
-		return false;
-	}
-	if(width == 0)
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
-		             "set width of W-LSB sliding window to %zd: window width "
-		             "must be a non-null positive integer", width);
-		return false;
-	}
+	size_t i;
 
-	/* window width must be a power of 2 */
-	if((width & (width - 1)) != 0)
+	if(rohc_profile_is_rohcv2(profile_id))
+	{
+		if(((size_t) profile_id) >= ROHCv2_PROFILE_MAX)
+		{
+			return ROHC_COMP_PROFILE_IDX_NONE;
+		}
+		i = rohc_comp_profiles_v2_idx[profile_id & 0xff];
+	}
+	else if(((size_t) profile_id) >= ROHC_PROFILE_MAX)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "failed to "
-		             "set width of W-LSB sliding window to %zd: window width "
-		             "must be a power of 2", width);
-		return false;
+		return ROHC_COMP_PROFILE_IDX_NONE;
 	}
-
-	/* refuse to set a value if compressor is in use */
-	if(comp->num_packets > 0)
+	else
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "unable to "
-		             "modify the W-LSB window width after initialization");
-		return false;
+		i = rohc_comp_profiles_idx[profile_id];
 	}
+	assert(i == ROHC_COMP_PROFILE_IDX_NONE ||
+	       rohc_comp_profiles[i]->id == profile_id);
 
-	comp->wlsb_window_width = width;
+	return i;
+}
 
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	          "width of W-LSB sliding window set to %zd", width);
 
-	return true;
+/**
+ * @brief Get the compression profiles that may accept a transport protocol
+ *
+ * The profiles dedicated to one transport protocol (UDP, UDP-Lite, ESP and
+ * TCP) are candidates only for their protocol. The TCP profile parses the IP
+ * headers on its own and supports more IP headers than \ref net_pkt_parse,
+ * so it is also a candidate for the packets that the latter does not fully
+ * parse. The IP-only (v1 and v2) and Uncompressed profiles are candidates for
+ * all the packets.
+ *
+ * @param proto  The transport protocol found by \ref net_pkt_parse
+ * @return       The bitmask of the indexes of the candidate profiles in
+ *               \ref rohc_comp_profiles
+ */
+static unsigned int rohc_comp_get_profiles_for_proto(const uint8_t proto)
+{
+	const unsigned int any_proto =
+		(1U << rohc_comp_profiles_idx[ROHC_PROFILE_IP]) |
+		(1U << ROHC_COMP_PROFILE_IDX_RFC5225_IP) |
+		(1U << rohc_comp_profiles_idx[ROHC_PROFILE_UNCOMPRESSED]);
+	const unsigned int tcp = (1U << rohc_comp_profiles_idx[ROHC_PROFILE_TCP]);
+
+	switch(proto)
+	{
+		case ROHC_IPPROTO_UDP:
+			return (1U << rohc_comp_profiles_idx[ROHC_PROFILE_RTP]) |
+			       (1U << rohc_comp_profiles_idx[ROHC_PROFILE_UDP]) | any_proto;
+		case ROHC_IPPROTO_UDPLITE:
+			return (1U << rohc_comp_profiles_idx[ROHC_PROFILE_UDPLITE]) | any_proto;
+		case ROHC_IPPROTO_ESP:
+			return (1U << rohc_comp_profiles_idx[ROHC_PROFILE_ESP]) | any_proto;
+		default:
+			return tcp | any_proto;
+	}
 }
 
 
 /**
- * @brief Set the timeout values for IR and FO periodic refreshes
- *
- * Set the timeout values for IR and FO periodic refreshes. The IR timeout
- * shall be greater than the FO timeout. Both timeouts are expressed in
- * number of compressed packets.
- *
- * The IR timeout is set to \ref CHANGE_TO_IR_COUNT by default.
- * The FO timeout is set to \ref CHANGE_TO_FO_COUNT by default.
- *
- * @warning The values can not be modified after library initialization
- *
- * @param comp        The ROHC compressor
- * @param ir_timeout  The number of packets to compress before going back
- *                    to IR state to force a context refresh
- * @param fo_timeout  The number of packets to compress before going back
- *                    to FO state to force a context refresh
- * @return            true in case of success, false in case of failure
+ * @brief Find out a ROHC profile given an IP protocol ID
  *
- * @ingroup rohc_comp
+ * @param comp    The ROHC compressor
+ * @param packet  The packet to find a compression profile for
+ * @return        The ROHC profile if found, NULL otherwise
  */
-bool rohc_comp_set_periodic_refreshes(struct rohc_comp *const comp,
-                                      const size_t ir_timeout,
-                                      const size_t fo_timeout)
+static const struct rohc_comp_profile *
+	c_get_profile_from_packet(const struct rohc_comp *const comp,
+	                          const struct net_pkt *const packet)
 {
-	/* we need a valid compressor, positive non-zero timeouts,
-	 * and IR timeout > FO timeout */
-	if(comp == NULL)
-	{
-		return false;
-	}
-	if(ir_timeout == 0 || fo_timeout == 0 || ir_timeout <= fo_timeout)
+	unsigned int candidates;
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "try to find the best profile for packet with transport "
+	           "protocol %u", packet->transport->proto);
+
+	/* the compression profiles that may accept the transport protocol of the
+	 * packet, only the Uncompressed profile accepts the IP fragments, the
+	 * IPv4 options and the bad IPv4 checksums */
+	candidates = rohc_comp_get_profiles_for_proto(packet->transport->proto);
+	if(rohc_comp_get_ip_anomalies(comp, packet) != 0)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "invalid "
-		             "timeouts for context periodic refreshes (IR timeout = %zd, "
-		             "FO timeout = %zd)", ir_timeout, fo_timeout);
-		return false;
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "IP headers not compressible (anomalies 0x%02x), skip all "
+		           "the profiles but the Uncompressed one", packet->ip_anomalies);
+		candidates &= (1U << rohc_comp_profiles_idx[ROHC_PROFILE_UNCOMPRESSED]);
 	}
 
-	/* refuse to set values if compressor is in use */
-	if(comp->num_packets > 0)
+	/* test the candidate profiles in the order of the profiles */
+	for(; candidates != 0; candidates &= candidates - 1)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "unable to modify the timeouts for periodic refreshes "
-		             "after initialization");
-		return false;
-	}
+		const size_t i = __builtin_ctz(candidates);
+		bool check_profile;
 
-	comp->periodic_refreshes_ir_timeout = ir_timeout;
-	comp->periodic_refreshes_fo_timeout = fo_timeout;
+		/* skip profile if the profile is not enabled */
+		if(!comp->enabled_profiles[i])
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "skip disabled profile '%s' (0x%04x)",
+			           rohc_get_profile_descr(rohc_comp_profiles[i]->id),
+			           rohc_comp_profiles[i]->id);
+			continue;
+		}
 
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "IR timeout for "
-	          "context periodic refreshes set to %zd", ir_timeout);
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "FO timeout for "
-	          "context periodic refreshes set to %zd", fo_timeout);
+		/* does the profile accept the packet? */
+		check_profile = rohc_comp_profiles[i]->check_profile(comp, packet);
+		if(!check_profile)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "skip profile '%s' (0x%04x) because it does not match "
+			           "packet",rohc_get_profile_descr(rohc_comp_profiles[i]->id),
+			           rohc_comp_profiles[i]->id);
+			continue;
+		}
 
-	return true;
+		/* the packet is compatible with the profile, let's go with it! */
+		return rohc_comp_profiles[i];
+	}
+
+	return NULL;
 }
 
 
 /**
- * @brief Set the number of uncompressed transmissions for list compression
- *
- * Set the number of transmissions required for list compression. This matches
- * the L parameter described in RFC 3095 and 4815. The compressor sends the
- * list items uncompressed L times before compressing them. The compressor
- * also sends the list structure L times before compressing it out.
- *
- * The L parameter is set to \ref ROHC_LIST_DEFAULT_L by default.
+ * @brief Whether a new context requires to recycle one context
  *
- * @warning The value can not be modified after library initialization
+ * @param comp  The ROHC compressor
+ * @return      true if all the CIDs are in use or if the memory budget is
+ *              exhausted, false otherwise
+ */
+static bool c_ctxts_full(const struct rohc_comp *const comp)
+{
+	return (comp->num_contexts_used > (comp->medium.max_cid - comp->min_cid) ||
+	        (comp->mem_budget != 0 && comp->lru_last != NULL &&
+	         c_mem_usage(comp) >= comp->mem_budget));
+}
+
+
+/**
+ * @brief Get the context to recycle to make room for a new one
  *
- * @param comp           The ROHC compressor
- * @param list_trans_nr  The number of times the list items or the list itself
- *                       are sent uncompressed before being sent compressed
- * @return               true if the new value is accepted,
- *                       false if the value is rejected
+ * The contexts of the ended flows are recycled first, the one of the flow
+ * that ended first. Without priority classes, the least recently used
+ * context is recycled then.
+ * Otherwise, the context of lowest priority class among the least recently
+ * used ones is recycled, the one with the fewest packets among the ones of
+ * the same class (short-lived flows first).
  *
- * @ingroup rohc_comp
+ * @param comp  The ROHC compressor with at least one context in use
+ * @return      The context to recycle
  */
-bool rohc_comp_set_list_trans_nr(struct rohc_comp *const comp,
-                                 const size_t list_trans_nr)
+static struct rohc_comp_ctxt *
+	c_ctxt_to_recycle(const struct rohc_comp *const comp)
 {
-	/* we need a valid compressor and a positive non-zero value for L */
-	if(comp == NULL)
+	struct rohc_comp_ctxt *best = comp->lru_last;
+	struct rohc_comp_ctxt *c;
+	size_t i;
+
+	assert(best != NULL);
+
+	/* the flows that ended first are recycled first, whatever their priority */
+	if(comp->closed_first != NULL)
 	{
-		return false;
+		return comp->closed_first;
 	}
-	if(list_trans_nr == 0)
+
+	if(comp->priority_callback == NULL)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "invalid "
-		             "value for uncompressed transmissions of list compression "
-		             "(%zu)", list_trans_nr);
-		return false;
+		return best;
 	}
 
-	/* refuse to set values if compressor is in use */
-	if(comp->num_packets > 0)
+	for(c = best->lru_prev, i = 1;
+	    c != NULL && i < ROHC_COMP_RECYCLE_CANDIDATES;
+	    c = c->lru_prev, i++)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "unable to modify the value for uncompressed transmissions"
-		             " of list compression after initialization");
-		return false;
+		if(c->priority < best->priority ||
+		   (c->priority == best->priority &&
+		    c->num_sent_packets < best->num_sent_packets))
+		{
+			best = c;
+		}
 	}
 
-	comp->list_trans_nr = list_trans_nr;
+	return best;
+}
 
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL, "uncompressed "
-	          "transmissions of list compression set to %zu", list_trans_nr);
 
-	return true;
+/**
+ * @brief Get the slot of a flow in the cache of the flows sent uncompressed
+ *
+ * @param key  The key of the flow
+ * @return     The slot of the flow
+ */
+static size_t c_uncomp_cache_slot(const rohc_ctxt_key_t key)
+{
+	return ((key ^ (key >> 16)) & (ROHC_COMP_UNCOMP_CACHE_LEN - 1));
 }
 
 
 /**
- * @brief Set the RTP detection callback function
- *
- * Set or replace the callback function that the ROHC library will call to
- * detect RTP streams among other UDP streams.
- *
- * The function is called once per UDP packet to compress, with the IP and
- * UDP headers and the UDP payload. If the callback function returns true, the
- * RTP profile is used for compression, otherwise the IP/UDP profile is used
- * instead.
- *
- * Special value NULL may be used to disable the detection of RTP streams with
- * the callback method. The detection will then be based on a list of UDP
- * ports dedicated for RTP streams.
+ * @brief Whether the flow of the packet was already sent uncompressed
  *
- * @param comp        The ROHC compressor
- * @param callback    The callback function used to detect RTP packets
- *                    The callback is deactivated if NULL is given as parameter
- * @param rtp_private A pointer to an external memory area
- *                    provided and used by the callback user
- * @return            true on success, false otherwise
+ * See \ref ROHC_COMP_FEATURE_UNCOMP_CACHE
  *
- * @ingroup rohc_comp
+ * @param comp    The ROHC compressor
+ * @param packet  The packet to compress
+ * @return        true if the flow shall be sent with the Uncompressed
+ *                profile, false if the profiles shall be probed
+ */
+static bool c_uncomp_cache_has(const struct rohc_comp *const comp,
+                               const struct net_pkt *const packet)
+{
+	const struct rohc_comp_uncomp_flow *const flow =
+		&comp->uncomp_flows[c_uncomp_cache_slot(packet->key)];
+
+	return (flow->used && flow->key == packet->key &&
+	        flow->proto == packet->transport->proto &&
+	        rohc_comp_profile_enabled(comp, ROHC_PROFILE_UNCOMPRESSED));
+}
+
+
+/**
+ * @brief Remember that the flow of the packet was sent uncompressed
  *
- * \par Example:
- * \snippet rtp_detection.c define RTP detection callback
- * \code
-        ...
-\endcode
- * \snippet simple_rohc_program.c define ROHC compressor
- * \code
-        ...
-\endcode
- * \snippet simple_rohc_program.c create ROHC compressor
- * \code
-        ...
-\endcode
- * \snippet rtp_detection.c set RTP detection callback
- * \code
-        ...
-\endcode
- * \snippet simple_rohc_program.c destroy ROHC compressor
+ * See \ref ROHC_COMP_FEATURE_UNCOMP_CACHE
  *
- * @see rohc_rtp_detection_callback_t
- * @see rohc_comp_add_rtp_port
- * @see rohc_comp_remove_rtp_port
- * @see rohc_comp_reset_rtp_ports
+ * @param comp    The ROHC compressor
+ * @param packet  The packet sent with the Uncompressed profile
  */
-bool rohc_comp_set_rtp_detection_cb(struct rohc_comp *const comp,
-                                    rohc_rtp_detection_callback_t callback,
-                                    void *const rtp_private)
+static void c_uncomp_cache_add(struct rohc_comp *const comp,
+                               const struct net_pkt *const packet)
 {
-	/* sanity check on compressor */
-	if(comp == NULL)
-	{
-		return false;
-	}
-
-	/* set RTP detection callback */
-	comp->rtp_callback = callback;
-	comp->rtp_private = rtp_private;
+	struct rohc_comp_uncomp_flow *const flow =
+		&comp->uncomp_flows[c_uncomp_cache_slot(packet->key)];
 
-	return true;
+	flow->key = packet->key;
+	flow->proto = packet->transport->proto;
+	flow->used = true;
 }
 
 
 /**
- * @brief Is the given compression profile enabled for a compressor?
+ * @brief Find the context of the packet among the most recently used ones
  *
- * Is the given compression profile enabled or disabled for a compressor?
+ * The contexts are validated as the contexts of the hash index: right
+ * profile, right key, then the profile checks that the packet matches the
+ * context. The context found, if any, is not moved to the front yet, see
+ * \ref c_recent_ctxts_push once the packet is compressed.
  *
  * @param comp     The ROHC compressor
- * @param profile  The profile to ask status for
- * @return         Possible return values:
- *                  \li true if the profile exists and is enabled,
- *                  \li false if the compressor is not valid, the profile
- *                      does not exist, or the profile is disabled
- *
- * @ingroup rohc_comp
- *
- * @see rohc_comp_enable_profile
- * @see rohc_comp_enable_profiles
- * @see rohc_comp_disable_profile
- * @see rohc_comp_disable_profiles
+ * @param profile  The profile selected for the packet
+ * @param packet   The packet to find a compression context for
+ * @return         The context of the packet,
+ *                 NULL if no recently used context matches
  */
-bool rohc_comp_profile_enabled(const struct rohc_comp *const comp,
-                               const rohc_profile_t profile)
+static struct rohc_comp_ctxt *
+	c_recent_ctxts_find(struct rohc_comp *const comp,
+	                    const struct rohc_comp_profile *const profile,
+	                    const struct net_pkt *const packet)
 {
 	size_t i;
 
-	if(comp == NULL)
-	{
-		goto error;
-	}
-
-	/* search the profile location */
-	for(i = 0; i < C_NUM_PROFILES; i++)
+	for(i = 0; i < ROHC_COMP_RECENT_CTXTS_NR && comp->recent_ctxts[i] != NULL; i++)
 	{
-		if(rohc_comp_profiles[i]->id == profile)
+		struct rohc_comp_ctxt *const candidate = comp->recent_ctxts[i];
+
+		/* the destroyed contexts remain in the cache until they are pushed
+		 * out of it, their memory is not released before the compressor */
+		if(candidate->used &&
+		   candidate->profile->id == profile->id &&
+		   candidate->key == packet->key &&
+		   candidate->profile->check_context(candidate, packet))
 		{
-			/* found */
-			break;
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "using recently used context CID = %zu", candidate->cid);
+			return candidate;
 		}
 	}
 
-	if(i == C_NUM_PROFILES)
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "unknown ROHC compression profile (ID = %d)", profile);
-		goto error;
-	}
-
-	/* return profile status */
-	return comp->enabled_profiles[i];
-
-error:
-	return false;
+	return NULL;
 }
 
 
 /**
- * @brief Enable a compression profile for a compressor
- *
- * Enable a compression profiles for a compressor.
- *
- * The ROHC compressor does not use the compression profiles that are not
- * enabled. Thus not enabling a profile might affect compression performances.
- * Compression will fail if no profile at all is enabled.
+ * @brief Move the given context to the front of the most recently used ones
  *
- * If the profile is already enabled, nothing is performed and success is
- * reported.
+ * The least recently used context leaves the cache if the context was not
+ * in it yet.
  *
  * @param comp     The ROHC compressor
- * @param profile  The profile to enable
- * @return         true if the profile exists,
- *                 false if the profile does not exist
- *
- * @ingroup rohc_comp
- *
- * \par Example:
- * \snippet simple_rohc_program.c define ROHC compressor
- * \code
-        ...
-\endcode
- * \snippet simple_rohc_program.c enable ROHC compression profile
- * \code
-        ...
-\endcode
- *
- * @see rohc_comp_enable_profiles
- * @see rohc_comp_disable_profile
- * @see rohc_comp_disable_profiles
+ * @param context  The context that compressed the last packet
  */
-bool rohc_comp_enable_profile(struct rohc_comp *const comp,
-                              const rohc_profile_t profile)
+static void c_recent_ctxts_push(struct rohc_comp *const comp,
+                                struct rohc_comp_ctxt *const context)
 {
 	size_t i;
 
-	if(comp == NULL)
+	for(i = 0; i < (ROHC_COMP_RECENT_CTXTS_NR - 1) &&
+	            comp->recent_ctxts[i] != context; i++)
 	{
-		goto error;
 	}
+	for(; i > 0; i--)
+	{
+		comp->recent_ctxts[i] = comp->recent_ctxts[i - 1];
+	}
+	comp->recent_ctxts[0] = context;
+}
 
-	/* search the profile location */
-	for(i = 0; i < C_NUM_PROFILES; i++)
+
+/**
+ * @brief Create a compression context
+ *
+ * @param comp          The ROHC compressor
+ * @param profile       The profile to associate the context with
+ * @param packet        The packet to create a compression context for
+ * @param arrival_time  The time at which packet was received (0 if unknown,
+ *                      or to disable time-related features in ROHC protocol)
+ * @param priority      The priority class of the flow
+ * @return              The compression context if successful, NULL otherwise
+ */
+static struct rohc_comp_ctxt *
+	c_create_context(struct rohc_comp *const comp,
+	                 const struct rohc_comp_profile *const profile,
+	                 const struct net_pkt *const packet,
+	                 const struct rohc_ts arrival_time,
+	                 const unsigned int priority)
+{
+	struct rohc_comp_ctxt *c;
+	rohc_cid_t cid_to_use;
+
+	assert(comp != NULL);
+	assert(profile != NULL);
+	assert(packet != NULL);
+
+	cid_to_use = comp->min_cid;
+
+	/* if all the contexts in the array are used or if the memory budget is
+	 * exhausted:
+	 *   => recycle the oldest context to make room
+	 * if at least one context in the array is not used:
+	 *   => pick the first unused context
+	 */
+	if(c_ctxts_full(comp))
+	{
+		/* all the contexts in the array were used, recycle the oldest context
+		 * to make some room: the least recently used context is the last one
+		 * of the LRU list, the priority classes may prefer another one */
+		c = c_ctxt_to_recycle(comp);
+		cid_to_use = c->cid;
+
+		/* destroy the oldest context before replacing it with a new one */
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "recycle oldest context (CID = %zu, priority %u)",
+		           cid_to_use, c->priority);
+		c_destroy_context(comp, c);
+		c->key = 0; /* reset context key */
+		rohc_seqlock_write_begin(&comp->stats_seq);
+		comp->ctxts_recycled_nr++;
+		rohc_seqlock_write_end(&comp->stats_seq);
+		rohc_trace_event(comp, ROHC_TRACE_COMP, ROHC_TRACE_EVENT_COMP_CTXT_EVICT,
+		                 c->profile->id, cid_to_use, ROHC_PACKET_UNKNOWN,
+		                 ROHC_TRACE_EVICT_RECYCLED, comp->num_contexts_used, 0);
+	}
+	else
 	{
-		if(rohc_comp_profiles[i]->id == profile)
+		/* there was at least one unused context in the array, pick the first
+		 * unused context in the context array */
+		cid_to_use = c_cid_first_unused(comp);
+
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "take the first unused context (CID = %zu)", cid_to_use);
+
+		/* allocate the context if it was never used before */
+		c = c_alloc_ctxt(comp, cid_to_use);
+		if(c == NULL)
 		{
-			/* found */
-			break;
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to allocate memory for context with CID %zu",
+			             cid_to_use);
+			goto error;
 		}
 	}
 
-	if(i == C_NUM_PROFILES)
+	if(!c_init_context(comp, c, cid_to_use, profile, packet, arrival_time))
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "unknown ROHC compression profile (ID = %d)", profile);
 		goto error;
 	}
+	c->priority = priority;
 
-	/* mark the profile as enabled */
-	comp->enabled_profiles[i] = true;
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	          "ROHC compression profile (ID = %d) enabled", profile);
-
-	return true;
+	return c;
 
 error:
-	return false;
+	return NULL;
 }
 
 
 /**
- * @brief Disable a compression profile for a compressor
- *
- * Disable a compression profile for a compressor.
+ * @brief Initialize a compression context at the given CID
  *
- * The ROHC compressor does not use the compression profiles that were
- * disabled. Thus disabling a profile might affect compression performances.
- * Compression will fail if no profile at all is enabled.
- *
- * If the profile is already disabled, nothing is performed and success is
- * reported.
- *
- * @param comp     The ROHC compressor
- * @param profile  The profile to disable
- * @return         true if the profile exists,
- *                 false if the profile does not exist
- *
- * @ingroup rohc_comp
- *
- * @see rohc_comp_enable_profile
- * @see rohc_comp_enable_profiles
- * @see rohc_comp_disable_profiles
+ * @param comp          The ROHC compressor
+ * @param c             The unused context to initialize
+ * @param cid           The CID of the context
+ * @param profile       The profile to associate the context with
+ * @param packet        The packet to create a compression context for
+ * @param arrival_time  The time at which packet was received (0 if unknown,
+ *                      or to disable time-related features in ROHC protocol)
+ * @return              true if successful, false otherwise
  */
-bool rohc_comp_disable_profile(struct rohc_comp *const comp,
-                               const rohc_profile_t profile)
+static bool c_init_context(struct rohc_comp *const comp,
+                           struct rohc_comp_ctxt *const c,
+                           const rohc_cid_t cid,
+                           const struct rohc_comp_profile *const profile,
+                           const struct net_pkt *const packet,
+                           const struct rohc_ts arrival_time)
 {
-	size_t i;
-
-	if(comp == NULL)
+	/* be sure that the hash index is large enough for one more context */
+	if(!c_ctxt_index_reserve(comp))
 	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "failed to grow the hash index of contexts");
 		goto error;
 	}
 
-	/* search the profile location */
-	for(i = 0; i < C_NUM_PROFILES; i++)
+	/* initialize the previously found context */
+
+	c->ir_count = 0;
+	c->fo_count = 0;
+	c->so_count = 0;
+	c->go_back_fo_count = 0;
+	c->go_back_ir_count = 0;
+	c->latest_used_ms = rohc_time_ms(arrival_time);
+	c->go_back_fo_time = c->latest_used_ms;
+	c->go_back_ir_time = c->latest_used_ms;
+	c->refresh_scale = 0;
+	c->refresh_feedback = false;
+	c->refresh_nack = false;
+
+#if ROHC_COMP_STATS == 1
+	memset(&c->stats, 0, sizeof(struct rohc_comp_ctxt_stats));
+#endif
+
+	c->num_sent_packets = 0;
+	c->store_synced_pkts = UINT64_MAX;
+	c->wlsb_width = comp->wlsb_window_width;
+	c->wlsb_shrink_acks = 0;
+	if(c->last_pkts != NULL)
 	{
-		if(rohc_comp_profiles[i]->id == profile)
-		{
-			/* found */
-			break;
-		}
+		c->last_pkts->pkts_nr = 0;
+		c->last_pkts->next = 0;
 	}
 
-	if(i == C_NUM_PROFILES)
+	c->cid = cid;
+	c->priority = 0;
+	c->closed = false;
+	c->closed_prev = NULL;
+	c->closed_next = NULL;
+	if(!rohc_comp_cid_hdr_build(&c->cid_hdr, c_cid_type(comp), c->cid))
 	{
 		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "unknown ROHC compression profile (ID = %d)", profile);
+		             "failed to encode the CID %zu", c->cid);
 		goto error;
 	}
+	c->profile = profile;
+	c->key = packet->key;
 
-	/* mark the profile as disabled */
-	comp->enabled_profiles[i] = false;
-	rohc_info(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	          "ROHC compression profile (ID = %d) disabled", profile);
+	c->mode = ROHC_U_MODE;
+	c->state = ROHC_COMP_STATE_IR;
+
+	c->compressor = comp;
+
+	/* the new context sends IR packets first, its profile-specific parts keep
+	 * the traces selected by the filter at creation */
+	rohc_trace_filter_select(comp, c->cid, profile->id, ROHC_PACKET_IR,
+	                         true, c->key);
+
+	/* create profile-specific context */
+	if(!profile->create(c, packet))
+	{
+		goto error;
+	}
+
+	/* if creation is successful, mark the context as used */
+	c->used = 1;
+	c_cid_set_used(comp, c->cid);
+	c->first_used = arrival_time.sec;
+	c->latest_used = arrival_time.sec;
+	assert(comp->num_contexts_used <= (comp->medium.max_cid - comp->min_cid));
+	rohc_seqlock_write_begin(&comp->stats_seq);
+	comp->num_contexts_used++;
+	rohc_seqlock_write_end(&comp->stats_seq);
 
+	/* make the new context reachable through the hash index, and record it
+	 * as the most recently used one */
+	c_ctxt_index_add(comp, c);
+	c_ctxt_lru_push(comp, c);
+
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "context (CID = %zu) created (num_used = %zu)",
+	           c->cid, comp->num_contexts_used);
+	rohc_trace_event(comp, ROHC_TRACE_COMP, ROHC_TRACE_EVENT_COMP_CTXT_NEW,
+	                 profile->id, c->cid, ROHC_PACKET_UNKNOWN,
+	                 comp->num_contexts_used, 0, 0);
 	return true;
 
 error:
@@ -1424,194 +7628,168 @@ error:
 
 
 /**
- * @brief Enable several compression profiles for a compressor
- *
- * Enable several compression profiles for a compressor. The list of profiles
- * to enable shall stop with -1.
- *
- * The ROHC compressor does not use the compression profiles that are not
- * enabled. Thus not enabling a profile might affect compression performances.
- * Compression will fail if no profile at all is enabled.
- *
- * If one or more of the profiles are already enabled, nothing is performed
- * and success is reported.
- *
- * @param comp  The ROHC compressor
- * @param ...   The sequence of compression profiles to enable, the sequence
- *              shall be terminated by -1
- * @return      true if all of the profiles exist,
- *              false if at least one of the profiles does not exist
- *
- * @ingroup rohc_comp
- *
- * \par Example:
- * \snippet simple_rohc_program.c define ROHC compressor
- * \code
-        ...
-\endcode
- * \snippet simple_rohc_program.c enable ROHC compression profiles
- * \code
-        ...
-\endcode
+ * @brief Record the headers of the last packet compressed with a context
  *
- * @see rohc_comp_enable_profile
- * @see rohc_comp_disable_profile
- * @see rohc_comp_disable_profiles
+ * @param comp         The ROHC compressor
+ * @param context      The compression context
+ * @param hdrs         The uncompressed headers
+ * @param hdrs_len     The length of the uncompressed headers
+ * @param payload_len  The length of the payload after the headers
  */
-bool rohc_comp_enable_profiles(struct rohc_comp *const comp,
-                               ...)
+static void c_ctxt_record_pkt(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const context,
+                              const uint8_t *const hdrs,
+                              const size_t hdrs_len,
+                              const size_t payload_len)
 {
-	va_list profiles;
-	int profile_id;
-	size_t err_nr = 0;
-	bool is_ok;
+	struct rohc_comp_ckpt_pkts *last_pkts = context->last_pkts;
 
-	if(comp == NULL)
+	/* the records are allocated the first time they are needed, then they
+	 * are kept until the compressor is destroyed */
+	if(last_pkts == NULL)
 	{
-		goto error;
+		last_pkts = rohc_mem_calloc(&comp->mem_ops, 1,
+		                            sizeof(struct rohc_comp_ckpt_pkts));
+		if(last_pkts == NULL)
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "CID %zu: no memory to record the headers", context->cid);
+			return;
+		}
+		context->last_pkts = last_pkts;
+		comp->ctxts_mem_len += sizeof(struct rohc_comp_ckpt_pkts);
 	}
 
-	va_start(profiles, comp);
-
-	while((profile_id = va_arg(profiles, int)) >= 0)
+	if(hdrs_len == 0 || hdrs_len > ROHC_COMP_CKPT_HDRS_MAX ||
+	   payload_len > 0xffff)
 	{
-		is_ok = rohc_comp_enable_profile(comp, profile_id);
-		if(!is_ok)
+		/* the context cannot be saved until enough small packets follow */
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "CID %zu: %zu-byte headers and %zu-byte payload cannot be "
+		           "saved", context->cid, hdrs_len, payload_len);
+		last_pkts->pkts_nr = 0;
+		last_pkts->next = 0;
+	}
+	else
+	{
+		last_pkts->pkts[last_pkts->next].msn =
+			(context->profile->get_msn != NULL ?
+			 context->profile->get_msn(context) : 0);
+		last_pkts->pkts[last_pkts->next].hdrs_len = hdrs_len;
+		last_pkts->pkts[last_pkts->next].payload_len = payload_len;
+		memcpy(last_pkts->pkts[last_pkts->next].hdrs, hdrs, hdrs_len);
+		last_pkts->next = (last_pkts->next + 1) % ROHC_COMP_CKPT_PKTS_NR;
+		if(last_pkts->pkts_nr < ROHC_COMP_CKPT_PKTS_NR)
 		{
-			err_nr++;
+			last_pkts->pkts_nr++;
 		}
 	}
-
-	va_end(profiles);
-
-	return (err_nr == 0);
-
-error:
-	return false;
 }
 
 
 /**
- * @brief Disable several compression profiles for a compressor
- *
- * Disable several compression profiles for a compressor. The list of profiles
- * to disable shall stop with -1.
- *
- * The ROHC compressor does not use the compression profiles that were
- * disabled. Thus disabling a profile might affect compression performances.
- * Compression will fail if no profile at all is enabled.
- *
- * If one or more of the profiles are already disabled, nothing is performed
- * and success is reported.
- *
- * @param comp  The ROHC compressor
- * @param ...   The sequence of compression profiles to disable, the sequence
- *              shall be terminated by -1
- * @return      true if all of the profiles exist,
- *              false if at least one of the profiles does not exist
+ * @brief Save one compression context
  *
- * @ingroup rohc_comp
+ * See \ref rohc_comp_save_contexts for the format of the saved context.
  *
- * @see rohc_comp_enable_profile
- * @see rohc_comp_enable_profiles
- * @see rohc_comp_disable_profile
+ * @param context   The compression context to save
+ * @param[out] rec  The buffer to save the context in, NULL to get the length
+ *                  of the saved context only
+ * @return          The length of the saved context (in bytes),
+ *                  0 if no headers were recorded for the context
  */
-bool rohc_comp_disable_profiles(struct rohc_comp *const comp,
-                                ...)
+static size_t c_save_context(const struct rohc_comp_ctxt *const context,
+                             uint8_t *const rec)
 {
-	va_list profiles;
-	int profile_id;
-	size_t err_nr = 0;
-	bool is_ok;
+	const struct rohc_comp_ckpt_pkts *const last_pkts = context->last_pkts;
+	size_t len;
+	size_t i;
 
-	if(comp == NULL)
+	if(last_pkts == NULL || last_pkts->pkts_nr == 0)
 	{
-		goto error;
+		return 0;
 	}
 
-	va_start(profiles, comp);
+	if(rec != NULL)
+	{
+		rec[0] = (context->cid >> 8) & 0xff;
+		rec[1] = context->cid & 0xff;
+		rec[2] = (context->profile->id >> 8) & 0xff;
+		rec[3] = context->profile->id & 0xff;
+		rec[4] = context->mode;
+		rec[5] = context->state;
+		rec[6] = last_pkts->pkts_nr;
+	}
+	len = ROHC_COMP_CKPT_CTXT_HDR_LEN;
 
-	while((profile_id = va_arg(profiles, int)) >= 0)
+	/* the packets of the context, the oldest one first */
+	for(i = 0; i < last_pkts->pkts_nr; i++)
 	{
-		is_ok = rohc_comp_disable_profile(comp, profile_id);
-		if(!is_ok)
+		const size_t idx = (last_pkts->next + ROHC_COMP_CKPT_PKTS_NR -
+		                    last_pkts->pkts_nr + i) % ROHC_COMP_CKPT_PKTS_NR;
+
+		if(rec != NULL)
 		{
-			err_nr++;
+			uint8_t *const pkt = rec + len;
+			pkt[0] = (last_pkts->pkts[idx].msn >> 8) & 0xff;
+			pkt[1] = last_pkts->pkts[idx].msn & 0xff;
+			pkt[2] = last_pkts->pkts[idx].hdrs_len;
+			pkt[3] = (last_pkts->pkts[idx].payload_len >> 8) & 0xff;
+			pkt[4] = last_pkts->pkts[idx].payload_len & 0xff;
+			memcpy(pkt + ROHC_COMP_CKPT_PKT_HDR_LEN, last_pkts->pkts[idx].hdrs,
+			       last_pkts->pkts[idx].hdrs_len);
 		}
+		len += ROHC_COMP_CKPT_PKT_HDR_LEN + last_pkts->pkts[idx].hdrs_len;
 	}
 
-	va_end(profiles);
-
-	return (err_nr == 0);
-
-error:
-	return false;
+	return len;
 }
 
 
 /**
- * @brief Set the Maximum Reconstructed Reception Unit (MRRU).
- *
- * Set the Maximum Reconstructed Reception Unit (MRRU).
- *
- * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
- * that are parts of the same ROHC packet. In short, the ROHC decompressor
- * does not expect to reassemble ROHC segments whose total length is larger
- * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
- * than the MRRU.
- *
- * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
- * MRRU includes the 32-bit CRC that protects it.
- * If set to 0, segmentation is disabled as no segment headers are allowed
- * on the channel. No segment will be generated.
- *
- * If segmentation is enabled and used by the compressor, the function
- * \ref rohc_comp_get_segment2 can be used to retrieve ROHC segments.
+ * @brief Check the length of one saved compression context and of its packets
  *
- * @param comp  The ROHC compressor
- * @param mrru  The new MRRU value (in bytes)
- * @return      true if the MRRU was successfully set, false otherwise
- *
- * @ingroup rohc_comp
- *
- * \par Example:
- * \snippet test_segment.c define ROHC compressor
- * \code
-        size_t mrru = 500;
-        ...
-\endcode
- * \snippet test_segment.c set compressor MRRU
- * \code
-        ...
-\endcode
- *
- * @see rohc_comp_get_mrru
- * @see rohc_comp_get_segment2
- * @see rohc_decomp_set_mrru
+ * @param rec           The saved context
+ * @param max_len       The number of bytes available for the saved context
+ * @param[out] rec_len  The length of the saved context
+ * @return              true if the saved context is well-formed,
+ *                      false if it is truncated or malformed
  */
-bool rohc_comp_set_mrru(struct rohc_comp *const comp,
-                        const size_t mrru)
+static bool c_check_saved_context(const uint8_t *const rec,
+                                  const size_t max_len,
+                                  size_t *const rec_len)
 {
-	/* compressor must be valid */
-	if(comp == NULL)
+	size_t pkts_nr;
+	size_t len;
+	size_t i;
+
+	if(max_len < ROHC_COMP_CKPT_CTXT_HDR_LEN)
 	{
-		/* cannot print a trace without a valid compressor */
 		goto error;
 	}
-
-	/* new MRRU value must be in range [0, ROHC_MAX_MRRU] */
-	if(mrru > ROHC_MAX_MRRU)
+	pkts_nr = rec[6];
+	if(pkts_nr == 0 || pkts_nr > ROHC_COMP_CKPT_PKTS_NR)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "unexpected MRRU value: must be in range [0, %d]",
-		             ROHC_MAX_MRRU);
 		goto error;
 	}
+	len = ROHC_COMP_CKPT_CTXT_HDR_LEN;
+	for(i = 0; i < pkts_nr; i++)
+	{
+		size_t hdrs_len;
 
-	/* set new MRRU */
-	comp->mrru = mrru;
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "MRRU is now set to %zd", comp->mrru);
+		if((max_len - len) < ROHC_COMP_CKPT_PKT_HDR_LEN)
+		{
+			goto error;
+		}
+		hdrs_len = rec[len + 2];
+		if(hdrs_len == 0 || hdrs_len > ROHC_COMP_CKPT_HDRS_MAX ||
+		   (max_len - len - ROHC_COMP_CKPT_PKT_HDR_LEN) < hdrs_len)
+		{
+			goto error;
+		}
+		len += ROHC_COMP_CKPT_PKT_HDR_LEN + hdrs_len;
+	}
+	*rec_len = len;
 
 	return true;
 
@@ -1621,904 +7799,1078 @@ error:
 
 
 /**
- * @brief Get the Maximum Reconstructed Reception Unit (MRRU).
- *
- * Get the current Maximum Reconstructed Reception Unit (MRRU).
- *
- * The MRRU is the largest cumulative length (in bytes) of the ROHC segments
- * that are parts of the same ROHC packet. In short, the ROHC decompressor
- * does not expect to reassemble ROHC segments whose total length is larger
- * than MRRU. So, the ROHC compressor shall not segment ROHC packets greater
- * than the MRRU.
- *
- * The MRRU value must be in range [0 ; \ref ROHC_MAX_MRRU]. Remember that the
- * MRRU includes the 32-bit CRC that protects it.
- * If MRRU value is 0, segmentation is disabled.
- *
- * If segmentation is enabled and used by the compressor, the function
- * \ref rohc_comp_get_segment2 can be used to retrieve ROHC segments.
- *
- * @param comp       The ROHC compressor
- * @param[out] mrru  The current MRRU value (in bytes)
- * @return           true if MRRU was successfully retrieved, false otherwise
- *
- * @ingroup rohc_comp
- *
- * \par Example:
- * \snippet test_segment.c define ROHC compressor
- * \code
-        size_t mrru;
-        ...
-\endcode
- * \snippet test_non_regression.c get compressor MRRU
- * \code
-        printf("the current MMRU at compressor is %zu bytes\n", mrru);
-        ...
-\endcode
- *
- * @see rohc_comp_set_mrru
- * @see rohc_comp_get_segment2
- * @see rohc_decomp_set_mrru
- * @see rohc_decomp_get_mrru
+ * @brief Restore one saved compression context
+ *
+ * The context is created at the given CID, then the saved packets (the saved
+ * headers followed by a payload of zeroes) are replayed with their saved MSN
+ * and the ROHC packets are dropped: the W-LSB windows, the lists and the
+ * other fields of the context hold the values that were last sent to the
+ * decompressor. The context is then put back in the saved mode and state.
+ *
+ * The saved packets shall have been checked by the caller.
+ *
+ * @param comp         The ROHC compressor
+ * @param cid          The CID of the saved context
+ * @param profile_id   The profile of the saved context
+ * @param mode         The mode of the saved context
+ * @param state        The state of the saved context
+ * @param pkts         The saved packets, the oldest one first
+ * @param pkts_nr      The number of saved packets
+ * @param buf          A buffer of ROHC_COMP_CKPT_BUF_LEN bytes to rebuild
+ *                     the saved packets and to encode them
+ * @return             true if the context was restored, false otherwise
  */
-bool rohc_comp_get_mrru(const struct rohc_comp *const comp,
-                        size_t *const mrru)
+static bool c_restore_context(struct rohc_comp *const comp,
+                              const rohc_cid_t cid,
+                              const rohc_profile_t profile_id,
+                              const rohc_mode_t mode,
+                              const rohc_comp_state_t state,
+                              const uint8_t *const pkts,
+                              const size_t pkts_nr,
+                              uint8_t *const buf)
 {
-	if(comp == NULL || mrru == NULL)
+	const struct rohc_comp_profile *profile;
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	struct rohc_comp_ctxt *c = NULL;
+	const uint8_t *pkt = pkts;
+	size_t i;
+
+	if(cid < comp->min_cid || cid > comp->medium.max_cid)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "cannot restore context with CID %zu: CID out of range "
+		             "[%zu, %zu]", cid, comp->min_cid, comp->medium.max_cid);
+		goto error;
+	}
+	if((mode != ROHC_U_MODE && mode != ROHC_O_MODE) ||
+	   (state != ROHC_COMP_STATE_IR && state != ROHC_COMP_STATE_FO &&
+	    state != ROHC_COMP_STATE_SO))
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "cannot restore context with CID %zu: unsupported mode %d "
+		             "or state %d", cid, mode, state);
+		goto error;
+	}
+	profile = rohc_get_profile_from_id(comp, profile_id);
+	if(profile == NULL)
 	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "cannot restore context with CID %zu: profile 0x%04x is "
+		             "not enabled", cid, profile_id);
 		goto error;
 	}
 
-	*mrru = comp->mrru;
+	for(i = 0; i < pkts_nr; i++)
+	{
+		const uint32_t msn = (pkt[0] << 8) | pkt[1];
+		const size_t hdrs_len = pkt[2];
+		const size_t payload_len = (pkt[3] << 8) | pkt[4];
+		const uint8_t *const hdrs = pkt + ROHC_COMP_CKPT_PKT_HDR_LEN;
+		const size_t pkt_len = hdrs_len + payload_len;
+		struct rohc_buf uncomp_pkt;
+		struct net_pkt ip_pkt;
+		rohc_packet_t packet_type;
+		size_t payload_offset;
+
+		/* rebuild the saved packet: the saved headers, then a payload of
+		 * zeroes, the ROHC packet is written after it */
+		memcpy(buf, hdrs, hdrs_len);
+		memset(buf + hdrs_len, 0, payload_len);
+		uncomp_pkt.data = buf;
+		uncomp_pkt.max_len = pkt_len;
+		uncomp_pkt.offset = 0;
+		uncomp_pkt.len = pkt_len;
+		uncomp_pkt.time = arrival_time;
+		if(!net_pkt_parse(&ip_pkt, uncomp_pkt,
+		                  !!(c_features(comp) & ROHC_COMP_FEATURE_FLOW_KEY),
+		                  comp->trace_callback, comp->trace_callback_priv,
+		                  ROHC_TRACE_COMP))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "cannot restore context with CID %zu: malformed saved "
+			             "packet #%zu", cid, i + 1);
+			goto destroy_ctxt;
+		}
+
+		if(c == NULL)
+		{
+			/* create the context at the saved CID with the oldest packet */
+			if(!profile->check_profile(comp, &ip_pkt))
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "cannot restore context with CID %zu: saved headers "
+				             "do not match profile '%s'", cid,
+				             rohc_get_profile_descr(profile_id));
+				goto error;
+			}
+			c = c_alloc_ctxt(comp, cid);
+			if(c == NULL || c->used)
+			{
+				rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				             "cannot restore context with CID %zu: no memory or "
+				             "CID already in use", cid);
+				goto error;
+			}
+			if(!c_init_context(comp, c, cid, profile, &ip_pkt, arrival_time))
+			{
+				goto error;
+			}
+		}
+		else if(ip_pkt.key != c->key || !profile->check_context(c, &ip_pkt))
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "cannot restore context with CID %zu: saved packet #%zu "
+			             "does not belong to the context", cid, i + 1);
+			goto destroy_ctxt;
+		}
+
+		/* replay the saved packet with its saved MSN */
+		if(profile->set_next_msn != NULL)
+		{
+			profile->set_next_msn(c, msn);
+		}
+		if(profile->encode(c, &ip_pkt, buf + pkt_len, ROHC_COMP_CKPT_ROHC_MAX_LEN,
+		                   &packet_type, &payload_offset) < 0)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "cannot restore context with CID %zu: failed to replay "
+			             "saved packet #%zu", cid, i + 1);
+			goto destroy_ctxt;
+		}
+		c->packet_type = packet_type;
+		c->num_sent_packets++;
+		if((c_features(comp) & ROHC_COMP_FEATURE_CHECKPOINT) != 0)
+		{
+			c_ctxt_record_pkt(comp, c, hdrs, hdrs_len, payload_len);
+		}
+
+		pkt += ROHC_COMP_CKPT_PKT_HDR_LEN + hdrs_len;
+	}
+
+	/* go back to the saved mode and state */
+	c->mode = mode;
+	rohc_comp_change_state(c, state);
+
+	rohc_info(comp, ROHC_TRACE_COMP, profile_id, "context with CID %zu "
+	          "restored in mode %d and state %d from %zu packets", cid, mode,
+	          state, pkts_nr);
+
 	return true;
 
+destroy_ctxt:
+	if(c != NULL)
+	{
+		c_destroy_context(comp, c);
+	}
 error:
 	return false;
 }
 
 
 /**
- * @brief Get the maximal CID value the compressor uses
- *
- * Get the maximal CID value the compressor uses, ie. the \e MAX_CID parameter
- * defined in RFC 3095.
- *
- * @param comp          The ROHC compressor
- * @param[out] max_cid  The current maximal CID value
- * @return              true if MAX_CID was successfully retrieved,
- *                      false otherwise
+ * @brief Find a compression context given an IP packet
  *
- * @ingroup rohc_comp
+ * @param comp             The ROHC compressor
+ * @param packet           The packet to find a compression context for
+ * @param profile_id_hint  If positive, indicate the profile to use
+ * @param arrival_time     The time at which packet was received
+ *                         (0 if unknown, or to disable time-related features
+ *                          in the ROHC protocol)
+ * @return                 The context if found or successfully created,
+ *                         NULL if not found
  */
-bool rohc_comp_get_max_cid(const struct rohc_comp *const comp,
-                           size_t *const max_cid)
+static struct rohc_comp_ctxt *
+	rohc_comp_find_ctxt(struct rohc_comp *const comp,
+	                    const struct net_pkt *const packet,
+	                    const int profile_id_hint,
+	                    const struct rohc_ts arrival_time)
 {
-	if(comp == NULL || max_cid == NULL)
+	const struct rohc_comp_profile *profile;
+	struct rohc_comp_ctxt *context;
+	unsigned int priority = 0;
+	bool is_shared_uncomp = false;
+	size_t slot;
+
+	/* use the suggested profile if any, otherwise find the best profile for
+	 * the packet */
+	if(profile_id_hint < 0)
+	{
+		profile = c_get_profile_from_packet(comp, packet);
+	}
+	else
+	{
+		profile = rohc_get_profile_from_id(comp, profile_id_hint);
+	}
+	if(profile == NULL)
+	{
+		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		             "no profile found for packet, giving up");
+		goto not_found;
+	}
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "using profile '%s' (0x%04x)",
+	           rohc_get_profile_descr(profile->id), profile->id);
+
+	/* get the context using help from the profile we just found: walk the
+	 * probe sequence of the hash index until an empty slot is found, only
+	 * contexts with the right profile and the right key are candidates */
+	context = NULL;
+
+	/* consecutive packets often belong to the same few flows, eg. the
+	 * segments of one TCP GSO packet or the interleaved packets of the RTP
+	 * streams of one call: try the contexts of the previous packets before
+	 * walking the hash index */
+	context = c_recent_ctxts_find(comp, profile, packet);
+	if(context == NULL)
+	{
+		for(slot = c_ctxt_index_hash(comp, profile->id, packet->key);
+		    comp->ctxts_index[slot] != ROHC_COMP_CTXT_INDEX_EMPTY;
+		    slot = (slot + 1) & comp->ctxts_index_mask)
+		{
+			struct rohc_comp_ctxt *const candidate =
+				c_ctxt_at(comp, comp->ctxts_index[slot]);
+
+			assert(candidate->used);
+
+			/* don't look at contexts with the wrong profile or the wrong key */
+			if(candidate->profile->id != profile->id ||
+			   candidate->key != packet->key)
+			{
+				continue;
+			}
+
+			/* ask the profile whether the packet matches the context */
+			if(candidate->profile->check_context(candidate, packet))
+			{
+				rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+				           "using context CID = %zu", candidate->cid);
+				context = candidate;
+				break;
+			}
+		}
+	}
+	if(context == NULL && comp->priority_callback != NULL)
+	{
+		/* new flow: classify it, the flows of low priority class are not worth
+		 * a context of their own, send them through the shared Uncompressed
+		 * context instead */
+		const struct rohc_comp_profile *const uncomp_profile =
+			rohc_get_profile_from_id(comp, ROHC_PROFILE_UNCOMPRESSED);
+
+		priority = comp->priority_callback(packet->data, packet->len,
+		                                   comp->priority_private);
+		if(uncomp_profile != NULL && profile != uncomp_profile &&
+		   (priority < comp->compress_min_priority ||
+		    (c_ctxts_full(comp) && c_ctxt_to_recycle(comp)->priority > priority)))
+		{
+			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "flow of priority %u is not worth a context, send it "
+			           "uncompressed", priority);
+			profile = uncomp_profile;
+			priority = 0;
+			context = comp->shared_uncomp_ctxt;
+			is_shared_uncomp = true;
+		}
+	}
+	if(context == NULL && comp->is_overloaded &&
+	   profile->id != ROHC_PROFILE_UNCOMPRESSED &&
+	   rohc_comp_profile_enabled(comp, ROHC_PROFILE_UNCOMPRESSED))
+	{
+		/* new flow while overloaded: do not spend a context, IR packets and
+		 * change detection on it, send it uncompressed until the overload is
+		 * over */
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "compressor overloaded, send the new flow uncompressed");
+		profile = rohc_get_profile_from_id(comp, ROHC_PROFILE_UNCOMPRESSED);
+		priority = 0;
+		context = comp->shared_uncomp_ctxt;
+		is_shared_uncomp = true;
+		rohc_seqlock_write_begin(&comp->stats_seq);
+		comp->overload_flows_nr++;
+		rohc_seqlock_write_end(&comp->stats_seq);
+	}
+	if(context == NULL)
+	{
+		/* context not found, create a new one */
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "no existing context found for packet, create a new one");
+		context = c_create_context(comp, profile, packet, arrival_time, priority);
+		if(context == NULL)
+		{
+			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			             "failed to create a new context");
+			goto not_found;
+		}
+		if(is_shared_uncomp)
+		{
+			comp->shared_uncomp_ctxt = context;
+		}
+	}
+	else
 	{
-		goto error;
+		/* matching context found */
+		c_ctxt_touch(comp, context, arrival_time);
 	}
 
-	*max_cid = comp->medium.max_cid;
-	return true;
+	return context;
 
-error:
-	return false;
+not_found:
+	return NULL;
 }
 
 
 /**
- * @brief Get the CID type that the compressor uses
- *
- * Get the CID type that the compressor currently uses.
+ * @brief Mark a compression context as used by a new packet
  *
- * @param comp           The ROHC compressor
- * @param[out] cid_type  The current CID type among \ref ROHC_SMALL_CID and
- *                       \ref ROHC_LARGE_CID
- * @return               true if the CID type was successfully retrieved,
- *                       false otherwise
+ * The use timestamp of the context is updated and the context is moved at
+ * the head of the LRU list.
  *
- * @ingroup rohc_comp
+ * @param comp          The ROHC compressor
+ * @param context       The context used by the packet
+ * @param arrival_time  The time at which packet was received
  */
-bool rohc_comp_get_cid_type(const struct rohc_comp *const comp,
-                            rohc_cid_type_t *const cid_type)
+static void c_ctxt_touch(struct rohc_comp *const comp,
+                         struct rohc_comp_ctxt *const context,
+                         const struct rohc_ts arrival_time)
 {
-	if(comp == NULL || cid_type == NULL)
+	context->latest_used = arrival_time.sec;
+	context->latest_used_ms = rohc_time_ms(arrival_time);
+	if(comp->lru_first != context)
 	{
-		goto error;
+		c_ctxt_lru_unlink(comp, context);
+		c_ctxt_lru_push(comp, context);
 	}
-
-	*cid_type = comp->medium.cid_type;
-	return true;
-
-error:
-	return false;
 }
 
 
 /**
- * @brief Enable/disable features for ROHC compressor
- *
- * Enable/disable features for ROHC compressor. Features control whether
- * mechanisms defined as optional by RFCs are enabled or not.
+ * @brief Get the Uncompressed context shared by the flows not compressed
  *
- * Available features are listed by \ref rohc_comp_features_t. They may be
- * combined by XOR'ing them together.
- *
- * @warning Changing the feature set while library is used is not supported
- *
- * @param comp      The ROHC compressor
- * @param features  The feature set to enable/disable
- * @return          true if the feature set was successfully enabled/disabled,
- *                  false if a problem occurred
- *
- * @ingroup rohc_comp
+ * The context is created on first use.
  *
- * @see rohc_comp_features_t
+ * @param comp          The ROHC compressor
+ * @param packet        The packet to send uncompressed
+ * @param arrival_time  The time at which packet was received
+ * @return              The shared Uncompressed context,
+ *                      NULL if it cannot be created
  */
-bool rohc_comp_set_features(struct rohc_comp *const comp,
-                            const rohc_comp_features_t features)
+static struct rohc_comp_ctxt *
+	c_get_shared_uncomp_ctxt(struct rohc_comp *const comp,
+	                         const struct net_pkt *const packet,
+	                         const struct rohc_ts arrival_time)
 {
-	const rohc_comp_features_t all_features =
-		ROHC_COMP_FEATURE_NO_IP_CHECKSUMS |
-		ROHC_COMP_FEATURE_DUMP_PACKETS;
-
-	/* compressor must be valid */
-	if(comp == NULL)
+	if(comp->shared_uncomp_ctxt != NULL)
 	{
-		/* cannot print a trace without a valid compressor */
-		goto error;
+		c_ctxt_touch(comp, comp->shared_uncomp_ctxt, arrival_time);
 	}
-
-	/* reject unsupported features */
-	if((features & all_features) != features)
+	else
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "feature set 0x%x is not supported (supported features "
-		             "set is 0x%x)", features, all_features);
-		goto error;
-	}
-
-	/* record new feature set */
-	comp->features = features;
+		const struct rohc_comp_profile *const uncomp_profile =
+			rohc_get_profile_from_id(comp, ROHC_PROFILE_UNCOMPRESSED);
 
-	return true;
+		assert(uncomp_profile != NULL);
+		comp->shared_uncomp_ctxt =
+			c_create_context(comp, uncomp_profile, packet, arrival_time, 0);
+	}
 
-error:
-	return false;
+	return comp->shared_uncomp_ctxt;
 }
 
 
 /**
- * @brief Deliver a feedback packet to the compressor
+ * @brief Whether the IR budget of the current interval is not spent yet
  *
- * When feedback is received by the decompressor, this function is called and
- * delivers the feedback to the right profile/context of the compressor.
+ * See \ref rohc_comp_set_ir_pacing. A new interval starts with a full budget
+ * once the current one is over.
  *
- * @param comp   The ROHC compressor
- * @param packet The feedback data
- * @param size   The length of the feedback packet
- * @return       true if the feedback was successfully taken into account,
- *               false if the feedback could not be taken into account
+ * @param comp          The ROHC compressor
+ * @param arrival_time  The time at which packet was received
+ * @return              true if one more IR packet may be sent,
+ *                      false if the context shall wait for the next interval
  */
-static bool __rohc_comp_deliver_feedback(struct rohc_comp *const comp,
-                                         const uint8_t *const packet,
-                                         const size_t size)
+static bool c_ir_pacing_allows(struct rohc_comp *const comp,
+                               const struct rohc_ts arrival_time)
 {
-	struct rohc_comp_ctxt *context;
-	const uint8_t *remain_data = packet;
-	size_t remain_len = size;
-	enum rohc_feedback_type feedback_type;
-	rohc_cid_t cid;
-	size_t cid_len;
-
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "deliver %zu byte(s) of feedback to the right context", size);
-
-	/* extract the CID from feedback */
-	if(!rohc_comp_feedback_parse_cid(comp, remain_data, remain_len, &cid, &cid_len))
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to deliver feedback: failed to extract CID from "
-		             "feedback");
-		goto error;
-	}
-	remain_data += cid_len;
-	remain_len -= cid_len;
-
-	/* find context */
-	context = c_get_context(comp, cid);
-	if(context == NULL)
-	{
-		/* context was not found */
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to deliver feedback: context with CID = %zu not found",
-		             cid);
-		goto error;
-	}
-	assert(context->cid == cid);
-	assert(context->used == 1);
-
-	/* FEEDBACK-1 or FEEDBACK-2 ? */
-	if(remain_len == 0)
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to deliver feedback: empty feedback data");
-		goto error;
-	}
-	else if(remain_len == 1)
-	{
-		feedback_type = ROHC_FEEDBACK_1;
-	}
-	else
-	{
-		feedback_type = ROHC_FEEDBACK_2;
-	}
+	const uint32_t now = rohc_time_ms(arrival_time);
 
-	/* deliver feedback to profile with the context */
-	if(!context->profile->feedback(context, feedback_type, packet, size,
-	                               remain_data, remain_len))
+	if((uint32_t) (now - comp->ir_pacing_start) >= comp->ir_pacing_interval)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to deliver feedback: failed to handle FEEDBACK-%d",
-		             feedback_type);
-		goto error;
+		comp->ir_pacing_start = now;
+		comp->ir_pacing_left = comp->ir_pacing_budget;
 	}
 
-	/* everything went fine */
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "FEEDBACK-%d data successfully handled", feedback_type);
-
-	return true;
-
-error:
-	return false;
+	return (comp->ir_pacing_left > 0);
 }
 
 
 /**
- * @brief Deliver a feedback packet to the compressor
- *
- * When feedback data is received by a decompressor, this function may be
- * called to deliver the feedback data to the corresponding profile/context
- * on the same-side associated compressor.
+ * @brief Enable or drop the text traces depending on the given context
  *
- * @param comp      The ROHC compressor
- * @param feedback  The feedback data
- * @return          true if the feedback was successfully taken into account,
- *                  false if the feedback could not be taken into account
+ * See \ref rohc_comp_trace_filter_add_cid. The packet type of the context is
+ * the type of the last ROHC packet it built.
  *
- * @ingroup rohc_comp
+ * @param comp     The ROHC compressor
+ * @param context  The context that handles the packet or the feedback
  */
-bool rohc_comp_deliver_feedback2(struct rohc_comp *const comp,
-                                 const struct rohc_buf feedback)
+static void c_trace_filter_select(struct rohc_comp *const comp,
+                                  const struct rohc_comp_ctxt *const context)
 {
-	struct rohc_buf remain_data = feedback;
-	size_t feedbacks_nr = 0;
-	size_t nr_failures = 0;
+	rohc_trace_filter_select(comp, context->cid, context->profile->id,
+	                         (context->num_sent_packets > 0 ?
+	                          context->packet_type : ROHC_PACKET_IR),
+	                         true, context->key);
+}
 
-	/* sanity checks */
-	if(comp == NULL)
-	{
-		goto error;
-	}
-	if(rohc_buf_is_malformed(remain_data))
-	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "failed to deliver feedback: feedback is malformed");
-		goto error;
-	}
 
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "deliver %zu byte(s) of feedback to the right context",
-	           remain_data.len);
+/**
+ * @brief Find out a context given its CID
+ *
+ * @param comp The ROHC compressor
+ * @param cid  The CID of the context to find
+ * @return     The context with the given CID if found, NULL otherwise
+ */
+static struct rohc_comp_ctxt *
+	c_get_context(struct rohc_comp *const comp, const rohc_cid_t cid)
+{
+	const struct rohc_comp_ctxt *page;
 
-	/* there is nothing for compressor if feedback contains no byte at all */
-	if(rohc_buf_is_empty(remain_data))
+	/* the CID must not be larger than the context array */
+	if(cid > comp->medium.max_cid)
 	{
-		goto ignore;
+		goto not_found;
 	}
 
-	/* parse as much feedback data as possible */
-	while(remain_data.len > 0 &&
-	      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+	/* the context with the given CID must be allocated and in use */
+	page = comp->ctxt_pages[cid / ROHC_COMP_CTXT_PAGE_LEN];
+	if(page == NULL || page[cid % ROHC_COMP_CTXT_PAGE_LEN].used == 0)
 	{
-		size_t feedback_hdr_len;
-		size_t feedback_data_len;
-		size_t feedback_len;
-
-		feedbacks_nr++;
-
-		if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
-		                           &feedback_data_len))
-		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "failed to parse a feedback item");
-			goto error;
-		}
-		feedback_len = feedback_hdr_len + feedback_data_len;
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "feedback found (header = %zu bytes, data = %zu bytes)",
-		           feedback_hdr_len, feedback_data_len);
-
-		/* reject feedback item if it doesn't fit in the available data */
-		if(feedback_len > remain_data.len)
-		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "the %zu-byte feedback is too large for the %zu-byte "
-			             "remaining ROHC data", feedback_len, remain_data.len);
-			goto error;
-		}
-
-		/* skip the feedback header */
-		rohc_buf_pull(&remain_data, feedback_hdr_len);
-
-		/* deliver the feedback data to the compressor */
-		if(!__rohc_comp_deliver_feedback(comp, rohc_buf_data(remain_data),
-		                                 feedback_data_len))
-		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "failed to deliver feedback item #%zu", feedbacks_nr);
-			nr_failures++;
-		}
-
-		/* skip the feedback data */
-		rohc_buf_pull(&remain_data, feedback_data_len);
+		goto not_found;
 	}
 
-	return (nr_failures == 0);
-
-ignore:
-	return true;
+	return c_ctxt_at(comp, cid);
 
-error:
-	return false;
+not_found:
+	return NULL;
 }
 
 
 /**
- * @brief Get some information about the last compressed packet
- *
- * Get some information about the last compressed packet.
- *
- * To use the function, call it with a pointer on a pre-allocated
- * \ref rohc_comp_last_packet_info2_t structure with the \e version_major and
- * \e version_minor fields set to one of the following supported versions:
- *  - Major 0, minor 0
- *
- * See the \ref rohc_comp_last_packet_info2_t structure for details about
- * fields that are supported in the above versions.
- *
- * @param comp          The ROHC compressor to get information from
- * @param[in,out] info  The structure where information will be stored
- * @return              true in case of success, false otherwise
+ * @brief Get the compression context with the given CID
  *
- * @ingroup rohc_comp
+ * The page of the context shall be already allocated.
  *
- * @see rohc_comp_last_packet_info2_t
+ * @param comp  The ROHC compressor
+ * @param cid   The CID of the context
+ * @return      The context with the given CID
  */
-bool rohc_comp_get_last_packet_info2(const struct rohc_comp *const comp,
-                                     rohc_comp_last_packet_info2_t *const info)
+static inline struct rohc_comp_ctxt *
+	c_ctxt_at(const struct rohc_comp *const comp, const rohc_cid_t cid)
 {
-	if(comp == NULL)
-	{
-		goto error;
-	}
+	assert(cid <= comp->medium.max_cid);
+	assert(comp->ctxt_pages[cid / ROHC_COMP_CTXT_PAGE_LEN] != NULL);
 
-	if(comp->last_context == NULL)
-	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "last context found in compressor is not valid");
-		goto error;
-	}
+	return &(comp->ctxt_pages[cid / ROHC_COMP_CTXT_PAGE_LEN][cid % ROHC_COMP_CTXT_PAGE_LEN]);
+}
+
+
+/**
+ * @brief Get the compression context with the given CID, allocate it if needed
+ *
+ * Compression contexts are allocated by pages of ROHC_COMP_CTXT_PAGE_LEN
+ * contexts the first time one CID of the page is used. Pages are allocated
+ * from the slab of contexts, so with the functions given to
+ * \ref rohc_comp_set_alloc_cbs if any. Pages are never freed
+ * before the compressor is destroyed, so contexts never move in memory.
+ *
+ * @param comp  The ROHC compressor
+ * @param cid   The CID of the context
+ * @return      The context with the given CID, NULL if memory is missing
+ */
+static struct rohc_comp_ctxt *
+	c_alloc_ctxt(struct rohc_comp *const comp, const rohc_cid_t cid)
+{
+	const size_t page_idx = cid / ROHC_COMP_CTXT_PAGE_LEN;
 
-	if(info == NULL)
-	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "structure for last packet information is not valid");
-		goto error;
-	}
+	assert(cid <= comp->medium.max_cid);
 
-	/* check compatibility version */
-	if(info->version_major == 0)
+	if(comp->ctxt_pages[page_idx] == NULL)
 	{
-		/* base fields for major version 0 */
-		info->context_id = comp->last_context->cid;
-		info->is_context_init = (comp->last_context->num_sent_packets == 1);
-		info->context_mode = comp->last_context->mode;
-		info->context_state = comp->last_context->state;
-		info->context_used = (comp->last_context->used ? true : false);
-		info->profile_id = comp->last_context->profile->id;
-		info->packet_type = comp->last_context->packet_type;
-		info->total_last_uncomp_size = comp->last_context->total_last_uncompressed_size;
-		info->header_last_uncomp_size = comp->last_context->header_last_uncompressed_size;
-		info->total_last_comp_size = comp->last_context->total_last_compressed_size;
-		info->header_last_comp_size = comp->last_context->header_last_compressed_size;
-
-		/* new fields added by minor versions */
-		if(info->version_minor > 0)
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "allocate page #%zu of %u contexts for CID %zu", page_idx,
+		           ROHC_COMP_CTXT_PAGE_LEN, cid);
+		comp->ctxt_pages[page_idx] =
+			rohc_slab_alloc(comp->ctxt_slab,
+			                ROHC_COMP_CTXT_PAGE_LEN * sizeof(struct rohc_comp_ctxt));
+		if(comp->ctxt_pages[page_idx] == NULL)
 		{
-			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "unsupported minor version (%u) of the structure for "
-			           "last packet information", info->version_minor);
 			goto error;
 		}
-	}
-	else
-	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "unsupported major version (%u) of the structure for last "
-		           "packet information", info->version_major);
-		goto error;
+		memset(comp->ctxt_pages[page_idx], 0,
+		       ROHC_COMP_CTXT_PAGE_LEN * sizeof(struct rohc_comp_ctxt));
 	}
 
-	return true;
+	return c_ctxt_at(comp, cid);
 
 error:
-	return false;
+	return NULL;
 }
 
 
 /**
- * @brief Get some general information about the compressor
- *
- * Get some general information about the compressor.
- *
- * To use the function, call it with a pointer on a pre-allocated
- * \ref rohc_comp_general_info_t structure with the \e version_major and
- * \e version_minor fields set to one of the following supported versions:
- *  - Major 0, minor 0
- *
- * See the \ref rohc_comp_general_info_t structure for details about fields
- * that are supported in the above versions.
- *
- * @param comp          The ROHC compressor to get information from
- * @param[in,out] info  The structure where information will be stored
- * @return              true in case of success, false otherwise
+ * @brief Destroy one compression context
  *
- * @ingroup rohc_comp
+ * The profile-specific part of the context is destroyed, the context is
+ * removed from the hash index and it is marked as unused.
  *
- * @see rohc_comp_general_info_t
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to destroy
  */
-bool rohc_comp_get_general_info(const struct rohc_comp *const comp,
-                                rohc_comp_general_info_t *const info)
+static void c_destroy_context(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const context)
 {
-	if(comp == NULL)
-	{
-		goto error;
-	}
-
-	if(info == NULL)
+	assert(context->used);
+
+	c_ctxt_index_remove(comp, context);
+	c_ctxt_lru_unlink(comp, context);
+	c_ctxt_closed_unlink(comp, context);
+	context->profile->destroy(context);
+	context->used = 0;
+	c_cid_set_unused(comp, context->cid);
+	if(comp->shared_uncomp_ctxt == context)
 	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "structure for general information is not valid");
-		goto error;
+		comp->shared_uncomp_ctxt = NULL;
 	}
-
-	/* check compatibility version */
-	if(info->version_major == 0)
+	if(context->profile->id == ROHC_PROFILE_UNCOMPRESSED)
 	{
-		/* base fields for major version 0 */
-		info->contexts_nr = comp->num_contexts_used;
-		info->packets_nr = comp->num_packets;
-		info->uncomp_bytes_nr = comp->total_uncompressed_size;
-		info->comp_bytes_nr = comp->total_compressed_size;
-
-		/* new fields added by minor versions */
-		if(info->version_minor > 0)
+		/* the flow is probed again once its Uncompressed context is gone */
+		struct rohc_comp_uncomp_flow *const flow =
+			&comp->uncomp_flows[c_uncomp_cache_slot(context->key)];
+		if(flow->used && flow->key == context->key)
 		{
-			rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "unsupported minor version (%u) of the structure for "
-			           "general information", info->version_minor);
-			goto error;
+			flow->used = false;
 		}
 	}
-	else
+	assert(comp->num_contexts_used > 0);
+	rohc_seqlock_write_begin(&comp->stats_seq);
+	comp->num_contexts_used--;
+	if(comp->last_context == context)
 	{
-		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "unsupported major version (%u) of the structure for "
-		           "general information", info->version_major);
-		goto error;
+		comp->last_pkt_info.context_used = false;
 	}
-
-	return true;
-
-error:
-	return false;
+	rohc_seqlock_write_end(&comp->stats_seq);
 }
 
 
 /**
- * @brief Give a description for the given ROHC compression context state
- *
- * Give a description for the given ROHC compression context state.
- *
- * The descriptions are not part of the API. They may change between
- * releases without any warning. Do NOT use them for other means that
- * providing to users a textual description of compression context states
- * used by the library. If unsure, ask on the mailing list.
- *
- * @param state  The compression context state to get a description for
- * @return       A string that describes the given compression context state
+ * @brief Mark the given CID as used in the bitmap of the used CIDs
  *
- * @ingroup rohc_comp
+ * @param comp  The ROHC compressor
+ * @param cid   The CID of the context now in use
  */
-const char * rohc_comp_get_state_descr(const rohc_comp_state_t state)
+static void c_cid_set_used(struct rohc_comp *const comp, const rohc_cid_t cid)
 {
-	switch(state)
+	const size_t word = cid / ROHC_COMP_CIDS_WORD_LEN;
+
+	assert(word < comp->cids_words_nr);
+	comp->cids_used[word] |= (UINT64_C(1) << (cid % ROHC_COMP_CIDS_WORD_LEN));
+	if(comp->cids_used[word] == UINT64_MAX)
 	{
-		case ROHC_COMP_STATE_IR:
-			return "IR";
-		case ROHC_COMP_STATE_FO:
-			return "FO";
-		case ROHC_COMP_STATE_SO:
-			return "SO";
-		case ROHC_COMP_STATE_UNKNOWN:
-		default:
-			return "no description";
+		comp->cids_full[word / ROHC_COMP_CIDS_WORD_LEN] |=
+			(UINT64_C(1) << (word % ROHC_COMP_CIDS_WORD_LEN));
 	}
 }
 
 
-/*
- * Definitions of private functions
+/**
+ * @brief Mark the given CID as unused in the bitmap of the used CIDs
+ *
+ * @param comp  The ROHC compressor
+ * @param cid   The CID of the context not in use anymore
  */
+static void c_cid_set_unused(struct rohc_comp *const comp, const rohc_cid_t cid)
+{
+	const size_t word = cid / ROHC_COMP_CIDS_WORD_LEN;
+
+	assert(word < comp->cids_words_nr);
+	comp->cids_used[word] &= ~(UINT64_C(1) << (cid % ROHC_COMP_CIDS_WORD_LEN));
+	comp->cids_full[word / ROHC_COMP_CIDS_WORD_LEN] &=
+		~(UINT64_C(1) << (word % ROHC_COMP_CIDS_WORD_LEN));
+}
 
 
 /**
- * @brief Find out a ROHC profile given a profile ID
+ * @brief Find the smallest unused CID of the compressor
  *
- * @param comp       The ROHC compressor
- * @param profile_id The ID of the ROHC profile to find out
- * @return           The ROHC profile if found, NULL otherwise
+ * The summary of the bitmap of the used CIDs gives the first word of the
+ * bitmap with one unused CID, so the search does not depend on the number
+ * of contexts in use. At least one CID in [MIN_CID, MAX_CID] shall be
+ * unused.
+ *
+ * @param comp  The ROHC compressor
+ * @return      The smallest unused CID greater than or equal to MIN_CID
  */
-static const struct rohc_comp_profile *
-	rohc_get_profile_from_id(const struct rohc_comp *comp,
-	                         const rohc_profile_t profile_id)
+static rohc_cid_t c_cid_first_unused(const struct rohc_comp *const comp)
 {
-	size_t i;
+	size_t word = comp->min_cid / ROHC_COMP_CIDS_WORD_LEN;
+	uint64_t used;
 
-	/* test all compression profiles */
-	for(i = 0; i < C_NUM_PROFILES; i++)
+	/* the CIDs below MIN_CID in its word count as used */
+	used = comp->cids_used[word] |
+	       ((UINT64_C(1) << (comp->min_cid % ROHC_COMP_CIDS_WORD_LEN)) - 1);
+	if(used == UINT64_MAX)
 	{
-		/* if the profile IDs match and the profile is enabled */
-		if(rohc_comp_profiles[i]->id == profile_id && comp->enabled_profiles[i])
+		/* the summary gives the first word after that one with one unused CID,
+		 * the words up to that one count as full */
+		size_t i;
+		uint64_t full;
+
+		word++;
+		i = word / ROHC_COMP_CIDS_WORD_LEN;
+		full = comp->cids_full[i] |
+		       ((UINT64_C(1) << (word % ROHC_COMP_CIDS_WORD_LEN)) - 1);
+		while(full == UINT64_MAX)
 		{
-			return rohc_comp_profiles[i];
+			i++;
+			assert(i < ROHC_COMP_CIDS_SUMMARY_LEN);
+			full = comp->cids_full[i];
 		}
+		word = i * ROHC_COMP_CIDS_WORD_LEN + __builtin_ctzll(~full);
+		assert(word < comp->cids_words_nr);
+		used = comp->cids_used[word];
 	}
 
-	return NULL;
+	return (word * ROHC_COMP_CIDS_WORD_LEN + __builtin_ctzll(~used));
 }
 
 
 /**
- * @brief Find out a ROHC profile given an IP protocol ID
+ * @brief Hash the key and the profile of a context for the index of contexts
  *
- * @param comp    The ROHC compressor
- * @param packet  The packet to find a compression profile for
- * @return        The ROHC profile if found, NULL otherwise
+ * @param profile_id  The ID of the profile of the context
+ * @param key         The key of the context
+ * @return            The hash, not reduced to the size of the index yet
  */
-static const struct rohc_comp_profile *
-	c_get_profile_from_packet(const struct rohc_comp *const comp,
-	                          const struct net_pkt *const packet)
+static uint32_t c_ctxt_index_mix(const rohc_profile_t profile_id,
+                                 const rohc_ctxt_key_t key)
 {
-	size_t i;
-
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "try to find the best profile for packet with transport "
-	           "protocol %u", packet->transport->proto);
-
-	/* test all compression profiles */
-	for(i = 0; i < C_NUM_PROFILES; i++)
-	{
-		bool check_profile;
+	uint32_t hash = key ^ (((uint32_t) profile_id) * 0x9e3779b1U);
 
-		/* skip profile if the profile is not enabled */
-		if(!comp->enabled_profiles[i])
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "skip disabled profile '%s' (0x%04x)",
-			           rohc_get_profile_descr(rohc_comp_profiles[i]->id),
-			           rohc_comp_profiles[i]->id);
-			continue;
-		}
+	/* final mix of the 32-bit MurmurHash3: hash bits influence the slot
+	 * more than the few low bits that differ between two flows */
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bU;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35U;
+	hash ^= hash >> 16;
 
-		/* does the profile accept the packet? */
-		check_profile = rohc_comp_profiles[i]->check_profile(comp, packet);
-		if(!check_profile)
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "skip profile '%s' (0x%04x) because it does not match "
-			           "packet",rohc_get_profile_descr(rohc_comp_profiles[i]->id),
-			           rohc_comp_profiles[i]->id);
-			continue;
-		}
+	return hash;
+}
 
-		/* the packet is compatible with the profile, let's go with it! */
-		return rohc_comp_profiles[i];
-	}
 
-	return NULL;
+/**
+ * @brief Hash the keys and the profiles of one group of packets of a burst
+ *
+ * Same hash as \ref c_ctxt_index_mix, computed on all the lanes of a vector
+ * at once: the compiler maps the vector on the SIMD registers of the target
+ * if any (SSE2/AVX2, NEON...), or on scalar operations otherwise, eg. in the
+ * Linux kernel where the SIMD registers are not available.
+ *
+ * @param profile_ids  The IDs of the profiles of the packets
+ * @param keys         The keys of the flows of the packets
+ * @param[out] hashes  The hashes, not reduced to the size of the index yet
+ */
+static void c_ctxt_index_mix_group(const uint32_t profile_ids[ROHC_COMP_BURST_GROUP],
+                                   const rohc_ctxt_key_t keys[ROHC_COMP_BURST_GROUP],
+                                   uint32_t hashes[ROHC_COMP_BURST_GROUP])
+{
+	typedef uint32_t c_hash_vec_t
+		__attribute__((vector_size(ROHC_COMP_BURST_GROUP * sizeof(uint32_t))));
+	c_hash_vec_t profiles;
+	c_hash_vec_t hash;
+
+	memcpy(&profiles, profile_ids, sizeof(c_hash_vec_t));
+	memcpy(&hash, keys, sizeof(c_hash_vec_t));
+
+	hash ^= profiles * 0x9e3779b1U;
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6bU;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35U;
+	hash ^= hash >> 16;
+
+	memcpy(hashes, &hash, sizeof(c_hash_vec_t));
 }
 
 
 /**
- * @brief Create a compression context
+ * @brief Compute the home slot of a context in the hash index of contexts
  *
- * @param comp          The ROHC compressor
- * @param profile       The profile to associate the context with
- * @param packet        The packet to create a compression context for
- * @param arrival_time  The time at which packet was received (0 if unknown,
- *                      or to disable time-related features in ROHC protocol)
- * @return              The compression context if successful, NULL otherwise
+ * @param comp        The ROHC compressor
+ * @param profile_id  The ID of the profile of the context
+ * @param key         The key of the context
+ * @return            The home slot in the index, in [0, mask]
  */
-static struct rohc_comp_ctxt *
-	c_create_context(struct rohc_comp *const comp,
-	                 const struct rohc_comp_profile *const profile,
-	                 const struct net_pkt *const packet,
-	                 const struct rohc_ts arrival_time)
+static size_t c_ctxt_index_hash(const struct rohc_comp *const comp,
+                                const rohc_profile_t profile_id,
+                                const rohc_ctxt_key_t key)
 {
-	struct rohc_comp_ctxt *c;
-	rohc_cid_t cid_to_use;
+	return (c_ctxt_index_mix(profile_id, key) & comp->ctxts_index_mask);
+}
 
-	assert(comp != NULL);
-	assert(profile != NULL);
-	assert(packet != NULL);
 
-	cid_to_use = 0;
+/**
+ * @brief Be sure that the hash index of contexts may store one more context
+ *
+ * The index starts small and is doubled every time its load factor would
+ * exceed 50%. All the contexts in use are then added again in the new index.
+ *
+ * @param comp  The ROHC compressor
+ * @return      true if the index is large enough, false if memory is missing
+ */
+static bool c_ctxt_index_reserve(struct rohc_comp *const comp)
+{
+	const size_t slots_nr = comp->ctxts_index_mask + 1;
+	const struct rohc_comp_ctxt *context;
+	rohc_cid_t *new_index;
+	size_t new_slots_nr;
+	size_t i;
 
-	/* if all the contexts in the array are used:
-	 *   => recycle the oldest context to make room
-	 * if at least one context in the array is not used:
-	 *   => pick the first unused context
-	 */
-	if(comp->num_contexts_used > comp->medium.max_cid)
+	if((2 * (comp->num_contexts_used + 1)) <= slots_nr)
 	{
-		/* all the contexts in the array were used, recycle the oldest context
-		 * to make some room */
-
-		uint64_t oldest;
-		rohc_cid_t i;
-
-		/* find the oldest context */
-		oldest = 0xffffffff;
-		for(i = 0; i <= comp->medium.max_cid; i++)
-		{
-			if(comp->contexts[i].latest_used < oldest)
-			{
-				oldest = comp->contexts[i].latest_used;
-				cid_to_use = i;
-			}
-		}
+		return true;
+	}
 
-		/* destroy the oldest context before replacing it with a new one */
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "recycle oldest context (CID = %zu)", cid_to_use);
-		comp->contexts[cid_to_use].profile->destroy(&comp->contexts[cid_to_use]);
-		comp->contexts[cid_to_use].key = 0; /* reset context key */
-		comp->contexts[cid_to_use].used = 0;
-		assert(comp->num_contexts_used > 0);
-		comp->num_contexts_used--;
+	/* allocate a twice larger index */
+	new_slots_nr = slots_nr * 2;
+	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+	           "grow the hash index of contexts from %zu to %zu slots",
+	           slots_nr, new_slots_nr);
+	new_index = rohc_mem_alloc(&comp->mem_ops, new_slots_nr * sizeof(rohc_cid_t));
+	if(new_index == NULL)
+	{
+		goto error;
 	}
-	else
+	for(i = 0; i < new_slots_nr; i++)
 	{
-		/* there was at least one unused context in the array, pick the first
-		 * unused context in the context array */
-
-		rohc_cid_t i;
-
-		/* find the first unused context */
-		for(i = 0; i <= comp->medium.max_cid; i++)
-		{
-			if(comp->contexts[i].used == 0)
-			{
-				cid_to_use = i;
-				break;
-			}
-		}
+		new_index[i] = ROHC_COMP_CTXT_INDEX_EMPTY;
+	}
+	rohc_mem_free(&comp->mem_ops, comp->ctxts_index);
+	comp->ctxts_index = new_index;
+	comp->ctxts_index_mask = new_slots_nr - 1;
 
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "take the first unused context (CID = %zu)", cid_to_use);
+	/* index again all the contexts in use, they are all in the LRU list */
+	for(context = comp->lru_first; context != NULL; context = context->lru_next)
+	{
+		c_ctxt_index_add(comp, context);
 	}
 
-	/* initialize the previously found context */
-	c = &comp->contexts[cid_to_use];
+	return true;
 
-	c->ir_count = 0;
-	c->fo_count = 0;
-	c->so_count = 0;
-	c->go_back_fo_count = 0;
-	c->go_back_ir_count = 0;
+error:
+	return false;
+}
 
-	c->total_uncompressed_size = 0;
-	c->total_compressed_size = 0;
-	c->header_uncompressed_size = 0;
-	c->header_compressed_size = 0;
 
-	c->total_last_uncompressed_size = 0;
-	c->total_last_compressed_size = 0;
-	c->header_last_uncompressed_size = 0;
-	c->header_last_compressed_size = 0;
+/**
+ * @brief Add one compression context in the hash index of contexts
+ *
+ * Linear probing is used: the context is stored in the first empty slot
+ * that follows its home slot. Room shall have been reserved in the index
+ * with \ref c_ctxt_index_reserve before.
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to add in the index
+ */
+static void c_ctxt_index_add(struct rohc_comp *const comp,
+                             const struct rohc_comp_ctxt *const context)
+{
+	size_t slot = c_ctxt_index_hash(comp, context->profile->id, context->key);
 
-	c->num_sent_packets = 0;
+	while(comp->ctxts_index[slot] != ROHC_COMP_CTXT_INDEX_EMPTY)
+	{
+		assert(comp->ctxts_index[slot] != context->cid);
+		slot = (slot + 1) & comp->ctxts_index_mask;
+	}
+	comp->ctxts_index[slot] = context->cid;
+}
 
-	c->cid = cid_to_use;
-	c->profile = profile;
-	c->key = packet->key;
 
-	c->mode = ROHC_U_MODE;
-	c->state = ROHC_COMP_STATE_IR;
+/**
+ * @brief Remove one compression context from the hash index of contexts
+ *
+ * Backward-shift deletion is used instead of tombstones: the contexts that
+ * follow the removed one in the same probe sequence are moved back, so that
+ * lookups may always stop at the first empty slot.
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to remove from the index
+ */
+static void c_ctxt_index_remove(struct rohc_comp *const comp,
+                                const struct rohc_comp_ctxt *const context)
+{
+	const size_t mask = comp->ctxts_index_mask;
+	size_t hole;
+	size_t slot;
 
-	c->compressor = comp;
+	/* find the slot of the context */
+	hole = c_ctxt_index_hash(comp, context->profile->id, context->key);
+	while(comp->ctxts_index[hole] != context->cid)
+	{
+		assert(comp->ctxts_index[hole] != ROHC_COMP_CTXT_INDEX_EMPTY);
+		hole = (hole + 1) & mask;
+	}
 
-	/* create profile-specific context */
-	if(!profile->create(c, packet))
+	/* fill the hole with the next entries of the probe sequence */
+	for(slot = (hole + 1) & mask;
+	    comp->ctxts_index[slot] != ROHC_COMP_CTXT_INDEX_EMPTY;
+	    slot = (slot + 1) & mask)
 	{
-		return NULL;
+		const struct rohc_comp_ctxt *const moved =
+			c_ctxt_at(comp, comp->ctxts_index[slot]);
+		const size_t home = c_ctxt_index_hash(comp, moved->profile->id,
+		                                      moved->key);
+
+		/* the entry may be moved into the hole only if its home slot is not
+		 * located (cyclically) between the hole and its current slot */
+		if(((slot - home) & mask) >= ((slot - hole) & mask))
+		{
+			comp->ctxts_index[hole] = comp->ctxts_index[slot];
+			hole = slot;
+		}
 	}
+	comp->ctxts_index[hole] = ROHC_COMP_CTXT_INDEX_EMPTY;
+}
 
-	/* if creation is successful, mark the context as used */
-	c->used = 1;
-	c->first_used = arrival_time.sec;
-	c->latest_used = arrival_time.sec;
-	assert(comp->num_contexts_used <= comp->medium.max_cid);
-	comp->num_contexts_used++;
 
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "context (CID = %zu) created (num_used = %zu)",
-	           c->cid, comp->num_contexts_used);
-	return c;
+/**
+ * @brief Insert one compression context at the head of the LRU list
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context that was just used
+ */
+static void c_ctxt_lru_push(struct rohc_comp *const comp,
+                            struct rohc_comp_ctxt *const context)
+{
+	context->lru_prev = NULL;
+	context->lru_next = comp->lru_first;
+	if(comp->lru_first != NULL)
+	{
+		comp->lru_first->lru_prev = context;
+	}
+	else
+	{
+		comp->lru_last = context;
+	}
+	comp->lru_first = context;
 }
 
 
 /**
- * @brief Find a compression context given an IP packet
+ * @brief Remove one compression context from the LRU list
  *
- * @param comp             The ROHC compressor
- * @param packet           The packet to find a compression context for
- * @param profile_id_hint  If positive, indicate the profile to use
- * @param arrival_time     The time at which packet was received
- *                         (0 if unknown, or to disable time-related features
- *                          in the ROHC protocol)
- * @return                 The context if found or successfully created,
- *                         NULL if not found
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to remove from the LRU list
  */
-static struct rohc_comp_ctxt *
-	rohc_comp_find_ctxt(struct rohc_comp *const comp,
-	                    const struct net_pkt *const packet,
-	                    const int profile_id_hint,
-	                    const struct rohc_ts arrival_time)
+static void c_ctxt_lru_unlink(struct rohc_comp *const comp,
+                              struct rohc_comp_ctxt *const context)
 {
-	const struct rohc_comp_profile *profile;
-	struct rohc_comp_ctxt *context;
-	size_t num_used_ctxt_seen = 0;
-	rohc_cid_t i;
-
-	/* use the suggested profile if any, otherwise find the best profile for
-	 * the packet */
-	if(profile_id_hint < 0)
+	if(context->lru_prev != NULL)
 	{
-		profile = c_get_profile_from_packet(comp, packet);
+		context->lru_prev->lru_next = context->lru_next;
 	}
 	else
 	{
-		profile = rohc_get_profile_from_id(comp, profile_id_hint);
+		assert(comp->lru_first == context);
+		comp->lru_first = context->lru_next;
 	}
-	if(profile == NULL)
+	if(context->lru_next != NULL)
 	{
-		rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		             "no profile found for packet, giving up");
-		goto not_found;
+		context->lru_next->lru_prev = context->lru_prev;
 	}
-	rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-	           "using profile '%s' (0x%04x)",
-	           rohc_get_profile_descr(profile->id), profile->id);
-
-	/* get the context using help from the profile we just found */
-	for(i = 0; i <= comp->medium.max_cid; i++)
+	else
 	{
-		context = &comp->contexts[i];
+		assert(comp->lru_last == context);
+		comp->lru_last = context->lru_prev;
+	}
+	context->lru_prev = NULL;
+	context->lru_next = NULL;
+}
 
-		/* don't even look at unused contexts */
-		if(!context->used)
-		{
-			continue;
-		}
-		num_used_ctxt_seen++;
 
-		/* don't look at contexts with the wrong profile */
-		if(context->profile->id != profile->id)
-		{
-			continue;
-		}
+/**
+ * @brief Destroy the compression contexts that were not used for too long
+ *
+ * The least recently used contexts are at the end of the LRU list: walk the
+ * list backwards until one context was used recently enough.
+ *
+ * @param comp          The ROHC compressor
+ * @param arrival_time  The arrival time of the packet being compressed
+ */
+static void c_expire_contexts(struct rohc_comp *const comp,
+                              const struct rohc_ts arrival_time)
+{
+	while(comp->lru_last != NULL &&
+	      arrival_time.sec >= comp->lru_last->latest_used &&
+	      (arrival_time.sec - comp->lru_last->latest_used) >=
+	      comp->ctxt_idle_timeout)
+	{
+		struct rohc_comp_ctxt *const context = comp->lru_last;
+
+		rohc_info(comp, ROHC_TRACE_COMP, context->profile->id, "destroy "
+		          "context with CID %zu unused for more than %zu seconds",
+		          context->cid, comp->ctxt_idle_timeout);
+		c_destroy_context(comp, context);
+		rohc_trace_event(comp, ROHC_TRACE_COMP, ROHC_TRACE_EVENT_COMP_CTXT_EVICT,
+		                 context->profile->id, context->cid, ROHC_PACKET_UNKNOWN,
+		                 ROHC_TRACE_EVICT_IDLE, comp->num_contexts_used, 0);
+	}
+}
 
-		/* don't look at contexts with the wrong key */
-		if(packet->key != context->key)
-		{
-			continue;
-		}
 
-		/* ask the profile whether the packet matches the context */
-		if(context->profile->check_context(context, packet))
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "using context CID = %zu", context->cid);
-			break;
-		}
+/**
+ * @brief Record whether the flow of the context ended
+ *
+ * The context is appended to the list of the contexts of the ended flows
+ * once the profile detected the end of its flow, it is removed from the list
+ * if the profile detected that the flow started again.
+ *
+ * @param comp          The ROHC compressor
+ * @param context       The compression context that compressed the packet
+ * @param arrival_time  The arrival time of the packet being compressed
+ */
+static void c_ctxt_closed_update(struct rohc_comp *const comp,
+                                 struct rohc_comp_ctxt *const context,
+                                 const struct rohc_ts arrival_time)
+{
+	const bool listed =
+		(context->closed_prev != NULL || comp->closed_first == context);
 
-		/* if all used contexts were checked, no need go search further */
-		if(num_used_ctxt_seen >= comp->num_contexts_used)
+	if(context->closed && !listed)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, context->profile->id, "flow of "
+		           "context with CID %zu ended", context->cid);
+		context->closed_time = arrival_time.sec;
+		context->closed_prev = comp->closed_last;
+		context->closed_next = NULL;
+		if(comp->closed_last != NULL)
 		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "no context was found");
-			context = NULL;
-			break;
+			comp->closed_last->closed_next = context;
 		}
-	}
-	if(context == NULL || i > comp->medium.max_cid)
-	{
-		/* context not found, create a new one */
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "no existing context found for packet, create a new one");
-		context = c_create_context(comp, profile, packet, arrival_time);
-		if(context == NULL)
+		else
 		{
-			rohc_warning(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			             "failed to create a new context");
-			goto not_found;
+			comp->closed_first = context;
 		}
+		comp->closed_last = context;
 	}
-	else
+	else if(!context->closed && listed)
 	{
-		/* matching context found, update use timestamp */
-		context->latest_used = arrival_time.sec;
+		rohc_debug(comp, ROHC_TRACE_COMP, context->profile->id, "flow of "
+		           "context with CID %zu started again", context->cid);
+		c_ctxt_closed_unlink(comp, context);
 	}
-
-	return context;
-
-not_found:
-	return NULL;
 }
 
 
 /**
- * @brief Find out a context given its CID
+ * @brief Remove one context from the list of the contexts of the ended flows
  *
- * @param comp The ROHC compressor
- * @param cid  The CID of the context to find
- * @return     The context with the given CID if found, NULL otherwise
+ * Nothing is done if the context is not in the list.
+ *
+ * @param comp     The ROHC compressor
+ * @param context  The compression context to remove
  */
-static struct rohc_comp_ctxt *
-	c_get_context(struct rohc_comp *const comp, const rohc_cid_t cid)
+static void c_ctxt_closed_unlink(struct rohc_comp *const comp,
+                                 struct rohc_comp_ctxt *const context)
 {
-	/* the CID must not be larger than the context array */
-	if(cid > comp->medium.max_cid)
+	if(context->closed_prev != NULL)
 	{
-		goto not_found;
+		context->closed_prev->closed_next = context->closed_next;
+	}
+	else if(comp->closed_first == context)
+	{
+		comp->closed_first = context->closed_next;
+	}
+	else
+	{
+		/* not in the list */
+		return;
 	}
+	if(context->closed_next != NULL)
+	{
+		context->closed_next->closed_prev = context->closed_prev;
+	}
+	else
+	{
+		assert(comp->closed_last == context);
+		comp->closed_last = context->closed_prev;
+	}
+	context->closed_prev = NULL;
+	context->closed_next = NULL;
+}
 
-	/* the context with the given CID must be in use */
-	if(comp->contexts[cid].used == 0)
+
+/**
+ * @brief Destroy the contexts of the flows that ended long enough ago
+ *
+ * The contexts of the ended flows are listed in the order the flows ended:
+ * walk the list from its start until one flow ended recently enough.
+ *
+ * @param comp          The ROHC compressor
+ * @param arrival_time  The arrival time of the packet being compressed
+ */
+static void c_release_closed_contexts(struct rohc_comp *const comp,
+                                      const struct rohc_ts arrival_time)
+{
+	while(comp->closed_first != NULL &&
+	      arrival_time.sec >= comp->closed_first->closed_time &&
+	      (arrival_time.sec - comp->closed_first->closed_time) >=
+	      comp->closed_ctxt_linger)
 	{
-		goto not_found;
+		struct rohc_comp_ctxt *const context = comp->closed_first;
+
+		rohc_info(comp, ROHC_TRACE_COMP, context->profile->id, "destroy "
+		          "context with CID %zu of a flow ended more than %zu seconds "
+		          "ago", context->cid, comp->closed_ctxt_linger);
+		c_destroy_context(comp, context);
+		rohc_trace_event(comp, ROHC_TRACE_COMP, ROHC_TRACE_EVENT_COMP_CTXT_EVICT,
+		                 context->profile->id, context->cid, ROHC_PACKET_UNKNOWN,
+		                 ROHC_TRACE_EVICT_CLOSED, comp->num_contexts_used, 0);
 	}
+}
 
-	return &(comp->contexts[cid]);
 
-not_found:
-	return NULL;
+/**
+ * @brief Get the number of bytes the compressor uses
+ *
+ * @param comp  The ROHC compressor
+ * @return      The number of bytes the compressor uses
+ */
+static size_t c_mem_usage(const struct rohc_comp *const comp)
+{
+	return (sizeof(struct rohc_comp) + comp->mrru +
+	        comp->ctxt_pages_nr * sizeof(struct rohc_comp_ctxt *) +
+	        comp->cids_words_nr * sizeof(uint64_t) +
+	        (comp->ctxts_index_mask + 1) * sizeof(rohc_cid_t) +
+	        comp->ctxts_mem_len + comp->ctxt_slab->mem_len +
+	        rohc_intern_mem_len(comp->static_store));
 }
 
 
 /**
  * @brief Create the array of compression contexts
  *
+ * Only the array of pages and a small hash index are allocated, the contexts
+ * themselves are allocated on demand by \ref c_alloc_ctxt.
+ *
  * @param comp The ROHC compressor
  * @return     true if the creation is successful, false otherwise
  */
 static bool c_create_contexts(struct rohc_comp *const comp)
 {
-	assert(comp->contexts == NULL);
+	size_t i;
+
+	assert(comp->ctxt_pages == NULL);
+	assert(comp->ctxts_index == NULL);
 
 	comp->num_contexts_used = 0;
 
@@ -2526,17 +8878,62 @@ static bool c_create_contexts(struct rohc_comp *const comp)
 	          "create enough room for %zu contexts (MAX_CID = %zu)",
 	          comp->medium.max_cid + 1, comp->medium.max_cid);
 
-	comp->contexts = calloc(comp->medium.max_cid + 1,
-	                        sizeof(struct rohc_comp_ctxt));
-	if(comp->contexts == NULL)
+	comp->ctxt_pages_nr = (comp->medium.max_cid + ROHC_COMP_CTXT_PAGE_LEN) /
+	                      ROHC_COMP_CTXT_PAGE_LEN;
+	comp->ctxts_mem_len = 0;
+	comp->ctxt_pages = rohc_mem_calloc(&comp->mem_ops, comp->ctxt_pages_nr,
+	                                   sizeof(struct rohc_comp_ctxt *));
+	if(comp->ctxt_pages == NULL)
 	{
 		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
 		           "cannot allocate memory for contexts");
 		goto error;
 	}
 
+	/* create the bitmap of the used CIDs: the CIDs beyond MAX_CID in its
+	 * last word are never unused */
+	comp->cids_words_nr = comp->medium.max_cid / ROHC_COMP_CIDS_WORD_LEN + 1;
+	comp->cids_used = rohc_mem_calloc(&comp->mem_ops, comp->cids_words_nr,
+	                                  sizeof(uint64_t));
+	if(comp->cids_used == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "cannot allocate memory for the bitmap of the used CIDs");
+		goto free_pages;
+	}
+	memset(comp->cids_full, 0, sizeof(comp->cids_full));
+	for(i = comp->medium.max_cid + 1;
+	    i < comp->cids_words_nr * ROHC_COMP_CIDS_WORD_LEN; i++)
+	{
+		c_cid_set_used(comp, i);
+	}
+
+	/* create a small hash index of contexts, it grows with the number of
+	 * contexts in use so that its load factor never exceeds 50% and the
+	 * probe sequences remain short */
+	comp->ctxts_index = rohc_mem_alloc(&comp->mem_ops, ROHC_COMP_CTXT_INDEX_MIN_LEN *
+	                                   sizeof(rohc_cid_t));
+	if(comp->ctxts_index == NULL)
+	{
+		rohc_error(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "cannot allocate memory for the hash index of contexts");
+		goto free_cids;
+	}
+	for(i = 0; i < ROHC_COMP_CTXT_INDEX_MIN_LEN; i++)
+	{
+		comp->ctxts_index[i] = ROHC_COMP_CTXT_INDEX_EMPTY;
+	}
+	comp->ctxts_index_mask = ROHC_COMP_CTXT_INDEX_MIN_LEN - 1;
+
 	return true;
 
+free_cids:
+	rohc_mem_free(&comp->mem_ops, comp->cids_used);
+	comp->cids_used = NULL;
+	comp->cids_words_nr = 0;
+free_pages:
+	rohc_mem_free(&comp->mem_ops, comp->ctxt_pages);
+	comp->ctxt_pages = NULL;
 error:
 	return false;
 }
@@ -2551,28 +8948,54 @@ error:
  */
 static void c_destroy_contexts(struct rohc_comp *const comp)
 {
-	rohc_cid_t i;
+	size_t page_idx;
 
-	assert(comp->contexts != NULL);
+	assert(comp->ctxt_pages != NULL);
 
-	for(i = 0; i <= comp->medium.max_cid; i++)
+	for(page_idx = 0; page_idx < comp->ctxt_pages_nr; page_idx++)
 	{
-		if(comp->contexts[i].used && comp->contexts[i].profile != NULL)
+		struct rohc_comp_ctxt *const page = comp->ctxt_pages[page_idx];
+		size_t i;
+
+		if(page == NULL)
 		{
-			comp->contexts[i].profile->destroy(&comp->contexts[i]);
+			continue;
 		}
 
-		if(comp->contexts[i].used)
+		for(i = 0; i < ROHC_COMP_CTXT_PAGE_LEN; i++)
 		{
-			comp->contexts[i].used = 0;
-			assert(comp->num_contexts_used > 0);
-			comp->num_contexts_used--;
+			if(page[i].used && page[i].profile != NULL)
+			{
+				page[i].profile->destroy(&page[i]);
+			}
+
+			if(page[i].used)
+			{
+				page[i].used = 0;
+				assert(comp->num_contexts_used > 0);
+				comp->num_contexts_used--;
+			}
+			rohc_mem_free(&comp->mem_ops, page[i].last_pkts);
 		}
+
+		rohc_slab_free(page);
 	}
 	assert(comp->num_contexts_used == 0);
 
-	free(comp->contexts);
-	comp->contexts = NULL;
+	comp->lru_first = NULL;
+	comp->lru_last = NULL;
+	comp->closed_first = NULL;
+	comp->closed_last = NULL;
+	comp->shared_uncomp_ctxt = NULL;
+	memset(comp->uncomp_flows, 0, sizeof(comp->uncomp_flows));
+	rohc_mem_free(&comp->mem_ops, comp->ctxts_index);
+	comp->ctxts_index = NULL;
+	rohc_mem_free(&comp->mem_ops, comp->cids_used);
+	comp->cids_used = NULL;
+	comp->cids_words_nr = 0;
+	rohc_mem_free(&comp->mem_ops, comp->ctxt_pages);
+	comp->ctxt_pages = NULL;
+	comp->ctxt_pages_nr = 0;
 }
 
 
@@ -2587,11 +9010,12 @@ void rohc_comp_change_mode(struct rohc_comp_ctxt *const context,
 {
 	if(context->mode != new_mode)
 	{
-		/* TODO: R-mode is not yet supported */
-		if(new_mode == ROHC_R_MODE)
+		/* only the profiles of RFC 3095 support R-mode */
+		if(new_mode == ROHC_R_MODE &&
+		   !rohc_profile_is_rfc3095(context->profile->id))
 		{
-			rohc_comp_warn(context, "ignore change to R-mode because R-mode is "
-			               "not supported yet");
+			rohc_comp_warn(context, "ignore change to R-mode because the profile "
+			               "does not support R-mode");
 			return;
 		}
 		/* TODO: downward transition to U-mode is not yet supported */
@@ -2606,7 +9030,17 @@ void rohc_comp_change_mode(struct rohc_comp_ctxt *const context,
 		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		          "CID %zu: change from mode %d to mode %d",
 		          context->cid, context->mode, new_mode);
+		rohc_trace_event(context->compressor, ROHC_TRACE_COMP,
+		                 ROHC_TRACE_EVENT_COMP_MODE, context->profile->id,
+		                 context->cid, ROHC_PACKET_UNKNOWN, context->mode,
+		                 new_mode, 0);
 		context->mode = new_mode;
+		if(context->compressor->last_context == context)
+		{
+			rohc_seqlock_write_begin(&context->compressor->stats_seq);
+			context->compressor->last_pkt_info.context_mode = new_mode;
+			rohc_seqlock_write_end(&context->compressor->stats_seq);
+		}
 		rohc_comp_change_state(context, ROHC_COMP_STATE_IR);
 	}
 }
@@ -2626,6 +9060,10 @@ void rohc_comp_change_state(struct rohc_comp_ctxt *const context,
 		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 		          "CID %zu: change from state %d to state %d",
 		          context->cid, context->state, new_state);
+		rohc_trace_event(context->compressor, ROHC_TRACE_COMP,
+		                 ROHC_TRACE_EVENT_COMP_STATE, context->profile->id,
+		                 context->cid, ROHC_PACKET_UNKNOWN, context->state,
+		                 new_state, 0);
 
 		/* reset counters */
 		context->ir_count = 0;
@@ -2634,51 +9072,173 @@ void rohc_comp_change_state(struct rohc_comp_ctxt *const context,
 
 		/* change state */
 		context->state = new_state;
+		if(context->compressor->last_context == context)
+		{
+			rohc_seqlock_write_begin(&context->compressor->stats_seq);
+			context->compressor->last_pkt_info.context_state = new_state;
+			rohc_seqlock_write_end(&context->compressor->stats_seq);
+		}
+	}
+}
+
+
+/**
+ * @brief Scale one timeout for the periodic refreshes of the context
+ *
+ * @param context  The compression context
+ * @param timeout  The timeout configured for the compressor
+ * @return         The timeout multiplied or divided by the power of 2 of the
+ *                 context, at least 1
+ */
+static size_t rohc_comp_refresh_timeout(const struct rohc_comp_ctxt *const context,
+                                        const size_t timeout)
+{
+	if(context->refresh_scale >= 0)
+	{
+		return (timeout << context->refresh_scale);
 	}
+	return rohc_max(timeout >> (-context->refresh_scale), 1U);
 }
 
 
 /**
  * @brief Periodically change the context state after a certain number
- *        of packets.
+ *        of packets or a certain time.
  *
  * @param context The compression context
  */
 void rohc_comp_periodic_down_transition(struct rohc_comp_ctxt *const context)
 {
-	rohc_debug(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+	struct rohc_comp *const comp = context->compressor;
+	const size_t fo_timeout =
+		rohc_comp_refresh_timeout(context, comp->periodic_refreshes_fo_timeout);
+	const size_t ir_timeout =
+		rohc_comp_refresh_timeout(context, comp->periodic_refreshes_ir_timeout);
+	const uint32_t fo_elapsed = context->latest_used_ms - context->go_back_fo_time;
+	const uint32_t ir_elapsed = context->latest_used_ms - context->go_back_ir_time;
+	const bool fo_time_expired = (comp->periodic_refreshes_fo_time != 0 &&
+		fo_elapsed >= rohc_comp_refresh_timeout(context,
+		                                        comp->periodic_refreshes_fo_time));
+	const bool ir_time_expired = (comp->periodic_refreshes_ir_time != 0 &&
+		ir_elapsed >= rohc_comp_refresh_timeout(context,
+		                                        comp->periodic_refreshes_ir_time));
+
+	rohc_debug(comp, ROHC_TRACE_COMP, context->profile->id,
 	           "CID %zu: timeouts for periodic refreshes: FO = %zu / %zu, "
 	           "IR = %zu / %zu", context->cid, context->go_back_fo_count,
-	           context->compressor->periodic_refreshes_fo_timeout,
-	           context->go_back_ir_count,
-	           context->compressor->periodic_refreshes_ir_timeout);
+	           fo_timeout, context->go_back_ir_count, ir_timeout);
 
-	if(context->go_back_fo_count >=
-	   context->compressor->periodic_refreshes_fo_timeout)
+	if(comp->is_overloaded &&
+	   (context->go_back_fo_count >= fo_timeout || fo_time_expired ||
+	    context->go_back_ir_count >= ir_timeout || ir_time_expired))
 	{
-		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		/* the refreshes are optional, the counters keep running so that the
+		 * refresh happens once the overload is over */
+		rohc_debug(comp, ROHC_TRACE_COMP, context->profile->id,
+		           "CID %zu: compressor overloaded, defer periodic refresh",
+		           context->cid);
+		rohc_seqlock_write_begin(&comp->stats_seq);
+		comp->overload_refreshes_nr++;
+		rohc_seqlock_write_end(&comp->stats_seq);
+	}
+	else if(context->go_back_fo_count >= fo_timeout || fo_time_expired)
+	{
+		rohc_info(comp, ROHC_TRACE_COMP, context->profile->id,
 		          "CID %zu: periodic change to FO state", context->cid);
 		context->go_back_fo_count = 0;
 		rohc_comp_change_state(context, ROHC_COMP_STATE_FO);
 	}
-	else if(context->go_back_ir_count >=
-	        context->compressor->periodic_refreshes_ir_timeout)
+	else if(context->go_back_ir_count >= ir_timeout || ir_time_expired)
 	{
-		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		rohc_info(comp, ROHC_TRACE_COMP, context->profile->id,
 		          "CID %zu: periodic change to IR state", context->cid);
 		context->go_back_ir_count = 0;
 		rohc_comp_change_state(context, ROHC_COMP_STATE_IR);
+
+		/* a whole refresh period with feedback but no NACK proves a clean
+		 * link, refresh less often */
+		if((c_features(comp) & ROHC_COMP_FEATURE_ADAPTIVE_REFRESHES) != 0 &&
+		   context->refresh_feedback && !context->refresh_nack &&
+		   context->refresh_scale < ROHC_COMP_REFRESH_SCALE_MAX)
+		{
+			context->refresh_scale++;
+			rohc_info(comp, ROHC_TRACE_COMP, context->profile->id,
+			          "CID %zu: no NACK during the latest refresh period, "
+			          "refresh less often (scale %d)", context->cid,
+			          context->refresh_scale);
+		}
+		context->refresh_feedback = false;
+		context->refresh_nack = false;
 	}
 
 	if(context->state == ROHC_COMP_STATE_SO)
 	{
 		context->go_back_fo_count++;
 	}
+	else
+	{
+		context->go_back_fo_time = context->latest_used_ms;
+	}
 	if(context->state == ROHC_COMP_STATE_SO ||
 	   context->state == ROHC_COMP_STATE_FO)
 	{
 		context->go_back_ir_count++;
 	}
+	else
+	{
+		context->go_back_ir_time = context->latest_used_ms;
+	}
+}
+
+
+/**
+ * @brief Get the anomalies of the IP headers that prevent their compression
+ *
+ * The anomalies are found once by \ref net_pkt_parse, the bad IPv4 checksums
+ * are ignored if \ref ROHC_COMP_FEATURE_NO_IP_CHECKSUMS is enabled.
+ *
+ * @param comp    The ROHC compressor
+ * @param packet  The packet to compress
+ * @return        The anomalies of the outer and inner IP headers, 0 if none
+ */
+uint8_t rohc_comp_get_ip_anomalies(const struct rohc_comp *const comp,
+                                   const struct net_pkt *const packet)
+{
+	uint8_t anomalies = packet->ip_anomalies;
+
+	if((c_features(comp) & ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) != 0)
+	{
+		anomalies &= ~NET_PKT_IPV4_BAD_CSUM;
+	}
+
+	return anomalies;
+}
+
+
+/**
+ * @brief Make the periodic refreshes of the context more frequent after a NACK
+ *
+ * Only if \ref ROHC_COMP_FEATURE_ADAPTIVE_REFRESHES is enabled: every NACK
+ * or STATIC-NACK halves the refresh timeouts of the context, down to the
+ * timeouts of the compressor divided by 2^\ref ROHC_COMP_REFRESH_SCALE_MAX.
+ *
+ * @param context  The compression context that received a NACK
+ */
+void rohc_comp_periodic_refreshes_nack(struct rohc_comp_ctxt *const context)
+{
+	if((c_features(context->compressor) & ROHC_COMP_FEATURE_ADAPTIVE_REFRESHES) == 0)
+	{
+		return;
+	}
+
+	context->refresh_nack = true;
+	if(context->refresh_scale > -ROHC_COMP_REFRESH_SCALE_MAX)
+	{
+		context->refresh_scale--;
+		rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		          "CID %zu: NACK received, refresh more often (scale %d)",
+		          context->cid, context->refresh_scale);
+	}
 }
 
 
@@ -2703,6 +9263,85 @@ bool rohc_comp_reinit_context(struct rohc_comp_ctxt *const context)
 }
 
 
+/**
+ * @brief Adapt the width of the W-LSB windows of the context to one ACK
+ *
+ * The packets sent after the acknowledged one are the packets in flight. The
+ * windows shall keep them plus the acknowledged one, that the decompressor
+ * surely received, so the width grows at once to the next power of 2 that
+ * covers them. The width is halved only once \ref ROHC_COMP_WLSB_SHRINK_ACKS
+ * consecutive ACKs measured no more packets in flight than half the width.
+ * The width stays in range [\ref ROHC_COMP_WLSB_WIDTH_MIN, width of the
+ * compressor].
+ *
+ * @param context     The compression context that received a valid ACK
+ * @param sn          The SN of the latest packet sent by the context
+ * @param sn_bits     The LSB bits of the acknowledged SN
+ * @param sn_bits_nr  The number of LSB bits of the acknowledged SN
+ * @return            The new width of the W-LSB windows of the context
+ */
+size_t rohc_comp_wlsb_width_ack(struct rohc_comp_ctxt *const context,
+                                const uint32_t sn,
+                                const uint32_t sn_bits,
+                                const size_t sn_bits_nr)
+{
+	const size_t max_width = context->compressor->wlsb_window_width;
+	const uint32_t sn_mask =
+		(sn_bits_nr < 32 ? ((1U << sn_bits_nr) - 1) : 0xffffffffU);
+	const size_t in_flight_nr = (sn - sn_bits) & sn_mask;
+	size_t needed_width = ROHC_COMP_WLSB_WIDTH_MIN;
+
+	while(needed_width < max_width && needed_width <= in_flight_nr)
+	{
+		needed_width *= 2;
+	}
+	needed_width = rohc_min(needed_width, max_width);
+
+	if(needed_width > context->wlsb_width)
+	{
+		context->wlsb_width = needed_width;
+		context->wlsb_shrink_acks = 0;
+	}
+	else if(needed_width <= (context->wlsb_width / 2))
+	{
+		context->wlsb_shrink_acks++;
+		if(context->wlsb_shrink_acks >= ROHC_COMP_WLSB_SHRINK_ACKS)
+		{
+			context->wlsb_width /= 2;
+			context->wlsb_shrink_acks = 0;
+		}
+	}
+	else
+	{
+		context->wlsb_shrink_acks = 0;
+	}
+
+	rohc_debug(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+	           "CID %zu: %zu packets in flight, W-LSB windows keep %zu entries",
+	           context->cid, in_flight_nr, context->wlsb_width);
+
+	return context->wlsb_width;
+}
+
+
+/**
+ * @brief Reset the width of the W-LSB windows of the context after a NACK
+ *
+ * A NACK means that packets were lost or damaged since the last ACK, so the
+ * windows get back to the width of the compressor.
+ *
+ * @param context  The compression context that received a NACK
+ * @return         The new width of the W-LSB windows of the context
+ */
+size_t rohc_comp_wlsb_width_nack(struct rohc_comp_ctxt *const context)
+{
+	context->wlsb_width = context->compressor->wlsb_window_width;
+	context->wlsb_shrink_acks = 0;
+
+	return context->wlsb_width;
+}
+
+
 /**
  * @brief Parse ROHC feedback CID
  *
@@ -2721,7 +9360,7 @@ static bool rohc_comp_feedback_parse_cid(const struct rohc_comp *const comp,
                                          size_t *const cid_len)
 {
 	/* decode CID */
-	if(comp->medium.cid_type == ROHC_LARGE_CID)
+	if(c_cid_type(comp) == ROHC_LARGE_CID)
 	{
 		size_t large_cid_size;
 		size_t large_cid_bits_nr;
@@ -2877,6 +9516,13 @@ bool rohc_comp_feedback_parse_opts(const struct rohc_comp_ctxt *const context,
 		remain_len -= opt_len;
 	}
 
+	/* the feedback of a trusted channel is neither corrupted nor malformed,
+	 * so skip the checks of the options and the CRC */
+	if((c_features(context->compressor) & ROHC_COMP_FEATURE_TRUSTED_FEEDBACK) != 0)
+	{
+		goto skip_checks;
+	}
+
 	/* sanity checks:
 	 *  - some profiles do not support all options
 	 *  - some options cannot be specified multiple times
@@ -2897,12 +9543,12 @@ bool rohc_comp_feedback_parse_opts(const struct rohc_comp_ctxt *const context,
 		/* compute the CRC of the feedback packet (skip CRC byte) */
 		crc_computed = crc_calculate(ROHC_CRC_TYPE_8, packet,
 		                             packet_len - crc_pos_from_end, CRC_INIT_8,
-		                             context->compressor->crc_table_8);
+		                             rohc_crc_table_8);
 		crc_computed = crc_calculate(ROHC_CRC_TYPE_8, &zeroed_crc, zeroed_crc_len,
-		                             crc_computed, context->compressor->crc_table_8);
+		                             crc_computed, rohc_crc_table_8);
 		crc_computed = crc_calculate(ROHC_CRC_TYPE_8, packet + packet_len -
 		                             crc_pos_from_end + 1, crc_pos_from_end - 1,
-		                             crc_computed, context->compressor->crc_table_8);
+		                             crc_computed, rohc_crc_table_8);
 
 		/* ignore feedback in case of bad CRC */
 		if(crc_in_packet != crc_computed)
@@ -2914,6 +9560,7 @@ bool rohc_comp_feedback_parse_opts(const struct rohc_comp_ctxt *const context,
 		}
 	}
 
+skip_checks:
 	return true;
 
 error:
@@ -2946,7 +9593,8 @@ static bool rohc_comp_feedback_parse_opt_sn(const struct rohc_comp_ctxt *const c
 	/* min length already checked in caller function */
 	assert(feedback_data_len >= 2);
 
-	if(context->profile->id == ROHC_PROFILE_TCP)
+	if(context->profile->id == ROHC_PROFILE_TCP ||
+	   rohc_profile_is_rohcv2(context->profile->id))
 	{
 		if(((*sn_bits) & 0xffffc000) != 0)
 		{
@@ -3023,8 +9671,12 @@ error:
 static bool rohc_comp_feedback_check_opts(const struct rohc_comp_ctxt *const context,
                                           const size_t opts_present[ROHC_FEEDBACK_OPT_MAX])
 {
+	/* the ROHCv2 profiles share the feedback options of the TCP profile */
+	const rohc_profile_t opts_profile =
+		(rohc_profile_is_rohcv2(context->profile->id) ? ROHC_PROFILE_TCP :
+		 context->profile->id);
 	uint8_t opt_type;
-	assert(context->profile->id < ROHC_PROFILE_MAX);
+	assert(opts_profile < ROHC_PROFILE_MAX);
 
 	for(opt_type = 0; opt_type < ROHC_FEEDBACK_OPT_MAX; opt_type++)
 	{
@@ -3033,7 +9685,7 @@ static bool rohc_comp_feedback_check_opts(const struct rohc_comp_ctxt *const con
 		   rohc_feedback_opt_charac[opt_type].supported)
 		{
 			const size_t max_occurs =
-				rohc_feedback_opt_charac[opt_type].max_occurs[context->profile->id];
+				rohc_feedback_opt_charac[opt_type].max_occurs[opts_profile];
 
 			/* is the option supported by the current compression profile? */
 			if(max_occurs == 0)
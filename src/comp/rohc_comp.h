@@ -56,6 +56,12 @@ extern "C"
 #  define ROHC_EXPORT
 #endif
 
+/* the public API stays visible when the library is built with
+ * -fvisibility=hidden */
+#if defined(__GNUC__) && __GNUC__ >= 4
+#  pragma GCC visibility push(default)
+#endif
+
 
 /*
  * Declare the private ROHC compressor structure that is defined inside the
@@ -64,6 +70,20 @@ extern "C"
 
 struct rohc_comp;
 
+/*
+ * Declare the private sharded ROHC compressor structure that is defined
+ * inside the library.
+ */
+
+struct rohc_comp_shards;
+
+/*
+ * Declare the private multi-channel ROHC compression engine structure that
+ * is defined inside the library.
+ */
+
+struct rohc_comp_engine;
+
 
 /*
  * Public structures and types
@@ -191,6 +211,10 @@ typedef struct
  * Supported versions:
  *  - major 0 and minor = 0 contains: version_major, version_minor,
  *    contexts_nr, packets_nr, uncomp_bytes_nr, and comp_bytes_nr.
+ *  - major 0 and minor = 1 added: contexts_recycled_nr, feedbacks_nr, and
+ *    packet_types_nr.
+ *  - major 0 and minor = 2 added: overloads_nr, overload_pkts_nr,
+ *    overload_flows_nr, and overload_refreshes_nr.
  *
  * @ingroup rohc_comp
  *
@@ -210,9 +234,114 @@ typedef struct
 	unsigned long uncomp_bytes_nr;
 	/** The number of compressed bytes produced by the compressor */
 	unsigned long comp_bytes_nr;
+
+	/* added in 0.1 */
+	/** The number of contexts recycled to make room for new contexts */
+	unsigned long contexts_recycled_nr;
+	/** The number of feedback items received by the compressor */
+	unsigned long feedbacks_nr;
+	/** The number of ROHC packets produced per type of ROHC packet */
+	unsigned long packet_types_nr[ROHC_PACKET_MAX];
+
+	/* added in 0.2 */
+	/** The number of times the compressor entered the overload mode */
+	unsigned long overloads_nr;
+	/** The number of packets compressed in overload mode */
+	unsigned long overload_pkts_nr;
+	/** The number of new flows sent uncompressed in overload mode */
+	unsigned long overload_flows_nr;
+	/** The number of packets that deferred a periodic refresh of their
+	 *  context in overload mode */
+	unsigned long overload_refreshes_nr;
+
 } __attribute__((packed)) rohc_comp_general_info_t;
 
 
+/**
+ * @brief The stages of compression measured by the ROHC compressor
+ *
+ * The stages are measured only if the library is configured with the
+ * --enable-rohc-perf-stats option.
+ *
+ * The change detection, the decisions, the field encoding and the packet
+ * coding are measured only for the IP, UDP, RTP, ESP, UDP-Lite and TCP
+ * profiles. They are part of the \ref ROHC_COMP_PERF_ENCODE stage.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_perf_stats
+ */
+typedef enum
+{
+	/** Parse the uncompressed packet */
+	ROHC_COMP_PERF_PARSE          = 0,
+	/** Find the context of the packet, or create it */
+	ROHC_COMP_PERF_CTXT_LOOKUP    = 1,
+	/** Encode the ROHC header with the profile of the context */
+	ROHC_COMP_PERF_ENCODE         = 2,
+	/** Detect the changes between the packet and the context */
+	ROHC_COMP_PERF_DETECT_CHANGES = 3,
+	/** Decide the state of the context */
+	ROHC_COMP_PERF_DECIDE_STATE   = 4,
+	/** Encode the header fields and compute their number of bits */
+	ROHC_COMP_PERF_ENCODE_FIELDS  = 5,
+	/** Decide the type of ROHC packet */
+	ROHC_COMP_PERF_DECIDE_PKT     = 6,
+	/** Write the ROHC header, including its CRC */
+	ROHC_COMP_PERF_CODE_PKT       = 7,
+	/** Copy the payload after the ROHC header */
+	ROHC_COMP_PERF_PAYLOAD_COPY   = 8,
+
+	ROHC_COMP_PERF_STAGE_MAX      /**< The number of compression stages */
+} rohc_comp_perf_stage_t;
+
+
+/**
+ * @brief The durations of the compression stages
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_perf_stats
+ */
+struct rohc_comp_perf_stats
+{
+	/** The histogram of durations of every compression stage */
+	struct rohc_perf_hist stages[ROHC_COMP_PERF_STAGE_MAX];
+};
+
+
+/**
+ * @brief The record of one compression context
+ *
+ * The records of all the contexts in use are given by the
+ * \ref rohc_comp_get_contexts function.
+ *
+ * The byte counters are always zero if the library is configured with the
+ * --disable-rohc-comp-stats option.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_get_contexts
+ */
+struct rohc_comp_ctxt_record
+{
+	/** The number of packets compressed with the context */
+	uint64_t packets_nr;
+	/** The number of uncompressed bytes received by the context */
+	uint64_t uncomp_bytes_nr;
+	/** The number of compressed bytes produced by the context */
+	uint64_t comp_bytes_nr;
+	/** The Context ID (CID) of the context */
+	rohc_cid_t cid;
+	/** The profile of the context */
+	rohc_profile_t profile;
+	/** The operation mode of the context */
+	rohc_mode_t mode;
+	/** The state of the context */
+	rohc_comp_state_t state;
+};
+
+
 /**
  * @brief The different features of the ROHC compressor
  *
@@ -234,10 +363,193 @@ typedef enum
 	ROHC_COMP_FEATURE_NO_IP_CHECKSUMS = (1 << 2),
 	/** Dump content of packets in traces (beware: performance impact) */
 	ROHC_COMP_FEATURE_DUMP_PACKETS    = (1 << 3),
+	/** Identify flows with a hash of their addresses, protocol, ports or SPI
+	 *  instead of their IP addresses only (faster context lookup with many
+	 *  flows between the same hosts) */
+	ROHC_COMP_FEATURE_FLOW_KEY        = (1 << 4),
+	/** Trust the feedback channel: do not check the occurrences of the
+	 *  FEEDBACK-2 options nor the feedback CRCs (faster feedback handling on
+	 *  trusted and lossless links only) */
+	ROHC_COMP_FEATURE_TRUSTED_FEEDBACK = (1 << 5),
+	/** Do not copy the payload of the packets to segment in the compressor:
+	 *  the segments are built from the uncompressed packet, that shall stay
+	 *  unchanged until its last segment is retrieved */
+	ROHC_COMP_FEATURE_SEGMENT_NO_COPY = (1 << 6),
+	/** Encode every packet type that fits the changes of the headers and
+	 *  send the smallest one instead of the first one that fits the RFC rules
+	 *  (fewer bytes on the wire, more CPU per packet) */
+	ROHC_COMP_FEATURE_SMALLEST_PACKETS = (1 << 7),
+	/** Record the headers of the last packets of every context, so that the
+	 *  contexts may be saved by \ref rohc_comp_save_contexts (one copy of
+	 *  the headers per packet) */
+	ROHC_COMP_FEATURE_CHECKPOINT      = (1 << 8),
+	/** Adapt the number of entries kept in the W-LSB windows of every
+	 *  context to the packets in flight measured on the O- and R-mode ACKs,
+	 *  up to the width set by \ref rohc_comp_set_wlsb_window_width (fewer
+	 *  bits on links with feedback and few packets in flight) */
+	ROHC_COMP_FEATURE_ADAPTIVE_WLSB   = (1 << 9),
+	/** Adapt the periodic refreshes of every context to the feedback: every
+	 *  NACK makes them twice more frequent, every refresh period with
+	 *  feedback but no NACK makes them twice less frequent, up to 8 times
+	 *  (fewer refreshes on clean links, faster repairs on lossy links) */
+	ROHC_COMP_FEATURE_ADAPTIVE_REFRESHES = (1 << 10),
+	/** Remember the flows sent with the Uncompressed profile (IP fragments,
+	 *  unknown protocols, compression failures...), so that their next
+	 *  packets skip the probing of the compression profiles as long as their
+	 *  Uncompressed context lives (best with \ref ROHC_COMP_FEATURE_FLOW_KEY,
+	 *  otherwise all the flows of one transport protocol between the same
+	 *  hosts are remembered together) */
+	ROHC_COMP_FEATURE_UNCOMP_CACHE    = (1 << 11),
+	/** Initialize the new TCP contexts with IR-CR packets that replicate the
+	 *  static part of one recent TCP context between the same hosts (RFC
+	 *  4164) instead of IR packets (fewer bytes for the short-lived TCP
+	 *  connections, the decompressor shall support IR-CR packets) */
+	ROHC_COMP_FEATURE_CONTEXT_REPLICATION = (1 << 12),
+	/** Only estimate the sizes of the ROHC packets: the contexts, their
+	 *  state machines and the packet types evolve as usual, but the header
+	 *  CRCs are not computed and left to zero, so the ROHC packets cannot be
+	 *  decompressed (capacity planning over large captures, best with
+	 *  \ref rohc_compress_hdr that copies no payload) */
+	ROHC_COMP_FEATURE_ESTIMATE        = (1 << 13),
+	/** Compress the packets of one context one after the other in the
+	 *  groups of packets of \ref rohc_compress_burst, so that every context
+	 *  is loaded in cache once per group; the packets of one flow keep their
+	 *  order and the ROHC packets keep the slots of their uncompressed
+	 *  packets (ignored if ROHC segmentation is enabled, see
+	 *  \ref rohc_comp_set_mrru) */
+	ROHC_COMP_FEATURE_BURST_GROUPING  = (1 << 14),
 
 } rohc_comp_features_t;
 
 
+/**
+ * @brief The compression effort levels of the ROHC compressor
+ *
+ * Like the levels of general-purpose compressors, the effort level trades
+ * CPU per packet for the size of the ROHC headers. It may be set with the
+ * function \ref rohc_comp_set_effort.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_set_effort
+ */
+typedef enum
+{
+	/** Skip the searches for the smallest packet types: the IP, UDP,
+	 *  UDP-Lite and ESP profiles send their UOR-2 packets with extension 3
+	 *  and the TCP profile sends co_common instead of the seq_X/rnd_X
+	 *  packets (fewer W-LSB encodings and decisions, larger headers in FO
+	 *  and SO states) */
+	ROHC_COMP_EFFORT_FAST    = 0,
+	/** Send the first packet type that fits the RFC rules (default) */
+	ROHC_COMP_EFFORT_DEFAULT = 1,
+	/** Encode every packet type that fits and send the smallest one, as
+	 *  \ref ROHC_COMP_FEATURE_SMALLEST_PACKETS does */
+	ROHC_COMP_EFFORT_BEST    = 2,
+
+} rohc_comp_effort_t;
+
+
+/**
+ * @brief The hints about one uncompressed packet
+ *
+ * The flags tell which hints of \ref rohc_comp_pkt_hints are given.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress_hinted
+ */
+typedef enum
+{
+	/** No hint is given, the packet is parsed as usual */
+	ROHC_COMP_HINT_NONE         = 0,
+	/** The offsets and the transport protocol are given */
+	ROHC_COMP_HINT_OFFSETS      = (1 << 0),
+	/** The checksums of all the IPv4 headers were checked and are good */
+	ROHC_COMP_HINT_IP_CSUM_GOOD = (1 << 1),
+
+} rohc_comp_hint_flags_t;
+
+
+/**
+ * @brief The locations and types of the headers of one uncompressed packet
+ *
+ * The hints are given by the program that already knows them, eg. from the
+ * packet type and header lengths given by the NIC, so that the compressor
+ * does not find them again. The offsets are relative to the beginning of
+ * the outer IP header, the packet may hold one or two IP headers.
+ *
+ * The offsets are lightly checked against the IP headers, and the packet is
+ * parsed as usual if they do not match. The IPv6 extension headers between
+ * one IPv6 header and the next header are trusted, they are not walked.
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_compress_hinted
+ * @see rohc_compress_burst_hinted
+ */
+struct rohc_comp_pkt_hints
+{
+	/** The offset of the inner IP header, 0 if the packet is not tunneled */
+	uint16_t inner_ip_offset;
+	/** The offset of the transport header, after the IP headers and their
+	 *  IPv6 extension headers */
+	uint16_t transport_offset;
+	/** The protocol of the transport header, see the IANA protocol numbers */
+	uint8_t transport_proto;
+	/** The hints that are given, see \ref rohc_comp_hint_flags_t */
+	uint8_t flags;
+};
+
+
+/**
+ * @brief The runtime configuration of one ROHC compressor
+ *
+ * The tunables that may be changed while the compressor is running, see
+ * \ref rohc_comp_get_cfg and \ref rohc_comp_publish_cfg. Every field has
+ * the meaning of the parameter of the corresponding setter.
+ *
+ * @ingroup rohc_comp
+ */
+struct rohc_comp_cfg
+{
+	/** The enabled features, see \ref rohc_comp_set_features */
+	rohc_comp_features_t features;
+	/** The timeout (in packets) of the periodic refreshes to IR, see
+	 *  \ref rohc_comp_set_periodic_refreshes */
+	size_t refresh_ir_timeout;
+	/** The timeout (in packets) of the periodic refreshes to FO, see
+	 *  \ref rohc_comp_set_periodic_refreshes */
+	size_t refresh_fo_timeout;
+	/** The timeout (in ms) of the periodic refreshes to IR, see
+	 *  \ref rohc_comp_set_periodic_refreshes_time */
+	size_t refresh_ir_time;
+	/** The timeout (in ms) of the periodic refreshes to FO, see
+	 *  \ref rohc_comp_set_periodic_refreshes_time */
+	size_t refresh_fo_time;
+	/** The bytes of IR headers per interval, see \ref rohc_comp_set_ir_pacing */
+	size_t ir_pacing_budget;
+	/** The interval (in ms) of the IR pacing, see \ref rohc_comp_set_ir_pacing */
+	size_t ir_pacing_interval;
+	/** The idle timeout (in seconds) of the contexts, see
+	 *  \ref rohc_comp_set_ctxt_idle_timeout */
+	size_t ctxt_idle_timeout;
+	/** The time (in seconds) the contexts of the ended flows are kept, see
+	 *  \ref rohc_comp_set_closed_ctxt_linger */
+	size_t closed_ctxt_linger;
+	/** The memory budget (in bytes), see \ref rohc_comp_set_mem_budget */
+	size_t mem_budget;
+	/** The lowest priority class of the compressed flows, see
+	 *  \ref rohc_comp_set_compress_min_priority */
+	unsigned int compress_min_priority;
+	/** The load beyond which the compressor sheds work, see
+	 *  \ref rohc_comp_set_overload */
+	struct rohc_load overload_limits;
+	/** The compression effort level, see \ref rohc_comp_set_effort */
+	rohc_comp_effort_t effort;
+};
+
+
 /**
  * @brief The prototype of the RTP detection callback
  *
@@ -268,6 +580,34 @@ typedef bool (*rohc_rtp_detection_callback_t)(const unsigned char *const ip,
 	__attribute__((warn_unused_result));
 
 
+/**
+ * @brief The prototype of the callback for the priority classes of flows
+ *
+ * User-defined function that is called by the ROHC library for the first
+ * packet of every new flow to classify the flow. The higher the class, the
+ * more valuable the flow: when all the CIDs are in use, the context of a
+ * flow is never recycled for a flow of lower class. The flows of classes
+ * lower than the one set by \ref rohc_comp_set_compress_min_priority are
+ * not compressed.
+ *
+ * The user-defined function is set by calling the function
+ * \ref rohc_comp_set_priority_cb
+ *
+ * @param packet        The uncompressed IP packet of the new flow
+ * @param packet_len    The length of the IP packet (in bytes)
+ * @param priv_ctxt     A pointer to a memory area to be used by the callback
+ *                      function, may be NULL.
+ * @return              The priority class of the flow, 0 being the lowest
+ *
+ * @see rohc_comp_set_priority_cb
+ * @ingroup rohc_comp
+ */
+typedef unsigned int (*rohc_comp_priority_callback_t)(const unsigned char *const packet,
+                                                      const size_t packet_len,
+                                                      void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
+
 /**
  * @brief The prototype of the callback for random numbers
  *
@@ -290,6 +630,46 @@ typedef int (*rohc_comp_random_cb_t) (const struct rohc_comp *const comp,
 	__attribute__((warn_unused_result));
 
 
+/**
+ * @brief The prototype of the callback for allocating memory
+ *
+ * User-defined function that is called when the ROHC compressor requires
+ * memory for its contexts and their profile-specific parts. The compressor
+ * requests memory by chunks of several contexts, and reuses the memory of
+ * recycled contexts for the next ones. The returned memory shall be aligned
+ * as the memory returned by malloc().
+ *
+ * The user-defined functions are set by calling the function
+ * \ref rohc_comp_set_alloc_cbs
+ *
+ * @param size  The size of the memory to allocate (in bytes)
+ * @param priv  The private data given by the user when he/she called the
+ *              \ref rohc_comp_set_alloc_cbs function, may be NULL.
+ * @return      The allocated memory, NULL if no memory is available
+ *
+ * @see rohc_comp_set_alloc_cbs
+ * @ingroup rohc_comp
+ */
+typedef void * (*rohc_comp_alloc_cb_t) (const size_t size, void *const priv)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief The prototype of the callback for freeing memory
+ *
+ * User-defined function that is called when the ROHC compressor releases
+ * memory previously obtained from the \ref rohc_comp_alloc_cb_t callback.
+ *
+ * @param ptr   The memory to free
+ * @param priv  The private data given by the user when he/she called the
+ *              \ref rohc_comp_set_alloc_cbs function, may be NULL.
+ *
+ * @see rohc_comp_set_alloc_cbs
+ * @ingroup rohc_comp
+ */
+typedef void (*rohc_comp_free_cb_t) (void *const ptr, void *const priv);
+
+
 /*
  * Prototypes of main public functions related to ROHC compression
  */
@@ -300,6 +680,28 @@ struct rohc_comp * ROHC_EXPORT rohc_comp_new2(const rohc_cid_type_t cid_type,
                                               void *const rand_priv)
 	__attribute__((warn_unused_result));
 
+struct rohc_comp * ROHC_EXPORT rohc_comp_new3(const rohc_cid_type_t cid_type,
+                                              const rohc_cid_t max_cid,
+                                              const rohc_comp_random_cb_t rand_cb,
+                                              void *const rand_priv,
+                                              const struct rohc_mem_ops *const mem_ops)
+	__attribute__((warn_unused_result));
+
+struct rohc_comp * ROHC_EXPORT rohc_comp_new_static(const rohc_cid_type_t cid_type,
+                                                    const rohc_cid_t max_cid,
+                                                    const rohc_comp_random_cb_t rand_cb,
+                                                    void *const rand_priv,
+                                                    void *const mem,
+                                                    const size_t mem_len)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_comp_mem_size(const rohc_cid_type_t cid_type,
+                                      const rohc_cid_t max_cid,
+                                      const rohc_profile_t profiles[],
+                                      const size_t profiles_nr,
+                                      const size_t wlsb_width)
+	__attribute__((warn_unused_result));
+
 void ROHC_EXPORT rohc_comp_free(struct rohc_comp *const comp);
 
 bool ROHC_EXPORT rohc_comp_set_traces_cb2(struct rohc_comp *const comp,
@@ -307,18 +709,134 @@ bool ROHC_EXPORT rohc_comp_set_traces_cb2(struct rohc_comp *const comp,
                                           void *const priv_ctxt)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_trace_ring(struct rohc_comp *const comp,
+                                          struct rohc_trace_ring *const ring)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_trace_events(struct rohc_comp *const comp,
+                                            const uint32_t events)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_trace_filter_add_cid(struct rohc_comp *const comp,
+                                                const rohc_cid_t cid)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_trace_filter_add_profile(struct rohc_comp *const comp,
+                                                    const rohc_profile_t profile)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_trace_filter_add_packet_type(struct rohc_comp *const comp,
+                                                        const rohc_packet_t packet_type)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_trace_filter_add_flow(struct rohc_comp *const comp,
+                                                 const struct rohc_buf packet)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_trace_filter_clear(struct rohc_comp *const comp)
+	__attribute__((warn_unused_result));
+
 rohc_status_t ROHC_EXPORT rohc_compress4(struct rohc_comp *const comp,
                                          const struct rohc_buf uncomp_packet,
                                          struct rohc_buf *const rohc_packet)
 	__attribute__((warn_unused_result));
 
+size_t ROHC_EXPORT rohc_compress_burst(struct rohc_comp *const comp,
+                                      const struct rohc_buf uncomp_packets[],
+                                      struct rohc_buf rohc_packets[],
+                                      rohc_status_t status[],
+                                      const size_t pkts_nr)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_hinted(struct rohc_comp *const comp,
+                                               const struct rohc_buf uncomp_packet,
+                                               const struct rohc_comp_pkt_hints *const hints,
+                                               struct rohc_buf *const rohc_packet)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_compress_burst_hinted(struct rohc_comp *const comp,
+                                             const struct rohc_buf uncomp_packets[],
+                                             const struct rohc_comp_pkt_hints hints[],
+                                             struct rohc_buf rohc_packets[],
+                                             rohc_status_t status[],
+                                             const size_t pkts_nr)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_hdr(struct rohc_comp *const comp,
+                                            const struct rohc_buf uncomp_packet,
+                                            struct rohc_buf *const rohc_hdr,
+                                            size_t *const payload_offset)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_compress_hdr_burst(struct rohc_comp *const comp,
+                                          const struct rohc_buf uncomp_packets[],
+                                          struct rohc_buf rohc_hdrs[],
+                                          size_t payload_offsets[],
+                                          rohc_status_t status[],
+                                          const size_t pkts_nr)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_compress_inplace(struct rohc_comp *const comp,
+                                                struct rohc_buf *const packet)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_predict_size(const struct rohc_comp *const comp,
+                                        const struct rohc_buf uncomp_packet,
+                                        size_t *const rohc_max_len)
+	__attribute__((warn_unused_result));
+
 rohc_status_t ROHC_EXPORT rohc_comp_get_segment2(struct rohc_comp *const comp,
                                                  struct rohc_buf *const segment)
 	__attribute__((warn_unused_result));
 
+size_t ROHC_EXPORT rohc_comp_get_segments(struct rohc_comp *const comp,
+                                          const size_t max_segment_len,
+                                          struct rohc_buf_vec segments[],
+                                          const size_t segments_max)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_force_contexts_reinit(struct rohc_comp *const comp)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_save_contexts(const struct rohc_comp *const comp,
+                                         uint8_t *const blob,
+                                         const size_t blob_max_len,
+                                         size_t *const blob_len)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_restore_contexts(struct rohc_comp *const comp,
+                                            const uint8_t *const blob,
+                                            const size_t blob_len)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_move_context(struct rohc_comp *const from,
+                                        const rohc_cid_t from_cid,
+                                        struct rohc_comp *const to,
+                                        const rohc_cid_t to_cid)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_provision_context(struct rohc_comp *const comp,
+                                             const rohc_cid_t cid,
+                                             const rohc_profile_t profile_id,
+                                             const struct rohc_buf pkts[],
+                                             const size_t pkts_nr,
+                                             struct rohc_buf *const descr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_get_store_len(const struct rohc_comp *const comp,
+                                         size_t *const len)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_sync_store(struct rohc_comp *const comp,
+                                      uint8_t *const store,
+                                      const size_t store_len)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_takeover_store(struct rohc_comp *const comp,
+                                          const uint8_t *const store,
+                                          const size_t store_len)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Prototypes of public functions related to user interaction
@@ -357,19 +875,129 @@ bool ROHC_EXPORT rohc_comp_get_cid_type(const struct rohc_comp *const comp,
                                         rohc_cid_type_t *const cid_type)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_priority_cb(struct rohc_comp *const comp,
+                                           rohc_comp_priority_callback_t callback,
+                                           void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_compress_min_priority(struct rohc_comp *const comp,
+                                                     const unsigned int min_priority)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_set_rtp_detection_cb(struct rohc_comp *const comp,
                                                 rohc_rtp_detection_callback_t callback,
                                                 void *const rtp_private)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_add_rtp_ports(struct rohc_comp *const comp,
+                                         const uint16_t first_port,
+                                         const uint16_t last_port)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_remove_rtp_ports(struct rohc_comp *const comp,
+                                            const uint16_t first_port,
+                                            const uint16_t last_port)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_reset_rtp_ports(struct rohc_comp *const comp)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_rtp_ts_timer(struct rohc_comp *const comp,
+                                            const bool enabled,
+                                            const size_t max_jitter_cd)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_set_features(struct rohc_comp *const comp,
                                         const rohc_comp_features_t features)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_effort(struct rohc_comp *const comp,
+                                      const rohc_comp_effort_t effort)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_alloc_cbs(struct rohc_comp *const comp,
+                                         rohc_comp_alloc_cb_t alloc_cb,
+                                         rohc_comp_free_cb_t free_cb,
+                                         void *const priv)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_deliver_feedback2(struct rohc_comp *const comp,
                                              const struct rohc_buf feedback)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_deliver_feedbacks(struct rohc_comp *const comp,
+                                             const struct rohc_buf *const feedbacks,
+                                             const size_t feedbacks_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_enqueue_feedback(struct rohc_comp *const comp,
+                                            const struct rohc_buf feedback)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_piggyback_feedback(struct rohc_comp *const comp,
+                                              const struct rohc_buf feedback)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_piggyback_max_len(struct rohc_comp *const comp,
+                                                 const size_t max_len)
+	__attribute__((warn_unused_result));
+
+
+/*
+ * Prototypes of public functions related to sharded ROHC compression
+ */
+
+struct rohc_comp_shards * ROHC_EXPORT
+	rohc_comp_shards_new(const rohc_cid_type_t cid_type,
+	                     const rohc_cid_t max_cid,
+	                     const size_t shards_nr,
+	                     const rohc_comp_random_cb_t rand_cb,
+	                     void *const rand_priv)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_comp_shards_free(struct rohc_comp_shards *const shards);
+
+struct rohc_comp * ROHC_EXPORT
+	rohc_comp_shards_get(const struct rohc_comp_shards *const shards,
+	                     const size_t shard_id)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_shards_select(const struct rohc_comp_shards *const shards,
+                                         const struct rohc_buf uncomp_packet,
+                                         size_t *const shard_id)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_shards_select_cid(const struct rohc_comp_shards *const shards,
+                                             const rohc_cid_t cid,
+                                             size_t *const shard_id)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_shards_enqueue_feedback(struct rohc_comp_shards *const shards,
+                                                   const struct rohc_buf feedback)
+	__attribute__((warn_unused_result));
+
+
+/*
+ * Prototypes of public functions related to multi-channel ROHC compression
+ */
+
+struct rohc_comp_engine * ROHC_EXPORT
+	rohc_comp_engine_new(const struct rohc_mem_ops *const mem_ops)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_comp_engine_free(struct rohc_comp_engine *const engine);
+
+struct rohc_comp * ROHC_EXPORT
+	rohc_comp_engine_new_channel(struct rohc_comp_engine *const engine,
+	                             const rohc_cid_type_t cid_type,
+	                             const rohc_cid_t max_cid,
+	                             const rohc_comp_random_cb_t rand_cb,
+	                             void *const rand_priv)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_comp_engine_get_channels_nr(const struct rohc_comp_engine *const engine)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Prototypes of public functions that configure robustness to packet
@@ -380,15 +1008,71 @@ bool ROHC_EXPORT rohc_comp_set_wlsb_window_width(struct rohc_comp *const comp,
                                                  const size_t width)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_get_wlsb_window_width(const struct rohc_comp *const comp,
+                                                 size_t *const width)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_set_periodic_refreshes(struct rohc_comp *const comp,
                                                   const size_t ir_timeout,
                                                   const size_t fo_timeout)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_get_periodic_refreshes(const struct rohc_comp *const comp,
+                                                  size_t *const ir_timeout,
+                                                  size_t *const fo_timeout)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_periodic_refreshes_time(struct rohc_comp *const comp,
+                                                       const size_t ir_timeout,
+                                                       const size_t fo_timeout)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_get_periodic_refreshes_time(const struct rohc_comp *const comp,
+                                                       size_t *const ir_timeout,
+                                                       size_t *const fo_timeout)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_ir_pacing(struct rohc_comp *const comp,
+                                         const size_t budget,
+                                         const size_t interval)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_set_list_trans_nr(struct rohc_comp *const comp,
                                              const size_t list_trans_nr)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_set_ctxt_idle_timeout(struct rohc_comp *const comp,
+                                                 const size_t timeout)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_closed_ctxt_linger(struct rohc_comp *const comp,
+                                                  const size_t linger)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_mem_budget(struct rohc_comp *const comp,
+                                          const size_t budget)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_get_mem_usage(const struct rohc_comp *const comp,
+                                         size_t *const usage)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_overload(struct rohc_comp *const comp,
+                                        const struct rohc_load *const limits)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_set_load(struct rohc_comp *const comp,
+                                    const struct rohc_load *const load)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_get_cfg(const struct rohc_comp *const comp,
+                                   struct rohc_comp_cfg *const cfg)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_comp_publish_cfg(struct rohc_comp *const comp,
+                                       const struct rohc_comp_cfg *const cfg)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Prototypes of public functions related to ROHC compression statistics
@@ -398,14 +1082,27 @@ bool ROHC_EXPORT rohc_comp_get_general_info(const struct rohc_comp *const comp,
                                             rohc_comp_general_info_t *const info)
 	__attribute__((warn_unused_result));
 
+size_t ROHC_EXPORT rohc_comp_get_contexts(const struct rohc_comp *const comp,
+                                          struct rohc_comp_ctxt_record records[],
+                                          const size_t records_max)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_comp_get_last_packet_info2(const struct rohc_comp *const comp,
                                                  rohc_comp_last_packet_info2_t *const info)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_comp_get_perf_stats(const struct rohc_comp *const comp,
+                                          struct rohc_comp_perf_stats *const stats)
+	__attribute__((warn_unused_result));
+
 const char * ROHC_EXPORT rohc_comp_get_state_descr(const rohc_comp_state_t state)
 	__attribute__((warn_unused_result, const));
 
 
+#if defined(__GNUC__) && __GNUC__ >= 4
+#  pragma GCC visibility pop
+#endif
+
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
 #ifdef __cplusplus
@@ -0,0 +1,281 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_comp_engine.c
+ * @brief  ROHC multi-channel compression engine
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * A compression engine hosts many ROHC channels: every channel is a regular
+ * ROHC compressor with its own CID space and its own parameters, but the
+ * contexts of all the channels are allocated from one slab shared by the
+ * engine, and the static header fragments of all the channels (eg. the IPv6
+ * addresses of the TCP contexts) are interned in one store shared by the
+ * engine. The blocks released by the contexts of one channel are thus reused
+ * by the contexts of the other channels, and creating a channel allocates
+ * no chunk of contexts.
+ *
+ * The other runtime state of the library (CRC tables, profiles...) is made
+ * of constants already shared by all the compressors.
+ *
+ * The pools of the engine are not locked: all the channels of one engine
+ * shall be used by the same thread. Use one engine per thread, or a sharded
+ * compressor, to compress packets from several threads.
+ */
+
+#include "rohc_comp_internals.h"
+#include "rohc_mem.h"
+
+#include <assert.h>
+
+
+/**
+ * @brief The multi-channel ROHC compression engine
+ */
+struct rohc_comp_engine
+{
+	/** The slab the contexts of all the channels are allocated from */
+	struct rohc_slab ctxt_slab;
+	/** The static header fragments shared by the contexts of all the
+	 *  channels */
+	struct rohc_intern static_store;
+
+	/** The functions all the memory of the engine and of its channels is
+	 *  allocated with */
+	struct rohc_mem_ops mem_ops;
+
+	/** The number of channels not freed yet */
+	size_t channels_nr;
+	/** Whether the engine was freed by the user, it is released with its
+	 *  last channel */
+	bool is_freed;
+};
+
+
+static void rohc_comp_engine_release(struct rohc_comp_engine *const engine)
+	__attribute__((nonnull(1)));
+
+
+/*
+ * Definitions of public functions
+ */
+
+/**
+ * @brief Create a new multi-channel ROHC compression engine
+ *
+ * Create a new engine that hosts many ROHC channels created with
+ * \ref rohc_comp_engine_new_channel. The contexts of all the channels are
+ * allocated from pools shared by the engine.
+ *
+ * All the channels of one engine shall be used by the same thread, since
+ * the shared pools are not locked.
+ *
+ * @param mem_ops  The functions to allocate all the memory of the engine and
+ *                 of its channels with, NULL for malloc() and free()
+ * @return         The created engine if successful,
+ *                 NULL if creation failed
+ *
+ * @warning Don't forget to free the engine with \ref rohc_comp_engine_free
+ *          if \e rohc_comp_engine_new succeeded
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_engine_free
+ * @see rohc_comp_engine_new_channel
+ */
+struct rohc_comp_engine * rohc_comp_engine_new(const struct rohc_mem_ops *const mem_ops)
+{
+	const struct rohc_mem_ops default_mem_ops = { NULL, NULL, NULL, NULL };
+	const struct rohc_mem_ops *const ops =
+		(mem_ops != NULL ? mem_ops : &default_mem_ops);
+	struct rohc_comp_engine *engine;
+
+	if(!rohc_mem_ops_check(mem_ops))
+	{
+		goto error;
+	}
+
+	engine = rohc_mem_aligned_alloc(ops, ROHC_MEM_CACHE_LINE_LEN,
+	                                sizeof(struct rohc_comp_engine));
+	if(engine == NULL)
+	{
+		goto error;
+	}
+	memset(engine, 0, sizeof(struct rohc_comp_engine));
+	engine->mem_ops = *ops;
+
+	rohc_slab_init(&engine->ctxt_slab);
+	if(ops->alloc != NULL &&
+	   !rohc_slab_set_cbs(&engine->ctxt_slab, ops->alloc, ops->free, ops->priv))
+	{
+		goto free_engine;
+	}
+	rohc_intern_init(&engine->static_store, &engine->ctxt_slab,
+	                 &engine->mem_ops);
+
+	engine->channels_nr = 0;
+	engine->is_freed = false;
+
+	return engine;
+
+free_engine:
+	rohc_mem_free(ops, engine);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the given multi-channel ROHC compression engine
+ *
+ * The engine is released once all its channels are freed with
+ * \ref rohc_comp_free: the channels remain usable until then, but no new
+ * channel may be created.
+ *
+ * @param engine  The engine to destroy
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_engine_new
+ */
+void rohc_comp_engine_free(struct rohc_comp_engine *const engine)
+{
+	if(engine != NULL && !engine->is_freed)
+	{
+		engine->is_freed = true;
+		if(engine->channels_nr == 0)
+		{
+			rohc_comp_engine_release(engine);
+		}
+	}
+}
+
+
+/**
+ * @brief Create a new channel in the given ROHC compression engine
+ *
+ * The channel is a regular ROHC compressor created like with
+ * \ref rohc_comp_new3 with the memory operations of the engine: configure
+ * it and compress packets with the usual functions, then free it with
+ * \ref rohc_comp_free. Its contexts are allocated from the pools of the
+ * engine, so its memory usage includes the pools shared with the other
+ * channels. The memory functions of a channel cannot be changed with
+ * \ref rohc_comp_set_alloc_cbs.
+ *
+ * @param engine     The engine to create the channel in
+ * @param cid_type   The type of Context IDs (CID) that the channel shall
+ *                   operate with, see \ref rohc_comp_new3
+ * @param max_cid    The maximum value that the channel should use for
+ *                   context IDs (CID), see \ref rohc_comp_new3
+ * @param rand_cb    The random callback of the channel
+ * @param rand_priv  Private data that will be given to the callback
+ * @return           The created channel if successful,
+ *                   NULL if creation failed
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_engine_new
+ * @see rohc_comp_free
+ */
+struct rohc_comp * rohc_comp_engine_new_channel(struct rohc_comp_engine *const engine,
+                                                const rohc_cid_type_t cid_type,
+                                                const rohc_cid_t max_cid,
+                                                const rohc_comp_random_cb_t rand_cb,
+                                                void *const rand_priv)
+{
+	const struct rohc_mem_ops *mem_ops;
+	struct rohc_comp *comp;
+
+	if(engine == NULL || engine->is_freed)
+	{
+		goto error;
+	}
+
+	/* malloc() and free() are used if the engine was given no function */
+	mem_ops = (engine->mem_ops.alloc != NULL ? &engine->mem_ops : NULL);
+	comp = rohc_comp_new3(cid_type, max_cid, rand_cb, rand_priv, mem_ops);
+	if(comp == NULL)
+	{
+		goto error;
+	}
+
+	/* the channel allocates its contexts from the pools of the engine */
+	comp->ctxt_slab = &engine->ctxt_slab;
+	comp->static_store = &engine->static_store;
+	comp->engine = engine;
+	engine->channels_nr++;
+
+	return comp;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Get the number of channels of the given ROHC compression engine
+ *
+ * @param engine  The engine
+ * @return        The number of channels not freed yet, 0 if \e engine is NULL
+ *
+ * @ingroup rohc_comp
+ */
+size_t rohc_comp_engine_get_channels_nr(const struct rohc_comp_engine *const engine)
+{
+	return (engine != NULL ? engine->channels_nr : 0);
+}
+
+
+/*
+ * Definitions of private functions
+ */
+
+/**
+ * @brief Release one channel of the given ROHC compression engine
+ *
+ * Called when one channel is freed: the engine is released with its last
+ * channel if it was freed by the user.
+ *
+ * @param engine  The engine of the freed channel
+ */
+void rohc_comp_engine_put(struct rohc_comp_engine *const engine)
+{
+	assert(engine->channels_nr > 0);
+	engine->channels_nr--;
+	if(engine->channels_nr == 0 && engine->is_freed)
+	{
+		rohc_comp_engine_release(engine);
+	}
+}
+
+
+/**
+ * @brief Release the pools and the memory of the given engine
+ *
+ * @param engine  The engine to release
+ */
+static void rohc_comp_engine_release(struct rohc_comp_engine *const engine)
+{
+	/* the memory operations are stored in the engine itself */
+	const struct rohc_mem_ops mem_ops = engine->mem_ops;
+
+	assert(engine->channels_nr == 0);
+	rohc_intern_release(&engine->static_store);
+	rohc_slab_release(&engine->ctxt_slab);
+	rohc_mem_free(&mem_ops, engine);
+}
@@ -29,11 +29,20 @@
 
 #include "rohc_internal.h"
 #include "rohc_traces_internal.h"
+#include "rohc_perf_internal.h"
 #include "rohc_packets.h"
 #include "rohc_comp.h"
 #include "schemes/comp_wlsb.h"
+#include "schemes/cid.h"
 #include "net_pkt.h"
 #include "feedback.h"
+#include "rohc_slab.h"
+#include "rohc_intern.h"
+#include "crc.h"
+#include "rohc_seqlock.h"
+#include "rohc_burst.h"
+
+#include "config.h" /* for ROHC_COMP_STATS */
 
 #ifdef __KERNEL__
 #  include <linux/types.h>
@@ -46,8 +55,12 @@
  * Constants and macros
  */
 
-/** The number of ROHC profiles ready to be used */
-#define C_NUM_PROFILES 7U
+/** The number of ROHC profiles ready to be used: the IP-only (v1 and v2),
+ *  UDP, RTP and Uncompressed profiles are always built, the other ones may
+ *  be disabled at build time */
+#define C_NUM_PROFILES \
+	(5U + ROHC_BUILD_PROFILE_UDPLITE + ROHC_BUILD_PROFILE_ESP + \
+	 ROHC_BUILD_PROFILE_TCP)
 
 /** The default maximal number of packets sent in > IR states (= FO and SO
  *  states) before changing back the state to IR (periodic refreshes) */
@@ -77,6 +90,128 @@
  */
 #define ROHC_LIST_DEFAULT_L  5U
 
+/** The value of an empty slot in the hash index of compression contexts */
+#define ROHC_COMP_CTXT_INDEX_EMPTY  ((rohc_cid_t) -1)
+
+/** The minimal number of slots in the hash index of compression contexts */
+#define ROHC_COMP_CTXT_INDEX_MIN_LEN  16U
+
+/** The number of compression contexts allocated together in one page */
+#define ROHC_COMP_CTXT_PAGE_LEN  64U
+
+/** The number of CIDs tracked by one word of the bitmap of the used CIDs */
+#define ROHC_COMP_CIDS_WORD_LEN  64U
+
+/** The number of words of the summary of the bitmap of the used CIDs: one
+ *  bit per word of the bitmap, set once all the CIDs of the word are used */
+#define ROHC_COMP_CIDS_SUMMARY_LEN \
+	(((ROHC_LARGE_CID_MAX + 1) / ROHC_COMP_CIDS_WORD_LEN + \
+	  ROHC_COMP_CIDS_WORD_LEN - 1) / ROHC_COMP_CIDS_WORD_LEN)
+
+/** The number of feedback items in the queue of feedback delivered by
+ *  another thread (power of 2) */
+#define ROHC_COMP_FEEDBACK_QUEUE_LEN  16U
+
+/** The maximal length of one feedback item in the queue of feedback
+ *  delivered by another thread */
+#define ROHC_COMP_FEEDBACK_QUEUE_ITEM_MAX_LEN  128U
+
+/** The default maximal number of bytes of feedback piggybacked ahead of one
+ *  ROHC packet */
+#define ROHC_COMP_PIGGYBACK_MAX_LEN_DEFAULT  \
+	(ROHC_COMP_FEEDBACK_QUEUE_LEN * ROHC_COMP_FEEDBACK_QUEUE_ITEM_MAX_LEN)
+
+/** The room kept in the output buffer for the ROHC header on top of the
+ *  uncompressed headers when feedback is piggybacked */
+#define ROHC_COMP_PIGGYBACK_HDR_ROOM  32U
+
+/** The maximal growth of the headers of one packet by compression, besides
+ *  the growth of every IP header: the IR fields (packet type, profile, CRC
+ *  and large CID), the transport fields that are not in the uncompressed
+ *  headers (eg. the RTP strides or the TCP MSN) and the overhead of the
+ *  compressed lists of TCP options and RTP CSRCs */
+#define ROHC_COMP_HDRS_GROWTH_MAX  48U
+
+/** The maximal growth of one IP header by compression, besides its IPv6
+ *  extension headers: the header of the compressed list of extension headers
+ *  and the fields of the dynamic chain that are not in the IP header */
+#define ROHC_COMP_IP_HDR_GROWTH_MAX  4U
+
+/** The maximal length of the uncompressed headers recorded per context to
+ *  save the contexts, the contexts with longer headers are not saved */
+#define ROHC_COMP_CKPT_HDRS_MAX  128U
+
+/** The number of packets recorded per context to save the contexts: as many
+ *  packets as the changes of the fields are repeated (see MAX_IR_COUNT and
+ *  MAX_FO_COUNT) */
+#define ROHC_COMP_CKPT_PKTS_NR  3U
+
+/** The minimal number of entries kept in the W-LSB windows of one context
+ *  when the width of the windows is adapted to the packets in flight */
+#define ROHC_COMP_WLSB_WIDTH_MIN  4U
+
+/** The number of consecutive ACKs with few packets in flight required to
+ *  halve the width of the W-LSB windows of one context */
+#define ROHC_COMP_WLSB_SHRINK_ACKS  8U
+
+/** The maximal power of 2 the periodic refreshes of one context are made
+ *  more or less frequent by, see \ref ROHC_COMP_FEATURE_ADAPTIVE_REFRESHES */
+#define ROHC_COMP_REFRESH_SCALE_MAX  3
+
+/** All the features supported by the compressor */
+#define ROHC_COMP_FEATURES_ALL \
+	(ROHC_COMP_FEATURE_NO_IP_CHECKSUMS | \
+	 ROHC_COMP_FEATURE_DUMP_PACKETS | \
+	 ROHC_COMP_FEATURE_FLOW_KEY | \
+	 ROHC_COMP_FEATURE_TRUSTED_FEEDBACK | \
+	 ROHC_COMP_FEATURE_SEGMENT_NO_COPY | \
+	 ROHC_COMP_FEATURE_SMALLEST_PACKETS | \
+	 ROHC_COMP_FEATURE_CHECKPOINT | \
+	 ROHC_COMP_FEATURE_ADAPTIVE_WLSB | \
+	 ROHC_COMP_FEATURE_ADAPTIVE_REFRESHES | \
+	 ROHC_COMP_FEATURE_UNCOMP_CACHE | \
+	 ROHC_COMP_FEATURE_CONTEXT_REPLICATION | \
+	 ROHC_COMP_FEATURE_ESTIMATE | \
+	 ROHC_COMP_FEATURE_BURST_GROUPING)
+
+/** The type of CID of the given compressor, a compile-time constant if the
+ *  library is built for one type of CID only */
+#ifdef ROHC_FIXED_CID_TYPE
+#  define c_cid_type(comp) \
+	((void) (comp), (rohc_cid_type_t) (ROHC_FIXED_CID_TYPE))
+#else
+#  define c_cid_type(comp)  ((comp)->medium.cid_type)
+#endif
+
+/** The features of the given compressor, a compile-time constant if the
+ *  library is built for one set of compression features only */
+#ifdef ROHC_FIXED_COMP_FEATURES
+#  define c_features(comp) \
+	((void) (comp), (rohc_comp_features_t) (ROHC_FIXED_COMP_FEATURES))
+#else
+#  define c_features(comp)  ((comp)->features)
+#endif
+
+/** The number of least recently used contexts the context to recycle is
+ *  chosen among when the flows are classified in priority classes */
+#define ROHC_COMP_RECYCLE_CANDIDATES  8U
+
+/** The number of flows remembered as sent with the Uncompressed profile,
+ *  see \ref ROHC_COMP_FEATURE_UNCOMP_CACHE (power of 2) */
+#define ROHC_COMP_UNCOMP_CACHE_LEN  64U
+
+/** The number of most recently used contexts that are tried before the
+ *  hash index of contexts is walked */
+#define ROHC_COMP_RECENT_CTXTS_NR  4U
+
+/** The number of packets of a burst that are parsed, hashed and prefetched
+ *  together before they are compressed one by one (power of 2) */
+#define ROHC_COMP_BURST_GROUP  8U
+
+/** The number of feedback items of one feedback packet that are located
+ *  together before they are applied context by context */
+#define ROHC_COMP_FEEDBACK_BATCH  ROHC_BURST_GROUP_MAX
+
 
 /** Print a warning trace for the given compression context */
 #define rohc_comp_warn(context, format, ...) \
@@ -93,7 +228,7 @@
 /** Dump a buffer for the given compression context */
 #define rohc_comp_dump_buf(context, descr, buf, buf_len) \
 	do { \
-		if(((context)->compressor->features & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0) { \
+		if((c_features((context)->compressor) & ROHC_COMP_FEATURE_DUMP_PACKETS) != 0) { \
 			rohc_dump_buf((context)->compressor->trace_callback, \
 			              (context)->compressor->trace_callback_priv, \
 			              ROHC_TRACE_COMP, ROHC_TRACE_DEBUG, \
@@ -115,76 +250,232 @@ struct rohc_comp_ctxt;
  */
 
 
+/**
+ * @brief The queue of feedback delivered by another thread
+ *
+ * The queue is a single-producer single-consumer ring: the feedback is
+ * enqueued by one thread with \ref rohc_comp_enqueue_feedback (or with
+ * \ref rohc_comp_piggyback_feedback for the feedback to send), then it is
+ * consumed by the thread of the compressor when the next packets are
+ * compressed. Every index is written by one thread only, so no lock is
+ * required. The two indexes are kept apart so that they share no cache
+ * line.
+ */
+struct rohc_comp_feedback_queue
+{
+	/** The index of the next item to enqueue, written by the producer */
+	uint32_t head;
+	/** The feedback items */
+	struct
+	{
+		/** The length of the feedback data */
+		size_t len;
+		/** The feedback data */
+		uint8_t data[ROHC_COMP_FEEDBACK_QUEUE_ITEM_MAX_LEN];
+	} items[ROHC_COMP_FEEDBACK_QUEUE_LEN];
+	/** The index of the next item to deliver, written by the consumer */
+	uint32_t tail;
+};
+
+
+/**
+ * @brief One feedback item located in a feedback packet
+ *
+ * The feedback items of one feedback packet are first located and bound to
+ * their contexts, then applied context by context, see
+ * \ref rohc_comp_deliver_feedback2.
+ */
+struct rohc_comp_feedback_item
+{
+	/** The feedback data with the CID bits */
+	const uint8_t *data;
+	/** The compression context the feedback is for */
+	struct rohc_comp_ctxt *context;
+	/** The length of the feedback data with the CID bits */
+	uint16_t len;
+	/** The length of the CID bits */
+	uint8_t cid_len;
+	/** Whether a later ACK of the context makes the feedback useless */
+	bool is_superseded;
+	/** The kind of ACK, one bit per kind, 0 if the feedback is not an ACK
+	 *  or if it may do more than acknowledging packets */
+	uint32_t ack_kind;
+};
+
+
+/**
+ * @brief One flow remembered as sent with the Uncompressed profile
+ *
+ * See \ref ROHC_COMP_FEATURE_UNCOMP_CACHE
+ */
+struct rohc_comp_uncomp_flow
+{
+	rohc_ctxt_key_t key;  /**< The key of the flow */
+	uint8_t proto;        /**< The transport protocol of the flow */
+	bool used;            /**< Whether the entry is in use */
+};
+
+
 /**
  * @brief The ROHC compressor
  */
 struct rohc_comp
 {
+	/* variables used for every packet, keep them together at the beginning
+	 * of the structure so that they share the same cache lines */
+
 	/** The medium associated with the decompressor */
 	struct rohc_medium medium;
 
 	/** Enabled/disabled features for the compressor */
 	rohc_comp_features_t features;
+	/** The compression effort level, see \ref rohc_comp_set_effort */
+	rohc_comp_effort_t effort;
 
-	/** The array of compression contexts that use the compressor */
-	struct rohc_comp_ctxt *contexts;
-	/** The number of compression contexts in use in the array */
+	/** The callback function used to manage traces */
+	rohc_trace_callback2_t trace_callback;
+	/** The private context of the callback function used to manage traces */
+	void *trace_callback_priv;
+	/** The ring of binary trace records, NULL if disabled */
+	struct rohc_trace_ring *trace_ring;
+	/** The mask of the events recorded in the ring of binary trace records */
+	uint32_t trace_events;
+	/** The filter that restricts the text traces to some contexts */
+	struct rohc_trace_filter trace_filter;
+
+	/** The pages of compression contexts that use the compressor: context
+	 *  with CID x is stored in page x / ROHC_COMP_CTXT_PAGE_LEN, pages are
+	 *  allocated from the slab of contexts the first time one of their CIDs
+	 *  is used */
+	struct rohc_comp_ctxt **ctxt_pages;
+	/** The number of pages of compression contexts */
+	size_t ctxt_pages_nr;
+	/** The number of compression contexts in use in the pages, see \e stats_seq */
 	size_t num_contexts_used;
+	/** The number of bytes of the records of the last packets of contexts,
+	 *  the pages of contexts are counted in the slab of contexts */
+	size_t ctxts_mem_len;
+	/** The maximum number of bytes the compressor should use, 0 for no
+	 *  limit */
+	size_t mem_budget;
+	/** The load beyond which the compressor sheds work, see
+	 *  \ref rohc_comp_set_overload */
+	struct rohc_load overload_limits;
+	/** Whether the latest load given by the user exceeds the limits */
+	bool is_overloaded;
+	/** The smallest CID that the compressor may use, the CIDs below are
+	 *  used by the other compressors of a sharded compressor if any */
+	rohc_cid_t min_cid;
+	/** The bitmap of the used CIDs: bit x % 64 of word x / 64 is set if the
+	 *  context with CID x is in use, the bits beyond MAX_CID are set */
+	uint64_t *cids_used;
+	/** The number of words of the bitmap of the used CIDs */
+	size_t cids_words_nr;
+	/** The summary of the bitmap of the used CIDs: bit w % 64 of word w / 64
+	 *  is set if all the CIDs of word w of the bitmap are used, so that the
+	 *  smallest unused CID is found without browsing the bitmap */
+	uint64_t cids_full[ROHC_COMP_CIDS_SUMMARY_LEN];
+
+	/** The open-addressing hash index of the contexts in use, keyed on the
+	 *  profile ID and the context key. Every slot contains the CID of one
+	 *  context or \ref ROHC_COMP_CTXT_INDEX_EMPTY */
+	rohc_cid_t *ctxts_index;
+	/** The mask to apply on hashes to get slots in the index (= slots - 1) */
+	size_t ctxts_index_mask;
+
+	/** The most recently used context of the LRU list of contexts in use */
+	struct rohc_comp_ctxt *lru_first;
+	/** The least recently used context of the LRU list of contexts in use,
+	 *  ie. the next context to recycle if all contexts are in use */
+	struct rohc_comp_ctxt *lru_last;
+
+	/** The context of the flow that ended first, in the list of the contexts
+	 *  of the ended flows, ie. the next context to recycle or to release */
+	struct rohc_comp_ctxt *closed_first;
+	/** The context of the flow that ended last, in the list of the contexts
+	 *  of the ended flows */
+	struct rohc_comp_ctxt *closed_last;
+
+	/** The last context used by the compressor */
+	struct rohc_comp_ctxt *last_context;
+	/** The most recently used contexts, the most recent first, NULL for the
+	 *  unused entries, see \ref ROHC_COMP_RECENT_CTXTS_NR */
+	struct rohc_comp_ctxt *recent_ctxts[ROHC_COMP_RECENT_CTXTS_NR];
 
 	/** Which profiles are enabled and with one are not? */
 	bool enabled_profiles[C_NUM_PROFILES];
 
 
-	/* CRC-related variables: */
-
-	/** The table to enable fast CRC-3 computation */
-	uint8_t crc_table_3[256];
-	/** The table to enable fast CRC-7 computation */
-	uint8_t crc_table_7[256];
-	/** The table to enable fast CRC-8 computation */
-	uint8_t crc_table_8[256];
-
-
-	/* segment-related variables */
-
-/** The maximal value for MRRU */
-#define ROHC_MAX_MRRU 65535
-	/** The remaining bytes of the Reconstructed Reception Unit (RRU) waiting
-	 *  to be split into segments */
-	uint8_t rru[ROHC_MAX_MRRU];
-	/** The offset of the remaining bytes in the RRU buffer */
-	size_t rru_off;
-	/** The number of the remaining bytes in the RRU buffer */
-	size_t rru_len;
-
-
 	/* variables related to RTP detection */
 
+/** The number of 64-bit words of the bitmap of the UDP ports for RTP */
+#define ROHC_COMP_RTP_PORTS_WORDS  (65536U / 64U)
+	/** The bitmap of the UDP destination ports reserved for RTP traffic */
+	uint64_t rtp_ports[ROHC_COMP_RTP_PORTS_WORDS];
+	/** The number of UDP destination ports reserved for RTP traffic */
+	size_t rtp_ports_nr;
 	/** The callback function used to detect RTP packet */
 	rohc_rtp_detection_callback_t rtp_callback;
 	/** Pointer to an external memory area provided/used by the callback user */
 	void *rtp_private;
-
-
-	/* some statistics about the compression process: */
-
+	/** The callback function used to classify the new flows, NULL if none */
+	rohc_comp_priority_callback_t priority_callback;
+	/** Pointer to an external memory area provided/used by the callback user */
+	void *priority_private;
+	/** The lowest priority class of the flows compressed with a context of
+	 *  their own, the flows of lower classes share one Uncompressed context */
+	unsigned int compress_min_priority;
+	/** The Uncompressed context shared by the flows not worth a context of
+	 *  their own, NULL if none */
+	struct rohc_comp_ctxt *shared_uncomp_ctxt;
+	/** The flows sent with the Uncompressed profile, indexed by their key,
+	 *  see \ref ROHC_COMP_FEATURE_UNCOMP_CACHE */
+	struct rohc_comp_uncomp_flow uncomp_flows[ROHC_COMP_UNCOMP_CACHE_LEN];
+	/** The packets of a burst parsed before they are compressed, see
+	 *  \ref ROHC_COMP_BURST_GROUP, too large for the stack of the kernel */
+	struct net_pkt burst_pkts[ROHC_COMP_BURST_GROUP];
+	/** Whether the RTP TS may be compressed with timer-based compression */
+	bool rtp_ts_timer;
+	/** The max jitter between compressor and decompressor (in milliseconds)
+	 *  for timer-based compression of the RTP TS */
+	size_t rtp_ts_max_jitter_cd;
+
+
+	/* some statistics about the compression process, they are modified by
+	 * the thread that compresses packets and they may be read by another
+	 * thread, so they are modified between rohc_seqlock_write_begin() and
+	 * rohc_seqlock_write_end() on \e stats_seq: */
+
+	/** The sequence number that protects the statistics */
+	uint32_t stats_seq;
+	/** The information about the last compressed packet, copied from its
+	 *  context so that it remains valid once the context is destroyed */
+	rohc_comp_last_packet_info2_t last_pkt_info;
+	/** Whether a packet was compressed, ie. \e last_pkt_info is valid */
+	bool has_last_pkt_info;
 	/** The number of sent packets */
-	int num_packets;
+	uint64_t num_packets;
+#if ROHC_COMP_STATS == 1
 	/** The size of all the received uncompressed IP packets */
-	int total_uncompressed_size;
+	uint64_t total_uncompressed_size;
 	/** The size of all the sent compressed ROHC packets */
-	int total_compressed_size;
-
-	/** The last context used by the compressor */
-	struct rohc_comp_ctxt *last_context;
-
-
-	/* random callback */
-
-	/** The user-defined callback for random numbers */
-	rohc_comp_random_cb_t random_cb;
-	/** Private data that will be given to the callback for random numbers */
-	void *random_cb_ctxt;
+	uint64_t total_compressed_size;
+#endif
+	/** The number of contexts recycled to make room for new contexts */
+	uint64_t ctxts_recycled_nr;
+	/** The number of feedback items received */
+	uint64_t feedbacks_nr;
+	/** The number of sent ROHC packets per type of ROHC packet */
+	uint64_t packet_types_nr[ROHC_PACKET_MAX];
+	/** The number of times the compressor entered the overload mode */
+	uint64_t overloads_nr;
+	/** The number of packets compressed in overload mode */
+	uint64_t overload_pkts_nr;
+	/** The number of new flows sent uncompressed in overload mode */
+	uint64_t overload_flows_nr;
+	/** The number of packets that deferred a periodic refresh in overload
+	 *  mode */
+	uint64_t overload_refreshes_nr;
 
 
 	/* user interaction variables: */
@@ -197,17 +488,119 @@ struct rohc_comp
 	/** The maximal number of packets sent in > FO states (= SO state)
 	 *  before changing back the state to FO (periodic refreshes) */
 	size_t periodic_refreshes_fo_timeout;
+	/** The maximal time (in milliseconds) spent in > IR states before changing
+	 *  back the state to IR (periodic refreshes), 0 if disabled */
+	size_t periodic_refreshes_ir_time;
+	/** The maximal time (in milliseconds) spent in > FO states before changing
+	 *  back the state to FO (periodic refreshes), 0 if disabled */
+	size_t periodic_refreshes_fo_time;
+	/** The bytes of IR and IR-DYN headers allowed per pacing interval, 0 if
+	 *  the IR packets are not paced, see \ref rohc_comp_set_ir_pacing */
+	size_t ir_pacing_budget;
+	/** The length (in milliseconds) of the IR pacing interval */
+	size_t ir_pacing_interval;
+	/** The bytes of IR and IR-DYN headers still allowed in the interval */
+	size_t ir_pacing_left;
+	/** The start (in milliseconds) of the current IR pacing interval */
+	uint32_t ir_pacing_start;
 	/** Maximum Reconstructed Reception Unit */
 	size_t mrru;
 	/** The connection type (currently not used) */
 	int connection_type;
 	/** The number of uncompressed transmissions for list compression (L) */
 	size_t list_trans_nr;
+	/** The number of seconds a context may stay unused before it is
+	 *  destroyed, 0 if contexts never expire */
+	size_t ctxt_idle_timeout;
+	/** The number of seconds the context of one ended flow is kept before it
+	 *  is destroyed, 0 if the contexts of the ended flows are kept until
+	 *  they are recycled */
+	size_t closed_ctxt_linger;
+
+
+	/* variables used only when contexts are created or destroyed */
+
+	/** The slab the profile-specific parts of the contexts are allocated
+	 *  from, blocks of recycled contexts are kept for the next contexts:
+	 *  the own slab of the compressor, or the slab shared by all the
+	 *  channels of an engine */
+	struct rohc_slab *ctxt_slab;
+	/** The static header fragments shared by the contexts, eg. the IPv6
+	 *  addresses of the TCP contexts: the own store of the compressor, or
+	 *  the store shared by all the channels of an engine */
+	struct rohc_intern *static_store;
+	/** The engine the compressor is one channel of, NULL if none */
+	struct rohc_comp_engine *engine;
+	/** The slab of the compressor when it is not a channel of an engine */
+	struct rohc_slab ctxt_slab_own;
+	/** The store of the compressor when it is not a channel of an engine */
+	struct rohc_intern static_store_own;
+
+	/** The functions all the memory of the compressor is allocated with */
+	struct rohc_mem_ops mem_ops;
 
-	/** The callback function used to manage traces */
-	rohc_trace_callback2_t trace_callback;
-	/** The private context of the callback function used to manage traces */
-	void *trace_callback_priv;
+	/** The user-defined callback for random numbers */
+	rohc_comp_random_cb_t random_cb;
+	/** Private data that will be given to the callback for random numbers */
+	void *random_cb_ctxt;
+
+
+	/* segment-related variables */
+
+/** The maximal value for MRRU */
+#define ROHC_MAX_MRRU 65535
+	/** The remaining bytes of the Reconstructed Reception Unit (RRU) waiting
+	 *  to be split into segments, allocated with MRRU bytes only when a
+	 *  non-zero MRRU is set */
+	uint8_t *rru;
+	/** The offset of the remaining bytes in the RRU */
+	size_t rru_off;
+	/** The number of the remaining bytes in the RRU */
+	size_t rru_len;
+	/** The payload of the RRU if it was not copied in the RRU buffer (see
+	 *  \ref ROHC_COMP_FEATURE_SEGMENT_NO_COPY), NULL otherwise */
+	const uint8_t *rru_payload;
+	/** The offset of the payload in the RRU if it was not copied */
+	size_t rru_payload_off;
+	/** The length of the payload of the RRU if it was not copied, 0 otherwise:
+	 *  the FCS-32 is stored in the RRU buffer right after the ROHC header */
+	size_t rru_payload_len;
+	/** The segment type bytes the segments retrieved at once point to, for
+	 *  the non-final and the final segments (see \ref rohc_comp_get_segments) */
+	uint8_t rru_seg_types[2];
+
+
+	/* variables related to the feedback delivered by another thread */
+
+	/** The queue of feedback delivered by another thread */
+	struct rohc_comp_feedback_queue feedback_queue;
+
+
+	/* variables related to the configuration published by another thread */
+
+	/** The runtime configuration published by another thread and not taken
+	 *  by the compressor yet, NULL if none, see \ref rohc_comp_publish_cfg */
+	struct rohc_comp_cfg *cfg_pending;
+
+
+	/* variables related to the feedback piggybacked ahead of ROHC packets */
+
+	/** The queue of feedback to piggyback ahead of the next ROHC packets */
+	struct rohc_comp_feedback_queue piggyback_queue;
+	/** The maximal number of bytes of feedback piggybacked ahead of one ROHC
+	 *  packet */
+	size_t piggyback_max_len;
+
+#if ROHC_PERF_STATS == 1
+	/* performance-related variables */
+	struct
+	{
+		/** The durations of the compression stages */
+		struct rohc_comp_perf_stats stats;
+		/** The beginning of the compression stages being measured */
+		uint64_t begin[ROHC_COMP_PERF_STAGE_MAX];
+	} perf;
+#endif
 };
 
 
@@ -297,6 +690,90 @@ struct rohc_comp_profile
 	                 const uint8_t *const feedback_data,
 	                 const size_t feedback_data_len)
 		__attribute__((warn_unused_result, nonnull(1, 3, 5)));
+
+	/**
+	 * @brief The handler used to get the MSN of the last packet, NULL if the
+	 *        MSN is taken from the packets (RTP SN, ESP SN)
+	 */
+	uint32_t (*get_msn)(const struct rohc_comp_ctxt *const context)
+		__attribute__((warn_unused_result, nonnull(1)));
+
+	/**
+	 * @brief The handler used to force the MSN of the next packet, NULL if
+	 *        the MSN is taken from the packets (RTP SN, ESP SN)
+	 */
+	void (*set_next_msn)(struct rohc_comp_ctxt *const context,
+	                     const uint32_t msn)
+		__attribute__((nonnull(1)));
+
+	/**
+	 * @brief The handler used to prefetch the profile-specific data of the
+	 *        context before the next packet is compressed, NULL if the
+	 *        profile has no data to prefetch
+	 */
+	void (*prefetch)(const struct rohc_comp_ctxt *const context)
+		__attribute__((nonnull(1)));
+
+	/**
+	 * @brief The handler used to get the maximum length the profile-specific
+	 *        part of one context takes in a memory block, see
+	 *        \ref rohc_comp_mem_size
+	 */
+	size_t (*get_mem_max)(const size_t wlsb_width)
+		__attribute__((warn_unused_result));
+};
+
+
+/**
+ * @brief The headers of the last packets of one compression context
+ *
+ * The packets are recorded to save the context, they are replayed in a new
+ * context to restore it.
+ */
+struct rohc_comp_ckpt_pkts
+{
+	/** The number of recorded packets */
+	size_t pkts_nr;
+	/** The index of the next packet to record */
+	size_t next;
+	/** The recorded packets, the oldest one at index next if all slots are
+	 *  used */
+	struct
+	{
+		/** The MSN of the packet */
+		uint32_t msn;
+		/** The length of the uncompressed headers */
+		size_t hdrs_len;
+		/** The length of the payload that followed the headers */
+		size_t payload_len;
+		/** The uncompressed headers */
+		uint8_t hdrs[ROHC_COMP_CKPT_HDRS_MAX];
+	} pkts[ROHC_COMP_CKPT_PKTS_NR];
+};
+
+
+/**
+ * @brief The statistics of one ROHC compression context
+ */
+struct rohc_comp_ctxt_stats
+{
+	/** The size of all the uncompressed packets */
+	uint64_t total_uncompressed_size;
+	/** The size of all the compressed packets */
+	uint64_t total_compressed_size;
+	/** The size of all the uncompressed headers */
+	uint64_t header_uncompressed_size;
+	/** The size of all the compressed headers */
+	uint64_t header_compressed_size;
+
+	/** The total size of the last uncompressed packet */
+	size_t total_last_uncompressed_size;
+	/** The total size of the last compressed packet */
+	size_t total_last_compressed_size;
+	/** The header size of the last uncompressed packet */
+	size_t header_last_uncompressed_size;
+	/** The header size of the last compressed packet */
+	size_t header_last_compressed_size;
 };
 
 
@@ -311,9 +788,33 @@ struct rohc_comp_ctxt
 	uint64_t latest_used;
 	/** The time when the context was last used (in seconds) */
 	uint64_t first_used;
+	/** The time when the context was last used (in milliseconds, see
+	 *  \ref rohc_time_ms) */
+	uint32_t latest_used_ms;
 
 	/** The context unique ID (CID) */
 	rohc_cid_t cid;
+	/** The priority class of the flow, see \ref rohc_comp_set_priority_cb */
+	unsigned int priority;
+	/** The CID part of the ROHC packets, built once for the context */
+	struct rohc_comp_cid_hdr cid_hdr;
+
+	/** The more recently used context in the LRU list of the compressor */
+	struct rohc_comp_ctxt *lru_prev;
+	/** The less recently used context in the LRU list of the compressor */
+	struct rohc_comp_ctxt *lru_next;
+
+	/** Whether the profile detected the end of the flow, eg. the TCP FIN or
+	 *  RST flag, set by the profile when it encodes the packets */
+	bool closed;
+	/** The time when the end of the flow was detected (in seconds) */
+	uint64_t closed_time;
+	/** The context of the flow that ended before in the list of the contexts
+	 *  of the ended flows */
+	struct rohc_comp_ctxt *closed_prev;
+	/** The context of the flow that ended after in the list of the contexts
+	 *  of the ended flows */
+	struct rohc_comp_ctxt *closed_next;
 
 	/** The key to help finding the context associated with a packet */
 	rohc_ctxt_key_t key; /* may not be unique */
@@ -356,27 +857,44 @@ struct rohc_comp_ctxt
 	 * @see rohc_comp_periodic_down_transition
 	 */
 	size_t go_back_ir_count;
-
-	/** The average size of the uncompressed packets */
-	int total_uncompressed_size;
-	/** The average size of the compressed packets */
-	int total_compressed_size;
-	/** The average size of the uncompressed headers */
-	int header_uncompressed_size;
-	/** The average size of the compressed headers */
-	int header_compressed_size;
-
-	/** The total size of the last uncompressed packet */
-	int total_last_uncompressed_size;
-	/** The total size of the last compressed packet */
-	int total_last_compressed_size;
-	/** The header size of the last uncompressed packet */
-	int header_last_uncompressed_size;
-	/** The header size of the last compressed packet */
-	int header_last_compressed_size;
+	/** The time of the latest packet sent in IR or FO state (in milliseconds),
+	 *  used for the periodic refreshes of the context */
+	uint32_t go_back_fo_time;
+	/** The time of the latest packet sent in IR state (in milliseconds), used
+	 *  for the periodic refreshes of the context */
+	uint32_t go_back_ir_time;
+	/** The power of 2 the periodic refreshes timeouts of the context are
+	 *  multiplied by (positive) or divided by (negative), in range
+	 *  [-\ref ROHC_COMP_REFRESH_SCALE_MAX, \ref ROHC_COMP_REFRESH_SCALE_MAX] */
+	int refresh_scale;
+	/** Whether feedback was received since the latest periodic IR refresh */
+	bool refresh_feedback;
+	/** Whether a NACK was received since the latest periodic IR refresh */
+	bool refresh_nack;
+
+	/** The number of entries kept in the W-LSB windows of the context,
+	 *  adapted to the packets in flight measured on the ACKs */
+	size_t wlsb_width;
+	/** The number of consecutive ACKs that measured few enough packets in
+	 *  flight to halve the width of the W-LSB windows */
+	size_t wlsb_shrink_acks;
 
 	/** The number of sent packets */
-	int num_sent_packets;
+	uint64_t num_sent_packets;
+	/** The number of sent packets when the context was last written in the
+	 *  context store, UINT64_MAX if never, see \ref rohc_comp_sync_store */
+	uint64_t store_synced_pkts;
+
+	/** The headers of the last packets compressed with the context, recorded
+	 *  only if \ref ROHC_COMP_FEATURE_CHECKPOINT is enabled, NULL otherwise */
+	struct rohc_comp_ckpt_pkts *last_pkts;
+
+#if ROHC_COMP_STATS == 1
+	/** The sizes of the compressed packets, written for every packet but
+	 *  read only by the statistics functions, so kept at the very end of
+	 *  the context, away from the fields read for every packet */
+	struct rohc_comp_ctxt_stats stats;
+#endif
 };
 
 
@@ -391,9 +909,24 @@ void rohc_comp_change_state(struct rohc_comp_ctxt *const context,
 void rohc_comp_periodic_down_transition(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
+void rohc_comp_periodic_refreshes_nack(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+
+uint8_t rohc_comp_get_ip_anomalies(const struct rohc_comp *const comp,
+                                   const struct net_pkt *const packet)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
+
 bool rohc_comp_reinit_context(struct rohc_comp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+size_t rohc_comp_wlsb_width_ack(struct rohc_comp_ctxt *const context,
+                                const uint32_t sn,
+                                const uint32_t sn_bits,
+                                const size_t sn_bits_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+size_t rohc_comp_wlsb_width_nack(struct rohc_comp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1)));
+
 bool rohc_comp_feedback_parse_opts(const struct rohc_comp_ctxt *const context,
                                    const uint8_t *const packet,
                                    const size_t packet_len,
@@ -406,5 +939,8 @@ bool rohc_comp_feedback_parse_opts(const struct rohc_comp_ctxt *const context,
                                    size_t crc_pos_from_end)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 6, 7, 8)));
 
+void rohc_comp_engine_put(struct rohc_comp_engine *const engine)
+	__attribute__((nonnull(1)));
+
 #endif
 
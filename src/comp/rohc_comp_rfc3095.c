@@ -30,6 +30,7 @@
 
 #include "rohc_comp_rfc3095.h"
 #include "c_rtp.h"
+#include "c_udp.h"
 #include "rohc_traces.h"
 #include "rohc_traces_internal.h"
 #include "rohc_debug.h"
@@ -70,12 +71,188 @@
 /** A flag to indicate that an errror occurred */
 #define MOD_ERROR 0x0008
 
+/**
+ * @brief Call one profile-specific handler of the RFC3095-based context
+ *
+ * The IPv4/UDP/RTP contexts are the most common ones: their handlers are
+ * called directly rather than through the table of handlers of the profile,
+ * so that the hot path avoids the indirect branches. The handlers of the
+ * other contexts are called through the table of handlers.
+ *
+ * @param ctxt         The RFC3095-based context
+ * @param handler      The name of the handler in the table
+ * @param rtp_handler  The handler of the RTP profile
+ * @param ...          The arguments of the handler
+ */
+#define rohc_comp_rfc3095_call(ctxt, handler, rtp_handler, ...) \
+	((ctxt)->is_ipv4_udp_rtp ? \
+	 rtp_handler(__VA_ARGS__) : (ctxt)->ops->handler(__VA_ARGS__))
+
+
+/*
+ * Pre-computed tables for the decision of the UO-1-ID/UOR-2* extension
+ */
+
+/* the candidate extensions, in the order they are tested */
+#define EXT_ROW_NONE  (1U << 0)
+#define EXT_ROW_0     (1U << 1)
+#define EXT_ROW_1     (1U << 2)
+#define EXT_ROW_2     (1U << 3)
+#define EXT_ROW_3     (1U << 4)
+#define EXT_ROWS_ALL  (EXT_ROW_NONE | EXT_ROW_0 | EXT_ROW_1 | EXT_ROW_2 | EXT_ROW_3)
+
+/** The extension of every candidate row */
+static const rohc_ext_t rohc_comp_ext_rows[] =
+{
+	ROHC_EXT_NONE, ROHC_EXT_0, ROHC_EXT_1, ROHC_EXT_2, ROHC_EXT_3
+};
+
+/**
+ * @brief The tables that decide the extension of one UO-1-ID/UOR-2* packet
+ *
+ * Every entry is the mask of the candidate extensions that the input allows,
+ * see \ref ROHC_COMP_BITS_TABLE. EXT-3 is always allowed.
+ */
+struct rohc_comp_ext_table
+{
+	/** Indexed by the number of SN bits for fields larger than 4 bits */
+	uint8_t sn[ROHC_COMP_BITS_NR];
+	/** Indexed by the number of SN bits for fields up to 4 bits */
+	uint8_t sn_4[ROHC_COMP_BITS_NR];
+	/** Indexed by the number of TS bits */
+	uint8_t ts[ROHC_COMP_BITS_NR];
+	/** Indexed by whether TS is deducible from SN, added to \e ts */
+	uint8_t ts_deducible[2];
+	/** Indexed by the number of IP-ID bits of the innermost IPv4 header */
+	uint8_t inner_ip_id[ROHC_COMP_BITS_NR];
+	/** Indexed by the number of IP-ID bits of the outermost IPv4 header */
+	uint8_t outer_ip_id[ROHC_COMP_BITS_NR];
+	/** Indexed by whether the RTP Marker bit is set */
+	uint8_t marker[2];
+	/** Indexed by the number of IP headers minus one */
+	uint8_t ip_layout[2];
+};
+
+#define EXT_ANY(v)  EXT_ROWS_ALL
+
+/* UOR-2 (non-RTP profiles), EXT-2 requires 2 IP headers */
+#define EXT_UOR2_SN(v) \
+	(ROHC_COMP_ROWS_IF(v, 0, 5, EXT_ROW_NONE) | \
+	 ROHC_COMP_ROWS_IF(v, 0, 8, EXT_ROW_0 | EXT_ROW_1 | EXT_ROW_2) | EXT_ROW_3)
+#define EXT_UOR2_INNER_IP_ID(v) \
+	(ROHC_COMP_ROWS_IF(v, 0, 0, EXT_ROW_NONE) | \
+	 ROHC_COMP_ROWS_IF(v, 1, 3, EXT_ROW_0) | \
+	 ROHC_COMP_ROWS_IF(v, 1, 11, EXT_ROW_1) | \
+	 ROHC_COMP_ROWS_IF(v, 1, 8, EXT_ROW_2) | EXT_ROW_3)
+#define EXT_UOR2_OUTER_IP_ID(v) \
+	(ROHC_COMP_ROWS_IF(v, 0, 0, EXT_ROW_NONE | EXT_ROW_0 | EXT_ROW_1) | \
+	 ROHC_COMP_ROWS_IF(v, 0, 11, EXT_ROW_2) | EXT_ROW_3)
+
+static const struct rohc_comp_ext_table rohc_comp_ext_uor2 =
+{
+	.sn           = ROHC_COMP_BITS_TABLE(EXT_UOR2_SN),
+	.sn_4         = ROHC_COMP_BITS_TABLE(EXT_ANY),
+	.ts           = ROHC_COMP_BITS_TABLE(EXT_ANY),
+	.ts_deducible = { 0, 0 },
+	.inner_ip_id  = ROHC_COMP_BITS_TABLE(EXT_UOR2_INNER_IP_ID),
+	.outer_ip_id  = ROHC_COMP_BITS_TABLE(EXT_UOR2_OUTER_IP_ID),
+	.marker       = { EXT_ROWS_ALL, EXT_ROWS_ALL },
+	.ip_layout    = { EXT_ROWS_ALL & ~EXT_ROW_2, EXT_ROWS_ALL },
+};
+
+/* UOR-2-RTP */
+#define EXT_UOR2RTP_SN(v) \
+	(ROHC_COMP_ROWS_IF(v, 0, 6, EXT_ROW_NONE) | \
+	 ROHC_COMP_ROWS_IF(v, 0, 9, EXT_ROW_0 | EXT_ROW_1 | EXT_ROW_2) | EXT_ROW_3)
+#define EXT_UOR2RTP_TS(v) \
+	(ROHC_COMP_ROWS_IF(v, 0, 6, EXT_ROW_NONE) | \
+	 ROHC_COMP_ROWS_IF(v, 0, 9, EXT_ROW_0) | \
+	 ROHC_COMP_ROWS_IF(v, 0, 17, EXT_ROW_1) | \
+	 ROHC_COMP_ROWS_IF(v, 0, 25, EXT_ROW_2) | EXT_ROW_3)
+#define EXT_UOR2RTP_IP_ID(v) \
+	(ROHC_COMP_ROWS_IF(v, 0, 0, EXT_ROWS_ALL) | EXT_ROW_3)
+
+static const struct rohc_comp_ext_table rohc_comp_ext_uor2rtp =
+{
+	.sn           = ROHC_COMP_BITS_TABLE(EXT_UOR2RTP_SN),
+	.sn_4         = ROHC_COMP_BITS_TABLE(EXT_ANY),
+	.ts           = ROHC_COMP_BITS_TABLE(EXT_UOR2RTP_TS),
+	.ts_deducible = { 0, 0 },
+	.inner_ip_id  = ROHC_COMP_BITS_TABLE(EXT_UOR2RTP_IP_ID),
+	.outer_ip_id  = ROHC_COMP_BITS_TABLE(EXT_UOR2RTP_IP_ID),
+	.marker       = { EXT_ROWS_ALL, EXT_ROWS_ALL },
+	.ip_layout    = { EXT_ROWS_ALL, EXT_ROWS_ALL },
+};
+
+/* UOR-2-TS */
+#define EXT_UOR2TS_TS(v) \
+	(ROHC_COMP_ROWS_IF(v, 0, 5, EXT_ROW_NONE) | \
+	 ROHC_COMP_ROWS_IF(v, 0, 8, EXT_ROW_0 | EXT_ROW_1) | \
+	 ROHC_COMP_ROWS_IF(v, 0, 16, EXT_ROW_2) | EXT_ROW_3)
+#define EXT_UOR2TS_INNER_IP_ID(v) \
+	(ROHC_COMP_ROWS_IF(v, 0, 0, EXT_ROW_NONE | EXT_ROW_0) | \
+	 ROHC_COMP_ROWS_IF(v, 0, 8, EXT_ROW_1 | EXT_ROW_2) | EXT_ROW_3)
+
+static const struct rohc_comp_ext_table rohc_comp_ext_uor2ts =
+{
+	.sn           = ROHC_COMP_BITS_TABLE(EXT_UOR2RTP_SN),
+	.sn_4         = ROHC_COMP_BITS_TABLE(EXT_ANY),
+	.ts           = ROHC_COMP_BITS_TABLE(EXT_UOR2TS_TS),
+	.ts_deducible = { 0, 0 },
+	.inner_ip_id  = ROHC_COMP_BITS_TABLE(EXT_UOR2TS_INNER_IP_ID),
+	.outer_ip_id  = ROHC_COMP_BITS_TABLE(EXT_UOR2RTP_IP_ID),
+	.marker       = { EXT_ROWS_ALL, EXT_ROWS_ALL },
+	.ip_layout    = { EXT_ROWS_ALL, EXT_ROWS_ALL },
+};
+
+/* UOR-2-ID and UO-1-ID, no TS bit for NONE and EXT-0 unless TS is deducible */
+#define EXT_ID_TS(v) \
+	(ROHC_COMP_ROWS_IF(v, 0, 0, EXT_ROW_NONE | EXT_ROW_0) | \
+	 ROHC_COMP_ROWS_IF(v, 0, 8, EXT_ROW_1 | EXT_ROW_2) | EXT_ROW_3)
+#define EXT_ID_INNER_IP_ID(v) \
+	(ROHC_COMP_ROWS_IF(v, 0, 5, EXT_ROW_NONE) | \
+	 ROHC_COMP_ROWS_IF(v, 0, 8, EXT_ROW_0 | EXT_ROW_1) | \
+	 ROHC_COMP_ROWS_IF(v, 0, 16, EXT_ROW_2) | EXT_ROW_3)
+
+static const struct rohc_comp_ext_table rohc_comp_ext_uor2id =
+{
+	.sn           = ROHC_COMP_BITS_TABLE(EXT_UOR2RTP_SN),
+	.sn_4         = ROHC_COMP_BITS_TABLE(EXT_ANY),
+	.ts           = ROHC_COMP_BITS_TABLE(EXT_ID_TS),
+	.ts_deducible = { 0, EXT_ROW_NONE | EXT_ROW_0 },
+	.inner_ip_id  = ROHC_COMP_BITS_TABLE(EXT_ID_INNER_IP_ID),
+	.outer_ip_id  = ROHC_COMP_BITS_TABLE(EXT_UOR2RTP_IP_ID),
+	.marker       = { EXT_ROWS_ALL, EXT_ROWS_ALL },
+	.ip_layout    = { EXT_ROWS_ALL, EXT_ROWS_ALL },
+};
+
+/* UO-1-ID, no extension if SN fits in 4 bits, EXT-3 if Marker bit is set */
+#define EXT_UO1ID_SN(v) \
+	(ROHC_COMP_ROWS_IF(v, 0, 7, EXT_ROW_0 | EXT_ROW_1 | EXT_ROW_2) | \
+	 EXT_ROW_NONE | EXT_ROW_3)
+#define EXT_UO1ID_SN_4(v) \
+	(ROHC_COMP_ROWS_IF(v, 0, 4, EXT_ROW_NONE) | \
+	 EXT_ROW_0 | EXT_ROW_1 | EXT_ROW_2 | EXT_ROW_3)
+
+static const struct rohc_comp_ext_table rohc_comp_ext_uo1id =
+{
+	.sn           = ROHC_COMP_BITS_TABLE(EXT_UO1ID_SN),
+	.sn_4         = ROHC_COMP_BITS_TABLE(EXT_UO1ID_SN_4),
+	.ts           = ROHC_COMP_BITS_TABLE(EXT_ID_TS),
+	.ts_deducible = { 0, EXT_ROW_NONE | EXT_ROW_0 },
+	.inner_ip_id  = ROHC_COMP_BITS_TABLE(EXT_ID_INNER_IP_ID),
+	.outer_ip_id  = ROHC_COMP_BITS_TABLE(EXT_UOR2RTP_IP_ID),
+	.marker       = { EXT_ROWS_ALL, EXT_ROW_3 },
+	.ip_layout    = { EXT_ROWS_ALL, EXT_ROWS_ALL },
+};
+
 
 /*
  * Prototypes of main private functions
  */
 
 static bool ip_header_info_new(struct ip_header_info *const header_info,
+                               struct rohc_slab *const slab,
                                const struct ip_packet *const ip,
                                const size_t list_trans_nr,
                                const size_t wlsb_window_width,
@@ -86,31 +263,55 @@ static bool ip_header_info_new(struct ip_header_info *const header_info,
 static void ip_header_info_free(struct ip_header_info *const header_info)
 	__attribute__((nonnull(1)));
 
+static bool c_inner_ip_info_new(struct rohc_comp_ctxt *const context,
+                                const struct ip_packet *const ip)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void c_inner_ip_info_free(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt)
+	__attribute__((nonnull(1)));
+
 static void c_init_tmp_variables(struct generic_tmp_vars *const tmp_vars);
 
 static rohc_packet_t decide_packet(struct rohc_comp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
-
-static rohc_ext_t decide_extension_uor2(const struct rohc_comp_ctxt *const context,
-                                        const size_t nr_innermost_ip_id_bits,
-                                        const size_t nr_outermost_ip_id_bits)
-	__attribute__((warn_unused_result, nonnull(1)));
-static rohc_ext_t decide_extension_uor2rtp(const struct rohc_comp_ctxt *const context,
-                                           const size_t nr_innermost_ip_id_bits,
-                                           const size_t nr_outermost_ip_id_bits)
-	__attribute__((warn_unused_result, nonnull(1)));
-static rohc_ext_t decide_extension_uor2ts(const struct rohc_comp_ctxt *const context,
-                                          const size_t nr_innermost_ip_id_bits,
-                                          const size_t nr_outermost_ip_id_bits)
-	__attribute__((warn_unused_result, nonnull(1)));
-static rohc_ext_t decide_extension_uor2id(const struct rohc_comp_ctxt *const context,
-                                          const size_t nr_innermost_ip_id_bits,
-                                          const size_t nr_outermost_ip_id_bits)
-	__attribute__((warn_unused_result, nonnull(1)));
-static rohc_ext_t decide_extension_uo1id(const struct rohc_comp_ctxt *const context,
-                                         const size_t nr_innermost_ip_id_bits,
-                                         const size_t nr_outermost_ip_id_bits)
+static rohc_packet_t rohc_comp_rfc3095_decide_r_packet(struct rohc_comp_ctxt *const context,
+                                                       const rohc_packet_t packet)
 	__attribute__((warn_unused_result, nonnull(1)));
+static void rohc_comp_rfc3095_track_r_update(struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+
+/**
+ * @brief The counters of one IP header that the coding of a packet updates
+ */
+struct rohc_comp_rfc3095_ip_counters
+{
+	uint8_t tos_count;       /**< see \ref ip_header_info */
+	uint8_t ttl_count;       /**< see \ref ip_header_info */
+	uint8_t protocol_count;  /**< see \ref ip_header_info */
+	uint8_t df_count;        /**< see \ref ipv4_header_info */
+	uint8_t rnd_count;       /**< see \ref ipv4_header_info */
+	uint8_t nbo_count;       /**< see \ref ipv4_header_info */
+	uint8_t sid_count;       /**< see \ref ipv4_header_info */
+};
+
+/**
+ * @brief The part of the context that the coding of a packet updates
+ *
+ * The snapshot is taken before one trial coding of a candidate packet and
+ * restored after it, see \ref rohc_comp_rfc3095_pick_smallest.
+ */
+struct rohc_comp_rfc3095_snapshot
+{
+	size_t fo_count;                                    /**< The FO counter */
+	struct generic_tmp_vars tmp;                        /**< The tmp variables */
+	struct rohc_comp_rfc3095_uo0_tmpl uo0_tmpl;         /**< The UO-0 layout */
+	struct rohc_comp_rfc3095_ip_counters ip[2];         /**< The IP counters */
+	struct rtp_tmp_vars rtp_tmp;                        /**< The RTP tmp vars */
+	size_t rtp_pt_change_count;                         /**< The RTP counters */
+	size_t rtp_padding_change_count;                    /**< The RTP counters */
+	size_t rtp_extension_change_count;                  /**< The RTP counters */
+	ts_sc_state ts_sc_state;                            /**< The TS_STRIDE state */
+	size_t nr_init_stride_packets;                      /**< The TS_STRIDE counter */
+};
 
 static int code_packet(struct rohc_comp_ctxt *const context,
                        const struct net_pkt *const uncomp_pkt,
@@ -118,6 +319,18 @@ static int code_packet(struct rohc_comp_ctxt *const context,
                        const size_t rohc_pkt_max_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
+static void rohc_comp_rfc3095_save(const struct rohc_comp_ctxt *const context,
+                                   struct rohc_comp_rfc3095_snapshot *const snap)
+	__attribute__((nonnull(1, 2)));
+static void rohc_comp_rfc3095_restore(struct rohc_comp_ctxt *const context,
+                                      const struct rohc_comp_rfc3095_snapshot *const snap)
+	__attribute__((nonnull(1, 2)));
+static void rohc_comp_rfc3095_pick_smallest(struct rohc_comp_ctxt *const context,
+                                            const struct net_pkt *const uncomp_pkt,
+                                            uint8_t *const rohc_pkt,
+                                            const size_t rohc_pkt_max_len)
+	__attribute__((nonnull(1, 2, 3)));
+
 static int code_IR_packet(struct rohc_comp_ctxt *const context,
                           const struct net_pkt *const uncomp_pkt,
                           uint8_t *const rohc_pkt,
@@ -198,6 +411,12 @@ static int code_UO0_packet(struct rohc_comp_ctxt *const context,
                            const size_t rohc_pkt_max_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
+static int rohc_comp_rfc3095_build_r0crc_pkt(struct rohc_comp_ctxt *const context,
+                                             const struct net_pkt *const uncomp_pkt,
+                                             uint8_t *const rohc_pkt,
+                                             const size_t rohc_pkt_max_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
 static int rohc_comp_rfc3095_build_uo1_pkt(struct rohc_comp_ctxt *const context,
                                            const struct net_pkt *const uncomp_pkt,
                                            uint8_t *const rohc_pkt,
@@ -309,7 +528,7 @@ static int header_fields(const struct rohc_comp_ctxt *const context,
                          int counter)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 7)));
 
-static uint8_t compute_uo_crc(const struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt,
+static uint8_t compute_uo_crc(const struct rohc_comp_ctxt *const context,
                               const struct net_pkt *const uncomp_pkt,
                               const rohc_crc_type_t crc_type,
                               const uint8_t crc_init,
@@ -345,6 +564,9 @@ static unsigned short detect_changed_fields(const struct rohc_comp_ctxt *const c
                                             struct ip_header_info *const header_info, /* TODO: add const */
                                             const struct ip_packet *const ip)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static bool rohc_comp_rfc3095_is_ip_hdr_steady(const struct ip_header_info *const header_info,
+                                              const struct ip_packet *const ip)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
 static bool is_field_changed(const unsigned short changed_fields,
                              const unsigned short check_field)
 	__attribute__((warn_unused_result, const));
@@ -355,10 +577,17 @@ static void detect_ip_id_behaviour(const struct rohc_comp_ctxt *const context,
                                    struct ip_header_info *const header_info,
                                    const struct ip_packet *const ip)
 	__attribute__((nonnull(1, 2, 3)));
+static bool is_ip_id_behaviour_confirmed(const struct ipv4_header_info *const v4_info,
+                                         const uint16_t old_id,
+                                         const uint16_t new_id)
+	__attribute__((warn_unused_result, nonnull(1), pure));
 
 static bool encode_uncomp_fields(struct rohc_comp_ctxt *const context,
                                  const struct net_pkt *const uncomp_pkt)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void rohc_comp_rfc3095_add_wlsb(struct rohc_comp_ctxt *const context,
+                                       const struct net_pkt *const uncomp_pkt)
+	__attribute__((nonnull(1, 2)));
 
 static void rohc_get_innermost_ipv4_non_rnd(const struct rohc_comp_ctxt *const context,
                                             ip_header_pos_t *const pos,
@@ -388,6 +617,14 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
                                            const size_t sn_bits_nr,
                                            const bool sn_not_valid)
 	__attribute__((nonnull(1)));
+static bool rohc_comp_rfc3095_is_sn_acked(const struct rohc_comp_ctxt *const context,
+                                          const uint32_t ref_sn,
+                                          const uint32_t sn_bits,
+                                          const size_t sn_bits_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void rohc_comp_rfc3095_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                             const size_t width)
+	__attribute__((nonnull(1)));
 
 
 
@@ -417,6 +654,7 @@ static bool is_field_changed(const unsigned short changed_fields,
  * @brief Initialize the IP header info stored in the context
  *
  * @param header_info        The IP header info to initialize
+ * @param slab               The slab to allocate the W-LSB window from
  * @param ip                 The IP header
  * @param list_trans_nr      The number of uncompressed transmissions for
  *                           list compression (L)
@@ -428,6 +666,7 @@ static bool is_field_changed(const unsigned short changed_fields,
  * @return                   true if successful, false otherwise
  */
 static bool ip_header_info_new(struct ip_header_info *const header_info,
+                               struct rohc_slab *const slab,
                                const struct ip_packet *const ip,
                                const size_t list_trans_nr,
                                const size_t wlsb_window_width,
@@ -451,7 +690,7 @@ static bool ip_header_info_new(struct ip_header_info *const header_info,
 	{
 		/* init the parameters to encode the IP-ID with W-LSB encoding */
 		header_info->info.v4.ip_id_window =
-			c_create_wlsb(16, wlsb_window_width, ROHC_LSB_SHIFT_IP_ID);
+			c_create_wlsb(slab, 16, wlsb_window_width, ROHC_LSB_SHIFT_IP_ID);
 		if(header_info->info.v4.ip_id_window == NULL)
 		{
 			__rohc_print(trace_cb, trace_cb_priv, ROHC_TRACE_ERROR,
@@ -469,6 +708,7 @@ static bool ip_header_info_new(struct ip_header_info *const header_info,
 		header_info->info.v4.rnd_count = MAX_FO_COUNT;
 		header_info->info.v4.nbo_count = MAX_FO_COUNT;
 		header_info->info.v4.sid_count = MAX_FO_COUNT;
+		header_info->info.v4.behaviour_confidence = 0;
 	}
 	else
 	{
@@ -504,6 +744,65 @@ static void ip_header_info_free(struct ip_header_info *const header_info)
 }
 
 
+/**
+ * @brief Allocate and initialize the info about the inner IP header
+ *
+ * Only the contexts with 2 IP headers own the info about the inner IP
+ * header, the other contexts do not pay for it.
+ *
+ * @param context  The compression context
+ * @param ip       The inner IP header
+ * @return         true if successful, false otherwise
+ */
+static bool c_inner_ip_info_new(struct rohc_comp_ctxt *const context,
+                                const struct ip_packet *const ip)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	struct ip_header_info *inner_ip_flags;
+
+	inner_ip_flags = rohc_slab_alloc(context->compressor->ctxt_slab,
+	                                 sizeof(struct ip_header_info));
+	if(inner_ip_flags == NULL)
+	{
+		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
+		           "no memory for the inner IP header of the profile context");
+		goto error;
+	}
+	memset(inner_ip_flags, 0, sizeof(struct ip_header_info));
+
+	if(!ip_header_info_new(inner_ip_flags, context->compressor->ctxt_slab, ip,
+	                       context->compressor->list_trans_nr,
+	                       context->compressor->wlsb_window_width,
+	                       context->compressor->trace_callback,
+	                       context->compressor->trace_callback_priv,
+	                       context->profile->id))
+	{
+		goto free_info;
+	}
+	rfc3095_ctxt->inner_ip_flags = inner_ip_flags;
+
+	return true;
+
+free_info:
+	rohc_slab_free(inner_ip_flags);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Destroy the info about the inner IP header
+ *
+ * @param rfc3095_ctxt  The generic part of the compression context
+ */
+static void c_inner_ip_info_free(struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt)
+{
+	ip_header_info_free(rfc3095_ctxt->inner_ip_flags);
+	rohc_slab_free(rfc3095_ctxt->inner_ip_flags);
+	rfc3095_ctxt->inner_ip_flags = NULL;
+}
+
+
 /**
  * @brief Initialize all temporary variables stored in the context.
  *
@@ -524,6 +823,7 @@ static void c_init_tmp_variables(struct generic_tmp_vars *const tmp_vars)
 	tmp_vars->nr_ip_id_bits2 = 0;
 
 	tmp_vars->packet_type = ROHC_PACKET_UNKNOWN;
+	tmp_vars->packet_candidates = 0;
 }
 
 
@@ -531,11 +831,13 @@ static void c_init_tmp_variables(struct generic_tmp_vars *const tmp_vars)
  * @brief Create a new context and initialize it thanks to the given IP packet.
  *
  * @param context   The compression context
+ * @param ops       The profile-specific handlers of the context
  * @param sn_shift  The shift parameter (p) to use for encoding SN with W-LSB
  * @param packet    The packet given to initialize the new context
  * @return          bool if successful, false otherwise
  */
 bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
+                              const struct rohc_comp_rfc3095_ops *const ops,
                               const rohc_lsb_shift_t sn_shift,
                               const struct net_pkt *const packet)
 {
@@ -543,12 +845,18 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 
 	assert(context != NULL);
 	assert(context->profile != NULL);
+	assert(ops != NULL);
+	assert(ops->decide_state != NULL);
+	assert(ops->get_next_sn != NULL);
+	assert(ops->compute_crc_static != NULL);
+	assert(ops->compute_crc_dynamic != NULL);
 	assert(packet != NULL);
 
 	rohc_comp_debug(context, "new generic context required for a new stream");
 
 	/* allocate memory for the generic part of the context */
-	rfc3095_ctxt = malloc(sizeof(struct rohc_comp_rfc3095_ctxt));
+	rfc3095_ctxt = rohc_slab_alloc(context->compressor->ctxt_slab,
+	                               sizeof(struct rohc_comp_rfc3095_ctxt));
 	if(rfc3095_ctxt == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -570,7 +878,8 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	rohc_comp_debug(context, "use shift parameter %d for LSB-encoding of SN",
 	                sn_shift);
 	rfc3095_ctxt->sn_window =
-		c_create_wlsb(16, context->compressor->wlsb_window_width, sn_shift);
+		c_create_wlsb(context->compressor->ctxt_slab, 16,
+		              context->compressor->wlsb_window_width, sn_shift);
 	if(rfc3095_ctxt->sn_window == NULL)
 	{
 		rohc_error(context->compressor, ROHC_TRACE_COMP, context->profile->id,
@@ -580,6 +889,7 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 
 	/* step 3 */
 	if(!ip_header_info_new(&rfc3095_ctxt->outer_ip_flags,
+	                       context->compressor->ctxt_slab,
 	                       &packet->outer_ip,
 	                       context->compressor->list_trans_nr,
 	                       context->compressor->wlsb_window_width,
@@ -591,13 +901,7 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	}
 	if(packet->ip_hdr_nr > 1)
 	{
-		if(!ip_header_info_new(&rfc3095_ctxt->inner_ip_flags,
-		                       &packet->inner_ip,
-		                       context->compressor->list_trans_nr,
-		                       context->compressor->wlsb_window_width,
-		                       context->compressor->trace_callback,
-		                       context->compressor->trace_callback_priv,
-		                       context->profile->id))
+		if(!c_inner_ip_info_new(context, &packet->inner_ip))
 		{
 			goto free_header_info;
 		}
@@ -615,18 +919,11 @@ bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
 	rfc3095_ctxt->specific = NULL;
 	rfc3095_ctxt->next_header_proto = packet->transport->proto;
 	rfc3095_ctxt->next_header_len = 0;
-	rfc3095_ctxt->decide_state = rohc_comp_rfc3095_decide_state;
-	rfc3095_ctxt->decide_FO_packet = NULL;
-	rfc3095_ctxt->decide_SO_packet = NULL;
-	rfc3095_ctxt->decide_extension = NULL;
-	rfc3095_ctxt->init_at_IR = NULL;
-	rfc3095_ctxt->get_next_sn = NULL;
-	rfc3095_ctxt->code_static_part = NULL;
-	rfc3095_ctxt->code_dynamic_part = NULL;
-	rfc3095_ctxt->code_UO_packet_head = NULL;
-	rfc3095_ctxt->code_uo_remainder = NULL;
-	rfc3095_ctxt->compute_crc_static = compute_crc_static;
-	rfc3095_ctxt->compute_crc_dynamic = compute_crc_dynamic;
+	rfc3095_ctxt->is_ipv4_udp_rtp = false;
+	rfc3095_ctxt->ops = ops;
+	crc_static_cache_init(&rfc3095_ctxt->crc_static_cache);
+	rfc3095_ctxt->uo0_tmpl.is_valid = false;
+	rfc3095_ctxt->static_chain_len = 0;
 
 	return true;
 
@@ -635,7 +932,7 @@ free_header_info:
 free_sn_window:
 	c_destroy_wlsb(rfc3095_ctxt->sn_window);
 free_generic_context:
-	free(rfc3095_ctxt);
+	rohc_slab_free(rfc3095_ctxt);
 quit:
 	return false;
 }
@@ -657,12 +954,60 @@ void rohc_comp_rfc3095_destroy(struct rohc_comp_ctxt *const context)
 	ip_header_info_free(&rfc3095_ctxt->outer_ip_flags);
 	if(rfc3095_ctxt->ip_hdr_nr > 1)
 	{
-		ip_header_info_free(&rfc3095_ctxt->inner_ip_flags);
+		c_inner_ip_info_free(rfc3095_ctxt);
 	}
 	c_destroy_wlsb(rfc3095_ctxt->sn_window);
 
-	zfree(rfc3095_ctxt->specific);
-	free(rfc3095_ctxt);
+	rohc_slab_free(rfc3095_ctxt->specific);
+	rohc_slab_free(rfc3095_ctxt);
+}
+
+
+/**
+ * @brief Get the maximum length the generic part of one context takes in a
+ *        memory block
+ *
+ * The profile-specific part is not included.
+ *
+ * @param wlsb_width  The width of the W-LSB sliding windows
+ * @return            The maximum number of bytes of the memory block the
+ *                    generic part of the context takes
+ */
+size_t rohc_comp_rfc3095_mem_max(const size_t wlsb_width)
+{
+	/* the generic part, the info about the inner IP header, the window of the
+	 * SN and the windows of the IP-IDs of the outer and inner IPv4 headers */
+	return (rohc_slab_block_mem_max(sizeof(struct rohc_comp_rfc3095_ctxt)) +
+	        rohc_slab_block_mem_max(sizeof(struct ip_header_info)) +
+	        3 * c_wlsb_mem_max(1, wlsb_width));
+}
+
+
+/**
+ * @brief Prefetch the W-LSB windows of the context
+ *
+ * Called by the compressor when it compresses a burst of packets, before the
+ * next packet is compressed in the context.
+ *
+ * @param context The compression context
+ */
+void rohc_comp_rfc3095_prefetch(const struct rohc_comp_ctxt *const context)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+
+	c_wlsb_prefetch(rfc3095_ctxt->sn_window);
+	if(rfc3095_ctxt->outer_ip_flags.version == IPV4)
+	{
+		c_wlsb_prefetch(rfc3095_ctxt->outer_ip_flags.info.v4.ip_id_window);
+	}
+	if(rfc3095_ctxt->ip_hdr_nr > 1 && rfc3095_ctxt->inner_ip_flags->version == IPV4)
+	{
+		c_wlsb_prefetch(rfc3095_ctxt->inner_ip_flags->info.v4.ip_id_window);
+	}
+	if(rfc3095_ctxt->specific != NULL)
+	{
+		__builtin_prefetch(rfc3095_ctxt->specific);
+	}
 }
 
 
@@ -709,35 +1054,6 @@ bool rohc_comp_rfc3095_check_profile(const struct rohc_comp *const comp,
 		goto bad_profile;
 	}
 
-	/* if outer header is IPv4, check the presence of options */
-	if(version == IPV4 &&
-	   ip_get_hdrlen(&packet->outer_ip) != sizeof(struct ipv4_hdr))
-	{
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "the outer IPv4 packet is not supported by the profile: "
-		           "IP options are not accepted");
-		goto bad_profile;
-	}
-
-	/* check if the outer header is a fragment */
-	if(ip_is_fragment(&packet->outer_ip))
-	{
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "the outer IP packet is fragmented");
-		goto bad_profile;
-	}
-
-	/* check if the checksum of the outer IP header is correct */
-	if(packet->outer_ip.version == IPV4 &&
-	   (comp->features & ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == 0 &&
-	   ip_fast_csum(packet->outer_ip.data,
-	                sizeof(struct ipv4_hdr) / sizeof(uint32_t)) != 0)
-	{
-		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-		           "the outer IP packet is not correct (bad checksum)");
-		goto bad_profile;
-	}
-
 	/* check the inner IP header if there is one */
 	if(packet->ip_hdr_nr > 1)
 	{
@@ -760,35 +1076,16 @@ bool rohc_comp_rfc3095_check_profile(const struct rohc_comp *const comp,
 			}
 			goto bad_profile;
 		}
+	}
 
-		/* if inner header is IPv4, check the presence of options */
-		if(version == IPV4 &&
-		   ip_get_hdrlen(&packet->inner_ip) != sizeof(struct ipv4_hdr))
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "the inner IPv4 packet is not supported by the profile: "
-			           "IP options are not accepted");
-			goto bad_profile;
-		}
-
-		/* check if the inner header is a fragment */
-		if(ip_is_fragment(&packet->inner_ip))
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "the inner IP packet is fragmented");
-			goto bad_profile;
-		}
-
-		/* check if the checksum of the inner IP header is correct */
-		if(packet->inner_ip.version == IPV4 &&
-		   (comp->features & ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == 0 &&
-		   ip_fast_csum(packet->inner_ip.data,
-		                sizeof(struct ipv4_hdr) / sizeof(uint32_t)) != 0)
-		{
-			rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
-			           "the inner IP packet is not correct (bad checksum)");
-			goto bad_profile;
-		}
+	/* the IP fragments, the IPv4 options and the bad IPv4 checksums of the
+	 * outer and inner IP headers were found once by net_pkt_parse() */
+	if(rohc_comp_get_ip_anomalies(comp, packet) != 0)
+	{
+		rohc_debug(comp, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+		           "the IP packet is fragmented, has IP options or a bad "
+		           "checksum (anomalies 0x%02x)", packet->ip_anomalies);
+		goto bad_profile;
 	}
 
 	return true;
@@ -839,35 +1136,59 @@ int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
 	rfc3095_ctxt->tmp.changed_fields2 = 0;
 	rfc3095_ctxt->tmp.nr_ip_id_bits2 = 0;
 	rfc3095_ctxt->tmp.packet_type = ROHC_PACKET_UNKNOWN;
+	rfc3095_ctxt->tmp.packet_candidates = 0;
 
 	/* detect changes between new uncompressed packet and context */
+	rohc_perf_begin(context->compressor, ROHC_COMP_PERF_DETECT_CHANGES);
 	if(!rohc_comp_rfc3095_detect_changes(context, uncomp_pkt))
 	{
 		rohc_comp_warn(context, "failed to detect changes in uncompressed packet");
 		goto error;
 	}
+	rohc_perf_end(context->compressor, ROHC_COMP_PERF_DETECT_CHANGES);
 
 	/* decide in which state to go */
-	assert(rfc3095_ctxt->decide_state != NULL);
-	rfc3095_ctxt->decide_state(context);
+	rohc_perf_begin(context->compressor, ROHC_COMP_PERF_DECIDE_STATE);
+	assert(rfc3095_ctxt->ops->decide_state != NULL);
+	rohc_comp_rfc3095_call(rfc3095_ctxt, decide_state, rtp_decide_state,
+	                       context);
 	if(context->mode == ROHC_U_MODE)
 	{
 		rohc_comp_periodic_down_transition(context);
 	}
+	else if(context->mode == ROHC_R_MODE)
+	{
+		rohc_comp_rfc3095_track_r_update(context);
+	}
+	rohc_perf_end(context->compressor, ROHC_COMP_PERF_DECIDE_STATE);
 
 	/* compute how many bits are needed to send header fields */
+	rohc_perf_begin(context->compressor, ROHC_COMP_PERF_ENCODE_FIELDS);
 	if(!encode_uncomp_fields(context, uncomp_pkt))
 	{
 		rohc_comp_warn(context, "failed to compute how many bits are needed "
 		               "to send header fields");
 		goto error;
 	}
+	rohc_perf_end(context->compressor, ROHC_COMP_PERF_ENCODE_FIELDS);
 
 	/* decide which packet to send */
+	rohc_perf_begin(context->compressor, ROHC_COMP_PERF_DECIDE_PKT);
 	rfc3095_ctxt->tmp.packet_type = decide_packet(context);
+	if(rfc3095_ctxt->tmp.packet_candidates != 0 &&
+	   (rfc3095_ctxt->tmp.packet_candidates &
+	    ~(1U << rfc3095_ctxt->tmp.packet_type)) != 0)
+	{
+		/* several packet types fit, send the smallest one */
+		rohc_comp_rfc3095_pick_smallest(context, uncomp_pkt, rohc_pkt,
+		                                rohc_pkt_max_len);
+	}
+	rohc_perf_end(context->compressor, ROHC_COMP_PERF_DECIDE_PKT);
 
 	/* code the ROHC header (and the extension if needed) */
+	rohc_perf_begin(context->compressor, ROHC_COMP_PERF_CODE_PKT);
 	size = code_packet(context, uncomp_pkt, rohc_pkt, rohc_pkt_max_len);
+	rohc_perf_end(context->compressor, ROHC_COMP_PERF_CODE_PKT);
 	if(size < 0)
 	{
 		goto error;
@@ -876,6 +1197,9 @@ int rohc_comp_rfc3095_encode(struct rohc_comp_ctxt *const context,
 	*payload_offset = net_pkt_get_payload_offset(uncomp_pkt);
 	*payload_offset += rfc3095_ctxt->next_header_len;
 
+	/* record the new SN and IP-ID values as references for the next packets */
+	rohc_comp_rfc3095_add_wlsb(context, uncomp_pkt);
+
 	/* update the context with the new headers */
 	update_context(context, uncomp_pkt);
 
@@ -890,6 +1214,161 @@ error:
 }
 
 
+/**
+ * @brief Save the part of the context that the coding of a packet updates
+ *
+ * @param context  The compression context
+ * @param snap     OUT: The snapshot of the context
+ */
+static void rohc_comp_rfc3095_save(const struct rohc_comp_ctxt *const context,
+                                   struct rohc_comp_rfc3095_snapshot *const snap)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const struct ip_header_info *const ip_infos[2] =
+		{ &rfc3095_ctxt->outer_ip_flags, rfc3095_ctxt->inner_ip_flags };
+	size_t i;
+
+	snap->fo_count = context->fo_count;
+	snap->tmp = rfc3095_ctxt->tmp;
+	snap->uo0_tmpl = rfc3095_ctxt->uo0_tmpl;
+	for(i = 0; i < rfc3095_ctxt->ip_hdr_nr; i++)
+	{
+		snap->ip[i].tos_count = ip_infos[i]->tos_count;
+		snap->ip[i].ttl_count = ip_infos[i]->ttl_count;
+		snap->ip[i].protocol_count = ip_infos[i]->protocol_count;
+		if(ip_infos[i]->version == IPV4)
+		{
+			snap->ip[i].df_count = ip_infos[i]->info.v4.df_count;
+			snap->ip[i].rnd_count = ip_infos[i]->info.v4.rnd_count;
+			snap->ip[i].nbo_count = ip_infos[i]->info.v4.nbo_count;
+			snap->ip[i].sid_count = ip_infos[i]->info.v4.sid_count;
+		}
+	}
+	if(context->profile->id == ROHC_PROFILE_RTP)
+	{
+		const struct sc_rtp_context *const rtp_context =
+			rfc3095_ctxt->specific;
+
+		snap->rtp_tmp = rtp_context->tmp;
+		snap->rtp_pt_change_count = rtp_context->rtp_pt_change_count;
+		snap->rtp_padding_change_count = rtp_context->rtp_padding_change_count;
+		snap->rtp_extension_change_count =
+			rtp_context->rtp_extension_change_count;
+		snap->ts_sc_state = rtp_context->ts_sc.state;
+		snap->nr_init_stride_packets = rtp_context->ts_sc.nr_init_stride_packets;
+	}
+}
+
+
+/**
+ * @brief Restore the part of the context that the coding of a packet updates
+ *
+ * @param context  The compression context
+ * @param snap     The snapshot of the context to restore
+ */
+static void rohc_comp_rfc3095_restore(struct rohc_comp_ctxt *const context,
+                                      const struct rohc_comp_rfc3095_snapshot *const snap)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	struct ip_header_info *const ip_infos[2] =
+		{ &rfc3095_ctxt->outer_ip_flags, rfc3095_ctxt->inner_ip_flags };
+	size_t i;
+
+	context->fo_count = snap->fo_count;
+	rfc3095_ctxt->tmp = snap->tmp;
+	rfc3095_ctxt->uo0_tmpl = snap->uo0_tmpl;
+	for(i = 0; i < rfc3095_ctxt->ip_hdr_nr; i++)
+	{
+		ip_infos[i]->tos_count = snap->ip[i].tos_count;
+		ip_infos[i]->ttl_count = snap->ip[i].ttl_count;
+		ip_infos[i]->protocol_count = snap->ip[i].protocol_count;
+		if(ip_infos[i]->version == IPV4)
+		{
+			ip_infos[i]->info.v4.df_count = snap->ip[i].df_count;
+			ip_infos[i]->info.v4.rnd_count = snap->ip[i].rnd_count;
+			ip_infos[i]->info.v4.nbo_count = snap->ip[i].nbo_count;
+			ip_infos[i]->info.v4.sid_count = snap->ip[i].sid_count;
+		}
+	}
+	if(context->profile->id == ROHC_PROFILE_RTP)
+	{
+		struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+
+		rtp_context->tmp = snap->rtp_tmp;
+		rtp_context->rtp_pt_change_count = snap->rtp_pt_change_count;
+		rtp_context->rtp_padding_change_count = snap->rtp_padding_change_count;
+		rtp_context->rtp_extension_change_count =
+			snap->rtp_extension_change_count;
+		rtp_context->ts_sc.state = snap->ts_sc_state;
+		rtp_context->ts_sc.nr_init_stride_packets = snap->nr_init_stride_packets;
+	}
+}
+
+
+/**
+ * @brief Replace the packet type decided by the rules by the smallest one
+ *
+ * Every candidate packet type, see \ref ROHC_COMP_FEATURE_SMALLEST_PACKETS,
+ * is coded once in the ROHC buffer, CID, extension and remainder included,
+ * the context being restored after every trial. The packet type decided by
+ * the rules is kept unless another candidate is strictly smaller.
+ *
+ * @param context           The compression context
+ * @param uncomp_pkt        The uncompressed packet to encode
+ * @param rohc_pkt          The buffer for the trial ROHC packets
+ * @param rohc_pkt_max_len  The maximum length of the ROHC packet
+ */
+static void rohc_comp_rfc3095_pick_smallest(struct rohc_comp_ctxt *const context,
+                                            const struct net_pkt *const uncomp_pkt,
+                                            uint8_t *const rohc_pkt,
+                                            const size_t rohc_pkt_max_len)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const rohc_packet_t rules_packet = rfc3095_ctxt->tmp.packet_type;
+	uint32_t candidates = rfc3095_ctxt->tmp.packet_candidates;
+	struct rohc_comp_rfc3095_snapshot snap;
+	rohc_packet_t best_packet = rules_packet;
+	int best_size;
+
+	rohc_comp_rfc3095_save(context, &snap);
+
+	/* the packet decided by the rules is the reference */
+	best_size = code_packet(context, uncomp_pkt, rohc_pkt, rohc_pkt_max_len);
+	rohc_comp_rfc3095_restore(context, &snap);
+	if(best_size < 0)
+	{
+		/* let the final coding report the problem */
+		return;
+	}
+
+	candidates &= ~(1U << rules_packet);
+	while(candidates != 0)
+	{
+		const rohc_packet_t packet = (rohc_packet_t) __builtin_ctz(candidates);
+		int size;
+
+		candidates &= candidates - 1;
+		rfc3095_ctxt->tmp.packet_type = packet;
+		size = code_packet(context, uncomp_pkt, rohc_pkt, rohc_pkt_max_len);
+		rohc_comp_rfc3095_restore(context, &snap);
+		if(size >= 0 && size < best_size)
+		{
+			best_packet = packet;
+			best_size = size;
+		}
+	}
+
+	if(best_packet != rules_packet)
+	{
+		rohc_comp_debug(context, "%s packet (%d bytes) is smaller than the %s "
+		                "packet decided by the rules",
+		                rohc_get_packet_descr(best_packet), best_size,
+		                rohc_get_packet_descr(rules_packet));
+	}
+	rfc3095_ctxt->tmp.packet_type = best_packet;
+}
+
+
 /**
  * @brief Update the profile when feedback is received
  *
@@ -1024,7 +1503,23 @@ static bool rohc_comp_rfc3095_feedback_2(struct rohc_comp_ctxt *const context,
 			 * by a CRC */
 			if(opts_present[ROHC_FEEDBACK_OPT_CRC] > 0)
 			{
+				struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+				const rohc_mode_t old_mode = context->mode;
+
 				rohc_comp_change_mode(context, feedback2->mode);
+
+				/* RFC 3095, §5.6.3 and §5.6.4: the packets that carry the new mode
+				 * shall be sent until one of them is acknowledged */
+				if(old_mode != ROHC_R_MODE && context->mode == ROHC_R_MODE)
+				{
+					rfc3095_ctxt->r_trans_pending = true;
+					rfc3095_ctxt->r_trans_sn_valid = false;
+					/* the next packet in IR or FO state opens one context update
+					 * that shall be acknowledged, see \ref decide_state */
+					rfc3095_ctxt->r_update_acked = false;
+					context->ir_count = 0;
+					context->fo_count = 0;
+				}
 			}
 			else
 			{
@@ -1056,11 +1551,24 @@ static bool rohc_comp_rfc3095_feedback_2(struct rohc_comp_ctxt *const context,
 			/* RFC3095 §5.4.1.1.1: NACKs, downward transition */
 			rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 			          "NACK received for CID %zu", context->cid);
+			rohc_trace_event(context->compressor, ROHC_TRACE_COMP,
+			                 ROHC_TRACE_EVENT_COMP_NACK, context->profile->id,
+			                 context->cid, ROHC_PACKET_UNKNOWN,
+			                 ROHC_FEEDBACK_NACK, 0, 0);
 			/* the compressor transits back to the FO state */
 			if(context->state == ROHC_COMP_STATE_SO)
 			{
 				rohc_comp_change_state(context, ROHC_COMP_STATE_FO);
 			}
+			/* packets were lost or damaged, refresh the context more often */
+			rohc_comp_periodic_refreshes_nack(context);
+			/* packets were lost or damaged, widen the W-LSB windows again */
+			if((c_features(context->compressor) &
+			    ROHC_COMP_FEATURE_ADAPTIVE_WLSB) != 0)
+			{
+				rohc_comp_rfc3095_set_wlsb_width(context,
+				                                 rohc_comp_wlsb_width_nack(context));
+			}
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -1070,8 +1578,21 @@ static bool rohc_comp_rfc3095_feedback_2(struct rohc_comp_ctxt *const context,
 			/* RFC3095 §5.4.1.1.1: NACKs, downward transition */
 			rohc_info(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 			          "STATIC-NACK received for CID %zu", context->cid);
+			rohc_trace_event(context->compressor, ROHC_TRACE_COMP,
+			                 ROHC_TRACE_EVENT_COMP_NACK, context->profile->id,
+			                 context->cid, ROHC_PACKET_UNKNOWN,
+			                 ROHC_FEEDBACK_STATIC_NACK, 0, 0);
 			/* the compressor transits back to the IR state */
 			rohc_comp_change_state(context, ROHC_COMP_STATE_IR);
+			/* packets were lost or damaged, refresh the context more often */
+			rohc_comp_periodic_refreshes_nack(context);
+			/* packets were lost or damaged, widen the W-LSB windows again */
+			if((c_features(context->compressor) &
+			    ROHC_COMP_FEATURE_ADAPTIVE_WLSB) != 0)
+			{
+				rohc_comp_rfc3095_set_wlsb_width(context,
+				                                 rohc_comp_wlsb_width_nack(context));
+			}
 			/* TODO: use the SN field to determine the latest packet successfully
 			 * decompressed and then determine what fields need to be updated */
 			break;
@@ -1139,18 +1660,35 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
 		 *  - valid positive ACKs of packets transmitted after a string was
 		 *    determined by the compressor causes transition to SO state (direct
 		 *    transition from IR to SO is possible) */
-		/* TODO: not implemented yet, determine the packet acknowledged by the SN
-		 * field and whether it is one IR packet ; if yes, transit upward */
-		rohc_comp_debug(context, "ACK(R) received, but not fully supported, so "
-		                "do not transit to SO state more quickly");
-
-		/* RFC 3095, §4.5.2: ack W-LSB values only in R-mode since U/O-mode uses
-		 * a sliding window with a limited maximum width */
 		/* acknowledge IP-ID and SN only if SN is considered as valid */
 		if(!sn_not_valid)
 		{
 			size_t acked_nr;
 
+			/* the last update of the context is acknowledged if the ACK is for
+			 * the packet that transmitted it or for a later one */
+			if(!rfc3095_ctxt->r_update_acked &&
+			   rohc_comp_rfc3095_is_sn_acked(context, rfc3095_ctxt->r_update_sn,
+			                                 sn_bits, sn_bits_nr))
+			{
+				rohc_comp_debug(context, "ACK(R) acknowledges the context update "
+				                "transmitted with SN %u", rfc3095_ctxt->r_update_sn);
+				rfc3095_ctxt->r_update_acked = true;
+			}
+
+			/* RFC 3095, §5.6.3: the transition to R-mode is complete once one
+			 * packet that carried the R-mode is acknowledged */
+			if(rfc3095_ctxt->r_trans_pending && rfc3095_ctxt->r_trans_sn_valid &&
+			   rohc_comp_rfc3095_is_sn_acked(context, rfc3095_ctxt->r_trans_sn,
+			                                 sn_bits, sn_bits_nr))
+			{
+				rohc_comp_debug(context, "ACK(R) completes the transition to R-mode");
+				rfc3095_ctxt->r_trans_pending = false;
+			}
+
+			/* RFC 3095, §4.5.2: ack W-LSB values only in R-mode since U/O-mode
+			 * uses a sliding window with a limited maximum width */
+
 			/* ack outer IP-ID only if IPv4 */
 			if(rfc3095_ctxt->outer_ip_flags.version == IPV4)
 			{
@@ -1161,9 +1699,9 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
 			}
 			/* inner IP-ID only if present and if IPv4 */
 			if(rfc3095_ctxt->ip_hdr_nr > 1 &&
-			   rfc3095_ctxt->inner_ip_flags.version == IPV4)
+			   rfc3095_ctxt->inner_ip_flags->version == IPV4)
 			{
-				acked_nr = wlsb_ack(rfc3095_ctxt->inner_ip_flags.info.v4.ip_id_window,
+				acked_nr = wlsb_ack(rfc3095_ctxt->inner_ip_flags->info.v4.ip_id_window,
 				                    sn_bits, sn_bits_nr);
 				rohc_comp_debug(context, "FEEDBACK-2: positive ACK removed %zu "
 				                "values from outer IP-ID W-LSB", acked_nr);
@@ -1175,6 +1713,16 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
 		}
 	}
 
+	/* O- and R-modes: size the W-LSB windows from the packets in flight
+	 * between the acknowledged packet and the latest one */
+	if((c_features(context->compressor) & ROHC_COMP_FEATURE_ADAPTIVE_WLSB) != 0 &&
+	   context->mode != ROHC_U_MODE && !sn_not_valid)
+	{
+		const size_t width =
+			rohc_comp_wlsb_width_ack(context, rfc3095_ctxt->sn, sn_bits, sn_bits_nr);
+		rohc_comp_rfc3095_set_wlsb_width(context, width);
+	}
+
 	/* RFC 3095, §5.8.2.1:
 	 *   Normally, Gen_id must have been repeated in at least L headers before
 	 *   the list can be used as a ref_list. However, some acknowledgments may
@@ -1221,6 +1769,63 @@ static void rohc_comp_rfc3095_feedback_ack(struct rohc_comp_ctxt *const context,
 }
 
 
+/**
+ * @brief Whether a positive ACK acknowledges the given SN
+ *
+ * The ACK acknowledges the SN if it is for the packet with that SN or for a
+ * later packet.
+ *
+ * @param context     The compression context
+ * @param ref_sn      The SN to check
+ * @param sn_bits     The LSB bits of the acknowledged SN
+ * @param sn_bits_nr  The number of LSB bits of the acknowledged SN
+ * @return            true if the SN is acknowledged, false otherwise
+ */
+static bool rohc_comp_rfc3095_is_sn_acked(const struct rohc_comp_ctxt *const context,
+                                          const uint32_t ref_sn,
+                                          const uint32_t sn_bits,
+                                          const size_t sn_bits_nr)
+{
+	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const uint32_t sn_mask =
+		(sn_bits_nr < 32 ? ((1U << sn_bits_nr) - 1) : 0xffffffffU);
+	const uint32_t sn_max =
+		(context->profile->id == ROHC_PROFILE_ESP ? 0xffffffffU : 0xffffU);
+
+	/* packets sent after the acknowledged one vs. packets sent after the
+	 * reference one */
+	return (((rfc3095_ctxt->sn - sn_bits) & sn_mask) <=
+	        ((rfc3095_ctxt->sn - ref_sn) & sn_max));
+}
+
+
+/**
+ * @brief Set the number of entries kept in the W-LSB windows of the context
+ *
+ * The windows of the SN and of the IP-ID fields are resized. The windows of
+ * the profiles built on top of the RFC 3095 framework keep their width.
+ *
+ * @param context  The compression context
+ * @param width    The number of entries to keep in the W-LSB windows
+ */
+static void rohc_comp_rfc3095_set_wlsb_width(struct rohc_comp_ctxt *const context,
+                                             const size_t width)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+
+	if(rfc3095_ctxt->outer_ip_flags.version == IPV4)
+	{
+		c_wlsb_set_width(rfc3095_ctxt->outer_ip_flags.info.v4.ip_id_window, width);
+	}
+	if(rfc3095_ctxt->ip_hdr_nr > 1 &&
+	   rfc3095_ctxt->inner_ip_flags->version == IPV4)
+	{
+		c_wlsb_set_width(rfc3095_ctxt->inner_ip_flags->info.v4.ip_id_window, width);
+	}
+	c_wlsb_set_width(rfc3095_ctxt->sn_window, width);
+}
+
+
 /**
  * @brief Detect changes between packet and context
  *
@@ -1236,8 +1841,10 @@ static bool rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const contex
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 
 	/* compute or find the new SN */
-	assert(rfc3095_ctxt->get_next_sn != NULL);
-	rfc3095_ctxt->sn = rfc3095_ctxt->get_next_sn(context, uncomp_pkt);
+	assert(rfc3095_ctxt->ops->get_next_sn != NULL);
+	rfc3095_ctxt->sn = rohc_comp_rfc3095_call(rfc3095_ctxt, get_next_sn,
+	                                          c_rtp_get_next_sn,
+	                                          context, uncomp_pkt);
 	rohc_comp_debug(context, "SN = %u", rfc3095_ctxt->sn);
 
 	/* init or free the context of the inner IP header if the number of IP
@@ -1247,13 +1854,7 @@ static bool rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const contex
 		if(uncomp_pkt->ip_hdr_nr > 1)
 		{
 			rohc_comp_debug(context, "packet got one more IP header than context");
-			if(!ip_header_info_new(&rfc3095_ctxt->inner_ip_flags,
-			                       &uncomp_pkt->inner_ip,
-			                       context->compressor->list_trans_nr,
-			                       context->compressor->wlsb_window_width,
-			                       context->compressor->trace_callback,
-			                       context->compressor->trace_callback_priv,
-			                       context->profile->id))
+			if(!c_inner_ip_info_new(context, &uncomp_pkt->inner_ip))
 			{
 				goto error;
 			}
@@ -1261,14 +1862,33 @@ static bool rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const contex
 		else
 		{
 			rohc_comp_debug(context, "packet got one less IP header than context");
-			ip_header_info_free(&rfc3095_ctxt->inner_ip_flags);
+			c_inner_ip_info_free(rfc3095_ctxt);
 		}
 		rfc3095_ctxt->ip_hdr_nr = uncomp_pkt->ip_hdr_nr;
+		rfc3095_ctxt->static_chain_len = 0;
 	}
 
 	/* check NBO and RND of the IP-ID of the IP headers (IPv4 only) */
 	detect_ip_id_behaviours(context, uncomp_pkt);
 
+	/* steady state: if the IP headers are the ones of the last packet, volatile
+	 * fields aside, and if all the past changes were already transmitted
+	 * enough times, then the field-by-field pass below would find nothing to
+	 * send, so skip it */
+	if(rohc_comp_rfc3095_is_ip_hdr_steady(&rfc3095_ctxt->outer_ip_flags,
+	                                      &uncomp_pkt->outer_ip) &&
+	   (uncomp_pkt->ip_hdr_nr <= 1 ||
+	    rohc_comp_rfc3095_is_ip_hdr_steady(rfc3095_ctxt->inner_ip_flags,
+	                                       &uncomp_pkt->inner_ip)))
+	{
+		rohc_comp_debug(context, "IP headers did not change since last packet");
+		rfc3095_ctxt->tmp.changed_fields = 0;
+		rfc3095_ctxt->tmp.changed_fields2 = 0;
+		rfc3095_ctxt->tmp.send_static = 0;
+		rfc3095_ctxt->tmp.send_dynamic = 0;
+		goto skip;
+	}
+
 	/* find outer IP fields that changed */
 	rfc3095_ctxt->tmp.changed_fields =
 		detect_changed_fields(context, &rfc3095_ctxt->outer_ip_flags,
@@ -1284,7 +1904,7 @@ static bool rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const contex
 	if(uncomp_pkt->ip_hdr_nr > 1)
 	{
 		rfc3095_ctxt->tmp.changed_fields2 =
-			detect_changed_fields(context, &rfc3095_ctxt->inner_ip_flags,
+			detect_changed_fields(context, rfc3095_ctxt->inner_ip_flags,
 			                      &uncomp_pkt->inner_ip);
 		if(rfc3095_ctxt->tmp.changed_fields2  & MOD_ERROR)
 		{
@@ -1302,6 +1922,7 @@ static bool rohc_comp_rfc3095_detect_changes(struct rohc_comp_ctxt *const contex
 	rohc_comp_debug(context, "send_static = %d, send_dynamic = %d",
 	                rfc3095_ctxt->tmp.send_static, rfc3095_ctxt->tmp.send_dynamic);
 
+skip:
 	return true;
 
 error:
@@ -1309,6 +1930,92 @@ error:
 }
 
 
+/**
+ * @brief Whether the IP header is the one of the last packet, volatile fields
+ *        aside, with no past change left to transmit
+ *
+ * The Total Length, IP-ID and Checksum fields of IPv4 headers and the Payload
+ * Length of IPv6 headers are masked out, all the other bytes of the header
+ * are compared at once against the header recorded in context. IPv6 headers
+ * shall carry no extension header and the list compressor shall have nothing
+ * left to transmit, otherwise the list of IPv6 extension headers shall be
+ * checked: the static outer IPv6 header of IPv4-in-IPv6 tunnels is thus
+ * handled like a template.
+ *
+ * @param header_info  The IP context to compare with
+ * @param ip           The uncompressed IP header
+ * @return             true if the field-by-field comparison may be skipped,
+ *                     false if it shall be run
+ */
+static bool rohc_comp_rfc3095_is_ip_hdr_steady(const struct ip_header_info *const header_info,
+                                              const struct ip_packet *const ip)
+{
+	const struct ipv4_header_info *const v4_info = &header_info->info.v4;
+	struct ipv4_hdr ipv4;
+
+	if(header_info->is_first_header || header_info->version != ip_get_version(ip))
+	{
+		return false;
+	}
+
+	/* all the past changes of the fields shall have been transmitted enough
+	 * times */
+	if(header_info->tos_count < MAX_FO_COUNT ||
+	   header_info->ttl_count < MAX_FO_COUNT ||
+	   header_info->protocol_count < MAX_FO_COUNT)
+	{
+		return false;
+	}
+
+	if(header_info->version == IPV6)
+	{
+		const struct ipv6_header_info *const v6_info = &header_info->info.v6;
+		struct ipv6_hdr ipv6;
+		uint8_t ext_type;
+
+		/* no extension header in packet nor in context */
+		if(ip_get_next_ext_from_ip(ip, &ext_type) != NULL ||
+		   !rohc_list_is_empty_ref(&v6_info->ext_comp))
+		{
+			return false;
+		}
+
+		/* mask out the field that changes from packet to packet */
+		memcpy(&ipv6, ipv6_get_header(ip), sizeof(struct ipv6_hdr));
+		ipv6.plen = v6_info->old_ip.plen;
+
+		return (memcmp(&ipv6, &v6_info->old_ip, sizeof(struct ipv6_hdr)) == 0);
+	}
+
+	/* all the past changes of the IPv4 flags shall have been transmitted
+	 * enough times */
+	if(v4_info->df_count < MAX_FO_COUNT ||
+	   v4_info->rnd_count < MAX_FO_COUNT ||
+	   v4_info->nbo_count < MAX_FO_COUNT ||
+	   v4_info->sid_count < MAX_FO_COUNT)
+	{
+		return false;
+	}
+
+	/* the IP-ID behaviour of the current packet shall be the one of the
+	 * last packet */
+	if(v4_info->rnd != v4_info->old_rnd ||
+	   v4_info->nbo != v4_info->old_nbo ||
+	   v4_info->sid != v4_info->old_sid)
+	{
+		return false;
+	}
+
+	/* mask out the fields that change from packet to packet */
+	memcpy(&ipv4, ipv4_get_header(ip), sizeof(struct ipv4_hdr));
+	ipv4.tot_len = v4_info->old_ip.tot_len;
+	ipv4.id = v4_info->old_ip.id;
+	ipv4.check = v4_info->old_ip.check;
+
+	return (memcmp(&ipv4, &v4_info->old_ip, sizeof(struct ipv4_hdr)) == 0);
+}
+
+
 /**
  * @brief Decide the state that should be used for the next packet.
  *
@@ -1330,7 +2037,14 @@ void rohc_comp_rfc3095_decide_state(struct rohc_comp_ctxt *const context)
 
 	if(curr_state == ROHC_COMP_STATE_IR)
 	{
-		if(context->ir_count < MAX_IR_COUNT)
+		if(context->mode == ROHC_R_MODE && !rfc3095_ctxt->r_update_acked)
+		{
+			/* RFC 3095, §5.5.1.1: leave IR state once one IR packet is ACKed */
+			rohc_comp_debug(context, "no IR packet acknowledged for the moment, "
+			                "so stay in IR state");
+			next_state = ROHC_COMP_STATE_IR;
+		}
+		else if(context->mode != ROHC_R_MODE && context->ir_count < MAX_IR_COUNT)
 		{
 			rohc_comp_debug(context, "no enough packets transmitted in IR state "
 			                "for the moment (%zu/%u), so stay in IR state",
@@ -1354,8 +2068,8 @@ void rohc_comp_rfc3095_decide_state(struct rohc_comp_ctxt *const context)
 		else if((rfc3095_ctxt->outer_ip_flags.version == IPV4 &&
 		         rfc3095_ctxt->outer_ip_flags.info.v4.sid_count < MAX_FO_COUNT) ||
 		        (rfc3095_ctxt->ip_hdr_nr > 1 &&
-		         rfc3095_ctxt->inner_ip_flags.version == IPV4 &&
-		         rfc3095_ctxt->inner_ip_flags.info.v4.sid_count < MAX_FO_COUNT))
+		         rfc3095_ctxt->inner_ip_flags->version == IPV4 &&
+		         rfc3095_ctxt->inner_ip_flags->info.v4.sid_count < MAX_FO_COUNT))
 		{
 			rohc_comp_debug(context, "at least one SID flag changed now or in the "
 			                "last few packets, so go to FO state");
@@ -1370,7 +2084,14 @@ void rohc_comp_rfc3095_decide_state(struct rohc_comp_ctxt *const context)
 	}
 	else if(curr_state == ROHC_COMP_STATE_FO)
 	{
-		if(context->fo_count < MAX_FO_COUNT)
+		if(context->mode == ROHC_R_MODE && !rfc3095_ctxt->r_update_acked)
+		{
+			/* RFC 3095, §5.5.1.2: leave FO state once the update is ACKed */
+			rohc_comp_debug(context, "context update not acknowledged for the "
+			                "moment, so stay in FO state");
+			next_state = ROHC_COMP_STATE_FO;
+		}
+		else if(context->mode != ROHC_R_MODE && context->fo_count < MAX_FO_COUNT)
 		{
 			rohc_comp_debug(context, "no enough packets transmitted in FO state "
 			                "for the moment (%zu/%u), so stay in FO state",
@@ -1388,8 +2109,8 @@ void rohc_comp_rfc3095_decide_state(struct rohc_comp_ctxt *const context)
 		else if((rfc3095_ctxt->outer_ip_flags.version == IPV4 &&
 		         rfc3095_ctxt->outer_ip_flags.info.v4.sid_count < MAX_FO_COUNT) ||
 		        (rfc3095_ctxt->ip_hdr_nr > 1 &&
-		         rfc3095_ctxt->inner_ip_flags.version == IPV4 &&
-		         rfc3095_ctxt->inner_ip_flags.info.v4.sid_count < MAX_FO_COUNT))
+		         rfc3095_ctxt->inner_ip_flags->version == IPV4 &&
+		         rfc3095_ctxt->inner_ip_flags->info.v4.sid_count < MAX_FO_COUNT))
 		{
 			rohc_comp_debug(context, "at least one SID flag changed now or in "
 			                "the last few packets, so stay in FO state");
@@ -1415,8 +2136,8 @@ void rohc_comp_rfc3095_decide_state(struct rohc_comp_ctxt *const context)
 		else if((rfc3095_ctxt->outer_ip_flags.version == IPV4 &&
 		         rfc3095_ctxt->outer_ip_flags.info.v4.sid_count < MAX_FO_COUNT) ||
 		        (rfc3095_ctxt->ip_hdr_nr > 1 &&
-		         rfc3095_ctxt->inner_ip_flags.version == IPV4 &&
-		         rfc3095_ctxt->inner_ip_flags.info.v4.sid_count < MAX_FO_COUNT))
+		         rfc3095_ctxt->inner_ip_flags->version == IPV4 &&
+		         rfc3095_ctxt->inner_ip_flags->info.v4.sid_count < MAX_FO_COUNT))
 		{
 			rohc_comp_debug(context, "at least one SID flag changed now or in "
 			                "the last few packets, so go back to FO state");
@@ -1473,9 +2194,10 @@ static rohc_packet_t decide_packet(struct rohc_comp_ctxt *const context)
 		{
 			rohc_comp_debug(context, "decide packet in FO state");
 			context->fo_count++;
-			if(rfc3095_ctxt->decide_FO_packet != NULL)
+			if(rfc3095_ctxt->ops->decide_FO_packet != NULL)
 			{
-				packet = rfc3095_ctxt->decide_FO_packet(context);
+				packet = rohc_comp_rfc3095_call(rfc3095_ctxt, decide_FO_packet,
+				                                c_rtp_decide_FO_packet, context);
 			}
 			else
 			{
@@ -1488,9 +2210,10 @@ static rohc_packet_t decide_packet(struct rohc_comp_ctxt *const context)
 		{
 			rohc_comp_debug(context, "decide packet in SO state");
 			context->so_count++;
-			if(rfc3095_ctxt->decide_SO_packet != NULL)
+			if(rfc3095_ctxt->ops->decide_SO_packet != NULL)
 			{
-				packet = rfc3095_ctxt->decide_SO_packet(context);
+				packet = rohc_comp_rfc3095_call(rfc3095_ctxt, decide_SO_packet,
+				                                c_rtp_decide_SO_packet, context);
 			}
 			else
 			{
@@ -1537,6 +2260,12 @@ static rohc_packet_t decide_packet(struct rohc_comp_ctxt *const context)
 		packet = ROHC_PACKET_IR_DYN;
 	}
 
+	/* R-mode uses its own set of packets */
+	if(context->mode == ROHC_R_MODE)
+	{
+		packet = rohc_comp_rfc3095_decide_r_packet(context, packet);
+	}
+
 	return packet;
 
 error:
@@ -1544,6 +2273,149 @@ error:
 }
 
 
+/**
+ * @brief Translate the packet decided for U/O-mode into one R-mode packet
+ *
+ * RFC 3095, §5.7 defines the R-0, R-0-CRC and R-1* packets for R-mode in
+ * place of the UO-0 and UO-1* packets. The R-1* packets are not implemented:
+ * the UOR-2* packets transmit the updates instead.
+ *
+ * R-0 packets carry no CRC and do not update the context of the
+ * decompressor, so they are used only when the SN is the single field to
+ * transmit. The RTP profile encodes TS against references that every built
+ * packet updates, so it uses R-0-CRC packets only.
+ *
+ * While the transition to R-mode is not acknowledged, the UOR-2* packets
+ * with extension 3 carry the new mode to the decompressor (RFC 3095, §5.6.3).
+ *
+ * @param context  The compression context
+ * @param packet   The packet decided for the U/O-mode
+ * @return         The packet to send in R-mode
+ */
+static rohc_packet_t rohc_comp_rfc3095_decide_r_packet(struct rohc_comp_ctxt *const context,
+                                                       const rohc_packet_t packet)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const bool is_rtp = (context->profile->id == ROHC_PROFILE_RTP);
+	bool only_sn;
+	rohc_packet_t r_packet;
+
+	/* no trial coding of several candidates in R-mode */
+	rfc3095_ctxt->tmp.packet_candidates = 0;
+
+	/* is the SN the only field to transmit? */
+	if(packet == ROHC_PACKET_UO_0)
+	{
+		only_sn = true;
+	}
+	else if(!is_rtp && context->state == ROHC_COMP_STATE_SO &&
+	        (packet == ROHC_PACKET_UO_1 || packet == ROHC_PACKET_UOR_2))
+	{
+		only_sn = (no_outer_ip_id_bits_required(rfc3095_ctxt) &&
+		           (rfc3095_ctxt->ip_hdr_nr <= 1 ||
+		            no_inner_ip_id_bits_required(rfc3095_ctxt)));
+	}
+	else
+	{
+		only_sn = false;
+	}
+
+	if(only_sn && !rfc3095_ctxt->r_trans_pending && !is_rtp &&
+	   rohc_comp_rfc3095_is_sn_possible(rfc3095_ctxt, 6, 0))
+	{
+		r_packet = ROHC_PACKET_R_0;
+	}
+	else if(only_sn && !rfc3095_ctxt->r_trans_pending &&
+	        rohc_comp_rfc3095_is_sn_possible(rfc3095_ctxt, 7, 0))
+	{
+		r_packet = ROHC_PACKET_R_0_CRC;
+	}
+	else if(packet == ROHC_PACKET_UO_0 ||
+	        packet == ROHC_PACKET_UO_1 ||
+	        packet == ROHC_PACKET_UO_1_RTP ||
+	        packet == ROHC_PACKET_UO_1_ID ||
+	        packet == ROHC_PACKET_UO_1_TS)
+	{
+		/* no R-1* packet, use the UOR-2* packets of the FO state instead */
+		r_packet = rohc_comp_rfc3095_call(rfc3095_ctxt, decide_FO_packet,
+		                                  c_rtp_decide_FO_packet, context);
+	}
+	else
+	{
+		r_packet = packet;
+	}
+
+	/* remember the first packet that carries the R-mode to the decompressor,
+	 * IR and IR-DYN packets do not carry the mode */
+	if(rfc3095_ctxt->r_trans_pending)
+	{
+		if(r_packet == ROHC_PACKET_IR || r_packet == ROHC_PACKET_IR_DYN)
+		{
+			rfc3095_ctxt->r_trans_sn_valid = false;
+		}
+		else if(!rfc3095_ctxt->r_trans_sn_valid)
+		{
+			rfc3095_ctxt->r_trans_sn = rfc3095_ctxt->sn;
+			rfc3095_ctxt->r_trans_sn_valid = true;
+		}
+	}
+
+	if(r_packet != packet)
+	{
+		rohc_comp_debug(context, "R-mode: packet '%s' replaced by packet '%s'",
+		                rohc_get_packet_descr(packet),
+		                rohc_get_packet_descr(r_packet));
+	}
+
+	return r_packet;
+}
+
+
+/**
+ * @brief Record the SN of the packets that update the context in R-mode
+ *
+ * In R-mode, the compressor leaves the IR and FO states once the update of
+ * the context is acknowledged (RFC 3095, §5.5.1). The update starts with the
+ * first packet sent in the IR or FO state, and starts again every time some
+ * fields change in FO state.
+ *
+ * @param context  The compression context
+ */
+static void rohc_comp_rfc3095_track_r_update(struct rohc_comp_ctxt *const context)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	bool is_new_update;
+
+	if(context->state == ROHC_COMP_STATE_IR)
+	{
+		is_new_update = (context->ir_count == 0);
+	}
+	else if(context->state == ROHC_COMP_STATE_FO)
+	{
+		is_new_update = (context->fo_count == 0 ||
+		                 rfc3095_ctxt->tmp.send_static ||
+		                 rfc3095_ctxt->tmp.send_dynamic);
+		if(context->profile->id == ROHC_PROFILE_RTP)
+		{
+			const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+			is_new_update = (is_new_update || rtp_context->tmp.send_rtp_dynamic);
+		}
+	}
+	else
+	{
+		is_new_update = false;
+	}
+
+	if(is_new_update)
+	{
+		rohc_comp_debug(context, "R-mode: context update starts with SN %u",
+		                rfc3095_ctxt->sn);
+		rfc3095_ctxt->r_update_sn = rfc3095_ctxt->sn;
+		rfc3095_ctxt->r_update_acked = false;
+	}
+}
+
+
 /**
  * @brief Build the ROHC packet to send.
  *
@@ -1579,8 +2451,12 @@ int code_packet(struct rohc_comp_ctxt *const context,
 			break;
 
 		case ROHC_PACKET_UO_0:
+		case ROHC_PACKET_R_0:
 			code_packet_type = code_UO0_packet;
 			break;
+		case ROHC_PACKET_R_0_CRC:
+			code_packet_type = rohc_comp_rfc3095_build_r0crc_pkt;
+			break;
 
 		case ROHC_PACKET_UO_1:
 			code_packet_type = rohc_comp_rfc3095_build_uo1_pkt;
@@ -1672,6 +2548,7 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	size_t counter;
 	size_t first_position;
 	int crc_position;
+	size_t static_end;
 	int ret;
 
 	assert(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 16);
@@ -1692,26 +2569,26 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter'
 	 */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
+	ret = code_cid_values(&(context->cid_hdr),
 	                      rohc_pkt, rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
 		               "%zu-byte ROHC buffer is too small",
-		               context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 		               "small" : "large", context->cid, rohc_pkt_max_len);
 		goto error;
 	}
 	counter = ret;
 	rohc_comp_debug(context, "%s CID %zu encoded on %zu byte(s)",
-	                context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+	                c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 	                "small" : "large", context->cid, counter - 1);
 
 	/* initialize some profile-specific things when building an IR
 	 * or IR-DYN packet */
-	if(rfc3095_ctxt->init_at_IR != NULL)
+	if(rfc3095_ctxt->ops->init_at_IR != NULL)
 	{
-		rfc3095_ctxt->init_at_IR(context, uncomp_pkt->transport->data);
+		rfc3095_ctxt->ops->init_at_IR(context, uncomp_pkt->transport->data);
 	}
 
 	/* part 2: type of packet and D flag if dynamic part is included */
@@ -1750,13 +2627,43 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	rohc_pkt[counter] = 0;
 	counter++;
 
-	/* part 6: static part */
-	ret = rohc_code_static_part(context, uncomp_pkt, rohc_pkt, counter);
-	if(ret < 0)
+	/* part 6: static part, built by the first IR packet of the context then
+	 * copied with the CRC of the IR header so far: the CID, the packet type
+	 * and the profile ID of the context do not change either */
+	if(rfc3095_ctxt->static_chain_len > 0)
 	{
-		goto error;
+		if((rohc_pkt_max_len - counter) < rfc3095_ctxt->static_chain_len)
+		{
+			rohc_comp_warn(context, "ROHC packet is too small for the %u-byte "
+			               "static chain", rfc3095_ctxt->static_chain_len);
+			goto error;
+		}
+		memcpy(rohc_pkt + counter, rfc3095_ctxt->static_chain,
+		       rfc3095_ctxt->static_chain_len);
+		counter += rfc3095_ctxt->static_chain_len;
+		C_COUNT_INC(rfc3095_ctxt->outer_ip_flags.protocol_count);
+		if(nr_of_ip_hdr > 1)
+		{
+			C_COUNT_INC(rfc3095_ctxt->inner_ip_flags->protocol_count);
+		}
 	}
-	counter = ret;
+	else
+	{
+		ret = rohc_code_static_part(context, uncomp_pkt, rohc_pkt, counter);
+		if(ret < 0)
+		{
+			goto error;
+		}
+		assert((ret - counter) <= ROHC_COMP_RFC3095_STATIC_CHAIN_MAX_LEN);
+		rfc3095_ctxt->static_chain_len = ret - counter;
+		memcpy(rfc3095_ctxt->static_chain, rohc_pkt + counter,
+		       rfc3095_ctxt->static_chain_len);
+		rfc3095_ctxt->static_chain_crc =
+			crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, ret, CRC_INIT_8,
+			              rohc_crc_table_8);
+		counter = ret;
+	}
+	static_end = counter;
 
 	/* part 7: if we do not want dynamic part in IR packet, we should not
 	 * send the following */
@@ -1768,9 +2675,9 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 	counter = ret;
 
 	/* part 8: IR remainder header */
-	if(rfc3095_ctxt->code_ir_remainder != NULL)
+	if(rfc3095_ctxt->ops->code_ir_remainder != NULL)
 	{
-		ret = rfc3095_ctxt->code_ir_remainder(context, rohc_pkt, rohc_pkt_max_len,
+		ret = rfc3095_ctxt->ops->code_ir_remainder(context, rohc_pkt, rohc_pkt_max_len,
 		                                      counter);
 		if(ret < 0)
 		{
@@ -1780,10 +2687,14 @@ static int code_IR_packet(struct rohc_comp_ctxt *const context,
 		counter = ret;
 	}
 
-	/* part 5 */
-	rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, counter,
-	                                       CRC_INIT_8,
-	                                       context->compressor->crc_table_8);
+	/* part 5: the CRC of the IR header up to the static chain is cached */
+	if((c_features(context->compressor) & ROHC_COMP_FEATURE_ESTIMATE) == 0)
+	{
+		rohc_pkt[crc_position] =
+			crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt + static_end,
+			              counter - static_end, rfc3095_ctxt->static_chain_crc,
+			              rohc_crc_table_8);
+	}
 	rohc_comp_debug(context, "CRC (header length = %zu, crc = 0x%x)",
 	                counter, rohc_pkt[crc_position]);
 
@@ -1859,26 +2770,26 @@ static int code_IR_DYN_packet(struct rohc_comp_ctxt *const context,
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter'
 	 */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
+	ret = code_cid_values(&(context->cid_hdr),
 	                      rohc_pkt, rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
 		               "%zu-byte ROHC buffer is too small",
-		               context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 		               "small" : "large", context->cid, rohc_pkt_max_len);
 		goto error;
 	}
 	counter = ret;
 	rohc_comp_debug(context, "%s CID %zu encoded on %zu byte(s)",
-	                context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+	                c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 	                "small" : "large", context->cid, counter - 1);
 
 	/* initialize some profile-specific things when building an IR
 	 * or IR-DYN packet */
-	if(rfc3095_ctxt->init_at_IR != NULL)
+	if(rfc3095_ctxt->ops->init_at_IR != NULL)
 	{
-		rfc3095_ctxt->init_at_IR(context, uncomp_pkt->transport->data);
+		rfc3095_ctxt->ops->init_at_IR(context, uncomp_pkt->transport->data);
 	}
 
 	/* part 2 */
@@ -1912,9 +2823,9 @@ static int code_IR_DYN_packet(struct rohc_comp_ctxt *const context,
 	counter = ret;
 
 	/* part 7: IR-DYN remainder header */
-	if(rfc3095_ctxt->code_ir_remainder != NULL)
+	if(rfc3095_ctxt->ops->code_ir_remainder != NULL)
 	{
-		ret = rfc3095_ctxt->code_ir_remainder(context, rohc_pkt, rohc_pkt_max_len,
+		ret = rfc3095_ctxt->ops->code_ir_remainder(context, rohc_pkt, rohc_pkt_max_len,
 		                                      counter);
 		if(ret < 0)
 		{
@@ -1925,9 +2836,11 @@ static int code_IR_DYN_packet(struct rohc_comp_ctxt *const context,
 	}
 
 	/* part 5 */
-	rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, counter,
-	                                       CRC_INIT_8,
-	                                       context->compressor->crc_table_8);
+	if((c_features(context->compressor) & ROHC_COMP_FEATURE_ESTIMATE) == 0)
+	{
+		rohc_pkt[crc_position] = crc_calculate(ROHC_CRC_TYPE_8, rohc_pkt, counter,
+		                                       CRC_INIT_8, rohc_crc_table_8);
+	}
 	rohc_comp_debug(context, "CRC (header length = %zu, crc = 0x%x)",
 	                counter, rohc_pkt[crc_position]);
 
@@ -1968,7 +2881,7 @@ static int rohc_code_static_part(const struct rohc_comp_ctxt *const context,
 	/* static part of the inner IP header (if any) */
 	if(uncomp_pkt->ip_hdr_nr > 1)
 	{
-		ret = rohc_code_static_ip_part(context, &rfc3095_ctxt->inner_ip_flags,
+		ret = rohc_code_static_ip_part(context, rfc3095_ctxt->inner_ip_flags,
 		                               &uncomp_pkt->inner_ip, rohc_pkt, counter);
 		if(ret < 0)
 		{
@@ -1978,11 +2891,13 @@ static int rohc_code_static_part(const struct rohc_comp_ctxt *const context,
 	}
 
 	/* static part of the transport header (if any) */
-	if(rfc3095_ctxt->code_static_part != NULL &&
+	if(rfc3095_ctxt->ops->code_static_part != NULL &&
 	   uncomp_pkt->transport->data != NULL)
 	{
-		ret = rfc3095_ctxt->code_static_part(context, uncomp_pkt->transport->data,
-		                                     rohc_pkt, counter);
+		ret = rohc_comp_rfc3095_call(rfc3095_ctxt, code_static_part,
+		                             rtp_code_static_rtp_part, context,
+		                             uncomp_pkt->transport->data, rohc_pkt,
+		                             counter);
 		if(ret < 0)
 		{
 			goto error;
@@ -2074,7 +2989,7 @@ static int code_ipv4_static_part(const struct rohc_comp_ctxt *const context,
 	rohc_comp_debug(context, "protocol = 0x%02x", protocol);
 	dest[counter] = protocol;
 	counter++;
-	header_info->protocol_count++;
+	C_COUNT_INC(header_info->protocol_count);
 
 	/* part 3 */
 	saddr = ipv4_get_saddr(ip);
@@ -2149,7 +3064,7 @@ static int code_ipv6_static_part(const struct rohc_comp_ctxt *const context,
 	rohc_comp_debug(context, "next header = 0x%02x", protocol);
 	dest[counter] = protocol;
 	counter++;
-	header_info->protocol_count++;
+	C_COUNT_INC(header_info->protocol_count);
 
 	/* part 4 */
 	saddr = ipv6_get_saddr(ip);
@@ -2204,7 +3119,7 @@ static int rohc_code_dynamic_part(const struct rohc_comp_ctxt *const context,
 	{
 		ip_hdr_pos++;
 		ret = rohc_code_dynamic_ip_part(context, ip_hdr_pos,
-		                                &rfc3095_ctxt->inner_ip_flags,
+		                                rfc3095_ctxt->inner_ip_flags,
 		                                &uncomp_pkt->inner_ip, rohc_pkt,
 		                                counter);
 		if(ret < 0)
@@ -2215,11 +3130,13 @@ static int rohc_code_dynamic_part(const struct rohc_comp_ctxt *const context,
 	}
 
 	/* static part of the transport header (if any) */
-	if(rfc3095_ctxt->code_dynamic_part != NULL &&
+	if(rfc3095_ctxt->ops->code_dynamic_part != NULL &&
 	   uncomp_pkt->transport->data != NULL)
 	{
-		ret = rfc3095_ctxt->code_dynamic_part(context, uncomp_pkt->transport->data,
-		                                      rohc_pkt, counter);
+		ret = rohc_comp_rfc3095_call(rfc3095_ctxt, code_dynamic_part,
+		                             rtp_code_dynamic_rtp_part, context,
+		                             uncomp_pkt->transport->data, rohc_pkt,
+		                             counter);
 		if(ret < 0)
 		{
 			goto error;
@@ -2314,14 +3231,14 @@ static int code_ipv4_dynamic_part(const struct rohc_comp_ctxt *const context,
 	dest[counter] = tos;
 	rohc_comp_debug(context, "TOS = 0x%02x", dest[counter]);
 	counter++;
-	header_info->tos_count++;
+	C_COUNT_INC(header_info->tos_count);
 
 	/* part 2 */
 	ttl = ip_get_ttl(ip);
 	dest[counter] = ttl;
 	rohc_comp_debug(context, "TTL = 0x%02x", dest[counter]);
 	counter++;
-	header_info->ttl_count++;
+	C_COUNT_INC(header_info->ttl_count);
 
 	/* part 3 */
 	/* always transmit IP-ID verbatim in IR and IR-DYN as stated by
@@ -2353,10 +3270,10 @@ static int code_ipv4_dynamic_part(const struct rohc_comp_ctxt *const context,
 	                header_info->info.v4.sid, dest[counter]);
 	counter++;
 
-	header_info->info.v4.df_count++;
-	header_info->info.v4.rnd_count++;
-	header_info->info.v4.nbo_count++;
-	header_info->info.v4.sid_count++;
+	C_COUNT_INC(header_info->info.v4.df_count);
+	C_COUNT_INC(header_info->info.v4.rnd_count);
+	C_COUNT_INC(header_info->info.v4.nbo_count);
+	C_COUNT_INC(header_info->info.v4.sid_count);
 
 	/* part 5 is not supported for the moment, but the field is mandatory,
 	   so add a zero byte */
@@ -2410,14 +3327,14 @@ static int code_ipv6_dynamic_part(const struct rohc_comp_ctxt *const context,
 	tos = ip_get_tos(ip);
 	dest[counter] = tos;
 	counter++;
-	header_info->tos_count++;
+	C_COUNT_INC(header_info->tos_count);
 	rohc_comp_debug(context, "TC = 0x%02x", tos);
 
 	/* part 2 */
 	ttl = ip_get_ttl(ip);
 	dest[counter] = ttl;
 	counter++;
-	header_info->ttl_count++;
+	C_COUNT_INC(header_info->ttl_count);
 	rohc_comp_debug(context, "HL = 0x%02x", ttl);
 
 	/* part 3: Generic extension header list */
@@ -2557,7 +3474,7 @@ static int code_uo_remainder(struct rohc_comp_ctxt *const context,
 	/* step 9: only IPv4 */
 	if(uncomp_pkt->ip_hdr_nr > 1 &&
 	   ip_get_version(&uncomp_pkt->inner_ip) == IPV4 &&
-	   rfc3095_ctxt->inner_ip_flags.info.v4.rnd == 1)
+	   rfc3095_ctxt->inner_ip_flags->info.v4.rnd == 1)
 	{
 		/* do not care of Network Byte Order because IP-ID is random */
 		id = ipv4_get_id(&uncomp_pkt->inner_ip);
@@ -2570,19 +3487,200 @@ static int code_uo_remainder(struct rohc_comp_ctxt *const context,
 
 	/* part 13 */
 	/* add fields related to the next header */
-	if(rfc3095_ctxt->code_uo_remainder != NULL &&
+	if(rfc3095_ctxt->ops->code_uo_remainder != NULL &&
 	   uncomp_pkt->transport->data != NULL)
 	{
-		counter = rfc3095_ctxt->code_uo_remainder(context, uncomp_pkt->transport->data,
-		                                          dest, counter);
+		counter = rohc_comp_rfc3095_call(rfc3095_ctxt, code_uo_remainder,
+		                                 udp_code_uo_remainder, context,
+		                                 uncomp_pkt->transport->data, dest,
+		                                 counter);
+	}
+
+	return counter;
+}
+
+
+/**
+ * @brief Build the UO-0 packet, or the R-0 packet in R-mode
+ *
+ * Both packets are one single byte long, so they share the same layout.
+ *
+ * \verbatim
+
+      0   1   2   3   4   5   6   7
+     --- --- --- --- --- --- --- ---
+ 1  :         Add-CID octet         :
+    +---+---+---+---+---+---+---+---+
+ 2  |   first octet of base header  |
+    +---+---+---+---+---+---+---+---+
+    :                               :
+ 3  /   0, 1, or 2 octets of CID    /
+    :                               :
+    +---+---+---+---+---+---+---+---+
+
+ UO-0 (5.7.1)
+
+      0   1   2   3   4   5   6   7
+    +---+---+---+---+---+---+---+---+
+ 2  | 0 |      SN       |    CRC    |
+    +===+===+===+===+===+===+===+===+
+
+ R-0 (5.7.1)
+
+      0   1   2   3   4   5   6   7
+    +---+---+---+---+---+---+---+---+
+ 2  | 0   0 |          SN           |
+    +===+===+===+===+===+===+===+===+
+
+\endverbatim
+ *
+ * @param context           The compression context
+ * @param uncomp_pkt        The uncompressed packet to encode
+ * @param rohc_pkt          OUT: The ROHC packet
+ * @param rohc_pkt_max_len  The maximum length of the ROHC packet
+ * @return                  The length of the ROHC packet if successful,
+ *                          -1 otherwise
+ */
+static int code_UO0_packet(struct rohc_comp_ctxt *const context,
+                           const struct net_pkt *const uncomp_pkt,
+                           uint8_t *const rohc_pkt,
+                           const size_t rohc_pkt_max_len)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt =
+		(struct rohc_comp_rfc3095_ctxt *) context->specific;
+	struct rohc_comp_rfc3095_uo0_tmpl *const tmpl = &rfc3095_ctxt->uo0_tmpl;
+	const bool outer_rnd =
+		(ip_get_version(&uncomp_pkt->outer_ip) == IPV4 &&
+		 rfc3095_ctxt->outer_ip_flags.info.v4.rnd == 1);
+	const bool inner_rnd =
+		(uncomp_pkt->ip_hdr_nr > 1 &&
+		 ip_get_version(&uncomp_pkt->inner_ip) == IPV4 &&
+		 rfc3095_ctxt->inner_ip_flags->info.v4.rnd == 1);
+	size_t counter;
+	size_t first_position;
+	uint8_t f_byte;
+	uint8_t crc;
+	int ret;
+
+	rohc_comp_debug(context, "code %s packet (CID = %zu)",
+	                rohc_get_packet_descr(rfc3095_ctxt->tmp.packet_type),
+	                context->cid);
+
+	if(rfc3095_ctxt->tmp.packet_type == ROHC_PACKET_R_0)
+	{
+		/* part 2: SN, no CRC */
+		f_byte = rfc3095_ctxt->sn & 0x3f;
+		rohc_comp_debug(context, "first byte = 0x%02x", f_byte);
+	}
+	else
+	{
+		/* part 2: SN + CRC
+		 * TODO: The CRC should be computed only on the CRC-DYNAMIC fields
+		 * if the CRC-STATIC fields did not change */
+		assert(rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4 <= 4);
+		f_byte = (rfc3095_ctxt->sn & 0x0f) << 3;
+		crc = compute_uo_crc(context, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
+		                     rohc_crc_table_3);
+		f_byte |= crc;
+		rohc_comp_debug(context, "first byte = 0x%02x (CRC = 0x%x)", f_byte, crc);
+	}
+
+	/* steady state: the CID octets and the positions of the base header and
+	 * of the random IP-IDs did not change since the last UO-0 packet, so copy
+	 * the recorded layout and fill its holes */
+	if(tmpl->is_valid && tmpl->outer_rnd == outer_rnd &&
+	   tmpl->inner_rnd == inner_rnd && tmpl->len <= rohc_pkt_max_len)
+	{
+		uint16_t id;
+
+		memcpy(rohc_pkt, tmpl->bytes, tmpl->len);
+		rohc_pkt[tmpl->sn_crc_pos] = f_byte;
+		if(outer_rnd)
+		{
+			/* do not care of Network Byte Order because IP-ID is random */
+			id = ipv4_get_id(&uncomp_pkt->outer_ip);
+			memcpy(&rohc_pkt[tmpl->outer_ip_id_pos], &id, 2);
+		}
+		if(inner_rnd)
+		{
+			/* do not care of Network Byte Order because IP-ID is random */
+			id = ipv4_get_id(&uncomp_pkt->inner_ip);
+			memcpy(&rohc_pkt[tmpl->inner_ip_id_pos], &id, 2);
+		}
+		counter = tmpl->len;
+
+		/* part 13: add fields related to the next header */
+		if(rfc3095_ctxt->ops->code_uo_remainder != NULL &&
+		   uncomp_pkt->transport->data != NULL)
+		{
+			counter = rohc_comp_rfc3095_call(rfc3095_ctxt, code_uo_remainder,
+			                                 udp_code_uo_remainder, context,
+			                                 uncomp_pkt->transport->data,
+			                                 rohc_pkt, counter);
+		}
+
+		return counter;
+	}
+
+	/* parts 1 and 3:
+	 *  - part 2 will be placed at 'first_position'
+	 *  - part 4 will start at 'counter'
+	 */
+	ret = code_cid_values(&(context->cid_hdr),
+	                      rohc_pkt, rohc_pkt_max_len, &first_position);
+	if(ret < 1)
+	{
+		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
+		               "%zu-byte ROHC buffer is too small",
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
+		               "small" : "large", context->cid, rohc_pkt_max_len);
+		goto error;
+	}
+	counter = ret;
+	rohc_comp_debug(context, "%s CID %zu encoded on %zu byte(s)",
+	                c_cid_type(context->compressor) == ROHC_SMALL_CID ?
+	                "small" : "large", context->cid, counter - 1);
+
+	/* build the UO head if necessary */
+	if(rfc3095_ctxt->ops->code_UO_packet_head != NULL && uncomp_pkt->transport->data != NULL)
+	{
+		counter = rfc3095_ctxt->ops->code_UO_packet_head(context, uncomp_pkt->transport->data,
+		                                            rohc_pkt, counter, &first_position);
+	}
+
+	rohc_pkt[first_position] = f_byte;
+
+	/* record the layout for the next UO-0 packets: the IP-IDs, if random,
+	 * are the first fields of the UO tail; the UO head depends on the packet
+	 * so no layout is recorded if the profile adds one */
+	tmpl->is_valid = false;
+	if(rfc3095_ctxt->ops->code_UO_packet_head == NULL)
+	{
+		tmpl->outer_rnd = outer_rnd;
+		tmpl->inner_rnd = inner_rnd;
+		tmpl->sn_crc_pos = first_position;
+		tmpl->outer_ip_id_pos = counter;
+		tmpl->inner_ip_id_pos = counter + (outer_rnd ? 2 : 0);
+		tmpl->len = tmpl->inner_ip_id_pos + (inner_rnd ? 2 : 0);
+		tmpl->is_valid = (tmpl->len <= ROHC_COMP_RFC3095_UO0_TMPL_MAX_LEN);
+	}
+
+	/* build the UO tail */
+	counter = code_uo_remainder(context, uncomp_pkt, rohc_pkt, counter);
+	if(tmpl->is_valid)
+	{
+		memcpy(tmpl->bytes, rohc_pkt, tmpl->len);
 	}
 
 	return counter;
+
+error:
+	return -1;
 }
 
 
 /**
- * @brief Build the UO-0 packet.
+ * @brief Build the R-0-CRC packet.
  *
  * \verbatim
 
@@ -2597,12 +3695,14 @@ static int code_uo_remainder(struct rohc_comp_ctxt *const context,
     :                               :
     +---+---+---+---+---+---+---+---+
 
- UO-0 (5.7.1)
+ R-0-CRC (5.7.1)
 
       0   1   2   3   4   5   6   7
     +---+---+---+---+---+---+---+---+
- 2  | 0 |      SN       |    CRC    |
+ 2  | 0   1 |          SN           |
     +===+===+===+===+===+===+===+===+
+ 4  |SN |            CRC            |
+    +---+---+---+---+---+---+---+---+
 
 \endverbatim
  *
@@ -2613,58 +3713,65 @@ static int code_uo_remainder(struct rohc_comp_ctxt *const context,
  * @return                  The length of the ROHC packet if successful,
  *                          -1 otherwise
  */
-static int code_UO0_packet(struct rohc_comp_ctxt *const context,
-                           const struct net_pkt *const uncomp_pkt,
-                           uint8_t *const rohc_pkt,
-                           const size_t rohc_pkt_max_len)
+static int rohc_comp_rfc3095_build_r0crc_pkt(struct rohc_comp_ctxt *const context,
+                                             const struct net_pkt *const uncomp_pkt,
+                                             uint8_t *const rohc_pkt,
+                                             const size_t rohc_pkt_max_len)
 {
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt =
+		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 	size_t counter;
 	size_t first_position;
-	uint8_t f_byte;
-	struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt;
 	uint8_t crc;
 	int ret;
 
-	rfc3095_ctxt = (struct rohc_comp_rfc3095_ctxt *) context->specific;
+	rohc_comp_debug(context, "code R-0-CRC packet (CID = %zu)", context->cid);
 
-	rohc_comp_debug(context, "code UO-0 packet (CID = %zu)", context->cid);
+	assert(rfc3095_ctxt->tmp.packet_type == ROHC_PACKET_R_0_CRC);
 
 	/* parts 1 and 3:
 	 *  - part 2 will be placed at 'first_position'
-	 *  - part 4 will start at 'counter'
-	 */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
+	 *  - part 4 will start at 'counter' */
+	ret = code_cid_values(&(context->cid_hdr),
 	                      rohc_pkt, rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
 		               "%zu-byte ROHC buffer is too small",
-		               context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 		               "small" : "large", context->cid, rohc_pkt_max_len);
 		goto error;
 	}
 	counter = ret;
 	rohc_comp_debug(context, "%s CID %zu encoded on %zu byte(s)",
-	                context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+	                c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 	                "small" : "large", context->cid, counter - 1);
 
 	/* build the UO head if necessary */
-	if(rfc3095_ctxt->code_UO_packet_head != NULL && uncomp_pkt->transport->data != NULL)
+	if(rfc3095_ctxt->ops->code_UO_packet_head != NULL && uncomp_pkt->transport->data != NULL)
 	{
-		counter = rfc3095_ctxt->code_UO_packet_head(context, uncomp_pkt->transport->data,
+		counter = rfc3095_ctxt->ops->code_UO_packet_head(context, uncomp_pkt->transport->data,
 		                                            rohc_pkt, counter, &first_position);
 	}
 
-	/* part 2: SN + CRC
+	/* part 2: the 6 MSB of the 7 SN bits */
+	rohc_pkt[first_position] = 0x40 | ((rfc3095_ctxt->sn >> 1) & 0x3f);
+	rohc_comp_debug(context, "0 1 + SN = 0x%02x", rohc_pkt[first_position]);
+
+	/* part 4: the LSB of the 7 SN bits + CRC
 	 * TODO: The CRC should be computed only on the CRC-DYNAMIC fields
 	 * if the CRC-STATIC fields did not change */
-	assert(rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4 <= 4);
-	f_byte = (rfc3095_ctxt->sn & 0x0f) << 3;
-	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
-	                     context->compressor->crc_table_3);
-	f_byte |= crc;
-	rohc_comp_debug(context, "first byte = 0x%02x (CRC = 0x%x)", f_byte, crc);
-	rohc_pkt[first_position] = f_byte;
+	if((rohc_pkt_max_len - counter) < 1)
+	{
+		rohc_comp_warn(context, "ROHC packet is too small for SN/CRC byte");
+		goto error;
+	}
+	crc = compute_uo_crc(context, uncomp_pkt, ROHC_CRC_TYPE_7, CRC_INIT_7,
+	                     rohc_crc_table_7);
+	rohc_pkt[counter] = ((rfc3095_ctxt->sn & 0x01) << 7) | (crc & 0x7f);
+	rohc_comp_debug(context, "SN (%u) + CRC (0x%x) = 0x%02x",
+	                rfc3095_ctxt->sn, crc, rohc_pkt[counter]);
+	counter++;
 
 	/* build the UO tail */
 	counter = code_uo_remainder(context, uncomp_pkt, rohc_pkt, counter);
@@ -2763,31 +3870,31 @@ static int rohc_comp_rfc3095_build_uo1_pkt(struct rohc_comp_ctxt *const context,
 	assert(rfc3095_ctxt->outer_ip_flags.version != IPV4 ||
 	       rfc3095_ctxt->outer_ip_flags.info.v4.rnd_count >= MAX_FO_COUNT);
 	assert(uncomp_pkt->ip_hdr_nr <= 1 ||
-	       rfc3095_ctxt->inner_ip_flags.version != IPV4 ||
-	       rfc3095_ctxt->inner_ip_flags.info.v4.rnd_count >= MAX_FO_COUNT);
+	       rfc3095_ctxt->inner_ip_flags->version != IPV4 ||
+	       rfc3095_ctxt->inner_ip_flags->info.v4.rnd_count >= MAX_FO_COUNT);
 
 	/* parts 1 and 3:
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter' */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
+	ret = code_cid_values(&(context->cid_hdr),
 	                      rohc_pkt, rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
 		               "%zu-byte ROHC buffer is too small",
-		               context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 		               "small" : "large", context->cid, rohc_pkt_max_len);
 		goto error;
 	}
 	counter = ret;
 	rohc_comp_debug(context, "%s CID %zu encoded on %zu byte(s)",
-	                context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+	                c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 	                "small" : "large", context->cid, counter - 1);
 
 	/* build the UO head if necessary */
-	if(rfc3095_ctxt->code_UO_packet_head != NULL && uncomp_pkt->transport->data != NULL)
+	if(rfc3095_ctxt->ops->code_UO_packet_head != NULL && uncomp_pkt->transport->data != NULL)
 	{
-		counter = rfc3095_ctxt->code_UO_packet_head(context, uncomp_pkt->transport->data,
+		counter = rfc3095_ctxt->ops->code_UO_packet_head(context, uncomp_pkt->transport->data,
 		                                            rohc_pkt, counter, &first_position);
 	}
 
@@ -2803,8 +3910,8 @@ static int rohc_comp_rfc3095_build_uo1_pkt(struct rohc_comp_ctxt *const context,
 		rohc_comp_warn(context, "ROHC packet is too small for SN/CRC byte");
 		goto error;
 	}
-	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
-	                     context->compressor->crc_table_3);
+	crc = compute_uo_crc(context, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
+	                     rohc_crc_table_3);
 	rohc_pkt[counter] = ((rfc3095_ctxt->sn & 0x1f) << 3) | (crc & 0x07);
 	rohc_comp_debug(context, "SN (%d) + CRC (%x) = 0x%02x",
 	                rfc3095_ctxt->sn, crc, rohc_pkt[counter]);
@@ -2904,25 +4011,25 @@ static int rohc_comp_rfc3095_build_uo1rtp_pkt(struct rohc_comp_ctxt *const conte
 	/* parts 1 and 3:
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter' */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
+	ret = code_cid_values(&(context->cid_hdr),
 	                      rohc_pkt, rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
 		               "%zu-byte ROHC buffer is too small",
-		               context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 		               "small" : "large", context->cid, rohc_pkt_max_len);
 		goto error;
 	}
 	counter = ret;
 	rohc_comp_debug(context, "%s CID %zu encoded on %zu byte(s)",
-	                context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+	                c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 	                "small" : "large", context->cid, counter - 1);
 
 	/* build the UO head if necessary */
-	if(rfc3095_ctxt->code_UO_packet_head != NULL && uncomp_pkt->transport->data != NULL)
+	if(rfc3095_ctxt->ops->code_UO_packet_head != NULL && uncomp_pkt->transport->data != NULL)
 	{
-		counter = rfc3095_ctxt->code_UO_packet_head(context, uncomp_pkt->transport->data,
+		counter = rfc3095_ctxt->ops->code_UO_packet_head(context, uncomp_pkt->transport->data,
 		                                            rohc_pkt, counter, &first_position);
 	}
 
@@ -2940,8 +4047,8 @@ static int rohc_comp_rfc3095_build_uo1rtp_pkt(struct rohc_comp_ctxt *const conte
 	}
 	rohc_pkt[counter] = ((!!rtp_context->tmp.is_marker_bit_set) & 0x01) << 7;
 	rohc_pkt[counter] |= (rfc3095_ctxt->sn & 0x0f) << 3;
-	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
-	                     context->compressor->crc_table_3);
+	crc = compute_uo_crc(context, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
+	                     rohc_crc_table_3);
 	rohc_pkt[counter] |= crc & 0x07;
 	rohc_comp_debug(context, "M (%d) + SN (%d) + CRC (%x) = 0x%02x",
 	                !!rtp_context->tmp.is_marker_bit_set,
@@ -3047,31 +4154,31 @@ static int rohc_comp_rfc3095_build_uo1ts_pkt(struct rohc_comp_ctxt *const contex
 	assert(rfc3095_ctxt->outer_ip_flags.version != IPV4 ||
 	       rfc3095_ctxt->outer_ip_flags.info.v4.rnd_count >= MAX_FO_COUNT);
 	assert(uncomp_pkt->ip_hdr_nr <= 1 ||
-	       rfc3095_ctxt->inner_ip_flags.version != IPV4 ||
-	       rfc3095_ctxt->inner_ip_flags.info.v4.rnd_count >= MAX_FO_COUNT);
+	       rfc3095_ctxt->inner_ip_flags->version != IPV4 ||
+	       rfc3095_ctxt->inner_ip_flags->info.v4.rnd_count >= MAX_FO_COUNT);
 
 	/* parts 1 and 3:
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter' */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
+	ret = code_cid_values(&(context->cid_hdr),
 	                      rohc_pkt, rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
 		               "%zu-byte ROHC buffer is too small",
-		               context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 		               "small" : "large", context->cid, rohc_pkt_max_len);
 		goto error;
 	}
 	counter = ret;
 	rohc_comp_debug(context, "%s CID %zu encoded on %zu byte(s)",
-	                context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+	                c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 	                "small" : "large", context->cid, counter - 1);
 
 	/* build the UO head if necessary */
-	if(rfc3095_ctxt->code_UO_packet_head != NULL && uncomp_pkt->transport->data != NULL)
+	if(rfc3095_ctxt->ops->code_UO_packet_head != NULL && uncomp_pkt->transport->data != NULL)
 	{
-		counter = rfc3095_ctxt->code_UO_packet_head(context, uncomp_pkt->transport->data,
+		counter = rfc3095_ctxt->ops->code_UO_packet_head(context, uncomp_pkt->transport->data,
 		                                            rohc_pkt, counter, &first_position);
 	}
 
@@ -3088,8 +4195,8 @@ static int rohc_comp_rfc3095_build_uo1ts_pkt(struct rohc_comp_ctxt *const contex
 		rohc_comp_warn(context, "ROHC packet is too small for SN/CRC byte");
 		goto error;
 	}
-	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
-	                     context->compressor->crc_table_3);
+	crc = compute_uo_crc(context, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
+	                     rohc_crc_table_3);
 	rohc_pkt[counter] = ((!!rtp_context->tmp.is_marker_bit_set) & 0x01) << 7;
 	rohc_pkt[counter] |= (rfc3095_ctxt->sn & 0x0f) << 3;
 	rohc_pkt[counter] |= crc & 0x07;
@@ -3206,36 +4313,37 @@ static int rohc_comp_rfc3095_build_uo1id_pkt(struct rohc_comp_ctxt *const contex
 	assert(rfc3095_ctxt->outer_ip_flags.version != IPV4 ||
 	       rfc3095_ctxt->outer_ip_flags.info.v4.rnd_count >= MAX_FO_COUNT);
 	assert(uncomp_pkt->ip_hdr_nr <= 1 ||
-	       rfc3095_ctxt->inner_ip_flags.version != IPV4 ||
-	       rfc3095_ctxt->inner_ip_flags.info.v4.rnd_count >= MAX_FO_COUNT);
+	       rfc3095_ctxt->inner_ip_flags->version != IPV4 ||
+	       rfc3095_ctxt->inner_ip_flags->info.v4.rnd_count >= MAX_FO_COUNT);
 
 	/* parts 1 and 3:
 	 *  - part 2 will be placed at 'first_position'
 	 *  - part 4 will start at 'counter' */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
+	ret = code_cid_values(&(context->cid_hdr),
 	                      rohc_pkt, rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
 		               "%zu-byte ROHC buffer is too small",
-		               context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 		               "small" : "large", context->cid, rohc_pkt_max_len);
 		goto error;
 	}
 	counter = ret;
 	rohc_comp_debug(context, "%s CID %zu encoded on %zu byte(s)",
-	                context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+	                c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 	                "small" : "large", context->cid, counter - 1);
 
 	/* build the UO head if necessary */
-	if(rfc3095_ctxt->code_UO_packet_head != NULL && uncomp_pkt->transport->data != NULL)
+	if(rfc3095_ctxt->ops->code_UO_packet_head != NULL && uncomp_pkt->transport->data != NULL)
 	{
-		counter = rfc3095_ctxt->code_UO_packet_head(context, uncomp_pkt->transport->data,
+		counter = rfc3095_ctxt->ops->code_UO_packet_head(context, uncomp_pkt->transport->data,
 		                                            rohc_pkt, counter, &first_position);
 	}
 
 	/* part 5: decide which extension to use */
-	extension = rfc3095_ctxt->decide_extension(context);
+	extension = rohc_comp_rfc3095_call(rfc3095_ctxt, decide_extension,
+	                                   c_rtp_decide_extension, context);
 	if(extension == ROHC_EXT_UNKNOWN)
 	{
 		rohc_comp_warn(context, "failed to determine the extension to code");
@@ -3297,7 +4405,7 @@ static int rohc_comp_rfc3095_build_uo1id_pkt(struct rohc_comp_ctxt *const contex
 			}
 			else /* ROHC_IP_HDR_SECOND */
 			{
-				innermost_ip_id_rnd_count = rfc3095_ctxt->inner_ip_flags.info.v4.rnd_count;
+				innermost_ip_id_rnd_count = rfc3095_ctxt->inner_ip_flags->info.v4.rnd_count;
 			}
 
 			/* part 2: 5 bits of innermost IP-ID with non-random IP-ID */
@@ -3359,8 +4467,8 @@ static int rohc_comp_rfc3095_build_uo1id_pkt(struct rohc_comp_ctxt *const contex
 		rohc_comp_warn(context, "ROHC packet is too small for SN/CRC byte");
 		goto error;
 	}
-	crc = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
-	                     context->compressor->crc_table_3);
+	crc = compute_uo_crc(context, uncomp_pkt, ROHC_CRC_TYPE_3, CRC_INIT_3,
+	                     rohc_crc_table_3);
 	s_byte = crc & 0x07;
 	switch(extension)
 	{
@@ -3608,25 +4716,25 @@ static int code_UO2_packet(struct rohc_comp_ctxt *const context,
 	 *  - part 2 will be placed at 'first_position'
 	 *  - parts 4/5 will start at 'counter'
 	 */
-	ret = code_cid_values(context->compressor->medium.cid_type, context->cid,
+	ret = code_cid_values(&(context->cid_hdr),
 	                      rohc_pkt, rohc_pkt_max_len, &first_position);
 	if(ret < 1)
 	{
 		rohc_comp_warn(context, "failed to encode %s CID %zu: maybe the "
 		               "%zu-byte ROHC buffer is too small",
-		               context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+		               c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 		               "small" : "large", context->cid, rohc_pkt_max_len);
 		goto error;
 	}
 	counter = ret;
 	rohc_comp_debug(context, "%s CID %zu encoded on %zu byte(s)",
-	                context->compressor->medium.cid_type == ROHC_SMALL_CID ?
+	                c_cid_type(context->compressor) == ROHC_SMALL_CID ?
 	                "small" : "large", context->cid, counter - 1);
 
 	/* build the UO head if necessary */
-	if(rfc3095_ctxt->code_UO_packet_head != NULL && uncomp_pkt->transport->data != NULL)
+	if(rfc3095_ctxt->ops->code_UO_packet_head != NULL && uncomp_pkt->transport->data != NULL)
 	{
-		counter = rfc3095_ctxt->code_UO_packet_head(context, uncomp_pkt->transport->data,
+		counter = rfc3095_ctxt->ops->code_UO_packet_head(context, uncomp_pkt->transport->data,
 		                                            rohc_pkt, counter, &first_position);
 	}
 
@@ -3646,18 +4754,25 @@ static int code_UO2_packet(struct rohc_comp_ctxt *const context,
 	 *
 	 * TODO: The CRC should be computed only on the CRC-DYNAMIC fields
 	 * if the CRC-STATIC fields did not change */
-	t_byte = compute_uo_crc(rfc3095_ctxt, uncomp_pkt, ROHC_CRC_TYPE_7, CRC_INIT_7,
-	                        context->compressor->crc_table_7);
+	t_byte = compute_uo_crc(context, uncomp_pkt, ROHC_CRC_TYPE_7, CRC_INIT_7,
+	                        rohc_crc_table_7);
 	t_byte_position = counter;
 	counter++;
 
 	/* part 6: decide which extension to use */
-	extension = rfc3095_ctxt->decide_extension(context);
+	extension = rohc_comp_rfc3095_call(rfc3095_ctxt, decide_extension,
+	                                   c_rtp_decide_extension, context);
 	if(extension == ROHC_EXT_UNKNOWN)
 	{
 		rohc_comp_warn(context, "failed to determine the extension to code");
 		goto error;
 	}
+	if(context->mode == ROHC_R_MODE && rfc3095_ctxt->r_trans_pending)
+	{
+		/* RFC 3095, §5.6.3: the Mode bits of extension 3 carry the R-mode to
+		 * the decompressor until the transition is acknowledged */
+		extension = ROHC_EXT_3;
+	}
 	rohc_comp_debug(context, "extension '%s' chosen",
 	                rohc_get_ext_descr(extension));
 
@@ -3919,8 +5034,8 @@ static int code_UOR2_RTP_bytes(const struct rohc_comp_ctxt *const context,
 		/* 2 IP headers: none of them must be IPv4 with non-random IP-ID */
 		assert(rfc3095_ctxt->outer_ip_flags.version != IPV4 ||
 		       rfc3095_ctxt->outer_ip_flags.info.v4.rnd == 1);
-		assert(rfc3095_ctxt->inner_ip_flags.version != IPV4 ||
-		       rfc3095_ctxt->inner_ip_flags.info.v4.rnd == 1);
+		assert(rfc3095_ctxt->inner_ip_flags->version != IPV4 ||
+		       rfc3095_ctxt->inner_ip_flags->info.v4.rnd == 1);
 	}
 
 	/* which extension to code? */
@@ -4168,10 +5283,10 @@ static int code_UOR2_TS_bytes(const struct rohc_comp_ctxt *const context,
 	{
 		/* 2 IP headers: at least one of them must be IPv4 with non-random
 		 * IP-ID */
-		if(rfc3095_ctxt->inner_ip_flags.version == IPV4)
+		if(rfc3095_ctxt->inner_ip_flags->version == IPV4)
 		{
 			/* inner IP header is IPv4 */
-			if(rfc3095_ctxt->inner_ip_flags.info.v4.rnd == 0)
+			if(rfc3095_ctxt->inner_ip_flags->info.v4.rnd == 0)
 			{
 				/* inner IPv4 header got a non-random IP-ID, that's fine */
 			}
@@ -4541,7 +5656,7 @@ static int code_UOR2_ID_bytes(const struct rohc_comp_ctxt *const context,
 			}
 			else /* ROHC_IP_HDR_SECOND */
 			{
-				innermost_ip_id_rnd_count = rfc3095_ctxt->inner_ip_flags.info.v4.rnd_count;
+				innermost_ip_id_rnd_count = rfc3095_ctxt->inner_ip_flags->info.v4.rnd_count;
 			}
 
 			/* part 2: 5 bits of innermost IP-ID with non-random IP-ID */
@@ -4953,8 +6068,8 @@ static int code_EXT2_packet(const struct rohc_comp_ctxt *const context,
 			assert(rfc3095_ctxt->outer_ip_flags.version == IPV4 &&
 			       rfc3095_ctxt->outer_ip_flags.info.v4.rnd == 0 &&
 			       rfc3095_ctxt->ip_hdr_nr > 1 &&
-			       rfc3095_ctxt->inner_ip_flags.version == IPV4 &&
-			       rfc3095_ctxt->inner_ip_flags.info.v4.rnd == 0);
+			       rfc3095_ctxt->inner_ip_flags->version == IPV4 &&
+			       rfc3095_ctxt->inner_ip_flags->info.v4.rnd == 0);
 
 			f_byte |= (rfc3095_ctxt->outer_ip_flags.info.v4.id_delta >> 8) & 0x07;
 			rohc_comp_debug(context, "3 bits of outer IP-ID = 0x%x",
@@ -4962,7 +6077,7 @@ static int code_EXT2_packet(const struct rohc_comp_ctxt *const context,
 			s_byte = rfc3095_ctxt->outer_ip_flags.info.v4.id_delta & 0xff;
 			rohc_comp_debug(context, "8 bits of outer IP-ID = 0x%x",
 			                s_byte & 0xff);
-			t_byte = rfc3095_ctxt->inner_ip_flags.info.v4.id_delta & 0xff;
+			t_byte = rfc3095_ctxt->inner_ip_flags->info.v4.id_delta & 0xff;
 			rohc_comp_debug(context, "8 bits of inner IP-ID = 0x%x",
 			                t_byte & 0xff);
 			break;
@@ -5199,7 +6314,7 @@ static int code_EXT3_rtp_packet(struct rohc_comp_ctxt *const context,
 	else /* double IP headers */
 	{
 		inner_ip = &uncomp_pkt->inner_ip;
-		inner_ip_flags = &rfc3095_ctxt->inner_ip_flags;
+		inner_ip_flags = rfc3095_ctxt->inner_ip_flags;
 		inner_ip_changed_fields = rfc3095_ctxt->tmp.changed_fields2;
 		outer_ip = &uncomp_pkt->outer_ip;
 		outer_ip_flags = &rfc3095_ctxt->outer_ip_flags;
@@ -5262,7 +6377,8 @@ static int code_EXT3_rtp_packet(struct rohc_comp_ctxt *const context,
 	 *    base header (UO-1-ID only),
 	 *  - RTP eXtension bit changed in this packet,
 	 *  - RTP eXtension bit changed in the last few packets,
-	 *  - RTP TS and TS_STRIDE must be initialized.
+	 *  - RTP TS and TS_STRIDE must be initialized,
+	 *  - the Mode bits shall carry the R-mode to the decompressor.
 	 */
 	rtp = (rtp_context->tmp.rtp_pt_changed ||
 	       rtp_context->rtp_pt_change_count < MAX_IR_COUNT ||
@@ -5271,7 +6387,8 @@ static int code_EXT3_rtp_packet(struct rohc_comp_ctxt *const context,
 	       (packet_type == ROHC_PACKET_UO_1_ID && rtp_context->tmp.is_marker_bit_set) ||
 	       rtp_context->tmp.extension_bit_changed ||
 	       rtp_context->rtp_extension_change_count < MAX_IR_COUNT ||
-	       (rtp_context->ts_sc.state == INIT_STRIDE));
+	       (rtp_context->ts_sc.state == INIT_STRIDE) ||
+	       (context->mode == ROHC_R_MODE && rfc3095_ctxt->r_trans_pending));
 
 	/* ip2 bit (force ip2=1 if I2=1, otherwise I2 is not sent) */
 	if(nr_of_ip_hdr == 1)
@@ -5386,7 +6503,7 @@ static int code_EXT3_rtp_packet(struct rohc_comp_ctxt *const context,
 		}
 		else
 		{
-			id_encoded = rohc_hton16(rfc3095_ctxt->inner_ip_flags.info.v4.id_delta);
+			id_encoded = rohc_hton16(rfc3095_ctxt->inner_ip_flags->info.v4.id_delta);
 		}
 		memcpy(&dest[counter], &id_encoded, 2);
 		rohc_comp_debug(context, "IP ID of IP header #%u = 0x%02x 0x%02x",
@@ -5511,7 +6628,7 @@ static int code_EXT3_nortp_packet(struct rohc_comp_ctxt *const context,
 	else /* double IP headers */
 	{
 		inner_ip = &uncomp_pkt->inner_ip;
-		inner_ip_flags = &rfc3095_ctxt->inner_ip_flags;
+		inner_ip_flags = rfc3095_ctxt->inner_ip_flags;
 		inner_ip_changed_fields = rfc3095_ctxt->tmp.changed_fields2;
 		outer_ip = &uncomp_pkt->outer_ip;
 		outer_ip_flags = &rfc3095_ctxt->outer_ip_flags;
@@ -5613,7 +6730,7 @@ static int code_EXT3_nortp_packet(struct rohc_comp_ctxt *const context,
 		}
 		else
 		{
-			id_encoded = rohc_hton16(rfc3095_ctxt->inner_ip_flags.info.v4.id_delta);
+			id_encoded = rohc_hton16(rfc3095_ctxt->inner_ip_flags->info.v4.id_delta);
 		}
 		memcpy(&dest[counter], &id_encoded, 2);
 		rohc_comp_debug(context, "IP ID of IP header #%u = 0x%02x 0x%02x",
@@ -5665,7 +6782,7 @@ static int code_EXT3_nortp_packet(struct rohc_comp_ctxt *const context,
                          2 = Bidirectional Optimistic,
                          3 = Bidirectional Reliable.
 
- Parts 3 & 5 are not supported yet.
+ Part 3 is not supported yet.
 
 \endverbatim
  *
@@ -5688,6 +6805,7 @@ static int rtp_header_flags_and_fields(const struct rohc_comp_ctxt *const contex
 	struct udphdr *udp;
 	struct rtphdr *rtp;
 	int tss;
+	int tis;
 	int rpt;
 	uint8_t byte;
 
@@ -5704,12 +6822,14 @@ static int rtp_header_flags_and_fields(const struct rohc_comp_ctxt *const contex
 	       rtp_context->tmp.padding_bit_changed ||
 	       rtp_context->rtp_padding_change_count < MAX_IR_COUNT);
 	tss = rtp_context->ts_sc.state == INIT_STRIDE;
+	tis = tss && rtp_context->ts_sc.is_timer_enabled;
 	byte = 0;
 	byte |= (context->mode & 0x03) << 6;
 	byte |= (rpt & 0x01) << 5;
 	byte |= (rtp->m & 0x01) << 4;
 	byte |= (rtp->extension & 0x01) << 3;
 	byte |= (tss & 0x01) << 1;
+	byte |= tis & 0x01;
 	rohc_comp_debug(context, "RTP flags = 0x%x", byte);
 	dest[counter] = byte;
 	counter++;
@@ -5776,7 +6896,25 @@ static int rtp_header_flags_and_fields(const struct rohc_comp_ctxt *const contex
 		}
 	}
 
-	/* part 5: not supported yet */
+	/* part 5 */
+	if(tis)
+	{
+		const uint32_t time_stride = get_time_stride(&rtp_context->ts_sc);
+		size_t sdvl_size;
+
+		/* SDVL-encode the TIME_STRIDE value, 0 if timer-based compression
+		 * shall not be used with the new TS_STRIDE */
+		if(!sdvl_encode_full(dest + counter, 4U, &sdvl_size, time_stride))
+		{
+			rohc_comp_warn(context, "failed to SDVL-encode TIME_STRIDE %u",
+			               time_stride);
+			goto error;
+		}
+		counter += sdvl_size;
+
+		rohc_comp_debug(context, "TIME_STRIDE %u ms is SDVL-encoded on %zu "
+		                "byte(s)", time_stride, sdvl_size);
+	}
 
 	return counter;
 
@@ -5862,13 +7000,13 @@ static int header_flags(const struct rohc_comp_ctxt *const context,
 		int df;
 
 		df = ipv4_get_df(ip);
-		header_info->info.v4.df_count++;
+		C_COUNT_INC(header_info->info.v4.df_count);
 		flags |= df << 5;
 
-		header_info->info.v4.nbo_count++;
+		C_COUNT_INC(header_info->info.v4.nbo_count);
 		flags |= header_info->info.v4.nbo << 2;
 
-		header_info->info.v4.rnd_count++;
+		C_COUNT_INC(header_info->info.v4.rnd_count);
 		flags |= header_info->info.v4.rnd << 1;
 	}
 
@@ -5951,7 +7089,7 @@ static int header_fields(const struct rohc_comp_ctxt *const context,
 		const unsigned int tos = ip_get_tos(ip);
 		rohc_comp_debug(context, "IP TOS/TC of IP header #%u = 0x%02x",
 		                ip_hdr_pos, tos);
-		header_info->tos_count++;
+		C_COUNT_INC(header_info->tos_count);
 		dest[counter] = tos;
 		counter++;
 	}
@@ -5963,7 +7101,7 @@ static int header_fields(const struct rohc_comp_ctxt *const context,
 		const unsigned int ttl = ip_get_ttl(ip);
 		rohc_comp_debug(context, "IP TTL/HL of IP header #%u = 0x%02x",
 		                ip_hdr_pos, ttl);
-		header_info->ttl_count++;
+		C_COUNT_INC(header_info->ttl_count);
 		dest[counter] = ttl;
 		counter++;
 	}
@@ -5975,7 +7113,7 @@ static int header_fields(const struct rohc_comp_ctxt *const context,
 		const uint8_t protocol = ip_get_protocol(ip);
 		rohc_comp_debug(context, "IP Protocol/Next Header of IP header #%u "
 		                "= 0x%02x", ip_hdr_pos, protocol);
-		header_info->protocol_count++;
+		C_COUNT_INC(header_info->protocol_count);
 		dest[counter] = protocol;
 		counter++;
 	}
@@ -6000,24 +7138,34 @@ static int header_fields(const struct rohc_comp_ctxt *const context,
 /**
  * @brief Compute the CRC for a UO* packet
  *
- * @param rfc3095_ctxt   The generic compression context
+ * The CRC is not computed if \ref ROHC_COMP_FEATURE_ESTIMATE is enabled.
+ *
+ * @param context     The compression context
  * @param uncomp_pkt  The uncompressed packet to encode
  * @param crc_type    The type of CRC to compute
  * @param crc_init    The initial value of the CRC
  * @param crc_table   The table of pre-computed CRC
  * @return            The computed CRC
  */
-static uint8_t compute_uo_crc(const struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt,
+static uint8_t compute_uo_crc(const struct rohc_comp_ctxt *const context,
                               const struct net_pkt *const uncomp_pkt,
                               const rohc_crc_type_t crc_type,
                               const uint8_t crc_init,
                               const uint8_t *const crc_table)
 {
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt =
+		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 	const uint8_t *outer_ip_hdr;
 	const uint8_t *inner_ip_hdr;
 	const uint8_t *next_header;
 	uint8_t crc = crc_init;
 
+	/* the packets are only sized in estimate mode */
+	if((c_features(context->compressor) & ROHC_COMP_FEATURE_ESTIMATE) != 0)
+	{
+		return 0;
+	}
+
 	outer_ip_hdr = ip_get_raw_data(&uncomp_pkt->outer_ip);
 	if(uncomp_pkt->ip_hdr_nr > 1)
 	{
@@ -6030,12 +7178,16 @@ static uint8_t compute_uo_crc(const struct rohc_comp_rfc3095_ctxt *rfc3095_ctxt,
 	next_header = uncomp_pkt->transport->data;
 
 	/* compute CRC on CRC-STATIC fields */
-	crc = rfc3095_ctxt->compute_crc_static(outer_ip_hdr, inner_ip_hdr, next_header,
-	                                       crc_type, crc, crc_table);
+	crc = rohc_comp_rfc3095_call(rfc3095_ctxt, compute_crc_static,
+	                             rtp_compute_crc_static, outer_ip_hdr,
+	                             inner_ip_hdr, next_header, crc_type, crc,
+	                             crc_table, &rfc3095_ctxt->crc_static_cache);
 
 	/* compute CRC on CRC-DYNAMIC fields */
-	crc = rfc3095_ctxt->compute_crc_dynamic(outer_ip_hdr, inner_ip_hdr, next_header,
-	                                        crc_type, crc, crc_table);
+	crc = rohc_comp_rfc3095_call(rfc3095_ctxt, compute_crc_dynamic,
+	                             rtp_compute_crc_dynamic, outer_ip_hdr,
+	                             inner_ip_hdr, next_header, crc_type, crc,
+	                             crc_table, &rfc3095_ctxt->crc_static_cache);
 
 	return crc;
 }
@@ -6059,7 +7211,7 @@ static void update_context(struct rohc_comp_ctxt *const context,
 
 	if(uncomp_pkt->ip_hdr_nr > 1)
 	{
-		update_context_ip_hdr(&rfc3095_ctxt->inner_ip_flags,
+		update_context_ip_hdr(rfc3095_ctxt->inner_ip_flags,
 		                      &uncomp_pkt->inner_ip);
 	}
 }
@@ -6118,7 +7270,7 @@ static int changed_static_both_hdr(struct rohc_comp_ctxt *const context,
 	{
 		nb_fields += changed_static_one_hdr(context,
 		                                    rfc3095_ctxt->tmp.changed_fields2,
-		                                    &rfc3095_ctxt->inner_ip_flags);
+		                                    rfc3095_ctxt->inner_ip_flags);
 	}
 
 	return nb_fields;
@@ -6162,12 +7314,17 @@ static int changed_static_one_hdr(struct rohc_comp_ctxt *const context,
 	if(is_field_changed(changed_fields, MOD_PROTOCOL) ||
 	   header_info->protocol_count < MAX_FO_COUNT)
 	{
-		rohc_comp_debug(context, "protocol_count %zu", header_info->protocol_count);
+		rohc_comp_debug(context, "protocol_count %u", header_info->protocol_count);
 
 		if(is_field_changed(changed_fields, MOD_PROTOCOL))
 		{
+			struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+
 			header_info->protocol_count = 0;
 			context->fo_count = 0;
+
+			/* the protocol is part of the static chain */
+			rfc3095_ctxt->static_chain_len = 0;
 		}
 		nb_fields += 1;
 	}
@@ -6203,7 +7360,7 @@ static int changed_dynamic_both_hdr(struct rohc_comp_ctxt *const context,
 		rohc_comp_debug(context, "check for changed fields in the inner IP header");
 		nb_fields += changed_dynamic_one_hdr(context,
 		                                     rfc3095_ctxt->tmp.changed_fields2,
-		                                     &rfc3095_ctxt->inner_ip_flags,
+		                                     rfc3095_ctxt->inner_ip_flags,
 		                                     &uncomp_pkt->inner_ip);
 	}
 
@@ -6521,7 +7678,7 @@ static void detect_ip_id_behaviours(struct rohc_comp_ctxt *const context,
 	if(uncomp_pkt->ip_hdr_nr > 1 &&
 	   ip_get_version(&uncomp_pkt->inner_ip) == IPV4)
 	{
-		detect_ip_id_behaviour(context, &rfc3095_ctxt->inner_ip_flags,
+		detect_ip_id_behaviour(context, rfc3095_ctxt->inner_ip_flags,
 		                       &uncomp_pkt->inner_ip);
 	}
 }
@@ -6536,6 +7693,9 @@ static void detect_ip_id_behaviours(struct rohc_comp_ctxt *const context,
  *  - increase in Little Endian,
  *  - randomly.
  *
+ * Once the same behaviour was detected for \ref ROHC_IP_ID_BEHAVIOR_CONFIDENCE
+ * consecutive packets, only that behaviour is checked until it fails.
+ *
  * @param context      The compression context
  * @param header_info  The header info stored in the profile
  * @param ip           One IPv4 header
@@ -6563,6 +7723,9 @@ static void detect_ip_id_behaviour(const struct rohc_comp_ctxt *const context,
 		/* we have seen at least one header before this one, so we can (try to)
 		 * detect IP-ID behaviour */
 
+		const int prev_rnd = header_info->info.v4.rnd;
+		const int prev_nbo = header_info->info.v4.nbo;
+		const int prev_sid = header_info->info.v4.sid;
 		uint16_t old_id; /* the IP-ID of the previous IPv4 header */
 		uint16_t new_id; /* the IP-ID of the IPv4 header being compressed */
 
@@ -6572,7 +7735,13 @@ static void detect_ip_id_behaviour(const struct rohc_comp_ctxt *const context,
 		rohc_comp_debug(context, "1) old_id = 0x%04x new_id = 0x%04x",
 		                old_id, new_id);
 
-		if(new_id == old_id)
+		if(header_info->info.v4.behaviour_confidence >= ROHC_IP_ID_BEHAVIOR_CONFIDENCE &&
+		   is_ip_id_behaviour_confirmed(&header_info->info.v4, old_id, new_id))
+		{
+			/* the trusted behaviour is confirmed, skip the detection */
+			rohc_comp_debug(context, "IP-ID behaviour is unchanged");
+		}
+		else if(new_id == old_id)
 		{
 			/* previous and current IP-ID values are equal: IP-ID is constant */
 			rohc_comp_debug(context, "IP-ID is constant (SID detected)");
@@ -6613,6 +7782,19 @@ static void detect_ip_id_behaviour(const struct rohc_comp_ctxt *const context,
 				header_info->info.v4.sid = 0;
 			}
 		}
+
+		/* trust the behaviour once it was detected for several packets */
+		if(header_info->info.v4.rnd != prev_rnd ||
+		   header_info->info.v4.nbo != prev_nbo ||
+		   header_info->info.v4.sid != prev_sid)
+		{
+			header_info->info.v4.behaviour_confidence = 0;
+		}
+		else if(header_info->info.v4.behaviour_confidence <
+		        ROHC_IP_ID_BEHAVIOR_CONFIDENCE)
+		{
+			header_info->info.v4.behaviour_confidence++;
+		}
 	}
 
 	rohc_comp_debug(context, "NBO = %d, RND = %d, SID = %d",
@@ -6624,6 +7806,48 @@ error:
 }
 
 
+/**
+ * @brief Whether the IP-ID field still behaves as recorded in context
+ *
+ * Only the recorded behaviour is checked, so the function is cheaper than
+ * the full detection. The random behaviour cannot be confirmed without the
+ * full detection.
+ *
+ * @param v4_info  The IPv4 header info stored in the profile
+ * @param old_id   The IP-ID of the previous IPv4 header (in HBO)
+ * @param new_id   The IP-ID of the IPv4 header being compressed (in HBO)
+ * @return         true if the IP-ID behaves as recorded in context,
+ *                 false if the behaviour shall be detected again
+ */
+static bool is_ip_id_behaviour_confirmed(const struct ipv4_header_info *const v4_info,
+                                         const uint16_t old_id,
+                                         const uint16_t new_id)
+{
+	bool is_confirmed;
+
+	if(v4_info->rnd)
+	{
+		is_confirmed = false;
+	}
+	else if(v4_info->sid)
+	{
+		is_confirmed = (new_id == old_id);
+	}
+	else if(v4_info->nbo)
+	{
+		is_confirmed = is_ip_id_increasing(old_id, new_id);
+	}
+	else
+	{
+		is_confirmed = (new_id != old_id &&
+		                !is_ip_id_increasing(old_id, new_id) &&
+		                is_ip_id_increasing(swab16(old_id), swab16(new_id)));
+	}
+
+	return is_confirmed;
+}
+
+
 /*
  * Definitions of main private functions
  */
@@ -6678,8 +7902,8 @@ static bool encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 		                (rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 > 4 ? "" : "not"),
 		                rfc3095_ctxt->tmp.nr_sn_bits_more_than_4);
 
-		/* add the new SN to the W-LSB encoding object */
-		c_add_wlsb(rfc3095_ctxt->sn_window, rfc3095_ctxt->sn, rfc3095_ctxt->sn);
+		/* the new SN is added to the W-LSB encoding object once the packet
+		 * is built, see \ref rohc_comp_rfc3095_add_wlsb */
 	}
 
 	/* update info related to the IP-ID of the outer header
@@ -6716,10 +7940,6 @@ static bool encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 		}
 		rohc_comp_debug(context, "%zd bits are required to encode new outer "
 		                "IP-ID delta", rfc3095_ctxt->tmp.nr_ip_id_bits);
-
-		/* add the new IP-ID / SN delta to the W-LSB encoding object */
-		c_add_wlsb(rfc3095_ctxt->outer_ip_flags.info.v4.ip_id_window, rfc3095_ctxt->sn,
-		           rfc3095_ctxt->outer_ip_flags.info.v4.id_delta);
 	}
 	else /* IPV6 */
 	{
@@ -6733,20 +7953,20 @@ static bool encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 	   ip_get_version(&uncomp_pkt->inner_ip) == IPV4)
 	{
 		/* compute the new IP-ID / SN delta */
-		rfc3095_ctxt->inner_ip_flags.info.v4.id_delta =
+		rfc3095_ctxt->inner_ip_flags->info.v4.id_delta =
 			rohc_ntoh16(ipv4_get_id_nbo(&uncomp_pkt->inner_ip,
-			                            rfc3095_ctxt->inner_ip_flags.info.v4.nbo)) -
+			                            rfc3095_ctxt->inner_ip_flags->info.v4.nbo)) -
 			rfc3095_ctxt->sn;
 		rohc_comp_debug(context, "new inner IP-ID delta = 0x%x / %u (NBO = %d, "
 		                "RND = %d, SID = %d)",
-		                rfc3095_ctxt->inner_ip_flags.info.v4.id_delta,
-		                rfc3095_ctxt->inner_ip_flags.info.v4.id_delta,
-		                rfc3095_ctxt->inner_ip_flags.info.v4.nbo,
-		                rfc3095_ctxt->inner_ip_flags.info.v4.rnd,
-		                rfc3095_ctxt->inner_ip_flags.info.v4.sid);
+		                rfc3095_ctxt->inner_ip_flags->info.v4.id_delta,
+		                rfc3095_ctxt->inner_ip_flags->info.v4.id_delta,
+		                rfc3095_ctxt->inner_ip_flags->info.v4.nbo,
+		                rfc3095_ctxt->inner_ip_flags->info.v4.rnd,
+		                rfc3095_ctxt->inner_ip_flags->info.v4.sid);
 
 		/* how many bits are required to encode the new IP-ID / SN delta ? */
-		if(rfc3095_ctxt->inner_ip_flags.info.v4.sid)
+		if(rfc3095_ctxt->inner_ip_flags->info.v4.sid)
 		{
 			/* IP-ID is constant, no IP-ID bit to transmit */
 			rfc3095_ctxt->tmp.nr_ip_id_bits2 = 0;
@@ -6757,15 +7977,11 @@ static bool encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 		{
 			/* send only required bits in FO or SO states */
 			rfc3095_ctxt->tmp.nr_ip_id_bits2 =
-				wlsb_get_k_16bits(rfc3095_ctxt->inner_ip_flags.info.v4.ip_id_window,
-				                  rfc3095_ctxt->inner_ip_flags.info.v4.id_delta);
+				wlsb_get_k_16bits(rfc3095_ctxt->inner_ip_flags->info.v4.ip_id_window,
+				                  rfc3095_ctxt->inner_ip_flags->info.v4.id_delta);
 		}
 		rohc_comp_debug(context, "%zd bits are required to encode new inner "
 		                "IP-ID delta", rfc3095_ctxt->tmp.nr_ip_id_bits2);
-
-		/* add the new IP-ID / SN delta to the W-LSB encoding object */
-		c_add_wlsb(rfc3095_ctxt->inner_ip_flags.info.v4.ip_id_window, rfc3095_ctxt->sn,
-		           rfc3095_ctxt->inner_ip_flags.info.v4.id_delta);
 	}
 	else if(uncomp_pkt->ip_hdr_nr > 1) /* IPV6 */
 	{
@@ -6773,8 +7989,9 @@ static bool encode_uncomp_fields(struct rohc_comp_ctxt *const context,
 	}
 
 	/* update info related to transport header */
-	if(rfc3095_ctxt->encode_uncomp_fields != NULL &&
-	   !rfc3095_ctxt->encode_uncomp_fields(context, uncomp_pkt))
+	if(rfc3095_ctxt->ops->encode_uncomp_fields != NULL &&
+	   !rohc_comp_rfc3095_call(rfc3095_ctxt, encode_uncomp_fields,
+	                           rtp_encode_uncomp_fields, context, uncomp_pkt))
 	{
 		rohc_comp_warn(context, "failed to encode uncompressed next header "
 		               "fields");
@@ -6788,11 +8005,53 @@ error:
 }
 
 
+/**
+ * @brief Add the SN and IP-ID values of the new packet to the W-LSB windows
+ *
+ * The values of one R-0 packet are not added since the decompressor does
+ * not update its context with them (RFC 3095, §5.5.1.1).
+ *
+ * @param context      The compression context
+ * @param uncomp_pkt   The uncompressed packet that was compressed
+ */
+static void rohc_comp_rfc3095_add_wlsb(struct rohc_comp_ctxt *const context,
+                                       const struct net_pkt *const uncomp_pkt)
+{
+	struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+
+	if(rfc3095_ctxt->tmp.packet_type == ROHC_PACKET_R_0)
+	{
+		rohc_comp_debug(context, "R-0 packet: do not use SN %u as reference",
+		                rfc3095_ctxt->sn);
+		return;
+	}
+
+	/* add the new SN to the W-LSB encoding object */
+	c_add_wlsb(rfc3095_ctxt->sn_window, rfc3095_ctxt->sn, rfc3095_ctxt->sn);
+
+	/* add the new IP-ID / SN deltas to the W-LSB encoding objects */
+	if(ip_get_version(&uncomp_pkt->outer_ip) == IPV4)
+	{
+		c_add_wlsb(rfc3095_ctxt->outer_ip_flags.info.v4.ip_id_window, rfc3095_ctxt->sn,
+		           rfc3095_ctxt->outer_ip_flags.info.v4.id_delta);
+	}
+	if(uncomp_pkt->ip_hdr_nr > 1 &&
+	   ip_get_version(&uncomp_pkt->inner_ip) == IPV4)
+	{
+		c_add_wlsb(rfc3095_ctxt->inner_ip_flags->info.v4.ip_id_window, rfc3095_ctxt->sn,
+		           rfc3095_ctxt->inner_ip_flags->info.v4.id_delta);
+	}
+}
+
+
 /**
  * @brief Decide what extension shall be used in the UO-1-ID/UOR-2 packet.
  *
  * Extensions 0, 1 & 2 are IPv4 only because of the IP-ID.
  *
+ * The extension is looked up in the pre-computed table of the packet type,
+ * see \ref rohc_comp_ext_table.
+ *
  * @param context The compression context
  * @return        The extension code among ROHC_EXT_NONE, ROHC_EXT_0,
  *                ROHC_EXT_1 and ROHC_EXT_3 if successful,
@@ -6801,8 +8060,13 @@ error:
 rohc_ext_t decide_extension(const struct rohc_comp_ctxt *const context)
 {
 	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
+	const struct rohc_comp_ext_table *table;
 	size_t nr_innermost_ip_id_bits;
 	size_t nr_outermost_ip_id_bits;
+	size_t nr_ts_bits = 0;
+	bool is_ts_deducible = false;
+	bool is_marker_bit_set = false;
+	unsigned int rows;
 	rohc_ext_t ext;
 
 	/* force extension type 3 if at least one static or dynamic field changed */
@@ -6812,340 +8076,71 @@ rohc_ext_t decide_extension(const struct rohc_comp_ctxt *const context)
 		                "dynamic field changed");
 		ext = ROHC_EXT_3;
 	}
+	else if(context->compressor->effort == ROHC_COMP_EFFORT_FAST &&
+	        context->profile->id != ROHC_PROFILE_RTP)
+	{
+		/* without TS, extension 3 fits all the changes: do not search for a
+		 * smaller one (the RTP TS may be too large for extension 3 when it is
+		 * deducible from the SN, so RTP keeps the search) */
+		rohc_comp_debug(context, "force EXT-3 because of the fast effort level");
+		ext = ROHC_EXT_3;
+	}
 	else
 	{
-		/* determine the number of IP-ID bits and the IP-ID offset of the
-		 * innermost IPv4 header with non-random IP-ID */
-		rohc_get_ipid_bits(context, &nr_innermost_ip_id_bits,
-		                   &nr_outermost_ip_id_bits);
-
 		switch(rfc3095_ctxt->tmp.packet_type)
 		{
 			case ROHC_PACKET_UOR_2:
-				ext = decide_extension_uor2(context, nr_innermost_ip_id_bits,
-				                            nr_outermost_ip_id_bits);
+				table = &rohc_comp_ext_uor2;
 				break;
 			case ROHC_PACKET_UOR_2_RTP:
-				ext = decide_extension_uor2rtp(context, nr_innermost_ip_id_bits,
-				                               nr_outermost_ip_id_bits);
+				table = &rohc_comp_ext_uor2rtp;
 				break;
 			case ROHC_PACKET_UOR_2_TS:
-				ext = decide_extension_uor2ts(context, nr_innermost_ip_id_bits,
-				                              nr_outermost_ip_id_bits);
+				table = &rohc_comp_ext_uor2ts;
 				break;
 			case ROHC_PACKET_UOR_2_ID:
-				ext = decide_extension_uor2id(context, nr_innermost_ip_id_bits,
-				                              nr_outermost_ip_id_bits);
+				table = &rohc_comp_ext_uor2id;
 				break;
 			case ROHC_PACKET_UO_1_ID:
-				ext = decide_extension_uo1id(context, nr_innermost_ip_id_bits,
-				                             nr_outermost_ip_id_bits);
+				table = &rohc_comp_ext_uo1id;
 				break;
 			default:
 				rohc_assert(context->compressor, ROHC_TRACE_COMP, context->profile->id,
 				            false, error, "bad packet type (%d)",
 				            rfc3095_ctxt->tmp.packet_type);
 		}
-	}
-
-	return ext;
-
-error:
-	return ROHC_EXT_UNKNOWN;
-}
-
-
-/**
- * @brief Decide what extension shall be used in the UOR-2 packet (non-RTP).
- *
- * Extensions 0, 1 & 2 are IPv4 only because of the IP-ID.
- *
- * @param context                  The compression context
- * @param nr_innermost_ip_id_bits  The number of IP-ID bits of the innermost
- *                                 IPv4 header
- * @param nr_outermost_ip_id_bits  The number of IP-ID bits of the outermost
- *                                 IPv4 header
- * @return                         The extension code among ROHC_EXT_NONE,
- *                                 ROHC_EXT_0, ROHC_EXT_1 and ROHC_EXT_3
- */
-static rohc_ext_t decide_extension_uor2(const struct rohc_comp_ctxt *const context,
-                                        const size_t nr_innermost_ip_id_bits,
-                                        const size_t nr_outermost_ip_id_bits)
-{
-	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
-	rohc_ext_t ext;
-
-	if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 5 &&
-	   nr_innermost_ip_id_bits == 0 &&
-	   nr_outermost_ip_id_bits == 0)
-	{
-		ext = ROHC_EXT_NONE;
-	}
-	else if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 8 &&
-	        nr_innermost_ip_id_bits != 0 && nr_innermost_ip_id_bits <= 3 &&
-	        nr_outermost_ip_id_bits == 0)
-	{
-		ext = ROHC_EXT_0;
-	}
-	else if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 8 &&
-	        nr_innermost_ip_id_bits != 0 && nr_innermost_ip_id_bits <= 11 &&
-	        nr_outermost_ip_id_bits == 0)
-	{
-		ext = ROHC_EXT_1;
-	}
-	else if(rfc3095_ctxt->ip_hdr_nr > 1 &&
-	        rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 8 &&
-	        nr_innermost_ip_id_bits != 0 && nr_innermost_ip_id_bits <= 8 &&
-	        nr_outermost_ip_id_bits <= 11)
-	{
-		ext = ROHC_EXT_2;
-	}
-	else
-	{
-		ext = ROHC_EXT_3;
-	}
-
-	return ext;
-}
-
-
-/**
- * @brief Decide what extension shall be used in the UOR-2 packet (RTP).
- *
- * Extensions 0, 1 & 2 are IPv4 only because of the IP-ID.
- *
- * @param context                  The compression context
- * @param nr_innermost_ip_id_bits  The number of IP-ID bits of the innermost
- *                                 IPv4 header
- * @param nr_outermost_ip_id_bits  The number of IP-ID bits of the outermost
- *                                 IPv4 header
- * @return                         The extension code among ROHC_EXT_NONE,
- *                                 ROHC_EXT_0, ROHC_EXT_1 and ROHC_EXT_3
- */
-static rohc_ext_t decide_extension_uor2rtp(const struct rohc_comp_ctxt *const context,
-                                           const size_t nr_innermost_ip_id_bits,
-                                           const size_t nr_outermost_ip_id_bits)
-{
-	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
-	const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
-	const size_t nr_ts_bits = rtp_context->tmp.nr_ts_bits_more_than_2;
-	rohc_ext_t ext;
-
-	if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 6 &&
-	   nr_ts_bits <= 6 &&
-	   nr_innermost_ip_id_bits == 0 &&
-	   nr_outermost_ip_id_bits == 0)
-	{
-		ext = ROHC_EXT_NONE;
-	}
-	else if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 9 &&
-	        nr_ts_bits <= 9 &&
-	        nr_innermost_ip_id_bits == 0 &&
-	        nr_outermost_ip_id_bits == 0)
-	{
-		ext = ROHC_EXT_0;
-	}
-	else if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 9 &&
-	        nr_ts_bits <= 17 &&
-	        nr_innermost_ip_id_bits == 0 &&
-	        nr_outermost_ip_id_bits == 0)
-	{
-		ext = ROHC_EXT_1;
-	}
-	else if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 9 &&
-	        nr_ts_bits <= 25 &&
-	        nr_innermost_ip_id_bits == 0 &&
-	        nr_outermost_ip_id_bits == 0)
-	{
-		ext = ROHC_EXT_2;
-	}
-	else
-	{
-		ext = ROHC_EXT_3;
-	}
-
-	return ext;
-}
-
-
-/**
- * @brief Decide what extension shall be used in the UO-1-ID/UOR-2 packet.
- *
- * Extensions 0, 1 & 2 are IPv4 only because of the IP-ID.
- *
- * @param context                  The compression context
- * @param nr_innermost_ip_id_bits  The number of IP-ID bits of the innermost
- *                                 IPv4 header
- * @param nr_outermost_ip_id_bits  The number of IP-ID bits of the outermost
- *                                 IPv4 header
- * @return                         The extension code among ROHC_EXT_NONE,
- *                                 ROHC_EXT_0, ROHC_EXT_1 and ROHC_EXT_3
- */
-static rohc_ext_t decide_extension_uor2ts(const struct rohc_comp_ctxt *const context,
-                                          const size_t nr_innermost_ip_id_bits,
-                                          const size_t nr_outermost_ip_id_bits)
-{
-	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
-	const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
-	const size_t nr_ts_bits = rtp_context->tmp.nr_ts_bits_more_than_2;
-	rohc_ext_t ext;
-
-	if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 6 &&
-	   nr_ts_bits <= 5 &&
-	   nr_innermost_ip_id_bits == 0 &&
-	   nr_outermost_ip_id_bits == 0)
-	{
-		ext = ROHC_EXT_NONE;
-	}
-	else if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 9 &&
-	        nr_ts_bits <= 8 &&
-	        nr_innermost_ip_id_bits == 0 &&
-	        nr_outermost_ip_id_bits == 0)
-	{
-		ext = ROHC_EXT_0;
-	}
-	else if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 9 &&
-	        nr_ts_bits <= 8 &&
-	        nr_innermost_ip_id_bits <= 8 &&
-	        nr_outermost_ip_id_bits == 0)
-	{
-		ext = ROHC_EXT_1;
-	}
-	else if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 9 &&
-	        nr_ts_bits <= 16 &&
-	        nr_innermost_ip_id_bits <= 8 &&
-	        nr_outermost_ip_id_bits == 0)
-	{
-		ext = ROHC_EXT_2;
-	}
-	else
-	{
-		ext = ROHC_EXT_3;
-	}
-
-	return ext;
-}
 
+		/* determine the number of IP-ID bits and the IP-ID offset of the
+		 * innermost IPv4 header with non-random IP-ID */
+		rohc_get_ipid_bits(context, &nr_innermost_ip_id_bits,
+		                   &nr_outermost_ip_id_bits);
 
-/**
- * @brief Decide what extension shall be used in the UOR-2-ID packet.
- *
- * Extensions 0, 1 & 2 are IPv4 only because of the IP-ID.
- *
- * @param context                  The compression context
- * @param nr_innermost_ip_id_bits  The number of IP-ID bits of the innermost
- *                                 IPv4 header
- * @param nr_outermost_ip_id_bits  The number of IP-ID bits of the outermost
- *                                 IPv4 header
- * @return                         The extension code among ROHC_EXT_NONE,
- *                                 ROHC_EXT_0, ROHC_EXT_1 and ROHC_EXT_3
- */
-static rohc_ext_t decide_extension_uor2id(const struct rohc_comp_ctxt *const context,
-                                          const size_t nr_innermost_ip_id_bits,
-                                          const size_t nr_outermost_ip_id_bits)
-{
-	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
-	const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
-	const size_t nr_ts_bits = rtp_context->tmp.nr_ts_bits_more_than_2;
-	rohc_ext_t ext;
+		/* the TS and the Marker bit are RTP-only inputs */
+		if(context->profile->id == ROHC_PROFILE_RTP)
+		{
+			const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+			nr_ts_bits = rtp_context->tmp.nr_ts_bits_more_than_2;
+			is_ts_deducible = rohc_ts_sc_is_deducible(&rtp_context->ts_sc);
+			is_marker_bit_set = rtp_context->tmp.is_marker_bit_set;
+		}
 
-	if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 6 &&
-	   (nr_ts_bits == 0 || rohc_ts_sc_is_deducible(&rtp_context->ts_sc)) &&
-	   nr_innermost_ip_id_bits <= 5 &&
-	   nr_outermost_ip_id_bits == 0)
-	{
-		ext = ROHC_EXT_NONE;
-	}
-	else if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 9 &&
-	        (nr_ts_bits == 0 || rohc_ts_sc_is_deducible(&rtp_context->ts_sc)) &&
-	        nr_innermost_ip_id_bits <= 8 &&
-	        nr_outermost_ip_id_bits == 0)
-	{
-		ext = ROHC_EXT_0;
-	}
-	else if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 9 &&
-	        nr_ts_bits <= 8 &&
-	        nr_innermost_ip_id_bits <= 8 &&
-	        nr_outermost_ip_id_bits == 0)
-	{
-		ext = ROHC_EXT_1;
-	}
-	else if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 9 &&
-	        nr_ts_bits <= 8 &&
-	        nr_innermost_ip_id_bits <= 16 &&
-	        nr_outermost_ip_id_bits == 0)
-	{
-		ext = ROHC_EXT_2;
-	}
-	else
-	{
-		ext = ROHC_EXT_3;
+		assert(rfc3095_ctxt->ip_hdr_nr >= 1 && rfc3095_ctxt->ip_hdr_nr <= 2);
+		rows = table->sn[rohc_comp_bits_idx(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4)];
+		rows &= table->sn_4[rohc_comp_bits_idx(rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4)];
+		rows &= table->ts[rohc_comp_bits_idx(nr_ts_bits)] |
+		        table->ts_deducible[is_ts_deducible];
+		rows &= table->inner_ip_id[rohc_comp_bits_idx(nr_innermost_ip_id_bits)];
+		rows &= table->outer_ip_id[rohc_comp_bits_idx(nr_outermost_ip_id_bits)];
+		rows &= table->marker[is_marker_bit_set];
+		rows &= table->ip_layout[rfc3095_ctxt->ip_hdr_nr - 1];
+		assert((rows & EXT_ROW_3) != 0);
+		ext = rohc_comp_ext_rows[__builtin_ctz(rows)];
 	}
 
 	return ext;
-}
-
-
-/**
- * @brief Decide what extension shall be used in the UO-1-ID packet.
- *
- * Extensions 0, 1 & 2 are IPv4 only because of the IP-ID.
- *
- * @param context                  The compression context
- * @param nr_innermost_ip_id_bits  The number of IP-ID bits of the innermost
- *                                 IPv4 header
- * @param nr_outermost_ip_id_bits  The number of IP-ID bits of the outermost
- *                                 IPv4 header
- * @return                         The extension code among ROHC_EXT_NONE,
- *                                 ROHC_EXT_0, ROHC_EXT_1 and ROHC_EXT_3
- */
-static rohc_ext_t decide_extension_uo1id(const struct rohc_comp_ctxt *const context,
-                                         const size_t nr_innermost_ip_id_bits,
-                                         const size_t nr_outermost_ip_id_bits)
-{
-	const struct rohc_comp_rfc3095_ctxt *const rfc3095_ctxt = context->specific;
-	const struct sc_rtp_context *const rtp_context = rfc3095_ctxt->specific;
-	const size_t nr_ts_bits = rtp_context->tmp.nr_ts_bits_more_than_2;
-	rohc_ext_t ext;
 
-	if(rfc3095_ctxt->tmp.nr_sn_bits_less_equal_than_4 <= 4 &&
-	   (nr_ts_bits == 0 || rohc_ts_sc_is_deducible(&rtp_context->ts_sc)) &&
-	   nr_innermost_ip_id_bits <= 5 &&
-	   nr_outermost_ip_id_bits == 0 &&
-	   !rtp_context->tmp.is_marker_bit_set)
-	{
-		ext = ROHC_EXT_NONE;
-	}
-	else if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 7 &&
-	        (nr_ts_bits == 0 || rohc_ts_sc_is_deducible(&rtp_context->ts_sc)) &&
-	        nr_innermost_ip_id_bits <= 8 &&
-	        nr_outermost_ip_id_bits == 0 &&
-	        !rtp_context->tmp.is_marker_bit_set)
-	{
-		ext = ROHC_EXT_0;
-	}
-	else if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 7 &&
-	        nr_ts_bits <= 8 &&
-	        nr_innermost_ip_id_bits <= 8 &&
-	        nr_outermost_ip_id_bits == 0 &&
-	        !rtp_context->tmp.is_marker_bit_set)
-	{
-		ext = ROHC_EXT_1;
-	}
-	else if(rfc3095_ctxt->tmp.nr_sn_bits_more_than_4 <= 7 &&
-	        nr_ts_bits <= 8 &&
-	        nr_innermost_ip_id_bits <= 16 &&
-	        nr_outermost_ip_id_bits == 0 &&
-	        !rtp_context->tmp.is_marker_bit_set)
-	{
-		ext = ROHC_EXT_2;
-	}
-	else
-	{
-		ext = ROHC_EXT_3;
-	}
-
-	return ext;
+error:
+	return ROHC_EXT_UNKNOWN;
 }
 
 
@@ -7174,13 +8169,13 @@ static void rohc_get_innermost_ipv4_non_rnd(const struct rohc_comp_ctxt *const c
 	assert(offset != NULL);
 
 	if(rfc3095_ctxt->ip_hdr_nr > 1 &&
-	   rfc3095_ctxt->inner_ip_flags.version == IPV4 &&
-	   rfc3095_ctxt->inner_ip_flags.info.v4.rnd == 0)
+	   rfc3095_ctxt->inner_ip_flags->version == IPV4 &&
+	   rfc3095_ctxt->inner_ip_flags->info.v4.rnd == 0)
 	{
 		/* inner IP header exists and is IPv4 with a non-random IP-ID */
 		*pos = ROHC_IP_HDR_SECOND;
 		*nr_bits = rfc3095_ctxt->tmp.nr_ip_id_bits2;
-		*offset = rfc3095_ctxt->inner_ip_flags.info.v4.id_delta;
+		*offset = rfc3095_ctxt->inner_ip_flags->info.v4.id_delta;
 	}
 	else if(rfc3095_ctxt->outer_ip_flags.version == IPV4 &&
 	        rfc3095_ctxt->outer_ip_flags.info.v4.rnd == 0)
@@ -7217,8 +8212,8 @@ void rohc_get_ipid_bits(const struct rohc_comp_ctxt *const context,
 		(struct rohc_comp_rfc3095_ctxt *) context->specific;
 
 	if(rfc3095_ctxt->ip_hdr_nr > 1 &&
-	   rfc3095_ctxt->inner_ip_flags.version == IPV4 &&
-	   rfc3095_ctxt->inner_ip_flags.info.v4.rnd == 0)
+	   rfc3095_ctxt->inner_ip_flags->version == IPV4 &&
+	   rfc3095_ctxt->inner_ip_flags->info.v4.rnd == 0)
 	{
 		/* inner IP header exists and is IPv4 with a non-random IP-ID */
 		*nr_innermost_bits = rfc3095_ctxt->tmp.nr_ip_id_bits2;
@@ -7350,7 +8345,7 @@ static void rohc_comp_rfc3095_get_ext3_I_flags(const struct rohc_comp_ctxt *cons
 	else /* double IP headers */
 	{
 		const struct ip_packet *const inner_ip = &uncomp_pkt->inner_ip;
-		const struct ip_header_info *const inner_ip_flags = &rfc3095_ctxt->inner_ip_flags;
+		const struct ip_header_info *const inner_ip_flags = rfc3095_ctxt->inner_ip_flags;
 		const struct ip_packet *const outer_ip = &uncomp_pkt->outer_ip;
 		const struct ip_header_info *const outer_ip_flags = &rfc3095_ctxt->outer_ip_flags;
 
@@ -36,6 +36,7 @@
 #include "crc.h"
 
 #include <stdlib.h>
+#include <stdint.h>
 
 
 /**
@@ -52,40 +53,42 @@ struct ipv4_header_info
 	/// A window to store the IP-ID
 	struct c_wlsb *ip_id_window;
 
-	/// The previous IP header
-	struct ipv4_hdr old_ip;
-
-	/// The number of times the DF field was added to the compressed header
-	size_t df_count;
-	/// @brief The number of times the IP-ID is specified as random in the
-	///        compressed header
-	size_t rnd_count;
-	/// @brief The number of times the IP-ID is specified as coded in Network
-	///        Byte Order (NBO) in the compressed header
-	size_t nbo_count;
-	/// @brief The number of times the IP-ID is specified as static in the
-	///        compressed header
-	size_t sid_count;
+	/// The delta between the IP-ID and the current Sequence Number (SN)
+	/// (overflow over 16 bits is expected when SN > IP-ID)
+	uint16_t id_delta;
 
 	/// Whether the IP-ID is considered as random or not
-	int rnd;
+	uint8_t rnd;
 	/// Whether the IP-ID is considered as coded in NBO or not
-	int nbo;
+	uint8_t nbo;
 	/// Whether the IP-ID is considered as static or not
-	int sid;
+	uint8_t sid;
 	/// @brief Whether the IP-ID of the previous IP header was considered as
 	///        random or not
-	int old_rnd;
+	uint8_t old_rnd;
 	/// @brief Whether the IP-ID of the previous IP header was considered as
 	///        coded in NBO or not
-	int old_nbo;
+	uint8_t old_nbo;
 	/// @brief Whether the IP-ID of the previous IP header was considered as
 	///        static or not
-	int old_sid;
+	uint8_t old_sid;
+	/// The number of consecutive packets that confirmed the IP-ID behaviour
+	uint8_t behaviour_confidence;
 
-	/// The delta between the IP-ID and the current Sequence Number (SN)
-	/// (overflow over 16 bits is expected when SN > IP-ID)
-	uint16_t id_delta;
+	/// The number of times the DF field was added to the compressed header
+	uint8_t df_count;
+	/// @brief The number of times the IP-ID is specified as random in the
+	///        compressed header
+	uint8_t rnd_count;
+	/// @brief The number of times the IP-ID is specified as coded in Network
+	///        Byte Order (NBO) in the compressed header
+	uint8_t nbo_count;
+	/// @brief The number of times the IP-ID is specified as static in the
+	///        compressed header
+	uint8_t sid_count;
+
+	/// The previous IP header
+	struct ipv4_hdr old_ip;
 };
 
 
@@ -110,22 +113,25 @@ struct ipv6_header_info
 /**
  * @brief Store information about an IP (IPv4 or IPv6) header between the
  *        different compressions of IP packets.
+ *
+ * The counters are only compared with MAX_FO_COUNT, they saturate instead of
+ * wrapping around, see \ref C_COUNT_INC.
  */
 struct ip_header_info
 {
 	ip_version version;            ///< The version of the IP header
 
+	/** Whether the old_* members of the struct and in its children are
+	 *  initialized or not */
+	bool is_first_header;
+
 	/// The number of times the TOS/TC field was added to the compressed header
-	size_t tos_count;
+	uint8_t tos_count;
 	/// The number of times the TTL/HL field was added to the compressed header
-	size_t ttl_count;
+	uint8_t ttl_count;
 	/// @brief The number of times the Protocol/Next Header field was added to
 	///        the compressed header
-	size_t protocol_count;
-
-	/** Whether the old_* members of the struct and in its children are
-	 *  initialized or not */
-	bool is_first_header;
+	uint8_t protocol_count;
 
 	union
 	{
@@ -135,6 +141,26 @@ struct ip_header_info
 };
 
 
+/**
+ * @brief Increment one repetition counter of the context
+ *
+ * The counters only tell whether one change was repeated MAX_FO_COUNT or
+ * MAX_IR_COUNT times, so they stop at their max value instead of wrapping
+ * around to 0 on long-lived flows.
+ *
+ * @param count  The counter to increment
+ */
+#define C_COUNT_INC(count) \
+	do \
+	{ \
+		if((count) < UINT8_MAX) \
+		{ \
+			(count)++; \
+		} \
+	} \
+	while(0)
+
+
 /**
  * @brief Structure that contains variables that are used during one single
  *        compression of packet.
@@ -168,41 +194,99 @@ struct generic_tmp_vars
 
 	/// The type of packet the compressor must send: IR, IR-DYN, UO*
 	rohc_packet_t packet_type;
+	/** The packet types that the compressor may send instead of packet_type,
+	 *  bit N for packet type N, see ROHC_COMP_FEATURE_SMALLEST_PACKETS */
+	uint32_t packet_candidates;
 };
 
 
+/** The max length of the pre-encoded UO-0 header: CID, base header, IP-IDs */
+#define ROHC_COMP_RFC3095_UO0_TMPL_MAX_LEN  8U
+
+/** The max length of the static chain: 2 IPv6 headers and UDP/RTP */
+#define ROHC_COMP_RFC3095_STATIC_CHAIN_MAX_LEN  80U
+
+
+/*
+ * Pre-computed decision tables
+ *
+ * The packet type and the extension are decided by tables rather than by
+ * chains of conditions. Every decision is a list of candidate rows tested in
+ * order, the first row whose conditions are all fulfilled wins. Every input of
+ * the decision (number of SN bits, number of TS bits, flags...) indexes one
+ * table that gives the mask of the rows that the input allows. The decision is
+ * the lowest bit of the AND of all the masks.
+ */
+
+/** The number of entries of the tables indexed by a number of bits (0-32) */
+#define ROHC_COMP_BITS_NR  33U
+
 /**
- * @brief The generic decompression context for RFC3095-based profiles
+ * @brief Build one table indexed by a number of bits from 0 to 32
  *
- * The object defines the generic context that manages IP(/nextheader) and
- * IP/IP(/nextheader) packets. nextheader is managed by the profile-specific
- * part of the context.
+ * @param f  The macro that computes the mask of rows for one number of bits
  */
-struct rohc_comp_rfc3095_ctxt
-{
-	/// The Sequence Number (SN), may be 16-bit or 32-bit long
-	uint32_t sn;
-	/// A window used to encode the SN
-	struct c_wlsb *sn_window;
+#define ROHC_COMP_BITS_TABLE(f) \
+	{ \
+		f(0),  f(1),  f(2),  f(3),  f(4),  f(5),  f(6),  f(7), \
+		f(8),  f(9),  f(10), f(11), f(12), f(13), f(14), f(15), \
+		f(16), f(17), f(18), f(19), f(20), f(21), f(22), f(23), \
+		f(24), f(25), f(26), f(27), f(28), f(29), f(30), f(31), \
+		f(32) \
+	}
 
-	/** The number of IP headers */
-	size_t ip_hdr_nr;
-	/// Information about the outer IP header
-	struct ip_header_info outer_ip_flags;
-	/// Information about the inner IP header
-	struct ip_header_info inner_ip_flags;
+/**
+ * @brief The mask of rows if the number of bits is in the given range
+ *
+ * @param v     The number of bits
+ * @param min   The min number of bits the rows accept
+ * @param max   The max number of bits the rows accept
+ * @param rows  The mask of rows
+ */
+#define ROHC_COMP_ROWS_IF(v, min, max, rows) \
+	(((v) >= (min) && (v) <= (max)) ? (rows) : 0U)
 
-	/// Temporary variables that are used during one single compression of packet
-	struct generic_tmp_vars tmp;
 
-	/* below are some information and handlers to manage the next header
-	 * (if any) located just after the IP headers (1 or 2 IP headers) */
+/**
+ * @brief The pre-encoded layout of the UO-0 header of one context
+ *
+ * The CID octets, the position of the base header and the positions of the
+ * random IP-IDs of a UO-0 packet only depend on the context, not on the
+ * packet. They are recorded once, then every steady-state UO-0 packet is
+ * built by copying them and filling the SN/CRC and IP-ID holes.
+ *
+ * @see code_UO0_packet
+ */
+struct rohc_comp_rfc3095_uo0_tmpl
+{
+	/** The pre-encoded bytes, holes included */
+	uint8_t bytes[ROHC_COMP_RFC3095_UO0_TMPL_MAX_LEN];
+	/** The length of the pre-encoded bytes */
+	size_t len;
+	/** The offset of the SN/CRC hole, i.e. the base header */
+	size_t sn_crc_pos;
+	/** The offset of the outer IP-ID hole, if outer_rnd is set */
+	size_t outer_ip_id_pos;
+	/** The offset of the inner IP-ID hole, if inner_rnd is set */
+	size_t inner_ip_id_pos;
+	/** Whether the outer IP-ID was random when the layout was recorded */
+	bool outer_rnd;
+	/** Whether the inner IP-ID was random when the layout was recorded */
+	bool inner_rnd;
+	/** Whether the layout was recorded or not */
+	bool is_valid;
+};
 
-	/// The protocol number registered by IANA for the next header protocol
-	unsigned int next_header_proto;
-	/// The length of the next header
-	unsigned int next_header_len;
 
+/**
+ * @brief The profile-specific handlers of the RFC3095-based contexts
+ *
+ * Every profile defines one constant table of handlers shared by all its
+ * contexts, see \ref rohc_comp_rfc3095_create. The optional handlers are NULL
+ * if the profile does not need them.
+ */
+struct rohc_comp_rfc3095_ops
+{
 	/** The handler for encoding profile-specific uncompressed header fields */
 	bool (*encode_uncomp_fields)(struct rohc_comp_ctxt *const context,
 	                             const struct net_pkt *const uncomp_pkt)
@@ -274,7 +358,8 @@ struct rohc_comp_rfc3095_ctxt
 	                              const uint8_t *const next_header,
 	                              const rohc_crc_type_t crc_type,
 	                              const uint8_t init_val,
-	                              const uint8_t *const crc_table)
+	                              const uint8_t *const crc_table,
+	                              struct crc_static_cache *const cache)
 		__attribute__((nonnull(1, 3, 6), warn_unused_result));
 
 	/// @brief The handler used to compute the CRC-DYNAMIC value
@@ -283,11 +368,91 @@ struct rohc_comp_rfc3095_ctxt
 	                               const uint8_t *const next_header,
 	                               const rohc_crc_type_t crc_type,
 	                               const uint8_t init_val,
-	                               const uint8_t *const crc_table)
+	                               const uint8_t *const crc_table,
+	                               const struct crc_static_cache *const cache)
 		__attribute__((nonnull(1, 3, 6), warn_unused_result));
+};
+
+
+/**
+ * @brief The generic decompression context for RFC3095-based profiles
+ *
+ * The object defines the generic context that manages IP(/nextheader) and
+ * IP/IP(/nextheader) packets. nextheader is managed by the profile-specific
+ * part of the context.
+ *
+ * The members are laid out by access frequency: the ones read for every
+ * packet first, the ones of the R-mode and of the IR packets last. The info
+ * about the inner IP header is allocated only for contexts with 2 IP headers.
+ */
+struct rohc_comp_rfc3095_ctxt
+{
+	/** The profile-specific handlers, shared by all the contexts of the
+	 *  profile */
+	const struct rohc_comp_rfc3095_ops *ops;
+
+	/// The Sequence Number (SN), may be 16-bit or 32-bit long
+	uint32_t sn;
+	/// A window used to encode the SN
+	struct c_wlsb *sn_window;
+
+	/** The number of IP headers */
+	uint8_t ip_hdr_nr;
+
+	/**
+	 * @brief Whether the context compresses one IPv4 header followed by UDP
+	 *        and RTP headers
+	 *
+	 * The RTP handlers of such contexts are called directly by the generic
+	 * code instead of through the table of handlers, see
+	 * \ref rohc_comp_rfc3095_call.
+	 */
+	bool is_ipv4_udp_rtp;
+
+	/* below are some information to manage the next header (if any) located
+	 * just after the IP headers (1 or 2 IP headers) */
+
+	/// The protocol number registered by IANA for the next header protocol
+	uint8_t next_header_proto;
+	/// The length of the next header
+	uint16_t next_header_len;
+
+	/// Temporary variables that are used during one single compression of packet
+	struct generic_tmp_vars tmp;
+
+	/// Information about the outer IP header
+	struct ip_header_info outer_ip_flags;
+	/// Information about the inner IP header, NULL if only one IP header
+	struct ip_header_info *inner_ip_flags;
 
 	/// Profile-specific data
 	void *specific;
+
+	/** The pre-encoded layout of the UO-0 and R-0 headers */
+	struct rohc_comp_rfc3095_uo0_tmpl uo0_tmpl;
+
+	/** The CRC-STATIC bytes and CRCs of the last packet */
+	struct crc_static_cache crc_static_cache;
+
+	/* below are the variables of the R-mode (RFC 3095, §5.5) */
+
+	/** The SN of the last packet that updated the context in R-mode */
+	uint32_t r_update_sn;
+	/** The SN of the first packet that carried the R-mode to the decompressor */
+	uint32_t r_trans_sn;
+	/** Whether the last context update was acknowledged by the decompressor */
+	bool r_update_acked;
+	/** Whether the transition to R-mode is not acknowledged yet */
+	bool r_trans_pending;
+	/** Whether \ref r_trans_sn holds the SN of a packet that carried the mode */
+	bool r_trans_sn_valid;
+
+	/** The CRC-8 of the IR header up to the end of the cached static chain */
+	uint8_t static_chain_crc;
+	/** The length of the cached static chain, 0 if not built yet */
+	uint8_t static_chain_len;
+	/** The static chain of the IR packets, built by the first IR packet */
+	uint8_t static_chain[ROHC_COMP_RFC3095_STATIC_CHAIN_MAX_LEN];
 };
 
 
@@ -296,13 +461,17 @@ struct rohc_comp_rfc3095_ctxt
  */
 
 bool rohc_comp_rfc3095_create(struct rohc_comp_ctxt *const context,
+                              const struct rohc_comp_rfc3095_ops *const ops,
                               const rohc_lsb_shift_t sn_shift,
                               const struct net_pkt *const packet)
-	__attribute__((warn_unused_result, nonnull(1, 3)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
 
 void rohc_comp_rfc3095_destroy(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
+size_t rohc_comp_rfc3095_mem_max(const size_t wlsb_width)
+	__attribute__((warn_unused_result, const));
+
 bool rohc_comp_rfc3095_check_profile(const struct rohc_comp *const comp,
                                      const struct net_pkt *const packet)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
@@ -326,6 +495,9 @@ bool rohc_comp_rfc3095_feedback(struct rohc_comp_ctxt *const context,
                                 const size_t feedback_data_len)
 	__attribute__((warn_unused_result, nonnull(1, 3, 5)));
 
+void rohc_comp_rfc3095_prefetch(const struct rohc_comp_ctxt *const context)
+	__attribute__((nonnull(1)));
+
 void rohc_comp_rfc3095_decide_state(struct rohc_comp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
@@ -381,8 +553,8 @@ static inline bool is_outer_ip_id_bits_possible(const struct rohc_comp_rfc3095_c
  */
 static inline bool no_inner_ip_id_bits_required(const struct rohc_comp_rfc3095_ctxt *const ctxt)
 {
-	return (ctxt->inner_ip_flags.version != IPV4 ||
-	        ctxt->inner_ip_flags.info.v4.rnd == 1 ||
+	return (ctxt->inner_ip_flags->version != IPV4 ||
+	        ctxt->inner_ip_flags->info.v4.rnd == 1 ||
 	        ctxt->tmp.nr_ip_id_bits2 == 0);
 }
 
@@ -398,12 +570,26 @@ static inline bool no_inner_ip_id_bits_required(const struct rohc_comp_rfc3095_c
 static inline bool is_inner_ip_id_bits_possible(const struct rohc_comp_rfc3095_ctxt *const ctxt,
                                                 const size_t max_ip_id_bits_nr)
 {
-	return (ctxt->inner_ip_flags.version == IPV4 &&
-	        ctxt->inner_ip_flags.info.v4.rnd != 1 &&
+	return (ctxt->inner_ip_flags->version == IPV4 &&
+	        ctxt->inner_ip_flags->info.v4.rnd != 1 &&
 	        ctxt->tmp.nr_ip_id_bits2 <= max_ip_id_bits_nr);
 }
 
 
+/**
+ * @brief Get the index of a number of bits in the pre-computed tables
+ *
+ * All the numbers of bits greater than 32 share the last entry of the tables.
+ *
+ * @param bits_nr  The number of bits
+ * @return         The index in the tables indexed by a number of bits
+ */
+static inline size_t rohc_comp_bits_idx(const size_t bits_nr)
+{
+	return (bits_nr < ROHC_COMP_BITS_NR ? bits_nr : (ROHC_COMP_BITS_NR - 1));
+}
+
+
 /**
  * @brief How many IP headers are IPv4 headers with non-random IP-IDs ?
  *
@@ -421,9 +607,9 @@ static inline size_t get_nr_ipv4_non_rnd(const struct rohc_comp_rfc3095_ctxt *co
 	}
 
 	/* optional inner IP header */
-	if(ctxt->ip_hdr_nr >= 1 &&
-	   ctxt->inner_ip_flags.version == IPV4 &&
-	   ctxt->inner_ip_flags.info.v4.rnd != 1)
+	if(ctxt->ip_hdr_nr > 1 &&
+	   ctxt->inner_ip_flags->version == IPV4 &&
+	   ctxt->inner_ip_flags->info.v4.rnd != 1)
 	{
 		nr_ipv4_non_rnd++;
 	}
@@ -453,9 +639,9 @@ static inline size_t get_nr_ipv4_non_rnd_with_bits(const struct rohc_comp_rfc309
 	}
 
 	/* optional inner IP header */
-	if(ctxt->ip_hdr_nr >= 1 &&
-	   ctxt->inner_ip_flags.version == IPV4 &&
-	   ctxt->inner_ip_flags.info.v4.rnd != 1 &&
+	if(ctxt->ip_hdr_nr > 1 &&
+	   ctxt->inner_ip_flags->version == IPV4 &&
+	   ctxt->inner_ip_flags->info.v4.rnd != 1 &&
 	   ctxt->tmp.nr_ip_id_bits2 > 0)
 	{
 		nr_ipv4_non_rnd_with_bits++;
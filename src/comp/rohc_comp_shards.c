@@ -0,0 +1,470 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_comp_shards.c
+ * @brief  ROHC sharded compression routines
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * A sharded compressor is made of several ROHC compressors that share the
+ * CID space of one channel: every compressor (shard) uses its own range of
+ * CIDs, so that the shards never use the same CID. The flows are spread
+ * over the shards with a hash of their addresses, protocol and ports, so
+ * that all the packets of one flow are compressed by the same shard.
+ *
+ * The shards share no data, so every shard may be used by its own thread
+ * without any lock.
+ */
+
+#include "rohc_comp_internals.h"
+#include "rohc_debug.h"
+#include "net_pkt.h"
+#include "feedback_parse.h"
+#include "sdvl.h"
+#include "rohc_add_cid.h"
+
+#include <assert.h>
+
+
+/**
+ * @brief The sharded ROHC compressor
+ */
+struct rohc_comp_shards
+{
+	/** The number of shards */
+	size_t shards_nr;
+	/** The number of CIDs of every shard (the last shard may have more) */
+	rohc_cid_t cids_per_shard;
+	/** The compressors of the shards */
+	struct rohc_comp **comps;
+};
+
+
+/*
+ * Prototypes of private functions
+ */
+
+static bool rohc_comp_shards_parse_cid(const struct rohc_comp_shards *const shards,
+                                       const uint8_t *const feedback,
+                                       const size_t feedback_len,
+                                       rohc_cid_t *const cid)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+
+
+/*
+ * Definitions of public functions
+ */
+
+/**
+ * @brief Create a new sharded ROHC compressor
+ *
+ * Create a new sharded ROHC compressor made of \e shards_nr ROHC compressors
+ * that share the CID space [0, \e max_cid]. Every compressor (shard) uses its
+ * own contiguous range of CIDs, so several threads may compress packets on
+ * the same ROHC channel without any lock: every thread owns one shard.
+ *
+ * Every shard is a regular ROHC compressor retrieved with
+ * \ref rohc_comp_shards_get. All the shards shall be configured the same
+ * way (profiles, features, callbacks...) before compressing packets.
+ *
+ * The packets of one flow shall always be compressed by the same shard: use
+ * \ref rohc_comp_shards_select to get the shard of every packet, and
+ * \ref rohc_comp_shards_select_cid to get the shard that shall receive the
+ * feedback for one CID. \ref rohc_comp_shards_enqueue_feedback hands the
+ * received feedback over to the shards without any lock.
+ *
+ * @param cid_type   The type of Context IDs (CID) that the ROHC compressors
+ *                   shall operate with, see \ref rohc_comp_new2
+ * @param max_cid    The maximum value that the ROHC compressors should use
+ *                   for context IDs (CID), see \ref rohc_comp_new2
+ * @param shards_nr  The number of shards, in range [1, \e max_cid + 1]
+ * @param rand_cb    The random callback to set for all the shards
+ * @param rand_priv  Private data that will be given to the callback
+ * @return           The created sharded compressor if successful,
+ *                   NULL if creation failed
+ *
+ * @warning Don't forget to free the sharded compressor memory with
+ *          \ref rohc_comp_shards_free if \e rohc_comp_shards_new succeeded
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_shards_free
+ * @see rohc_comp_shards_get
+ * @see rohc_comp_shards_select
+ * @see rohc_comp_shards_select_cid
+ */
+struct rohc_comp_shards * rohc_comp_shards_new(const rohc_cid_type_t cid_type,
+                                               const rohc_cid_t max_cid,
+                                               const size_t shards_nr,
+                                               const rohc_comp_random_cb_t rand_cb,
+                                               void *const rand_priv)
+{
+	struct rohc_comp_shards *shards;
+	size_t i;
+
+	/* check input parameters, the other ones are checked when creating the
+	 * compressors of the shards */
+	if(shards_nr == 0 || shards_nr > (max_cid + 1))
+	{
+		goto error;
+	}
+
+	shards = malloc(sizeof(struct rohc_comp_shards));
+	if(shards == NULL)
+	{
+		goto error;
+	}
+	shards->shards_nr = shards_nr;
+	shards->cids_per_shard = (max_cid + 1) / shards_nr;
+
+	shards->comps = calloc(shards_nr, sizeof(struct rohc_comp *));
+	if(shards->comps == NULL)
+	{
+		goto free_shards;
+	}
+
+	/* create the compressors of the shards, the last shard gets the CIDs
+	 * that remain if the CIDs cannot be split evenly */
+	for(i = 0; i < shards_nr; i++)
+	{
+		const rohc_cid_t min_cid = i * shards->cids_per_shard;
+		const rohc_cid_t shard_max_cid =
+			((i + 1) == shards_nr ? max_cid : (min_cid + shards->cids_per_shard - 1));
+
+		shards->comps[i] = rohc_comp_new2(cid_type, shard_max_cid, rand_cb,
+		                                  rand_priv);
+		if(shards->comps[i] == NULL)
+		{
+			goto free_comps;
+		}
+		shards->comps[i]->min_cid = min_cid;
+	}
+
+	return shards;
+
+free_comps:
+	for(i = 0; i < shards_nr; i++)
+	{
+		if(shards->comps[i] != NULL)
+		{
+			rohc_comp_free(shards->comps[i]);
+		}
+	}
+	zfree(shards->comps);
+free_shards:
+	zfree(shards);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the given sharded ROHC compressor
+ *
+ * Destroy the given sharded ROHC compressor and the compressors of all its
+ * shards.
+ *
+ * @param shards  The sharded ROHC compressor to destroy
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_shards_new
+ */
+void rohc_comp_shards_free(struct rohc_comp_shards *const shards)
+{
+	if(shards != NULL)
+	{
+		size_t i;
+
+		for(i = 0; i < shards->shards_nr; i++)
+		{
+			rohc_comp_free(shards->comps[i]);
+		}
+		free(shards->comps);
+		free(shards);
+	}
+}
+
+
+/**
+ * @brief Get the ROHC compressor of one shard
+ *
+ * The compressor of the shard is a regular ROHC compressor: configure it
+ * and compress packets with the usual functions, eg. \ref rohc_compress4.
+ * The compressor shall not be freed with \ref rohc_comp_free, it is freed
+ * with the sharded compressor.
+ *
+ * @param shards    The sharded ROHC compressor
+ * @param shard_id  The index of the shard, in range [0, shards_nr - 1]
+ * @return          The ROHC compressor of the shard,
+ *                  NULL if one parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_shards_select
+ */
+struct rohc_comp * rohc_comp_shards_get(const struct rohc_comp_shards *const shards,
+                                        const size_t shard_id)
+{
+	if(shards == NULL || shard_id >= shards->shards_nr)
+	{
+		goto error;
+	}
+
+	return shards->comps[shard_id];
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Get the shard that shall compress the given packet
+ *
+ * The shard is selected with a hash of the IP addresses, the protocol and
+ * the ports (or the SPI) of the packet, so that all the packets of one flow
+ * are compressed by the same shard. The packets that cannot be parsed are
+ * given to the first shard that reports the error when compressing them.
+ *
+ * The function neither modifies the sharded compressor nor its shards, so
+ * it may be called from any thread, eg. the thread that dispatches the
+ * packets to the threads of the shards.
+ *
+ * @param shards         The sharded ROHC compressor
+ * @param uncomp_packet  The uncompressed packet to compress
+ * @param[out] shard_id  The index of the shard that shall compress the packet
+ * @return               true if a shard was selected,
+ *                       false if one parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_shards_get
+ */
+bool rohc_comp_shards_select(const struct rohc_comp_shards *const shards,
+                             const struct rohc_buf uncomp_packet,
+                             size_t *const shard_id)
+{
+	struct net_pkt ip_pkt;
+
+	if(shards == NULL || shard_id == NULL)
+	{
+		goto error;
+	}
+
+	if(shards->shards_nr == 1 ||
+	   !net_pkt_parse(&ip_pkt, uncomp_packet, true, NULL, NULL, ROHC_TRACE_COMP))
+	{
+		*shard_id = 0;
+	}
+	else
+	{
+		/* mix the bits of the flow key, then map it onto the shards */
+		const uint32_t hash = ip_pkt.key * 0x9e3779b1U;
+		*shard_id = (((uint64_t) hash) * shards->shards_nr) >> 32;
+	}
+	assert((*shard_id) < shards->shards_nr);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the shard that uses the given CID
+ *
+ * The feedback for one CID shall be delivered with
+ * \ref rohc_comp_deliver_feedback2 to the compressor of the shard that uses
+ * the CID.
+ *
+ * The function neither modifies the sharded compressor nor its shards, so
+ * it may be called from any thread.
+ *
+ * @param shards         The sharded ROHC compressor
+ * @param cid            The CID
+ * @param[out] shard_id  The index of the shard that uses the CID
+ * @return               true if a shard was found,
+ *                       false if one parameter is invalid
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_shards_get
+ * @see rohc_comp_shards_enqueue_feedback
+ */
+bool rohc_comp_shards_select_cid(const struct rohc_comp_shards *const shards,
+                                 const rohc_cid_t cid,
+                                 size_t *const shard_id)
+{
+	const struct rohc_comp *last_comp;
+
+	if(shards == NULL || shard_id == NULL)
+	{
+		goto error;
+	}
+	last_comp = shards->comps[shards->shards_nr - 1];
+	if(cid > last_comp->medium.max_cid)
+	{
+		goto error;
+	}
+
+	*shard_id = cid / shards->cids_per_shard;
+	if((*shard_id) >= shards->shards_nr)
+	{
+		/* the last shard gets the CIDs that remain */
+		*shard_id = shards->shards_nr - 1;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Enqueue feedback data for the shards that use its CIDs
+ *
+ * Every feedback item of the given feedback data is enqueued with
+ * \ref rohc_comp_enqueue_feedback in the feedback queue of the shard that
+ * uses its CID. The shard applies the feedback at the beginning of its next
+ * compression, in its own thread, so the shards stay free of locks.
+ *
+ * The function is meant to be called by one thread only, eg. the thread of
+ * the same-side associated decompressor that received the feedback data:
+ * the feedback queues of the shards accept one producer thread only.
+ *
+ * The feedback data ends with the first byte that does not start a
+ * feedback item. If one feedback item cannot be enqueued, the items before
+ * it stay enqueued and the items after it are dropped.
+ *
+ * @param shards    The sharded ROHC compressor
+ * @param feedback  The feedback data, made of one or more feedback items
+ * @return          true if all the feedback items were enqueued,
+ *                  false if the feedback data is malformed, if one CID is
+ *                  used by no shard or if the queue of one shard is full
+ *
+ * @ingroup rohc_comp
+ *
+ * @see rohc_comp_shards_select_cid
+ * @see rohc_comp_enqueue_feedback
+ */
+bool rohc_comp_shards_enqueue_feedback(struct rohc_comp_shards *const shards,
+                                       const struct rohc_buf feedback)
+{
+	struct rohc_buf remain_data = feedback;
+
+	if(shards == NULL || rohc_buf_is_malformed(remain_data))
+	{
+		goto error;
+	}
+
+	while(remain_data.len > 0 &&
+	      rohc_packet_is_feedback(rohc_buf_byte(remain_data)))
+	{
+		struct rohc_buf feedback_item = remain_data;
+		size_t feedback_hdr_len;
+		size_t feedback_data_len;
+		rohc_cid_t cid;
+		size_t shard_id;
+
+		if(!rohc_feedback_get_size(remain_data, &feedback_hdr_len,
+		                           &feedback_data_len) ||
+		   (feedback_hdr_len + feedback_data_len) > remain_data.len)
+		{
+			goto error;
+		}
+		feedback_item.len = feedback_hdr_len + feedback_data_len;
+
+		/* find the shard that uses the CID of the feedback item */
+		if(!rohc_comp_shards_parse_cid(shards,
+		                               rohc_buf_data_at(remain_data, feedback_hdr_len),
+		                               feedback_data_len, &cid) ||
+		   !rohc_comp_shards_select_cid(shards, cid, &shard_id))
+		{
+			goto error;
+		}
+
+		/* enqueue the whole feedback item, header included */
+		if(!rohc_comp_enqueue_feedback(shards->comps[shard_id], feedback_item))
+		{
+			goto error;
+		}
+
+		rohc_buf_pull(&remain_data, feedback_item.len);
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/*
+ * Definitions of private functions
+ */
+
+/**
+ * @brief Parse the CID of one feedback item
+ *
+ * All the shards use the same type of CID, so the CID is parsed as the
+ * compressor of any shard would.
+ *
+ * @param shards        The sharded ROHC compressor
+ * @param feedback      The feedback data, without the feedback header
+ * @param feedback_len  The length of the feedback data
+ * @param[out] cid      The CID of the feedback item
+ * @return              true if the CID was successfully parsed,
+ *                      false if the CID is malformed
+ */
+static bool rohc_comp_shards_parse_cid(const struct rohc_comp_shards *const shards,
+                                       const uint8_t *const feedback,
+                                       const size_t feedback_len,
+                                       rohc_cid_t *const cid)
+{
+	if(shards->comps[0]->medium.cid_type == ROHC_LARGE_CID)
+	{
+		size_t large_cid_size;
+		size_t large_cid_bits_nr;
+		uint32_t large_cid;
+
+		/* decode SDVL-encoded large CID field */
+		large_cid_size = sdvl_decode(feedback, feedback_len, &large_cid,
+		                             &large_cid_bits_nr);
+		if(large_cid_size != 1 && large_cid_size != 2)
+		{
+			goto error;
+		}
+		*cid = large_cid;
+	}
+	else
+	{
+		/* decode small CID if present, CID 0 otherwise */
+		*cid = rohc_add_cid_decode(feedback, feedback_len);
+		if((*cid) == UINT8_MAX)
+		{
+			*cid = 0;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
@@ -28,6 +28,9 @@
 #include "sdvl.h"
 
 #include <stdint.h>
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
 #include <assert.h>
 
 
@@ -44,25 +47,20 @@ static uint8_t c_add_cid(const rohc_cid_t cid)
  */
 
 /**
- * @brief Build the CID part of the ROHC packets.
+ * @brief Build the CID part of the ROHC packets of one compression context
  *
- * @param cid_type       The type of CID in use for the compression context:
- *                       ROHC_SMALL_CID or ROHC_LARGE_CID
- * @param cid            The value of the CID for the compression context
- * @param dest           The rohc-packet-under-build buffer
- * @param dest_size      The length of the rohc-packet-under-build buffer
- * @param first_position OUT: The position of the first byte to be completed
- *                       by other functions
- * @return               The position in the rohc-packet-under-build buffer
- *                       in case of success, -1 in case of error
+ * @param cid_hdr   OUT: The CID part of the ROHC packets
+ * @param cid_type  The type of CID in use for the compression context:
+ *                  ROHC_SMALL_CID or ROHC_LARGE_CID
+ * @param cid       The value of the CID for the compression context
+ * @return          true if the CID part is built,
+ *                  false if the CID cannot be encoded
  */
-int code_cid_values(const rohc_cid_type_t cid_type,
-                    const rohc_cid_t cid,
-                    uint8_t *const dest,
-                    const size_t dest_size,
-                    size_t *const first_position)
+bool rohc_comp_cid_hdr_build(struct rohc_comp_cid_hdr *const cid_hdr,
+                             const rohc_cid_type_t cid_type,
+                             const rohc_cid_t cid)
 {
-	size_t counter = 0;
+	memset(cid_hdr->bytes, 0, ROHC_COMP_CID_HDR_MAX_LEN);
 
 	/* small CID */
 	if(cid_type == ROHC_SMALL_CID)
@@ -70,50 +68,36 @@ int code_cid_values(const rohc_cid_type_t cid_type,
 		if(cid > 0)
 		{
 			/* Add-CID */
-			if(dest_size < 2)
-			{
-				goto error;
-			}
-			dest[counter] = c_add_cid(cid);
-			*first_position = 1;
-			counter = 2;
+			cid_hdr->bytes[0] = c_add_cid(cid);
+			cid_hdr->first_position = 1;
+			cid_hdr->len = 2;
 		}
 		else
 		{
 			/* no Add-CID */
-			if(dest_size < 1)
-			{
-				goto error;
-			}
-			*first_position = 0;
-			counter = 1;
+			cid_hdr->first_position = 0;
+			cid_hdr->len = 1;
 		}
 	}
 	else /* large CID */
 	{
 		size_t sdvl_len;
 
-		*first_position = 0;
-		counter++;
-
-		/* SDVL-encode the large CID */
-		if(!sdvl_encode_full(dest + counter, dest_size, &sdvl_len, cid))
-		{
-			/* failed to SDVL-encode the large CID */
-			goto error;
-		}
-		else if(sdvl_len != 1 && sdvl_len != 2)
+		/* SDVL-encode the large CID after the packet type byte */
+		if(!sdvl_encode_full(cid_hdr->bytes + 1, ROHC_COMP_CID_HDR_MAX_LEN - 1,
+		                     &sdvl_len, cid))
 		{
 			/* SDVL-encoded large CID shall be 1 or 2 byte long */
 			goto error;
 		}
-		counter += sdvl_len;
+		cid_hdr->first_position = 0;
+		cid_hdr->len = 1 + sdvl_len;
 	}
 
-	return counter;
+	return true;
 
 error:
-	return -1;
+	return false;
 }
 
 
@@ -29,18 +29,81 @@
 #include "rohc.h"
 
 #include <stdlib.h>
+#include <stdint.h>
+#ifdef __KERNEL__
+#  include <linux/types.h>
+#  include <linux/string.h>
+#else
+#  include <stdbool.h>
+#  include <string.h>
+#endif
+
+
+/** The maximum length of the CID part of the ROHC packets: type + 2 bytes */
+#define ROHC_COMP_CID_HDR_MAX_LEN  3U
+
+
+/**
+ * @brief The CID part of the ROHC packets of one compression context
+ *
+ * The CID part never changes during the life of the context, it is built
+ * once when the context is created and copied in every ROHC packet.
+ */
+struct rohc_comp_cid_hdr
+{
+	/** The Add-CID byte or the large CID, around the packet type byte */
+	uint8_t bytes[ROHC_COMP_CID_HDR_MAX_LEN];
+	/** The length of the CID part, packet type byte included */
+	uint8_t len;
+	/** The position of the packet type byte */
+	uint8_t first_position;
+};
 
 
 /*
  * Prototypes of functions that may used by other ROHC modules
  */
 
-int code_cid_values(const rohc_cid_type_t cid_type,
-                    const rohc_cid_t cid,
-                    uint8_t *const dest,
-                    const size_t dest_size,
-                    size_t *const first_position)
-	__attribute__((warn_unused_result, nonnull(3, 5)));
+bool rohc_comp_cid_hdr_build(struct rohc_comp_cid_hdr *const cid_hdr,
+                             const rohc_cid_type_t cid_type,
+                             const rohc_cid_t cid)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static inline int code_cid_values(const struct rohc_comp_cid_hdr *const cid_hdr,
+                                  uint8_t *const dest,
+                                  const size_t dest_size,
+                                  size_t *const first_position)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+
+
+/**
+ * @brief Build the CID part of the ROHC packets.
+ *
+ * The CID part that was built when the context was created is copied in the
+ * ROHC packet, the packet type byte is to be completed by other functions.
+ *
+ * @param cid_hdr        The CID part of the compression context
+ * @param dest           The rohc-packet-under-build buffer
+ * @param dest_size      The length of the rohc-packet-under-build buffer
+ * @param first_position OUT: The position of the first byte to be completed
+ *                       by other functions
+ * @return               The position in the rohc-packet-under-build buffer
+ *                       in case of success, -1 in case of error
+ */
+static inline int code_cid_values(const struct rohc_comp_cid_hdr *const cid_hdr,
+                                  uint8_t *const dest,
+                                  const size_t dest_size,
+                                  size_t *const first_position)
+{
+	if(dest_size < cid_hdr->len)
+	{
+		return -1;
+	}
+	memcpy(dest, cid_hdr->bytes, cid_hdr->len);
+	*first_position = cid_hdr->first_position;
+
+	return cid_hdr->len;
+}
 
 
 #endif
@@ -40,7 +40,13 @@
 
 static bool build_ipv6_ext_pkt_list(struct list_comp *const comp,
                                     const struct ip_packet *const ip,
-                                    struct rohc_list *const pkt_list)
+                                    struct rohc_list *const pkt_list,
+                                    bool *const is_same_list)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+
+static bool rohc_list_reuse_pkt_list(const struct list_comp *const comp,
+                                     const struct ip_packet *const ip,
+                                     struct rohc_list *const pkt_list)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
 static unsigned int rohc_list_get_nearest_list(const struct list_comp *const comp,
@@ -92,7 +98,7 @@ static uint8_t rohc_list_compute_ps(const struct list_comp *const comp,
                                     const struct rohc_list *const list,
                                     const uint8_t mask[ROHC_LIST_ITEMS_MAX],
                                     const size_t m)
-	__attribute__((warn_unused_result, nonnull(1, 2)));
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
 
 static int rohc_list_build_XIs(const struct list_comp *const comp,
                                const struct rohc_list *const list,
@@ -118,6 +124,10 @@ static int rohc_list_build_XIs_4(const struct list_comp *const comp,
                                  uint8_t *const first_4b_xi)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 6)));
 
+static size_t rohc_list_get_item_index(const struct list_comp *const comp,
+                                       const struct rohc_list_item *const item)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
+
 
 
 /**
@@ -137,12 +147,13 @@ bool detect_ipv6_ext_changes(struct list_comp *const comp,
 {
 	unsigned int new_cur_id = ROHC_LIST_GEN_ID_NONE;
 	struct rohc_list pkt_list;
+	bool is_same_list = false;
 	bool is_new_list = false;
 
 	/* parse all extension headers:
 	 *  - update the related entries in the translation table,
 	 *  - create the list for the packet */
-	if(!build_ipv6_ext_pkt_list(comp, ip, &pkt_list))
+	if(!build_ipv6_ext_pkt_list(comp, ip, &pkt_list, &is_same_list))
 	{
 		rohc_comp_list_warn(comp, "failed to build the list of extension headers "
 		                    "for the current packet");
@@ -151,8 +162,19 @@ bool detect_ipv6_ext_changes(struct list_comp *const comp,
 
 	/* now that translation table is updated and packet list is generated,
 	 * search for a context list with the same structure or use an anonymous
-	 * list */
-	new_cur_id = rohc_list_get_nearest_list(comp, &pkt_list, &is_new_list);
+	 * list: if the list of the previous packet is reused and it is the
+	 * reference list, no other list may match better */
+	if(is_same_list && comp->cur_id != ROHC_LIST_GEN_ID_NONE &&
+	   comp->cur_id == comp->ref_id)
+	{
+		rc_list_debug(comp, "send reference list with gen_id = %u again",
+		              comp->ref_id);
+		new_cur_id = comp->ref_id;
+	}
+	else
+	{
+		new_cur_id = rohc_list_get_nearest_list(comp, &pkt_list, &is_new_list);
+	}
 	if(is_new_list)
 	{
 		/* TODO: context should not be overwritten until compression is fully OK */
@@ -218,15 +240,19 @@ error:
  *  \li update the related entries in the translation table,
  *  \li create the list for the packet
  *
- * @param comp           The list compressor
- * @param ip             The IP packet to compress
- * @param[out] pkt_list  The list of extension headers for the current packet
- * @return               true if no error occurred,
- *                       false if one error occurred
+ * @param comp               The list compressor
+ * @param ip                 The IP packet to compress
+ * @param[out] pkt_list      The list of extension headers for the current
+ *                           packet
+ * @param[out] is_same_list  Whether the list is the one of the previous
+ *                           packet
+ * @return                   true if no error occurred,
+ *                           false if one error occurred
  */
 static bool build_ipv6_ext_pkt_list(struct list_comp *const comp,
                                     const struct ip_packet *const ip,
-                                    struct rohc_list *const pkt_list)
+                                    struct rohc_list *const pkt_list,
+                                    bool *const is_same_list)
 {
 	uint8_t ext_types_count[ROHC_IPPROTO_MAX + 1] = { 0 };
 	const uint8_t *ext;
@@ -235,6 +261,15 @@ static bool build_ipv6_ext_pkt_list(struct list_comp *const comp,
 	/* reset the list of the current packet */
 	rohc_list_reset(pkt_list);
 
+	/* the extension headers are probably the same as in the previous packet */
+	*is_same_list = rohc_list_reuse_pkt_list(comp, ip, pkt_list);
+	if(*is_same_list)
+	{
+		rc_list_debug(comp, "the %zu IPv6 extension(s) are the same as in the "
+		              "previous packet", pkt_list->items_nr);
+		return true;
+	}
+
 	/* get the next known IP extension in packet */
 	ext = ip_get_next_ext_from_ip(ip, &ext_type);
 	if(ext == NULL)
@@ -317,12 +352,77 @@ static bool build_ipv6_ext_pkt_list(struct list_comp *const comp,
 	}
 
 skip:
+	/* remember the list for the next packet */
+	comp->last_pkt_list.items_nr = pkt_list->items_nr;
+	memcpy(comp->last_pkt_list.items, pkt_list->items,
+	       pkt_list->items_nr * sizeof(struct rohc_list_item *));
+	comp->last_pkt_exts_len = ip_get_exts_len(ip);
 	return true;
 error:
 	return false;
 }
 
 
+/**
+ * @brief Reuse the list of the previous packet if the extensions are the same
+ *
+ * The total length of the extension headers of the packet, already known
+ * from the parsing of the packet, is compared first with the one of the
+ * previous packet: a changed list is most of the time detected without
+ * reading the extension headers at all. The extension headers are then
+ * compared with the items of the list of the previous packet, in the
+ * translation table. If all of them are equal, the list of the previous
+ * packet is the list of the packet: the translation table is not looked up
+ * nor updated.
+ *
+ * @param comp           The list compressor
+ * @param ip             The IP packet to compress
+ * @param[out] pkt_list  The list of extension headers for the current packet
+ * @return               true if the list of the previous packet was reused,
+ *                       false if the list shall be built again
+ */
+static bool rohc_list_reuse_pkt_list(const struct list_comp *const comp,
+                                     const struct ip_packet *const ip,
+                                     struct rohc_list *const pkt_list)
+{
+	const struct rohc_list *const last_list = &comp->last_pkt_list;
+	const uint8_t *ext;
+	uint8_t ext_type;
+	size_t i;
+
+	/* the extensions shall take as many bytes as the items of the previous list */
+	if(ip_get_exts_len(ip) != comp->last_pkt_exts_len)
+	{
+		goto not_same;
+	}
+
+	/* the items of the previous list and the extensions shall be of the same
+	 * types, in the same order, so they use the same translation entries */
+	ext = ip_get_next_ext_from_ip(ip, &ext_type);
+	for(i = 0; i < last_list->items_nr; i++)
+	{
+		if(ext == NULL ||
+		   !comp->cmp_item(last_list->items[i], ext_type, ext, comp->get_size(ext)))
+		{
+			goto not_same;
+		}
+		ext = ip_get_next_ext_from_ext(ext, &ext_type);
+	}
+	if(ext != NULL)
+	{
+		goto not_same;
+	}
+
+	pkt_list->items_nr = last_list->items_nr;
+	memcpy(pkt_list->items, last_list->items,
+	       last_list->items_nr * sizeof(struct rohc_list_item *));
+	return true;
+
+not_same:
+	return false;
+}
+
+
 /**
  * @brief Generic encoding of compressed list
  *
@@ -453,6 +553,26 @@ void rohc_list_update_context(struct list_comp *const comp)
 }
 
 
+/**
+ * @brief Whether the empty list is the reference list and the current one
+ *
+ * If so, a packet without any extension header changes nothing in the list
+ * compressor: \ref detect_ipv6_ext_changes would find that the list did not
+ * change and \ref rohc_list_update_context would do nothing.
+ *
+ * @param comp  The list compressor
+ * @return      true if the empty list is the reference and current list,
+ *              false otherwise
+ */
+bool rohc_list_is_empty_ref(const struct list_comp *const comp)
+{
+	return (comp->ref_id != ROHC_LIST_GEN_ID_NONE &&
+	        comp->cur_id == comp->ref_id &&
+	        comp->lists[comp->ref_id].items_nr == 0 &&
+	        comp->lists[comp->ref_id].counter >= comp->list_trans_nr);
+}
+
+
 /**
  * @brief Search the nearest list for the packet list
  *
@@ -758,7 +878,6 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
                                    uint8_t *const dest,
                                    int counter)
 {
-	uint8_t ext_types_count[ROHC_IPPROTO_MAX + 1] = { 0 };
 	const uint8_t et = 0; /* list encoding type 0 */
 	uint8_t gp;
 	size_t m; /* the number of elements in current list = number of XIs */
@@ -778,10 +897,7 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
 		uint8_t ins_mask[ROHC_LIST_ITEMS_MAX] = { 1 };
 
 		ps = rohc_list_compute_ps(comp, &(comp->lists[comp->cur_id]), ins_mask, m);
-		if(ps != 0 && ps != 1)
-		{
-			goto error;
-		}
+		assert(ps == 0 || ps == 1);
 	}
 
 	/* part 1: ET, GP, PS, CC */
@@ -814,18 +930,8 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
 			const struct rohc_list_item *const item = comp->lists[comp->cur_id].items[k];
 			int index_table;
 
-			/* one more occurrence of this item */
-			if(ext_types_count[item->type] >= 255)
-			{
-				rohc_comp_list_warn(comp, "too many IPv6 extension header of type 0x%02x",
-				                    item->type);
-				goto error;
-			}
-			ext_types_count[item->type]++;
-
-			index_table = comp->get_index_table(item->type, ext_types_count[item->type]);
-			assert(index_table >= 0);
-			assert(((size_t) index_table) < ROHC_LIST_MAX_ITEM);
+			/* the item index is its position in the translation table */
+			index_table = rohc_list_get_item_index(comp, item);
 
 			dest[counter] = 0;
 			/* set the X bit if item is not already known */
@@ -851,18 +957,8 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
 			const struct rohc_list_item *const item = comp->lists[comp->cur_id].items[k];
 			int index_table;
 
-			/* one more occurrence of this item */
-			if(ext_types_count[item->type] >= 255)
-			{
-				rohc_comp_list_warn(comp, "too many IPv6 extension header of type 0x%02x",
-				                    item->type);
-				goto error;
-			}
-			ext_types_count[item->type]++;
-
-			index_table = comp->get_index_table(item->type, ext_types_count[item->type]);
-			assert(index_table >= 0);
-			assert(((size_t) index_table) < ROHC_LIST_MAX_ITEM);
+			/* the item index is its position in the translation table */
+			index_table = rohc_list_get_item_index(comp, item);
 
 			dest[counter] = 0;
 
@@ -886,19 +982,8 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
 					comp->lists[comp->cur_id].items[k + 1];
 				int index_table2;
 
-				/* one more occurrence of this item */
-				if(ext_types_count[item2->type] >= 255)
-				{
-					rohc_comp_list_warn(comp, "too many IPv6 extension header of type "
-					                    "0x%02x", item2->type);
-					goto error;
-				}
-				ext_types_count[item2->type]++;
-
-				index_table2 =
-					comp->get_index_table(item2->type, ext_types_count[item2->type]);
-				assert(index_table2 >= 0);
-				assert(((size_t) index_table2) < ROHC_LIST_MAX_ITEM);
+				/* the item index is its position in the translation table */
+				index_table2 = rohc_list_get_item_index(comp, item2);
 
 				/* set the X bit if item is not already known */
 				if(!item2->known)
@@ -939,9 +1024,6 @@ static int rohc_list_encode_type_0(struct list_comp *const comp,
 	}
 
 	return counter;
-
-error:
-	return -1;
 }
 
 
@@ -1083,10 +1165,7 @@ static int rohc_list_encode_type_1(struct list_comp *const comp,
 
 	/* determine whether we should use 4-bit or 8-bit indexes */
 	ps = rohc_list_compute_ps(comp, &(comp->lists[comp->cur_id]), ins_mask, m);
-	if(ps != 0 && ps != 1)
-	{
-		goto error;
-	}
+	assert(ps == 0 || ps == 1);
 
 	/* part 5: k XI (= X + Indexes) */
 	{
@@ -1424,10 +1503,7 @@ static int rohc_list_encode_type_3(struct list_comp *const comp,
 
 	/* determine whether we should use 4-bit or 8-bit indexes */
 	ps = rohc_list_compute_ps(comp, &(comp->lists[comp->cur_id]), ins_mask, m);
-	if(ps != 0 && ps != 1)
-	{
-		goto error;
-	}
+	assert(ps == 0 || ps == 1);
 
 	/* part 6: k XI (= X + Indexes) */
 	{
@@ -1738,15 +1814,13 @@ error:
  * @param mask  The insertion mask for the list
  * @param m     The number of elements in current list
  * @return      0 for 4-bit indexes,
- *              1 for 8-bit indexes,
- *              2 for error
+ *              1 for 8-bit indexes
  */
 static uint8_t rohc_list_compute_ps(const struct list_comp *const comp,
                                     const struct rohc_list *const list,
                                     const uint8_t mask[ROHC_LIST_ITEMS_MAX],
                                     const size_t m)
 {
-	uint8_t ext_types_count[ROHC_IPPROTO_MAX + 1] = { 0 };
 	uint8_t ps = 0; /* 4-bit indexes by default */
 	size_t k;
 
@@ -1755,24 +1829,8 @@ static uint8_t rohc_list_compute_ps(const struct list_comp *const comp,
 		const struct rohc_list_item *const item = list->items[k];
 		int index_table;
 
-		/* one more occurrence of this item */
-		if(ext_types_count[item->type] >= 255)
-		{
-			rohc_comp_list_warn(comp, "too many IPv6 extension header of type 0x%02x",
-			                    item->type);
-			goto error;
-		}
-		ext_types_count[item->type]++;
-
-		/* get the index corresponding to the item type and the number of
-		 * occurrences */
-		index_table = comp->get_index_table(item->type, ext_types_count[item->type]);
-		if(index_table < 0 || ((size_t) index_table) >= ROHC_LIST_MAX_ITEM)
-		{
-			rohc_comp_list_warn(comp, "failed to handle unknown IPv6 extension "
-			                    "header of type 0x%02x", item->type);
-			goto error;
-		}
+		/* the item index is its position in the translation table */
+		index_table = rohc_list_get_item_index(comp, item);
 
 		if((mask[k] != 0 || !item->known) && index_table > 0x07)
 		{
@@ -1781,9 +1839,6 @@ static uint8_t rohc_list_compute_ps(const struct list_comp *const comp,
 	}
 
 	return ps;
-
-error:
-	return 2;
 }
 
 
@@ -1837,7 +1892,6 @@ static int rohc_list_build_XIs_8(const struct list_comp *const comp,
                                  uint8_t *const rohc_data,
                                  const size_t rohc_max_len)
 {
-	uint8_t ext_types_count[ROHC_IPPROTO_MAX + 1] = { 0 };
 	const size_t m = list->items_nr;
 	size_t xi_len = 0;
 	size_t k;
@@ -1849,18 +1903,8 @@ static int rohc_list_build_XIs_8(const struct list_comp *const comp,
 		const struct rohc_list_item *const item = list->items[k];
 		int index_table;
 
-		/* one more occurrence of this item */
-		if(ext_types_count[item->type] >= 255)
-		{
-			rohc_comp_list_warn(comp, "too many IPv6 extension header of type 0x%02x",
-			                    item->type);
-			goto error;
-		}
-		ext_types_count[item->type]++;
-
-		index_table = comp->get_index_table(item->type, ext_types_count[item->type]);
-		assert(index_table >= 0);
-		assert(((size_t) index_table) < ROHC_LIST_MAX_ITEM);
+		/* the item index is its position in the translation table */
+		index_table = rohc_list_get_item_index(comp, item);
 
 		/* skip element if it present in the reference list and compressor
 		 * is confident that item is known by decompressor */
@@ -1920,7 +1964,6 @@ static int rohc_list_build_XIs_4(const struct list_comp *const comp,
                                  const size_t rohc_max_len,
                                  uint8_t *const first_4b_xi)
 {
-	uint8_t ext_types_count[ROHC_IPPROTO_MAX + 1] = { 0 };
 	const size_t m = list->items_nr;
 	size_t xi_index = 0;
 	size_t xi_len = 0;
@@ -1933,18 +1976,8 @@ static int rohc_list_build_XIs_4(const struct list_comp *const comp,
 		const struct rohc_list_item *const item = list->items[k];
 		int index_table;
 
-		/* one more occurrence of this item */
-		if(ext_types_count[item->type] >= 255)
-		{
-			rohc_comp_list_warn(comp, "too many IPv6 extension header of type 0x%02x",
-			                    item->type);
-			goto error;
-		}
-		ext_types_count[item->type]++;
-
-		index_table = comp->get_index_table(item->type, ext_types_count[item->type]);
-		assert(index_table >= 0);
-		assert(((size_t) index_table) < ROHC_LIST_MAX_ITEM);
+		/* the item index is its position in the translation table */
+		index_table = rohc_list_get_item_index(comp, item);
 
 		/* skip element if it present in the reference list and compressor
 		 * is confident that item is known by decompressor */
@@ -2039,3 +2072,26 @@ error:
 	return -1;
 }
 
+
+
+/**
+ * @brief Get the index of the given item in the translation table
+ *
+ * The items of the lists always point to entries of the translation table,
+ * so the index of one item is its position in the table. It is the same
+ * index as the one computed from the item type and its number of occurrences
+ * when the list was built.
+ *
+ * @param comp  The list compressor
+ * @param item  The list item to get the index for
+ * @return      The index of the item in the translation table
+ */
+static size_t rohc_list_get_item_index(const struct list_comp *const comp,
+                                       const struct rohc_list_item *const item)
+{
+	const size_t index_table = item - comp->trans_table;
+
+	assert(index_table < ROHC_LIST_MAX_ITEM);
+
+	return index_table;
+}
@@ -53,6 +53,12 @@ struct list_comp
 	unsigned int cur_id; /* TODO: should not be overwritten until compression
 	                              is fully OK */
 
+	/** The list of the previous packet, reused as long as the extension
+	 *  headers of the next packets do not change */
+	struct rohc_list last_pkt_list;
+	/** The length of the extension headers of the previous packet */
+	size_t last_pkt_exts_len;
+
 	/** The number of uncompressed transmissions for list compression (L) */
 	size_t list_trans_nr;
 
@@ -93,5 +99,8 @@ int rohc_list_encode(struct list_comp *const comp,
 void rohc_list_update_context(struct list_comp *const comp)
 	__attribute__((nonnull(1)));
 
+bool rohc_list_is_empty_ref(const struct list_comp *const comp)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
 #endif
 
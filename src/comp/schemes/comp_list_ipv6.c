@@ -73,6 +73,8 @@ void rohc_comp_list_ipv6_new(struct list_comp *const comp,
 	{
 		rohc_list_item_reset(&comp->trans_table[i]);
 	}
+	rohc_list_reset(&comp->last_pkt_list);
+	comp->last_pkt_exts_len = 0;
 
 	comp->list_trans_nr = list_trans_nr;
 
@@ -28,6 +28,8 @@
 #include "comp_scaled_rtp_ts.h"
 #include "sdvl.h"
 #include "rohc_traces_internal.h"
+#include "rohc_time_internal.h"
+#include "rohc_utils.h"
 
 #include <stdlib.h> /* for abs(3) */
 #include <assert.h>
@@ -39,19 +41,55 @@
 	           format, ##__VA_ARGS__)
 
 
+/*
+ * Private function prototypes
+ */
+
+static void c_ts_sc_update_state(struct ts_sc_comp *const ts_sc,
+                                 const uint32_t ts,
+                                 const uint16_t sn)
+	__attribute__((nonnull(1)));
+
+static void c_ts_sc_set_stride(struct ts_sc_comp *const ts_sc,
+                               const uint32_t ts_stride)
+	__attribute__((nonnull(1)));
+
+static inline uint32_t c_ts_sc_div_stride(const struct ts_sc_comp *const ts_sc,
+                                          const uint32_t value)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static void c_ts_sc_update_timer(struct ts_sc_comp *const ts_sc)
+	__attribute__((nonnull(1)));
+
+static void c_ts_sc_add_timer_ref(struct ts_sc_comp *const ts_sc)
+	__attribute__((nonnull(1)));
+
+static size_t c_ts_sc_timer_bits(const struct ts_sc_comp *const ts_sc)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+
 /**
  * @brief Create the ts_sc_comp object
  *
  * @param ts_sc              The ts_sc_comp object to create
+ * @param slab               The slab to allocate the W-LSB windows from,
+ *                           may be NULL to allocate them from the heap
  * @param wlsb_window_width  The width of the W-LSB sliding window to use
  *                           for TS_STRIDE (must be > 0)
+ * @param is_timer_enabled   Whether the timer-based compression of TS may
+ *                           be used or not
+ * @param max_jitter_cd      The max jitter between compressor and
+ *                           decompressor (in milliseconds)
  * @param trace_cb           The trace callback
  * @param trace_cb_priv      An optional private context for the trace
  *                           callback, may be NULL
  * @return                   true if creation is successful, false otherwise
  */
 bool c_create_sc(struct ts_sc_comp *const ts_sc,
+                 struct rohc_slab *const slab,
                  const size_t wlsb_window_width,
+                 const bool is_timer_enabled,
+                 const size_t max_jitter_cd,
                  rohc_trace_callback2_t trace_cb,
                  void *const trace_cb_priv)
 {
@@ -59,6 +97,8 @@ bool c_create_sc(struct ts_sc_comp *const ts_sc,
 	assert(wlsb_window_width > 0);
 
 	ts_sc->ts_stride = 0;
+	ts_sc->ts_stride_mult = 0;
+	ts_sc->ts_stride_shift = 0;
 	ts_sc->ts_scaled = 0;
 	ts_sc->ts_offset = 0;
 	ts_sc->old_ts = 0;
@@ -70,12 +110,25 @@ bool c_create_sc(struct ts_sc_comp *const ts_sc,
 	ts_sc->state = INIT_TS;
 	ts_sc->are_old_val_init = false;
 	ts_sc->nr_init_stride_packets = 0;
+	ts_sc->ts_unscaled_missing_nr = 0;
+
+	ts_sc->is_timer_enabled = is_timer_enabled;
+	ts_sc->max_jitter_cd = rohc_min(max_jitter_cd, UINT32_MAX);
+	ts_sc->time_stride = 0;
+	ts_sc->arrival = 0;
+	ts_sc->old_arrival = 0;
+	ts_sc->is_arrival_known = false;
+	ts_sc->is_old_arrival_known = false;
+	ts_sc->timer_refs = NULL;
+	ts_sc->timer_refs_max = 0;
+	ts_sc->timer_refs_nr = 0;
+	ts_sc->timer_refs_next = 0;
 
 	ts_sc->trace_callback = trace_cb;
 	ts_sc->trace_callback_priv = trace_cb_priv;
 
 	/* W-LSB context for TS_SCALED */
-	ts_sc->ts_scaled_wlsb = c_create_wlsb(32, wlsb_window_width,
+	ts_sc->ts_scaled_wlsb = c_create_wlsb(slab, 32, wlsb_window_width,
 	                                      ROHC_LSB_SHIFT_RTP_TS);
 	if(ts_sc->ts_scaled_wlsb == NULL)
 	{
@@ -85,7 +138,7 @@ bool c_create_sc(struct ts_sc_comp *const ts_sc,
 	}
 
 	/* W-LSB context for unscaled TS */
-	ts_sc->ts_unscaled_wlsb = c_create_wlsb(32, wlsb_window_width,
+	ts_sc->ts_unscaled_wlsb = c_create_wlsb(slab, 32, wlsb_window_width,
 	                                        ROHC_LSB_SHIFT_RTP_TS);
 	if(ts_sc->ts_unscaled_wlsb == NULL)
 	{
@@ -94,8 +147,25 @@ bool c_create_sc(struct ts_sc_comp *const ts_sc,
 		goto free_ts_scaled_wlsb;
 	}
 
+	/* references for the timer-based compression of TS, one per packet
+	 * that the decompressor may use as reference */
+	if(is_timer_enabled)
+	{
+		ts_sc->timer_refs =
+			rohc_slab_alloc(slab, sizeof(struct ts_sc_timer_ref) * wlsb_window_width);
+		if(ts_sc->timer_refs == NULL)
+		{
+			rohc_error(ts_sc, ROHC_TRACE_COMP, ROHC_PROFILE_GENERAL,
+			           "cannot create the references for timer-based compression");
+			goto free_ts_unscaled_wlsb;
+		}
+		ts_sc->timer_refs_max = wlsb_window_width;
+	}
+
 	return true;
 
+free_ts_unscaled_wlsb:
+	c_destroy_wlsb(ts_sc->ts_unscaled_wlsb);
 free_ts_scaled_wlsb:
 	c_destroy_wlsb(ts_sc->ts_scaled_wlsb);
 error:
@@ -115,19 +185,86 @@ void c_destroy_sc(struct ts_sc_comp *const ts_sc)
 	assert(ts_sc->ts_scaled_wlsb != NULL);
 	c_destroy_wlsb(ts_sc->ts_unscaled_wlsb);
 	c_destroy_wlsb(ts_sc->ts_scaled_wlsb);
+	if(ts_sc->timer_refs != NULL)
+	{
+		rohc_slab_free(ts_sc->timer_refs);
+	}
+}
+
+
+/**
+ * @brief Get the maximum length one ts_sc_comp object takes in a memory block
+ *
+ * The references for the timer-based compression are always counted.
+ *
+ * @param wlsb_window_width  The width of the W-LSB sliding window
+ * @return                   The maximum number of bytes of the memory block
+ *                           the object takes
+ */
+size_t c_sc_mem_max(const size_t wlsb_window_width)
+{
+	return (2 * c_wlsb_mem_max(1, wlsb_window_width) +
+	        rohc_slab_block_mem_max(sizeof(struct ts_sc_timer_ref) *
+	                                wlsb_window_width));
 }
 
 
 /**
  * @brief Store the new TS, calculate new values and update the state
  *
+ * Only the W-LSB window of the values sent in the current state is updated
+ * for every packet: in state SEND_SCALED, the unscaled TS values are added
+ * to their W-LSB window from the TS_SCALED ones when the state is left.
+ *
+ * @param ts_sc         The ts_sc_comp object
+ * @param ts            The timestamp to add
+ * @param sn            The sequence number of the RTP packet
+ * @param arrival_time  The arrival time of the RTP packet, zero if unknown
+ */
+void c_add_ts(struct ts_sc_comp *const ts_sc,
+              const uint32_t ts,
+              const uint16_t sn,
+              const struct rohc_ts arrival_time)
+{
+	/* TS_STRIDE and TS_OFFSET of the TS_SCALED values not added as unscaled
+	 * TS values yet: they do not change while in state SEND_SCALED */
+	const uint32_t ts_stride = ts_sc->ts_stride;
+	const uint32_t ts_offset = ts_sc->ts_offset;
+
+	/* record the arrival time for timer-based compression */
+	ts_sc->old_arrival = ts_sc->arrival;
+	ts_sc->is_old_arrival_known = ts_sc->is_arrival_known;
+	ts_sc->arrival = rohc_time_ms(arrival_time);
+	ts_sc->is_arrival_known = rohc_time_is_known(arrival_time);
+
+	c_ts_sc_update_state(ts_sc, ts, sn);
+
+	if(ts_sc->is_timer_enabled)
+	{
+		c_ts_sc_update_timer(ts_sc);
+	}
+
+	if(ts_sc->state != SEND_SCALED && ts_sc->ts_unscaled_missing_nr > 0)
+	{
+		ts_debug(ts_sc, "add the %zu unscaled TS values sent as TS_SCALED "
+		         "to the unscaled W-LSB window", ts_sc->ts_unscaled_missing_nr);
+		c_add_wlsb_unscaled(ts_sc->ts_unscaled_wlsb, ts_sc->ts_scaled_wlsb,
+		                    ts_sc->ts_unscaled_missing_nr, ts_stride, ts_offset);
+		ts_sc->ts_unscaled_missing_nr = 0;
+	}
+}
+
+
+/**
+ * @brief Calculate the new TS values and update the state
+ *
  * @param ts_sc        The ts_sc_comp object
  * @param ts           The timestamp to add
  * @param sn           The sequence number of the RTP packet
  */
-void c_add_ts(struct ts_sc_comp *const ts_sc,
-              const uint32_t ts,
-              const uint16_t sn)
+static void c_ts_sc_update_state(struct ts_sc_comp *const ts_sc,
+                                 const uint32_t ts,
+                                 const uint16_t sn)
 {
 	uint16_t sn_delta;
 
@@ -211,23 +348,26 @@ void c_add_ts(struct ts_sc_comp *const ts_sc,
 		 * not transmitted enough times to the decompressor to be used */
 		ts_debug(ts_sc, "state INIT_STRIDE");
 
-		/* reset INIT_STRIDE counter if TS_STRIDE/TS_OFFSET changed */
-		if(ts_sc->ts_delta != ts_sc->ts_stride ||
-		   (ts_sc->ts % ts_sc->ts_delta) != ts_sc->ts_offset)
+		/* compute TS_STRIDE */
+		if(ts_sc->ts_delta != ts_sc->ts_stride)
 		{
-			ts_debug(ts_sc, "TS_STRIDE and/or TS_OFFSET changed");
+			ts_debug(ts_sc, "TS_STRIDE changed");
 			ts_sc->nr_init_stride_packets = 0;
+			c_ts_sc_set_stride(ts_sc, ts_sc->ts_delta);
 		}
-
-		/* compute TS_STRIDE, TS_OFFSET and TS_SCALED */
-		ts_sc->ts_stride = ts_sc->ts_delta;
 		ts_debug(ts_sc, "TS_STRIDE = %u", ts_sc->ts_stride);
-		assert(ts_sc->ts_stride != 0);
-		ts_sc->ts_offset = ts_sc->ts % ts_sc->ts_stride;
+
+		/* compute TS_SCALED and TS_OFFSET, reset INIT_STRIDE counter if
+		 * TS_OFFSET changed */
+		ts_sc->ts_scaled = c_ts_sc_div_stride(ts_sc, ts_sc->ts);
+		if((ts_sc->ts - ts_sc->ts_scaled * ts_sc->ts_stride) != ts_sc->ts_offset)
+		{
+			ts_debug(ts_sc, "TS_OFFSET changed");
+			ts_sc->nr_init_stride_packets = 0;
+			ts_sc->ts_offset = ts_sc->ts - ts_sc->ts_scaled * ts_sc->ts_stride;
+		}
 		ts_debug(ts_sc, "TS_OFFSET = %u modulo %u = %u",
 		         ts_sc->ts, ts_sc->ts_stride, ts_sc->ts_offset);
-		assert(ts_sc->ts_stride != 0);
-		ts_sc->ts_scaled = (ts_sc->ts - ts_sc->ts_offset) / ts_sc->ts_stride;
 		ts_debug(ts_sc, "TS_SCALED = (%u - %u) / %u = %u", ts_sc->ts,
 		         ts_sc->ts_offset, ts_sc->ts_stride, ts_sc->ts_scaled);
 	}
@@ -245,8 +385,10 @@ void c_add_ts(struct ts_sc_comp *const ts_sc,
 		ts_debug(ts_sc, "previous TS_STRIDE = %u", ts_sc->ts_stride);
 		if(ts_sc->ts_delta != ts_sc->ts_stride)
 		{
-			assert(ts_sc->ts_stride != 0);
-			if((ts_sc->ts_delta % ts_sc->ts_stride) != 0)
+			const uint32_t ts_delta_scaled =
+				c_ts_sc_div_stride(ts_sc, ts_sc->ts_delta);
+
+			if((ts_sc->ts_delta - ts_delta_scaled * ts_sc->ts_stride) != 0)
 			{
 				/* TS delta changed and is not a multiple of previous TS_STRIDE:
 				 * record the new value as TS_STRIDE and transmit it several
@@ -258,9 +400,9 @@ void c_add_ts(struct ts_sc_comp *const ts_sc,
 				ts_sc->state = INIT_STRIDE;
 				ts_sc->nr_init_stride_packets = 0;
 				ts_debug(ts_sc, "state -> INIT_STRIDE");
-				ts_sc->ts_stride = ts_sc->ts_delta;
+				c_ts_sc_set_stride(ts_sc, ts_sc->ts_delta);
 			}
-			else if((ts_sc->ts_delta / ts_sc->ts_stride) != sn_delta)
+			else if(ts_delta_scaled != sn_delta)
 			{
 				/* TS delta changed but is a multiple of previous TS_STRIDE:
 				 * do not change TS_STRIDE, but transmit all TS bits several
@@ -283,15 +425,11 @@ void c_add_ts(struct ts_sc_comp *const ts_sc,
 		}
 		ts_debug(ts_sc, "TS_STRIDE = %u", ts_sc->ts_stride);
 
-		/* update TS_OFFSET is needed */
-		assert(ts_sc->ts_stride != 0);
-		ts_sc->ts_offset = ts_sc->ts % ts_sc->ts_stride;
+		/* compute TS_SCALED and update TS_OFFSET if needed */
+		ts_sc->ts_scaled = c_ts_sc_div_stride(ts_sc, ts_sc->ts);
+		ts_sc->ts_offset = ts_sc->ts - ts_sc->ts_scaled * ts_sc->ts_stride;
 		ts_debug(ts_sc, "TS_OFFSET = %u modulo %u = %u",
 		         ts_sc->ts, ts_sc->ts_stride, ts_sc->ts_offset);
-
-		/* compute TS_SCALED */
-		assert(ts_sc->ts_stride != 0);
-		ts_sc->ts_scaled = (ts_sc->ts - ts_sc->ts_offset) / ts_sc->ts_stride;
 		ts_debug(ts_sc, "TS_SCALED = (%u - %u) / %u = %u", ts_sc->ts,
 		         ts_sc->ts_offset, ts_sc->ts_stride, ts_sc->ts_scaled);
 
@@ -371,6 +509,199 @@ void c_add_ts(struct ts_sc_comp *const ts_sc,
 }
 
 
+/**
+ * @brief Set TS_STRIDE and the parameters to divide by TS_STRIDE
+ *
+ * The division by TS_STRIDE is computed as a multiplication and shifts by
+ * c_ts_sc_div_stride(). The parameters are computed once per TS_STRIDE, see
+ * T. Granlund and P. L. Montgomery, "Division by Invariant Integers using
+ * Multiplication", figure 4.1.
+ *
+ * @param ts_sc      The ts_sc_comp object
+ * @param ts_stride  The new TS_STRIDE value (must be > 0)
+ */
+static void c_ts_sc_set_stride(struct ts_sc_comp *const ts_sc,
+                               const uint32_t ts_stride)
+{
+	/* shift = ceil(log2(TS_STRIDE)) */
+	const uint8_t shift =
+		(ts_stride <= 1 ? 0 : (32 - __builtin_clz(ts_stride - 1)));
+
+	assert(ts_stride != 0);
+
+	ts_sc->ts_stride = ts_stride;
+	ts_sc->ts_stride_shift = shift;
+	ts_sc->ts_stride_mult =
+		((((uint64_t) 1 << shift) - ts_stride) << 32) / ts_stride + 1;
+
+	/* TS_SCALED values computed with the previous TS_STRIDE cannot be used
+	 * as references for timer-based compression */
+	ts_sc->timer_refs_nr = 0;
+}
+
+
+/**
+ * @brief Update TIME_STRIDE for the timer-based compression of TS
+ *
+ * TIME_STRIDE is the time interval (in milliseconds) that matches one
+ * TS_STRIDE. It is computed from the arrival times of the first packets
+ * with a new TS_STRIDE and then transmitted with TS_STRIDE, so that the
+ * decompressor may approximate TS_SCALED from the arrival times of the
+ * packets. See section 4.5.4 of RFC 3095 for details.
+ *
+ * A packet without arrival time stops the use of the timer-based compression
+ * until TIME_STRIDE is transmitted again.
+ *
+ * @param ts_sc  The ts_sc_comp object
+ */
+static void c_ts_sc_update_timer(struct ts_sc_comp *const ts_sc)
+{
+	if(ts_sc->state == INIT_TS)
+	{
+		ts_sc->time_stride = 0;
+		ts_sc->timer_refs_nr = 0;
+	}
+	else if(ts_sc->state == SEND_SCALED)
+	{
+		if(ts_sc->time_stride != 0 && !ts_sc->is_arrival_known)
+		{
+			ts_debug(ts_sc, "arrival time of packet is unknown, disable "
+			         "timer-based compression: go in INIT_STRIDE state");
+			ts_sc->state = INIT_STRIDE;
+			ts_sc->nr_init_stride_packets = 0;
+			ts_sc->time_stride = 0;
+			ts_sc->timer_refs_nr = 0;
+		}
+	}
+	else if(ts_sc->nr_init_stride_packets == 0)
+	{
+		uint32_t time_stride = 0;
+
+		assert(ts_sc->state == INIT_STRIDE);
+		assert(ts_sc->ts_delta != 0);
+
+		/* TIME_STRIDE = elapsed time * TS_STRIDE / TS delta, rounded */
+		if(ts_sc->is_arrival_known && ts_sc->is_old_arrival_known)
+		{
+			const uint64_t elapsed = (uint32_t) (ts_sc->arrival - ts_sc->old_arrival);
+			const uint64_t stride =
+				(elapsed * ts_sc->ts_stride + ts_sc->ts_delta / 2) / ts_sc->ts_delta;
+
+			if(stride <= UINT32_MAX && sdvl_can_value_be_encoded(stride))
+			{
+				time_stride = stride;
+			}
+		}
+		if(time_stride != ts_sc->time_stride)
+		{
+			ts_sc->time_stride = time_stride;
+			ts_sc->timer_refs_nr = 0;
+		}
+		ts_debug(ts_sc, "TIME_STRIDE = %u ms", ts_sc->time_stride);
+	}
+}
+
+
+/**
+ * @brief Record the current packet as reference for timer-based compression
+ *
+ * @param ts_sc  The ts_sc_comp object
+ */
+static void c_ts_sc_add_timer_ref(struct ts_sc_comp *const ts_sc)
+{
+	if(!ts_sc->is_timer_enabled || ts_sc->state == INIT_TS ||
+	   ts_sc->time_stride == 0 || !ts_sc->is_arrival_known)
+	{
+		return;
+	}
+	assert(ts_sc->timer_refs != NULL);
+
+	ts_sc->timer_refs[ts_sc->timer_refs_next].ts_scaled = ts_sc->ts_scaled;
+	ts_sc->timer_refs[ts_sc->timer_refs_next].arrival = ts_sc->arrival;
+	ts_sc->timer_refs_next = (ts_sc->timer_refs_next + 1) % ts_sc->timer_refs_max;
+	if(ts_sc->timer_refs_nr < ts_sc->timer_refs_max)
+	{
+		ts_sc->timer_refs_nr++;
+	}
+}
+
+
+/**
+ * @brief Return the number of TS_SCALED bits required by timer-based
+ *        compression
+ *
+ * The decompressor approximates TS_SCALED from the arrival time of the
+ * packet and from one of the packets it received before. The interpretation
+ * interval must cover the jitter between the source and the compressor
+ * computed with every reference that the decompressor may use, the jitter
+ * between the compressor and the decompressor, and the rounding errors:
+ *   J = Max_Jitter_BC + Max_Jitter_CD + 2
+ *   k = ceil(log2(2 * J + 1))
+ *
+ * @param ts_sc  The ts_sc_comp object
+ * @return       The number of TS_SCALED bits to transmit
+ */
+static size_t c_ts_sc_timer_bits(const struct ts_sc_comp *const ts_sc)
+{
+	uint64_t max_jitter = 0;
+	uint64_t jitter;
+	size_t i;
+
+	assert(ts_sc->time_stride != 0);
+
+	if(ts_sc->timer_refs_nr == 0)
+	{
+		return 32;
+	}
+
+	/* Max_Jitter_BC */
+	for(i = 0; i < ts_sc->timer_refs_nr; i++)
+	{
+		const struct ts_sc_timer_ref *const ref = &ts_sc->timer_refs[i];
+		const int32_t elapsed = (int32_t) (ts_sc->arrival - ref->arrival);
+		const int32_t approx_delta = elapsed / (int32_t) ts_sc->time_stride;
+		const int32_t real_delta = (int32_t) (ts_sc->ts_scaled - ref->ts_scaled);
+
+		const int64_t diff = ((int64_t) real_delta) - approx_delta;
+
+		jitter = (diff >= 0 ? diff : -diff);
+		if(jitter > max_jitter)
+		{
+			max_jitter = jitter;
+		}
+	}
+
+	/* Max_Jitter_CD in TS_SCALED units, plus the rounding errors */
+	jitter = max_jitter +
+	         (ts_sc->max_jitter_cd + ts_sc->time_stride - 1) / ts_sc->time_stride +
+	         2;
+
+	return rohc_min(64 - __builtin_clzll(2 * jitter), 32);
+}
+
+
+/**
+ * @brief Divide the given value by TS_STRIDE
+ *
+ * @param ts_sc  The ts_sc_comp object
+ * @param value  The value to divide
+ * @return       The value divided by TS_STRIDE
+ */
+static inline uint32_t c_ts_sc_div_stride(const struct ts_sc_comp *const ts_sc,
+                                          const uint32_t value)
+{
+	const uint32_t t = (((uint64_t) ts_sc->ts_stride_mult) * value) >> 32;
+
+	assert(ts_sc->ts_stride != 0);
+
+	if(ts_sc->ts_stride_shift == 0)
+	{
+		return value;
+	}
+	return (t + ((value - t) >> 1)) >> (ts_sc->ts_stride_shift - 1);
+}
+
+
 /**
  * @brief Return the number of bits needed to encode unscaled TS
  *
@@ -399,16 +730,21 @@ void nb_bits_unscaled(const struct ts_sc_comp *const ts_sc,
  * @param ts_sc  The ts_sc_comp object
  * @param sn     The Sequence Number
  */
-void add_unscaled(const struct ts_sc_comp *const ts_sc, const uint16_t sn)
+void add_unscaled(struct ts_sc_comp *const ts_sc, const uint16_t sn)
 {
 	assert(ts_sc != NULL);
 	c_add_wlsb(ts_sc->ts_unscaled_wlsb, sn, ts_sc->ts);
+	c_ts_sc_add_timer_ref(ts_sc);
 }
 
 
 /**
  * @brief Return the number of bits needed to encode TS_SCALED
  *
+ * If TIME_STRIDE was transmitted to the decompressor, the number of bits is
+ * computed for timer-based compression instead of W-LSB encoding, unless TS
+ * is deducible from SN.
+ *
  * @param ts_sc                           The ts_sc_comp object
  * @param[out] bits_nr_less_equal_than_2  The number of bits needed to encode
  *                                        TS_SCALED in a field that is smaller
@@ -426,6 +762,19 @@ void nb_bits_scaled(const struct ts_sc_comp *const ts_sc,
 	*bits_nr_more_than_2 =
 		wlsb_get_mink_32bits(ts_sc->ts_scaled_wlsb, ts_sc->ts_scaled, 3);
 
+	/* timer-based compression: the decompressor interprets the TS_SCALED bits
+	 * wrt the arrival time of the packet, not wrt the W-LSB reference */
+	if(ts_sc->time_stride != 0 &&
+	   !(ts_sc->is_deducible && (*bits_nr_less_equal_than_2) == 0))
+	{
+		const size_t timer_bits_nr = c_ts_sc_timer_bits(ts_sc);
+		ts_debug(ts_sc, "timer-based compression: %zu bits of TS_SCALED are "
+		         "required", timer_bits_nr);
+		*bits_nr_less_equal_than_2 = timer_bits_nr;
+		*bits_nr_more_than_2 = timer_bits_nr;
+		return;
+	}
+
 	/* do not send 0 bit of TS if TS is not deducible, because decompressor
 	 * will interprets a 0-bit value as deducible */
 	if(!ts_sc->is_deducible)
@@ -448,10 +797,15 @@ void nb_bits_scaled(const struct ts_sc_comp *const ts_sc,
  * @param ts_sc        The ts_sc_comp object
  * @param sn           The Sequence Number
  */
-void add_scaled(const struct ts_sc_comp *const ts_sc, const uint16_t sn)
+void add_scaled(struct ts_sc_comp *const ts_sc, const uint16_t sn)
 {
 	assert(ts_sc != NULL);
 	c_add_wlsb(ts_sc->ts_scaled_wlsb, sn, ts_sc->ts_scaled);
+	c_ts_sc_add_timer_ref(ts_sc);
+
+	/* the unscaled TS value is added to its W-LSB window only when the
+	 * SEND_SCALED state is left, see c_add_ts() */
+	ts_sc->ts_unscaled_missing_nr++;
 }
 
 
@@ -467,6 +821,19 @@ uint32_t get_ts_stride(const struct ts_sc_comp *const ts_sc)
 }
 
 
+/**
+ * @brief Return the TIME_STRIDE value
+ *
+ * @param ts_sc  The ts_sc_comp object
+ * @return       The TIME_STRIDE value (in milliseconds), 0 if timer-based
+ *               compression is not used
+ */
+uint32_t get_time_stride(const struct ts_sc_comp *const ts_sc)
+{
+	return ts_sc->time_stride;
+}
+
+
 /**
  * @brief Return the TS_SCALED value
  *
@@ -33,6 +33,7 @@
 
 #include "comp_wlsb.h"
 #include "rohc_traces.h"
+#include "rohc_time.h"
 
 #ifdef __KERNEL__
 #  include <linux/types.h>
@@ -58,6 +59,19 @@ typedef enum
 } ts_sc_state;
 
 
+/**
+ * @brief One reference for the timer-based compression of RTP Timestamp
+ *
+ * See section 4.5.4 of RFC 3095 for details about timer-based compression
+ * of RTP Timestamp.
+ */
+struct ts_sc_timer_ref
+{
+	uint32_t ts_scaled;  /**< The TS_SCALED value of the packet */
+	uint32_t arrival;    /**< The arrival time of the packet (in ms) */
+};
+
+
 /**
  * @brief Scaled RTP Timestamp encoding object
  *
@@ -68,6 +82,10 @@ struct ts_sc_comp
 {
 	/// The TS_STRIDE value
 	uint32_t ts_stride;
+	/** The multiplier used to divide by TS_STRIDE (see c_add_ts) */
+	uint32_t ts_stride_mult;
+	/** The shift used to divide by TS_STRIDE (see c_add_ts) */
+	uint8_t ts_stride_shift;
 
 	/// The TS_SCALED value
 	uint32_t ts_scaled;
@@ -81,6 +99,9 @@ struct ts_sc_comp
 	uint32_t ts;
 	/** The W-LSB object used to encode the TS value */
 	struct c_wlsb *ts_unscaled_wlsb;
+	/** The number of TS_SCALED values added since the last unscaled TS value,
+	 *  they are added to the unscaled W-LSB window only when required */
+	size_t ts_unscaled_missing_nr;
 	/// The previous timestamp
 	uint32_t old_ts;
 
@@ -102,6 +123,33 @@ struct ts_sc_comp
 	/// The difference between old and current TS
 	uint32_t ts_delta;
 
+	/* variables related to the timer-based compression of TS */
+
+	/** Whether the timer-based compression of TS may be used or not */
+	bool is_timer_enabled;
+	/** The max jitter between compressor and decompressor (in ms) */
+	uint32_t max_jitter_cd;
+	/** The TIME_STRIDE value (in ms), 0 if timer-based compression is not
+	 *  used with the current TS_STRIDE */
+	uint32_t time_stride;
+	/** The arrival time of the current packet (in ms) */
+	uint32_t arrival;
+	/** The arrival time of the previous packet (in ms) */
+	uint32_t old_arrival;
+	/** Whether the arrival time of the current packet is known or not */
+	bool is_arrival_known;
+	/** Whether the arrival time of the previous packet is known or not */
+	bool is_old_arrival_known;
+	/** The TS_SCALED values and arrival times of the last packets, used to
+	 *  compute the jitter between the source and the compressor */
+	struct ts_sc_timer_ref *timer_refs;
+	/** The max number of references in timer_refs */
+	size_t timer_refs_max;
+	/** The number of references in timer_refs */
+	size_t timer_refs_nr;
+	/** The index of the next reference to replace in timer_refs */
+	size_t timer_refs_next;
+
 	/** The callback function used to manage traces */
 	rohc_trace_callback2_t trace_callback;
 	/** The private context of the callback function used to manage traces */
@@ -115,30 +163,38 @@ struct ts_sc_comp
  */
 
 bool c_create_sc(struct ts_sc_comp *const ts_sc,
+                 struct rohc_slab *const slab,
                  const size_t wlsb_window_width,
+                 const bool is_timer_enabled,
+                 const size_t max_jitter_cd,
                  rohc_trace_callback2_t trace_cb,
                  void *const trace_cb_priv)
 	__attribute__((warn_unused_result));
 void c_destroy_sc(struct ts_sc_comp *const ts_sc);
+size_t c_sc_mem_max(const size_t wlsb_window_width)
+	__attribute__((warn_unused_result, const));
 
 void c_add_ts(struct ts_sc_comp *const ts_sc,
               const uint32_t ts,
-              const uint16_t sn);
+              const uint16_t sn,
+              const struct rohc_ts arrival_time);
 
 void nb_bits_unscaled(const struct ts_sc_comp *const ts_sc,
                       size_t *const bits_nr_less_equal_than_2,
                       size_t *const bits_nr_more_than_2)
 	__attribute__((nonnull(1, 2, 3)));
-void add_unscaled(const struct ts_sc_comp *const ts_sc, const uint16_t sn);
+void add_unscaled(struct ts_sc_comp *const ts_sc, const uint16_t sn);
 
 void nb_bits_scaled(const struct ts_sc_comp *const ts_sc,
                     size_t *const bits_nr_less_equal_than_2,
                     size_t *const bits_nr_more_than_2)
 	__attribute__((nonnull(1, 2, 3)));
-void add_scaled(const struct ts_sc_comp *const ts_sc, const uint16_t sn);
+void add_scaled(struct ts_sc_comp *const ts_sc, const uint16_t sn);
 
 uint32_t get_ts_stride(const struct ts_sc_comp *const ts_sc)
 	__attribute__((nonnull(1), warn_unused_result, pure));
+uint32_t get_time_stride(const struct ts_sc_comp *const ts_sc)
+	__attribute__((nonnull(1), warn_unused_result, pure));
 uint32_t get_ts_scaled(const struct ts_sc_comp *const ts_sc)
 	__attribute__((nonnull(1), warn_unused_result, pure));
 uint32_t get_ts_unscaled(const struct ts_sc_comp *const ts_sc)
@@ -27,6 +27,7 @@
 
 #include "comp_wlsb.h"
 #include "interval.h" /* for the rohc_f_*bits() functions */
+#include "rohc_utils.h"
 
 #ifndef __KERNEL__
 #  include <string.h>
@@ -39,23 +40,20 @@
  */
 
 /**
- * @brief Define a W-LSB window entry
- */
-struct c_window
-{
-	uint32_t sn;     /**< The Sequence Number (SN) associated with the entry
-	                      (used to acknowledge the entry) */
-	uint32_t value;  /**< The value stored in the window entry */
-};
-
-
-/**
- * @brief Defines a W-LSB encoding object
+ * @brief The rows of a W-LSB window
+ *
+ * Every row of the window is made of one Sequence Number (SN) and of the
+ * values of all the fields of the window associated with that SN. The rows
+ * are shared by all the fields of a multi-field window, so that adding a row
+ * or acknowledging SNs updates all the fields at once.
  */
-struct c_wlsb
+struct c_wlsb_rows
 {
-	/// The width of the window
-	size_t window_width; /* TODO: R-mode needs a non-fixed window width */
+	/// The capacity of the window (power of 2)
+	size_t window_width;
+	/** The number of entries kept in the window, lower or equal to the
+	 *  capacity of the window, adapted to the feedback by the context */
+	size_t width;
 
 	/// The size of the window (power of 2) minus 1
 	size_t window_mask;
@@ -67,6 +65,35 @@ struct c_wlsb
 
 	/// Count of entries in the window
 	size_t count;
+	/** The sum of the SN steps between consecutive entries of the window,
+	 *  from the oldest entry to the newest one; it equals the SN distance
+	 *  between them only if the SNs grow in the window */
+	uint64_t sn_span;
+
+	/// The number of fields that share the rows
+	size_t fields_nr;
+
+	/** The Sequence Numbers (SN) associated with the window entries (used to
+	 *  acknowledge the entries), stored right after the fields */
+	uint32_t *sns;
+};
+
+
+/**
+ * @brief Defines a W-LSB encoding object
+ *
+ * The window is stored as separate arrays: one for the values of every
+ * field, one for the Sequence Numbers (SN) associated with them. The
+ * computations of k only scan the values, and the acknowledgements only scan
+ * the SNs, so that every scan runs over contiguous data.
+ *
+ * The object is one field of the window: the rows of the window, ie. its SNs
+ * and its positions, may be shared with other fields.
+ */
+struct c_wlsb
+{
+	/// The rows of the window, shared by all the fields of the window
+	struct c_wlsb_rows *rows;
 
 	/// The maximal number of bits for representing the value
 	size_t bits;
@@ -74,7 +101,7 @@ struct c_wlsb
 	rohc_lsb_shift_t p;
 
 	/** The window in which previous values of the encoded value are stored */
-	struct c_window window[1];
+	uint32_t *values;
 };
 
 
@@ -84,9 +111,29 @@ struct c_wlsb
 
 static size_t wlsb_get_next_older(const size_t entry, const size_t max)
 	__attribute__((warn_unused_result, const));
-
-static size_t wlsb_ack_remove(struct c_wlsb *const wlsb, const size_t pos)
+static void wlsb_remove_oldest(struct c_wlsb_rows *const rows)
+	__attribute__((nonnull(1)));
+
+static size_t wlsb_ack_search(const struct c_wlsb_rows *const rows,
+                              const uint32_t sn_bits,
+                              const uint32_t sn_mask)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static size_t wlsb_ack_remove(struct c_wlsb_rows *const rows, const size_t pos)
 	__attribute__((warn_unused_result, nonnull(1)));
+static uint64_t wlsb_get_sn_span(const struct c_wlsb_rows *const rows)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static bool wlsb_is_shift_variable(const rohc_lsb_shift_t p)
+	__attribute__((warn_unused_result, const));
+static uint32_t wlsb_get_window_dist(const struct c_wlsb *const wlsb,
+                                     const uint32_t value,
+                                     const rohc_lsb_shift_t p,
+                                     const uint32_t field_mask)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static size_t wlsb_get_k_from_dist(const uint32_t dist,
+                                   const size_t min_k,
+                                   const size_t bits_nr)
+	__attribute__((warn_unused_result, const));
 
 static size_t rohc_g_8bits(const uint8_t v_ref,
                            const uint8_t v,
@@ -108,6 +155,14 @@ static size_t rohc_g_32bits(const uint32_t v_ref,
                             const size_t bits_nr)
 	__attribute__((warn_unused_result));
 
+static size_t rohc_g(const uint32_t v_ref,
+                     const uint32_t v,
+                     const size_t min_k,
+                     const rohc_lsb_shift_t p,
+                     const size_t bits_nr,
+                     const size_t field_bits)
+	__attribute__((warn_unused_result, const));
+
 
 /*
  * Public functions
@@ -117,58 +172,147 @@ static size_t rohc_g_32bits(const uint32_t v_ref,
  * @brief Create a new Window-based Least Significant Bits (W-LSB) encoding
  *        object
  *
+ * @param slab         The slab to allocate the object from, may be NULL to
+ *                     allocate it from the heap
  * @param bits         The maximal number of bits for representing a value
  * @param window_width The number of entries in the window (power of 2)
  * @param p            Shift parameter (see 4.5.2 in the RFC 3095)
  * @return             The newly-created W-LSB encoding object
  */
-struct c_wlsb * c_create_wlsb(const size_t bits,
+struct c_wlsb * c_create_wlsb(struct rohc_slab *const slab,
+                              const size_t bits,
                               const size_t window_width,
                               const rohc_lsb_shift_t p)
 {
-	struct c_wlsb *wlsb;
+	return c_create_wlsb_multi(slab, 1, &bits, window_width, &p);
+}
+
 
-	assert(bits > 0);
+/**
+ * @brief Create a new multi-field W-LSB encoding object
+ *
+ * The fields of the window share the same rows: every row of the window is
+ * made of one Sequence Number (SN) and of one value per field. All the
+ * values of one row are added at once with \ref c_add_wlsb_multi, and
+ * acknowledging SNs or changing the width of the window with any field
+ * updates all the fields at once. The SNs are stored only once.
+ *
+ * Every field is one regular W-LSB encoding object given by
+ * \ref c_wlsb_get_field, the first field is the one returned.
+ *
+ * @param slab          The slab to allocate the object from, may be NULL to
+ *                      allocate it from the heap
+ * @param fields_nr     The number of fields of the window
+ * @param bits          The maximal number of bits for representing the
+ *                      values, one per field
+ * @param window_width  The number of entries in the window (power of 2)
+ * @param ps            The shift parameters (see 4.5.2 in the RFC 3095), one
+ *                      per field
+ * @return              The first field of the newly-created W-LSB encoding
+ *                      object
+ */
+struct c_wlsb * c_create_wlsb_multi(struct rohc_slab *const slab,
+                                    const size_t fields_nr,
+                                    const size_t bits[],
+                                    const size_t window_width,
+                                    const rohc_lsb_shift_t ps[])
+{
+	struct c_wlsb_rows *rows;
+	struct c_wlsb *fields;
+	size_t i;
+
+	assert(fields_nr > 0);
 	assert(window_width > 0);
 	/* window_width must be a power of 2! */
 	assert(window_width != 0 && (window_width & (window_width - 1)) == 0);
 
-	wlsb = malloc(sizeof(struct c_wlsb) + (window_width - 1) * sizeof(struct c_window));
-	if(wlsb == NULL)
+	/* the rows, the fields, the SNs then the values of all the fields are
+	 * allocated at once */
+	rows = rohc_slab_alloc(slab, sizeof(struct c_wlsb_rows) +
+	                       fields_nr * sizeof(struct c_wlsb) +
+	                       (fields_nr + 1) * window_width * sizeof(uint32_t));
+	if(rows == NULL)
 	{
 		goto error;
 	}
+	fields = (struct c_wlsb *) (rows + 1);
+
+	rows->oldest = 0;
+	rows->next = 0;
+	rows->count = 0;
+	rows->sn_span = 0;
+	rows->window_width = window_width;
+	rows->width = window_width;
+	rows->window_mask = window_width - 1;
+	rows->fields_nr = fields_nr;
+	rows->sns = (uint32_t *) (fields + fields_nr);
+
+	for(i = 0; i < fields_nr; i++)
+	{
+		assert(bits[i] > 0);
+		fields[i].rows = rows;
+		fields[i].bits = bits[i];
+		fields[i].p = ps[i];
+		fields[i].values = rows->sns + (i + 1) * window_width;
+	}
 
-	wlsb->oldest = 0;
-	wlsb->next = 0;
-	wlsb->count = 0;
-	wlsb->window_width = window_width;
-	wlsb->window_mask = window_width - 1;
-	wlsb->bits = bits;
-	wlsb->p = p;
-
-	return wlsb;
+	return fields;
 
 error:
 	return NULL;
 }
 
 
+/**
+ * @brief Get one field of a multi-field W-LSB encoding object
+ *
+ * @param wlsb   Any field of the W-LSB object
+ * @param field  The index of the field to get
+ * @return       The field of the W-LSB object
+ */
+struct c_wlsb * c_wlsb_get_field(struct c_wlsb *const wlsb, const size_t field)
+{
+	assert(field < wlsb->rows->fields_nr);
+	return ((struct c_wlsb *) (wlsb->rows + 1)) + field;
+}
+
+
 /**
  * @brief Destroy a Window-based LSB (W-LSB) encoding object
  *
+ * All the fields of a multi-field object are destroyed at once.
+ *
  * @param wlsb  The W-LSB object to destroy
  */
 void c_destroy_wlsb(struct c_wlsb *const wlsb)
 {
-	free(wlsb);
+	if(wlsb != NULL)
+	{
+		rohc_slab_free(wlsb->rows);
+	}
+}
+
+
+/**
+ * @brief Get the maximum length one W-LSB object takes in a memory block
+ *
+ * @param fields_nr     The number of fields of the window
+ * @param window_width  The number of entries in the window
+ * @return              The maximum number of bytes of the memory block the
+ *                      object takes, see \ref rohc_slab_block_mem_max
+ */
+size_t c_wlsb_mem_max(const size_t fields_nr, const size_t window_width)
+{
+	return rohc_slab_block_mem_max(sizeof(struct c_wlsb_rows) +
+	                               fields_nr * sizeof(struct c_wlsb) +
+	                               (fields_nr + 1) * window_width * sizeof(uint32_t));
 }
 
 
 /**
  * @brief Add a value into a W-LSB encoding object
  *
- * @param wlsb  The W-LSB object
+ * @param wlsb  The W-LSB object, with one single field
  * @param sn    The Sequence Number (SN) for the new entry
  * @param value The value to base the LSB coding on
  */
@@ -177,22 +321,133 @@ void c_add_wlsb(struct c_wlsb *const wlsb,
                 const uint32_t value)
 {
 	assert(wlsb != NULL);
-	assert(wlsb->window != NULL);
-	assert(wlsb->next < wlsb->window_width);
+	assert(wlsb->rows->fields_nr == 1);
+
+	c_add_wlsb_multi(wlsb, sn, &value);
+}
+
+
+/**
+ * @brief Add one row of values into a multi-field W-LSB encoding object
+ *
+ * @param wlsb    Any field of the W-LSB object
+ * @param sn      The Sequence Number (SN) for the new entry
+ * @param values  The values to base the LSB coding on, one per field
+ */
+void c_add_wlsb_multi(struct c_wlsb *const wlsb,
+                      const uint32_t sn,
+                      const uint32_t values[])
+{
+	struct c_wlsb_rows *const rows = wlsb->rows;
+	struct c_wlsb *const fields = (struct c_wlsb *) (rows + 1);
+	size_t i;
+
+	assert(rows->next < rows->window_width);
+	assert(rows->count <= rows->width);
 
 	/* if window is full, an entry is overwritten */
-	if(wlsb->count == wlsb->window_width)
+	if(rows->count == rows->width)
 	{
-		wlsb->oldest = (wlsb->oldest + 1) & wlsb->window_mask;
+		wlsb_remove_oldest(rows);
 	}
-	else
+	if(rows->count > 0)
+	{
+		const size_t newest = wlsb_get_next_older(rows->next, rows->window_mask);
+		rows->sn_span += (uint32_t) (sn - rows->sns[newest]);
+	}
+	rows->count++;
+
+	rows->sns[rows->next] = sn;
+	for(i = 0; i < rows->fields_nr; i++)
+	{
+		fields[i].values[rows->next] = values[i];
+	}
+	rows->next = (rows->next + 1) & rows->window_mask;
+}
+
+
+/**
+ * @brief Set the number of entries kept in a W-LSB encoding object
+ *
+ * The width is bounded by the capacity the object was created with. The
+ * oldest entries that do not fit in the new width are removed at once. All
+ * the fields of a multi-field object are updated at once.
+ *
+ * @param wlsb   The W-LSB object
+ * @param width  The number of entries to keep in the window
+ */
+void c_wlsb_set_width(struct c_wlsb *const wlsb, const size_t width)
+{
+	struct c_wlsb_rows *const rows = wlsb->rows;
+
+	rows->width = rohc_max(rohc_min(width, rows->window_width), 1U);
+	while(rows->count > rows->width)
 	{
-		wlsb->count++;
+		wlsb_remove_oldest(rows);
 	}
+}
+
+
+/**
+ * @brief Get the number of entries in a W-LSB encoding object
+ *
+ * @param wlsb  The W-LSB object
+ * @return      The number of entries in the window
+ */
+size_t wlsb_get_count(const struct c_wlsb *const wlsb)
+{
+	return wlsb->rows->count;
+}
+
 
-	wlsb->window[wlsb->next].sn = sn;
-	wlsb->window[wlsb->next].value = value;
-	wlsb->next = (wlsb->next + 1) & wlsb->window_mask;
+/**
+ * @brief Prefetch a W-LSB encoding object before it is used
+ *
+ * The rows of the window and the first values of the field are prefetched.
+ *
+ * @param wlsb  The W-LSB object
+ */
+void c_wlsb_prefetch(const struct c_wlsb *const wlsb)
+{
+	__builtin_prefetch(wlsb->rows);
+	__builtin_prefetch(wlsb->values);
+}
+/**
+ * @brief Add the newest entries of a window of scaled values into a W-LSB
+ *        encoding object, unscaled
+ *
+ * Every value v of the newest entries of the scaled window is added as
+ * (v * factor + offset) along with its Sequence Number (SN), from the oldest
+ * entry to the newest one. No more entries than the scaled window contains
+ * are added.
+ *
+ * @param wlsb         The W-LSB object to add the unscaled values into
+ * @param scaled_wlsb  The W-LSB object that contains the scaled values
+ * @param entries_nr   The number of newest entries to add
+ * @param factor       The factor the values were scaled with
+ * @param offset       The offset the values were scaled with
+ */
+void c_add_wlsb_unscaled(struct c_wlsb *const wlsb,
+                         const struct c_wlsb *const scaled_wlsb,
+                         const size_t entries_nr,
+                         const uint32_t factor,
+                         const uint32_t offset)
+{
+	const struct c_wlsb_rows *const scaled_rows = scaled_wlsb->rows;
+	const size_t added_nr = rohc_min(entries_nr, scaled_rows->count);
+	size_t entry;
+	size_t i;
+
+	assert(wlsb != NULL);
+	assert(scaled_wlsb != NULL);
+
+	entry = (scaled_rows->next - added_nr) & scaled_rows->window_mask;
+	for(i = 0; i < added_nr; i++)
+	{
+		c_add_wlsb(wlsb, scaled_rows->sns[entry],
+		           scaled_wlsb->values[entry] * factor + offset);
+		entry = (entry + 1) & scaled_rows->window_mask;
+	}
 }
 
 
@@ -230,10 +485,17 @@ size_t wlsb_get_kp_8bits(const struct c_wlsb *const wlsb,
 	size_t bits_nr;
 
 	/* use all bits if the window contains no value */
-	if(wlsb->count == 0)
+	if(wlsb->rows->count == 0)
 	{
 		bits_nr = wlsb->bits;
 	}
+	else if(!wlsb_is_shift_variable(p))
+	{
+		/* the shift parameter does not depend on k: the minimal number of bits
+		 * for ALL the values in the window is derived at once */
+		const uint32_t dist = wlsb_get_window_dist(wlsb, value, p, 0xff);
+		bits_nr = wlsb_get_k_from_dist(dist, 0, wlsb->bits);
+	}
 	else
 	{
 		size_t entry;
@@ -243,12 +505,12 @@ size_t wlsb_get_kp_8bits(const struct c_wlsb *const wlsb,
 
 		/* find the minimal number of bits of the value required to be able
 		 * to recreate it thanks to ANY value in the window */
-		for(i = wlsb->count, entry = wlsb->oldest;
+		for(i = wlsb->rows->count, entry = wlsb->rows->oldest;
 		    i > 0;
-		    i--, entry = (entry + 1) & wlsb->window_mask)
+		    i--, entry = (entry + 1) & wlsb->rows->window_mask)
 		{
 			const size_t k =
-				rohc_g_8bits(wlsb->window[entry].value, value, p, wlsb->bits);
+				rohc_g_8bits(wlsb->values[entry], value, p, wlsb->bits);
 			if(k > bits_nr)
 			{
 				bits_nr = k;
@@ -337,10 +599,17 @@ size_t wlsb_get_minkp_16bits(const struct c_wlsb *const wlsb,
 	size_t bits_nr;
 
 	/* use all bits if the window contains no value */
-	if(wlsb->count == 0)
+	if(wlsb->rows->count == 0)
 	{
 		bits_nr = wlsb->bits;
 	}
+	else if(!wlsb_is_shift_variable(p))
+	{
+		/* the shift parameter does not depend on k: the minimal number of bits
+		 * for ALL the values in the window is derived at once */
+		const uint32_t dist = wlsb_get_window_dist(wlsb, value, p, 0xffff);
+		bits_nr = wlsb_get_k_from_dist(dist, min_k, wlsb->bits);
+	}
 	else
 	{
 		size_t entry;
@@ -350,12 +619,12 @@ size_t wlsb_get_minkp_16bits(const struct c_wlsb *const wlsb,
 
 		/* find the minimal number of bits of the value required to be able
 		 * to recreate it thanks to ANY value in the window */
-		for(i = wlsb->count, entry = wlsb->oldest;
+		for(i = wlsb->rows->count, entry = wlsb->rows->oldest;
 		    i > 0;
-		    i--, entry = (entry + 1) & wlsb->window_mask)
+		    i--, entry = (entry + 1) & wlsb->rows->window_mask)
 		{
 			const size_t k =
-				rohc_g_16bits(wlsb->window[entry].value, value, min_k, p, wlsb->bits);
+				rohc_g_16bits(wlsb->values[entry], value, min_k, p, wlsb->bits);
 			if(k > bits_nr)
 			{
 				bits_nr = k;
@@ -443,14 +712,20 @@ size_t wlsb_get_minkp_32bits(const struct c_wlsb *const wlsb,
 {
 	size_t bits_nr;
 
-	assert(wlsb->window != NULL);
 	assert(value <= 0xffffffff);
 
 	/* use all bits if the window contains no value */
-	if(wlsb->count == 0)
+	if(wlsb->rows->count == 0)
 	{
 		bits_nr = wlsb->bits;
 	}
+	else if(!wlsb_is_shift_variable(p))
+	{
+		/* the shift parameter does not depend on k: the minimal number of bits
+		 * for ALL the values in the window is derived at once */
+		const uint32_t dist = wlsb_get_window_dist(wlsb, value, p, 0xffffffff);
+		bits_nr = wlsb_get_k_from_dist(dist, min_k, wlsb->bits);
+	}
 	else
 	{
 		size_t entry;
@@ -460,12 +735,12 @@ size_t wlsb_get_minkp_32bits(const struct c_wlsb *const wlsb,
 
 		/* find the minimal number of bits of the value required to be able
 		 * to recreate it thanks to ANY value in the window */
-		for(i = wlsb->count, entry = wlsb->oldest;
+		for(i = wlsb->rows->count, entry = wlsb->rows->oldest;
 		    i > 0;
-		    i--, entry = (entry + 1) & wlsb->window_mask)
+		    i--, entry = (entry + 1) & wlsb->rows->window_mask)
 		{
 			const size_t k =
-				rohc_g_32bits(wlsb->window[entry].value, value, min_k, p, wlsb->bits);
+				rohc_g_32bits(wlsb->values[entry], value, min_k, p, wlsb->bits);
 			if(k > bits_nr)
 			{
 				bits_nr = k;
@@ -478,12 +753,83 @@ size_t wlsb_get_minkp_32bits(const struct c_wlsb *const wlsb,
 }
 
 
+/**
+ * @brief Find out the minimal numbers of bits of the to-be-encoded value
+ *        required to be able to uniquely recreate it given the window, for
+ *        several shift parameters at once
+ *
+ * The function is dedicated to 32-bit fields. It gives the same results as
+ * calling wlsb_get_kp_32bits() once for every shift parameter, but browses
+ * the window only once when all the shift parameters do not depend on k.
+ *
+ * @param wlsb          The W-LSB object
+ * @param value         The value to encode using the LSB algorithm
+ * @param ps            The shift parameters
+ * @param ps_nr         The number of shift parameters, WLSB_KPS_MAX_NR at most
+ * @param[out] bits_nr  The number of bits required to uniquely recreate the
+ *                      value, one for every shift parameter
+ */
+void wlsb_get_kps_32bits(const struct c_wlsb *const wlsb,
+                         const uint32_t value,
+                         const rohc_lsb_shift_t ps[],
+                         const size_t ps_nr,
+                         size_t bits_nr[])
+{
+	uint32_t dists[WLSB_KPS_MAX_NR] = { 0 };
+	size_t entry;
+	size_t i;
+	size_t j;
+
+	assert(ps_nr <= WLSB_KPS_MAX_NR);
+
+	for(j = 0; j < ps_nr; j++)
+	{
+		if(wlsb->rows->count == 0 || wlsb_is_shift_variable(ps[j]))
+		{
+			/* no distance to share with the other shift parameters */
+			for(j = 0; j < ps_nr; j++)
+			{
+				bits_nr[j] = wlsb_get_kp_32bits(wlsb, value, ps[j]);
+			}
+			return;
+		}
+	}
+
+	/* the distance (v - v_ref + p) is (v - v_ref) + p, so compute the
+	 * distance (v - v_ref) once per entry of the window, then shift it with
+	 * all the parameters, see wlsb_get_window_dist() */
+	for(i = wlsb->rows->count, entry = wlsb->rows->oldest;
+	    i > 0;
+	    i--, entry = (entry + 1) & wlsb->rows->window_mask)
+	{
+		const uint32_t dist = value - wlsb->values[entry];
+
+		for(j = 0; j < ps_nr; j++)
+		{
+			dists[j] |= dist + ((uint32_t) ps[j]);
+		}
+	}
+
+	for(j = 0; j < ps_nr; j++)
+	{
+		bits_nr[j] = wlsb_get_k_from_dist(dists[j], 0, wlsb->bits);
+		assert(bits_nr[j] <= 32);
+	}
+}
+
+
 /**
  * @brief Acknowledge based on the Sequence Number (SN)
  *
  * Removes all window entries older (and including) than the one that matches
  * the given SN bits.
  *
+ * The SNs of the window grow most of the time. When the SN distance between
+ * the oldest and the newest entries is lower than 2^sn_bits_nr, no two entries
+ * share the same SN LSB (except for duplicate SNs), so the acknowledged entry
+ * is found by a binary search on the SN distances to the newest entry. The
+ * whole window is searched otherwise.
+ *
  * @param wlsb        The W-LSB object
  * @param sn_bits     The LSB of the SN to acknowledge
  * @param sn_bits_nr  The number of LSB of the SN to acknowledge
@@ -493,8 +839,10 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
                 const uint32_t sn_bits,
                 const size_t sn_bits_nr)
 {
-	size_t entry = wlsb->next;
+	struct c_wlsb_rows *const rows = wlsb->rows;
+	size_t entry = rows->next;
 	uint32_t sn_mask;
+	size_t acked_nr;
 	size_t i;
 
 	if(sn_bits_nr < 32)
@@ -507,15 +855,38 @@ size_t wlsb_ack(struct c_wlsb *const wlsb,
 	}
 	assert((sn_bits & sn_mask) == sn_bits);
 
+	if(rows->count == 0)
+	{
+		return 0;
+	}
+	else if(rows->sn_span <= sn_mask)
+	{
+		/* SNs of the window grow without wrapping around the SN LSB space */
+		const size_t newest = wlsb_get_next_older(rows->next, rows->window_mask);
+
+		entry = wlsb_ack_search(rows, sn_bits, sn_mask);
+		if(entry == rows->window_width)
+		{
+			return 0;
+		}
+
+		/* remove the window entry and all the older ones if found */
+		acked_nr = wlsb_ack_remove(rows, entry);
+		rows->sn_span = (uint32_t) (rows->sns[newest] - rows->sns[entry]);
+		return acked_nr;
+	}
+
 	/* search for the window entry that matches the given SN LSB
 	 * starting from the one */
-	for(i = 0; i < wlsb->count; i++)
+	for(i = 0; i < rows->count; i++)
 	{
-		entry = wlsb_get_next_older(entry, wlsb->window_mask);
-		if((wlsb->window[entry].sn & sn_mask) == sn_bits)
+		entry = wlsb_get_next_older(entry, rows->window_mask);
+		if((rows->sns[entry] & sn_mask) == sn_bits)
 		{
 			/* remove the window entry and all the older ones if found */
-			return wlsb_ack_remove(wlsb, entry);
+			acked_nr = wlsb_ack_remove(rows, entry);
+			rows->sn_span = wlsb_get_sn_span(rows);
+			return acked_nr;
 		}
 	}
 
@@ -541,26 +912,214 @@ static size_t wlsb_get_next_older(const size_t entry, const size_t max)
 }
 
 
+/**
+ * @brief Remove the oldest entry of a non-empty W-LSB window
+ *
+ * @param rows  The rows of the W-LSB window
+ */
+static void wlsb_remove_oldest(struct c_wlsb_rows *const rows)
+{
+	const size_t new_oldest = (rows->oldest + 1) & rows->window_mask;
+
+	assert(rows->count > 0);
+	if(rows->count > 1)
+	{
+		rows->sn_span -= (uint32_t) (rows->sns[new_oldest] -
+		                             rows->sns[rows->oldest]);
+	}
+	rows->oldest = new_oldest;
+	rows->count--;
+}
+
+
 /**
  * @brief Removes all W-LSB window entries prior to the given position
  *
- * @param wlsb  The W-LSB object
+ * @param rows  The rows of the W-LSB window
  * @param pos   The position to set as the oldest
  * @return      The number of acked window entries
  */
-static size_t wlsb_ack_remove(struct c_wlsb *const wlsb, const size_t pos)
+static size_t wlsb_ack_remove(struct c_wlsb_rows *const rows, const size_t pos)
+{
+	const size_t acked_nr = (pos - rows->oldest) & rows->window_mask;
+
+	assert(acked_nr < rows->count);
+
+	/* remove the oldest entries at once */
+	rows->oldest = pos;
+	rows->count -= acked_nr;
+
+	return acked_nr;
+}
+
+
+/**
+ * @brief Search for the newest W-LSB window entry that matches the given SN
+ *
+ * The SN distances between the newest entry and the older ones grow from the
+ * newest entry to the oldest one, and they are all lower than 2^sn_bits_nr.
+ * The SN distance of the acknowledged entry is thus found by a binary search.
+ *
+ * @param rows     The rows of a non-empty W-LSB window
+ * @param sn_bits  The LSB of the SN to acknowledge
+ * @param sn_mask  The mask of the SN LSB to acknowledge
+ * @return         The position of the matching entry in the window,
+ *                 the window width if no entry matches
+ */
+static size_t wlsb_ack_search(const struct c_wlsb_rows *const rows,
+                              const uint32_t sn_bits,
+                              const uint32_t sn_mask)
 {
-	size_t acked_nr = 0;
+	const size_t newest = wlsb_get_next_older(rows->next, rows->window_mask);
+	const uint32_t newest_sn = rows->sns[newest];
+	const uint32_t acked_dist = (newest_sn - sn_bits) & sn_mask;
+	size_t low = 0;
+	size_t high = rows->count;
 
-	while(wlsb->oldest != pos)
+	assert(rows->count > 0);
+	assert(rows->sn_span <= sn_mask);
+
+	/* the acknowledged SN is older than the oldest SN in window */
+	if(acked_dist > rows->sn_span)
 	{
-		/* remove the oldest entry */
-		wlsb->oldest = (wlsb->oldest + 1) & wlsb->window_mask;
-		wlsb->count--;
-		acked_nr++;
+		return rows->window_width;
 	}
 
-	return acked_nr;
+	/* find the newest entry with a SN distance greater or equal to the
+	 * acknowledged one, entries being numbered from the newest one */
+	while(low < high)
+	{
+		const size_t middle = low + (high - low) / 2;
+		const size_t entry = (newest - middle) & rows->window_mask;
+
+		if((uint32_t) (newest_sn - rows->sns[entry]) < acked_dist)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	assert(low < rows->count);
+
+	/* the entry matches only if its SN distance is the acknowledged one */
+	{
+		const size_t entry = (newest - low) & rows->window_mask;
+		if((uint32_t) (newest_sn - rows->sns[entry]) != acked_dist)
+		{
+			return rows->window_width;
+		}
+		return entry;
+	}
+}
+
+
+/**
+ * @brief Compute the sum of the SN steps between the entries of the window
+ *
+ * @param rows  The rows of the W-LSB window
+ * @return      The sum of the SN steps from the oldest entry to the newest one
+ */
+static uint64_t wlsb_get_sn_span(const struct c_wlsb_rows *const rows)
+{
+	uint64_t sn_span = 0;
+	size_t entry = rows->oldest;
+	size_t i;
+
+	for(i = 1; i < rows->count; i++)
+	{
+		const size_t next_entry = (entry + 1) & rows->window_mask;
+		sn_span += (uint32_t) (rows->sns[next_entry] - rows->sns[entry]);
+		entry = next_entry;
+	}
+
+	return sn_span;
+}
+
+
+/**
+ * @brief Whether the given shift parameter depends on the number of bits k
+ *
+ * @param p  The shift parameter
+ * @return   true if the real shift parameter is computed from k,
+ *           false if it is the same for all k values
+ */
+static bool wlsb_is_shift_variable(const rohc_lsb_shift_t p)
+{
+	assert(p != ROHC_LSB_SHIFT_VAR);
+	return (p == ROHC_LSB_SHIFT_RTP_TS ||
+	        p == ROHC_LSB_SHIFT_RTP_SN ||
+	        p == ROHC_LSB_SHIFT_ESP_SN);
+}
+
+
+/**
+ * @brief Get the distances of the given value to all the values of the window
+ *
+ * The value v falls into the interpretation interval f(v_ref, k) = [v_ref - p,
+ * v_ref + (2^k - 1) - p] if and only if the distance (v - v_ref + p) modulo the
+ * field size is lower than 2^k, the wraparound of the interval being handled
+ * by the modulo. So, the highest bit set in the distances to all the values of
+ * the window gives the minimal k for the whole window. The distances are ORed
+ * together to find out that bit.
+ *
+ * The shift parameter shall not depend on k.
+ *
+ * @param wlsb        The W-LSB object, with a non-empty window
+ * @param value       The value to encode using the LSB algorithm
+ * @param p           The shift parameter
+ * @param field_mask  The mask of the field size (0xff, 0xffff or 0xffffffff)
+ * @return            The distances to all the values of the window ORed
+ *                    together
+ */
+static uint32_t wlsb_get_window_dist(const struct c_wlsb *const wlsb,
+                                     const uint32_t value,
+                                     const rohc_lsb_shift_t p,
+                                     const uint32_t field_mask)
+{
+	const uint32_t v_shifted = value + ((uint32_t) p);
+	const size_t first_len =
+		rohc_min(wlsb->rows->count, wlsb->rows->window_width - wlsb->rows->oldest);
+	uint32_t dist = 0;
+	size_t i;
+
+	assert(wlsb->rows->count > 0);
+	assert(!wlsb_is_shift_variable(p));
+
+	/* the window is a ring buffer: browse the entries from the oldest one to
+	 * the end of the buffer, then the wrapped entries from the beginning of
+	 * the buffer, so that both loops run over contiguous entries */
+	for(i = wlsb->rows->oldest; i < (wlsb->rows->oldest + first_len); i++)
+	{
+		dist |= v_shifted - wlsb->values[i];
+	}
+	for(i = 0; i < (wlsb->rows->count - first_len); i++)
+	{
+		dist |= v_shifted - wlsb->values[i];
+	}
+
+	return (dist & field_mask);
+}
+
+
+/**
+ * @brief Get the minimal number of bits k from the distances to the window
+ *
+ * @param dist     The distances to all the values of the window ORed together
+ * @param min_k    The minimum number of bits to find out
+ * @param bits_nr  The number of bits that may be used to represent the
+ *                 LSB-encoded value
+ * @return         The minimal k value as defined by the LSB algorithm
+ */
+static size_t wlsb_get_k_from_dist(const uint32_t dist,
+                                   const size_t min_k,
+                                   const size_t bits_nr)
+{
+	const size_t dist_bits_nr = (dist == 0 ? 0 : (32 - __builtin_clz(dist)));
+	const size_t k = rohc_max(min_k, dist_bits_nr);
+
+	return rohc_min(k, bits_nr);
 }
 
 
@@ -582,35 +1141,9 @@ static size_t rohc_g_8bits(const uint8_t v_ref,
                            const rohc_lsb_shift_t p,
                            const size_t bits_nr)
 {
-	struct rohc_interval8 interval;
-	size_t k;
-
 	assert(bits_nr <= 8);
 
-	for(k = 0; k < bits_nr; k++)
-	{
-		interval = rohc_f_8bits(v_ref, k, p);
-		if(interval.min <= interval.max)
-		{
-			/* interpretation interval does not straddle field boundaries,
-			 * check if value is in [min, max] */
-			if(v >= interval.min && v <= interval.max)
-			{
-				break;
-			}
-		}
-		else
-		{
-			/* the interpretation interval does straddle the field boundaries,
-			 * check if value is in [min, 0xffff] or [0, max] */
-			if(v >= interval.min || v <= interval.max)
-			{
-				break;
-			}
-		}
-	}
-
-	return k;
+	return rohc_g(v_ref, v, 0, p, bits_nr, 8);
 }
 
 
@@ -634,36 +1167,10 @@ static size_t rohc_g_16bits(const uint16_t v_ref,
                             const rohc_lsb_shift_t p,
                             const size_t bits_nr)
 {
-	struct rohc_interval16 interval;
-	size_t k;
-
 	assert(bits_nr <= 16);
 	assert(min_k <= bits_nr);
 
-	for(k = min_k; k < bits_nr; k++)
-	{
-		interval = rohc_f_16bits(v_ref, k, p);
-		if(interval.min <= interval.max)
-		{
-			/* interpretation interval does not straddle field boundaries,
-			 * check if value is in [min, max] */
-			if(v >= interval.min && v <= interval.max)
-			{
-				break;
-			}
-		}
-		else
-		{
-			/* the interpretation interval does straddle the field boundaries,
-			 * check if value is in [min, 0xffff] or [0, max] */
-			if(v >= interval.min || v <= interval.max)
-			{
-				break;
-			}
-		}
-	}
-
-	return k;
+	return rohc_g(v_ref, v, min_k, p, bits_nr, 16);
 }
 
 
@@ -687,35 +1194,100 @@ static size_t rohc_g_32bits(const uint32_t v_ref,
                             const rohc_lsb_shift_t p,
                             const size_t bits_nr)
 {
-	struct rohc_interval32 interval;
-	size_t k;
-
 	assert(bits_nr <= 32);
 	assert(min_k < bits_nr);
 
-	for(k = min_k; k < bits_nr; k++)
+	return rohc_g(v_ref, v, min_k, p, bits_nr, 32);
+}
+
+
+/**
+ * @brief The g function as defined in LSB encoding
+ *
+ * Find the minimal k value so that v falls into the interval given by
+ * f(v_ref, k). See 4.5.1 in the RFC 3095.
+ *
+ * The k value is computed directly from the offset between v_ref and v
+ * instead of trying every k value one after the other:
+ *  \li if p does not depend on k, v falls into f(v_ref, k) if and only if
+ *      (v - v_ref + p) modulo the field size is lower than 2^k, the highest
+ *      bit set in that distance gives k;
+ *  \li if p depends on k (RTP TS, RTP SN and ESP SN), p is constant for the
+ *      small k values, then p = 2^(k - c) - 1 for the large k values. In the
+ *      latter case, v falls into f(v_ref, k) if and only if the signed offset
+ *      s = v - v_ref is in [-(2^(k - c) - 1), 2^k - 2^(k - c)], the interval
+ *      grows with k so the minimal k derives from the highest bit set in s.
+ *
+ * @param v_ref       The reference value
+ * @param v           The value to encode
+ * @param min_k       The minimum number of bits to find out
+ * @param p           The shift parameter
+ * @param bits_nr     The number of bits that may be used to represent the
+ *                    LSB-encoded value
+ * @param field_bits  The size of the field (8, 16 or 32 bits)
+ * @return            The minimal k value as defined by the LSB algorithm
+ */
+static size_t rohc_g(const uint32_t v_ref,
+                     const uint32_t v,
+                     const size_t min_k,
+                     const rohc_lsb_shift_t p,
+                     const size_t bits_nr,
+                     const size_t field_bits)
+{
+	const uint32_t field_mask =
+		(field_bits == 32 ? 0xffffffff : ((1U << field_bits) - 1));
+	const uint32_t dist = (v - v_ref) & field_mask;
+	size_t small_k_max; /* the largest k value with a constant p */
+	uint32_t small_p;   /* the p value for the small k values */
+	size_t c;           /* p = 2^(k - c) - 1 for the large k values */
+	size_t k;
+
+	switch(p)
 	{
-		interval = rohc_f_32bits(v_ref, k, p);
-		if(interval.min <= interval.max)
-		{
-			/* interpretation interval does not straddle field boundaries,
-			 * check if value is in [min, max] */
-			if(v >= interval.min && v <= interval.max)
-			{
-				break;
-			}
-		}
-		else
+		case ROHC_LSB_SHIFT_RTP_TS:
+			small_k_max = 2;
+			small_p = 0;
+			c = 2;
+			break;
+		case ROHC_LSB_SHIFT_RTP_SN:
+		case ROHC_LSB_SHIFT_ESP_SN:
+			small_k_max = 4;
+			small_p = 1;
+			c = 5;
+			break;
+		default:
+			/* the shift parameter does not depend on k */
+			assert(!wlsb_is_shift_variable(p));
+			return wlsb_get_k_from_dist((dist + ((uint32_t) p)) & field_mask,
+			                            min_k, bits_nr);
+	}
+
+	/* small k values with a constant shift parameter */
+	k = wlsb_get_k_from_dist((dist + small_p) & field_mask, min_k, field_bits);
+	if(k <= small_k_max)
+	{
+		return rohc_min(k, bits_nr);
+	}
+
+	/* large k values with p = 2^(k - c) - 1 */
+	if((dist >> (field_bits - 1)) != 0)
+	{
+		/* negative offset: 2^(k - c) - 1 >= |s| */
+		const uint32_t abs_offset = (0U - dist) & field_mask;
+		k = c + (32 - __builtin_clz(abs_offset));
+	}
+	else
+	{
+		/* positive offset: s <= 2^k - 2^(k - c), so k is the number of bits
+		 * of s, or one more bit if s is too close to 2^k */
+		k = rohc_max(wlsb_get_k_from_dist(dist, 0, field_bits), c);
+		if(dist > ((1U << k) - (1U << (k - c))))
 		{
-			/* the interpretation interval does straddle the field boundaries,
-			 * check if value is in [min, 0xffff] or [0, max] */
-			if(v >= interval.min || v <= interval.max)
-			{
-				break;
-			}
+			k++;
 		}
 	}
+	k = rohc_max(k, rohc_max(min_k, small_k_max + 1));
 
-	return k;
+	return rohc_min(k, bits_nr);
 }
 
@@ -28,12 +28,17 @@
 #define ROHC_COMP_SCHEMES_WLSB_H
 
 #include "interval.h" /* for rohc_lsb_shift_t */
+#include "rohc_slab.h"
 
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
 
 
+/** The max number of shift parameters given to wlsb_get_kps_32bits() */
+#define WLSB_KPS_MAX_NR  5U
+
+
 /* The definition of the W-LSB encoding object is private */
 struct c_wlsb;
 
@@ -42,15 +47,43 @@ struct c_wlsb;
  * Public function prototypes:
  */
 
-struct c_wlsb * c_create_wlsb(const size_t bits,
+struct c_wlsb * c_create_wlsb(struct rohc_slab *const slab,
+                              const size_t bits,
                               const size_t window_width,
                               const rohc_lsb_shift_t p)
 	__attribute__((warn_unused_result));
+struct c_wlsb * c_create_wlsb_multi(struct rohc_slab *const slab,
+                                    const size_t fields_nr,
+                                    const size_t bits[],
+                                    const size_t window_width,
+                                    const rohc_lsb_shift_t ps[])
+	__attribute__((warn_unused_result, nonnull(3, 5)));
+struct c_wlsb * c_wlsb_get_field(struct c_wlsb *const wlsb, const size_t field)
+	__attribute__((warn_unused_result, nonnull(1), pure));
 void c_destroy_wlsb(struct c_wlsb *s);
+size_t c_wlsb_mem_max(const size_t fields_nr, const size_t window_width)
+	__attribute__((warn_unused_result, const));
+
+void c_wlsb_set_width(struct c_wlsb *const wlsb, const size_t width)
+	__attribute__((nonnull(1)));
+size_t wlsb_get_count(const struct c_wlsb *const wlsb)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+void c_wlsb_prefetch(const struct c_wlsb *const wlsb)
+	__attribute__((nonnull(1)));
 
 void c_add_wlsb(struct c_wlsb *const wlsb,
                 const uint32_t sn,
                 const uint32_t value);
+void c_add_wlsb_multi(struct c_wlsb *const wlsb,
+                      const uint32_t sn,
+                      const uint32_t values[])
+	__attribute__((nonnull(1, 3)));
+void c_add_wlsb_unscaled(struct c_wlsb *const wlsb,
+                         const struct c_wlsb *const scaled_wlsb,
+                         const size_t entries_nr,
+                         const uint32_t factor,
+                         const uint32_t offset)
+	__attribute__((nonnull(1, 2)));
 
 size_t wlsb_get_k_8bits(const struct c_wlsb *const wlsb,
                         const uint8_t value)
@@ -93,6 +126,12 @@ size_t wlsb_get_minkp_32bits(const struct c_wlsb *const wlsb,
                              const size_t min_k,
                              const rohc_lsb_shift_t p)
 	__attribute__((warn_unused_result, nonnull(1)));
+void wlsb_get_kps_32bits(const struct c_wlsb *const wlsb,
+                         const uint32_t value,
+                         const rohc_lsb_shift_t ps[],
+                         const size_t ps_nr,
+                         size_t bits_nr[])
+	__attribute__((nonnull(1, 3, 5)));
 
 size_t wlsb_ack(struct c_wlsb *const wlsb,
                 const uint32_t sn_bits,
@@ -33,6 +33,16 @@
 #  include <stdbool.h>
 #endif
 
+/**
+ * @brief The number of consecutive packets that shall confirm the IP-ID
+ *        behavior before its detection is skipped
+ *
+ * Once the IP-ID behavior is trusted, only the behavior predicted by the
+ * context is checked for the next packets. The full detection runs again
+ * as soon as the prediction fails.
+ */
+#define ROHC_IP_ID_BEHAVIOR_CONFIDENCE  3U
+
 bool is_ip_id_increasing(const uint16_t old_id, const uint16_t new_id)
 	__attribute__((warn_unused_result, const));
 
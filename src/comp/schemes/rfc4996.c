@@ -36,6 +36,11 @@
 #include <assert.h>
 
 
+/** The max number of scaling factors a field may grow by to be scaled
+ *  incrementally by \ref c_field_scaling_cached */
+#define C_FIELD_SCALING_STEPS_MAX  4U
+
+
 /**
  * @brief Compress the 8 bits given, depending of the context value.
  *
@@ -322,6 +327,63 @@ void c_field_scaling(uint32_t *const scaled_value,
 }
 
 
+/**
+ * @brief Calculate the scaled and residue values from the last ones
+ *
+ * Same as \ref c_field_scaling, but the division and the modulus are avoided
+ * when the scaling factor did not change and the unscaled value grew by at
+ * most a few scaling factors since the last scaling, eg. the sequence number
+ * of a bulk transfer with a fixed MSS: the scaled value and the residue are
+ * then derived from the last ones by additions. The division is done when
+ * the scaling factor changes, when the value wraps around or jumps.
+ *
+ * @param cache            The last scaling of the field, updated
+ * @param scaled_value     OUT: The scaled value
+ * @param residue_field    OUT: The residue
+ * @param scaling_factor   The scaling factor
+ * @param unscaled_value   The unscaled value
+ */
+void c_field_scaling_cached(struct c_field_scaling_cache *const cache,
+                            uint32_t *const scaled_value,
+                            uint32_t *const residue_field,
+                            const uint32_t scaling_factor,
+                            const uint32_t unscaled_value)
+{
+	const uint32_t delta = unscaled_value - cache->unscaled;
+
+	if(scaling_factor != 0 &&
+	   scaling_factor == cache->factor &&
+	   unscaled_value >= cache->unscaled &&
+	   delta <= (((uint64_t) scaling_factor) * C_FIELD_SCALING_STEPS_MAX))
+	{
+		uint64_t residue = ((uint64_t) cache->residue) + delta;
+		uint32_t scaled = cache->scaled;
+
+		/* no more than C_FIELD_SCALING_STEPS_MAX + 1 iterations since the last
+		 * residue is smaller than the scaling factor */
+		while(residue >= scaling_factor)
+		{
+			residue -= scaling_factor;
+			scaled++;
+		}
+		*scaled_value = scaled;
+		*residue_field = (uint32_t) residue;
+		assert(unscaled_value ==
+		       (((*scaled_value) * scaling_factor) + (*residue_field)));
+	}
+	else
+	{
+		c_field_scaling(scaled_value, residue_field, scaling_factor,
+		                unscaled_value);
+	}
+
+	cache->factor = scaling_factor;
+	cache->unscaled = unscaled_value;
+	cache->scaled = *scaled_value;
+	cache->residue = *residue_field;
+}
+
+
 /**
  * @brief Is is possible to use the rsf_index_enc encoding?
  *
@@ -35,6 +35,21 @@
 struct rohc_comp_ctxt;
 
 
+/**
+ * @brief The last scaling of one field, see \ref c_field_scaling_cached
+ *
+ * The next scaling with the same scaling factor is derived from the last one
+ * by additions, as long as the field grows by a few scaling factors only.
+ */
+struct c_field_scaling_cache
+{
+	uint32_t factor;    /**< The last scaling factor, 0 if none */
+	uint32_t unscaled;  /**< The last unscaled value */
+	uint32_t scaled;    /**< The last scaled value */
+	uint32_t residue;   /**< The last residue */
+};
+
+
 /* static_or_irreg encoding for 8-bit and 16-bit values */
 int c_static_or_irreg8(const uint8_t context_value,
                        const uint8_t packet_value,
@@ -77,6 +92,12 @@ void c_field_scaling(uint32_t *const scaled_value,
                      const uint32_t scaling_factor,
                      const uint32_t unscaled_value)
 	__attribute__((nonnull(1, 2)));
+void c_field_scaling_cached(struct c_field_scaling_cache *const cache,
+                            uint32_t *const scaled_value,
+                            uint32_t *const residue_field,
+                            const uint32_t scaling_factor,
+                            const uint32_t unscaled_value)
+	__attribute__((nonnull(1, 2, 3)));
 
 // RFC4996 page 71
 bool rsf_index_enc_possible(const uint8_t rsf_flags)
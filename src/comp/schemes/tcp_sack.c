@@ -24,6 +24,10 @@
 
 #include "tcp_sack.h"
 
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
+
 
 static int c_tcp_sack_code_block(const struct rohc_comp_ctxt *const context,
                                  const uint32_t reference,
@@ -52,6 +56,7 @@ static int c_tcp_sack_code_pure_lsb(const struct rohc_comp_ctxt *const context,
  * @param length          The length of the SACK blocks
  * @param is_unchanged    Whether the SACK option is unchanged or not
  *                        (only for irregular chain, use false for list item)
+ * @param[in,out] cache   The last SACK option encoded for the context
  * @param[out] rohc_data  The ROHC packet being built
  * @param rohc_max_len    The max remaining length in the ROHC buffer
  * @return                The length appended in the ROHC buffer if positive,
@@ -62,6 +67,7 @@ int c_tcp_opt_sack_code(const struct rohc_comp_ctxt *const context,
                         const sack_block_t *const sack_blocks,
                         const uint8_t length,
                         const bool is_unchanged,
+                        struct c_tcp_sack_cache *const cache,
                         uint8_t *const rohc_data,
                         const size_t rohc_max_len)
 {
@@ -93,19 +99,53 @@ int c_tcp_opt_sack_code(const struct rohc_comp_ctxt *const context,
 	}
 	else
 	{
+		size_t cached_blocks_nr = 0;
 		uint32_t reference;
 
 		/* determine the number of SACK blocks
 		 * (integer division checked by \ref c_tcp_check_profile ) */
 		blocks_nr = length / sizeof(sack_block_t);
-		rohc_remain_data[0] = blocks_nr;
-		rohc_remain_data++;
-		rohc_remain_len--;
 
-		/* compress every SACK block, one by one:
+		/* re-use the last encoding if the ACK number did not change and if the
+		 * last SACK blocks are the first SACK blocks of the current option: the
+		 * option is either unchanged, or new blocks were appended */
+		if(cache->is_valid && cache->ack_value == ack_value &&
+		   cache->blocks_len <= length &&
+		   memcmp(cache->blocks, sack_blocks, cache->blocks_len) == 0)
+		{
+			if(rohc_max_len < cache->data_len)
+			{
+				rohc_comp_warn(context, "ROHC buffer too small for the TCP option "
+				               "SACK: %zu bytes required, but only %zu bytes "
+				               "available", cache->data_len, rohc_max_len);
+				goto error;
+			}
+			cached_blocks_nr = cache->blocks_len / sizeof(sack_block_t);
+			rohc_comp_debug(context, "re-use the encoding of the first %zu SACK "
+			                "blocks from previous packet", cached_blocks_nr);
+			memcpy(rohc_remain_data, cache->data, cache->data_len);
+			rohc_remain_data += cache->data_len;
+			rohc_remain_len -= cache->data_len;
+		}
+		else
+		{
+			rohc_remain_data++;
+			rohc_remain_len--;
+		}
+		rohc_data[0] = blocks_nr;
+
+		/* compress every other SACK block, one by one:
 		 *  - first block uses ACK as reference
 		 *  - next block uses current block end as reference */
-		for(i = 0, reference = ack_value, block = sack_blocks;
+		if(cached_blocks_nr == 0)
+		{
+			reference = ack_value;
+		}
+		else
+		{
+			reference = rohc_ntoh32(sack_blocks[cached_blocks_nr - 1].block_end);
+		}
+		for(i = cached_blocks_nr, block = sack_blocks + cached_blocks_nr;
 		    i < blocks_nr;
 		    i++, reference = rohc_ntoh32(block->block_end), block++)
 		{
@@ -123,6 +163,19 @@ int c_tcp_opt_sack_code(const struct rohc_comp_ctxt *const context,
 			rohc_remain_data += ret;
 			rohc_remain_len -= ret;
 		}
+
+		/* record the encoding for next packets */
+		if(cached_blocks_nr != blocks_nr || !cache->is_valid ||
+		   cache->ack_value != ack_value)
+		{
+			cache->data_len = rohc_max_len - rohc_remain_len;
+			assert(cache->data_len <= C_TCP_SACK_MAX_LEN);
+			memcpy(cache->data, rohc_data, cache->data_len);
+			memcpy(cache->blocks, sack_blocks, length);
+			cache->blocks_len = length;
+			cache->ack_value = ack_value;
+			cache->is_valid = true;
+		}
 	}
 
 	return (rohc_max_len - rohc_remain_len);
@@ -31,14 +31,43 @@
 #include <stddef.h>
 #include <stdint.h>
 
+/**
+ * @brief The maximum length (in bytes) of one compressed SACK option
+ *
+ * One byte for the number of blocks, then up to 5 bytes for the start and
+ * the end of each SACK block.
+ */
+#define C_TCP_SACK_MAX_LEN  (1U + TCP_SACK_BLOCKS_MAX_NR * 2U * 5U)
+
+
+/**
+ * @brief The last SACK option encoded for one compression context
+ *
+ * The encoding of one SACK option only depends on the ACK number and on the
+ * SACK blocks, so it can be re-used as long as they don't change, or the
+ * blocks that did not change can be re-used when new blocks are appended.
+ */
+struct c_tcp_sack_cache
+{
+	bool is_valid;                  /**< Whether the cache was filled or not */
+	uint8_t blocks_len;             /**< The length of the cached SACK blocks */
+	uint32_t ack_value;             /**< The cached ACK number (in HBO) */
+	/** The cached SACK blocks */
+	sack_block_t blocks[TCP_SACK_BLOCKS_MAX_NR];
+	size_t data_len;                /**< The length of the cached encoding */
+	uint8_t data[C_TCP_SACK_MAX_LEN]; /**< The cached encoding */
+};
+
+
 int c_tcp_opt_sack_code(const struct rohc_comp_ctxt *const context,
                         const uint32_t ack_value,
                         const sack_block_t *const sack_blocks,
                         const uint8_t length,
                         const bool is_unchanged,
+                        struct c_tcp_sack_cache *const cache,
                         uint8_t *const rohc_data,
                         const size_t rohc_max_len)
-	__attribute__((warn_unused_result, nonnull(1, 3, 6)));
+	__attribute__((warn_unused_result, nonnull(1, 3, 6, 7)));
 
 #endif /* ROHC_COMP_SCHEMES_TCP_SACK_H */
 
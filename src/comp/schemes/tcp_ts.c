@@ -29,6 +29,106 @@
 #endif
 
 
+/** The max number of values tracked by the prediction of TS fields */
+#define C_TCP_TS_PRED_RUN_MAX  0xffffU
+
+
+/**
+ * @brief Add the given timestamp to its W-LSB window and to its prediction
+ *
+ * All the values of the TS fields shall be added to the W-LSB windows with
+ * this function, so that the prediction knows the values in the window.
+ *
+ * @param pred       The prediction of the TS field
+ * @param wlsb       The W-LSB window of the TS field
+ * @param msn        The MSN of the packet the timestamp belongs to
+ * @param timestamp  The timestamp to add
+ */
+void c_tcp_ts_pred_add(struct c_tcp_ts_pred *const pred,
+                       struct c_wlsb *const wlsb,
+                       const uint32_t msn,
+                       const uint32_t timestamp)
+{
+	const uint32_t delta = timestamp - pred->last;
+
+	c_add_wlsb(wlsb, msn, timestamp);
+
+	if(pred->run_nr == 0)
+	{
+		/* first value */
+		pred->run_nr = 1;
+	}
+	else if(pred->run_nr == 1 || delta != pred->delta)
+	{
+		/* the last 2 values define a new delta */
+		pred->delta = delta;
+		pred->run_nr = 2;
+	}
+	else if(pred->run_nr < C_TCP_TS_PRED_RUN_MAX)
+	{
+		pred->run_nr++;
+	}
+	pred->last = timestamp;
+}
+
+
+/**
+ * @brief Get the LSB widths required to encode the given timestamp
+ *
+ * Same as wlsb_get_kps_32bits() with the shift parameters of the TCP TS
+ * encoding, but the LSB widths are taken from the prediction if every value
+ * in the window is a multiple of the same delta away from the timestamp and
+ * if they were already computed for that delta and that window size.
+ *
+ * @param pred          The prediction of the TS field
+ * @param wlsb          The W-LSB window of the TS field
+ * @param timestamp     The timestamp to encode
+ * @param[out] bits_nr  The LSB widths for p = -1, 0x40000 and 0x4000000
+ */
+void c_tcp_ts_get_lsb_bits(struct c_tcp_ts_pred *const pred,
+                           const struct c_wlsb *const wlsb,
+                           const uint32_t timestamp,
+                           size_t bits_nr[C_TCP_TS_PS_NR])
+{
+	const rohc_lsb_shift_t ps[C_TCP_TS_PS_NR] = {
+		ROHC_LSB_SHIFT_TCP_TS_1B, ROHC_LSB_SHIFT_TCP_TS_3B, ROHC_LSB_SHIFT_TCP_TS_4B
+	};
+	const size_t count = wlsb_get_count(wlsb);
+	const uint32_t delta = timestamp - pred->last;
+	/* the values in the window are the last ones added, so they are all
+	 * multiples of delta away from the timestamp if the last ones grew by
+	 * the same delta */
+	const bool is_predictable =
+		(count > 0 && count <= pred->run_nr &&
+		 (pred->run_nr == 1 || delta == pred->delta));
+	size_t i;
+
+	if(is_predictable && pred->is_cached &&
+	   pred->cache_delta == delta && pred->cache_count == count)
+	{
+		for(i = 0; i < C_TCP_TS_PS_NR; i++)
+		{
+			bits_nr[i] = pred->cache_bits[i];
+		}
+	}
+	else
+	{
+		/* browse the window once for all the shift parameters */
+		wlsb_get_kps_32bits(wlsb, timestamp, ps, C_TCP_TS_PS_NR, bits_nr);
+		if(is_predictable)
+		{
+			pred->is_cached = true;
+			pred->cache_delta = delta;
+			pred->cache_count = count;
+			for(i = 0; i < C_TCP_TS_PS_NR; i++)
+			{
+				pred->cache_bits[i] = bits_nr[i];
+			}
+		}
+	}
+}
+
+
 /**
  * @brief Compress the TimeStamp option value
  *
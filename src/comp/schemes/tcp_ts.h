@@ -26,10 +26,53 @@
 #define ROHC_COMP_SCHEMES_TCP_TS_H
 
 #include "rohc_comp_internals.h"
+#include "schemes/comp_wlsb.h"
 
 #include <stddef.h>
 #include <stdint.h>
 
+
+/** The number of shift parameters of the TCP TS encoding, see RFC4996 page 65 */
+#define C_TCP_TS_PS_NR  3U
+
+
+/**
+ * @brief The prediction of the LSB widths of one field of the TCP TS option
+ *
+ * The echo request of a long-lived flow often grows by a constant delta
+ * between packets, and the echo reply often repeats. Once the values in the
+ * W-LSB window are all a multiple of the same delta away from the new value,
+ * the LSB widths only depend on that delta and on the number of values in
+ * the window: they are cached for them, so that the window is not browsed
+ * again while the prediction holds.
+ */
+struct c_tcp_ts_pred
+{
+	uint32_t last;         /**< The last value added to the W-LSB window */
+	uint32_t delta;        /**< The delta between the last values */
+	/** The number of last values added to the window that grow by \e delta */
+	size_t run_nr;
+
+	bool is_cached;        /**< Whether the LSB widths below were cached */
+	uint32_t cache_delta;  /**< The delta the LSB widths were cached for */
+	size_t cache_count;    /**< The window size they were cached for */
+	/** The cached LSB widths, one per shift parameter */
+	size_t cache_bits[C_TCP_TS_PS_NR];
+};
+
+
+void c_tcp_ts_pred_add(struct c_tcp_ts_pred *const pred,
+                       struct c_wlsb *const wlsb,
+                       const uint32_t msn,
+                       const uint32_t timestamp)
+	__attribute__((nonnull(1, 2)));
+
+void c_tcp_ts_get_lsb_bits(struct c_tcp_ts_pred *const pred,
+                           const struct c_wlsb *const wlsb,
+                           const uint32_t timestamp,
+                           size_t bits_nr[C_TCP_TS_PS_NR])
+	__attribute__((nonnull(1, 2, 4)));
+
 bool c_tcp_ts_lsb_code(const struct rohc_comp_ctxt *const context,
                        const uint32_t timestamp,
                        const size_t nr_bits_minus_1,
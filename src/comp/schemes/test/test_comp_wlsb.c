@@ -0,0 +1,801 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_comp_wlsb.c
+ * @brief  Test the number of bits computed by the W-LSB encoding
+ * @author Didier Barvaux <didier@barvaux.org>
+ */
+
+#include "comp_wlsb.h"
+#include "interval.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+
+/** The maximum width of the W-LSB sliding window in the test */
+#define TEST_WLSB_WINDOW_MAX_WIDTH  16U
+
+/** The number of values to encode for every test configuration */
+#define TEST_WLSB_VALUES_NR  2000U
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+
+/** The values stored in the W-LSB window, as expected by the test */
+struct test_window
+{
+	uint32_t values[TEST_WLSB_VALUES_NR];  /**< All the values ever added */
+	uint32_t sns[TEST_WLSB_VALUES_NR];     /**< The SNs of all the values */
+	size_t first;                          /**< The oldest value in window */
+	size_t next;                           /**< The next value to add */
+};
+
+
+static bool run_test_wlsb_get_k(const bool be_verbose,
+                                const size_t field_bits,
+                                const size_t bits,
+                                const size_t window_width,
+                                const rohc_lsb_shift_t p)
+	__attribute__((warn_unused_result));
+
+static bool run_test_wlsb_all_offsets(const bool be_verbose,
+                                      const size_t field_bits,
+                                      const size_t bits,
+                                      const rohc_lsb_shift_t p)
+	__attribute__((warn_unused_result));
+
+static bool check_wlsb_get_k(struct c_wlsb *const wlsb,
+                             const struct test_window *const window,
+                             const uint32_t value,
+                             const size_t min_k,
+                             const rohc_lsb_shift_t p,
+                             const size_t bits,
+                             const size_t field_bits)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool run_test_wlsb_ack(const bool be_verbose,
+                              const size_t window_width,
+                              const size_t sn_bits_nr,
+                              const bool is_multi)
+	__attribute__((warn_unused_result));
+
+static size_t ref_get_k(const struct test_window *const window,
+                        const uint32_t value,
+                        const size_t min_k,
+                        const rohc_lsb_shift_t p,
+                        const size_t bits,
+                        const size_t field_bits)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static size_t ref_ack(struct test_window *const window,
+                      const uint32_t sn_bits,
+                      const size_t sn_bits_nr)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static uint32_t test_rand(void)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Test the number of bits computed by the W-LSB encoding
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if test succeeds, non-zero if test fails
+ */
+int main(int argc, char *argv[])
+{
+	const rohc_lsb_shift_t p_params[] = {
+		ROHC_LSB_SHIFT_SN,
+		ROHC_LSB_SHIFT_IP_ID,
+		ROHC_LSB_SHIFT_TCP_TTL,
+		ROHC_LSB_SHIFT_TCP_SN,
+		ROHC_LSB_SHIFT_TCP_SEQ_SCALED,
+		ROHC_LSB_SHIFT_TCP_WINDOW,
+		ROHC_LSB_SHIFT_RTP_TS,
+		ROHC_LSB_SHIFT_RTP_SN,
+		ROHC_LSB_SHIFT_ESP_SN,
+	};
+	const size_t p_nums = sizeof(p_params) / sizeof(rohc_lsb_shift_t);
+	const size_t fields[][2] = {
+		/* size of field, number of bits for the value */
+		{ 8, 8 }, { 8, 4 }, { 16, 16 }, { 16, 12 }, { 32, 32 }, { 32, 20 },
+	};
+	const size_t fields_nr = sizeof(fields) / sizeof(fields[0]);
+	const size_t sn_bits_nrs[] = { 4, 6, 8, 12, 16, 32 };
+	const size_t sn_bits_nrs_nr = sizeof(sn_bits_nrs) / sizeof(size_t);
+	size_t sn_bits_index;
+	size_t p_index;
+
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("test the number of bits computed by the W-LSB encoding\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	for(p_index = 0; p_index < p_nums; p_index++)
+	{
+		size_t field_index;
+
+		for(field_index = 0; field_index < fields_nr; field_index++)
+		{
+			size_t window_width;
+
+			for(window_width = 1; window_width <= TEST_WLSB_WINDOW_MAX_WIDTH;
+			    window_width *= 4)
+			{
+				trace(verbose, "run test with %zu-bit field, %zu-bit values, "
+				      "window width %zu and shift parameter %d\n",
+				      fields[field_index][0], fields[field_index][1],
+				      window_width, p_params[p_index]);
+				if(!run_test_wlsb_get_k(verbose, fields[field_index][0],
+				                        fields[field_index][1], window_width,
+				                        p_params[p_index]))
+				{
+					fprintf(stderr, "test with %zu-bit field, %zu-bit values, "
+					        "window width %zu and shift parameter %d failed\n",
+					        fields[field_index][0], fields[field_index][1],
+					        window_width, p_params[p_index]);
+					goto error;
+				}
+			}
+
+			trace(verbose, "run test with %zu-bit field, %zu-bit values, "
+			      "one reference value and shift parameter %d\n",
+			      fields[field_index][0], fields[field_index][1],
+			      p_params[p_index]);
+			if(!run_test_wlsb_all_offsets(verbose, fields[field_index][0],
+			                              fields[field_index][1],
+			                              p_params[p_index]))
+			{
+				fprintf(stderr, "test with %zu-bit field, %zu-bit values, "
+				        "one reference value and shift parameter %d failed\n",
+				        fields[field_index][0], fields[field_index][1],
+				        p_params[p_index]);
+				goto error;
+			}
+		}
+	}
+
+	for(sn_bits_index = 0; sn_bits_index < sn_bits_nrs_nr; sn_bits_index++)
+	{
+		size_t window_width;
+
+		for(window_width = 1; window_width <= TEST_WLSB_WINDOW_MAX_WIDTH;
+		    window_width *= 2)
+		{
+			size_t is_multi;
+
+			for(is_multi = 0; is_multi <= 1; is_multi++)
+			{
+				trace(verbose, "run acknowledgement test with %s window of width "
+				      "%zu and %zu-bit SN\n", is_multi ? "multi-field" : "one-field",
+				      window_width, sn_bits_nrs[sn_bits_index]);
+				if(!run_test_wlsb_ack(verbose, window_width,
+				                      sn_bits_nrs[sn_bits_index], !!is_multi))
+				{
+					fprintf(stderr, "acknowledgement test with %s window of width "
+					        "%zu and %zu-bit SN failed\n",
+					        is_multi ? "multi-field" : "one-field", window_width,
+					        sn_bits_nrs[sn_bits_index]);
+					goto error;
+				}
+			}
+		}
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Compare the number of bits given by W-LSB with a reference
+ *
+ * Values close to the previous ones and random values are added to the
+ * window, some of them are acknowledged so that the window is partially
+ * filled and wraps around the end of its ring buffer.
+ *
+ * @param be_verbose    Whether to print traces or not
+ * @param field_bits    The size of the field (8, 16 or 32 bits)
+ * @param bits          The number of bits for the values
+ * @param window_width  The width of the W-LSB window
+ * @param p             The shift parameter
+ * @return              true if test succeeds, false otherwise
+ */
+static bool run_test_wlsb_get_k(const bool be_verbose,
+                                const size_t field_bits,
+                                const size_t bits,
+                                const size_t window_width,
+                                const rohc_lsb_shift_t p)
+{
+	static struct test_window window;
+	const uint32_t value_mask =
+		(bits == 32 ? 0xffffffff : ((1U << bits) - 1));
+	struct c_wlsb *wlsb;
+	uint32_t value = ((test_rand() << 12) ^ test_rand()) & value_mask;
+	size_t i;
+	bool is_success = false;
+
+	wlsb = c_create_wlsb(NULL, bits, window_width, p);
+	if(wlsb == NULL)
+	{
+		fprintf(stderr, "no memory to allocate W-LSB encoding\n");
+		goto error;
+	}
+	window.first = 0;
+	window.next = 0;
+
+	for(i = 0; i < TEST_WLSB_VALUES_NR; i++)
+	{
+		const size_t min_k = test_rand() % bits;
+
+		/* next value is either close to the previous one or random */
+		if((test_rand() % 4) == 0)
+		{
+			value = ((test_rand() << 12) ^ test_rand()) & value_mask;
+		}
+		else
+		{
+			value = (value + (test_rand() % 64) - 16) & value_mask;
+		}
+
+		/* compare the number of bits with the reference */
+		if(!check_wlsb_get_k(wlsb, &window, value, min_k, p, bits, field_bits))
+		{
+			fprintf(stderr, "value #%zu is not correctly encoded\n", i);
+			goto destroy_wlsb;
+		}
+
+		/* add the value in the window */
+		c_add_wlsb(wlsb, i, value);
+		window.values[window.next] = value;
+		window.sns[window.next] = i;
+		window.next++;
+		if((window.next - window.first) > window_width)
+		{
+			window.first++;
+		}
+
+		/* acknowledge some values from time to time */
+		if((test_rand() % 8) == 0)
+		{
+			const size_t acked_sn =
+				window.first + test_rand() % (window.next - window.first);
+			const size_t expected_acked_nr = ref_ack(&window, acked_sn, 32);
+			const size_t acked_nr = wlsb_ack(wlsb, acked_sn, 32);
+
+			if(acked_nr != expected_acked_nr)
+			{
+				fprintf(stderr, "SN %zu: %zu entries acknowledged while %zu "
+				        "entries expected\n", acked_sn, acked_nr, expected_acked_nr);
+				goto destroy_wlsb;
+			}
+		}
+	}
+	trace(be_verbose, "\t%zu values successfully tested\n", i);
+
+	is_success = true;
+
+destroy_wlsb:
+	c_destroy_wlsb(wlsb);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Compare the number of bits given by W-LSB for one reference value
+ *
+ * The window holds one single reference value. For 8-bit fields, all the
+ * couples of reference value and value to encode are tested. For larger
+ * fields, the values to encode are taken around the reference value and
+ * around the offsets 2^k and -2^k where the number of bits changes.
+ *
+ * @param be_verbose  Whether to print traces or not
+ * @param field_bits  The size of the field (8, 16 or 32 bits)
+ * @param bits        The number of bits for the values
+ * @param p           The shift parameter
+ * @return            true if test succeeds, false otherwise
+ */
+static bool run_test_wlsb_all_offsets(const bool be_verbose,
+                                      const size_t field_bits,
+                                      const size_t bits,
+                                      const rohc_lsb_shift_t p)
+{
+	static struct test_window window;
+	const uint32_t value_mask =
+		(bits == 32 ? 0xffffffff : ((1U << bits) - 1));
+	const size_t refs_nr = (field_bits == 8 ? (value_mask + 1) : 64);
+	struct c_wlsb *wlsb;
+	size_t tests_nr = 0;
+	size_t i;
+	bool is_success = false;
+
+	wlsb = c_create_wlsb(NULL, bits, 1, p);
+	if(wlsb == NULL)
+	{
+		fprintf(stderr, "no memory to allocate W-LSB encoding\n");
+		goto error;
+	}
+
+	for(i = 0; i < refs_nr; i++)
+	{
+		uint32_t v_ref;
+
+		if(field_bits == 8)
+		{
+			v_ref = i;
+		}
+		else if(i < 2)
+		{
+			/* the first and last values of the field */
+			v_ref = (i == 0 ? 0 : value_mask);
+		}
+		else
+		{
+			v_ref = ((test_rand() << 12) ^ test_rand()) & value_mask;
+		}
+
+		/* the window contains the reference value only */
+		c_add_wlsb(wlsb, i, v_ref);
+		window.values[0] = v_ref;
+		window.sns[0] = i;
+		window.first = 0;
+		window.next = 1;
+
+		if(field_bits == 8)
+		{
+			uint32_t value;
+
+			for(value = 0; value <= value_mask; value++)
+			{
+				if(!check_wlsb_get_k(wlsb, &window, value, 0, p, bits, field_bits))
+				{
+					goto destroy_wlsb;
+				}
+				tests_nr++;
+			}
+		}
+		else
+		{
+			const size_t min_k = test_rand() % bits;
+			size_t k;
+
+			for(k = 0; k < bits; k++)
+			{
+				const uint32_t offset = (1U << k);
+				int32_t delta;
+
+				for(delta = -3; delta <= 3; delta++)
+				{
+					const uint32_t value_plus =
+						(v_ref + offset + (uint32_t) delta) & value_mask;
+					const uint32_t value_minus =
+						(v_ref - offset + (uint32_t) delta) & value_mask;
+
+					if(!check_wlsb_get_k(wlsb, &window, value_plus, min_k, p, bits,
+					                     field_bits) ||
+					   !check_wlsb_get_k(wlsb, &window, value_minus, min_k, p, bits,
+					                     field_bits))
+					{
+						goto destroy_wlsb;
+					}
+					tests_nr += 2;
+				}
+			}
+		}
+	}
+	trace(be_verbose, "\t%zu values successfully tested\n", tests_nr);
+
+	is_success = true;
+
+destroy_wlsb:
+	c_destroy_wlsb(wlsb);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Compare the entries acknowledged by W-LSB with a reference
+ *
+ * The SNs mostly grow one by one, with some gaps, some duplicates, some
+ * reordering and some wraparounds of 16-bit SNs, so that both the search
+ * on growing SNs and the search on the whole window are exercised. The
+ * acknowledged SNs are either in the window or random.
+ *
+ * The multi-field window stores a second field along the SN, it shall be
+ * acknowledged along the SN.
+ *
+ * @param be_verbose    Whether to print traces or not
+ * @param window_width  The width of the W-LSB window
+ * @param sn_bits_nr    The number of SN bits in acknowledgements
+ * @param is_multi      Whether to test a multi-field window
+ * @return              true if test succeeds, false otherwise
+ */
+static bool run_test_wlsb_ack(const bool be_verbose,
+                              const size_t window_width,
+                              const size_t sn_bits_nr,
+                              const bool is_multi)
+{
+	static struct test_window window;
+	static struct test_window window2;
+	const uint32_t sn_mask =
+		(sn_bits_nr == 32 ? 0xffffffff : ((1U << sn_bits_nr) - 1));
+	struct c_wlsb *wlsb;
+	uint32_t sn = test_rand();
+	size_t width = window_width;
+	size_t acks_nr = 0;
+	size_t i;
+	bool is_success = false;
+
+	if(is_multi)
+	{
+		const size_t bits[2] = { 32, 32 };
+		const rohc_lsb_shift_t ps[2] = { ROHC_LSB_SHIFT_SN, ROHC_LSB_SHIFT_SN };
+		wlsb = c_create_wlsb_multi(NULL, 2, bits, window_width, ps);
+	}
+	else
+	{
+		wlsb = c_create_wlsb(NULL, 32, window_width, ROHC_LSB_SHIFT_SN);
+	}
+	if(wlsb == NULL)
+	{
+		fprintf(stderr, "no memory to allocate W-LSB encoding\n");
+		goto error;
+	}
+	window.first = 0;
+	window.next = 0;
+
+	for(i = 0; i < TEST_WLSB_VALUES_NR; i++)
+	{
+		const uint32_t step_type = test_rand() % 32;
+
+		/* next SN is mostly the previous SN + 1 */
+		if(step_type == 0)
+		{
+			sn += test_rand() % 300; /* gap */
+		}
+		else if(step_type == 1)
+		{
+			/* duplicate SN */
+		}
+		else if(step_type == 2)
+		{
+			sn -= 1 + test_rand() % 3; /* reordering */
+		}
+		else if(step_type == 3)
+		{
+			sn = (sn + 1) & 0xffff; /* 16-bit SN */
+		}
+		else
+		{
+			sn++;
+		}
+
+		/* add the SN in the window, and a second field derived from the SN
+		 * in the multi-field window */
+		if(is_multi)
+		{
+			const uint32_t values[2] = { sn, sn * 7 + 1 };
+			c_add_wlsb_multi(wlsb, sn, values);
+		}
+		else
+		{
+			c_add_wlsb(wlsb, sn, sn);
+		}
+		window2.values[window.next] = sn * 7 + 1;
+		window.values[window.next] = sn;
+		window.sns[window.next] = sn;
+		window.next++;
+		if((window.next - window.first) > width)
+		{
+			window.first++;
+		}
+
+		/* shrink or widen the window from time to time, up to its capacity */
+		if((test_rand() % 64) == 0)
+		{
+			width = 1U << (test_rand() % 6);
+			c_wlsb_set_width(wlsb, width);
+			width = (width > window_width ? window_width : width);
+			while((window.next - window.first) > width)
+			{
+				window.first++;
+			}
+		}
+
+		/* acknowledge some SNs from time to time */
+		if((test_rand() % 4) == 0)
+		{
+			uint32_t acked_sn;
+			size_t expected_acked_nr;
+			size_t acked_nr;
+
+			if((test_rand() % 4) == 0)
+			{
+				acked_sn = (test_rand() << 12) ^ test_rand();
+			}
+			else
+			{
+				acked_sn = window.sns[window.first +
+				                      test_rand() % (window.next - window.first)];
+			}
+			acked_sn &= sn_mask;
+
+			expected_acked_nr = ref_ack(&window, acked_sn, sn_bits_nr);
+			acked_nr = wlsb_ack(wlsb, acked_sn, sn_bits_nr);
+			if(acked_nr != expected_acked_nr)
+			{
+				fprintf(stderr, "SN #%zu 0x%08x: %zu entries acknowledged "
+				        "while %zu entries expected\n", i, acked_sn, acked_nr,
+				        expected_acked_nr);
+				goto destroy_wlsb;
+			}
+			acks_nr++;
+		}
+
+		/* the values left in the window shall be the expected ones */
+		if(wlsb_get_count(wlsb) != (window.next - window.first))
+		{
+			fprintf(stderr, "SN #%zu: %zu entries in window while %zu entries "
+			        "expected\n", i, wlsb_get_count(wlsb),
+			        window.next - window.first);
+			goto destroy_wlsb;
+		}
+		if(!check_wlsb_get_k(wlsb, &window, sn + 1000, 0,
+		                     ROHC_LSB_SHIFT_SN, 32, 32))
+		{
+			fprintf(stderr, "SN #%zu: unexpected values in window\n", i);
+			goto destroy_wlsb;
+		}
+		window2.first = window.first;
+		window2.next = window.next;
+		if(is_multi &&
+		   !check_wlsb_get_k(c_wlsb_get_field(wlsb, 1), &window2,
+		                     sn * 7 + 1 + 1000, 0, ROHC_LSB_SHIFT_SN, 32, 32))
+		{
+			fprintf(stderr, "SN #%zu: unexpected values in second field of "
+			        "window\n", i);
+			goto destroy_wlsb;
+		}
+	}
+	trace(be_verbose, "\t%zu acknowledgements successfully tested\n",
+	      acks_nr);
+
+	is_success = true;
+
+destroy_wlsb:
+	c_destroy_wlsb(wlsb);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Check the number of bits given by W-LSB against the reference
+ *
+ * @param wlsb        The W-LSB encoding to test
+ * @param window      The values in the window
+ * @param value       The value to encode
+ * @param min_k       The minimum number of bits to find out
+ * @param p           The shift parameter
+ * @param bits        The number of bits for the values
+ * @param field_bits  The size of the field (8, 16 or 32 bits)
+ * @return            true if the number of bits is the expected one,
+ *                    false otherwise
+ */
+static bool check_wlsb_get_k(struct c_wlsb *const wlsb,
+                             const struct test_window *const window,
+                             const uint32_t value,
+                             const size_t min_k,
+                             const rohc_lsb_shift_t p,
+                             const size_t bits,
+                             const size_t field_bits)
+{
+	size_t expected_k;
+	size_t k;
+
+	if(field_bits == 8)
+	{
+		expected_k = ref_get_k(window, value, 0, p, bits, field_bits);
+		k = wlsb_get_kp_8bits(wlsb, value, p);
+	}
+	else if(field_bits == 16)
+	{
+		expected_k = ref_get_k(window, value, min_k, p, bits, field_bits);
+		k = wlsb_get_minkp_16bits(wlsb, value, min_k, p);
+	}
+	else
+	{
+		const rohc_lsb_shift_t ps[] = { p, 63, 65535 };
+		size_t ks[sizeof(ps) / sizeof(rohc_lsb_shift_t)];
+		size_t i;
+
+		/* several shift parameters at once shall give the same results as
+		 * one shift parameter at a time */
+		wlsb_get_kps_32bits(wlsb, value, ps, sizeof(ps) / sizeof(rohc_lsb_shift_t),
+		                    ks);
+		for(i = 0; i < (sizeof(ps) / sizeof(rohc_lsb_shift_t)); i++)
+		{
+			expected_k = ref_get_k(window, value, 0, ps[i], bits, field_bits);
+			if(ks[i] != expected_k)
+			{
+				fprintf(stderr, "value 0x%08x with reference 0x%08x and p = %d: "
+				        "%zu bits computed for several shift parameters while %zu "
+				        "bits expected\n", value, window->values[window->first],
+				        ps[i], ks[i], expected_k);
+				return false;
+			}
+		}
+
+		expected_k = ref_get_k(window, value, min_k, p, bits, field_bits);
+		k = wlsb_get_minkp_32bits(wlsb, value, min_k, p);
+	}
+	if(k != expected_k)
+	{
+		fprintf(stderr, "value 0x%08x with reference 0x%08x: %zu bits computed "
+		        "while %zu bits expected\n", value, window->values[window->first],
+		        k, expected_k);
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Compute the number of bits for the given value as RFC 3095 does
+ *
+ * For every value in the window, find the minimal k so that the value to
+ * encode falls into the interval f(v_ref, k), then take the highest k.
+ *
+ * @param window      The values in the window
+ * @param value       The value to encode
+ * @param min_k       The minimum number of bits to find out
+ * @param p           The shift parameter
+ * @param bits        The number of bits for the values
+ * @param field_bits  The size of the field (8, 16 or 32 bits)
+ * @return            The expected number of bits
+ */
+static size_t ref_get_k(const struct test_window *const window,
+                        const uint32_t value,
+                        const size_t min_k,
+                        const rohc_lsb_shift_t p,
+                        const size_t bits,
+                        const size_t field_bits)
+{
+	const uint32_t field_mask =
+		(field_bits == 32 ? 0xffffffff : ((1U << field_bits) - 1));
+	size_t bits_nr;
+	size_t i;
+
+	if(window->first == window->next)
+	{
+		return bits;
+	}
+
+	bits_nr = 0;
+	for(i = window->first; i < window->next; i++)
+	{
+		size_t k;
+
+		for(k = min_k; k < bits; k++)
+		{
+			const struct rohc_interval32 interval =
+				rohc_f_32bits(window->values[i], k, p);
+			const uint32_t min = interval.min & field_mask;
+			const uint32_t max = interval.max & field_mask;
+
+			if(min <= max && value >= min && value <= max)
+			{
+				break;
+			}
+			else if(min > max && (value >= min || value <= max))
+			{
+				break;
+			}
+		}
+		if(k > bits_nr)
+		{
+			bits_nr = k;
+		}
+	}
+
+	return bits_nr;
+}
+
+
+/**
+ * @brief Acknowledge the entries of the window as RFC 3095 does
+ *
+ * Search for the newest entry whose SN matches the acknowledged SN bits, then
+ * remove all the entries older than that one.
+ *
+ * @param window      The values in the window
+ * @param sn_bits     The LSB of the SN to acknowledge
+ * @param sn_bits_nr  The number of LSB of the SN to acknowledge
+ * @return            The number of acknowledged entries
+ */
+static size_t ref_ack(struct test_window *const window,
+                      const uint32_t sn_bits,
+                      const size_t sn_bits_nr)
+{
+	const uint32_t sn_mask =
+		(sn_bits_nr == 32 ? 0xffffffff : ((1U << sn_bits_nr) - 1));
+	size_t i;
+
+	for(i = window->next; i > window->first; i--)
+	{
+		if((window->sns[i - 1] & sn_mask) == sn_bits)
+		{
+			const size_t acked_nr = i - 1 - window->first;
+			window->first = i - 1;
+			return acked_nr;
+		}
+	}
+
+	return 0;
+}
+
+
+/**
+ * @brief Get a pseudo-random number, the same ones for every run
+ *
+ * @return  The pseudo-random number
+ */
+static uint32_t test_rand(void)
+{
+	static uint32_t seed = 42;
+
+	seed = seed * 1103515245U + 12345U;
+
+	return (seed >> 8);
+}
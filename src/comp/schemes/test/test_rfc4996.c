@@ -167,7 +167,7 @@ static bool run_test_variable_length_32_enc(const bool be_verbose)
 	};
 
 	/* create the W-LSB context */
-	wlsb = c_create_wlsb(32, ROHC_WLSB_WINDOW_WIDTH, ROHC_LSB_SHIFT_VAR);
+	wlsb = c_create_wlsb(NULL, 32, ROHC_WLSB_WINDOW_WIDTH, ROHC_LSB_SHIFT_VAR);
 	if(wlsb == NULL)
 	{
 		trace(be_verbose, "failed to create W-LSB context\n");
@@ -26,6 +26,7 @@
 #include "rohc_comp.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include <assert.h>
@@ -52,6 +53,26 @@ static int random_cb(const struct rohc_comp *const comp,
                      void *const user_context)
 	__attribute__((warn_unused_result));
 
+static void * alloc_cb(const size_t size, void *const priv)
+	__attribute__((warn_unused_result));
+static void free_cb(void *const ptr, void *const priv);
+static void * count_alloc_cb(const size_t size, void *const priv)
+	__attribute__((warn_unused_result));
+static void count_free_cb(void *const ptr, void *const priv);
+
+static void count_trace_cb(void *const priv_ctxt,
+                           const rohc_trace_level_t level,
+                           const rohc_trace_entity_t entity,
+                           const int profile,
+                           const char *const format,
+                           ...)
+	__attribute__((format(printf, 5, 6)));
+
+static unsigned int priority_cb(const unsigned char *const packet,
+                                const size_t packet_len,
+                                void *const priv_ctxt)
+	__attribute__((warn_unused_result));
+
 
 /**
  * @brief Test the robustness of the compression API
@@ -109,6 +130,93 @@ int main(int argc, char *argv[])
 	                     random_cb, NULL) == NULL);
 	CHECK(rohc_comp_new2(ROHC_LARGE_CID, ROHC_LARGE_CID_MAX,
 	                     NULL, NULL) == NULL);
+
+	/* rohc_comp_new3() */
+	{
+		size_t allocs_nr = 0;
+		const struct rohc_mem_ops no_free_ops = {
+			.alloc = count_alloc_cb, .free = NULL, .priv = &allocs_nr
+		};
+		const struct rohc_mem_ops mem_ops = {
+			.alloc = count_alloc_cb, .free = count_free_cb, .priv = &allocs_nr
+		};
+
+		CHECK(rohc_comp_new3(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL,
+		                     &no_free_ops) == NULL);
+		CHECK(allocs_nr == 0);
+		comp = rohc_comp_new3(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL,
+		                      NULL);
+		CHECK(comp != NULL);
+		rohc_comp_free(comp);
+		comp = rohc_comp_new3(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL,
+		                      &mem_ops);
+		CHECK(comp != NULL);
+		CHECK(allocs_nr > 0);
+		{
+			const size_t allocs_nr_before = allocs_nr;
+			CHECK(rohc_comp_set_mrru(comp, 500) == true);
+			CHECK(allocs_nr == (allocs_nr_before + 1));
+		}
+		CHECK(rohc_comp_set_alloc_cbs(comp, NULL, NULL, NULL) == true);
+		rohc_comp_free(comp);
+		CHECK(allocs_nr == 0);
+	}
+
+	/* rohc_comp_mem_size() and rohc_comp_new_static() */
+	{
+		const rohc_profile_t profiles[] = {
+			ROHC_PROFILE_UNCOMPRESSED, ROHC_PROFILE_IP, ROHC_PROFILE_UDP
+		};
+		const size_t profiles_nr = sizeof(profiles) / sizeof(profiles[0]);
+		const rohc_profile_t unknown_profile = ROHC_PROFILE_UDPLITE_RTP;
+		size_t mem_len;
+		void *mem;
+
+		CHECK(rohc_comp_mem_size(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX + 1,
+		                         profiles, profiles_nr, 4) == 0);
+		CHECK(rohc_comp_mem_size(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                         NULL, profiles_nr, 4) == 0);
+		CHECK(rohc_comp_mem_size(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                         profiles, 0, 4) == 0);
+		CHECK(rohc_comp_mem_size(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                         profiles, profiles_nr, 0) == 0);
+		CHECK(rohc_comp_mem_size(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                         profiles, profiles_nr, 3) == 0);
+		CHECK(rohc_comp_mem_size(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                         &unknown_profile, 1, 4) == 0);
+		mem_len = rohc_comp_mem_size(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                             profiles, profiles_nr, 4);
+		CHECK(mem_len > 0);
+		CHECK(rohc_comp_mem_size(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                         profiles, profiles_nr, 16) > mem_len);
+		CHECK(rohc_comp_mem_size(ROHC_LARGE_CID, ROHC_LARGE_CID_MAX,
+		                         profiles, profiles_nr, 4) > mem_len);
+
+		mem = malloc(mem_len);
+		CHECK(mem != NULL);
+		CHECK(rohc_comp_new_static(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb,
+		                           NULL, NULL, mem_len) == NULL);
+		CHECK(rohc_comp_new_static(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb,
+		                           NULL, mem, 64) == NULL);
+		CHECK(rohc_comp_new_static(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, NULL,
+		                           NULL, mem, mem_len) == NULL);
+		comp = rohc_comp_new_static(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb,
+		                            NULL, mem, mem_len);
+		CHECK(comp != NULL);
+		CHECK(rohc_comp_set_alloc_cbs(comp, NULL, NULL, NULL) == false);
+		CHECK(rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+		                                ROHC_PROFILE_IP, ROHC_PROFILE_UDP,
+		                                -1) == true);
+		rohc_comp_free(comp);
+
+		/* the block may be used again once the compressor is destroyed */
+		comp = rohc_comp_new_static(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb,
+		                            NULL, ((unsigned char *) mem) + 1, mem_len - 1);
+		CHECK(comp != NULL);
+		rohc_comp_free(comp);
+		free(mem);
+	}
+
 	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
 	                      random_cb, NULL);
 	CHECK(comp != NULL);
@@ -121,6 +229,63 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_set_traces_cb2(comp, fct, comp) == true);
 	}
 
+	/* rohc_comp_set_trace_ring() */
+	{
+		struct rohc_trace_record records[4];
+		struct rohc_trace_ring ring;
+		CHECK(rohc_trace_ring_init(&ring, records, 4) == true);
+		CHECK(rohc_comp_set_trace_ring(NULL, &ring) == false);
+		CHECK(rohc_comp_set_trace_ring(comp, &ring) == true);
+		CHECK(rohc_comp_set_trace_ring(comp, NULL) == true);
+	}
+
+	/* rohc_comp_set_trace_events() */
+	CHECK(rohc_comp_set_trace_events(NULL, ROHC_TRACE_EVENTS_ALL) == false);
+	CHECK(rohc_comp_set_trace_events(comp, ROHC_TRACE_EVENT_BIT(ROHC_TRACE_EVENT_MAX)) == false);
+	CHECK(rohc_comp_set_trace_events(comp, 0) == true);
+	CHECK(rohc_comp_set_trace_events(comp, ROHC_TRACE_EVENTS_CTXT) == true);
+	CHECK(rohc_comp_set_trace_events(comp, ROHC_TRACE_EVENTS_ALL) == true);
+
+	/* rohc_comp_trace_filter_*() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+
+		CHECK(rohc_comp_trace_filter_add_cid(NULL, 0) == false);
+		CHECK(rohc_comp_trace_filter_add_cid(comp, ROHC_SMALL_CID_MAX + 1) == false);
+		for(size_t i = 0; i < ROHC_TRACE_FILTER_MAX; i++)
+		{
+			CHECK(rohc_comp_trace_filter_add_cid(comp, i) == true);
+		}
+		CHECK(rohc_comp_trace_filter_add_cid(comp, 0) == true);
+		CHECK(rohc_comp_trace_filter_add_cid(comp, ROHC_TRACE_FILTER_MAX) == false);
+
+		CHECK(rohc_comp_trace_filter_add_profile(NULL, ROHC_PROFILE_IP) == false);
+		CHECK(rohc_comp_trace_filter_add_profile(comp, ROHC_PROFILE_GENERAL) == false);
+		CHECK(rohc_comp_trace_filter_add_profile(comp, ROHC_PROFILE_IP) == true);
+
+		CHECK(rohc_comp_trace_filter_add_packet_type(NULL, ROHC_PACKET_IR) == false);
+		CHECK(rohc_comp_trace_filter_add_packet_type(comp, ROHC_PACKET_UNKNOWN) == false);
+		CHECK(rohc_comp_trace_filter_add_packet_type(comp, ROHC_PACKET_MAX) == false);
+		CHECK(rohc_comp_trace_filter_add_packet_type(comp, ROHC_PACKET_IR) == true);
+
+		CHECK(rohc_comp_trace_filter_add_flow(NULL, pkt) == false);
+		pkt.len = 0;
+		CHECK(rohc_comp_trace_filter_add_flow(comp, pkt) == false);
+		pkt.len = sizeof(buf);
+		CHECK(rohc_comp_trace_filter_add_flow(comp, pkt) == true);
+
+		CHECK(rohc_comp_trace_filter_clear(NULL) == false);
+		CHECK(rohc_comp_trace_filter_clear(comp) == true);
+	}
+
 	/* rohc_comp_profile_enabled() */
 	CHECK(rohc_comp_profile_enabled(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_comp_profile_enabled(comp, ROHC_PROFILE_GENERAL) == false);
@@ -136,12 +301,19 @@ int main(int argc, char *argv[])
 	CHECK(rohc_comp_enable_profile(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_comp_enable_profile(comp, ROHC_PROFILE_GENERAL) == false);
 	CHECK(rohc_comp_enable_profile(comp, ROHC_PROFILE_IP) == true);
+	CHECK(rohc_comp_enable_profile(comp, ROHCv2_PROFILE_IP) == false);
 
 	/* rohc_comp_disable_profile() */
 	CHECK(rohc_comp_disable_profile(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_comp_disable_profile(comp, ROHC_PROFILE_GENERAL) == false);
 	CHECK(rohc_comp_disable_profile(comp, ROHC_PROFILE_IP) == true);
 
+	/* a ROHCv1 profile and its ROHCv2 counterpart are mutually exclusive */
+	CHECK(rohc_comp_enable_profile(comp, ROHCv2_PROFILE_IP) == true);
+	CHECK(rohc_comp_enable_profile(comp, ROHC_PROFILE_IP) == false);
+	CHECK(rohc_comp_profile_enabled(comp, ROHC_PROFILE_IP) == false);
+	CHECK(rohc_comp_disable_profile(comp, ROHCv2_PROFILE_IP) == true);
+
 	/* rohc_comp_enable_profiles() */
 	CHECK(rohc_comp_enable_profiles(NULL, ROHC_PROFILE_IP, -1) == false);
 	CHECK(rohc_comp_enable_profiles(comp, ROHC_PROFILE_GENERAL, -1) == false);
@@ -185,16 +357,57 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_get_segment2(comp, &pkt1) == ROHC_STATUS_ERROR);
 	}
 
+	/* rohc_comp_get_segments() */
+	{
+		struct rohc_buf_vec segments[2];
+		CHECK(rohc_comp_get_segments(NULL, 100, segments, 2) == 0);
+		CHECK(rohc_comp_get_segments(comp, 100, NULL, 2) == 0);
+		CHECK(rohc_comp_get_segments(comp, 0, segments, 2) == 0);
+		CHECK(rohc_comp_get_segments(comp, 1, segments, 2) == 0);
+		CHECK(rohc_comp_get_segments(comp, 100, segments, 0) == 0);
+		CHECK(rohc_comp_get_segments(comp, 100, segments, 2) == 0);
+	}
+
 	/* rohc_comp_force_contexts_reinit() */
 	CHECK(rohc_comp_force_contexts_reinit(NULL) == false);
 	CHECK(rohc_comp_force_contexts_reinit(comp) == true);
 
+	/* rohc_comp_save_contexts() and rohc_comp_restore_contexts() */
+	{
+		uint8_t blob[7];
+		size_t blob_len;
+
+		CHECK(rohc_comp_save_contexts(NULL, blob, 7, &blob_len) == false);
+		CHECK(rohc_comp_save_contexts(comp, blob, 7, NULL) == false);
+		CHECK(rohc_comp_save_contexts(comp, NULL, 0, &blob_len) == false);
+		CHECK(blob_len == 7);
+		CHECK(rohc_comp_save_contexts(comp, blob, 6, &blob_len) == false);
+		CHECK(rohc_comp_save_contexts(comp, blob, 7, &blob_len) == true);
+		CHECK(blob_len == 7);
+
+		CHECK(rohc_comp_restore_contexts(NULL, blob, 7) == false);
+		CHECK(rohc_comp_restore_contexts(comp, NULL, 7) == false);
+		CHECK(rohc_comp_restore_contexts(comp, blob, 6) == false);
+		CHECK(rohc_comp_restore_contexts(comp, blob, 7) == true);
+		blob[4]++;
+		CHECK(rohc_comp_restore_contexts(comp, blob, 7) == false);
+	}
+
 	/* rohc_comp_set_wlsb_window_width() */
 	CHECK(rohc_comp_set_wlsb_window_width(NULL, 16) == false);
 	CHECK(rohc_comp_set_wlsb_window_width(comp, 0) == false);
 	CHECK(rohc_comp_set_wlsb_window_width(comp, 15) == false);
 	CHECK(rohc_comp_set_wlsb_window_width(comp, 16) == true);
 
+	/* rohc_comp_get_wlsb_window_width() */
+	{
+		size_t width;
+		CHECK(rohc_comp_get_wlsb_window_width(NULL, &width) == false);
+		CHECK(rohc_comp_get_wlsb_window_width(comp, NULL) == false);
+		CHECK(rohc_comp_get_wlsb_window_width(comp, &width) == true);
+		CHECK(width == 16);
+	}
+
 	/* rohc_comp_set_periodic_refreshes() */
 	CHECK(rohc_comp_set_periodic_refreshes(NULL, 1700, 700) == false);
 	CHECK(rohc_comp_set_periodic_refreshes(comp, 0, 700) == false);
@@ -202,12 +415,97 @@ int main(int argc, char *argv[])
 	CHECK(rohc_comp_set_periodic_refreshes(comp, 5, 10) == false);
 	CHECK(rohc_comp_set_periodic_refreshes(comp, 10, 5) == true);
 
+	/* rohc_comp_get_periodic_refreshes() */
+	{
+		size_t ir_timeout;
+		size_t fo_timeout;
+		CHECK(rohc_comp_get_periodic_refreshes(NULL, &ir_timeout, &fo_timeout) == false);
+		CHECK(rohc_comp_get_periodic_refreshes(comp, NULL, &fo_timeout) == false);
+		CHECK(rohc_comp_get_periodic_refreshes(comp, &ir_timeout, NULL) == false);
+		CHECK(rohc_comp_get_periodic_refreshes(comp, &ir_timeout, &fo_timeout) == true);
+		CHECK(ir_timeout == 10 && fo_timeout == 5);
+	}
+
+	/* rohc_comp_set_periodic_refreshes_time() */
+	CHECK(rohc_comp_set_periodic_refreshes_time(NULL, 1000, 500) == false);
+	CHECK(rohc_comp_set_periodic_refreshes_time(comp, 0, 500) == false);
+	CHECK(rohc_comp_set_periodic_refreshes_time(comp, 1000, 0) == false);
+	CHECK(rohc_comp_set_periodic_refreshes_time(comp, 500, 1000) == false);
+	CHECK(rohc_comp_set_periodic_refreshes_time(comp, 1000, 500) == true);
+
+	/* rohc_comp_get_periodic_refreshes_time() */
+	{
+		size_t ir_timeout;
+		size_t fo_timeout;
+		CHECK(rohc_comp_get_periodic_refreshes_time(NULL, &ir_timeout, &fo_timeout) == false);
+		CHECK(rohc_comp_get_periodic_refreshes_time(comp, NULL, &fo_timeout) == false);
+		CHECK(rohc_comp_get_periodic_refreshes_time(comp, &ir_timeout, NULL) == false);
+		CHECK(rohc_comp_get_periodic_refreshes_time(comp, &ir_timeout, &fo_timeout) == true);
+		CHECK(ir_timeout == 1000 && fo_timeout == 500);
+	}
+	CHECK(rohc_comp_set_periodic_refreshes_time(comp, 0, 0) == true);
+
+	/* rohc_comp_set_ir_pacing() */
+	CHECK(rohc_comp_set_ir_pacing(NULL, 1000, 100) == false);
+	CHECK(rohc_comp_set_ir_pacing(comp, 1000, 0) == false);
+	CHECK(rohc_comp_set_ir_pacing(comp, 0, 100) == false);
+	CHECK(rohc_comp_set_ir_pacing(comp, 1000, 100) == true);
+	CHECK(rohc_comp_set_ir_pacing(comp, 0, 0) == true);
+
+	/* rohc_comp_set_overload() and rohc_comp_set_load() */
+	{
+		const struct rohc_load limits = { .queue_depth = 0, .burst_time_us = 100 };
+		const struct rohc_load load = { .queue_depth = 0, .burst_time_us = 10 };
+		CHECK(rohc_comp_set_overload(NULL, &limits) == false);
+		CHECK(rohc_comp_set_overload(comp, &limits) == true);
+		CHECK(rohc_comp_set_load(NULL, &load) == false);
+		CHECK(rohc_comp_set_load(comp, NULL) == false);
+		CHECK(rohc_comp_set_load(comp, &load) == true);
+		CHECK(rohc_comp_set_overload(comp, NULL) == true);
+	}
+
+	/* rohc_comp_get_cfg() and rohc_comp_publish_cfg() */
+	{
+		struct rohc_comp_cfg cfg;
+		CHECK(rohc_comp_get_cfg(NULL, &cfg) == false);
+		CHECK(rohc_comp_get_cfg(comp, NULL) == false);
+		CHECK(rohc_comp_get_cfg(comp, &cfg) == true);
+		CHECK(rohc_comp_publish_cfg(NULL, &cfg) == false);
+		CHECK(rohc_comp_publish_cfg(comp, NULL) == false);
+		cfg.features = 0xffffffff;
+		CHECK(rohc_comp_publish_cfg(comp, &cfg) == false);
+		cfg.features = ROHC_COMP_FEATURE_NONE;
+		cfg.refresh_fo_timeout = cfg.refresh_ir_timeout;
+		CHECK(rohc_comp_publish_cfg(comp, &cfg) == false);
+		cfg.refresh_fo_timeout = cfg.refresh_ir_timeout - 1;
+		cfg.ir_pacing_budget = 1000;
+		cfg.ir_pacing_interval = 0;
+		CHECK(rohc_comp_publish_cfg(comp, &cfg) == false);
+		cfg.ir_pacing_budget = 0;
+		cfg.effort = (rohc_comp_effort_t) 3;
+		CHECK(rohc_comp_publish_cfg(comp, &cfg) == false);
+		cfg.effort = ROHC_COMP_EFFORT_DEFAULT;
+		/* the pending snapshot is superseded, then freed with the compressor */
+		CHECK(rohc_comp_publish_cfg(comp, &cfg) == true);
+		CHECK(rohc_comp_publish_cfg(comp, &cfg) == true);
+	}
+
 	/* rohc_comp_set_list_trans_nr() */
 	CHECK(rohc_comp_set_list_trans_nr(NULL, 5) == false);
 	CHECK(rohc_comp_set_list_trans_nr(comp, 0) == false);
 	CHECK(rohc_comp_set_list_trans_nr(comp, 1) == true);
 	CHECK(rohc_comp_set_list_trans_nr(comp, 5) == true);
 
+	/* rohc_comp_set_ctxt_idle_timeout() */
+	CHECK(rohc_comp_set_ctxt_idle_timeout(NULL, 10) == false);
+	CHECK(rohc_comp_set_ctxt_idle_timeout(comp, 10) == true);
+	CHECK(rohc_comp_set_ctxt_idle_timeout(comp, 0) == true);
+
+	/* rohc_comp_set_closed_ctxt_linger() */
+	CHECK(rohc_comp_set_closed_ctxt_linger(NULL, 10) == false);
+	CHECK(rohc_comp_set_closed_ctxt_linger(comp, 10) == true);
+	CHECK(rohc_comp_set_closed_ctxt_linger(comp, 0) == true);
+
 	/* rohc_comp_set_rtp_detection_cb() */
 	{
 		rohc_rtp_detection_callback_t fct =
@@ -216,6 +514,43 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_set_rtp_detection_cb(comp, fct, NULL) == true);
 	}
 
+	/* rohc_comp_set_priority_cb() */
+	{
+		rohc_comp_priority_callback_t fct =
+			(rohc_comp_priority_callback_t) NULL;
+		CHECK(rohc_comp_set_priority_cb(NULL, fct, NULL) == false);
+		CHECK(rohc_comp_set_priority_cb(comp, fct, NULL) == true);
+	}
+
+	/* rohc_comp_set_compress_min_priority() */
+	CHECK(rohc_comp_set_compress_min_priority(NULL, 1) == false);
+	CHECK(rohc_comp_set_compress_min_priority(comp, 1) == true);
+	CHECK(rohc_comp_set_compress_min_priority(comp, 0) == true);
+
+	/* rohc_comp_add_rtp_ports(), rohc_comp_remove_rtp_ports() and
+	 * rohc_comp_reset_rtp_ports() */
+	CHECK(rohc_comp_add_rtp_ports(NULL, 1234, 1234) == false);
+	CHECK(rohc_comp_add_rtp_ports(comp, 1235, 1234) == false);
+	CHECK(rohc_comp_add_rtp_ports(comp, 1234, 1234) == true);
+	CHECK(rohc_comp_add_rtp_ports(comp, 0, 65535) == true);
+	CHECK(rohc_comp_remove_rtp_ports(NULL, 1234, 1234) == false);
+	CHECK(rohc_comp_remove_rtp_ports(comp, 1235, 1234) == false);
+	CHECK(rohc_comp_remove_rtp_ports(comp, 0, 65535) == true);
+	CHECK(rohc_comp_reset_rtp_ports(NULL) == false);
+	CHECK(rohc_comp_reset_rtp_ports(comp) == true);
+
+	/* rohc_comp_set_rtp_ts_timer() */
+	CHECK(rohc_comp_set_rtp_ts_timer(NULL, true, 0) == false);
+	CHECK(rohc_comp_set_rtp_ts_timer(comp, true, 20) == true);
+	CHECK(rohc_comp_set_rtp_ts_timer(comp, false, 0) == true);
+
+	/* rohc_comp_set_alloc_cbs() */
+	CHECK(rohc_comp_set_alloc_cbs(NULL, alloc_cb, free_cb, NULL) == false);
+	CHECK(rohc_comp_set_alloc_cbs(comp, alloc_cb, NULL, NULL) == false);
+	CHECK(rohc_comp_set_alloc_cbs(comp, NULL, free_cb, NULL) == false);
+	CHECK(rohc_comp_set_alloc_cbs(comp, NULL, NULL, NULL) == true);
+	CHECK(rohc_comp_set_alloc_cbs(comp, alloc_cb, free_cb, NULL) == true);
+
 	/* rohc_comp_set_mrru() */
 	CHECK(rohc_comp_set_mrru(NULL, 10) == false);
 	CHECK(rohc_comp_set_mrru(comp, 65535 + 1) == false);
@@ -301,7 +636,406 @@ int main(int argc, char *argv[])
 		pkt2.max_len = pkt.len + 1;
 		pkt2.offset = 0;
 		pkt2.len = 0;
-		CHECK(rohc_compress4(comp, pkt, &pkt2) == ROHC_STATUS_OK);
+		{
+			struct rohc_trace_record records[4];
+			struct rohc_trace_record read_records[4];
+			struct rohc_trace_ring ring;
+			uint32_t next_seq = 0;
+
+			CHECK(rohc_trace_ring_init(&ring, records, 4) == true);
+			CHECK(rohc_comp_set_trace_ring(comp, &ring) == true);
+			CHECK(rohc_compress4(comp, pkt, &pkt2) == ROHC_STATUS_OK);
+			CHECK(rohc_comp_set_trace_ring(comp, NULL) == true);
+
+			/* the new context and the compressed packet were recorded */
+			CHECK(rohc_trace_ring_read(&ring, &next_seq, read_records, 4) == 2);
+			CHECK(next_seq == 2);
+			CHECK(read_records[0].seq == 0);
+			CHECK(read_records[0].event == ROHC_TRACE_EVENT_COMP_CTXT_NEW);
+			CHECK(read_records[0].entity == ROHC_TRACE_COMP);
+			CHECK(read_records[1].seq == 1);
+			CHECK(read_records[1].event == ROHC_TRACE_EVENT_COMP_PKT);
+			CHECK(read_records[1].cid == read_records[0].cid);
+			CHECK(read_records[1].packet_type == ROHC_PACKET_IR);
+			CHECK(read_records[1].args[0] == pkt.len);
+			CHECK(read_records[1].args[1] == pkt2.len);
+			CHECK(rohc_trace_ring_read(&ring, &next_seq, read_records, 4) == 0);
+
+			/* nothing is recorded for the packets of an unchanged context if
+			 * only the events of the life of the contexts are recorded */
+			CHECK(rohc_comp_set_trace_events(comp, ROHC_TRACE_EVENTS_CTXT) == true);
+			CHECK(rohc_comp_set_trace_ring(comp, &ring) == true);
+			rohc_buf_reset(&pkt2);
+			CHECK(rohc_compress4(comp, pkt, &pkt2) == ROHC_STATUS_OK);
+			CHECK(rohc_comp_set_trace_ring(comp, NULL) == true);
+			CHECK(rohc_comp_set_trace_events(comp, ROHC_TRACE_EVENTS_ALL) == true);
+			CHECK(rohc_trace_ring_read(&ring, &next_seq, read_records, 4) == 0);
+		}
+
+		/* timer-based compression cannot be changed once compressor is in use */
+		CHECK(rohc_comp_set_rtp_ts_timer(comp, true, 20) == false);
+	}
+
+	/* rohc_comp_predict_size() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		struct rohc_comp *predict_comp;
+		size_t max_len;
+
+		predict_comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                              random_cb, NULL);
+		CHECK(predict_comp != NULL);
+		CHECK(rohc_comp_enable_profile(predict_comp, ROHC_PROFILE_IP) == true);
+
+		CHECK(rohc_comp_predict_size(NULL, pkt, &max_len) == false);
+		CHECK(rohc_comp_predict_size(predict_comp, pkt, NULL) == false);
+		pkt.len = 0;
+		CHECK(rohc_comp_predict_size(predict_comp, pkt, &max_len) == false);
+		pkt.len = sizeof(buf);
+
+		/* the predicted length is enough for the IR packet of a new flow */
+		max_len = 0;
+		CHECK(rohc_comp_predict_size(predict_comp, pkt, &max_len) == true);
+		CHECK(max_len >= pkt.len);
+		CHECK(max_len <= sizeof(buf_out));
+		pkt_out.max_len = max_len;
+		CHECK(rohc_compress4(predict_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(pkt_out.len <= max_len);
+
+		rohc_comp_free(predict_comp);
+	}
+
+	/* only the contexts selected by the trace filter are traced */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		uint8_t other_buf[sizeof(buf)];
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		struct rohc_buf other_pkt = rohc_buf_init_full(other_buf, sizeof(buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		struct rohc_comp *filter_comp;
+		size_t traces_nr = 0;
+
+		/* the other flow has another destination address */
+		memcpy(other_buf, buf, sizeof(buf));
+		other_buf[19]++;
+		other_buf[11]--;
+
+		filter_comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                             random_cb, NULL);
+		CHECK(filter_comp != NULL);
+		CHECK(rohc_comp_set_traces_cb2(filter_comp, count_trace_cb,
+		                               &traces_nr) == true);
+		CHECK(rohc_comp_enable_profile(filter_comp, ROHC_PROFILE_IP) == true);
+
+		/* the flow of the other packet is not traced */
+		CHECK(rohc_comp_trace_filter_add_flow(filter_comp, pkt) == true);
+		traces_nr = 0;
+		CHECK(rohc_compress4(filter_comp, other_pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(traces_nr == 0);
+
+		/* the traced flow is traced */
+		rohc_buf_reset(&pkt_out);
+		CHECK(rohc_compress4(filter_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(traces_nr > 0);
+
+		/* no context sends UO-0 packets yet */
+		traces_nr = 0;
+		CHECK(rohc_comp_trace_filter_clear(filter_comp) == true);
+		CHECK(rohc_comp_trace_filter_add_packet_type(filter_comp,
+		                                             ROHC_PACKET_UO_0) == true);
+		rohc_buf_reset(&pkt_out);
+		CHECK(rohc_compress4(filter_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(traces_nr == 0);
+
+		/* all the flows are traced once the filter is cleared */
+		CHECK(rohc_comp_trace_filter_clear(filter_comp) == true);
+		rohc_buf_reset(&pkt_out);
+		CHECK(rohc_compress4(filter_comp, other_pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(traces_nr > 0);
+
+		rohc_comp_free(filter_comp);
+	}
+
+	/* rohc_comp_enqueue_feedback(), the feedback is delivered by the next
+	 * call to rohc_compress_burst() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[129] = { 0xf4, 0x20, 0x01, 0x11, 0x39 };
+		struct rohc_buf pkt = rohc_buf_init_full(buf, 5, ts);
+
+		CHECK(rohc_comp_enqueue_feedback(NULL, pkt) == false);
+		pkt.len = 129; CHECK(rohc_comp_enqueue_feedback(comp, pkt) == false);
+		pkt.len = 5;
+		for(size_t i = 0; i < 16; i++)
+		{
+			CHECK(rohc_comp_enqueue_feedback(comp, pkt) == true);
+		}
+		CHECK(rohc_comp_enqueue_feedback(comp, pkt) == false);
+	}
+
+	/* rohc_compress_burst() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		struct rohc_buf pkts[3] =
+		{
+			rohc_buf_init_full(buf, sizeof(buf), ts),
+			rohc_buf_init_full(buf, sizeof(buf), ts),
+			rohc_buf_init_full(buf, sizeof(buf), ts),
+		};
+		uint8_t bufs_out[3][100];
+		struct rohc_buf pkts_out[3] =
+		{
+			rohc_buf_init_empty(bufs_out[0], 100),
+			rohc_buf_init_empty(bufs_out[1], 100),
+			rohc_buf_init_empty(bufs_out[2], 100),
+		};
+		rohc_status_t status[3];
+		CHECK(rohc_compress_burst(NULL, pkts, pkts_out, status, 3) == 0);
+		CHECK(rohc_compress_burst(comp, NULL, pkts_out, status, 3) == 0);
+		CHECK(rohc_compress_burst(comp, pkts, NULL, status, 3) == 0);
+		CHECK(rohc_compress_burst(comp, pkts, pkts_out, NULL, 3) == 0);
+		CHECK(rohc_compress_burst(comp, pkts, pkts_out, status, 0) == 0);
+
+		/* one bad packet does not prevent the others from being compressed */
+		pkts[1].len = 0;
+		CHECK(rohc_compress_burst(comp, pkts, pkts_out, status, 3) == 3);
+		CHECK(status[0] == ROHC_STATUS_OK);
+		CHECK(status[1] == ROHC_STATUS_ERROR);
+		CHECK(status[2] == ROHC_STATUS_OK);
+		CHECK(pkts_out[0].len > 0);
+		CHECK(pkts_out[2].len > 0);
+
+		/* bursts longer than one group of packets are compressed entirely */
+		{
+			struct rohc_buf long_pkts[19];
+			uint8_t long_bufs_out[19][100];
+			struct rohc_buf long_pkts_out[19];
+			rohc_status_t long_status[19];
+
+			for(size_t j = 0; j < 19; j++)
+			{
+				long_pkts[j] = pkts[0];
+				long_pkts_out[j] = pkts_out[0];
+				long_pkts_out[j].data = long_bufs_out[j];
+				long_pkts_out[j].len = 0;
+			}
+			long_pkts[8].len = 0;
+			long_pkts[17].len = 0;
+			CHECK(rohc_compress_burst(comp, long_pkts, long_pkts_out,
+			                          long_status, 19) == 19);
+			for(size_t j = 0; j < 19; j++)
+			{
+				CHECK(long_status[j] == ((j == 8 || j == 17) ?
+				                         ROHC_STATUS_ERROR : ROHC_STATUS_OK));
+			}
+		}
+
+		/* the enqueued feedback was delivered */
+		{
+			uint8_t buf_fb[] = { 0xf4, 0x20, 0x01, 0x11, 0x39 };
+			const struct rohc_buf fb = rohc_buf_init_full(buf_fb, 5, ts);
+
+			for(size_t j = 0; j < 16; j++)
+			{
+				CHECK(rohc_comp_enqueue_feedback(comp, fb) == true);
+			}
+			CHECK(rohc_comp_enqueue_feedback(comp, fb) == false);
+		}
+	}
+
+	/* rohc_compress_hinted() and rohc_compress_burst_hinted() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		struct rohc_buf pkts[2] =
+		{
+			rohc_buf_init_full(buf, sizeof(buf), ts),
+			rohc_buf_init_full(buf, sizeof(buf), ts),
+		};
+		struct rohc_comp_pkt_hints hints[2] =
+		{
+			{
+				.inner_ip_offset = 0,
+				.transport_offset = 20,
+				.transport_proto = 1,
+				.flags = ROHC_COMP_HINT_OFFSETS | ROHC_COMP_HINT_IP_CSUM_GOOD,
+			},
+			{
+				.inner_ip_offset = 0,
+				.transport_offset = 20,
+				.transport_proto = 1,
+				.flags = ROHC_COMP_HINT_OFFSETS,
+			},
+		};
+		uint8_t bufs_out[2][100];
+		struct rohc_buf pkts_out[2] =
+		{
+			rohc_buf_init_empty(bufs_out[0], 100),
+			rohc_buf_init_empty(bufs_out[1], 100),
+		};
+		rohc_status_t status[2];
+
+		CHECK(rohc_compress_hinted(NULL, pkts[0], &hints[0], &pkts_out[0]) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_hinted(comp, pkts[0], NULL, &pkts_out[0]) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_hinted(comp, pkts[0], &hints[0], NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_hinted(comp, pkts[0], &hints[0], &pkts_out[0]) == ROHC_STATUS_OK);
+		CHECK(pkts_out[0].len > 0);
+
+		/* hints that do not match the packet are ignored */
+		hints[1].transport_offset = 24;
+		rohc_buf_reset(&pkts_out[1]);
+		CHECK(rohc_compress_hinted(comp, pkts[1], &hints[1], &pkts_out[1]) == ROHC_STATUS_OK);
+		CHECK(pkts_out[1].len > 0);
+		hints[1].transport_offset = 20;
+		hints[1].transport_proto = 17;
+		rohc_buf_reset(&pkts_out[1]);
+		CHECK(rohc_compress_hinted(comp, pkts[1], &hints[1], &pkts_out[1]) == ROHC_STATUS_OK);
+		CHECK(pkts_out[1].len > 0);
+		hints[1].transport_proto = 1;
+
+		CHECK(rohc_compress_burst_hinted(NULL, pkts, hints, pkts_out, status, 2) == 0);
+		CHECK(rohc_compress_burst_hinted(comp, NULL, hints, pkts_out, status, 2) == 0);
+		CHECK(rohc_compress_burst_hinted(comp, pkts, NULL, pkts_out, status, 2) == 0);
+		CHECK(rohc_compress_burst_hinted(comp, pkts, hints, NULL, status, 2) == 0);
+		CHECK(rohc_compress_burst_hinted(comp, pkts, hints, pkts_out, NULL, 2) == 0);
+		CHECK(rohc_compress_burst_hinted(comp, pkts, hints, pkts_out, status, 0) == 0);
+		rohc_buf_reset(&pkts_out[0]);
+		rohc_buf_reset(&pkts_out[1]);
+		CHECK(rohc_compress_burst_hinted(comp, pkts, hints, pkts_out, status, 2) == 2);
+		CHECK(status[0] == ROHC_STATUS_OK);
+		CHECK(status[1] == ROHC_STATUS_OK);
+		CHECK(pkts_out[0].len > 0);
+		CHECK(pkts_out[1].len > 0);
+	}
+
+	/* rohc_compress_hdr() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf_hdr[100];
+		struct rohc_buf hdr = rohc_buf_init_empty(buf_hdr, 100);
+		size_t payload_offset;
+		CHECK(rohc_compress_hdr(NULL, pkt, &hdr, &payload_offset) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_hdr(comp, pkt, NULL, &payload_offset) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_hdr(comp, pkt, &hdr, NULL) == ROHC_STATUS_ERROR);
+
+		/* only the ROHC header is written, the payload is the ICMP header */
+		payload_offset = 0;
+		CHECK(rohc_compress_hdr(comp, pkt, &hdr, &payload_offset) == ROHC_STATUS_OK);
+		CHECK(hdr.len > 0);
+		CHECK(payload_offset == 20);
+	}
+
+	/* rohc_compress_inplace() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		const uint8_t ip[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		uint8_t buf[100];
+		struct rohc_buf pkt = rohc_buf_init_full(buf, 100, ts);
+		uint8_t *payload;
+
+		memcpy(buf + 100 - sizeof(ip), ip, sizeof(ip));
+		pkt.offset = 100 - sizeof(ip);
+		pkt.len = sizeof(ip);
+		payload = buf + 100 - 8;
+
+		CHECK(rohc_compress_inplace(NULL, &pkt) == ROHC_STATUS_ERROR);
+		CHECK(rohc_compress_inplace(comp, NULL) == ROHC_STATUS_ERROR);
+		pkt.offset = 0;
+		CHECK(rohc_compress_inplace(comp, &pkt) == ROHC_STATUS_ERROR);
+		pkt.offset = 100 - sizeof(ip);
+
+		/* the ICMP payload is not moved, the ROHC header is written in front
+		 * of it over the IPv4 header */
+		CHECK(rohc_compress_inplace(comp, &pkt) == ROHC_STATUS_OK);
+		CHECK(pkt.len > 8);
+		CHECK(pkt.len < sizeof(ip));
+		CHECK(rohc_buf_data(pkt) + pkt.len - 8 == payload);
+		CHECK(memcmp(payload, ip + sizeof(ip) - 8, 8) == 0);
+	}
+
+	/* rohc_compress_hdr_burst() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		struct rohc_buf pkts[2] =
+		{
+			rohc_buf_init_full(buf, sizeof(buf), ts),
+			rohc_buf_init_full(buf, sizeof(buf), ts),
+		};
+		uint8_t bufs_hdr[2][100];
+		struct rohc_buf hdrs[2] =
+		{
+			rohc_buf_init_empty(bufs_hdr[0], 100),
+			rohc_buf_init_empty(bufs_hdr[1], 100),
+		};
+		size_t payload_offsets[2] = { 0, 0 };
+		rohc_status_t status[2];
+		CHECK(rohc_compress_hdr_burst(NULL, pkts, hdrs, payload_offsets, status, 2) == 0);
+		CHECK(rohc_compress_hdr_burst(comp, NULL, hdrs, payload_offsets, status, 2) == 0);
+		CHECK(rohc_compress_hdr_burst(comp, pkts, NULL, payload_offsets, status, 2) == 0);
+		CHECK(rohc_compress_hdr_burst(comp, pkts, hdrs, NULL, status, 2) == 0);
+		CHECK(rohc_compress_hdr_burst(comp, pkts, hdrs, payload_offsets, NULL, 2) == 0);
+		CHECK(rohc_compress_hdr_burst(comp, pkts, hdrs, payload_offsets, status, 0) == 0);
+
+		/* only the ROHC headers are written */
+		CHECK(rohc_compress_hdr_burst(comp, pkts, hdrs, payload_offsets, status, 2) == 2);
+		CHECK(status[0] == ROHC_STATUS_OK);
+		CHECK(status[1] == ROHC_STATUS_OK);
+		CHECK(hdrs[0].len > 0);
+		CHECK(hdrs[1].len > 0);
+		CHECK(payload_offsets[0] == 20);
+		CHECK(payload_offsets[1] == 20);
 	}
 
 	/* rohc_comp_get_last_packet_info2() */
@@ -319,6 +1053,113 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_get_last_packet_info2(comp, &info) == true);
 	}
 
+	/* interleaved flows, more than the most recently used contexts, keep
+	 * their contexts */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		unsigned int cids[6];
+
+		for(size_t round = 0; round < 2; round++)
+		{
+			for(size_t j = 0; j < 6; j++)
+			{
+				uint8_t buf[] =
+				{
+					0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+					0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+					0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+					0x9b, 0x42, 0x00, 0x01
+				};
+				const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+				uint8_t buf_out[100];
+				struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+				rohc_comp_last_packet_info2_t info;
+
+				/* one destination per flow, keep the IP checksum right */
+				buf[19] += j;
+				buf[11] -= j;
+				CHECK(rohc_compress4(comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+
+				memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+				CHECK(rohc_comp_get_last_packet_info2(comp, &info) == true);
+				if(round == 0)
+				{
+					cids[j] = info.context_id;
+				}
+				else
+				{
+					CHECK(info.context_id == cids[j]);
+					CHECK(info.is_context_init == false);
+				}
+			}
+		}
+	}
+
+	/* consecutive packets of one flow reuse the context of the previous
+	 * packet, but never once it was destroyed */
+	{
+		struct rohc_comp *const comp2 =
+			rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		const uint64_t times[] = { 1, 2, 3, 4, 100 };
+		const size_t flows[] = { 0, 0, 1, 0, 0 };
+		const bool is_init[] = { true, false, true, false, true };
+		unsigned int cids[2];
+
+		CHECK(comp2 != NULL);
+		CHECK(rohc_comp_enable_profile(comp2, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_comp_set_ctxt_idle_timeout(comp2, 10) == true);
+
+		for(size_t j = 0; j < 5; j++)
+		{
+			const struct rohc_ts ts = { .sec = times[j], .nsec = 0 };
+			uint8_t buf[] =
+			{
+				0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+				0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+				0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+				0x9b, 0x42, 0x00, 0x01
+			};
+			const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+			uint8_t buf_out[100];
+			struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+			rohc_comp_last_packet_info2_t info;
+
+			/* one destination per flow, keep the IP checksum right */
+			buf[19] += flows[j];
+			buf[11] -= flows[j];
+			CHECK(rohc_compress4(comp2, pkt, &pkt_out) == ROHC_STATUS_OK);
+
+			memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+			CHECK(rohc_comp_get_last_packet_info2(comp2, &info) == true);
+			CHECK(info.is_context_init == is_init[j]);
+			if(j == 0 || j == 2)
+			{
+				cids[flows[j]] = info.context_id;
+			}
+			else if(!is_init[j])
+			{
+				CHECK(info.context_id == cids[flows[j]]);
+			}
+		}
+		CHECK(cids[0] != cids[1]);
+
+		rohc_comp_free(comp2);
+	}
+
+	/* rohc_comp_get_perf_stats() */
+	{
+		struct rohc_comp_perf_stats stats;
+		CHECK(rohc_comp_get_perf_stats(NULL, &stats) == false);
+		CHECK(rohc_comp_get_perf_stats(comp, NULL) == false);
+		/* durations are measured only if enabled at build time */
+		if(rohc_comp_get_perf_stats(comp, &stats))
+		{
+			CHECK(stats.stages[ROHC_COMP_PERF_PARSE].count > 0);
+			CHECK(stats.stages[ROHC_COMP_PERF_CTXT_LOOKUP].count > 0);
+			CHECK(stats.stages[ROHC_COMP_PERF_ENCODE].count > 0);
+		}
+	}
+
 	/* rohc_comp_get_general_info() */
 	{
 		rohc_comp_general_info_t info;
@@ -332,6 +1173,31 @@ int main(int argc, char *argv[])
 		CHECK(rohc_comp_get_general_info(comp, &info) == false);
 		info.version_minor = 0;
 		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		info.version_minor = 1;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.packets_nr > 0);
+		CHECK(info.packet_types_nr[ROHC_PACKET_IR] > 0);
+		info.version_minor = 2;
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.overloads_nr == 0);
+	}
+
+	/* rohc_comp_get_contexts() */
+	{
+		struct rohc_comp_ctxt_record records[ROHC_SMALL_CID_MAX + 1];
+		rohc_comp_general_info_t info;
+		size_t records_nr;
+		memset(&info, 0, sizeof(rohc_comp_general_info_t));
+		CHECK(rohc_comp_get_general_info(comp, &info) == true);
+		CHECK(info.contexts_nr > 0);
+		CHECK(rohc_comp_get_contexts(NULL, records, ROHC_SMALL_CID_MAX + 1) == 0);
+		CHECK(rohc_comp_get_contexts(comp, NULL, ROHC_SMALL_CID_MAX + 1) == 0);
+		CHECK(rohc_comp_get_contexts(comp, records, 0) == 0);
+		CHECK(rohc_comp_get_contexts(comp, records, 1) == 1);
+		records_nr = rohc_comp_get_contexts(comp, records, ROHC_SMALL_CID_MAX + 1);
+		CHECK(records_nr == info.contexts_nr);
+		CHECK(records[0].packets_nr > 0);
+		CHECK(records[0].cid <= ROHC_SMALL_CID_MAX);
 	}
 
 	/* rohc_comp_get_state_descr() */
@@ -343,11 +1209,30 @@ int main(int argc, char *argv[])
 	/* rohc_comp_force_contexts_reinit() with some contexts init'ed */
 	CHECK(rohc_comp_force_contexts_reinit(comp) == true);
 
+	/* rohc_comp_set_alloc_cbs() with some contexts init'ed */
+	CHECK(rohc_comp_set_alloc_cbs(comp, NULL, NULL, NULL) == false);
+
 	/* rohc_comp_set_features */
 	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_COMPAT_1_6_x) == false);
 	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NO_IP_CHECKSUMS) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_FLOW_KEY) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_SMALLEST_PACKETS) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_CHECKPOINT) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_ADAPTIVE_WLSB) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_ADAPTIVE_REFRESHES) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_UNCOMP_CACHE) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_CONTEXT_REPLICATION) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_ESTIMATE) == true);
+	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_BURST_GROUPING) == true);
 	CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NONE) == true);
 
+	/* rohc_comp_set_effort() */
+	CHECK(rohc_comp_set_effort(NULL, ROHC_COMP_EFFORT_FAST) == false);
+	CHECK(rohc_comp_set_effort(comp, (rohc_comp_effort_t) 3) == false);
+	CHECK(rohc_comp_set_effort(comp, ROHC_COMP_EFFORT_FAST) == true);
+	CHECK(rohc_comp_set_effort(comp, ROHC_COMP_EFFORT_BEST) == true);
+	CHECK(rohc_comp_set_effort(comp, ROHC_COMP_EFFORT_DEFAULT) == true);
+
 	/* rohc_comp_deliver_feedback2() */
 	{
 		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
@@ -363,18 +1248,873 @@ int main(int argc, char *argv[])
 		pkt.len = 5; CHECK(rohc_comp_deliver_feedback2(comp, pkt) == true);
 	}
 
+	/* rohc_comp_deliver_feedback2() with several ACKs for one context, only
+	 * the newest one is applied */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf_bad_first[] =
+		{
+			0xf4, 0x20, 0x01, 0x11, 0x00,
+			0xf4, 0x20, 0x01, 0x11, 0x39
+		};
+		uint8_t buf_bad_last[] =
+		{
+			0xf4, 0x20, 0x01, 0x11, 0x39,
+			0xf4, 0x20, 0x01, 0x11, 0x00
+		};
+		const struct rohc_buf pkt_bad_first =
+			rohc_buf_init_full(buf_bad_first, sizeof(buf_bad_first), ts);
+		const struct rohc_buf pkt_bad_last =
+			rohc_buf_init_full(buf_bad_last, sizeof(buf_bad_last), ts);
+
+		CHECK(rohc_comp_deliver_feedback2(comp, pkt_bad_first) == true);
+		CHECK(rohc_comp_deliver_feedback2(comp, pkt_bad_last) == false);
+	}
+
+	/* rohc_comp_deliver_feedbacks() and ROHC_COMP_FEATURE_TRUSTED_FEEDBACK */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf_ok[] = { 0xf4, 0x20, 0x01, 0x11, 0x39 };
+		uint8_t buf_bad_crc[] = { 0xf4, 0x20, 0x01, 0x11, 0x00 };
+		struct rohc_buf pkts[2] = {
+			rohc_buf_init_full(buf_ok, 5, ts),
+			rohc_buf_init_full(buf_bad_crc, 5, ts),
+		};
+
+		CHECK(rohc_comp_deliver_feedbacks(NULL, pkts, 2) == false);
+		CHECK(rohc_comp_deliver_feedbacks(comp, NULL, 2) == false);
+		CHECK(rohc_comp_deliver_feedbacks(comp, NULL, 0) == true);
+		CHECK(rohc_comp_deliver_feedbacks(comp, pkts, 1) == true);
+		CHECK(rohc_comp_deliver_feedbacks(comp, pkts, 2) == false);
+
+		/* the CRC is not checked on a trusted feedback channel */
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_TRUSTED_FEEDBACK) == true);
+		CHECK(rohc_comp_deliver_feedbacks(comp, pkts, 2) == true);
+		CHECK(rohc_comp_set_features(comp, ROHC_COMP_FEATURE_NONE) == true);
+	}
+
 	/* several functions with some packets already compressed */
 	{
 		rohc_trace_callback2_t fct = (rohc_trace_callback2_t) NULL;
 		CHECK(rohc_comp_set_traces_cb2(comp, fct, comp) == false);
 
-		CHECK(rohc_comp_set_wlsb_window_width(comp, 16) == false);
+		/* the W-LSB window width and the periodic refreshes may be tuned
+		 * on a live compressor */
+		CHECK(rohc_comp_set_wlsb_window_width(comp, 16) == true);
 
-		CHECK(rohc_comp_set_periodic_refreshes(comp, 10, 5) == false);
+		CHECK(rohc_comp_set_periodic_refreshes(comp, 10, 5) == true);
 
 		CHECK(rohc_comp_set_list_trans_nr(comp, 5) == false);
 	}
 
+	/* the W-LSB window width and the periodic refreshes tuned on a live
+	 * compressor are reported back and apply from the next packet */
+	{
+		struct rohc_comp *const comp3 =
+			rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, random_cb, NULL);
+		size_t ir_pkts_nr = 0;
+		size_t width;
+		size_t ir_timeout;
+		size_t fo_timeout;
+
+		CHECK(comp3 != NULL);
+		CHECK(rohc_comp_enable_profile(comp3, ROHC_PROFILE_IP) == true);
+
+		for(size_t j = 0; j < 20; j++)
+		{
+			const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+			uint8_t buf[] =
+			{
+				0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+				0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+				0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+				0x9b, 0x42, 0x00, 0x01
+			};
+			const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+			uint8_t buf_out[100];
+			struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+			rohc_comp_last_packet_info2_t info;
+
+			if(j == 10)
+			{
+				CHECK(rohc_comp_set_wlsb_window_width(comp3, 8) == true);
+				CHECK(rohc_comp_get_wlsb_window_width(comp3, &width) == true);
+				CHECK(width == 8);
+				CHECK(rohc_comp_set_periodic_refreshes(comp3, 4, 2) == true);
+				CHECK(rohc_comp_get_periodic_refreshes(comp3, &ir_timeout,
+				                                       &fo_timeout) == true);
+				CHECK(ir_timeout == 4 && fo_timeout == 2);
+			}
+
+			CHECK(rohc_compress4(comp3, pkt, &pkt_out) == ROHC_STATUS_OK);
+
+			memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+			CHECK(rohc_comp_get_last_packet_info2(comp3, &info) == true);
+			if(j >= 3 && info.packet_type == ROHC_PACKET_IR)
+			{
+				/* no periodic refresh with the default timeouts */
+				CHECK(j >= 10);
+				ir_pkts_nr++;
+			}
+		}
+		/* the shorter IR timeout refreshed the context */
+		CHECK(ir_pkts_nr > 0);
+
+		rohc_comp_free(comp3);
+	}
+
+	/* rohc_comp_shards_*() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		struct rohc_comp_shards *shards;
+		struct rohc_comp_ctxt_record record;
+		struct rohc_comp *shard_comp;
+		size_t shard_id;
+
+		CHECK(rohc_comp_shards_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, 0,
+		                           random_cb, NULL) == NULL);
+		CHECK(rohc_comp_shards_new(ROHC_SMALL_CID, 3, 5, random_cb, NULL) == NULL);
+		CHECK(rohc_comp_shards_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX + 1, 4,
+		                           random_cb, NULL) == NULL);
+		shards = rohc_comp_shards_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, 4,
+		                              random_cb, NULL);
+		CHECK(shards != NULL);
+
+		CHECK(rohc_comp_shards_get(NULL, 0) == NULL);
+		CHECK(rohc_comp_shards_get(shards, 4) == NULL);
+		CHECK(rohc_comp_shards_get(shards, 3) != NULL);
+
+		/* the 16 small CIDs are split into 4 shards of 4 CIDs */
+		CHECK(rohc_comp_shards_select_cid(NULL, 0, &shard_id) == false);
+		CHECK(rohc_comp_shards_select_cid(shards, 0, NULL) == false);
+		CHECK(rohc_comp_shards_select_cid(shards, ROHC_SMALL_CID_MAX + 1,
+		                                  &shard_id) == false);
+		CHECK(rohc_comp_shards_select_cid(shards, 0, &shard_id) == true);
+		CHECK(shard_id == 0);
+		CHECK(rohc_comp_shards_select_cid(shards, 7, &shard_id) == true);
+		CHECK(shard_id == 1);
+		CHECK(rohc_comp_shards_select_cid(shards, ROHC_SMALL_CID_MAX,
+		                                  &shard_id) == true);
+		CHECK(shard_id == 3);
+
+		/* the packet is compressed by its shard with one CID of the shard */
+		CHECK(rohc_comp_shards_select(NULL, pkt, &shard_id) == false);
+		CHECK(rohc_comp_shards_select(shards, pkt, NULL) == false);
+		CHECK(rohc_comp_shards_select(shards, pkt, &shard_id) == true);
+		CHECK(shard_id < 4);
+		shard_comp = rohc_comp_shards_get(shards, shard_id);
+		CHECK(shard_comp != NULL);
+		CHECK(rohc_comp_enable_profile(shard_comp, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_compress4(shard_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(shard_comp, &record, 1) == 1);
+		CHECK(record.cid >= (shard_id * 4));
+		CHECK(record.cid < ((shard_id + 1) * 4));
+
+		/* feedback is enqueued for the shard that uses its CID */
+		{
+			const uint8_t feedback_cid7[] = { 0xf2, 0xe7, 0x00 };
+			const uint8_t feedback_cid0[] = { 0xf1, 0x00 };
+			const uint8_t feedback_bad[] = { 0xf3, 0xe7, 0x00 };
+			const struct rohc_buf fb_cid7 =
+				rohc_buf_init_full((uint8_t *) feedback_cid7,
+				                   sizeof(feedback_cid7), ts);
+			const struct rohc_buf fb_cid0 =
+				rohc_buf_init_full((uint8_t *) feedback_cid0,
+				                   sizeof(feedback_cid0), ts);
+			const struct rohc_buf fb_bad =
+				rohc_buf_init_full((uint8_t *) feedback_bad,
+				                   sizeof(feedback_bad), ts);
+			struct rohc_comp *const shard1_comp = rohc_comp_shards_get(shards, 1);
+			size_t i;
+
+			CHECK(shard1_comp != NULL);
+			CHECK(rohc_comp_shards_enqueue_feedback(NULL, fb_cid7) == false);
+			CHECK(rohc_comp_shards_enqueue_feedback(shards, fb_bad) == false);
+
+			/* the queue of shard #1 gets full, the other shards are not affected */
+			for(i = 0; i < 16; i++)
+			{
+				CHECK(rohc_comp_shards_enqueue_feedback(shards, fb_cid7) == true);
+			}
+			CHECK(rohc_comp_shards_enqueue_feedback(shards, fb_cid7) == false);
+			CHECK(rohc_comp_enqueue_feedback(shard1_comp, fb_cid7) == false);
+			CHECK(rohc_comp_shards_enqueue_feedback(shards, fb_cid0) == true);
+
+			/* shard #1 drains its queue with its next compression */
+			CHECK(rohc_comp_enable_profile(shard1_comp, ROHC_PROFILE_IP) == true);
+			pkt_out.len = 0;
+			CHECK(rohc_compress4(shard1_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+			CHECK(rohc_comp_shards_enqueue_feedback(shards, fb_cid7) == true);
+		}
+
+		rohc_comp_shards_free(NULL);
+		rohc_comp_shards_free(shards);
+	}
+
+	/* rohc_comp_engine_*() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		const struct rohc_mem_ops bad_ops = { NULL, NULL, NULL, NULL };
+		struct rohc_comp_engine *engine;
+		struct rohc_comp *chan1;
+		struct rohc_comp *chan2;
+
+		CHECK(rohc_comp_engine_new(&bad_ops) == NULL);
+		engine = rohc_comp_engine_new(NULL);
+		CHECK(engine != NULL);
+		CHECK(rohc_comp_engine_get_channels_nr(NULL) == 0);
+		CHECK(rohc_comp_engine_get_channels_nr(engine) == 0);
+
+		CHECK(rohc_comp_engine_new_channel(NULL, ROHC_SMALL_CID,
+		                                   ROHC_SMALL_CID_MAX, random_cb,
+		                                   NULL) == NULL);
+		CHECK(rohc_comp_engine_new_channel(engine, ROHC_SMALL_CID,
+		                                   ROHC_SMALL_CID_MAX + 1, random_cb,
+		                                   NULL) == NULL);
+		CHECK(rohc_comp_engine_new_channel(engine, ROHC_SMALL_CID,
+		                                   ROHC_SMALL_CID_MAX, NULL,
+		                                   NULL) == NULL);
+		chan1 = rohc_comp_engine_new_channel(engine, ROHC_SMALL_CID,
+		                                     ROHC_SMALL_CID_MAX, random_cb, NULL);
+		CHECK(chan1 != NULL);
+		chan2 = rohc_comp_engine_new_channel(engine, ROHC_LARGE_CID, 500,
+		                                     random_cb, NULL);
+		CHECK(chan2 != NULL);
+		CHECK(rohc_comp_engine_get_channels_nr(engine) == 2);
+
+		/* the memory functions of the channels are the ones of the engine */
+		CHECK(rohc_comp_set_alloc_cbs(chan1, NULL, NULL, NULL) == false);
+
+		/* every channel compresses with its own contexts */
+		CHECK(rohc_comp_enable_profile(chan1, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_comp_enable_profile(chan2, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_compress4(chan1, pkt, &pkt_out) == ROHC_STATUS_OK);
+		rohc_buf_reset(&pkt_out);
+		CHECK(rohc_compress4(chan2, pkt, &pkt_out) == ROHC_STATUS_OK);
+
+		/* the engine is released with its last channel */
+		rohc_comp_free(chan1);
+		CHECK(rohc_comp_engine_get_channels_nr(engine) == 1);
+		rohc_comp_engine_free(NULL);
+		rohc_comp_engine_free(engine);
+		rohc_comp_free(chan2);
+	}
+
+	/* contexts unused for longer than the idle timeout are destroyed */
+	{
+		const struct rohc_ts ts = { .sec = 100, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		struct rohc_comp_ctxt_record record;
+		struct rohc_comp *idle_comp;
+
+		idle_comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                           random_cb, NULL);
+		CHECK(idle_comp != NULL);
+		CHECK(rohc_comp_enable_profile(idle_comp, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_comp_set_ctxt_idle_timeout(idle_comp, 10) == true);
+
+		CHECK(rohc_compress4(idle_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		pkt.time.sec = 109;
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(idle_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(idle_comp, &record, 1) == 1);
+		CHECK(record.packets_nr == 2);
+
+		/* the context is re-created after 10 seconds without packets */
+		pkt.time.sec = 119;
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(idle_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(idle_comp, &record, 1) == 1);
+		CHECK(record.packets_nr == 1);
+
+		rohc_comp_free(idle_comp);
+	}
+
+	/* the contexts of the ended TCP connections are recycled first, then
+	 * destroyed once the linger time expires */
+	{
+		const struct rohc_ts ts = { .sec = 100, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x28,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x06, 0x93, 0x79,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x03, 0xe9, 0x00, 0x50,
+			0x00, 0x00, 0x00, 0x01,  0x00, 0x00, 0x00, 0x01,
+			0x50, 0x10, 0x72, 0x10,  0x12, 0x34, 0x00, 0x00
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		struct rohc_comp_ctxt_record records[2];
+		struct rohc_comp *closed_comp;
+
+		closed_comp = rohc_comp_new2(ROHC_SMALL_CID, 1, random_cb, NULL);
+		CHECK(closed_comp != NULL);
+		CHECK(rohc_comp_enable_profile(closed_comp, ROHC_PROFILE_TCP) == true);
+
+		/* two packets of the connection with port 1001, then the FIN of the
+		 * connection with port 1000 */
+		CHECK(rohc_compress4(closed_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(closed_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		buf[21] = 0xe8;
+		buf[33] = 0x11; /* FIN + ACK */
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(closed_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+
+		/* the connection with port 1002 recycles the context of the ended
+		 * connection, not the least recently used one */
+		buf[21] = 0xea;
+		buf[33] = 0x10;
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(closed_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(closed_comp, records, 2) == 2);
+		CHECK(records[0].packets_nr == 2 || records[1].packets_nr == 2);
+
+		/* the context of the connection with port 1002 is released 5 seconds
+		 * after its RST, not before */
+		CHECK(rohc_comp_set_closed_ctxt_linger(closed_comp, 5) == true);
+		buf[33] = 0x14; /* RST + ACK */
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(closed_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		buf[21] = 0xe9;
+		buf[33] = 0x10;
+		pkt.time.sec = 104;
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(closed_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(closed_comp, records, 2) == 2);
+		pkt.time.sec = 105;
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(closed_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(closed_comp, records, 2) == 1);
+		CHECK(records[0].packets_nr == 4);
+
+		rohc_comp_free(closed_comp);
+	}
+
+	/* contexts are refreshed once the periodic refresh time expires */
+	{
+		const struct rohc_ts ts = { .sec = 100, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		struct rohc_comp_ctxt_record record;
+		struct rohc_comp *refresh_comp;
+		size_t i;
+
+		refresh_comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                              random_cb, NULL);
+		CHECK(refresh_comp != NULL);
+		CHECK(rohc_comp_enable_profile(refresh_comp, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_comp_set_periodic_refreshes_time(refresh_comp, 2000, 500) == true);
+
+		/* one packet every 10 ms brings the context to SO state */
+		for(i = 0; i < 10; i++)
+		{
+			pkt.time.nsec = i * 10000000;
+			pkt_out.len = 0;
+			CHECK(rohc_compress4(refresh_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		}
+		CHECK(rohc_comp_get_contexts(refresh_comp, &record, 1) == 1);
+		CHECK(record.state == ROHC_COMP_STATE_SO);
+
+		/* the context goes back to FO state after 500 ms in SO state */
+		pkt.time.nsec = 600000000;
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(refresh_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(refresh_comp, &record, 1) == 1);
+		CHECK(record.state == ROHC_COMP_STATE_FO);
+
+		rohc_comp_free(refresh_comp);
+	}
+
+	/* the flows of high priority class are not recycled for the flows of
+	 * lower priority class, the latter are sent uncompressed */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8d,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x02,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		struct rohc_comp_ctxt_record records[2];
+		struct rohc_comp *prio_comp;
+
+		prio_comp = rohc_comp_new2(ROHC_SMALL_CID, 1, random_cb, NULL);
+		CHECK(prio_comp != NULL);
+		CHECK(rohc_comp_enable_profiles(prio_comp, ROHC_PROFILE_UNCOMPRESSED,
+		                                ROHC_PROFILE_IP, -1) == true);
+		CHECK(rohc_comp_set_priority_cb(prio_comp, priority_cb, NULL) == true);
+		CHECK(rohc_comp_set_compress_min_priority(prio_comp, 3) == true);
+
+		/* the flow of priority 2 is not compressed */
+		CHECK(rohc_compress4(prio_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(prio_comp, records, 2) == 1);
+		CHECK(records[0].profile == ROHC_PROFILE_UNCOMPRESSED);
+
+		/* the flow of priority 5 is compressed */
+		buf[11] = 0x8a; /* IP checksum */
+		buf[19] = 0x05;
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(prio_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(prio_comp, records, 2) == 2);
+
+		/* the flow of priority 1 shares the Uncompressed context */
+		buf[11] = 0x8e; /* IP checksum */
+		buf[19] = 0x01;
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(prio_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(prio_comp, records, 2) == 2);
+		CHECK(records[0].profile == ROHC_PROFILE_UNCOMPRESSED);
+		CHECK(records[0].packets_nr == 2);
+
+		/* the flow of priority 6 recycles the Uncompressed context */
+		buf[11] = 0x89; /* IP checksum */
+		buf[19] = 0x06;
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(prio_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(prio_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(prio_comp, records, 2) == 2);
+		CHECK(records[0].profile == ROHC_PROFILE_IP);
+		CHECK(records[1].profile == ROHC_PROFILE_IP);
+
+		/* the flow of priority 4 does not recycle the context of priority 6 */
+		buf[11] = 0x8b; /* IP checksum */
+		buf[19] = 0x04;
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(prio_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(prio_comp, records, 2) == 2);
+		CHECK((records[0].profile == ROHC_PROFILE_IP &&
+		       records[0].packets_nr == 2 &&
+		       records[1].profile == ROHC_PROFILE_UNCOMPRESSED) ||
+		      (records[1].profile == ROHC_PROFILE_IP &&
+		       records[1].packets_nr == 2 &&
+		       records[0].profile == ROHC_PROFILE_UNCOMPRESSED));
+
+		rohc_comp_free(prio_comp);
+	}
+
+	/* the flows sent uncompressed skip the profile probing with
+	 * ROHC_COMP_FEATURE_UNCOMP_CACHE */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		struct rohc_comp_ctxt_record records[2];
+		struct rohc_comp *uncomp_comp;
+
+		uncomp_comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                             random_cb, NULL);
+		CHECK(uncomp_comp != NULL);
+		CHECK(rohc_comp_enable_profile(uncomp_comp, ROHC_PROFILE_UNCOMPRESSED) == true);
+		CHECK(rohc_comp_set_features(uncomp_comp, ROHC_COMP_FEATURE_UNCOMP_CACHE) == true);
+
+		/* no profile but the Uncompressed one accepts the ICMP flow */
+		CHECK(rohc_compress4(uncomp_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(uncomp_comp, records, 2) == 1);
+		CHECK(records[0].profile == ROHC_PROFILE_UNCOMPRESSED);
+
+		/* the ICMP flow keeps the Uncompressed profile once remembered */
+		CHECK(rohc_comp_enable_profile(uncomp_comp, ROHC_PROFILE_IP) == true);
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(uncomp_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(uncomp_comp, records, 2) == 1);
+		CHECK(records[0].packets_nr == 2);
+
+		/* the profiles are probed again without the feature */
+		CHECK(rohc_comp_set_features(uncomp_comp, ROHC_COMP_FEATURE_NONE) == true);
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(uncomp_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(uncomp_comp, records, 2) == 2);
+
+		rohc_comp_free(uncomp_comp);
+	}
+
+	/* ROHC_COMP_FEATURE_ESTIMATE sizes the ROHC packets like the regular
+	 * compression does, but leaves their CRCs to zero */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		uint8_t non_ip_buf[] = { 0x00, 0x01, 0x02, 0x03 };
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		const struct rohc_buf non_ip_pkt =
+			rohc_buf_init_full(non_ip_buf, sizeof(non_ip_buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		uint8_t buf_hdr[100];
+		struct rohc_buf hdr = rohc_buf_init_empty(buf_hdr, 100);
+		struct rohc_comp *estim_comp;
+		struct rohc_comp *ref_comp;
+		size_t payload_offset;
+		size_t i;
+
+		estim_comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                            random_cb, NULL);
+		CHECK(estim_comp != NULL);
+		CHECK(rohc_comp_enable_profiles(estim_comp, ROHC_PROFILE_UNCOMPRESSED,
+		                                ROHC_PROFILE_IP, -1) == true);
+		CHECK(rohc_comp_set_features(estim_comp, ROHC_COMP_FEATURE_ESTIMATE) == true);
+		ref_comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                          random_cb, NULL);
+		CHECK(ref_comp != NULL);
+		CHECK(rohc_comp_enable_profiles(ref_comp, ROHC_PROFILE_UNCOMPRESSED,
+		                                ROHC_PROFILE_IP, -1) == true);
+
+		/* the packets get the same sizes as with the regular compression */
+		for(i = 0; i < 5; i++)
+		{
+			hdr.len = 0;
+			CHECK(rohc_compress_hdr(estim_comp, pkt, &hdr, &payload_offset) == ROHC_STATUS_OK);
+			pkt_out.len = 0;
+			CHECK(rohc_compress4(ref_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+			CHECK(payload_offset == 20);
+			CHECK(pkt_out.len == (hdr.len + pkt.len - payload_offset));
+			CHECK(rohc_buf_byte_at(hdr, 0) == rohc_buf_byte_at(pkt_out, 0));
+
+			/* the IR packet is not protected by its CRC */
+			CHECK(i > 0 || rohc_buf_byte_at(hdr, 2) == 0x00);
+			CHECK(i > 0 || rohc_buf_byte_at(pkt_out, 2) != 0x00);
+		}
+
+		/* the headers of the non-IP packets are sent uncompressed */
+		hdr.len = 0;
+		CHECK(rohc_compress_hdr(estim_comp, non_ip_pkt, &hdr, &payload_offset) == ROHC_STATUS_OK);
+		CHECK(payload_offset == 0);
+
+		rohc_comp_free(ref_comp);
+		rohc_comp_free(estim_comp);
+	}
+
+	/* ROHC_COMP_FEATURE_BURST_GROUPING compresses the interleaved flows of a
+	 * burst flow by flow, but the ROHC packets keep their slots */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		const uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const uint8_t flows[] = { 0, 1, 0, 2, 1, 0, 0, 2, 1, 1 };
+		uint8_t bufs[10][sizeof(buf)];
+		uint8_t bufs_grouped[10][100];
+		uint8_t bufs_ref[10][100];
+		struct rohc_buf pkts[10];
+		struct rohc_buf pkts_grouped[10];
+		struct rohc_buf pkts_ref[10];
+		rohc_status_t status_grouped[10];
+		rohc_status_t status_ref[10];
+		struct rohc_comp *grouped_comp;
+		struct rohc_comp *ref_comp;
+		size_t i;
+
+		grouped_comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                              random_cb, NULL);
+		CHECK(grouped_comp != NULL);
+		CHECK(rohc_comp_enable_profiles(grouped_comp, ROHC_PROFILE_UNCOMPRESSED,
+		                                ROHC_PROFILE_IP, -1) == true);
+		CHECK(rohc_comp_set_features(grouped_comp,
+		                             ROHC_COMP_FEATURE_BURST_GROUPING) == true);
+		ref_comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                          random_cb, NULL);
+		CHECK(ref_comp != NULL);
+		CHECK(rohc_comp_enable_profiles(ref_comp, ROHC_PROFILE_UNCOMPRESSED,
+		                                ROHC_PROFILE_IP, -1) == true);
+
+		for(i = 0; i < 10; i++)
+		{
+			const struct rohc_buf pkt = rohc_buf_init_full(bufs[i], sizeof(buf), ts);
+			const struct rohc_buf pkt_grouped = rohc_buf_init_empty(bufs_grouped[i], 100);
+			const struct rohc_buf pkt_ref = rohc_buf_init_empty(bufs_ref[i], 100);
+
+			/* one destination per flow, keep the IP checksum right */
+			memcpy(bufs[i], buf, sizeof(buf));
+			bufs[i][19] += flows[i];
+			bufs[i][11] -= flows[i];
+			pkts[i] = pkt;
+			pkts_grouped[i] = pkt_grouped;
+			pkts_ref[i] = pkt_ref;
+		}
+		CHECK(rohc_compress_burst(grouped_comp, pkts, pkts_grouped,
+		                          status_grouped, 10) == 10);
+		CHECK(rohc_compress_burst(ref_comp, pkts, pkts_ref, status_ref, 10) == 10);
+
+		/* every flow got the same ROHC packets in the same slots */
+		for(i = 0; i < 10; i++)
+		{
+			CHECK(status_grouped[i] == ROHC_STATUS_OK);
+			CHECK(status_ref[i] == ROHC_STATUS_OK);
+			CHECK(pkts_grouped[i].len == pkts_ref[i].len);
+			CHECK(memcmp(rohc_buf_data(pkts_grouped[i]), rohc_buf_data(pkts_ref[i]),
+			             pkts_ref[i].len) == 0);
+		}
+
+		rohc_comp_free(ref_comp);
+		rohc_comp_free(grouped_comp);
+	}
+
+	/* the IR packets are paced with rohc_comp_set_ir_pacing() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		struct rohc_comp_ctxt_record records[3];
+		struct rohc_comp *pacing_comp;
+
+		pacing_comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                             random_cb, NULL);
+		CHECK(pacing_comp != NULL);
+		CHECK(rohc_comp_enable_profiles(pacing_comp, ROHC_PROFILE_UNCOMPRESSED,
+		                                ROHC_PROFILE_IP, -1) == true);
+		CHECK(rohc_comp_set_ir_pacing(pacing_comp, 1, 1000) == true);
+
+		/* the first flow spends the IR budget of the interval */
+		CHECK(rohc_compress4(pacing_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(pacing_comp, records, 3) == 1);
+		CHECK(records[0].packets_nr == 1);
+
+		/* the second flow waits for the next interval */
+		buf[11] = 0x89; /* IP checksum */
+		buf[19] = 0x06;
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(pacing_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(pacing_comp, records, 3) == 3);
+		CHECK(records[0].profile == ROHC_PROFILE_UNCOMPRESSED);
+		CHECK(records[0].packets_nr == 1);
+		CHECK(records[1].profile == ROHC_PROFILE_IP);
+		CHECK(records[1].packets_nr == 0);
+
+		/* the second flow sends its IR packet in the next interval */
+		pkt.time.sec = 1;
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(pacing_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(pacing_comp, records, 3) == 3);
+		CHECK(records[0].profile == ROHC_PROFILE_IP);
+		CHECK(records[0].packets_nr == 1);
+		CHECK(records[1].profile == ROHC_PROFILE_UNCOMPRESSED);
+		CHECK(records[1].packets_nr == 1);
+
+		rohc_comp_free(pacing_comp);
+	}
+
+	/* the new flows are sent uncompressed while the compressor is
+	 * overloaded, see rohc_comp_set_overload() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		const struct rohc_load limits = { .queue_depth = 32, .burst_time_us = 0 };
+		const struct rohc_load busy = { .queue_depth = 33, .burst_time_us = 0 };
+		const struct rohc_load idle = { .queue_depth = 1, .burst_time_us = 0 };
+		struct rohc_comp_ctxt_record records[3];
+		rohc_comp_general_info_t info;
+		struct rohc_comp *overload_comp;
+
+		overload_comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                               random_cb, NULL);
+		CHECK(overload_comp != NULL);
+		CHECK(rohc_comp_enable_profiles(overload_comp, ROHC_PROFILE_UNCOMPRESSED,
+		                                ROHC_PROFILE_IP, -1) == true);
+		CHECK(rohc_comp_set_overload(overload_comp, &limits) == true);
+
+		/* the first flow starts while the compressor is overloaded */
+		CHECK(rohc_comp_set_load(overload_comp, &busy) == true);
+		CHECK(rohc_compress4(overload_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(overload_comp, records, 3) == 1);
+		CHECK(records[0].profile == ROHC_PROFILE_UNCOMPRESSED);
+
+		/* the flow gets a context of its own once the overload is over */
+		CHECK(rohc_comp_set_load(overload_comp, &idle) == true);
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(overload_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(overload_comp, records, 3) == 2);
+		CHECK(records[0].profile == ROHC_PROFILE_IP);
+
+		memset(&info, 0, sizeof(rohc_comp_general_info_t));
+		info.version_minor = 2;
+		CHECK(rohc_comp_get_general_info(overload_comp, &info) == true);
+		CHECK(info.overloads_nr == 1);
+		CHECK(info.overload_pkts_nr == 1);
+		CHECK(info.overload_flows_nr == 1);
+
+		rohc_comp_free(overload_comp);
+	}
+
+	/* the published configuration is taken with the next packet, see
+	 * rohc_comp_publish_cfg() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		struct rohc_comp_cfg cfg;
+		struct rohc_comp *cfg_comp;
+
+		cfg_comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                          random_cb, NULL);
+		CHECK(cfg_comp != NULL);
+		CHECK(rohc_comp_enable_profile(cfg_comp, ROHC_PROFILE_IP) == true);
+
+		CHECK(rohc_comp_get_cfg(cfg_comp, &cfg) == true);
+		cfg.refresh_ir_timeout = 10;
+		cfg.refresh_fo_timeout = 5;
+		cfg.mem_budget = 1000000;
+		CHECK(cfg.effort == ROHC_COMP_EFFORT_DEFAULT);
+		cfg.effort = ROHC_COMP_EFFORT_FAST;
+		CHECK(rohc_comp_publish_cfg(cfg_comp, &cfg) == true);
+
+		/* not taken before the next packet */
+		memset(&cfg, 0, sizeof(struct rohc_comp_cfg));
+		CHECK(rohc_comp_get_cfg(cfg_comp, &cfg) == true);
+		CHECK(cfg.refresh_ir_timeout != 10);
+		CHECK(cfg.mem_budget == 0);
+
+		CHECK(rohc_compress4(cfg_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_cfg(cfg_comp, &cfg) == true);
+		CHECK(cfg.refresh_ir_timeout == 10);
+		CHECK(cfg.refresh_fo_timeout == 5);
+		CHECK(cfg.mem_budget == 1000000);
+		CHECK(cfg.effort == ROHC_COMP_EFFORT_FAST);
+
+		rohc_comp_free(cfg_comp);
+	}
+
+	/* rohc_comp_set_mem_budget() and rohc_comp_get_mem_usage() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		struct rohc_comp_ctxt_record records[2];
+		struct rohc_comp *budget_comp;
+		size_t usage_before;
+		size_t usage;
+
+		budget_comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                             random_cb, NULL);
+		CHECK(budget_comp != NULL);
+		CHECK(rohc_comp_enable_profile(budget_comp, ROHC_PROFILE_IP) == true);
+
+		CHECK(rohc_comp_get_mem_usage(NULL, &usage) == false);
+		CHECK(rohc_comp_get_mem_usage(budget_comp, NULL) == false);
+		CHECK(rohc_comp_get_mem_usage(budget_comp, &usage_before) == true);
+		CHECK(usage_before > 0);
+		CHECK(rohc_comp_set_mem_budget(NULL, usage_before) == false);
+
+		/* the first context makes the memory grow */
+		CHECK(rohc_compress4(budget_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_mem_usage(budget_comp, &usage) == true);
+		CHECK(usage > usage_before);
+
+		/* once the budget is exhausted, new flows recycle the oldest context */
+		CHECK(rohc_comp_set_mem_budget(budget_comp, usage) == true);
+		buf[11] = 0x89; /* IP checksum */
+		buf[19] = 0x06;
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(budget_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(budget_comp, records, 2) == 1);
+		CHECK(records[0].cid == 0);
+		CHECK(rohc_comp_get_mem_usage(budget_comp, &usage_before) == true);
+		CHECK(usage_before == usage);
+
+		/* without budget, new flows get new contexts */
+		CHECK(rohc_comp_set_mem_budget(budget_comp, 0) == true);
+		buf[11] = 0x88; /* IP checksum */
+		buf[19] = 0x07;
+		pkt_out.len = 0;
+		CHECK(rohc_compress4(budget_comp, pkt, &pkt_out) == ROHC_STATUS_OK);
+		CHECK(rohc_comp_get_contexts(budget_comp, records, 2) == 2);
+
+		rohc_comp_free(budget_comp);
+	}
+
 	/* rohc_comp_free() */
 	rohc_comp_free(NULL);
 	rohc_comp_free(comp);
@@ -401,3 +2141,103 @@ static int random_cb(const struct rohc_comp *const comp __attribute__((unused)),
 	return 0; /* fake */
 }
 
+
+/**
+ * @brief Allocate memory for the compressor
+ *
+ * @param size  The size of the memory to allocate
+ * @param priv  Private data
+ * @return      The allocated memory
+ */
+static void * alloc_cb(const size_t size,
+                       void *const priv __attribute__((unused)))
+{
+	return malloc(size);
+}
+
+
+/**
+ * @brief Free memory for the compressor
+ *
+ * @param ptr   The memory to free
+ * @param priv  Private data
+ */
+static void free_cb(void *const ptr, void *const priv __attribute__((unused)))
+{
+	free(ptr);
+}
+
+
+/**
+ * @brief Allocate memory for the compressor and count the allocations
+ *
+ * @param size  The number of bytes to allocate
+ * @param priv  The number of allocations not freed yet
+ * @return      The allocated memory
+ */
+static void * count_alloc_cb(const size_t size, void *const priv)
+{
+	size_t *const allocs_nr = priv;
+	void *const ptr = malloc(size);
+
+	if(ptr != NULL)
+	{
+		(*allocs_nr)++;
+	}
+	return ptr;
+}
+
+
+/**
+ * @brief Free memory for the compressor and count the allocations
+ *
+ * @param ptr   The memory to free
+ * @param priv  The number of allocations not freed yet
+ */
+static void count_free_cb(void *const ptr, void *const priv)
+{
+	size_t *const allocs_nr = priv;
+
+	(*allocs_nr)--;
+	free(ptr);
+}
+
+
+/**
+ * @brief Classify the flows: the priority class is the last byte of the
+ *        destination IPv4 address
+ *
+ * @param packet      The uncompressed packet
+ * @param packet_len  The length of the uncompressed packet
+ * @param priv_ctxt   Private data
+ * @return            The priority class of the flow
+ */
+/**
+ * @brief Count the traces of the compressor
+ *
+ * @param priv_ctxt  The number of traces
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace
+ * @param profile    The ID of the ROHC compression profile
+ * @param format     The format string of the trace
+ */
+static void count_trace_cb(void *const priv_ctxt,
+                           const rohc_trace_level_t level __attribute__((unused)),
+                           const rohc_trace_entity_t entity __attribute__((unused)),
+                           const int profile __attribute__((unused)),
+                           const char *const format __attribute__((unused)),
+                           ...)
+{
+	size_t *const traces_nr = priv_ctxt;
+
+	(*traces_nr)++;
+}
+
+
+static unsigned int priority_cb(const unsigned char *const packet,
+                                const size_t packet_len,
+                                void *const priv_ctxt __attribute__((unused)))
+{
+	return (packet_len >= 20 ? packet[19] : 0);
+}
+
@@ -66,6 +66,9 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
+static size_t d_esp_mem_max(void)
+	__attribute__((warn_unused_result, const));
+
 static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(1, 2)));
@@ -100,6 +103,23 @@ static void esp_update_context(struct rohc_decomp_ctxt *const context,
  * Private function definitions
  */
 
+/** The handlers of the ESP profile for the generic RFC3095-based code */
+static const struct rohc_decomp_rfc3095_ops d_esp_rfc3095_ops =
+{
+	.parse_static_next_hdr   = esp_parse_static_esp,
+	.parse_dyn_next_hdr      = esp_parse_dynamic_esp,
+	.parse_ext3              = ip_parse_ext3,
+	.parse_uo_remainder      = NULL,
+	.decode_values_from_bits = esp_decode_values_from_bits,
+	.build_next_header       = esp_build_uncomp_esp,
+	.compute_crc_static      = esp_compute_crc_static,
+	.compute_crc_dynamic     = esp_compute_crc_dynamic,
+	.update_context          = esp_update_context,
+	.decode_fast_next_hdr    = NULL,
+	.patch_next_hdr          = NULL,
+};
+
+
 /**
  * @brief Create the ESP decompression context
  *
@@ -116,6 +136,7 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
+	struct rohc_slab *const slab = context->decompressor->ctxt_slab;
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 	struct d_esp_context *esp_context;
 
@@ -124,7 +145,8 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 	assert(context->profile != NULL);
 
 	/* create the generic context */
-	if(!rohc_decomp_rfc3095_create(context, persist_ctxt, volat_ctxt,
+	if(!rohc_decomp_rfc3095_create(context, &d_esp_rfc3095_ops,
+	                               persist_ctxt, volat_ctxt,
 	                               context->decompressor->trace_callback,
 	                               context->decompressor->trace_callback_priv,
 	                               context->profile->id))
@@ -136,7 +158,7 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt = *persist_ctxt;
 
 	/* create the ESP-specific part of the context */
-	esp_context = malloc(sizeof(struct d_esp_context));
+	esp_context = rohc_slab_alloc(slab, sizeof(struct d_esp_context));
 	if(esp_context == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -148,7 +170,7 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the LSB decoding context for SN (same shift value as RTP) */
 	rfc3095_ctxt->sn_lsb_p = ROHC_LSB_SHIFT_ESP_SN;
-	rfc3095_ctxt->sn_lsb_ctxt = rohc_lsb_new(32);
+	rfc3095_ctxt->sn_lsb_ctxt = rohc_lsb_new(slab, 32);
 	if(rfc3095_ctxt->sn_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -158,19 +180,11 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* some ESP-specific values and functions */
 	rfc3095_ctxt->next_header_len = sizeof(struct esphdr);
-	rfc3095_ctxt->parse_static_next_hdr = esp_parse_static_esp;
-	rfc3095_ctxt->parse_dyn_next_hdr = esp_parse_dynamic_esp;
-	rfc3095_ctxt->parse_ext3 = ip_parse_ext3;
-	rfc3095_ctxt->parse_uo_remainder = NULL;
-	rfc3095_ctxt->decode_values_from_bits = esp_decode_values_from_bits;
-	rfc3095_ctxt->build_next_header = esp_build_uncomp_esp;
-	rfc3095_ctxt->compute_crc_static = esp_compute_crc_static;
-	rfc3095_ctxt->compute_crc_dynamic = esp_compute_crc_dynamic;
-	rfc3095_ctxt->update_context = esp_update_context;
 
 	/* create the ESP-specific part of the header changes */
 	rfc3095_ctxt->outer_ip_changes->next_header_len = sizeof(struct esphdr);
-	rfc3095_ctxt->outer_ip_changes->next_header = malloc(sizeof(struct esphdr));
+	rfc3095_ctxt->outer_ip_changes->next_header =
+		rohc_slab_alloc(slab, sizeof(struct esphdr));
 	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -181,7 +195,8 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 	memset(rfc3095_ctxt->outer_ip_changes->next_header, 0, sizeof(struct esphdr));
 
 	rfc3095_ctxt->inner_ip_changes->next_header_len = sizeof(struct esphdr);
-	rfc3095_ctxt->inner_ip_changes->next_header = malloc(sizeof(struct esphdr));
+	rfc3095_ctxt->inner_ip_changes->next_header =
+		rohc_slab_alloc(slab, sizeof(struct esphdr));
 	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -197,11 +212,11 @@ static bool d_esp_create(const struct rohc_decomp_ctxt *const context,
 	return true;
 
 free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_slab_zfree(rfc3095_ctxt->outer_ip_changes->next_header);
 free_lsb_sn:
 	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
 free_esp_context:
-	zfree(esp_context);
+	rohc_slab_zfree(rfc3095_ctxt->specific);
 destroy_context:
 	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
 quit:
@@ -223,9 +238,9 @@ static void d_esp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
 {
 	/* clean ESP-specific memory */
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_slab_zfree(rfc3095_ctxt->outer_ip_changes->next_header);
 	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
+	rohc_slab_zfree(rfc3095_ctxt->inner_ip_changes->next_header);
 
 	/* destroy the LSB decoding context for SN */
 	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
@@ -433,6 +448,20 @@ static void esp_update_context(struct rohc_decomp_ctxt *const context,
 }
 
 
+/**
+ * @brief Get the maximum length one ESP context takes in a memory block
+ *
+ * @return  The maximum number of bytes of the memory block the
+ *          profile-specific part of the context takes
+ */
+static size_t d_esp_mem_max(void)
+{
+	return (rohc_decomp_rfc3095_mem_max() +
+	        rohc_slab_block_mem_max(sizeof(struct d_esp_context)) +
+	        rohc_lsb_mem_max() + 2 * rohc_slab_block_mem_max(sizeof(struct esphdr)));
+}
+
+
 /**
  * @brief Define the decompression part of the ESP profile as described
  *        in the RFC 3095.
@@ -450,5 +479,8 @@ const struct rohc_decomp_profile d_esp_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.decode_fast     = NULL,
+	.prefetch        = rohc_decomp_rfc3095_prefetch,
+	.get_mem_max     = d_esp_mem_max,
 };
 
@@ -45,11 +45,31 @@ static bool d_ip_create(const struct rohc_decomp_ctxt *const context,
                         struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
+static size_t d_ip_mem_max(void)
+	__attribute__((warn_unused_result, const));
+
 static void d_ip_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                          const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(1, 2)));
 
 
+/** The handlers of the IP-only profile for the generic RFC3095-based code */
+static const struct rohc_decomp_rfc3095_ops d_ip_rfc3095_ops =
+{
+	.parse_static_next_hdr   = NULL,
+	.parse_dyn_next_hdr      = ip_parse_dynamic_ip,
+	.parse_ext3              = ip_parse_ext3,
+	.parse_uo_remainder      = NULL,
+	.decode_values_from_bits = NULL,
+	.build_next_header       = NULL,
+	.compute_crc_static      = compute_crc_static,
+	.compute_crc_dynamic     = compute_crc_dynamic,
+	.update_context          = NULL,
+	.decode_fast_next_hdr    = NULL,
+	.patch_next_hdr          = NULL,
+};
+
+
 /**
  * @brief Create the IP decompression context.
  *
@@ -66,6 +86,7 @@ static bool d_ip_create(const struct rohc_decomp_ctxt *const context,
                         struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
                         struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
+	struct rohc_slab *const slab = context->decompressor->ctxt_slab;
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 
 	assert(context != NULL);
@@ -73,7 +94,8 @@ static bool d_ip_create(const struct rohc_decomp_ctxt *const context,
 	assert(context->profile != NULL);
 
 	/* create the generic context */
-	if(!rohc_decomp_rfc3095_create(context, persist_ctxt, volat_ctxt,
+	if(!rohc_decomp_rfc3095_create(context, &d_ip_rfc3095_ops,
+	                               persist_ctxt, volat_ctxt,
 	                               context->decompressor->trace_callback,
 	                               context->decompressor->trace_callback_priv,
 	                               context->profile->id))
@@ -87,7 +109,7 @@ static bool d_ip_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the LSB decoding context for SN */
 	rfc3095_ctxt->sn_lsb_p = ROHC_LSB_SHIFT_SN;
-	rfc3095_ctxt->sn_lsb_ctxt = rohc_lsb_new(16);
+	rfc3095_ctxt->sn_lsb_ctxt = rohc_lsb_new(slab, 16);
 	if(rfc3095_ctxt->sn_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -95,14 +117,10 @@ static bool d_ip_create(const struct rohc_decomp_ctxt *const context,
 		goto free_context;
 	}
 
-	/* some IP-specific values and functions */
-	rfc3095_ctxt->parse_dyn_next_hdr = ip_parse_dynamic_ip;
-	rfc3095_ctxt->parse_ext3 = ip_parse_ext3;
-
 	return true;
 
 free_context:
-	zfree(rfc3095_ctxt);
+	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
 quit:
 	return false;
 }
@@ -148,37 +166,15 @@ rohc_packet_t ip_detect_packet_type(const struct rohc_decomp_ctxt *const context
 		goto error;
 	}
 
-	if(rohc_decomp_packet_is_uo0(rohc_packet, rohc_length))
-	{
-		/* UO-0 packet */
-		type = ROHC_PACKET_UO_0;
-	}
-	else if(rohc_decomp_packet_is_uo1(rohc_packet, rohc_length))
-	{
-		/* UO-1 packet */
-		type = ROHC_PACKET_UO_1;
-	}
-	else if(rohc_decomp_packet_is_uor2(rohc_packet, rohc_length))
-	{
-		/* UOR-2 packet */
-		type = ROHC_PACKET_UOR_2;
-	}
-	else if(rohc_decomp_packet_is_irdyn(rohc_packet, rohc_length))
+	/* UO-0, UO-1, UOR-2, IR-DYN or IR packet (R-0, R-0-CRC, UOR-2, IR-DYN or
+	 * IR packet in R-mode) */
+	type = rohc_decomp_pkt_type(context->mode == ROHC_R_MODE ?
+	                            rohc_decomp_pkt_types_ip_r :
+	                            rohc_decomp_pkt_types_ip, rohc_packet[0]);
+	if(type == ROHC_PACKET_UNKNOWN)
 	{
-		/* IR-DYN packet */
-		type = ROHC_PACKET_IR_DYN;
-	}
-	else if(rohc_decomp_packet_is_ir(rohc_packet, rohc_length))
-	{
-		/* IR packet */
-		type = ROHC_PACKET_IR;
-	}
-	else
-	{
-		/* unknown packet */
 		rohc_decomp_warn(context, "failed to recognize the packet type in byte "
 		                 "0x%02x", rohc_packet[0]);
-		type = ROHC_PACKET_UNKNOWN;
 	}
 
 	return type;
@@ -771,6 +767,18 @@ error:
 }
 
 
+/**
+ * @brief Get the maximum length one IP-only context takes in a memory block
+ *
+ * @return  The maximum number of bytes of the memory block the
+ *          profile-specific part of the context takes
+ */
+static size_t d_ip_mem_max(void)
+{
+	return (rohc_decomp_rfc3095_mem_max() + rohc_lsb_mem_max());
+}
+
+
 /**
  * @brief Define the decompression part of the IP-only profile as described
  *        in the RFC 3843.
@@ -788,5 +796,8 @@ const struct rohc_decomp_profile d_ip_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.decode_fast     = NULL,
+	.prefetch        = rohc_decomp_rfc3095_prefetch,
+	.get_mem_max     = d_ip_mem_max,
 };
 
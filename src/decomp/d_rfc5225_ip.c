@@ -0,0 +1,1737 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   d_rfc5225_ip.c
+ * @brief  ROHC decompression context for the ROHCv2 IP-only profile
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * See c_rfc5225_ip.c for the subset of RFC 5225 that the profile supports.
+ *
+ * The decompressor does not repair the context upon CRC failure: the packet
+ * is dropped and the context is repaired by the co_repair or IR packets that
+ * the compressor sends after a NACK or a STATIC-NACK, or periodically in
+ * U-mode.
+ */
+
+#include "rohc_decomp.h"
+#include "rohc_decomp_internals.h"
+#include "rohc_decomp_detect_packet.h"
+#include "rohc_packets.h"
+#include "rohc_bit_stream.h"
+#include "rohc_traces_internal.h"
+#include "rohc_utils.h"
+#include "rohc_debug.h"
+#include "ip.h"
+#include "schemes/decomp_wlsb.h"
+#include "protocols/ip.h"
+#include "protocols/ipv4.h"
+#include "protocols/ipv6.h"
+#include "protocols/rfc5225.h"
+#include "crc.h"
+
+#include "config.h" /* for WORDS_BIGENDIAN */
+
+#ifndef __KERNEL__
+#  include <string.h>
+#endif
+#include <stdint.h>
+
+
+/** The LSB shift parameter of the innermost IP-ID offset with k bits
+ *  (RFC 5225, §6.6.7: ip_id_lsb) */
+#define RFC5225_IP_ID_LSB_P(k)  ((1 << (k)) / 4 - 1)
+
+
+/** The decompression context of one IP header */
+struct d_rfc5225_ip_hdr_ctxt
+{
+	uint8_t version;         /**< The IP version */
+	uint8_t next_proto;      /**< The protocol after the IP header */
+	uint8_t tos_tc;          /**< The IPv4 TOS or the IPv6 Traffic Class */
+	uint8_t ttl_hopl;        /**< The IPv4 TTL or the IPv6 Hop Limit */
+	uint8_t df;              /**< The IPv4 Don't Fragment (DF) flag */
+	uint8_t ip_id_behavior;  /**< The behavior of the IPv4 IP-ID */
+	uint32_t flow_label;     /**< The IPv6 Flow Label */
+	uint8_t saddr[16];       /**< The source address, 4 bytes for IPv4 */
+	uint8_t daddr[16];       /**< The destination address, 4 bytes for IPv4 */
+};
+
+
+/** The persistent decompression context of the ROHCv2 IP-only profile */
+struct d_rfc5225_ip_ctxt
+{
+	/** The LSB decoding context of the MSN */
+	struct rohc_lsb_decode *msn_lsb_ctxt;
+	/** The LSB decoding context of the innermost IP-ID offset */
+	struct rohc_lsb_decode *ip_id_lsb_ctxt;
+
+	size_t ip_hdrs_nr;  /**< The number of IP headers */
+	/** The contexts of the IP headers, from the outermost to the innermost */
+	struct d_rfc5225_ip_hdr_ctxt ip_hdrs[ROHC_RFC5225_MAX_IP_HDRS];
+};
+
+
+/** The bits extracted for one IP header */
+struct rfc5225_ip_extr_ip_bits
+{
+	uint8_t version;           /**< The IP version */
+	uint8_t next_proto;        /**< The protocol after the IP header */
+	uint32_t flow_label;       /**< The IPv6 Flow Label */
+	uint8_t saddr[16];         /**< The source address */
+	uint8_t daddr[16];         /**< The destination address */
+
+	bool tos_tc_present;       /**< Whether the TOS/TC was transmitted */
+	uint8_t tos_tc;            /**< The IPv4 TOS or the IPv6 Traffic Class */
+	bool ttl_hopl_present;     /**< Whether the TTL/HL was transmitted */
+	uint8_t ttl_hopl;          /**< The IPv4 TTL or the IPv6 Hop Limit */
+	bool df_present;           /**< Whether the DF flag was transmitted */
+	uint8_t df;                /**< The IPv4 Don't Fragment (DF) flag */
+	bool ip_id_behavior_present; /**< Whether the IP-ID behavior was transmitted */
+	uint8_t ip_id_behavior;    /**< The behavior of the IPv4 IP-ID */
+	bool ip_id_present;        /**< Whether the full IP-ID was transmitted */
+	uint16_t ip_id;            /**< The full IPv4 IP-ID */
+};
+
+
+/** The bits extracted from one ROHCv2 IP-only packet */
+struct rohc_rfc5225_ip_extr_bits
+{
+	size_t ip_nr;  /**< The number of IP headers */
+	/** The bits extracted for the IP headers */
+	struct rfc5225_ip_extr_ip_bits ip[ROHC_RFC5225_MAX_IP_HDRS];
+
+	struct rohc_lsb_field16 msn;           /**< The MSN bits */
+	struct rohc_lsb_field16 ip_id_offset;  /**< The innermost IP-ID offset bits */
+
+	bool ctrl_crc_present;  /**< Whether the control CRC was transmitted */
+	uint8_t ctrl_crc;       /**< The control CRC-3 */
+	uint8_t reorder_ratio;  /**< The reorder ratio */
+};
+
+
+/** The values decoded for one IP header */
+struct rfc5225_ip_decoded_ip
+{
+	uint8_t version;         /**< The IP version */
+	uint8_t next_proto;      /**< The protocol after the IP header */
+	uint8_t tos_tc;          /**< The IPv4 TOS or the IPv6 Traffic Class */
+	uint8_t ttl_hopl;        /**< The IPv4 TTL or the IPv6 Hop Limit */
+	uint8_t df;              /**< The IPv4 Don't Fragment (DF) flag */
+	uint8_t ip_id_behavior;  /**< The behavior of the IPv4 IP-ID */
+	uint16_t ip_id;          /**< The IPv4 IP-ID */
+	uint32_t flow_label;     /**< The IPv6 Flow Label */
+	uint8_t saddr[16];       /**< The source address */
+	uint8_t daddr[16];       /**< The destination address */
+};
+
+
+/** The values decoded from one ROHCv2 IP-only packet */
+struct rohc_rfc5225_ip_decoded
+{
+	size_t ip_nr;  /**< The number of IP headers */
+	/** The values decoded for the IP headers */
+	struct rfc5225_ip_decoded_ip ip[ROHC_RFC5225_MAX_IP_HDRS];
+	uint16_t msn;           /**< The MSN */
+	uint16_t ip_id_offset;  /**< The innermost IP-ID offset */
+};
+
+
+/*
+ * Private function prototypes.
+ */
+
+static bool d_rfc5225_ip_create(const struct rohc_decomp_ctxt *const context,
+                                struct d_rfc5225_ip_ctxt **const persist_ctxt,
+                                struct rohc_decomp_volat_ctxt *const volat_ctxt)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+static size_t d_rfc5225_ip_mem_max(void)
+	__attribute__((warn_unused_result, const));
+static void d_rfc5225_ip_destroy(struct d_rfc5225_ip_ctxt *const rfc5225_ctxt,
+                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+	__attribute__((nonnull(1, 2)));
+
+static rohc_packet_t d_rfc5225_ip_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
+                                                  const uint8_t *const rohc_packet,
+                                                  const size_t rohc_length,
+                                                  const size_t large_cid_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+
+static bool d_rfc5225_ip_parse_pkt(const struct rohc_decomp_ctxt *const context,
+                                   const struct rohc_buf rohc_packet,
+                                   const size_t large_cid_len,
+                                   rohc_packet_t *const packet_type,
+                                   struct rohc_decomp_crc *const extr_crc,
+                                   struct rohc_rfc5225_ip_extr_bits *const bits,
+                                   size_t *const rohc_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 4, 5, 6, 7)));
+static bool d_rfc5225_ip_parse_ir(const struct rohc_decomp_ctxt *const context,
+                                  const uint8_t *const rohc_packet,
+                                  const size_t rohc_length,
+                                  const size_t large_cid_len,
+                                  struct rohc_decomp_crc *const extr_crc,
+                                  struct rohc_rfc5225_ip_extr_bits *const bits,
+                                  size_t *const rohc_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6, 7)));
+static bool d_rfc5225_ip_parse_co(const struct rohc_decomp_ctxt *const context,
+                                  const uint8_t *const rohc_packet,
+                                  const size_t rohc_length,
+                                  const size_t large_cid_len,
+                                  const rohc_packet_t packet_type,
+                                  struct rohc_decomp_crc *const extr_crc,
+                                  struct rohc_rfc5225_ip_extr_bits *const bits,
+                                  size_t *const rohc_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 6, 7, 8)));
+static bool d_rfc5225_ip_parse_co_common(const struct rohc_decomp_ctxt *const context,
+                                         struct rohc_bit_reader *const reader,
+                                         struct rohc_decomp_crc *const extr_crc,
+                                         struct rohc_rfc5225_ip_extr_bits *const bits,
+                                         bool *const outer_ip_flag)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
+static bool d_rfc5225_ip_parse_static_chain(const struct rohc_decomp_ctxt *const context,
+                                            const uint8_t *const rohc_packet,
+                                            const size_t rohc_length,
+                                            struct rohc_rfc5225_ip_extr_bits *const bits,
+                                            size_t *const parsed_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
+static bool d_rfc5225_ip_parse_dyn_chain(const struct rohc_decomp_ctxt *const context,
+                                         const uint8_t *const rohc_packet,
+                                         const size_t rohc_length,
+                                         struct rohc_rfc5225_ip_extr_bits *const bits,
+                                         size_t *const parsed_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
+static bool d_rfc5225_ip_parse_irreg_chain(const struct rohc_decomp_ctxt *const context,
+                                           const uint8_t *const rohc_packet,
+                                           const size_t rohc_length,
+                                           const bool outer_ip_flag,
+                                           struct rohc_rfc5225_ip_extr_bits *const bits,
+                                           size_t *const parsed_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6)));
+static void d_rfc5225_ip_reset_extr_bits(const struct rohc_decomp_ctxt *const context,
+                                         struct rohc_rfc5225_ip_extr_bits *const bits)
+	__attribute__((nonnull(1, 2)));
+
+static bool d_rfc5225_ip_decode_bits(const struct rohc_decomp_ctxt *const context,
+                                     const struct rohc_rfc5225_ip_extr_bits *const bits,
+                                     const size_t payload_len,
+                                     struct rohc_rfc5225_ip_decoded *const decoded)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+static bool d_rfc5225_ip_decode_ip_id(const struct rohc_decomp_ctxt *const context,
+                                      const struct rohc_rfc5225_ip_extr_bits *const bits,
+                                      const size_t ip_hdr_pos,
+                                      struct rohc_rfc5225_ip_decoded *const decoded)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+
+static rohc_status_t d_rfc5225_ip_build_hdrs(const struct rohc_decomp *const decomp,
+                                             const struct rohc_decomp_ctxt *const context,
+                                             const rohc_packet_t packet_type,
+                                             const struct rohc_decomp_crc *const extr_crc,
+                                             const struct rohc_rfc5225_ip_decoded *const decoded,
+                                             const size_t payload_len,
+                                             struct rohc_buf *const uncomp_hdrs,
+                                             size_t *const uncomp_hdrs_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 7, 8)));
+static bool d_rfc5225_ip_build_ip_hdr(const struct rohc_decomp_ctxt *const context,
+                                      const struct rfc5225_ip_decoded_ip *const decoded,
+                                      struct rohc_buf *const uncomp_hdrs,
+                                      size_t *const ip_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+
+static bool d_rfc5225_ip_attempt_repair(const struct rohc_decomp *const decomp,
+                                        const struct rohc_decomp_ctxt *const context,
+                                        const struct rohc_ts pkt_arrival_time,
+                                        struct rohc_decomp_crc_corr_ctxt *const crc_corr,
+                                        struct rohc_rfc5225_ip_extr_bits *const bits)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
+
+static void d_rfc5225_ip_update_ctxt(struct rohc_decomp_ctxt *const context,
+                                     const struct rohc_rfc5225_ip_decoded *const decoded,
+                                     const size_t payload_len,
+                                     bool *const do_change_mode)
+	__attribute__((nonnull(1, 2, 4)));
+
+static uint32_t d_rfc5225_ip_get_msn(const struct rohc_decomp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+static void d_rfc5225_ip_prefetch(const struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Create the ROHCv2 IP-only decompression context
+ *
+ * This function is one of the functions that must exist in one profile for the
+ * framework to work.
+ *
+ * @param context            The main decompression context
+ * @param[out] persist_ctxt  The persistent part of the decompression context
+ * @param[out] volat_ctxt    The volatile part of the decompression context
+ * @return                   true if creation succeeded, false in case of problem
+ */
+static bool d_rfc5225_ip_create(const struct rohc_decomp_ctxt *const context,
+                                struct d_rfc5225_ip_ctxt **const persist_ctxt,
+                                struct rohc_decomp_volat_ctxt *const volat_ctxt)
+{
+	struct rohc_slab *const slab = context->decompressor->ctxt_slab;
+	struct d_rfc5225_ip_ctxt *rfc5225_ctxt;
+
+	/* allocate memory for the context */
+	*persist_ctxt = rohc_slab_alloc(slab, sizeof(struct d_rfc5225_ip_ctxt));
+	if((*persist_ctxt) == NULL)
+	{
+		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
+		           "not enough memory for the ROHCv2 IP-only decompression "
+		           "context");
+		goto quit;
+	}
+	rfc5225_ctxt = *persist_ctxt;
+	memset(rfc5225_ctxt, 0, sizeof(struct d_rfc5225_ip_ctxt));
+
+	/* create the LSB decoding context for the MSN */
+	rfc5225_ctxt->msn_lsb_ctxt = rohc_lsb_new(slab, 16);
+	if(rfc5225_ctxt->msn_lsb_ctxt == NULL)
+	{
+		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
+		           "failed to create the LSB decoding context for the MSN");
+		goto destroy_context;
+	}
+
+	/* create the LSB decoding context for the innermost IP-ID offset */
+	rfc5225_ctxt->ip_id_lsb_ctxt = rohc_lsb_new(slab, 16);
+	if(rfc5225_ctxt->ip_id_lsb_ctxt == NULL)
+	{
+		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
+		           "failed to create the LSB decoding context for the innermost "
+		           "IP-ID offset");
+		goto free_lsb_msn;
+	}
+
+	/* volatile part of the decompression context */
+	volat_ctxt->crc.type = ROHC_CRC_TYPE_NONE;
+	volat_ctxt->crc.bits_nr = 0;
+	volat_ctxt->extr_bits =
+		rohc_slab_alloc(slab, sizeof(struct rohc_rfc5225_ip_extr_bits));
+	if(volat_ctxt->extr_bits == NULL)
+	{
+		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
+		                 "of one of the ROHCv2 IP-only decompression context");
+		goto free_lsb_ip_id;
+	}
+	volat_ctxt->decoded_values =
+		rohc_slab_alloc(slab, sizeof(struct rohc_rfc5225_ip_decoded));
+	if(volat_ctxt->decoded_values == NULL)
+	{
+		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
+		                 "of one of the ROHCv2 IP-only decompression context");
+		goto free_extr_bits;
+	}
+
+	return true;
+
+free_extr_bits:
+	rohc_slab_zfree(volat_ctxt->extr_bits);
+free_lsb_ip_id:
+	rohc_lsb_free(rfc5225_ctxt->ip_id_lsb_ctxt);
+free_lsb_msn:
+	rohc_lsb_free(rfc5225_ctxt->msn_lsb_ctxt);
+destroy_context:
+	rohc_slab_free(rfc5225_ctxt);
+	*persist_ctxt = NULL;
+quit:
+	return false;
+}
+
+
+/**
+ * @brief Destroy the ROHCv2 IP-only decompression context
+ *
+ * This function is one of the functions that must exist in one profile for the
+ * framework to work.
+ *
+ * @param rfc5225_ctxt  The persistent decompression context
+ * @param volat_ctxt    The volatile decompression context
+ */
+static void d_rfc5225_ip_destroy(struct d_rfc5225_ip_ctxt *const rfc5225_ctxt,
+                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
+{
+	rohc_lsb_free(rfc5225_ctxt->ip_id_lsb_ctxt);
+	rohc_lsb_free(rfc5225_ctxt->msn_lsb_ctxt);
+	rohc_slab_free(rfc5225_ctxt);
+
+	/* free the volatile part of the decompression context */
+	rohc_slab_free(volat_ctxt->decoded_values);
+	rohc_slab_free(volat_ctxt->extr_bits);
+}
+
+
+/**
+ * @brief Detect the type of ROHC packet for the ROHCv2 IP-only profile
+ *
+ * @param context        The decompression context
+ * @param rohc_packet    The ROHC packet
+ * @param rohc_length    The length of the ROHC packet
+ * @param large_cid_len  The length of the optional large CID field
+ * @return               The packet type
+ */
+static rohc_packet_t d_rfc5225_ip_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
+                                                  const uint8_t *const rohc_packet,
+                                                  const size_t rohc_length,
+                                                  const size_t large_cid_len __attribute__((unused)))
+{
+	rohc_packet_t type;
+
+	if(rohc_length < 1)
+	{
+		rohc_decomp_warn(context, "ROHC packet too small to read the packet "
+		                 "type (len = %zu)", rohc_length);
+		goto error;
+	}
+
+	rohc_decomp_debug(context, "try to determine the header from first byte "
+	                  "0x%02x", rohc_packet[0]);
+	type = rohc_decomp_pkt_type(rohc_decomp_pkt_types_rfc5225_ip, rohc_packet[0]);
+	if(context->num_recv_packets == 0 && type != ROHC_PACKET_IR)
+	{
+		/* only IR packets may initialize the context */
+		rohc_decomp_warn(context, "non IR packet received without initialized "
+		                 "context: cannot determine the packet type");
+		goto error;
+	}
+
+	return type;
+
+error:
+	return ROHC_PACKET_UNKNOWN;
+}
+
+
+/**
+ * @brief Parse the given ROHC packet for the ROHCv2 IP-only profile
+ *
+ * @param context              The decompression context
+ * @param rohc_packet          The ROHC packet to parse
+ * @param large_cid_len        The length of the optional large CID field
+ * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
+ *                             OUT: The type of the parsed ROHC packet
+ * @param[out] extr_crc        The CRC bits extracted from the ROHC header
+ * @param[out] bits            The bits extracted from the ROHC packet
+ * @param[out] rohc_hdr_len    The length of the ROHC header (in bytes)
+ * @return                     true if parsing was successful,
+ *                             false if packet was malformed
+ */
+static bool d_rfc5225_ip_parse_pkt(const struct rohc_decomp_ctxt *const context,
+                                   const struct rohc_buf rohc_packet,
+                                   const size_t large_cid_len,
+                                   rohc_packet_t *const packet_type,
+                                   struct rohc_decomp_crc *const extr_crc,
+                                   struct rohc_rfc5225_ip_extr_bits *const bits,
+                                   size_t *const rohc_hdr_len)
+{
+	bool parsing_ok;
+
+	rohc_decomp_debug(context, "rohc_length = %zu, large_cid_len = %zu",
+	                  rohc_packet.len, large_cid_len);
+
+	/* reset all extracted bits */
+	d_rfc5225_ip_reset_extr_bits(context, bits);
+
+	if((*packet_type) == ROHC_PACKET_IR)
+	{
+		parsing_ok = d_rfc5225_ip_parse_ir(context, rohc_buf_data(rohc_packet),
+		                                   rohc_packet.len, large_cid_len,
+		                                   extr_crc, bits, rohc_hdr_len);
+	}
+	else
+	{
+		parsing_ok = d_rfc5225_ip_parse_co(context, rohc_buf_data(rohc_packet),
+		                                   rohc_packet.len, large_cid_len,
+		                                   *packet_type, extr_crc, bits,
+		                                   rohc_hdr_len);
+	}
+
+	return parsing_ok;
+}
+
+
+/**
+ * @brief Parse the given IR packet for the ROHCv2 IP-only profile
+ *
+ * @param context            The decompression context
+ * @param rohc_packet        The ROHC packet to decode
+ * @param rohc_length        The length of the ROHC packet to decode
+ * @param large_cid_len      The length of the optional large CID field
+ * @param[out] extr_crc      The CRC bits extracted from the ROHC header
+ * @param[out] bits          The bits extracted from the IR packet
+ * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
+ * @return                   true if parsing was successful,
+ *                           false if packet was malformed
+ */
+static bool d_rfc5225_ip_parse_ir(const struct rohc_decomp_ctxt *const context,
+                                  const uint8_t *const rohc_packet,
+                                  const size_t rohc_length,
+                                  const size_t large_cid_len,
+                                  struct rohc_decomp_crc *const extr_crc,
+                                  struct rohc_rfc5225_ip_extr_bits *const bits,
+                                  size_t *const rohc_hdr_len)
+{
+	const uint8_t *remain_data = rohc_packet;
+	size_t remain_len = rohc_length;
+	size_t static_chain_len;
+	size_t dyn_chain_len;
+
+	/* skip the first byte, the large CID and the Profile byte */
+	if(remain_len < (1 + large_cid_len + 1))
+	{
+		rohc_decomp_warn(context, "malformed ROHC packet: too short for first "
+		                 "byte, large CID bytes, and profile byte");
+		goto error;
+	}
+	remain_data += 1 + large_cid_len + 1;
+	remain_len -= 1 + large_cid_len + 1;
+
+	/* parse CRC, the CRC-8 is checked by the framework */
+	if(remain_len < 1)
+	{
+		rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+		                 "CRC byte");
+		goto error;
+	}
+	extr_crc->type = ROHC_CRC_TYPE_NONE;
+	extr_crc->bits = remain_data[0];
+	extr_crc->bits_nr = 8;
+	remain_data++;
+	remain_len--;
+
+	/* parse static chain */
+	if(!d_rfc5225_ip_parse_static_chain(context, remain_data, remain_len,
+	                                    bits, &static_chain_len))
+	{
+		rohc_decomp_warn(context, "failed to parse the static chain");
+		goto error;
+	}
+	remain_data += static_chain_len;
+	remain_len -= static_chain_len;
+
+	/* parse dynamic chain */
+	if(!d_rfc5225_ip_parse_dyn_chain(context, remain_data, remain_len,
+	                                 bits, &dyn_chain_len))
+	{
+		rohc_decomp_warn(context, "failed to parse the dynamic chain");
+		goto error;
+	}
+	remain_data += dyn_chain_len;
+
+	*rohc_hdr_len = remain_data - rohc_packet;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Parse the given CO packet for the ROHCv2 IP-only profile
+ *
+ * The base header is read with a bit reader that skips the large CID, it is
+ * followed by the dynamic chain for the co_repair packet and by the irregular
+ * chain for the other packets.
+ *
+ * @param context            The decompression context
+ * @param rohc_packet        The ROHC packet to decode
+ * @param rohc_length        The length of the ROHC packet to decode
+ * @param large_cid_len      The length of the optional large CID field
+ * @param packet_type        The type of the ROHC packet to parse
+ * @param[out] extr_crc      The CRC bits extracted from the ROHC header
+ * @param[out] bits          The bits extracted from the CO packet
+ * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
+ * @return                   true if parsing was successful,
+ *                           false if packet was malformed
+ */
+static bool d_rfc5225_ip_parse_co(const struct rohc_decomp_ctxt *const context,
+                                  const uint8_t *const rohc_packet,
+                                  const size_t rohc_length,
+                                  const size_t large_cid_len,
+                                  const rohc_packet_t packet_type,
+                                  struct rohc_decomp_crc *const extr_crc,
+                                  struct rohc_rfc5225_ip_extr_bits *const bits,
+                                  size_t *const rohc_hdr_len)
+{
+	struct rohc_bit_reader reader;
+	bool outer_ip_flag = false;
+	const uint8_t *remain_data;
+	size_t remain_len;
+	size_t chain_len;
+	size_t co_len;
+
+	if(rohc_length < (1 + large_cid_len))
+	{
+		rohc_decomp_warn(context, "malformed ROHC packet: too short for first "
+		                 "byte and large CID bytes");
+		goto error;
+	}
+	rohc_bit_reader_init(&reader, rohc_packet, rohc_length, large_cid_len);
+
+	switch(packet_type)
+	{
+		case ROHC_PACKET_CO_REPAIR:
+			if(rohc_bit_reader_avail(&reader) < 3)
+			{
+				rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+				                 "3-byte co_repair base header");
+				goto error;
+			}
+			rohc_bit_read(&reader, 8); /* discriminator */
+			if(rohc_bit_read(&reader, 1) != 0)
+			{
+				rohc_decomp_warn(context, "malformed co_repair: reserved bit set");
+				goto error;
+			}
+			extr_crc->type = ROHC_CRC_TYPE_7;
+			extr_crc->bits = rohc_bit_read(&reader, 7);
+			extr_crc->bits_nr = 7;
+			if(rohc_bit_read(&reader, 5) != 0)
+			{
+				rohc_decomp_warn(context, "malformed co_repair: reserved bits set");
+				goto error;
+			}
+			bits->ctrl_crc_present = true;
+			bits->ctrl_crc = rohc_bit_read(&reader, 3);
+			break;
+		case ROHC_PACKET_CO_COMMON:
+			if(!d_rfc5225_ip_parse_co_common(context, &reader, extr_crc, bits,
+			                                 &outer_ip_flag))
+			{
+				goto error;
+			}
+			break;
+		case ROHC_PACKET_PT_0_CRC3:
+			rohc_bit_read(&reader, 1); /* discriminator */
+			bits->msn.bits = rohc_bit_read(&reader, 4);
+			bits->msn.bits_nr = 4;
+			extr_crc->type = ROHC_CRC_TYPE_3;
+			extr_crc->bits = rohc_bit_read(&reader, 3);
+			extr_crc->bits_nr = 3;
+			break;
+		case ROHC_PACKET_NORTP_PT_0_CRC7:
+			if(rohc_bit_reader_avail(&reader) < 2)
+			{
+				rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+				                 "2-byte pt_0_crc7 base header");
+				goto error;
+			}
+			rohc_bit_read(&reader, 3); /* discriminator */
+			bits->msn.bits = rohc_bit_read(&reader, 6);
+			bits->msn.bits_nr = 6;
+			extr_crc->type = ROHC_CRC_TYPE_7;
+			extr_crc->bits = rohc_bit_read(&reader, 7);
+			extr_crc->bits_nr = 7;
+			break;
+		case ROHC_PACKET_NORTP_PT_1_SEQ_ID:
+			if(rohc_bit_reader_avail(&reader) < 2)
+			{
+				rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+				                 "2-byte pt_1_seq_id base header");
+				goto error;
+			}
+			rohc_bit_read(&reader, 3); /* discriminator */
+			extr_crc->type = ROHC_CRC_TYPE_3;
+			extr_crc->bits = rohc_bit_read(&reader, 3);
+			extr_crc->bits_nr = 3;
+			bits->msn.bits = rohc_bit_read(&reader, 6);
+			bits->msn.bits_nr = 6;
+			bits->ip_id_offset.bits = rohc_bit_read(&reader, 4);
+			bits->ip_id_offset.bits_nr = 4;
+			bits->ip_id_offset.p = RFC5225_IP_ID_LSB_P(4);
+			break;
+		case ROHC_PACKET_NORTP_PT_2_SEQ_ID:
+			if(rohc_bit_reader_avail(&reader) < 3)
+			{
+				rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+				                 "3-byte pt_2_seq_id base header");
+				goto error;
+			}
+			rohc_bit_read(&reader, 3); /* discriminator */
+			bits->ip_id_offset.bits = rohc_bit_read(&reader, 6);
+			bits->ip_id_offset.bits_nr = 6;
+			bits->ip_id_offset.p = RFC5225_IP_ID_LSB_P(6);
+			extr_crc->type = ROHC_CRC_TYPE_7;
+			extr_crc->bits = rohc_bit_read(&reader, 7);
+			extr_crc->bits_nr = 7;
+			bits->msn.bits = rohc_bit_read(&reader, 8);
+			bits->msn.bits_nr = 8;
+			break;
+		default:
+			rohc_decomp_warn(context, "unsupported packet type %d", packet_type);
+			goto error;
+	}
+
+	/* the sequential IP-ID may be transmitted only if the innermost IP-ID
+	 * behavior is sequential */
+	if(bits->ip_id_offset.bits_nr > 0)
+	{
+		const struct rfc5225_ip_extr_ip_bits *const innermost_bits =
+			&(bits->ip[bits->ip_nr - 1]);
+		if(innermost_bits->version != IPV4 ||
+		   innermost_bits->ip_id_behavior > IP_ID_BEHAVIOR_SEQ_SWAP)
+		{
+			rohc_decomp_warn(context, "malformed ROHC packet: IP-ID offset bits "
+			                 "transmitted for a non-sequential IP-ID");
+			goto error;
+		}
+	}
+
+	co_len = rohc_bit_reader_offset(&reader);
+	remain_data = rohc_packet + large_cid_len + co_len;
+	remain_len = rohc_length - large_cid_len - co_len;
+
+	/* the dynamic chain follows the co_repair base header, the irregular chain
+	 * follows the other base headers */
+	if(packet_type == ROHC_PACKET_CO_REPAIR)
+	{
+		if(!d_rfc5225_ip_parse_dyn_chain(context, remain_data, remain_len,
+		                                 bits, &chain_len))
+		{
+			rohc_decomp_warn(context, "failed to parse the dynamic chain");
+			goto error;
+		}
+	}
+	else if(!d_rfc5225_ip_parse_irreg_chain(context, remain_data, remain_len,
+	                                        outer_ip_flag, bits, &chain_len))
+	{
+		rohc_decomp_warn(context, "failed to parse the irregular chain");
+		goto error;
+	}
+
+	*rohc_hdr_len = large_cid_len + co_len + chain_len;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Parse the co_common base header
+ *
+ * See c_rfc5225_ip_code_co_common() for the format.
+ *
+ * @param context             The decompression context
+ * @param reader              The bit reader on the ROHC packet
+ * @param[out] extr_crc       The CRC bits extracted from the ROHC header
+ * @param[out] bits           The bits extracted from the co_common packet
+ * @param[out] outer_ip_flag  Whether the irregular chain contains the outer
+ *                            TOS/TC and TTL/HL
+ * @return                    true if parsing was successful,
+ *                            false if packet was malformed
+ */
+static bool d_rfc5225_ip_parse_co_common(const struct rohc_decomp_ctxt *const context,
+                                         struct rohc_bit_reader *const reader,
+                                         struct rohc_decomp_crc *const extr_crc,
+                                         struct rohc_rfc5225_ip_extr_bits *const bits,
+                                         bool *const outer_ip_flag)
+{
+	struct rfc5225_ip_extr_ip_bits *const innermost_bits =
+		&(bits->ip[bits->ip_nr - 1]);
+	size_t avail = rohc_bit_reader_avail(reader);
+	uint8_t ip_id_ind;
+	uint8_t flags_ind;
+	uint8_t ttl_hopl_ind;
+	uint8_t tos_tc_ind;
+
+	if(avail < 3)
+	{
+		rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+		                 "3-byte fixed part of the co_common base header");
+		goto error;
+	}
+	rohc_bit_read(reader, 8); /* discriminator */
+	ip_id_ind = rohc_bit_read(reader, 1);
+	extr_crc->type = ROHC_CRC_TYPE_7;
+	extr_crc->bits = rohc_bit_read(reader, 7);
+	extr_crc->bits_nr = 7;
+	flags_ind = rohc_bit_read(reader, 1);
+	ttl_hopl_ind = rohc_bit_read(reader, 1);
+	tos_tc_ind = rohc_bit_read(reader, 1);
+	bits->reorder_ratio = rohc_bit_read(reader, 2);
+	bits->ctrl_crc_present = true;
+	bits->ctrl_crc = rohc_bit_read(reader, 3);
+	avail -= 3;
+
+	if(avail < (flags_ind + tos_tc_ind + ttl_hopl_ind + 1U))
+	{
+		rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+		                 "variable part of the co_common base header");
+		goto error;
+	}
+	avail -= flags_ind + tos_tc_ind + ttl_hopl_ind + 1U;
+
+	if(flags_ind)
+	{
+		*outer_ip_flag = !!(rohc_bit_read(reader, 1) != 0);
+		innermost_bits->df = rohc_bit_read(reader, 1);
+		innermost_bits->ip_id_behavior = rohc_bit_read(reader, 2);
+		if(rohc_bit_read(reader, 4) != 0)
+		{
+			rohc_decomp_warn(context, "malformed co_common: reserved bits set");
+			goto error;
+		}
+		if(innermost_bits->version == IPV4)
+		{
+			innermost_bits->df_present = true;
+			innermost_bits->ip_id_behavior_present = true;
+		}
+	}
+	if(tos_tc_ind)
+	{
+		innermost_bits->tos_tc = rohc_bit_read(reader, 8);
+		innermost_bits->tos_tc_present = true;
+	}
+	if(ttl_hopl_ind)
+	{
+		innermost_bits->ttl_hopl = rohc_bit_read(reader, 8);
+		innermost_bits->ttl_hopl_present = true;
+	}
+	bits->msn.bits = rohc_bit_read(reader, 8);
+	bits->msn.bits_nr = 8;
+
+	/* the IP-ID is transmitted only if sequential */
+	if(innermost_bits->version == IPV4 &&
+	   innermost_bits->ip_id_behavior <= IP_ID_BEHAVIOR_SEQ_SWAP)
+	{
+		if(ip_id_ind == 0)
+		{
+			if(avail < 1)
+			{
+				rohc_decomp_warn(context, "malformed ROHC packet: too short for "
+				                 "the 1-byte IP-ID offset");
+				goto error;
+			}
+			bits->ip_id_offset.bits = rohc_bit_read(reader, 8);
+			bits->ip_id_offset.bits_nr = 8;
+			bits->ip_id_offset.p = RFC5225_IP_ID_LSB_P(8);
+		}
+		else
+		{
+			if(avail < 2)
+			{
+				rohc_decomp_warn(context, "malformed ROHC packet: too short for "
+				                 "the 2-byte IP-ID");
+				goto error;
+			}
+			innermost_bits->ip_id = rohc_bit_read(reader, 16);
+			innermost_bits->ip_id_present = true;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Parse the static chain of the IR packet
+ *
+ * See c_rfc5225_ip_code_static_chain() for the format.
+ *
+ * @param context          The decompression context
+ * @param rohc_packet      The remaining part of the ROHC packet
+ * @param rohc_length      The remaining length (in bytes) of the ROHC packet
+ * @param[out] bits        The bits extracted from the static chain
+ * @param[out] parsed_len  The length (in bytes) of the static chain in case of
+ *                         success
+ * @return                 true in the static chain was successfully parsed,
+ *                         false if the ROHC packet was malformed
+ */
+static bool d_rfc5225_ip_parse_static_chain(const struct rohc_decomp_ctxt *const context,
+                                            const uint8_t *const rohc_packet,
+                                            const size_t rohc_length,
+                                            struct rohc_rfc5225_ip_extr_bits *const bits,
+                                            size_t *const parsed_len)
+{
+	const uint8_t *remain_data = rohc_packet;
+	size_t remain_len = rohc_length;
+	bool is_innermost = false;
+
+	bits->ip_nr = 0;
+	while(!is_innermost)
+	{
+		struct rfc5225_ip_extr_ip_bits *ip_bits;
+
+		if(bits->ip_nr >= ROHC_RFC5225_MAX_IP_HDRS)
+		{
+			rohc_decomp_warn(context, "too many IP headers to decompress");
+			goto error;
+		}
+		ip_bits = &(bits->ip[bits->ip_nr]);
+		if(remain_len < 1)
+		{
+			rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+			                 "first byte of the IP static part");
+			goto error;
+		}
+		is_innermost = !!((remain_data[0] & 0x40) != 0);
+
+		if((remain_data[0] & 0x80) == 0)
+		{
+			const size_t ipv4_static_len = 1 + 1 + 4 + 4;
+
+			if(remain_len < ipv4_static_len)
+			{
+				rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+				                 "%zu-byte IPv4 static part", ipv4_static_len);
+				goto error;
+			}
+			if((remain_data[0] & 0x3f) != 0)
+			{
+				rohc_decomp_warn(context, "malformed IPv4 static part: reserved bits "
+				                 "set");
+				goto error;
+			}
+			ip_bits->version = IPV4;
+			ip_bits->next_proto = remain_data[1];
+			memcpy(ip_bits->saddr, remain_data + 2, 4);
+			memcpy(ip_bits->daddr, remain_data + 6, 4);
+			remain_data += ipv4_static_len;
+			remain_len -= ipv4_static_len;
+		}
+		else
+		{
+			const bool fl_present = !!((remain_data[0] & 0x10) != 0);
+			const size_t ipv6_static_len =
+				1 + (fl_present ? 2 : 0) + 1 + 2 * sizeof(struct ipv6_addr);
+
+			if(remain_len < ipv6_static_len)
+			{
+				rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+				                 "%zu-byte IPv6 static part", ipv6_static_len);
+				goto error;
+			}
+			if((remain_data[0] & 0x20) != 0 ||
+			   (!fl_present && (remain_data[0] & 0x0f) != 0))
+			{
+				rohc_decomp_warn(context, "malformed IPv6 static part: reserved bits "
+				                 "set");
+				goto error;
+			}
+			ip_bits->version = IPV6;
+			if(fl_present)
+			{
+				ip_bits->flow_label = ((remain_data[0] & 0x0f) << 16) |
+				                      (remain_data[1] << 8) | remain_data[2];
+				remain_data += 3;
+			}
+			else
+			{
+				ip_bits->flow_label = 0;
+				remain_data++;
+			}
+			ip_bits->next_proto = remain_data[0];
+			memcpy(ip_bits->saddr, remain_data + 1, sizeof(struct ipv6_addr));
+			memcpy(ip_bits->daddr, remain_data + 1 + sizeof(struct ipv6_addr),
+			       sizeof(struct ipv6_addr));
+			remain_data += 1 + 2 * sizeof(struct ipv6_addr);
+			remain_len -= ipv6_static_len;
+		}
+		rohc_decomp_debug(context, "IPv%u static part: %sinnermost, protocol %u",
+		                  ip_bits->version, is_innermost ? "" : "not ",
+		                  ip_bits->next_proto);
+		bits->ip_nr++;
+	}
+
+	*parsed_len = rohc_length - remain_len;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Parse the dynamic chain of the IR and co_repair packets
+ *
+ * See c_rfc5225_ip_code_dyn_chain() for the format.
+ *
+ * @param context          The decompression context
+ * @param rohc_packet      The remaining part of the ROHC packet
+ * @param rohc_length      The remaining length (in bytes) of the ROHC packet
+ * @param[out] bits        The bits extracted from the dynamic chain
+ * @param[out] parsed_len  The length (in bytes) of the dynamic chain in case of
+ *                         success
+ * @return                 true in the dynamic chain was successfully parsed,
+ *                         false if the ROHC packet was malformed
+ */
+static bool d_rfc5225_ip_parse_dyn_chain(const struct rohc_decomp_ctxt *const context,
+                                         const uint8_t *const rohc_packet,
+                                         const size_t rohc_length,
+                                         struct rohc_rfc5225_ip_extr_bits *const bits,
+                                         size_t *const parsed_len)
+{
+	const uint8_t *remain_data = rohc_packet;
+	size_t remain_len = rohc_length;
+	size_t ip_hdr_pos;
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < bits->ip_nr; ip_hdr_pos++)
+	{
+		struct rfc5225_ip_extr_ip_bits *const ip_bits = &(bits->ip[ip_hdr_pos]);
+		const bool is_innermost = !!(ip_hdr_pos + 1 == bits->ip_nr);
+		const size_t msn_len = (is_innermost ? 2 : 0);
+
+		if(ip_bits->version == IPV4)
+		{
+			size_t ipv4_dyn_len = 3 + msn_len;
+
+			if(remain_len < ipv4_dyn_len)
+			{
+				rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+				                 "IPv4 dynamic part");
+				goto error;
+			}
+			if((remain_data[0] & (is_innermost ? 0xe0 : 0xf8)) != 0)
+			{
+				rohc_decomp_warn(context, "malformed IPv4 dynamic part: reserved "
+				                 "bits set");
+				goto error;
+			}
+			if(is_innermost)
+			{
+				bits->reorder_ratio = (remain_data[0] >> 3) & 0x03;
+			}
+			ip_bits->df = (remain_data[0] >> 2) & 0x01;
+			ip_bits->df_present = true;
+			ip_bits->ip_id_behavior = remain_data[0] & 0x03;
+			ip_bits->ip_id_behavior_present = true;
+			if(!is_innermost && ip_bits->ip_id_behavior != IP_ID_BEHAVIOR_ZERO &&
+			   ip_bits->ip_id_behavior != IP_ID_BEHAVIOR_RAND)
+			{
+				rohc_decomp_warn(context, "malformed IPv4 dynamic part: outer IP-ID "
+				                 "behavior %s not supported",
+				                 tcp_ip_id_behavior_get_descr(ip_bits->ip_id_behavior));
+				goto error;
+			}
+			ip_bits->tos_tc = remain_data[1];
+			ip_bits->tos_tc_present = true;
+			ip_bits->ttl_hopl = remain_data[2];
+			ip_bits->ttl_hopl_present = true;
+			remain_data += 3;
+			if(ip_bits->ip_id_behavior != IP_ID_BEHAVIOR_ZERO)
+			{
+				ipv4_dyn_len += 2;
+				if(remain_len < ipv4_dyn_len)
+				{
+					rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+					                 "IP-ID of the IPv4 dynamic part");
+					goto error;
+				}
+				ip_bits->ip_id = (remain_data[0] << 8) | remain_data[1];
+				ip_bits->ip_id_present = true;
+				remain_data += 2;
+			}
+			remain_len -= ipv4_dyn_len - msn_len;
+		}
+		else
+		{
+			const size_t ipv6_dyn_len = 2 + (is_innermost ? 1 : 0) + msn_len;
+
+			if(remain_len < ipv6_dyn_len)
+			{
+				rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+				                 "IPv6 dynamic part");
+				goto error;
+			}
+			ip_bits->tos_tc = remain_data[0];
+			ip_bits->tos_tc_present = true;
+			ip_bits->ttl_hopl = remain_data[1];
+			ip_bits->ttl_hopl_present = true;
+			remain_data += 2;
+			if(is_innermost)
+			{
+				if((remain_data[0] & 0xfc) != 0)
+				{
+					rohc_decomp_warn(context, "malformed IPv6 dynamic part: reserved "
+					                 "bits set");
+					goto error;
+				}
+				bits->reorder_ratio = remain_data[0] & 0x03;
+				remain_data++;
+			}
+			remain_len -= ipv6_dyn_len - msn_len;
+		}
+
+		if(is_innermost)
+		{
+			bits->msn.bits = (remain_data[0] << 8) | remain_data[1];
+			bits->msn.bits_nr = 16;
+			remain_data += 2;
+			remain_len -= 2;
+		}
+	}
+
+	*parsed_len = rohc_length - remain_len;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Parse the irregular chain of the co_common and pt_* packets
+ *
+ * See c_rfc5225_ip_code_irreg_chain() for the format.
+ *
+ * @param context          The decompression context
+ * @param rohc_packet      The remaining part of the ROHC packet
+ * @param rohc_length      The remaining length (in bytes) of the ROHC packet
+ * @param outer_ip_flag    Whether the outer TOS/TC and TTL/HL are present
+ * @param[out] bits        The bits extracted from the irregular chain
+ * @param[out] parsed_len  The length (in bytes) of the irregular chain in case
+ *                         of success
+ * @return                 true in the irregular chain was successfully parsed,
+ *                         false if the ROHC packet was malformed
+ */
+static bool d_rfc5225_ip_parse_irreg_chain(const struct rohc_decomp_ctxt *const context,
+                                           const uint8_t *const rohc_packet,
+                                           const size_t rohc_length,
+                                           const bool outer_ip_flag,
+                                           struct rohc_rfc5225_ip_extr_bits *const bits,
+                                           size_t *const parsed_len)
+{
+	const uint8_t *remain_data = rohc_packet;
+	size_t remain_len = rohc_length;
+	size_t ip_hdr_pos;
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < bits->ip_nr; ip_hdr_pos++)
+	{
+		struct rfc5225_ip_extr_ip_bits *const ip_bits = &(bits->ip[ip_hdr_pos]);
+		const bool is_innermost = !!(ip_hdr_pos + 1 == bits->ip_nr);
+
+		if(ip_bits->version == IPV4 &&
+		   ip_bits->ip_id_behavior == IP_ID_BEHAVIOR_RAND)
+		{
+			if(remain_len < 2)
+			{
+				rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+				                 "random IP-ID of the irregular chain");
+				goto error;
+			}
+			ip_bits->ip_id = (remain_data[0] << 8) | remain_data[1];
+			ip_bits->ip_id_present = true;
+			remain_data += 2;
+			remain_len -= 2;
+		}
+		if(!is_innermost && outer_ip_flag)
+		{
+			if(remain_len < 2)
+			{
+				rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+				                 "outer TOS/TC and TTL/HL of the irregular chain");
+				goto error;
+			}
+			ip_bits->tos_tc = remain_data[0];
+			ip_bits->tos_tc_present = true;
+			ip_bits->ttl_hopl = remain_data[1];
+			ip_bits->ttl_hopl_present = true;
+			remain_data += 2;
+			remain_len -= 2;
+		}
+	}
+
+	*parsed_len = rohc_length - remain_len;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Reset the extracted bits for next parsing
+ *
+ * The IP versions, the static fields and the IP-ID behaviors are taken from
+ * the context, the IR packets overwrite them.
+ *
+ * @param context    The decompression context
+ * @param[out] bits  The extracted bits to reset
+ */
+static void d_rfc5225_ip_reset_extr_bits(const struct rohc_decomp_ctxt *const context,
+                                         struct rohc_rfc5225_ip_extr_bits *const bits)
+{
+	const struct d_rfc5225_ip_ctxt *const rfc5225_ctxt = context->persist_ctxt;
+	size_t ip_hdr_pos;
+
+	memset(bits, 0, sizeof(struct rohc_rfc5225_ip_extr_bits));
+	bits->ip_nr = rfc5225_ctxt->ip_hdrs_nr;
+	for(ip_hdr_pos = 0; ip_hdr_pos < rfc5225_ctxt->ip_hdrs_nr; ip_hdr_pos++)
+	{
+		const struct d_rfc5225_ip_hdr_ctxt *const ip_ctxt =
+			&(rfc5225_ctxt->ip_hdrs[ip_hdr_pos]);
+		struct rfc5225_ip_extr_ip_bits *const ip_bits = &(bits->ip[ip_hdr_pos]);
+
+		ip_bits->version = ip_ctxt->version;
+		ip_bits->next_proto = ip_ctxt->next_proto;
+		ip_bits->flow_label = ip_ctxt->flow_label;
+		memcpy(ip_bits->saddr, ip_ctxt->saddr, 16);
+		memcpy(ip_bits->daddr, ip_ctxt->daddr, 16);
+		ip_bits->ip_id_behavior = ip_ctxt->ip_id_behavior;
+	}
+	bits->msn.p = ROHC_LSB_SHIFT_ROHCV2_MSN;
+	bits->reorder_ratio = ROHC_RFC5225_REORDERING_NONE;
+}
+
+
+/**
+ * @brief Decode values from extracted bits
+ *
+ * This function is one of the functions that must exist in one profile for the
+ * framework to work.
+ *
+ * @param context       The decompression context
+ * @param bits          The bits extracted from the ROHC packet
+ * @param payload_len   The length of the packet payload (in bytes)
+ * @param[out] decoded  The corresponding decoded values
+ * @return              true if decoding is successful, false otherwise
+ */
+static bool d_rfc5225_ip_decode_bits(const struct rohc_decomp_ctxt *const context,
+                                     const struct rohc_rfc5225_ip_extr_bits *const bits,
+                                     const size_t payload_len __attribute__((unused)),
+                                     struct rohc_rfc5225_ip_decoded *const decoded)
+{
+	const struct d_rfc5225_ip_ctxt *const rfc5225_ctxt = context->persist_ctxt;
+	uint8_t ip_id_behaviors[ROHC_RFC5225_MAX_IP_HDRS];
+	size_t ip_id_behaviors_nr = 0;
+	size_t ip_hdr_pos;
+
+	if(bits->reorder_ratio != ROHC_RFC5225_REORDERING_NONE)
+	{
+		rohc_decomp_warn(context, "reorder ratio %u not supported",
+		                 bits->reorder_ratio);
+		goto error;
+	}
+
+	/* decode MSN */
+	if(bits->msn.bits_nr == 16)
+	{
+		decoded->msn = bits->msn.bits;
+	}
+	else
+	{
+		uint32_t msn_decoded32;
+
+		assert(bits->msn.bits_nr > 0); /* all packets contain some MSN bits */
+
+		if(!rohc_lsb_decode(rfc5225_ctxt->msn_lsb_ctxt, ROHC_LSB_REF_0, 0,
+		                    bits->msn.bits, bits->msn.bits_nr, bits->msn.p,
+		                    &msn_decoded32))
+		{
+			rohc_decomp_warn(context, "failed to decode %zu MSN bits 0x%x",
+			                 bits->msn.bits_nr, bits->msn.bits);
+			goto error;
+		}
+		decoded->msn = (uint16_t) (msn_decoded32 & 0xffff);
+	}
+	rohc_decomp_debug(context, "decoded MSN = 0x%04x (%zu bits 0x%x)",
+	                  decoded->msn, bits->msn.bits_nr, bits->msn.bits);
+
+	/* decode IP headers */
+	decoded->ip_nr = bits->ip_nr;
+	for(ip_hdr_pos = 0; ip_hdr_pos < bits->ip_nr; ip_hdr_pos++)
+	{
+		const struct rfc5225_ip_extr_ip_bits *const ip_bits = &(bits->ip[ip_hdr_pos]);
+		const struct d_rfc5225_ip_hdr_ctxt *const ip_ctxt =
+			&(rfc5225_ctxt->ip_hdrs[ip_hdr_pos]);
+		struct rfc5225_ip_decoded_ip *const ip_decoded = &(decoded->ip[ip_hdr_pos]);
+
+		ip_decoded->version = ip_bits->version;
+		ip_decoded->next_proto = ip_bits->next_proto;
+		ip_decoded->flow_label = ip_bits->flow_label;
+		memcpy(ip_decoded->saddr, ip_bits->saddr, 16);
+		memcpy(ip_decoded->daddr, ip_bits->daddr, 16);
+		ip_decoded->tos_tc =
+			(ip_bits->tos_tc_present ? ip_bits->tos_tc : ip_ctxt->tos_tc);
+		ip_decoded->ttl_hopl =
+			(ip_bits->ttl_hopl_present ? ip_bits->ttl_hopl : ip_ctxt->ttl_hopl);
+		ip_decoded->df = (ip_bits->df_present ? ip_bits->df : ip_ctxt->df);
+		ip_decoded->ip_id_behavior = ip_bits->ip_id_behavior;
+
+		if(ip_decoded->version == IPV4)
+		{
+			if(!d_rfc5225_ip_decode_ip_id(context, bits, ip_hdr_pos, decoded))
+			{
+				rohc_decomp_warn(context, "failed to decode the IP-ID of IPv4 "
+				                 "header #%zu", ip_hdr_pos + 1);
+				goto error;
+			}
+			ip_id_behaviors[ip_id_behaviors_nr] = ip_decoded->ip_id_behavior;
+			ip_id_behaviors_nr++;
+		}
+		else
+		{
+			ip_decoded->ip_id = 0;
+		}
+	}
+
+	/* the control CRC protects the control fields that are not covered by the
+	 * CRC on the uncompressed headers */
+	if(bits->ctrl_crc_present)
+	{
+		const uint8_t ctrl_crc =
+			compute_crc_ctrl_fields(bits->reorder_ratio, decoded->msn,
+			                        ip_id_behaviors, ip_id_behaviors_nr);
+		if(ctrl_crc != bits->ctrl_crc)
+		{
+			rohc_decomp_warn(context, "control CRC failure (computed = 0x%x, "
+			                 "packet = 0x%x)", ctrl_crc, bits->ctrl_crc);
+			goto error;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Decode the IP-ID of one IPv4 header
+ *
+ * @param context         The decompression context
+ * @param bits            The bits extracted from the ROHC packet
+ * @param ip_hdr_pos      The position of the IPv4 header
+ * @param[in,out] decoded IN:  The decoded MSN and IP-ID behavior
+ *                        OUT: The decoded IP-ID and innermost IP-ID offset
+ * @return                true if decoding is successful, false otherwise
+ */
+static bool d_rfc5225_ip_decode_ip_id(const struct rohc_decomp_ctxt *const context,
+                                      const struct rohc_rfc5225_ip_extr_bits *const bits,
+                                      const size_t ip_hdr_pos,
+                                      struct rohc_rfc5225_ip_decoded *const decoded)
+{
+	const struct d_rfc5225_ip_ctxt *const rfc5225_ctxt = context->persist_ctxt;
+	const struct rfc5225_ip_extr_ip_bits *const ip_bits = &(bits->ip[ip_hdr_pos]);
+	struct rfc5225_ip_decoded_ip *const ip_decoded = &(decoded->ip[ip_hdr_pos]);
+	const bool is_innermost = !!(ip_hdr_pos + 1 == bits->ip_nr);
+	const bool is_seq =
+		!!(ip_decoded->ip_id_behavior == IP_ID_BEHAVIOR_SEQ ||
+		   ip_decoded->ip_id_behavior == IP_ID_BEHAVIOR_SEQ_SWAP);
+
+	if(ip_bits->ip_id_present)
+	{
+		/* the full IP-ID was transmitted */
+		ip_decoded->ip_id = ip_bits->ip_id;
+		if(is_innermost && is_seq)
+		{
+			const uint16_t ip_id_hbo =
+				(ip_decoded->ip_id_behavior == IP_ID_BEHAVIOR_SEQ_SWAP ?
+				 swab16(ip_decoded->ip_id) : ip_decoded->ip_id);
+			decoded->ip_id_offset = ip_id_hbo - decoded->msn;
+		}
+	}
+	else if(is_innermost && is_seq)
+	{
+		/* the IP-ID is derived from the MSN and the IP-ID offset */
+		if(bits->ip_id_offset.bits_nr > 0)
+		{
+			uint32_t offset_decoded32;
+
+			if(!rohc_lsb_decode(rfc5225_ctxt->ip_id_lsb_ctxt, ROHC_LSB_REF_0, 0,
+			                    bits->ip_id_offset.bits, bits->ip_id_offset.bits_nr,
+			                    bits->ip_id_offset.p, &offset_decoded32))
+			{
+				rohc_decomp_warn(context, "failed to decode %zu IP-ID offset bits "
+				                 "0x%x", bits->ip_id_offset.bits_nr,
+				                 bits->ip_id_offset.bits);
+				goto error;
+			}
+			decoded->ip_id_offset = offset_decoded32 & 0xffff;
+		}
+		else
+		{
+			decoded->ip_id_offset =
+				rohc_lsb_get_ref(rfc5225_ctxt->ip_id_lsb_ctxt, ROHC_LSB_REF_0);
+		}
+		ip_decoded->ip_id = decoded->ip_id_offset + decoded->msn;
+		if(ip_decoded->ip_id_behavior == IP_ID_BEHAVIOR_SEQ_SWAP)
+		{
+			ip_decoded->ip_id = swab16(ip_decoded->ip_id);
+		}
+	}
+	else if(ip_decoded->ip_id_behavior == IP_ID_BEHAVIOR_ZERO)
+	{
+		ip_decoded->ip_id = 0;
+	}
+	else
+	{
+		rohc_decomp_warn(context, "no IP-ID transmitted for %s IP-ID",
+		                 tcp_ip_id_behavior_get_descr(ip_decoded->ip_id_behavior));
+		goto error;
+	}
+
+	/* the compressor records a null offset when the innermost IP-ID is not
+	 * sequential */
+	if(is_innermost && !is_seq)
+	{
+		decoded->ip_id_offset = 0;
+	}
+	rohc_decomp_debug(context, "decoded %s IP-ID = 0x%04x",
+	                  tcp_ip_id_behavior_get_descr(ip_decoded->ip_id_behavior),
+	                  ip_decoded->ip_id);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Build the uncompressed IP headers
+ *
+ * This function is one of the functions that must exist in one profile for the
+ * framework to work.
+ *
+ * @param decomp               The ROHC decompressor
+ * @param context              The decompression context
+ * @param packet_type          The type of ROHC packet
+ * @param extr_crc             The CRC bits extracted from the ROHC header
+ * @param decoded              The values decoded from ROHC header
+ * @param payload_len          The length of the packet payload (in bytes)
+ * @param[out] uncomp_hdrs     The uncompressed headers being built
+ * @param[out] uncomp_hdrs_len The length of the uncompressed headers written
+ *                             into the buffer
+ * @return                     Possible values:
+ *                              \li ROHC_STATUS_OK if headers are built
+ *                                  successfully,
+ *                              \li ROHC_STATUS_BAD_CRC if headers do not
+ *                                  match CRC,
+ *                              \li ROHC_STATUS_OUTPUT_TOO_SMALL if
+ *                                  \e uncomp_packet is too small
+ */
+static rohc_status_t d_rfc5225_ip_build_hdrs(const struct rohc_decomp *const decomp,
+                                             const struct rohc_decomp_ctxt *const context,
+                                             const rohc_packet_t packet_type,
+                                             const struct rohc_decomp_crc *const extr_crc,
+                                             const struct rohc_rfc5225_ip_decoded *const decoded,
+                                             const size_t payload_len,
+                                             struct rohc_buf *const uncomp_hdrs,
+                                             size_t *const uncomp_hdrs_len)
+{
+	size_t ip_hdr_pos;
+
+	rohc_decomp_debug(context, "build IP headers");
+
+	*uncomp_hdrs_len = 0;
+
+	/* build IP headers */
+	for(ip_hdr_pos = 0; ip_hdr_pos < decoded->ip_nr; ip_hdr_pos++)
+	{
+		if(!d_rfc5225_ip_build_ip_hdr(context, &(decoded->ip[ip_hdr_pos]),
+		                              uncomp_hdrs, uncomp_hdrs_len))
+		{
+			rohc_decomp_warn(context, "failed to build uncompressed IP header #%zu",
+			                 ip_hdr_pos + 1);
+			goto error_output_too_small;
+		}
+	}
+
+	/* unhide the IP headers */
+	rohc_buf_push(uncomp_hdrs, *uncomp_hdrs_len);
+
+	/* compute payload lengths and checksums for all IP headers */
+	for(ip_hdr_pos = 0; ip_hdr_pos < decoded->ip_nr; ip_hdr_pos++)
+	{
+		if(decoded->ip[ip_hdr_pos].version == IPV4)
+		{
+			struct ipv4_hdr *const ipv4 =
+				(struct ipv4_hdr *) rohc_buf_data(*uncomp_hdrs);
+			ipv4->tot_len = rohc_hton16(uncomp_hdrs->len + payload_len);
+			ipv4->check = 0;
+			ipv4->check = ip_fast_csum(rohc_buf_data(*uncomp_hdrs), ipv4->ihl);
+			rohc_buf_pull(uncomp_hdrs, sizeof(struct ipv4_hdr));
+		}
+		else
+		{
+			struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) rohc_buf_data(*uncomp_hdrs);
+			rohc_buf_pull(uncomp_hdrs, sizeof(struct ipv6_hdr));
+			ipv6->plen = rohc_hton16(uncomp_hdrs->len + payload_len);
+		}
+	}
+	rohc_buf_push(uncomp_hdrs, *uncomp_hdrs_len);
+
+	/* check the CRC-3 or CRC-7 on the uncompressed headers, the CRC-8 of the
+	 * IR packets was checked by the framework */
+	if(extr_crc->type != ROHC_CRC_TYPE_NONE)
+	{
+		const uint8_t crc_init =
+			(extr_crc->type == ROHC_CRC_TYPE_3 ? CRC_INIT_3 : CRC_INIT_7);
+		const uint8_t *const crc_table =
+			(extr_crc->type == ROHC_CRC_TYPE_3 ? rohc_crc_table_3 : rohc_crc_table_7);
+		const uint8_t crc_computed =
+			crc_calculate(extr_crc->type, rohc_buf_data(*uncomp_hdrs),
+			              uncomp_hdrs->len, crc_init, crc_table);
+
+		rohc_decomp_debug(context, "CRC-%d on uncompressed header = 0x%x",
+		                  extr_crc->type, crc_computed);
+		if(crc_computed != extr_crc->bits)
+		{
+			rohc_decomp_warn(context, "CRC failure (computed = 0x%02x, packet = "
+			                 "0x%02x) for packet of type %s in state %s and mode %s",
+			                 crc_computed, extr_crc->bits,
+			                 rohc_get_packet_descr(packet_type),
+			                 rohc_decomp_get_state_descr(context->state),
+			                 rohc_get_mode_descr(context->mode));
+			goto error_crc;
+		}
+	}
+
+	if((d_features(decomp) & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+	{
+		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
+		                 "IP headers", *uncomp_hdrs);
+	}
+
+	return ROHC_STATUS_OK;
+
+error_crc:
+	return ROHC_STATUS_BAD_CRC;
+error_output_too_small:
+	return ROHC_STATUS_OUTPUT_TOO_SMALL;
+}
+
+
+/**
+ * @brief Build one uncompressed IP header
+ *
+ * The lengths and checksum are computed once all headers are built.
+ *
+ * @param context             The decompression context
+ * @param decoded             The values decoded for the IP header
+ * @param[out] uncomp_hdrs    The uncompressed headers being built
+ * @param[in,out] ip_hdr_len  The length of the IP headers built so far
+ * @return                    true if the IP header was successfully built,
+ *                            false if the output \e uncomp_hdrs was not
+ *                            large enough
+ */
+static bool d_rfc5225_ip_build_ip_hdr(const struct rohc_decomp_ctxt *const context,
+                                      const struct rfc5225_ip_decoded_ip *const decoded,
+                                      struct rohc_buf *const uncomp_hdrs,
+                                      size_t *const ip_hdr_len)
+{
+	size_t hdr_len;
+
+	if(decoded->version == IPV4)
+	{
+		struct ipv4_hdr *const ipv4 = (struct ipv4_hdr *) rohc_buf_data(*uncomp_hdrs);
+
+		hdr_len = sizeof(struct ipv4_hdr);
+		if(rohc_buf_avail_len(*uncomp_hdrs) < hdr_len)
+		{
+			rohc_decomp_warn(context, "output buffer too small for the %zu-byte "
+			                 "IPv4 header", hdr_len);
+			goto error;
+		}
+		ipv4->version = IPV4;
+		ipv4->ihl = hdr_len / sizeof(uint32_t);
+		ipv4->tos = decoded->tos_tc;
+		ipv4->id = rohc_hton16(decoded->ip_id);
+		ipv4->frag_off = 0;
+		ipv4->df = decoded->df;
+		ipv4->ttl = decoded->ttl_hopl;
+		ipv4->protocol = decoded->next_proto;
+		memcpy(&ipv4->saddr, decoded->saddr, 4);
+		memcpy(&ipv4->daddr, decoded->daddr, 4);
+	}
+	else
+	{
+		struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) rohc_buf_data(*uncomp_hdrs);
+
+		hdr_len = sizeof(struct ipv6_hdr);
+		if(rohc_buf_avail_len(*uncomp_hdrs) < hdr_len)
+		{
+			rohc_decomp_warn(context, "output buffer too small for the %zu-byte "
+			                 "IPv6 header", hdr_len);
+			goto error;
+		}
+		ipv6->version = IPV6;
+		ipv6_set_tc(ipv6, decoded->tos_tc);
+		ipv6_set_flow_label(ipv6, decoded->flow_label);
+		ipv6->nh = decoded->next_proto;
+		ipv6->hl = decoded->ttl_hopl;
+		memcpy(&ipv6->saddr, decoded->saddr, sizeof(struct ipv6_addr));
+		memcpy(&ipv6->daddr, decoded->daddr, sizeof(struct ipv6_addr));
+	}
+	rohc_decomp_debug(context, "  build %zu-byte IPv%u header", hdr_len,
+	                  decoded->version);
+
+	/* skip the IP header */
+	uncomp_hdrs->len += hdr_len;
+	rohc_buf_pull(uncomp_hdrs, hdr_len);
+	*ip_hdr_len += hdr_len;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Attempt a packet/context repair upon CRC failure
+ *
+ * The profile never attempts a repair, see the file description.
+ *
+ * @param decomp            The ROHC decompressor
+ * @param context           The decompression context
+ * @param pkt_arrival_time  The arrival time of the ROHC packet that caused the CRC
+ *                          failure
+ * @param[in,out] crc_corr  The context for corrections upon CRC failures
+ * @param[in,out] bits      The bits extracted from the ROHC header
+ * @return                  true if repair is possible, false if not
+ */
+static bool d_rfc5225_ip_attempt_repair(const struct rohc_decomp *const decomp __attribute__((unused)),
+                                        const struct rohc_decomp_ctxt *const context __attribute__((unused)),
+                                        const struct rohc_ts pkt_arrival_time __attribute__((unused)),
+                                        struct rohc_decomp_crc_corr_ctxt *const crc_corr __attribute__((unused)),
+                                        struct rohc_rfc5225_ip_extr_bits *const bits __attribute__((unused)))
+{
+	rohc_decomp_debug(context, "will not attempt packet/context repair");
+	return false;
+}
+
+
+/**
+ * @brief Update the decompression context with the infos of current packet
+ *
+ * @param context              The decompression context
+ * @param decoded              The decoded values to update in the context
+ * @param payload_len          The length of the packet payload (in bytes)
+ * @param[out] do_change_mode  Whether the profile context wants to change
+ *                             its operational mode or not
+ */
+static void d_rfc5225_ip_update_ctxt(struct rohc_decomp_ctxt *const context,
+                                     const struct rohc_rfc5225_ip_decoded *const decoded,
+                                     const size_t payload_len __attribute__((unused)),
+                                     bool *const do_change_mode)
+{
+	struct d_rfc5225_ip_ctxt *const rfc5225_ctxt = context->persist_ctxt;
+	size_t ip_hdr_pos;
+
+	/* mode did not change */
+	*do_change_mode = false;
+
+	/* MSN and innermost IP-ID offset */
+	rohc_lsb_set_ref(rfc5225_ctxt->msn_lsb_ctxt, decoded->msn, false);
+	rohc_lsb_set_ref(rfc5225_ctxt->ip_id_lsb_ctxt, decoded->ip_id_offset, false);
+	rohc_decomp_debug(context, "MSN 0x%04x and IP-ID offset 0x%04x are the new "
+	                  "references", decoded->msn, decoded->ip_id_offset);
+
+	/* IP headers */
+	rfc5225_ctxt->ip_hdrs_nr = decoded->ip_nr;
+	for(ip_hdr_pos = 0; ip_hdr_pos < decoded->ip_nr; ip_hdr_pos++)
+	{
+		const struct rfc5225_ip_decoded_ip *const ip_decoded =
+			&(decoded->ip[ip_hdr_pos]);
+		struct d_rfc5225_ip_hdr_ctxt *const ip_ctxt =
+			&(rfc5225_ctxt->ip_hdrs[ip_hdr_pos]);
+
+		ip_ctxt->version = ip_decoded->version;
+		ip_ctxt->next_proto = ip_decoded->next_proto;
+		ip_ctxt->tos_tc = ip_decoded->tos_tc;
+		ip_ctxt->ttl_hopl = ip_decoded->ttl_hopl;
+		ip_ctxt->df = ip_decoded->df;
+		ip_ctxt->ip_id_behavior = ip_decoded->ip_id_behavior;
+		ip_ctxt->flow_label = ip_decoded->flow_label;
+		memcpy(ip_ctxt->saddr, ip_decoded->saddr, 16);
+		memcpy(ip_ctxt->daddr, ip_decoded->daddr, 16);
+	}
+}
+
+
+/**
+ * @brief Get the reference MSN value of the context
+ *
+ * This function is one of the functions that must exist in one profile for the
+ * framework to work.
+ *
+ * @param context The decompression context
+ * @return        The reference MSN value
+ */
+static uint32_t d_rfc5225_ip_get_msn(const struct rohc_decomp_ctxt *const context)
+{
+	const struct d_rfc5225_ip_ctxt *const rfc5225_ctxt = context->persist_ctxt;
+	return rohc_lsb_get_ref(rfc5225_ctxt->msn_lsb_ctxt, ROHC_LSB_REF_0);
+}
+
+
+/**
+ * @brief Prefetch the LSB decoding contexts used by every packet
+ *
+ * Called by the decompressor when it decompresses a burst of packets, before
+ * the next packet is decompressed in the context.
+ *
+ * @param context  The decompression context
+ */
+static void d_rfc5225_ip_prefetch(const struct rohc_decomp_ctxt *const context)
+{
+	const struct d_rfc5225_ip_ctxt *const rfc5225_ctxt = context->persist_ctxt;
+
+	__builtin_prefetch(rfc5225_ctxt->msn_lsb_ctxt);
+	__builtin_prefetch(rfc5225_ctxt->ip_id_lsb_ctxt);
+}
+
+
+/**
+ * @brief Get the maximum length one ROHCv2 IP-only context takes in a memory block
+ *
+ * @return  The maximum number of bytes of the memory block the
+ *          profile-specific part of the context takes
+ */
+static size_t d_rfc5225_ip_mem_max(void)
+{
+	return (rohc_slab_block_mem_max(sizeof(struct d_rfc5225_ip_ctxt)) +
+	        2 * rohc_lsb_mem_max() +
+	        rohc_slab_block_mem_max(sizeof(struct rohc_rfc5225_ip_extr_bits)) +
+	        rohc_slab_block_mem_max(sizeof(struct rohc_rfc5225_ip_decoded)));
+}
+
+
+/**
+ * @brief Define the decompression part of the ROHCv2 IP-only profile as
+ *        described in the RFC 5225
+ */
+const struct rohc_decomp_profile d_rfc5225_ip_profile =
+{
+	.id              = ROHCv2_PROFILE_IP, /* profile ID (see RFC 5225) */
+	.msn_max_bits    = 16,
+	.new_context     = (rohc_decomp_new_context_t) d_rfc5225_ip_create,
+	.free_context    = (rohc_decomp_free_context_t) d_rfc5225_ip_destroy,
+	.detect_pkt_type = d_rfc5225_ip_detect_pkt_type,
+	.parse_pkt       = (rohc_decomp_parse_pkt_t) d_rfc5225_ip_parse_pkt,
+	.decode_bits     = (rohc_decomp_decode_bits_t) d_rfc5225_ip_decode_bits,
+	.build_hdrs      = (rohc_decomp_build_hdrs_t) d_rfc5225_ip_build_hdrs,
+	.update_ctxt     = (rohc_decomp_update_ctxt_t) d_rfc5225_ip_update_ctxt,
+	.attempt_repair  = (rohc_decomp_attempt_repair_t) d_rfc5225_ip_attempt_repair,
+	.get_sn          = d_rfc5225_ip_get_msn,
+	.decode_fast     = NULL,
+	.prefetch        = d_rfc5225_ip_prefetch,
+	.get_mem_max     = d_rfc5225_ip_mem_max,
+};
+
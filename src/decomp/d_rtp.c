@@ -27,6 +27,7 @@
  * @author Didier Barvaux <didier@barvaux.org>
  */
 
+#include "d_rtp.h"
 #include "d_udp.h"
 #include "d_ip.h"
 #include "rohc_traces_internal.h"
@@ -74,6 +75,9 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
+static size_t d_rtp_mem_max(void)
+	__attribute__((warn_unused_result, const));
+
 static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(1, 2)));
@@ -84,16 +88,8 @@ static rohc_packet_t rtp_detect_packet_type(const struct rohc_decomp_ctxt *const
                                             const size_t large_cid_len)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 
-static rohc_packet_t rtp_choose_uo1_variant(const struct rohc_decomp_ctxt *const context,
-                                            const uint8_t *const packet,
-                                            const size_t rohc_length)
-	__attribute__((warn_unused_result, nonnull(1, 2)));
-
-static rohc_packet_t rtp_choose_uor2_variant(const struct rohc_decomp_ctxt *const context,
-                                             const uint8_t *const packet,
-                                             const size_t rohc_length,
-                                             const size_t large_cid_len)
-	__attribute__((warn_unused_result, nonnull(1, 2)));
+static const uint8_t * rtp_get_pkt_types(const struct rohc_decomp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1)));
 
 static int rtp_parse_static_rtp(const struct rohc_decomp_ctxt *const context,
                                 const uint8_t *packet,
@@ -123,25 +119,6 @@ static int rtp_parse_rtp_hdr_fields(const struct rohc_decomp_ctxt *const context
                                     struct rohc_extr_bits *const bits)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
 
-static int rtp_parse_uo_remainder(const struct rohc_decomp_ctxt *const context,
-                                  const uint8_t *packet,
-                                  unsigned int length,
-                                  struct rohc_extr_bits *const bits);
-
-static bool rtp_decode_values_from_bits(const struct rohc_decomp_ctxt *context,
-                                        const struct rohc_extr_bits *const bits,
-                                        struct rohc_decoded_values *const decoded)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
-
-static int rtp_build_uncomp_rtp(const struct rohc_decomp_ctxt *const context,
-                                const struct rohc_decoded_values *const decoded,
-                                uint8_t *const dest,
-                                const unsigned int payload_len);
-
-static void rtp_update_context(struct rohc_decomp_ctxt *const context,
-                               const struct rohc_decoded_values *const decoded)
-	__attribute__((nonnull(1, 2)));
-
 
 /*
  * Prototypes of private helper functions
@@ -157,6 +134,23 @@ static inline bool is_inner_ipv4_rnd_ctxt(const struct rohc_decomp_rfc3095_ctxt
  * Definitions of functions
  */
 
+/** The handlers of the RTP profile for the generic RFC3095-based code */
+static const struct rohc_decomp_rfc3095_ops d_rtp_rfc3095_ops =
+{
+	.parse_static_next_hdr   = rtp_parse_static_rtp,
+	.parse_dyn_next_hdr      = rtp_parse_dynamic_rtp,
+	.parse_ext3              = rtp_parse_ext3,
+	.parse_uo_remainder      = rtp_parse_uo_remainder,
+	.decode_values_from_bits = rtp_decode_values_from_bits,
+	.build_next_header       = rtp_build_uncomp_rtp,
+	.compute_crc_static      = rtp_compute_crc_static,
+	.compute_crc_dynamic     = rtp_compute_crc_dynamic,
+	.update_context          = rtp_update_context,
+	.decode_fast_next_hdr    = rtp_decode_fast_rtp,
+	.patch_next_hdr          = rtp_patch_uncomp_rtp,
+};
+
+
 /**
  * @brief Create the RTP decompression context.
  *
@@ -173,6 +167,7 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
+	struct rohc_slab *const slab = context->decompressor->ctxt_slab;
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 	struct d_rtp_context *rtp_context;
 	const size_t nh_len = sizeof(struct udphdr) + sizeof(struct rtphdr);
@@ -182,7 +177,8 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 	assert(context->profile != NULL);
 
 	/* create the generic context */
-	if(!rohc_decomp_rfc3095_create(context, persist_ctxt, volat_ctxt,
+	if(!rohc_decomp_rfc3095_create(context, &d_rtp_rfc3095_ops,
+	                               persist_ctxt, volat_ctxt,
 	                               context->decompressor->trace_callback,
 	                               context->decompressor->trace_callback_priv,
 	                               context->profile->id))
@@ -194,7 +190,7 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt = *persist_ctxt;
 
 	/* create the RTP-specific part of the context */
-	rtp_context = malloc(sizeof(struct d_rtp_context));
+	rtp_context = rohc_slab_alloc(slab, sizeof(struct d_rtp_context));
 	if(rtp_context == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -206,7 +202,7 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the LSB decoding context for SN */
 	rfc3095_ctxt->sn_lsb_p = ROHC_LSB_SHIFT_RTP_SN;
-	rfc3095_ctxt->sn_lsb_ctxt = rohc_lsb_new(16);
+	rfc3095_ctxt->sn_lsb_ctxt = rohc_lsb_new(slab, 16);
 	if(rfc3095_ctxt->sn_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -220,19 +216,11 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* some RTP-specific values and functions */
 	rfc3095_ctxt->next_header_len = nh_len;
-	rfc3095_ctxt->parse_static_next_hdr = rtp_parse_static_rtp;
-	rfc3095_ctxt->parse_dyn_next_hdr = rtp_parse_dynamic_rtp;
-	rfc3095_ctxt->parse_ext3 = rtp_parse_ext3;
-	rfc3095_ctxt->parse_uo_remainder = rtp_parse_uo_remainder;
-	rfc3095_ctxt->decode_values_from_bits = rtp_decode_values_from_bits;
-	rfc3095_ctxt->build_next_header = rtp_build_uncomp_rtp;
-	rfc3095_ctxt->compute_crc_static = rtp_compute_crc_static;
-	rfc3095_ctxt->compute_crc_dynamic = rtp_compute_crc_dynamic;
-	rfc3095_ctxt->update_context = rtp_update_context;
 
 	/* create the UDP-specific part of the header changes */
 	rfc3095_ctxt->outer_ip_changes->next_header_len = nh_len;
-	rfc3095_ctxt->outer_ip_changes->next_header = malloc(nh_len);
+	rfc3095_ctxt->outer_ip_changes->next_header =
+		rohc_slab_alloc(slab, nh_len);
 	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -243,7 +231,8 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 	memset(rfc3095_ctxt->outer_ip_changes->next_header, 0, nh_len);
 
 	rfc3095_ctxt->inner_ip_changes->next_header_len = nh_len;
-	rfc3095_ctxt->inner_ip_changes->next_header = malloc(nh_len);
+	rfc3095_ctxt->inner_ip_changes->next_header =
+		rohc_slab_alloc(slab, nh_len);
 	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -258,7 +247,8 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the scaled RTP Timestamp decoding context */
 	rtp_context->ts_scaled_ctxt =
-		d_create_sc(context->decompressor->trace_callback,
+		d_create_sc(slab,
+		            context->decompressor->trace_callback,
 		            context->decompressor->trace_callback_priv);
 	if(rtp_context->ts_scaled_ctxt == NULL)
 	{
@@ -270,13 +260,13 @@ static bool d_rtp_create(const struct rohc_decomp_ctxt *const context,
 	return true;
 
 free_inner_ip_changes_next_header:
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
+	rohc_slab_zfree(rfc3095_ctxt->inner_ip_changes->next_header);
 free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_slab_zfree(rfc3095_ctxt->outer_ip_changes->next_header);
 free_lsb_sn:
 	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
 free_rtp_context:
-	zfree(rtp_context);
+	rohc_slab_zfree(rfc3095_ctxt->specific);
 destroy_context:
 	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
 quit:
@@ -304,9 +294,9 @@ static void d_rtp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
 
 	/* clean UDP-specific memory */
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_slab_zfree(rfc3095_ctxt->outer_ip_changes->next_header);
 	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
+	rohc_slab_zfree(rfc3095_ctxt->inner_ip_changes->next_header);
 
 	/* destroy the LSB decoding context for SN */
 	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
@@ -339,38 +329,31 @@ static rohc_packet_t rtp_detect_packet_type(const struct rohc_decomp_ctxt *const
 		goto error;
 	}
 
-	if(rohc_decomp_packet_is_uo0(rohc_packet, rohc_length))
-	{
-		/* UO-0 packet */
-		type = ROHC_PACKET_UO_0;
-	}
-	else if(rohc_decomp_packet_is_uo1(rohc_packet, rohc_length))
-	{
-		/* choose between the UO-1-RTP, UO-1-ID, and UO-1-TS variants */
-		type = rtp_choose_uo1_variant(context, rohc_packet, rohc_length);
-	}
-	else if(rohc_decomp_packet_is_uor2(rohc_packet, rohc_length))
+	/* UO-0, UO-1*, UOR-2*, IR-DYN or IR packet (R-0, R-0-CRC, UOR-2*, IR-DYN
+	 * or IR packet in R-mode) */
+	type = rohc_decomp_pkt_type(rtp_get_pkt_types(context), rohc_packet[0]);
+	if(type == ROHC_DECOMP_PKT_MORE)
 	{
-		/* choose between the UOR-2-RTP, UOR-2-ID, and UOR-2-TS variants */
-		type = rtp_choose_uor2_variant(context, rohc_packet, rohc_length,
-		                               large_cid_len);
-	}
-	else if(rohc_decomp_packet_is_irdyn(rohc_packet, rohc_length))
-	{
-		/* IR-DYN packet */
-		type = ROHC_PACKET_IR_DYN;
-	}
-	else if(rohc_decomp_packet_is_ir(rohc_packet, rohc_length))
-	{
-		/* IR packet */
-		type = ROHC_PACKET_IR;
+		/* UOR-2-ID or UOR-2-TS packet, check the T field */
+		if(rohc_decomp_packet_is_uor2_ts(rohc_packet, rohc_length, large_cid_len))
+		{
+			rohc_decomp_debug(context, "UOR-2* packet disambiguation: T = 1, "
+			                  "so try parsing as UOR-2-TS, and fallback on "
+			                  "UOR-2-RTP later if value(RND) = 1 in packet");
+			type = ROHC_PACKET_UOR_2_TS;
+		}
+		else
+		{
+			rohc_decomp_debug(context, "UOR-2* packet disambiguation: T = 0, "
+			                  "so try parsing as UOR-2-ID, and fallback on "
+			                  "UOR-2-RTP later if value(RND) = 1 in packet");
+			type = ROHC_PACKET_UOR_2_ID;
+		}
 	}
-	else
+	else if(type == ROHC_PACKET_UNKNOWN)
 	{
-		/* unknown packet */
 		rohc_decomp_warn(context, "failed to recognize the packet type in byte "
 		                 "0x%02x", rohc_packet[0]);
-		type = ROHC_PACKET_UNKNOWN;
 	}
 
 	return type;
@@ -381,210 +364,48 @@ error:
 
 
 /**
- * @brief Choose between UO-1-RTP, UO-1-TS, and UO-1-ID variants
- *
- * This function is useful to choose which packet type to try to parse in the
- * UO-1* families.
+ * @brief Get the table of packet types that matches the RTP context
  *
- * @param context        The decompression context
- * @param packet         The ROHC packet
- * @param rohc_length    The length of the ROHC packet
- * @return               The packet type
- */
-static rohc_packet_t rtp_choose_uo1_variant(const struct rohc_decomp_ctxt *const context,
-                                            const uint8_t *const packet,
-                                            const size_t rohc_length)
-{
-	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
-	rohc_packet_t type;
-	size_t nr_ipv4_non_rnd;
-	size_t nr_ipv4;
-
-	/* compute the number of IPv4 headers, and IPv4 with context(RND) = 0 */
-	nr_ipv4 = 0;
-	nr_ipv4_non_rnd = 0;
-	if(is_outer_ipv4_ctxt(rfc3095_ctxt))
-	{
-		nr_ipv4++;
-		if(!is_outer_ipv4_rnd_ctxt(rfc3095_ctxt))
-		{
-			nr_ipv4_non_rnd++;
-		}
-	}
-	if(is_inner_ipv4_ctxt(rfc3095_ctxt))
-	{
-		nr_ipv4++;
-		if(!is_inner_ipv4_rnd_ctxt(rfc3095_ctxt))
-		{
-			nr_ipv4_non_rnd++;
-		}
-	}
-
-	/* There is no easy way to disambiguate UO-1-ID/TS and UO-1-RTP
-	 * packets. The following algorithm is based on notes you may
-	 * read in RFC 3095, section 5.7.3:
-	 *  - UO-1-RTP cannot be used if the context contains at least one
-	 *    IPv4 header with value(RND) = 0. This disambiguates it from
-	 *    UO-1-ID and UO-1-TS.
-	 *  - UO-1-ID cannot be used if there is no IPv4 header in the
-	 *    context or if value(RND) and value(RND2) are both 1.
-	 *  - UO-1-TS cannot be used if there is no IPv4 header in the
-	 *    context or if value(RND) and value(RND2) are both 1.
-	 *  - T: T = 0 indicates format UO-1-ID;
-	 *       T = 1 indicates format UO-1-TS.
-	 */
-	if(nr_ipv4 == 0)
-	{
-		/* no IPv4 header at all, so only UO-1-RTP packet can be used */
-		rohc_decomp_debug(context, "UO-1* packet disambiguation: no IPv4 "
-		                  "header at all, so parse as UO-1-RTP");
-		type = ROHC_PACKET_UO_1_RTP;
-	}
-	else if(nr_ipv4_non_rnd == 0)
-	{
-		/* there is no IPv4 header with context(RND) = 0, and UO-1* packets
-		 * have either no value(RND) or value(RND) = context(RND) if they have
-		 * one. So only UO-1-RTP packet can be used */
-		rohc_decomp_debug(context, "UO-1* packet disambiguation: no IPv4 "
-		                  "header with context(RND) = 0, so parse as "
-		                  "UO-1-RTP");
-		type = ROHC_PACKET_UO_1_RTP;
-	}
-	else
-	{
-		/* there is at least one IPv4 header with context(RND) = 0, and UO-1*
-		 * packets have either no value(RND) or value(RND) = context(RND) if
-		 * they have one. So only UO-1-TS/ID are possible */
-		rohc_decomp_debug(context, "UO-1* packet disambiguation: at least one "
-		                  "IP header is IPv4 with context(RND) = 0, so parse "
-		                  "as UO-1-ID or UO-1-TS");
-
-		/* UO-1-ID or UO-1-TS packet, check the T field */
-		if(rohc_decomp_packet_is_uo1_ts(packet, rohc_length))
-		{
-			/* UO-1-TS packet */
-			rohc_decomp_debug(context, "UO-1* packet disambiguation: T = 1, "
-			                  "so parse as UO-1-TS");
-			type = ROHC_PACKET_UO_1_TS;
-		}
-		else
-		{
-			/* UO-1-ID packet */
-			rohc_decomp_debug(context, "UO-1* packet disambiguation: T = 0, "
-			                  "so parse as UO-1-ID");
-			type = ROHC_PACKET_UO_1_ID;
-		}
-	}
-
-	return type;
-}
-
-
-/**
- * @brief Choose between UOR-2-RTP, UOR-2-TS, and UOR-2-ID variants
+ * There is no easy way to disambiguate the UO-1-ID/TS and UOR-2-ID/TS
+ * packets from the UO-1-RTP and UOR-2-RTP packets. The following algorithm
+ * is based on notes you may read in RFC 3095, sections 5.7.3 and 5.7.4:
+ *  - *-RTP packets cannot be used if the context contains at least one
+ *    IPv4 header with value(RND) = 0. This disambiguates them from the
+ *    *-ID and *-TS packets.
+ *  - *-ID and *-TS packets cannot be used if there is no IPv4 header in the
+ *    context or if value(RND) and value(RND2) are both 1.
+ *  - T: T = 0 indicates the *-ID formats, T = 1 indicates the *-TS formats.
  *
- * This function is useful to choose which packet type to try to decode (may
- * change later, causing a packet reparse) in the UOR-2* family.
+ * The UOR-2* packets may contain a RND field that updates the context, so
+ * their parsing may fallback on the other variants later.
  *
- * @param context        The decompression context
- * @param packet         The ROHC packet
- * @param rohc_length    The length of the ROHC packet
- * @param large_cid_len  The length of the optional large CID field
- * @return               The packet type
+ * @param context  The decompression context
+ * @return         The table of packet types indexed by the first byte
  */
-static rohc_packet_t rtp_choose_uor2_variant(const struct rohc_decomp_ctxt *const context,
-                                             const uint8_t *const packet,
-                                             const size_t rohc_length,
-                                             const size_t large_cid_len)
+static const uint8_t * rtp_get_pkt_types(const struct rohc_decomp_ctxt *const context)
 {
 	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
-	rohc_packet_t type;
-	size_t nr_ipv4_non_rnd;
-	size_t nr_ipv4;
-
-	/* compute the number of IPv4 headers, and IPv4 with context(RND) = 0 */
-	nr_ipv4 = 0;
-	nr_ipv4_non_rnd = 0;
-	if(is_outer_ipv4_ctxt(rfc3095_ctxt))
-	{
-		nr_ipv4++;
-		if(!is_outer_ipv4_rnd_ctxt(rfc3095_ctxt))
-		{
-			nr_ipv4_non_rnd++;
-		}
-	}
-	if(is_inner_ipv4_ctxt(rfc3095_ctxt))
-	{
-		nr_ipv4++;
-		if(!is_inner_ipv4_rnd_ctxt(rfc3095_ctxt))
-		{
-			nr_ipv4_non_rnd++;
-		}
-	}
+	const uint8_t *pkt_types;
 
-	/* There is no easy way to disambiguate UOR-2-ID/TS and UOR-2-RTP
-	 * packets. The following algorithm is based on notes you may
-	 * read in RFC 3095, section 5.7.4:
-	 *  - UOR-2-RTP cannot be used if the context contains at least one
-	 *    IPv4 header with value(RND) = 0. This disambiguates it from
-	 *    UOR-2-ID and UOR-2-TS.
-	 *  - UOR-2-ID cannot be used if there is no IPv4 header in the
-	 *    context or if value(RND) and value(RND2) are both 1.
-	 *  - UOR-2-TS cannot be used if there is no IPv4 header in the
-	 *    context or if value(RND) and value(RND2) are both 1.
-	 *  - T: T = 0 indicates format UOR-2-ID;
-	 *       T = 1 indicates format UOR-2-TS.
-	 */
-	if(nr_ipv4 == 0)
+	if((is_outer_ipv4_ctxt(rfc3095_ctxt) && !is_outer_ipv4_rnd_ctxt(rfc3095_ctxt)) ||
+	   (is_inner_ipv4_ctxt(rfc3095_ctxt) && !is_inner_ipv4_rnd_ctxt(rfc3095_ctxt)))
 	{
-		/* no IPv4 header at all, so only *-RTP packet can be used */
-		rohc_decomp_debug(context, "UOR-2* packet disambiguation: no IPv4 "
-		                  "header at all, so parse as UOR-2-RTP");
-		type = ROHC_PACKET_UOR_2_RTP;
-	}
-	else if(nr_ipv4_non_rnd == 0)
-	{
-		/* there is no IPv4 header with context(RND) = 0, but maybe there is a
-		 * IPv4 header with value(RND) = 0 (the ROHC packet may contain a RND
-		 * field and update context). So try parsing UOR-2-RTP, and fallback
-		 * on UOR-2-TS/ID if value(RND) = 0 is found. */
-		rohc_decomp_debug(context, "UOR-2* packet disambiguation: no IPv4 "
-		                  "header with context(RND) = 0, so try parsing as "
-		                  "UOR-2-RTP, and fallback on UOR-2-ID/TS later if "
-		                  "value(RND) = 0 in packet");
-		type = ROHC_PACKET_UOR_2_RTP;
+		rohc_decomp_debug(context, "UO-1*/UOR-2* packet disambiguation: at least "
+		                  "one IP header is IPv4 with context(RND) = 0, so parse "
+		                  "as *-ID or *-TS");
+		pkt_types = (context->mode == ROHC_R_MODE ?
+		             rohc_decomp_pkt_types_rtp_ipv4_r :
+		             rohc_decomp_pkt_types_rtp_ipv4);
 	}
 	else
 	{
-		/* there is at least one IPv4 header with context(RND) = 0, but maybe
-		 * there is a IPv4 header with value(RND) = 1 (the ROHC packet may
-		 * contain a RND field and update context), so try parsing UOR-2-TS/ID,
-		 * and fallback on UOR-2-RTP if value(RND) = 1 is found */
-		rohc_decomp_debug(context, "UOR-2* packet disambiguation: at least one "
-		                  "IP header is IPv4 with context(RND) = 0, so try "
-		                  "parsing as UOR-2-ID/TS, and fallback on UOR-2-RTP "
-		                  "later if value(RND) = 1 in packet");
-
-		/* UOR-2-ID or UOR-2-TS packet, check the T field */
-		if(rohc_decomp_packet_is_uor2_ts(packet, rohc_length, large_cid_len))
-		{
-			/* UOR-2-TS packet */
-			rohc_decomp_debug(context, "UOR-2* packet disambiguation: T = 1, "
-			                  "so try parsing as UOR-2-TS, and fallback on "
-			                  "UOR-2-RTP later if value(RND) = 1 in packet");
-			type = ROHC_PACKET_UOR_2_TS;
-		}
-		else
-		{
-			/* UOR-2-ID packet */
-			rohc_decomp_debug(context, "UOR-2* packet disambiguation: T = 0, "
-			                  "so try parsing as UOR-2-ID, and fallback on "
-			                  "UOR-2-RTP later if value(RND) = 1 in packet");
-			type = ROHC_PACKET_UOR_2_ID;
-		}
+		rohc_decomp_debug(context, "UO-1*/UOR-2* packet disambiguation: no IPv4 "
+		                  "header with context(RND) = 0, so parse as *-RTP");
+		pkt_types = (context->mode == ROHC_R_MODE ?
+		             rohc_decomp_pkt_types_rtp_r : rohc_decomp_pkt_types_rtp);
 	}
 
-	return type;
+	return pkt_types;
 }
 
 
@@ -825,9 +646,29 @@ static int rtp_parse_dynamic_rtp(const struct rohc_decomp_ctxt *const context,
 				goto error;
 			}
 
-			/* not supported yet */
-			rohc_decomp_debug(context, "TIME_STRIDE field not supported yet");
-			goto error;
+			size_t time_stride_sdvl_len;
+			uint32_t time_stride;
+			size_t time_stride_bits_nr;
+
+			/* decode the SDVL-encoded TIME_STRIDE field */
+			time_stride_sdvl_len = sdvl_decode(packet, remain_len, &time_stride,
+			                                   &time_stride_bits_nr);
+			if(time_stride_sdvl_len == 0)
+			{
+				rohc_decomp_warn(context, "failed to decode SDVL-encoded "
+				                 "TIME_STRIDE field");
+				goto error;
+			}
+			rohc_decomp_debug(context, "TIME_STRIDE read = %u ms", time_stride);
+
+			/* skip the SDVL-encoded TIME_STRIDE field in packet */
+#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
+			packet += time_stride_sdvl_len;
+#endif
+			remain_len -= time_stride_sdvl_len;
+
+			/* temporarily store the decoded TIME_STRIDE in context */
+			d_record_time_stride(rtp_context->ts_scaled_ctxt, time_stride);
 		}
 	}
 
@@ -1456,9 +1297,29 @@ static int rtp_parse_rtp_hdr_fields(const struct rohc_decomp_ctxt *const context
 
 	if(tis)
 	{
-		/* TODO: TIME_STRIDE */
-		rohc_decomp_warn(context, "TIME_STRIDE not supported yet");
-		goto error;
+		const struct d_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+		uint32_t time_stride;
+		size_t time_stride_bits_nr;
+		size_t time_stride_size;
+
+		/* decode SDVL-encoded TIME_STRIDE value */
+		time_stride_size = sdvl_decode(rohc_remain_data, rohc_remain_len,
+		                               &time_stride, &time_stride_bits_nr);
+		if(time_stride_size == 0)
+		{
+			rohc_decomp_warn(context, "failed to decode SDVL-encoded "
+			                 "TIME_STRIDE field");
+			goto error;
+		}
+		rohc_decomp_debug(context, "decoded TIME_STRIDE = %u ms", time_stride);
+
+#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
+		rohc_remain_data += time_stride_size;
+#endif
+		rohc_remain_len -= time_stride_size;
+
+		/* temporarily store the decoded TIME_STRIDE in context */
+		d_record_time_stride(rtp_context->ts_scaled_ctxt, time_stride);
 	}
 
 	return (rohc_data_len - rohc_remain_len);
@@ -1478,10 +1339,10 @@ error:
  * @return             The number of bytes read in the ROHC packet,
  *                     -1 in case of failure
  */
-static int rtp_parse_uo_remainder(const struct rohc_decomp_ctxt *const context,
-                                  const uint8_t *packet,
-                                  unsigned int length,
-                                  struct rohc_extr_bits *const bits)
+int rtp_parse_uo_remainder(const struct rohc_decomp_ctxt *const context,
+                           const uint8_t *packet,
+                           unsigned int length,
+                           struct rohc_extr_bits *const bits)
 {
 	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
 	const struct d_rtp_context *const rtp_context = rfc3095_ctxt->specific;
@@ -1547,9 +1408,9 @@ error:
  * @param decoded  OUT: The corresponding decoded values
  * @return         true if decoding is successful, false otherwise
  */
-static bool rtp_decode_values_from_bits(const struct rohc_decomp_ctxt *context,
-                                        const struct rohc_extr_bits *const bits,
-                                        struct rohc_decoded_values *const decoded)
+bool rtp_decode_values_from_bits(const struct rohc_decomp_ctxt *context,
+                                 const struct rohc_extr_bits *const bits,
+                                 struct rohc_decoded_values *const decoded)
 {
 	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
 	const struct d_rtp_context *const rtp_context = rfc3095_ctxt->specific;
@@ -1769,6 +1630,7 @@ static bool rtp_decode_values_from_bits(const struct rohc_decomp_ctxt *context,
 		rohc_decomp_debug(context, "TS is scaled");
 		ts_decode_ok = ts_decode_scaled_bits(rtp_context->ts_scaled_ctxt,
 		                                     bits->ts, bits->ts_nr,
+		                                     context->volat_ctxt.arrival_time,
 		                                     &decoded->ts);
 		if(!ts_decode_ok)
 		{
@@ -1813,10 +1675,10 @@ error:
  * @return             The length of the next header (ie. the UDP/RTP header),
  *                     -1 in case of error
  */
-static int rtp_build_uncomp_rtp(const struct rohc_decomp_ctxt *const context,
-                                const struct rohc_decoded_values *const decoded,
-                                uint8_t *const dest,
-                                const unsigned int payload_len)
+int rtp_build_uncomp_rtp(const struct rohc_decomp_ctxt *const context,
+                         const struct rohc_decoded_values *const decoded,
+                         uint8_t *const dest,
+                         const unsigned int payload_len)
 {
 	struct udphdr *udp;
 	struct rtphdr *rtp;
@@ -1866,8 +1728,8 @@ static int rtp_build_uncomp_rtp(const struct rohc_decomp_ctxt *const context,
  * @param context  The decompression context
  * @param decoded  The decoded values to update in the context
  */
-static void rtp_update_context(struct rohc_decomp_ctxt *const context,
-                               const struct rohc_decoded_values *const decoded)
+void rtp_update_context(struct rohc_decomp_ctxt *const context,
+                        const struct rohc_decoded_values *const decoded)
 {
 	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
 	struct d_rtp_context *const rtp_context = rfc3095_ctxt->specific;
@@ -1883,7 +1745,8 @@ static void rtp_update_context(struct rohc_decomp_ctxt *const context,
 	/* update context for RTP fields */
 	rtp = (struct rtphdr *) (udp + 1);
 	assert(decoded->sn <= 0xffff);
-	ts_update_context(rtp_context->ts_scaled_ctxt, decoded->ts, decoded->sn);
+	ts_update_context(rtp_context->ts_scaled_ctxt, decoded->ts, decoded->sn,
+	                  context->volat_ctxt.arrival_time);
 	rtp->version = decoded->rtp_version;
 	rtp->padding = decoded->rtp_p;
 	rtp->extension = decoded->rtp_x;
@@ -1897,6 +1760,97 @@ static void rtp_update_context(struct rohc_decomp_ctxt *const context,
 }
 
 
+/**
+ * @brief Decode the UDP/RTP fields of one UO-0 or UO-1-RTP packet
+ *
+ * The fast path calls this function to parse the UDP checksum from the UO*
+ * remainder, and to decode the UDP checksum, the RTP TimeStamp (TS) and the
+ * RTP Marker (M) flag. It reports no error, the generic path does.
+ *
+ * @param context        The decompression context
+ * @param bits           The bits extracted from the UO* base header
+ * @param rohc_data      The UO* remainder to parse
+ * @param rohc_data_len  The length of the UO* remainder
+ * @param[out] decoded   The decoded values
+ * @return               The number of bytes read in the ROHC packet,
+ *                       -1 if the packet shall be decoded by the generic path
+ */
+int rtp_decode_fast_rtp(const struct rohc_decomp_ctxt *const context,
+                        const struct rohc_extr_uo_bits *const bits,
+                        const uint8_t *const rohc_data,
+                        const size_t rohc_data_len,
+                        struct rohc_decoded_values *const decoded)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	const struct d_rtp_context *const rtp_context = rfc3095_ctxt->specific;
+	int read = 0; /* number of bytes read from the packet */
+
+	/* UDP checksum */
+	if(rtp_context->udp_check_present == ROHC_TRISTATE_YES)
+	{
+		if(rohc_data_len < 2)
+		{
+			goto error;
+		}
+		decoded->udp_check = GET_NEXT_16_BITS(rohc_data);
+		read += 2;
+	}
+	else if(rtp_context->udp_check_present == ROHC_TRISTATE_NO)
+	{
+		decoded->udp_check = 0;
+	}
+	else
+	{
+		goto error;
+	}
+
+	/* RTP Marker (M) flag: context(M) is never updated */
+	decoded->rtp_m = bits->rtp_m;
+
+	/* RTP TimeStamp (TS) is always scaled in UO-0 and UO-1-RTP packets */
+	assert(decoded->sn <= 0xffff);
+	if(bits->ts_nr == 0)
+	{
+		decoded->ts = ts_deduce_from_sn(rtp_context->ts_scaled_ctxt, decoded->sn);
+	}
+	else if(!ts_decode_scaled_bits(rtp_context->ts_scaled_ctxt, bits->ts,
+	                               bits->ts_nr, context->volat_ctxt.arrival_time,
+	                               &decoded->ts))
+	{
+		goto error;
+	}
+
+	return read;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Patch the UDP/RTP header copied from the template of the fast path
+ *
+ * @param decoded      The values decoded from the ROHC header
+ * @param dest         The UDP/RTP header to patch
+ * @param payload_len  The length of the UDP/RTP payload
+ */
+void rtp_patch_uncomp_rtp(const struct rohc_decoded_values *const decoded,
+                          uint8_t *const dest,
+                          const size_t payload_len)
+{
+	struct udphdr *const udp = (struct udphdr *) dest;
+	struct rtphdr *const rtp = (struct rtphdr *) (udp + 1);
+
+	udp->check = decoded->udp_check;
+	udp->len = rohc_hton16(payload_len + sizeof(struct udphdr) +
+	                       sizeof(struct rtphdr));
+	rtp->m = decoded->rtp_m;
+	assert(decoded->sn <= 0xffff);
+	rtp->sn = rohc_hton16((uint16_t) decoded->sn);
+	rtp->timestamp = rohc_hton32(decoded->ts);
+}
+
+
 /*
  * Private helper functions
  */
@@ -1950,6 +1904,22 @@ static inline bool is_inner_ipv4_rnd_ctxt(const struct rohc_decomp_rfc3095_ctxt
 }
 
 
+/**
+ * @brief Get the maximum length one RTP context takes in a memory block
+ *
+ * @return  The maximum number of bytes of the memory block the
+ *          profile-specific part of the context takes
+ */
+static size_t d_rtp_mem_max(void)
+{
+	return (rohc_decomp_rfc3095_mem_max() +
+	        rohc_slab_block_mem_max(sizeof(struct d_rtp_context)) +
+	        rohc_lsb_mem_max() +
+	        2 * rohc_slab_block_mem_max(sizeof(struct udphdr) + sizeof(struct rtphdr)) +
+	        d_sc_mem_max());
+}
+
+
 /**
  * @brief Define the decompression part of the RTP profile as described
  *        in the RFC 3095.
@@ -1967,5 +1937,8 @@ const struct rohc_decomp_profile d_rtp_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.decode_fast     = (rohc_decomp_decode_fast_t) rfc3095_decomp_decode_fast,
+	.prefetch        = rohc_decomp_rfc3095_prefetch,
+	.get_mem_max     = d_rtp_mem_max,
 };
 
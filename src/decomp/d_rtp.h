@@ -0,0 +1,65 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file d_rtp.h
+ * @brief ROHC decompression context for the RTP profile.
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The handlers of the RTP profile that the generic RFC3095 code calls
+ * directly for the IPv4/UDP/RTP contexts.
+ */
+
+#ifndef ROHC_DECOMP_RTP_H
+#define ROHC_DECOMP_RTP_H
+
+#include "rohc_decomp_rfc3095.h"
+
+int rtp_parse_uo_remainder(const struct rohc_decomp_ctxt *const context,
+                           const uint8_t *packet,
+                           unsigned int length,
+                           struct rohc_extr_bits *const bits);
+
+bool rtp_decode_values_from_bits(const struct rohc_decomp_ctxt *context,
+                                 const struct rohc_extr_bits *const bits,
+                                 struct rohc_decoded_values *const decoded)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+
+int rtp_build_uncomp_rtp(const struct rohc_decomp_ctxt *const context,
+                         const struct rohc_decoded_values *const decoded,
+                         uint8_t *const dest,
+                         const unsigned int payload_len);
+
+void rtp_update_context(struct rohc_decomp_ctxt *const context,
+                        const struct rohc_decoded_values *const decoded)
+	__attribute__((nonnull(1, 2)));
+
+int rtp_decode_fast_rtp(const struct rohc_decomp_ctxt *const context,
+                        const struct rohc_extr_uo_bits *const bits,
+                        const uint8_t *const rohc_data,
+                        const size_t rohc_data_len,
+                        struct rohc_decoded_values *const decoded)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+
+void rtp_patch_uncomp_rtp(const struct rohc_decoded_values *const decoded,
+                          uint8_t *const dest,
+                          const size_t payload_len)
+	__attribute__((nonnull(1, 2)));
+
+#endif
+
@@ -34,11 +34,14 @@
 
 #include "rohc_decomp.h"
 #include "rohc_decomp_internals.h"
+#include "rohc_decomp_detect_packet.h"
 #include "rohc_packets.h"
 #include "rohc_bit_ops.h"
+#include "rohc_bit_stream.h"
 #include "rohc_traces_internal.h"
 #include "rohc_utils.h"
 #include "rohc_debug.h"
+#include "sdvl.h"
 #include "schemes/rfc4996.h"
 #include "schemes/decomp_wlsb.h"
 #include "schemes/tcp_sack.h"
@@ -53,6 +56,17 @@
 #  include <string.h>
 #endif
 #include <stdint.h>
+#include <stddef.h> /* for offsetof() */
+
+
+/**
+ * @brief The maximum length of the co_common base header
+ *
+ * The fixed part, then the sequence and ACK numbers, the ACK stride, the
+ * window, the IP-ID, the URG pointer, the DSCP and the TTL/HL.
+ */
+#define D_TCP_CO_COMMON_MAX_LEN \
+	(sizeof(co_common_t) + 4 + 4 + 2 + 2 + 2 + 2 + 1 + 1)
 
 
 /*
@@ -64,6 +78,9 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
+static size_t d_tcp_mem_max(void)
+	__attribute__((warn_unused_result, const));
+
 static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(1, 2)));
@@ -76,6 +93,8 @@ static rohc_packet_t tcp_detect_packet_type(const struct rohc_decomp_ctxt *const
 
 static uint32_t d_tcp_get_msn(const struct rohc_decomp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1), pure));
+static void d_tcp_prefetch(const struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1)));
 
 /* parsing */
 static bool d_tcp_parse_packet(const struct rohc_decomp_ctxt *const context,
@@ -102,6 +121,18 @@ static bool d_tcp_parse_irdyn(const struct rohc_decomp_ctxt *const context,
                               struct rohc_tcp_extr_bits *const bits,
                               size_t *const rohc_hdr_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6, 7)));
+static bool d_tcp_parse_ir_cr(const struct rohc_decomp_ctxt *const context,
+                              const uint8_t *const rohc_packet,
+                              const size_t rohc_length,
+                              const size_t large_cid_len,
+                              struct rohc_decomp_crc *const extr_crc,
+                              struct rohc_tcp_extr_bits *const bits,
+                              size_t *const rohc_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6, 7)));
+static void d_tcp_replicate_static_chain(const struct rohc_decomp_ctxt *const context,
+                                         const struct d_tcp_context *const base_ctxt,
+                                         struct rohc_tcp_extr_bits *const bits)
+	__attribute__((nonnull(1, 2, 3)));
 static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
                            const uint8_t *const rohc_packet,
                            const size_t rohc_length,
@@ -113,134 +144,102 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 	__attribute__((warn_unused_result, nonnull(1, 2, 6, 7, 8)));
 
 static bool d_tcp_parse_rnd_1(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 static bool d_tcp_parse_rnd_2(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 static bool d_tcp_parse_rnd_3(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 static bool d_tcp_parse_rnd_4(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 static bool d_tcp_parse_rnd_5(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 static bool d_tcp_parse_rnd_6(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 static bool d_tcp_parse_rnd_7(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 static bool d_tcp_parse_rnd_8(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 
 static bool d_tcp_parse_seq_1(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 static bool d_tcp_parse_seq_2(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 static bool d_tcp_parse_seq_3(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 static bool d_tcp_parse_seq_4(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 static bool d_tcp_parse_seq_5(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 static bool d_tcp_parse_seq_6(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 static bool d_tcp_parse_seq_7(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 static bool d_tcp_parse_seq_8(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 6, 7)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 
 static bool d_tcp_parse_co_common(const struct rohc_decomp_ctxt *const context,
                                   const uint8_t *const rohc_packet,
@@ -261,6 +260,9 @@ static bool d_tcp_decode_bits(const struct rohc_decomp_ctxt *const context,
                               const size_t payload_len,
                               struct rohc_tcp_decoded_values *const decoded)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+static void d_tcp_put_pending_addrs(const struct d_tcp_context *const tcp_context,
+                                    struct rohc_tcp_decoded_values *const decoded)
+	__attribute__((nonnull(1, 2)));
 static bool d_tcp_decode_bits_ip_hdrs(const struct rohc_decomp_ctxt *const context,
                                       const struct rohc_tcp_extr_bits *const bits,
                                       struct rohc_tcp_decoded_values *const decoded)
@@ -330,7 +332,7 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
                                       struct rohc_buf *const uncomp_hdrs,
                                       size_t *const uncomp_hdrs_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 7, 8)));
-static bool d_tcp_check_uncomp_crc(const struct rohc_decomp *const decomp,
+static bool d_tcp_check_uncomp_crc(const struct rohc_decomp *const decomp __attribute__((unused)),
                                    const struct rohc_decomp_ctxt *const context,
                                    struct rohc_buf *const uncomp_hdrs,
                                    const rohc_crc_type_t crc_type,
@@ -368,10 +370,11 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
                          struct d_tcp_context **const persist_ctxt,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
+	struct rohc_slab *const slab = context->decompressor->ctxt_slab;
 	struct d_tcp_context *tcp_context;
 
 	/* allocate memory for the context */
-	*persist_ctxt = malloc(sizeof(struct d_tcp_context));
+	*persist_ctxt = rohc_slab_alloc(slab, sizeof(struct d_tcp_context));
 	if((*persist_ctxt) == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -380,9 +383,10 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	}
 	tcp_context = *persist_ctxt;
 	memset(tcp_context, 0, sizeof(struct d_tcp_context));
+	tcp_context->static_store = context->decompressor->static_store;
 
 	/* create the LSB decoding context for the MSN */
-	tcp_context->msn_lsb_ctxt = rohc_lsb_new(16);
+	tcp_context->msn_lsb_ctxt = rohc_lsb_new(slab, 16);
 	if(tcp_context->msn_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -391,7 +395,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the LSB decoding context for the innermost IP-ID */
-	tcp_context->ip_id_lsb_ctxt = rohc_lsb_new(16);
+	tcp_context->ip_id_lsb_ctxt = rohc_lsb_new(slab, 16);
 	if(tcp_context->ip_id_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -401,7 +405,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the LSB decoding context for the innermost TTL/HL */
-	tcp_context->ttl_hl_lsb_ctxt = rohc_lsb_new(8);
+	tcp_context->ttl_hl_lsb_ctxt = rohc_lsb_new(slab, 8);
 	if(tcp_context->ttl_hl_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -411,7 +415,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the LSB decoding context for the TCP window */
-	tcp_context->window_lsb_ctxt = rohc_lsb_new(16);
+	tcp_context->window_lsb_ctxt = rohc_lsb_new(slab, 16);
 	if(tcp_context->window_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -420,7 +424,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the LSB decoding context for the sequence number */
-	tcp_context->seq_lsb_ctxt = rohc_lsb_new(32);
+	tcp_context->seq_lsb_ctxt = rohc_lsb_new(slab, 32);
 	if(tcp_context->seq_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -430,7 +434,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the LSB decoding context for the scaled sequence number */
-	tcp_context->seq_scaled_lsb_ctxt = rohc_lsb_new(32);
+	tcp_context->seq_scaled_lsb_ctxt = rohc_lsb_new(slab, 32);
 	if(tcp_context->seq_scaled_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -440,7 +444,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the LSB decoding context for the ACK number */
-	tcp_context->ack_lsb_ctxt = rohc_lsb_new(32);
+	tcp_context->ack_lsb_ctxt = rohc_lsb_new(slab, 32);
 	if(tcp_context->ack_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -450,7 +454,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the LSB decoding context for the scaled acknowledgment number */
-	tcp_context->ack_scaled_lsb_ctxt = rohc_lsb_new(32);
+	tcp_context->ack_scaled_lsb_ctxt = rohc_lsb_new(slab, 32);
 	if(tcp_context->ack_scaled_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -466,7 +470,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the LSB decoding context for the TCP option Timestamp echo
 	 * request */
-	tcp_context->opt_ts_req_lsb_ctxt = rohc_lsb_new(32);
+	tcp_context->opt_ts_req_lsb_ctxt = rohc_lsb_new(slab, 32);
 	if(tcp_context->opt_ts_req_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -477,7 +481,7 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the LSB decoding context for the TCP option Timestamp echo
 	 * reply */
-	tcp_context->opt_ts_rep_lsb_ctxt = rohc_lsb_new(32);
+	tcp_context->opt_ts_rep_lsb_ctxt = rohc_lsb_new(slab, 32);
 	if(tcp_context->opt_ts_rep_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -489,25 +493,37 @@ static bool d_tcp_create(const struct rohc_decomp_ctxt *const context,
 	/* volatile part of the decompression context */
 	volat_ctxt->crc.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.bits_nr = 0;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_tcp_extr_bits));
+	volat_ctxt->extr_bits =
+		rohc_slab_alloc(slab, sizeof(struct rohc_tcp_extr_bits));
 	if(volat_ctxt->extr_bits == NULL)
 	{
 		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
 		                 "of one of the TCP decompression context");
 		goto free_lsb_ts_opt_rep;
 	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_tcp_decoded_values));
+	volat_ctxt->decoded_values =
+		rohc_slab_alloc(slab, sizeof(struct rohc_tcp_decoded_values));
 	if(volat_ctxt->decoded_values == NULL)
 	{
 		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
 		                 "of one of the TCP decompression context");
 		goto free_extr_bits;
 	}
+	{
+		struct rohc_tcp_decoded_values *const decoded = volat_ctxt->decoded_values;
+		size_t i;
+
+		/* no interned IPv6 addresses pending yet */
+		for(i = 0; i < ROHC_TCP_MAX_IP_HDRS; i++)
+		{
+			decoded->ip[i].addrs = NULL;
+		}
+	}
 
 	return true;
 
 free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
+	rohc_slab_zfree(volat_ctxt->extr_bits);
 free_lsb_ts_opt_rep:
 	rohc_lsb_free(tcp_context->opt_ts_rep_lsb_ctxt);
 free_lsb_ts_opt_req:
@@ -529,7 +545,8 @@ free_lsb_ip_id:
 free_lsb_msn:
 	rohc_lsb_free(tcp_context->msn_lsb_ctxt);
 destroy_context:
-	zfree(tcp_context);
+	rohc_slab_free(tcp_context);
+	*persist_ctxt = NULL;
 quit:
 	return false;
 }
@@ -547,6 +564,33 @@ quit:
 static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
+	size_t i;
+
+	/* release the interned IPv6 addresses */
+	d_tcp_put_pending_addrs(tcp_context, volat_ctxt->decoded_values);
+	for(i = 0; i < tcp_context->ip_contexts_nr; i++)
+	{
+		if(tcp_context->ip_contexts[i].version == IPV6)
+		{
+			rohc_intern_put(tcp_context->static_store,
+			                tcp_context->ip_contexts[i].ctxt.v6.addrs);
+		}
+	}
+
+	/* free the cold parts of the context, the IP headers beyond the current
+	 * ones may have kept their contexts of extension headers */
+	for(i = 0; i < ROHC_TCP_MAX_IP_HDRS; i++)
+	{
+		if(tcp_context->ip_contexts[i].opts != NULL)
+		{
+			rohc_slab_free(tcp_context->ip_contexts[i].opts);
+		}
+	}
+	if(tcp_context->static_chain != NULL)
+	{
+		rohc_slab_free(tcp_context->static_chain);
+	}
+
 	/* destroy the LSB decoding context for the TCP option Timestamp echo
 	 * request */
 	rohc_lsb_free(tcp_context->opt_ts_req_lsb_ctxt);
@@ -571,11 +615,11 @@ static void d_tcp_destroy(struct d_tcp_context *const tcp_context,
 	rohc_lsb_free(tcp_context->msn_lsb_ctxt);
 
 	/* free the TCP decompression context itself */
-	free(tcp_context);
+	rohc_slab_free(tcp_context);
 
 	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
+	rohc_slab_free(volat_ctxt->decoded_values);
+	rohc_slab_free(volat_ctxt->extr_bits);
 }
 
 
@@ -605,119 +649,42 @@ static rohc_packet_t tcp_detect_packet_type(const struct rohc_decomp_ctxt *const
 		goto error;
 	}
 
-	rohc_decomp_debug(context, "try to determine the header from first byte "
-	                  "0x%02x", rohc_packet[0]);
-
-	if(rohc_packet[0] == ROHC_PACKET_TYPE_IR)
+	if(context->num_recv_packets == 0)
 	{
-		type = ROHC_PACKET_IR;
-	}
-	else if(rohc_packet[0] == ROHC_PACKET_TYPE_IR_DYN)
-	{
-		type = ROHC_PACKET_IR_DYN;
+		/* only IR and IR-DYN packets may initialize the context */
+		rohc_decomp_debug(context, "try to determine the header from first byte "
+		                  "0x%02x", rohc_packet[0]);
+		type = rohc_decomp_pkt_type(rohc_decomp_pkt_types_tcp_ir, rohc_packet[0]);
+		if(type == ROHC_PACKET_UNKNOWN)
+		{
+			rohc_decomp_warn(context, "non IR(-DYN) packet received without "
+			                 "initialized context: cannot determine the packet "
+			                 "type");
+			goto error;
+		}
 	}
 	else
 	{
+		const ip_context_t *innermost_hdr_ctxt;
 		uint8_t innermost_ip_id_behavior;
 		bool is_ip_id_seq;
 
 		/* detect the version and IP-ID behavior of the innermost IP header */
-		{
-			const ip_context_t *innermost_hdr_ctxt;
-			if(context->num_recv_packets == 0)
-			{
-				rohc_decomp_warn(context, "non IR(-DYN) packet received without "
-				                 "initialized context: cannot determine the packet "
-				                 "type");
-				goto error;
-			}
-			assert(tcp_context->ip_contexts_nr > 0);
-			innermost_hdr_ctxt =
-				&(tcp_context->ip_contexts[tcp_context->ip_contexts_nr - 1]);
-			innermost_ip_id_behavior = innermost_hdr_ctxt->ctxt.vx.ip_id_behavior;
-			is_ip_id_seq = (innermost_ip_id_behavior <= IP_ID_BEHAVIOR_SEQ_SWAP);
-			rohc_decomp_debug(context, "IPv%u header #%zu is the innermost IP header",
-			                  innermost_hdr_ctxt->version, tcp_context->ip_contexts_nr);
-		}
+		assert(tcp_context->ip_contexts_nr > 0);
+		innermost_hdr_ctxt =
+			&(tcp_context->ip_contexts[tcp_context->ip_contexts_nr - 1]);
+		innermost_ip_id_behavior = innermost_hdr_ctxt->ctxt.vx.ip_id_behavior;
+		is_ip_id_seq = (innermost_ip_id_behavior <= IP_ID_BEHAVIOR_SEQ_SWAP);
+		rohc_decomp_debug(context, "IPv%u header #%zu is the innermost IP header",
+		                  innermost_hdr_ctxt->version, tcp_context->ip_contexts_nr);
 
 		rohc_decomp_debug(context, "try to determine the header from first byte "
 		                  "0x%02x and innermost IP-ID behavior %s", rohc_packet[0],
 		                  tcp_ip_id_behavior_get_descr(innermost_ip_id_behavior));
 
-		if(rohc_packet[0] & 0x80)
-		{
-			switch(rohc_packet[0] & 0xf0)
-			{
-				case 0x80: /* 1000 = seq_5 / rnd_5 */
-					type = (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_5 : ROHC_PACKET_TCP_RND_5);
-					break;
-				case 0x90: /* 1001 = seq_3 / rnd_5 */
-					type = (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_3 : ROHC_PACKET_TCP_RND_5);
-					break;
-				case 0xa0: /* 1010 = seq_1 / rnd_6 */
-					type = (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_1 : ROHC_PACKET_TCP_RND_6);
-					break;
-				case 0xb0: /* 1011 = seq_8 / rnd_1 / rnd_7 / rnd_8 */
-					if(is_ip_id_seq)
-					{
-						type = ROHC_PACKET_TCP_SEQ_8;
-					}
-					else if(rohc_packet[0] & 0x08)
-					{
-						if(rohc_packet[0] & 0x04)
-						{
-							type = ROHC_PACKET_TCP_RND_7;
-						}
-						else
-						{
-							type = ROHC_PACKET_TCP_RND_1;
-						}
-					}
-					else
-					{
-						type = ROHC_PACKET_TCP_RND_8;
-					}
-					break;
-				case 0xc0: /* 1100 = seq_7 / rnd_2 */
-					type = (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_7 : ROHC_PACKET_TCP_RND_2);
-					break;
-				case 0xd0: /* 1101 = seq_2 / seq_6 / rnd_4 */
-					if(is_ip_id_seq)
-					{
-						if(rohc_packet[0] & 0x08)
-						{
-							type = ROHC_PACKET_TCP_SEQ_6;
-						}
-						else
-						{
-							type = ROHC_PACKET_TCP_SEQ_2;
-						}
-					}
-					else
-					{
-						type = ROHC_PACKET_TCP_RND_4;
-					}
-					break;
-				case 0xf0: /* 1111 = common */
-					if((rohc_packet[0] & 0xfe) == 0xfa)
-					{
-						type = ROHC_PACKET_TCP_CO_COMMON;
-					}
-					else
-					{
-						type = ROHC_PACKET_UNKNOWN;
-					}
-					break;
-				default:
-					type = ROHC_PACKET_UNKNOWN;
-					break;
-			}
-		}
-		else
-		{
-			/* seq_4 / rnd_3 */
-			type = (is_ip_id_seq ? ROHC_PACKET_TCP_SEQ_4 : ROHC_PACKET_TCP_RND_3);
-		}
+		/* the seq_* and rnd_* packets share their discriminators */
+		type = rohc_decomp_pkt_type(is_ip_id_seq ? rohc_decomp_pkt_types_tcp_seq :
+		                            rohc_decomp_pkt_types_tcp_rnd, rohc_packet[0]);
 	}
 
 	return type;
@@ -771,6 +738,13 @@ static bool d_tcp_parse_packet(const struct rohc_decomp_ctxt *const context,
 		                               rohc_packet.len, large_cid_len,
 		                               extr_crc, extr_bits, rohc_hdr_len);
 	}
+	else if((*packet_type) == ROHC_PACKET_IR_CR)
+	{
+		/* decode IR-CR packet */
+		parsing_ok = d_tcp_parse_ir_cr(context, rohc_buf_data(rohc_packet),
+		                               rohc_packet.len, large_cid_len,
+		                               extr_crc, extr_bits, rohc_hdr_len);
+	}
 	else
 	{
 		/* decode CO packet */
@@ -804,6 +778,7 @@ static bool d_tcp_parse_ir(const struct rohc_decomp_ctxt *const context,
                            struct rohc_tcp_extr_bits *const bits,
                            size_t *const rohc_hdr_len)
 {
+	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
 	const uint8_t *remain_data;
 	size_t remain_len;
 	size_t static_chain_len;
@@ -837,15 +812,35 @@ static bool d_tcp_parse_ir(const struct rohc_decomp_ctxt *const context,
 	remain_data++;
 	remain_len--;
 
-	/* parse static chain */
-	if(!tcp_parse_static_chain(context, remain_data, remain_len,
-	                           bits, &static_chain_len))
+	/* parse static chain, unless it is the one of the last IR packet: the
+	 * periodic IR refreshes are then parsed as IR-DYN packets, the static
+	 * fields being retrieved from context as for the IR-DYN packets */
+	if(tcp_context->static_chain != NULL &&
+	   tcp_context->static_chain->len > 0 &&
+	   remain_len >= tcp_context->static_chain->len &&
+	   memcmp(remain_data, tcp_context->static_chain->data,
+	          tcp_context->static_chain->len) == 0)
 	{
-		rohc_decomp_warn(context, "failed to parse the static chain");
-		goto error;
+		rohc_decomp_debug(context, "static chain of %zu bytes is unchanged",
+		                  tcp_context->static_chain->len);
+		static_chain_len = tcp_context->static_chain->len;
+		extr_crc->is_static_unchanged = true;
+	}
+	else
+	{
+		if(!tcp_parse_static_chain(context, remain_data, remain_len,
+		                           bits, &static_chain_len))
+		{
+			rohc_decomp_warn(context, "failed to parse the static chain");
+			goto error;
+		}
+		bits->static_chain = remain_data;
+		bits->static_chain_len = static_chain_len;
+		extr_crc->is_static_unchanged = false;
 	}
 	remain_data += static_chain_len;
 	remain_len -= static_chain_len;
+	extr_crc->static_end = remain_data - rohc_packet;
 
 	/* parse dynamic chain */
 	if(!tcp_parse_dyn_chain(context, remain_data, remain_len, bits, &dyn_chain_len))
@@ -941,6 +936,259 @@ error:
 }
 
 
+/**
+ * @brief Parse the given IR-CR packet for the TCP profile
+ *
+ * The IR-CR packet initializes the context from the static part of one base
+ * context (RFC 4164 and RFC 6846, §7.3.2): the IP addresses, the IP protocols,
+ * the IPv6 flow labels and the IPv6 extension headers are copied from the
+ * base context, the TCP ports and the whole dynamic chain are transmitted.
+ *
+ * \verbatim
+
+     0   1   2   3   4   5   6   7
+    --- --- --- --- --- --- --- ---
+ 1  :         Add-CID octet         : if for small CIDs and CID != 0
+    +---+---+---+---+---+---+---+---+
+ 2  | 1   1   1   1   1   1   0   0 | IR-CR type octet
+    +---+---+---+---+---+---+---+---+
+    :                               :
+ 3  /      0-2 octets of CID        / 1-2 octets if for large CIDs
+    :                               :
+    +---+---+---+---+---+---+---+---+
+ 4  |            Profile            | 1 octet
+    +---+---+---+---+---+---+---+---+
+ 5  |             CRC               | 1 octet
+    +---+---+---+---+---+---+---+---+
+ 6  | B |           CRC7            | 1 octet
+    +---+---+---+---+---+---+---+---+
+    :   Reserved    |   Base CID    : 1 octet, if B = 1 and for small CIDs
+    +---+---+---+---+---+---+---+---+
+ 7  /           Base CID            / 1-2 octets, if B = 1 and for large CIDs
+    +---+---+---+---+---+---+---+---+
+ 8  /     TCP source and dest ports / 4 octets
+    +---+---+---+---+---+---+---+---+
+ 9  /         Dynamic chain         / variable length
+    +---+---+---+---+---+---+---+---+
+    |                               |
+10  /            Payload            / variable length
+    |                               |
+     - - - - - - - - - - - - - - - -
+
+\endverbatim
+ *
+ * The CRC covers the IR-CR header as the CRC of the IR header does. The CRC7
+ * covers the uncompressed headers, so that a base context that differs
+ * between compressor and decompressor is detected. Without the B flag, the
+ * base context is the context itself.
+ *
+ * @param context            The decompression context
+ * @param rohc_packet        The ROHC packet to decode
+ * @param rohc_length        The length of the ROHC packet to decode
+ * @param large_cid_len      The length of the optional large CID field
+ * @param[out] extr_crc      The CRC bits extracted from the ROHC header
+ * @param[out] bits          The bits extracted from the IR-CR packet
+ * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
+ * @return                   true if parsing was successful,
+ *                           false if packet was malformed
+ */
+static bool d_tcp_parse_ir_cr(const struct rohc_decomp_ctxt *const context,
+                              const uint8_t *const rohc_packet,
+                              const size_t rohc_length,
+                              const size_t large_cid_len,
+                              struct rohc_decomp_crc *const extr_crc,
+                              struct rohc_tcp_extr_bits *const bits,
+                              size_t *const rohc_hdr_len)
+{
+	const struct rohc_decomp_ctxt *base_ctxt;
+	const tcp_static_t *tcp_ports;
+	const uint8_t *remain_data;
+	size_t remain_len;
+	rohc_cid_t base_cid;
+	size_t dyn_chain_len;
+	bool has_base_cid;
+
+	remain_data = rohc_packet;
+	remain_len = rohc_length;
+
+	/* skip:
+	 * - the first byte of the ROHC packet (field 2)
+	 * - the Profile byte (field 4) */
+	if(remain_len < (1 + large_cid_len + 1))
+	{
+		rohc_decomp_warn(context, "malformed ROHC packet: too short for first "
+		                 "byte, large CID bytes, and profile byte");
+		goto error;
+	}
+	remain_data += 1 + large_cid_len + 1;
+	remain_len -= 1 + large_cid_len + 1;
+
+	/* parse CRC and B flag + CRC7 */
+	if(remain_len < 2)
+	{
+		rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+		                 "CRC byte and the B flag + CRC7 byte");
+		goto error;
+	}
+	extr_crc->type = ROHC_CRC_TYPE_NONE;
+	extr_crc->bits = remain_data[0];
+	extr_crc->bits_nr = 8;
+	has_base_cid = !!GET_BIT_7(remain_data + 1);
+	bits->replicate_crc = GET_BIT_0_6(remain_data + 1);
+	remain_data += 2;
+	remain_len -= 2;
+
+	/* parse the optional base CID */
+	if(!has_base_cid)
+	{
+		base_cid = context->cid;
+	}
+	else if(d_cid_type(context->decompressor) == ROHC_SMALL_CID)
+	{
+		if(remain_len < 1)
+		{
+			rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+			                 "small base CID");
+			goto error;
+		}
+		base_cid = GET_BIT_0_3(remain_data);
+		remain_data++;
+		remain_len--;
+	}
+	else
+	{
+		uint32_t large_base_cid;
+		size_t large_base_cid_bits_nr;
+		size_t large_base_cid_len;
+
+		large_base_cid_len = sdvl_decode(remain_data, remain_len, &large_base_cid,
+		                                 &large_base_cid_bits_nr);
+		if(large_base_cid_len != 1 && large_base_cid_len != 2)
+		{
+			rohc_decomp_warn(context, "malformed ROHC packet: failed to decode the "
+			                 "large base CID");
+			goto error;
+		}
+		base_cid = large_base_cid & 0xffff;
+		remain_data += large_base_cid_len;
+		remain_len -= large_base_cid_len;
+	}
+	rohc_decomp_debug(context, "replicate the base context with CID %zu, CRC7 "
+	                  "= 0x%02x", base_cid, bits->replicate_crc);
+
+	/* copy the static chain from the base context */
+	base_ctxt = rohc_decomp_find_base_ctxt(context, base_cid);
+	if(base_ctxt == NULL)
+	{
+		rohc_decomp_warn(context, "cannot replicate the base context with CID %zu",
+		                 base_cid);
+		goto error;
+	}
+	d_tcp_replicate_static_chain(context, base_ctxt->persist_ctxt, bits);
+
+	/* the IR-CR packet does not carry the static chain it installs */
+	bits->static_chain = rohc_packet;
+	bits->static_chain_len = 0;
+
+	/* parse the TCP ports, the only static fields that are not replicated */
+	if(remain_len < sizeof(tcp_static_t))
+	{
+		rohc_decomp_warn(context, "malformed ROHC packet: too short for the "
+		                 "TCP ports");
+		goto error;
+	}
+	tcp_ports = (const tcp_static_t *) remain_data;
+	bits->src_port = rohc_ntoh16(tcp_ports->src_port);
+	bits->src_port_nr = 16;
+	bits->dst_port = rohc_ntoh16(tcp_ports->dst_port);
+	bits->dst_port_nr = 16;
+	rohc_decomp_debug(context, "TCP ports = %u -> %u", bits->src_port,
+	                  bits->dst_port);
+	remain_data += sizeof(tcp_static_t);
+	remain_len -= sizeof(tcp_static_t);
+
+	/* parse dynamic chain */
+	if(!tcp_parse_dyn_chain(context, remain_data, remain_len, bits, &dyn_chain_len))
+	{
+		rohc_decomp_warn(context, "failed to parse the dynamic chain");
+		goto error;
+	}
+	remain_data += dyn_chain_len;
+#ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
+	remain_len -= dyn_chain_len;
+#endif
+
+	*rohc_hdr_len = remain_data - rohc_packet;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Copy the static chain of the base context of an IR-CR packet
+ *
+ * The bits are set as if the static chain of an IR packet was parsed, except
+ * for the TCP ports.
+ *
+ * @param context    The decompression context
+ * @param base_ctxt  The TCP part of the base context
+ * @param[out] bits  The bits extracted from the IR-CR packet
+ */
+static void d_tcp_replicate_static_chain(const struct rohc_decomp_ctxt *const context,
+                                         const struct d_tcp_context *const base_ctxt,
+                                         struct rohc_tcp_extr_bits *const bits)
+{
+	size_t ip_hdr_pos;
+
+	for(ip_hdr_pos = 0; ip_hdr_pos < base_ctxt->ip_contexts_nr; ip_hdr_pos++)
+	{
+		const ip_context_t *const ip_ctxt = &(base_ctxt->ip_contexts[ip_hdr_pos]);
+		struct rohc_tcp_extr_ip_bits *const ip_bits = &(bits->ip[ip_hdr_pos]);
+
+		ip_bits->version = ip_ctxt->version;
+		ip_bits->proto = ip_ctxt->ctxt.vx.next_header;
+		ip_bits->proto_nr = 8;
+
+		if(ip_ctxt->version == IPV4)
+		{
+			memcpy(ip_bits->saddr, &ip_ctxt->ctxt.v4.src_addr, sizeof(uint32_t));
+			ip_bits->saddr_nr = 32;
+			memcpy(ip_bits->daddr, &ip_ctxt->ctxt.v4.dst_addr, sizeof(uint32_t));
+			ip_bits->daddr_nr = 32;
+			ip_bits->opts_nr = 0;
+			ip_bits->opts_len = 0;
+		}
+		else
+		{
+			size_t ext_pos;
+
+			ip_bits->flowid = ip_ctxt->ctxt.v6.flow_label;
+			ip_bits->flowid_nr = 20;
+			memcpy(ip_bits->saddr, &ip_ctxt->ctxt.v6.addrs[0], sizeof(struct ipv6_addr));
+			ip_bits->saddr_nr = 128;
+			memcpy(ip_bits->daddr, &ip_ctxt->ctxt.v6.addrs[1], sizeof(struct ipv6_addr));
+			ip_bits->daddr_nr = 128;
+
+			/* the dynamic chain carries the data of the extension headers */
+			ip_bits->opts_nr = ip_ctxt->opts_nr;
+			ip_bits->opts_len = ip_ctxt->opts_len;
+			for(ext_pos = 0; ext_pos < ip_ctxt->opts_nr; ext_pos++)
+			{
+				memcpy(&(ip_bits->opts[ext_pos]), &(ip_ctxt->opts[ext_pos]),
+				       offsetof(ip_option_context_t, generic.data) +
+				       ip_ctxt->opts[ext_pos].generic.data_len);
+			}
+		}
+		rohc_decomp_debug(context, "IPv%u header #%zu replicated with %zu "
+		                  "extension headers", ip_bits->version, ip_hdr_pos + 1,
+		                  ip_bits->opts_nr);
+	}
+	bits->ip_nr = base_ctxt->ip_contexts_nr;
+}
+
+
 /**
  * @brief Parse the given CO packet for the TCP profile
  *
@@ -981,8 +1229,6 @@ error:
  * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
- *
- * @todo TODO: avoid malloc/free of packed_rohc_packet
  */
 static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
                            const uint8_t *const rohc_packet,
@@ -993,8 +1239,6 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
                            struct rohc_tcp_extr_bits *const bits,
                            size_t *const rohc_hdr_len)
 {
-	const size_t packed_rohc_packet_max_len = 0xffff + 100;
-	uint8_t *packed_rohc_packet = malloc(packed_rohc_packet_max_len); // TODO: change that
 	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
 	int ret;
 
@@ -1008,24 +1252,18 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 
 	bool has_opts_list;
 	size_t rohc_opts_len;
+	size_t co_pkt_len;
 
 	bool (*parse_co_pkt)(const struct rohc_decomp_ctxt *const context,
-	                     const uint8_t *const rohc_packet,
-	                     const size_t rohc_length,
+	                     struct rohc_bit_reader *const reader,
 	                     struct rohc_decomp_crc *const extr_crc,
 	                     struct rohc_tcp_extr_bits *const bits,
-	                     size_t *const rohc_hdr_len,
 	                     bool *const has_opts_list);
 
 	assert(rohc_packet != NULL);
 	assert(large_cid_len <= 2);
 	assert(packet_type != ROHC_PACKET_UNKNOWN);
 
-#ifndef __clang_analyzer__ /* silent warning about value never read */
-	rohc_remain_data = (uint8_t *) rohc_packet;
-#endif
-	rohc_remain_len = rohc_length;
-
 	rohc_decomp_debug(context, "large_cid_len = %zu, rohc_length = %zu",
 	                  large_cid_len, rohc_length);
 
@@ -1035,25 +1273,12 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 	inner_ip_bits = &(bits->ip[bits->ip_nr - 1]);
 
 	/* check if the ROHC packet is large enough to parse parts 2, 3 and 4 */
-	if(rohc_remain_len <= (1 + large_cid_len))
+	if(rohc_length <= (1 + large_cid_len))
 	{
 		rohc_decomp_warn(context, "rohc packet too small (len = %zu)",
-		                 rohc_remain_len);
-		goto error;
-	}
-
-	/* copy the first byte of header over the last byte of the large CID field
-	 * to be able to map packet strutures to the ROHC bytes */
-	if((rohc_remain_len - large_cid_len) > packed_rohc_packet_max_len)
-	{
-		rohc_decomp_warn(context, "internal problem: internal buffer too small");
+		                 rohc_length);
 		goto error;
 	}
-	packed_rohc_packet[0] = rohc_packet[0];
-	memcpy(packed_rohc_packet + 1, rohc_packet + 1 + large_cid_len,
-	       rohc_remain_len - 1 - large_cid_len);
-	rohc_remain_data = packed_rohc_packet;
-	rohc_remain_len -= large_cid_len;
 	*rohc_hdr_len = 0;
 
 	/* parse the packet type we detected earlier */
@@ -1110,27 +1335,62 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 			parse_co_pkt = d_tcp_parse_seq_8;
 			break;
 		case ROHC_PACKET_TCP_CO_COMMON:
-			parse_co_pkt = d_tcp_parse_co_common;
+			parse_co_pkt = NULL;
 			break;
 		default:
 			assert(0); /* should not happen */
 			goto error;
 	}
+	if(parse_co_pkt != NULL)
+	{
+		/* the seq_* and rnd_* packets are read field by field, the large CID
+		 * between their first byte and their other bytes is skipped */
+		struct rohc_bit_reader reader;
+
+		rohc_bit_reader_init(&reader, rohc_packet, rohc_length, large_cid_len);
+		if(!parse_co_pkt(context, &reader, extr_crc, bits, &has_opts_list))
+		{
+			rohc_decomp_warn(context, "failed to parse %s packet (type %d)",
+			                 rohc_get_packet_descr(packet_type), packet_type);
+			goto error;
+		}
+		co_pkt_len = rohc_bit_reader_offset(&reader);
+	}
+	else if(large_cid_len == 0)
 	{
-		size_t co_pkt_len;
-		if(!parse_co_pkt(context, rohc_remain_data, rohc_remain_len,
-		                 extr_crc, bits, &co_pkt_len, &has_opts_list))
+		/* the co_common packet is contiguous without large CID */
+		if(!d_tcp_parse_co_common(context, rohc_packet, rohc_length,
+		                          extr_crc, bits, &co_pkt_len, &has_opts_list))
 		{
 			rohc_decomp_warn(context, "failed to parse %s packet (type %d)",
 			                 rohc_get_packet_descr(packet_type), packet_type);
 			goto error;
 		}
-		rohc_remain_data += co_pkt_len;
-		rohc_remain_len -= co_pkt_len;
-		(*rohc_hdr_len) += co_pkt_len;
 	}
-	rohc_decomp_dump_buf(context, "ROHC base header", packed_rohc_packet,
-	                     *rohc_hdr_len);
+	else
+	{
+		/* copy the first byte of the co_common packet before its other bytes
+		 * to be able to map the packet structure to the ROHC bytes */
+		uint8_t co_common_bytes[D_TCP_CO_COMMON_MAX_LEN];
+		const size_t co_common_max_len =
+			rohc_min(rohc_length - large_cid_len, D_TCP_CO_COMMON_MAX_LEN);
+
+		co_common_bytes[0] = rohc_packet[0];
+		memcpy(co_common_bytes + 1, rohc_packet + 1 + large_cid_len,
+		       co_common_max_len - 1);
+		if(!d_tcp_parse_co_common(context, co_common_bytes, co_common_max_len,
+		                          extr_crc, bits, &co_pkt_len, &has_opts_list))
+		{
+			rohc_decomp_warn(context, "failed to parse %s packet (type %d)",
+			                 rohc_get_packet_descr(packet_type), packet_type);
+			goto error;
+		}
+	}
+	rohc_decomp_dump_buf(context, "ROHC base header (large CID included)",
+	                     rohc_packet, large_cid_len + co_pkt_len);
+	rohc_remain_data = rohc_packet + large_cid_len + co_pkt_len;
+	rohc_remain_len = rohc_length - large_cid_len - co_pkt_len;
+	(*rohc_hdr_len) += co_pkt_len;
 
 	/* innermost IP-ID behavior */
 	if(inner_ip_bits->id_behavior_nr > 0)
@@ -1157,7 +1417,8 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 		                  "after the ROHC base header");
 		/* same list as in previous packets, but reset the 'present' flags ; the
 		 * list might be updated by irregular chain later */
-		memcpy(&bits->tcp_opts, &tcp_context->tcp_opts, sizeof(struct d_tcp_opts_ctxt));
+		d_tcp_copy_tcp_opts(&bits->tcp_opts, &tcp_context->tcp_opts);
+		bits->tcp_opts.is_list_present = false;
 		for(i = 0; i < ROHC_TCP_OPTS_MAX; i++)
 		{
 			bits->tcp_opts.expected_dynamic[i] = false;
@@ -1205,11 +1466,9 @@ static bool d_tcp_parse_CO(const struct rohc_decomp_ctxt *const context,
 	*rohc_hdr_len += large_cid_len;
 	assert((*rohc_hdr_len) <= rohc_length);
 
-	free(packed_rohc_packet);
 	return true;
 
 error:
-	free(packed_rohc_packet);
 	return false;
 }
 
@@ -1218,50 +1477,46 @@ error:
  * @brief Parse the given rnd_1 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_rnd_1(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
-	const rnd_1_t *const rnd_1 = (rnd_1_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
-	/* check if the ROHC packet is large enough to parse rnd_1 */
-	if(rohc_length < sizeof(rnd_1_t))
+	/* check once if the ROHC packet is large enough to parse rnd_1 */
+	if(rohc_bit_reader_avail(reader) < sizeof(rnd_1_t))
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_1 (len = %zu)",
-		                 rohc_length);
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(rnd_1->discriminator == 0x2e); /* '101110' */
-	bits->seq.bits = (rnd_1->seq_num1 << 16) | rohc_ntoh16(rnd_1->seq_num2);
+	discriminator = rohc_bit_read(reader, 6);
+	assert(discriminator == 0x2e); /* '101110' */
+	bits->seq.bits = rohc_bit_read(reader, 18);
 	bits->seq.bits_nr = 18;
 	bits->seq.p = 65535;
-	bits->msn.bits = rnd_1->msn;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = rnd_1->psh_flag;
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = rnd_1->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 3);
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(rnd_1_t);
 	*has_opts_list = false;
 
 	return true;
@@ -1275,49 +1530,45 @@ error:
  * @brief Parse the given rnd_2 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_rnd_2(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
-	const rnd_2_t *const rnd_2 = (rnd_2_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
-	/* check if the ROHC packet is large enough to parse rnd_2 */
-	if(rohc_length < sizeof(rnd_2_t))
+	/* check once if the ROHC packet is large enough to parse rnd_2 */
+	if(rohc_bit_reader_avail(reader) < sizeof(rnd_2_t))
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_2 (len = %zu)",
-		                 rohc_length);
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(rnd_2->discriminator == 0x0c); /* '1100' */
-	bits->seq_scaled.bits = rnd_2->seq_num_scaled;
+	discriminator = rohc_bit_read(reader, 4);
+	assert(discriminator == 0x0c); /* '1100' */
+	bits->seq_scaled.bits = rohc_bit_read(reader, 4);
 	bits->seq_scaled.bits_nr = 4;
-	bits->msn.bits = rnd_2->msn;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = rnd_2->psh_flag;
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = rnd_2->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 3);
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(rnd_2_t);
 	*has_opts_list = false;
 
 	return true;
@@ -1331,50 +1582,46 @@ error:
  * @brief Parse the given rnd_3 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_rnd_3(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
-	const rnd_3_t *const rnd_3 = (rnd_3_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
-	/* check if the ROHC packet is large enough to parse rnd_3 */
-	if(rohc_length < sizeof(rnd_3_t))
+	/* check once if the ROHC packet is large enough to parse rnd_3 */
+	if(rohc_bit_reader_avail(reader) < sizeof(rnd_3_t))
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_3 (len = %zu)",
-		                 rohc_length);
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(rnd_3->discriminator == 0x00); /* '0' */
-	bits->ack.bits = (rnd_3->ack_num1 << 8) | rnd_3->ack_num2;
+	discriminator = rohc_bit_read(reader, 1);
+	assert(discriminator == 0x00); /* '0' */
+	bits->ack.bits = rohc_bit_read(reader, 15);
 	bits->ack.bits_nr = 15;
 	bits->ack.p = 8191;
-	bits->msn.bits = rnd_3->msn;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = rnd_3->psh_flag;
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = rnd_3->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 3);
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(rnd_3_t);
 	*has_opts_list = false;
 
 	return true;
@@ -1388,26 +1635,22 @@ error:
  * @brief Parse the given rnd_4 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_rnd_4(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
 	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
-	const rnd_4_t *const rnd_4 = (rnd_4_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
@@ -1421,26 +1664,26 @@ static bool d_tcp_parse_rnd_4(const struct rohc_decomp_ctxt *const context,
 		goto error;
 	}
 
-	/* check if the ROHC packet is large enough to parse rnd_4 */
-	if(rohc_length < sizeof(rnd_4_t))
+	/* check once if the ROHC packet is large enough to parse rnd_4 */
+	if(rohc_bit_reader_avail(reader) < sizeof(rnd_4_t))
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_4 (len = %zu)",
-		                 rohc_length);
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(rnd_4->discriminator == 0x0d); /* '1101' */
-	bits->ack_scaled.bits = rnd_4->ack_num_scaled;
+	discriminator = rohc_bit_read(reader, 4);
+	assert(discriminator == 0x0d); /* '1101' */
+	bits->ack_scaled.bits = rohc_bit_read(reader, 4);
 	bits->ack_scaled.bits_nr = 4;
-	bits->msn.bits = rnd_4->msn;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = rnd_4->psh_flag;
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = rnd_4->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 3);
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(rnd_4_t);
 	*has_opts_list = false;
 
 	return true;
@@ -1454,54 +1697,49 @@ error:
  * @brief Parse the given rnd_5 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_rnd_5(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
-	const rnd_5_t *const rnd_5 = (rnd_5_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
-	/* check if the ROHC packet is large enough to parse rnd_5 */
-	if(rohc_length < sizeof(rnd_5_t))
+	/* check once if the ROHC packet is large enough to parse rnd_5 */
+	if(rohc_bit_reader_avail(reader) < sizeof(rnd_5_t))
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_5 (len = %zu)",
-		                 rohc_length);
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(rnd_5->discriminator == 0x04); /* '100' */
-	bits->psh_flag_bits = rnd_5->psh_flag;
+	discriminator = rohc_bit_read(reader, 3);
+	assert(discriminator == 0x04); /* '100' */
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
-	bits->msn.bits = rnd_5->msn;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = rnd_5->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 3);
 	extr_crc->bits_nr = 3;
-	bits->seq.bits =
-		(rnd_5->seq_num1 << 9) | (rnd_5->seq_num2 << 1) | rnd_5->seq_num3;
+	bits->seq.bits = rohc_bit_read(reader, 14);
 	bits->seq.bits_nr = 14;
 	bits->seq.p = 8191;
-	bits->ack.bits = (rnd_5->ack_num1 << 8) | rnd_5->ack_num2;
+	bits->ack.bits = rohc_bit_read(reader, 15);
 	bits->ack.bits_nr = 15;
 	bits->ack.p = 8191;
 
-	*rohc_hdr_len = sizeof(rnd_5_t);
 	*has_opts_list = false;
 
 	return true;
@@ -1515,52 +1753,48 @@ error:
  * @brief Parse the given rnd_6 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_rnd_6(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
-	const rnd_6_t *const rnd_6 = (rnd_6_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
-	/* check if the ROHC packet is large enough to parse rnd_6 */
-	if(rohc_length < sizeof(rnd_6_t))
+	/* check once if the ROHC packet is large enough to parse rnd_6 */
+	if(rohc_bit_reader_avail(reader) < sizeof(rnd_6_t))
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_6 (len = %zu)",
-		                 rohc_length);
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(rnd_6->discriminator == 0x0a); /* '1010' */
+	discriminator = rohc_bit_read(reader, 4);
+	assert(discriminator == 0x0a); /* '1010' */
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = rnd_6->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 3);
 	extr_crc->bits_nr = 3;
-	bits->psh_flag_bits = rnd_6->psh_flag;
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
-	bits->ack.bits = rohc_ntoh16(rnd_6->ack_num);
+	bits->ack.bits = rohc_bit_read(reader, 16);
 	bits->ack.bits_nr = 16;
 	bits->ack.p = 16383;
-	bits->msn.bits = rnd_6->msn;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
-	bits->seq_scaled.bits = rnd_6->seq_num_scaled;
+	bits->seq_scaled.bits = rohc_bit_read(reader, 4);
 	bits->seq_scaled.bits_nr = 4;
 
-	*rohc_hdr_len = sizeof(rnd_6_t);
 	*has_opts_list = false;
 
 	return true;
@@ -1574,52 +1808,48 @@ error:
  * @brief Parse the given rnd_7 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_rnd_7(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
-	const rnd_7_t *const rnd_7 = (rnd_7_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
-	/* check if the ROHC packet is large enough to parse rnd_7 */
-	if(rohc_length < sizeof(rnd_7_t))
+	/* check once if the ROHC packet is large enough to parse rnd_7 */
+	if(rohc_bit_reader_avail(reader) < sizeof(rnd_7_t))
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_7 (len = %zu)",
-		                 rohc_length);
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(rnd_7->discriminator == 0x2f); /* '101111' */
-	bits->ack.bits = (rnd_7->ack_num1 << 16) | rohc_ntoh16(rnd_7->ack_num2);
+	discriminator = rohc_bit_read(reader, 6);
+	assert(discriminator == 0x2f); /* '101111' */
+	bits->ack.bits = rohc_bit_read(reader, 18);
 	bits->ack.bits_nr = 18;
 	bits->ack.p = 65535;
-	bits->window.bits = rohc_ntoh16(rnd_7->window);
+	bits->window.bits = rohc_bit_read(reader, 16);
 	bits->window.bits_nr = 16;
-	bits->msn.bits = rnd_7->msn;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = rnd_7->psh_flag;
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = rnd_7->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 3);
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(rnd_7_t);
 	*has_opts_list = false;
 
 	return true;
@@ -1633,64 +1863,59 @@ error:
  * @brief Parse the given rnd_8 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_rnd_8(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const rnd_8_t *const rnd_8 = (rnd_8_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state != ROHC_DECOMP_STATE_NC);
 
-	/* check if the ROHC packet is large enough to parse rnd_8 */
-	if(rohc_length < sizeof(rnd_8_t))
+	/* check once if the ROHC packet is large enough to parse rnd_8 */
+	if(rohc_bit_reader_avail(reader) < sizeof(rnd_8_t))
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for rnd_8 (len = %zu)",
-		                 rohc_length);
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(rnd_8->discriminator == 0x16); /* '10110' */
-	bits->rsf_flags_bits = rnd_8->rsf_flags;
+	discriminator = rohc_bit_read(reader, 5);
+	assert(discriminator == 0x16); /* '10110' */
+	bits->rsf_flags_bits = rohc_bit_read(reader, 2);
 	bits->rsf_flags_bits_nr = 2;
-	(*has_opts_list) = !!rnd_8->list_present;
+	(*has_opts_list) = !!rohc_bit_read(reader, 1);
 	extr_crc->type = ROHC_CRC_TYPE_7;
-	extr_crc->bits = rnd_8->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 7);
 	extr_crc->bits_nr = 7;
-	bits->msn.bits = (rnd_8->msn1 << 3) | rnd_8->msn2;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = rnd_8->psh_flag;
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
-	innermost_ip_bits->ttl_hl.bits = rnd_8->ttl_hopl;
+	innermost_ip_bits->ttl_hl.bits = rohc_bit_read(reader, 3);
 	innermost_ip_bits->ttl_hl.bits_nr = 3;
-	bits->ecn_used_bits = rnd_8->ecn_used;
+	bits->ecn_used_bits = rohc_bit_read(reader, 1);
 	bits->ecn_used_bits_nr = 1;
 	rohc_decomp_debug(context, "packet ecn_used = %d", bits->ecn_used_bits);
-	bits->seq.bits = rohc_ntoh16(rnd_8->seq_num);
+	bits->seq.bits = rohc_bit_read(reader, 16);
 	bits->seq.bits_nr = 16;
 	bits->seq.p = 65535;
-	bits->ack.bits = rohc_ntoh16(rnd_8->ack_num);
+	bits->ack.bits = rohc_bit_read(reader, 16);
 	bits->ack.bits_nr = 16;
 	bits->ack.p = 16383;
 
-	*rohc_hdr_len = sizeof(rnd_8_t);
-
 	return true;
 
 error:
@@ -1702,55 +1927,51 @@ error:
  * @brief Parse the given seq_1 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_seq_1(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_1_t *const seq_1 = (seq_1_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
-	/* check if the ROHC packet is large enough to parse seq_1 */
-	if(rohc_length < sizeof(seq_1_t))
+	/* check once if the ROHC packet is large enough to parse seq_1 */
+	if(rohc_bit_reader_avail(reader) < sizeof(seq_1_t))
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for seq_1 (len = %zu)",
-		                 rohc_length);
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(seq_1->discriminator == 0x0a); /* '1010' */
-	innermost_ip_bits->id.bits = seq_1->ip_id;
+	discriminator = rohc_bit_read(reader, 4);
+	assert(discriminator == 0x0a); /* '1010' */
+	innermost_ip_bits->id.bits = rohc_bit_read(reader, 4);
 	innermost_ip_bits->id.bits_nr = 4;
 	innermost_ip_bits->id.p = 3;
-	bits->seq.bits = rohc_ntoh16(seq_1->seq_num);
+	bits->seq.bits = rohc_bit_read(reader, 16);
 	bits->seq.bits_nr = 16;
 	bits->seq.p = 32767;
-	bits->msn.bits = seq_1->msn;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_1->psh_flag;
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = seq_1->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 3);
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(seq_1_t);
 	*has_opts_list = false;
 
 	return true;
@@ -1764,54 +1985,50 @@ error:
  * @brief Parse the given seq_2 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_seq_2(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_2_t *const seq_2 = (seq_2_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
-	/* check if the ROHC packet is large enough to parse seq_2 */
-	if(rohc_length < sizeof(seq_2_t))
+	/* check once if the ROHC packet is large enough to parse seq_2 */
+	if(rohc_bit_reader_avail(reader) < sizeof(seq_2_t))
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for seq_2 (len = %zu)",
-		                 rohc_length);
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(seq_2->discriminator == 0x1a); /* '11010' */
-	innermost_ip_bits->id.bits = (seq_2->ip_id1 << 4) | seq_2->ip_id2;
+	discriminator = rohc_bit_read(reader, 5);
+	assert(discriminator == 0x1a); /* '11010' */
+	innermost_ip_bits->id.bits = rohc_bit_read(reader, 7);
 	innermost_ip_bits->id.bits_nr = 7;
 	innermost_ip_bits->id.p = 3;
-	bits->seq_scaled.bits = seq_2->seq_num_scaled;
+	bits->seq_scaled.bits = rohc_bit_read(reader, 4);
 	bits->seq_scaled.bits_nr = 4;
-	bits->msn.bits = seq_2->msn;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_2->psh_flag;
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = seq_2->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 3);
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(seq_2_t);
 	*has_opts_list = false;
 
 	return true;
@@ -1825,55 +2042,51 @@ error:
  * @brief Parse the given seq_3 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_seq_3(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_3_t *const seq_3 = (seq_3_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
-	/* check if the ROHC packet is large enough to parse seq_3 */
-	if(rohc_length < sizeof(seq_3_t))
+	/* check once if the ROHC packet is large enough to parse seq_3 */
+	if(rohc_bit_reader_avail(reader) < sizeof(seq_3_t))
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for seq_3 (len = %zu)",
-		                 rohc_length);
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(seq_3->discriminator == 0x09); /* '1001' */
-	innermost_ip_bits->id.bits = seq_3->ip_id;
+	discriminator = rohc_bit_read(reader, 4);
+	assert(discriminator == 0x09); /* '1001' */
+	innermost_ip_bits->id.bits = rohc_bit_read(reader, 4);
 	innermost_ip_bits->id.bits_nr = 4;
 	innermost_ip_bits->id.p = 3;
-	bits->ack.bits = rohc_ntoh16(seq_3->ack_num);
+	bits->ack.bits = rohc_bit_read(reader, 16);
 	bits->ack.bits_nr = 16;
 	bits->ack.p = 16383;
-	bits->msn.bits = seq_3->msn;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_3->psh_flag;
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = seq_3->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 3);
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(seq_3_t);
 	*has_opts_list = false;
 
 	return true;
@@ -1887,28 +2100,24 @@ error:
  * @brief Parse the given seq_4 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_seq_4(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
 	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_4_t *const seq_4 = (seq_4_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
@@ -1922,29 +2131,29 @@ static bool d_tcp_parse_seq_4(const struct rohc_decomp_ctxt *const context,
 		goto error;
 	}
 
-	/* check if the ROHC packet is large enough to parse seq_4 */
-	if(rohc_length < sizeof(seq_4_t))
+	/* check once if the ROHC packet is large enough to parse seq_4 */
+	if(rohc_bit_reader_avail(reader) < sizeof(seq_4_t))
 	{
-		rohc_decomp_warn(context, "ROHC packet too small for seq_4 len = %zu)",
-		                 rohc_length);
+		rohc_decomp_warn(context, "ROHC packet too small for seq_4 (len = %zu)",
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(seq_4->discriminator == 0x00); /* '0' */
-	bits->ack_scaled.bits = seq_4->ack_num_scaled;
+	discriminator = rohc_bit_read(reader, 1);
+	assert(discriminator == 0x00); /* '0' */
+	bits->ack_scaled.bits = rohc_bit_read(reader, 4);
 	bits->ack_scaled.bits_nr = 4;
-	innermost_ip_bits->id.bits = seq_4->ip_id;
+	innermost_ip_bits->id.bits = rohc_bit_read(reader, 3);
 	innermost_ip_bits->id.bits_nr = 3;
 	innermost_ip_bits->id.p = 1;
-	bits->msn.bits = seq_4->msn;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_4->psh_flag;
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = seq_4->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 3);
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(seq_4_t);
 	*has_opts_list = false;
 
 	return true;
@@ -1958,58 +2167,54 @@ error:
  * @brief Parse the given seq_5 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_seq_5(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_5_t *const seq_5 = (seq_5_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
-	/* check if the ROHC packet is large enough to parse seq_5 */
-	if(rohc_length < sizeof(seq_5_t))
+	/* check once if the ROHC packet is large enough to parse seq_5 */
+	if(rohc_bit_reader_avail(reader) < sizeof(seq_5_t))
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for seq_5 (len = %zu)",
-		                 rohc_length);
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(seq_5->discriminator == 0x08); /* '1000' */
-	innermost_ip_bits->id.bits = seq_5->ip_id;
+	discriminator = rohc_bit_read(reader, 4);
+	assert(discriminator == 0x08); /* '1000' */
+	innermost_ip_bits->id.bits = rohc_bit_read(reader, 4);
 	innermost_ip_bits->id.bits_nr = 4;
 	innermost_ip_bits->id.p = 3;
-	bits->ack.bits = rohc_ntoh16(seq_5->ack_num);
+	bits->ack.bits = rohc_bit_read(reader, 16);
 	bits->ack.bits_nr = 16;
 	bits->ack.p = 16383;
-	bits->seq.bits = rohc_ntoh16(seq_5->seq_num);
+	bits->seq.bits = rohc_bit_read(reader, 16);
 	bits->seq.bits_nr = 16;
 	bits->seq.p = 32767;
-	bits->msn.bits = seq_5->msn;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_5->psh_flag;
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = seq_5->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 3);
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(seq_5_t);
 	*has_opts_list = false;
 
 	return true;
@@ -2023,57 +2228,53 @@ error:
  * @brief Parse the given seq_6 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_seq_6(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_6_t *const seq_6 = (seq_6_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
-	/* check if the ROHC packet is large enough to parse seq_6 */
-	if(rohc_length < sizeof(seq_6_t))
+	/* check once if the ROHC packet is large enough to parse seq_6 */
+	if(rohc_bit_reader_avail(reader) < sizeof(seq_6_t))
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for seq_6 (len = %zu)",
-		                 rohc_length);
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(seq_6->discriminator == 0x1b); /* '11011' */
-	bits->seq_scaled.bits = (seq_6->seq_num_scaled1 << 1) | seq_6->seq_num_scaled2;
+	discriminator = rohc_bit_read(reader, 5);
+	assert(discriminator == 0x1b); /* '11011' */
+	bits->seq_scaled.bits = rohc_bit_read(reader, 4);
 	bits->seq_scaled.bits_nr = 4;
-	innermost_ip_bits->id.bits = seq_6->ip_id;
+	innermost_ip_bits->id.bits = rohc_bit_read(reader, 7);
 	innermost_ip_bits->id.bits_nr = 7;
 	innermost_ip_bits->id.p = 3;
-	bits->ack.bits = rohc_ntoh16(seq_6->ack_num);
+	bits->ack.bits = rohc_bit_read(reader, 16);
 	bits->ack.bits_nr = 16;
 	bits->ack.p = 16383;
-	bits->msn.bits = seq_6->msn;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_6->psh_flag;
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = seq_6->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 3);
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(seq_6_t);
 	*has_opts_list = false;
 
 	return true;
@@ -2087,59 +2288,54 @@ error:
  * @brief Parse the given seq_7 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_seq_7(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_7_t *const seq_7 = (seq_7_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state == ROHC_DECOMP_STATE_FC);
 
-	/* check if the ROHC packet is large enough to parse seq_7 */
-	if(rohc_length < sizeof(seq_7_t))
+	/* check once if the ROHC packet is large enough to parse seq_7 */
+	if(rohc_bit_reader_avail(reader) < sizeof(seq_7_t))
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for seq_7 (len = %zu)",
-		                 rohc_length);
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(seq_7->discriminator == 0x0c); /* '1100' */
-	bits->window.bits =
-		(seq_7->window1 << 11) | (seq_7->window2 << 3) | seq_7->window3;
+	discriminator = rohc_bit_read(reader, 4);
+	assert(discriminator == 0x0c); /* '1100' */
+	bits->window.bits = rohc_bit_read(reader, 15);
 	bits->window.bits_nr = 15;
 	bits->window.p = ROHC_LSB_SHIFT_TCP_WINDOW;
-	innermost_ip_bits->id.bits = seq_7->ip_id;
+	innermost_ip_bits->id.bits = rohc_bit_read(reader, 5);
 	innermost_ip_bits->id.bits_nr = 5;
 	innermost_ip_bits->id.p = 3;
-	bits->ack.bits = rohc_ntoh16(seq_7->ack_num);
+	bits->ack.bits = rohc_bit_read(reader, 16);
 	bits->ack.bits_nr = 16;
 	bits->ack.p = 32767;
-	bits->msn.bits = seq_7->msn;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_7->psh_flag;
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
 	extr_crc->type = ROHC_CRC_TYPE_3;
-	extr_crc->bits = seq_7->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 3);
 	extr_crc->bits_nr = 3;
 
-	*rohc_hdr_len = sizeof(seq_7_t);
 	*has_opts_list = false;
 
 	return true;
@@ -2153,67 +2349,62 @@ error:
  * @brief Parse the given seq_8 packet for the TCP profile
  *
  * @param context            The decompression context
- * @param rohc_packet        The ROHC packet to decode
- * @param rohc_length        The length of the ROHC packet
+ * @param reader             The bit reader on the ROHC packet
  * @param[out] extr_crc      The CRC bits extracted from the ROHC header
  * @param[out] bits          The bits extracted from the CO packet
- * @param[out] rohc_hdr_len  The length of the ROHC header (in bytes)
  * @param[out] has_opts_list Whether the list TCP options is present after
  *                           the CO packet
  * @return                   true if parsing was successful,
  *                           false if packet was malformed
  */
 static bool d_tcp_parse_seq_8(const struct rohc_decomp_ctxt *const context,
-                              const uint8_t *const rohc_packet,
-                              const size_t rohc_length,
+                              struct rohc_bit_reader *const reader,
                               struct rohc_decomp_crc *const extr_crc,
                               struct rohc_tcp_extr_bits *const bits,
-                              size_t *const rohc_hdr_len,
                               bool *const has_opts_list)
 {
 	struct rohc_tcp_extr_ip_bits *const innermost_ip_bits =
 		&(bits->ip[bits->ip_nr - 1]);
-	const seq_8_t *const seq_8 = (seq_8_t *) rohc_packet;
+	uint8_t discriminator __attribute__((unused));
 
 	/* check packet usage */
 	assert(context->state != ROHC_DECOMP_STATE_NC);
 
-	/* check if the ROHC packet is large enough to parse seq_8 */
-	if(rohc_length < sizeof(seq_8_t))
+	/* check once if the ROHC packet is large enough to parse seq_8 */
+	if(rohc_bit_reader_avail(reader) < sizeof(seq_8_t))
 	{
 		rohc_decomp_warn(context, "ROHC packet too small for seq_8 (len = %zu)",
-		                 rohc_length);
+		                 rohc_bit_reader_avail(reader));
 		goto error;
 	}
 
-	assert(seq_8->discriminator == 0x0b); /* '1011' */
-	innermost_ip_bits->id.bits = seq_8->ip_id;
+	discriminator = rohc_bit_read(reader, 4);
+	assert(discriminator == 0x0b); /* '1011' */
+	innermost_ip_bits->id.bits = rohc_bit_read(reader, 4);
 	innermost_ip_bits->id.bits_nr = 4;
 	innermost_ip_bits->id.p = 3;
-	(*has_opts_list) = !!seq_8->list_present;
+	(*has_opts_list) = !!rohc_bit_read(reader, 1);
 	extr_crc->type = ROHC_CRC_TYPE_7;
-	extr_crc->bits = seq_8->header_crc;
+	extr_crc->bits = rohc_bit_read(reader, 7);
 	extr_crc->bits_nr = 7;
-	bits->msn.bits = seq_8->msn;
+	bits->msn.bits = rohc_bit_read(reader, 4);
 	bits->msn.bits_nr = 4;
-	bits->psh_flag_bits = seq_8->psh_flag;
+	bits->psh_flag_bits = rohc_bit_read(reader, 1);
 	bits->psh_flag_bits_nr = 1;
-	innermost_ip_bits->ttl_hl.bits = seq_8->ttl_hopl;
+	innermost_ip_bits->ttl_hl.bits = rohc_bit_read(reader, 3);
 	innermost_ip_bits->ttl_hl.bits_nr = 3;
-	bits->ecn_used_bits = seq_8->ecn_used;
+	bits->ecn_used_bits = rohc_bit_read(reader, 1);
 	bits->ecn_used_bits_nr = 1;
 	rohc_decomp_debug(context, "packet ecn_used = %d", bits->ecn_used_bits);
-	bits->ack.bits = (seq_8->ack_num1 << 8) | seq_8->ack_num2;
+	bits->ack.bits = rohc_bit_read(reader, 15);
 	bits->ack.bits_nr = 15;
 	bits->ack.p = 8191;
-	bits->rsf_flags_bits = seq_8->rsf_flags;
+	bits->rsf_flags_bits = rohc_bit_read(reader, 2);
 	bits->rsf_flags_bits_nr = 2;
-	bits->seq.bits = (seq_8->seq_num1 << 8) | seq_8->seq_num2;
+	bits->seq.bits = rohc_bit_read(reader, 14);
 	bits->seq.bits_nr = 14;
 	bits->seq.p = 8191;
 
-	*rohc_hdr_len = sizeof(seq_8_t);
-
 	return true;
 
 error:
@@ -2490,8 +2681,17 @@ static void d_tcp_reset_extr_bits(const struct rohc_decomp_ctxt *const context,
 	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
 	size_t i;
 
-	/* set every bits and sizes to 0 */
-	memset(bits, 0, sizeof(struct rohc_tcp_extr_bits));
+	/* set every bits and sizes to 0: for IP headers, only reset the fixed part,
+	 * the IP extension headers beyond opts_nr are never read; for TCP options,
+	 * the bits of every option are reset by the parsing of the compressed list
+	 * or copied from context if the list is absent */
+	for(i = 0; i < ROHC_TCP_MAX_IP_HDRS; i++)
+	{
+		memset(&bits->ip[i], 0, offsetof(struct rohc_tcp_extr_ip_bits, opts));
+	}
+	memset(&bits->ip_nr, 0,
+	       offsetof(struct rohc_tcp_extr_bits, tcp_opts) -
+	       offsetof(struct rohc_tcp_extr_bits, ip_nr));
 
 	/* if context handled at least one packet, init the list of IP headers */
 	if(context->num_recv_packets >= 1)
@@ -2513,6 +2713,7 @@ static void d_tcp_reset_extr_bits(const struct rohc_decomp_ctxt *const context,
 					bits->ip[i].opts[j].proto = tcp_context->ip_contexts[i].opts[j].proto;
 					bits->ip[i].opts[j].nh_proto =
 						tcp_context->ip_contexts[i].opts[j].nh_proto;
+					bits->ip[i].opts[j].generic.data_len = 0;
 				}
 			}
 		}
@@ -2534,8 +2735,11 @@ static void d_tcp_reset_extr_bits(const struct rohc_decomp_ctxt *const context,
 
 	/* no parsed TCP options at the beginning */
 	bits->tcp_opts.nr = 0;
-	memset(bits->tcp_opts.bits, 0,
-	       (MAX_TCP_OPTION_INDEX + 1) * sizeof(struct d_tcp_opt_ctxt));
+	bits->tcp_opts.is_list_present = false;
+	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
+	{
+		bits->tcp_opts.bits[i].used = false;
+	}
 	for(i = 0; i < ROHC_TCP_OPTS_MAX; i++)
 	{
 		bits->tcp_opts.expected_dynamic[i] = false;
@@ -2558,7 +2762,8 @@ static bool d_tcp_decode_bits(const struct rohc_decomp_ctxt *const context,
                               const size_t payload_len,
                               struct rohc_tcp_decoded_values *const decoded)
 {
-	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
+	struct d_tcp_context *const tcp_context = context->persist_ctxt;
+	size_t ip_hdr_nr;
 
 	/* decode MSN */
 	if(bits->msn.bits_nr == 16)
@@ -2591,6 +2796,13 @@ static bool d_tcp_decode_bits(const struct rohc_decomp_ctxt *const context,
 	decoded->ttl_dyn_chain_flag = bits->ttl_dyn_chain_flag;
 	decoded->ttl_irreg_chain_flag = bits->ttl_irreg_chain_flag;
 
+	/* CRC-7 of the IR-CR packet, checked once headers are built */
+	decoded->replicate_crc = bits->replicate_crc;
+
+	/* static chain of the IR packet, kept in context once it is updated */
+	decoded->static_chain = bits->static_chain;
+	decoded->static_chain_len = bits->static_chain_len;
+
 	/* decode IP headers */
 	if(!d_tcp_decode_bits_ip_hdrs(context, bits, decoded))
 	{
@@ -2598,6 +2810,26 @@ static bool d_tcp_decode_bits(const struct rohc_decomp_ctxt *const context,
 		goto error;
 	}
 
+	/* the contexts of the IPv6 extension headers are allocated with the first
+	 * extension header, so that the context may be updated later */
+	for(ip_hdr_nr = 0; ip_hdr_nr < decoded->ip_nr; ip_hdr_nr++)
+	{
+		ip_context_t *const ip_context = &(tcp_context->ip_contexts[ip_hdr_nr]);
+
+		if(decoded->ip[ip_hdr_nr].opts_nr > 0 && ip_context->opts == NULL)
+		{
+			ip_context->opts =
+				rohc_slab_alloc(context->decompressor->ctxt_slab,
+				                sizeof(ip_option_context_t) * ROHC_TCP_MAX_IP_EXT_HDRS);
+			if(ip_context->opts == NULL)
+			{
+				rohc_decomp_warn(context, "no memory for the contexts of the IPv6 "
+				                 "extension headers");
+				goto error;
+			}
+		}
+	}
+
 	/* decode TCP header */
 	if(!d_tcp_decode_bits_tcp_hdr(context, bits, payload_len, decoded))
 	{
@@ -2627,6 +2859,10 @@ static bool d_tcp_decode_bits_ip_hdrs(const struct rohc_decomp_ctxt *const conte
 	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
 	size_t ip_hdr_nr;
 
+	/* the addresses interned for a packet that did not update the context
+	 * are not needed anymore */
+	d_tcp_put_pending_addrs(tcp_context, decoded);
+
 	/* decode IP headers */
 	assert(bits->ip_nr > 0);
 	for(ip_hdr_nr = 0; ip_hdr_nr < bits->ip_nr; ip_hdr_nr++)
@@ -2654,6 +2890,35 @@ error:
 }
 
 
+/**
+ * @brief Release the IPv6 addresses interned for the last decoded packet
+ *
+ * The addresses interned while decoding one packet are referenced by the
+ * context only if the packet updated it. The other ones are released.
+ *
+ * @param tcp_context   The persistent decompression context
+ * @param[in,out] decoded  The values decoded from the last packet
+ */
+static void d_tcp_put_pending_addrs(const struct d_tcp_context *const tcp_context,
+                                    struct rohc_tcp_decoded_values *const decoded)
+{
+	size_t i;
+
+	for(i = 0; i < ROHC_TCP_MAX_IP_HDRS; i++)
+	{
+		const ip_context_t *const ip_context = &(tcp_context->ip_contexts[i]);
+		const struct ipv6_addr *const addrs = decoded->ip[i].addrs;
+
+		if(addrs != NULL &&
+		   (ip_context->version != IPV6 || ip_context->ctxt.v6.addrs != addrs))
+		{
+			rohc_intern_put(tcp_context->static_store, addrs);
+		}
+		decoded->ip[i].addrs = NULL;
+	}
+}
+
+
 /**
  * @brief Decode values for one IP header from extracted bits
  *
@@ -2874,11 +3139,16 @@ static bool d_tcp_decode_bits_ip_hdr(const struct rohc_decomp_ctxt *const contex
 		memcpy(ip_decoded->saddr, &ip_context->ctxt.v4.src_addr, 4);
 		rohc_decomp_debug(context, "  4-byte source address (context)");
 	}
-	else /* IPv6 */
+	else if(ip_context->version == IPV6 && ip_context->ctxt.v6.addrs != NULL)
 	{
-		memcpy(ip_decoded->saddr, ip_context->ctxt.v6.src_addr, 16);
+		memcpy(ip_decoded->saddr, &ip_context->ctxt.v6.addrs[0], 16);
 		rohc_decomp_debug(context, "  16-byte source address (context)");
 	}
+	else
+	{
+		rohc_decomp_warn(context, "no IPv6 source address in context");
+		goto error;
+	}
 
 	/* destination address */
 	if(ip_bits->daddr_nr > 0)
@@ -2892,11 +3162,38 @@ static bool d_tcp_decode_bits_ip_hdr(const struct rohc_decomp_ctxt *const contex
 		memcpy(ip_decoded->daddr, &ip_context->ctxt.v4.dst_addr, 4);
 		rohc_decomp_debug(context, "  4-byte destination address (context)");
 	}
-	else /* IPv6 */
+	else if(ip_context->version == IPV6 && ip_context->ctxt.v6.addrs != NULL)
 	{
-		memcpy(ip_decoded->daddr, ip_context->ctxt.v6.dest_addr, 16);
+		memcpy(ip_decoded->daddr, &ip_context->ctxt.v6.addrs[1], 16);
 		rohc_decomp_debug(context, "  16-byte destination address (context)");
 	}
+	else
+	{
+		rohc_decomp_warn(context, "no IPv6 destination address in context");
+		goto error;
+	}
+
+	/* the IPv6 addresses are interned in the store shared by the contexts,
+	 * the context keeps its reference if they did not change */
+	if(ip_decoded->version == IPV6)
+	{
+		struct ipv6_addr addrs[2];
+
+		memcpy(&addrs[0], ip_decoded->saddr, sizeof(struct ipv6_addr));
+		memcpy(&addrs[1], ip_decoded->daddr, sizeof(struct ipv6_addr));
+		if(ip_context->version != IPV6 ||
+		   ip_context->ctxt.v6.addrs == NULL ||
+		   memcmp(ip_context->ctxt.v6.addrs, addrs, sizeof(addrs)) != 0)
+		{
+			ip_decoded->addrs =
+				rohc_intern_get(tcp_context->static_store, addrs, sizeof(addrs));
+			if(ip_decoded->addrs == NULL)
+			{
+				rohc_decomp_warn(context, "failed to intern the IPv6 addresses");
+				goto error;
+			}
+		}
+	}
 
 	/* extension headers */
 	assert(ip_bits->opts_nr <= ROHC_TCP_MAX_IP_EXT_HDRS);
@@ -2916,7 +3213,8 @@ static bool d_tcp_decode_bits_ip_hdr(const struct rohc_decomp_ctxt *const contex
 					if(ip_bits->opts[ext_pos].generic.data_len > 0)
 					{
 						memcpy(&(ip_decoded->opts[ext_pos]), &(ip_bits->opts[ext_pos]),
-						       sizeof(ip_option_context_t));
+						       offsetof(ip_option_context_t, generic.data) +
+						       ip_bits->opts[ext_pos].generic.data_len);
 					}
 					break;
 				default:
@@ -3368,7 +3666,7 @@ static bool d_tcp_decode_bits_tcp_opts(const struct rohc_decomp_ctxt *const cont
 	rohc_decomp_debug(context, "decode TCP options");
 
 	/* copy the informations collected on TCP options */
-	memcpy(&decoded->tcp_opts, &bits->tcp_opts, sizeof(struct d_tcp_opts_ctxt));
+	d_tcp_copy_tcp_opts(&decoded->tcp_opts, &bits->tcp_opts);
 
 	for(tcp_opt_id = 0; tcp_opt_id < decoded->tcp_opts.nr; tcp_opt_id++)
 	{
@@ -3993,11 +4291,16 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
 	/* unhide the IP headers */
 	rohc_buf_push(uncomp_hdrs, ip_hdrs_len);
 
-	/* compute CRC on uncompressed headers if asked */
-	if(extr_crc->type != ROHC_CRC_TYPE_NONE)
+	/* compute CRC on uncompressed headers if asked, the IR-CR packet carries
+	 * a CRC-7 besides the CRC-8 on its header */
+	if(extr_crc->type != ROHC_CRC_TYPE_NONE || packet_type == ROHC_PACKET_IR_CR)
 	{
-		const bool crc_ok = d_tcp_check_uncomp_crc(decomp, context, uncomp_hdrs,
-		                                           extr_crc->type, extr_crc->bits);
+		const bool crc_ok =
+			(packet_type == ROHC_PACKET_IR_CR ?
+			 d_tcp_check_uncomp_crc(decomp, context, uncomp_hdrs,
+			                        ROHC_CRC_TYPE_7, decoded->replicate_crc) :
+			 d_tcp_check_uncomp_crc(decomp, context, uncomp_hdrs,
+			                        extr_crc->type, extr_crc->bits));
 		if(!crc_ok)
 		{
 			rohc_decomp_warn(context, "CRC detected a decompression failure for "
@@ -4005,7 +4308,7 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
 			                 rohc_get_packet_descr(packet_type),
 			                 rohc_decomp_get_state_descr(context->state),
 			                 rohc_get_mode_descr(context->mode));
-			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			if((d_features(decomp) & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 			{
 				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
 				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
@@ -4015,7 +4318,7 @@ static rohc_status_t d_tcp_build_hdrs(const struct rohc_decomp *const decomp,
 		}
 	}
 
-	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+	if((d_features(decomp) & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 	{
 		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
 		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
@@ -4041,7 +4344,7 @@ error_output_too_small:
  * @param crc_packet   The CRC extracted from the ROHC header
  * @return             true if the CRC is correct, false otherwise
  */
-static bool d_tcp_check_uncomp_crc(const struct rohc_decomp *const decomp,
+static bool d_tcp_check_uncomp_crc(const struct rohc_decomp *const decomp __attribute__((unused)),
                                    const struct rohc_decomp_ctxt *const context,
                                    struct rohc_buf *const uncomp_hdrs,
                                    const rohc_crc_type_t crc_type,
@@ -4055,11 +4358,11 @@ static bool d_tcp_check_uncomp_crc(const struct rohc_decomp *const decomp,
 	{
 		case ROHC_CRC_TYPE_3:
 			crc_computed = CRC_INIT_3;
-			crc_table = decomp->crc_table_3;
+			crc_table = rohc_crc_table_3;
 			break;
 		case ROHC_CRC_TYPE_7:
 			crc_computed = CRC_INIT_7;
-			crc_table = decomp->crc_table_7;
+			crc_table = rohc_crc_table_7;
 			break;
 		case ROHC_CRC_TYPE_8:
 			rohc_decomp_warn(context, "unexpected CRC type %d", crc_type);
@@ -4143,6 +4446,37 @@ static void d_tcp_update_ctxt(struct rohc_decomp_ctxt *const context,
 	rohc_lsb_set_ref(tcp_context->msn_lsb_ctxt, msn, false);
 	rohc_decomp_debug(context, "MSN 0x%04x / %u is the new reference", msn, msn);
 
+	/* keep the static chain of the IR packet to recognize the next IR
+	 * packets that do not change it */
+	if(decoded->static_chain != NULL)
+	{
+		/* the static chain is parsed again if no memory is available to keep
+		 * it in context */
+		if(decoded->static_chain_len > 0 &&
+		   decoded->static_chain_len <= ROHC_TCP_STATIC_CHAIN_MAX_LEN &&
+		   tcp_context->static_chain == NULL)
+		{
+			tcp_context->static_chain =
+				rohc_slab_alloc(context->decompressor->ctxt_slab,
+				                sizeof(struct d_tcp_static_chain));
+		}
+		if(tcp_context->static_chain == NULL)
+		{
+			/* nothing to keep or no memory */
+		}
+		else if(decoded->static_chain_len > 0 &&
+		        decoded->static_chain_len <= ROHC_TCP_STATIC_CHAIN_MAX_LEN)
+		{
+			memcpy(tcp_context->static_chain->data, decoded->static_chain,
+			       decoded->static_chain_len);
+			tcp_context->static_chain->len = decoded->static_chain_len;
+		}
+		else
+		{
+			tcp_context->static_chain->len = 0;
+		}
+	}
+
 	/* update context for IP headers */
 	assert(decoded->ip_nr > 0);
 	for(ip_hdr_nr = 0; ip_hdr_nr < decoded->ip_nr; ip_hdr_nr++)
@@ -4155,6 +4489,15 @@ static void d_tcp_update_ctxt(struct rohc_decomp_ctxt *const context,
 		rohc_decomp_debug(context, "update context for IPv%u header #%zu",
 		                  ip_decoded->version, ip_hdr_nr + 1);
 
+		/* release the IPv6 addresses that are replaced, before the IPv4 fields
+		 * of the union overwrite them */
+		if(ip_context->version == IPV6 &&
+		   (ip_decoded->version != IPV6 || ip_decoded->addrs != NULL))
+		{
+			rohc_intern_put(tcp_context->static_store, ip_context->ctxt.v6.addrs);
+			ip_context->ctxt.v6.addrs = NULL;
+		}
+
 		ip_context->version = ip_decoded->version;
 		ip_context->ctxt.vx.version = ip_decoded->version;
 		ip_context->ctxt.vx.dscp = ip_decoded->dscp;
@@ -4211,10 +4554,15 @@ static void d_tcp_update_ctxt(struct rohc_decomp_ctxt *const context,
 
 			assert((ip_decoded->flowid & 0xfffff) == ip_decoded->flowid);
 			ip_context->ctxt.v6.flow_label = ip_decoded->flowid;
-			memcpy(&ip_context->ctxt.v6.src_addr, ip_decoded->saddr, 16);
-			memcpy(&ip_context->ctxt.v6.dest_addr, ip_decoded->daddr, 16);
+			if(ip_decoded->addrs != NULL)
+			{
+				/* the context takes the reference on the new addresses */
+				ip_context->ctxt.v6.addrs = ip_decoded->addrs;
+			}
 
-			/* remember the extension headers */
+			/* remember the extension headers, their contexts were allocated
+			 * while decoding */
+			assert(ip_decoded->opts_nr == 0 || ip_context->opts != NULL);
 			ip_context->opts_nr = ip_decoded->opts_nr;
 			ip_context->opts_len = ip_decoded->opts_len;
 			for(ext_pos = 0; ext_pos < ip_context->opts_nr; ext_pos++)
@@ -4227,10 +4575,22 @@ static void d_tcp_update_ctxt(struct rohc_decomp_ctxt *const context,
 				                  rohc_get_ip_proto_descr(ext_proto), ext_proto,
 				                  ext_pos + 1);
 				memcpy(&(ip_context->opts[ext_pos]), &(ip_decoded->opts[ext_pos]),
-				       sizeof(ip_option_context_t));
+				       offsetof(ip_option_context_t, generic.data) +
+				       ip_decoded->opts[ext_pos].generic.data_len);
 			}
 		}
 	}
+	for(ip_hdr_nr = decoded->ip_nr; ip_hdr_nr < tcp_context->ip_contexts_nr;
+	    ip_hdr_nr++)
+	{
+		ip_context_t *const ip_context = &(tcp_context->ip_contexts[ip_hdr_nr]);
+
+		if(ip_context->version == IPV6)
+		{
+			rohc_intern_put(tcp_context->static_store, ip_context->ctxt.v6.addrs);
+			ip_context->ctxt.v6.addrs = NULL;
+		}
+	}
 	tcp_context->ip_contexts_nr = decoded->ip_nr;
 
 	/* TCP source & destination ports */
@@ -4328,6 +4688,9 @@ static void d_tcp_update_ctxt(struct rohc_decomp_ctxt *const context,
 			       sizeof(struct d_tcp_opt_sack));
 		}
 	}
+
+	/* record the uncompressed TCP options for next packets */
+	d_tcp_cache_tcp_opts(context, decoded);
 }
 
 
@@ -4349,6 +4712,48 @@ static uint32_t d_tcp_get_msn(const struct rohc_decomp_ctxt *const context)
 }
 
 
+/**
+ * @brief Prefetch the LSB decoding contexts used by every packet
+ *
+ * Called by the decompressor when it decompresses a burst of packets, before
+ * the next packet is decompressed in the context.
+ *
+ * @param context  The decompression context
+ */
+static void d_tcp_prefetch(const struct rohc_decomp_ctxt *const context)
+{
+	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
+
+	__builtin_prefetch(tcp_context->msn_lsb_ctxt);
+	__builtin_prefetch(tcp_context->ip_id_lsb_ctxt);
+	__builtin_prefetch(tcp_context->seq_lsb_ctxt);
+	__builtin_prefetch(tcp_context->ack_lsb_ctxt);
+}
+
+
+/**
+ * @brief Get the maximum length one TCP context takes in a memory block
+ *
+ * @return  The maximum number of bytes of the memory block the
+ *          profile-specific part of the context takes
+ */
+static size_t d_tcp_mem_max(void)
+{
+	/* the profile part, its LSB decoding contexts, the volatile part, the
+	 * static chain kept in context, then the contexts of the IPv6 extension
+	 * headers and the addresses of every IPv6 header if they are not shared */
+	return (rohc_slab_block_mem_max(sizeof(struct d_tcp_context)) +
+	        10 * rohc_lsb_mem_max() +
+	        rohc_slab_block_mem_max(sizeof(struct rohc_tcp_extr_bits)) +
+	        rohc_slab_block_mem_max(sizeof(struct rohc_tcp_decoded_values)) +
+	        rohc_slab_block_mem_max(sizeof(struct d_tcp_static_chain)) +
+	        ROHC_TCP_MAX_IP_HDRS *
+	        (rohc_slab_block_mem_max(sizeof(ip_option_context_t) *
+	                                 ROHC_TCP_MAX_IP_EXT_HDRS) +
+	         rohc_intern_entry_mem_max(sizeof(struct ipv6_addr) * 2)));
+}
+
+
 /**
  * @brief Define the decompression part of the TCP profile as described
  *        in the RFC 3095.
@@ -4365,6 +4770,9 @@ const struct rohc_decomp_profile d_tcp_profile =
 	.build_hdrs      = (rohc_decomp_build_hdrs_t) d_tcp_build_hdrs,
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) d_tcp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) d_tcp_attempt_repair,
-	.get_sn          = d_tcp_get_msn
+	.get_sn          = d_tcp_get_msn,
+	.decode_fast     = NULL,
+	.prefetch        = d_tcp_prefetch,
+	.get_mem_max     = d_tcp_mem_max,
 };
 
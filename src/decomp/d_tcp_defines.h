@@ -31,6 +31,7 @@
 
 #include "ip.h"
 #include "interval.h"
+#include "rohc_intern.h"
 #include "protocols/tcp.h"
 #include "schemes/decomp_wlsb.h"
 #include "schemes/tcp_ts.h"
@@ -173,8 +174,9 @@ typedef struct __attribute__((packed)) ipv6_context
 
 	uint32_t flow_label:20; /**< IPv6 Flow Label */
 
-	uint32_t src_addr[4];
-	uint32_t dest_addr[4];
+	/** The source then destination addresses, shared with the other contexts
+	 *  through the static store of the decompressor */
+	const struct ipv6_addr *addrs;
 
 } ipv6_context_t;
 
@@ -194,7 +196,9 @@ typedef struct
 
 	size_t opts_nr;
 	size_t opts_len;
-	ip_option_context_t opts[ROHC_TCP_MAX_IP_EXT_HDRS];
+	/** The contexts of the IPv6 extension headers, allocated with the first
+	 *  extension header only, NULL before */
+	ip_option_context_t *opts;
 
 } ip_context_t;
 
@@ -259,35 +263,102 @@ struct d_tcp_opts_ctxt
 	/** The TCP options that were found or not */
 	bool found[ROHC_TCP_OPTS_MAX];
 
+	/** Whether the compressed list of TCP options was present in the packet */
+	bool is_list_present;
+
 	/** The bits of TCP options extracted from the dynamic chain, the tail of
 	 * co_common/seq_8/rnd_8 packets, or the irregular chain */
 	struct d_tcp_opt_ctxt bits[MAX_TCP_OPTION_INDEX + 1];
 };
 
 
-/** Define the TCP part of the decompression profile context */
+/** The maximum length (in bytes) of the TCP options */
+#define ROHC_TCP_OPTS_MAX_LEN  40U
+
+/** The maximum length (in bytes) of the static chain kept in context: two
+ *  IPv6 headers and the TCP ports */
+#define ROHC_TCP_STATIC_CHAIN_MAX_LEN  80U
+
+
+/**
+ * @brief The uncompressed TCP options built for the last packet
+ *
+ * As long as the compressed list of TCP options is not transmitted, only the
+ * TS and SACK options may change from one packet to another, so the TCP
+ * options of the last packet are copied then patched.
+ */
+struct d_tcp_opts_cache
+{
+	/** Whether the cache was built or not */
+	bool is_valid;
+
+	/** The number of options in the cached list of TCP options */
+	size_t nr;
+	/** The structure of the cached list of TCP options */
+	uint8_t structure[ROHC_TCP_OPTS_MAX];
+
+	/** Whether the TS option is present in the cached list */
+	bool ts_present;
+	/** The offset (in bytes) of the TS option in the cached list */
+	size_t ts_offset;
+	/** Whether the SACK option is present in the cached list */
+	bool sack_present;
+	/** The offset (in bytes) of the SACK option in the cached list */
+	size_t sack_offset;
+	/** The number of SACK blocks in the cached SACK option */
+	size_t sack_blocks_nr;
+
+	/** The length (in bytes) of the cached TCP options */
+	size_t len;
+	/** The cached TCP options */
+	uint8_t data[ROHC_TCP_OPTS_MAX_LEN];
+};
+
+
+/** The static chain of the last IR packet, compared with the static chain
+ *  of the next IR packets */
+struct d_tcp_static_chain
+{
+	/** The static chain */
+	uint8_t data[ROHC_TCP_STATIC_CHAIN_MAX_LEN];
+	/** The length of the static chain, 0 if none */
+	size_t len;
+};
+
+
+/**
+ * @brief Define the TCP part of the decompression profile context
+ *
+ * The fields read or written for every packet come first, so that they
+ * share the first cache lines of the context. The contexts of the IPv6
+ * extension headers and the static chain of the last IR packet are cold:
+ * they are allocated on first use only.
+ */
 struct d_tcp_context
 {
 	/** The LSB decoding context of MSN */
 	struct rohc_lsb_decode *msn_lsb_ctxt;
-
 	/** The LSB decoding context of innermost IP-ID */
 	struct rohc_lsb_decode *ip_id_lsb_ctxt;
 	/** The LSB decoding context of innermost TTL/HL */
 	struct rohc_lsb_decode *ttl_hl_lsb_ctxt;
-
-	/* TCP static part */
-	uint16_t tcp_src_port; /**< The TCP source port */
-	uint16_t tcp_dst_port; /**< The TCP dest port */
-
-	uint32_t seq_num_residue;
 	struct rohc_lsb_decode *seq_lsb_ctxt;
 	struct rohc_lsb_decode *seq_scaled_lsb_ctxt;
+	struct rohc_lsb_decode *ack_lsb_ctxt;
+	struct rohc_lsb_decode *ack_scaled_lsb_ctxt;
+	/** The LSB decoding context of TCP window */
+	struct rohc_lsb_decode *window_lsb_ctxt;
 
+	uint32_t seq_num_residue;
 	uint16_t ack_stride;
 	uint16_t ack_num_residue;
-	struct rohc_lsb_decode *ack_lsb_ctxt;
-	struct rohc_lsb_decode *ack_scaled_lsb_ctxt;
+
+	/* TCP static part */
+	uint16_t tcp_src_port; /**< The TCP source port */
+	uint16_t tcp_dst_port; /**< The TCP dest port */
+
+	/** The URG pointer */
+	uint16_t urg_ptr;
 
 	/* TCP flags */
 	uint8_t res_flags:4;  /**< The TCP reserved flags */
@@ -297,22 +368,25 @@ struct d_tcp_context
 	bool ack_flag;        /**< The TCP ACK flag */
 	uint8_t rsf_flags:3;  /**< The TCP RSF flag */
 
-	/** The LSB decoding context of TCP window */
-	struct rohc_lsb_decode *window_lsb_ctxt;
-
-	/** The URG pointer */
-	uint16_t urg_ptr;
+	size_t ip_contexts_nr;
 
-	/** The decoded values of TCP options */
-	struct d_tcp_opts_ctxt tcp_opts;
 	/* TCP TS option */
 	struct rohc_lsb_decode *opt_ts_req_lsb_ctxt;
 	struct rohc_lsb_decode *opt_ts_rep_lsb_ctxt;
-	/* TCP SACK option */
-	struct d_tcp_opt_sack opt_sack_blocks;  /**< The TCP SACK blocks */
 
-	size_t ip_contexts_nr;
+	/** The store the IPv6 addresses of the context are interned in */
+	struct rohc_intern *static_store;
+	/** The static chain of the last IR packet, NULL if not kept yet */
+	struct d_tcp_static_chain *static_chain;
+
 	ip_context_t ip_contexts[ROHC_TCP_MAX_IP_HDRS];
+
+	/** The decoded values of TCP options */
+	struct d_tcp_opts_ctxt tcp_opts;
+	/** The uncompressed TCP options of the last packet */
+	struct d_tcp_opts_cache tcp_opts_cache;
+	/* TCP SACK option */
+	struct d_tcp_opt_sack opt_sack_blocks;  /**< The TCP SACK blocks */
 };
 
 
@@ -351,10 +425,11 @@ struct rohc_tcp_extr_ip_bits
 	                          chain of IR header */
 	size_t daddr_nr;     /**< The number of source address bits */
 
-	/** The parsed IP extension headers */
-	ip_option_context_t opts[ROHC_TCP_MAX_IP_EXT_HDRS];
 	size_t opts_nr;  /**< The number of parsed IP extension headers */
 	size_t opts_len; /**< The length of the parsed IP extension headers */
+	/** The parsed IP extension headers, only the first opts_nr ones are valid
+	 *  (kept last so that the fixed part of the struct is reset alone) */
+	ip_option_context_t opts[ROHC_TCP_MAX_IP_EXT_HDRS];
 };
 
 
@@ -402,6 +477,16 @@ struct rohc_tcp_extr_bits
 	                           IR/IR-DYN header or in irregular chain of CO header */
 	struct rohc_lsb_field16 urg_ptr;     /**< The TCP Urgent pointer bits */
 
+	/** The CRC-7 on the uncompressed headers found in IR-CR header */
+	uint8_t replicate_crc;
+
+	/** The static chain of the IR packet, NULL if the packet does not
+	 *  install any static chain */
+	const uint8_t *static_chain;
+	/** The length of the static chain of the IR packet, 0 for the static
+	 *  chain that the IR-CR packet replicates */
+	size_t static_chain_len;
+
 	/** The bits of TCP options extracted from the dynamic chain, the tail of
 	 * co_common/seq_8/rnd_8 packets, or the irregular chain */
 	struct d_tcp_opts_ctxt tcp_opts;
@@ -425,6 +510,9 @@ struct rohc_tcp_decoded_ip_values
 	uint32_t flowid:20;  /**< The decoded flow ID field (IPv6 only) */
 	uint8_t saddr[16];   /**< The decoded source address field */
 	uint8_t daddr[16];   /**< The decoded destination address field */
+	/** The interned IPv6 addresses not yet referenced by the context (IPv6
+	 *  only), NULL if they are the ones of the context */
+	const struct ipv6_addr *addrs;
 
 	/** The decoded IP extension headers */
 	ip_option_context_t opts[ROHC_TCP_MAX_IP_EXT_HDRS];
@@ -475,8 +563,20 @@ struct rohc_tcp_decoded_values
 	uint16_t tcp_check;  /**< The TCP checksum */
 	uint16_t urg_ptr;    /**< The TCP Urgent pointer */
 
+	/** The CRC-7 on the uncompressed headers found in IR-CR header */
+	uint8_t replicate_crc;
+
+	/** The static chain of the IR packet, NULL if the packet does not
+	 *  install any static chain */
+	const uint8_t *static_chain;
+	/** The length of the static chain of the IR packet, 0 for the static
+	 *  chain that the IR-CR packet replicates */
+	size_t static_chain_len;
+
 	/** The decoded values of TCP options */
 	struct d_tcp_opts_ctxt tcp_opts;
+	/** The uncompressed TCP options of the last packet */
+	struct d_tcp_opts_cache tcp_opts_cache;
 	/* TCP TS option */
 	uint32_t opt_ts_req;  /**< The echo request value of the TCP TS option */
 	uint32_t opt_ts_rep;  /**< The echo reply value of the TCP TS option */
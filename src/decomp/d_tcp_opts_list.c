@@ -255,8 +255,20 @@ static bool d_tcp_build_generic(const struct rohc_decomp_ctxt *const context,
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4, 5)));
 
 
-/* TODO */
-static struct d_tcp_opt d_tcp_opts[MAX_TCP_OPTION_INDEX + 1] =
+static bool d_tcp_build_tcp_opts_list(const struct rohc_decomp_ctxt *const context,
+                                      const struct rohc_tcp_decoded_values *const decoded,
+                                      struct rohc_buf *const uncomp_packet,
+                                      size_t *const opts_len,
+                                      struct d_tcp_opts_cache *const cache)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
+
+static bool d_tcp_is_tcp_opts_cache_usable(const struct d_tcp_opts_cache *const cache,
+                                           const struct rohc_tcp_decoded_values *const decoded)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
+
+
+/* The definitions of all the TCP options supported by the decompressor */
+static const struct d_tcp_opt d_tcp_opts[MAX_TCP_OPTION_INDEX + 1] =
 {
 	[TCP_INDEX_NOP]       = { TCP_INDEX_NOP, true, TCP_OPT_NOP,
 	                          "No Operation (NOP)",
@@ -342,6 +354,12 @@ int d_tcp_parse_tcp_opts_list_item(const struct rohc_decomp_ctxt *const context,
 	uint8_t PS;
 	uint8_t m;
 
+	tcp_opts->is_list_present = true;
+
+	/* the bits of all TCP options are defined by the compressed list */
+	memset(tcp_opts->bits, 0,
+	       (MAX_TCP_OPTION_INDEX + 1) * sizeof(struct d_tcp_opt_ctxt));
+
 	/* we need at least one byte to check whether TCP options are present or
 	 * not */
 	if(remain_len < 1)
@@ -1431,17 +1449,200 @@ error:
 }
 
 
-/* TODO */
+/**
+ * @brief Build the uncompressed TCP options
+ *
+ * If the compressed list of TCP options was not transmitted and if the
+ * TCP options built for the last packet are still in use, copy them and
+ * patch the TS and SACK options. Otherwise, build all the TCP options one by
+ * one.
+ *
+ * @param context            The decompression context
+ * @param decoded            The values decoded from the ROHC packet
+ * @param[out] uncomp_packet The uncompressed packet being built
+ * @param[out] opts_len      The length (in bytes) of the TCP options
+ * @return                   true if the TCP options were successfully built,
+ *                           false otherwise
+ */
 bool d_tcp_build_tcp_opts(const struct rohc_decomp_ctxt *const context,
                           const struct rohc_tcp_decoded_values *const decoded,
                           struct rohc_buf *const uncomp_packet,
                           size_t *const opts_len)
+{
+	const struct d_tcp_context *const tcp_context = context->persist_ctxt;
+	const struct d_tcp_opts_cache *const cache = &tcp_context->tcp_opts_cache;
+	uint8_t *opts;
+
+	if(!d_tcp_is_tcp_opts_cache_usable(cache, decoded))
+	{
+		return d_tcp_build_tcp_opts_list(context, decoded, uncomp_packet,
+		                                 opts_len, NULL);
+	}
+
+	rohc_decomp_debug(context, "build TCP options from the %zu TCP options "
+	                  "of the last packet", cache->nr);
+
+	if(rohc_buf_avail_len(*uncomp_packet) < cache->len)
+	{
+		rohc_decomp_warn(context, "output buffer too small for the %zu-byte "
+		                 "TCP options", cache->len);
+		goto error;
+	}
+	opts = rohc_buf_data(*uncomp_packet);
+	rohc_buf_append(uncomp_packet, cache->data, cache->len);
+
+	/* patch the TS and SACK options that may change in the irregular chain */
+	if(cache->ts_present)
+	{
+		const struct tcp_option_timestamp ts_load = {
+			.ts = rohc_hton32(decoded->opt_ts_req),
+			.ts_reply = rohc_hton32(decoded->opt_ts_rep)
+		};
+		memcpy(opts + cache->ts_offset + 2, &ts_load, sizeof(ts_load));
+	}
+	if(cache->sack_present)
+	{
+		memcpy(opts + cache->sack_offset + 2, decoded->opt_sack_blocks.blocks,
+		       sizeof(sack_block_t) * cache->sack_blocks_nr);
+	}
+
+	rohc_buf_pull(uncomp_packet, cache->len);
+	*opts_len = cache->len;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Record the uncompressed TCP options in context for next packets
+ *
+ * Nothing is recorded if the list contains generic TCP options, since their
+ * content may change in the irregular chain.
+ *
+ * @param context  The decompression context
+ * @param decoded  The values decoded from the ROHC packet
+ */
+void d_tcp_cache_tcp_opts(struct rohc_decomp_ctxt *const context,
+                          const struct rohc_tcp_decoded_values *const decoded)
+{
+	struct d_tcp_context *const tcp_context = context->persist_ctxt;
+	struct d_tcp_opts_cache *const cache = &tcp_context->tcp_opts_cache;
+	struct rohc_buf opts_buf =
+		rohc_buf_init_empty(cache->data, ROHC_TCP_OPTS_MAX_LEN);
+	size_t i;
+
+	/* the cached TCP options are still valid */
+	if(d_tcp_is_tcp_opts_cache_usable(cache, decoded))
+	{
+		return;
+	}
+	cache->is_valid = false;
+
+	for(i = 0; i < decoded->tcp_opts.nr; i++)
+	{
+		if(decoded->tcp_opts.structure[i] >= TCP_INDEX_GENERIC7)
+		{
+			rohc_decomp_debug(context, "do not cache TCP options with generic "
+			                  "option #%zu", i + 1);
+			return;
+		}
+	}
+
+	if(!d_tcp_build_tcp_opts_list(context, decoded, &opts_buf, &cache->len, cache))
+	{
+		return;
+	}
+	cache->nr = decoded->tcp_opts.nr;
+	memcpy(cache->structure, decoded->tcp_opts.structure, cache->nr);
+	cache->is_valid = true;
+}
+
+
+/**
+ * @brief Copy the informations collected on the TCP options
+ *
+ * Only the options marked as used are copied, the other ones are only marked
+ * as unused in the destination: the bits of unused options are never read.
+ *
+ * @param dst  The informations on TCP options to update
+ * @param src  The informations on TCP options to copy
+ */
+void d_tcp_copy_tcp_opts(struct d_tcp_opts_ctxt *const dst,
+                         const struct d_tcp_opts_ctxt *const src)
+{
+	size_t i;
+
+	dst->nr = src->nr;
+	memcpy(dst->structure, src->structure, sizeof(uint8_t) * ROHC_TCP_OPTS_MAX);
+	memcpy(dst->expected_dynamic, src->expected_dynamic,
+	       sizeof(bool) * ROHC_TCP_OPTS_MAX);
+	memcpy(dst->found, src->found, sizeof(bool) * ROHC_TCP_OPTS_MAX);
+	dst->is_list_present = src->is_list_present;
+	for(i = 0; i <= MAX_TCP_OPTION_INDEX; i++)
+	{
+		if(src->bits[i].used)
+		{
+			memcpy(&dst->bits[i], &src->bits[i], sizeof(struct d_tcp_opt_ctxt));
+		}
+		else
+		{
+			dst->bits[i].used = false;
+		}
+	}
+}
+
+
+/**
+ * @brief Whether the cached TCP options may be used for the current packet
+ *
+ * @param cache    The TCP options of the last packet
+ * @param decoded  The values decoded from the ROHC packet
+ * @return         true if the cached TCP options may be used,
+ *                 false if the TCP options shall be built one by one
+ */
+static bool d_tcp_is_tcp_opts_cache_usable(const struct d_tcp_opts_cache *const cache,
+                                           const struct rohc_tcp_decoded_values *const decoded)
+{
+	return (cache->is_valid &&
+	        !decoded->tcp_opts.is_list_present &&
+	        decoded->tcp_opts.nr == cache->nr &&
+	        memcmp(decoded->tcp_opts.structure, cache->structure, cache->nr) == 0 &&
+	        (!cache->sack_present ||
+	         decoded->opt_sack_blocks.blocks_nr == cache->sack_blocks_nr));
+}
+
+
+/**
+ * @brief Build the uncompressed TCP options one by one
+ *
+ * @param context            The decompression context
+ * @param decoded            The values decoded from the ROHC packet
+ * @param[out] uncomp_packet The uncompressed packet being built
+ * @param[out] opts_len      The length (in bytes) of the TCP options
+ * @param[out] cache         If not NULL, record the location of the TS and
+ *                           SACK options
+ * @return                   true if the TCP options were successfully built,
+ *                           false otherwise
+ */
+static bool d_tcp_build_tcp_opts_list(const struct rohc_decomp_ctxt *const context,
+                                      const struct rohc_tcp_decoded_values *const decoded,
+                                      struct rohc_buf *const uncomp_packet,
+                                      size_t *const opts_len,
+                                      struct d_tcp_opts_cache *const cache)
 {
 	size_t i;
 
 	rohc_decomp_debug(context, "build TCP options");
 
 	*opts_len = 0;
+	if(cache != NULL)
+	{
+		cache->ts_present = false;
+		cache->sack_present = false;
+	}
 
 	for(i = 0; i < decoded->tcp_opts.nr; i++)
 	{
@@ -1469,6 +1670,17 @@ bool d_tcp_build_tcp_opts(const struct rohc_decomp_ctxt *const context,
 			goto error;
 		}
 		rohc_decomp_debug(context, "    => option is %zu-byte length", opt_len);
+		if(cache != NULL && opt_index == TCP_INDEX_TS)
+		{
+			cache->ts_present = true;
+			cache->ts_offset = *opts_len;
+		}
+		else if(cache != NULL && opt_index == TCP_INDEX_SACK)
+		{
+			cache->sack_present = true;
+			cache->sack_offset = *opts_len;
+			cache->sack_blocks_nr = decoded->opt_sack_blocks.blocks_nr;
+		}
 		rohc_buf_pull(uncomp_packet, opt_len);
 		*opts_len += opt_len;
 	}
@@ -1484,4 +1696,3 @@ bool d_tcp_build_tcp_opts(const struct rohc_decomp_ctxt *const context,
 error:
 	return false;
 }
-
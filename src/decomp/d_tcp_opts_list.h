@@ -55,5 +55,13 @@ bool d_tcp_build_tcp_opts(const struct rohc_decomp_ctxt *const context,
                           size_t *const opts_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 
+void d_tcp_cache_tcp_opts(struct rohc_decomp_ctxt *const context,
+                          const struct rohc_tcp_decoded_values *const decoded)
+	__attribute__((nonnull(1, 2)));
+
+void d_tcp_copy_tcp_opts(struct d_tcp_opts_ctxt *const dst,
+                         const struct d_tcp_opts_ctxt *const src)
+	__attribute__((nonnull(1, 2)));
+
 #endif /* ROHC_DECOMP_TCP_OPTS_LIST_H */
 
@@ -344,6 +344,7 @@ static int tcp_parse_static_ipv6_option(const struct rohc_decomp_ctxt *const con
 	ip_opt_static = (ip_opt_static_t *) rohc_packet;
 	opt_context->proto = protocol;
 	opt_context->nh_proto = ip_opt_static->next_header;
+	opt_context->generic.data_len = 0; /* data is in the dynamic chain if any */
 
 	switch(protocol)
 	{
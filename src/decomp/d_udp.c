@@ -65,6 +65,9 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
+static size_t d_udp_mem_max(void)
+	__attribute__((warn_unused_result, const));
+
 static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                           const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(1, 2)));
@@ -93,6 +96,35 @@ static void udp_update_context(struct rohc_decomp_ctxt *const context,
                                const struct rohc_decoded_values *const decoded)
 	__attribute__((nonnull(1)));
 
+static int udp_decode_fast_udp(const struct rohc_decomp_ctxt *const context,
+                               const struct rohc_extr_uo_bits *const bits,
+                               const uint8_t *const rohc_data,
+                               const size_t rohc_data_len,
+                               struct rohc_decoded_values *const decoded)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+
+static void udp_patch_uncomp_udp(const struct rohc_decoded_values *const decoded,
+                                 uint8_t *const dest,
+                                 const size_t payload_len)
+	__attribute__((nonnull(1, 2)));
+
+
+/** The handlers of the UDP profile for the generic RFC3095-based code */
+static const struct rohc_decomp_rfc3095_ops d_udp_rfc3095_ops =
+{
+	.parse_static_next_hdr   = udp_parse_static_udp,
+	.parse_dyn_next_hdr      = udp_parse_dynamic_udp,
+	.parse_ext3              = ip_parse_ext3,
+	.parse_uo_remainder      = udp_parse_uo_remainder,
+	.decode_values_from_bits = udp_decode_values_from_bits,
+	.build_next_header       = udp_build_uncomp_udp,
+	.compute_crc_static      = udp_compute_crc_static,
+	.compute_crc_dynamic     = udp_compute_crc_dynamic,
+	.update_context          = udp_update_context,
+	.decode_fast_next_hdr    = udp_decode_fast_udp,
+	.patch_next_hdr          = udp_patch_uncomp_udp,
+};
+
 
 /**
  * @brief Create the UDP decompression context.
@@ -110,6 +142,7 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
                          struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
                          struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
+	struct rohc_slab *const slab = context->decompressor->ctxt_slab;
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 	struct d_udp_context *udp_context;
 
@@ -118,7 +151,8 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
 	assert(context->profile != NULL);
 
 	/* create the generic context */
-	if(!rohc_decomp_rfc3095_create(context, persist_ctxt, volat_ctxt,
+	if(!rohc_decomp_rfc3095_create(context, &d_udp_rfc3095_ops,
+	                               persist_ctxt, volat_ctxt,
 	                               context->decompressor->trace_callback,
 	                               context->decompressor->trace_callback_priv,
 	                               context->profile->id))
@@ -130,7 +164,7 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt = *persist_ctxt;
 
 	/* create the UDP-specific part of the context */
-	udp_context = malloc(sizeof(struct d_udp_context));
+	udp_context = rohc_slab_alloc(slab, sizeof(struct d_udp_context));
 	if(udp_context == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -142,7 +176,7 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the LSB decoding context for SN */
 	rfc3095_ctxt->sn_lsb_p = ROHC_LSB_SHIFT_SN;
-	rfc3095_ctxt->sn_lsb_ctxt = rohc_lsb_new(16);
+	rfc3095_ctxt->sn_lsb_ctxt = rohc_lsb_new(slab, 16);
 	if(rfc3095_ctxt->sn_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -156,19 +190,11 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
 
 	/* some UDP-specific values and functions */
 	rfc3095_ctxt->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->parse_static_next_hdr = udp_parse_static_udp;
-	rfc3095_ctxt->parse_dyn_next_hdr = udp_parse_dynamic_udp;
-	rfc3095_ctxt->parse_ext3 = ip_parse_ext3;
-	rfc3095_ctxt->parse_uo_remainder = udp_parse_uo_remainder;
-	rfc3095_ctxt->decode_values_from_bits = udp_decode_values_from_bits;
-	rfc3095_ctxt->build_next_header = udp_build_uncomp_udp;
-	rfc3095_ctxt->compute_crc_static = udp_compute_crc_static;
-	rfc3095_ctxt->compute_crc_dynamic = udp_compute_crc_dynamic;
-	rfc3095_ctxt->update_context = udp_update_context;
 
 	/* create the UDP-specific part of the header changes */
 	rfc3095_ctxt->outer_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->outer_ip_changes->next_header = malloc(sizeof(struct udphdr));
+	rfc3095_ctxt->outer_ip_changes->next_header =
+		rohc_slab_alloc(slab, sizeof(struct udphdr));
 	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -179,7 +205,8 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
 	memset(rfc3095_ctxt->outer_ip_changes->next_header, 0, sizeof(struct udphdr));
 
 	rfc3095_ctxt->inner_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->inner_ip_changes->next_header = malloc(sizeof(struct udphdr));
+	rfc3095_ctxt->inner_ip_changes->next_header =
+		rohc_slab_alloc(slab, sizeof(struct udphdr));
 	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -195,11 +222,11 @@ static bool d_udp_create(const struct rohc_decomp_ctxt *const context,
 	return true;
 
 free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_slab_zfree(rfc3095_ctxt->outer_ip_changes->next_header);
 free_lsb_sn:
 	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
 free_udp_context:
-	zfree(udp_context);
+	rohc_slab_zfree(rfc3095_ctxt->specific);
 destroy_context:
 	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
 quit:
@@ -221,9 +248,9 @@ static void d_udp_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
 {
 	/* clean UDP-specific memory */
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_slab_zfree(rfc3095_ctxt->outer_ip_changes->next_header);
 	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
+	rohc_slab_zfree(rfc3095_ctxt->inner_ip_changes->next_header);
 
 	/* destroy the LSB decoding context for SN */
 	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
@@ -597,6 +624,89 @@ static void udp_update_context(struct rohc_decomp_ctxt *const context,
 }
 
 
+/**
+ * @brief Decode the UDP fields of one UO-0 or UO-1 packet
+ *
+ * The fast path calls this function to parse and decode the UDP checksum
+ * from the UO* remainder. It reports no error, the generic path does.
+ *
+ * @param context        The decompression context
+ * @param bits           The bits extracted from the UO* base header
+ * @param rohc_data      The UO* remainder to parse
+ * @param rohc_data_len  The length of the UO* remainder
+ * @param[out] decoded   The decoded values
+ * @return               The number of bytes read in the ROHC packet,
+ *                       -1 if the packet shall be decoded by the generic path
+ */
+static int udp_decode_fast_udp(const struct rohc_decomp_ctxt *const context,
+                               const struct rohc_extr_uo_bits *const bits __attribute__((unused)),
+                               const uint8_t *const rohc_data,
+                               const size_t rohc_data_len,
+                               struct rohc_decoded_values *const decoded)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt =
+		context->persist_ctxt;
+	const struct d_udp_context *const udp_context = rfc3095_ctxt->specific;
+	int read = 0; /* number of bytes read from the packet */
+
+	/* UDP checksum */
+	if(udp_context->udp_check_present == ROHC_TRISTATE_YES)
+	{
+		if(rohc_data_len < 2)
+		{
+			goto error;
+		}
+		decoded->udp_check = GET_NEXT_16_BITS(rohc_data);
+		read += 2;
+	}
+	else if(udp_context->udp_check_present == ROHC_TRISTATE_NO)
+	{
+		decoded->udp_check = 0;
+	}
+	else
+	{
+		goto error;
+	}
+
+	return read;
+
+error:
+	return -1;
+}
+
+
+/**
+ * @brief Patch the UDP header copied from the template of the fast path
+ *
+ * @param decoded      The values decoded from the ROHC header
+ * @param dest         The UDP header to patch
+ * @param payload_len  The length of the UDP payload
+ */
+static void udp_patch_uncomp_udp(const struct rohc_decoded_values *const decoded,
+                                 uint8_t *const dest,
+                                 const size_t payload_len)
+{
+	struct udphdr *const udp = (struct udphdr *) dest;
+
+	udp->check = decoded->udp_check;
+	udp->len = rohc_hton16(payload_len + sizeof(struct udphdr));
+}
+
+
+/**
+ * @brief Get the maximum length one UDP context takes in a memory block
+ *
+ * @return  The maximum number of bytes of the memory block the
+ *          profile-specific part of the context takes
+ */
+static size_t d_udp_mem_max(void)
+{
+	return (rohc_decomp_rfc3095_mem_max() +
+	        rohc_slab_block_mem_max(sizeof(struct d_udp_context)) +
+	        rohc_lsb_mem_max() + 2 * rohc_slab_block_mem_max(sizeof(struct udphdr)));
+}
+
+
 /**
  * @brief Define the decompression part of the UDP profile as described
  *        in the RFC 3095.
@@ -614,5 +724,8 @@ const struct rohc_decomp_profile d_udp_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.decode_fast     = (rohc_decomp_decode_fast_t) rfc3095_decomp_decode_fast,
+	.prefetch        = rohc_decomp_rfc3095_prefetch,
+	.get_mem_max     = d_udp_mem_max,
 };
 
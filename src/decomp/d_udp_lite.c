@@ -76,6 +76,9 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
                               struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
 
+static size_t d_udp_lite_mem_max(void)
+	__attribute__((warn_unused_result, const));
+
 static void d_udp_lite_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                                const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(1, 2)));
@@ -124,6 +127,23 @@ static void udp_lite_update_context(struct rohc_decomp_ctxt *const context,
  * Definitions of functions.
  */
 
+/** The handlers of the UDP-Lite profile for the generic RFC3095-based code */
+static const struct rohc_decomp_rfc3095_ops d_udp_lite_rfc3095_ops =
+{
+	.parse_static_next_hdr   = udp_parse_static_udp,
+	.parse_dyn_next_hdr      = udp_lite_parse_dynamic_udp,
+	.parse_ext3              = ip_parse_ext3,
+	.parse_uo_remainder      = udp_lite_parse_uo_remainder,
+	.decode_values_from_bits = udp_lite_decode_values_from_bits,
+	.build_next_header       = udp_lite_build_uncomp_udp,
+	.compute_crc_static      = udp_compute_crc_static,
+	.compute_crc_dynamic     = udp_compute_crc_dynamic,
+	.update_context          = udp_lite_update_context,
+	.decode_fast_next_hdr    = NULL,
+	.patch_next_hdr          = NULL,
+};
+
+
 /**
  * @brief Create the UDP-Lite decompression context.
  *
@@ -140,6 +160,7 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
                               struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
                               struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
+	struct rohc_slab *const slab = context->decompressor->ctxt_slab;
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 	struct d_udp_lite_context *udp_lite_context;
 
@@ -148,7 +169,8 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
 	assert(context->profile != NULL);
 
 	/* create the generic context */
-	if(!rohc_decomp_rfc3095_create(context, persist_ctxt, volat_ctxt,
+	if(!rohc_decomp_rfc3095_create(context, &d_udp_lite_rfc3095_ops,
+	                               persist_ctxt, volat_ctxt,
 	                               context->decompressor->trace_callback,
 	                               context->decompressor->trace_callback_priv,
 	                               context->profile->id))
@@ -160,7 +182,8 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
 	rfc3095_ctxt = *persist_ctxt;
 
 	/* create the UDP-Lite-specific part of the context */
-	udp_lite_context = malloc(sizeof(struct d_udp_lite_context));
+	udp_lite_context = rohc_slab_alloc(slab,
+	                                   sizeof(struct d_udp_lite_context));
 	if(udp_lite_context == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -172,7 +195,7 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
 
 	/* create the LSB decoding context for SN */
 	rfc3095_ctxt->sn_lsb_p = ROHC_LSB_SHIFT_SN;
-	rfc3095_ctxt->sn_lsb_ctxt = rohc_lsb_new(16);
+	rfc3095_ctxt->sn_lsb_ctxt = rohc_lsb_new(slab, 16);
 	if(rfc3095_ctxt->sn_lsb_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -187,19 +210,11 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
 
 	/* some UDP-Lite-specific values and functions */
 	rfc3095_ctxt->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->parse_static_next_hdr = udp_parse_static_udp;
-	rfc3095_ctxt->parse_dyn_next_hdr = udp_lite_parse_dynamic_udp;
-	rfc3095_ctxt->parse_ext3 = ip_parse_ext3;
-	rfc3095_ctxt->parse_uo_remainder = udp_lite_parse_uo_remainder;
-	rfc3095_ctxt->decode_values_from_bits = udp_lite_decode_values_from_bits;
-	rfc3095_ctxt->build_next_header = udp_lite_build_uncomp_udp;
-	rfc3095_ctxt->compute_crc_static = udp_compute_crc_static;
-	rfc3095_ctxt->compute_crc_dynamic = udp_compute_crc_dynamic;
-	rfc3095_ctxt->update_context = udp_lite_update_context;
 
 	/* create the UDP-Lite-specific part of the header changes */
 	rfc3095_ctxt->outer_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->outer_ip_changes->next_header = malloc(sizeof(struct udphdr));
+	rfc3095_ctxt->outer_ip_changes->next_header =
+		rohc_slab_alloc(slab, sizeof(struct udphdr));
 	if(rfc3095_ctxt->outer_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -210,7 +225,8 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
 	memset(rfc3095_ctxt->outer_ip_changes->next_header, 0, sizeof(struct udphdr));
 
 	rfc3095_ctxt->inner_ip_changes->next_header_len = sizeof(struct udphdr);
-	rfc3095_ctxt->inner_ip_changes->next_header = malloc(sizeof(struct udphdr));
+	rfc3095_ctxt->inner_ip_changes->next_header =
+		rohc_slab_alloc(slab, sizeof(struct udphdr));
 	if(rfc3095_ctxt->inner_ip_changes->next_header == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -226,11 +242,11 @@ static bool d_udp_lite_create(const struct rohc_decomp_ctxt *const context,
 	return true;
 
 free_outer_ip_changes_next_header:
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_slab_zfree(rfc3095_ctxt->outer_ip_changes->next_header);
 free_lsb_sn:
 	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
 free_udp_context:
-	zfree(udp_lite_context);
+	rohc_slab_zfree(rfc3095_ctxt->specific);
 destroy_context:
 	rohc_decomp_rfc3095_destroy(rfc3095_ctxt, volat_ctxt);
 quit:
@@ -252,9 +268,9 @@ static void d_udp_lite_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ct
 {
 	/* clean UDP-specific memory */
 	assert(rfc3095_ctxt->outer_ip_changes != NULL);
-	zfree(rfc3095_ctxt->outer_ip_changes->next_header);
+	rohc_slab_zfree(rfc3095_ctxt->outer_ip_changes->next_header);
 	assert(rfc3095_ctxt->inner_ip_changes != NULL);
-	zfree(rfc3095_ctxt->inner_ip_changes->next_header);
+	rohc_slab_zfree(rfc3095_ctxt->inner_ip_changes->next_header);
 
 	/* destroy the LSB decoding context for SN */
 	rohc_lsb_free(rfc3095_ctxt->sn_lsb_ctxt);
@@ -788,6 +804,20 @@ static void udp_lite_update_context(struct rohc_decomp_ctxt *const context,
 }
 
 
+/**
+ * @brief Get the maximum length one UDP-Lite context takes in a memory block
+ *
+ * @return  The maximum number of bytes of the memory block the
+ *          profile-specific part of the context takes
+ */
+static size_t d_udp_lite_mem_max(void)
+{
+	return (rohc_decomp_rfc3095_mem_max() +
+	        rohc_slab_block_mem_max(sizeof(struct d_udp_lite_context)) +
+	        rohc_lsb_mem_max() + 2 * rohc_slab_block_mem_max(sizeof(struct udphdr)));
+}
+
+
 /**
  * @brief Define the decompression part of the UDP-Lite profile as described
  *        in the RFC 4019.
@@ -805,5 +835,8 @@ const struct rohc_decomp_profile d_udplite_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) rfc3095_decomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) rfc3095_decomp_attempt_repair,
 	.get_sn          = rohc_decomp_rfc3095_get_sn,
+	.decode_fast     = NULL,
+	.prefetch        = rohc_decomp_rfc3095_prefetch,
+	.get_mem_max     = d_udp_lite_mem_max,
 };
 
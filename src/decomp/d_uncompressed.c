@@ -29,7 +29,7 @@
 #include "rohc_bit_ops.h"
 #include "rohc_traces_internal.h"
 #include "crc.h"
-#include "rohc_decomp_detect_packet.h" /* for rohc_decomp_packet_is_ir() */
+#include "rohc_decomp_detect_packet.h" /* for rohc_decomp_pkt_type() */
 
 #ifndef __KERNEL__
 #	include <string.h>
@@ -69,6 +69,9 @@ static void uncomp_free_context(void *const persist_ctxt,
                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(2)));
 
+static size_t uncomp_mem_max(void)
+	__attribute__((warn_unused_result, const));
+
 static rohc_packet_t uncomp_detect_pkt_type(const struct rohc_decomp_ctxt *const context,
                                             const uint8_t *const rohc_packet,
                                             const size_t rohc_length,
@@ -153,6 +156,8 @@ static bool uncomp_new_context(const struct rohc_decomp_ctxt *const context,
                                void **const persist_ctxt,
                                struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
+	struct rohc_slab *const slab = context->decompressor->ctxt_slab;
+
 	assert(context->profile->id == ROHC_PROFILE_UNCOMPRESSED);
 
 	/* persistent part */
@@ -161,14 +166,16 @@ static bool uncomp_new_context(const struct rohc_decomp_ctxt *const context,
 	/* volatile part */
 	volat_ctxt->crc.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.bits_nr = 0;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_uncomp_extr_bits));
+	volat_ctxt->extr_bits =
+		rohc_slab_alloc(slab, sizeof(struct rohc_uncomp_extr_bits));
 	if(volat_ctxt->extr_bits == NULL)
 	{
 		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
 		                 "of the Uncompressed decompression profile");
 		goto error;
 	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_uncomp_decoded));
+	volat_ctxt->decoded_values =
+		rohc_slab_alloc(slab, sizeof(struct rohc_uncomp_decoded));
 	if(volat_ctxt->decoded_values == NULL)
 	{
 		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
@@ -179,7 +186,7 @@ static bool uncomp_new_context(const struct rohc_decomp_ctxt *const context,
 	return true;
 
 free_extr_bits:
-	free(volat_ctxt->extr_bits);
+	rohc_slab_free(volat_ctxt->extr_bits);
 error:
 	return false;
 }
@@ -199,8 +206,8 @@ static void uncomp_free_context(void *const persist_ctxt,
                                 const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
 	assert(persist_ctxt == NULL);
-	free(volat_ctxt->extr_bits);
-	free(volat_ctxt->decoded_values);
+	rohc_slab_free(volat_ctxt->extr_bits);
+	rohc_slab_free(volat_ctxt->decoded_values);
 }
 
 
@@ -223,13 +230,13 @@ static rohc_packet_t uncomp_detect_pkt_type(const struct rohc_decomp_ctxt *const
 {
 	rohc_packet_t type;
 
-	if(rohc_decomp_packet_is_ir(rohc_packet, rohc_length))
+	if(rohc_length < 1)
 	{
-		type = ROHC_PACKET_IR;
+		type = ROHC_PACKET_NORMAL;
 	}
 	else
 	{
-		type = ROHC_PACKET_NORMAL;
+		type = rohc_decomp_pkt_type(rohc_decomp_pkt_types_uncomp, rohc_packet[0]);
 	}
 
 	return type;
@@ -382,6 +389,15 @@ static bool uncomp_parse_normal(const struct rohc_decomp_ctxt *const context,
 		goto error;
 	}
 
+	/* without large CID, the first byte of the ROHC packet is followed by the
+	 * rest of the IP packet: the whole IP packet is the payload, so that it is
+	 * decompressed without being copied nor moved */
+	if(large_cid_len == 0)
+	{
+		extr_bits->first_byte_used = false;
+		return true;
+	}
+
 	/* save the first byte of the ROHC packet into the volatile part of the
 	 * context (please note that the ROHC header length will be too large by one
 	 * because of that, not great, but hey it's uncompressed profile anyway) */
@@ -546,6 +562,20 @@ static uint32_t uncomp_get_sn(const struct rohc_decomp_ctxt *const context __att
 }
 
 
+/**
+ * @brief Get the maximum length one Uncompressed context takes in a memory
+ *        block
+ *
+ * @return  The maximum number of bytes of the memory block the
+ *          profile-specific part of the context takes
+ */
+static size_t uncomp_mem_max(void)
+{
+	return (rohc_slab_block_mem_max(sizeof(struct rohc_uncomp_extr_bits)) +
+	        rohc_slab_block_mem_max(sizeof(struct rohc_uncomp_decoded)));
+}
+
+
 /**
  * @brief Define the decompression part of the Uncompressed profile as
  *        described in the RFC 3095.
@@ -563,5 +593,8 @@ const struct rohc_decomp_profile d_uncomp_profile =
 	.update_ctxt     = (rohc_decomp_update_ctxt_t) uncomp_update_ctxt,
 	.attempt_repair  = (rohc_decomp_attempt_repair_t) uncomp_attempt_repair,
 	.get_sn          = uncomp_get_sn,
+	.decode_fast     = NULL,
+	.prefetch        = NULL,
+	.get_mem_max     = uncomp_mem_max,
 };
 
@@ -25,6 +25,7 @@
  */
 
 #include "feedback_create.h"
+#include "rohc_internal.h"
 #include "crc.h"
 #include "rohc_debug.h"
 #include "rohc_bit_ops.h"
@@ -49,6 +50,21 @@ static bool f_append_cid(struct d_feedback *const feedback,
                          size_t *const cid_len)
 	__attribute__((warn_unused_result, nonnull(1, 4)));
 
+static size_t f_feedback2_sn_opts_nr(const size_t sn_bits_on_first_byte,
+                                     const size_t sn_bits_nr)
+	__attribute__((warn_unused_result, const));
+
+static bool f_feedback2_tmpl_build(struct d_feedback_tmpl *const tmpl,
+                                   const rohc_profile_t profile_id,
+                                   const enum rohc_feedback_ack_type ack_type,
+                                   const rohc_mode_t mode,
+                                   const size_t sn_bits_nr,
+                                   const uint16_t cid,
+                                   const rohc_cid_type_t cid_type,
+                                   const rohc_feedback_crc_t protect_with_crc,
+                                   const uint8_t *const crc_table)
+	__attribute__((warn_unused_result, nonnull(1, 9)));
+
 
 /**
  * @brief Build a FEEDBACK-1 packet.
@@ -115,7 +131,7 @@ bool f_feedback2(const rohc_profile_t profile_id,
 		assert(0);
 		goto error;
 	}
-	else if(profile_id == ROHC_PROFILE_TCP)
+	else if(profile_id == ROHC_PROFILE_TCP || rohc_profile_is_rohcv2(profile_id))
 	{
 		feedback->data[feedback->size] = (ack_type & 0x3) << 6;
 		sn_bits_on_first_byte = 6;
@@ -138,12 +154,7 @@ bool f_feedback2(const rohc_profile_t profile_id,
 
 	/* how many SN options are required to store the full SN on the base header
 	 * and those SN options? */
-	for(needed_sn_opts_nr = 0; needed_sn_opts_nr <= 3 &&
-	    sn_bits_nr > (sn_bits_on_first_byte + sn_bits_on_2nd_byte + needed_sn_opts_nr * 8);
-	    needed_sn_opts_nr++)
-	{
-	}
-	assert(needed_sn_opts_nr <= 3); /* should never happen: SN is not larger than 32 bits */
+	needed_sn_opts_nr = f_feedback2_sn_opts_nr(sn_bits_on_first_byte, sn_bits_nr);
 	sn_bits_to_send = sn_bits_on_first_byte + sn_bits_on_2nd_byte + needed_sn_opts_nr * 8;
 	assert(sn_bits_to_send >= sn_bits_nr);
 #ifdef ROHC_FEEDBACK_DEBUG
@@ -172,8 +183,8 @@ bool f_feedback2(const rohc_profile_t profile_id,
 #endif
 	feedback->size++;
 
-	/* base header: CRC for TCP profile */
-	if(profile_id == ROHC_PROFILE_TCP)
+	/* base header: CRC for TCP and ROHCv2 profiles */
+	if(profile_id == ROHC_PROFILE_TCP || rohc_profile_is_rohcv2(profile_id))
 	{
 		feedback->data[feedback->size] = 0x00; /* zeroed for computation */
 		feedback->size++;
@@ -399,7 +410,9 @@ static bool f_append_cid(struct d_feedback *const feedback,
  * @param protect_with_crc  Whether the CRC option must be added or not
  * @param crc_table         The pre-computed table for fast CRC computation
  * @param final_size        OUT: The final size of the feedback packet
- * @return                  The feedback packet if successful, NULL otherwise
+ * @return                  The feedback packet if successful, NULL otherwise;
+ *                          the feedback packet is built in place in the data
+ *                          of \e feedback, so it lives as long as \e feedback
  */
 uint8_t * f_wrap_feedback(struct d_feedback *const feedback,
                           const uint16_t cid,
@@ -408,7 +421,7 @@ uint8_t * f_wrap_feedback(struct d_feedback *const feedback,
                           const uint8_t *const crc_table,
                           size_t *const final_size)
 {
-	uint8_t *feedback_packet;
+	uint8_t *const feedback_packet = feedback->data;
 	size_t feedback_cid_len = 0;
 	size_t crc_pos = 0;
 	uint8_t crc;
@@ -449,16 +462,6 @@ uint8_t * f_wrap_feedback(struct d_feedback *const feedback,
 		goto error;
 	}
 
-	/* allocate memory for the feedback packet */
-	feedback_packet = (uint8_t *) malloc(feedback->size);
-	if(feedback_packet == NULL)
-	{
-		goto error;
-	}
-
-	/* duplicate the feedback packet */
-	memcpy(feedback_packet, feedback->data, feedback->size);
-
 	/* compute the CRC and store it in the feedback packet if specified */
 	if(protect_with_crc != ROHC_FEEDBACK_WITH_NO_CRC)
 	{
@@ -477,3 +480,223 @@ error:
 	return NULL;
 }
 
+
+
+/**
+ * @brief Build a FEEDBACK-2 packet from the given template
+ *
+ * The FEEDBACK-2 packet is built as \ref f_feedback2 and \ref f_wrap_feedback
+ * do. The template is (re)built only if it was built with other parameters,
+ * otherwise only the SN bits and the CRC of the prebuilt packet are written.
+ *
+ * @param tmpl              The template of the context
+ * @param profile_id        The ID of the decompression profile that builds
+ *                          the feedback
+ * @param ack_type          The type of acknowledgement
+ * @param mode              The mode in which ROHC operates
+ * @param sn_bits           The LSB of the Sequence Number (SN) the feedback
+ *                          packet is associated with
+ * @param sn_bits_nr        The number of SN LSB
+ * @param cid               The Context ID (CID) to append
+ * @param cid_type          The type of CID used for the feedback
+ * @param protect_with_crc  Whether the CRC must be added or not
+ * @param crc_table         The pre-computed table for fast CRC computation
+ * @param final_size        OUT: The final size of the feedback packet
+ * @return                  The feedback packet if successful, NULL otherwise;
+ *                          the feedback packet is built in place in the
+ *                          template, so it lives until the template is used
+ *                          again
+ */
+uint8_t * f_feedback2_tmpl(struct d_feedback_tmpl *const tmpl,
+                           const rohc_profile_t profile_id,
+                           const enum rohc_feedback_ack_type ack_type,
+                           const rohc_mode_t mode,
+                           const uint32_t sn_bits,
+                           const size_t sn_bits_nr,
+                           const uint16_t cid,
+                           const rohc_cid_type_t cid_type,
+                           const rohc_feedback_crc_t protect_with_crc,
+                           const uint8_t *const crc_table,
+                           size_t *const final_size)
+{
+	uint8_t sn_mask_on_first_byte;
+	uint8_t *base_hdr;
+	size_t sn_bits_shift;
+	size_t sn_opt_nr;
+
+	/* if SN is not valid, it shall be zero */
+	if(sn_bits_nr == 0)
+	{
+		assert(sn_bits == 0);
+	}
+
+	/* build the template again if the parameters changed */
+	if(!tmpl->is_built ||
+	   tmpl->profile_id != profile_id ||
+	   tmpl->ack_type != ack_type ||
+	   tmpl->mode != mode ||
+	   tmpl->sn_bits_nr != sn_bits_nr ||
+	   tmpl->protect_with_crc != protect_with_crc ||
+	   tmpl->cid != cid ||
+	   tmpl->cid_type != cid_type)
+	{
+		if(!f_feedback2_tmpl_build(tmpl, profile_id, ack_type, mode, sn_bits_nr,
+		                           cid, cid_type, protect_with_crc, crc_table))
+		{
+			goto error;
+		}
+	}
+
+	/* patch the SN bits in the base header and in the SN options */
+	sn_mask_on_first_byte = (1U << tmpl->sn_bits_on_first_byte) - 1;
+	base_hdr = tmpl->data + tmpl->base_pos;
+	sn_bits_shift = tmpl->sn_bits_on_first_byte + 8 + tmpl->sn_opts_nr * 8;
+	sn_bits_shift -= tmpl->sn_bits_on_first_byte;
+	base_hdr[0] &= ~sn_mask_on_first_byte;
+	if(sn_bits_shift < 32)
+	{
+		base_hdr[0] |= (sn_bits >> sn_bits_shift) & sn_mask_on_first_byte;
+	}
+	sn_bits_shift -= 8;
+	base_hdr[1] = (sn_bits >> sn_bits_shift) & 0xff;
+	for(sn_opt_nr = 0; sn_opt_nr < tmpl->sn_opts_nr; sn_opt_nr++)
+	{
+		sn_bits_shift -= 8;
+		tmpl->data[tmpl->sn_opts_pos + sn_opt_nr * 2] =
+			(sn_bits >> sn_bits_shift) & 0xff;
+	}
+
+	/* compute the CRC over the whole packet with the CRC zeroed */
+	if(protect_with_crc != ROHC_FEEDBACK_WITH_NO_CRC)
+	{
+		tmpl->data[tmpl->crc_pos] = 0x00;
+		tmpl->data[tmpl->crc_pos] =
+			crc_calculate(ROHC_CRC_TYPE_8, tmpl->data, tmpl->size, CRC_INIT_8,
+			              crc_table) & 0xff;
+	}
+
+	*final_size = tmpl->size;
+	return tmpl->data;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Get the number of SN options required to transmit the given SN bits
+ *
+ * @param sn_bits_on_first_byte  The number of SN bits in the first byte of
+ *                               the FEEDBACK-2 base header
+ * @param sn_bits_nr             The number of SN bits to transmit
+ * @return                       The number of SN options
+ */
+static size_t f_feedback2_sn_opts_nr(const size_t sn_bits_on_first_byte,
+                                     const size_t sn_bits_nr)
+{
+	const size_t sn_bits_on_2nd_byte = 8;
+	size_t needed_sn_opts_nr;
+
+	for(needed_sn_opts_nr = 0; needed_sn_opts_nr <= 3 &&
+	    sn_bits_nr > (sn_bits_on_first_byte + sn_bits_on_2nd_byte + needed_sn_opts_nr * 8);
+	    needed_sn_opts_nr++)
+	{
+	}
+	assert(needed_sn_opts_nr <= 3); /* should never happen: SN is not larger than 32 bits */
+
+	return needed_sn_opts_nr;
+}
+
+
+/**
+ * @brief Build the template of FEEDBACK-2 packets for the given parameters
+ *
+ * @param tmpl              The template to build
+ * @param profile_id        The ID of the decompression profile that builds
+ *                          the feedback
+ * @param ack_type          The type of acknowledgement
+ * @param mode              The mode in which ROHC operates
+ * @param sn_bits_nr        The number of SN LSB
+ * @param cid               The Context ID (CID) to append
+ * @param cid_type          The type of CID used for the feedback
+ * @param protect_with_crc  Whether the CRC must be added or not
+ * @param crc_table         The pre-computed table for fast CRC computation
+ * @return                  true if the template is successfully built,
+ *                          false otherwise
+ */
+static bool f_feedback2_tmpl_build(struct d_feedback_tmpl *const tmpl,
+                                   const rohc_profile_t profile_id,
+                                   const enum rohc_feedback_ack_type ack_type,
+                                   const rohc_mode_t mode,
+                                   const size_t sn_bits_nr,
+                                   const uint16_t cid,
+                                   const rohc_cid_type_t cid_type,
+                                   const rohc_feedback_crc_t protect_with_crc,
+                                   const uint8_t *const crc_table)
+{
+	const bool is_crc_in_base =
+		(profile_id == ROHC_PROFILE_TCP || rohc_profile_is_rohcv2(profile_id));
+	const size_t base_hdr_len = (is_crc_in_base ? 3 : 2);
+	struct d_feedback feedback;
+	size_t unwrapped_size;
+	size_t cid_len;
+	uint8_t *feedbackp;
+	size_t feedbacksize;
+
+	tmpl->is_built = false;
+
+	/* build the feedback with all SN bits zeroed */
+	if(!f_feedback2(profile_id, ack_type, mode, 0, sn_bits_nr, &feedback))
+	{
+		goto error;
+	}
+	unwrapped_size = feedback.size;
+	feedbackp = f_wrap_feedback(&feedback, cid, cid_type, protect_with_crc,
+	                            crc_table, &feedbacksize);
+	if(feedbackp == NULL)
+	{
+		goto error;
+	}
+	memcpy(tmpl->data, feedbackp, feedbacksize);
+	tmpl->size = feedbacksize;
+
+	/* the CID is prepended, the CRC option is appended */
+	cid_len = feedbacksize - unwrapped_size;
+	if(protect_with_crc == ROHC_FEEDBACK_WITH_CRC_OPT)
+	{
+		cid_len -= 2;
+		tmpl->crc_pos = feedbacksize - 1;
+	}
+	else
+	{
+		tmpl->crc_pos = cid_len + 2;
+	}
+
+	/* locate the SN bits */
+	tmpl->base_pos = cid_len;
+	tmpl->sn_bits_on_first_byte = (is_crc_in_base ? 6 : 4);
+	if(sn_bits_nr > 0)
+	{
+		tmpl->sn_opts_nr =
+			f_feedback2_sn_opts_nr(tmpl->sn_bits_on_first_byte, sn_bits_nr);
+	}
+	else
+	{
+		tmpl->sn_opts_nr = 0;
+	}
+	tmpl->sn_opts_pos = cid_len + base_hdr_len + 1;
+
+	tmpl->profile_id = profile_id;
+	tmpl->ack_type = ack_type;
+	tmpl->mode = mode;
+	tmpl->sn_bits_nr = sn_bits_nr;
+	tmpl->protect_with_crc = protect_with_crc;
+	tmpl->cid = cid;
+	tmpl->cid_type = cid_type;
+	tmpl->is_built = true;
+
+	return true;
+
+error:
+	return false;
+}
@@ -66,6 +66,45 @@ struct d_feedback
 };
 
 
+/**
+ * @brief A prebuilt FEEDBACK-2 packet
+ *
+ * The FEEDBACK-2 packets sent for one context only differ by their SN bits
+ * and their CRC as long as they are built with the same parameters. The
+ * template holds the packet built once with zeroed SN bits and CRC, so that
+ * the next packets are built by patching the SN bits and computing the CRC.
+ */
+struct d_feedback_tmpl
+{
+	/** The prebuilt FEEDBACK-2 packet with its CID, SN bits and CRC zeroed */
+	uint8_t data[FEEDBACK_DATA_MAX_LEN];
+	/** The length of the prebuilt packet */
+	uint8_t size;
+	/** The position of the base header in the prebuilt packet */
+	uint8_t base_pos;
+	/** The position of the first SN option in the prebuilt packet */
+	uint8_t sn_opts_pos;
+	/** The number of SN options in the prebuilt packet */
+	uint8_t sn_opts_nr;
+	/** The number of SN bits in the first byte of the base header */
+	uint8_t sn_bits_on_first_byte;
+	/** The position of the CRC in the prebuilt packet, if any */
+	uint8_t crc_pos;
+
+	/** Whether the template was built or not */
+	bool is_built;
+
+	/* the parameters the template was built with */
+	rohc_profile_t profile_id;               /**< The ID of the profile */
+	enum rohc_feedback_ack_type ack_type;    /**< The type of ACK */
+	rohc_mode_t mode;                        /**< The decompression mode */
+	size_t sn_bits_nr;                       /**< The number of SN bits */
+	rohc_feedback_crc_t protect_with_crc;    /**< The CRC protection */
+	uint16_t cid;                            /**< The Context ID */
+	rohc_cid_type_t cid_type;                /**< The type of CID */
+};
+
+
 /*
  * Prototypes of public functions.
  */
@@ -100,6 +139,19 @@ uint8_t * f_wrap_feedback(struct d_feedback *feedback,
                           size_t *const final_size)
 	__attribute__((warn_unused_result, nonnull(1, 5, 6)));
 
+uint8_t * f_feedback2_tmpl(struct d_feedback_tmpl *const tmpl,
+                           const rohc_profile_t profile_id,
+                           const enum rohc_feedback_ack_type ack_type,
+                           const rohc_mode_t mode,
+                           const uint32_t sn_bits,
+                           const size_t sn_bits_nr,
+                           const uint16_t cid,
+                           const rohc_cid_type_t cid_type,
+                           const rohc_feedback_crc_t protect_with_crc,
+                           const uint8_t *const crc_table,
+                           size_t *const final_size)
+	__attribute__((warn_unused_result, nonnull(1, 10, 11)));
+
 
 #endif
 
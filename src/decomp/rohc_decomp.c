@@ -42,6 +42,9 @@
 #include "rohc_traces_internal.h"
 #include "rohc_time_internal.h"
 #include "rohc_utils.h"
+#include "rohc_mem.h"
+#include "rohc_mem_block.h"
+#include "rohc_burst.h"
 #include "rohc_bit_ops.h"
 #include "rohc_debug.h"
 #include "feedback_create.h"
@@ -50,6 +53,13 @@
 #include "rohc_add_cid.h"
 #include "rohc_decomp_detect_packet.h"
 #include "crc.h"
+#include "protocols/ip_numbers.h"
+#include "protocols/ipv4.h"
+#include "protocols/ipv6.h"
+#include "protocols/udp.h"
+#include "protocols/rtp.h"
+#include "protocols/esp.h"
+#include "protocols/tcp.h"
 
 #ifndef __KERNEL__
 #  include <string.h>
@@ -64,7 +74,8 @@ extern const struct rohc_decomp_profile d_uncomp_profile,
                                         d_udplite_profile,
                                         d_esp_profile,
                                         d_rtp_profile,
-                                        d_tcp_profile;
+                                        d_tcp_profile,
+                                        d_rfc5225_ip_profile;
 
 
 /**
@@ -75,10 +86,84 @@ static const struct rohc_decomp_profile *const rohc_decomp_profiles[D_NUM_PROFIL
 	&d_uncomp_profile,
 	&d_rtp_profile,
 	&d_udp_profile,
+#if ROHC_BUILD_PROFILE_ESP == 1
 	&d_esp_profile,
+#endif
 	&d_ip_profile,
+#if ROHC_BUILD_PROFILE_TCP == 1
 	&d_tcp_profile,
+#endif
+#if ROHC_BUILD_PROFILE_UDPLITE == 1
 	&d_udplite_profile,
+#endif
+	&d_rfc5225_ip_profile,
+};
+
+/** The indexes of the profiles in \ref rohc_decomp_profiles */
+enum
+{
+	ROHC_DECOMP_PROFILE_IDX_UNCOMP,
+	ROHC_DECOMP_PROFILE_IDX_RTP,
+	ROHC_DECOMP_PROFILE_IDX_UDP,
+#if ROHC_BUILD_PROFILE_ESP == 1
+	ROHC_DECOMP_PROFILE_IDX_ESP,
+#endif
+	ROHC_DECOMP_PROFILE_IDX_IP,
+#if ROHC_BUILD_PROFILE_TCP == 1
+	ROHC_DECOMP_PROFILE_IDX_TCP,
+#endif
+#if ROHC_BUILD_PROFILE_UDPLITE == 1
+	ROHC_DECOMP_PROFILE_IDX_UDPLITE,
+#endif
+	ROHC_DECOMP_PROFILE_IDX_RFC5225_IP,
+	/** The index of the ROHC profiles that are not supported */
+	ROHC_DECOMP_PROFILE_IDX_NONE,
+};
+
+_Static_assert(ROHC_DECOMP_PROFILE_IDX_NONE == D_NUM_PROFILES,
+               "the indexes of the profiles shall match the built profiles");
+
+/**
+ * @brief The indexes of the decompression parts of the ROHC profiles
+ *
+ * The indexes in \ref rohc_decomp_profiles are given by profile ID, so that the
+ * profiles are found without searching them one by one. The table is
+ * read-only, so it is shared by all the decompressors.
+ */
+static const uint8_t rohc_decomp_profiles_idx[ROHC_PROFILE_MAX] =
+{
+	[ROHC_PROFILE_UNCOMPRESSED]  = ROHC_DECOMP_PROFILE_IDX_UNCOMP,
+	[ROHC_PROFILE_RTP]           = ROHC_DECOMP_PROFILE_IDX_RTP,
+	[ROHC_PROFILE_UDP]           = ROHC_DECOMP_PROFILE_IDX_UDP,
+#if ROHC_BUILD_PROFILE_ESP == 1
+	[ROHC_PROFILE_ESP]           = ROHC_DECOMP_PROFILE_IDX_ESP,
+#else
+	[ROHC_PROFILE_ESP]           = ROHC_DECOMP_PROFILE_IDX_NONE,
+#endif
+	[ROHC_PROFILE_IP]            = ROHC_DECOMP_PROFILE_IDX_IP,
+	[ROHC_PROFILE_RTP_LLA]       = ROHC_DECOMP_PROFILE_IDX_NONE,
+#if ROHC_BUILD_PROFILE_TCP == 1
+	[ROHC_PROFILE_TCP]           = ROHC_DECOMP_PROFILE_IDX_TCP,
+#else
+	[ROHC_PROFILE_TCP]           = ROHC_DECOMP_PROFILE_IDX_NONE,
+#endif
+	[ROHC_PROFILE_UDPLITE_RTP]   = ROHC_DECOMP_PROFILE_IDX_NONE,
+#if ROHC_BUILD_PROFILE_UDPLITE == 1
+	[ROHC_PROFILE_UDPLITE]       = ROHC_DECOMP_PROFILE_IDX_UDPLITE,
+#else
+	[ROHC_PROFILE_UDPLITE]       = ROHC_DECOMP_PROFILE_IDX_NONE,
+#endif
+};
+
+/** The indexes of the decompression parts of the ROHCv2 profiles, given by
+ *  the 8 LSB of their profile IDs */
+static const uint8_t rohc_decomp_profiles_v2_idx[ROHCv2_PROFILE_MAX & 0xff] =
+{
+	[ROHC_PROFILE_UNCOMPRESSED]  = ROHC_DECOMP_PROFILE_IDX_NONE,
+	[ROHC_PROFILE_RTP]           = ROHC_DECOMP_PROFILE_IDX_NONE,
+	[ROHC_PROFILE_UDP]           = ROHC_DECOMP_PROFILE_IDX_NONE,
+	[ROHC_PROFILE_ESP]           = ROHC_DECOMP_PROFILE_IDX_NONE,
+	[ROHCv2_PROFILE_IP & 0xff]   = ROHC_DECOMP_PROFILE_IDX_RFC5225_IP,
 };
 
 
@@ -117,6 +202,19 @@ struct rohc_decomp_stream
 	size_t sn_bits_nr;         /**< The number of SN LSB bits (if context found) */
 	rohc_packet_t packet_type; /**< The type of the decompressed packet */
 	bool crc_failed;           /**< Whether the packet failed the CRC check or not */
+	struct rohc_ts arrival_time; /**< The arrival time of the packet */
+	const uint8_t *hdr;        /**< The ROHC header (if context found) */
+	size_t hdr_len;            /**< The length of the ROHC header and payload */
+};
+
+
+/** The information parsed from one feedback item built by the decompressor */
+struct rohc_decomp_feedback_item
+{
+	size_t len;      /**< The length of the item, feedback header included */
+	rohc_cid_t cid;  /**< The CID the feedback is for */
+	bool is_ack;     /**< Whether the feedback is an ACK or not */
+	bool is_fb2;     /**< Whether the feedback is a FEEDBACK-2 or a FEEDBACK-1 */
 };
 
 
@@ -132,6 +230,8 @@ static const struct rohc_decomp_profile *
 	find_profile(const struct rohc_decomp *const decomp,
 	             const rohc_profile_t profile_id)
 	__attribute__((warn_unused_result));
+static size_t rohc_decomp_get_profile_idx(const rohc_profile_t profile_id)
+	__attribute__((warn_unused_result, const));
 
 static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
                                                 const rohc_cid_t cid,
@@ -140,15 +240,98 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 static struct rohc_decomp_ctxt * find_context(const struct rohc_decomp *const decomp,
                                               const size_t cid)
 	__attribute__((nonnull(1), warn_unused_result));
+static struct rohc_decomp_ctxt * d_alloc_ctxt(struct rohc_decomp *const decomp,
+                                              const rohc_cid_t cid)
+	__attribute__((nonnull(1), warn_unused_result));
 static void context_free(struct rohc_decomp_ctxt *const context)
 	__attribute__((nonnull(1)));
 
+static void d_ctxt_lru_push(struct rohc_decomp *const decomp,
+                            struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void d_ctxt_lru_unlink(struct rohc_decomp *const decomp,
+                              struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1, 2)));
+static void d_expire_contexts(struct rohc_decomp *const decomp,
+                              const struct rohc_ts arrival_time)
+	__attribute__((nonnull(1)));
+static size_t d_mem_usage(const struct rohc_decomp *const decomp)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static void d_flight_record(struct rohc_decomp *const decomp,
+                            const struct rohc_decomp_stream *const stream,
+                            const rohc_status_t status)
+	__attribute__((nonnull(1, 2)));
+static size_t d_flight_get(const struct rohc_decomp_flight *const flight,
+                           struct rohc_decomp_flight_pkt pkts[],
+                           const size_t pkts_nr)
+	__attribute__((nonnull(1, 2), warn_unused_result));
+
+static bool rohc_decomp_check_bufs(const struct rohc_decomp *const decomp,
+                                   const struct rohc_buf rohc_packet,
+                                   const struct rohc_buf *const uncomp_packet)
+	__attribute__((nonnull(1), warn_unused_result));
+static bool rohc_decomp_check_feedback_bufs(const struct rohc_decomp *const decomp,
+                                            const struct rohc_buf *const rcvd_feedback,
+                                            const struct rohc_buf *const feedback_send)
+	__attribute__((nonnull(1), warn_unused_result));
+static bool rohc_decomp_get_pkt_cid(const struct rohc_decomp *const decomp,
+                                    const struct rohc_buf rohc_packet,
+                                    rohc_cid_t *const cid)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static const struct rohc_decomp_ctxt *
+	rohc_decomp_get_pkt_ctxt(const struct rohc_decomp *const decomp,
+	                         const struct rohc_buf rohc_packet)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void rohc_decomp_group_pkts(const struct rohc_decomp *const decomp,
+                                   const struct rohc_buf rohc_packets[],
+                                   const size_t pkts_nr,
+                                   size_t order[ROHC_DECOMP_BURST_GROUP])
+	__attribute__((nonnull(1, 2, 4)));
+static void rohc_decomp_prefetch_ctxt(const struct rohc_decomp *const decomp,
+                                      const struct rohc_buf rohc_packet)
+	__attribute__((nonnull(1)));
+static void rohc_decomp_prefetch_ctxt_data(const struct rohc_decomp *const decomp,
+                                           const struct rohc_buf rohc_packet)
+	__attribute__((nonnull(1)));
+
+static bool rohc_decomp_check_cfg(const struct rohc_decomp *const decomp,
+                                  const struct rohc_decomp_cfg *const cfg)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void rohc_decomp_take_cfg(struct rohc_decomp *const decomp)
+	__attribute__((nonnull(1)));
+
+static rohc_status_t rohc_decomp_decompress_pkt(struct rohc_decomp *const decomp,
+                                                const struct rohc_buf rohc_packet,
+                                                struct rohc_buf *const uncomp_packet,
+                                                struct rohc_buf *const payload,
+                                                struct rohc_buf *const rcvd_feedback,
+                                                struct rohc_buf *const feedback_send)
+	__attribute__((nonnull(1, 3), warn_unused_result));
+static void rohc_decomp_parse_fields(const struct rohc_decomp *const decomp,
+                                     struct rohc_buf *const hdrs,
+                                     struct rohc_decomp_fields *const fields)
+	__attribute__((nonnull(1, 2, 3)));
+static size_t rohc_decomp_parse_fields_hdrs(const uint8_t *const data,
+                                            const size_t len,
+                                            const bool has_rtp,
+                                            struct rohc_decomp_fields *const fields)
+	__attribute__((warn_unused_result, nonnull(1, 4)));
+static void rohc_decomp_coalesce_feedback(const struct rohc_decomp *const decomp,
+                                          struct rohc_buf *const feedback)
+	__attribute__((nonnull(1, 2)));
+static bool rohc_decomp_parse_feedback_item(const struct rohc_decomp *const decomp,
+                                            const struct rohc_buf feedback,
+                                            struct rohc_decomp_feedback_item *const item)
+	__attribute__((nonnull(1, 3), warn_unused_result));
+
 static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
                                      const struct rohc_buf rohc_packet,
                                      struct rohc_buf *const uncomp_packet,
+                                     struct rohc_buf *const payload,
                                      struct rohc_buf *const rcvd_feedback,
                                      struct rohc_decomp_stream *const stream)
-	__attribute__((nonnull(1, 3, 5), warn_unused_result));
+	__attribute__((nonnull(1, 3, 6), warn_unused_result));
 
 static bool rohc_decomp_decode_cid(struct rohc_decomp *decomp,
                                    const uint8_t *packet,
@@ -179,9 +362,10 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
                                             const size_t add_cid_len,
                                             const size_t large_cid_len,
                                             struct rohc_buf *const uncomp_packet,
+                                            struct rohc_buf *const payload,
                                             rohc_packet_t *const packet_type,
                                             bool *const do_change_mode)
-	__attribute__((warn_unused_result, nonnull(1, 2, 6, 7, 8)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 6, 8, 9)));
 
 static bool rohc_decomp_check_ir_crc(const struct rohc_decomp *const decomp,
                                      const struct rohc_decomp_ctxt *const context,
@@ -189,13 +373,15 @@ static bool rohc_decomp_check_ir_crc(const struct rohc_decomp *const decomp,
                                      const size_t rohc_hdr_len,
                                      const size_t add_cid_len,
                                      const size_t large_cid_len,
-                                     const uint8_t crc_packet)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+                                     struct rohc_decomp_crc *const extr_crc)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 7)));
 
 static void rohc_decomp_stats_add_success(struct rohc_decomp_ctxt *const context,
                                           const size_t comp_hdr_len,
                                           const size_t uncomp_hdr_len)
 	__attribute__((nonnull(1)));
+static void rohc_decomp_stats_record_last(struct rohc_decomp *const decomp)
+	__attribute__((nonnull(1)));
 
 static void rohc_decomp_update_context(struct rohc_decomp_ctxt *const context,
                                        const void *const decoded_values,
@@ -210,10 +396,10 @@ static bool rohc_decomp_parse_feedbacks(struct rohc_decomp *const decomp,
                                         struct rohc_buf *const feedbacks)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
 static bool rohc_decomp_parse_feedback(struct rohc_decomp *const decomp,
-                                       struct rohc_buf *const rohc_data,
-                                       struct rohc_buf *const feedback,
+                                       const struct rohc_buf rohc_data,
+                                       const size_t offset,
                                        size_t *const feedback_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
+	__attribute__((warn_unused_result, nonnull(1, 4)));
 
 /* function related to the transmission of feedback to the remote ROHC compressor */
 static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
@@ -224,6 +410,14 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
                                       const struct rohc_decomp_stream *const stream,
                                       struct rohc_buf *const feedback)
 	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool rohc_decomp_feedback_fits_rates(struct rohc_decomp *const decomp,
+                                            const struct rohc_decomp_stream *const stream,
+                                            const size_t feedback_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static void rohc_feedback_bucket_refill(struct rohc_feedback_bucket *const bucket,
+                                        const size_t byte_rate,
+                                        const struct rohc_ts now)
+	__attribute__((nonnull(1)));
 
 /* statistics-related functions */
 static void rohc_decomp_reset_stats(struct rohc_decomp *const decomp)
@@ -251,9 +445,155 @@ static bool rohc_decomp_packet_carry_crc_7_or_8(const rohc_packet_t packet_type)
 static struct rohc_decomp_ctxt * find_context(const struct rohc_decomp *const decomp,
                                               const rohc_cid_t cid)
 {
+	struct rohc_decomp_ctxt *page;
+
 	/* CID must be valid wrt MAX_CID */
 	assert(cid <= decomp->medium.max_cid);
-	return decomp->contexts[cid];
+
+	/* the context with the given CID must be allocated and in use */
+	page = decomp->ctxt_pages[cid / ROHC_DECOMP_CTXT_PAGE_LEN];
+	if(page == NULL || !page[cid % ROHC_DECOMP_CTXT_PAGE_LEN].used)
+	{
+		return NULL;
+	}
+
+	return &(page[cid % ROHC_DECOMP_CTXT_PAGE_LEN]);
+}
+
+
+/**
+ * @brief Find the base context that an IR-CR packet replicates
+ *
+ * The base context shall use the same profile as the given context and shall
+ * have been initialized by one packet at least. It may be the given context
+ * itself if the IR-CR packet refreshes the context from its own content.
+ *
+ * @param context   The decompression context being initialized
+ * @param base_cid  The CID of the base context found in the IR-CR packet
+ * @return          The base context if found, NULL otherwise
+ */
+const struct rohc_decomp_ctxt *
+	rohc_decomp_find_base_ctxt(const struct rohc_decomp_ctxt *const context,
+	                           const rohc_cid_t base_cid)
+{
+	const struct rohc_decomp *const decomp = context->decompressor;
+	const struct rohc_decomp_ctxt *base_ctxt;
+
+	if(base_cid > decomp->medium.max_cid)
+	{
+		rohc_decomp_warn(context, "base CID %zu is greater than MAX_CID %zu",
+		                 base_cid, decomp->medium.max_cid);
+		goto error;
+	}
+
+	base_ctxt = find_context(decomp, base_cid);
+	if(base_ctxt == NULL)
+	{
+		rohc_decomp_warn(context, "base context with CID %zu does not exist",
+		                 base_cid);
+		goto error;
+	}
+	if(base_ctxt->profile != context->profile)
+	{
+		rohc_decomp_warn(context, "base context with CID %zu uses profile '%s' "
+		                 "(0x%04x)", base_cid,
+		                 rohc_get_profile_descr(base_ctxt->profile->id),
+		                 base_ctxt->profile->id);
+		goto error;
+	}
+	if(base_ctxt->state == ROHC_DECOMP_STATE_NC)
+	{
+		rohc_decomp_warn(context, "base context with CID %zu is not initialized "
+		                 "yet", base_cid);
+		goto error;
+	}
+
+	return base_ctxt;
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Change the state of the given decompression context
+ *
+ * @param context    The decompression context
+ * @param new_state  The new state the context must enter in
+ */
+void rohc_decomp_change_state(struct rohc_decomp_ctxt *const context,
+                              const rohc_decomp_state_t new_state)
+{
+	if(new_state != context->state)
+	{
+		rohc_trace_event(context->decompressor, ROHC_TRACE_DECOMP,
+		                 ROHC_TRACE_EVENT_DECOMP_STATE, context->profile->id,
+		                 context->cid, ROHC_PACKET_UNKNOWN, context->state,
+		                 new_state, 0);
+		context->state = new_state;
+	}
+}
+
+
+/**
+ * @brief Change the mode of the given decompression context
+ *
+ * @param context   The decompression context
+ * @param new_mode  The new mode the context must enter in
+ */
+void rohc_decomp_change_mode(struct rohc_decomp_ctxt *const context,
+                             const rohc_mode_t new_mode)
+{
+	if(new_mode != context->mode)
+	{
+		rohc_trace_event(context->decompressor, ROHC_TRACE_DECOMP,
+		                 ROHC_TRACE_EVENT_DECOMP_MODE, context->profile->id,
+		                 context->cid, ROHC_PACKET_UNKNOWN, context->mode,
+		                 new_mode, 0);
+		context->mode = new_mode;
+	}
+}
+
+
+/**
+ * @brief Get the decompression context with the given CID, allocate it if needed
+ *
+ * Decompression contexts are allocated by pages of ROHC_DECOMP_CTXT_PAGE_LEN
+ * contexts the first time one CID of the page is used. Pages are never freed
+ * before the decompressor is destroyed, so contexts never move in memory.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param cid     The CID of the context
+ * @return        The context with the given CID (in use or not),
+ *                NULL if memory is missing
+ */
+static struct rohc_decomp_ctxt * d_alloc_ctxt(struct rohc_decomp *const decomp,
+                                              const rohc_cid_t cid)
+{
+	const size_t page_idx = cid / ROHC_DECOMP_CTXT_PAGE_LEN;
+
+	assert(cid <= decomp->medium.max_cid);
+
+	if(decomp->ctxt_pages[page_idx] == NULL)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		           "allocate page #%zu of %u contexts for CID %zu", page_idx,
+		           ROHC_DECOMP_CTXT_PAGE_LEN, cid);
+		decomp->ctxt_pages[page_idx] =
+			rohc_mem_calloc(&decomp->mem_ops, ROHC_DECOMP_CTXT_PAGE_LEN,
+			                sizeof(struct rohc_decomp_ctxt));
+		if(decomp->ctxt_pages[page_idx] == NULL)
+		{
+			goto error;
+		}
+		decomp->ctxts_mem_len +=
+			ROHC_DECOMP_CTXT_PAGE_LEN * sizeof(struct rohc_decomp_ctxt);
+	}
+
+	return &(decomp->ctxt_pages[page_idx][cid % ROHC_DECOMP_CTXT_PAGE_LEN]);
+
+error:
+	return NULL;
 }
 
 
@@ -278,14 +618,43 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	assert(cid <= ROHC_LARGE_CID_MAX);
 	assert(profile != NULL);
 
-	/* allocate memory for the decompression context */
-	context = (struct rohc_decomp_ctxt *) malloc(sizeof(struct rohc_decomp_ctxt));
+	/* a context for a new CID needs more memory: once the memory budget is
+	 * exhausted, destroy the least recently used context to make room */
+	if(decomp->mem_budget != 0 && decomp->lru_last != NULL &&
+	   find_context(decomp, cid) == NULL &&
+	   d_mem_usage(decomp) >= decomp->mem_budget)
+	{
+		struct rohc_decomp_ctxt *const oldest = decomp->lru_last;
+
+		rohc_info(decomp, ROHC_TRACE_DECOMP, oldest->profile->id,
+		          "memory budget of %zu bytes exhausted, destroy the oldest "
+		          "context with CID %zu", decomp->mem_budget, oldest->cid);
+		if(decomp->last_context == oldest)
+		{
+			decomp->last_context = NULL;
+		}
+		context_free(oldest);
+		rohc_trace_event(decomp, ROHC_TRACE_DECOMP,
+		                 ROHC_TRACE_EVENT_DECOMP_CTXT_EVICT, oldest->profile->id,
+		                 oldest->cid, ROHC_PACKET_UNKNOWN, ROHC_TRACE_EVICT_MEM,
+		                 decomp->num_contexts_used, 0);
+	}
+
+	/* get the decompression context in its page, or the spare context if the
+	 * CID is already in use: the new context replaces the old one only if the
+	 * IR packet is successfully decompressed */
+	context = d_alloc_ctxt(decomp, cid);
 	if(context == NULL)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
 		             "cannot allocate memory for the contexts");
 		goto error;
 	}
+	if(context->used)
+	{
+		context = decomp->spare_ctxt;
+		assert(!context->used);
+	}
 
 	/* record the CID */
 	context->cid = cid;
@@ -308,11 +677,17 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	context->last_pkt_feedbacks[ROHC_FEEDBACK_NACK].sent = 0;
 	context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].needed = 0;
 	context->last_pkt_feedbacks[ROHC_FEEDBACK_STATIC_NACK].sent = 0;
+	context->feedback_bucket.tokens =
+		((uint64_t) decomp->ack_rate_limits.ctxt_byte_rate) * 1000000U;
+	context->feedback_bucket.last_refill = arrival_time;
+	context->feedback_tmpl.is_built = false;
+	context->is_ack_deferred = false;
 
 	/* init the context for packet/context corrections upon CRC failures */
 	/* at the beginning, no attempt to correct CRC failure */
 	context->crc_corr.algo = ROHC_DECOMP_CRC_CORR_SN_NONE;
 	context->crc_corr.counter = 0;
+	context->crc_corr.cands_nr = 0;
 	/* arrival times for correction upon CRC failure */
 	memset(context->crc_corr.arrival_times, 0,
 	       sizeof(struct rohc_ts) * ROHC_MAX_ARRIVAL_TIMES);
@@ -335,6 +710,13 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 	context->first_used = arrival_time.sec;
 	context->latest_used = arrival_time.sec;
 
+	/* the packets of the previous context at the same CID are forgotten */
+	if(context->flight != NULL)
+	{
+		context->flight->pkts_nr = 0;
+		context->flight->next = 0;
+	}
+
 	/* create the profile-specific parts of the decompression context (performed
 	 * at the every end so that everything is initialized in context first) */
 	if(!profile->new_context(context, &context->persist_ctxt, &context->volat_ctxt))
@@ -342,7 +724,15 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
 		             "failed to initialize the profile-specific parts of the "
 		             "decompression context");
-		goto destroy_context;
+		goto error;
+	}
+	context->used = true;
+
+	/* the spare context joins the LRU list only if it replaces the context
+	 * of its CID */
+	if(context != decomp->spare_ctxt)
+	{
+		d_ctxt_lru_push(decomp, context);
 	}
 
 	/* decompressor got one more context (for a short moment, decompressor
@@ -352,8 +742,6 @@ static struct rohc_decomp_ctxt * context_create(struct rohc_decomp *decomp,
 
 	return context;
 
-destroy_context:
-	zfree(context);
 error:
 	return NULL;
 }
@@ -376,12 +764,219 @@ static void context_free(struct rohc_decomp_ctxt *const context)
 	/* destroy the profile-specific data */
 	context->profile->free_context(context->persist_ctxt, &context->volat_ctxt);
 
+	/* the spare context is never in the LRU list */
+	if(context != context->decompressor->spare_ctxt)
+	{
+		d_ctxt_lru_unlink(context->decompressor, context);
+	}
+
 	/* decompressor got one more context */
 	assert(context->decompressor->num_contexts_used > 0);
 	context->decompressor->num_contexts_used--;
 
-	/* destroy the context itself */
-	free(context);
+	/* the context itself remains in its page for the next context */
+	context->used = false;
+}
+
+
+/**
+ * @brief Insert one decompression context at the head of the LRU list
+ *
+ * @param decomp   The ROHC decompressor
+ * @param context  The decompression context that was just used
+ */
+static void d_ctxt_lru_push(struct rohc_decomp *const decomp,
+                            struct rohc_decomp_ctxt *const context)
+{
+	context->lru_prev = NULL;
+	context->lru_next = decomp->lru_first;
+	if(decomp->lru_first != NULL)
+	{
+		decomp->lru_first->lru_prev = context;
+	}
+	else
+	{
+		decomp->lru_last = context;
+	}
+	decomp->lru_first = context;
+}
+
+
+/**
+ * @brief Remove one decompression context from the LRU list
+ *
+ * @param decomp   The ROHC decompressor
+ * @param context  The decompression context to remove from the LRU list
+ */
+static void d_ctxt_lru_unlink(struct rohc_decomp *const decomp,
+                              struct rohc_decomp_ctxt *const context)
+{
+	if(context->lru_prev != NULL)
+	{
+		context->lru_prev->lru_next = context->lru_next;
+	}
+	else
+	{
+		assert(decomp->lru_first == context);
+		decomp->lru_first = context->lru_next;
+	}
+	if(context->lru_next != NULL)
+	{
+		context->lru_next->lru_prev = context->lru_prev;
+	}
+	else
+	{
+		assert(decomp->lru_last == context);
+		decomp->lru_last = context->lru_prev;
+	}
+	context->lru_prev = NULL;
+	context->lru_next = NULL;
+}
+
+
+/**
+ * @brief Destroy the decompression contexts that were not used for too long
+ *
+ * The least recently used contexts are at the end of the LRU list: walk the
+ * list backwards until one context was used recently enough.
+ *
+ * @param decomp        The ROHC decompressor
+ * @param arrival_time  The arrival time of the packet being decompressed
+ */
+static void d_expire_contexts(struct rohc_decomp *const decomp,
+                              const struct rohc_ts arrival_time)
+{
+	while(decomp->lru_last != NULL &&
+	      arrival_time.sec >= decomp->lru_last->latest_used &&
+	      (arrival_time.sec - decomp->lru_last->latest_used) >=
+	      decomp->ctxt_idle_timeout)
+	{
+		struct rohc_decomp_ctxt *const context = decomp->lru_last;
+
+		rohc_info(decomp, ROHC_TRACE_DECOMP, context->profile->id, "destroy "
+		          "context with CID %zu unused for more than %zu seconds",
+		          context->cid, decomp->ctxt_idle_timeout);
+		if(decomp->last_context == context)
+		{
+			decomp->last_context = NULL;
+		}
+		context_free(context);
+		rohc_trace_event(decomp, ROHC_TRACE_DECOMP,
+		                 ROHC_TRACE_EVENT_DECOMP_CTXT_EVICT, context->profile->id,
+		                 context->cid, ROHC_PACKET_UNKNOWN, ROHC_TRACE_EVICT_IDLE,
+		                 decomp->num_contexts_used, 0);
+	}
+}
+
+
+/**
+ * @brief Get the number of bytes the decompressor uses
+ *
+ * @param decomp  The ROHC decompressor
+ * @return        The number of bytes the decompressor uses
+ */
+static size_t d_mem_usage(const struct rohc_decomp *const decomp)
+{
+	return (sizeof(struct rohc_decomp) + decomp->mrru +
+	        decomp->ctxt_pages_nr * sizeof(struct rohc_decomp_ctxt *) +
+	        sizeof(struct rohc_decomp_ctxt) +
+	        decomp->ctxts_mem_len + decomp->ctxt_slab->mem_len +
+	        rohc_intern_mem_len(decomp->static_store));
+}
+
+
+/**
+ * @brief Record one packet in the flight recorder of its context
+ *
+ * The recorded packets are given to the user-defined callback if the packet
+ * failed the CRC check or if it damaged the context.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param stream  The information collected on the packet, its context shall
+ *                be known
+ * @param status  The status of the decompression of the packet
+ */
+static void d_flight_record(struct rohc_decomp *const decomp,
+                            const struct rohc_decomp_stream *const stream,
+                            const rohc_status_t status)
+{
+	struct rohc_decomp_ctxt *const context = stream->context;
+	struct rohc_decomp_flight *flight = context->flight;
+	struct rohc_decomp_flight_pkt *pkt;
+
+	/* the recorder is allocated the first time it is needed, then it is kept
+	 * until the decompressor is destroyed */
+	if(flight == NULL)
+	{
+		flight = rohc_mem_calloc(&decomp->mem_ops, 1,
+		                         sizeof(struct rohc_decomp_flight));
+		if(flight == NULL)
+		{
+			rohc_decomp_debug(context, "no memory to record the packet");
+			return;
+		}
+		context->flight = flight;
+		decomp->ctxts_mem_len += sizeof(struct rohc_decomp_flight);
+	}
+
+	pkt = &flight->pkts[flight->next];
+	pkt->time = stream->arrival_time;
+	pkt->sn = context->profile->get_sn(context);
+	pkt->len = rohc_min(stream->hdr_len, 0xffff);
+	pkt->packet_type = stream->packet_type;
+	pkt->status = status;
+	pkt->state = context->state;
+	pkt->bytes_nr = rohc_min(stream->hdr_len, ROHC_DECOMP_FLIGHT_BYTES_MAX);
+	if(pkt->bytes_nr > 0)
+	{
+		memcpy(pkt->bytes, stream->hdr, pkt->bytes_nr);
+	}
+	flight->next = (flight->next + 1) % ROHC_DECOMP_FLIGHT_PKTS_NR;
+	if(flight->pkts_nr < ROHC_DECOMP_FLIGHT_PKTS_NR)
+	{
+		flight->pkts_nr++;
+	}
+
+	/* give the last packets to the user if the context failed */
+	if(decomp->flight_cb != NULL &&
+	   (status == ROHC_STATUS_BAD_CRC || context->state < stream->state))
+	{
+		struct rohc_decomp_flight_pkt pkts[ROHC_DECOMP_FLIGHT_PKTS_NR];
+		const size_t pkts_nr =
+			d_flight_get(flight, pkts, ROHC_DECOMP_FLIGHT_PKTS_NR);
+
+		rohc_decomp_debug(context, "give the %zu last packets of the context "
+		                  "to the user", pkts_nr);
+		decomp->flight_cb(decomp->flight_cb_priv, context->cid,
+		                  context->profile->id, pkts, pkts_nr);
+	}
+}
+
+
+/**
+ * @brief Copy the last packets of one flight recorder, the oldest first
+ *
+ * @param flight       The flight recorder
+ * @param[out] pkts    The recorded packets
+ * @param pkts_nr      The maximal number of packets to copy
+ * @return             The number of packets copied, the most recent ones if
+ *                     more packets are recorded
+ */
+static size_t d_flight_get(const struct rohc_decomp_flight *const flight,
+                           struct rohc_decomp_flight_pkt pkts[],
+                           const size_t pkts_nr)
+{
+	const size_t copied_nr = rohc_min(flight->pkts_nr, pkts_nr);
+	size_t i;
+
+	for(i = 0; i < copied_nr; i++)
+	{
+		const size_t idx = (flight->next + ROHC_DECOMP_FLIGHT_PKTS_NR -
+		                    copied_nr + i) % ROHC_DECOMP_FLIGHT_PKTS_NR;
+		memcpy(&pkts[i], &flight->pkts[idx], sizeof(struct rohc_decomp_flight_pkt));
+	}
+
+	return copied_nr;
 }
 
 
@@ -410,8 +1005,8 @@ static void context_free(struct rohc_decomp_ctxt *const context)
  *                    \li \ref ROHC_O_MODE for the Bidirectional Optimistic
  *                        mode,
  *                    \li \ref ROHC_R_MODE for the Bidirectional Reliable mode
- *                        is not supported yet: specifying \ref ROHC_R_MODE is
- *                        an error.
+ *                        (the profiles of RFC 3095 only, the other profiles
+ *                        use the O-mode instead).
  * @return          The created decompressor if successful,
  *                  NULL if creation failed
  *
@@ -441,12 +1036,56 @@ static void context_free(struct rohc_decomp_ctxt *const context)
  * @see rohc_decomp_disable_profile
  * @see rohc_decomp_set_mrru
  * @see rohc_decomp_set_features
+ * @see rohc_decomp_new3
  */
 struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
                                       const rohc_cid_t max_cid,
                                       const rohc_mode_t mode)
 {
+	return rohc_decomp_new3(cid_type, max_cid, mode, NULL);
+}
+
 
+/**
+ * @brief Create a new ROHC decompressor that allocates with the given functions
+ *
+ * Create a new ROHC decompressor like \ref rohc_decomp_new2 does, but
+ * allocate all its memory with the given memory operations: the
+ * decompressor itself, its contexts and its buffers. The decompressor
+ * structure is allocated with the \e aligned_alloc function if any, aligned
+ * on a cache line.
+ *
+ * The profile-specific parts of the contexts are allocated with the same
+ * functions, unless other ones are set with \ref rohc_decomp_set_alloc_cbs.
+ *
+ * @param cid_type  The type of Context IDs (CID) that the ROHC decompressor
+ *                  shall operate with, see \ref rohc_decomp_new2
+ * @param max_cid   The maximum value that the ROHC decompressor should use
+ *                  for context IDs (CID), see \ref rohc_decomp_new2
+ * @param mode      The operational mode that the ROHC decompressor shall
+ *                  target, see \ref rohc_decomp_new2
+ * @param mem_ops   The functions to allocate and free memory with, NULL to
+ *                  use malloc() and free(); the structure is copied
+ * @return          The created decompressor if successful,
+ *                  NULL if creation failed
+ *
+ * @warning Don't forget to free decompressor memory with
+ *          \ref rohc_decomp_free if rohc_decomp_new3 succeeded
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_new2
+ * @see rohc_decomp_free
+ * @see rohc_decomp_set_alloc_cbs
+ */
+struct rohc_decomp * rohc_decomp_new3(const rohc_cid_type_t cid_type,
+                                      const rohc_cid_t max_cid,
+                                      const rohc_mode_t mode,
+                                      const struct rohc_mem_ops *const mem_ops)
+{
+	const struct rohc_mem_ops default_mem_ops = { NULL, NULL, NULL, NULL };
+	const struct rohc_mem_ops *const ops =
+		(mem_ops != NULL ? mem_ops : &default_mem_ops);
 	struct rohc_decomp *decomp;
 	bool is_fine;
 	size_t i;
@@ -473,30 +1112,75 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 		/* unexpected CID type */
 		goto error;
 	}
+#ifdef ROHC_FIXED_CID_TYPE
+	if(cid_type != ROHC_FIXED_CID_TYPE)
+	{
+		/* the library is built for the other CID type only */
+		goto error;
+	}
+#endif
 	if(mode != ROHC_U_MODE && mode != ROHC_O_MODE && mode != ROHC_R_MODE)
 	{
 		/* unexpected operational mode */
 		goto error;
 	}
-	else if(mode == ROHC_R_MODE)
+	if(!rohc_mem_ops_check(mem_ops))
 	{
-		/* R-mode is not supported yet */
 		goto error;
 	}
 
 	/* allocate memory for the decompressor */
-	decomp = (struct rohc_decomp *) malloc(sizeof(struct rohc_decomp));
+	decomp = rohc_mem_aligned_alloc(ops, ROHC_MEM_CACHE_LINE_LEN,
+	                                sizeof(struct rohc_decomp));
 	if(decomp == NULL)
 	{
 		goto error;
 	}
+	decomp->mem_ops = *ops;
+
+	/* contexts are allocated from the slab of the decompressor, with the
+	 * same functions by default */
+	rohc_slab_init(&decomp->ctxt_slab_own);
+	if(ops->alloc != NULL &&
+	   !rohc_slab_set_cbs(&decomp->ctxt_slab_own, ops->alloc, ops->free,
+	                      ops->priv))
+	{
+		goto destroy_decomp;
+	}
+	rohc_intern_init(&decomp->static_store_own, &decomp->ctxt_slab_own,
+	                 &decomp->mem_ops);
+	decomp->ctxt_slab = &decomp->ctxt_slab_own;
+	decomp->static_store = &decomp->static_store_own;
+	decomp->engine = NULL;
+	decomp->cfg_pending = NULL;
 
-	/* no trace callback during decompressor creation */
+	/* no trace callback during decompressor creation, all the contexts are
+	 * traced once a callback is given */
 	decomp->trace_callback = NULL;
 	decomp->trace_callback_priv = NULL;
+	rohc_trace_filter_init(&decomp->trace_filter, NULL);
 
-	/* default feature set (empty for the moment) */
+	/* no callback for the recorded packets of the damaged contexts */
+	decomp->flight_cb = NULL;
+	decomp->flight_cb_priv = NULL;
+
+	/* no ring of trace records during decompressor creation, all the events
+	 * are recorded once a ring is given */
+	decomp->trace_ring = NULL;
+	decomp->trace_events = ROHC_TRACE_EVENTS_ALL;
+
+#if ROHC_PERF_STATS == 1
+	/* no stage measured yet */
+	memset(&decomp->perf, 0, sizeof(decomp->perf));
+#endif
+
+	/* default feature set (empty for the moment, unless the library is built
+	 * for one set of features only) */
+#ifdef ROHC_FIXED_DECOMP_FEATURES
+	decomp->features = ROHC_FIXED_DECOMP_FEATURES;
+#else
 	decomp->features = ROHC_DECOMP_FEATURE_NONE;
+#endif
 
 	/* init decompressor medium */
 	decomp->medium.cid_type = cid_type;
@@ -512,8 +1196,12 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 	decomp->target_mode = mode;
 
 	/* initialize the array of decompression contexts to its minimal value */
-	decomp->contexts = NULL;
+	decomp->ctxt_pages = NULL;
+	decomp->ctxt_pages_nr = 0;
+	decomp->spare_ctxt = NULL;
 	decomp->num_contexts_used = 0;
+	decomp->lru_first = NULL;
+	decomp->lru_last = NULL;
 	is_fine = rohc_decomp_create_contexts(decomp, decomp->medium.max_cid);
 	if(!is_fine)
 	{
@@ -521,6 +1209,20 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 	}
 	decomp->last_context = NULL;
 
+	/* contexts never expire by default */
+	decomp->ctxt_idle_timeout = 0;
+
+	/* no memory budget by default */
+	decomp->mem_budget = 0;
+
+	/* never overloaded by default */
+	decomp->overload_limits.queue_depth = 0;
+	decomp->overload_limits.burst_time_us = 0;
+	decomp->is_overloaded = false;
+
+	/* packets are expected in order by default */
+	decomp->reorder_window = 0;
+
 	/* counters and thresholds for feedbacks and downward state transitions */
 	{
 		const size_t rtt = 1000U; /* conservative 1-second RTT */
@@ -530,6 +1232,11 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 		assert(is_fine);
 		is_fine = rohc_decomp_set_rate_limits(decomp, 1, prtt, 30, 100, 30, 100);
 		assert(is_fine);
+		decomp->ack_rate_limits.decomp_byte_rate = 0;
+		decomp->ack_rate_limits.ctxt_byte_rate = 0;
+		decomp->feedback_bucket.tokens = 0;
+		decomp->feedback_bucket.last_refill.sec = 0;
+		decomp->feedback_bucket.last_refill.nsec = 0;
 		decomp->last_pkts_errors = 0;
 		decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed = 0;
 		decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].sent = 0;
@@ -540,38 +1247,186 @@ struct rohc_decomp * rohc_decomp_new2(const rohc_cid_type_t cid_type,
 	}
 
 	/* no Reconstructed Reception Unit (RRU) at the moment */
+	decomp->rru = NULL;
 	decomp->rru_len = 0;
+	decomp->rru_crc = CRC_INIT_FCS32;
+	decomp->rru_crc_len = 0;
 	/* no segmentation by default */
 	decomp->mrru = 0;
 
-	/* init the tables for fast CRC computation */
-	is_fine = rohc_crc_init_table(decomp->crc_table_3, ROHC_CRC_TYPE_3);
-	if(is_fine != true)
+	/* reset the decompressor statistics */
+	rohc_decomp_reset_stats(decomp);
+
+	return decomp;
+
+destroy_decomp:
+	rohc_mem_free(ops, decomp);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Create a new ROHC decompressor in the given memory block
+ *
+ * Create a new ROHC decompressor like \ref rohc_decomp_new2 does, but carve
+ * all its memory from the given memory block: the decompressor itself, its
+ * contexts and its buffers. The decompressor never allocates memory from the
+ * heap, so its memory usage is bounded by the length of the block. A block
+ * of \ref rohc_decomp_mem_size bytes is large enough to decompress packets
+ * with all the MAX_CID + 1 contexts, so no allocation ever fails while
+ * packets are decompressed.
+ *
+ * The block remains owned by the caller: it shall stay valid until the
+ * decompressor is destroyed with \ref rohc_decomp_free, and it may be used
+ * again afterwards. The memory functions of the decompressor cannot be
+ * changed with \ref rohc_decomp_set_alloc_cbs.
+ *
+ * @param cid_type  The type of Context IDs (CID) that the ROHC decompressor
+ *                  shall operate with, see \ref rohc_decomp_new2
+ * @param max_cid   The maximum value that the ROHC decompressor should use
+ *                  for context IDs (CID), see \ref rohc_decomp_new2
+ * @param mode      The operational mode that the ROHC decompressor shall
+ *                  target, see \ref rohc_decomp_new2
+ * @param mem       The memory block to carve the decompressor from, aligned
+ *                  or not
+ * @param mem_len   The length of the memory block
+ * @return          The created decompressor if successful,
+ *                  NULL if creation failed or if the block is too small
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_mem_size
+ * @see rohc_decomp_free
+ */
+struct rohc_decomp * rohc_decomp_new_static(const rohc_cid_type_t cid_type,
+                                            const rohc_cid_t max_cid,
+                                            const rohc_mode_t mode,
+                                            void *const mem,
+                                            const size_t mem_len)
+{
+	struct rohc_mem_block *block;
+	struct rohc_mem_ops mem_ops;
+
+	block = rohc_mem_block_init(mem, mem_len);
+	if(block == NULL)
 	{
-		goto destroy_contexts;
+		goto error;
 	}
-	is_fine = rohc_crc_init_table(decomp->crc_table_7, ROHC_CRC_TYPE_7);
-	if(is_fine != true)
+	mem_ops.alloc = rohc_mem_block_alloc;
+	mem_ops.aligned_alloc = NULL; /* all the areas are aligned on cache lines */
+	mem_ops.free = rohc_mem_block_free;
+	mem_ops.priv = block;
+
+	return rohc_decomp_new3(cid_type, max_cid, mode, &mem_ops);
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Get the length of the memory block a static ROHC decompressor needs
+ *
+ * The length is the worst case for a decompressor created with
+ * \ref rohc_decomp_new_static that uses all its MAX_CID + 1 contexts with
+ * the given profiles: every context is counted with the largest profile,
+ * the spare context that receives the IR packets re-using a CID is counted
+ * too, and so is the slab of contexts with one partly-used chunk per size of
+ * block. The length depends only on the parameters, not on the traffic.
+ *
+ * The length covers the default configuration of the decompressor: enabling
+ * segmentation with \ref rohc_decomp_set_mrru needs more memory, and so do
+ * other profiles. A smaller block may be given together with a memory
+ * budget, see \ref rohc_decomp_set_mem_budget.
+ *
+ * @param cid_type     The type of Context IDs (CID) of the decompressor
+ * @param max_cid      The maximum CID of the decompressor
+ * @param profiles     The profiles the decompressor shall enable
+ * @param profiles_nr  The number of profiles in \e profiles
+ * @return             The length (in bytes) of the memory block,
+ *                     0 if the parameters are invalid or if one profile
+ *                     is not supported
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_new_static
+ */
+size_t rohc_decomp_mem_size(const rohc_cid_type_t cid_type,
+                            const rohc_cid_t max_cid,
+                            const rohc_profile_t profiles[],
+                            const size_t profiles_nr)
+{
+	/* all the contexts plus the spare context */
+	const size_t ctxts_nr = max_cid + 2;
+	const size_t pages_nr =
+		(max_cid + ROHC_DECOMP_CTXT_PAGE_LEN) / ROHC_DECOMP_CTXT_PAGE_LEN;
+	size_t ctxt_mem_max = 0;
+	size_t interned_nr = 0;
+	size_t mem_len;
+	size_t i;
+
+	/* check input parameters */
+	if(!((cid_type == ROHC_SMALL_CID && max_cid <= ROHC_SMALL_CID_MAX) ||
+	     (cid_type == ROHC_LARGE_CID && max_cid <= ROHC_LARGE_CID_MAX)))
 	{
-		goto destroy_contexts;
+		goto error;
 	}
-	is_fine = rohc_crc_init_table(decomp->crc_table_8, ROHC_CRC_TYPE_8);
-	if(is_fine != true)
+	if(profiles == NULL || profiles_nr == 0)
 	{
-		goto destroy_contexts;
+		goto error;
 	}
 
-	/* reset the decompressor statistics */
-	rohc_decomp_reset_stats(decomp);
+	/* every context is counted with the largest profile */
+	for(i = 0; i < profiles_nr; i++)
+	{
+		const size_t profile_idx = rohc_decomp_get_profile_idx(profiles[i]);
+		const struct rohc_decomp_profile *profile;
 
-	return decomp;
+		if(profile_idx == ROHC_DECOMP_PROFILE_IDX_NONE)
+		{
+			goto error;
+		}
+		profile = rohc_decomp_profiles[profile_idx];
+		ctxt_mem_max = rohc_max(ctxt_mem_max, profile->get_mem_max());
+
+		/* the contexts of the TCP profile share the IPv6 addresses of their IP
+		 * headers */
+		if(profile->id == ROHC_PROFILE_TCP)
+		{
+			interned_nr = ROHC_TCP_MAX_IP_HDRS;
+		}
+	}
+
+	/* the decompressor, the array of pages of contexts, the spare context and
+	 * the pages of contexts themselves */
+	mem_len = rohc_mem_block_len(sizeof(struct rohc_decomp)) +
+	          rohc_mem_block_len(pages_nr * sizeof(struct rohc_decomp_ctxt *)) +
+	          rohc_mem_block_len(sizeof(struct rohc_decomp_ctxt)) +
+	          pages_nr * rohc_mem_block_len(ROHC_DECOMP_CTXT_PAGE_LEN *
+	                                        sizeof(struct rohc_decomp_ctxt));
+
+	/* the profile-specific parts of the contexts, all allocated from the slab
+	 * of contexts */
+	mem_len += ctxts_nr * ctxt_mem_max;
+	mem_len += rohc_slab_mem_max();
+
+	/* the IPv6 addresses shared by the contexts, and the ones of the packet
+	 * being decompressed that are not in its context yet */
+	if(interned_nr > 0)
+	{
+		mem_len += interned_nr *
+		           rohc_intern_entry_mem_max(sizeof(struct ipv6_addr) * 2);
+		mem_len += rohc_intern_mem_max((ctxts_nr + 1) * interned_nr);
+	}
+
+	/* the configuration snapshots published by the control plane */
+	mem_len += 2 * rohc_mem_block_len(sizeof(struct rohc_decomp_cfg));
+
+	return rohc_mem_block_size(mem_len);
 
-destroy_contexts:
-	free(decomp->contexts);
-destroy_decomp:
-	free(decomp);
 error:
-	return NULL;
+	return 0;
 }
 
 
@@ -601,31 +1456,72 @@ error:
  */
 void rohc_decomp_free(struct rohc_decomp *const decomp)
 {
-	rohc_cid_t i;
+	struct rohc_decomp_engine *engine;
+	struct rohc_mem_ops mem_ops;
+	size_t page_idx;
 
 	/* sanity check */
 	if(decomp == NULL)
 	{
 		goto error;
 	}
-	assert(decomp->contexts != NULL);
+
+	/* the memory operations are stored in the decompressor itself */
+	mem_ops = decomp->mem_ops;
+	assert(decomp->ctxt_pages != NULL);
+	assert(decomp->spare_ctxt != NULL);
 
 	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 	           "free ROHC decompressor");
 
 	/* destroy all the contexts owned by the decompressor */
-	for(i = 0; i <= decomp->medium.max_cid; i++)
+	for(page_idx = 0; page_idx < decomp->ctxt_pages_nr; page_idx++)
 	{
-		if(decomp->contexts[i] != NULL)
+		struct rohc_decomp_ctxt *const page = decomp->ctxt_pages[page_idx];
+		size_t i;
+
+		if(page == NULL)
 		{
-			context_free(decomp->contexts[i]);
+			continue;
+		}
+
+		for(i = 0; i < ROHC_DECOMP_CTXT_PAGE_LEN; i++)
+		{
+			if(page[i].used)
+			{
+				context_free(&page[i]);
+			}
+			if(page[i].flight != NULL)
+			{
+				rohc_mem_free(&mem_ops, page[i].flight);
+			}
 		}
+		rohc_mem_free(&mem_ops, page);
 	}
-	zfree(decomp->contexts);
+	rohc_mem_free(&mem_ops, decomp->ctxt_pages);
+	decomp->ctxt_pages = NULL;
+	assert(!decomp->spare_ctxt->used);
+	rohc_mem_free(&mem_ops, decomp->spare_ctxt);
+	decomp->spare_ctxt = NULL;
 	assert(decomp->num_contexts_used == 0);
+	rohc_intern_release(&decomp->static_store_own);
+	rohc_slab_release(&decomp->ctxt_slab_own);
+
+	/* destroy the Reconstructed Reception Unit (RRU) if any */
+	rohc_mem_free(&mem_ops, decomp->rru);
+
+	/* destroy the configuration published but not taken yet if any */
+	rohc_mem_free(&mem_ops, decomp->cfg_pending);
 
 	/* destroy the decompressor itself */
-	free(decomp);
+	engine = decomp->engine;
+	rohc_mem_free(&mem_ops, decomp);
+
+	/* the last channel of a freed engine releases the engine */
+	if(engine != NULL)
+	{
+		rohc_decomp_engine_put(engine);
+	}
 
 error:
 	return;
@@ -705,228 +1601,793 @@ rohc_status_t rohc_decompress3(struct rohc_decomp *const decomp,
                                struct rohc_buf *const rcvd_feedback,
                                struct rohc_buf *const feedback_send)
 {
-	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
-	struct rohc_decomp_stream stream;
-
 	/* check inputs validity */
 	if(decomp == NULL)
 	{
 		goto error;
 	}
-	if(rohc_buf_is_malformed(rohc_packet))
-	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is malformed");
-		goto error;
-	}
-	if(rohc_buf_is_empty(rohc_packet))
+	if(!rohc_decomp_check_bufs(decomp, rohc_packet, uncomp_packet))
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "given rohc_packet is empty");
 		goto error;
 	}
-	if(uncomp_packet == NULL)
+	if(!rohc_decomp_check_feedback_bufs(decomp, rcvd_feedback, feedback_send))
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is NULL");
 		goto error;
 	}
-	if(rohc_buf_is_malformed(*uncomp_packet))
+
+	return rohc_decomp_decompress_pkt(decomp, rohc_packet, uncomp_packet, NULL,
+	                                  rcvd_feedback, feedback_send);
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Decompress a burst of ROHC packets
+ *
+ * Decompress the given ROHC packets into uncompressed packets, as if
+ * \ref rohc_decompress3 was called for every packet in order. The checks of
+ * the decompressor are done only once for the whole burst, and the contexts
+ * of the next packets, LSB decoding contexts included, are prefetched while
+ * the current one is decompressed.
+ *
+ * The status of every packet is given in \e status. The feedback received
+ * in all the ROHC packets of the burst and the feedback generated for all of
+ * them are aggregated into the single \e rcvd_feedback and \e feedback_send
+ * buffers. Feedback items that do not fit in the buffers any more are
+ * dropped.
+ *
+ * If the \ref ROHC_DECOMP_FEATURE_BURST_GROUPING feature is enabled, the
+ * packets are decompressed context by context within groups of
+ * \ref ROHC_DECOMP_BURST_GROUP packets. The packets of one context keep their
+ * order, and every uncompressed packet and every status is written in the
+ * slot of its ROHC packet. The ROHC segments, and the packets that start
+ * with padding or feedback, keep their position in the burst.
+ *
+ * If the \ref ROHC_DECOMP_FEATURE_COALESCE_FEEDBACK feature is enabled, the
+ * ACKs of \e feedback_send that are superseded by a later feedback for the
+ * same CID in the burst are dropped, so that the whole burst is acknowledged
+ * with one single feedback per CID most of the time.
+ *
+ * @param decomp                The ROHC decompressor
+ * @param rohc_packets          The compressed ROHC packets to decode
+ * @param[out] uncomp_packets   The resulting uncompressed packets
+ * @param[out] status           The status of every packet, see
+ *                              \ref rohc_decompress3 for possible values
+ * @param pkts_nr               The number of packets in the burst
+ * @param[out] rcvd_feedback    The feedback received in the ROHC packets
+ *                              for the same-side associated ROHC compressor,
+ *                              may be NULL to ignore it
+ * @param[out] feedback_send    The feedback to be transmitted to the
+ *                              remote compressor, may be NULL to send none
+ * @return                      The number of packets that were handled, a
+ *                              status is given for each of them
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ */
+size_t rohc_decompress_burst(struct rohc_decomp *const decomp,
+                             const struct rohc_buf rohc_packets[],
+                             struct rohc_buf uncomp_packets[],
+                             rohc_status_t status[],
+                             const size_t pkts_nr,
+                             struct rohc_buf *const rcvd_feedback,
+                             struct rohc_buf *const feedback_send)
+{
+	size_t order[ROHC_DECOMP_BURST_GROUP];
+	size_t group_nr;
+	size_t i;
+
+	/* check inputs validity */
+	if(decomp == NULL || rohc_packets == NULL || uncomp_packets == NULL ||
+	   status == NULL || pkts_nr == 0)
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is malformed");
 		goto error;
 	}
-	if(!rohc_buf_is_empty(*uncomp_packet))
+	if(!rohc_decomp_check_feedback_bufs(decomp, rcvd_feedback, feedback_send))
 	{
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "given uncomp_packet is not empty");
 		goto error;
 	}
-	if(rcvd_feedback != NULL)
+
+	for(i = 0; i < pkts_nr; i += group_nr)
 	{
-		if(rohc_buf_is_malformed(*rcvd_feedback))
+		const struct rohc_buf *const group = &rohc_packets[i];
+		size_t k;
+
+		group_nr = rohc_min(pkts_nr - i, ROHC_DECOMP_BURST_GROUP);
+		rohc_decomp_group_pkts(decomp, group, group_nr, order);
+
+		for(k = 0; k < ROHC_DECOMP_BURST_AHEAD && k < group_nr; k++)
 		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "given rcvd_feedback is malformed");
-			goto error;
+			rohc_decomp_prefetch_ctxt(decomp, group[order[k]]);
 		}
-		if(!rohc_buf_is_empty(*rcvd_feedback))
+		for(k = 0; k < group_nr; k++)
 		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "given rcvd_feedback is not empty");
-			goto error;
+			const size_t j = i + order[k];
+
+			/* prefetch the context of the packet ahead, then the persistent
+			 * data of the context of the next packet, while the current packet
+			 * is not decompressed yet */
+			if((k + ROHC_DECOMP_BURST_AHEAD) < group_nr)
+			{
+				rohc_decomp_prefetch_ctxt(decomp, group[order[k + ROHC_DECOMP_BURST_AHEAD]]);
+			}
+			if((k + 1) < group_nr)
+			{
+				rohc_decomp_prefetch_ctxt_data(decomp, group[order[k + 1]]);
+			}
+
+			if(!rohc_decomp_check_bufs(decomp, rohc_packets[j], &uncomp_packets[j]))
+			{
+				status[j] = ROHC_STATUS_ERROR;
+				continue;
+			}
+			status[j] = rohc_decomp_decompress_pkt(decomp, rohc_packets[j],
+			                                       &uncomp_packets[j], NULL,
+			                                       rcvd_feedback, feedback_send);
 		}
 	}
-	if(feedback_send != NULL)
+
+	/* drop the ACKs superseded by later feedback if asked by user */
+	if(feedback_send != NULL &&
+	   (d_features(decomp) & ROHC_DECOMP_FEATURE_COALESCE_FEEDBACK) != 0)
 	{
-		if(rohc_buf_is_malformed(*feedback_send))
+		rohc_decomp_coalesce_feedback(decomp, feedback_send);
+	}
+
+	return pkts_nr;
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Drop the superseded ACKs from the feedback built for a burst
+ *
+ * One ACK is superseded by a later feedback for the same CID if the ACK is
+ * a FEEDBACK-1 (it transmits SN bits only) or if the later feedback is a
+ * FEEDBACK-2 (it transmits the mode and the SN bits): the remote compressor
+ * gets the same information from the later feedback. NACKs and STATIC-NACKs
+ * are never dropped.
+ *
+ * The feedback items are compacted in place, in their original order.
+ *
+ * @param decomp            The ROHC decompressor
+ * @param[in,out] feedback  The feedback built for the burst
+ */
+static void rohc_decomp_coalesce_feedback(const struct rohc_decomp *const decomp,
+                                          struct rohc_buf *const feedback)
+{
+	uint8_t *const data = rohc_buf_data(*feedback);
+	const size_t len = feedback->len;
+	size_t read_pos = 0;
+	size_t write_pos = 0;
+
+	while(read_pos < len)
+	{
+		struct rohc_buf remain = *feedback;
+		struct rohc_decomp_feedback_item item;
+		bool is_superseded = false;
+
+		rohc_buf_pull(&remain, read_pos);
+		if(!rohc_decomp_parse_feedback_item(decomp, remain, &item))
 		{
+			/* should not happen since the decompressor built the feedback,
+			 * keep the remaining bytes unchanged */
 			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "given feedback_send is malformed");
-			goto error;
+			             "failed to parse feedback at offset %zu, do not "
+			             "coalesce the remaining feedback", read_pos);
+			memmove(data + write_pos, data + read_pos, len - read_pos);
+			write_pos += len - read_pos;
+			break;
 		}
-		if(!rohc_buf_is_empty(*feedback_send))
+
+		/* is the ACK superseded by a later feedback for the same CID? */
+		if(item.is_ack)
 		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "given feedback_send is not empty");
-			goto error;
+			struct rohc_buf next_remain = remain;
+			struct rohc_decomp_feedback_item next;
+
+			rohc_buf_pull(&next_remain, item.len);
+			while(!is_superseded && next_remain.len > 0 &&
+			      rohc_decomp_parse_feedback_item(decomp, next_remain, &next))
+			{
+				is_superseded =
+					(next.cid == item.cid && (!item.is_fb2 || next.is_fb2));
+				rohc_buf_pull(&next_remain, next.len);
+			}
+		}
+
+		if(is_superseded)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "CID %zu: drop the %zu-byte ACK superseded by a later "
+			           "feedback of the burst", item.cid, item.len);
+		}
+		else
+		{
+			if(write_pos != read_pos)
+			{
+				memmove(data + write_pos, data + read_pos, item.len);
+			}
+			write_pos += item.len;
 		}
+		read_pos += item.len;
 	}
 
-	decomp->stats.received++;
-	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-	           "decompress the %zu-byte packet #%lu", rohc_packet.len,
-	           decomp->stats.received);
+	feedback->len = write_pos;
+}
 
-	/* print compressed bytes */
-	if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+
+/**
+ * @brief Parse one feedback item built by the decompressor
+ *
+ * @param decomp     The ROHC decompressor
+ * @param feedback   The feedback data, starting with the feedback item
+ * @param[out] item  The information parsed from the feedback item
+ * @return           true if the feedback item was successfully parsed,
+ *                   false if it is malformed
+ */
+static bool rohc_decomp_parse_feedback_item(const struct rohc_decomp *const decomp,
+                                            const struct rohc_buf feedback,
+                                            struct rohc_decomp_feedback_item *const item)
+{
+	const uint8_t *fb_data;
+	size_t fb_hdr_len;
+	size_t fb_data_len;
+	size_t cid_len;
+
+	/* the feedback header and the feedback data shall be complete */
+	if(!rohc_feedback_get_size(feedback, &fb_hdr_len, &fb_data_len) ||
+	   fb_data_len == 0 || (fb_hdr_len + fb_data_len) > feedback.len)
 	{
-		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
-		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
-		                 "compressed data, max 100 bytes", rohc_packet);
+		goto error;
 	}
+	fb_data = rohc_buf_data(feedback) + fb_hdr_len;
+	item->len = fb_hdr_len + fb_data_len;
 
-	/* decode ROHC header */
-	status = d_decode_header(decomp, rohc_packet, uncomp_packet, rcvd_feedback,
-	                         &stream);
-	assert(status != ROHC_STATUS_SEGMENT);
-
-	/* handle mode transitions if context was found and it is still valid */
-	if(stream.context != NULL)
+	/* the CID of the feedback */
+	if(d_cid_type(decomp) == ROHC_SMALL_CID)
 	{
-		if(stream.context->mode == ROHC_U_MODE)
+		const uint8_t add_cid = rohc_add_cid_decode(fb_data, fb_data_len);
+
+		if(add_cid == UINT8_MAX)
 		{
-			if(decomp->target_mode == ROHC_U_MODE)
-			{
-				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-				           "stay in U-mode as requested by user");
-			}
-			else if(decomp->target_mode == ROHC_O_MODE)
-			{
-				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-				           "transit from U-mode to O-mode as requested by user");
-				stream.context->mode = ROHC_O_MODE;
-				/* ACK(O), NACK(O) or STATIC-NACK(O) will transmit the mode
-				 * transition to the remote compressor */
-				stream.mode = ROHC_O_MODE;
-				stream.do_change_mode = true;
-			}
-			else /* R-mode */
-			{
-				assert(0); /* TODO: R-mode not supported yet */
-				status = ROHC_STATUS_ERROR;
-				goto error;
-			}
+			item->cid = 0;
+			cid_len = 0;
 		}
-		else if(stream.context->mode == ROHC_O_MODE)
+		else
 		{
-			if(decomp->target_mode == ROHC_U_MODE)
-			{
-				assert(0); /* TODO: O- to U-mode transition not supported yet */
-				status = ROHC_STATUS_ERROR;
-				goto error;
-			}
-			else if(decomp->target_mode == ROHC_O_MODE)
-			{
-				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-				           "stay in O-mode as requested by user");
-			}
-			else /* R-mode */
-			{
-				assert(0); /* TODO: R-mode not supported yet */
-				status = ROHC_STATUS_ERROR;
-				goto error;
-			}
+			item->cid = add_cid;
+			cid_len = 1;
 		}
-		else /* R-mode */
+	}
+	else
+	{
+		uint32_t large_cid;
+		size_t large_cid_bits_nr;
+
+		cid_len = sdvl_decode(fb_data, fb_data_len, &large_cid,
+		                      &large_cid_bits_nr);
+		if(cid_len != 1 && cid_len != 2)
 		{
-			assert(0); /* TODO: R-mode not supported yet */
-			status = ROHC_STATUS_ERROR;
 			goto error;
 		}
+		item->cid = large_cid & 0xffff;
 	}
-
-	/* update statistics and send feedback if needed */
+	if(cid_len >= fb_data_len)
+	{
+		goto error;
+	}
+
+	/* FEEDBACK-1 is one single byte, FEEDBACK-2 starts with the ACK type */
+	item->is_fb2 = ((fb_data_len - cid_len) > 1);
+	item->is_ack =
+		(!item->is_fb2 || GET_BIT_6_7(fb_data + cid_len) == ROHC_FEEDBACK_ACK);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Decompress the given ROHC packet in place
+ *
+ * Decompress the given ROHC packet as \ref rohc_decompress3 does, but rebuild
+ * the uncompressed headers in the same buffer, right in front of the payload.
+ * The payload is never copied.
+ *
+ * The ROHC packet shall be given with some headroom, ie. with a non-zero
+ * \e packet->offset. The uncompressed headers are first built in the
+ * headroom, then moved in front of the payload: the headroom shall thus be
+ * large enough for the uncompressed headers, otherwise
+ * \ref ROHC_STATUS_OUTPUT_TOO_SMALL is returned.
+ *
+ * If the final segment of a ROHC packet is given, the reconstructed packet
+ * is not located in the given buffer, so the payload is copied into the
+ * headroom after the uncompressed headers.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param[in,out] packet      IN:  The compressed packet to decompress, with
+ *                                 some headroom in front of it
+ *                            OUT: The resulting uncompressed packet, in the
+ *                                 same buffer, if decompression is
+ *                                 successful; left unchanged otherwise
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor, see
+ *                            \ref rohc_decompress3
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor, see \ref rohc_decompress3
+ * @return                    See \ref rohc_decompress3
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ */
+rohc_status_t rohc_decompress_inplace(struct rohc_decomp *const decomp,
+                                      struct rohc_buf *const packet,
+                                      struct rohc_buf *const rcvd_feedback,
+                                      struct rohc_buf *const feedback_send)
+{
+	struct rohc_buf uncomp_packet;
+	rohc_status_t status;
+
+	/* check inputs validity */
+	if(decomp == NULL || packet == NULL)
+	{
+		goto error;
+	}
+	if(packet->offset == 0)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given packet has no headroom for the uncompressed "
+		             "headers");
+		goto error;
+	}
+
+	/* the uncompressed headers are built in the headroom */
+	uncomp_packet.time = packet->time;
+	uncomp_packet.data = packet->data;
+	uncomp_packet.max_len = packet->offset;
+	uncomp_packet.offset = 0;
+	uncomp_packet.len = 0;
+
+	if(!rohc_decomp_check_bufs(decomp, *packet, &uncomp_packet))
+	{
+		goto error;
+	}
+	if(!rohc_decomp_check_feedback_bufs(decomp, rcvd_feedback, feedback_send))
+	{
+		goto error;
+	}
+
+	status = rohc_decomp_decompress_pkt(decomp, *packet, &uncomp_packet, NULL,
+	                                    rcvd_feedback, feedback_send);
 	if(status == ROHC_STATUS_OK)
 	{
-		/* print a trace to report success (the context may be NULL if packet
-		 * was a feedback-only packet) */
-		rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-		           "packet decompression succeeded");
+		packet->offset = uncomp_packet.offset;
+		packet->len = uncomp_packet.len;
+	}
 
-		/* do not update statistics and build positive feedback for feedback-only
-		 * packets */
-		if(uncomp_packet->len > 0)
+	return status;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Decompress the given ROHC packet into its header fields
+ *
+ * Decompress the given ROHC packet as \ref rohc_decompress3 does, but give
+ * the fields of the uncompressed headers instead of the uncompressed packet:
+ * the 5-tuple, the sequence numbers and the timestamps of the packet. The
+ * payload is never copied, it is given as a view of the buffer it is
+ * already in.
+ *
+ * The uncompressed headers are still built in the given \e hdrs buffer:
+ * the CRC of the ROHC header is computed over them and it shall be checked
+ * before the context is updated. A buffer as large as the largest
+ * uncompressed headers is enough, it may be reused for all the packets.
+ * The whole packet is built there for the Uncompressed profile.
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packet         The compressed packet to decompress
+ * @param[out] hdrs           The buffer the uncompressed headers are built in,
+ *                            it shall be empty
+ * @param[out] fields         The fields of the uncompressed headers and the
+ *                            payload of the packet, if decompression is
+ *                            successful; all the fields but the payload are
+ *                            zero for a feedback-only packet
+ * @param[out] rcvd_feedback  The feedback received from the remote peer for
+ *                            the same-side associated ROHC compressor, see
+ *                            \ref rohc_decompress3
+ * @param[out] feedback_send  The feedback to be transmitted to the remote
+ *                            compressor, see \ref rohc_decompress3
+ * @return                    See \ref rohc_decompress3
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress3
+ */
+rohc_status_t rohc_decompress_fields(struct rohc_decomp *const decomp,
+                                     const struct rohc_buf rohc_packet,
+                                     struct rohc_buf *const hdrs,
+                                     struct rohc_decomp_fields *const fields,
+                                     struct rohc_buf *const rcvd_feedback,
+                                     struct rohc_buf *const feedback_send)
+{
+	rohc_status_t status;
+
+	/* check inputs validity */
+	if(decomp == NULL || fields == NULL)
+	{
+		goto error;
+	}
+	if(!rohc_decomp_check_bufs(decomp, rohc_packet, hdrs))
+	{
+		goto error;
+	}
+	if(!rohc_decomp_check_feedback_bufs(decomp, rcvd_feedback, feedback_send))
+	{
+		goto error;
+	}
+
+	/* no payload for feedback-only packets */
+	fields->payload.time = rohc_packet.time;
+	fields->payload.data = NULL;
+	fields->payload.max_len = 0;
+	fields->payload.offset = 0;
+	fields->payload.len = 0;
+
+	status = rohc_decomp_decompress_pkt(decomp, rohc_packet, hdrs,
+	                                    &fields->payload, rcvd_feedback,
+	                                    feedback_send);
+	if(status == ROHC_STATUS_OK)
+	{
+		rohc_decomp_parse_fields(decomp, hdrs, fields);
+	}
+
+	return status;
+
+error:
+	return ROHC_STATUS_ERROR;
+}
+
+
+/**
+ * @brief Get the header fields of the packet that was just decompressed
+ *
+ * @param decomp      The ROHC decompressor
+ * @param hdrs        The uncompressed headers of the packet
+ * @param[in,out] fields  IN:  The payload of the packet
+ *                        OUT: The fields of the packet
+ */
+static void rohc_decomp_parse_fields(const struct rohc_decomp *const decomp,
+                                     struct rohc_buf *const hdrs,
+                                     struct rohc_decomp_fields *const fields)
+{
+	const struct rohc_decomp_ctxt *const context = decomp->last_context;
+	const struct rohc_buf payload = fields->payload;
+	bool has_rtp;
+	size_t hdrs_len;
+
+	memset(fields, 0, sizeof(struct rohc_decomp_fields));
+	fields->payload = payload;
+
+	/* nothing more for feedback-only packets */
+	if(hdrs->len == 0 && payload.len == 0)
+	{
+		fields->profile = ROHC_PROFILE_GENERAL;
+		return;
+	}
+	assert(context != NULL);
+	fields->cid = context->cid;
+	fields->profile = context->profile->id;
+	fields->sn = context->profile->get_sn(context);
+
+	has_rtp = (fields->profile == ROHC_PROFILE_RTP ||
+	           fields->profile == ROHC_PROFILE_UDPLITE_RTP);
+	hdrs_len = rohc_decomp_parse_fields_hdrs(rohc_buf_data(*hdrs), hdrs->len,
+	                                         has_rtp, fields);
+	if(fields->profile == ROHC_PROFILE_UNCOMPRESSED)
+	{
+		/* the whole packet was built in the headers buffer, split it */
+		fields->payload = *hdrs;
+		rohc_buf_pull(&fields->payload, hdrs_len);
+		hdrs->len = hdrs_len;
+	}
+	fields->hdrs_len = hdrs->len;
+}
+
+
+/**
+ * @brief Get the fields of the given uncompressed headers
+ *
+ * The headers were built by the profile, or received as-is by the
+ * Uncompressed profile: the IP headers, the IPv6 extension headers and the
+ * transport headers are read as long as they are complete and known.
+ *
+ * @param data        The uncompressed headers
+ * @param len         The length of the uncompressed headers
+ * @param has_rtp     Whether the profile built one RTP header after the
+ *                    UDP or UDP-Lite header
+ * @param[out] fields The fields of the headers
+ * @return            The length of the headers that were read
+ */
+static size_t rohc_decomp_parse_fields_hdrs(const uint8_t *const data,
+                                            const size_t len,
+                                            const bool has_rtp,
+                                            struct rohc_decomp_fields *const fields)
+{
+	size_t offset = 0;
+	uint8_t proto = ROHC_IPPROTO_IPIP;
+
+	/* the IP headers, the fields of the innermost one are kept */
+	while(rohc_is_tunneling(proto) && (len - offset) >= 1)
+	{
+		const uint8_t version = (data[offset] >> 4) & 0x0f;
+
+		if(version == IPV4)
 		{
-			/* update statistics */
-			rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-			           "update decompressor and context statistics");
-			assert(stream.context != NULL);
-			stream.context->num_recv_packets++;
-			stream.context->packet_type = stream.packet_type;
-			stream.context->total_uncompressed_size += uncomp_packet->len;
-			stream.context->total_compressed_size += rohc_packet.len;
-			decomp->stats.total_uncompressed_size += uncomp_packet->len;
-			decomp->stats.total_compressed_size += rohc_packet.len;
+			const struct ipv4_hdr *const ipv4 =
+				(const struct ipv4_hdr *) (data + offset);
+			size_t hdr_len;
 
-			/* build positive feedback if asked by user and if needed by decompressor */
-			if(!rohc_decomp_feedback_ack(decomp, &stream, feedback_send))
+			if((len - offset) < sizeof(struct ipv4_hdr))
 			{
-				rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-				             "failed to build positive feedback");
-				status = ROHC_STATUS_ERROR;
-				goto error;
+				break;
+			}
+			hdr_len = ipv4->ihl * sizeof(uint32_t);
+			if(hdr_len < sizeof(struct ipv4_hdr) || hdr_len > (len - offset))
+			{
+				break;
+			}
+			fields->tos = ipv4->tos;
+			fields->ttl = ipv4->ttl;
+			fields->ip_id = rohc_ntoh16(ipv4->id);
+			memset(fields->src_addr, 0, sizeof(fields->src_addr));
+			memcpy(fields->src_addr, &ipv4->saddr, sizeof(uint32_t));
+			memset(fields->dst_addr, 0, sizeof(fields->dst_addr));
+			memcpy(fields->dst_addr, &ipv4->daddr, sizeof(uint32_t));
+			proto = ipv4->protocol;
+			offset += hdr_len;
+		}
+		else if(version == IPV6)
+		{
+			const struct ipv6_hdr *const ipv6 =
+				(const struct ipv6_hdr *) (data + offset);
+
+			if((len - offset) < sizeof(struct ipv6_hdr))
+			{
+				break;
+			}
+			fields->tos = ipv6_get_tc(ipv6);
+			fields->ttl = ipv6->hl;
+			fields->ip_id = 0;
+			memcpy(fields->src_addr, &ipv6->saddr, sizeof(struct ipv6_addr));
+			memcpy(fields->dst_addr, &ipv6->daddr, sizeof(struct ipv6_addr));
+			proto = ipv6->nh;
+			offset += sizeof(struct ipv6_hdr);
+
+			/* skip the IPv6 extension headers */
+			while(rohc_is_ipv6_opt(proto))
+			{
+				const struct ipv6_opt *const opt =
+					(const struct ipv6_opt *) (data + offset);
+				size_t opt_len;
+
+				if((len - offset) < (sizeof(struct ipv6_opt) - 1))
+				{
+					goto end;
+				}
+				opt_len = ipv6_opt_get_length(opt);
+				if(opt_len > (len - offset))
+				{
+					goto end;
+				}
+				proto = opt->next_header;
+				offset += opt_len;
 			}
 		}
+		else
+		{
+			break;
+		}
+		fields->ip_version = version;
+		fields->proto = proto;
+		fields->ip_hdrs_nr++;
 	}
-	else /* packet failed to be decompressed */
+	if(fields->ip_hdrs_nr == 0 || rohc_is_tunneling(proto))
 	{
-		/* in case of failure, users shall get an empty decompressed packet */
-		uncomp_packet->len = 0;
+		goto end;
+	}
 
-		rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-		             "packet decompression failed: %s (%d)",
-		             rohc_strerror(status), status);
+	/* the transport header */
+	if(proto == ROHC_IPPROTO_UDP || proto == ROHC_IPPROTO_UDPLITE)
+	{
+		const struct udphdr *const udp = (const struct udphdr *) (data + offset);
 
-		/* update statistics */
-		if(stream.context != NULL)
+		if((len - offset) < sizeof(struct udphdr))
 		{
-			stream.context->num_recv_packets++;
+			goto end;
 		}
-		switch(status)
+		fields->src_port = rohc_ntoh16(udp->source);
+		fields->dst_port = rohc_ntoh16(udp->dest);
+		offset += sizeof(struct udphdr);
+
+		/* the RTP header, if the profile built one */
+		if(has_rtp && (len - offset) >= sizeof(struct rtphdr))
 		{
-			case ROHC_STATUS_MALFORMED:
-			case ROHC_STATUS_OUTPUT_TOO_SMALL:
-			case ROHC_STATUS_ERROR:
-				decomp->stats.failed_decomp++;
-				break;
-			case ROHC_STATUS_NO_CONTEXT:
-				decomp->stats.failed_no_context++;
-				break;
-			case ROHC_STATUS_BAD_CRC:
-				decomp->stats.failed_crc++;
-				break;
-			case ROHC_STATUS_OK: /* success codes shall not happen */
-			case ROHC_STATUS_SEGMENT:
-			default:
-				assert(0);
-				status = ROHC_STATUS_ERROR;
-				goto error;
+			const struct rtphdr *const rtp =
+				(const struct rtphdr *) (data + offset);
+
+			if((len - offset) < (sizeof(struct rtphdr) + rtp->cc * sizeof(uint32_t)))
+			{
+				goto end;
+			}
+			fields->is_rtp = true;
+			fields->rtp_marker = !!rtp->m;
+			fields->rtp_pt = rtp->pt;
+			fields->rtp_sn = rohc_ntoh16(rtp->sn);
+			fields->rtp_ts = rohc_ntoh32(rtp->timestamp);
+			fields->rtp_ssrc = rohc_ntoh32(rtp->ssrc);
+			offset += sizeof(struct rtphdr) + rtp->cc * sizeof(uint32_t);
 		}
+	}
+	else if(proto == ROHC_IPPROTO_TCP)
+	{
+		const struct tcphdr *const tcp = (const struct tcphdr *) (data + offset);
+		size_t hdr_len;
 
-		/* build negative feedback if asked by user and if needed by decompressor */
-		if(!rohc_decomp_feedback_nack(decomp, &stream, feedback_send))
+		if((len - offset) < sizeof(struct tcphdr))
 		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
-			             "failed to build negative feedback");
-			status = ROHC_STATUS_ERROR;
-			goto error;
+			goto end;
+		}
+		hdr_len = tcp->data_offset * sizeof(uint32_t);
+		if(hdr_len < sizeof(struct tcphdr) || hdr_len > (len - offset))
+		{
+			goto end;
+		}
+		fields->src_port = rohc_ntoh16(tcp->src_port);
+		fields->dst_port = rohc_ntoh16(tcp->dst_port);
+		fields->tcp_seq = rohc_ntoh32(tcp->seq_num);
+		fields->tcp_ack = rohc_ntoh32(tcp->ack_num);
+		fields->tcp_window = rohc_ntoh16(tcp->window);
+		fields->tcp_flags = (tcp->ecn_flags << 6) | (tcp->urg_flag << 5) |
+		                    (tcp->ack_flag << 4) | (tcp->psh_flag << 3) |
+		                    tcp->rsf_flags;
+		offset += hdr_len;
+	}
+	else if(proto == ROHC_IPPROTO_ESP)
+	{
+		const struct esphdr *const esp = (const struct esphdr *) (data + offset);
+
+		if((len - offset) < sizeof(struct esphdr))
+		{
+			goto end;
 		}
+		fields->esp_spi = rohc_ntoh32(esp->spi);
+		fields->esp_sn = rohc_ntoh32(esp->sn);
+		offset += sizeof(struct esphdr);
+	}
+
+end:
+	return offset;
+}
+
+
+/**
+ * @brief Provision one decompression context out of band
+ *
+ * Create the context of one known long-lived flow from the description
+ * built by \ref rohc_comp_provision_context in the remote compressor, eg.
+ * at configuration time, instead of from the IR packets received on the
+ * link. The description is the IR header of the last packet the remote
+ * context was provisioned from: it is decoded once, the context is then in the Full Context state with
+ * the same CID, profile, static and initial dynamic state as the context of
+ * the remote compressor. The first packets received on the link are already
+ * compressed ones.
+ *
+ * Any context already at the CID of the description is replaced, as if an
+ * IR packet was received. No statistics are updated and no feedback is
+ * built for the description.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param descr   The description of the context, as built by
+ *                \ref rohc_comp_provision_context
+ * @return        true if the context was provisioned,
+ *                false if the description is not one valid IR header for
+ *                an enabled profile, or if a parameter is invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_comp_provision_context
+ */
+bool rohc_decomp_provision_context(struct rohc_decomp *const decomp,
+                                   const struct rohc_buf descr)
+{
+	struct rohc_decomp_stream stream;
+	struct rohc_buf uncomp_hdrs;
+	rohc_cid_t cid;
+	size_t add_cid_len;
+	size_t large_cid_len;
+	rohc_status_t status;
+	uint8_t *buf;
+
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(rohc_buf_is_malformed(descr) || rohc_buf_is_empty(descr))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given context description is malformed or empty");
+		goto error;
+	}
+
+	/* the description is one IR header, with neither padding, nor feedback,
+	 * nor segment in front of it */
+	if(!rohc_decomp_decode_cid(decomp, rohc_buf_data(descr), descr.len, &cid,
+	                           &add_cid_len, &large_cid_len) ||
+	   !rohc_decomp_packet_is_ir(rohc_buf_data_at(descr, add_cid_len),
+	                             descr.len - add_cid_len))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given context description is not an IR header");
+		goto error;
+	}
+
+	/* the uncompressed headers are decoded to check the description, then
+	 * dropped */
+	buf = rohc_mem_alloc(&decomp->mem_ops, ROHC_DECOMP_PROVISION_BUF_LEN);
+	if(buf == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "cannot provision context with CID %zu: no memory for "
+		             "the uncompressed headers", cid);
+		goto error;
+	}
+	uncomp_hdrs.time = descr.time;
+	uncomp_hdrs.data = buf;
+	uncomp_hdrs.max_len = ROHC_DECOMP_PROVISION_BUF_LEN;
+	uncomp_hdrs.offset = 0;
+	uncomp_hdrs.len = 0;
+
+	rohc_seqlock_write_begin(&decomp->stats_seq);
+	rohc_decomp_take_cfg(decomp);
+	status = d_decode_header(decomp, descr, &uncomp_hdrs, NULL, NULL, &stream);
+	if(status == ROHC_STATUS_OK)
+	{
+		assert(stream.context != NULL);
+		stream.context->num_recv_packets++;
+		stream.context->packet_type = stream.packet_type;
+	}
+	rohc_seqlock_write_end(&decomp->stats_seq);
+	rohc_mem_free(&decomp->mem_ops, buf);
+	if(status != ROHC_STATUS_OK)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "cannot provision context with CID %zu: failed to decode "
+		             "the description: %s (%d)", cid, rohc_strerror(status),
+		             status);
+		goto error;
 	}
 
+	rohc_info(decomp, ROHC_TRACE_DECOMP, stream.profile_id, "context with "
+	          "CID %zu provisioned in state %s from a %zu-byte description",
+	          cid, rohc_decomp_get_state_descr(stream.context->state),
+	          descr.len);
+
+	return true;
+
 error:
-	return status;
+	return false;
 }
 
 
@@ -936,6 +2397,8 @@ error:
  * @param decomp              The ROHC decompressor
  * @param rohc_packet         The ROHC packet to decode
  * @param[out] uncomp_packet  The uncompressed packet
+ * @param[out] payload        The payload of the packet, left in place, or
+ *                            NULL to copy it in \e uncomp_packet
  * @param[out] rcvd_feedback  The feedback received from the remote peer for
  *                            the same-side associated ROHC compressor through
  *                            the feedback channel:
@@ -958,6 +2421,7 @@ error:
 static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
                                      const struct rohc_buf rohc_packet,
                                      struct rohc_buf *const uncomp_packet,
+                                     struct rohc_buf *const payload,
                                      struct rohc_buf *const rcvd_feedback,
                                      struct rohc_decomp_stream *const stream)
 {
@@ -975,7 +2439,7 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 
 	/* at the beginning, context is not found yet but channel CID type is known */
 	stream->profile_id = ROHC_PROFILE_GENERAL;
-	stream->cid_type = decomp->medium.cid_type;
+	stream->cid_type = d_cid_type(decomp);
 	stream->cid_found = false;
 	stream->cid = SIZE_MAX;
 	stream->context_found = false;
@@ -987,6 +2451,9 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 	stream->sn_bits_nr = 0;
 	stream->packet_type = ROHC_PACKET_UNKNOWN;
 	stream->crc_failed = false;
+	stream->arrival_time = rohc_packet.time;
+	stream->hdr = NULL;
+	stream->hdr_len = 0;
 
 	/* empty ROHC packets are not considered as valid */
 	if(remain_rohc_data.len < 1)
@@ -1065,9 +2532,25 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		           "append new segment to the %zd bytes we already received",
 		           decomp->rru_len);
-		memcpy(decomp->rru + decomp->rru_len, walk, remain_len);
+		if(decomp->rru_len == 0)
+		{
+			decomp->rru_crc = CRC_INIT_FCS32;
+			decomp->rru_crc_len = 0;
+		}
+		memcpy(decomp->rru + decomp->rru_len, walk, remain_len);
 		decomp->rru_len += remain_len;
 
+		/* update the FCS-32 of the RRU while the segment is hot in cache, the
+		 * last 4 bytes are left apart since they may be the FCS-32 itself */
+		if(decomp->rru_len > (decomp->rru_crc_len + 4))
+		{
+			decomp->rru_crc =
+				crc_calc_fcs32(decomp->rru + decomp->rru_crc_len,
+				               decomp->rru_len - 4 - decomp->rru_crc_len,
+				               decomp->rru_crc);
+			decomp->rru_crc_len = decomp->rru_len - 4;
+		}
+
 		/* stop decoding here is not final segment */
 		if(!is_final)
 		{
@@ -1091,8 +2574,8 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		           "final segment received, check the 4-byte CRC of the "
 		           "%zd-byte RRU", decomp->rru_len);
-		crc_computed = crc_calc_fcs32(decomp->rru, decomp->rru_len,
-		                              CRC_INIT_FCS32);
+		assert(decomp->rru_crc_len == decomp->rru_len);
+		crc_computed = decomp->rru_crc;
 		if(memcmp(&crc_computed, decomp->rru + decomp->rru_len, 4) != 0)
 		{
 			uint32_t crc_packet;
@@ -1145,12 +2628,20 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 	remain_len -= add_cid_len;
 	rohc_buf_pull(&remain_rohc_data, add_cid_len);
 
+	/* destroy the contexts that were not used for too long */
+	if(decomp->ctxt_idle_timeout != 0)
+	{
+		d_expire_contexts(decomp, rohc_packet.time);
+	}
+
 	/* find the context according to the CID found in CID,
 	 * create it if needed (and possible) */
+	rohc_perf_begin(decomp, ROHC_DECOMP_PERF_CTXT_LOOKUP);
 	status = rohc_decomp_find_context(decomp, walk, remain_len, stream->cid,
 	                                  large_cid_len, rohc_packet.time,
 	                                  &stream->profile_id, &stream->context,
 	                                  &is_new_context);
+	rohc_perf_end(decomp, ROHC_DECOMP_PERF_CTXT_LOOKUP);
 	if(status == ROHC_STATUS_MALFORMED)
 	{
 		/* no additional feedback information to collect */
@@ -1164,6 +2655,8 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 	assert(status == ROHC_STATUS_OK);
 	profile = stream->context->profile;
 	decomp->last_context = stream->context;
+	rohc_trace_filter_select(decomp, stream->cid, profile->id,
+	                         stream->packet_type, false, 0);
 	sn_feedback_min_bits = rohc_min(decomp->sn_feedback_min_bits,
 	                                profile->msn_max_bits);
 
@@ -1184,6 +2677,10 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 	/* detect the type of the ROHC packet */
 	stream->packet_type = profile->detect_pkt_type(stream->context, walk, remain_len,
 	                                               large_cid_len);
+	stream->hdr = walk;
+	stream->hdr_len = remain_len;
+	rohc_trace_filter_select(decomp, stream->cid, profile->id,
+	                         stream->packet_type, false, 0);
 	if(stream->packet_type == ROHC_PACKET_UNKNOWN)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, profile->id,
@@ -1237,14 +2734,16 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 	}
 	/* all packet types are allowed in Full Context state */
 
-	/* only IR packet can create a new context */
-	assert(stream->packet_type == ROHC_PACKET_IR || !is_new_context);
+	/* only IR and IR-CR packets can create a new context */
+	assert(stream->packet_type == ROHC_PACKET_IR ||
+	       stream->packet_type == ROHC_PACKET_IR_CR || !is_new_context);
 
 	/* decode the packet thanks to the profile-specific routines
 	 * (may change the initial assumption about the packet type) */
 	status = rohc_decomp_decode_pkt(decomp, stream->context, remain_rohc_data,
 	                                add_cid_len, large_cid_len, uncomp_packet,
-	                                &stream->packet_type, &stream->do_change_mode);
+	                                payload, &stream->packet_type,
+	                                &stream->do_change_mode);
 	if(status != ROHC_STATUS_OK)
 	{
 		/* decompression failed, free ressources if necessary */
@@ -1261,13 +2760,42 @@ static rohc_status_t d_decode_header(struct rohc_decomp *decomp,
 
 	/* decompression was successful, replace the existing context with the
 	 * new one if necessary */
-	if(is_new_context)
-	{
-		if(decomp->contexts[stream->cid] != NULL)
+	if(is_new_context && stream->context == decomp->spare_ctxt)
+	{
+		struct rohc_decomp_ctxt *const old_context =
+			find_context(decomp, stream->cid);
+		struct rohc_decomp_flight *old_flight;
+
+		assert(old_context != NULL);
+		context_free(old_context);
+		rohc_trace_event(decomp, ROHC_TRACE_DECOMP,
+		                 ROHC_TRACE_EVENT_DECOMP_CTXT_EVICT,
+		                 old_context->profile->id, old_context->cid,
+		                 ROHC_PACKET_UNKNOWN, ROHC_TRACE_EVICT_RECYCLED,
+		                 decomp->num_contexts_used, 0);
+		/* the flight recorder stays with the memory of the context, the packets
+		 * of the old context are forgotten */
+		old_flight = old_context->flight;
+		memcpy(old_context, stream->context, sizeof(struct rohc_decomp_ctxt));
+		old_context->flight = old_flight;
+		if(old_flight != NULL)
 		{
-			context_free(decomp->contexts[stream->cid]);
+			old_flight->pkts_nr = 0;
+			old_flight->next = 0;
 		}
-		decomp->contexts[stream->cid] = stream->context;
+		decomp->spare_ctxt->used = false;
+		stream->context = old_context;
+		decomp->last_context = old_context;
+		d_ctxt_lru_push(decomp, old_context);
+	}
+
+	/* update the use timestamp of the context and move it at the head of the
+	 * LRU list */
+	stream->context->latest_used = rohc_packet.time.sec;
+	if(decomp->lru_first != stream->context)
+	{
+		d_ctxt_lru_unlink(decomp, stream->context);
+		d_ctxt_lru_push(decomp, stream->context);
 	}
 
 	/* get the SN of the latest packet successfully decompressed */
@@ -1310,18 +2838,27 @@ error_no_context:
  *  \li C. Decode extracted bits
  *  \li D. Build uncompressed headers (and check for correct decompression
  *         for UO* packets)
- *  \li E. Copy the payload (if any)
+ *  \li E. Copy the payload (if any), or move the uncompressed headers in
+ *         front of the payload if they were built in the headroom of the
+ *         ROHC packet
  *  \li F. Update the compression context
  *
  * Steps C and D may be repeated if packet or context repair is attempted
  * upon CRC failure.
  *
+ * The profile may decode the most common packets with a fast path that
+ * performs steps A to D in one single step. The regular steps are run
+ * whenever the fast path declines the packet.
+ *
  * @param decomp               The ROHC decompressor
  * @param context              The decompression context
  * @param rohc_packet          The ROHC packet to decode
  * @param add_cid_len          The length of the optional Add-CID field
  * @param large_cid_len        The length of the optional large CID field
  * @param[out] uncomp_packet   The uncompressed packet
+ * @param[out] payload         The payload of the packet, left in place in
+ *                             \e rohc_packet, or NULL to copy it after the
+ *                             uncompressed headers in \e uncomp_packet
  * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
  *                             OUT: The type of the parsed ROHC packet
  * @param[out] do_change_mode  Whether the profile context wants to change
@@ -1337,6 +2874,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
                                             const size_t add_cid_len,
                                             const size_t large_cid_len,
                                             struct rohc_buf *const uncomp_packet,
+                                            struct rohc_buf *const payload,
                                             rohc_packet_t *const packet_type,
                                             bool *const do_change_mode)
 {
@@ -1355,6 +2893,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 
 	/* Whether to attempt packet correction or not */
 	bool try_decoding_again;
+	size_t decode_attempts_nr;
 
 	/* helper variables for values returned by functions */
 	bool parsing_ok;
@@ -1365,15 +2904,39 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 	assert(large_cid_len <= 2);
 	assert((*packet_type) != ROHC_PACKET_UNKNOWN);
 
+	/* the arrival time is used for the timer-based decoding of some fields */
+	context->volat_ctxt.arrival_time = rohc_packet.time;
+
+	/* no static chain parsed yet */
+	extr_crc_bits->static_end = 0;
+	extr_crc_bits->is_static_unchanged = false;
+
+	/* try the fast path of the profile first, unless CRC repair is running */
+	rohc_perf_begin(decomp, ROHC_DECOMP_PERF_FAST_PATH);
+	if(profile->decode_fast != NULL &&
+	   context->crc_corr.algo == ROHC_DECOMP_CRC_CORR_SN_NONE &&
+	   profile->decode_fast(decomp, context, rohc_packet, large_cid_len,
+	                        *packet_type, decoded_values, uncomp_packet,
+	                        &rohc_hdr_len, &uncomp_hdr_len))
+	{
+		rohc_perf_end(decomp, ROHC_DECOMP_PERF_FAST_PATH);
+		rohc_buf_pull(uncomp_packet, uncomp_hdr_len);
+		payload_data = rohc_buf_data(rohc_packet) + rohc_hdr_len;
+		payload_len = rohc_packet.len - rohc_hdr_len;
+		goto copy_payload;
+	}
+
 	/* A. Parse the ROHC header */
 
 	rohc_decomp_debug(context, "parse packet type '%s' (%d)",
 	                  rohc_get_packet_descr(*packet_type), *packet_type);
 
 	/* let's parse the packet! */
+	rohc_perf_begin(decomp, ROHC_DECOMP_PERF_PARSE);
 	parsing_ok = profile->parse_pkt(context, rohc_packet, large_cid_len,
 	                                packet_type, extr_crc_bits, extr_bits,
 	                                &rohc_hdr_len);
+	rohc_perf_end(decomp, ROHC_DECOMP_PERF_PARSE);
 	if(!parsing_ok)
 	{
 		rohc_decomp_warn(context, "failed to parse the %s header",
@@ -1396,22 +2959,25 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 	 * correctly received. The optional Add-CID is part of the CRC.
 	 */
 
-	if((*packet_type) == ROHC_PACKET_IR || (*packet_type) == ROHC_PACKET_IR_DYN)
+	if((*packet_type) == ROHC_PACKET_IR || (*packet_type) == ROHC_PACKET_IR_DYN ||
+	   (*packet_type) == ROHC_PACKET_IR_CR)
 	{
 		bool crc_ok;
 
 		assert(extr_crc_bits->type == ROHC_CRC_TYPE_NONE);
 		assert(extr_crc_bits->bits_nr == 8);
 
+		rohc_perf_begin(decomp, ROHC_DECOMP_PERF_CRC_CHECK);
 		crc_ok = rohc_decomp_check_ir_crc(decomp, context,
 		                                  rohc_buf_data(rohc_packet) - add_cid_len,
-		                                  add_cid_len + rohc_hdr_len, large_cid_len,
-		                                  add_cid_len, extr_crc_bits->bits);
+		                                  add_cid_len + rohc_hdr_len, add_cid_len,
+		                                  large_cid_len, extr_crc_bits);
+		rohc_perf_end(decomp, ROHC_DECOMP_PERF_CRC_CHECK);
 		if(!crc_ok)
 		{
 			rohc_decomp_warn(context, "CRC detected a transmission failure for "
 			                 "%s packet", rohc_get_packet_descr(*packet_type));
-			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			if((d_features(decomp) & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 			{
 				rohc_dump_buf(decomp->trace_callback, decomp->trace_callback_priv,
 				              ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING, "ROHC header",
@@ -1429,6 +2995,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 
 
 	try_decoding_again = false;
+	decode_attempts_nr = 0;
 	do
 	{
 		if(try_decoding_again)
@@ -1436,6 +3003,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 			rohc_decomp_warn(context, "CID %zu: CRC repair: try decoding packet "
 			                 "again with new assumptions", context->cid);
 		}
+		decode_attempts_nr++;
 
 
 		/* C. Decode extracted bits
@@ -1443,8 +3011,10 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 		 * All bits are now extracted from the packet, let's decode them.
 		 */
 
+		rohc_perf_begin(decomp, ROHC_DECOMP_PERF_DECODE);
 		decode_ok = profile->decode_bits(context, extr_bits, payload_len,
 		                                 decoded_values);
+		rohc_perf_end(decomp, ROHC_DECOMP_PERF_DECODE);
 		if(!decode_ok)
 		{
 			rohc_decomp_warn(context, "failed to decode values from bits "
@@ -1462,9 +3032,11 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 		 */
 
 		/* build the uncompressed headers */
+		rohc_perf_begin(decomp, ROHC_DECOMP_PERF_BUILD);
 		build_ret = profile->build_hdrs(decomp, context, *packet_type, extr_crc_bits,
 		                                decoded_values, payload_len,
 		                                uncomp_packet, &uncomp_hdr_len);
+		rohc_perf_end(decomp, ROHC_DECOMP_PERF_BUILD);
 		if(build_ret == ROHC_STATUS_OK)
 		{
 			/* uncompressed headers successfully built and CRC is correct,
@@ -1475,17 +3047,21 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 			{
 				rohc_decomp_debug(context, "CRC is correct");
 			}
-			else if((*packet_type) == ROHC_PACKET_IR)
+			else if((*packet_type) == ROHC_PACKET_IR ||
+			        (*packet_type) == ROHC_PACKET_IR_CR)
 			{
 				rohc_decomp_debug(context, "CRC is correct, stop CRC repair");
 				context->crc_corr.algo = ROHC_DECOMP_CRC_CORR_SN_NONE;
 				context->crc_corr.counter = 0;
+				context->crc_corr.cands_nr = 0;
 			}
 			else
 			{
 				rohc_decomp_debug(context, "CID %zu: CRC repair: CRC is correct",
 				                  context->cid);
 				try_decoding_again = false;
+				/* the other candidate corrections are useless */
+				context->crc_corr.cands_nr = 0;
 			}
 		}
 		else if(build_ret == ROHC_STATUS_OUTPUT_TOO_SMALL)
@@ -1499,7 +3075,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 			/* uncompressed headers cannot be built, stop decoding */
 			rohc_decomp_warn(context, "CID %zu: failed to build uncompressed "
 			                 "headers", context->cid);
-			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			if((d_features(decomp) & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 			{
 				rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
 				                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
@@ -1524,6 +3100,25 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 				profile->attempt_repair(decomp, context, rohc_packet.time,
 				                        &context->crc_corr, extr_bits);
 
+			/* bound the work spent on one packet whatever the repair algorithms
+			 * propose */
+			if(try_decoding_again &&
+			   decode_attempts_nr >= ROHC_DECOMP_DECODE_ATTEMPTS_MAX)
+			{
+				rohc_decomp_warn(context, "CID %zu: CRC repair: give up after %zu "
+				                 "decoding attempts", context->cid,
+				                 decode_attempts_nr);
+				try_decoding_again = false;
+			}
+
+			if(try_decoding_again)
+			{
+				decomp->stats.crc_repairs++;
+			}
+
+			/* drop the headers built by the failed attempt before the next one */
+			uncomp_packet->len -= uncomp_hdr_len;
+
 			/* report CRC failure if attempt is not possible */
 			if(!try_decoding_again)
 			{
@@ -1531,7 +3126,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 				 * was disabled or attempted without any success, so give up */
 				rohc_decomp_warn(context, "CID %zu: failed to build uncompressed "
 				                 "headers (CRC failure)", context->cid);
-				if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+				if((d_features(decomp) & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 				{
 					rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
 					                 ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
@@ -1543,10 +3138,18 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 	}
 	while(try_decoding_again);
 
+	/* the SN interpretation without the reorder window is the regular one,
+	 * so it does not require any CRC-valid packet to be approved */
+	if(context->crc_corr.algo == ROHC_DECOMP_CRC_CORR_SN_IN_ORDER)
+	{
+		context->crc_corr.algo = ROHC_DECOMP_CRC_CORR_SN_NONE;
+	}
 	/* after CRC failure, if the SN value seems to be correctly guessed, we must
 	 * wait for 3 CRC-valid packets before the correction is approved. Two
-	 * packets are therefore thrown away. */
-	if(context->crc_corr.algo != ROHC_DECOMP_CRC_CORR_SN_NONE)
+	 * packets are therefore thrown away. R-0 packets carry no CRC, so they
+	 * cannot approve the correction. */
+	else if(context->crc_corr.algo != ROHC_DECOMP_CRC_CORR_SN_NONE &&
+	        (*packet_type) != ROHC_PACKET_R_0)
 	{
 		if(context->crc_corr.counter > 1)
 		{
@@ -1593,6 +3196,7 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 
 	/* E. Copy the payload (if any) */
 
+copy_payload:
 	if((rohc_hdr_len + payload_len) != rohc_packet.len)
 	{
 		rohc_decomp_warn(context, "ROHC %s header (%zu bytes) and payload "
@@ -1601,20 +3205,53 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 		                 rohc_hdr_len, payload_len, rohc_packet.len);
 		goto error;
 	}
-	if(rohc_buf_avail_len(*uncomp_packet) < payload_len)
+	rohc_perf_begin(decomp, ROHC_DECOMP_PERF_PAYLOAD_COPY);
+	if(payload != NULL && profile->id != ROHC_PROFILE_UNCOMPRESSED)
+	{
+		/* only the uncompressed headers are asked for (see
+		 * rohc_decompress_fields()): the payload is left where it is */
+		*payload = rohc_packet;
+		rohc_buf_pull(payload, rohc_hdr_len);
+		rohc_buf_push(uncomp_packet, uncomp_hdr_len);
+		rohc_decomp_debug(context, "%zu-byte payload left in place",
+		                  payload_len);
+	}
+	else if(uncomp_packet->data == rohc_packet.data &&
+	   uncomp_packet->max_len <= rohc_packet.offset)
+	{
+		/* uncompressed headers were built in the headroom of the ROHC packet
+		 * (see rohc_decompress_inplace()): move them right in front of the
+		 * payload, so that the payload itself is never copied */
+		const size_t payload_offset = rohc_packet.offset + rohc_hdr_len;
+
+		rohc_buf_push(uncomp_packet, uncomp_hdr_len);
+		memmove(rohc_packet.data + payload_offset - uncomp_hdr_len,
+		        rohc_buf_data(*uncomp_packet), uncomp_hdr_len);
+		uncomp_packet->max_len = rohc_packet.max_len;
+		uncomp_packet->offset = payload_offset - uncomp_hdr_len;
+		uncomp_packet->len = uncomp_hdr_len + payload_len;
+		rohc_decomp_debug(context, "%zu-byte payload kept in place, %zu-byte "
+		                  "uncompressed headers moved in front of it",
+		                  payload_len, uncomp_hdr_len);
+	}
+	else if(rohc_buf_avail_len(*uncomp_packet) < payload_len)
 	{
 		rohc_decomp_warn(context, "uncompressed packet too small (%zu bytes "
 		                 "max) for the %zu-byte payload",
 		                 rohc_buf_avail_len(*uncomp_packet), payload_len);
 		goto error_output_too_small;
 	}
-	if(payload_len != 0)
+	else
 	{
-		rohc_buf_append(uncomp_packet, payload_data, payload_len);
-		rohc_buf_pull(uncomp_packet, payload_len);
+		if(payload_len != 0)
+		{
+			rohc_buf_append(uncomp_packet, payload_data, payload_len);
+			rohc_buf_pull(uncomp_packet, payload_len);
+		}
+		/* unhide the uncompressed headers and payload */
+		rohc_buf_push(uncomp_packet, uncomp_hdr_len + payload_len);
 	}
-	/* unhide the uncompressed headers and payload */
-	rohc_buf_push(uncomp_packet, uncomp_hdr_len + payload_len);
+	rohc_perf_end(decomp, ROHC_DECOMP_PERF_PAYLOAD_COPY);
 	rohc_decomp_debug(context, "uncompressed packet length = %zu bytes",
 	                  uncomp_packet->len);
 
@@ -1633,12 +3270,16 @@ static rohc_status_t rohc_decomp_decode_pkt(struct rohc_decomp *const decomp,
 	{
 		rohc_decomp_debug(context, "change from state %d to state %d",
 		                  context->state, ROHC_DECOMP_STATE_FC);
-		context->state = ROHC_DECOMP_STATE_FC;
+		rohc_decomp_change_state(context, ROHC_DECOMP_STATE_FC);
 	}
 
-	/* update context with decoded values */
-	rohc_decomp_update_context(context, decoded_values, payload_len,
-	                           rohc_packet.time, do_change_mode);
+	/* update context with decoded values, but R-0 packets are not protected
+	 * by any CRC, so they do not update the context (RFC 3095, §5.5.1.1) */
+	if((*packet_type) != ROHC_PACKET_R_0)
+	{
+		rohc_decomp_update_context(context, decoded_values, payload_len,
+		                           rohc_packet.time, do_change_mode);
+	}
 
 	/* update statistics */
 	rohc_decomp_stats_add_success(context, rohc_hdr_len, uncomp_hdr_len);
@@ -1663,13 +3304,19 @@ error_malformed:
  * The CRC for IR/IR-DYN headers is always CRC-8. It is computed on the
  * whole compressed header (payload excluded, but any CID bits included).
  *
+ * The part of the IR header up to the end of its static chain does not change
+ * as long as the static chain does not: its CRC is recorded in the context
+ * once the IR packet is successfully decompressed. The next IR packets that
+ * repeat the same static chain compute the CRC over their dynamic chain only.
+ *
  * @param decomp          The ROHC decompressor
  * @param context         The decompression context
  * @param rohc_hdr        The compressed IR or IR-DYN header
  * @param rohc_hdr_len    The length (in bytes) of the compressed header
  * @param add_cid_len     The length of the optional Add-CID field
  * @param large_cid_len   The length of the optional large CID field
- * @param crc_packet      The CRC extracted from the ROHC header
+ * @param extr_crc        IN:  The CRC extracted from the ROHC header
+ *                        OUT: The CRC of the header up to its static chain
  * @return                true if the CRC is correct, false otherwise
  */
 static bool rohc_decomp_check_ir_crc(const struct rohc_decomp *const decomp,
@@ -1678,9 +3325,11 @@ static bool rohc_decomp_check_ir_crc(const struct rohc_decomp *const decomp,
                                      const size_t rohc_hdr_len,
                                      const size_t add_cid_len,
                                      const size_t large_cid_len,
-                                     const uint8_t crc_packet)
+                                     struct rohc_decomp_crc *const extr_crc)
 {
 	const size_t rohc_hdr_full_len = add_cid_len + large_cid_len + rohc_hdr_len;
+	const size_t crc_pos = add_cid_len + 2 + large_cid_len;
+	const uint8_t crc_packet = extr_crc->bits;
 	const uint8_t *crc_table;
 	const rohc_crc_type_t crc_type = ROHC_CRC_TYPE_8;
 	const uint8_t crc_zero[] = { 0x00 };
@@ -1689,28 +3338,60 @@ static bool rohc_decomp_check_ir_crc(const struct rohc_decomp *const decomp,
 	assert(decomp != NULL);
 	assert(rohc_hdr != NULL);
 	assert(rohc_hdr_len >= (add_cid_len + 2 + large_cid_len + 1));
+	assert(extr_crc->static_end == 0 ||
+	       (add_cid_len + extr_crc->static_end) <= rohc_hdr_len);
 
-	crc_table = decomp->crc_table_8;
-
-	/* ROHC header before CRC field:
-	 * optional Add-CID + IR type + Profile ID + optional large CID */
-	crc_comp = crc_calculate(crc_type, rohc_hdr,
-	                         add_cid_len + 2 + large_cid_len,
-	                         CRC_INIT_8, crc_table);
+	crc_table = rohc_crc_table_8;
 
-	/* all profiles but the Uncompressed profile compute their CRC through the
-	 * zeroed CRC field and the rest of the ROHC header */
-	if(context->profile->id != ROHC_PROFILE_UNCOMPRESSED)
+	if(extr_crc->static_end > 0 && extr_crc->is_static_unchanged &&
+	   rohc_hdr[add_cid_len] == context->ir_static_type)
 	{
-		/* zeroed CRC field */
+		/* same header up to the end of the static chain as the last IR packet:
+		 * ROHC header after the static chain only */
+		crc_comp = crc_calculate(crc_type,
+		                         rohc_hdr + add_cid_len + extr_crc->static_end,
+		                         rohc_hdr_len - add_cid_len - extr_crc->static_end,
+		                         context->ir_static_crc, crc_table);
+	}
+	else if(extr_crc->static_end > 0)
+	{
+		/* ROHC header before CRC field, zeroed CRC field, then static chain */
+		crc_comp = crc_calculate(crc_type, rohc_hdr, crc_pos, CRC_INIT_8,
+		                         crc_table);
 		crc_comp = crc_calculate(crc_type, crc_zero, 1, crc_comp, crc_table);
+		crc_comp = crc_calculate(crc_type, rohc_hdr + crc_pos + 1,
+		                         add_cid_len + extr_crc->static_end - crc_pos - 1,
+		                         crc_comp, crc_table);
+		extr_crc->static_crc = crc_comp;
+		extr_crc->static_type = rohc_hdr[add_cid_len];
+		extr_crc->is_static_unchanged = false;
 
-		/* ROHC header after CRC field */
+		/* ROHC header after the static chain */
 		crc_comp = crc_calculate(crc_type,
-		                         rohc_hdr + add_cid_len + 2 + large_cid_len + 1,
-		                         rohc_hdr_len - add_cid_len - 2 - large_cid_len - 1,
+		                         rohc_hdr + add_cid_len + extr_crc->static_end,
+		                         rohc_hdr_len - add_cid_len - extr_crc->static_end,
 		                         crc_comp, crc_table);
 	}
+	else
+	{
+		/* ROHC header before CRC field:
+		 * optional Add-CID + IR type + Profile ID + optional large CID */
+		crc_comp = crc_calculate(crc_type, rohc_hdr, crc_pos, CRC_INIT_8,
+		                         crc_table);
+
+		/* all profiles but the Uncompressed profile compute their CRC through
+		 * the zeroed CRC field and the rest of the ROHC header */
+		if(context->profile->id != ROHC_PROFILE_UNCOMPRESSED)
+		{
+			/* zeroed CRC field */
+			crc_comp = crc_calculate(crc_type, crc_zero, 1, crc_comp, crc_table);
+
+			/* ROHC header after CRC field */
+			crc_comp = crc_calculate(crc_type, rohc_hdr + crc_pos + 1,
+			                         rohc_hdr_len - crc_pos - 1,
+			                         crc_comp, crc_table);
+		}
+	}
 
 	rohc_decomp_debug(context, "CRC-%d on compressed %zu-byte ROHC header = "
 	                  "0x%x", crc_type, rohc_hdr_full_len, crc_comp);
@@ -1752,6 +3433,15 @@ static void rohc_decomp_update_context(struct rohc_decomp_ctxt *const context,
 	/* call the profile-specific callback */
 	context->profile->update_ctxt(context, decoded, payload_len, do_change_mode);
 
+	/* the profile kept the static chain of the IR packet, keep the CRC of the
+	 * IR header up to the end of the static chain along */
+	if(context->volat_ctxt.crc.static_end > 0 &&
+	   !context->volat_ctxt.crc.is_static_unchanged)
+	{
+		context->ir_static_crc = context->volat_ctxt.crc.static_crc;
+		context->ir_static_type = context->volat_ctxt.crc.static_type;
+	}
+
 	/* update arrival time */
 	crc_corr->arrival_times[crc_corr->arrival_times_index] = pkt_arrival_time;
 	crc_corr->arrival_times_index =
@@ -1832,7 +3522,8 @@ static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
 		/* feedback logic for O-mode is described in RFC 3095, §5.4.2.2 */
 
 		/* all states: when an IR packet is correctly decompressed, send an ACK(O) */
-		if(infos->packet_type == ROHC_PACKET_IR)
+		if(infos->packet_type == ROHC_PACKET_IR ||
+		   infos->packet_type == ROHC_PACKET_IR_CR)
 		{
 			do_build_ack = true;
 		}
@@ -1852,8 +3543,25 @@ static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
 	}
 	else /* R-mode */
 	{
-		assert(0); /* TODO: R-mode not implemented yet */
-		goto error;
+		/* feedback logic for R-mode is described in RFC 3095, §5.5.2.2: all
+		 * states: when a context updating packet (ie. a packet that carries a
+		 * 7- or 8-bit CRC) is correctly decompressed, send an ACK(R) ; the
+		 * R-0 packets do not update the context, so they are never
+		 * acknowledged */
+		if(rohc_decomp_packet_carry_crc_7_or_8(infos->packet_type))
+		{
+			do_build_ack = true;
+		}
+	}
+
+	/* the ACK deferred while overloaded acknowledges the first packet after
+	 * the overload */
+	if(!do_build_ack && infos->context->is_ack_deferred &&
+	   !decomp->is_overloaded)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "send the positive ACK deferred during the overload");
+		do_build_ack = true;
 	}
 
 	/* stop now if no ACK is required */
@@ -1864,6 +3572,17 @@ static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
 		goto skip;
 	}
 
+	/* defer the optional ACKs while overloaded */
+	if(decomp->is_overloaded && !infos->do_change_mode)
+	{
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+		           "decompressor overloaded, defer the positive ACK");
+		infos->context->is_ack_deferred = true;
+		decomp->stats.overload_acks++;
+		goto skip;
+	}
+	infos->context->is_ack_deferred = false;
+
 	/* rate-limit the ACKs */
 	decomp->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed |= 1;
 	infos->context->last_pkt_feedbacks[ROHC_FEEDBACK_ACK].needed |= 1;
@@ -1906,23 +3625,19 @@ static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
 			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
 			           "use FEEDBACK-1 as positive feedback");
 			f_feedback1(infos->sn_bits, &sfeedback);
-			crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
+			feedbackp = f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
+			                            ROHC_FEEDBACK_WITH_NO_CRC, rohc_crc_table_8,
+			                            &feedbacksize);
 		}
 		else
 		{
 			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
 			           "use FEEDBACK-2 as positive ACK(%c) feedback",
 			           mode_short[infos->mode]);
-			if(!f_feedback2(infos->profile_id, ROHC_FEEDBACK_ACK, infos->mode,
-			                infos->sn_bits, infos->sn_bits_nr, &sfeedback))
-			{
-				rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-				             "failed to build the ACK feedback");
-				goto error;
-			}
 
 			/* use CRC option if mode change requested */
-			if(infos->profile_id == ROHC_PROFILE_TCP)
+			if(infos->profile_id == ROHC_PROFILE_TCP ||
+			   rohc_profile_is_rohcv2(infos->profile_id))
 			{
 				crc_present = ROHC_FEEDBACK_WITH_CRC_BASE;
 			}
@@ -1934,34 +3649,42 @@ static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
 			{
 				crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
 			}
-		}
 
-		/* build the feedback packet */
-		feedbackp = f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
-		                            crc_present, decomp->crc_table_8, &feedbacksize);
+			/* only the SN bits and the CRC change from one ACK to the next
+			 * one, patch them in the prebuilt packet of the context */
+			feedbackp =
+				f_feedback2_tmpl(&infos->context->feedback_tmpl, infos->profile_id,
+				                 ROHC_FEEDBACK_ACK, infos->mode, infos->sn_bits,
+				                 infos->sn_bits_nr, infos->cid, infos->cid_type,
+				                 crc_present, rohc_crc_table_8, &feedbacksize);
+		}
 		if(feedbackp == NULL)
 		{
 			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			             "failed to wrap the ACK feedback");
+			             "failed to build the ACK feedback");
 			goto error;
 		}
 
 		/* copy the feedback to the buffer provided by the user */
 		/* TODO: build feedback directly into the provided buffer */
 		feedback_hdr_len = 1 + (feedbacksize < 8 ? 0 : 1);
-		if((feedback_hdr_len + feedbacksize) <= rohc_buf_avail_len(*feedback))
+		if((feedback->len + feedback_hdr_len + feedbacksize) <=
+		   rohc_buf_avail_len(*feedback) &&
+		   rohc_decomp_feedback_fits_rates(decomp, infos,
+		                                   feedback_hdr_len + feedbacksize))
 		{
 			if(feedbacksize < 8)
 			{
-				rohc_buf_byte(*feedback) = 0xf0 | feedbacksize;
+				rohc_buf_byte_at(*feedback, feedback->len) = 0xf0 | feedbacksize;
 			}
 			else
 			{
-				rohc_buf_byte(*feedback) = 0xf0;
-				rohc_buf_byte_at(*feedback, 1) = feedbacksize;
+				rohc_buf_byte_at(*feedback, feedback->len) = 0xf0;
+				rohc_buf_byte_at(*feedback, feedback->len + 1) = feedbacksize;
 			}
 			feedback->len += feedback_hdr_len;
 			rohc_buf_append(feedback, feedbackp, feedbacksize);
+			decomp->stats.feedbacks_ack++;
 		}
 
 		if(feedback->len > 0)
@@ -1970,9 +3693,6 @@ static bool rohc_decomp_feedback_ack(struct rohc_decomp *const decomp,
 			           "decompressor built a %zu-byte positive feedback",
 			           feedback->len);
 		}
-
-		/* destroy the temporary feedback buffer */
-		free(feedbackp);
 	}
 
 skip:
@@ -2078,9 +3798,10 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
 		do_downward_transition = true;
 		do_build_ack = false;
 	}
-	else if(infos->mode == ROHC_O_MODE)
+	else /* O- or R-mode */
 	{
-		/* feedback logic for O-mode is described in RFC 3095, §5.4.2.2 */
+		/* feedback logic for O-mode is described in RFC 3095, §5.4.2.2, the
+		 * R-mode logic of §5.5.2.2 sends the same negative feedbacks in R-mode */
 
 		/* NC state: when receiving a type 0, 1, 2 or IR-DYN packet, or an IR
 		 * packet has failed the CRC check, send a STATIC-NACK(O), subject to the
@@ -2122,11 +3843,6 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
 			do_build_ack = true;
 		}
 	}
-	else /* R-mode */
-	{
-		assert(0); /* TODO: R-mode not implemented yet */
-		goto error;
-	}
 
 	/* stop now if no downward state transition nor NACK is required */
 	if(!do_build_ack && !do_downward_transition)
@@ -2243,17 +3959,9 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
 		           k_too_quickly, threshold_too_quickly,
 		           k_too_many, decomp->ack_rate_limits.speed.threshold);
 
-		/* prepare FEEDBACK-2 */
-		if(!f_feedback2(infos->profile_id, ack_type, infos->mode, infos->sn_bits,
-		                infos->sn_bits_nr, &sfeedback))
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			             "failed to build the (STATIC-)NACK feedback");
-			goto error;
-		}
-
 		/* use CRC option if mode change requested */
-		if(infos->profile_id == ROHC_PROFILE_TCP)
+		if(infos->profile_id == ROHC_PROFILE_TCP ||
+		   rohc_profile_is_rohcv2(infos->profile_id))
 		{
 			crc_present = ROHC_FEEDBACK_WITH_CRC_BASE;
 		}
@@ -2266,32 +3974,54 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
 			crc_present = ROHC_FEEDBACK_WITH_NO_CRC;
 		}
 
-		/* build the feedback packet */
-		feedbackp = f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
-		                            crc_present, decomp->crc_table_8, &feedbacksize);
+		/* build the FEEDBACK-2 packet from the prebuilt packet of the context
+		 * if any */
+		if(infos->context != NULL)
+		{
+			feedbackp =
+				f_feedback2_tmpl(&infos->context->feedback_tmpl, infos->profile_id,
+				                 ack_type, infos->mode, infos->sn_bits,
+				                 infos->sn_bits_nr, infos->cid, infos->cid_type,
+				                 crc_present, rohc_crc_table_8, &feedbacksize);
+		}
+		else if(f_feedback2(infos->profile_id, ack_type, infos->mode,
+		                    infos->sn_bits, infos->sn_bits_nr, &sfeedback))
+		{
+			feedbackp = f_wrap_feedback(&sfeedback, infos->cid, infos->cid_type,
+			                            crc_present, rohc_crc_table_8,
+			                            &feedbacksize);
+		}
+		else
+		{
+			feedbackp = NULL;
+		}
 		if(feedbackp == NULL)
 		{
 			rohc_warning(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
-			             "failed to wrap the (STATIC-)NACK feedback");
+			             "failed to build the (STATIC-)NACK feedback");
 			goto error;
 		}
 
 		/* copy the feedback to the buffer provided by the user */
 		/* TODO: build feedback directly into the provided buffer */
 		feedback_hdr_len = 1 + (feedbacksize < 8 ? 0 : 1);
-		if((feedback_hdr_len + feedbacksize) <= rohc_buf_avail_len(*feedback))
+		if((feedback->len + feedback_hdr_len + feedbacksize) <=
+		   rohc_buf_avail_len(*feedback) &&
+		   rohc_decomp_feedback_fits_rates(decomp, infos,
+		                                   feedback_hdr_len + feedbacksize))
 		{
 			if(feedbacksize < 8)
 			{
-				rohc_buf_byte(*feedback) = 0xf0 | feedbacksize;
+				rohc_buf_byte_at(*feedback, feedback->len) = 0xf0 | feedbacksize;
 			}
 			else
 			{
-				rohc_buf_byte(*feedback) = 0xf0;
-				rohc_buf_byte_at(*feedback, 1) = feedbacksize;
+				rohc_buf_byte_at(*feedback, feedback->len) = 0xf0;
+				rohc_buf_byte_at(*feedback, feedback->len + 1) = feedbacksize;
 			}
 			feedback->len += feedback_hdr_len;
 			rohc_buf_append(feedback, feedbackp, feedbacksize);
+			decomp->stats.feedbacks_nack++;
 		}
 
 		if(feedback->len > 0)
@@ -2300,9 +4030,6 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
 			           "decompressor built a %zu-byte negative feedback",
 			           feedback->len);
 		}
-
-		/* destroy the temporary feedback buffer */
-		free(feedbackp);
 	}
 
 	/* upon decompression failure, perform downward transitions if context is
@@ -2327,14 +4054,14 @@ static bool rohc_decomp_feedback_nack(struct rohc_decomp *const decomp,
 			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
 			          "change from state %d to state %d because of error(s)",
 			          infos->state, ROHC_DECOMP_STATE_NC);
-			infos->context->state = ROHC_DECOMP_STATE_NC;
+			rohc_decomp_change_state(infos->context, ROHC_DECOMP_STATE_NC);
 		}
 		else if(infos->state == ROHC_DECOMP_STATE_FC)
 		{
 			rohc_info(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
 			          "change from state %d to state %d because of error(s)",
 			          infos->state, ROHC_DECOMP_STATE_SC);
-			infos->context->state = ROHC_DECOMP_STATE_SC;
+			rohc_decomp_change_state(infos->context, ROHC_DECOMP_STATE_SC);
 		}
 		else
 		{
@@ -2351,6 +4078,112 @@ error:
 }
 
 
+/**
+ * @brief Whether the byte rates of the feedback channel allow one feedback
+ *
+ * The feedback is allowed if both the token bucket of the decompressor and
+ * the token bucket of the context (if any) hold enough bytes for it. The
+ * bytes of the allowed feedback are then taken from the buckets.
+ *
+ * @param decomp        The ROHC decompressor
+ * @param infos         The information collected on the decompressed packet
+ * @param feedback_len  The length of the feedback, feedback header included
+ * @return              true if the feedback may be sent,
+ *                      false if it exceeds one of the byte rates
+ */
+static bool rohc_decomp_feedback_fits_rates(struct rohc_decomp *const decomp,
+                                            const struct rohc_decomp_stream *const infos,
+                                            const size_t feedback_len)
+{
+	const uint64_t tokens_needed = ((uint64_t) feedback_len) * 1000000U;
+	const size_t decomp_rate = decomp->ack_rate_limits.decomp_byte_rate;
+	const size_t ctxt_rate = (infos->context == NULL ? 0 :
+	                          decomp->ack_rate_limits.ctxt_byte_rate);
+
+	if(decomp_rate != 0)
+	{
+		rohc_feedback_bucket_refill(&decomp->feedback_bucket, decomp_rate,
+		                            infos->arrival_time);
+		if(decomp->feedback_bucket.tokens < tokens_needed)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "do not send the %zu-byte feedback because of the byte "
+			           "rate of the decompressor (%zu bytes/s)", feedback_len,
+			           decomp_rate);
+			goto error;
+		}
+	}
+	if(ctxt_rate != 0)
+	{
+		rohc_feedback_bucket_refill(&infos->context->feedback_bucket, ctxt_rate,
+		                            infos->arrival_time);
+		if(infos->context->feedback_bucket.tokens < tokens_needed)
+		{
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, infos->profile_id,
+			           "CID %zu: do not send the %zu-byte feedback because of "
+			           "the byte rate of the context (%zu bytes/s)", infos->cid,
+			           feedback_len, ctxt_rate);
+			goto error;
+		}
+	}
+
+	/* take the bytes of the feedback from the buckets */
+	if(decomp_rate != 0)
+	{
+		decomp->feedback_bucket.tokens -= tokens_needed;
+	}
+	if(ctxt_rate != 0)
+	{
+		infos->context->feedback_bucket.tokens -= tokens_needed;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Refill one token bucket with the time elapsed since its last refill
+ *
+ * The bucket holds at most one second of feedback. If the time goes backward,
+ * the bucket is not refilled but its time is reset to the current time.
+ *
+ * @param bucket     The token bucket to refill
+ * @param byte_rate  The max bytes of feedback per second
+ * @param now        The current time, ie. the arrival time of the packet
+ */
+static void rohc_feedback_bucket_refill(struct rohc_feedback_bucket *const bucket,
+                                        const size_t byte_rate,
+                                        const struct rohc_ts now)
+{
+	const uint64_t tokens_max = ((uint64_t) byte_rate) * 1000000U;
+
+	if(now.sec > bucket->last_refill.sec ||
+	   (now.sec == bucket->last_refill.sec && now.nsec > bucket->last_refill.nsec))
+	{
+		const uint64_t elapsed_us = rohc_time_interval(bucket->last_refill, now);
+
+		if(elapsed_us >= 1000000U)
+		{
+			bucket->tokens = tokens_max;
+		}
+		else
+		{
+			bucket->tokens = rohc_min(bucket->tokens + elapsed_us * byte_rate,
+			                          tokens_max);
+		}
+		bucket->last_refill = now;
+	}
+	else if(now.sec < bucket->last_refill.sec ||
+	        (now.sec == bucket->last_refill.sec && now.nsec < bucket->last_refill.nsec))
+	{
+		bucket->last_refill = now;
+	}
+}
+
+
 /**
  * @brief Update statistics upon successful decompression
  *
@@ -2367,6 +4200,37 @@ static void rohc_decomp_stats_add_success(struct rohc_decomp_ctxt *const context
 }
 
 
+/**
+ * @brief Record the information about the last decompressed packet
+ *
+ * The information is copied from the last context, so that it may be read
+ * while the context is modified or destroyed, see
+ * \ref rohc_decomp_get_last_packet_info.
+ *
+ * @param decomp  The ROHC decompressor
+ */
+static void rohc_decomp_stats_record_last(struct rohc_decomp *const decomp)
+{
+	const struct rohc_decomp_ctxt *const context = decomp->last_context;
+	rohc_decomp_last_packet_info_t *const info = &decomp->last_pkt_info;
+
+	decomp->has_last_pkt_info = (context != NULL);
+	if(context != NULL)
+	{
+		info->context_mode = context->mode;
+		info->context_state = context->state;
+		info->profile_id = context->profile->id;
+		info->nr_lost_packets = context->nr_lost_packets;
+		info->nr_misordered_packets = context->nr_misordered_packets;
+		info->is_duplicated = context->is_duplicated;
+		info->corrected_crc_failures = context->corrected_crc_failures;
+		info->corrected_sn_wraparounds = context->corrected_sn_wraparounds;
+		info->corrected_wrong_sn_updates = context->corrected_wrong_sn_updates;
+		info->packet_type = context->packet_type;
+	}
+}
+
+
 /**
  * @brief Reset all the statistics of the given ROHC decompressor
  *
@@ -2375,6 +4239,8 @@ static void rohc_decomp_stats_add_success(struct rohc_decomp_ctxt *const context
 static void rohc_decomp_reset_stats(struct rohc_decomp *const decomp)
 {
 	assert(decomp != NULL);
+	decomp->stats_seq = 0;
+	decomp->has_last_pkt_info = false;
 	decomp->stats.received = 0;
 	decomp->stats.failed_crc = 0;
 	decomp->stats.failed_no_context = 0;
@@ -2384,6 +4250,12 @@ static void rohc_decomp_reset_stats(struct rohc_decomp *const decomp)
 	decomp->stats.corrected_crc_failures = 0;
 	decomp->stats.corrected_sn_wraparounds = 0;
 	decomp->stats.corrected_wrong_sn_updates = 0;
+	decomp->stats.feedbacks_ack = 0;
+	decomp->stats.feedbacks_nack = 0;
+	decomp->stats.crc_repairs = 0;
+	decomp->stats.overloads = 0;
+	decomp->stats.overload_pkts = 0;
+	decomp->stats.overload_acks = 0;
 }
 
 
@@ -2434,6 +4306,10 @@ const char * rohc_decomp_get_state_descr(const rohc_decomp_state_t state)
  * See \ref rohc_decomp_last_packet_info_t for details about fields that
  * are supported in the above versions.
  *
+ * The function may be called by a monitoring thread while another thread
+ * decompresses packets with the decompressor: the information is copied without
+ * any lock, again if the decompressor modified it in the meantime.
+ *
  * @param decomp        The ROHC decompressor to get information from
  * @param[in,out] info  The structure where information will be stored
  * @return              true in case of success, false otherwise
@@ -2450,13 +4326,6 @@ bool rohc_decomp_get_last_packet_info(const struct rohc_decomp *const decomp,
 		goto error;
 	}
 
-	if(decomp->last_context == NULL)
-	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		           "last context found in decompressor is not valid");
-		goto error;
-	}
-
 	if(info == NULL)
 	{
 		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
@@ -2467,35 +4336,50 @@ bool rohc_decomp_get_last_packet_info(const struct rohc_decomp *const decomp,
 	/* check compatibility version */
 	if(info->version_major == 0)
 	{
-		/* base fields for major version 0 */
-		info->context_mode = decomp->last_context->mode;
-		info->context_state = decomp->last_context->state;
-		info->profile_id = decomp->last_context->profile->id;
-		info->nr_lost_packets = decomp->last_context->nr_lost_packets;
-		info->nr_misordered_packets = decomp->last_context->nr_misordered_packets;
-		info->is_duplicated = decomp->last_context->is_duplicated;
+		const rohc_decomp_last_packet_info_t *const last = &decomp->last_pkt_info;
+		bool has_last_pkt_info;
+		uint32_t seq;
 
-		/* new fields added by minor versions */
-		switch(info->version_minor)
+		if(info->version_minor > 1)
 		{
-			case 0:
-				/* nothing to add */
-				break;
-			case 1:
+			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "last packet information", info->version_minor);
+			goto error;
+		}
+
+		/* the information is copied again if the decompressor modified it
+		 * in the meantime */
+		do
+		{
+			seq = rohc_seqlock_read_begin(&decomp->stats_seq);
+			has_last_pkt_info = decomp->has_last_pkt_info;
+
+			/* base fields for major version 0 */
+			info->context_mode = last->context_mode;
+			info->context_state = last->context_state;
+			info->profile_id = last->profile_id;
+			info->nr_lost_packets = last->nr_lost_packets;
+			info->nr_misordered_packets = last->nr_misordered_packets;
+			info->is_duplicated = last->is_duplicated;
+
+			/* new fields added by minor versions */
+			if(info->version_minor >= 1)
+			{
 				/* new fields in 0.1 */
-				info->corrected_crc_failures =
-					decomp->last_context->corrected_crc_failures;
-				info->corrected_sn_wraparounds =
-					decomp->last_context->corrected_sn_wraparounds;
-				info->corrected_wrong_sn_updates =
-					decomp->last_context->corrected_wrong_sn_updates;
-				info->packet_type = decomp->last_context->packet_type;
-				break;
-			default:
-				rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-				           "unsupported minor version (%u) of the structure for "
-				           "last packet information", info->version_minor);
-				goto error;
+				info->corrected_crc_failures = last->corrected_crc_failures;
+				info->corrected_sn_wraparounds = last->corrected_sn_wraparounds;
+				info->corrected_wrong_sn_updates = last->corrected_wrong_sn_updates;
+				info->packet_type = last->packet_type;
+			}
+		}
+		while(rohc_seqlock_read_retry(&decomp->stats_seq, seq));
+
+		if(!has_last_pkt_info)
+		{
+			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "last context found in decompressor is not valid");
+			goto error;
 		}
 	}
 	else
@@ -2564,7 +4448,9 @@ bool rohc_decomp_get_context_info(const struct rohc_decomp *const decomp,
 	if(info->version_major == 0)
 	{
 		/* base fields for major version 0 */
-		if(decomp->contexts[cid] == NULL)
+		const struct rohc_decomp_ctxt *const context = find_context(decomp, cid);
+
+		if(context == NULL)
 		{
 			info->packets_nr = 0;
 			info->comp_bytes_nr = 0;
@@ -2575,15 +4461,15 @@ bool rohc_decomp_get_context_info(const struct rohc_decomp *const decomp,
 		}
 		else
 		{
-			info->packets_nr = decomp->contexts[cid]->num_recv_packets;
-			info->comp_bytes_nr = decomp->contexts[cid]->total_compressed_size;
-			info->uncomp_bytes_nr = decomp->contexts[cid]->total_uncompressed_size;
+			info->packets_nr = context->num_recv_packets;
+			info->comp_bytes_nr = context->total_compressed_size;
+			info->uncomp_bytes_nr = context->total_uncompressed_size;
 			info->corrected_crc_failures =
-				decomp->contexts[cid]->corrected_crc_failures;
+				context->corrected_crc_failures;
 			info->corrected_sn_wraparounds =
-				decomp->contexts[cid]->corrected_sn_wraparounds;
+				context->corrected_sn_wraparounds;
 			info->corrected_wrong_sn_updates =
-				decomp->contexts[cid]->corrected_wrong_sn_updates;
+				context->corrected_wrong_sn_updates;
 		}
 
 		/* new fields added by minor versions */
@@ -2610,6 +4496,80 @@ error:
 }
 
 
+/**
+ * @brief Get the records of all the decompression contexts in use
+ *
+ * Fill the given array with one compact record per decompression context in
+ * use, in increasing order of CIDs. The contexts are walked once, so the
+ * records of thousands of contexts are retrieved much faster than with one
+ * call of \ref rohc_decomp_get_context_info per CID.
+ *
+ * The function does not lock the decompressor: call it from the thread that
+ * decompresses the packets, or while no packet is being decompressed. The
+ * records are a copy of the statistics of the contexts, so they may then be
+ * processed from another thread, eg. a monitoring thread, without any
+ * impact on the decompression.
+ *
+ * If the decompressor uses more contexts than \e records_max, only the
+ * records of the \e records_max contexts with the smallest CIDs are given.
+ * The number of contexts in use is given by
+ * \ref rohc_decomp_get_general_info.
+ *
+ * @param decomp        The ROHC decompressor to get the records from
+ * @param[out] records  The records of the contexts in use
+ * @param records_max   The maximum number of records that \e records may
+ *                      hold
+ * @return              The number of records written in \e records,
+ *                      0 if no context is in use or in case of error
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_ctxt_record
+ * @see rohc_decomp_get_general_info
+ */
+size_t rohc_decomp_get_contexts(const struct rohc_decomp *const decomp,
+                                struct rohc_decomp_ctxt_record records[],
+                                const size_t records_max)
+{
+	size_t records_nr = 0;
+	rohc_cid_t cid;
+
+	if(decomp == NULL || records == NULL)
+	{
+		goto error;
+	}
+
+	for(cid = 0;
+	    cid <= decomp->medium.max_cid && records_nr < records_max &&
+	    records_nr < decomp->num_contexts_used;
+	    cid++)
+	{
+		const struct rohc_decomp_ctxt *const context = find_context(decomp, cid);
+		struct rohc_decomp_ctxt_record *record;
+
+		if(context == NULL)
+		{
+			continue;
+		}
+
+		record = &records[records_nr];
+		record->packets_nr = context->num_recv_packets;
+		record->comp_bytes_nr = context->total_compressed_size;
+		record->uncomp_bytes_nr = context->total_uncompressed_size;
+		record->cid = cid;
+		record->profile = context->profile->id;
+		record->mode = context->mode;
+		record->state = context->state;
+		records_nr++;
+	}
+
+	return records_nr;
+
+error:
+	return 0;
+}
+
+
 /**
  * @brief Get some general information about the decompressor
  *
@@ -2623,6 +4583,10 @@ error:
  * See the \ref rohc_decomp_general_info_t structure for details about fields
  * that are supported in the above versions.
  *
+ * The function may be called by a monitoring thread while another thread
+ * decompresses packets with the decompressor: the information is copied without
+ * any lock, again if the decompressor modified it in the meantime.
+ *
  * @param decomp        The ROHC decompressor to get information from
  * @param[in,out] info  The structure where information will be stored
  * @return              true in case of success, false otherwise
@@ -2649,32 +4613,61 @@ bool rohc_decomp_get_general_info(const struct rohc_decomp *const decomp,
 	/* check compatibility version */
 	if(info->version_major == 0)
 	{
-		/* base fields for major version 0 */
-		info->contexts_nr = decomp->num_contexts_used;
-		info->packets_nr = decomp->stats.received;
-		info->comp_bytes_nr = decomp->stats.total_compressed_size;
-		info->uncomp_bytes_nr = decomp->stats.total_uncompressed_size;
+		uint32_t seq;
 
-		/* new fields added by minor versions */
-		switch(info->version_minor)
+		if(info->version_minor > 4)
 		{
-			case 0:
-				/* nothing to add */
-				break;
-			case 1:
+			rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			           "unsupported minor version (%u) of the structure for "
+			           "general information", info->version_minor);
+			goto error;
+		}
+
+		/* the statistics are copied again if the decompressor modified them
+		 * in the meantime */
+		do
+		{
+			seq = rohc_seqlock_read_begin(&decomp->stats_seq);
+
+			/* base fields for major version 0 */
+			info->contexts_nr = decomp->num_contexts_used;
+			info->packets_nr = decomp->stats.received;
+			info->comp_bytes_nr = decomp->stats.total_compressed_size;
+			info->uncomp_bytes_nr = decomp->stats.total_uncompressed_size;
+
+			/* new fields added by minor versions */
+			if(info->version_minor >= 1)
+			{
 				/* new fields in 0.1 */
 				info->corrected_crc_failures = decomp->stats.corrected_crc_failures;
 				info->corrected_sn_wraparounds =
 					decomp->stats.corrected_sn_wraparounds;
 				info->corrected_wrong_sn_updates =
 					decomp->stats.corrected_wrong_sn_updates;
-				break;
-			default:
-				rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-				           "unsupported minor version (%u) of the structure for "
-				           "general information", info->version_minor);
-				goto error;
+			}
+			if(info->version_minor >= 2)
+			{
+				/* new fields in 0.2 */
+				info->failed_crc_nr = decomp->stats.failed_crc;
+				info->failed_no_context_nr = decomp->stats.failed_no_context;
+				info->failed_decomp_nr = decomp->stats.failed_decomp;
+				info->feedbacks_ack_nr = decomp->stats.feedbacks_ack;
+				info->feedbacks_nack_nr = decomp->stats.feedbacks_nack;
+			}
+			if(info->version_minor >= 3)
+			{
+				/* new fields in 0.3 */
+				info->crc_repairs_nr = decomp->stats.crc_repairs;
+			}
+			if(info->version_minor >= 4)
+			{
+				/* new fields in 0.4 */
+				info->overloads_nr = decomp->stats.overloads;
+				info->overload_pkts_nr = decomp->stats.overload_pkts;
+				info->overload_acks_nr = decomp->stats.overload_acks;
+			}
 		}
+		while(rohc_seqlock_read_retry(&decomp->stats_seq, seq));
 	}
 	else
 	{
@@ -2691,6 +4684,48 @@ error:
 }
 
 
+/**
+ * @brief Get the durations of the decompression stages
+ *
+ * Get the histograms of the durations of every decompression stage measured
+ * since the creation of the decompressor. See \ref rohc_decomp_perf_stage_t
+ * for the list of stages.
+ *
+ * The durations are measured only if the library was configured with the
+ * --enable-rohc-perf-stats option. The function fails otherwise.
+ *
+ * @param decomp        The ROHC decompressor to get the durations from
+ * @param[out] stats    The durations of the decompression stages
+ * @return              true in case of success,
+ *                      false if the library measures no duration or
+ *                      if one parameter is invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_perf_stage_t
+ */
+bool rohc_decomp_get_perf_stats(const struct rohc_decomp *const decomp,
+                                struct rohc_decomp_perf_stats *const stats)
+{
+	if(decomp == NULL || stats == NULL)
+	{
+		goto error;
+	}
+
+#if ROHC_PERF_STATS == 1
+	memcpy(stats, &decomp->perf.stats, sizeof(struct rohc_decomp_perf_stats));
+	return true;
+#else
+	rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "library was built without performance statistics, configure "
+	           "it with --enable-rohc-perf-stats");
+#endif
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Get the CID type that the decompressor uses
  *
@@ -2712,7 +4747,7 @@ bool rohc_decomp_get_cid_type(const struct rohc_decomp *const decomp,
 		goto error;
 	}
 
-	*cid_type = decomp->medium.cid_type;
+	*cid_type = d_cid_type(decomp);
 	return true;
 
 error:
@@ -2818,12 +4853,43 @@ bool rohc_decomp_set_mrru(struct rohc_decomp *const decomp,
 		goto error;
 	}
 
-	/* set new MRRU */
-	decomp->mrru = mrru;
-	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-	           "MRRU is now set to %zd", decomp->mrru);
-
-	return true;
+	/* resize the buffer for the Reconstructed Reception Unit (RRU): it is
+	 * allocated only if segmentation is enabled */
+	if(mrru != decomp->mrru)
+	{
+		uint8_t *rru = NULL;
+
+		if(mrru > 0)
+		{
+			rru = rohc_mem_alloc(&decomp->mem_ops, mrru);
+			if(rru == NULL)
+			{
+				rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+				             "failed to allocate %zu bytes for the RRU", mrru);
+				goto error;
+			}
+		}
+		if(decomp->rru_len > mrru)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "discard the %zu bytes of RRU received so far: they "
+			             "exceed the new MRRU", decomp->rru_len);
+			decomp->rru_len = 0;
+		}
+		else if(decomp->rru_len > 0)
+		{
+			memcpy(rru, decomp->rru, decomp->rru_len);
+		}
+		rohc_mem_free(&decomp->mem_ops, decomp->rru);
+		decomp->rru = rru;
+	}
+
+	/* set new MRRU */
+	decomp->mrru = mrru;
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "MRRU is now set to %zd", decomp->mrru);
+
+	return true;
 
 error:
 	return false;
@@ -3004,6 +5070,454 @@ error:
 }
 
 
+/**
+ * @brief Set the reorder window of the decompressor
+ *
+ * Set the maximum number of packets a late packet may be behind the newest
+ * packet of its context. The reorder window applies to the contexts of the
+ * profiles of RFC 3095 in U-mode and O-mode.
+ *
+ * A late packet is decoded against the SN of the newer packets that were
+ * already decompressed, so the LSB interpretation of its SN usually fails
+ * the CRC check. Once the window is set, the interpretation interval of the
+ * SN bits is shifted by \e window packets before the reference SN (at most
+ * half of the values after the reference SN, so that the packets sent after
+ * a burst of lost packets are still decoded). A late packet is then
+ * delivered, but the context keeps the values of the newer packets: no
+ * negative feedback nor correction attempt is triggered by the reordering.
+ *
+ * If the CRC check fails, the regular interpretation of the SN bits is
+ * attempted first, and it is accepted at once if the CRC check is
+ * successful.
+ *
+ * The reorder window must be in range [0 ; 64]. If set to 0, the packets are
+ * expected in order.
+ *
+ * The default value is 0.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param window  The number of packets a late packet may be behind the
+ *                newest one
+ * @return        true if the new value was successfully set, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_reorder_window
+ * @see rohc_decomp_get_last_packet_info
+ */
+bool rohc_decomp_set_reorder_window(struct rohc_decomp *const decomp,
+                                    const size_t window)
+{
+	/* decompressor must be valid */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	/* new reorder window must be in range [0, ROHC_DECOMP_REORDER_WINDOW_MAX] */
+	if(window > ROHC_DECOMP_REORDER_WINDOW_MAX)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unexpected reorder window: must be in range [0, %u]",
+		             ROHC_DECOMP_REORDER_WINDOW_MAX);
+		goto error;
+	}
+
+	/* set new reorder window */
+	decomp->reorder_window = window;
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "reorder window is now set to %zu packets",
+	           decomp->reorder_window);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the reorder window of the decompressor
+ *
+ * See \ref rohc_decomp_set_reorder_window for details.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param[out] window  The number of packets a late packet may be behind the
+ *                     newest one
+ * @return             true if the reorder window was successfully retrieved,
+ *                     false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_reorder_window
+ */
+bool rohc_decomp_get_reorder_window(const struct rohc_decomp *const decomp,
+                                    size_t *const window)
+{
+	if(decomp == NULL || window == NULL)
+	{
+		goto error;
+	}
+
+	*window = decomp->reorder_window;
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the timeout after which unused contexts are destroyed
+ *
+ * By default, the contexts are destroyed only when a new IR packet replaces
+ * them: the contexts of the flows that ended keep their memory forever.
+ *
+ * With an idle timeout, the contexts that did not decompress any packet for
+ * \e timeout seconds are destroyed before the next packet is decompressed,
+ * and their memory is given back for the next contexts. The timeout is
+ * compared to the arrival times of the ROHC packets: the contexts never
+ * expire if the arrival times are not given (zero).
+ *
+ * The contexts are expired from the end of the list of the least recently
+ * used contexts, so the expiry costs nothing while no context expires.
+ *
+ * The timeout shall be smaller than the timeout of the compressor (see
+ * \ref rohc_comp_set_ctxt_idle_timeout), otherwise the compressor may go on
+ * with a context that the decompressor already destroyed.
+ *
+ * @param decomp   The ROHC decompressor
+ * @param timeout  The number of seconds a context may stay unused,
+ *                 0 to never expire the contexts (default)
+ * @return         true if the new value was successfully set, false otherwise
+ *
+ * @ingroup rohc_decomp
+ */
+bool rohc_decomp_set_ctxt_idle_timeout(struct rohc_decomp *const decomp,
+                                       const size_t timeout)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	decomp->ctxt_idle_timeout = timeout;
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "idle timeout of contexts set to %zu seconds", timeout);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the maximum number of bytes the decompressor should use
+ *
+ * The memory of the decompressor grows with the number of contexts in use.
+ * Without budget, it grows until all the CIDs up to MAX_CID are in use.
+ *
+ * With a budget, the decompressor stops growing once it uses \e budget
+ * bytes: an IR packet for a new CID then destroys the least recently used
+ * context first, and the memory of the destroyed context is reused for the
+ * new context. The flow of the destroyed context is decompressed again once
+ * the compressor sends an IR packet for it. The budget is a soft limit: the
+ * decompressor may exceed it by the memory of one context.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param budget  The maximum number of bytes the decompressor should use,
+ *                0 for no limit (default)
+ * @return        true if the new value was successfully set, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_mem_usage
+ */
+bool rohc_decomp_set_mem_budget(struct rohc_decomp *const decomp,
+                                const size_t budget)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	decomp->mem_budget = budget;
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "memory budget set to %zu bytes (%zu bytes in use)", budget,
+	          d_mem_usage(decomp));
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the number of bytes the decompressor uses
+ *
+ * The memory allocated with the callbacks given to
+ * \ref rohc_decomp_set_alloc_cbs is counted.
+ *
+ * @param decomp      The ROHC decompressor
+ * @param[out] usage  The number of bytes the decompressor uses
+ * @return            true if the usage was successfully retrieved,
+ *                    false if a parameter is invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_mem_budget
+ */
+bool rohc_decomp_get_mem_usage(const struct rohc_decomp *const decomp,
+                               size_t *const usage)
+{
+	if(decomp == NULL || usage == NULL)
+	{
+		goto error;
+	}
+
+	*usage = d_mem_usage(decomp);
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the load beyond which the decompressor sheds work
+ *
+ * When a core is saturated, degrading the feedback is better than dropping
+ * packets. Once the load given with \ref rohc_decomp_set_load exceeds one of
+ * the limits, the decompressor enters the overload mode until a load within
+ * the limits is given: the optional positive feedbacks (ACK) are deferred,
+ * every context that deferred one sends an ACK with its first packet after
+ * the overload. The negative feedbacks and the ACKs that change the mode of
+ * a context are never deferred.
+ *
+ * A limit of 0 disables the corresponding criterion. The decompressor is
+ * never overloaded by default.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param limits  The load beyond which the decompressor sheds work,
+ *                NULL to never shed work
+ * @return        true if the new limits are accepted,
+ *                false if the decompressor is invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_load
+ */
+bool rohc_decomp_set_overload(struct rohc_decomp *const decomp,
+                              const struct rohc_load *const limits)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	if(limits == NULL)
+	{
+		decomp->overload_limits.queue_depth = 0;
+		decomp->overload_limits.burst_time_us = 0;
+	}
+	else
+	{
+		decomp->overload_limits = *limits;
+	}
+	decomp->is_overloaded = false;
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	          "overload beyond %zu queued packets or %u us per burst",
+	          decomp->overload_limits.queue_depth,
+	          decomp->overload_limits.burst_time_us);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Give the current load of the core to the decompressor
+ *
+ * Call the function before a burst of packets, eg. with the depth of the
+ * queue the packets are taken from and the time the previous burst took.
+ * The decompressor enters or leaves the overload mode according to the
+ * limits set with \ref rohc_decomp_set_overload.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param load    The current load of the core
+ * @return        true if the load is accepted,
+ *                false if a parameter is invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_overload
+ */
+bool rohc_decomp_set_load(struct rohc_decomp *const decomp,
+                          const struct rohc_load *const load)
+{
+	bool is_overloaded;
+
+	if(decomp == NULL || load == NULL)
+	{
+		goto error;
+	}
+
+	is_overloaded =
+		((decomp->overload_limits.queue_depth != 0 &&
+		  load->queue_depth > decomp->overload_limits.queue_depth) ||
+		 (decomp->overload_limits.burst_time_us != 0 &&
+		  load->burst_time_us > decomp->overload_limits.burst_time_us));
+	if(is_overloaded && !decomp->is_overloaded)
+	{
+		rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		          "enter overload mode (%zu queued packets, %u us per burst)",
+		          load->queue_depth, load->burst_time_us);
+		rohc_seqlock_write_begin(&decomp->stats_seq);
+		decomp->stats.overloads++;
+		rohc_seqlock_write_end(&decomp->stats_seq);
+	}
+	else if(!is_overloaded && decomp->is_overloaded)
+	{
+		rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		          "leave overload mode (%zu queued packets, %u us per burst)",
+		          load->queue_depth, load->burst_time_us);
+	}
+	decomp->is_overloaded = is_overloaded;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the runtime configuration of the decompressor
+ *
+ * Copy the runtime tunables in use by the decompressor, eg. to modify some
+ * of them and publish the result with \ref rohc_decomp_publish_cfg. The
+ * function may be called by another thread than the thread of the
+ * decompressor. A configuration published but not taken by the
+ * decompressor yet is not returned.
+ *
+ * @param decomp    The ROHC decompressor
+ * @param[out] cfg  The runtime configuration of the decompressor
+ * @return          true if the configuration is copied,
+ *                  false if a parameter is invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_publish_cfg
+ */
+bool rohc_decomp_get_cfg(const struct rohc_decomp *const decomp,
+                         struct rohc_decomp_cfg *const cfg)
+{
+	uint32_t seq;
+
+	if(decomp == NULL || cfg == NULL)
+	{
+		goto error;
+	}
+
+	/* copied again if the decompressor took a new configuration meanwhile */
+	do
+	{
+		seq = rohc_seqlock_read_begin(&decomp->stats_seq);
+		cfg->features = d_features(decomp);
+		cfg->prtt = decomp->prtt;
+		cfg->reorder_window = decomp->reorder_window;
+		cfg->k = decomp->ack_rate_limits.speed.k;
+		cfg->n = decomp->ack_rate_limits.speed.n;
+		cfg->k_1 = decomp->ack_rate_limits.nack.k;
+		cfg->n_1 = decomp->ack_rate_limits.nack.n;
+		cfg->k_2 = decomp->ack_rate_limits.static_nack.k;
+		cfg->n_2 = decomp->ack_rate_limits.static_nack.n;
+		cfg->decomp_byte_rate = decomp->ack_rate_limits.decomp_byte_rate;
+		cfg->ctxt_byte_rate = decomp->ack_rate_limits.ctxt_byte_rate;
+		cfg->ctxt_idle_timeout = decomp->ctxt_idle_timeout;
+		cfg->mem_budget = decomp->mem_budget;
+		cfg->overload_limits = decomp->overload_limits;
+	}
+	while(rohc_seqlock_read_retry(&decomp->stats_seq, seq));
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Publish a new runtime configuration for the decompressor
+ *
+ * Retune a running decompressor without locking it: the given configuration
+ * is checked, then copied in an immutable snapshot that replaces the
+ * pending one atomically. The decompressor takes the snapshot before it
+ * decompresses the next packet, so that every packet is decompressed with
+ * one consistent configuration. The cost for the thread of the
+ * decompressor is one load per packet when no configuration is pending.
+ *
+ * The function is meant to be called by another thread than the thread of
+ * the decompressor, eg. the thread of the control plane. No lock is
+ * required as long as only one thread publishes configurations for the
+ * decompressor. A snapshot published while another one is still pending
+ * supersedes it.
+ *
+ * The MRRU cannot be changed this way since it sizes the reassembly buffer,
+ * see \ref rohc_decomp_set_mrru.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param cfg     The new runtime configuration, see \ref rohc_decomp_get_cfg
+ * @return        true if the configuration is published,
+ *                false if a parameter is invalid or if the snapshot cannot
+ *                be allocated
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_cfg
+ */
+bool rohc_decomp_publish_cfg(struct rohc_decomp *const decomp,
+                             const struct rohc_decomp_cfg *const cfg)
+{
+	struct rohc_decomp_cfg *snapshot;
+	struct rohc_decomp_cfg *superseded;
+
+	if(decomp == NULL || cfg == NULL)
+	{
+		goto error;
+	}
+	if(!rohc_decomp_check_cfg(decomp, cfg))
+	{
+		goto error;
+	}
+
+	snapshot = rohc_mem_alloc(&decomp->mem_ops, sizeof(struct rohc_decomp_cfg));
+	if(snapshot == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to allocate the configuration snapshot");
+		goto error;
+	}
+	*snapshot = *cfg;
+
+	/* the snapshot is never modified once published: the decompressor owns
+	 * it once taken, the publisher owns the pending snapshot it replaced */
+	superseded = __atomic_exchange_n(&decomp->cfg_pending, snapshot,
+	                                 __ATOMIC_ACQ_REL);
+	rohc_mem_free(&decomp->mem_ops, superseded);
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Set the rate limits for feedbacks
  *
@@ -3194,6 +5708,101 @@ error:
 }
 
 
+/**
+ * @brief Set the byte rates of the feedback channel
+ *
+ * Limit the bytes of feedback that the decompressor sends per second,
+ * whatever the rate of the ROHC packets. Two token buckets are used: one for
+ * the whole decompressor, and one for every context. Both hold at most one
+ * second of feedback, so feedback may be sent in short bursts as long as the
+ * average rate is not exceeded. A feedback is sent only if both buckets hold
+ * enough bytes for it, otherwise it is dropped.
+ *
+ * The buckets are refilled with the arrival times of the ROHC packets: set
+ * the \e time field of the ROHC packets given to the decompression functions,
+ * otherwise the buckets are never refilled.
+ *
+ * The byte rates are applied in addition to the rate limits set with
+ * \ref rohc_decomp_set_rate_limits.
+ *
+ * The default values are 0, ie. no limit.
+ *
+ * @param decomp            The ROHC decompressor
+ * @param decomp_byte_rate  The max bytes of feedback per second for the whole
+ *                          decompressor, 0 for no limit
+ * @param ctxt_byte_rate    The max bytes of feedback per second for every
+ *                          context, 0 for no limit
+ * @return                  true if the new values were successfully set,
+ *                          false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_feedback_rates
+ * @see rohc_decomp_set_rate_limits
+ */
+bool rohc_decomp_set_feedback_rates(struct rohc_decomp *const decomp,
+                                    const size_t decomp_byte_rate,
+                                    const size_t ctxt_byte_rate)
+{
+	/* decompressor must be valid */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	/* set new byte rates, the bucket of the decompressor starts full */
+	decomp->ack_rate_limits.decomp_byte_rate = decomp_byte_rate;
+	decomp->ack_rate_limits.ctxt_byte_rate = ctxt_byte_rate;
+	decomp->feedback_bucket.tokens = ((uint64_t) decomp_byte_rate) * 1000000U;
+
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "feedback byte rates are now set to: %zu bytes/s (all), %zu "
+	           "bytes/s (every context)", decomp_byte_rate, ctxt_byte_rate);
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the byte rates of the feedback channel currently configured
+ *
+ * See \ref rohc_decomp_set_feedback_rates for details.
+ *
+ * @param decomp                 The ROHC decompressor
+ * @param[out] decomp_byte_rate  The max bytes of feedback per second for the
+ *                               whole decompressor, 0 for no limit
+ * @param[out] ctxt_byte_rate    The max bytes of feedback per second for
+ *                               every context, 0 for no limit
+ * @return                       true if the byte rates were successfully
+ *                               retrieved, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_feedback_rates
+ */
+bool rohc_decomp_get_feedback_rates(const struct rohc_decomp *const decomp,
+                                    size_t *const decomp_byte_rate,
+                                    size_t *const ctxt_byte_rate)
+{
+	if(decomp == NULL || decomp_byte_rate == NULL || ctxt_byte_rate == NULL)
+	{
+		goto error;
+	}
+
+	*decomp_byte_rate = decomp->ack_rate_limits.decomp_byte_rate;
+	*ctxt_byte_rate = decomp->ack_rate_limits.ctxt_byte_rate;
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Enable/disable features for ROHC decompressor
  *
@@ -3217,9 +5826,7 @@ error:
 bool rohc_decomp_set_features(struct rohc_decomp *const decomp,
                               const rohc_decomp_features_t features)
 {
-	const rohc_decomp_features_t all_features =
-		ROHC_DECOMP_FEATURE_CRC_REPAIR |
-		ROHC_DECOMP_FEATURE_DUMP_PACKETS;
+	const rohc_decomp_features_t all_features = ROHC_DECOMP_FEATURES_ALL;
 
 	/* decompressor must be valid */
 	if(decomp == NULL)
@@ -3236,6 +5843,16 @@ bool rohc_decomp_set_features(struct rohc_decomp *const decomp,
 		             "set is 0x%x)", features, all_features);
 		goto error;
 	}
+#ifdef ROHC_FIXED_DECOMP_FEATURES
+	if(features != ROHC_FIXED_DECOMP_FEATURES)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "feature set 0x%x is not supported (library built for "
+		             "feature set 0x%x only)", features,
+		             ROHC_FIXED_DECOMP_FEATURES);
+		goto error;
+	}
+#endif
 
 	/* record new feature set */
 	decomp->features = features;
@@ -3247,6 +5864,78 @@ error:
 }
 
 
+/**
+ * @brief Set the functions the ROHC decompressor allocates context memory with
+ *
+ * The profile-specific parts of the decompression contexts are allocated
+ * from a slab owned by the decompressor: the memory of recycled contexts is
+ * kept for the next contexts instead of being freed. The slab allocates
+ * memory by chunks of several contexts with the memory operations given to
+ * \ref rohc_decomp_new3, or with malloc() by default. This function sets
+ * other functions to allocate and free the chunks, eg. to use a cache of
+ * objects or to account for the memory of the contexts.
+ *
+ * Give NULL for both functions to come back to the memory operations given
+ * to \ref rohc_decomp_new3, or to malloc() and free() if none was given.
+ *
+ * @warning The functions may only be changed before the first packet is
+ *          decompressed
+ *
+ * @param decomp    The ROHC decompressor
+ * @param alloc_cb  The function to allocate memory with
+ * @param free_cb   The function to free memory with
+ * @param priv      Private data that will be given to the callbacks, may be
+ *                  NULL
+ * @return          true if the functions were successfully set,
+ *                  false if a problem occurred
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_alloc_cb_t
+ * @see rohc_decomp_free_cb_t
+ */
+bool rohc_decomp_set_alloc_cbs(struct rohc_decomp *const decomp,
+                               rohc_decomp_alloc_cb_t alloc_cb,
+                               rohc_decomp_free_cb_t free_cb,
+                               void *priv)
+{
+	/* decompressor must be valid */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	/* come back to the memory operations of the decompressor if no function
+	 * is given */
+	if(alloc_cb == NULL && free_cb == NULL)
+	{
+		alloc_cb = decomp->mem_ops.alloc;
+		free_cb = decomp->mem_ops.free;
+		priv = decomp->mem_ops.priv;
+	}
+
+	/* the functions cannot be changed once memory was allocated with them */
+	if(decomp->num_contexts_used > 0 || decomp->engine != NULL ||
+	   decomp->mem_ops.alloc == rohc_mem_block_alloc ||
+	   !rohc_slab_set_cbs(decomp->ctxt_slab, alloc_cb, free_cb, priv))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "failed to set the functions for memory allocation: "
+		             "both functions shall be given, contexts shall not be "
+		             "created yet, and the decompressor shall not be one "
+		             "channel of an engine nor be carved from a memory "
+		             "block");
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
 /**
  * @brief Is the given decompression profile enabled for a decompressor?
  *
@@ -3276,17 +5965,9 @@ bool rohc_decomp_profile_enabled(const struct rohc_decomp *const decomp,
 		goto error;
 	}
 
-	/* search the profile location */
-	for(i = 0; i < D_NUM_PROFILES; i++)
-	{
-		if(rohc_decomp_profiles[i]->id == profile)
-		{
-			/* found */
-			break;
-		}
-	}
-
-	if(i == D_NUM_PROFILES)
+	/* get the profile location */
+	i = rohc_decomp_get_profile_idx(profile);
+	if(i == ROHC_DECOMP_PROFILE_IDX_NONE)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		             "unknown ROHC decompression profile (ID = %d)", profile);
@@ -3313,10 +5994,14 @@ error:
  * If the profile is already enabled, nothing is performed and success is
  * reported.
  *
+ * A ROHCv1 profile and its ROHCv2 counterpart (eg. \ref ROHC_PROFILE_IP and
+ * \ref ROHCv2_PROFILE_IP) cannot be enabled at the same time.
+ *
  * @param decomp   The ROHC decompressor
  * @param profile  The profile to enable
  * @return         true if the profile exists,
- *                 false if the profile does not exist
+ *                 false if the profile does not exist or if its counterpart
+ *                 of the other ROHC version is already enabled
  *
  * @ingroup rohc_decomp
  *
@@ -3337,6 +6022,7 @@ error:
 bool rohc_decomp_enable_profile(struct rohc_decomp *const decomp,
                                 const rohc_profile_t profile)
 {
+	size_t other_i;
 	size_t i;
 
 	if(decomp == NULL)
@@ -3344,20 +6030,24 @@ bool rohc_decomp_enable_profile(struct rohc_decomp *const decomp,
 		goto error;
 	}
 
-	/* search the profile location */
-	for(i = 0; i < D_NUM_PROFILES; i++)
+	/* get the profile location */
+	i = rohc_decomp_get_profile_idx(profile);
+	if(i == ROHC_DECOMP_PROFILE_IDX_NONE)
 	{
-		if(rohc_decomp_profiles[i]->id == profile)
-		{
-			/* found */
-			break;
-		}
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unknown ROHC decompression profile (ID = %d)", profile);
+		goto error;
 	}
 
-	if(i == D_NUM_PROFILES)
+	/* the IR packets carry only the 8 LSB of the profile ID, so a ROHCv1
+	 * profile and its ROHCv2 counterpart cannot be enabled together */
+	other_i = rohc_decomp_get_profile_idx(rohc_profile_get_other_version(profile));
+	if(other_i != ROHC_DECOMP_PROFILE_IDX_NONE && decomp->enabled_profiles[other_i])
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-		             "unknown ROHC decompression profile (ID = %d)", profile);
+		             "cannot enable ROHC decompression profile (ID = 0x%04x) "
+		             "while profile 0x%04x is enabled", profile,
+		             rohc_profile_get_other_version(profile));
 		goto error;
 	}
 
@@ -3406,17 +6096,9 @@ bool rohc_decomp_disable_profile(struct rohc_decomp *const decomp,
 		goto error;
 	}
 
-	/* search the profile location */
-	for(i = 0; i < D_NUM_PROFILES; i++)
-	{
-		if(rohc_decomp_profiles[i]->id == profile)
-		{
-			/* found */
-			break;
-		}
-	}
-
-	if(i == D_NUM_PROFILES)
+	/* get the profile location */
+	i = rohc_decomp_get_profile_idx(profile);
+	if(i == ROHC_DECOMP_PROFILE_IDX_NONE)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		             "unknown ROHC decompression profile (ID = %d)", profile);
@@ -3536,88 +6218,1087 @@ bool rohc_decomp_disable_profiles(struct rohc_decomp *const decomp,
 	size_t err_nr = 0;
 	bool is_ok;
 
-	if(decomp == NULL)
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	va_start(profiles, decomp);
+
+	while((profile_id = va_arg(profiles, int)) >= 0)
+	{
+		is_ok = rohc_decomp_disable_profile(decomp, profile_id);
+		if(!is_ok)
+		{
+			err_nr++;
+		}
+	}
+
+	va_end(profiles);
+
+	return (err_nr == 0);
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the callback function used to manage traces in decompressor
+ *
+ * Set the user-defined callback function used to manage traces in the
+ * decompressor.
+ *
+ * The function will be called by the ROHC library every time it wants to
+ * print something related to decompression, from errors to debug. User may
+ * thus decide what traces are interesting (filter on \e level, source
+ * \e entity, or \e profile) and what to do with them (print on console,
+ * storage in file, syslog...).
+ *
+ * @warning The callback can not be modified after library initialization
+ *
+ * @param decomp     The ROHC decompressor
+ * @param callback   Two possible cases:
+ *                     \li The callback function used to manage traces
+ *                     \li NULL to remove the previous callback
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @return           true on success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ */
+bool rohc_decomp_set_traces_cb2(struct rohc_decomp *decomp,
+                                rohc_trace_callback2_t callback,
+                                void *const priv_ctxt)
+{
+	/* check decompressor validity */
+	if(decomp == NULL)
+	{
+		/* cannot print a trace without a valid decompressor */
+		goto error;
+	}
+
+	/* refuse to set a new trace callback if decompressor is in use */
+	if(decomp->stats.received > 0)
+	{
+		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "unable to "
+		           "modify the trace callback after initialization");
+		goto error;
+	}
+
+	/* replace current trace callback by the new one, the trace filter
+	 * restores it only for the contexts it selects */
+	decomp->trace_filter.callback = callback;
+	decomp->trace_callback = (decomp->trace_filter.is_active ? NULL : callback);
+	decomp->trace_callback_priv = priv_ctxt;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the ring of binary trace records of the decompressor
+ *
+ * Once set, the decompressor records one fixed-size binary record in the
+ * ring for every decompressed packet, every decompression failure, and every
+ * event in the life of the decompression contexts: creation, destruction,
+ * change of state or mode, and CRC failure. Unlike the trace callback, no
+ * text is formatted, so the binary traces may stay enabled at line rate.
+ * The recorded events may be filtered with \ref rohc_decomp_set_trace_events.
+ *
+ * The ring may be changed or disabled at any time between two packets.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param ring    Two possible cases:
+ *                  \li The ring initialized with \ref rohc_trace_ring_init
+ *                  \li NULL to stop recording binary traces
+ * @return        true on success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_trace_ring_init
+ * @see rohc_trace_ring_read
+ */
+bool rohc_decomp_set_trace_ring(struct rohc_decomp *const decomp,
+                                struct rohc_trace_ring *const ring)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	decomp->trace_ring = ring;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Set the events recorded in the ring of binary trace records
+ *
+ * All the events are recorded by default. Monitoring the life of the
+ * contexts with \ref ROHC_TRACE_EVENTS_CTXT records nothing while the
+ * contexts do not change, so the ring may be polled instead of the
+ * information on every decompressed packet.
+ *
+ * The events may be changed at any time between two packets.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param events  The mask of the events to record, made of
+ *                \ref ROHC_TRACE_EVENT_BIT of every event, eg.
+ *                \ref ROHC_TRACE_EVENTS_ALL or \ref ROHC_TRACE_EVENTS_CTXT
+ * @return        true on success, false otherwise
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_trace_ring
+ */
+bool rohc_decomp_set_trace_events(struct rohc_decomp *const decomp,
+                                  const uint32_t events)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if((events & ~ROHC_TRACE_EVENTS_ALL) != 0)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unknown events in mask 0x%08x", events);
+		goto error;
+	}
+
+	decomp->trace_events = events;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Trace only the decompression context with the given CID
+ *
+ * Once one criterion is given to the trace filter of the decompressor, the
+ * text traces are given to the trace callback only while one context that
+ * matches the filter decompresses one packet. The other traces are dropped
+ * before they are formatted, so that debugging one flow among many costs
+ * almost nothing to the other flows. The traces that are not related to one
+ * context are dropped too, as the traces of one packet until its context is
+ * found.
+ *
+ * One context matches the filter if it matches every criterion given to the
+ * filter. One context matches one criterion if it matches one of the values
+ * given for the criterion: several CIDs may be traced for example. Every
+ * criterion holds at most \ref ROHC_TRACE_FILTER_MAX values.
+ *
+ * The filter may be changed at any time between two packets. It does not
+ * apply to the binary trace records, see \ref rohc_decomp_set_trace_events.
+ *
+ * @param decomp  The ROHC decompressor
+ * @param cid     The CID of the context to trace
+ * @return        true if the CID was added to the filter,
+ *                false if the decompressor is invalid, the CID is out of
+ *                range or the filter already holds \ref ROHC_TRACE_FILTER_MAX
+ *                CIDs
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_trace_filter_add_profile
+ * @see rohc_decomp_trace_filter_add_packet_type
+ * @see rohc_decomp_trace_filter_clear
+ */
+bool rohc_decomp_trace_filter_add_cid(struct rohc_decomp *const decomp,
+                                      const rohc_cid_t cid)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(cid > decomp->medium.max_cid)
+	{
+		__rohc_print(decomp->trace_filter.callback, decomp->trace_callback_priv,
+		             ROHC_TRACE_WARNING, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unable to trace CID %zu: CID is greater than MAX_CID %zu",
+		             cid, decomp->medium.max_cid);
+		goto error;
+	}
+	if(!rohc_trace_filter_add(&decomp->trace_filter, decomp->trace_filter.cids,
+	                          &decomp->trace_filter.cids_nr, cid))
+	{
+		__rohc_print(decomp->trace_filter.callback, decomp->trace_callback_priv,
+		             ROHC_TRACE_WARNING, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unable to trace CID %zu: too many CIDs to trace", cid);
+		goto error;
+	}
+	decomp->trace_callback = NULL;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Trace only the decompression contexts of the given profile
+ *
+ * See \ref rohc_decomp_trace_filter_add_cid for the trace filter.
+ *
+ * @param decomp   The ROHC decompressor
+ * @param profile  The profile of the contexts to trace
+ * @return         true if the profile was added to the filter,
+ *                 false if the decompressor is invalid, the profile is
+ *                 unknown or the filter already holds
+ *                 \ref ROHC_TRACE_FILTER_MAX profiles
+ *
+ * @ingroup rohc_decomp
+ */
+bool rohc_decomp_trace_filter_add_profile(struct rohc_decomp *const decomp,
+                                          const rohc_profile_t profile)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(rohc_decomp_get_profile_idx(profile) == ROHC_DECOMP_PROFILE_IDX_NONE)
+	{
+		__rohc_print(decomp->trace_filter.callback, decomp->trace_callback_priv,
+		             ROHC_TRACE_WARNING, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unable to trace unknown profile 0x%04x", profile);
+		goto error;
+	}
+	if(!rohc_trace_filter_add(&decomp->trace_filter, decomp->trace_filter.profiles,
+	                          &decomp->trace_filter.profiles_nr, profile))
+	{
+		__rohc_print(decomp->trace_filter.callback, decomp->trace_callback_priv,
+		             ROHC_TRACE_WARNING, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unable to trace profile 0x%04x: too many profiles to "
+		             "trace", profile);
+		goto error;
+	}
+	decomp->trace_callback = NULL;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Trace only the ROHC packets of the given type
+ *
+ * The traces of one packet are given to the trace callback once the type of
+ * the packet is detected. The contexts are created by IR packets.
+ *
+ * See \ref rohc_decomp_trace_filter_add_cid for the trace filter.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param packet_type  The packet type to trace
+ * @return             true if the packet type was added to the filter,
+ *                     false if the decompressor or the packet type is invalid
+ *
+ * @ingroup rohc_decomp
+ */
+bool rohc_decomp_trace_filter_add_packet_type(struct rohc_decomp *const decomp,
+                                              const rohc_packet_t packet_type)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+	if(packet_type >= ROHC_PACKET_MAX || packet_type == ROHC_PACKET_UNKNOWN)
+	{
+		__rohc_print(decomp->trace_filter.callback, decomp->trace_callback_priv,
+		             ROHC_TRACE_WARNING, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unable to trace invalid packet type %d", packet_type);
+		goto error;
+	}
+
+	decomp->trace_filter.packet_types |= ((uint64_t) 1) << packet_type;
+	decomp->trace_filter.is_active = true;
+	decomp->trace_callback = NULL;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Remove all the criteria of the trace filter of the decompressor
+ *
+ * All the text traces are given to the trace callback again.
+ *
+ * @param decomp  The ROHC decompressor
+ * @return        true if the filter was cleared, false if the decompressor
+ *                is invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_trace_filter_add_cid
+ */
+bool rohc_decomp_trace_filter_clear(struct rohc_decomp *const decomp)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	rohc_trace_filter_init(&decomp->trace_filter, decomp->trace_filter.callback);
+	decomp->trace_callback = decomp->trace_filter.callback;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the last packets received for one decompression context
+ *
+ * With the \ref ROHC_DECOMP_FEATURE_FLIGHT_RECORDER feature, the decompressor
+ * keeps the last \ref ROHC_DECOMP_FLIGHT_PKTS_NR packets of every context:
+ * the first bytes of every packet are copied once it is handled, along with
+ * its SN, its type and the status of its decompression. Retrieve them after a
+ * CRC failure or a context damage to find out which packets led to it,
+ * without capturing all the traffic. See \ref rohc_decomp_set_flight_cb to
+ * receive them as soon as the context fails.
+ *
+ * Every context takes sizeof(struct rohc_decomp_flight_pkt) *
+ * \ref ROHC_DECOMP_FLIGHT_PKTS_NR more bytes of memory once the feature is
+ * enabled.
+ *
+ * @param decomp    The ROHC decompressor
+ * @param cid       The CID of the context
+ * @param[out] pkts The recorded packets, the oldest first
+ * @param pkts_nr   The maximal number of packets to copy in \e pkts
+ * @return          The number of packets copied in \e pkts, the most recent
+ *                  ones if more are recorded, 0 if the decompressor or the
+ *                  CID is invalid, or if no packet was recorded for the CID
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_set_flight_cb
+ */
+size_t rohc_decomp_get_flight(const struct rohc_decomp *const decomp,
+                              const rohc_cid_t cid,
+                              struct rohc_decomp_flight_pkt pkts[],
+                              const size_t pkts_nr)
+{
+	const struct rohc_decomp_ctxt *context;
+
+	if(decomp == NULL || pkts == NULL || cid > decomp->medium.max_cid)
+	{
+		goto error;
+	}
+
+	context = find_context(decomp, cid);
+	if(context == NULL || context->flight == NULL)
+	{
+		goto error;
+	}
+
+	return d_flight_get(context->flight, pkts, pkts_nr);
+
+error:
+	return 0;
+}
+
+
+/**
+ * @brief Set the callback that receives the recorded packets of the
+ *        damaged contexts
+ *
+ * With the \ref ROHC_DECOMP_FEATURE_FLIGHT_RECORDER feature, the callback is
+ * called every time one packet fails the CRC check of its context or damages
+ * its context, with the last packets of the context. The callback is called
+ * from the decompression functions: it shall not call them, and it shall
+ * copy the packets it wants to keep.
+ *
+ * @param decomp    The ROHC decompressor
+ * @param callback  The callback, NULL to remove the current one
+ * @param priv      The private data given to the callback, may be NULL
+ * @return          true if the callback was set, false if the decompressor
+ *                  is invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_flight
+ */
+bool rohc_decomp_set_flight_cb(struct rohc_decomp *const decomp,
+                               rohc_decomp_flight_cb_t callback,
+                               void *const priv)
+{
+	if(decomp == NULL)
+	{
+		goto error;
+	}
+
+	decomp->flight_cb = callback;
+	decomp->flight_cb_priv = priv;
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/*
+ * Private functions
+ */
+
+
+/**
+ * @brief Check the packet buffers given to one of the decompression functions
+ *
+ * @param decomp         The ROHC decompressor
+ * @param rohc_packet    The ROHC packet to decode
+ * @param uncomp_packet  The buffer for the uncompressed packet
+ * @return               true if the buffers are valid, false otherwise
+ */
+static bool rohc_decomp_check_bufs(const struct rohc_decomp *const decomp,
+                                   const struct rohc_buf rohc_packet,
+                                   const struct rohc_buf *const uncomp_packet)
+{
+	if(rohc_buf_is_malformed(rohc_packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is malformed");
+		goto error;
+	}
+	if(rohc_buf_is_empty(rohc_packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given rohc_packet is empty");
+		goto error;
+	}
+	if(uncomp_packet == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is NULL");
+		goto error;
+	}
+	if(rohc_buf_is_malformed(*uncomp_packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is malformed");
+		goto error;
+	}
+	if(!rohc_buf_is_empty(*uncomp_packet))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "given uncomp_packet is not empty");
+		goto error;
+	}
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Check the feedback buffers given to one of the decompression functions
+ *
+ * @param decomp         The ROHC decompressor
+ * @param rcvd_feedback  The buffer for the received feedback, may be NULL
+ * @param feedback_send  The buffer for the feedback to send, may be NULL
+ * @return               true if the buffers are valid, false otherwise
+ */
+static bool rohc_decomp_check_feedback_bufs(const struct rohc_decomp *const decomp,
+                                            const struct rohc_buf *const rcvd_feedback,
+                                            const struct rohc_buf *const feedback_send)
+{
+	if(rcvd_feedback != NULL)
+	{
+		if(rohc_buf_is_malformed(*rcvd_feedback))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given rcvd_feedback is malformed");
+			goto error;
+		}
+		if(!rohc_buf_is_empty(*rcvd_feedback))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given rcvd_feedback is not empty");
+			goto error;
+		}
+	}
+	if(feedback_send != NULL)
+	{
+		if(rohc_buf_is_malformed(*feedback_send))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given feedback_send is malformed");
+			goto error;
+		}
+		if(!rohc_buf_is_empty(*feedback_send))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "given feedback_send is not empty");
+			goto error;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the CID of the given ROHC packet without decompressing it
+ *
+ * Only the CID of ROHC packets that do not start with padding nor feedback
+ * is decoded. The ROHC segments have no CID.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param rohc_packet  The ROHC packet
+ * @param[out] cid     The CID of the packet
+ * @return             true if the CID of the packet was decoded,
+ *                     false otherwise
+ */
+static bool rohc_decomp_get_pkt_cid(const struct rohc_decomp *const decomp,
+                                    const struct rohc_buf rohc_packet,
+                                    rohc_cid_t *const cid)
+{
+	const uint8_t *data;
+
+	if(rohc_buf_is_malformed(rohc_packet) || rohc_packet.len < 2)
+	{
+		goto error;
+	}
+	data = rohc_buf_data(rohc_packet);
+	if(rohc_decomp_packet_is_padding(data) || rohc_packet_is_feedback(data[0]) ||
+	   rohc_decomp_packet_is_segment(data))
+	{
+		goto error;
+	}
+
+	if(d_cid_type(decomp) == ROHC_SMALL_CID)
+	{
+		*cid = rohc_add_cid_decode(data, rohc_packet.len);
+		if((*cid) == UINT8_MAX)
+		{
+			*cid = 0;
+		}
+	}
+	else
+	{
+		uint32_t large_cid;
+		size_t large_cid_bits_nr;
+
+		if(sdvl_decode(data + 1, rohc_packet.len - 1, &large_cid,
+		               &large_cid_bits_nr) == 0)
+		{
+			goto error;
+		}
+		*cid = large_cid & 0xffff;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the location of the context of the given ROHC packet
+ *
+ * The context is not read, so that its location may be prefetched.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param rohc_packet  The ROHC packet
+ * @return             The location of the context of the packet,
+ *                     NULL if it is unknown or not allocated
+ */
+static const struct rohc_decomp_ctxt *
+	rohc_decomp_get_pkt_ctxt(const struct rohc_decomp *const decomp,
+	                         const struct rohc_buf rohc_packet)
+{
+	rohc_cid_t cid;
+
+	if(!rohc_decomp_get_pkt_cid(decomp, rohc_packet, &cid))
+	{
+		return NULL;
+	}
+
+	if(cid <= decomp->medium.max_cid)
+	{
+		const struct rohc_decomp_ctxt *const page =
+			decomp->ctxt_pages[cid / ROHC_DECOMP_CTXT_PAGE_LEN];
+
+		if(page != NULL)
+		{
+			return &(page[cid % ROHC_DECOMP_CTXT_PAGE_LEN]);
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+ * @brief Compute the order in which one group of packets of a burst is
+ *        decompressed
+ *
+ * With \ref ROHC_DECOMP_FEATURE_BURST_GROUPING, the packets of one context
+ * are decompressed one after the other, see \ref rohc_burst_group. The
+ * packets whose CID is not known before decompression keep their position.
+ * Otherwise the packets are decompressed in order.
+ *
+ * @param decomp        The ROHC decompressor
+ * @param rohc_packets  The ROHC packets of the group
+ * @param pkts_nr       The number of packets in the group,
+ *                      at most \ref ROHC_DECOMP_BURST_GROUP
+ * @param[out] order    The indexes of the packets in the order to
+ *                      decompress them
+ */
+static void rohc_decomp_group_pkts(const struct rohc_decomp *const decomp,
+                                   const struct rohc_buf rohc_packets[],
+                                   const size_t pkts_nr,
+                                   size_t order[ROHC_DECOMP_BURST_GROUP])
+{
+	size_t i;
+
+	assert(pkts_nr <= ROHC_DECOMP_BURST_GROUP);
+
+	if((d_features(decomp) & ROHC_DECOMP_FEATURE_BURST_GROUPING) != 0)
+	{
+		uint32_t cids[ROHC_DECOMP_BURST_GROUP];
+		bool has_cid[ROHC_DECOMP_BURST_GROUP];
+
+		for(i = 0; i < pkts_nr; i++)
+		{
+			rohc_cid_t cid = 0;
+
+			has_cid[i] = rohc_decomp_get_pkt_cid(decomp, rohc_packets[i], &cid);
+			cids[i] = cid;
+		}
+		rohc_burst_group(cids, has_cid, pkts_nr, order);
+	}
+	else
+	{
+		for(i = 0; i < pkts_nr; i++)
+		{
+			order[i] = i;
+		}
+	}
+}
+
+
+/**
+ * @brief Prefetch the context of the given ROHC packet
+ *
+ * @param decomp       The ROHC decompressor
+ * @param rohc_packet  The ROHC packet
+ */
+static void rohc_decomp_prefetch_ctxt(const struct rohc_decomp *const decomp,
+                                      const struct rohc_buf rohc_packet)
+{
+	const struct rohc_decomp_ctxt *const ctxt =
+		rohc_decomp_get_pkt_ctxt(decomp, rohc_packet);
+
+	if(ctxt != NULL)
+	{
+		__builtin_prefetch(ctxt);
+	}
+}
+
+
+/**
+ * @brief Prefetch the persistent data of the context of the given ROHC packet
+ *
+ * The context itself was prefetched one packet earlier, see
+ * \ref rohc_decomp_prefetch_ctxt, so it is expected to be in cache now: the
+ * persistent data it points to, eg. the LSB decoding contexts, are prefetched
+ * in turn.
+ *
+ * @param decomp       The ROHC decompressor
+ * @param rohc_packet  The ROHC packet
+ */
+static void rohc_decomp_prefetch_ctxt_data(const struct rohc_decomp *const decomp,
+                                           const struct rohc_buf rohc_packet)
+{
+	const struct rohc_decomp_ctxt *const ctxt =
+		rohc_decomp_get_pkt_ctxt(decomp, rohc_packet);
+
+	if(ctxt == NULL || !ctxt->used || ctxt->persist_ctxt == NULL)
+	{
+		return;
+	}
+
+	__builtin_prefetch(ctxt->persist_ctxt);
+	if(ctxt->profile->prefetch != NULL)
+	{
+		ctxt->profile->prefetch(ctxt);
+	}
+}
+
+
+/**
+ * @brief Check a runtime configuration before it is published
+ *
+ * @param decomp  The ROHC decompressor
+ * @param cfg     The runtime configuration to check
+ * @return        true if the configuration is valid, false otherwise
+ *
+ * @see rohc_decomp_publish_cfg
+ */
+static bool rohc_decomp_check_cfg(const struct rohc_decomp *const decomp,
+                                  const struct rohc_decomp_cfg *const cfg)
+{
+	/* same rules as rohc_decomp_set_features(), rohc_decomp_set_prtt(),
+	 * rohc_decomp_set_reorder_window() and rohc_decomp_set_rate_limits() */
+	if((cfg->features & ROHC_DECOMP_FEATURES_ALL) != cfg->features
+#ifdef ROHC_FIXED_DECOMP_FEATURES
+	   || cfg->features != ROHC_FIXED_DECOMP_FEATURES
+#endif
+	  )
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "feature set 0x%x is not supported", cfg->features);
+		goto error;
+	}
+	if(cfg->prtt >= (SIZE_MAX / 2))
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unexpected pRTT value %zu", cfg->prtt);
+		goto error;
+	}
+	if(cfg->reorder_window > ROHC_DECOMP_REORDER_WINDOW_MAX)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "unexpected reorder window: must be in range [0, %u]",
+		             ROHC_DECOMP_REORDER_WINDOW_MAX);
+		goto error;
+	}
+	if(cfg->n == 0 || cfg->n_1 == 0 || cfg->n_2 == 0)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "rate-limits n/n_1/n_2 shall not be 0");
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Take the runtime configuration published by another thread
+ *
+ * The pending snapshot, if any, is taken atomically, applied and released.
+ * The function is called between rohc_seqlock_write_begin() and
+ * rohc_seqlock_write_end() on \e stats_seq, so that
+ * \ref rohc_decomp_get_cfg never returns a mix of two configurations.
+ *
+ * @param decomp  The ROHC decompressor
+ *
+ * @see rohc_decomp_publish_cfg
+ */
+static void rohc_decomp_take_cfg(struct rohc_decomp *const decomp)
+{
+	struct rohc_ack_rate_limits *const limits = &decomp->ack_rate_limits;
+	struct rohc_decomp_cfg *cfg;
+
+	/* the configuration rarely changes, avoid the atomic exchange */
+	if(__builtin_expect(__atomic_load_n(&decomp->cfg_pending, __ATOMIC_RELAXED) == NULL, 1))
+	{
+		return;
+	}
+	cfg = __atomic_exchange_n(&decomp->cfg_pending, NULL, __ATOMIC_ACQUIRE);
+	assert(cfg != NULL);
+
+	decomp->features = cfg->features;
+	decomp->prtt = cfg->prtt;
+	decomp->sn_feedback_min_bits = sizeof(uint32_t) * 8;
+	if(decomp->prtt != 0)
+	{
+		decomp->sn_feedback_min_bits -= __builtin_clz(decomp->prtt);
+	}
+	decomp->reorder_window = cfg->reorder_window;
+	limits->speed.k = cfg->k;
+	limits->speed.n = cfg->n;
+	limits->speed.threshold = limits->speed.k * 32 * 100 / limits->speed.n;
+	limits->nack.k = cfg->k_1;
+	limits->nack.n = cfg->n_1;
+	limits->nack.threshold = limits->nack.k * 32 * 100 / limits->nack.n;
+	limits->static_nack.k = cfg->k_2;
+	limits->static_nack.n = cfg->n_2;
+	limits->static_nack.threshold =
+		limits->static_nack.k * 32 * 100 / limits->static_nack.n;
+	if(cfg->decomp_byte_rate != limits->decomp_byte_rate)
+	{
+		/* the bucket of the decompressor starts full */
+		decomp->feedback_bucket.tokens = ((uint64_t) cfg->decomp_byte_rate) * 1000000U;
+	}
+	limits->decomp_byte_rate = cfg->decomp_byte_rate;
+	limits->ctxt_byte_rate = cfg->ctxt_byte_rate;
+	decomp->ctxt_idle_timeout = cfg->ctxt_idle_timeout;
+	decomp->mem_budget = cfg->mem_budget;
+	if(cfg->overload_limits.queue_depth != decomp->overload_limits.queue_depth ||
+	   cfg->overload_limits.burst_time_us != decomp->overload_limits.burst_time_us)
+	{
+		decomp->overload_limits = cfg->overload_limits;
+		decomp->is_overloaded = false;
+	}
+
+	rohc_mem_free(&decomp->mem_ops, cfg);
+
+	rohc_info(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "new runtime "
+	          "configuration taken");
+}
+
+
+/**
+ * @brief Decompress one ROHC packet with checked buffers
+ *
+ * @param decomp              The ROHC decompressor
+ * @param rohc_packet         The compressed packet to decompress
+ * @param[out] uncomp_packet  The resulting uncompressed packet, or only its
+ *                            headers if \e payload is not NULL
+ * @param[out] payload        The payload of the packet, left in place, or
+ *                            NULL to copy it in \e uncomp_packet
+ * @param[out] rcvd_feedback  The feedback received by the decompressor,
+ *                            may be NULL
+ * @param[out] feedback_send  The feedback to send to the remote compressor,
+ *                            may be NULL
+ * @return                    See \ref rohc_decompress3
+ */
+static rohc_status_t rohc_decomp_decompress_pkt(struct rohc_decomp *const decomp,
+                                                const struct rohc_buf rohc_packet,
+                                                struct rohc_buf *const uncomp_packet,
+                                                struct rohc_buf *const payload,
+                                                struct rohc_buf *const rcvd_feedback,
+                                                struct rohc_buf *const feedback_send)
+{
+	rohc_status_t status = ROHC_STATUS_ERROR; /* error status by default */
+	struct rohc_decomp_stream stream;
+	size_t uncomp_len;
+
+	/* the traces are dropped until the context of the packet is known */
+	rohc_trace_filter_mute(decomp);
+
+	rohc_seqlock_write_begin(&decomp->stats_seq);
+	rohc_decomp_take_cfg(decomp);
+	decomp->stats.received++;
+	if(decomp->is_overloaded)
+	{
+		decomp->stats.overload_pkts++;
+	}
+	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+	           "decompress the %zu-byte packet #%lu", rohc_packet.len,
+	           decomp->stats.received);
+
+	/* print compressed bytes */
+	if((d_features(decomp) & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 	{
-		goto error;
+		rohc_dump_packet(decomp->trace_callback, decomp->trace_callback_priv,
+		                 ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG,
+		                 "compressed data, max 100 bytes", rohc_packet);
 	}
 
-	va_start(profiles, decomp);
+	/* decode ROHC header */
+	rohc_perf_begin(decomp, ROHC_DECOMP_PERF_DECODE_HEADER);
+	status = d_decode_header(decomp, rohc_packet, uncomp_packet, payload,
+	                         rcvd_feedback, &stream);
+	rohc_perf_end(decomp, ROHC_DECOMP_PERF_DECODE_HEADER);
+	assert(status != ROHC_STATUS_SEGMENT);
 
-	while((profile_id = va_arg(profiles, int)) >= 0)
+	/* handle mode transitions if context was found and it is still valid */
+	if(stream.context != NULL)
 	{
-		is_ok = rohc_decomp_disable_profile(decomp, profile_id);
-		if(!is_ok)
+		if(stream.context->mode == ROHC_U_MODE)
 		{
-			err_nr++;
+			if(decomp->target_mode == ROHC_U_MODE)
+			{
+				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+				           "stay in U-mode as requested by user");
+			}
+			else if(decomp->target_mode == ROHC_O_MODE ||
+			        !rohc_profile_is_rfc3095(stream.profile_id))
+			{
+				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+				           "transit from U-mode to O-mode as requested by user");
+				rohc_decomp_change_mode(stream.context, ROHC_O_MODE);
+				/* ACK(O), NACK(O) or STATIC-NACK(O) will transmit the mode
+				 * transition to the remote compressor */
+				stream.mode = ROHC_O_MODE;
+				stream.do_change_mode = true;
+			}
+			else /* R-mode */
+			{
+				/* RFC 3095, §5.6.4: the context transits through O-mode, it
+				 * enters R-mode once the compressor sends packets in R-mode */
+				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+				           "transit from U-mode to R-mode as requested by user");
+				rohc_decomp_change_mode(stream.context, ROHC_O_MODE);
+				/* ACK(R), NACK(R) or STATIC-NACK(R) will request the mode
+				 * transition to the remote compressor */
+				stream.mode = ROHC_R_MODE;
+				stream.do_change_mode = true;
+			}
+		}
+		else if(stream.context->mode == ROHC_O_MODE)
+		{
+			if(decomp->target_mode == ROHC_U_MODE)
+			{
+				assert(0); /* TODO: O- to U-mode transition not supported yet */
+				status = ROHC_STATUS_ERROR;
+				goto error;
+			}
+			else if(decomp->target_mode == ROHC_O_MODE ||
+			        !rohc_profile_is_rfc3095(stream.profile_id))
+			{
+				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+				           "stay in O-mode as requested by user");
+			}
+			else /* R-mode */
+			{
+				/* RFC 3095, §5.6.3: request the transition to R-mode until the
+				 * compressor sends packets in R-mode */
+				rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+				           "transit from O-mode to R-mode as requested by user");
+				stream.mode = ROHC_R_MODE;
+				stream.do_change_mode = true;
+			}
+		}
+		else /* R-mode */
+		{
+			/* the profile enters R-mode only if the user targets it */
+			assert(decomp->target_mode == ROHC_R_MODE);
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+			           "stay in R-mode as requested by user");
+			stream.mode = ROHC_R_MODE;
 		}
 	}
 
-	va_end(profiles);
-
-	return (err_nr == 0);
-
-error:
-	return false;
-}
+	/* update statistics and send feedback if needed */
+	if(status == ROHC_STATUS_OK)
+	{
+		/* print a trace to report success (the context may be NULL if packet
+		 * was a feedback-only packet) */
+		rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+		           "packet decompression succeeded");
 
+		/* do not update statistics and build positive feedback for feedback-only
+		 * packets */
+		uncomp_len = uncomp_packet->len;
+		if(payload != NULL)
+		{
+			uncomp_len += payload->len;
+		}
+		if(uncomp_len > 0)
+		{
+			/* update statistics */
+			rohc_debug(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+			           "update decompressor and context statistics");
+			assert(stream.context != NULL);
+			stream.context->num_recv_packets++;
+			stream.context->packet_type = stream.packet_type;
+			stream.context->total_uncompressed_size += uncomp_len;
+			stream.context->total_compressed_size += rohc_packet.len;
+			decomp->stats.total_uncompressed_size += uncomp_len;
+			decomp->stats.total_compressed_size += rohc_packet.len;
+			rohc_trace_event(decomp, ROHC_TRACE_DECOMP,
+			                 ROHC_TRACE_EVENT_DECOMP_PKT, stream.profile_id,
+			                 stream.cid, stream.packet_type, rohc_packet.len,
+			                 uncomp_len, 0);
 
-/**
- * @brief Set the callback function used to manage traces in decompressor
- *
- * Set the user-defined callback function used to manage traces in the
- * decompressor.
- *
- * The function will be called by the ROHC library every time it wants to
- * print something related to decompression, from errors to debug. User may
- * thus decide what traces are interesting (filter on \e level, source
- * \e entity, or \e profile) and what to do with them (print on console,
- * storage in file, syslog...).
- *
- * @warning The callback can not be modified after library initialization
- *
- * @param decomp     The ROHC decompressor
- * @param callback   Two possible cases:
- *                     \li The callback function used to manage traces
- *                     \li NULL to remove the previous callback
- * @param priv_ctxt  An optional private context, may be NULL
- * @return           true on success, false otherwise
- *
- * @ingroup rohc_decomp
- */
-bool rohc_decomp_set_traces_cb2(struct rohc_decomp *decomp,
-                                rohc_trace_callback2_t callback,
-                                void *const priv_ctxt)
-{
-	/* check decompressor validity */
-	if(decomp == NULL)
-	{
-		/* cannot print a trace without a valid decompressor */
-		goto error;
+			/* build positive feedback if asked by user and if needed by decompressor */
+			if(!rohc_decomp_feedback_ack(decomp, &stream, feedback_send))
+			{
+				rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+				             "failed to build positive feedback");
+				status = ROHC_STATUS_ERROR;
+				goto error;
+			}
+		}
 	}
-
-	/* refuse to set a new trace callback if decompressor is in use */
-	if(decomp->stats.received > 0)
+	else /* packet failed to be decompressed */
 	{
-		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, "unable to "
-		           "modify the trace callback after initialization");
-		goto error;
-	}
+		/* in case of failure, users shall get an empty decompressed packet */
+		uncomp_packet->len = 0;
 
-	/* replace current trace callback by the new one */
-	decomp->trace_callback = callback;
-	decomp->trace_callback_priv = priv_ctxt;
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+		             "packet decompression failed: %s (%d)",
+		             rohc_strerror(status), status);
+		rohc_trace_event(decomp, ROHC_TRACE_DECOMP,
+		                 ROHC_TRACE_EVENT_DECOMP_FAILURE, stream.profile_id,
+		                 stream.cid_found ? stream.cid : ROHC_TRACE_RECORD_NO_CID,
+		                 stream.packet_type, rohc_packet.len, status, 0);
 
-	return true;
+		/* update statistics */
+		if(stream.context != NULL)
+		{
+			stream.context->num_recv_packets++;
+		}
+		switch(status)
+		{
+			case ROHC_STATUS_MALFORMED:
+			case ROHC_STATUS_OUTPUT_TOO_SMALL:
+			case ROHC_STATUS_ERROR:
+				decomp->stats.failed_decomp++;
+				break;
+			case ROHC_STATUS_NO_CONTEXT:
+				decomp->stats.failed_no_context++;
+				break;
+			case ROHC_STATUS_BAD_CRC:
+				decomp->stats.failed_crc++;
+				if(stream.context != NULL)
+				{
+					rohc_trace_event(decomp, ROHC_TRACE_DECOMP,
+					                 ROHC_TRACE_EVENT_DECOMP_CRC, stream.profile_id,
+					                 stream.cid, stream.packet_type, rohc_packet.len,
+					                 stream.context->state, 0);
+				}
+				break;
+			case ROHC_STATUS_OK: /* success codes shall not happen */
+			case ROHC_STATUS_SEGMENT:
+			default:
+				assert(0);
+				status = ROHC_STATUS_ERROR;
+				goto error;
+		}
+
+		/* build negative feedback if asked by user and if needed by decompressor */
+		if(!rohc_decomp_feedback_nack(decomp, &stream, feedback_send))
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, stream.profile_id,
+			             "failed to build negative feedback");
+			status = ROHC_STATUS_ERROR;
+			goto error;
+		}
+	}
 
 error:
-	return false;
+	/* record the packet in the flight recorder of its context */
+	if(stream.context != NULL &&
+	   (d_features(decomp) & ROHC_DECOMP_FEATURE_FLIGHT_RECORDER) != 0)
+	{
+		d_flight_record(decomp, &stream, status);
+	}
+	rohc_decomp_stats_record_last(decomp);
+	rohc_seqlock_write_end(&decomp->stats_seq);
+	return status;
 }
 
 
-/*
- * Private functions
- */
-
 
 /**
  * @brief Find the ROHC profile with the given profile ID.
@@ -3635,13 +7316,8 @@ static const struct rohc_decomp_profile * find_profile(const struct rohc_decomp
 	assert(decomp != NULL);
 
 	/* search for the profile within the enabled profiles */
-	for(i = 0;
-	    i < D_NUM_PROFILES && rohc_decomp_profiles[i]->id != profile_id;
-	    i++)
-	{
-	}
-
-	if(i >= D_NUM_PROFILES)
+	i = rohc_decomp_get_profile_idx(profile_id);
+	if(i == ROHC_DECOMP_PROFILE_IDX_NONE)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		             "decompression profile with ID 0x%04x not found",
@@ -3661,6 +7337,41 @@ static const struct rohc_decomp_profile * find_profile(const struct rohc_decomp
 }
 
 
+/**
+ * @brief Get the index of a ROHC profile given a profile ID
+ *
+ * @param profile_id  The ID of the ROHC profile
+ * @return            The index of the ROHC profile in
+ *                    \ref rohc_decomp_profiles,
+ *                    \ref ROHC_DECOMP_PROFILE_IDX_NONE if not supported
+ */
+static size_t rohc_decomp_get_profile_idx(const rohc_profile_t profile_id)
+{
+	size_t i;
+
+	if(rohc_profile_is_rohcv2(profile_id))
+	{
+		if(((size_t) profile_id) >= ROHCv2_PROFILE_MAX)
+		{
+			return ROHC_DECOMP_PROFILE_IDX_NONE;
+		}
+		i = rohc_decomp_profiles_v2_idx[profile_id & 0xff];
+	}
+	else if(((size_t) profile_id) >= ROHC_PROFILE_MAX)
+	{
+		return ROHC_DECOMP_PROFILE_IDX_NONE;
+	}
+	else
+	{
+		i = rohc_decomp_profiles_idx[profile_id];
+	}
+	assert(i == ROHC_DECOMP_PROFILE_IDX_NONE ||
+	       rohc_decomp_profiles[i]->id == profile_id);
+
+	return i;
+}
+
+
 /**
  * @brief Decode the CID of a packet
  *
@@ -3688,7 +7399,7 @@ static bool rohc_decomp_decode_cid(struct rohc_decomp *decomp,
 		goto error;
 	}
 
-	if(decomp->medium.cid_type == ROHC_SMALL_CID)
+	if(d_cid_type(decomp) == ROHC_SMALL_CID)
 	{
 		/* small CID */
 		*large_cid_len = 0;
@@ -3710,7 +7421,7 @@ static bool rohc_decomp_decode_cid(struct rohc_decomp *decomp,
 			*add_cid_len = 1;
 		}
 	}
-	else if(decomp->medium.cid_type == ROHC_LARGE_CID)
+	else if(d_cid_type(decomp) == ROHC_LARGE_CID)
 	{
 		uint32_t large_cid;
 		size_t large_cid_bits_nr;
@@ -3739,7 +7450,7 @@ static bool rohc_decomp_decode_cid(struct rohc_decomp *decomp,
 	{
 		rohc_error(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		           "unexpected CID type (%d), should not happen",
-		           decomp->medium.cid_type);
+		           d_cid_type(decomp));
 		assert(0);
 		goto error;
 	}
@@ -3760,15 +7471,11 @@ error:
 static void rohc_decomp_parse_padding(const struct rohc_decomp *const decomp,
                                       struct rohc_buf *const packet)
 {
-	size_t padding_length = 0;
+	const size_t padding_length =
+		rohc_decomp_padding_len(rohc_buf_data(*packet), packet->len);
 
 	/* remove all padded bytes */
-	while(packet->len > 0 &&
-	      rohc_decomp_packet_is_padding(rohc_buf_data(*packet)))
-	{
-		rohc_buf_pull(packet, 1);
-		padding_length++;
-	}
+	rohc_buf_pull(packet, padding_length);
 	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 	           "skip %zu byte(s) of padding", padding_length);
 }
@@ -3835,7 +7542,9 @@ static rohc_status_t rohc_decomp_find_context(struct rohc_decomp *const decomp,
 	is_packet_ir_dyn = rohc_decomp_packet_is_irdyn(remain_data, remain_len);
 	if(is_packet_ir || is_packet_ir_dyn)
 	{
+		rohc_profile_t v2_profile_id;
 		uint8_t pkt_profile_id;
+		size_t v2_i;
 
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		           "ROHC packet is an IR or IR-DYN packet");
@@ -3857,7 +7566,19 @@ static rohc_status_t rohc_decomp_find_context(struct rohc_decomp *const decomp,
 			goto error_malformed;
 		}
 		pkt_profile_id = remain_data[0];
-		*profile_id = pkt_profile_id; /* TODO: ROHCv2 profiles not handled yet */
+
+		/* the IR packets carry only the 8 LSB of the profile ID: the ROHCv2
+		 * profile is used if it is enabled, its ROHCv1 counterpart cannot be */
+		v2_profile_id = (rohc_profile_t) (0x0100 | pkt_profile_id);
+		v2_i = rohc_decomp_get_profile_idx(v2_profile_id);
+		if(v2_i != ROHC_DECOMP_PROFILE_IDX_NONE && decomp->enabled_profiles[v2_i])
+		{
+			*profile_id = v2_profile_id;
+		}
+		else
+		{
+			*profile_id = pkt_profile_id;
+		}
 		remain_data++;
 		remain_len--;
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
@@ -3931,6 +7652,10 @@ static rohc_status_t rohc_decomp_find_context(struct rohc_decomp *const decomp,
 			goto error_no_context;
 		}
 
+		/* the new context is created by one IR packet, its profile-specific
+		 * parts keep the traces selected by the filter at creation */
+		rohc_trace_filter_select(decomp, cid, profile->id, ROHC_PACKET_IR,
+		                         false, 0);
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		           "create new context with CID %u and profile '%s' (0x%04x)",
 		           cid, rohc_get_profile_descr(*profile_id), *profile_id);
@@ -3943,6 +7668,9 @@ static rohc_status_t rohc_decomp_find_context(struct rohc_decomp *const decomp,
 			goto error_no_context;
 		}
 		*context_created = true;
+		rohc_trace_event(decomp, ROHC_TRACE_DECOMP,
+		                 ROHC_TRACE_EVENT_DECOMP_CTXT_NEW, *profile_id, cid,
+		                 ROHC_PACKET_UNKNOWN, decomp->num_contexts_used, 0, 0);
 	}
 	assert((*context)->profile != NULL);
 
@@ -3958,10 +7686,15 @@ error_no_context:
 /**
  * @brief Parse zero or more feedback items from the given ROHC data
  *
+ * The feedback items are contiguous at the beginning of the ROHC data: they
+ * are all retrieved at once once their lengths are checked.
+ *
  * @param decomp              The ROHC decompressor
  * @param rohc_data           The ROHC data to parse for feedback items
  * @param[out] feedbacks      The parsed feedback items, may be NULL if one
- *                            don't want to retrieve the feedback items
+ *                            don't want to retrieve the feedback items;
+ *                            the items are appended to the ones already
+ *                            retrieved from the previous packets of a burst
  * @return                    true if parsing of feedback items is successful,
  *                            false if at least one feedback is malformed
  */
@@ -3970,46 +7703,58 @@ static bool rohc_decomp_parse_feedbacks(struct rohc_decomp *const decomp,
                                         struct rohc_buf *const feedbacks)
 {
 	size_t feedbacks_nr = 0;
-	size_t feedbacks_full_len = 0; /* full feedbacks length */
-	size_t feedbacks_len = 0;      /* maybe truncated feedbacks length */
+	size_t feedbacks_len = 0;
 
-	/* no feedback parsed for the moment */
-	assert(feedbacks == NULL || rohc_buf_is_empty(*feedbacks));
-
-	/* parse as much feedback data as possible */
-	while(rohc_data->len > 0 &&
-	      rohc_packet_is_feedback(rohc_buf_byte(*rohc_data)))
+	/* find the end of the feedback items */
+	while(feedbacks_len < rohc_data->len &&
+	      rohc_packet_is_feedback(rohc_buf_byte_at(*rohc_data, feedbacks_len)))
 	{
-		size_t feedback_len = 0;
+		size_t feedback_len;
 
 		feedbacks_nr++;
+		if(feedbacks_nr > ROHC_DECOMP_FEEDBACK_ITEMS_MAX)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "more than %u feedback items in ROHC packet",
+			             ROHC_DECOMP_FEEDBACK_ITEMS_MAX);
+			goto error;
+		}
 
 		/* decode one feedback packet */
 		rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		           "parse feedback item #%zu at offset %zu in ROHC packet",
-		           feedbacks_nr, feedbacks_full_len);
-		if(!rohc_decomp_parse_feedback(decomp, rohc_data, feedbacks, &feedback_len))
+		           feedbacks_nr, feedbacks_len);
+		if(!rohc_decomp_parse_feedback(decomp, *rohc_data, feedbacks_len,
+		                               &feedback_len))
 		{
 			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 			             "failed to parse feedback item #%zu at offset %zu in "
-			             "ROHC packet", feedbacks_nr, feedbacks_full_len);
+			             "ROHC packet", feedbacks_nr, feedbacks_len);
 			goto error;
 		}
-		feedbacks_full_len += feedback_len;
+		feedbacks_len += feedback_len;
+	}
 
-		/* hide the feedback */
-		if(feedbacks != NULL)
+	/* return the feedback items to user if he/she asked for */
+	if(feedbacks != NULL && feedbacks_len > 0)
+	{
+		const size_t avail_len = rohc_buf_avail_len(*feedbacks) - feedbacks->len;
+
+		if(feedbacks_len > avail_len)
+		{
+			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+			             "failed to store %zu bytes of feedback into the buffer "
+			             "given by the user, only %zu bytes available: ignore "
+			             "feedback", feedbacks_len, avail_len);
+		}
+		else
 		{
-			feedbacks_len += feedbacks->len;
-			rohc_buf_pull(feedbacks, feedbacks->len);
+			rohc_buf_append(feedbacks, rohc_buf_data(*rohc_data), feedbacks_len);
 		}
 	}
 
-	/* unhide all feedbacks */
-	if(feedbacks != NULL)
-	{
-		rohc_buf_push(feedbacks, feedbacks_len);
-	}
+	/* skip the feedback items in the ROHC packet */
+	rohc_buf_pull(rohc_data, feedbacks_len);
 
 	return true;
 
@@ -4023,25 +7768,25 @@ error:
  *
  * @param decomp             The ROHC decompressor
  * @param rohc_data          The ROHC data to parse for one feedback item
- * @param[out] feedback      The retrieved feedback (header and data included),
- *                           may be NULL if one don't want to retrieve the
- *                           feedback item
- * @param[out] feedback_len  The length of the parsed feedback (maybe be different
- *                           from feedback->len if feedback was NULL or full)
+ * @param offset             The offset of the feedback item in the ROHC data
+ * @param[out] feedback_len  The length of the parsed feedback item
  * @return                   true if feedback parsing was successful,
  *                           false if feedback is malformed
  */
 static bool rohc_decomp_parse_feedback(struct rohc_decomp *const decomp,
-                                       struct rohc_buf *const rohc_data,
-                                       struct rohc_buf *const feedback,
+                                       const struct rohc_buf rohc_data,
+                                       const size_t offset,
                                        size_t *const feedback_len)
 {
+	struct rohc_buf feedback = rohc_data;
 	size_t feedback_hdr_len;
 	size_t feedback_data_len;
 	bool is_ok;
 
+	rohc_buf_pull(&feedback, offset);
+
 	/* compute the length of the feedback item */
-	is_ok = rohc_feedback_get_size(*rohc_data, &feedback_hdr_len,
+	is_ok = rohc_feedback_get_size(feedback, &feedback_hdr_len,
 	                               &feedback_data_len);
 	if(!is_ok)
 	{
@@ -4055,33 +7800,14 @@ static bool rohc_decomp_parse_feedback(struct rohc_decomp *const decomp,
 	           feedback_hdr_len, feedback_data_len);
 
 	/* reject feedback item if it doesn't fit in the available ROHC data */
-	if((*feedback_len) > rohc_data->len)
+	if((*feedback_len) > feedback.len)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		             "the %zu-byte feedback is too large for the %zu-byte "
-		             "remaining ROHC data", *feedback_len, rohc_data->len);
+		             "remaining ROHC data", *feedback_len, feedback.len);
 		goto error;
 	}
 
-	/* copy the feedback item in order to return it user if he/she asked for */
-	if(feedback != NULL)
-	{
-		if((feedback->len + (*feedback_len)) > rohc_buf_avail_len(*feedback))
-		{
-			rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
-			             "failed to store %zu-byte feedback into the buffer given "
-			             "by the user, only %zu bytes still available: ignore "
-			             "feedback", *feedback_len, rohc_buf_avail_len(*feedback));
-		}
-		else
-		{
-			rohc_buf_append(feedback, rohc_buf_data(*rohc_data), *feedback_len);
-		}
-	}
-
-	/* skip the feedback item in the ROHC packet */
-	rohc_buf_pull(rohc_data, *feedback_len);
-
 	return true;
 
 error:
@@ -4104,18 +7830,40 @@ static bool rohc_decomp_create_contexts(struct rohc_decomp *const decomp,
 	assert(decomp != NULL);
 	assert(max_cid <= ROHC_LARGE_CID_MAX);
 
-	/* allocate memory for the new context array */
-	decomp->contexts = calloc(max_cid + 1, sizeof(struct rohc_decomp_ctxt *));
-	if(decomp->contexts == NULL)
+	/* allocate memory for the array of context pages, the pages themselves
+	 * are allocated on demand by d_alloc_ctxt() */
+	decomp->ctxt_pages_nr = (max_cid + ROHC_DECOMP_CTXT_PAGE_LEN) /
+	                        ROHC_DECOMP_CTXT_PAGE_LEN;
+	decomp->ctxts_mem_len = 0;
+	decomp->ctxt_pages = rohc_mem_calloc(&decomp->mem_ops, decomp->ctxt_pages_nr,
+	                                     sizeof(struct rohc_decomp_ctxt *));
+	if(decomp->ctxt_pages == NULL)
 	{
 		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 		             "cannot allocate memory for the contexts");
-		return false;
+		goto error;
 	}
+
+	/* allocate the spare context for the IR packets that re-use a CID */
+	decomp->spare_ctxt = rohc_mem_calloc(&decomp->mem_ops, 1,
+	                                     sizeof(struct rohc_decomp_ctxt));
+	if(decomp->spare_ctxt == NULL)
+	{
+		rohc_warning(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
+		             "cannot allocate memory for the spare context");
+		goto free_pages;
+	}
+
 	rohc_debug(decomp, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
 	           "room for %zu decompression contexts created", max_cid + 1);
 
 	return true;
+
+free_pages:
+	rohc_mem_free(&decomp->mem_ops, decomp->ctxt_pages);
+	decomp->ctxt_pages = NULL;
+error:
+	return false;
 }
 
 
@@ -4128,7 +7876,7 @@ static bool rohc_decomp_create_contexts(struct rohc_decomp *const decomp,
  */
 static bool rohc_decomp_packet_carry_static_info(const rohc_packet_t packet_type)
 {
-	return (packet_type == ROHC_PACKET_IR);
+	return (packet_type == ROHC_PACKET_IR || packet_type == ROHC_PACKET_IR_CR);
 }
 
 
@@ -4147,13 +7895,19 @@ static bool rohc_decomp_packet_carry_crc_7_or_8(const rohc_packet_t packet_type)
 	{
 		case ROHC_PACKET_IR:
 		case ROHC_PACKET_IR_DYN:
+		case ROHC_PACKET_IR_CR:
 		case ROHC_PACKET_UOR_2:
 		case ROHC_PACKET_UOR_2_RTP:
 		case ROHC_PACKET_UOR_2_TS:
 		case ROHC_PACKET_UOR_2_ID:
+		case ROHC_PACKET_R_0_CRC:
 		case ROHC_PACKET_TCP_CO_COMMON:
 		case ROHC_PACKET_TCP_SEQ_8:
 		case ROHC_PACKET_TCP_RND_8:
+		case ROHC_PACKET_CO_REPAIR:
+		case ROHC_PACKET_CO_COMMON:
+		case ROHC_PACKET_NORTP_PT_0_CRC7:
+		case ROHC_PACKET_NORTP_PT_2_SEQ_ID:
 			carry_crc_7_or_8 = true;
 			break;
 		case ROHC_PACKET_UO_0:
@@ -4161,6 +7915,7 @@ static bool rohc_decomp_packet_carry_crc_7_or_8(const rohc_packet_t packet_type)
 		case ROHC_PACKET_UO_1_RTP:
 		case ROHC_PACKET_UO_1_TS:
 		case ROHC_PACKET_UO_1_ID:
+		case ROHC_PACKET_R_0:
 		case ROHC_PACKET_NORMAL:
 		case ROHC_PACKET_TCP_SEQ_1:
 		case ROHC_PACKET_TCP_SEQ_2:
@@ -4176,6 +7931,8 @@ static bool rohc_decomp_packet_carry_crc_7_or_8(const rohc_packet_t packet_type)
 		case ROHC_PACKET_TCP_RND_5:
 		case ROHC_PACKET_TCP_RND_6:
 		case ROHC_PACKET_TCP_RND_7:
+		case ROHC_PACKET_PT_0_CRC3:
+		case ROHC_PACKET_NORTP_PT_1_SEQ_ID:
 			carry_crc_7_or_8 = false;
 			break;
 		case ROHC_PACKET_UNKNOWN:
@@ -46,6 +46,12 @@ extern "C"
 #  define ROHC_EXPORT
 #endif
 
+/* the public API stays visible when the library is built with
+ * -fvisibility=hidden */
+#if defined(__GNUC__) && __GNUC__ >= 4
+#  pragma GCC visibility push(default)
+#endif
+
 
 /*
  * Declare the private ROHC decompressor structure that is defined inside the
@@ -53,6 +59,8 @@ extern "C"
  */
 
 struct rohc_decomp;
+struct rohc_decomp_shards;
+struct rohc_decomp_engine;
 
 
 
@@ -210,6 +218,35 @@ typedef struct
 } __attribute__((packed)) rohc_decomp_context_info_t;
 
 
+/**
+ * @brief The record of one decompression context
+ *
+ * The records of all the contexts in use are given by the
+ * \ref rohc_decomp_get_contexts function.
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_contexts
+ */
+struct rohc_decomp_ctxt_record
+{
+	/** The number of packets received by the context */
+	uint64_t packets_nr;
+	/** The number of compressed bytes received by the context */
+	uint64_t comp_bytes_nr;
+	/** The number of uncompressed bytes produced by the context */
+	uint64_t uncomp_bytes_nr;
+	/** The Context ID (CID) of the context */
+	rohc_cid_t cid;
+	/** The profile of the context */
+	rohc_profile_t profile;
+	/** The operation mode of the context */
+	rohc_mode_t mode;
+	/** The state of the context */
+	rohc_decomp_state_t state;
+};
+
+
 /**
  * @brief Some general information about the decompressor
  *
@@ -238,6 +275,13 @@ typedef struct
  * Supported versions:
  *  - major 0 and minor = 0 contains: version_major, version_minor,
  *    contexts_nr, packets_nr, comp_bytes_nr, and uncomp_bytes_nr.
+ *  - major 0 and minor = 1 added: corrected_crc_failures,
+ *    corrected_sn_wraparounds, and corrected_wrong_sn_updates.
+ *  - major 0 and minor = 2 added: failed_crc_nr, failed_no_context_nr,
+ *    failed_decomp_nr, feedbacks_ack_nr, and feedbacks_nack_nr.
+ *  - major 0 and minor = 3 added: crc_repairs_nr.
+ *  - major 0 and minor = 4 added: overloads_nr, overload_pkts_nr, and
+ *    overload_acks_nr.
  *
  * @ingroup rohc_decomp
  *
@@ -268,9 +312,86 @@ typedef struct
 	 *  upon CRC failure */
 	unsigned long corrected_wrong_sn_updates;
 
+	/* added in 0.2 */
+	/** The number of packets that failed decompression because of a bad CRC */
+	unsigned long failed_crc_nr;
+	/** The number of packets that failed decompression because no context
+	 *  was established for their CID */
+	unsigned long failed_no_context_nr;
+	/** The number of packets that failed decompression */
+	unsigned long failed_decomp_nr;
+	/** The number of positive feedbacks (ACK) built */
+	unsigned long feedbacks_ack_nr;
+	/** The number of negative feedbacks (NACK and STATIC-NACK) built */
+	unsigned long feedbacks_nack_nr;
+
+	/* added in 0.3 */
+	/** The cumulative number of corrections attempted upon CRC failure,
+	 *  see corrected_crc_failures for the successful ones */
+	unsigned long crc_repairs_nr;
+
+	/* added in 0.4 */
+	/** The number of times the decompressor entered the overload mode */
+	unsigned long overloads_nr;
+	/** The number of packets decompressed in overload mode */
+	unsigned long overload_pkts_nr;
+	/** The number of positive feedbacks (ACK) deferred in overload mode */
+	unsigned long overload_acks_nr;
+
 } __attribute__((packed)) rohc_decomp_general_info_t;
 
 
+/**
+ * @brief The stages of decompression measured by the ROHC decompressor
+ *
+ * The stages are measured only if the library is configured with the
+ * --enable-rohc-perf-stats option.
+ *
+ * The context lookup and all the next stages are part of the
+ * \ref ROHC_DECOMP_PERF_DECODE_HEADER stage. The packets decoded by the fast
+ * path of their profile skip the parsing, decoding and building stages.
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_perf_stats
+ */
+typedef enum
+{
+	/** Decode the whole ROHC packet */
+	ROHC_DECOMP_PERF_DECODE_HEADER = 0,
+	/** Find the context of the packet, or create it */
+	ROHC_DECOMP_PERF_CTXT_LOOKUP   = 1,
+	/** Decode the packet with the fast path of the profile */
+	ROHC_DECOMP_PERF_FAST_PATH     = 2,
+	/** Parse the ROHC header */
+	ROHC_DECOMP_PERF_PARSE         = 3,
+	/** Check the CRC of the IR and IR-DYN headers */
+	ROHC_DECOMP_PERF_CRC_CHECK     = 4,
+	/** Decode the header fields from the parsed bits */
+	ROHC_DECOMP_PERF_DECODE        = 5,
+	/** Build the uncompressed headers and check their CRC */
+	ROHC_DECOMP_PERF_BUILD         = 6,
+	/** Copy the payload after the uncompressed headers */
+	ROHC_DECOMP_PERF_PAYLOAD_COPY  = 7,
+
+	ROHC_DECOMP_PERF_STAGE_MAX     /**< The number of decompression stages */
+} rohc_decomp_perf_stage_t;
+
+
+/**
+ * @brief The durations of the decompression stages
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_perf_stats
+ */
+struct rohc_decomp_perf_stats
+{
+	/** The histogram of durations of every decompression stage */
+	struct rohc_perf_hist stages[ROHC_DECOMP_PERF_STAGE_MAX];
+};
+
+
 /**
  * @brief The different features of the ROHC decompressor
  *
@@ -292,10 +413,262 @@ typedef enum
 	ROHC_DECOMP_FEATURE_COMPAT_1_6_x = (1 << 1),
 	/** Dump content of packets in traces (beware: performance impact) */
 	ROHC_DECOMP_FEATURE_DUMP_PACKETS = (1 << 3),
+	/** Drop the superseded ACKs from the feedback of bursts */
+	ROHC_DECOMP_FEATURE_COALESCE_FEEDBACK = (1 << 4),
+	/** Record the last packets of every context for post-mortem analysis,
+	 *  see \ref rohc_decomp_get_flight */
+	ROHC_DECOMP_FEATURE_FLIGHT_RECORDER = (1 << 5),
+	/** Decompress the packets of one context one after the other in the
+	 *  groups of packets of \ref rohc_decompress_burst, so that every
+	 *  context is loaded in cache once per group; the packets of one context
+	 *  keep their order and the uncompressed packets keep the slots of their
+	 *  ROHC packets */
+	ROHC_DECOMP_FEATURE_BURST_GROUPING = (1 << 6),
 
 } rohc_decomp_features_t;
 
 
+/**
+ * @brief The runtime configuration of one ROHC decompressor
+ *
+ * The tunables that may be changed while the decompressor is running, see
+ * \ref rohc_decomp_get_cfg and \ref rohc_decomp_publish_cfg. Every field
+ * has the meaning of the parameter of the corresponding setter.
+ *
+ * @ingroup rohc_decomp
+ */
+struct rohc_decomp_cfg
+{
+	/** The enabled features, see \ref rohc_decomp_set_features */
+	rohc_decomp_features_t features;
+	/** The number of packets per Round-Trip Time, see
+	 *  \ref rohc_decomp_set_prtt */
+	size_t prtt;
+	/** The reorder window (in packets), see
+	 *  \ref rohc_decomp_set_reorder_window */
+	size_t reorder_window;
+	/** The rate limits of the feedbacks, see \ref rohc_decomp_set_rate_limits */
+	size_t k;
+	size_t n;      /**< see \e k */
+	size_t k_1;    /**< see \e k */
+	size_t n_1;    /**< see \e k */
+	size_t k_2;    /**< see \e k */
+	size_t n_2;    /**< see \e k */
+	/** The byte rate (in bytes/s) of all the feedbacks, see
+	 *  \ref rohc_decomp_set_feedback_rates */
+	size_t decomp_byte_rate;
+	/** The byte rate (in bytes/s) of the feedbacks of every context, see
+	 *  \ref rohc_decomp_set_feedback_rates */
+	size_t ctxt_byte_rate;
+	/** The idle timeout (in seconds) of the contexts, see
+	 *  \ref rohc_decomp_set_ctxt_idle_timeout */
+	size_t ctxt_idle_timeout;
+	/** The memory budget (in bytes), see \ref rohc_decomp_set_mem_budget */
+	size_t mem_budget;
+	/** The load beyond which the decompressor sheds work, see
+	 *  \ref rohc_decomp_set_overload */
+	struct rohc_load overload_limits;
+};
+
+
+/**
+ * @brief The prototype of the callback for allocating memory
+ *
+ * User-defined function that is called when the ROHC decompressor requires
+ * memory for the profile-specific parts of its contexts. The decompressor
+ * requests memory by chunks of several contexts, and reuses the memory of
+ * recycled contexts for the next ones. The returned memory shall be aligned
+ * as the memory returned by malloc().
+ *
+ * The user-defined functions are set by calling the function
+ * \ref rohc_decomp_set_alloc_cbs
+ *
+ * @param size  The size of the memory to allocate (in bytes)
+ * @param priv  The private data given by the user when he/she called the
+ *              \ref rohc_decomp_set_alloc_cbs function, may be NULL.
+ * @return      The allocated memory, NULL if no memory is available
+ *
+ * @see rohc_decomp_set_alloc_cbs
+ * @ingroup rohc_decomp
+ */
+typedef void * (*rohc_decomp_alloc_cb_t) (const size_t size, void *const priv)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief The prototype of the callback for freeing memory
+ *
+ * User-defined function that is called when the ROHC decompressor releases
+ * memory previously obtained from the \ref rohc_decomp_alloc_cb_t callback.
+ *
+ * @param ptr   The memory to free
+ * @param priv  The private data given by the user when he/she called the
+ *              \ref rohc_decomp_set_alloc_cbs function, may be NULL.
+ *
+ * @see rohc_decomp_set_alloc_cbs
+ * @ingroup rohc_decomp
+ */
+typedef void (*rohc_decomp_free_cb_t) (void *const ptr, void *const priv);
+
+
+/** The number of packets the flight recorder keeps for every context */
+#define ROHC_DECOMP_FLIGHT_PKTS_NR  8U
+
+/** The maximal number of bytes the flight recorder keeps for every packet */
+#define ROHC_DECOMP_FLIGHT_BYTES_MAX  48U
+
+
+/**
+ * @brief One packet recorded by the flight recorder of a context
+ *
+ * The flight recorder of a context keeps the last \ref ROHC_DECOMP_FLIGHT_PKTS_NR
+ * packets received for the context, so that a CRC failure or a context
+ * damage may be diagnosed without a full capture. Only the first
+ * \ref ROHC_DECOMP_FLIGHT_BYTES_MAX bytes of every packet are kept, starting
+ * with the ROHC header: the padding and the piggybacked feedback are skipped.
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_get_flight
+ * @see ROHC_DECOMP_FEATURE_FLIGHT_RECORDER
+ */
+struct rohc_decomp_flight_pkt
+{
+	/** The time at which the packet was received */
+	struct rohc_ts time;
+	/** The SN of the context once the packet was handled: the SN of the
+	 *  packet if it was decompressed, the reference SN otherwise */
+	uint32_t sn;
+	/** The length of the ROHC packet, ROHC header and payload */
+	uint16_t len;
+	/** The type of the ROHC packet, see \ref rohc_packet_t */
+	uint8_t packet_type;
+	/** The status of the decompression, see \ref rohc_status_t */
+	uint8_t status;
+	/** The state of the context once the packet was handled,
+	 *  see \ref rohc_decomp_state_t */
+	uint8_t state;
+	/** The number of bytes recorded in \e bytes */
+	uint8_t bytes_nr;
+	/** The first bytes of the packet */
+	uint8_t bytes[ROHC_DECOMP_FLIGHT_BYTES_MAX];
+};
+
+
+/**
+ * @brief The prototype of the callback that receives the recorded packets
+ *        of a damaged context
+ *
+ * User-defined function that is called by the ROHC decompressor when one
+ * packet fails the CRC check of its context, or when the context is damaged
+ * (its state is downgraded). The callback receives the last packets of the
+ * context, the failing one included.
+ *
+ * The user-defined function is set by calling the function
+ * \ref rohc_decomp_set_flight_cb
+ *
+ * @param priv     The private data given by the user when he/she called the
+ *                 \ref rohc_decomp_set_flight_cb function, may be NULL.
+ * @param cid      The CID of the context
+ * @param profile  The profile of the context
+ * @param pkts     The recorded packets, the oldest first
+ * @param pkts_nr  The number of recorded packets
+ *
+ * @see rohc_decomp_set_flight_cb
+ * @ingroup rohc_decomp
+ */
+typedef void (*rohc_decomp_flight_cb_t) (void *const priv,
+                                         const rohc_cid_t cid,
+                                         const rohc_profile_t profile,
+                                         const struct rohc_decomp_flight_pkt pkts[],
+                                         const size_t pkts_nr);
+
+
+/**
+ * @brief The header fields of one decompressed packet
+ *
+ * The fields are given by \ref rohc_decompress_fields for the programs that
+ * only need the flow and sequencing information of the packets, not the
+ * packets themselves. The fields of the IP header are the ones of the
+ * innermost IP header. The multi-byte fields are in host byte order, except
+ * the IP addresses that are kept in network byte order.
+ *
+ * The fields that the packet does not carry are set to zero.
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decompress_fields
+ */
+struct rohc_decomp_fields
+{
+	/** The Context ID (CID) of the packet */
+	rohc_cid_t cid;
+	/** The profile of the context */
+	rohc_profile_t profile;
+	/** The SN of the packet as decoded by the profile: the RTP SN, the ESP
+	 *  SN, the TCP MSN or the SN generated by the remote compressor */
+	uint32_t sn;
+
+	/** The length of the uncompressed headers in the \e hdrs buffer given
+	 *  to \ref rohc_decompress_fields */
+	size_t hdrs_len;
+	/** The payload of the packet, not copied: it points either in the ROHC
+	 *  packet, in the \e hdrs buffer for the Uncompressed profile, or in the
+	 *  decompressor for a packet reassembled from ROHC segments. It is valid
+	 *  until the next packet is decompressed. */
+	struct rohc_buf payload;
+
+	/** The number of IP headers, 0 for a feedback-only packet */
+	uint8_t ip_hdrs_nr;
+	/** The version of the IP header: 4 or 6 */
+	uint8_t ip_version;
+	/** The TOS of the IPv4 header or the Traffic Class of the IPv6 header */
+	uint8_t tos;
+	/** The TTL of the IPv4 header or the Hop Limit of the IPv6 header */
+	uint8_t ttl;
+	/** The IP-ID of the IPv4 header */
+	uint16_t ip_id;
+	/** The transport protocol, after the IPv6 extension headers */
+	uint8_t proto;
+	/** The source IP address: 4 bytes for IPv4, 16 bytes for IPv6 */
+	uint8_t src_addr[16];
+	/** The destination IP address: 4 bytes for IPv4, 16 bytes for IPv6 */
+	uint8_t dst_addr[16];
+
+	/** The source port of the UDP, UDP-Lite or TCP header */
+	uint16_t src_port;
+	/** The destination port of the UDP, UDP-Lite or TCP header */
+	uint16_t dst_port;
+
+	/** The sequence number of the TCP header */
+	uint32_t tcp_seq;
+	/** The acknowledgment number of the TCP header */
+	uint32_t tcp_ack;
+	/** The window of the TCP header */
+	uint16_t tcp_window;
+	/** The 8 flags of the TCP header, CWR to FIN */
+	uint8_t tcp_flags;
+
+	/** Whether the packet carries one RTP header or not */
+	bool is_rtp;
+	/** The Marker (M) bit of the RTP header */
+	bool rtp_marker;
+	/** The Payload Type (PT) of the RTP header */
+	uint8_t rtp_pt;
+	/** The sequence number of the RTP header */
+	uint16_t rtp_sn;
+	/** The timestamp of the RTP header */
+	uint32_t rtp_ts;
+	/** The SSRC of the RTP header */
+	uint32_t rtp_ssrc;
+
+	/** The SPI of the ESP header */
+	uint32_t esp_spi;
+	/** The sequence number of the ESP header */
+	uint32_t esp_sn;
+};
+
+
 
 /*
  * Functions related to decompressor:
@@ -306,6 +679,25 @@ struct rohc_decomp * ROHC_EXPORT rohc_decomp_new2(const rohc_cid_type_t cid_type
                                                   const rohc_mode_t mode)
 	__attribute__((warn_unused_result));
 
+struct rohc_decomp * ROHC_EXPORT rohc_decomp_new3(const rohc_cid_type_t cid_type,
+                                                  const rohc_cid_t max_cid,
+                                                  const rohc_mode_t mode,
+                                                  const struct rohc_mem_ops *const mem_ops)
+	__attribute__((warn_unused_result));
+
+struct rohc_decomp * ROHC_EXPORT rohc_decomp_new_static(const rohc_cid_type_t cid_type,
+                                                        const rohc_cid_t max_cid,
+                                                        const rohc_mode_t mode,
+                                                        void *const mem,
+                                                        const size_t mem_len)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_decomp_mem_size(const rohc_cid_type_t cid_type,
+                                        const rohc_cid_t max_cid,
+                                        const rohc_profile_t profiles[],
+                                        const size_t profiles_nr)
+	__attribute__((warn_unused_result));
+
 void ROHC_EXPORT rohc_decomp_free(struct rohc_decomp *const decomp);
 
 rohc_status_t ROHC_EXPORT rohc_decompress3(struct rohc_decomp *const decomp,
@@ -315,6 +707,78 @@ rohc_status_t ROHC_EXPORT rohc_decompress3(struct rohc_decomp *const decomp,
                                            struct rohc_buf *const feedback_send)
 	__attribute__((warn_unused_result));
 
+size_t ROHC_EXPORT rohc_decompress_burst(struct rohc_decomp *const decomp,
+                                         const struct rohc_buf rohc_packets[],
+                                         struct rohc_buf uncomp_packets[],
+                                         rohc_status_t status[],
+                                         const size_t pkts_nr,
+                                         struct rohc_buf *const rcvd_feedback,
+                                         struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_decompress_inplace(struct rohc_decomp *const decomp,
+                                                  struct rohc_buf *const packet,
+                                                  struct rohc_buf *const rcvd_feedback,
+                                                  struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+rohc_status_t ROHC_EXPORT rohc_decompress_fields(struct rohc_decomp *const decomp,
+                                                 const struct rohc_buf rohc_packet,
+                                                 struct rohc_buf *const hdrs,
+                                                 struct rohc_decomp_fields *const fields,
+                                                 struct rohc_buf *const rcvd_feedback,
+                                                 struct rohc_buf *const feedback_send)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_provision_context(struct rohc_decomp *const decomp,
+                                               const struct rohc_buf descr)
+	__attribute__((warn_unused_result));
+
+
+/*
+ * Functions related to sharded decompressor:
+ */
+
+struct rohc_decomp_shards * ROHC_EXPORT
+	rohc_decomp_shards_new(const rohc_cid_type_t cid_type,
+	                       const rohc_cid_t max_cid,
+	                       const size_t shards_nr,
+	                       const rohc_mode_t mode)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_decomp_shards_free(struct rohc_decomp_shards *const shards);
+
+struct rohc_decomp * ROHC_EXPORT
+	rohc_decomp_shards_get(const struct rohc_decomp_shards *const shards,
+	                       const size_t shard_id)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_shards_select(const struct rohc_decomp_shards *const shards,
+                                           const struct rohc_buf rohc_packet,
+                                           size_t *const shard_id)
+	__attribute__((warn_unused_result));
+
+
+/*
+ * Functions related to multi-channel decompression engine:
+ */
+
+struct rohc_decomp_engine * ROHC_EXPORT
+	rohc_decomp_engine_new(const struct rohc_mem_ops *const mem_ops)
+	__attribute__((warn_unused_result));
+
+void ROHC_EXPORT rohc_decomp_engine_free(struct rohc_decomp_engine *const engine);
+
+struct rohc_decomp * ROHC_EXPORT
+	rohc_decomp_engine_new_channel(struct rohc_decomp_engine *const engine,
+	                               const rohc_cid_type_t cid_type,
+	                               const rohc_cid_t max_cid,
+	                               const rohc_mode_t mode)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_decomp_engine_get_channels_nr(const struct rohc_decomp_engine *const engine)
+	__attribute__((warn_unused_result));
+
 
 
 /*
@@ -333,10 +797,19 @@ bool ROHC_EXPORT rohc_decomp_get_context_info(const struct rohc_decomp *const de
                                               rohc_decomp_context_info_t *const info)
 	__attribute__((warn_unused_result));
 
+size_t ROHC_EXPORT rohc_decomp_get_contexts(const struct rohc_decomp *const decomp,
+                                            struct rohc_decomp_ctxt_record records[],
+                                            const size_t records_max)
+	__attribute__((warn_unused_result));
+
 bool ROHC_EXPORT rohc_decomp_get_last_packet_info(const struct rohc_decomp *const decomp,
                                                   rohc_decomp_last_packet_info_t *const info)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_get_perf_stats(const struct rohc_decomp *const decomp,
+                                            struct rohc_decomp_perf_stats *const stats)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Functions related to user parameters
@@ -372,6 +845,52 @@ bool ROHC_EXPORT rohc_decomp_get_prtt(const struct rohc_decomp *const decomp,
                                       size_t *const prtt)
 	__attribute__((warn_unused_result));
 
+/* tolerance to reordering */
+
+bool ROHC_EXPORT rohc_decomp_set_reorder_window(struct rohc_decomp *const decomp,
+                                                const size_t window)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_get_reorder_window(const struct rohc_decomp *const decomp,
+                                                size_t *const window)
+	__attribute__((warn_unused_result));
+
+/* expiry of unused contexts */
+
+bool ROHC_EXPORT rohc_decomp_set_ctxt_idle_timeout(struct rohc_decomp *const decomp,
+                                                   const size_t timeout)
+	__attribute__((warn_unused_result));
+
+/* memory budget */
+
+bool ROHC_EXPORT rohc_decomp_set_mem_budget(struct rohc_decomp *const decomp,
+                                            const size_t budget)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_get_mem_usage(const struct rohc_decomp *const decomp,
+                                           size_t *const usage)
+	__attribute__((warn_unused_result));
+
+/* overload shedding */
+
+bool ROHC_EXPORT rohc_decomp_set_overload(struct rohc_decomp *const decomp,
+                                          const struct rohc_load *const limits)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_set_load(struct rohc_decomp *const decomp,
+                                      const struct rohc_load *const load)
+	__attribute__((warn_unused_result));
+
+/* runtime configuration */
+
+bool ROHC_EXPORT rohc_decomp_get_cfg(const struct rohc_decomp *const decomp,
+                                     struct rohc_decomp_cfg *const cfg)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_publish_cfg(struct rohc_decomp *const decomp,
+                                         const struct rohc_decomp_cfg *const cfg)
+	__attribute__((warn_unused_result));
+
 /* feedback rate-limiting */
 
 bool ROHC_EXPORT rohc_decomp_set_rate_limits(struct rohc_decomp *const decomp,
@@ -386,12 +905,28 @@ bool ROHC_EXPORT rohc_decomp_get_rate_limits(const struct rohc_decomp *const dec
                                              size_t *const k_2, size_t *const n_2)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_set_feedback_rates(struct rohc_decomp *const decomp,
+                                                const size_t decomp_byte_rate,
+                                                const size_t ctxt_byte_rate)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_get_feedback_rates(const struct rohc_decomp *const decomp,
+                                                size_t *const decomp_byte_rate,
+                                                size_t *const ctxt_byte_rate)
+	__attribute__((warn_unused_result));
+
 /* decompression library features */
 
 bool ROHC_EXPORT rohc_decomp_set_features(struct rohc_decomp *const decomp,
                                           const rohc_decomp_features_t features)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_set_alloc_cbs(struct rohc_decomp *const decomp,
+                                           rohc_decomp_alloc_cb_t alloc_cb,
+                                           rohc_decomp_free_cb_t free_cb,
+                                           void *const priv)
+	__attribute__((warn_unused_result));
+
 
 /*
  * Functions related to decompression profiles
@@ -427,6 +962,44 @@ bool ROHC_EXPORT rohc_decomp_set_traces_cb2(struct rohc_decomp *const decomp,
                                             void *const priv_ctxt)
 	__attribute__((warn_unused_result));
 
+bool ROHC_EXPORT rohc_decomp_set_trace_ring(struct rohc_decomp *const decomp,
+                                            struct rohc_trace_ring *const ring)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_set_trace_events(struct rohc_decomp *const decomp,
+                                              const uint32_t events)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_trace_filter_add_cid(struct rohc_decomp *const decomp,
+                                                  const rohc_cid_t cid)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_trace_filter_add_profile(struct rohc_decomp *const decomp,
+                                                      const rohc_profile_t profile)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_trace_filter_add_packet_type(struct rohc_decomp *const decomp,
+                                                          const rohc_packet_t packet_type)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_trace_filter_clear(struct rohc_decomp *const decomp)
+	__attribute__((warn_unused_result));
+
+size_t ROHC_EXPORT rohc_decomp_get_flight(const struct rohc_decomp *const decomp,
+                                          const rohc_cid_t cid,
+                                          struct rohc_decomp_flight_pkt pkts[],
+                                          const size_t pkts_nr)
+	__attribute__((warn_unused_result));
+
+bool ROHC_EXPORT rohc_decomp_set_flight_cb(struct rohc_decomp *const decomp,
+                                           rohc_decomp_flight_cb_t callback,
+                                           void *const priv)
+	__attribute__((warn_unused_result));
+
+
+#if defined(__GNUC__) && __GNUC__ >= 4
+#  pragma GCC visibility pop
+#endif
 
 #undef ROHC_EXPORT /* do not pollute outside this header */
 
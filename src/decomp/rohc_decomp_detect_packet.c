@@ -26,6 +26,7 @@
 
 #include "rohc_decomp_detect_packet.h"
 #include "rohc_bit_ops.h"
+#include "rohc_bit_stream.h"
 
 
 /** The magic bits to find out whether a field is a segment field or not */
@@ -34,6 +35,9 @@
 /** The magic byte to find out whether a field is a padding field or not */
 #define D_PADDING        0xe0
 
+/** The magic byte of padding fields repeated over 8 bytes */
+#define D_PADDING_WORD   (D_PADDING * 0x0101010101010101ULL)
+
 /** The magic bits to find out whether a ROHC packet is an IR packet or not */
 #define D_IR_PACKET      (0xfc >> 1)
 
@@ -41,107 +45,301 @@
 #define D_IR_DYN_PACKET  0xf8
 
 
+/** Repeat one packet type for 8 consecutive first bytes */
+#define ROHC_PKT_TYPES_8(type) \
+	(type), (type), (type), (type), (type), (type), (type), (type)
+
+/** Repeat one packet type for 16 consecutive first bytes */
+#define ROHC_PKT_TYPES_16(type) \
+	ROHC_PKT_TYPES_8(type), ROHC_PKT_TYPES_8(type)
+
 /**
- * @brief Find out whether the field is a segment field or not
+ * @brief The packet types for the first bytes 0xf0 to 0xff
  *
- * @param data The field to analyze
- * @return     Whether the field is a segment field or not
+ * The feedback, padding and segment bytes are parsed before the profile
+ * detects the packet type, they are unknown packet types here.
  */
-bool rohc_decomp_packet_is_segment(const uint8_t *const data)
+#define ROHC_PKT_TYPES_F0 \
+	ROHC_PKT_TYPES_8(ROHC_PACKET_UNKNOWN), /* 0xf0-0xf7: feedback */ \
+	ROHC_PACKET_IR_DYN, /* 0xf8 */ \
+	ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN, \
+	ROHC_PACKET_IR, ROHC_PACKET_IR, /* 0xfc-0xfd */ \
+	ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN /* 0xfe-0xff: segment */
+
+/** The types of packets that share the UO-0/UO-1/UOR-2 layout of RFC 3095 */
+#define ROHC_PKT_TYPES_RFC3095(uo1_id, uo1_ts, uor2) \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UO_0),     /* 0x00-0x0f */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UO_0),     /* 0x10-0x1f */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UO_0),     /* 0x20-0x2f */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UO_0),     /* 0x30-0x3f */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UO_0),     /* 0x40-0x4f */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UO_0),     /* 0x50-0x5f */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UO_0),     /* 0x60-0x6f */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UO_0),     /* 0x70-0x7f */ \
+	ROHC_PKT_TYPES_16(uo1_id),               /* 0x80-0x8f: T = 0 */ \
+	ROHC_PKT_TYPES_16(uo1_id),               /* 0x90-0x9f: T = 0 */ \
+	ROHC_PKT_TYPES_16(uo1_ts),               /* 0xa0-0xaf: T = 1 */ \
+	ROHC_PKT_TYPES_16(uo1_ts),               /* 0xb0-0xbf: T = 1 */ \
+	ROHC_PKT_TYPES_16(uor2),                 /* 0xc0-0xcf */ \
+	ROHC_PKT_TYPES_16(uor2),                 /* 0xd0-0xdf */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UNKNOWN),  /* 0xe0-0xef: padding, Add-CID */ \
+	ROHC_PKT_TYPES_F0
+
+/**
+ * @brief The types of packets that share the R-0/R-0-CRC/UOR-2 layout of
+ *        RFC 3095 (R-mode)
+ *
+ * The R-1* packets are never sent by the compressor, so they are unknown.
+ */
+#define ROHC_PKT_TYPES_RFC3095_R(uor2) \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_R_0),      /* 0x00-0x0f */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_R_0),      /* 0x10-0x1f */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_R_0),      /* 0x20-0x2f */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_R_0),      /* 0x30-0x3f */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_R_0_CRC),  /* 0x40-0x4f */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_R_0_CRC),  /* 0x50-0x5f */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_R_0_CRC),  /* 0x60-0x6f */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_R_0_CRC),  /* 0x70-0x7f */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UNKNOWN),  /* 0x80-0x8f: R-1* */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UNKNOWN),  /* 0x90-0x9f: R-1* */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UNKNOWN),  /* 0xa0-0xaf: R-1* */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UNKNOWN),  /* 0xb0-0xbf: R-1* */ \
+	ROHC_PKT_TYPES_16(uor2),                 /* 0xc0-0xcf */ \
+	ROHC_PKT_TYPES_16(uor2),                 /* 0xd0-0xdf */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UNKNOWN),  /* 0xe0-0xef: padding, Add-CID */ \
+	ROHC_PKT_TYPES_F0
+
+/** The types of the TCP packets with the 4-bit discriminators of RFC 6846 */
+#define ROHC_PKT_TYPES_TCP(t0, t8, t9, ta, tb0, tb8, tbc, tc, td0, td8, tfa) \
+	ROHC_PKT_TYPES_16(t0), ROHC_PKT_TYPES_16(t0), /* 0x00-0x1f */ \
+	ROHC_PKT_TYPES_16(t0), ROHC_PKT_TYPES_16(t0), /* 0x20-0x3f */ \
+	ROHC_PKT_TYPES_16(t0), ROHC_PKT_TYPES_16(t0), /* 0x40-0x5f */ \
+	ROHC_PKT_TYPES_16(t0), ROHC_PKT_TYPES_16(t0), /* 0x60-0x7f */ \
+	ROHC_PKT_TYPES_16(t8),                        /* 0x80-0x8f */ \
+	ROHC_PKT_TYPES_16(t9),                        /* 0x90-0x9f */ \
+	ROHC_PKT_TYPES_16(ta),                        /* 0xa0-0xaf */ \
+	ROHC_PKT_TYPES_8(tb0),                        /* 0xb0-0xb7 */ \
+	(tb8), (tb8), (tb8), (tb8),                   /* 0xb8-0xbb */ \
+	(tbc), (tbc), (tbc), (tbc),                   /* 0xbc-0xbf */ \
+	ROHC_PKT_TYPES_16(tc),                        /* 0xc0-0xcf */ \
+	ROHC_PKT_TYPES_8(td0),                        /* 0xd0-0xd7 */ \
+	ROHC_PKT_TYPES_8(td8),                        /* 0xd8-0xdf */ \
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UNKNOWN),       /* 0xe0-0xef */ \
+	ROHC_PKT_TYPES_8(ROHC_PACKET_UNKNOWN),        /* 0xf0-0xf7 */ \
+	ROHC_PACKET_IR_DYN,                           /* 0xf8 */ \
+	ROHC_PACKET_UNKNOWN,                          /* 0xf9 */ \
+	(tfa), (tfa),                                 /* 0xfa-0xfb */ \
+	ROHC_PACKET_IR_CR,                            /* 0xfc */ \
+	ROHC_PACKET_IR,                               /* 0xfd */ \
+	ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN      /* 0xfe-0xff */
+
+
+/** The packet types of the IP-based non-RTP profiles */
+const uint8_t rohc_decomp_pkt_types_ip[ROHC_DECOMP_PKT_TYPES_NR] =
 {
-	return (GET_BIT_1_7(data) == D_SEGMENT);
-}
+	ROHC_PKT_TYPES_RFC3095(ROHC_PACKET_UO_1, ROHC_PACKET_UO_1, ROHC_PACKET_UOR_2)
+};
 
+/** The packet types of the RTP profile without IPv4 header with RND = 0 */
+const uint8_t rohc_decomp_pkt_types_rtp[ROHC_DECOMP_PKT_TYPES_NR] =
+{
+	ROHC_PKT_TYPES_RFC3095(ROHC_PACKET_UO_1_RTP, ROHC_PACKET_UO_1_RTP,
+	                       ROHC_PACKET_UOR_2_RTP)
+};
 
 /**
- * @brief Find out whether the field is a padding field or not
+ * @brief The packet types of the RTP profile with one IPv4 header with RND = 0
  *
- * @param data The field to analyze
- * @return     Whether the field is a padding field or not
+ * The T bit of UOR-2-ID/TS packets is in the byte after the large CID, so
+ * their first byte is not enough to detect the packet type.
  */
-bool rohc_decomp_packet_is_padding(const uint8_t *const data)
+const uint8_t rohc_decomp_pkt_types_rtp_ipv4[ROHC_DECOMP_PKT_TYPES_NR] =
 {
-	return (GET_BIT_0_7(data) == D_PADDING);
-}
+	ROHC_PKT_TYPES_RFC3095(ROHC_PACKET_UO_1_ID, ROHC_PACKET_UO_1_TS,
+	                       ROHC_DECOMP_PKT_MORE)
+};
 
+/** The packet types of the IP-based non-RTP profiles in R-mode */
+const uint8_t rohc_decomp_pkt_types_ip_r[ROHC_DECOMP_PKT_TYPES_NR] =
+{
+	ROHC_PKT_TYPES_RFC3095_R(ROHC_PACKET_UOR_2)
+};
+
+/** The packet types of the RTP profile in R-mode without IPv4 header with
+ *  RND = 0 */
+const uint8_t rohc_decomp_pkt_types_rtp_r[ROHC_DECOMP_PKT_TYPES_NR] =
+{
+	ROHC_PKT_TYPES_RFC3095_R(ROHC_PACKET_UOR_2_RTP)
+};
+
+/** The packet types of the RTP profile in R-mode with one IPv4 header with
+ *  RND = 0 */
+const uint8_t rohc_decomp_pkt_types_rtp_ipv4_r[ROHC_DECOMP_PKT_TYPES_NR] =
+{
+	ROHC_PKT_TYPES_RFC3095_R(ROHC_DECOMP_PKT_MORE)
+};
+
+/** The packet types of the Uncompressed profile */
+const uint8_t rohc_decomp_pkt_types_uncomp[ROHC_DECOMP_PKT_TYPES_NR] =
+{
+	ROHC_PKT_TYPES_16(ROHC_PACKET_NORMAL), ROHC_PKT_TYPES_16(ROHC_PACKET_NORMAL),
+	ROHC_PKT_TYPES_16(ROHC_PACKET_NORMAL), ROHC_PKT_TYPES_16(ROHC_PACKET_NORMAL),
+	ROHC_PKT_TYPES_16(ROHC_PACKET_NORMAL), ROHC_PKT_TYPES_16(ROHC_PACKET_NORMAL),
+	ROHC_PKT_TYPES_16(ROHC_PACKET_NORMAL), ROHC_PKT_TYPES_16(ROHC_PACKET_NORMAL),
+	ROHC_PKT_TYPES_16(ROHC_PACKET_NORMAL), ROHC_PKT_TYPES_16(ROHC_PACKET_NORMAL),
+	ROHC_PKT_TYPES_16(ROHC_PACKET_NORMAL), ROHC_PKT_TYPES_16(ROHC_PACKET_NORMAL),
+	ROHC_PKT_TYPES_16(ROHC_PACKET_NORMAL), ROHC_PKT_TYPES_16(ROHC_PACKET_NORMAL),
+	ROHC_PKT_TYPES_16(ROHC_PACKET_NORMAL),
+	ROHC_PKT_TYPES_8(ROHC_PACKET_NORMAL),
+	ROHC_PACKET_NORMAL, ROHC_PACKET_NORMAL, ROHC_PACKET_NORMAL, ROHC_PACKET_NORMAL,
+	ROHC_PACKET_IR, ROHC_PACKET_IR, /* 0xfc-0xfd */
+	ROHC_PACKET_NORMAL, ROHC_PACKET_NORMAL
+};
+
+/** The packet types of the TCP profile with a sequential innermost IP-ID */
+const uint8_t rohc_decomp_pkt_types_tcp_seq[ROHC_DECOMP_PKT_TYPES_NR] =
+{
+	ROHC_PKT_TYPES_TCP(ROHC_PACKET_TCP_SEQ_4, ROHC_PACKET_TCP_SEQ_5,
+	                   ROHC_PACKET_TCP_SEQ_3, ROHC_PACKET_TCP_SEQ_1,
+	                   ROHC_PACKET_TCP_SEQ_8, ROHC_PACKET_TCP_SEQ_8,
+	                   ROHC_PACKET_TCP_SEQ_8, ROHC_PACKET_TCP_SEQ_7,
+	                   ROHC_PACKET_TCP_SEQ_2, ROHC_PACKET_TCP_SEQ_6,
+	                   ROHC_PACKET_TCP_CO_COMMON)
+};
+
+/** The packet types of the TCP profile with a non-sequential innermost IP-ID */
+const uint8_t rohc_decomp_pkt_types_tcp_rnd[ROHC_DECOMP_PKT_TYPES_NR] =
+{
+	ROHC_PKT_TYPES_TCP(ROHC_PACKET_TCP_RND_3, ROHC_PACKET_TCP_RND_5,
+	                   ROHC_PACKET_TCP_RND_5, ROHC_PACKET_TCP_RND_6,
+	                   ROHC_PACKET_TCP_RND_8, ROHC_PACKET_TCP_RND_1,
+	                   ROHC_PACKET_TCP_RND_7, ROHC_PACKET_TCP_RND_2,
+	                   ROHC_PACKET_TCP_RND_4, ROHC_PACKET_TCP_RND_4,
+	                   ROHC_PACKET_TCP_CO_COMMON)
+};
+
+/** The packet types of the TCP profile before the context is initialized */
+const uint8_t rohc_decomp_pkt_types_tcp_ir[ROHC_DECOMP_PKT_TYPES_NR] =
+{
+	ROHC_PKT_TYPES_TCP(ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN,
+	                   ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN,
+	                   ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN,
+	                   ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN,
+	                   ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN,
+	                   ROHC_PACKET_UNKNOWN)
+};
 
 /**
- * @brief Find out whether a ROHC packet is an IR packet or not
+ * @brief The packet types of the ROHCv2 IP-only profile
  *
- * @param data  The ROHC packet to analyze
- * @param len   The length of the ROHC packet
- * @return      Whether the ROHC packet is an IR packet or not
+ * See RFC 5225, §6.8.2: the IR-DYN and IR-CR packets do not exist in ROHCv2.
  */
-bool rohc_decomp_packet_is_ir(const uint8_t *const data, const size_t len)
+const uint8_t rohc_decomp_pkt_types_rfc5225_ip[ROHC_DECOMP_PKT_TYPES_NR] =
 {
-	return (len > 0 && GET_BIT_1_7(data) == D_IR_PACKET);
-}
+	ROHC_PKT_TYPES_16(ROHC_PACKET_PT_0_CRC3),         /* 0x00-0x0f */
+	ROHC_PKT_TYPES_16(ROHC_PACKET_PT_0_CRC3),         /* 0x10-0x1f */
+	ROHC_PKT_TYPES_16(ROHC_PACKET_PT_0_CRC3),         /* 0x20-0x2f */
+	ROHC_PKT_TYPES_16(ROHC_PACKET_PT_0_CRC3),         /* 0x30-0x3f */
+	ROHC_PKT_TYPES_16(ROHC_PACKET_PT_0_CRC3),         /* 0x40-0x4f */
+	ROHC_PKT_TYPES_16(ROHC_PACKET_PT_0_CRC3),         /* 0x50-0x5f */
+	ROHC_PKT_TYPES_16(ROHC_PACKET_PT_0_CRC3),         /* 0x60-0x6f */
+	ROHC_PKT_TYPES_16(ROHC_PACKET_PT_0_CRC3),         /* 0x70-0x7f */
+	ROHC_PKT_TYPES_16(ROHC_PACKET_NORTP_PT_0_CRC7),   /* 0x80-0x8f */
+	ROHC_PKT_TYPES_16(ROHC_PACKET_NORTP_PT_0_CRC7),   /* 0x90-0x9f */
+	ROHC_PKT_TYPES_16(ROHC_PACKET_NORTP_PT_1_SEQ_ID), /* 0xa0-0xaf */
+	ROHC_PKT_TYPES_16(ROHC_PACKET_NORTP_PT_1_SEQ_ID), /* 0xb0-0xbf */
+	ROHC_PKT_TYPES_16(ROHC_PACKET_NORTP_PT_2_SEQ_ID), /* 0xc0-0xcf */
+	ROHC_PKT_TYPES_16(ROHC_PACKET_NORTP_PT_2_SEQ_ID), /* 0xd0-0xdf */
+	ROHC_PKT_TYPES_16(ROHC_PACKET_UNKNOWN),           /* 0xe0-0xef */
+	ROHC_PKT_TYPES_8(ROHC_PACKET_UNKNOWN),            /* 0xf0-0xf7 */
+	ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN,         /* 0xf8-0xf9 */
+	ROHC_PACKET_CO_COMMON,                            /* 0xfa */
+	ROHC_PACKET_CO_REPAIR,                            /* 0xfb */
+	ROHC_PACKET_UNKNOWN,                              /* 0xfc */
+	ROHC_PACKET_IR,                                   /* 0xfd */
+	ROHC_PACKET_UNKNOWN, ROHC_PACKET_UNKNOWN          /* 0xfe-0xff */
+};
 
 
 /**
- * @brief Find out whether a ROHC packet is an IR-DYN packet or not
+ * @brief Find out whether the field is a segment field or not
  *
- * @param data  The ROHC packet to analyze
- * @param len   The length of the ROHC packet
- * @return      Whether the ROHC packet is an IR-DYN packet or not
+ * @param data The field to analyze
+ * @return     Whether the field is a segment field or not
  */
-bool rohc_decomp_packet_is_irdyn(const uint8_t *const data, const size_t len)
+bool rohc_decomp_packet_is_segment(const uint8_t *const data)
 {
-	return (len > 0 && GET_BIT_0_7(data) == D_IR_DYN_PACKET);
+	return (GET_BIT_1_7(data) == D_SEGMENT);
 }
 
 
 /**
- * @brief Find out whether a ROHC packet is an UO-0 packet or not
+ * @brief Find out whether the field is a padding field or not
  *
- * @param data  The ROHC packet to analyze
- * @param len   The length of the ROHC packet
- * @return      Whether the ROHC packet is an UO-0 packet or not
+ * @param data The field to analyze
+ * @return     Whether the field is a padding field or not
  */
-bool rohc_decomp_packet_is_uo0(const uint8_t *const data, const size_t len)
+bool rohc_decomp_packet_is_padding(const uint8_t *const data)
 {
-	return (len > 0 && GET_BIT_7(data) == 0);
+	return (GET_BIT_0_7(data) == D_PADDING);
 }
 
 
 /**
- * @brief Find out whether a ROHC packet is an UO-1* packet or not
+ * @brief Get the number of padding bytes at the beginning of the given data
  *
- * @param data  The ROHC packet to analyze
- * @param len   The length of the ROHC packet
- * @return      Whether the ROHC packet is an UO-1* packet or not
+ * The bytes are compared with the padding byte 8 at a time.
+ *
+ * @param data  The data to analyze
+ * @param len   The length of the data
+ * @return      The number of padding bytes
  */
-bool rohc_decomp_packet_is_uo1(const uint8_t *const data, const size_t len)
+size_t rohc_decomp_padding_len(const uint8_t *const data, const size_t len)
 {
-	return (len > 0 && GET_BIT_6_7(data) == 0x02);
+	size_t padding_len = 0;
+
+	while((len - padding_len) >= sizeof(uint64_t))
+	{
+		const uint64_t diff = rohc_bit_load_be64(data + padding_len) ^ D_PADDING_WORD;
+		if(diff != 0)
+		{
+			/* the first byte of the 8 bytes is the most significant one */
+			return (padding_len + __builtin_clzll(diff) / 8);
+		}
+		padding_len += sizeof(uint64_t);
+	}
+	while(padding_len < len && rohc_decomp_packet_is_padding(data + padding_len))
+	{
+		padding_len++;
+	}
+
+	return padding_len;
 }
 
 
 /**
- * @brief Find out whether a ROHC packet is an UO-1-TS packet or not
- *
- * Check the T field that discriminates between UO-1-TS and UO-1-ID.
+ * @brief Find out whether a ROHC packet is an IR packet or not
  *
  * @param data  The ROHC packet to analyze
  * @param len   The length of the ROHC packet
- * @return      Whether the ROHC packet is an UO-1-TS packet or not
+ * @return      Whether the ROHC packet is an IR packet or not
  */
-bool rohc_decomp_packet_is_uo1_ts(const uint8_t *const data, const size_t len)
+bool rohc_decomp_packet_is_ir(const uint8_t *const data, const size_t len)
 {
-	return (len > 0 && GET_BIT_5(data) != 0);
+	return (len > 0 && GET_BIT_1_7(data) == D_IR_PACKET);
 }
 
 
 /**
- * @brief Find out whether a ROHC packet is an UOR-2* packet or not
+ * @brief Find out whether a ROHC packet is an IR-DYN packet or not
  *
  * @param data  The ROHC packet to analyze
  * @param len   The length of the ROHC packet
- * @return      Whether the ROHC packet is an UOR-2* packet or not
+ * @return      Whether the ROHC packet is an IR-DYN packet or not
  */
-bool rohc_decomp_packet_is_uor2(const uint8_t *const data, const size_t len)
+bool rohc_decomp_packet_is_irdyn(const uint8_t *const data, const size_t len)
 {
-	return (len > 0 && GET_BIT_5_7(data) == 0x06);
+	return (len > 0 && GET_BIT_0_7(data) == D_IR_DYN_PACKET);
 }
 
 
@@ -35,6 +35,40 @@
 #  include <stdbool.h>
 #endif
 
+#include "rohc_packets.h"
+
+
+/** The number of entries of the tables of packet types: one per first byte */
+#define ROHC_DECOMP_PKT_TYPES_NR  256U
+
+/**
+ * @brief The packet type of the first bytes that are not enough to detect
+ *        the packet type
+ *
+ * The profile shall inspect the next bytes of the packet.
+ */
+#define ROHC_DECOMP_PKT_MORE  ROHC_PACKET_MAX
+
+
+/*
+ * The tables of packet types indexed by the first byte of the ROHC packets
+ * (after the Add-CID octet). They replace the chains of packet predicates:
+ * the profiles pick the table that matches their context, then detect the
+ * packet type with one load.
+ */
+
+extern const uint8_t rohc_decomp_pkt_types_ip[ROHC_DECOMP_PKT_TYPES_NR];
+extern const uint8_t rohc_decomp_pkt_types_rtp[ROHC_DECOMP_PKT_TYPES_NR];
+extern const uint8_t rohc_decomp_pkt_types_rtp_ipv4[ROHC_DECOMP_PKT_TYPES_NR];
+extern const uint8_t rohc_decomp_pkt_types_ip_r[ROHC_DECOMP_PKT_TYPES_NR];
+extern const uint8_t rohc_decomp_pkt_types_rtp_r[ROHC_DECOMP_PKT_TYPES_NR];
+extern const uint8_t rohc_decomp_pkt_types_rtp_ipv4_r[ROHC_DECOMP_PKT_TYPES_NR];
+extern const uint8_t rohc_decomp_pkt_types_uncomp[ROHC_DECOMP_PKT_TYPES_NR];
+extern const uint8_t rohc_decomp_pkt_types_tcp_seq[ROHC_DECOMP_PKT_TYPES_NR];
+extern const uint8_t rohc_decomp_pkt_types_tcp_rnd[ROHC_DECOMP_PKT_TYPES_NR];
+extern const uint8_t rohc_decomp_pkt_types_tcp_ir[ROHC_DECOMP_PKT_TYPES_NR];
+extern const uint8_t rohc_decomp_pkt_types_rfc5225_ip[ROHC_DECOMP_PKT_TYPES_NR];
+
 
 /*
  * Function prototypes.
@@ -45,6 +79,8 @@ bool rohc_decomp_packet_is_segment(const uint8_t *const data)
 	__attribute__((warn_unused_result, nonnull(1), pure));
 bool rohc_decomp_packet_is_padding(const uint8_t *const data)
 	__attribute__((warn_unused_result, nonnull(1), pure));
+size_t rohc_decomp_padding_len(const uint8_t *const data, const size_t len)
+	__attribute__((warn_unused_result, nonnull(1), pure));
 
 /* IR packet */
 bool rohc_decomp_packet_is_ir(const uint8_t *const data, const size_t len)
@@ -54,23 +90,30 @@ bool rohc_decomp_packet_is_ir(const uint8_t *const data, const size_t len)
 bool rohc_decomp_packet_is_irdyn(const uint8_t *const data, const size_t len)
 	__attribute__((warn_unused_result, nonnull(1), pure));
 
-/* UO-0 packet */
-bool rohc_decomp_packet_is_uo0(const uint8_t *const data, const size_t len)
-	__attribute__((warn_unused_result, nonnull(1), pure));
-
-/* UO-1* packets */
-bool rohc_decomp_packet_is_uo1(const uint8_t *const data, const size_t len)
-	__attribute__((warn_unused_result, nonnull(1), pure));
-bool rohc_decomp_packet_is_uo1_ts(const uint8_t *const data, const size_t len)
-	__attribute__((warn_unused_result, nonnull(1), pure));
-
 /* UOR-2* packets */
-bool rohc_decomp_packet_is_uor2(const uint8_t *const data, const size_t len)
-	__attribute__((warn_unused_result, nonnull(1), pure));
 bool rohc_decomp_packet_is_uor2_ts(const uint8_t *const data,
                                    const size_t data_len,
                                    const size_t large_cid_len)
 	__attribute__((warn_unused_result, nonnull(1), pure));
 
+static inline rohc_packet_t rohc_decomp_pkt_type(const uint8_t *const types,
+                                                 const uint8_t first_byte)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+
+/**
+ * @brief Detect the type of a ROHC packet from its first byte
+ *
+ * @param types       The table of packet types of the profile
+ * @param first_byte  The first byte of the ROHC packet (after Add-CID)
+ * @return            The packet type, \ref ROHC_DECOMP_PKT_MORE if the next
+ *                    bytes of the packet are required
+ */
+static inline rohc_packet_t rohc_decomp_pkt_type(const uint8_t *const types,
+                                                 const uint8_t first_byte)
+{
+	return (rohc_packet_t) types[first_byte];
+}
+
 #endif
 
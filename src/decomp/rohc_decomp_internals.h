@@ -30,8 +30,14 @@
 #include "rohc_internal.h"
 #include "rohc_decomp.h"
 #include "rohc_traces_internal.h"
+#include "rohc_perf_internal.h"
 #include "feedback_create.h"
 #include "crc.h"
+#include "rohc_slab.h"
+#include "rohc_intern.h"
+#include "rohc_seqlock.h"
+
+#include "config.h" /* for ROHC_BUILD_PROFILE_* */
 
 
 /*
@@ -39,8 +45,60 @@
  */
 
 
-/** The number of ROHC profiles ready to be used */
-#define D_NUM_PROFILES 7U
+/** The number of ROHC profiles ready to be used: the IP-only (v1 and v2),
+ *  UDP, RTP and Uncompressed profiles are always built, the other ones may
+ *  be disabled at build time */
+#define D_NUM_PROFILES \
+	(5U + ROHC_BUILD_PROFILE_UDPLITE + ROHC_BUILD_PROFILE_ESP + \
+	 ROHC_BUILD_PROFILE_TCP)
+
+/** The number of decompression contexts allocated together in one page */
+#define ROHC_DECOMP_CTXT_PAGE_LEN  64U
+
+/** The number of packets a burst looks ahead of the packet being
+ *  decompressed, so that the context of the packet is prefetched in 2 steps:
+ *  first the context itself, then the persistent data it points to */
+#define ROHC_DECOMP_BURST_AHEAD  2U
+
+/** The number of packets of a burst that are grouped by context, see
+ *  \ref ROHC_DECOMP_FEATURE_BURST_GROUPING */
+#define ROHC_DECOMP_BURST_GROUP  16U
+
+/** The maximum number of feedback items piggybacked in front of one ROHC
+ *  packet: the compressor of the library piggybacks up to 16 of them, more
+ *  items are most probably crafted to make the decompressor spin, so the
+ *  packet is rejected as malformed */
+#define ROHC_DECOMP_FEEDBACK_ITEMS_MAX  64U
+
+/** The length of the buffer the description of one provisioned context is
+ *  decoded in: the uncompressed headers fit in the largest IP packet */
+#define ROHC_DECOMP_PROVISION_BUF_LEN  0xffffU
+
+/** All the features supported by the decompressor */
+#define ROHC_DECOMP_FEATURES_ALL \
+	(ROHC_DECOMP_FEATURE_CRC_REPAIR | \
+	 ROHC_DECOMP_FEATURE_DUMP_PACKETS | \
+	 ROHC_DECOMP_FEATURE_COALESCE_FEEDBACK | \
+	 ROHC_DECOMP_FEATURE_FLIGHT_RECORDER | \
+	 ROHC_DECOMP_FEATURE_BURST_GROUPING)
+
+/** The type of CID of the given decompressor, a compile-time constant if the
+ *  library is built for one type of CID only */
+#ifdef ROHC_FIXED_CID_TYPE
+#  define d_cid_type(decomp) \
+	((void) (decomp), (rohc_cid_type_t) (ROHC_FIXED_CID_TYPE))
+#else
+#  define d_cid_type(decomp)  ((decomp)->medium.cid_type)
+#endif
+
+/** The features of the given decompressor, a compile-time constant if the
+ *  library is built for one set of decompression features only */
+#ifdef ROHC_FIXED_DECOMP_FEATURES
+#  define d_features(decomp) \
+	((void) (decomp), (rohc_decomp_features_t) (ROHC_FIXED_DECOMP_FEATURES))
+#else
+#  define d_features(decomp)  ((decomp)->features)
+#endif
 
 
 /** Print a warning trace for the given decompression context */
@@ -58,7 +116,7 @@
 /** Dump a buffer for the given compression context */
 #define rohc_decomp_dump_buf(context, descr, buf, buf_len) \
 	do { \
-		if(((context)->decompressor->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0) { \
+		if((d_features((context)->decompressor) & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0) { \
 			rohc_dump_buf((context)->decompressor->trace_callback, \
 			              (context)->decompressor->trace_callback_priv, \
 			              ROHC_TRACE_DECOMP, ROHC_TRACE_DEBUG, \
@@ -99,6 +157,21 @@ struct d_statistics
 	/** The cumulative number of successful corrections of incorrect SN updates
 	 *  upon CRC failure */
 	unsigned long corrected_wrong_sn_updates;
+
+	/** The number of positive feedbacks (ACK) built */
+	unsigned long feedbacks_ack;
+	/** The number of negative feedbacks (NACK and STATIC-NACK) built */
+	unsigned long feedbacks_nack;
+
+	/** The cumulative number of corrections attempted upon CRC failure */
+	unsigned long crc_repairs;
+
+	/** The number of times the decompressor entered the overload mode */
+	unsigned long overloads;
+	/** The number of packets decompressed in overload mode */
+	unsigned long overload_pkts;
+	/** The number of positive feedbacks (ACK) deferred in overload mode */
+	unsigned long overload_acks;
 };
 
 
@@ -125,6 +198,11 @@ struct rohc_ack_rate_limits
 	struct rohc_ack_rate_limit nack;
 	/** The rate-limit parameters to avoid sending STATIC-NACKs too quickly */
 	struct rohc_ack_rate_limit static_nack;
+	/** The max bytes of feedback per second for the whole decompressor,
+	 *  0 for no limit */
+	size_t decomp_byte_rate;
+	/** The max bytes of feedback per second for every context, 0 for no limit */
+	size_t ctxt_byte_rate;
 };
 
 
@@ -136,29 +214,93 @@ struct rohc_ack_stats
 };
 
 
+/**
+ * @brief The token bucket that limits the bytes of feedback per second
+ *
+ * The bucket is refilled with the arrival times of the ROHC packets. Tokens
+ * are counted in millionths of bytes, so that the frequent refills with a
+ * few microseconds of elapsed time do not lose any token.
+ */
+struct rohc_feedback_bucket
+{
+	uint64_t tokens;              /**< The available millionths of bytes */
+	struct rohc_ts last_refill;   /**< The time of the last refill */
+};
+
+
 /**
  * @brief The ROHC decompressor
  */
 struct rohc_decomp
 {
+	/* variables used for every packet, keep them together at the beginning
+	 * of the structure so that they share the same cache lines */
+
 	/** The medium associated with the decompressor */
 	struct rohc_medium medium;
 
 	/** Enabled/disabled features for the decompressor */
 	rohc_decomp_features_t features;
 
-	/** Which profiles are enabled and with one are not? */
-	bool enabled_profiles[D_NUM_PROFILES];
+	/** The callback function used to manage traces */
+	rohc_trace_callback2_t trace_callback;
+	/** The private context of the callback function used to manage traces */
+	void *trace_callback_priv;
+	/** The ring of binary trace records, NULL if disabled */
+	struct rohc_trace_ring *trace_ring;
+	/** The mask of the events recorded in the ring of binary trace records */
+	uint32_t trace_events;
+	/** The filter that restricts the text traces to some contexts */
+	struct rohc_trace_filter trace_filter;
+	/** The callback that receives the recorded packets of damaged contexts */
+	rohc_decomp_flight_cb_t flight_cb;
+	/** The private context of the callback for the recorded packets */
+	void *flight_cb_priv;
 
 	/** The operation mode that the contexts shall target */
 	rohc_mode_t target_mode;
 
-	/** The array of decompression contexts that use the decompressor */
-	struct rohc_decomp_ctxt **contexts;
-	/** The number of decompression contexts in use */
+	/** The pages of decompression contexts that use the decompressor: context
+	 *  with CID x is stored in page x / ROHC_DECOMP_CTXT_PAGE_LEN, pages are
+	 *  allocated the first time one of their CIDs is used */
+	struct rohc_decomp_ctxt **ctxt_pages;
+	/** The number of pages of decompression contexts */
+	size_t ctxt_pages_nr;
+	/** The number of decompression contexts in use, see \e stats_seq */
 	size_t num_contexts_used;
+	/** The number of bytes of the pages of contexts */
+	size_t ctxts_mem_len;
+	/** The maximum number of bytes the decompressor should use, 0 for no
+	 *  limit */
+	size_t mem_budget;
+	/** The load beyond which the decompressor sheds work, see
+	 *  \ref rohc_decomp_set_overload */
+	struct rohc_load overload_limits;
+	/** Whether the latest load given by the user exceeds the limits */
+	bool is_overloaded;
 	/** The last decompression context used by the decompressor */
 	struct rohc_decomp_ctxt *last_context;
+	/** The most recently used context, head of the LRU list of contexts */
+	struct rohc_decomp_ctxt *lru_first;
+	/** The least recently used context, tail of the LRU list of contexts */
+	struct rohc_decomp_ctxt *lru_last;
+	/** The number of seconds a context may stay unused before it is
+	 *  destroyed, 0 if contexts never expire */
+	size_t ctxt_idle_timeout;
+
+	/** The sequence number that protects the statistics: every packet is
+	 *  decompressed between rohc_seqlock_write_begin() and
+	 *  rohc_seqlock_write_end(), so that another thread may read the
+	 *  statistics while the decompressor runs */
+	uint32_t stats_seq;
+	/** Some statistics about the decompression processes */
+	struct d_statistics stats;
+	/** The information about the last decompressed packet, copied from its
+	 *  context once the packet is decompressed */
+	rohc_decomp_last_packet_info_t last_pkt_info;
+	/** Whether \e last_pkt_info is valid, ie. the last packet was
+	 *  decompressed successfully and its context still exists */
+	bool has_last_pkt_info;
 
 
 	/* feedback-related variables */
@@ -167,43 +309,84 @@ struct rohc_decomp
 	size_t prtt;
 	/** The minimum number of SN bits to transmit in feedbacks */
 	size_t sn_feedback_min_bits;
+/** The largest reorder window, see \ref rohc_decomp_set_reorder_window */
+#define ROHC_DECOMP_REORDER_WINDOW_MAX  64U
+	/** The number of packets a late packet may be behind the newest one,
+	 *  0 to disable the tolerance to reordering */
+	size_t reorder_window;
 	/** The configuration for feedback rate-limiting */
 	struct rohc_ack_rate_limits ack_rate_limits;
 	/** Whether the last decompressed packets failed or not */
 	uint32_t last_pkts_errors;
 	/** The informations for feedback rate-limiting */
 	struct rohc_ack_stats last_pkt_feedbacks[ROHC_FEEDBACK_RESERVED];
+	/** The token bucket that limits the feedback of the decompressor */
+	struct rohc_feedback_bucket feedback_bucket;
+
+
+	/* variables used only when contexts are created or destroyed */
+
+	/** Which profiles are enabled and with one are not? */
+	bool enabled_profiles[D_NUM_PROFILES];
+
+	/** The context that an IR packet is decompressed in when its CID is
+	 *  already in use: it replaces the context of the CID only if the IR
+	 *  packet is successfully decompressed */
+	struct rohc_decomp_ctxt *spare_ctxt;
+
+	/** The slab the profile-specific parts of the contexts are allocated
+	 *  from, the blocks of the contexts replaced by new IR packets are kept
+	 *  for the next contexts: the own slab of the decompressor, or the slab
+	 *  shared by all the channels of an engine */
+	struct rohc_slab *ctxt_slab;
+	/** The static header fragments shared by the contexts, eg. the IPv6
+	 *  addresses of the TCP contexts: the own store of the decompressor, or
+	 *  the store shared by all the channels of an engine */
+	struct rohc_intern *static_store;
+	/** The engine the decompressor is one channel of, NULL if none */
+	struct rohc_decomp_engine *engine;
+	/** The slab of the decompressor when it is not a channel of an engine */
+	struct rohc_slab ctxt_slab_own;
+	/** The store of the decompressor when it is not a channel of an engine */
+	struct rohc_intern static_store_own;
+
+	/** The functions all the memory of the decompressor is allocated with */
+	struct rohc_mem_ops mem_ops;
+
+	/** The runtime configuration published by another thread and not taken
+	 *  by the decompressor yet, NULL if none, see
+	 *  \ref rohc_decomp_publish_cfg */
+	struct rohc_decomp_cfg *cfg_pending;
 
 
 	/* segment-related variables */
 
 /** The maximal value for MRRU */
 #define ROHC_MAX_MRRU 65535
-	/** The Reconstructed Reception Unit */
-	uint8_t rru[ROHC_MAX_MRRU];
+	/** The Reconstructed Reception Unit, allocated with MRRU bytes only when
+	 *  a non-zero MRRU is set */
+	uint8_t *rru;
 	/** The length (in bytes) of the Reconstructed Reception Unit */
 	size_t rru_len;
+	/** The FCS-32 of the first \e rru_crc_len bytes of the RRU, computed
+	 *  while the segments are received */
+	uint32_t rru_crc;
+	/** The number of bytes of the RRU covered by \e rru_crc: the last 4
+	 *  bytes received may be the FCS-32 of the RRU, so they are not covered */
+	size_t rru_crc_len;
 	/** The Maximum Reconstructed Reception Unit (MRRU) */
 	size_t mrru;
 
-
-	/* CRC-related variables: */
-
-	/** The table to enable fast CRC-3 computation */
-	uint8_t crc_table_3[256];
-	/** The table to enable fast CRC-7 computation */
-	uint8_t crc_table_7[256];
-	/** The table to enable fast CRC-8 computation */
-	uint8_t crc_table_8[256];
-
-
-	/** Some statistics about the decompression processes */
-	struct d_statistics stats;
-
-	/** The callback function used to manage traces */
-	rohc_trace_callback2_t trace_callback;
-	/** The private context of the callback function used to manage traces */
-	void *trace_callback_priv;
+#if ROHC_PERF_STATS == 1
+	/* performance-related variables */
+	struct
+	{
+		/** The durations of the decompression stages */
+		struct rohc_decomp_perf_stats stats;
+		/** The beginning of the decompression stages being measured */
+		uint64_t begin[ROHC_DECOMP_PERF_STAGE_MAX];
+	} perf;
+#endif
 };
 
 
@@ -215,6 +398,8 @@ typedef enum
 	ROHC_DECOMP_CRC_CORR_SN_NONE    = 0, /**< No correction */
 	ROHC_DECOMP_CRC_CORR_SN_WRAP    = 1, /**< Correction of SN wraparound */
 	ROHC_DECOMP_CRC_CORR_SN_UPDATES = 2, /**< Correction of incorrect SN updates */
+	ROHC_DECOMP_CRC_CORR_SN_IN_ORDER = 3, /**< Interpretation of SN without
+	                                           the reorder window */
 
 } rohc_decomp_crc_corr_t;
 
@@ -226,6 +411,15 @@ struct rohc_decomp_crc_corr_ctxt
 	rohc_decomp_crc_corr_t algo;
 	/** Correction counter (see e and f in 5.3.2.2.4 of the RFC 3095) */
 	size_t counter;
+/** The maximum number of candidate corrections for one CRC failure */
+#define ROHC_DECOMP_CRC_CORR_CANDS_MAX  2U
+/** The maximum number of times the fields of one packet are decoded and its
+ *  headers built: the first attempt, then one per candidate correction */
+#define ROHC_DECOMP_DECODE_ATTEMPTS_MAX  (1U + ROHC_DECOMP_CRC_CORR_CANDS_MAX)
+	/** The candidate corrections not tried yet on the packet being repaired */
+	rohc_decomp_crc_corr_t cands[ROHC_DECOMP_CRC_CORR_CANDS_MAX];
+	/** The number of candidate corrections not tried yet */
+	size_t cands_nr;
 /** The number of last packets to record arrival times for */
 #define ROHC_MAX_ARRIVAL_TIMES  10U
 	/** The arrival times for the last packets */
@@ -243,6 +437,16 @@ struct rohc_decomp_crc
 	rohc_crc_type_t type;  /**< The type of CRC that protects the ROHC header */
 	uint8_t bits;          /**< The CRC bits found in ROHC header */
 	size_t bits_nr;        /**< The number of CRC bits found in ROHC header */
+
+	/** The length of the IR header up to the end of its static chain (Add-CID
+	 *  excluded), 0 if the header has no static chain */
+	size_t static_end;
+	/** Whether the static chain is the one of the last IR packet */
+	bool is_static_unchanged;
+	/** The CRC-8 of the IR header up to the end of its static chain */
+	uint8_t static_crc;
+	/** The first byte of the IR header, covered by \ref static_crc */
+	uint8_t static_type;
 };
 
 
@@ -265,6 +469,22 @@ struct rohc_decomp_volat_ctxt
 	/** The profile-specific data for values decoded from persistent context
 	 * and bits extracted from the ROHC packet, defined by the profiles */
 	void *decoded_values;
+
+	/** The arrival time of the ROHC packet being parsed, zero if unknown */
+	struct rohc_ts arrival_time;
+};
+
+
+/** The flight recorder of one decompression context */
+struct rohc_decomp_flight
+{
+	/** The number of recorded packets */
+	size_t pkts_nr;
+	/** The index of the next packet to record */
+	size_t next;
+	/** The recorded packets, the oldest one at index next if all slots are
+	 *  used */
+	struct rohc_decomp_flight_pkt pkts[ROHC_DECOMP_FLIGHT_PKTS_NR];
 };
 
 
@@ -273,37 +493,66 @@ struct rohc_decomp_volat_ctxt
  */
 struct rohc_decomp_ctxt
 {
-	/** The Context IDentifier (CID) */
-	rohc_cid_t cid;
+	/* variables used for every packet, keep them together at the beginning
+	 * of the structure so that they share the same cache line */
 
-	/** The associated decompressor */
-	struct rohc_decomp *decompressor;
+	/** Whether the context is in use or not */
+	bool used;
+	/** The operation mode in which the context operates */
+	rohc_mode_t mode;
+	/** The operation state in which the context operates */
+	rohc_decomp_state_t state;
 
 	/** The associated profile */
 	const struct rohc_decomp_profile *profile;
 	/** The persistent profile-specific data, defined by the profiles */
 	void *persist_ctxt;
+
+	/** The Context IDentifier (CID) */
+	rohc_cid_t cid;
+
+	/** The associated decompressor */
+	struct rohc_decomp *decompressor;
+
 	/** The volatile data, erased between two ROHC packets */
 	struct rohc_decomp_volat_ctxt volat_ctxt;
 
-	/** The operation mode in which the context operates */
-	rohc_mode_t mode;
-	/** The operation state in which the context operates */
-	rohc_decomp_state_t state;
+	/** The time when the context was last used (in seconds) */
+	uint64_t latest_used;
+	/** The time when the context was created (in seconds) */
+	uint64_t first_used;
 
-	/** Usage timestamp */
-	unsigned int latest_used;
-	/** Usage timestamp */
-	unsigned int first_used;
+	/** The more recently used context in the LRU list of the decompressor */
+	struct rohc_decomp_ctxt *lru_prev;
+	/** The less recently used context in the LRU list of the decompressor */
+	struct rohc_decomp_ctxt *lru_next;
 
 	/** Whether the last decompressed packets failed or not */
 	uint32_t last_pkts_errors;
 	/** The informations for feedback rate-limiting */
 	struct rohc_ack_stats last_pkt_feedbacks[ROHC_FEEDBACK_RESERVED];
+	/** The token bucket that limits the feedback of the context */
+	struct rohc_feedback_bucket feedback_bucket;
+	/** The prebuilt FEEDBACK-2 packet of the context */
+	struct d_feedback_tmpl feedback_tmpl;
+	/** Whether an ACK was deferred because the decompressor was overloaded,
+	 *  it is sent with the first packet after the overload */
+	bool is_ack_deferred;
 
 	/** The context for corrections upon CRC failure */
 	struct rohc_decomp_crc_corr_ctxt crc_corr;
 
+	/** The last packets of the context, see
+	 *  \ref ROHC_DECOMP_FEATURE_FLIGHT_RECORDER: allocated the first time one
+	 *  packet is recorded, then kept with the memory of the context until the
+	 *  decompressor is destroyed */
+	struct rohc_decomp_flight *flight;
+
+	/** The CRC-8 of the last IR header up to the end of its static chain */
+	uint8_t ir_static_crc;
+	/** The first byte of the last IR header, covered by \ref ir_static_crc */
+	uint8_t ir_static_type;
+
 	/* below are some statistics */
 
 	/** The type of the last decompressed ROHC packet */
@@ -390,9 +639,23 @@ typedef bool (*rohc_decomp_attempt_repair_t)(const struct rohc_decomp *const dec
                                              void *const extr_bits)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 
+typedef bool (*rohc_decomp_decode_fast_t)(const struct rohc_decomp *const decomp,
+                                          const struct rohc_decomp_ctxt *const context,
+                                          const struct rohc_buf rohc_packet,
+                                          const size_t large_cid_len,
+                                          const rohc_packet_t packet_type,
+                                          void *const decoded_values,
+                                          struct rohc_buf *const uncomp_hdrs,
+                                          size_t *const rohc_hdr_len,
+                                          size_t *const uncomp_hdrs_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 6, 7, 8, 9)));
+
 typedef uint32_t (*rohc_decomp_get_sn_t)(const struct rohc_decomp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+typedef void (*rohc_decomp_prefetch_t)(const struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1)));
+
 
 /**
  * @brief The ROHC decompression profile.
@@ -436,7 +699,36 @@ struct rohc_decomp_profile
 
 	/* The handler used to retrieve the Sequence Number (SN) */
 	rohc_decomp_get_sn_t get_sn;
+
+	/* The handler used to parse, decode and build the most common packets
+	 * in one single step, may be NULL */
+	rohc_decomp_decode_fast_t decode_fast;
+
+	/* The handler used to prefetch the persistent data of the context before
+	 * the next packet of a burst is decompressed, may be NULL */
+	rohc_decomp_prefetch_t prefetch;
+
+	/* The handler used to bound the memory one context of the profile takes
+	 * in the memory block of a static decompressor */
+	size_t (*get_mem_max)(void) __attribute__((warn_unused_result));
 };
 
+
+const struct rohc_decomp_ctxt *
+	rohc_decomp_find_base_ctxt(const struct rohc_decomp_ctxt *const context,
+	                           const rohc_cid_t base_cid)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+void rohc_decomp_change_state(struct rohc_decomp_ctxt *const context,
+                              const rohc_decomp_state_t new_state)
+	__attribute__((nonnull(1)));
+
+void rohc_decomp_change_mode(struct rohc_decomp_ctxt *const context,
+                             const rohc_mode_t new_mode)
+	__attribute__((nonnull(1)));
+
+void rohc_decomp_engine_put(struct rohc_decomp_engine *const engine)
+	__attribute__((nonnull(1)));
+
 #endif
 
@@ -28,6 +28,7 @@
  */
 
 #include "rohc_decomp_rfc3095.h"
+#include "d_rtp.h"
 #include "rohc_traces_internal.h"
 #include "rohc_time_internal.h"
 #include "rohc_debug.h"
@@ -49,11 +50,34 @@
 #include <assert.h>
 
 
+/**
+ * @brief Call one profile-specific handler of the RFC3095-based context
+ *
+ * The IPv4/UDP/RTP contexts are the most common ones: their handlers are
+ * called directly rather than through the table of handlers of the profile,
+ * so that the hot path avoids the indirect branches. The handlers of the
+ * other contexts are called through the table of handlers.
+ *
+ * @param ctxt         The RFC3095-based context
+ * @param handler      The name of the handler in the table
+ * @param rtp_handler  The handler of the RTP profile
+ * @param ...          The arguments of the handler
+ */
+#define rohc_decomp_rfc3095_call(ctxt, handler, rtp_handler, ...) \
+	((ctxt)->is_ipv4_udp_rtp ? \
+	 rtp_handler(__VA_ARGS__) : (ctxt)->ops->handler(__VA_ARGS__))
+
+
 /*
  * Private function prototypes for parsing the static and dynamic parts
  * of the IR and IR-DYN headers
  */
 
+static int parse_static_chain(const struct rohc_decomp_ctxt *const context,
+                              const uint8_t *const rohc_data,
+                              const size_t rohc_len,
+                              struct rohc_extr_bits *const bits)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
 static int parse_static_part_ip(const struct rohc_decomp_ctxt *const context,
                                 const uint8_t *const packet,
                                 const size_t length,
@@ -88,6 +112,9 @@ static int parse_dynamic_part_ipv6(const struct rohc_decomp_ctxt *const context,
                                    struct list_decomp *const list_decomp)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5)));
 
+static bool d_inner_list_decomp_new(const struct rohc_decomp_ctxt *const context)
+	__attribute__((warn_unused_result, nonnull(1)));
+
 
 /*
  * Private function prototypes for parsing the different UO* headers
@@ -123,6 +150,26 @@ static bool parse_uo0(const struct rohc_decomp_ctxt *const context,
                       size_t *const rohc_hdr_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6, 7, 8)));
 
+static bool parse_r0(const struct rohc_decomp_ctxt *const context,
+                     const uint8_t *const rohc_packet,
+                     const size_t rohc_length,
+                     const size_t large_cid_len,
+                     rohc_packet_t *const packet_type,
+                     struct rohc_decomp_crc *const extr_crc,
+                     struct rohc_extr_bits *const bits,
+                     size_t *const rohc_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6, 7, 8)));
+
+static bool parse_r0crc(const struct rohc_decomp_ctxt *const context,
+                        const uint8_t *const rohc_packet,
+                        const size_t rohc_length,
+                        const size_t large_cid_len,
+                        rohc_packet_t *const packet_type,
+                        struct rohc_decomp_crc *const extr_crc,
+                        struct rohc_extr_bits *const bits,
+                        size_t *const rohc_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 5, 6, 7, 8)));
+
 static bool parse_uo1(const struct rohc_decomp_ctxt *const context,
                       const uint8_t *const rohc_packet,
                       const size_t rohc_length,
@@ -297,6 +344,21 @@ static bool build_uncomp_ipv6(const struct rohc_decomp_ctxt *const context,
                               const size_t payload_size,
                               const struct list_decomp *const list_decomp)
 	__attribute__((warn_unused_result, nonnull(1, 3, 5, 7)));
+static size_t build_uncomp_hdrs_from_tmpl(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                                          const struct rohc_decoded_values *const decoded,
+                                          const size_t payload_len,
+                                          uint8_t *const dest,
+                                          const size_t dest_max_len,
+                                          size_t *const ip_hdr_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4, 6)));
+static size_t patch_uncomp_ip_from_tmpl(uint8_t *const dest,
+                                        const struct rohc_decoded_ip_values *const ip_values,
+                                        const size_t ip_len)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool is_ip_tmpl_usable(const struct rohc_extr_ip_bits *const bits,
+                              const ip_version tmpl_version,
+                              const struct list_decomp *const list_decomp)
+	__attribute__((warn_unused_result, nonnull(1, 3), pure));
 
 
 /*
@@ -327,6 +389,12 @@ static bool check_uncomp_crc(const struct rohc_decomp *const decomp,
                              const rohc_crc_type_t crc_type,
                              const uint8_t crc_packet)
 	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+static uint8_t compute_uncomp_crc(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                                  const uint8_t *const outer_ip_hdr,
+                                  const uint8_t *const inner_ip_hdr,
+                                  const uint8_t *const next_header,
+                                  const rohc_crc_type_t crc_type)
+	__attribute__((warn_unused_result, nonnull(1, 2, 4)));
 
 static bool is_sn_wraparound(const struct rohc_ts cur_arrival_time,
                              const struct rohc_ts arrival_times[ROHC_MAX_ARRIVAL_TIMES],
@@ -336,6 +404,25 @@ static bool is_sn_wraparound(const struct rohc_ts cur_arrival_time,
                              const rohc_lsb_shift_t p)
 	__attribute__((warn_unused_result, pure));
 
+static size_t rfc3095_decomp_get_repair_cands(const struct rohc_decomp_ctxt *const context,
+                                              const struct rohc_ts pkt_arrival_time,
+                                              struct rohc_decomp_crc_corr_ctxt *const crc_corr,
+                                              const struct rohc_extr_bits *const extr_bits)
+	__attribute__((warn_unused_result, nonnull(1, 3, 4)));
+
+static uint32_t rfc3095_decomp_get_reorder_offset(const struct rohc_decomp_ctxt *const context,
+                                                  const size_t sn_nr)
+	__attribute__((warn_unused_result, nonnull(1), pure));
+
+static bool rfc3095_decomp_decode_sn(const struct rohc_decomp_ctxt *const context,
+                                     const rohc_lsb_ref_t ref_type,
+                                     const uint32_t ref_offset,
+                                     const uint32_t sn_bits,
+                                     const size_t sn_nr,
+                                     uint32_t *const sn,
+                                     bool *const is_late)
+	__attribute__((warn_unused_result, nonnull(1, 6, 7)));
+
 static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                             struct rohc_extr_bits *const bits)
 	__attribute__((nonnull(1, 2)));
@@ -353,6 +440,7 @@ static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095
  * framework to work.
  *
  * @param context            The decompression context
+ * @param ops                The profile-specific handlers of the context
  * @param[out] persist_ctxt  The persistent part of the decompression context
  * @param[out] volat_ctxt    The volatile part of the decompression context
  * @param trace_cb           The function to call for printing traces
@@ -362,16 +450,19 @@ static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095
  *                           created, false if a problem occurred
  */
 bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
+                                const struct rohc_decomp_rfc3095_ops *const ops,
                                 struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
                                 struct rohc_decomp_volat_ctxt *const volat_ctxt,
                                 rohc_trace_callback2_t trace_cb,
                                 void *const trace_cb_priv,
                                 const int profile_id)
 {
+	struct rohc_slab *const slab = context->decompressor->ctxt_slab;
 	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
 
 	/* allocate memory for the generic context */
-	*persist_ctxt = malloc(sizeof(struct rohc_decomp_rfc3095_ctxt));
+	*persist_ctxt =
+		rohc_slab_alloc(slab, sizeof(struct rohc_decomp_rfc3095_ctxt));
 	if((*persist_ctxt) == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -382,7 +473,7 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	memset(rfc3095_ctxt, 0, sizeof(struct rohc_decomp_rfc3095_ctxt));
 
 	/* create the Offset IP-ID decoding context for outer IP header */
-	rfc3095_ctxt->outer_ip_id_offset_ctxt = ip_id_offset_new();
+	rfc3095_ctxt->outer_ip_id_offset_ctxt = ip_id_offset_new(slab);
 	if(rfc3095_ctxt->outer_ip_id_offset_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -392,7 +483,7 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* create the Offset IP-ID decoding context for inner IP header */
-	rfc3095_ctxt->inner_ip_id_offset_ctxt = ip_id_offset_new();
+	rfc3095_ctxt->inner_ip_id_offset_ctxt = ip_id_offset_new(slab);
 	if(rfc3095_ctxt->inner_ip_id_offset_ctxt == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -401,7 +492,8 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 		goto free_outer_ip_id_offset_ctxt;
 	}
 
-	rfc3095_ctxt->outer_ip_changes = malloc(sizeof(struct rohc_decomp_rfc3095_changes));
+	rfc3095_ctxt->outer_ip_changes =
+		rohc_slab_alloc(slab, sizeof(struct rohc_decomp_rfc3095_changes));
 	if(rfc3095_ctxt->outer_ip_changes == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -410,7 +502,8 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	}
 	memset(rfc3095_ctxt->outer_ip_changes, 0, sizeof(struct rohc_decomp_rfc3095_changes));
 
-	rfc3095_ctxt->inner_ip_changes = malloc(sizeof(struct rohc_decomp_rfc3095_changes));
+	rfc3095_ctxt->inner_ip_changes =
+		rohc_slab_alloc(slab, sizeof(struct rohc_decomp_rfc3095_changes));
 	if(rfc3095_ctxt->inner_ip_changes == NULL)
 	{
 		rohc_error(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
@@ -420,30 +513,33 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	memset(rfc3095_ctxt->inner_ip_changes, 0, sizeof(struct rohc_decomp_rfc3095_changes));
 
 	/* init the context used to compress the list of IPv6 extension headers
-	 * for the outer and inner IP headers */
+	 * for the outer IP header, the one for the inner IP header is allocated
+	 * only once two IP headers are received, see \ref d_inner_list_decomp_new */
 	rohc_decomp_list_ipv6_new(&rfc3095_ctxt->list_decomp1,
 	                          trace_cb, trace_cb_priv, profile_id);
-	rohc_decomp_list_ipv6_new(&rfc3095_ctxt->list_decomp2,
-	                          trace_cb, trace_cb_priv, profile_id);
+	rfc3095_ctxt->list_decomp2 = NULL;
 
 	/* no default next header */
 	rfc3095_ctxt->next_header_proto = 0;
+	rfc3095_ctxt->is_ipv4_udp_rtp = false;
 
-	/* default CRC computation */
-	rfc3095_ctxt->compute_crc_static = compute_crc_static;
-	rfc3095_ctxt->compute_crc_dynamic = compute_crc_dynamic;
+	/* the profile-specific handlers */
+	rfc3095_ctxt->ops = ops;
+	crc_static_cache_init(&rfc3095_ctxt->crc_static_cache);
 
 	/* volatile part of the decompression context */
 	volat_ctxt->crc.type = ROHC_CRC_TYPE_NONE;
 	volat_ctxt->crc.bits_nr = 0;
-	volat_ctxt->extr_bits = malloc(sizeof(struct rohc_extr_bits));
+	volat_ctxt->extr_bits =
+		rohc_slab_alloc(slab, sizeof(struct rohc_extr_bits));
 	if(volat_ctxt->extr_bits == NULL)
 	{
 		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
 		                 "of one of the RFC3095 decompression context");
 		goto free_inner_ip_changes;
 	}
-	volat_ctxt->decoded_values = malloc(sizeof(struct rohc_decoded_values));
+	volat_ctxt->decoded_values =
+		rohc_slab_alloc(slab, sizeof(struct rohc_decoded_values));
 	if(volat_ctxt->decoded_values == NULL)
 	{
 		rohc_decomp_warn(context, "failed to allocate memory for the volatile part "
@@ -454,17 +550,17 @@ bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
 	return rfc3095_ctxt;
 
 free_extr_bits:
-	zfree(volat_ctxt->extr_bits);
+	rohc_slab_zfree(volat_ctxt->extr_bits);
 free_inner_ip_changes:
-	zfree(rfc3095_ctxt->inner_ip_changes);
+	rohc_slab_zfree(rfc3095_ctxt->inner_ip_changes);
 free_outer_ip_changes:
-	zfree(rfc3095_ctxt->outer_ip_changes);
+	rohc_slab_zfree(rfc3095_ctxt->outer_ip_changes);
 free_inner_ip_id_offset_ctxt:
 	ip_id_offset_free(rfc3095_ctxt->inner_ip_id_offset_ctxt);
 free_outer_ip_id_offset_ctxt:
 	ip_id_offset_free(rfc3095_ctxt->outer_ip_id_offset_ctxt);
 free_context:
-	zfree(rfc3095_ctxt);
+	rohc_slab_zfree(rfc3095_ctxt);
 quit:
 	return NULL;
 }
@@ -483,27 +579,51 @@ void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_
                                  const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 {
 	/* free the volatile part of the decompression context */
-	free(volat_ctxt->decoded_values);
-	free(volat_ctxt->extr_bits);
+	rohc_slab_free(volat_ctxt->decoded_values);
+	rohc_slab_free(volat_ctxt->extr_bits);
 
 	/* destroy Offset IP-ID decoding contexts */
 	ip_id_offset_free(rfc3095_ctxt->outer_ip_id_offset_ctxt);
 	ip_id_offset_free(rfc3095_ctxt->inner_ip_id_offset_ctxt);
 
 	/* destroy the information about the IP headers */
-	zfree(rfc3095_ctxt->outer_ip_changes);
-	zfree(rfc3095_ctxt->inner_ip_changes);
+	rohc_slab_zfree(rfc3095_ctxt->outer_ip_changes);
+	rohc_slab_zfree(rfc3095_ctxt->inner_ip_changes);
 
 	/* destroy contexts used to decompress the lists of IPv6 extension headers
 	 * for outer and inner IP headers */
 	rohc_decomp_list_ipv6_free(&rfc3095_ctxt->list_decomp1);
-	rohc_decomp_list_ipv6_free(&rfc3095_ctxt->list_decomp2);
+	if(rfc3095_ctxt->list_decomp2 != NULL)
+	{
+		rohc_decomp_list_ipv6_free(rfc3095_ctxt->list_decomp2);
+		rohc_slab_zfree(rfc3095_ctxt->list_decomp2);
+	}
 
 	/* destroy profile-specific part */
-	zfree(rfc3095_ctxt->specific);
+	rohc_slab_zfree(rfc3095_ctxt->specific);
 
 	/* destroy generic context itself */
-	free(rfc3095_ctxt);
+	rohc_slab_free(rfc3095_ctxt);
+}
+
+
+/**
+ * @brief Get the maximum length the generic part of one RFC3095-like
+ *        decompression context takes in a memory block
+ *
+ * The profile-specific part is not included.
+ *
+ * @return  The maximum number of bytes of the memory block the generic part
+ *          of the context takes, see \ref rohc_slab_block_mem_max
+ */
+size_t rohc_decomp_rfc3095_mem_max(void)
+{
+	return (rohc_slab_block_mem_max(sizeof(struct rohc_decomp_rfc3095_ctxt)) +
+	        2 * ip_id_offset_mem_max() +
+	        2 * rohc_slab_block_mem_max(sizeof(struct rohc_decomp_rfc3095_changes)) +
+	        rohc_slab_block_mem_max(sizeof(struct list_decomp)) +
+	        rohc_slab_block_mem_max(sizeof(struct rohc_extr_bits)) +
+	        rohc_slab_block_mem_max(sizeof(struct rohc_decoded_values)));
 }
 
 
@@ -524,6 +644,8 @@ void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_
  * @see parse_ir
  * @see parse_irdyn
  * @see parse_uo0
+ * @see parse_r0
+ * @see parse_r0crc
  * @see parse_uo1
  * @see parse_uo1rtp
  * @see parse_uo1id
@@ -577,6 +699,16 @@ bool rfc3095_decomp_parse_pkt(const struct rohc_decomp_ctxt *const context,
 			parse = parse_uo0;
 			break;
 		}
+		case ROHC_PACKET_R_0:
+		{
+			parse = parse_r0;
+			break;
+		}
+		case ROHC_PACKET_R_0_CRC:
+		{
+			parse = parse_r0crc;
+			break;
+		}
 		case ROHC_PACKET_UO_1:
 		{
 			parse = parse_uo1;
@@ -767,6 +899,167 @@ static bool parse_ir(const struct rohc_decomp_ctxt *const context,
 	rohc_remain_len--;
 	(*rohc_hdr_len)++;
 
+	/* decode the static chain, unless it is the one of the last IR packet:
+	 * the periodic IR refreshes are then parsed as IR-DYN packets, the static
+	 * fields being retrieved from context as for the IR-DYN packets */
+	if(rfc3095_ctxt->static_chain_len > 0 &&
+	   rohc_remain_len >= rfc3095_ctxt->static_chain_len &&
+	   memcmp(rohc_remain_data, rfc3095_ctxt->static_chain,
+	          rfc3095_ctxt->static_chain_len) == 0)
+	{
+		rohc_decomp_debug(context, "static chain of %u bytes is unchanged",
+		                  rfc3095_ctxt->static_chain_len);
+		size = rfc3095_ctxt->static_chain_len;
+		extr_crc->is_static_unchanged = true;
+	}
+	else
+	{
+		size = parse_static_chain(context, rohc_remain_data, rohc_remain_len, bits);
+		if(size == -1)
+		{
+			goto error;
+		}
+		bits->static_chain = rohc_remain_data;
+		bits->static_chain_len = size;
+		extr_crc->is_static_unchanged = false;
+	}
+	rohc_remain_data += size;
+	rohc_remain_len -= size;
+	*rohc_hdr_len += size;
+	extr_crc->static_end = *rohc_hdr_len;
+
+	/* the inner IP header requires its own list decompressor */
+	if(bits->multiple_ip && !d_inner_list_decomp_new(context))
+	{
+		goto error;
+	}
+
+	/* decode the dynamic part of the ROHC packet */
+	if(dynamic_present)
+	{
+		/* decode the dynamic part of the outer IP header */
+		size = parse_dynamic_part_ip(context, rohc_remain_data, rohc_remain_len,
+		                             &bits->outer_ip, &rfc3095_ctxt->list_decomp1);
+		if(size == -1)
+		{
+			rohc_decomp_warn(context, "cannot parse outer IP dynamic part");
+			goto error;
+		}
+		rohc_remain_data += size;
+		rohc_remain_len -= size;
+		*rohc_hdr_len += size;
+
+		/* decode the dynamic part of the inner IP header */
+		if(bits->multiple_ip)
+		{
+			size = parse_dynamic_part_ip(context, rohc_remain_data, rohc_remain_len,
+			                             &bits->inner_ip, rfc3095_ctxt->list_decomp2);
+			if(size == -1)
+			{
+				rohc_decomp_warn(context, "cannot parse inner IP dynamic part");
+				goto error;
+			}
+			rohc_remain_data += size;
+			rohc_remain_len -= size;
+			*rohc_hdr_len += size;
+		}
+
+		/* parse the dynamic part of the next header header if necessary */
+		if(rfc3095_ctxt->ops->parse_dyn_next_hdr != NULL)
+		{
+			size = rfc3095_ctxt->ops->parse_dyn_next_hdr(context, rohc_remain_data,
+			                                        rohc_remain_len, bits);
+			if(size == -1)
+			{
+				rohc_decomp_warn(context, "cannot parse next header dynamic part");
+				goto error;
+			}
+#ifndef __clang_analyzer__ /* silent warning about dead increment */
+			rohc_remain_data += size;
+			rohc_remain_len -= size;
+#endif
+			*rohc_hdr_len += size;
+		}
+	}
+	else if(context->state != ROHC_DECOMP_STATE_FC)
+	{
+		/* in 'Static Context' or 'No Context' state and the packet does not
+		 * contain a dynamic part */
+		rohc_decomp_warn(context, "receive IR packet without a dynamic part, "
+		                 "but not in Full Context state");
+		goto error;
+	}
+
+	/* sanity checks */
+	assert((*rohc_hdr_len) <= rohc_length);
+
+	/* IR packet was successfully parsed */
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Allocate the list decompressor of the inner IP header if not done yet
+ *
+ * The list decompressor is large because of its translation table, so it is
+ * not allocated for the contexts that never receive two IP headers.
+ *
+ * @param context  The decompression context
+ * @return         true if the list decompressor is available,
+ *                 false if it cannot be allocated
+ */
+static bool d_inner_list_decomp_new(const struct rohc_decomp_ctxt *const context)
+{
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+
+	if(rfc3095_ctxt->list_decomp2 != NULL)
+	{
+		return true;
+	}
+
+	rfc3095_ctxt->list_decomp2 =
+		rohc_slab_alloc(context->decompressor->ctxt_slab, sizeof(struct list_decomp));
+	if(rfc3095_ctxt->list_decomp2 == NULL)
+	{
+		rohc_decomp_warn(context, "cannot allocate memory for the list "
+		                 "decompressor of the inner IP header");
+		return false;
+	}
+	rohc_decomp_list_ipv6_new(rfc3095_ctxt->list_decomp2,
+	                          context->decompressor->trace_callback,
+	                          context->decompressor->trace_callback_priv,
+	                          context->profile->id);
+
+	return true;
+}
+
+
+/**
+ * @brief Parse the static chain of an IR packet
+ *
+ * See 5.7.7.3 to 5.7.7.7 in RFC 3095 for details.
+ *
+ * @param context     The decompression context
+ * @param rohc_data   The static chain to parse
+ * @param rohc_len    The length of the ROHC data to parse
+ * @param bits        OUT: The bits extracted from the static chain
+ * @return            The length of the static chain,
+ *                    -1 in case of failure
+ */
+static int parse_static_chain(const struct rohc_decomp_ctxt *const context,
+                              const uint8_t *const rohc_data,
+                              const size_t rohc_len,
+                              struct rohc_extr_bits *const bits)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt =
+		context->persist_ctxt;
+	const uint8_t *rohc_remain_data = rohc_data;
+	size_t rohc_remain_len = rohc_len;
+	int size;
+
 	/* decode the static part of the outer header */
 	size = parse_static_part_ip(context, rohc_remain_data, rohc_remain_len,
 	                            &bits->outer_ip);
@@ -777,7 +1070,6 @@ static bool parse_ir(const struct rohc_decomp_ctxt *const context,
 	}
 	rohc_remain_data += size;
 	rohc_remain_len -= size;
-	*rohc_hdr_len += size;
 
 	/* check for IP version switch during context re-use */
 	if(context->num_recv_packets >= 1 &&
@@ -804,6 +1096,11 @@ static bool parse_ir(const struct rohc_decomp_ctxt *const context,
 			bits->is_context_reused = true;
 		}
 
+		/* the inner IP bits were not reset for a single IP header context */
+		if(!bits->multiple_ip)
+		{
+			memset(&bits->inner_ip, 0, sizeof(struct rohc_extr_ip_bits));
+		}
 		bits->multiple_ip = true;
 	}
 	else
@@ -832,7 +1129,6 @@ static bool parse_ir(const struct rohc_decomp_ctxt *const context,
 		}
 		rohc_remain_data += size;
 		rohc_remain_len -= size;
-		*rohc_hdr_len += size;
 
 		/* check for IP version switch during context re-use */
 		if(context->num_recv_packets >= 1 &&
@@ -847,9 +1143,9 @@ static bool parse_ir(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* parse the static part of the next header header if necessary */
-	if(rfc3095_ctxt->parse_static_next_hdr != NULL)
+	if(rfc3095_ctxt->ops->parse_static_next_hdr != NULL)
 	{
-		size = rfc3095_ctxt->parse_static_next_hdr(context, rohc_remain_data,
+		size = rfc3095_ctxt->ops->parse_static_next_hdr(context, rohc_remain_data,
 		                                           rohc_remain_len, bits);
 		if(size == -1)
 		{
@@ -858,73 +1154,12 @@ static bool parse_ir(const struct rohc_decomp_ctxt *const context,
 		}
 		rohc_remain_data += size;
 		rohc_remain_len -= size;
-		*rohc_hdr_len += size;
-	}
-
-	/* decode the dynamic part of the ROHC packet */
-	if(dynamic_present)
-	{
-		/* decode the dynamic part of the outer IP header */
-		size = parse_dynamic_part_ip(context, rohc_remain_data, rohc_remain_len,
-		                             &bits->outer_ip, &rfc3095_ctxt->list_decomp1);
-		if(size == -1)
-		{
-			rohc_decomp_warn(context, "cannot parse outer IP dynamic part");
-			goto error;
-		}
-		rohc_remain_data += size;
-		rohc_remain_len -= size;
-		*rohc_hdr_len += size;
-
-		/* decode the dynamic part of the inner IP header */
-		if(bits->multiple_ip)
-		{
-			size = parse_dynamic_part_ip(context, rohc_remain_data, rohc_remain_len,
-			                             &bits->inner_ip, &rfc3095_ctxt->list_decomp2);
-			if(size == -1)
-			{
-				rohc_decomp_warn(context, "cannot parse inner IP dynamic part");
-				goto error;
-			}
-			rohc_remain_data += size;
-			rohc_remain_len -= size;
-			*rohc_hdr_len += size;
-		}
-
-		/* parse the dynamic part of the next header header if necessary */
-		if(rfc3095_ctxt->parse_dyn_next_hdr != NULL)
-		{
-			size = rfc3095_ctxt->parse_dyn_next_hdr(context, rohc_remain_data,
-			                                        rohc_remain_len, bits);
-			if(size == -1)
-			{
-				rohc_decomp_warn(context, "cannot parse next header dynamic part");
-				goto error;
-			}
-#ifndef __clang_analyzer__ /* silent warning about dead increment */
-			rohc_remain_data += size;
-			rohc_remain_len -= size;
-#endif
-			*rohc_hdr_len += size;
-		}
-	}
-	else if(context->state != ROHC_DECOMP_STATE_FC)
-	{
-		/* in 'Static Context' or 'No Context' state and the packet does not
-		 * contain a dynamic part */
-		rohc_decomp_warn(context, "receive IR packet without a dynamic part, "
-		                 "but not in Full Context state");
-		goto error;
 	}
 
-	/* sanity checks */
-	assert((*rohc_hdr_len) <= rohc_length);
-
-	/* IR packet was successfully parsed */
-	return true;
+	return (rohc_len - rohc_remain_len);
 
 error:
-	return false;
+	return -1;
 }
 
 
@@ -1358,6 +1593,29 @@ uint32_t rohc_decomp_rfc3095_get_sn(const struct rohc_decomp_ctxt *const context
 }
 
 
+/**
+ * @brief Prefetch the LSB decoding contexts of the context
+ *
+ * Called by the decompressor when it decompresses a burst of packets, before
+ * the next packet is decompressed in the context.
+ *
+ * @param context The decompression context
+ */
+void rohc_decomp_rfc3095_prefetch(const struct rohc_decomp_ctxt *const context)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+
+	__builtin_prefetch(rfc3095_ctxt->sn_lsb_ctxt);
+	__builtin_prefetch(rfc3095_ctxt->outer_ip_id_offset_ctxt);
+	__builtin_prefetch(rfc3095_ctxt->inner_ip_id_offset_ctxt);
+	__builtin_prefetch(rfc3095_ctxt->outer_ip_changes);
+	if(rfc3095_ctxt->specific != NULL)
+	{
+		__builtin_prefetch(rfc3095_ctxt->specific);
+	}
+}
+
+
 /**
  * @brief Parse one UO-0 header
  *
@@ -1529,30 +1787,264 @@ error:
 }
 
 
+
 /**
- * @brief Parse one UO-1 header for non-RTP profiles
+ * @brief Parse one R-0 header
  *
  * \verbatim
 
+ R-0 (5.7.1)
+
       0   1   2   3   4   5   6   7
-     --- --- --- --- --- --- --- ---
- 1  :         Add-CID octet         :                    |
-    +---+---+---+---+---+---+---+---+                    |
- 2  |   first octet of base header  |                    |
-    +---+---+---+---+---+---+---+---+                    |
-    :                               :                    |
- 3  /   0, 1, or 2 octets of CID    /                    |
-    :                               :                    |
-    +---+---+---+---+---+---+---+---+                    |
-    :   remainder of base header    :                    |
- 4  /     see below for details     /                    |
-    :                               :                    |
-    +---+---+---+---+---+---+---+---+                    |
-    :                               :                    |
- 5  /           Extension           /                    |
-    :                               :                    |
-     --- --- --- --- --- --- --- ---                     |
-    :                               :                    |
+    +---+---+---+---+---+---+---+---+
+ 2  | 0   0 |          SN           |
+    +===+===+===+===+===+===+===+===+
+
+ Part 4 is empty.
+
+\endverbatim
+ *
+ * The R-0 header carries no CRC: the packet does not update the context, see
+ * RFC 3095, §5.5.1.1. The other parts are the ones of the UO-0 header, see
+ * \ref parse_uo0.
+ *
+ * @param context              The decompression context
+ * @param rohc_packet          The ROHC packet to decode
+ * @param rohc_length          The length of the ROHC packet
+ * @param large_cid_len        The length of the optional large CID field
+ * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
+ *                             OUT: The type of the parsed ROHC packet
+ * @param[out] extr_crc        The CRC bits extracted from the R-0 header
+ * @param[out] bits            The bits extracted from the R-0 header
+ * @param[out] rohc_hdr_len    The length of the ROHC header (in bytes)
+ * @return                     true if R-0 is successfully parsed,
+ *                             false otherwise
+ */
+static bool parse_r0(const struct rohc_decomp_ctxt *const context,
+                     const uint8_t *const rohc_packet,
+                     const size_t rohc_length,
+                     const size_t large_cid_len,
+                     rohc_packet_t *const packet_type,
+                     struct rohc_decomp_crc *const extr_crc,
+                     struct rohc_extr_bits *const bits,
+                     size_t *const rohc_hdr_len)
+{
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	size_t rohc_remainder_len;
+
+	/* remaining ROHC data not parsed yet and the length of the ROHC headers
+	   (will be computed during parsing) */
+	const uint8_t *rohc_remain_data;
+	size_t rohc_remain_len;
+
+	assert(rfc3095_ctxt != NULL);
+	assert(rohc_packet != NULL);
+	assert(packet_type != NULL);
+	assert((*packet_type) == ROHC_PACKET_R_0);
+	assert(bits != NULL);
+	assert(rohc_hdr_len != NULL);
+
+	rohc_remain_data = rohc_packet;
+	rohc_remain_len = rohc_length;
+	*rohc_hdr_len = 0;
+
+	/* reset all extracted bits */
+	reset_extr_bits(rfc3095_ctxt, bits);
+
+	/* check packet usage */
+	assert(context->state == ROHC_DECOMP_STATE_FC);
+
+	/* check if the ROHC packet is large enough to parse parts 2 and 3 */
+	if(rohc_remain_len < (1 + large_cid_len))
+	{
+		rohc_decomp_warn(context, "ROHC packet too small (len = %zu)",
+		                 rohc_remain_len);
+		goto error;
+	}
+
+	/* part 2: 2-bit "00" + 6-bit SN */
+	assert(GET_BIT_6_7(rohc_remain_data) == 0);
+	bits->sn = GET_BIT_0_5(rohc_remain_data);
+	bits->sn_nr = 6;
+	bits->is_sn_enc = true;
+	rohc_decomp_debug(context, "%zd SN bits = 0x%x", bits->sn_nr, bits->sn);
+	extr_crc->type = ROHC_CRC_TYPE_NONE;
+	extr_crc->bits_nr = 0;
+	rohc_remain_data++;
+	rohc_remain_len--;
+	(*rohc_hdr_len)++;
+
+	/* part 3: skip large CID (handled elsewhere) */
+	rohc_remain_data += large_cid_len;
+	rohc_remain_len -= large_cid_len;
+	*rohc_hdr_len += large_cid_len;
+
+	/* part 4: no remainder of base header for R-0 packet */
+	/* part 5: no extension for R-0 packet */
+
+	/* parts 6, 9, and 13: UO* remainder */
+	if(!parse_uo_remainder(context, rohc_remain_data, rohc_remain_len, bits,
+	                       &rohc_remainder_len))
+	{
+		rohc_decomp_warn(context, "failed to parse UO* remainder");
+		goto error;
+	}
+	*rohc_hdr_len += rohc_remainder_len;
+
+	/* sanity checks */
+	assert((*rohc_hdr_len) <= rohc_length);
+
+	/* R-0 packet was successfully parsed */
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Parse one R-0-CRC header
+ *
+ * \verbatim
+
+ R-0-CRC (5.7.1)
+
+      0   1   2   3   4   5   6   7
+    +---+---+---+---+---+---+---+---+
+ 2  | 0   1 |          SN           |
+    +===+===+===+===+===+===+===+===+
+ 4  |SN |            CRC            |
+    +---+---+---+---+---+---+---+---+
+
+\endverbatim
+ *
+ * The other parts are the ones of the UO-0 header, see \ref parse_uo0.
+ *
+ * @param context              The decompression context
+ * @param rohc_packet          The ROHC packet to decode
+ * @param rohc_length          The length of the ROHC packet
+ * @param large_cid_len        The length of the optional large CID field
+ * @param[in,out] packet_type  IN:  The type of the ROHC packet to parse
+ *                             OUT: The type of the parsed ROHC packet
+ * @param[out] extr_crc        The CRC bits extracted from the R-0-CRC header
+ * @param[out] bits            The bits extracted from the R-0-CRC header
+ * @param[out] rohc_hdr_len    The length of the ROHC header (in bytes)
+ * @return                     true if R-0-CRC is successfully parsed,
+ *                             false otherwise
+ */
+static bool parse_r0crc(const struct rohc_decomp_ctxt *const context,
+                        const uint8_t *const rohc_packet,
+                        const size_t rohc_length,
+                        const size_t large_cid_len,
+                        rohc_packet_t *const packet_type,
+                        struct rohc_decomp_crc *const extr_crc,
+                        struct rohc_extr_bits *const bits,
+                        size_t *const rohc_hdr_len)
+{
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	size_t rohc_remainder_len;
+
+	/* remaining ROHC data not parsed yet and the length of the ROHC headers
+	   (will be computed during parsing) */
+	const uint8_t *rohc_remain_data;
+	size_t rohc_remain_len;
+
+	assert(rfc3095_ctxt != NULL);
+	assert(rohc_packet != NULL);
+	assert(packet_type != NULL);
+	assert((*packet_type) == ROHC_PACKET_R_0_CRC);
+	assert(bits != NULL);
+	assert(rohc_hdr_len != NULL);
+
+	rohc_remain_data = rohc_packet;
+	rohc_remain_len = rohc_length;
+	*rohc_hdr_len = 0;
+
+	/* reset all extracted bits */
+	reset_extr_bits(rfc3095_ctxt, bits);
+
+	/* check packet usage */
+	assert(context->state == ROHC_DECOMP_STATE_FC);
+
+	/* check if the ROHC packet is large enough to parse parts 2, 3 and 4 */
+	if(rohc_remain_len < (1 + large_cid_len + 1))
+	{
+		rohc_decomp_warn(context, "ROHC packet too small (len = %zu)",
+		                 rohc_remain_len);
+		goto error;
+	}
+
+	/* part 2: 2-bit "01" + 6 MSB of the 7-bit SN */
+	assert(GET_BIT_6_7(rohc_remain_data) == 0x01);
+	bits->sn = GET_BIT_0_5(rohc_remain_data);
+	rohc_remain_data++;
+	rohc_remain_len--;
+	(*rohc_hdr_len)++;
+
+	/* part 3: skip large CID (handled elsewhere) */
+	rohc_remain_data += large_cid_len;
+	rohc_remain_len -= large_cid_len;
+	*rohc_hdr_len += large_cid_len;
+
+	/* part 4: 1 LSB of the 7-bit SN + 7-bit CRC */
+	bits->sn = (bits->sn << 1) | GET_REAL(GET_BIT_7(rohc_remain_data));
+	bits->sn_nr = 7;
+	bits->is_sn_enc = true;
+	rohc_decomp_debug(context, "%zd SN bits = 0x%x", bits->sn_nr, bits->sn);
+	extr_crc->type = ROHC_CRC_TYPE_7;
+	extr_crc->bits = GET_BIT_0_6(rohc_remain_data);
+	extr_crc->bits_nr = 7;
+	rohc_decomp_debug(context, "CRC-%zd found in packet = 0x%02x",
+	                  extr_crc->bits_nr, extr_crc->bits);
+	rohc_remain_data++;
+	rohc_remain_len--;
+	(*rohc_hdr_len)++;
+
+	/* part 5: no extension for R-0-CRC packet */
+
+	/* parts 6, 9, and 13: UO* remainder */
+	if(!parse_uo_remainder(context, rohc_remain_data, rohc_remain_len, bits,
+	                       &rohc_remainder_len))
+	{
+		rohc_decomp_warn(context, "failed to parse UO* remainder");
+		goto error;
+	}
+	*rohc_hdr_len += rohc_remainder_len;
+
+	/* sanity checks */
+	assert((*rohc_hdr_len) <= rohc_length);
+
+	/* R-0-CRC packet was successfully parsed */
+	return true;
+
+error:
+	return false;
+}
+
+/**
+ * @brief Parse one UO-1 header for non-RTP profiles
+ *
+ * \verbatim
+
+      0   1   2   3   4   5   6   7
+     --- --- --- --- --- --- --- ---
+ 1  :         Add-CID octet         :                    |
+    +---+---+---+---+---+---+---+---+                    |
+ 2  |   first octet of base header  |                    |
+    +---+---+---+---+---+---+---+---+                    |
+    :                               :                    |
+ 3  /   0, 1, or 2 octets of CID    /                    |
+    :                               :                    |
+    +---+---+---+---+---+---+---+---+                    |
+    :   remainder of base header    :                    |
+ 4  /     see below for details     /                    |
+    :                               :                    |
+    +---+---+---+---+---+---+---+---+                    |
+    :                               :                    |
+ 5  /           Extension           /                    |
+    :                               :                    |
+     --- --- --- --- --- --- --- ---                     |
+    :                               :                    |
  6  +   IP-ID of outer IPv4 header  +
     :                               :     (see section 5.7 or [RFC-3095])
      --- --- --- --- --- --- --- ---
@@ -2235,7 +2727,7 @@ static bool parse_uo1id(const struct rohc_decomp_ctxt *const context,
 			case ROHC_EXT_3:
 			{
 				/* decode the extension */
-				ext_size = rfc3095_ctxt->parse_ext3(context, rohc_remain_data,
+				ext_size = rfc3095_ctxt->ops->parse_ext3(context, rohc_remain_data,
 				                                    rohc_remain_len, *packet_type,
 				                                    bits);
 
@@ -2757,7 +3249,7 @@ static bool parse_uor2(const struct rohc_decomp_ctxt *const context,
 			case ROHC_EXT_3:
 			{
 				/* decode the extension */
-				ext_size = rfc3095_ctxt->parse_ext3(context, rohc_remain_data,
+				ext_size = rfc3095_ctxt->ops->parse_ext3(context, rohc_remain_data,
 				                                    rohc_remain_len, *packet_type,
 				                                    bits);
 				break;
@@ -3210,7 +3702,7 @@ static bool parse_uor2rtp_once(const struct rohc_decomp_ctxt *const context,
 			case ROHC_EXT_3:
 			{
 				/* decode the extension */
-				ext_size = rfc3095_ctxt->parse_ext3(context, rohc_remain_data,
+				ext_size = rfc3095_ctxt->ops->parse_ext3(context, rohc_remain_data,
 				                                    rohc_remain_len, packet_type,
 				                                    bits);
 				break;
@@ -3676,7 +4168,7 @@ static bool parse_uor2id_once(const struct rohc_decomp_ctxt *const context,
 			case ROHC_EXT_3:
 			{
 				/* decode the extension */
-				ext_size = rfc3095_ctxt->parse_ext3(context, rohc_remain_data,
+				ext_size = rfc3095_ctxt->ops->parse_ext3(context, rohc_remain_data,
 				                                    rohc_remain_len, packet_type,
 				                                    bits);
 
@@ -4145,7 +4637,7 @@ static bool parse_uor2ts_once(const struct rohc_decomp_ctxt *const context,
 			case ROHC_EXT_3:
 			{
 				/* decode the extension */
-				ext_size = rfc3095_ctxt->parse_ext3(context, rohc_remain_data,
+				ext_size = rfc3095_ctxt->ops->parse_ext3(context, rohc_remain_data,
 				                                    rohc_remain_len, packet_type,
 				                                    bits);
 				break;
@@ -4378,12 +4870,13 @@ static bool parse_uo_remainder(const struct rohc_decomp_ctxt *const context,
 	/* parts 10, 11 and 12: not supported */
 
 	/* part 13: decode the tail of UO* packet */
-	if(rfc3095_ctxt->parse_uo_remainder != NULL)
+	if(rfc3095_ctxt->ops->parse_uo_remainder != NULL)
 	{
 		int size;
 
-		size = rfc3095_ctxt->parse_uo_remainder(context, rohc_remain_data,
-		                                        rohc_remain_len, bits);
+		size = rohc_decomp_rfc3095_call(rfc3095_ctxt, parse_uo_remainder,
+		                                rtp_parse_uo_remainder, context,
+		                                rohc_remain_data, rohc_remain_len, bits);
 		if(size < 0)
 		{
 			rohc_decomp_warn(context, "cannot decode the remainder of UO* packet");
@@ -4524,8 +5017,10 @@ static bool parse_irdyn(const struct rohc_decomp_ctxt *const context,
 	/* decode the dynamic part of the inner IP header */
 	if(bits->multiple_ip)
 	{
+		/* allocated by the IR packet that established the two IP headers */
+		assert(rfc3095_ctxt->list_decomp2 != NULL);
 		size = parse_dynamic_part_ip(context, rohc_remain_data, rohc_remain_len,
-		                             &bits->inner_ip, &rfc3095_ctxt->list_decomp2);
+		                             &bits->inner_ip, rfc3095_ctxt->list_decomp2);
 		if(size == -1)
 		{
 			rohc_decomp_warn(context, "cannot decode the inner IP dynamic part");
@@ -4537,9 +5032,9 @@ static bool parse_irdyn(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* parse the dynamic part of the next header if necessary */
-	if(rfc3095_ctxt->parse_dyn_next_hdr != NULL)
+	if(rfc3095_ctxt->ops->parse_dyn_next_hdr != NULL)
 	{
-		size = rfc3095_ctxt->parse_dyn_next_hdr(context, rohc_remain_data,
+		size = rfc3095_ctxt->ops->parse_dyn_next_hdr(context, rohc_remain_data,
 		                                        rohc_remain_len, bits);
 		if(size == -1)
 		{
@@ -4937,54 +5432,298 @@ static uint8_t parse_extension_type(const uint8_t *const rohc_ext)
 
 
 /**
- * @brief Build the uncompressed headers
+ * @brief Decode one UO-0, UO-1 or UO-1-RTP packet in one single step
  *
- * @todo check for uncomp_hdrs size before writing into it
+ * Most packets of a flow in Full Context state are UO-0, UO-1 or UO-1-RTP
+ * packets. They transmit a few LSB bits of the SN, IP-ID and TS fields only,
+ * all the other fields are the same as in the previous packet. The fast path
+ * thus extracts the few transmitted bits, decodes them against the context,
+ * then patches a copy of the headers built for the previous packet.
+ *
+ * The fast path does not change the context (the headers are only recorded
+ * as pending until the context is updated) and it does not report anything:
+ * whenever the packet is not one it handles or the CRC does not match, it
+ * gives up and the generic path decodes the packet again, reports errors
+ * and attempts repairs as usual.
  *
  * @param decomp                The ROHC decompressor
  * @param context               The decompression context
+ * @param rohc_packet           The ROHC packet to decode
+ * @param large_cid_len         The length of the optional large CID field
  * @param packet_type           The type of ROHC packet
- * @param extr_crc              The CRC bits extracted from the ROHC header
- * @param decoded               The values decoded from ROHC header
- * @param payload_len           The length of the packet payload
+ * @param[out] decoded          The values decoded from ROHC header
  * @param[out] uncomp_hdrs      The buffer to store the uncompressed headers
+ * @param[out] rohc_hdr_len     The length of the ROHC header (in bytes)
  * @param[out] uncomp_hdrs_len  The length of the uncompressed headers written
  *                              into the buffer
- * @return                      Possible values:
- *                               \li ROHC_STATUS_OK if headers are built
- *                                   successfully,
- *                               \li ROHC_STATUS_BAD_CRC if headers do not
- *                                   match CRC,
- *                               \li ROHC_STATUS_OUTPUT_TOO_SMALL if the
- *                                   output buffer is too small
+ * @return                      true if the packet was decoded and the
+ *                              uncompressed headers built with a correct CRC,
+ *                              false if the generic path shall be used
  */
-rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
-                                        const struct rohc_decomp_ctxt *const context,
-                                        const rohc_packet_t packet_type,
-                                        const struct rohc_decomp_crc *const extr_crc,
-                                        const struct rohc_decoded_values *const decoded,
-                                        const size_t payload_len,
-                                        struct rohc_buf *const uncomp_hdrs,
-                                        size_t *const uncomp_hdrs_len)
+bool rfc3095_decomp_decode_fast(const struct rohc_decomp *const decomp __attribute__((unused)),
+                                const struct rohc_decomp_ctxt *const context,
+                                const struct rohc_buf rohc_packet,
+                                const size_t large_cid_len,
+                                const rohc_packet_t packet_type,
+                                struct rohc_decoded_values *const decoded,
+                                struct rohc_buf *const uncomp_hdrs,
+                                size_t *const rohc_hdr_len,
+                                size_t *const uncomp_hdrs_len)
 {
 	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
-	uint8_t *uncomp_hdrs_data = rohc_buf_data(*uncomp_hdrs);
-	size_t uncomp_hdrs_max_len = rohc_buf_avail_len(*uncomp_hdrs);
-	uint8_t *outer_ip_hdr;
-	uint8_t *inner_ip_hdr;
-	uint8_t *next_header;
-	size_t ip_payload_len = 0;
-
-	*uncomp_hdrs_len = 0;
-
-	/* build the IP headers */
-	if(decoded->multiple_ip)
+	struct rohc_decomp_rfc3095_tmpl *const tmpl = &rfc3095_ctxt->tmpl;
+	const struct rohc_decomp_rfc3095_changes *const outer_ip =
+		rfc3095_ctxt->outer_ip_changes;
+	const uint8_t *rohc_remain_data = rohc_buf_data(rohc_packet);
+	size_t rohc_remain_len = rohc_packet.len;
+	const bool is_ipv4 = !!(ip_get_version(&outer_ip->ip) == IPV4);
+	struct rohc_extr_uo_bits bits;
+	uint8_t *dest;
+	size_t hdrs_len;
+	size_t ip_hdr_len;
+	size_t payload_len;
+	int remainder_len;
+
+	/* the fast path handles the templates of one single IP header only */
+	if(!tmpl->is_valid || context->state != ROHC_DECOMP_STATE_FC ||
+	   rfc3095_ctxt->ops->decode_fast_next_hdr == NULL || tmpl->decoded.multiple_ip)
 	{
-		size_t inner_ip_hdr_len;
-		size_t inner_ip_ext_hdrs_len;
-		size_t outer_ip_hdr_len;
+		goto skip;
+	}
+	assert(!rfc3095_ctxt->multiple_ip);
+	assert(rfc3095_ctxt->ops->patch_next_hdr != NULL);
 
-		/* determine the length of the inner IP header */
+	/* parse the base header, skip the large CID (handled elsewhere) */
+	bits.ip_id = 0;
+	bits.ip_id_nr = 0;
+	bits.ts = 0;
+	bits.ts_nr = 0;
+	bits.rtp_m = 0;
+	switch(packet_type)
+	{
+		case ROHC_PACKET_UO_0:
+		{
+			/* 1-bit "0" + 4-bit SN + 3-bit CRC */
+			if(rohc_remain_len < (1 + large_cid_len))
+			{
+				goto skip;
+			}
+			bits.sn = GET_BIT_3_6(rohc_remain_data);
+			bits.sn_nr = 4;
+			bits.crc = GET_BIT_0_2(rohc_remain_data);
+			*rohc_hdr_len = 1 + large_cid_len;
+			break;
+		}
+		case ROHC_PACKET_UO_1:
+		{
+			/* 2-bit "10" + 6-bit IP-ID, then 5-bit SN + 3-bit CRC */
+			if(rohc_remain_len < (2 + large_cid_len) || !is_ipv4 || outer_ip->rnd)
+			{
+				goto skip;
+			}
+			bits.ip_id = GET_BIT_0_5(rohc_remain_data);
+			bits.ip_id_nr = 6;
+			bits.sn = GET_BIT_3_7(rohc_remain_data + 1 + large_cid_len);
+			bits.sn_nr = 5;
+			bits.crc = GET_BIT_0_2(rohc_remain_data + 1 + large_cid_len);
+			*rohc_hdr_len = 2 + large_cid_len;
+			break;
+		}
+		case ROHC_PACKET_UO_1_RTP:
+		{
+			/* 2-bit "10" + 6-bit TS, then 1-bit M + 4-bit SN + 3-bit CRC */
+			if(rohc_remain_len < (2 + large_cid_len))
+			{
+				goto skip;
+			}
+			bits.ts = GET_BIT_0_5(rohc_remain_data);
+			bits.ts_nr = 6;
+			bits.rtp_m = GET_REAL(GET_BIT_7(rohc_remain_data + 1 + large_cid_len));
+			bits.sn = GET_BIT_3_6(rohc_remain_data + 1 + large_cid_len);
+			bits.sn_nr = 4;
+			bits.crc = GET_BIT_0_2(rohc_remain_data + 1 + large_cid_len);
+			*rohc_hdr_len = 2 + large_cid_len;
+			break;
+		}
+		default:
+		{
+			goto skip;
+		}
+	}
+	rohc_remain_data += *rohc_hdr_len;
+	rohc_remain_len -= *rohc_hdr_len;
+
+	/* all fields but SN, IP-ID, TS, M and UDP checksum are the same as in
+	 * the previous packet */
+	*decoded = tmpl->decoded;
+	decoded->mode = context->mode;
+	decoded->is_context_reused = false;
+	decoded->static_chain = NULL;
+	decoded->static_chain_len = 0;
+
+	/* decode SN */
+	if(!rfc3095_decomp_decode_sn(context, ROHC_LSB_REF_0, 0, bits.sn, bits.sn_nr,
+	                             &decoded->sn, &decoded->is_late))
+	{
+		goto skip;
+	}
+
+	/* decode IP-ID, the random IP-ID is transmitted in the UO* remainder */
+	if(!is_ipv4)
+	{
+		/* no IP-ID in IPv6 header */
+	}
+	else if(outer_ip->rnd)
+	{
+		if(outer_ip->sid || rohc_remain_len < 2)
+		{
+			goto skip;
+		}
+		decoded->outer_ip.id = rohc_ntoh16(GET_NEXT_16_BITS(rohc_remain_data));
+		rohc_remain_data += 2;
+		rohc_remain_len -= 2;
+		*rohc_hdr_len += 2;
+	}
+	else if(outer_ip->sid)
+	{
+		decoded->outer_ip.id = ipv4_get_id(&outer_ip->ip);
+	}
+	else if(!ip_id_offset_decode(rfc3095_ctxt->outer_ip_id_offset_ctxt,
+	                             ROHC_LSB_REF_0, bits.ip_id, bits.ip_id_nr,
+	                             decoded->sn, &decoded->outer_ip.id))
+	{
+		goto skip;
+	}
+
+	/* decode the fields of the next header */
+	remainder_len = rohc_decomp_rfc3095_call(rfc3095_ctxt, decode_fast_next_hdr,
+	                                         rtp_decode_fast_rtp, context, &bits,
+	                                         rohc_remain_data, rohc_remain_len,
+	                                         decoded);
+	if(remainder_len < 0)
+	{
+		goto skip;
+	}
+	*rohc_hdr_len += remainder_len;
+	payload_len = rohc_packet.len - (*rohc_hdr_len);
+
+	/* patch a copy of the headers of the previous packet */
+	dest = rohc_buf_data(*uncomp_hdrs);
+	hdrs_len = build_uncomp_hdrs_from_tmpl(rfc3095_ctxt, decoded, payload_len,
+	                                       dest, rohc_buf_avail_len(*uncomp_hdrs),
+	                                       &ip_hdr_len);
+	if(hdrs_len == 0)
+	{
+		goto skip;
+	}
+
+	/* the CRC shall match, otherwise let the generic path handle the failure */
+	if(compute_uncomp_crc(rfc3095_ctxt, dest, NULL, dest + ip_hdr_len,
+	                      ROHC_CRC_TYPE_3) != bits.crc)
+	{
+		goto skip;
+	}
+	rohc_decomp_debug(context, "%s packet decoded by the fast path (SN = %u)",
+	                  rohc_get_packet_descr(packet_type), decoded->sn);
+
+	/* record the headers until the context is updated */
+	memcpy(tmpl->hdrs[!tmpl->cur], dest, hdrs_len);
+	tmpl->hdrs_len[!tmpl->cur] = hdrs_len;
+	tmpl->is_pending = true;
+
+	uncomp_hdrs->len += hdrs_len;
+	*uncomp_hdrs_len = hdrs_len;
+
+	return true;
+
+skip:
+	return false;
+}
+
+
+/**
+ * @brief Build the uncompressed headers
+ *
+ * @todo check for uncomp_hdrs size before writing into it
+ *
+ * @param decomp                The ROHC decompressor
+ * @param context               The decompression context
+ * @param packet_type           The type of ROHC packet
+ * @param extr_crc              The CRC bits extracted from the ROHC header
+ * @param decoded               The values decoded from ROHC header
+ * @param payload_len           The length of the packet payload
+ * @param[out] uncomp_hdrs      The buffer to store the uncompressed headers
+ * @param[out] uncomp_hdrs_len  The length of the uncompressed headers written
+ *                              into the buffer
+ * @return                      Possible values:
+ *                               \li ROHC_STATUS_OK if headers are built
+ *                                   successfully,
+ *                               \li ROHC_STATUS_BAD_CRC if headers do not
+ *                                   match CRC,
+ *                               \li ROHC_STATUS_OUTPUT_TOO_SMALL if the
+ *                                   output buffer is too small
+ */
+rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
+                                        const struct rohc_decomp_ctxt *const context,
+                                        const rohc_packet_t packet_type,
+                                        const struct rohc_decomp_crc *const extr_crc,
+                                        const struct rohc_decoded_values *const decoded,
+                                        const size_t payload_len,
+                                        struct rohc_buf *const uncomp_hdrs,
+                                        size_t *const uncomp_hdrs_len)
+{
+	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
+	const bool use_tmpl = !!(decoded->is_tmpl_usable && rfc3095_ctxt->tmpl.is_valid);
+	uint8_t *uncomp_hdrs_data = rohc_buf_data(*uncomp_hdrs);
+	size_t uncomp_hdrs_max_len = rohc_buf_avail_len(*uncomp_hdrs);
+	uint8_t *outer_ip_hdr;
+	uint8_t *inner_ip_hdr;
+	uint8_t *next_header;
+	size_t ip_payload_len = 0;
+
+	*uncomp_hdrs_len = 0;
+	rfc3095_ctxt->tmpl.is_pending = false;
+
+	/* build the IP headers */
+	if(use_tmpl)
+	{
+		size_t ip_hdr_len;
+
+		/* no static or dynamic field changed: patch a copy of the headers of
+		 * the previous packet */
+		*uncomp_hdrs_len =
+			build_uncomp_hdrs_from_tmpl(rfc3095_ctxt, decoded, payload_len,
+			                            uncomp_hdrs_data, uncomp_hdrs_max_len,
+			                            &ip_hdr_len);
+		if((*uncomp_hdrs_len) == 0)
+		{
+			rohc_decomp_warn(context, "uncompressed packet too small for the "
+			                 "headers");
+			goto error_output_too_small;
+		}
+		rohc_decomp_debug(context, "%zu-byte headers built from the template",
+		                  *uncomp_hdrs_len);
+		outer_ip_hdr = uncomp_hdrs_data;
+		if(decoded->multiple_ip)
+		{
+			inner_ip_hdr = uncomp_hdrs_data +
+				(decoded->outer_ip.version == IPV4 ?
+				 sizeof(struct ipv4_hdr) : sizeof(struct ipv6_hdr));
+		}
+		else
+		{
+			inner_ip_hdr = NULL;
+		}
+		uncomp_hdrs_data += ip_hdr_len;
+		uncomp_hdrs->len += *uncomp_hdrs_len;
+	}
+	else if(decoded->multiple_ip)
+	{
+		size_t inner_ip_hdr_len;
+		size_t inner_ip_ext_hdrs_len;
+		size_t outer_ip_hdr_len;
+
+		/* determine the length of the inner IP header */
 		if(decoded->inner_ip.version == IPV4)
 		{
 			inner_ip_hdr_len = sizeof(struct ipv4_hdr);
@@ -4999,14 +5738,14 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 
 		/* determine the length of extension headers of the inner IP header */
 		inner_ip_ext_hdrs_len = 0;
-		if(rfc3095_ctxt->list_decomp2.pkt_list.id != ROHC_LIST_GEN_ID_NONE)
+		if(rfc3095_ctxt->list_decomp2->pkt_list.id != ROHC_LIST_GEN_ID_NONE)
 		{
 			size_t i;
 
-			for(i = 0; i < rfc3095_ctxt->list_decomp2.pkt_list.items_nr; i++)
+			for(i = 0; i < rfc3095_ctxt->list_decomp2->pkt_list.items_nr; i++)
 			{
 				inner_ip_ext_hdrs_len +=
-					rfc3095_ctxt->list_decomp2.pkt_list.items[i]->length;
+					rfc3095_ctxt->list_decomp2->pkt_list.items[i]->length;
 			}
 		}
 		rohc_decomp_debug(context, "length of extension headers for inner IP "
@@ -5036,7 +5775,7 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 		ip_payload_len -= inner_ip_hdr_len + inner_ip_ext_hdrs_len;
 		if(!build_uncomp_ip(context, decoded->inner_ip, uncomp_hdrs_data,
 		                    uncomp_hdrs_max_len, &inner_ip_hdr_len,
-		                    ip_payload_len, &rfc3095_ctxt->list_decomp2))
+		                    ip_payload_len, rfc3095_ctxt->list_decomp2))
 		{
 			rohc_decomp_warn(context, "failed to build the inner IP header");
 			goto error_output_too_small;
@@ -5076,13 +5815,15 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 		uncomp_hdrs->len += ip_hdr_len;
 	}
 
-	/* build the next header if present */
+	/* build the next header if present (and not built from the template) */
 	next_header = uncomp_hdrs_data;
-	if(rfc3095_ctxt->build_next_header != NULL)
+	if(!use_tmpl && rfc3095_ctxt->ops->build_next_header != NULL)
 	{
 		/* TODO: check uncomp_hdrs max size */
-		size_t size = rfc3095_ctxt->build_next_header(context, decoded,
-		                                              uncomp_hdrs_data, payload_len);
+		size_t size = rohc_decomp_rfc3095_call(rfc3095_ctxt, build_next_header,
+		                                       rtp_build_uncomp_rtp, context,
+		                                       decoded, uncomp_hdrs_data,
+		                                       payload_len);
 #ifndef __clang_analyzer__ /* silent warning about dead in/decrement */
 		uncomp_hdrs_data += size;
 #endif
@@ -5109,7 +5850,7 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 			                 rohc_get_packet_descr(packet_type),
 			                 rohc_decomp_get_state_descr(context->state),
 			                 rohc_get_mode_descr(context->mode));
-			if((decomp->features & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
+			if((d_features(decomp) & ROHC_DECOMP_FEATURE_DUMP_PACKETS) != 0)
 			{
 				rohc_dump_buf(decomp->trace_callback, decomp->trace_callback_priv,
 				              ROHC_TRACE_DECOMP, ROHC_TRACE_WARNING,
@@ -5119,6 +5860,21 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
 		}
 	}
 
+	/* record the headers as template if it supports them */
+	if(rfc3095_ctxt->ops->patch_next_hdr != NULL &&
+	   (decoded->outer_ip.version == IPV4 ||
+	    rfc3095_ctxt->list_decomp1.pkt_list.id == ROHC_LIST_GEN_ID_NONE) &&
+	   (!decoded->multiple_ip || decoded->inner_ip.version == IPV4 ||
+	    rfc3095_ctxt->list_decomp2->pkt_list.id == ROHC_LIST_GEN_ID_NONE) &&
+	   (*uncomp_hdrs_len) <= ROHC_DECOMP_RFC3095_TMPL_MAX_LEN)
+	{
+		struct rohc_decomp_rfc3095_tmpl *const tmpl = &rfc3095_ctxt->tmpl;
+
+		memcpy(tmpl->hdrs[!tmpl->cur], outer_ip_hdr, *uncomp_hdrs_len);
+		tmpl->hdrs_len[!tmpl->cur] = *uncomp_hdrs_len;
+		tmpl->is_pending = true;
+	}
+
 	return ROHC_STATUS_OK;
 
 error_crc:
@@ -5310,6 +6066,154 @@ error:
 }
 
 
+/**
+ * @brief Build the uncompressed headers from the header template
+ *
+ * Copy the headers of the previous packet, then patch the fields that may
+ * change without any static or dynamic field changing: the IP-ID, the IPv4
+ * Total Length and checksum or the IPv6 Payload Length, and the fields of
+ * the next header that the profile patches. The TOS and TTL of the IPv4
+ * header are patched too if they changed. The IPv4 checksum is updated
+ * incrementally from the one of the template.
+ *
+ * @param rfc3095_ctxt     The generic decompression context
+ * @param decoded          The values decoded from ROHC header
+ * @param payload_len      The length of the packet payload
+ * @param dest             The buffer to store the uncompressed headers
+ * @param dest_max_len     The max length of the uncompressed headers
+ * @param[out] ip_hdr_len  The length of the IP header(s)
+ * @return                 The length of the uncompressed headers,
+ *                         0 if the buffer is too small
+ */
+static size_t build_uncomp_hdrs_from_tmpl(const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                                          const struct rohc_decoded_values *const decoded,
+                                          const size_t payload_len,
+                                          uint8_t *const dest,
+                                          const size_t dest_max_len,
+                                          size_t *const ip_hdr_len)
+{
+	const struct rohc_decomp_rfc3095_tmpl *const tmpl = &rfc3095_ctxt->tmpl;
+	const size_t hdrs_len = tmpl->hdrs_len[tmpl->cur];
+
+	assert(tmpl->is_valid);
+	assert(rfc3095_ctxt->ops->patch_next_hdr != NULL);
+
+	if(dest_max_len < hdrs_len)
+	{
+		return 0;
+	}
+	memcpy(dest, tmpl->hdrs[tmpl->cur], hdrs_len);
+
+	*ip_hdr_len = patch_uncomp_ip_from_tmpl(dest, &decoded->outer_ip,
+	                                        hdrs_len + payload_len);
+	if(decoded->multiple_ip)
+	{
+		*ip_hdr_len +=
+			patch_uncomp_ip_from_tmpl(dest + (*ip_hdr_len), &decoded->inner_ip,
+			                          hdrs_len - (*ip_hdr_len) + payload_len);
+	}
+	rohc_decomp_rfc3095_call(rfc3095_ctxt, patch_next_hdr, rtp_patch_uncomp_rtp,
+	                         decoded, dest + (*ip_hdr_len), payload_len);
+
+	return hdrs_len;
+}
+
+
+/**
+ * @brief Patch one IP header copied from the header template
+ *
+ * @param dest       The IP header copied from the template
+ * @param ip_values  The values decoded for the IP header
+ * @param ip_len     The length of the IP packet, IP header included
+ * @return           The length of the IP header
+ */
+static size_t patch_uncomp_ip_from_tmpl(uint8_t *const dest,
+                                        const struct rohc_decoded_ip_values *const ip_values,
+                                        const size_t ip_len)
+{
+	size_t ip_hdr_len;
+
+	if(ip_values->version == IPV4)
+	{
+		struct ipv4_hdr *const ip = (struct ipv4_hdr *) dest;
+		uint16_t id = rohc_hton16(ip_values->id);
+		const uint16_t tot_len = rohc_hton16(ip_len);
+
+		if(!ip_values->nbo)
+		{
+			id = swab16(id);
+		}
+
+		/* the checksum of the template is updated with the changed words
+		 * only, the other fields of the IPv4 header are not read again */
+		ip->check = ip_csum_replace2(ip->check, ip->id, id);
+		ip->check = ip_csum_replace2(ip->check, ip->tot_len, tot_len);
+		ip->id = id;
+		ip->tot_len = tot_len;
+		if(ip->tos != ip_values->tos)
+		{
+			uint16_t old_word;
+			uint16_t new_word;
+
+			/* TOS is in the 1st 16-bit word of the IPv4 header */
+			memcpy(&old_word, dest, sizeof(uint16_t));
+			ip->tos = ip_values->tos;
+			memcpy(&new_word, dest, sizeof(uint16_t));
+			ip->check = ip_csum_replace2(ip->check, old_word, new_word);
+		}
+		if(ip->ttl != ip_values->ttl)
+		{
+			uint16_t old_word;
+			uint16_t new_word;
+
+			/* TTL is in the 5th 16-bit word of the IPv4 header */
+			memcpy(&old_word, dest + 8, sizeof(uint16_t));
+			ip->ttl = ip_values->ttl;
+			memcpy(&new_word, dest + 8, sizeof(uint16_t));
+			ip->check = ip_csum_replace2(ip->check, old_word, new_word);
+		}
+		ip_hdr_len = sizeof(struct ipv4_hdr);
+	}
+	else
+	{
+		struct ipv6_hdr *const ip = (struct ipv6_hdr *) dest;
+
+		ip->plen = rohc_hton16(ip_len - sizeof(struct ipv6_hdr));
+		ip_hdr_len = sizeof(struct ipv6_hdr);
+	}
+
+	return ip_hdr_len;
+}
+
+
+/**
+ * @brief Whether the IP fields extracted from the ROHC packet let the header
+ *        template be patched
+ *
+ * The IP header shall keep the version and all the static and dynamic fields
+ * of the template, but the TOS and TTL of IPv4 headers. IPv6 headers shall
+ * have no extension header.
+ *
+ * @param bits          The bits extracted for the IP header
+ * @param tmpl_version  The version of the IP header in the template
+ * @param list_decomp   The list decompressor of the IP header
+ * @return              true if the template may be patched, false otherwise
+ */
+static bool is_ip_tmpl_usable(const struct rohc_extr_ip_bits *const bits,
+                              const ip_version tmpl_version,
+                              const struct list_decomp *const list_decomp)
+{
+	return !!(bits->version == tmpl_version &&
+	          (bits->version == IPV4 ||
+	           list_decomp->pkt_list.id == ROHC_LIST_GEN_ID_NONE) &&
+	          ((bits->tos_nr == 0 && bits->ttl_nr == 0) ||
+	           bits->version == IPV4) &&
+	          bits->df_nr == 0 && bits->proto_nr == 0 &&
+	          bits->flowid_nr == 0 && bits->saddr_nr == 0 &&
+	          bits->daddr_nr == 0);
+}
+
+
 /**
  * @brief Check whether the CRC on uncompressed header is correct or not
  *
@@ -5333,47 +6237,26 @@ static bool check_uncomp_crc(const struct rohc_decomp *const decomp,
                              const rohc_crc_type_t crc_type,
                              const uint8_t crc_packet)
 {
-	struct rohc_decomp_rfc3095_ctxt *rfc3095_ctxt;
-	const uint8_t *crc_table;
 	uint8_t crc_computed;
 
 	assert(decomp != NULL);
 	assert(context != NULL);
 	assert(context->persist_ctxt != NULL);
-	rfc3095_ctxt = context->persist_ctxt;
 	assert(outer_ip_hdr != NULL);
 	assert(next_header != NULL);
-	assert(crc_type != ROHC_CRC_TYPE_NONE);
 
-	/* determine the initial value and the pre-computed table for the CRC */
-	switch(crc_type)
+	/* determine whether the CRC type is supported */
+	if(crc_type != ROHC_CRC_TYPE_3 && crc_type != ROHC_CRC_TYPE_7 &&
+	   crc_type != ROHC_CRC_TYPE_8)
 	{
-		case ROHC_CRC_TYPE_3:
-			crc_computed = CRC_INIT_3;
-			crc_table = decomp->crc_table_3;
-			break;
-		case ROHC_CRC_TYPE_7:
-			crc_computed = CRC_INIT_7;
-			crc_table = decomp->crc_table_7;
-			break;
-		case ROHC_CRC_TYPE_8:
-			crc_computed = CRC_INIT_8;
-			crc_table = decomp->crc_table_8;
-			break;
-		case ROHC_CRC_TYPE_NONE:
-		default:
-			rohc_decomp_warn(context, "unknown CRC type %d", crc_type);
-			assert(0);
-			goto error;
+		rohc_decomp_warn(context, "unknown CRC type %d", crc_type);
+		assert(0);
+		goto error;
 	}
 
 	/* compute the CRC from built uncompressed headers */
-	crc_computed = rfc3095_ctxt->compute_crc_static(outer_ip_hdr, inner_ip_hdr,
-	                                                next_header, crc_type,
-	                                                crc_computed, crc_table);
-	crc_computed = rfc3095_ctxt->compute_crc_dynamic(outer_ip_hdr, inner_ip_hdr,
-	                                                 next_header, crc_type,
-	                                                 crc_computed, crc_table);
+	crc_computed = compute_uncomp_crc(context->persist_ctxt, outer_ip_hdr,
+	                                  inner_ip_hdr, next_header, crc_type);
 	rohc_decomp_debug(context, "CRC-%d on uncompressed header = 0x%x",
 	                  crc_type, crc_computed);
 
@@ -5393,9 +6276,74 @@ error:
 }
 
 
+/**
+ * @brief Compute the CRC on uncompressed headers
+ *
+ * @param rfc3095_ctxt  The generic decompression context
+ * @param outer_ip_hdr  The outer IP header
+ * @param inner_ip_hdr  The inner IP header if it exists, NULL otherwise
+ * @param next_header   The transport header, eg. UDP
+ * @param crc_type      The type of CRC, either CRC-3, CRC-7 or CRC-8
+ * @return              The CRC computed on the uncompressed headers
+ */
+static uint8_t compute_uncomp_crc(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
+                                  const uint8_t *const outer_ip_hdr,
+                                  const uint8_t *const inner_ip_hdr,
+                                  const uint8_t *const next_header,
+                                  const rohc_crc_type_t crc_type)
+{
+	const uint8_t *crc_table;
+	uint8_t crc_computed;
+
+	/* determine the initial value and the pre-computed table for the CRC */
+	if(crc_type == ROHC_CRC_TYPE_3)
+	{
+		crc_computed = CRC_INIT_3;
+		crc_table = rohc_crc_table_3;
+	}
+	else if(crc_type == ROHC_CRC_TYPE_7)
+	{
+		crc_computed = CRC_INIT_7;
+		crc_table = rohc_crc_table_7;
+	}
+	else
+	{
+		assert(crc_type == ROHC_CRC_TYPE_8);
+		crc_computed = CRC_INIT_8;
+		crc_table = rohc_crc_table_8;
+	}
+
+	/* compute the CRC from built uncompressed headers */
+	crc_computed =
+		rohc_decomp_rfc3095_call(rfc3095_ctxt, compute_crc_static,
+		                         rtp_compute_crc_static, outer_ip_hdr,
+		                         inner_ip_hdr, next_header, crc_type,
+		                         crc_computed, crc_table,
+		                         &rfc3095_ctxt->crc_static_cache);
+	crc_computed =
+		rohc_decomp_rfc3095_call(rfc3095_ctxt, compute_crc_dynamic,
+		                         rtp_compute_crc_dynamic, outer_ip_hdr,
+		                         inner_ip_hdr, next_header, crc_type,
+		                         crc_computed, crc_table,
+		                         &rfc3095_ctxt->crc_static_cache);
+
+	return crc_computed;
+}
+
+
 /**
  * @brief Attempt a packet/context repair upon CRC failure
  *
+ * The candidate corrections are determined at once on the first CRC
+ * failure, then tried one after the other on the same packet until one of
+ * them passes the CRC check. Once a SN LSB wraparound is detected as in
+ * RFC3095, §5.3.2.2.4, only that correction is attempted. Otherwise the
+ * repair of incorrect SN updates of RFC3095, §5.3.2.2.5 is attempted.
+ *
+ * If the SN was decoded with the reorder window, the regular interpretation
+ * of the SN without the reorder window is the first candidate. It does not
+ * require any CRC-valid packet to be approved.
+ *
  * @param decomp             The ROHC decompressor
  * @param context            The decompression context
  * @param pkt_arrival_time   The arrival time of the ROHC packet that caused
@@ -5417,62 +6365,89 @@ bool rfc3095_decomp_attempt_repair(const struct rohc_decomp *const decomp,
 	                                                 ROHC_LSB_REF_MINUS_1);
 	bool verdict = false;
 
-	/* do not try to repair packet/context if feature is disabled */
-	if((decomp->features & ROHC_DECOMP_FEATURE_CRC_REPAIR) == 0)
+	/* the regular interpretation of the SN failed too and no candidate
+	 * correction remains */
+	if(crc_corr->algo == ROHC_DECOMP_CRC_CORR_SN_IN_ORDER &&
+	   crc_corr->cands_nr == 0)
 	{
-		rohc_decomp_warn(context, "CID %zu: CRC repair: feature disabled",
-		                 context->cid);
+		rohc_decomp_warn(context, "CID %zu: CRC repair: SN interpretation "
+		                 "without reorder window failed too", context->cid);
+		crc_corr->algo = ROHC_DECOMP_CRC_CORR_SN_NONE;
 		goto skip;
 	}
 
-	/* do not try to repair packet/context if repair is already in action */
-	if(crc_corr->algo != ROHC_DECOMP_CRC_CORR_SN_NONE)
+	/* do not try to repair packet/context if feature is disabled, unless the
+	 * SN was decoded with the reorder window */
+	if((d_features(decomp) & ROHC_DECOMP_FEATURE_CRC_REPAIR) == 0 &&
+	   rfc3095_decomp_get_reorder_offset(context, extr_bits->sn_nr) == 0)
 	{
-		rohc_decomp_warn(context, "CID %zu: CRC repair: repair already in action",
+		rohc_decomp_warn(context, "CID %zu: CRC repair: feature disabled",
 		                 context->cid);
 		goto skip;
 	}
 
-	/* no correction attempt shall be already running */
-	assert(crc_corr->counter == 0);
-
-	/* try to guess the correct SN value in case of failure */
-	rohc_decomp_warn(context, "CID %zu: CRC repair: attempt to correct SN",
-	                 context->cid);
-
-	/* step b of RFC3095, §5.3.2.2.4. Correction of SN LSB wraparound:
-	 *   When decompression fails, the decompressor computes the time
-	 *   elapsed between the arrival of the previous, correctly decompressed
-	 *   packet and the current packet.
-	 *
-	 * step c of RFC3095, §5.3.2.2.4. Correction of SN LSB wraparound:
-	 *   If wraparound has occurred, INTERVAL will correspond to at least
-	 *   2^k inter-packet times, where k is the number of SN bits in the
-	 *   current header. */
-	if(is_sn_wraparound(pkt_arrival_time, crc_corr->arrival_times,
-	                    crc_corr->arrival_times_nr, crc_corr->arrival_times_index,
-	                    extr_bits->sn_nr, rfc3095_ctxt->sn_lsb_p))
+	if(crc_corr->algo != ROHC_DECOMP_CRC_CORR_SN_NONE)
 	{
-		rohc_decomp_warn(context, "CID %zu: CRC repair: CRC failure seems to "
-		                 "be caused by a sequence number LSB wraparound",
-		                 context->cid);
+		/* do not try to repair packet/context if repair is already in action,
+		 * unless candidate corrections remain for the current packet */
+		if(crc_corr->cands_nr == 0)
+		{
+			rohc_decomp_warn(context, "CID %zu: CRC repair: repair already in "
+			                 "action", context->cid);
+			goto skip;
+		}
+		rohc_decomp_warn(context, "CID %zu: CRC repair: correction failed, try "
+		                 "the next candidate correction", context->cid);
+	}
+	else
+	{
+		/* no correction attempt shall be already running */
+		assert(crc_corr->counter == 0);
 
-		crc_corr->algo = ROHC_DECOMP_CRC_CORR_SN_WRAP;
+		/* try to guess the correct SN value in case of failure */
+		rohc_decomp_warn(context, "CID %zu: CRC repair: attempt to correct SN",
+		                 context->cid);
+		if(rfc3095_decomp_get_repair_cands(context, pkt_arrival_time, crc_corr,
+		                                   extr_bits) == 0)
+		{
+			/* step e of RFC3095, §5.3.2.2.5. Repair of incorrect SN updates:
+			 *   If the decompressed header generated in b. does not pass the CRC
+			 *   test and SN curr2 is the same as SN curr1, an additional
+			 *   decompression attempt is not useful and is not attempted. */
+			rohc_decomp_warn(context, "CID %zu: CRC repair: repair is not useful",
+			                 context->cid);
+			goto skip;
+		}
+	}
 
+	/* try the first remaining candidate correction */
+	crc_corr->algo = crc_corr->cands[0];
+	crc_corr->cands_nr--;
+	memmove(crc_corr->cands, crc_corr->cands + 1,
+	        crc_corr->cands_nr * sizeof(rohc_decomp_crc_corr_t));
+	extr_bits->lsb_ref_type = ROHC_LSB_REF_0;
+	extr_bits->sn_ref_offset = 0;
+	if(crc_corr->algo == ROHC_DECOMP_CRC_CORR_SN_WRAP)
+	{
 		/* step d of RFC3095, §5.3.2.2.4. Correction of SN LSB wraparound:
 		 *   add 2^k to the reference SN and attempts to decompress the
 		 *   packet using the new reference SN */
-		extr_bits->sn_ref_offset = (1 << extr_bits->sn_nr);
+		extr_bits->sn_ref_offset = (1U << extr_bits->sn_nr);
 		rohc_decomp_warn(context, "CID %zu: CRC repair: try adding 2^k = 2^%zu "
 		                 "= %u to reference SN (ref 0 = %u)", context->cid,
 		                 extr_bits->sn_nr, extr_bits->sn_ref_offset, sn_ref_0);
 	}
-	else if(sn_ref_0 != sn_ref_minus_1)
+	else if(crc_corr->algo == ROHC_DECOMP_CRC_CORR_SN_IN_ORDER)
 	{
-		rohc_decomp_warn(context, "CID %zu: CRC repair: CRC failure seems to "
-		                 "be caused by an incorrect SN update", context->cid);
-
-		crc_corr->algo = ROHC_DECOMP_CRC_CORR_SN_UPDATES;
+		/* the packet is not a late packet, the SN is decoded without the
+		 * reorder window */
+		rohc_decomp_warn(context, "CID %zu: CRC repair: try decoding SN "
+		                 "without reorder window (ref 0 = %u)", context->cid,
+		                 sn_ref_0);
+	}
+	else
+	{
+		assert(crc_corr->algo == ROHC_DECOMP_CRC_CORR_SN_UPDATES);
 
 		/* step d of RFC3095, §5.3.2.2.5. Repair of incorrect SN updates:
 		 *   If the header generated in b. does not pass the CRC test, and the
@@ -5484,24 +6459,245 @@ bool rfc3095_decomp_attempt_repair(const struct rohc_decomp *const decomp,
 		                 "as reference SN instead of ref 0 (%u)",
 		                 context->cid, sn_ref_minus_1, sn_ref_0);
 	}
+
+	/* packet/context correction is going to be attempted, 3 packets with
+	 * correct CRC are required to accept the correction, but the regular
+	 * interpretation of the SN is accepted at once */
+	if(crc_corr->algo == ROHC_DECOMP_CRC_CORR_SN_IN_ORDER)
+	{
+		crc_corr->counter = 0;
+	}
 	else
 	{
-		/* step e of RFC3095, §5.3.2.2.5. Repair of incorrect SN updates:
-		 *   If the decompressed header generated in b. does not pass the CRC
-		 *   test and SN curr2 is the same as SN curr1, an additional
-		 *   decompression attempt is not useful and is not attempted. */
-		rohc_decomp_warn(context, "CID %zu: CRC repair: repair is not useful",
+		crc_corr->counter = 3;
+	}
+	verdict = true;
+
+skip:
+	return verdict;
+}
+
+
+/**
+ * @brief Determine the candidate corrections for one CRC failure
+ *
+ * The regular interpretation of the SN comes first if the SN was decoded
+ * with the reorder window. Then comes one correction of RFC3095: correction
+ * of SN LSB wraparound if a wraparound is detected, repair of incorrect SN
+ * updates otherwise.
+ *
+ * The regular interpretation and the wraparound correction only change the
+ * reference of the SN, so they are discarded if they decode the SN of the
+ * failed attempt. The repair of incorrect SN updates decodes all the LSB
+ * fields with ref -1, so it is kept as long as ref -1 differs from ref 0,
+ * even if it decodes the SN of the failed attempt.
+ *
+ * @param context           The decompression context
+ * @param pkt_arrival_time  The arrival time of the ROHC packet that caused
+ *                          the CRC failure
+ * @param[out] crc_corr     The context for corrections upon CRC failures
+ * @param extr_bits         The bits extracted from the ROHC header, as used by
+ *                          the decompression attempt that failed
+ * @return                  The number of candidate corrections
+ */
+static size_t rfc3095_decomp_get_repair_cands(const struct rohc_decomp_ctxt *const context,
+                                              const struct rohc_ts pkt_arrival_time,
+                                              struct rohc_decomp_crc_corr_ctxt *const crc_corr,
+                                              const struct rohc_extr_bits *const extr_bits)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt =
+		context->persist_ctxt;
+	uint32_t in_order_sn = 0;
+	uint32_t failed_sn;
+	bool is_late;
+	uint32_t sn;
+
+	crc_corr->cands_nr = 0;
+
+	/* only the SN transmitted with W-LSB encoding may be wrongly decoded */
+	if(!extr_bits->is_sn_enc)
+	{
+		rohc_decomp_warn(context, "CID %zu: CRC repair: SN is not encoded",
 		                 context->cid);
 		goto skip;
 	}
 
-	/* packet/context correction is going to be attempted, 3 packets with
-	 * correct CRC are required to accept the correction */
-	crc_corr->counter = 3;
-	verdict = true;
+	/* the SN decoded by the failed decompression attempt */
+	if(!rfc3095_decomp_decode_sn(context, extr_bits->lsb_ref_type,
+	                             extr_bits->sn_ref_offset, extr_bits->sn,
+	                             extr_bits->sn_nr, &failed_sn, &is_late))
+	{
+		goto skip;
+	}
+
+	/* the SN decoded with the reorder window may belong to a packet sent
+	 * after a burst of lost packets: decode SN without the reorder window */
+	if(rfc3095_decomp_get_reorder_offset(context, extr_bits->sn_nr) != 0 &&
+	   rohc_lsb_decode(rfc3095_ctxt->sn_lsb_ctxt, ROHC_LSB_REF_0, 0,
+	                   extr_bits->sn, extr_bits->sn_nr, rfc3095_ctxt->sn_lsb_p,
+	                   &sn) &&
+	   sn != failed_sn)
+	{
+		rohc_decomp_warn(context, "CID %zu: CRC repair: CRC failure may be "
+		                 "caused by the reorder window (SN %u instead of %u)",
+		                 context->cid, sn, failed_sn);
+		in_order_sn = sn;
+		crc_corr->cands[crc_corr->cands_nr] = ROHC_DECOMP_CRC_CORR_SN_IN_ORDER;
+		crc_corr->cands_nr++;
+	}
+
+	/* the corrections of RFC3095 are not attempted if the feature is
+	 * disabled */
+	if((d_features(context->decompressor) & ROHC_DECOMP_FEATURE_CRC_REPAIR) == 0)
+	{
+		goto skip;
+	}
+
+	/* step b of RFC3095, §5.3.2.2.4. Correction of SN LSB wraparound:
+	 *   When decompression fails, the decompressor computes the time
+	 *   elapsed between the arrival of the previous, correctly decompressed
+	 *   packet and the current packet.
+	 *
+	 * step c of RFC3095, §5.3.2.2.4. Correction of SN LSB wraparound:
+	 *   If wraparound has occurred, INTERVAL will correspond to at least
+	 *   2^k inter-packet times, where k is the number of SN bits in the
+	 *   current header.
+	 *
+	 * Once a wraparound is detected, only the correction of the wraparound
+	 * is attempted. */
+	if(is_sn_wraparound(pkt_arrival_time, crc_corr->arrival_times,
+	                    crc_corr->arrival_times_nr, crc_corr->arrival_times_index,
+	                    extr_bits->sn_nr, rfc3095_ctxt->sn_lsb_p))
+	{
+		if(rohc_lsb_decode(rfc3095_ctxt->sn_lsb_ctxt, ROHC_LSB_REF_0,
+		                   (1U << extr_bits->sn_nr), extr_bits->sn,
+		                   extr_bits->sn_nr, rfc3095_ctxt->sn_lsb_p, &sn) &&
+		   sn != failed_sn &&
+		   (crc_corr->cands_nr == 0 || sn != in_order_sn))
+		{
+			rohc_decomp_warn(context, "CID %zu: CRC repair: CRC failure seems to "
+			                 "be caused by a sequence number LSB wraparound (SN %u "
+			                 "instead of %u)", context->cid, sn, failed_sn);
+			crc_corr->cands[crc_corr->cands_nr] = ROHC_DECOMP_CRC_CORR_SN_WRAP;
+			crc_corr->cands_nr++;
+		}
+	}
+	else if(rohc_lsb_get_ref(rfc3095_ctxt->sn_lsb_ctxt, ROHC_LSB_REF_0) !=
+	        rohc_lsb_get_ref(rfc3095_ctxt->sn_lsb_ctxt, ROHC_LSB_REF_MINUS_1))
+	{
+		/* step d of RFC3095, §5.3.2.2.5. Repair of incorrect SN updates:
+		 *   the fields are decoded again with ref -1 as the reference; the
+		 *   other LSB fields change even if SN curr2 equals SN curr1 */
+		rohc_decomp_warn(context, "CID %zu: CRC repair: CRC failure seems to "
+		                 "be caused by an incorrect SN update", context->cid);
+		crc_corr->cands[crc_corr->cands_nr] = ROHC_DECOMP_CRC_CORR_SN_UPDATES;
+		crc_corr->cands_nr++;
+	}
+	assert(crc_corr->cands_nr <= ROHC_DECOMP_CRC_CORR_CANDS_MAX);
 
 skip:
-	return verdict;
+	return crc_corr->cands_nr;
+}
+
+
+/**
+ * @brief Get the offset of the reference SN for the reorder window
+ *
+ * The interpretation interval of the SN is shifted on the left by the
+ * reorder window, so that the late packets are decoded before the reference
+ * SN. The shift keeps at least half of the values after the reference SN in
+ * the interval, and it is not applied in R-mode, where the compressor may
+ * encode the SN from an old acknowledged reference, nor while a correction
+ * upon CRC failure is running.
+ *
+ * @param context  The decompression context
+ * @param sn_nr    The number k of SN bits in the packet
+ * @return         The offset to add to the reference SN (modulo 2^32),
+ *                 0 if the reorder window is not applied
+ */
+static uint32_t rfc3095_decomp_get_reorder_offset(const struct rohc_decomp_ctxt *const context,
+                                                  const size_t sn_nr)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt =
+		context->persist_ctxt;
+	int64_t forward_width;
+	size_t shift;
+
+	if(context->decompressor->reorder_window == 0 ||
+	   context->mode == ROHC_R_MODE ||
+	   context->crc_corr.algo != ROHC_DECOMP_CRC_CORR_SN_NONE ||
+	   sn_nr >= 32)
+	{
+		return 0;
+	}
+
+	/* the values after the reference SN in the interpretation interval */
+	forward_width = (((int64_t) 1) << sn_nr) - 1 -
+	                rohc_interval_compute_p(sn_nr, rfc3095_ctxt->sn_lsb_p);
+	if(forward_width <= 1)
+	{
+		return 0;
+	}
+	shift = rohc_min(context->decompressor->reorder_window,
+	                 (size_t) (forward_width / 2));
+
+	return (uint32_t) (0 - shift);
+}
+
+
+/**
+ * @brief Decode the SN of one packet, with the reorder window if any
+ *
+ * @param context      The decompression context
+ * @param ref_type     The reference SN to use to decode
+ * @param ref_offset   The offset to apply on the reference SN
+ * @param sn_bits      The LSB bits of the SN
+ * @param sn_nr        The number of LSB bits of the SN
+ * @param[out] sn      The decoded SN
+ * @param[out] is_late Whether the packet is a late packet of the reorder
+ *                     window, ie. its SN is decoded before the reference SN
+ * @return             true if SN was successfully decoded, false otherwise
+ */
+static bool rfc3095_decomp_decode_sn(const struct rohc_decomp_ctxt *const context,
+                                     const rohc_lsb_ref_t ref_type,
+                                     const uint32_t ref_offset,
+                                     const uint32_t sn_bits,
+                                     const size_t sn_nr,
+                                     uint32_t *const sn,
+                                     bool *const is_late)
+{
+	const struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt =
+		context->persist_ctxt;
+	const uint32_t reorder_offset =
+		rfc3095_decomp_get_reorder_offset(context, sn_nr);
+
+	if(!rohc_lsb_decode(rfc3095_ctxt->sn_lsb_ctxt, ref_type,
+	                    ref_offset + reorder_offset, sn_bits, sn_nr,
+	                    rfc3095_ctxt->sn_lsb_p, sn))
+	{
+		goto error;
+	}
+
+	/* the late packets are decoded in the part of the interpretation interval
+	 * added by the reorder window, before the reference SN */
+	*is_late = false;
+	if(reorder_offset != 0)
+	{
+		const uint32_t sn_mask =
+			(context->profile->id == ROHC_PROFILE_ESP ? 0xffffffff : 0xffff);
+		const uint32_t sn_ref =
+			rohc_lsb_get_ref(rfc3095_ctxt->sn_lsb_ctxt, ROHC_LSB_REF_0);
+		const uint32_t late_dist = (sn_ref - (*sn)) & sn_mask;
+		const int64_t late_dist_max = ((int64_t) (0 - reorder_offset)) +
+			rohc_interval_compute_p(sn_nr, rfc3095_ctxt->sn_lsb_p);
+
+		*is_late = (late_dist > 0 && late_dist <= late_dist_max);
+	}
+
+	return true;
+
+error:
+	return false;
 }
 
 
@@ -5610,6 +6806,8 @@ bool rfc3095_decomp_decode_bits(const struct rohc_decomp_ctxt *const context,
 	bool decode_ok;
 
 	decoded->is_context_reused = bits->is_context_reused;
+	decoded->static_chain = bits->static_chain;
+	decoded->static_chain_len = bits->static_chain_len;
 
 	/* decode context mode */
 	if(bits->mode_nr > 0 && bits->mode != 0)
@@ -5625,6 +6823,7 @@ bool rfc3095_decomp_decode_bits(const struct rohc_decomp_ctxt *const context,
 	if(!bits->is_sn_enc)
 	{
 		/* SN is not encoded: either take the value unchanged or deduce it */
+		decoded->is_late = false;
 		if(bits->sn_nr == 16 || bits->sn_nr == 32)
 		{
 			decoded->sn = bits->sn; /* take packet value unchanged */
@@ -5646,9 +6845,10 @@ bool rfc3095_decomp_decode_bits(const struct rohc_decomp_ctxt *const context,
 	else
 	{
 		/* decode SN from packet bits and context */
-		decode_ok = rohc_lsb_decode(rfc3095_ctxt->sn_lsb_ctxt, bits->lsb_ref_type,
-		                            bits->sn_ref_offset, bits->sn, bits->sn_nr,
-		                            rfc3095_ctxt->sn_lsb_p, &decoded->sn);
+		decode_ok = rfc3095_decomp_decode_sn(context, bits->lsb_ref_type,
+		                                     bits->sn_ref_offset, bits->sn,
+		                                     bits->sn_nr, &decoded->sn,
+		                                     &decoded->is_late);
 		if(!decode_ok)
 		{
 			rohc_decomp_warn(context, "failed to decode %zu SN bits 0x%x",
@@ -5663,6 +6863,24 @@ bool rfc3095_decomp_decode_bits(const struct rohc_decomp_ctxt *const context,
 	/* maybe current packet changed the number of IP headers */
 	decoded->multiple_ip = bits->multiple_ip;
 
+	/* the header template may be patched if the packet transmits no static
+	 * or dynamic field, but the TOS and TTL of IPv4 headers */
+	decoded->is_tmpl_usable =
+		!!(!bits->is_context_reused &&
+		   bits->multiple_ip == rfc3095_ctxt->tmpl.decoded.multiple_ip &&
+		   is_ip_tmpl_usable(&bits->outer_ip,
+		                     rfc3095_ctxt->tmpl.decoded.outer_ip.version,
+		                     &rfc3095_ctxt->list_decomp1) &&
+		   (!bits->multiple_ip ||
+		    is_ip_tmpl_usable(&bits->inner_ip,
+		                      rfc3095_ctxt->tmpl.decoded.inner_ip.version,
+		                      rfc3095_ctxt->list_decomp2)) &&
+		   bits->udp_src_nr == 0 && bits->udp_dst_nr == 0 &&
+		   bits->udp_check_present == ROHC_TRISTATE_NONE &&
+		   bits->rtp_version_nr == 0 && bits->rtp_p_nr == 0 &&
+		   bits->rtp_x_nr == 0 && bits->rtp_cc_nr == 0 && bits->rtp_pt_nr == 0 &&
+		   bits->rtp_ssrc_nr == 0);
+
 	/* decode fields related to the outer IP header */
 	decode_ok = decode_ip_values_from_bits(context, rfc3095_ctxt->outer_ip_changes,
 	                                       rfc3095_ctxt->outer_ip_id_offset_ctxt,
@@ -5694,9 +6912,11 @@ bool rfc3095_decomp_decode_bits(const struct rohc_decomp_ctxt *const context,
 	}
 
 	/* decode fields of next header if required */
-	if(rfc3095_ctxt->decode_values_from_bits != NULL)
+	if(rfc3095_ctxt->ops->decode_values_from_bits != NULL)
 	{
-		decode_ok = rfc3095_ctxt->decode_values_from_bits(context, bits, decoded);
+		decode_ok = rohc_decomp_rfc3095_call(rfc3095_ctxt, decode_values_from_bits,
+		                                     rtp_decode_values_from_bits,
+		                                     context, bits, decoded);
 		if(!decode_ok)
 		{
 			rohc_decomp_warn(context, "failed to decode fields of the next header");
@@ -6115,6 +7335,42 @@ void rfc3095_decomp_update_ctxt(struct rohc_decomp_ctxt *const context,
 	struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt = context->persist_ctxt;
 	bool keep_ref_minus_1; /* for action upon CRC failure */
 
+	/* the late packets of the reorder window are older than the context:
+	 * deliver them without updating the context */
+	if(decoded->is_late)
+	{
+		const uint32_t sn_mask =
+			(context->profile->id == ROHC_PROFILE_ESP ? 0xffffffff : 0xffff);
+		const uint32_t sn_context = context->profile->get_sn(context);
+
+		rohc_info(context->decompressor, ROHC_TRACE_DECOMP, context->profile->id,
+		          "packet comes late within the reorder window (SN 0x%x while "
+		          "context SN is 0x%x), context is left unchanged", decoded->sn,
+		          sn_context);
+		context->nr_lost_packets = 0;
+		context->nr_misordered_packets = (sn_context + 1 - decoded->sn) & sn_mask;
+		context->is_duplicated = false;
+		rfc3095_ctxt->tmpl.is_pending = false;
+		*do_change_mode = false;
+		return;
+	}
+
+	/* keep the static chain of the IR packet to recognize the next IR
+	 * packets that do not change it */
+	if(decoded->static_chain != NULL)
+	{
+		if(decoded->static_chain_len <= ROHC_DECOMP_RFC3095_STATIC_CHAIN_MAX_LEN)
+		{
+			memcpy(rfc3095_ctxt->static_chain, decoded->static_chain,
+			       decoded->static_chain_len);
+			rfc3095_ctxt->static_chain_len = decoded->static_chain_len;
+		}
+		else
+		{
+			rfc3095_ctxt->static_chain_len = 0;
+		}
+	}
+
 	/* action upon CRC failure: in case of incorrect SN updates, ref-1 shall not
 	 * be replaced by ref0 in the LSB context */
 	if(context->crc_corr.algo == ROHC_DECOMP_CRC_CORR_SN_UPDATES &&
@@ -6132,9 +7388,20 @@ void rfc3095_decomp_update_ctxt(struct rohc_decomp_ctxt *const context,
 		keep_ref_minus_1 = false;
 	}
 
+	/* RFC 3095, §5.6.3 and §5.6.4: enter R-mode when the compressor sends
+	 * packets in R-mode as requested by the decompressor, the ACK(R) of the
+	 * packet ends the transition on the compressor side */
+	if(decoded->mode == ROHC_R_MODE && context->mode != ROHC_R_MODE &&
+	   context->decompressor->target_mode == ROHC_R_MODE)
+	{
+		rohc_decomp_debug(context, "compressor operates in R-mode, so transit "
+		                  "to R-mode");
+		rohc_decomp_change_mode(context, ROHC_R_MODE);
+		*do_change_mode = true;
+	}
 	/* tell compressor about the current decompressor's operating mode
 	 * if they are different */
-	if(decoded->mode != context->mode)
+	else if(decoded->mode != context->mode)
 	{
 		rohc_decomp_debug(context, "mode different in compressor (%d) and "
 		                  "decompressor (%d)", decoded->mode, context->mode);
@@ -6233,6 +7500,10 @@ void rfc3095_decomp_update_ctxt(struct rohc_decomp_ctxt *const context,
 
 	/* maybe current packet changed the number of IP headers */
 	rfc3095_ctxt->multiple_ip = decoded->multiple_ip;
+	rfc3095_ctxt->is_ipv4_udp_rtp =
+		(context->profile->id == ROHC_PROFILE_RTP &&
+		 !decoded->multiple_ip &&
+		 decoded->outer_ip.version == IPV4);
 
 	/* update fields related to the outer IP header */
 	ip_set_version(&rfc3095_ctxt->outer_ip_changes->ip, decoded->outer_ip.version);
@@ -6283,9 +7554,25 @@ void rfc3095_decomp_update_ctxt(struct rohc_decomp_ctxt *const context,
 	}
 
 	/* update context with decoded fields for next header if required */
-	if(rfc3095_ctxt->update_context != NULL)
+	if(rfc3095_ctxt->ops->update_context != NULL)
+	{
+		rohc_decomp_rfc3095_call(rfc3095_ctxt, update_context,
+		                         rtp_update_context, context, decoded);
+	}
+
+	/* the headers built for the packet become the template for the fast path,
+	 * forget the previous template otherwise */
+	if(rfc3095_ctxt->tmpl.is_pending)
+	{
+		rfc3095_ctxt->tmpl.cur = !rfc3095_ctxt->tmpl.cur;
+		memcpy(&rfc3095_ctxt->tmpl.decoded, decoded,
+		       sizeof(struct rohc_decoded_values));
+		rfc3095_ctxt->tmpl.is_valid = true;
+		rfc3095_ctxt->tmpl.is_pending = false;
+	}
+	else
 	{
-		rfc3095_ctxt->update_context(context, decoded);
+		rfc3095_ctxt->tmpl.is_valid = false;
 	}
 }
 
@@ -6302,12 +7589,13 @@ static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095
 	assert(rfc3095_ctxt != NULL);
 	assert(bits != NULL);
 
-	/* set every bits and sizes to 0 except for CCE-related variables */
+	/* set every bits and sizes to 0 except for CCE-related variables and for
+	 * the inner IP header that is reset below only if the context has one */
 	{
 		const rohc_packet_cce_t cce_pkt = bits->cce_pkt;
 		const rohc_tristate_t cfp = bits->cfp;
 		const rohc_tristate_t cfi = bits->cfi;
-		memset(bits, 0, sizeof(struct rohc_extr_bits));
+		memset(bits, 0, offsetof(struct rohc_extr_bits, inner_ip));
 		bits->cce_pkt = cce_pkt;
 		bits->cfp = cfp;
 		bits->cfi = cfi;
@@ -6335,6 +7623,7 @@ static void reset_extr_bits(const struct rohc_decomp_rfc3095_ctxt *const rfc3095
 	/* set IP version and NBO/RND flags for inner IP header (if any) */
 	if(bits->multiple_ip)
 	{
+		memset(&bits->inner_ip, 0, sizeof(struct rohc_extr_ip_bits));
 		bits->inner_ip.version = ip_get_version(&rfc3095_ctxt->inner_ip_changes->ip);
 		bits->inner_ip.nbo = rfc3095_ctxt->inner_ip_changes->nbo;
 		bits->inner_ip.rnd = rfc3095_ctxt->inner_ip_changes->rnd;
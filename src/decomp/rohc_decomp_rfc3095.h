@@ -114,13 +114,18 @@ struct rohc_extr_bits
 {
 	bool is_context_reused; /**< Whether the context is re-used or not */
 
+	/** The static chain of the IR packet, NULL if not parsed */
+	const uint8_t *static_chain;
+	/** The length of the static chain of the IR packet */
+	size_t static_chain_len;
+
 	/* SN */
 	uint32_t sn;         /**< The SN bits found in ROHC header */
 	size_t sn_nr;        /**< The number of SN bits found in ROHC header */
 	bool is_sn_enc;      /**< Whether value(SN) is encoded with W-LSB or not */
 	rohc_lsb_ref_t lsb_ref_type; /**< The reference to use for LSB decoding
 	                                  (used for context repair after CRC failure) */
-	bool sn_ref_offset;         /**< Optional offset to add to the reference SN
+	uint32_t sn_ref_offset;     /**< Optional offset to add to the reference SN
 	                                 (used for context repair after CRC failure) */
 
 	/** Whether there are multiple IP headers or only one single IP header */
@@ -129,9 +134,6 @@ struct rohc_extr_bits
 	/** bits related to outer IP header */
 	struct rohc_extr_ip_bits outer_ip;
 
-	/** bits related to inner IP header */
-	struct rohc_extr_ip_bits inner_ip;
-
 	/* X (extension) flag */
 	uint8_t ext_flag:1;     /**< X (extension) flag */
 
@@ -226,6 +228,11 @@ struct rohc_extr_bits
 	uint32_t esp_spi;      /**< The SPI bits found in static chain of
 	                             IR header */
 	size_t esp_spi_nr;     /**< The number of SPI bits found in header */
+
+
+	/** bits related to inner IP header, only valid if multiple_ip is set
+	 *  (kept last so that it is not reset for single IP header packets) */
+	struct rohc_extr_ip_bits inner_ip;
 };
 
 
@@ -258,11 +265,21 @@ struct rohc_decoded_values
 	bool is_context_reused; /**< Whether the context is re-used or not */
 
 	uint32_t sn;  /**< The decoded SN value */
+	/** Whether the packet is a late packet of the reorder window */
+	bool is_late;
+
+	/** The static chain of the IR packet, NULL if not parsed */
+	const uint8_t *static_chain;
+	/** The length of the static chain of the IR packet */
+	size_t static_chain_len;
 
 	rohc_mode_t mode;  /**< The operation mode asked by compressor */
 
 	/** Whether there are multiple IP headers or only one single IP header */
 	bool multiple_ip;
+	/** Whether the packet changed no other field than the ones patched in
+	 *  the header template */
+	bool is_tmpl_usable;
 	/** The decoded values for the outer IP header */
 	struct rohc_decoded_ip_values outer_ip;
 	/** The decoded values for the inner IP header */
@@ -300,6 +317,67 @@ struct rohc_decoded_values
 };
 
 
+/**
+ * @brief The bits extracted from UO-0 and UO-1 base headers by the fast path
+ *
+ * Only the few fields that UO-0, UO-1 and UO-1-RTP packets may transmit are
+ * extracted, all the other fields are taken from the header template.
+ */
+struct rohc_extr_uo_bits
+{
+	uint8_t sn;        /**< The SN LSB bits */
+	uint8_t sn_nr;     /**< The number of SN LSB bits */
+	uint8_t ip_id;     /**< The outer IP-ID LSB bits */
+	uint8_t ip_id_nr;  /**< The number of outer IP-ID LSB bits */
+	uint8_t ts;        /**< The TS_SCALED LSB bits (RTP profile only) */
+	uint8_t ts_nr;     /**< The number of TS_SCALED LSB bits */
+	uint8_t rtp_m;     /**< The RTP Marker (M) flag (RTP profile only) */
+	uint8_t crc;       /**< The 3-bit CRC on uncompressed headers */
+};
+
+
+/** The maximum length of the header template: two IPv6 headers, plus the
+ *  UDP and RTP headers */
+#define ROHC_DECOMP_RFC3095_TMPL_MAX_LEN  100U
+
+/** The maximum length of the static chain kept in context: two IPv6
+ *  headers, plus the UDP and RTP static parts */
+#define ROHC_DECOMP_RFC3095_STATIC_CHAIN_MAX_LEN  96U
+
+
+/**
+ * @brief The uncompressed headers of the last packet successfully decompressed
+ *
+ * Most UO* packets transmit a few changing fields only, all the other fields
+ * of the uncompressed headers are the same as in the previous packet. The
+ * headers built for the last packet are thus kept as a template: as long as
+ * no static or dynamic field changes, the headers of the next packets are
+ * built by copying the template and patching the changing fields (SN, TS,
+ * M, IP-ID, UDP checksum) and the inferred ones (lengths, IPv4 checksum).
+ *
+ * The headers are recorded as pending when they are built, then they become
+ * the template once the context is updated with the values they were built
+ * from. Only packets with one or two IPv4 or IPv6 headers (without extension
+ * headers) are recorded: the static outer header of IP-in-IP tunnels is part
+ * of the template too.
+ */
+struct rohc_decomp_rfc3095_tmpl
+{
+	/** The template and the pending headers, see \e cur */
+	uint8_t hdrs[2][ROHC_DECOMP_RFC3095_TMPL_MAX_LEN];
+	/** The lengths of the template and of the pending headers */
+	size_t hdrs_len[2];
+	/** The index of the template in \e hdrs, the other one is pending */
+	size_t cur;
+	/** Whether the template may be used or not */
+	bool is_valid;
+	/** Whether headers were recorded for the packet being decompressed */
+	bool is_pending;
+	/** The values the template was built from */
+	struct rohc_decoded_values decoded;
+};
+
+
 /**
  * @brief Store information about an IP header between the different
  *        decompressions of IP packets.
@@ -328,45 +406,14 @@ struct rohc_decomp_rfc3095_changes
 
 
 /**
- * @brief The generic decompression context for RFC3095-based profiles
+ * @brief The profile-specific handlers of the RFC3095-based contexts
  *
- * The object defines the generic context that manages IP(/nextheader) and
- * IP/IP(/nextheader) packets. nextheader is managed by the profile-specific
- * part of the context.
+ * Every profile defines one constant table of handlers shared by all its
+ * contexts, see \ref rohc_decomp_rfc3095_create. The optional handlers are
+ * NULL if the profile does not need them.
  */
-struct rohc_decomp_rfc3095_ctxt
+struct rohc_decomp_rfc3095_ops
 {
-	/// Information about the outer IP header
-	struct rohc_decomp_rfc3095_changes *outer_ip_changes;
-	/// Information about the inner IP header
-	struct rohc_decomp_rfc3095_changes *inner_ip_changes;
-
-	/** The LSB shift parameter for the Sequence Number (SN) */
-	rohc_lsb_shift_t sn_lsb_p;
-	/// The LSB decoding context for the Sequence Number (SN)
-	struct rohc_lsb_decode *sn_lsb_ctxt;
-	/// The IP-ID of the outer IP header
-	struct ip_id_offset_decode *outer_ip_id_offset_ctxt;
-	/// The IP-ID of the inner IP header
-	struct ip_id_offset_decode *inner_ip_id_offset_ctxt;
-
-	/// The list decompressor of the outer IP header
-	struct list_decomp list_decomp1;
-	/// The list decompressor of the inner IP header
-	struct list_decomp list_decomp2;
-
-	/// Whether the decompressed packet contains a 2nd IP header
-	int multiple_ip;
-
-	/* below are some information and handlers to manage the next header
-	 * (if any) located just after the IP headers (1 or 2 IP headers) */
-
-	/// The IP protocol ID of the protocol the context is able to decompress
-	unsigned short next_header_proto;
-
-	/// The length of the next header
-	unsigned int next_header_len;
-
 	/// @brief The handler used to parse the static part of the next header
 	///        in the ROHC packet
 	int (*parse_static_next_hdr)(const struct rohc_decomp_ctxt *const context,
@@ -425,7 +472,8 @@ struct rohc_decomp_rfc3095_ctxt
 	                              const uint8_t *const next_header,
 	                              const rohc_crc_type_t crc_type,
 	                              const uint8_t init_val,
-	                              const uint8_t *const crc_table);
+	                              const uint8_t *const crc_table,
+	                              struct crc_static_cache *const cache);
 
 	/// @brief The handler used to compute the CRC-DYNAMIC value
 	uint8_t (*compute_crc_dynamic)(const uint8_t *const ip,
@@ -433,15 +481,120 @@ struct rohc_decomp_rfc3095_ctxt
 	                               const uint8_t *const next_header,
 	                               const rohc_crc_type_t crc_type,
 	                               const uint8_t init_val,
-	                               const uint8_t *const crc_table);
+	                               const uint8_t *const crc_table,
+	                               const struct crc_static_cache *const cache);
 
 	/** The handler used to update context with decoded next header fields */
 	void (*update_context)(struct rohc_decomp_ctxt *const context,
 	                       const struct rohc_decoded_values *const decoded)
 		__attribute__((nonnull(1, 2)));
 
+	/**
+	 * @brief The handler used by the fast path to decode the next header
+	 *
+	 * May be NULL if the profile does not support the fast path.
+	 *
+	 * @param context        The decompression context
+	 * @param bits           The bits extracted from the UO-0/UO-1 base header
+	 * @param rohc_data      The UO* remainder to parse
+	 * @param rohc_data_len  The length of the UO* remainder
+	 * @param[out] decoded   The decoded values of the next header
+	 * @return               The data length read from the ROHC packet,
+	 *                       -1 if the fast path cannot decode the packet
+	 */
+	int (*decode_fast_next_hdr)(const struct rohc_decomp_ctxt *const context,
+	                            const struct rohc_extr_uo_bits *const bits,
+	                            const uint8_t *const rohc_data,
+	                            const size_t rohc_data_len,
+	                            struct rohc_decoded_values *const decoded)
+		__attribute__((warn_unused_result, nonnull(1, 2, 3, 5)));
+
+	/**
+	 * @brief The handler used by the fast path to patch the next header
+	 *
+	 * @param decoded      The decoded values of the next header
+	 * @param dest         The next header copied from the template
+	 * @param payload_len  The length of the payload
+	 */
+	void (*patch_next_hdr)(const struct rohc_decoded_values *const decoded,
+	                       uint8_t *const dest,
+	                       const size_t payload_len)
+		__attribute__((nonnull(1, 2)));
+};
+
+
+/**
+ * @brief The generic decompression context for RFC3095-based profiles
+ *
+ * The object defines the generic context that manages IP(/nextheader) and
+ * IP/IP(/nextheader) packets. nextheader is managed by the profile-specific
+ * part of the context.
+ *
+ * The members are laid out by access frequency: the ones read for every
+ * packet first, the ones of the IR packets last.
+ */
+struct rohc_decomp_rfc3095_ctxt
+{
+	/** The profile-specific handlers, shared by all the contexts of the
+	 *  profile */
+	const struct rohc_decomp_rfc3095_ops *ops;
+
+	/// The LSB decoding context for the Sequence Number (SN)
+	struct rohc_lsb_decode *sn_lsb_ctxt;
+	/** The LSB shift parameter for the Sequence Number (SN) */
+	rohc_lsb_shift_t sn_lsb_p;
+
+	/// Whether the decompressed packet contains a 2nd IP header
+	bool multiple_ip;
+
+	/**
+	 * @brief Whether the context decompresses one IPv4 header followed by UDP
+	 *        and RTP headers
+	 *
+	 * The RTP handlers of such contexts are called directly by the generic
+	 * code instead of through the table of handlers, see
+	 * \ref rohc_decomp_rfc3095_call.
+	 */
+	bool is_ipv4_udp_rtp;
+
+	/* below are some information to manage the next header (if any) located
+	 * just after the IP headers (1 or 2 IP headers) */
+
+	/// The IP protocol ID of the protocol the context is able to decompress
+	uint8_t next_header_proto;
+	/// The length of the next header
+	uint16_t next_header_len;
+
+	/// The IP-ID of the outer IP header
+	struct ip_id_offset_decode *outer_ip_id_offset_ctxt;
+	/// The IP-ID of the inner IP header
+	struct ip_id_offset_decode *inner_ip_id_offset_ctxt;
+
+	/// Information about the outer IP header
+	struct rohc_decomp_rfc3095_changes *outer_ip_changes;
+	/// Information about the inner IP header
+	struct rohc_decomp_rfc3095_changes *inner_ip_changes;
+
 	/// Profile-specific data
 	void *specific;
+
+	/** The uncompressed headers of the last packet, see the fast path */
+	struct rohc_decomp_rfc3095_tmpl tmpl;
+
+	/** The CRC-STATIC bytes and CRCs of the last packet */
+	struct crc_static_cache crc_static_cache;
+
+	/// The list decompressor of the outer IP header
+	struct list_decomp list_decomp1;
+	/// The list decompressor of the inner IP header, NULL until the first
+	/// IR packet with two IP headers
+	struct list_decomp *list_decomp2;
+
+	/** The length of the static chain in context, 0 if none */
+	uint8_t static_chain_len;
+	/** The static chain of the last IR packet, compared with the static
+	 *  chain of the next IR packets, see \ref parse_ir */
+	uint8_t static_chain[ROHC_DECOMP_RFC3095_STATIC_CHAIN_MAX_LEN];
 };
 
 
@@ -450,17 +603,21 @@ struct rohc_decomp_rfc3095_ctxt
  */
 
 bool rohc_decomp_rfc3095_create(const struct rohc_decomp_ctxt *const context,
+                                const struct rohc_decomp_rfc3095_ops *const ops,
                                 struct rohc_decomp_rfc3095_ctxt **const persist_ctxt,
                                 struct rohc_decomp_volat_ctxt *const volat_ctxt,
                                 rohc_trace_callback2_t trace_cb,
                                 void *const trace_cb_priv,
                                 const int profile_id)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 4)));
 
 void rohc_decomp_rfc3095_destroy(struct rohc_decomp_rfc3095_ctxt *const rfc3095_ctxt,
                                  const struct rohc_decomp_volat_ctxt *const volat_ctxt)
 	__attribute__((nonnull(1, 2)));
 
+size_t rohc_decomp_rfc3095_mem_max(void)
+	__attribute__((warn_unused_result, const));
+
 bool rfc3095_decomp_parse_pkt(const struct rohc_decomp_ctxt *const context,
                               const struct rohc_buf rohc_packet,
                               const size_t large_cid_len,
@@ -480,6 +637,17 @@ rohc_status_t rfc3095_decomp_build_hdrs(const struct rohc_decomp *const decomp,
                                         size_t *const uncomp_hdrs_len)
 	__attribute__((warn_unused_result, nonnull(1, 2, 4, 5, 7, 8)));
 
+bool rfc3095_decomp_decode_fast(const struct rohc_decomp *const decomp,
+                                const struct rohc_decomp_ctxt *const context,
+                                const struct rohc_buf rohc_packet,
+                                const size_t large_cid_len,
+                                const rohc_packet_t packet_type,
+                                struct rohc_decoded_values *const decoded,
+                                struct rohc_buf *const uncomp_hdrs,
+                                size_t *const rohc_hdr_len,
+                                size_t *const uncomp_hdrs_len)
+	__attribute__((warn_unused_result, nonnull(1, 2, 6, 7, 8, 9)));
+
 bool rfc3095_decomp_decode_bits(const struct rohc_decomp_ctxt *const context,
                                 const struct rohc_extr_bits *const bits,
                                 const size_t payload_len __attribute__((unused)),
@@ -502,6 +670,9 @@ bool rfc3095_decomp_attempt_repair(const struct rohc_decomp *const decomp,
 uint32_t rohc_decomp_rfc3095_get_sn(const struct rohc_decomp_ctxt *const context)
 	__attribute__((warn_unused_result, nonnull(1)));
 
+void rohc_decomp_rfc3095_prefetch(const struct rohc_decomp_ctxt *const context)
+	__attribute__((nonnull(1)));
+
 
 
 /*
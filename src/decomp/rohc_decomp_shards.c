@@ -0,0 +1,322 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   rohc_decomp_shards.c
+ * @brief  ROHC sharded decompression routines
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * A sharded decompressor is made of several ROHC decompressors that share
+ * the CID space of one channel: every decompressor (shard) owns its own
+ * range of CIDs. The CID of every ROHC packet is decoded right after its
+ * padding and its feedback items, so that all the packets of one context
+ * are decompressed by the same shard, in the order they were received.
+ *
+ * The shards share no data, so every shard may be used by its own thread
+ * without any lock.
+ */
+
+#include "rohc_decomp_internals.h"
+#include "rohc_debug.h"
+#include "rohc_utils.h"
+#include "rohc_decomp_detect_packet.h"
+#include "feedback_parse.h"
+#include "rohc_add_cid.h"
+#include "sdvl.h"
+
+#include <assert.h>
+
+
+/**
+ * @brief The sharded ROHC decompressor
+ */
+struct rohc_decomp_shards
+{
+	/** The number of shards */
+	size_t shards_nr;
+	/** The type of CIDs of the channel */
+	rohc_cid_type_t cid_type;
+	/** The largest CID of the channel */
+	rohc_cid_t max_cid;
+	/** The number of CIDs of every shard (the last shard may have more) */
+	rohc_cid_t cids_per_shard;
+	/** The decompressors of the shards */
+	struct rohc_decomp **decomps;
+};
+
+
+/*
+ * Definitions of public functions
+ */
+
+/**
+ * @brief Create a new sharded ROHC decompressor
+ *
+ * Create a new sharded ROHC decompressor made of \e shards_nr ROHC
+ * decompressors that share the CID space [0, \e max_cid]. Every decompressor
+ * (shard) owns its own contiguous range of CIDs, so several threads may
+ * decompress packets of the same ROHC channel without any lock: every thread
+ * owns one shard.
+ *
+ * Every shard is a regular ROHC decompressor retrieved with
+ * \ref rohc_decomp_shards_get. All the shards shall be configured the same
+ * way (profiles, features, callbacks...) before decompressing packets.
+ *
+ * The packets of one context shall always be decompressed by the same shard
+ * in the order they were received: use \ref rohc_decomp_shards_select to get
+ * the shard of every packet, eg. from a dispatcher thread that hands every
+ * packet to the thread of its shard through one single-producer
+ * single-consumer queue per shard. Every shard returns the feedback to send
+ * for its own contexts: the feedback of all the shards shall be merged in
+ * the feedback channel towards the remote compressor.
+ *
+ * @param cid_type   The type of Context IDs (CID) that the ROHC decompressors
+ *                   shall operate with, see \ref rohc_decomp_new2
+ * @param max_cid    The maximum value that the ROHC decompressors should use
+ *                   for context IDs (CID), see \ref rohc_decomp_new2
+ * @param shards_nr  The number of shards, in range [1, \e max_cid + 1]
+ * @param mode       The operational mode of the decompressors,
+ *                   see \ref rohc_decomp_new2
+ * @return           The created sharded decompressor if successful,
+ *                   NULL if creation failed
+ *
+ * @warning Don't forget to free the sharded decompressor memory with
+ *          \ref rohc_decomp_shards_free if \e rohc_decomp_shards_new succeeded
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_shards_free
+ * @see rohc_decomp_shards_get
+ * @see rohc_decomp_shards_select
+ */
+struct rohc_decomp_shards * rohc_decomp_shards_new(const rohc_cid_type_t cid_type,
+                                                   const rohc_cid_t max_cid,
+                                                   const size_t shards_nr,
+                                                   const rohc_mode_t mode)
+{
+	struct rohc_decomp_shards *shards;
+	size_t i;
+
+	/* check input parameters, the other ones are checked when creating the
+	 * decompressors of the shards */
+	if(shards_nr == 0 || shards_nr > (max_cid + 1))
+	{
+		goto error;
+	}
+
+	shards = malloc(sizeof(struct rohc_decomp_shards));
+	if(shards == NULL)
+	{
+		goto error;
+	}
+	shards->shards_nr = shards_nr;
+	shards->cid_type = cid_type;
+	shards->max_cid = max_cid;
+	shards->cids_per_shard = (max_cid + 1) / shards_nr;
+
+	shards->decomps = calloc(shards_nr, sizeof(struct rohc_decomp *));
+	if(shards->decomps == NULL)
+	{
+		goto free_shards;
+	}
+
+	/* create the decompressors of the shards: every shard accepts the whole
+	 * CID space of the channel, but it only receives the packets of its own
+	 * CIDs, so it only allocates the contexts of its own CIDs */
+	for(i = 0; i < shards_nr; i++)
+	{
+		shards->decomps[i] = rohc_decomp_new2(cid_type, max_cid, mode);
+		if(shards->decomps[i] == NULL)
+		{
+			goto free_decomps;
+		}
+	}
+
+	return shards;
+
+free_decomps:
+	for(i = 0; i < shards_nr; i++)
+	{
+		if(shards->decomps[i] != NULL)
+		{
+			rohc_decomp_free(shards->decomps[i]);
+		}
+	}
+	zfree(shards->decomps);
+free_shards:
+	zfree(shards);
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Destroy the given sharded ROHC decompressor
+ *
+ * Destroy the given sharded ROHC decompressor and the decompressors of all
+ * its shards.
+ *
+ * @param shards  The sharded ROHC decompressor to destroy
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_shards_new
+ */
+void rohc_decomp_shards_free(struct rohc_decomp_shards *const shards)
+{
+	if(shards != NULL)
+	{
+		size_t i;
+
+		for(i = 0; i < shards->shards_nr; i++)
+		{
+			rohc_decomp_free(shards->decomps[i]);
+		}
+		free(shards->decomps);
+		free(shards);
+	}
+}
+
+
+/**
+ * @brief Get the ROHC decompressor of one shard
+ *
+ * The decompressor of the shard is a regular ROHC decompressor: configure it
+ * and decompress packets with the usual functions, eg. \ref rohc_decompress3.
+ * The decompressor shall not be freed with \ref rohc_decomp_free, it is freed
+ * with the sharded decompressor.
+ *
+ * @param shards    The sharded ROHC decompressor
+ * @param shard_id  The index of the shard, in range [0, shards_nr - 1]
+ * @return          The ROHC decompressor of the shard,
+ *                  NULL if one parameter is invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_shards_select
+ */
+struct rohc_decomp * rohc_decomp_shards_get(const struct rohc_decomp_shards *const shards,
+                                            const size_t shard_id)
+{
+	if(shards == NULL || shard_id >= shards->shards_nr)
+	{
+		goto error;
+	}
+
+	return shards->decomps[shard_id];
+
+error:
+	return NULL;
+}
+
+
+/**
+ * @brief Get the shard that shall decompress the given ROHC packet
+ *
+ * The padding and the feedback items at the beginning of the packet are
+ * skipped, then the CID of the packet is decoded and the shard that owns
+ * the CID is selected. The packets made of padding and feedback only, and
+ * the packets too short or malformed to carry a CID, are given to the first
+ * shard that reports them when decompressing them. The CIDs greater than
+ * the largest CID of the channel are given to the last shard that rejects
+ * them.
+ *
+ * The function neither modifies the sharded decompressor nor its shards, so
+ * it may be called from any thread, eg. the thread that dispatches the
+ * packets to the threads of the shards.
+ *
+ * @param shards         The sharded ROHC decompressor
+ * @param rohc_packet    The ROHC packet to decompress
+ * @param[out] shard_id  The index of the shard that shall decompress the
+ *                       packet
+ * @return               true if a shard was selected,
+ *                       false if one parameter is invalid
+ *
+ * @ingroup rohc_decomp
+ *
+ * @see rohc_decomp_shards_get
+ */
+bool rohc_decomp_shards_select(const struct rohc_decomp_shards *const shards,
+                               const struct rohc_buf rohc_packet,
+                               size_t *const shard_id)
+{
+	struct rohc_buf remain = rohc_packet;
+	rohc_cid_t cid = 0;
+
+	if(shards == NULL || shard_id == NULL || rohc_buf_is_malformed(rohc_packet))
+	{
+		goto error;
+	}
+
+	/* skip the padding */
+	rohc_buf_pull(&remain, rohc_decomp_padding_len(rohc_buf_data(remain),
+	                                               remain.len));
+
+	/* skip the feedback items */
+	while(remain.len > 0 && rohc_packet_is_feedback(rohc_buf_byte(remain)))
+	{
+		size_t feedback_hdr_len;
+		size_t feedback_data_len;
+
+		if(!rohc_feedback_get_size(remain, &feedback_hdr_len, &feedback_data_len) ||
+		   (feedback_hdr_len + feedback_data_len) > remain.len)
+		{
+			remain.len = 0;
+			break;
+		}
+		rohc_buf_pull(&remain, feedback_hdr_len + feedback_data_len);
+	}
+
+	/* decode the CID that follows, CID 0 if none */
+	if(remain.len > 0)
+	{
+		const uint8_t *const data = rohc_buf_data(remain);
+
+		if(shards->cid_type == ROHC_SMALL_CID)
+		{
+			cid = rohc_add_cid_decode(data, remain.len);
+			if(cid == UINT8_MAX)
+			{
+				cid = 0;
+			}
+		}
+		else if(remain.len > 1)
+		{
+			uint32_t large_cid;
+			size_t large_cid_bits_nr;
+
+			if(sdvl_decode(data + 1, remain.len - 1, &large_cid,
+			               &large_cid_bits_nr) != 0)
+			{
+				cid = large_cid & 0xffff;
+			}
+		}
+	}
+
+	*shard_id = rohc_min(cid, shards->max_cid) / shards->cids_per_shard;
+	if((*shard_id) >= shards->shards_nr)
+	{
+		/* the last shard gets the CIDs that remain */
+		*shard_id = shards->shards_nr - 1;
+	}
+
+	return true;
+
+error:
+	return false;
+}
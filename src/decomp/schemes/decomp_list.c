@@ -29,10 +29,21 @@
 
 #ifndef __KERNEL__
 #  include <string.h>
+#else
+#  include <bitops.h> /* for __builtin_popcount() in Linux kernel */
 #endif
 #include <assert.h>
 
 
+/**
+ * @brief The bit of the given item in an insertion/removal bit mask
+ *
+ * Bit masks are stored left-aligned on 16 bits: the bit of the first item is
+ * the MSB, whatever the length of the mask (7 or 15 bits).
+ */
+#define ROHC_LIST_MASK_BIT(item_pos) ((uint16_t) (0x8000U >> (item_pos)))
+
+
 /* decode the generic part of the compressed list */
 
 static int rohc_list_decode(struct list_decomp *decomp,
@@ -101,13 +112,12 @@ static int rohc_list_decode_mask(struct list_decomp *const decomp,
                                  const char *const descr,
                                  const uint8_t *const packet,
                                  const size_t packet_len,
-                                 uint8_t mask[2],
+                                 uint16_t *const mask,
                                  size_t *const mask_len)
-	__attribute__((warn_unused_result, nonnull(1, 2, 3, 6)));
+	__attribute__((warn_unused_result, nonnull(1, 2, 3, 5, 6)));
 
-static size_t rohc_list_get_xi_nr(const uint8_t ins_mask[2],
-                                  const size_t ins_mask_len)
-	__attribute__((warn_unused_result));
+static size_t rohc_list_get_xi_nr(const uint16_t ins_mask)
+	__attribute__((warn_unused_result, const));
 
 static size_t rohc_list_get_xi_len(const size_t xi_nr,
                                    const int ps)
@@ -126,9 +136,6 @@ static uint8_t rohc_list_get_xi_type_2or3(const int ps,
                                           bool *const is_item_present)
 	__attribute__((warn_unused_result, nonnull(4, 5)));
 
-static uint8_t rohc_get_bit(const uint8_t byte, const size_t pos)
-	__attribute__((warn_unused_result, const));
-
 
 
 /**
@@ -915,8 +922,8 @@ static int rohc_list_parse_insertion_scheme(struct list_decomp *const decomp,
                                             struct rohc_list *const ins_list)
 {
 	size_t packet_read_len = 0;
-	uint8_t mask[2]; /* removal bit mask on 1-2 bytes */
-	size_t mask_len; /* length (in bits) of the removal mask */
+	uint16_t mask; /* insertion bit mask, left-aligned */
+	size_t mask_len; /* length (in bits) of the insertion mask */
 	size_t item_read_len; /* the amount of bytes currently read in the item field */
 	size_t ref_list_cur_pos; /* current position in reference list */
 	int ref_list_miss; /* the index of the first missing item in reference list */
@@ -930,7 +937,7 @@ static int rohc_list_parse_insertion_scheme(struct list_decomp *const decomp,
 
 	/* parse the insertion bit mask */
 	ret = rohc_list_decode_mask(decomp, "insertion", packet, packet_len,
-	                            mask, &mask_len);
+	                            &mask, &mask_len);
 	if(ret < 0)
 	{
 		rd_list_warn(decomp, "failed to parse the insertion bit mask");
@@ -941,7 +948,7 @@ static int rohc_list_parse_insertion_scheme(struct list_decomp *const decomp,
 	packet_len -= ret;
 
 	/* determine the number of indexes in the XI list */
-	k = rohc_list_get_xi_nr(mask, mask_len);
+	k = rohc_list_get_xi_nr(mask);
 
 	/* determine the length (in bytes) of the XI list */
 	xi_len = rohc_list_get_xi_len(k, ps);
@@ -970,19 +977,8 @@ static int rohc_list_parse_insertion_scheme(struct list_decomp *const decomp,
 	ref_list_miss = -1;
 	for(i = 0; i < mask_len; i++)
 	{
-		uint8_t new_item_to_insert;
-
 		/* retrieve the corresponding bit in the insertion mask */
-		if(i < 7)
-		{
-			/* bit is located in first byte of insertion mask */
-			new_item_to_insert = rohc_get_bit(mask[0], 6 - i);
-		}
-		else
-		{
-			/* bit is located in 2nd byte of insertion mask */
-			new_item_to_insert = rohc_get_bit(mask[1], 14 - i);
-		}
+		const bool new_item_to_insert = !!(mask & ROHC_LIST_MASK_BIT(i));
 
 		/* insert item if required */
 		if(!new_item_to_insert)
@@ -1144,14 +1140,14 @@ static int rohc_list_parse_removal_scheme(struct list_decomp *const decomp,
                                           struct rohc_list *const rem_list)
 {
 	size_t packet_read_len = 0;
-	uint8_t mask[2]; /* removal bit mask on 1-2 bytes */
+	uint16_t mask; /* removal bit mask, left-aligned */
 	size_t mask_len; /* length (in bits) of the removal mask */
-	size_t i;
+	uint16_t kept_items; /* the items of the reference list to keep */
 	int ret;
 
 	/* parse the removal bit mask */
 	ret = rohc_list_decode_mask(decomp, "removal", packet, packet_len,
-	                            mask, &mask_len);
+	                            &mask, &mask_len);
 	if(ret < 0)
 	{
 		rd_list_warn(decomp, "failed to parse the removal bit mask");
@@ -1163,53 +1159,35 @@ static int rohc_list_parse_removal_scheme(struct list_decomp *const decomp,
 #endif
 	packet_read_len += ret;
 
-	/* copy non-removed items from reference list */
-	for(i = 0; i < mask_len; i++)
+	/* copy non-removed items from reference list, ie. the items whose bits
+	 * are not set in the removal mask, skip the removed ones at once */
+	kept_items = (~mask) & (0xffffU << (16 - mask_len));
+	while(kept_items != 0)
 	{
-		uint8_t item_to_remove;
+		/* the position of the next item to keep is the number of leading zeros
+		 * of the mask (the mask is promoted to 32 bits) */
+		const size_t i = __builtin_clz(kept_items) - 16;
+		kept_items &= ~ROHC_LIST_MASK_BIT(i);
 
-		/* retrieve the corresponding bit in the removal mask */
-		if(i < 7)
-		{
-			/* bit is located in first byte of removal mask */
-			item_to_remove = rohc_get_bit(mask[0], 6 - i);
-		}
-		else
-		{
-			/* bit is located in 2nd byte of insertion mask */
-			item_to_remove = rohc_get_bit(mask[1], 14 - i);
-		}
+		rd_list_debug(decomp, "take item at index %zu of reference list "
+		              "as item at index %zu of current list", i,
+		              rem_list->items_nr);
 
-		/* remove item if required */
-		if(item_to_remove)
+		/* check that reference list is large enough */
+		if(i >= ref_list->items_nr)
 		{
-			/* skip item only if reference list is large enough */
-			if(i < ref_list->items_nr)
-			{
-				rd_list_debug(decomp, "skip item at index %zu of reference "
-				              "list", i);
-			}
+			rd_list_warn(decomp, "reference list is too short: item at index "
+			             "%zu requested while list contains only %zu items",
+			             i, ref_list->items_nr);
+			goto error;
 		}
-		else
-		{
-			rd_list_debug(decomp, "take item at index %zu of reference list "
-			              "as item at index %zu of current list", i,
-			              rem_list->items_nr);
-
-			/* check that reference list is large enough */
-			if(i >= ref_list->items_nr)
-			{
-				rd_list_warn(decomp, "reference list is too short: item at index "
-				             "%zu requested while list contains only %zu items",
-				             i, ref_list->items_nr);
-				goto error;
-			}
 
-			/* take the item of the reference list */
-			rem_list->items[rem_list->items_nr] = ref_list->items[i];
-			rem_list->items_nr++;
-		}
+		/* take the item of the reference list */
+		rem_list->items[rem_list->items_nr] = ref_list->items[i];
+		rem_list->items_nr++;
 	}
+	rd_list_debug(decomp, "%zu items removed from reference list",
+	              ref_list->items_nr - rem_list->items_nr);
 
 	return packet_read_len;
 
@@ -1225,7 +1203,8 @@ error:
  * @param descr           The name of bit mask being decoded
  * @param packet          The ROHC packet to decompress
  * @param packet_len      The length (in bytes) of the packet to decompress
- * @param[out] mask       The insertion/removal bit mask on 1-2 bytes
+ * @param[out] mask       The insertion/removal bit mask, left-aligned on
+ *                        16 bits
  * @param[out] mask_len   The length of the insertion/removal mask (in bits)
  * @return                \li In case of success, the number of bytes read in the
  *                            given packet, ie. the length of the compressed list
@@ -1235,7 +1214,7 @@ static int rohc_list_decode_mask(struct list_decomp *const decomp,
                                  const char *const descr,
                                  const uint8_t *const packet,
                                  const size_t packet_len,
-                                 uint8_t mask[2],
+                                 uint16_t *const mask,
                                  size_t *const mask_len)
 {
 	size_t parsed_bytes_nr;
@@ -1250,9 +1229,9 @@ static int rohc_list_decode_mask(struct list_decomp *const decomp,
 	}
 
 	/* determine the number of bits set to 1 in the insertion bit mask */
-	mask[0] = packet[0];
-	rd_list_debug(decomp, "%s bit mask (first byte) = 0x%02x", descr, mask[0]);
-	if(GET_REAL(GET_BIT_7(mask)) == 1)
+	*mask = ((uint16_t) (packet[0] & 0x7f)) << 9;
+	rd_list_debug(decomp, "%s bit mask (first byte) = 0x%02x", descr, packet[0]);
+	if(GET_REAL(GET_BIT_7(packet)) == 1)
 	{
 		/* 15-bit mask */
 		if(packet_len < 2)
@@ -1262,8 +1241,8 @@ static int rohc_list_decode_mask(struct list_decomp *const decomp,
 			goto error;
 		}
 		*mask_len = 15;
-		mask[1] = packet[1];
-		rd_list_debug(decomp, "%s bit mask (second byte) = 0x%02x", descr, mask[1]);
+		*mask |= ((uint16_t) packet[1]) << 1;
+		rd_list_debug(decomp, "%s bit mask (second byte) = 0x%02x", descr, packet[1]);
 		parsed_bytes_nr = 2;
 	}
 	else
@@ -1271,7 +1250,6 @@ static int rohc_list_decode_mask(struct list_decomp *const decomp,
 		/* 7-bit mask */
 		rd_list_debug(decomp, "no second byte of %s bit mask", descr);
 		*mask_len = 7;
-		mask[1] = 0; /* shut up compiler warning about read of uninitialized data */
 		parsed_bytes_nr = 1;
 	}
 
@@ -1285,33 +1263,13 @@ error:
 /**
  * @brief Determine the number of indexes in the XI list
  *
- * @param ins_mask      The insertion bit mask
- * @param ins_mask_len  The length of the insertion bit mask (in bits)
- * @return              The number of indexes in the XI list
+ * @param ins_mask  The insertion bit mask, left-aligned on 16 bits
+ * @return          The number of indexes in the XI list
  */
-static size_t rohc_list_get_xi_nr(const uint8_t ins_mask[2],
-                                  const size_t ins_mask_len)
+static size_t rohc_list_get_xi_nr(const uint16_t ins_mask)
 {
-	size_t xi_nr = 0;
-	int j;
-
-	/* determine the number of bits set to 1 in the insertion bit mask */
-	for(j = 6; j >= 0; j--)
-	{
-		if(rohc_get_bit(ins_mask[0], j))
-		{
-			xi_nr++;
-		}
-	}
-	for(j = ins_mask_len - 8; j >= 0; j--)
-	{
-		if(rohc_get_bit(ins_mask[0], j))
-		{
-			xi_nr++;
-		}
-	}
-
-	return xi_nr;
+	/* the number of bits set to 1 in the insertion bit mask */
+	return __builtin_popcount(ins_mask);
 }
 
 
@@ -1454,51 +1412,3 @@ static uint8_t rohc_list_get_xi_type_2or3(const int ps,
 	return xi_value;
 }
 
-
-/**
- * @brief Get the bit in the given byte at the given position
- *
- * @param byte   The byte to analyse
- * @param pos    The position between 0 and 7
- * @return       The requested bit
- */
-static uint8_t rohc_get_bit(const uint8_t byte, const size_t pos)
-{
-	uint8_t bit;
-
-	switch(pos)
-	{
-		case 0:
-			bit = GET_REAL(GET_BIT_0(&byte));
-			break;
-		case 1:
-			bit = GET_REAL(GET_BIT_1(&byte));
-			break;
-		case 2:
-			bit = GET_REAL(GET_BIT_2(&byte));
-			break;
-		case 3:
-			bit = GET_REAL(GET_BIT_3(&byte));
-			break;
-		case 4:
-			bit = GET_REAL(GET_BIT_4(&byte));
-			break;
-		case 5:
-			bit = GET_REAL(GET_BIT_5(&byte));
-			break;
-		case 6:
-			bit = GET_REAL(GET_BIT_6(&byte));
-			break;
-		case 7:
-			bit = GET_REAL(GET_BIT_7(&byte));
-			break;
-		default:
-			/* there is no such bit in a byte */
-			assert(0); /* should not happen */
-			bit = 0;
-			break;
-	}
-
-	return bit;
-}
-
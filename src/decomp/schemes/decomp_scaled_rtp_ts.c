@@ -29,10 +29,16 @@
 #include "decomp_scaled_rtp_ts.h"
 #include "decomp_wlsb.h"
 #include "rohc_traces_internal.h"
+#include "rohc_time_internal.h"
 
 #include <assert.h>
 
 
+/** The max number of TS_STRIDEs between the context and the new unscaled TS
+ *  for TS_SCALED and TS_OFFSET to be derived without division */
+#define TS_SC_DECOMP_STRIDES_MAX  4U
+
+
 /** Print debug messages for the ts_sc_decomp module */
 #define ts_debug(entity_struct, format, ...) \
 	rohc_debug(entity_struct, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL, \
@@ -74,6 +80,14 @@ struct ts_sc_decomp
 	/// The previous sequence number
 	uint16_t old_sn;
 
+	/** The last received TIME_STRIDE value (in ms, validated by CRC),
+	 *  0 if timer-based compression is not used */
+	uint32_t time_stride;
+	/** The arrival time of the last packet (in ms, validated by CRC) */
+	uint32_t arrival;
+	/** Whether the arrival time of the last packet is known or not */
+	bool is_arrival_known;
+
 
 	/* the attributes below are new TS_* values computed by not yet validated
 	   by CRC check */
@@ -84,6 +98,10 @@ struct ts_sc_decomp
 	uint32_t new_ts_scaled;
 	/// The last computed or received TS_OFFSET value (not validated by CRC)
 	uint32_t new_ts_offset;
+	/** The last received TIME_STRIDE value (not validated by CRC) */
+	uint32_t new_time_stride;
+	/** Whether TIME_STRIDE was received in the current packet or not */
+	bool is_new_time_stride;
 
 	/** The callback function used to manage traces */
 	rohc_trace_callback2_t trace_callback;
@@ -92,6 +110,18 @@ struct ts_sc_decomp
 };
 
 
+/*
+ * Private function prototypes
+ */
+
+static void ts_split_unscaled(const struct ts_sc_decomp *const ts_sc,
+                              const uint32_t ts,
+                              const uint32_t ts_stride,
+                              uint32_t *const ts_scaled,
+                              uint32_t *const ts_offset)
+	__attribute__((nonnull(1, 4, 5)));
+
+
 
 /*
  * Public functions
@@ -100,17 +130,20 @@ struct ts_sc_decomp
 /**
  * @brief Create the scaled RTP Timestamp decoding context
  *
+ * @param slab           The slab to allocate the context from, may be NULL
+ *                       to allocate it from the heap
  * @param trace_cb       The trace callback
  * @param trace_cb_priv  An optional private context for the trace
  * @return               The scaled RTP Timestamp decoding context in case of
  *                       success, NULL otherwise
  */
-struct ts_sc_decomp * d_create_sc(rohc_trace_callback2_t trace_cb,
+struct ts_sc_decomp * d_create_sc(struct rohc_slab *const slab,
+                                  rohc_trace_callback2_t trace_cb,
                                   void *const trace_cb_priv)
 {
 	struct ts_sc_decomp *ts_sc;
 
-	ts_sc = malloc(sizeof(struct ts_sc_decomp));
+	ts_sc = rohc_slab_alloc(slab, sizeof(struct ts_sc_decomp));
 	if(ts_sc == NULL)
 	{
 		goto error;
@@ -129,13 +162,19 @@ struct ts_sc_decomp * d_create_sc(rohc_trace_callback2_t trace_cb,
 	ts_sc->new_ts_scaled = 0;
 	ts_sc->new_ts_offset = 0;
 
-	ts_sc->lsb_ts_scaled = rohc_lsb_new(32);
+	ts_sc->time_stride = 0;
+	ts_sc->arrival = 0;
+	ts_sc->is_arrival_known = false;
+	ts_sc->new_time_stride = 0;
+	ts_sc->is_new_time_stride = false;
+
+	ts_sc->lsb_ts_scaled = rohc_lsb_new(slab, 32);
 	if(ts_sc->lsb_ts_scaled == NULL)
 	{
 		goto free_context;
 	}
 
-	ts_sc->lsb_ts_unscaled = rohc_lsb_new(32);
+	ts_sc->lsb_ts_unscaled = rohc_lsb_new(slab, 32);
 	if(ts_sc->lsb_ts_unscaled == NULL)
 	{
 		goto free_lsb_ts_scaled;
@@ -149,7 +188,7 @@ struct ts_sc_decomp * d_create_sc(rohc_trace_callback2_t trace_cb,
 free_lsb_ts_scaled:
 	rohc_lsb_free(ts_sc->lsb_ts_scaled);
 free_context:
-	free(ts_sc);
+	rohc_slab_free(ts_sc);
 error:
 	return NULL;
 }
@@ -164,20 +203,35 @@ void rohc_ts_scaled_free(struct ts_sc_decomp *const ts_sc)
 {
 	rohc_lsb_free(ts_sc->lsb_ts_unscaled);
 	rohc_lsb_free(ts_sc->lsb_ts_scaled);
-	free(ts_sc);
+	rohc_slab_free(ts_sc);
+}
+
+
+/**
+ * @brief Get the maximum length one ts_sc_decomp object takes in a memory block
+ *
+ * @return  The maximum number of bytes of the memory block the object takes,
+ *          see \ref rohc_slab_block_mem_max
+ */
+size_t d_sc_mem_max(void)
+{
+	return (rohc_slab_block_mem_max(sizeof(struct ts_sc_decomp)) +
+	        2 * rohc_lsb_mem_max());
 }
 
 
 /**
  * @brief Store a new timestamp
  *
- * @param ts_sc  The ts_sc_decomp object
- * @param ts     The new decoded TimeStamp (TS)
- * @param sn     The new decoded Sequence Number (SN)
+ * @param ts_sc         The ts_sc_decomp object
+ * @param ts            The new decoded TimeStamp (TS)
+ * @param sn            The new decoded Sequence Number (SN)
+ * @param arrival_time  The arrival time of the packet, zero if unknown
  */
 void ts_update_context(struct ts_sc_decomp *const ts_sc,
                        const uint32_t ts,
-                       const uint16_t sn)
+                       const uint16_t sn,
+                       const struct rohc_ts arrival_time)
 {
 	/* replace the old TS/SN with the new ones, keep backup of the old ones */
 	ts_sc->old_ts = ts_sc->ts;
@@ -220,10 +274,24 @@ void ts_update_context(struct ts_sc_decomp *const ts_sc,
 		ts_debug(ts_sc, "old TS_OFFSET %u kept unchanged", ts_sc->ts_offset);
 	}
 
+	if(ts_sc->is_new_time_stride)
+	{
+		ts_debug(ts_sc, "old TIME_STRIDE %u replaced by new TIME_STRIDE %u",
+		         ts_sc->time_stride, ts_sc->new_time_stride);
+		ts_sc->time_stride = ts_sc->new_time_stride;
+	}
+
+	/* the arrival time of the packet is the reference for timer-based
+	 * decompression of the next packets */
+	ts_sc->arrival = rohc_time_ms(arrival_time);
+	ts_sc->is_arrival_known = rohc_time_is_known(arrival_time);
+
 	/* reset all the new TS_* values */
 	ts_sc->new_ts_scaled = 0;
 	ts_sc->new_ts_stride = 0;
 	ts_sc->new_ts_offset = 0;
+	ts_sc->new_time_stride = 0;
+	ts_sc->is_new_time_stride = false;
 
 	/* update the LSB objects for unscaled TS and TS_SCALED */
 	rohc_lsb_set_ref(ts_sc->lsb_ts_unscaled, ts_sc->ts, false);
@@ -245,6 +313,22 @@ void d_record_ts_stride(struct ts_sc_decomp *const ts_sc,
 }
 
 
+/**
+ * @brief Store the newly-parsed TIME_STRIDE value
+ *
+ * @param ts_sc        The ts_sc_decomp object
+ * @param time_stride  The TIME_STRIDE value (in ms) to add, 0 to stop the
+ *                     timer-based decompression
+ */
+void d_record_time_stride(struct ts_sc_decomp *const ts_sc,
+                          const uint32_t time_stride)
+{
+	ts_debug(ts_sc, "new TIME_STRIDE %u ms recorded", time_stride);
+	ts_sc->new_time_stride = time_stride;
+	ts_sc->is_new_time_stride = true;
+}
+
+
 /**
  * @brief Decode timestamp (TS) value with some LSB bits of the unscaled value
  *
@@ -315,13 +399,11 @@ bool ts_decode_unscaled_bits(struct ts_sc_decomp *const ts_sc,
 
 	if(effective_ts_stride != 0)
 	{
-		/* compute the new TS_OFFSET value */
-		new_ts_offset = (*decoded_ts) % effective_ts_stride;
+		/* compute the new TS_OFFSET and TS_SCALED values */
+		ts_split_unscaled(ts_sc, *decoded_ts, effective_ts_stride,
+		                  &new_ts_scaled, &new_ts_offset);
 		ts_debug(ts_sc, "TS_OFFSET = %u modulo %u = %u",
 		         *decoded_ts, effective_ts_stride, new_ts_offset);
-
-		/* compute the new TS_SCALED value */
-		new_ts_scaled = ((*decoded_ts) - new_ts_offset) / effective_ts_stride;
 		ts_debug(ts_sc, "TS_SCALED = (%u - %u) / %u = %u", *decoded_ts,
 		         new_ts_offset, effective_ts_stride, new_ts_scaled);
 
@@ -344,17 +426,26 @@ error:
  * Use the given TS and TS_SCALED bits.
  * Use the TS_STRIDE and TS_OFFSET values found in context.
  *
+ * If TIME_STRIDE was received and the arrival times of the packet and of the
+ * reference packet are known, the TS_SCALED bits are interpreted wrt the
+ * TS_SCALED value approximated from the arrival times (timer-based
+ * compression, see RFC 3095, section 4.5.4).
+ *
  * @param ts_sc              The ts_sc_decomp object
  * @param ts_scaled_bits     The W-LSB-encoded TS_SCALED value
  * @param ts_scaled_bits_nr  The number of bits of TS_SCALED (W-LSB)
+ * @param arrival_time       The arrival time of the packet, zero if unknown
  * @param decoded_ts         OUT: The decoded TS
  * @return                   true in case of success, false otherwise
  */
 bool ts_decode_scaled_bits(struct ts_sc_decomp *const ts_sc,
                            const uint32_t ts_scaled_bits,
                            const size_t ts_scaled_bits_nr,
+                           const struct rohc_ts arrival_time,
                            uint32_t *const decoded_ts)
 {
+	const uint32_t time_stride =
+		(ts_sc->is_new_time_stride ? ts_sc->new_time_stride : ts_sc->time_stride);
 	uint32_t effective_ts_stride;
 	uint32_t ts_scaled_decoded;
 	bool lsb_decode_ok;
@@ -387,12 +478,34 @@ bool ts_decode_scaled_bits(struct ts_sc_decomp *const ts_sc,
 	}
 
 	/* update TS_SCALED in context */
-	ts_debug(ts_sc, "decode %zd-bit TS_SCALED %u (reference = %u)",
-	         ts_scaled_bits_nr, ts_scaled_bits,
-	         rohc_lsb_get_ref(ts_sc->lsb_ts_scaled, ROHC_LSB_REF_0));
-	lsb_decode_ok = rohc_lsb_decode(ts_sc->lsb_ts_scaled, ROHC_LSB_REF_0, 0,
-	                                ts_scaled_bits, ts_scaled_bits_nr,
-	                                ROHC_LSB_SHIFT_RTP_TS, &ts_scaled_decoded);
+	if(time_stride != 0 && ts_sc->is_arrival_known &&
+	   rohc_time_is_known(arrival_time) && ts_scaled_bits_nr < 32)
+	{
+		/* timer-based compression: approximate TS_SCALED from the time elapsed
+		 * since the reference packet, then interpret the received bits in the
+		 * interval [approx - p, approx + p + 1] with p = 2^(k-1) - 1 */
+		const int32_t elapsed = (int32_t) (rohc_time_ms(arrival_time) - ts_sc->arrival);
+		const uint32_t approx = ts_sc->ts_scaled + (elapsed / (int32_t) time_stride);
+		const uint32_t mask = (((uint32_t) 1) << ts_scaled_bits_nr) - 1;
+		const uint32_t min = approx - (mask >> 1);
+
+		assert(ts_scaled_bits_nr > 0);
+		ts_scaled_decoded = min + ((ts_scaled_bits - min) & mask);
+		lsb_decode_ok = true;
+		ts_debug(ts_sc, "decode %zd-bit TS_SCALED %u with timer (reference = %u, "
+		         "%d ms elapsed, TIME_STRIDE = %u ms, approximation = %u)",
+		         ts_scaled_bits_nr, ts_scaled_bits, ts_sc->ts_scaled, elapsed,
+		         time_stride, approx);
+	}
+	else
+	{
+		ts_debug(ts_sc, "decode %zd-bit TS_SCALED %u (reference = %u)",
+		         ts_scaled_bits_nr, ts_scaled_bits,
+		         rohc_lsb_get_ref(ts_sc->lsb_ts_scaled, ROHC_LSB_REF_0));
+		lsb_decode_ok = rohc_lsb_decode(ts_sc->lsb_ts_scaled, ROHC_LSB_REF_0, 0,
+		                                ts_scaled_bits, ts_scaled_bits_nr,
+		                                ROHC_LSB_SHIFT_RTP_TS, &ts_scaled_decoded);
+	}
 	if(!lsb_decode_ok)
 	{
 		rohc_error(ts_sc, ROHC_TRACE_DECOMP, ROHC_PROFILE_GENERAL,
@@ -457,3 +570,62 @@ uint32_t ts_deduce_from_sn(struct ts_sc_decomp *const ts_sc,
 	return new_ts;
 }
 
+
+
+/*
+ * Private functions
+ */
+
+/**
+ * @brief Split the given unscaled TS into TS_SCALED and TS_OFFSET
+ *
+ * TS = TS_SCALED * TS_STRIDE + TS_OFFSET with TS_OFFSET = TS modulo TS_STRIDE.
+ *
+ * The TS of a stream with a constant TS_STRIDE grows by a few TS_STRIDEs
+ * between packets: if the TS_STRIDE is the one of the context and if the TS
+ * is at most \ref TS_SC_DECOMP_STRIDES_MAX TS_STRIDEs after the TS described
+ * by the TS_SCALED and TS_OFFSET of the context, the new TS_SCALED and
+ * TS_OFFSET are derived from the ones of the context by subtraction. They
+ * are computed with one division otherwise.
+ *
+ * @param ts_sc           The ts_sc_decomp object
+ * @param ts              The unscaled TS to split
+ * @param ts_stride       The TS_STRIDE to split the TS with, not 0
+ * @param[out] ts_scaled  The TS_SCALED of the TS
+ * @param[out] ts_offset  The TS_OFFSET of the TS
+ */
+static void ts_split_unscaled(const struct ts_sc_decomp *const ts_sc,
+                              const uint32_t ts,
+                              const uint32_t ts_stride,
+                              uint32_t *const ts_scaled,
+                              uint32_t *const ts_offset)
+{
+	/* the TS described by the context, without wraparound */
+	const uint64_t ctxt_ts =
+		((uint64_t) ts_sc->ts_scaled) * ts_sc->ts_stride + ts_sc->ts_offset;
+
+	assert(ts_stride != 0);
+
+	if(ts_stride == ts_sc->ts_stride && ts_sc->ts_offset < ts_stride &&
+	   ctxt_ts <= ts &&
+	   (ts - ctxt_ts) <= (((uint64_t) ts_stride) * TS_SC_DECOMP_STRIDES_MAX))
+	{
+		/* TS_OFFSET < TS_STRIDE in context, so at most TS_SC_DECOMP_STRIDES_MAX
+		 * plus one TS_STRIDEs are carried into TS_SCALED */
+		uint64_t offset = ts_sc->ts_offset + (ts - ctxt_ts);
+		uint32_t scaled = ts_sc->ts_scaled;
+
+		while(offset >= ts_stride)
+		{
+			offset -= ts_stride;
+			scaled++;
+		}
+		*ts_scaled = scaled;
+		*ts_offset = (uint32_t) offset;
+	}
+	else
+	{
+		*ts_offset = ts % ts_stride;
+		*ts_scaled = (ts - (*ts_offset)) / ts_stride;
+	}
+}
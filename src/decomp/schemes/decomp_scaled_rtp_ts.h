@@ -30,6 +30,8 @@
 #define ROHC_DECOMP_SCHEMES_SCALED_RTP_TS_H
 
 #include "rohc_traces.h"
+#include "rohc_slab.h"
+#include "rohc_time.h"
 
 #include <stdlib.h>
 #include <stdint.h>
@@ -48,19 +50,27 @@ struct ts_sc_decomp;
  * Function prototypes
  */
 
-struct ts_sc_decomp * d_create_sc(rohc_trace_callback2_t trace_cb,
+struct ts_sc_decomp * d_create_sc(struct rohc_slab *const slab,
+                                  rohc_trace_callback2_t trace_cb,
                                   void *const trace_cb_priv)
 	__attribute__((warn_unused_result));
 void rohc_ts_scaled_free(struct ts_sc_decomp *const ts_scaled)
 	__attribute__((nonnull(1)));
 
+size_t d_sc_mem_max(void)
+	__attribute__((warn_unused_result, const));
+
 void ts_update_context(struct ts_sc_decomp *const ts_sc,
                        const uint32_t ts,
-                       const uint16_t sn);
+                       const uint16_t sn,
+                       const struct rohc_ts arrival_time);
 
 void d_record_ts_stride(struct ts_sc_decomp *const ts_sc,
                         const uint32_t ts_stride);
 
+void d_record_time_stride(struct ts_sc_decomp *const ts_sc,
+                          const uint32_t time_stride);
+
 bool ts_decode_unscaled_bits(struct ts_sc_decomp *const ts_sc,
                              const uint32_t ts_unscaled_bits,
                              const size_t ts_unscaled_bits_nr,
@@ -70,6 +80,7 @@ bool ts_decode_unscaled_bits(struct ts_sc_decomp *const ts_sc,
 bool ts_decode_scaled_bits(struct ts_sc_decomp *const ts_sc,
                            const uint32_t ts_scaled_bits,
                            const size_t ts_scaled_bits_nr,
+                           const struct rohc_ts arrival_time,
                            uint32_t *const decoded_ts)
 	__attribute__((warn_unused_result));
 
@@ -25,11 +25,8 @@
  */
 
 #include "decomp_wlsb.h"
-#include "interval.h" /* for the rohc_f_32bits() function */
+#include "interval.h" /* for the rohc_interval_compute_p() function */
 
-#ifndef __KERNEL__
-#  include <string.h>
-#endif
 #include <assert.h>
 
 
@@ -52,38 +49,6 @@ struct rohc_lsb_decode
 };
 
 
-/*
- * Private functions
- */
-
-static bool rohc_lsb_decode32(const struct rohc_lsb_decode *const lsb,
-                              const rohc_lsb_ref_t ref_type,
-                              const uint32_t v_ref_d_offset,
-                              const uint32_t m,
-                              const size_t k,
-                              const rohc_lsb_shift_t p,
-                              uint32_t *const decoded)
-	__attribute__((nonnull(1, 7), warn_unused_result));
-
-static bool rohc_lsb_decode16(const struct rohc_lsb_decode *const lsb,
-                              const rohc_lsb_ref_t ref_type,
-                              const uint16_t v_ref_d_offset,
-                              const uint16_t m,
-                              const size_t k,
-                              const rohc_lsb_shift_t p,
-                              uint16_t *const decoded)
-	__attribute__((nonnull(1, 7), warn_unused_result));
-
-static bool rohc_lsb_decode8(const struct rohc_lsb_decode *const lsb,
-                             const rohc_lsb_ref_t ref_type,
-                             const uint8_t v_ref_d_offset,
-                             const uint8_t m,
-                             const size_t k,
-                             const rohc_lsb_shift_t p,
-                             uint8_t *const decoded)
-	__attribute__((nonnull(1, 7), warn_unused_result));
-
-
 /*
  * Public functions
  */
@@ -93,17 +58,20 @@ static bool rohc_lsb_decode8(const struct rohc_lsb_decode *const lsb,
  *
  * See 4.5.1 in the RFC 3095 for details about LSB encoding.
  *
+ * @param slab     The slab to allocate the context from, may be NULL to
+ *                 allocate it from the heap
  * @param max_len  The max length (in bits) of the non-compressed field
  * @return         The new LSB decoding context in case of success, NULL
  *                 otherwise
  */
-struct rohc_lsb_decode * rohc_lsb_new(const size_t max_len)
+struct rohc_lsb_decode * rohc_lsb_new(struct rohc_slab *const slab,
+                                      const size_t max_len)
 {
 	struct rohc_lsb_decode *lsb;
 
 	assert(max_len == 8 || max_len == 16 || max_len == 32);
 
-	lsb = malloc(sizeof(struct rohc_lsb_decode));
+	lsb = rohc_slab_alloc(slab, sizeof(struct rohc_lsb_decode));
 	if(lsb != NULL)
 	{
 		lsb->max_len = max_len;
@@ -123,7 +91,19 @@ struct rohc_lsb_decode * rohc_lsb_new(const size_t max_len)
  */
 void rohc_lsb_free(struct rohc_lsb_decode *const lsb)
 {
-	free(lsb);
+	rohc_slab_free(lsb);
+}
+
+
+/**
+ * @brief Get the maximum length one LSB decoding context takes in a memory block
+ *
+ * @return  The maximum number of bytes of the memory block the LSB decoding context takes,
+ *          see \ref rohc_slab_block_mem_max
+ */
+size_t rohc_lsb_mem_max(void)
+{
+	return rohc_slab_block_mem_max(sizeof(struct rohc_lsb_decode));
 }
 
 
@@ -143,7 +123,9 @@ bool rohc_lsb_is_ready(const struct rohc_lsb_decode *const lsb)
 /**
  * @brief Decode a LSB-encoded value
  *
- * See 4.5.1 in the RFC 3095 for details about LSB encoding.
+ * See 4.5.1 in the RFC 3095 for details about LSB encoding. The value is
+ * decoded without any branch by the function specialised for the width of
+ * the field, see \ref rohc_lsb_decode_value32.
  *
  * @param lsb             The LSB object used to decode
  * @param ref_type        The reference value to use to decode
@@ -155,7 +137,9 @@ bool rohc_lsb_is_ready(const struct rohc_lsb_decode *const lsb)
  * @param p               The shift value p used to efficiently encode/decode
  *                        the values
  * @param decoded         OUT: The decoded value
- * @return                true in case of success, false otherwise
+ * @return                true in case of success, false otherwise (the
+ *                        interpretation interval always contains one value
+ *                        with the k LSB bits, so decoding never fails)
  */
 bool rohc_lsb_decode(const struct rohc_lsb_decode *const lsb,
                      const rohc_lsb_ref_t ref_type,
@@ -165,230 +149,33 @@ bool rohc_lsb_decode(const struct rohc_lsb_decode *const lsb,
                      const rohc_lsb_shift_t p,
                      uint32_t *const decoded)
 {
-	bool is_success;
+	const int32_t computed_p = rohc_interval_compute_p(k, p);
+	uint32_t v_ref;
 
 	assert(lsb != NULL);
 	assert(lsb->is_init == true);
 	assert(decoded != NULL);
 	assert(ref_type == ROHC_LSB_REF_MINUS_1 || ref_type == ROHC_LSB_REF_0);
+	assert(k <= lsb->max_len);
+	assert(k == 32 || (m >> k) == 0);
 
-	if(lsb->max_len == 8)
-	{
-		uint8_t decoded8;
-
-		assert(lsb->max_len == 8);
-		assert(k <= 8);
-
-		is_success = rohc_lsb_decode8(lsb, ref_type, v_ref_d_offset, m, k, p,
-		                              &decoded8);
-		if(is_success)
-		{
-			*decoded = ((uint32_t) decoded8) & 0xff;
-		}
-	}
-	else if(lsb->max_len == 16)
-	{
-		uint16_t decoded16 = 0; /* initialized for GCC 4.0.x */
-
-		assert(lsb->max_len == 16);
-		assert(k <= 16);
-
-		is_success = rohc_lsb_decode16(lsb, ref_type, v_ref_d_offset, m, k, p,
-		                               &decoded16);
-		if(is_success)
-		{
-			*decoded = ((uint32_t) decoded16) & 0xffff;
-		}
-	}
-	else /* 32-bit value */
-	{
-		assert(lsb->max_len == 32);
-		assert(k <= 32);
-
-		is_success = rohc_lsb_decode32(lsb, ref_type, v_ref_d_offset, m, k, p,
-		                               decoded);
-	}
-
-	return is_success;
-}
-
-
-/**
- * @brief Decode a 32-bit LSB-encoded value
- *
- * See 4.5.1 in the RFC 3095 for details about LSB encoding.
- *
- * @param lsb             The LSB object used to decode
- * @param ref_type        The reference value to use to decode
- *                        (used for context repair upon CRC failure)
- * @param v_ref_d_offset  The offset to apply on v_ref_d
- *                        (used for context repair upon CRC failure)
- * @param m               The LSB value to decode
- * @param k               The length of the LSB value to decode
- * @param p               The shift value p used to efficiently encode/decode
- *                        the values
- * @param decoded         OUT: The decoded value
- * @return                true in case of success, false otherwise
- */
-static bool rohc_lsb_decode32(const struct rohc_lsb_decode *const lsb,
-                              const rohc_lsb_ref_t ref_type,
-                              const uint32_t v_ref_d_offset,
-                              const uint32_t m,
-                              const size_t k,
-                              const rohc_lsb_shift_t p,
-                              uint32_t *const decoded)
-{
-	struct rohc_interval32 interval;
-	uint32_t decoded_value;
-	uint32_t try;
-	uint32_t mask;
-	bool is_found = false;
-
-	/* compute the mask for k bits (and avoid integer overflow) */
-	if(k == 32)
-	{
-		mask = 0xffffffff;
-	}
-	else
-	{
-		mask = (1U << k) - 1;
-	}
-	assert((m & mask) == m);
-
-	/* determine the interval in which the decoded value should be present */
-	interval = rohc_f_32bits(lsb->v_ref_d[ref_type] + v_ref_d_offset, k, p);
-
-	/* search the value that matches the k lower bits of the value m to decode */
-	if(interval.min <= interval.max)
-	{
-		/* the interpretation interval does not straddle the field boundaries */
-
-		/* find the minimum value in the interval [min ; max] with the same k LSB
-		 * bits as m */
-		try = (interval.min & (~mask)) | m;
-		if((interval.min & mask) > m)
-		{
-			/* value is not in the interval (lower than min), try next value */
-			try += mask + 1;
-		}
-		if(try >= interval.min && try <= interval.max)
-		{
-			/* value is in the interval: corresponding value found */
-			is_found = true;
-			decoded_value = try;
-		}
-	}
-	else
-	{
-		/* the interpretation interval does straddle the field boundaries */
-
-		/* find the first value in the interval [min ; max] with the same
-		 * k LSB bits as m */
-		try = (interval.min & (~mask)) | m;
-		if((interval.min & mask) > m)
-		{
-			/* value is not in the interval (lower than min), try next value */
-			try += mask + 1;
-		}
-		if(try >= interval.min || try <= interval.max)
-		{
-			/* value is in the interval: corresponding value found */
-			is_found = true;
-			decoded_value = try;
-		}
-	}
-
-	if(is_found)
-	{
-		assert((decoded_value & mask) == m);
-		memcpy(decoded, &decoded_value, sizeof(uint32_t));
-	}
-
-	return is_found;
-}
-
-
-/**
- * @brief Decode a 16-bit LSB-encoded value
- *
- * See \ref rohc_lsb_decode32 for details.
- *
- * @param lsb             The LSB object used to decode
- * @param ref_type        The reference value to use to decode
- *                        (used for context repair upon CRC failure)
- * @param v_ref_d_offset  The offset to apply on v_ref_d
- *                        (used for context repair upon CRC failure)
- * @param m               The LSB value to decode
- * @param k               The length of the LSB value to decode
- * @param p               The shift value p used to efficiently encode/decode
- *                        the values
- * @param decoded         OUT: The decoded value
- * @return                true in case of success, false otherwise
- */
-static bool rohc_lsb_decode16(const struct rohc_lsb_decode *const lsb,
-                              const rohc_lsb_ref_t ref_type,
-                              const uint16_t v_ref_d_offset,
-                              const uint16_t m,
-                              const size_t k,
-                              const rohc_lsb_shift_t p,
-                              uint16_t *const decoded)
-{
-	uint32_t m32;
-	uint32_t decoded32;
-	bool is_success;
-
-	m32 = ((uint32_t) m) & 0xffff;
-
-	is_success = rohc_lsb_decode32(lsb, ref_type, v_ref_d_offset, m32, k, p,
-	                               &decoded32);
-	if(is_success)
-	{
-		*decoded = (uint16_t) (decoded32 & 0xffff);
-	}
-
-	return is_success;
-}
-
-
-/**
- * @brief Decode a 8-bit LSB-encoded value
- *
- * See \ref rohc_lsb_decode32 for details.
- *
- * @param lsb             The LSB object used to decode
- * @param ref_type        The reference value to use to decode
- *                        (used for context repair upon CRC failure)
- * @param v_ref_d_offset  The offset to apply on v_ref_d
- *                        (used for context repair upon CRC failure)
- * @param m               The LSB value to decode
- * @param k               The length of the LSB value to decode
- * @param p               The shift value p used to efficiently encode/decode
- *                        the values
- * @param decoded         OUT: The decoded value
- * @return                true in case of success, false otherwise
- */
-static bool rohc_lsb_decode8(const struct rohc_lsb_decode *const lsb,
-                             const rohc_lsb_ref_t ref_type,
-                             const uint8_t v_ref_d_offset,
-                             const uint8_t m,
-                             const size_t k,
-                             const rohc_lsb_shift_t p,
-                             uint8_t *const decoded)
-{
-	uint32_t m32;
-	uint32_t decoded32;
-	bool is_success;
-
-	m32 = ((uint32_t) m) & 0xff;
+	v_ref = lsb->v_ref_d[ref_type] + v_ref_d_offset;
 
-	is_success = rohc_lsb_decode32(lsb, ref_type, v_ref_d_offset, m32, k, p,
-	                               &decoded32);
-	if(is_success)
+	switch(lsb->max_len)
 	{
-		*decoded = (uint8_t) (decoded32 & 0xff);
+		case 8:
+			*decoded = rohc_lsb_decode_value8(v_ref, m, k, computed_p);
+			break;
+		case 16:
+			*decoded = rohc_lsb_decode_value16(v_ref, m, k, computed_p);
+			break;
+		default: /* 32-bit value */
+			assert(lsb->max_len == 32);
+			*decoded = rohc_lsb_decode_value32(v_ref, m, k, computed_p);
+			break;
 	}
 
-	return is_success;
+	return true;
 }
 
 
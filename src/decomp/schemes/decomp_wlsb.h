@@ -28,6 +28,7 @@
 #define ROHC_DECOMP_SCHEMES_WLSB_H
 
 #include "interval.h" /* for rohc_lsb_shift_t */
+#include "rohc_slab.h"
 
 #include <stdlib.h>
 #include <stdint.h>
@@ -84,12 +85,16 @@ struct rohc_lsb_field8
  * Function prototypes
  */
 
-struct rohc_lsb_decode * rohc_lsb_new(const size_t max_len)
+struct rohc_lsb_decode * rohc_lsb_new(struct rohc_slab *const slab,
+                                      const size_t max_len)
 	__attribute__((warn_unused_result));
 
 void rohc_lsb_free(struct rohc_lsb_decode *const lsb)
 	__attribute__((nonnull(1)));
 
+size_t rohc_lsb_mem_max(void)
+	__attribute__((warn_unused_result, const));
+
 bool rohc_lsb_is_ready(const struct rohc_lsb_decode *const lsb)
 	__attribute__((warn_unused_result, nonnull(1), pure));
 
@@ -111,5 +116,95 @@ uint32_t rohc_lsb_get_ref(const struct rohc_lsb_decode *const lsb,
                           const rohc_lsb_ref_t ref_type)
 	__attribute__((nonnull(1), warn_unused_result));
 
+static inline uint32_t rohc_lsb_decode_value32(const uint32_t v_ref,
+                                               const uint32_t m,
+                                               const size_t k,
+                                               const int32_t p)
+	__attribute__((warn_unused_result, const));
+
+static inline uint16_t rohc_lsb_decode_value16(const uint16_t v_ref,
+                                               const uint16_t m,
+                                               const size_t k,
+                                               const int32_t p)
+	__attribute__((warn_unused_result, const));
+
+static inline uint8_t rohc_lsb_decode_value8(const uint8_t v_ref,
+                                             const uint8_t m,
+                                             const size_t k,
+                                             const int32_t p)
+	__attribute__((warn_unused_result, const));
+
+
+/**
+ * @brief Decode a 32-bit LSB-encoded value without any branch
+ *
+ * The interpretation interval [v_ref - p, v_ref - p + 2^k - 1] contains
+ * exactly one value with the k LSB bits \e m, wraparound included: the one
+ * at the offset (m - min) modulo 2^k from the lower bound of the interval.
+ * See 4.5.1 in the RFC 3095 for details about LSB encoding.
+ *
+ * @param v_ref  The reference value
+ * @param m      The LSB value to decode
+ * @param k      The length of the LSB value to decode, from 0 to 32 bits
+ * @param p      The shift parameter p, see \ref rohc_interval_compute_p
+ * @return       The decoded value
+ */
+static inline uint32_t rohc_lsb_decode_value32(const uint32_t v_ref,
+                                               const uint32_t m,
+                                               const size_t k,
+                                               const int32_t p)
+{
+	const uint32_t mask = (uint32_t) ((((uint64_t) 1) << k) - 1);
+	const uint32_t min = v_ref - ((uint32_t) p);
+
+	return min + ((m - min) & mask);
+}
+
+
+/**
+ * @brief Decode a 16-bit LSB-encoded value without any branch
+ *
+ * See \ref rohc_lsb_decode_value32 for details.
+ *
+ * @param v_ref  The reference value
+ * @param m      The LSB value to decode
+ * @param k      The length of the LSB value to decode, from 0 to 16 bits
+ * @param p      The shift parameter p, see \ref rohc_interval_compute_p
+ * @return       The decoded value
+ */
+static inline uint16_t rohc_lsb_decode_value16(const uint16_t v_ref,
+                                               const uint16_t m,
+                                               const size_t k,
+                                               const int32_t p)
+{
+	const uint16_t mask = (uint16_t) ((1U << k) - 1);
+	const uint16_t min = (uint16_t) (v_ref - ((uint16_t) p));
+
+	return (uint16_t) (min + ((m - min) & mask));
+}
+
+
+/**
+ * @brief Decode a 8-bit LSB-encoded value without any branch
+ *
+ * See \ref rohc_lsb_decode_value32 for details.
+ *
+ * @param v_ref  The reference value
+ * @param m      The LSB value to decode
+ * @param k      The length of the LSB value to decode, from 0 to 8 bits
+ * @param p      The shift parameter p, see \ref rohc_interval_compute_p
+ * @return       The decoded value
+ */
+static inline uint8_t rohc_lsb_decode_value8(const uint8_t v_ref,
+                                             const uint8_t m,
+                                             const size_t k,
+                                             const int32_t p)
+{
+	const uint8_t mask = (uint8_t) ((1U << k) - 1);
+	const uint8_t min = (uint8_t) (v_ref - ((uint8_t) p));
+
+	return (uint8_t) (min + ((m - min) & mask));
+}
+
 #endif
 
@@ -55,20 +55,22 @@ struct ip_id_offset_decode
  *
  * See 4.5.5 in the RFC 3095 for details about Offset IP-ID encoding.
  *
- * @return  The new Offset IP-ID decoding context in case of success,
- *          NULL otherwise
+ * @param slab  The slab to allocate the context from, may be NULL to
+ *              allocate it from the heap
+ * @return      The new Offset IP-ID decoding context in case of success,
+ *              NULL otherwise
  */
-struct ip_id_offset_decode * ip_id_offset_new(void)
+struct ip_id_offset_decode * ip_id_offset_new(struct rohc_slab *const slab)
 {
 	struct ip_id_offset_decode *ipid;
 
-	ipid = malloc(sizeof(struct ip_id_offset_decode));
+	ipid = rohc_slab_alloc(slab, sizeof(struct ip_id_offset_decode));
 	if(ipid == NULL)
 	{
 		goto error;
 	}
 
-	ipid->lsb = rohc_lsb_new(16);
+	ipid->lsb = rohc_lsb_new(slab, 16);
 	if(ipid->lsb == NULL)
 	{
 		goto destroy_ipid;
@@ -77,7 +79,7 @@ struct ip_id_offset_decode * ip_id_offset_new(void)
 	return ipid;
 
 destroy_ipid:
-	free(ipid);
+	rohc_slab_free(ipid);
 error:
 	return NULL;
 }
@@ -93,7 +95,20 @@ error:
 void ip_id_offset_free(struct ip_id_offset_decode *const ipid)
 {
 	rohc_lsb_free(ipid->lsb);
-	free(ipid);
+	rohc_slab_free(ipid);
+}
+
+
+/**
+ * @brief Get the maximum length one Offset IP-ID decoding context takes in a memory block
+ *
+ * @return  The maximum number of bytes of the memory block the Offset IP-ID decoding context takes,
+ *          see \ref rohc_slab_block_mem_max
+ */
+size_t ip_id_offset_mem_max(void)
+{
+	return (rohc_slab_block_mem_max(sizeof(struct ip_id_offset_decode)) +
+	        rohc_lsb_mem_max());
 }
 
 
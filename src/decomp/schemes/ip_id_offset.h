@@ -46,11 +46,14 @@ struct ip_id_offset_decode;
  * Function prototypes.
  */
 
-struct ip_id_offset_decode * ip_id_offset_new(void);
+struct ip_id_offset_decode * ip_id_offset_new(struct rohc_slab *const slab);
 
 void ip_id_offset_free(struct ip_id_offset_decode *const ipid)
 	__attribute__((nonnull(1)));
 
+size_t ip_id_offset_mem_max(void)
+	__attribute__((warn_unused_result, const));
+
 bool ip_id_offset_decode(const struct ip_id_offset_decode *const ipid,
                          const rohc_lsb_ref_t ref_type,
                          const uint16_t m,
@@ -0,0 +1,282 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_list_decomp.c
+ * @brief  Check and benchmark the decoding of the 4 types of compressed lists
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The lists of IPv6 extension headers are decoded with encoding types 0, 1,
+ * 2 and 3. Types 1, 2 and 3 use 15-bit insertion/removal bit masks, so that
+ * all the items of the masks are iterated. The decoded lists are checked
+ * against the expected ones, then every list is decoded many times to
+ * measure the decoding time.
+ */
+
+#include "schemes/decomp_list.h"
+#include "schemes/decomp_list_ipv6.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+
+
+/** The number of decodings of every list for the time measurement */
+#define TEST_LIST_DECOMP_ROUNDS  1000000U
+
+/** The length of the IPv6 Destination Option items in the test */
+#define TEST_LIST_ITEM_LEN  8U
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+
+/** One compressed list and the list it shall be decoded to */
+struct test_list
+{
+	const char *descr;        /**< The description of the list */
+	uint8_t data[160];        /**< The compressed list */
+	size_t len;               /**< The length of the compressed list */
+	size_t items_nr;          /**< The number of items of the decoded list */
+	uint8_t items[ROHC_LIST_ITEMS_MAX]; /**< The indexes of the decoded items */
+};
+
+
+static bool test_list_decode(const bool be_verbose,
+                             struct list_decomp *const decomp,
+                             const struct test_list *const list)
+	__attribute__((warn_unused_result, nonnull(2, 3)));
+
+
+/**
+ * @brief Decode one compressed list and check the result
+ *
+ * @param be_verbose  Whether to print traces or not
+ * @param decomp      The list decompression context
+ * @param list        The compressed list to decode and the expected result
+ * @return            true if the list is decoded as expected, false otherwise
+ */
+static bool test_list_decode(const bool be_verbose,
+                             struct list_decomp *const decomp,
+                             const struct test_list *const list)
+{
+	size_t i;
+	int ret;
+
+	trace(be_verbose, "decode %s\n", list->descr);
+
+	ret = rohc_list_decode_maybe(decomp, list->data, list->len);
+	if(ret < 0)
+	{
+		fprintf(stderr, "failed to decode %s\n", list->descr);
+		goto error;
+	}
+	else if(((size_t) ret) != list->len)
+	{
+		fprintf(stderr, "%s: %d bytes decoded while %zu bytes expected\n",
+		        list->descr, ret, list->len);
+		goto error;
+	}
+
+	if(decomp->pkt_list.items_nr != list->items_nr)
+	{
+		fprintf(stderr, "%s: %zu items decoded while %zu items expected\n",
+		        list->descr, decomp->pkt_list.items_nr, list->items_nr);
+		goto error;
+	}
+	for(i = 0; i < list->items_nr; i++)
+	{
+		if(decomp->pkt_list.items[i] != &decomp->trans_table[list->items[i]])
+		{
+			fprintf(stderr, "%s: item #%zu is not the item #%u of the "
+			        "translation table\n", list->descr, i + 1, list->items[i]);
+			goto error;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Check and benchmark the decoding of the compressed lists
+ *
+ * @param argc  The number of program arguments
+ * @param argv  The program arguments
+ * @return      The unix return code:
+ *               \li 0 in case of success,
+ *               \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	/* type 0 with all items: creates the 15 items of the translation table,
+	 * gen_id 0 */
+	struct test_list init_list = {
+		.descr = "type 0 list that creates all items",
+		.items_nr = ROHC_LIST_ITEMS_MAX,
+	};
+	const struct test_list lists[] = {
+		/* type 0 with known items only: the first 8 items, gen_id 1 */
+		{
+			.descr = "type 0 list with 8 known items",
+			.data = { 0x38, 0x01, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07 },
+			.len = 10,
+			.items_nr = 8,
+			.items = { 0, 1, 2, 3, 4, 5, 6, 7 },
+		},
+		/* type 1 based on gen_id 1: insert 7 items at odd positions with a
+		 * 15-bit insertion mask, gen_id 2 */
+		{
+			.descr = "type 1 list with 15-bit insertion mask",
+			.data = { 0x70, 0x02, 0x01, 0xaa, 0xaa,
+			          0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e },
+			.len = 12,
+			.items_nr = 15,
+			.items = { 0, 8, 1, 9, 2, 10, 3, 11, 4, 12, 5, 13, 6, 14, 7 },
+		},
+		/* type 2 based on gen_id 0: remove the items at odd positions with a
+		 * 15-bit removal mask, gen_id 3 */
+		{
+			.descr = "type 2 list with 15-bit removal mask",
+			.data = { 0xa8, 0x03, 0x00, 0xaa, 0xaa },
+			.len = 5,
+			.items_nr = 8,
+			.items = { 0, 2, 4, 6, 8, 10, 12, 14 },
+		},
+		/* type 2 based on gen_id 1: remove the first 3 items with a 7-bit
+		 * removal mask, gen_id 4 */
+		{
+			.descr = "type 2 list with 7-bit removal mask",
+			.data = { 0xa4, 0x04, 0x01, 0x70 },
+			.len = 4,
+			.items_nr = 4,
+			.items = { 3, 4, 5, 6 },
+		},
+		/* type 3 based on gen_id 0: remove the first 8 items, then insert
+		 * 4 items at even positions with 15-bit masks, gen_id 5 */
+		{
+			.descr = "type 3 list with 15-bit removal and insertion masks",
+			.data = { 0xf0, 0x05, 0x00, 0xff, 0x80, 0xd5, 0x00,
+			          0x00, 0x01, 0x02, 0x03 },
+			.len = 11,
+			.items_nr = 11,
+			.items = { 0, 8, 1, 9, 2, 10, 3, 11, 12, 13, 14 },
+		},
+	};
+	const size_t lists_nr = sizeof(lists) / sizeof(lists[0]);
+	static struct list_decomp decomp; /* too large for the stack */
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+	size_t i;
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("check and benchmark the decoding of compressed lists\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	/* build the type 0 list that transmits all the items: 8-bit XIs with the
+	 * X bit set, then the IPv6 Destination Option headers */
+	init_list.data[0] = 0x30 | ROHC_LIST_ITEMS_MAX;
+	init_list.data[1] = 0x00;
+	for(i = 0; i < ROHC_LIST_ITEMS_MAX; i++)
+	{
+		uint8_t *const item =
+			init_list.data + 2 + ROHC_LIST_ITEMS_MAX + i * TEST_LIST_ITEM_LEN;
+
+		init_list.data[2 + i] = 0x80 | i;
+		item[0] = ROHC_IPPROTO_DSTOPTS;
+		item[1] = 0; /* (0 + 1) * 8 = 8 bytes */
+		memset(item + 2, i, TEST_LIST_ITEM_LEN - 2);
+		init_list.items[i] = i;
+	}
+	init_list.len = 2 + ROHC_LIST_ITEMS_MAX * (1 + TEST_LIST_ITEM_LEN);
+	assert(init_list.len <= sizeof(init_list.data));
+
+	rohc_decomp_list_ipv6_new(&decomp, NULL, NULL, ROHC_PROFILE_GENERAL);
+
+	/* create the items and the reference lists, then check the decoding of
+	 * all the lists */
+	if(!test_list_decode(verbose, &decomp, &init_list))
+	{
+		goto free_list;
+	}
+	for(i = 0; i < lists_nr; i++)
+	{
+		if(!test_list_decode(verbose, &decomp, &lists[i]))
+		{
+			goto free_list;
+		}
+	}
+
+	/* measure the decoding time of every list */
+	for(i = 0; i < lists_nr; i++)
+	{
+		clock_t start;
+		clock_t end;
+		size_t round;
+
+		start = clock();
+		for(round = 0; round < TEST_LIST_DECOMP_ROUNDS; round++)
+		{
+			if(rohc_list_decode_maybe(&decomp, lists[i].data, lists[i].len) < 0)
+			{
+				fprintf(stderr, "failed to decode %s\n", lists[i].descr);
+				goto free_list;
+			}
+		}
+		end = clock();
+
+		printf("%s: %.1f ns/list\n", lists[i].descr,
+		       ((double) (end - start)) * 1e9 / CLOCKS_PER_SEC /
+		       TEST_LIST_DECOMP_ROUNDS);
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+free_list:
+	rohc_decomp_list_ipv6_free(&decomp);
+error:
+	return is_failure;
+}
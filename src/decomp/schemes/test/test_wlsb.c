@@ -36,46 +36,28 @@
 #include "config.h" /* for HAVE_CMOCKA_RUN(_GROUP)?_TESTS */
 
 
-/** Stub for \ref rohc_f_32bits */
-struct rohc_interval32 __wrap_rohc_f_32bits(const uint32_t v_ref,
-                                            const size_t k,
-                                            const rohc_lsb_shift_t p)
-{
-	struct rohc_interval32 interval;
-
-	check_expected(v_ref);
-	check_expected(k);
-	check_expected(p);
-
-	interval.min = mock_type(uint32_t);
-	interval.max = mock_type(uint32_t);
-
-	return interval;
-}
-
-
 /** Test \ref test_lsb_new */
 static void test_lsb_new(void **state)
 {
 	struct rohc_lsb_decode *lsb;
 
 	/* 32-bit LSB */
-	lsb = rohc_lsb_new(32);
+	lsb = rohc_lsb_new(NULL, 32);
 	assert_true(lsb != NULL);
 	rohc_lsb_free(lsb);
 
 	/* 16-bit LSB */
-	lsb = rohc_lsb_new(16);
+	lsb = rohc_lsb_new(NULL, 16);
 	assert_true(lsb != NULL);
 	rohc_lsb_free(lsb);
 
 	/* 8-bit LSB */
-	lsb = rohc_lsb_new(8);
+	lsb = rohc_lsb_new(NULL, 8);
 	assert_true(lsb != NULL);
 	rohc_lsb_free(lsb);
 
 #if 0 /* TODO: enable this when all assert() of the library are replaced */
-	lsb = rohc_lsb_new(0);
+	lsb = rohc_lsb_new(NULL, 0);
 	assert_true(lsb == NULL);
 #endif
 }
@@ -87,75 +69,55 @@ static void test_lsb_decode(void **state)
 	const struct
 	{
 		bool used;
-		uint32_t min;
-		uint32_t max;
+		uint32_t v_ref;
+		rohc_lsb_shift_t p;
 		uint32_t m;
 		size_t k;
-		bool exp_status;
 		uint32_t exp_value;
 	} tests[] = {
-		/* used          min          max            m   k   exp_status    exp_value */
-		/* full interval + limits of the interval */
-		{  true,         0x0,  0xffffffff,         0x0,  5,        true,         0x0 },
-		{  true,         0x0,  0xffffffff,  0xffffffff, 32,        true,  0xffffffff },
-		/* full interval + small/medium/large values */
-		{  true,         0x0,  0xffffffff,         0x2,  5,        true,         0x2 },
-		{  true,         0x0,  0xffffffff,  0x7fffffff, 31,        true,  0x7fffffff },
-		{  true,         0x0,  0xffffffff,  0xfffffffd, 32,        true,  0xfffffffd },
-		/* zero interval */
-		{  true,      0x4242,      0x4242,         0x0,  0,        true,      0x4242 },
-		{  true,      0x4242,      0x4242,         0x0,  1,        true,      0x4242 },
-		{  true,      0x4242,      0x4242,  0x00004242, 32,        true,      0x4242 },
-		{  true,      0x4242,      0x4242,         0x1,  1,       false,         0x0 },
-		/* small interval (no wraparound) */
-		{  true,      0x4242,      0x42ff,         0x0,  0,        true,      0x4242 },
-		{  true,      0x4242,      0x42ff,         0x0,  1,        true,      0x4242 },
-		{  true,      0x4242,      0x42ff,         0x1,  1,        true,      0x4243 },
-		{  true,      0x4242,      0x42ff,         0xf,  4,        true,      0x424f },
-		{  true,      0x4242,      0x42ff,        0xff,  8,        true,      0x42ff },
-		{  true,      0x4242,      0x4341,        0x41,  8,        true,      0x4341 },
-		{  true,      0x4242,      0x42ff,        0x41,  8,       false,         0x0 },
-		/* small interval (wraparound) */
-		{  true,  0xfffffffd,        0xff,         0x0,  0,        true,  0xfffffffd },
-		{  true,  0xfffffffd,        0xff,         0x1,  1,        true,  0xfffffffd },
-		{  true,  0xfffffffd,        0xff,         0x0,  1,        true,  0xfffffffe },
-		{  true,  0xfffffffd,        0xff,         0xf,  4,        true,  0xffffffff },
-		{  true,  0xfffffffd,        0xff,        0xff,  8,        true,  0xffffffff },
-		{  true,  0xfffffffd,        0xff,        0x41,  8,        true,        0x41 },
-		{  true,  0xfffffffd,        0x40,        0x41,  8,       false,         0x0 },
+		/* used       v_ref                    p           m   k    exp_value */
+		/* interpretation interval [v_ref ; v_ref + 2^k - 1] */
+		{  true,        0x0, ROHC_LSB_SHIFT_IP_ID,        0x0,  5,         0x0 },
+		{  true,        0x0, ROHC_LSB_SHIFT_IP_ID,        0x2,  5,         0x2 },
+		{  true,        0x0, ROHC_LSB_SHIFT_IP_ID, 0x7fffffff, 31,  0x7fffffff },
+		{  true,        0x0, ROHC_LSB_SHIFT_IP_ID, 0xffffffff, 32,  0xffffffff },
+		{  true,     0x4242, ROHC_LSB_SHIFT_IP_ID,        0x0,  0,      0x4242 },
+		{  true,     0x4242, ROHC_LSB_SHIFT_IP_ID,        0x1,  1,      0x4243 },
+		{  true,     0x4242, ROHC_LSB_SHIFT_IP_ID,       0x41,  8,      0x4341 },
+		{  true,     0x4242, ROHC_LSB_SHIFT_IP_ID, 0x00004242, 32,      0x4242 },
+		/* interpretation interval [v_ref + 1 ; v_ref + 2^k] */
+		{  true,        0x0,    ROHC_LSB_SHIFT_SN,        0x0,  5,        0x20 },
+		{  true,     0x4242,    ROHC_LSB_SHIFT_SN,        0xf,  4,      0x424f },
+		{  true,     0x4242,    ROHC_LSB_SHIFT_SN,        0x2,  4,      0x4252 },
+		/* interpretation interval across the wraparound */
+		{  true, 0xfffffffd, ROHC_LSB_SHIFT_IP_ID,        0x1,  1,  0xfffffffd },
+		{  true, 0xfffffffd, ROHC_LSB_SHIFT_IP_ID,        0x0,  1,  0xfffffffe },
+		{  true, 0xfffffffd, ROHC_LSB_SHIFT_IP_ID,        0xf,  4,  0xffffffff },
+		{  true, 0xfffffffd, ROHC_LSB_SHIFT_IP_ID,       0x41,  8,        0x41 },
+		{  true, 0xfffffffd,    ROHC_LSB_SHIFT_SN,        0x0,  4,         0x0 },
 		/* end of tests */
-		{ false,         0x0,         0x0,         0x0,  0,       false,         0x0 },
+		{ false,        0x0, ROHC_LSB_SHIFT_IP_ID,        0x0,  0,         0x0 },
 	};
 	struct rohc_lsb_decode *lsb;
 	size_t test_num;
 
-	lsb = rohc_lsb_new(32);
+	lsb = rohc_lsb_new(NULL, 32);
 	assert_true(lsb != NULL);
 
-	rohc_lsb_set_ref(lsb, 0, false);
-
 	for(test_num = 0; tests[test_num].used; test_num++)
 	{
 		uint32_t decoded;
 		bool ret;
 
-		printf("decode %zu-bit m 0x%08x in interval [0x%08x ; 0x%08x] (expected %s)\n",
-		       tests[test_num].k, tests[test_num].m, tests[test_num].min,
-		       tests[test_num].max, tests[test_num].exp_status ? "success" : "failure");
+		printf("decode %zu-bit m 0x%08x with reference 0x%08x and shift %d\n",
+		       tests[test_num].k, tests[test_num].m, tests[test_num].v_ref,
+		       tests[test_num].p);
 
-		expect_value(__wrap_rohc_f_32bits, v_ref, 0);
-		expect_value(__wrap_rohc_f_32bits, k, tests[test_num].k);
-		expect_value(__wrap_rohc_f_32bits, p, ROHC_LSB_SHIFT_RTP_TS);
-		will_return(__wrap_rohc_f_32bits, tests[test_num].min);
-		will_return(__wrap_rohc_f_32bits, tests[test_num].max);
+		rohc_lsb_set_ref(lsb, tests[test_num].v_ref, false);
 		ret = rohc_lsb_decode(lsb, ROHC_LSB_REF_0, 0, tests[test_num].m,
-		                      tests[test_num].k, ROHC_LSB_SHIFT_RTP_TS,
-		                      &decoded);
-		assert_true(ret == tests[test_num].exp_status);
-		if(ret)
-		{
-			assert_true(decoded == tests[test_num].exp_value);
-		}
+		                      tests[test_num].k, tests[test_num].p, &decoded);
+		assert_true(ret);
+		assert_true(decoded == tests[test_num].exp_value);
 		printf("\n");
 	}
 
@@ -25,6 +25,7 @@
 #include "rohc_decomp.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
 #include <assert.h>
@@ -46,6 +47,23 @@
 		assert(condition); \
 	} while(0)
 
+static void * alloc_cb(const size_t size, void *const priv)
+	__attribute__((warn_unused_result));
+static void free_cb(void *const ptr, void *const priv);
+static void * count_alloc_cb(const size_t size, void *const priv)
+	__attribute__((warn_unused_result));
+static void * count_aligned_alloc_cb(const size_t alignment,
+                                     const size_t size,
+                                     void *const priv)
+	__attribute__((warn_unused_result));
+static void count_free_cb(void *const ptr, void *const priv);
+
+static void flight_cb(void *const priv,
+                      const rohc_cid_t cid,
+                      const rohc_profile_t profile,
+                      const struct rohc_decomp_flight_pkt pkts[],
+                      const size_t pkts_nr);
+
 
 /**
  * @brief Test the robustness of the decompression API
@@ -100,6 +118,87 @@ int main(int argc, char *argv[])
 	CHECK(decomp != NULL);
 	rohc_decomp_free(decomp);
 
+	/* rohc_decomp_new3() */
+	{
+		size_t allocs_nr = 0;
+		const struct rohc_mem_ops no_alloc_ops = {
+			.aligned_alloc = count_aligned_alloc_cb, .free = count_free_cb,
+			.priv = &allocs_nr
+		};
+		const struct rohc_mem_ops mem_ops = {
+			.alloc = count_alloc_cb, .aligned_alloc = count_aligned_alloc_cb,
+			.free = count_free_cb, .priv = &allocs_nr
+		};
+
+		CHECK(rohc_decomp_new3(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE,
+		                       &no_alloc_ops) == NULL);
+		CHECK(allocs_nr == 0);
+		decomp = rohc_decomp_new3(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE,
+		                          NULL);
+		CHECK(decomp != NULL);
+		rohc_decomp_free(decomp);
+		decomp = rohc_decomp_new3(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE,
+		                          &mem_ops);
+		CHECK(decomp != NULL);
+		CHECK((((uintptr_t) decomp) % 64) == 0);
+		CHECK(allocs_nr > 0);
+		{
+			const size_t allocs_nr_before = allocs_nr;
+			CHECK(rohc_decomp_set_mrru(decomp, 500) == true);
+			CHECK(allocs_nr == (allocs_nr_before + 1));
+		}
+		rohc_decomp_free(decomp);
+		CHECK(allocs_nr == 0);
+	}
+
+	/* rohc_decomp_mem_size() and rohc_decomp_new_static() */
+	{
+		const rohc_profile_t profiles[] = {
+			ROHC_PROFILE_UNCOMPRESSED, ROHC_PROFILE_IP, ROHC_PROFILE_UDP
+		};
+		const size_t profiles_nr = sizeof(profiles) / sizeof(profiles[0]);
+		const rohc_profile_t unknown_profile = ROHC_PROFILE_UDPLITE_RTP;
+		size_t mem_len;
+		void *mem;
+
+		CHECK(rohc_decomp_mem_size(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX + 1,
+		                           profiles, profiles_nr) == 0);
+		CHECK(rohc_decomp_mem_size(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                           NULL, profiles_nr) == 0);
+		CHECK(rohc_decomp_mem_size(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                           profiles, 0) == 0);
+		CHECK(rohc_decomp_mem_size(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                           &unknown_profile, 1) == 0);
+		mem_len = rohc_decomp_mem_size(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                               profiles, profiles_nr);
+		CHECK(mem_len > 0);
+		CHECK(rohc_decomp_mem_size(ROHC_LARGE_CID, ROHC_LARGE_CID_MAX,
+		                           profiles, profiles_nr) > mem_len);
+
+		mem = malloc(mem_len);
+		CHECK(mem != NULL);
+		CHECK(rohc_decomp_new_static(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                             ROHC_U_MODE, NULL, mem_len) == NULL);
+		CHECK(rohc_decomp_new_static(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                             ROHC_U_MODE, mem, 64) == NULL);
+		decomp = rohc_decomp_new_static(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                                ROHC_U_MODE, mem, mem_len);
+		CHECK(decomp != NULL);
+		CHECK(rohc_decomp_set_alloc_cbs(decomp, NULL, NULL, NULL) == false);
+		CHECK(rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+		                                  ROHC_PROFILE_IP, ROHC_PROFILE_UDP,
+		                                  -1) == true);
+		rohc_decomp_free(decomp);
+
+		/* the block may be used again once the decompressor is destroyed */
+		decomp = rohc_decomp_new_static(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+		                                ROHC_U_MODE, ((unsigned char *) mem) + 1,
+		                                mem_len - 1);
+		CHECK(decomp != NULL);
+		rohc_decomp_free(decomp);
+		free(mem);
+	}
+
 	decomp = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
 	CHECK(decomp != NULL);
 
@@ -111,6 +210,42 @@ int main(int argc, char *argv[])
 		CHECK(rohc_decomp_set_traces_cb2(decomp, fct, decomp) == true);
 	}
 
+	/* rohc_decomp_set_trace_ring() */
+	{
+		struct rohc_trace_record records[4];
+		struct rohc_trace_ring ring;
+		CHECK(rohc_trace_ring_init(&ring, records, 4) == true);
+		CHECK(rohc_decomp_set_trace_ring(NULL, &ring) == false);
+		CHECK(rohc_decomp_set_trace_ring(decomp, &ring) == true);
+		CHECK(rohc_decomp_set_trace_ring(decomp, NULL) == true);
+	}
+
+	/* rohc_decomp_set_trace_events() */
+	CHECK(rohc_decomp_set_trace_events(NULL, ROHC_TRACE_EVENTS_ALL) == false);
+	CHECK(rohc_decomp_set_trace_events(decomp, ROHC_TRACE_EVENT_BIT(ROHC_TRACE_EVENT_MAX)) == false);
+	CHECK(rohc_decomp_set_trace_events(decomp, 0) == true);
+	CHECK(rohc_decomp_set_trace_events(decomp, ROHC_TRACE_EVENTS_CTXT) == true);
+	CHECK(rohc_decomp_set_trace_events(decomp, ROHC_TRACE_EVENTS_ALL) == true);
+
+	/* rohc_decomp_trace_filter_*() */
+	CHECK(rohc_decomp_trace_filter_add_cid(NULL, 0) == false);
+	CHECK(rohc_decomp_trace_filter_add_cid(decomp, ROHC_SMALL_CID_MAX + 1) == false);
+	for(size_t i = 0; i < ROHC_TRACE_FILTER_MAX; i++)
+	{
+		CHECK(rohc_decomp_trace_filter_add_cid(decomp, i) == true);
+	}
+	CHECK(rohc_decomp_trace_filter_add_cid(decomp, 0) == true);
+	CHECK(rohc_decomp_trace_filter_add_cid(decomp, ROHC_TRACE_FILTER_MAX) == false);
+	CHECK(rohc_decomp_trace_filter_add_profile(NULL, ROHC_PROFILE_IP) == false);
+	CHECK(rohc_decomp_trace_filter_add_profile(decomp, ROHC_PROFILE_GENERAL) == false);
+	CHECK(rohc_decomp_trace_filter_add_profile(decomp, ROHC_PROFILE_IP) == true);
+	CHECK(rohc_decomp_trace_filter_add_packet_type(NULL, ROHC_PACKET_IR) == false);
+	CHECK(rohc_decomp_trace_filter_add_packet_type(decomp, ROHC_PACKET_UNKNOWN) == false);
+	CHECK(rohc_decomp_trace_filter_add_packet_type(decomp, ROHC_PACKET_MAX) == false);
+	CHECK(rohc_decomp_trace_filter_add_packet_type(decomp, ROHC_PACKET_IR) == true);
+	CHECK(rohc_decomp_trace_filter_clear(NULL) == false);
+	CHECK(rohc_decomp_trace_filter_clear(decomp) == true);
+
 	/* rohc_decomp_profile_enabled() */
 	CHECK(rohc_decomp_profile_enabled(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_decomp_profile_enabled(decomp, ROHC_PROFILE_GENERAL) == false);
@@ -126,12 +261,19 @@ int main(int argc, char *argv[])
 	CHECK(rohc_decomp_enable_profile(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_decomp_enable_profile(decomp, ROHC_PROFILE_GENERAL) == false);
 	CHECK(rohc_decomp_enable_profile(decomp, ROHC_PROFILE_IP) == true);
+	CHECK(rohc_decomp_enable_profile(decomp, ROHCv2_PROFILE_IP) == false);
 
 	/* rohc_decomp_disable_profile() */
 	CHECK(rohc_decomp_disable_profile(NULL, ROHC_PROFILE_IP) == false);
 	CHECK(rohc_decomp_disable_profile(decomp, ROHC_PROFILE_GENERAL) == false);
 	CHECK(rohc_decomp_disable_profile(decomp, ROHC_PROFILE_IP) == true);
 
+	/* a ROHCv1 profile and its ROHCv2 counterpart are mutually exclusive */
+	CHECK(rohc_decomp_enable_profile(decomp, ROHCv2_PROFILE_IP) == true);
+	CHECK(rohc_decomp_enable_profile(decomp, ROHC_PROFILE_IP) == false);
+	CHECK(rohc_decomp_profile_enabled(decomp, ROHC_PROFILE_IP) == false);
+	CHECK(rohc_decomp_disable_profile(decomp, ROHCv2_PROFILE_IP) == true);
+
 	/* rohc_decomp_enable_profiles() */
 	CHECK(rohc_decomp_enable_profiles(NULL, ROHC_PROFILE_IP, -1) == false);
 	CHECK(rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_GENERAL, -1) == false);
@@ -203,6 +345,91 @@ int main(int argc, char *argv[])
 		CHECK(prtt == SIZE_MAX / 2 - 1);
 	}
 
+	/* rohc_decomp_set_reorder_window() */
+	CHECK(rohc_decomp_set_reorder_window(NULL, 4) == false);
+	CHECK(rohc_decomp_set_reorder_window(decomp, 65) == false);
+	CHECK(rohc_decomp_set_reorder_window(decomp, 0) == true);
+	CHECK(rohc_decomp_set_reorder_window(decomp, 64) == true);
+
+	/* rohc_decomp_get_reorder_window() */
+	{
+		size_t window;
+		CHECK(rohc_decomp_get_reorder_window(NULL, &window) == false);
+		CHECK(rohc_decomp_get_reorder_window(decomp, NULL) == false);
+		CHECK(rohc_decomp_get_reorder_window(decomp, &window) == true);
+		CHECK(window == 64);
+		CHECK(rohc_decomp_set_reorder_window(decomp, 0) == true);
+	}
+
+	/* rohc_decomp_set_ctxt_idle_timeout() */
+	CHECK(rohc_decomp_set_ctxt_idle_timeout(NULL, 10) == false);
+	CHECK(rohc_decomp_set_ctxt_idle_timeout(decomp, 10) == true);
+	CHECK(rohc_decomp_set_ctxt_idle_timeout(decomp, 0) == true);
+
+	/* rohc_decomp_set_mem_budget() and rohc_decomp_get_mem_usage() */
+	{
+		size_t usage;
+		CHECK(rohc_decomp_get_mem_usage(NULL, &usage) == false);
+		CHECK(rohc_decomp_get_mem_usage(decomp, NULL) == false);
+		CHECK(rohc_decomp_get_mem_usage(decomp, &usage) == true);
+		CHECK(usage > 0);
+		CHECK(rohc_decomp_set_mem_budget(NULL, usage) == false);
+		CHECK(rohc_decomp_set_mem_budget(decomp, usage) == true);
+		CHECK(rohc_decomp_set_mem_budget(decomp, 0) == true);
+	}
+
+	/* rohc_decomp_set_overload() and rohc_decomp_set_load() */
+	{
+		const struct rohc_load limits = { .queue_depth = 64, .burst_time_us = 0 };
+		const struct rohc_load load = { .queue_depth = 65, .burst_time_us = 0 };
+		CHECK(rohc_decomp_set_overload(NULL, &limits) == false);
+		CHECK(rohc_decomp_set_overload(decomp, &limits) == true);
+		CHECK(rohc_decomp_set_load(NULL, &load) == false);
+		CHECK(rohc_decomp_set_load(decomp, NULL) == false);
+		CHECK(rohc_decomp_set_load(decomp, &load) == true);
+		CHECK(rohc_decomp_set_overload(decomp, NULL) == true);
+	}
+
+	/* rohc_decomp_get_cfg() and rohc_decomp_publish_cfg() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t padding[] = { 0xe0 };
+		const struct rohc_buf pkt = rohc_buf_init_full(padding, 1, ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		struct rohc_decomp_cfg cfg;
+		rohc_status_t status;
+
+		CHECK(rohc_decomp_get_cfg(NULL, &cfg) == false);
+		CHECK(rohc_decomp_get_cfg(decomp, NULL) == false);
+		CHECK(rohc_decomp_get_cfg(decomp, &cfg) == true);
+		CHECK(rohc_decomp_publish_cfg(NULL, &cfg) == false);
+		CHECK(rohc_decomp_publish_cfg(decomp, NULL) == false);
+		cfg.features = ROHC_DECOMP_FEATURE_COMPAT_1_6_x;
+		CHECK(rohc_decomp_publish_cfg(decomp, &cfg) == false);
+		cfg.features = ROHC_DECOMP_FEATURE_NONE;
+		cfg.reorder_window = 65;
+		CHECK(rohc_decomp_publish_cfg(decomp, &cfg) == false);
+		cfg.reorder_window = 4;
+		cfg.n_1 = 0;
+		CHECK(rohc_decomp_publish_cfg(decomp, &cfg) == false);
+		cfg.n_1 = 100;
+		cfg.prtt = 10;
+		CHECK(rohc_decomp_publish_cfg(decomp, &cfg) == true);
+
+		/* not taken before the next packet */
+		memset(&cfg, 0, sizeof(struct rohc_decomp_cfg));
+		CHECK(rohc_decomp_get_cfg(decomp, &cfg) == true);
+		CHECK(cfg.reorder_window != 4 || cfg.prtt != 10);
+
+		status = rohc_decompress3(decomp, pkt, &pkt_out, NULL, NULL);
+		CHECK(status == ROHC_STATUS_OK || status == ROHC_STATUS_MALFORMED);
+		CHECK(rohc_decomp_get_cfg(decomp, &cfg) == true);
+		CHECK(cfg.reorder_window == 4);
+		CHECK(cfg.prtt == 10);
+		CHECK(cfg.n_1 == 100);
+	}
+
 	/* rohc_decomp_set_rate_limits() */
 	CHECK(rohc_decomp_set_rate_limits(NULL,   30, 100, 31, 101, 32, 102) == false);
 	CHECK(rohc_decomp_set_rate_limits(decomp,  0, 100, 31, 101, 32, 102) == true);
@@ -232,11 +459,35 @@ int main(int argc, char *argv[])
 		CHECK(n_2 == 102);
 	}
 
+	/* rohc_decomp_set_feedback_rates() */
+	CHECK(rohc_decomp_set_feedback_rates(NULL, 100, 10) == false);
+	CHECK(rohc_decomp_set_feedback_rates(decomp, 100, 10) == true);
+
+	/* rohc_decomp_get_feedback_rates() */
+	{
+		size_t decomp_rate, ctxt_rate;
+		CHECK(rohc_decomp_get_feedback_rates(NULL, &decomp_rate, &ctxt_rate) == false);
+		CHECK(rohc_decomp_get_feedback_rates(decomp, NULL, &ctxt_rate) == false);
+		CHECK(rohc_decomp_get_feedback_rates(decomp, &decomp_rate, NULL) == false);
+		CHECK(rohc_decomp_get_feedback_rates(decomp, &decomp_rate, &ctxt_rate) == true);
+		CHECK(decomp_rate == 100);
+		CHECK(ctxt_rate == 10);
+	}
+	CHECK(rohc_decomp_set_feedback_rates(decomp, 0, 0) == true);
+
 	/* rohc_decomp_set_features */
 	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_COMPAT_1_6_x) == false);
 	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_CRC_REPAIR) == true);
+	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_BURST_GROUPING) == true);
 	CHECK(rohc_decomp_set_features(decomp, ROHC_DECOMP_FEATURE_NONE) == true);
 
+	/* rohc_decomp_set_alloc_cbs() */
+	CHECK(rohc_decomp_set_alloc_cbs(NULL, alloc_cb, free_cb, NULL) == false);
+	CHECK(rohc_decomp_set_alloc_cbs(decomp, alloc_cb, NULL, NULL) == false);
+	CHECK(rohc_decomp_set_alloc_cbs(decomp, NULL, free_cb, NULL) == false);
+	CHECK(rohc_decomp_set_alloc_cbs(decomp, NULL, NULL, NULL) == true);
+	CHECK(rohc_decomp_set_alloc_cbs(decomp, alloc_cb, free_cb, NULL) == true);
+
 	/* rohc_decompress3() */
 	{
 		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
@@ -287,7 +538,35 @@ int main(int argc, char *argv[])
 		pkt2.max_len = pkt.len - 2;
 		pkt2.offset = 0;
 		pkt2.len = 0;
-		CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, NULL) == ROHC_STATUS_OK);
+		{
+			struct rohc_trace_record records[4];
+			struct rohc_trace_record read_records[4];
+			struct rohc_trace_ring ring;
+			uint32_t next_seq = 0;
+			size_t records_nr;
+
+			CHECK(rohc_trace_ring_init(&ring, records, 4) == true);
+			CHECK(rohc_decomp_set_trace_ring(decomp, &ring) == true);
+			CHECK(rohc_decompress3(decomp, pkt, &pkt2, NULL, NULL) == ROHC_STATUS_OK);
+			CHECK(rohc_decomp_set_trace_ring(decomp, NULL) == true);
+
+			/* the new context, its changes of state and mode, and the
+			 * decompressed packet were recorded */
+			records_nr = rohc_trace_ring_read(&ring, &next_seq, read_records, 4);
+			CHECK(records_nr == 4);
+			CHECK(next_seq == records_nr);
+			CHECK(read_records[0].event == ROHC_TRACE_EVENT_DECOMP_CTXT_NEW);
+			CHECK(read_records[1].event == ROHC_TRACE_EVENT_DECOMP_STATE);
+			CHECK(read_records[1].args[0] == ROHC_DECOMP_STATE_NC);
+			CHECK(read_records[1].args[1] == ROHC_DECOMP_STATE_FC);
+			CHECK(read_records[2].event == ROHC_TRACE_EVENT_DECOMP_MODE);
+			CHECK(read_records[2].args[0] == ROHC_U_MODE);
+			CHECK(read_records[2].args[1] == ROHC_O_MODE);
+			CHECK(read_records[records_nr - 1].event == ROHC_TRACE_EVENT_DECOMP_PKT);
+			CHECK(read_records[records_nr - 1].entity == ROHC_TRACE_DECOMP);
+			CHECK(read_records[records_nr - 1].args[0] == pkt.len);
+			CHECK(read_records[records_nr - 1].args[1] == pkt2.len);
+		}
 		CHECK(pkt2.len > 0);
 
 		{
@@ -310,6 +589,501 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	/* rohc_decompress_burst() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01
+		};
+		struct rohc_buf pkts[3] =
+		{
+			rohc_buf_init_full(buf, sizeof(buf), ts),
+			rohc_buf_init_full(buf, 0, ts),
+			rohc_buf_init_full(buf, sizeof(buf), ts),
+		};
+		uint8_t bufs_out[3][100];
+		struct rohc_buf pkts_out[3] =
+		{
+			rohc_buf_init_empty(bufs_out[0], 100),
+			rohc_buf_init_empty(bufs_out[1], 100),
+			rohc_buf_init_empty(bufs_out[2], 100),
+		};
+		rohc_status_t status[3];
+		uint8_t buf_fb[100];
+		struct rohc_buf fb = rohc_buf_init_empty(buf_fb, 100);
+		uint8_t buf_full[100];
+		struct rohc_buf pkt_full = rohc_buf_init_full(buf_full, 100, ts);
+
+		CHECK(rohc_decompress_burst(NULL, pkts, pkts_out, status, 3, NULL, NULL) == 0);
+		CHECK(rohc_decompress_burst(decomp, NULL, pkts_out, status, 3, NULL, NULL) == 0);
+		CHECK(rohc_decompress_burst(decomp, pkts, NULL, status, 3, NULL, NULL) == 0);
+		CHECK(rohc_decompress_burst(decomp, pkts, pkts_out, NULL, 3, NULL, NULL) == 0);
+		CHECK(rohc_decompress_burst(decomp, pkts, pkts_out, status, 0, NULL, NULL) == 0);
+		CHECK(rohc_decompress_burst(decomp, pkts, pkts_out, status, 3, &pkt_full, NULL) == 0);
+		CHECK(rohc_decompress_burst(decomp, pkts, pkts_out, status, 3, NULL, &pkt_full) == 0);
+
+		/* one bad packet does not prevent the others from being decompressed,
+		 * feedback is aggregated in one single buffer */
+		CHECK(rohc_decompress_burst(decomp, pkts, pkts_out, status, 3, NULL, &fb) == 3);
+		CHECK(status[0] == ROHC_STATUS_OK);
+		CHECK(status[1] == ROHC_STATUS_ERROR);
+		CHECK(status[2] == ROHC_STATUS_OK);
+		CHECK(pkts_out[0].len > 0);
+		CHECK(pkts_out[2].len > 0);
+		CHECK(fb.len > 0);
+	}
+
+	/* rohc_decompress_burst() with feedback coalescing */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01
+		};
+		struct rohc_buf pkts[3] =
+		{
+			rohc_buf_init_full(buf, sizeof(buf), ts),
+			rohc_buf_init_full(buf, sizeof(buf), ts),
+			rohc_buf_init_full(buf, sizeof(buf), ts),
+		};
+		uint8_t bufs_out[3][100];
+		struct rohc_buf pkts_out[3] =
+		{
+			rohc_buf_init_empty(bufs_out[0], 100),
+			rohc_buf_init_empty(bufs_out[1], 100),
+			rohc_buf_init_empty(bufs_out[2], 100),
+		};
+		rohc_status_t status[3];
+		uint8_t buf_fb[100];
+		struct rohc_buf fb = rohc_buf_init_empty(buf_fb, 100);
+		struct rohc_decomp *decomp2;
+
+		decomp2 = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_O_MODE);
+		CHECK(decomp2 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_decomp_set_rate_limits(decomp2, 1, 1, 30, 100, 30, 100) == true);
+		CHECK(rohc_decomp_set_features(decomp2, ROHC_DECOMP_FEATURE_COALESCE_FEEDBACK) == true);
+
+		/* every IR packet is acknowledged: the FEEDBACK-2 that advertises the
+		 * O-mode is kept, the FEEDBACK-1 of the 2nd packet is superseded by
+		 * the FEEDBACK-1 of the 3rd packet */
+		CHECK(rohc_decompress_burst(decomp2, pkts, pkts_out, status, 3, NULL, &fb) == 3);
+		CHECK(status[0] == ROHC_STATUS_OK);
+		CHECK(status[1] == ROHC_STATUS_OK);
+		CHECK(status[2] == ROHC_STATUS_OK);
+		CHECK(fb.len == 9);
+		CHECK(buf_fb[6] == 0xf2);
+
+		rohc_decomp_free(decomp2);
+	}
+
+	/* rohc_decompress_burst() with feedback piggybacked in several packets */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t bufs[2][32] =
+		{
+			{
+				0xf1, 0x10,
+				0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+				0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+				0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+				0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01
+			},
+			{
+				0xf1, 0x20,
+				0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+				0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+				0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+				0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01
+			},
+		};
+		struct rohc_buf pkts[2] =
+		{
+			rohc_buf_init_full(bufs[0], 32, ts),
+			rohc_buf_init_full(bufs[1], 32, ts),
+		};
+		uint8_t bufs_out[2][100];
+		struct rohc_buf pkts_out[2] =
+		{
+			rohc_buf_init_empty(bufs_out[0], 100),
+			rohc_buf_init_empty(bufs_out[1], 100),
+		};
+		rohc_status_t status[2];
+		uint8_t buf_rcvd_fb[100];
+		struct rohc_buf rcvd_fb = rohc_buf_init_empty(buf_rcvd_fb, 100);
+		uint8_t buf_rcvd_fb_small[3];
+		struct rohc_buf rcvd_fb_small = rohc_buf_init_empty(buf_rcvd_fb_small, 3);
+
+		/* the feedback items of all the packets are retrieved */
+		CHECK(rohc_decompress_burst(decomp, pkts, pkts_out, status, 2,
+		                            &rcvd_fb, NULL) == 2);
+		CHECK(status[0] == ROHC_STATUS_OK);
+		CHECK(status[1] == ROHC_STATUS_OK);
+		CHECK(rcvd_fb.len == 4);
+		CHECK(buf_rcvd_fb[0] == 0xf1 && buf_rcvd_fb[1] == 0x10);
+		CHECK(buf_rcvd_fb[2] == 0xf1 && buf_rcvd_fb[3] == 0x20);
+
+		/* the feedback items that do not fit are ignored */
+		rohc_buf_reset(&pkts_out[0]);
+		rohc_buf_reset(&pkts_out[1]);
+		CHECK(rohc_decompress_burst(decomp, pkts, pkts_out, status, 2,
+		                            &rcvd_fb_small, NULL) == 2);
+		CHECK(rcvd_fb_small.len == 2);
+		CHECK(buf_rcvd_fb_small[1] == 0x10);
+	}
+
+	/* rohc_decompress_burst() with the packets grouped by context */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ir0[] =
+		{
+			0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01
+		};
+		uint8_t ir1[] =
+		{
+			0xfd, 0x01, 0x04, 0x5a,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01
+		};
+		const uint8_t ip[] =
+		{
+			0x45, 0x00, 0x00, 0x1c,  0x00, 0x00, 0x40, 0x00,
+			0x40, 0x01, 0x93, 0x8a,  0xc0, 0xa8, 0x13, 0x01,
+			0xc0, 0xa8, 0x13, 0x05,  0x08, 0x00, 0xe9, 0xc2,
+			0x9b, 0x42, 0x00, 0x01
+		};
+		struct rohc_buf pkts[6] =
+		{
+			rohc_buf_init_full(ir0, sizeof(ir0), ts),
+			rohc_buf_init_full(ir1, sizeof(ir1), ts),
+			rohc_buf_init_full(ir0, sizeof(ir0), ts),
+			rohc_buf_init_full(ir1, 0, ts),
+			rohc_buf_init_full(ir0, sizeof(ir0), ts),
+			rohc_buf_init_full(ir1, sizeof(ir1), ts),
+		};
+		uint8_t bufs_out[6][100];
+		struct rohc_buf pkts_out[6] =
+		{
+			rohc_buf_init_empty(bufs_out[0], 100),
+			rohc_buf_init_empty(bufs_out[1], 100),
+			rohc_buf_init_empty(bufs_out[2], 100),
+			rohc_buf_init_empty(bufs_out[3], 100),
+			rohc_buf_init_empty(bufs_out[4], 100),
+			rohc_buf_init_empty(bufs_out[5], 100),
+		};
+		rohc_status_t status[6];
+		struct rohc_decomp *decomp2;
+
+		decomp2 = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		CHECK(decomp2 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_decomp_set_features(decomp2, ROHC_DECOMP_FEATURE_BURST_GROUPING) == true);
+
+		/* every uncompressed packet is written in the slot of its ROHC packet,
+		 * the bad packet keeps its slot too */
+		CHECK(rohc_decompress_burst(decomp2, pkts, pkts_out, status, 6, NULL, NULL) == 6);
+		for(size_t i = 0; i < 6; i++)
+		{
+			if(i == 3)
+			{
+				CHECK(status[i] == ROHC_STATUS_ERROR);
+				CHECK(pkts_out[i].len == 0);
+			}
+			else
+			{
+				CHECK(status[i] == ROHC_STATUS_OK);
+				CHECK(pkts_out[i].len == sizeof(ip));
+				CHECK(memcmp(rohc_buf_data(pkts_out[i]), ip, sizeof(ip)) == 0);
+			}
+		}
+
+		rohc_decomp_free(decomp2);
+	}
+
+	/* rohc_decomp_get_flight() and rohc_decomp_set_flight_cb() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t ir[] =
+		{
+			0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01
+		};
+		uint8_t uo0[] = { 0x00, 0x00 };
+		struct rohc_buf pkt_ir = rohc_buf_init_full(ir, sizeof(ir), ts);
+		struct rohc_buf pkt_uo0 = rohc_buf_init_full(uo0, sizeof(uo0), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		struct rohc_decomp_flight_pkt pkts[ROHC_DECOMP_FLIGHT_PKTS_NR];
+		size_t flight_pkts_nr = 0;
+		struct rohc_decomp *decomp2;
+		rohc_status_t status;
+
+		decomp2 = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+		CHECK(decomp2 != NULL);
+		CHECK(rohc_decomp_enable_profile(decomp2, ROHC_PROFILE_IP) == true);
+
+		CHECK(rohc_decomp_set_flight_cb(NULL, flight_cb, &flight_pkts_nr) == false);
+		CHECK(rohc_decomp_set_flight_cb(decomp2, flight_cb, &flight_pkts_nr) == true);
+		CHECK(rohc_decomp_get_flight(NULL, 0, pkts, ROHC_DECOMP_FLIGHT_PKTS_NR) == 0);
+		CHECK(rohc_decomp_get_flight(decomp2, 0, NULL, ROHC_DECOMP_FLIGHT_PKTS_NR) == 0);
+		CHECK(rohc_decomp_get_flight(decomp2, ROHC_SMALL_CID_MAX + 1, pkts,
+		                             ROHC_DECOMP_FLIGHT_PKTS_NR) == 0);
+
+		/* nothing is recorded without the feature */
+		CHECK(rohc_decompress3(decomp2, pkt_ir, &pkt_out, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(rohc_decomp_get_flight(decomp2, 0, pkts, ROHC_DECOMP_FLIGHT_PKTS_NR) == 0);
+
+		/* the IR packet is recorded with the feature */
+		CHECK(rohc_decomp_set_features(decomp2, ROHC_DECOMP_FEATURE_FLIGHT_RECORDER) == true);
+		rohc_buf_reset(&pkt_out);
+		CHECK(rohc_decompress3(decomp2, pkt_ir, &pkt_out, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(rohc_decomp_get_flight(decomp2, 0, pkts, ROHC_DECOMP_FLIGHT_PKTS_NR) == 1);
+		CHECK(pkts[0].packet_type == ROHC_PACKET_IR);
+		CHECK(pkts[0].status == ROHC_STATUS_OK);
+		CHECK(pkts[0].state == ROHC_DECOMP_STATE_FC);
+		CHECK(pkts[0].len == sizeof(ir));
+		CHECK(pkts[0].bytes_nr == sizeof(ir));
+		CHECK(memcmp(pkts[0].bytes, ir, sizeof(ir)) == 0);
+		CHECK(flight_pkts_nr == 0);
+
+		/* the UO-0 packets with a wrong CRC are given to the callback */
+		for(uint8_t crc = 0; crc < 8 && flight_pkts_nr == 0; crc++)
+		{
+			uo0[0] = 0x08 | crc;
+			rohc_buf_reset(&pkt_out);
+			status = rohc_decompress3(decomp2, pkt_uo0, &pkt_out, NULL, NULL);
+			CHECK(status == ROHC_STATUS_OK || status == ROHC_STATUS_BAD_CRC);
+		}
+		CHECK(flight_pkts_nr >= 2);
+		CHECK(rohc_decomp_get_flight(decomp2, 0, pkts, ROHC_DECOMP_FLIGHT_PKTS_NR) ==
+		      flight_pkts_nr);
+		CHECK(pkts[0].packet_type == ROHC_PACKET_IR);
+		CHECK(pkts[flight_pkts_nr - 1].packet_type == ROHC_PACKET_UO_0);
+		CHECK(pkts[flight_pkts_nr - 1].status == ROHC_STATUS_BAD_CRC);
+		CHECK(pkts[flight_pkts_nr - 1].bytes_nr == sizeof(uo0));
+		CHECK(memcmp(pkts[flight_pkts_nr - 1].bytes, uo0, sizeof(uo0)) == 0);
+
+		/* the most recent packets are copied if the array is too small */
+		CHECK(rohc_decomp_get_flight(decomp2, 0, pkts, 1) == 1);
+		CHECK(pkts[0].packet_type == ROHC_PACKET_UO_0);
+
+		rohc_decomp_free(decomp2);
+	}
+
+	/* rohc_decompress_inplace() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		const uint8_t ir[] =
+		{
+			0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01
+		};
+		uint8_t buf[100];
+		struct rohc_buf pkt = rohc_buf_init_full(buf, 100, ts);
+		uint8_t *payload;
+
+		memcpy(buf + 100 - sizeof(ir), ir, sizeof(ir));
+		pkt.offset = 100 - sizeof(ir);
+		pkt.len = sizeof(ir);
+		payload = buf + 100 - 8;
+
+		CHECK(rohc_decompress_inplace(NULL, &pkt, NULL, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_decompress_inplace(decomp, NULL, NULL, NULL) == ROHC_STATUS_ERROR);
+		pkt.offset = 0;
+		CHECK(rohc_decompress_inplace(decomp, &pkt, NULL, NULL) == ROHC_STATUS_ERROR);
+		pkt.offset = 100 - sizeof(ir);
+
+		/* headroom too small for the uncompressed headers */
+		pkt.data = buf + 100 - sizeof(ir) - 10;
+		pkt.max_len = sizeof(ir) + 10;
+		pkt.offset = 10;
+		CHECK(rohc_decompress_inplace(decomp, &pkt, NULL, NULL) == ROHC_STATUS_OUTPUT_TOO_SMALL);
+		CHECK(pkt.offset == 10);
+		CHECK(pkt.len == sizeof(ir));
+
+		/* the ICMP payload is not moved, the IPv4 header is rebuilt in front
+		 * of it */
+		pkt.data = buf;
+		pkt.max_len = 100;
+		pkt.offset = 100 - sizeof(ir);
+		CHECK(rohc_decompress_inplace(decomp, &pkt, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(pkt.len == 28);
+		CHECK(rohc_buf_data(pkt) + 20 == payload);
+		CHECK(rohc_buf_byte(pkt) == 0x45);
+		CHECK(memcmp(payload, ir + sizeof(ir) - 8, 8) == 0);
+	}
+
+	/* rohc_decompress_fields() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		const uint8_t ir[] =
+		{
+			0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01
+		};
+		const uint8_t addrs[] = { 0xc0, 0xa8, 0x13, 0x01, 0xc0, 0xa8, 0x13, 0x05 };
+		const struct rohc_buf pkt = rohc_buf_init_full((uint8_t *) ir, sizeof(ir), ts);
+		uint8_t buf[100];
+		struct rohc_buf hdrs = rohc_buf_init_empty(buf, 100);
+		struct rohc_decomp_fields fields;
+
+		CHECK(rohc_decompress_fields(NULL, pkt, &hdrs, &fields, NULL, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_decompress_fields(decomp, pkt, NULL, &fields, NULL, NULL) == ROHC_STATUS_ERROR);
+		CHECK(rohc_decompress_fields(decomp, pkt, &hdrs, NULL, NULL, NULL) == ROHC_STATUS_ERROR);
+
+		/* the IPv4 header is built, the ICMP payload is left in the ROHC packet */
+		CHECK(rohc_decompress_fields(decomp, pkt, &hdrs, &fields, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(hdrs.len == 20);
+		CHECK(rohc_buf_byte(hdrs) == 0x45);
+		CHECK(fields.cid == 0);
+		CHECK(fields.profile == ROHC_PROFILE_IP);
+		CHECK(fields.sn == 1);
+		CHECK(fields.hdrs_len == 20);
+		CHECK(fields.payload.len == 8);
+		CHECK(rohc_buf_data(fields.payload) == ir + sizeof(ir) - 8);
+		CHECK(fields.ip_hdrs_nr == 1);
+		CHECK(fields.ip_version == 4);
+		CHECK(fields.ttl == 0x40);
+		CHECK(fields.proto == 1);
+		CHECK(memcmp(fields.src_addr, addrs, 4) == 0);
+		CHECK(memcmp(fields.dst_addr, addrs + 4, 4) == 0);
+		CHECK(fields.src_port == 0 && fields.dst_port == 0);
+		CHECK(fields.is_rtp == false);
+	}
+
+	/* rohc_decomp_shards_*() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0xe0, 0xf1, 0x00, 0xfd,  0x06, 0x04, 0xce, 0x40,
+			0x01, 0xc0, 0xa8, 0x13,  0x01, 0xc0, 0xa8, 0x13,
+			0x05, 0x00, 0x40, 0x00,  0x00, 0xa0, 0x00, 0x00,
+			0x01, 0x08, 0x00, 0xe9,  0xc2, 0x9b, 0x42, 0x00,
+			0x01
+		};
+		struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		struct rohc_decomp_shards *shards;
+		struct rohc_decomp *shard_decomp;
+		size_t shard_id;
+
+		CHECK(rohc_decomp_shards_new(ROHC_LARGE_CID, 15, 0, ROHC_U_MODE) == NULL);
+		CHECK(rohc_decomp_shards_new(ROHC_LARGE_CID, 3, 5, ROHC_U_MODE) == NULL);
+		CHECK(rohc_decomp_shards_new(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX + 1, 4,
+		                             ROHC_U_MODE) == NULL);
+		shards = rohc_decomp_shards_new(ROHC_LARGE_CID, 15, 4, ROHC_U_MODE);
+		CHECK(shards != NULL);
+
+		CHECK(rohc_decomp_shards_get(NULL, 0) == NULL);
+		CHECK(rohc_decomp_shards_get(shards, 4) == NULL);
+		CHECK(rohc_decomp_shards_get(shards, 3) != NULL);
+
+		/* the 16 CIDs are split into 4 shards of 4 CIDs, the padding and the
+		 * feedback before the IR packet of CID 6 are skipped */
+		CHECK(rohc_decomp_shards_select(NULL, pkt, &shard_id) == false);
+		CHECK(rohc_decomp_shards_select(shards, pkt, NULL) == false);
+		CHECK(rohc_decomp_shards_select(shards, pkt, &shard_id) == true);
+		CHECK(shard_id == 1);
+		buf[4] = 0x0f;
+		CHECK(rohc_decomp_shards_select(shards, pkt, &shard_id) == true);
+		CHECK(shard_id == 3);
+
+		/* the CIDs greater than the largest CID go to the last shard */
+		buf[4] = 0x7f;
+		CHECK(rohc_decomp_shards_select(shards, pkt, &shard_id) == true);
+		CHECK(shard_id == 3);
+
+		/* the packet is decompressed by its shard */
+		buf[4] = 0x00;
+		rohc_buf_pull(&pkt, 3);
+		CHECK(rohc_decomp_shards_select(shards, pkt, &shard_id) == true);
+		CHECK(shard_id == 0);
+		shard_decomp = rohc_decomp_shards_get(shards, shard_id);
+		CHECK(shard_decomp != NULL);
+		CHECK(rohc_decomp_enable_profile(shard_decomp, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_decompress3(shard_decomp, pkt, &pkt_out, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(pkt_out.len == 28);
+
+		rohc_decomp_shards_free(NULL);
+		rohc_decomp_shards_free(shards);
+	}
+
+	/* rohc_decomp_engine_*() */
+	{
+		const struct rohc_ts ts = { .sec = 0, .nsec = 0 };
+		uint8_t buf[] =
+		{
+			0xfd, 0x00, 0x04, 0xce,  0x40, 0x01, 0xc0, 0xa8,
+			0x13, 0x01, 0xc0, 0xa8,  0x13, 0x05, 0x00, 0x40,
+			0x00, 0x00, 0xa0, 0x00,  0x00, 0x01, 0x08, 0x00,
+			0xe9, 0xc2, 0x9b, 0x42,  0x00, 0x01
+		};
+		const struct rohc_buf pkt = rohc_buf_init_full(buf, sizeof(buf), ts);
+		uint8_t buf_out[100];
+		struct rohc_buf pkt_out = rohc_buf_init_empty(buf_out, 100);
+		const struct rohc_mem_ops bad_ops = { NULL, NULL, NULL, NULL };
+		struct rohc_decomp_engine *engine;
+		struct rohc_decomp *chan1;
+		struct rohc_decomp *chan2;
+
+		CHECK(rohc_decomp_engine_new(&bad_ops) == NULL);
+		engine = rohc_decomp_engine_new(NULL);
+		CHECK(engine != NULL);
+		CHECK(rohc_decomp_engine_get_channels_nr(NULL) == 0);
+		CHECK(rohc_decomp_engine_get_channels_nr(engine) == 0);
+
+		CHECK(rohc_decomp_engine_new_channel(NULL, ROHC_LARGE_CID, 15,
+		                                     ROHC_U_MODE) == NULL);
+		CHECK(rohc_decomp_engine_new_channel(engine, ROHC_SMALL_CID,
+		                                     ROHC_SMALL_CID_MAX + 1,
+		                                     ROHC_U_MODE) == NULL);
+		chan1 = rohc_decomp_engine_new_channel(engine, ROHC_LARGE_CID, 15,
+		                                       ROHC_U_MODE);
+		CHECK(chan1 != NULL);
+		chan2 = rohc_decomp_engine_new_channel(engine, ROHC_LARGE_CID, 500,
+		                                       ROHC_O_MODE);
+		CHECK(chan2 != NULL);
+		CHECK(rohc_decomp_engine_get_channels_nr(engine) == 2);
+
+		/* the memory functions of the channels are the ones of the engine */
+		CHECK(rohc_decomp_set_alloc_cbs(chan1, NULL, NULL, NULL) == false);
+
+		/* every channel decompresses with its own contexts */
+		CHECK(rohc_decomp_enable_profile(chan1, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_decomp_enable_profile(chan2, ROHC_PROFILE_IP) == true);
+		CHECK(rohc_decompress3(chan1, pkt, &pkt_out, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(pkt_out.len == 28);
+		rohc_buf_reset(&pkt_out);
+		CHECK(rohc_decompress3(chan2, pkt, &pkt_out, NULL, NULL) == ROHC_STATUS_OK);
+		CHECK(pkt_out.len == 28);
+
+		/* the engine is released with its last channel */
+		rohc_decomp_free(chan1);
+		CHECK(rohc_decomp_engine_get_channels_nr(engine) == 1);
+		rohc_decomp_engine_free(NULL);
+		rohc_decomp_engine_free(engine);
+		rohc_decomp_free(chan2);
+	}
+
 	/* rohc_decomp_get_last_packet_info() */
 	{
 		rohc_decomp_last_packet_info_t info;
@@ -327,6 +1101,19 @@ int main(int argc, char *argv[])
 		CHECK(rohc_decomp_get_last_packet_info(decomp, &info) == true);
 	}
 
+	/* rohc_decomp_get_perf_stats() */
+	{
+		struct rohc_decomp_perf_stats stats;
+		CHECK(rohc_decomp_get_perf_stats(NULL, &stats) == false);
+		CHECK(rohc_decomp_get_perf_stats(decomp, NULL) == false);
+		/* durations are measured only if enabled at build time */
+		if(rohc_decomp_get_perf_stats(decomp, &stats))
+		{
+			CHECK(stats.stages[ROHC_DECOMP_PERF_DECODE_HEADER].count > 0);
+			CHECK(stats.stages[ROHC_DECOMP_PERF_CTXT_LOOKUP].count > 0);
+		}
+	}
+
 	/* rohc_decomp_get_general_info() */
 	{
 		rohc_decomp_general_info_t info;
@@ -342,6 +1129,34 @@ int main(int argc, char *argv[])
 		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
 		info.version_minor = 1;
 		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		info.version_minor = 2;
+		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		CHECK(info.failed_decomp_nr <= info.packets_nr);
+		info.version_minor = 3;
+		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		CHECK(info.corrected_crc_failures <= info.crc_repairs_nr);
+		info.version_minor = 4;
+		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		CHECK(info.overloads_nr == 1);
+		CHECK(info.overload_pkts_nr == 0);
+	}
+
+	/* rohc_decomp_get_contexts() */
+	{
+		struct rohc_decomp_ctxt_record records[ROHC_SMALL_CID_MAX + 1];
+		rohc_decomp_general_info_t info;
+		size_t records_nr;
+		memset(&info, 0, sizeof(rohc_decomp_general_info_t));
+		CHECK(rohc_decomp_get_general_info(decomp, &info) == true);
+		CHECK(info.contexts_nr > 0);
+		CHECK(rohc_decomp_get_contexts(NULL, records, ROHC_SMALL_CID_MAX + 1) == 0);
+		CHECK(rohc_decomp_get_contexts(decomp, NULL, ROHC_SMALL_CID_MAX + 1) == 0);
+		CHECK(rohc_decomp_get_contexts(decomp, records, 0) == 0);
+		CHECK(rohc_decomp_get_contexts(decomp, records, 1) == 1);
+		records_nr = rohc_decomp_get_contexts(decomp, records, ROHC_SMALL_CID_MAX + 1);
+		CHECK(records_nr == info.contexts_nr);
+		CHECK(records[0].packets_nr > 0);
+		CHECK(records[0].profile != ROHC_PROFILE_GENERAL);
 	}
 
 	/* rohc_decomp_get_state_descr() */
@@ -355,6 +1170,7 @@ int main(int argc, char *argv[])
 		rohc_trace_callback2_t fct = (rohc_trace_callback2_t) NULL;
 		CHECK(rohc_decomp_set_traces_cb2(decomp, fct, decomp) == false);
 	}
+	CHECK(rohc_decomp_set_alloc_cbs(decomp, NULL, NULL, NULL) == false);
 
 	/* rohc_decomp_free() */
 	rohc_decomp_free(NULL);
@@ -368,3 +1184,112 @@ error:
 	return is_failure;
 }
 
+
+/**
+ * @brief Allocate memory for the decompressor
+ *
+ * @param size  The size of the memory to allocate
+ * @param priv  Private data
+ * @return      The allocated memory
+ */
+static void * alloc_cb(const size_t size,
+                       void *const priv __attribute__((unused)))
+{
+	return malloc(size);
+}
+
+
+/**
+ * @brief Free memory for the decompressor
+ *
+ * @param ptr   The memory to free
+ * @param priv  Private data
+ */
+static void free_cb(void *const ptr, void *const priv __attribute__((unused)))
+{
+	free(ptr);
+}
+
+
+/**
+ * @brief Allocate memory for the decompressor and count the allocations
+ *
+ * @param size  The number of bytes to allocate
+ * @param priv  The number of allocations not freed yet
+ * @return      The allocated memory
+ */
+static void * count_alloc_cb(const size_t size, void *const priv)
+{
+	size_t *const allocs_nr = priv;
+	void *const ptr = malloc(size);
+
+	if(ptr != NULL)
+	{
+		(*allocs_nr)++;
+	}
+	return ptr;
+}
+
+
+/**
+ * @brief Allocate aligned memory for the decompressor and count the allocations
+ *
+ * @param alignment  The alignment of the memory
+ * @param size       The number of bytes to allocate
+ * @param priv       The number of allocations not freed yet
+ * @return           The allocated memory
+ */
+static void * count_aligned_alloc_cb(const size_t alignment,
+                                     const size_t size,
+                                     void *const priv)
+{
+	size_t *const allocs_nr = priv;
+	void *ptr;
+
+	if(posix_memalign(&ptr, alignment, size) != 0)
+	{
+		return NULL;
+	}
+	(*allocs_nr)++;
+	return ptr;
+}
+
+
+/**
+ * @brief Free memory for the decompressor and count the allocations
+ *
+ * @param ptr   The memory to free
+ * @param priv  The number of allocations not freed yet
+ */
+static void count_free_cb(void *const ptr, void *const priv)
+{
+	size_t *const allocs_nr = priv;
+
+	(*allocs_nr)--;
+	free(ptr);
+}
+
+
+/**
+ * @brief Record the number of packets given for a damaged context
+ *
+ * @param priv     The number of packets given
+ * @param cid      The CID of the context
+ * @param profile  The profile of the context
+ * @param pkts     The recorded packets, the oldest first
+ * @param pkts_nr  The number of recorded packets
+ */
+static void flight_cb(void *const priv,
+                      const rohc_cid_t cid,
+                      const rohc_profile_t profile,
+                      const struct rohc_decomp_flight_pkt pkts[],
+                      const size_t pkts_nr)
+{
+	size_t *const flight_pkts_nr = priv;
+
+	assert(cid == 0);
+	assert(profile == ROHC_PROFILE_IP);
+	assert(pkts_nr > 0);
+	assert(pkts[pkts_nr - 1].status == ROHC_STATUS_BAD_CRC);
+	*flight_pkts_nr = pkts_nr;
+}
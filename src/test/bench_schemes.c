@@ -0,0 +1,1083 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    bench_schemes.c
+ * @brief   Microbenchmark the encoding and decoding schemes
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * Every benchmark runs one operation of an encoding or decoding scheme on
+ * inputs generated from a fixed seed, so that all runs perform the same
+ * work. Every benchmark is warmed up, then run several times. The minimum
+ * and median times per operation are printed on one line per benchmark, so
+ * that the outputs of two builds may be compared line by line.
+ *
+ * Run the benchmarks with 'make bench'.
+ */
+
+#include "schemes/comp_wlsb.h"
+#include "schemes/decomp_wlsb.h"
+#include "schemes/comp_scaled_rtp_ts.h"
+#include "schemes/comp_list_ipv6.h"
+#include "schemes/decomp_list_ipv6.h"
+#include "schemes/tcp_ts.h"
+#include "schemes/tcp_sack.h"
+#include "rohc_comp_internals.h"
+#include "feedback_create.h"
+#include "interval.h"
+#include "sdvl.h"
+#include "crc.h"
+#include "ip.h"
+#include "protocols/ipv6.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+#include <assert.h>
+
+
+/** The default number of operations per timed run */
+#define BENCH_ITERS_DEFAULT  1000000U
+
+/** The number of timed runs of every benchmark */
+#define BENCH_RUNS_NR  7U
+
+/** The number of inputs generated for every benchmark (power of two) */
+#define BENCH_INPUTS_NR  4096U
+
+/** The seed of the pseudo-random generator of inputs */
+#define BENCH_SEED  0x524f4843U
+
+/** The length of the headers the CRCs are computed on */
+#define BENCH_CRC_DATA_LEN  40U
+
+/** The number of IPv6 packets with different extension lists */
+#define BENCH_LISTS_NR  2U
+
+/** The number of packets in one cycle of list (de)compression */
+#define BENCH_LIST_CYCLE_LEN  64U
+
+/** The maximum length of one compressed list */
+#define BENCH_LIST_MAX_LEN  100U
+
+/** The large CID the feedback packets are built for */
+#define BENCH_FEEDBACK_CID  300U
+
+/** The number of SN bits the feedback packets acknowledge */
+#define BENCH_FEEDBACK_SN_BITS_NR  16U
+
+
+/** The objects and the inputs shared by all benchmarks */
+struct bench_ctxt
+{
+	uint32_t values[BENCH_INPUTS_NR];  /**< Random values near the windows */
+	uint32_t randoms[BENCH_INPUTS_NR]; /**< Fully random values */
+	uint8_t crc_data[BENCH_CRC_DATA_LEN];  /**< The data to compute CRCs on */
+	uint8_t sdvl_data[BENCH_INPUTS_NR][4]; /**< The SDVL-encoded values */
+
+	struct c_wlsb *wlsb8;    /**< The W-LSB window for 8-bit values */
+	struct c_wlsb *wlsb16;   /**< The W-LSB window for 16-bit values */
+	struct c_wlsb *wlsb32;   /**< The W-LSB window for 32-bit values */
+	struct c_wlsb *wlsb_add; /**< The W-LSB window for the add benchmark */
+	struct rohc_lsb_decode *lsb16;  /**< The LSB decoder for 16-bit values */
+	struct rohc_lsb_decode *lsb32;  /**< The LSB decoder for 32-bit values */
+	uint32_t ref_value;      /**< The reference value of all windows */
+
+	struct ts_sc_comp ts_sc; /**< The scaled RTP TS compressor */
+	uint32_t ts;             /**< The last RTP TS given to the compressor */
+	uint16_t sn;             /**< The last RTP SN given to the compressor */
+
+	/** The IPv6 packets with extension headers for list (de)compression */
+	uint8_t ipv6_pkts[BENCH_LISTS_NR][sizeof(struct ipv6_hdr) + 16 + 16 + 8];
+	struct ip_packet ipv6[BENCH_LISTS_NR];  /**< The parsed IPv6 packets */
+	struct list_comp list_comp;             /**< The list compressor */
+	struct list_decomp list_decomp;         /**< The list decompressor */
+	size_t list_pkt_idx;                    /**< The next packet to compress */
+	/** One cycle of compressed lists in steady state */
+	uint8_t lists[BENCH_LIST_CYCLE_LEN][BENCH_LIST_MAX_LEN];
+	size_t lists_len[BENCH_LIST_CYCLE_LEN]; /**< The lengths of the lists */
+
+	struct rohc_comp comp;            /**< A compressor for TCP options */
+	struct rohc_comp_ctxt tcp_ctxt;   /**< A TCP context for TCP options */
+	sack_block_t sack_blocks[BENCH_INPUTS_NR][2]; /**< SACK blocks */
+	struct c_tcp_sack_cache sack_cache;  /**< The cache of SACK encoding */
+
+	struct d_feedback_tmpl feedback_tmpl; /**< The prebuilt FEEDBACK-2 */
+};
+
+
+/** One benchmark */
+struct bench
+{
+	const char *name;  /**< The name of the benchmark */
+	/** Run the given number of operations, return a value that depends on
+	 *  all operations so that the compiler cannot skip any of them */
+	uint64_t (*run)(struct bench_ctxt *const ctxt, const size_t iters);
+};
+
+
+static bool bench_ctxt_init(struct bench_ctxt *const ctxt)
+	__attribute__((warn_unused_result, nonnull(1)));
+static void bench_ctxt_free(struct bench_ctxt *const ctxt)
+	__attribute__((nonnull(1)));
+static bool bench_lists_init(struct bench_ctxt *const ctxt)
+	__attribute__((warn_unused_result, nonnull(1)));
+static int bench_list_encode_next(struct bench_ctxt *const ctxt,
+                                  uint8_t *const dest)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static double bench_run(struct bench_ctxt *const ctxt,
+                        const struct bench *const bench,
+                        const size_t iters,
+                        double *const median_ns)
+	__attribute__((nonnull(1, 2, 4)));
+static uint64_t bench_get_ns(void)
+	__attribute__((warn_unused_result));
+static uint32_t bench_rand(uint32_t *const state)
+	__attribute__((warn_unused_result, nonnull(1)));
+static int bench_cmp_double(const void *const a, const void *const b)
+	__attribute__((warn_unused_result, nonnull(1, 2), pure));
+
+static uint64_t bench_c_add_wlsb(struct bench_ctxt *const ctxt, const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_wlsb_get_k_8bits(struct bench_ctxt *const ctxt,
+                                       const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_wlsb_get_k_16bits(struct bench_ctxt *const ctxt,
+                                        const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_wlsb_get_k_32bits(struct bench_ctxt *const ctxt,
+                                        const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_wlsb_get_kp_16bits(struct bench_ctxt *const ctxt,
+                                         const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_wlsb_get_kps_32bits(struct bench_ctxt *const ctxt,
+                                          const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_rohc_lsb_decode_16bits(struct bench_ctxt *const ctxt,
+                                             const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_rohc_lsb_decode_32bits(struct bench_ctxt *const ctxt,
+                                             const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_rohc_f_8bits(struct bench_ctxt *const ctxt,
+                                   const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_rohc_f_16bits(struct bench_ctxt *const ctxt,
+                                    const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_rohc_f_32bits(struct bench_ctxt *const ctxt,
+                                    const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_sdvl_encode(struct bench_ctxt *const ctxt,
+                                  const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_sdvl_decode(struct bench_ctxt *const ctxt,
+                                  const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_crc3(struct bench_ctxt *const ctxt, const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_crc7(struct bench_ctxt *const ctxt, const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_crc8(struct bench_ctxt *const ctxt, const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_fcs32(struct bench_ctxt *const ctxt, const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_c_add_ts(struct bench_ctxt *const ctxt, const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_list_encode(struct bench_ctxt *const ctxt,
+                                  const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_list_decode(struct bench_ctxt *const ctxt,
+                                  const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_tcp_opt_ts(struct bench_ctxt *const ctxt,
+                                 const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_tcp_opt_sack(struct bench_ctxt *const ctxt,
+                                   const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_feedback2_build(struct bench_ctxt *const ctxt,
+                                      const size_t iters)
+	__attribute__((nonnull(1)));
+static uint64_t bench_feedback2_tmpl(struct bench_ctxt *const ctxt,
+                                     const size_t iters)
+	__attribute__((nonnull(1)));
+
+
+/** All the benchmarks, in the order they are run */
+static const struct bench benches[] =
+{
+	{ "c_add_wlsb",              bench_c_add_wlsb },
+	{ "wlsb_get_k_8bits",        bench_wlsb_get_k_8bits },
+	{ "wlsb_get_k_16bits",       bench_wlsb_get_k_16bits },
+	{ "wlsb_get_k_32bits",       bench_wlsb_get_k_32bits },
+	{ "wlsb_get_kp_16bits",      bench_wlsb_get_kp_16bits },
+	{ "wlsb_get_kps_32bits",     bench_wlsb_get_kps_32bits },
+	{ "rohc_lsb_decode_16bits",  bench_rohc_lsb_decode_16bits },
+	{ "rohc_lsb_decode_32bits",  bench_rohc_lsb_decode_32bits },
+	{ "rohc_f_8bits",            bench_rohc_f_8bits },
+	{ "rohc_f_16bits",           bench_rohc_f_16bits },
+	{ "rohc_f_32bits",           bench_rohc_f_32bits },
+	{ "sdvl_encode_full",        bench_sdvl_encode },
+	{ "sdvl_decode",             bench_sdvl_decode },
+	{ "crc_calculate_3",         bench_crc3 },
+	{ "crc_calculate_7",         bench_crc7 },
+	{ "crc_calculate_8",         bench_crc8 },
+	{ "crc_calc_fcs32",          bench_fcs32 },
+	{ "c_add_ts",                bench_c_add_ts },
+	{ "rohc_list_encode_ipv6",   bench_list_encode },
+	{ "rohc_list_decode_ipv6",   bench_list_decode },
+	{ "c_tcp_ts_lsb_code",       bench_tcp_opt_ts },
+	{ "c_tcp_opt_sack_code",     bench_tcp_opt_sack },
+	{ "f_feedback2_ack",         bench_feedback2_build },
+	{ "f_feedback2_tmpl_ack",    bench_feedback2_tmpl },
+};
+
+
+/**
+ * @brief Run the microbenchmarks of the encoding and decoding schemes
+ *
+ * @param argc  The number of command line arguments
+ * @param argv  The command line arguments
+ * @return      0 if the benchmarks succeed, 1 otherwise
+ */
+int main(int argc, char *argv[])
+{
+	const size_t benches_nr = sizeof(benches) / sizeof(benches[0]);
+	struct bench_ctxt *ctxt;
+	const char *filter = NULL;
+	size_t iters = BENCH_ITERS_DEFAULT;
+	int is_failure = 1;
+	size_t i;
+
+	/* parse arguments */
+	for(i = 1; i < (size_t) argc; i++)
+	{
+		if(!strcmp(argv[i], "-n") && (i + 1) < (size_t) argc)
+		{
+			const int iters_arg = atoi(argv[i + 1]);
+			if(iters_arg <= 0)
+			{
+				fprintf(stderr, "invalid number of iterations '%s'\n", argv[i + 1]);
+				goto error;
+			}
+			iters = iters_arg;
+			i++;
+		}
+		else if(filter == NULL && argv[i][0] != '-')
+		{
+			filter = argv[i];
+		}
+		else
+		{
+			printf("microbenchmark the ROHC encoding and decoding schemes\n");
+			printf("usage: %s [-n ITERATIONS] [FILTER]\n", argv[0]);
+			printf("  -n ITERATIONS  the number of operations per run "
+			       "(default: %u)\n", BENCH_ITERS_DEFAULT);
+			printf("  FILTER         only run the benchmarks whose name "
+			       "contains FILTER\n");
+			goto error;
+		}
+	}
+
+	ctxt = calloc(1, sizeof(struct bench_ctxt));
+	if(ctxt == NULL)
+	{
+		fprintf(stderr, "failed to allocate memory for benchmarks\n");
+		goto error;
+	}
+	if(!bench_ctxt_init(ctxt))
+	{
+		fprintf(stderr, "failed to initialize benchmarks\n");
+		goto free_ctxt;
+	}
+
+	printf("# %zu operations per run, minimum and median of %u runs\n",
+	       iters, BENCH_RUNS_NR);
+	printf("# %-28s %12s %12s\n", "benchmark", "min ns/op", "median ns/op");
+	for(i = 0; i < benches_nr; i++)
+	{
+		double min_ns;
+		double median_ns;
+
+		if(filter != NULL && strstr(benches[i].name, filter) == NULL)
+		{
+			continue;
+		}
+		min_ns = bench_run(ctxt, &benches[i], iters, &median_ns);
+		printf("  %-28s %12.2f %12.2f\n", benches[i].name, min_ns, median_ns);
+		fflush(stdout);
+	}
+
+	is_failure = 0;
+
+	bench_ctxt_free(ctxt);
+free_ctxt:
+	free(ctxt);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Run one benchmark
+ *
+ * The benchmark is warmed up with one untimed run, then it is timed
+ * BENCH_RUNS_NR times.
+ *
+ * @param ctxt            The objects and inputs shared by all benchmarks
+ * @param bench           The benchmark to run
+ * @param iters           The number of operations per run
+ * @param[out] median_ns  The median time per operation (in ns)
+ * @return                The minimum time per operation (in ns)
+ */
+static double bench_run(struct bench_ctxt *const ctxt,
+                        const struct bench *const bench,
+                        const size_t iters,
+                        double *const median_ns)
+{
+	double runs_ns[BENCH_RUNS_NR];
+	volatile uint64_t sink;
+	size_t run;
+
+	/* warmup */
+	sink = bench->run(ctxt, iters);
+
+	for(run = 0; run < BENCH_RUNS_NR; run++)
+	{
+		const uint64_t start_ns = bench_get_ns();
+		sink += bench->run(ctxt, iters);
+		runs_ns[run] = ((double) (bench_get_ns() - start_ns)) / iters;
+	}
+	(void) sink;
+
+	qsort(runs_ns, BENCH_RUNS_NR, sizeof(double), bench_cmp_double);
+	*median_ns = runs_ns[BENCH_RUNS_NR / 2];
+
+	return runs_ns[0];
+}
+
+
+/**
+ * @brief Create the objects and generate the inputs of all benchmarks
+ *
+ * @param ctxt  The objects and inputs shared by all benchmarks
+ * @return      true if the benchmarks are ready, false otherwise
+ */
+static bool bench_ctxt_init(struct bench_ctxt *const ctxt)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	static const struct rohc_comp_profile tcp_profile = {
+		.id = ROHC_PROFILE_TCP,
+	};
+	uint32_t seed = BENCH_SEED;
+	size_t i;
+
+	/* the windows of the W-LSB encoders and LSB decoders are filled with
+	 * values around the reference value, the inputs are close to it */
+	ctxt->ref_value = 0x10000;
+	for(i = 0; i < BENCH_INPUTS_NR; i++)
+	{
+		ctxt->values[i] = ctxt->ref_value + (bench_rand(&seed) % 300) - 100;
+		ctxt->randoms[i] = bench_rand(&seed);
+	}
+	for(i = 0; i < BENCH_CRC_DATA_LEN; i++)
+	{
+		ctxt->crc_data[i] = bench_rand(&seed);
+	}
+
+	ctxt->wlsb8 = c_create_wlsb(NULL, 8, 4, ROHC_LSB_SHIFT_SN);
+	ctxt->wlsb16 = c_create_wlsb(NULL, 16, 4, ROHC_LSB_SHIFT_SN);
+	ctxt->wlsb32 = c_create_wlsb(NULL, 32, 4, ROHC_LSB_SHIFT_SN);
+	ctxt->wlsb_add = c_create_wlsb(NULL, 16, 4, ROHC_LSB_SHIFT_SN);
+	ctxt->lsb16 = rohc_lsb_new(NULL, 16);
+	ctxt->lsb32 = rohc_lsb_new(NULL, 32);
+	if(ctxt->wlsb8 == NULL || ctxt->wlsb16 == NULL || ctxt->wlsb32 == NULL ||
+	   ctxt->wlsb_add == NULL || ctxt->lsb16 == NULL || ctxt->lsb32 == NULL)
+	{
+		fprintf(stderr, "no memory to allocate W-LSB contexts\n");
+		goto error;
+	}
+	for(i = 0; i < 4; i++)
+	{
+		const uint32_t value = ctxt->ref_value - 3 + i;
+		c_add_wlsb(ctxt->wlsb8, i, value & 0xff);
+		c_add_wlsb(ctxt->wlsb16, i, value & 0xffff);
+		c_add_wlsb(ctxt->wlsb32, i, value);
+	}
+	rohc_lsb_set_ref(ctxt->lsb16, ctxt->ref_value & 0xffff, false);
+	rohc_lsb_set_ref(ctxt->lsb32, ctxt->ref_value, false);
+
+	/* the SDVL inputs */
+	for(i = 0; i < BENCH_INPUTS_NR; i++)
+	{
+		const uint32_t value = ctxt->randoms[i] >> (ctxt->randoms[i] % 32);
+		size_t len;
+		if(!sdvl_encode_full(ctxt->sdvl_data[i], 4, &len,
+		                     value & ((1U << 29) - 1)))
+		{
+			fprintf(stderr, "failed to SDVL-encode value 0x%08x\n", value);
+			goto error;
+		}
+	}
+
+	/* the scaled RTP TS encoder with a stream of audio packets */
+	if(!c_create_sc(&ctxt->ts_sc, NULL, 4, false, 0, NULL, NULL))
+	{
+		fprintf(stderr, "no memory to allocate the scaled RTP TS encoder\n");
+		goto error;
+	}
+	ctxt->ts = 0x12345678;
+	ctxt->sn = 0x1234;
+	for(i = 0; i < 10; i++)
+	{
+		ctxt->ts += 160;
+		ctxt->sn++;
+		c_add_ts(&ctxt->ts_sc, ctxt->ts, ctxt->sn, arrival_time);
+		add_scaled(&ctxt->ts_sc, ctxt->sn);
+		add_unscaled(&ctxt->ts_sc, ctxt->sn);
+	}
+
+	/* the list compressor and decompressor in steady state */
+	if(!bench_lists_init(ctxt))
+	{
+		goto free_ts_sc;
+	}
+
+	/* the TCP options with a fake TCP context */
+	ctxt->tcp_ctxt.compressor = &ctxt->comp;
+	ctxt->tcp_ctxt.profile = &tcp_profile;
+	for(i = 0; i < BENCH_INPUTS_NR; i++)
+	{
+		const uint32_t ack = ctxt->randoms[i];
+		ctxt->sack_blocks[i][0].block_start = rohc_hton32(ack + 1000);
+		ctxt->sack_blocks[i][0].block_end = rohc_hton32(ack + 2000);
+		ctxt->sack_blocks[i][1].block_start = rohc_hton32(ack + 3000);
+		ctxt->sack_blocks[i][1].block_end = rohc_hton32(ack + 4000);
+	}
+
+	return true;
+
+free_ts_sc:
+	c_destroy_sc(&ctxt->ts_sc);
+error:
+	if(ctxt->wlsb8 != NULL)
+	{
+		c_destroy_wlsb(ctxt->wlsb8);
+	}
+	if(ctxt->wlsb16 != NULL)
+	{
+		c_destroy_wlsb(ctxt->wlsb16);
+	}
+	if(ctxt->wlsb32 != NULL)
+	{
+		c_destroy_wlsb(ctxt->wlsb32);
+	}
+	if(ctxt->wlsb_add != NULL)
+	{
+		c_destroy_wlsb(ctxt->wlsb_add);
+	}
+	if(ctxt->lsb16 != NULL)
+	{
+		rohc_lsb_free(ctxt->lsb16);
+	}
+	if(ctxt->lsb32 != NULL)
+	{
+		rohc_lsb_free(ctxt->lsb32);
+	}
+	return false;
+}
+
+
+/**
+ * @brief Destroy the objects of all benchmarks
+ *
+ * @param ctxt  The objects and inputs shared by all benchmarks
+ */
+static void bench_ctxt_free(struct bench_ctxt *const ctxt)
+{
+	rohc_decomp_list_ipv6_free(&ctxt->list_decomp);
+	rohc_comp_list_ipv6_free(&ctxt->list_comp);
+	c_destroy_sc(&ctxt->ts_sc);
+	rohc_lsb_free(ctxt->lsb32);
+	rohc_lsb_free(ctxt->lsb16);
+	c_destroy_wlsb(ctxt->wlsb_add);
+	c_destroy_wlsb(ctxt->wlsb32);
+	c_destroy_wlsb(ctxt->wlsb16);
+	c_destroy_wlsb(ctxt->wlsb8);
+}
+
+
+/**
+ * @brief Build the IPv6 packets and bring list (de)compression in steady state
+ *
+ * The packets alternate between two lists of IPv6 extension headers every
+ * 4 packets, so that the compressor keeps encoding lists. One cycle of
+ * compressed lists is recorded once the compressor reached its steady
+ * state, the decompression benchmark replays it.
+ *
+ * @param ctxt  The objects and inputs shared by all benchmarks
+ * @return      true if list (de)compression is ready, false otherwise
+ */
+static bool bench_lists_init(struct bench_ctxt *const ctxt)
+{
+	size_t i;
+
+	for(i = 0; i < BENCH_LISTS_NR; i++)
+	{
+		uint8_t *const pkt = ctxt->ipv6_pkts[i];
+		struct ipv6_hdr *const ipv6 = (struct ipv6_hdr *) pkt;
+		uint8_t *const hop_opts = pkt + sizeof(struct ipv6_hdr);
+		uint8_t *const dst_opts = hop_opts + 16;
+		const size_t pkt_len = sizeof(ctxt->ipv6_pkts[i]);
+
+		/* IPv6 header followed by Hop-by-Hop and Destination options, then
+		 * 8 bytes of UDP; the Destination options differ between lists */
+		memset(pkt, 0, pkt_len);
+		ipv6->version = 6;
+		ipv6->plen = rohc_hton16(pkt_len - sizeof(struct ipv6_hdr));
+		ipv6->nh = ROHC_IPPROTO_HOPOPTS;
+		ipv6->hl = 64;
+		ipv6->saddr.u8[15] = 1;
+		ipv6->daddr.u8[15] = 2;
+		hop_opts[0] = ROHC_IPPROTO_DSTOPTS;
+		hop_opts[1] = 1; /* 16 bytes */
+		hop_opts[2] = 1; /* PadN */
+		hop_opts[3] = 12;
+		dst_opts[0] = ROHC_IPPROTO_UDP;
+		dst_opts[1] = 1; /* 16 bytes */
+		dst_opts[2] = 0x1e; /* experimental option */
+		dst_opts[3] = 12;
+		dst_opts[4] = i + 1;
+
+		if(!ip_create(&ctxt->ipv6[i], pkt, pkt_len))
+		{
+			fprintf(stderr, "failed to parse IPv6 packet #%zu\n", i + 1);
+			goto error;
+		}
+	}
+
+	rohc_comp_list_ipv6_new(&ctxt->list_comp, 3, NULL, NULL, ROHC_PROFILE_IP);
+	rohc_decomp_list_ipv6_new(&ctxt->list_decomp, NULL, NULL, ROHC_PROFILE_IP);
+
+	/* bring compressor and decompressor to steady state, then record and
+	 * decode one cycle of compressed lists */
+	for(i = 0; i < (BENCH_LIST_CYCLE_LEN * 2); i++)
+	{
+		uint8_t list[BENCH_LIST_MAX_LEN];
+		uint8_t *const dest =
+			(i < BENCH_LIST_CYCLE_LEN ? list :
+			 ctxt->lists[i - BENCH_LIST_CYCLE_LEN]);
+		const int len = bench_list_encode_next(ctxt, dest);
+		if(len <= 0 || rohc_list_decode_maybe(&ctxt->list_decomp, dest, len) != len)
+		{
+			fprintf(stderr, "failed to compress/decompress list #%zu\n", i + 1);
+			goto free_lists;
+		}
+		if(i >= BENCH_LIST_CYCLE_LEN)
+		{
+			ctxt->lists_len[i - BENCH_LIST_CYCLE_LEN] = len;
+		}
+	}
+
+	/* the recorded cycle shall be decoded again and again */
+	for(i = 0; i < BENCH_LIST_CYCLE_LEN; i++)
+	{
+		if(rohc_list_decode_maybe(&ctxt->list_decomp, ctxt->lists[i],
+		                          ctxt->lists_len[i]) != (int) ctxt->lists_len[i])
+		{
+			fprintf(stderr, "failed to decompress list #%zu again\n", i + 1);
+			goto free_lists;
+		}
+	}
+
+	return true;
+
+free_lists:
+	rohc_decomp_list_ipv6_free(&ctxt->list_decomp);
+	rohc_comp_list_ipv6_free(&ctxt->list_comp);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Compress the list of IPv6 extension headers of the next packet
+ *
+ * @param ctxt  The objects and inputs shared by all benchmarks
+ * @param dest  The buffer to write the compressed list into
+ * @return      The length of the compressed list, -1 in case of error
+ */
+static int bench_list_encode_next(struct bench_ctxt *const ctxt,
+                                  uint8_t *const dest)
+{
+	const struct ip_packet *const ip =
+		&ctxt->ipv6[(ctxt->list_pkt_idx / 4) % BENCH_LISTS_NR];
+	bool list_struct_changed;
+	bool list_content_changed;
+	int len;
+
+	ctxt->list_pkt_idx = (ctxt->list_pkt_idx + 1) % BENCH_LIST_CYCLE_LEN;
+
+	if(!detect_ipv6_ext_changes(&ctxt->list_comp, ip, &list_struct_changed,
+	                            &list_content_changed))
+	{
+		return -1;
+	}
+	len = rohc_list_encode(&ctxt->list_comp, dest, 0);
+	rohc_list_update_context(&ctxt->list_comp);
+
+	return len;
+}
+
+
+/*
+ * The benchmarks
+ */
+
+static uint64_t bench_c_add_wlsb(struct bench_ctxt *const ctxt, const size_t iters)
+{
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		c_add_wlsb(ctxt->wlsb_add, i, ctxt->values[i % BENCH_INPUTS_NR]);
+	}
+	return wlsb_get_k_16bits(ctxt->wlsb_add, ctxt->values[0]);
+}
+
+static uint64_t bench_wlsb_get_k_8bits(struct bench_ctxt *const ctxt,
+                                       const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		sum += wlsb_get_k_8bits(ctxt->wlsb8, ctxt->values[i % BENCH_INPUTS_NR]);
+	}
+	return sum;
+}
+
+static uint64_t bench_wlsb_get_k_16bits(struct bench_ctxt *const ctxt,
+                                        const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		sum += wlsb_get_k_16bits(ctxt->wlsb16, ctxt->values[i % BENCH_INPUTS_NR]);
+	}
+	return sum;
+}
+
+static uint64_t bench_wlsb_get_k_32bits(struct bench_ctxt *const ctxt,
+                                        const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		sum += wlsb_get_k_32bits(ctxt->wlsb32, ctxt->values[i % BENCH_INPUTS_NR]);
+	}
+	return sum;
+}
+
+static uint64_t bench_wlsb_get_kp_16bits(struct bench_ctxt *const ctxt,
+                                         const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		sum += wlsb_get_kp_16bits(ctxt->wlsb16, ctxt->values[i % BENCH_INPUTS_NR],
+		                          ROHC_LSB_SHIFT_RTP_SN);
+	}
+	return sum;
+}
+
+static uint64_t bench_wlsb_get_kps_32bits(struct bench_ctxt *const ctxt,
+                                          const size_t iters)
+{
+	const rohc_lsb_shift_t ps[] = {
+		ROHC_LSB_SHIFT_TCP_SEQ_SCALED, ROHC_LSB_SHIFT_TCP_SN, ROHC_LSB_SHIFT_SN
+	};
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		size_t bits_nr[3];
+		wlsb_get_kps_32bits(ctxt->wlsb32, ctxt->values[i % BENCH_INPUTS_NR],
+		                    ps, 3, bits_nr);
+		sum += bits_nr[0] + bits_nr[1] + bits_nr[2];
+	}
+	return sum;
+}
+
+static uint64_t bench_rohc_lsb_decode_16bits(struct bench_ctxt *const ctxt,
+                                             const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		const uint32_t value = ctxt->values[i % BENCH_INPUTS_NR];
+		uint32_t decoded = 0;
+		if(rohc_lsb_decode(ctxt->lsb16, ROHC_LSB_REF_0, 0, value & 0x3ff, 10,
+		                   ROHC_LSB_SHIFT_SN, &decoded))
+		{
+			sum += decoded;
+		}
+	}
+	return sum;
+}
+
+static uint64_t bench_rohc_lsb_decode_32bits(struct bench_ctxt *const ctxt,
+                                             const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		const uint32_t value = ctxt->values[i % BENCH_INPUTS_NR];
+		uint32_t decoded = 0;
+		if(rohc_lsb_decode(ctxt->lsb32, ROHC_LSB_REF_0, 0, value & 0x3ff, 10,
+		                   ROHC_LSB_SHIFT_RTP_TS, &decoded))
+		{
+			sum += decoded;
+		}
+	}
+	return sum;
+}
+
+static uint64_t bench_rohc_f_8bits(struct bench_ctxt *const ctxt,
+                                   const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		const uint32_t value = ctxt->randoms[i % BENCH_INPUTS_NR];
+		const struct rohc_interval8 interval =
+			rohc_f_8bits(value, 1 + (value >> 8) % 8, ROHC_LSB_SHIFT_SN);
+		sum += interval.min + interval.max;
+	}
+	return sum;
+}
+
+static uint64_t bench_rohc_f_16bits(struct bench_ctxt *const ctxt,
+                                    const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		const uint32_t value = ctxt->randoms[i % BENCH_INPUTS_NR];
+		const struct rohc_interval16 interval =
+			rohc_f_16bits(value, 1 + (value >> 16) % 16, ROHC_LSB_SHIFT_RTP_SN);
+		sum += interval.min + interval.max;
+	}
+	return sum;
+}
+
+static uint64_t bench_rohc_f_32bits(struct bench_ctxt *const ctxt,
+                                    const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		const uint32_t value = ctxt->randoms[i % BENCH_INPUTS_NR];
+		const struct rohc_interval32 interval =
+			rohc_f_32bits(value, 1 + (value >> 24) % 32, ROHC_LSB_SHIFT_RTP_TS);
+		sum += interval.min + interval.max;
+	}
+	return sum;
+}
+
+static uint64_t bench_sdvl_encode(struct bench_ctxt *const ctxt,
+                                  const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		const uint32_t value = ctxt->randoms[i % BENCH_INPUTS_NR];
+		uint8_t data[4];
+		size_t len;
+		if(sdvl_encode_full(data, 4, &len, value >> (value % 32)))
+		{
+			sum += len + data[0];
+		}
+	}
+	return sum;
+}
+
+static uint64_t bench_sdvl_decode(struct bench_ctxt *const ctxt,
+                                  const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		uint32_t value;
+		size_t bits_nr;
+		sum += sdvl_decode(ctxt->sdvl_data[i % BENCH_INPUTS_NR], 4, &value,
+		                   &bits_nr);
+		sum += value;
+	}
+	return sum;
+}
+
+static uint64_t bench_crc3(struct bench_ctxt *const ctxt, const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		sum += crc_calculate(ROHC_CRC_TYPE_3, ctxt->crc_data, BENCH_CRC_DATA_LEN,
+		                     i & 0x7, rohc_crc_table_3);
+	}
+	return sum;
+}
+
+static uint64_t bench_crc7(struct bench_ctxt *const ctxt, const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		sum += crc_calculate(ROHC_CRC_TYPE_7, ctxt->crc_data, BENCH_CRC_DATA_LEN,
+		                     i & 0x7f, rohc_crc_table_7);
+	}
+	return sum;
+}
+
+static uint64_t bench_crc8(struct bench_ctxt *const ctxt, const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		sum += crc_calculate(ROHC_CRC_TYPE_8, ctxt->crc_data, BENCH_CRC_DATA_LEN,
+		                     i & 0xff, rohc_crc_table_8);
+	}
+	return sum;
+}
+
+static uint64_t bench_fcs32(struct bench_ctxt *const ctxt, const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		sum += crc_calc_fcs32(ctxt->crc_data, BENCH_CRC_DATA_LEN, i);
+	}
+	return sum;
+}
+
+static uint64_t bench_c_add_ts(struct bench_ctxt *const ctxt, const size_t iters)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		size_t bits_nr_le_2;
+		size_t bits_nr_gt_2;
+
+		/* the same steps as the RTP compressor for every packet */
+		ctxt->ts += 160;
+		ctxt->sn++;
+		c_add_ts(&ctxt->ts_sc, ctxt->ts, ctxt->sn, arrival_time);
+		nb_bits_scaled(&ctxt->ts_sc, &bits_nr_le_2, &bits_nr_gt_2);
+		add_scaled(&ctxt->ts_sc, ctxt->sn);
+		add_unscaled(&ctxt->ts_sc, ctxt->sn);
+		sum += bits_nr_le_2 + bits_nr_gt_2;
+	}
+	return sum;
+}
+
+static uint64_t bench_list_encode(struct bench_ctxt *const ctxt,
+                                  const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		uint8_t list[BENCH_LIST_MAX_LEN];
+		const int len = bench_list_encode_next(ctxt, list);
+		sum += len + list[0];
+	}
+	return sum;
+}
+
+static uint64_t bench_list_decode(struct bench_ctxt *const ctxt,
+                                  const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		const size_t idx = i % BENCH_LIST_CYCLE_LEN;
+		sum += rohc_list_decode_maybe(&ctxt->list_decomp, ctxt->lists[idx],
+		                              ctxt->lists_len[idx]);
+	}
+	return sum;
+}
+
+static uint64_t bench_tcp_opt_ts(struct bench_ctxt *const ctxt,
+                                 const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		const uint32_t value = ctxt->randoms[i % BENCH_INPUTS_NR];
+		uint8_t data[4];
+		size_t len = 0;
+		if(c_tcp_ts_lsb_code(&ctxt->tcp_ctxt, value, value % 8, 18, 26,
+		                     data, 4, &len))
+		{
+			sum += len + data[0];
+		}
+	}
+	return sum;
+}
+
+static uint64_t bench_tcp_opt_sack(struct bench_ctxt *const ctxt,
+                                   const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		const size_t idx = i % BENCH_INPUTS_NR;
+		uint8_t data[C_TCP_SACK_MAX_LEN];
+		const int len =
+			c_tcp_opt_sack_code(&ctxt->tcp_ctxt, ctxt->randoms[idx],
+			                    ctxt->sack_blocks[idx], sizeof(sack_block_t) * 2,
+			                    false, &ctxt->sack_cache, data, C_TCP_SACK_MAX_LEN);
+		sum += len + data[0];
+	}
+	return sum;
+}
+
+static uint64_t bench_feedback2_build(struct bench_ctxt *const ctxt,
+                                      const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		const uint32_t sn = ctxt->randoms[i % BENCH_INPUTS_NR] & 0xffff;
+		struct d_feedback feedback;
+		uint8_t *packet;
+		size_t len;
+		if(f_feedback2(ROHC_PROFILE_TCP, ROHC_FEEDBACK_ACK, ROHC_O_MODE, sn,
+		               BENCH_FEEDBACK_SN_BITS_NR, &feedback))
+		{
+			packet = f_wrap_feedback(&feedback, BENCH_FEEDBACK_CID, ROHC_LARGE_CID,
+			                         ROHC_FEEDBACK_WITH_CRC_BASE, rohc_crc_table_8,
+			                         &len);
+			if(packet != NULL)
+			{
+				sum += len + packet[len - 1];
+			}
+		}
+	}
+	return sum;
+}
+
+static uint64_t bench_feedback2_tmpl(struct bench_ctxt *const ctxt,
+                                     const size_t iters)
+{
+	uint64_t sum = 0;
+	size_t i;
+	for(i = 0; i < iters; i++)
+	{
+		const uint32_t sn = ctxt->randoms[i % BENCH_INPUTS_NR] & 0xffff;
+		uint8_t *packet;
+		size_t len;
+		packet = f_feedback2_tmpl(&ctxt->feedback_tmpl, ROHC_PROFILE_TCP,
+		                          ROHC_FEEDBACK_ACK, ROHC_O_MODE, sn,
+		                          BENCH_FEEDBACK_SN_BITS_NR, BENCH_FEEDBACK_CID,
+		                          ROHC_LARGE_CID, ROHC_FEEDBACK_WITH_CRC_BASE,
+		                          rohc_crc_table_8, &len);
+		if(packet != NULL)
+		{
+			sum += len + packet[len - 1];
+		}
+	}
+	return sum;
+}
+
+
+/*
+ * Helpers
+ */
+
+/**
+ * @brief Get the current time of a monotonic clock
+ *
+ * @return  The current time in nanoseconds
+ */
+static uint64_t bench_get_ns(void)
+{
+	struct timespec now;
+
+	if(clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+	{
+		return 0;
+	}
+	return ((uint64_t) now.tv_sec) * 1000000000U + now.tv_nsec;
+}
+
+
+/**
+ * @brief Get the next value of the xorshift32 pseudo-random generator
+ *
+ * @param state  The state of the generator, never 0
+ * @return       The next pseudo-random value
+ */
+static uint32_t bench_rand(uint32_t *const state)
+{
+	*state ^= (*state) << 13;
+	*state ^= (*state) >> 17;
+	*state ^= (*state) << 5;
+	return *state;
+}
+
+
+/**
+ * @brief Compare two doubles for qsort()
+ *
+ * @param a  The first double
+ * @param b  The second double
+ * @return   <0, 0 or >0 whether a is less, equal or greater than b
+ */
+static int bench_cmp_double(const void *const a, const void *const b)
+{
+	const double da = *((const double *) a);
+	const double db = *((const double *) b);
+	return (da > db) - (da < db);
+}
+
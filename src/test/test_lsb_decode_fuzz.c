@@ -0,0 +1,263 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file    test_lsb_decode_fuzz.c
+ * @brief   Compare the branchless LSB decoding with the interval search
+ * @author  Didier Barvaux <didier@barvaux.org>
+ *
+ * The LSB decoding is run on random reference values, LSB values, numbers
+ * of bits and shift parameters. Every decoded value is compared with the one
+ * found by searching the interpretation interval given by the f function,
+ * as the LSB decoding did before it was made branchless.
+ */
+
+#include "schemes/decomp_wlsb.h"
+#include "interval.h"
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+/** The number of random values to decode for every field width */
+#define TEST_LSB_FUZZ_NR  2000000U
+
+
+/** Print trace on stdout only in verbose mode */
+#define trace(is_verbose, format, ...) \
+	do { \
+		if(is_verbose) { \
+			printf(format, ##__VA_ARGS__); \
+		} \
+	} while(0)
+
+
+static bool search_interval(const uint32_t v_ref,
+                            const uint32_t m,
+                            const size_t k,
+                            const rohc_lsb_shift_t p,
+                            uint32_t *const decoded)
+	__attribute__((warn_unused_result, nonnull(5)));
+
+static bool run_test(const size_t width, const bool be_verbose)
+	__attribute__((warn_unused_result));
+
+static uint32_t test_rand(void)
+	__attribute__((warn_unused_result));
+
+
+/** The state of the pseudo-random generator, fixed seed for reproducibility */
+static uint32_t test_rand_state = 0x2545f491U;
+
+
+/**
+ * @brief Check the branchless LSB decoding against the interval search
+ *
+ * @param argc  The number of arguments
+ * @param argv  The arguments
+ * @return      0 in case of success, 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	bool verbose; /* whether to run in verbose mode or not */
+	int is_failure = 1; /* test fails by default */
+
+	/* do we run in verbose mode ? */
+	if(argc == 1)
+	{
+		/* no argument, run in silent mode */
+		verbose = false;
+	}
+	else if(argc == 2 && strcmp(argv[1], "verbose") == 0)
+	{
+		/* run in verbose mode */
+		verbose = true;
+	}
+	else
+	{
+		/* invalid usage */
+		printf("compare the branchless LSB decoding with the interval search\n");
+		printf("usage: %s [verbose]\n", argv[0]);
+		goto error;
+	}
+
+	if(!run_test(8, verbose) ||
+	   !run_test(16, verbose) ||
+	   !run_test(32, verbose))
+	{
+		goto error;
+	}
+
+	/* test succeeds */
+	trace(verbose, "all tests are successful\n");
+	is_failure = 0;
+
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Decode random values of one field width in both ways
+ *
+ * @param width       The width of the field: 8, 16 or 32 bits
+ * @param be_verbose  Whether to print traces or not
+ * @return            true if all the decoded values are equal,
+ *                    false otherwise
+ */
+static bool run_test(const size_t width, const bool be_verbose)
+{
+	const rohc_lsb_shift_t p_params[] =
+	{
+		ROHC_LSB_SHIFT_SN,
+		ROHC_LSB_SHIFT_IP_ID,
+		ROHC_LSB_SHIFT_TCP_TTL,
+		ROHC_LSB_SHIFT_TCP_SN,
+		ROHC_LSB_SHIFT_TCP_SEQ_SCALED,
+		ROHC_LSB_SHIFT_RTP_TS,
+		ROHC_LSB_SHIFT_RTP_SN,
+		ROHC_LSB_SHIFT_ESP_SN,
+		ROHC_LSB_SHIFT_TCP_WINDOW,
+		ROHC_LSB_SHIFT_TCP_TS_3B,
+		ROHC_LSB_SHIFT_TCP_TS_4B,
+	};
+	const size_t p_nr = sizeof(p_params) / sizeof(rohc_lsb_shift_t);
+	const uint32_t width_mask =
+		(width == 32 ? 0xffffffffU : ((1U << width) - 1));
+	struct rohc_lsb_decode *lsb;
+	bool is_success = false;
+	size_t i;
+
+	trace(be_verbose, "decode %u random %zu-bit values\n",
+	      TEST_LSB_FUZZ_NR, width);
+
+	lsb = rohc_lsb_new(NULL, width);
+	if(lsb == NULL)
+	{
+		trace(be_verbose, "\tfailed to create the LSB decoding context\n");
+		goto error;
+	}
+
+	for(i = 0; i < TEST_LSB_FUZZ_NR; i++)
+	{
+		const uint32_t v_ref = test_rand() & width_mask;
+		const size_t k = test_rand() % (width + 1);
+		const uint32_t m =
+			test_rand() & (k == 32 ? 0xffffffffU : ((1U << k) - 1));
+		const rohc_lsb_shift_t p = p_params[test_rand() % p_nr];
+		const uint32_t v_ref_d_offset = test_rand() % 4;
+		uint32_t expected;
+		uint32_t decoded;
+
+		/* the interval search of the former implementation */
+		if(!search_interval((v_ref + v_ref_d_offset) & width_mask, m, k, p,
+		                    &expected))
+		{
+			trace(be_verbose, "\tno value found in the interval for v_ref = "
+			      "0x%08x, m = 0x%08x, k = %zu, p = %d\n", v_ref, m, k, p);
+			goto free_lsb;
+		}
+		expected &= width_mask;
+
+		/* the branchless decoding */
+		rohc_lsb_set_ref(lsb, v_ref, false);
+		if(!rohc_lsb_decode(lsb, ROHC_LSB_REF_0, v_ref_d_offset, m, k, p,
+		                    &decoded))
+		{
+			trace(be_verbose, "\tfailed to decode v_ref = 0x%08x, m = 0x%08x, "
+			      "k = %zu, p = %d\n", v_ref, m, k, p);
+			goto free_lsb;
+		}
+		if(decoded != expected)
+		{
+			trace(be_verbose, "\tv_ref = 0x%08x, m = 0x%08x, k = %zu, p = %d: "
+			      "decoded 0x%08x instead of 0x%08x\n", v_ref, m, k, p,
+			      decoded, expected);
+			goto free_lsb;
+		}
+	}
+
+	is_success = true;
+
+free_lsb:
+	rohc_lsb_free(lsb);
+error:
+	return is_success;
+}
+
+
+/**
+ * @brief Decode one LSB value by searching the interpretation interval
+ *
+ * @param v_ref     The reference value
+ * @param m         The LSB value to decode
+ * @param k         The length of the LSB value to decode
+ * @param p         The shift parameter
+ * @param decoded   OUT: The decoded value
+ * @return          true if a value was found in the interval,
+ *                  false otherwise
+ */
+static bool search_interval(const uint32_t v_ref,
+                            const uint32_t m,
+                            const size_t k,
+                            const rohc_lsb_shift_t p,
+                            uint32_t *const decoded)
+{
+	const uint32_t mask = (k == 32 ? 0xffffffffU : ((1U << k) - 1));
+	const struct rohc_interval32 interval = rohc_f_32bits(v_ref, k, p);
+	uint32_t try;
+
+	/* find the first value not lower than min with the same k LSB bits */
+	try = (interval.min & (~mask)) | m;
+	if((interval.min & mask) > m)
+	{
+		try += mask + 1;
+	}
+
+	/* the interval may straddle the field boundaries */
+	if(interval.min <= interval.max)
+	{
+		if(try < interval.min || try > interval.max)
+		{
+			return false;
+		}
+	}
+	else if(try < interval.min && try > interval.max)
+	{
+		return false;
+	}
+
+	*decoded = try;
+	return true;
+}
+
+
+/**
+ * @brief Get the next pseudo-random number (xorshift32)
+ *
+ * @return  The next pseudo-random number
+ */
+static uint32_t test_rand(void)
+{
+	test_rand_state ^= test_rand_state << 13;
+	test_rand_state ^= test_rand_state >> 17;
+	test_rand_state ^= test_rand_state << 5;
+	return test_rand_state;
+}
+
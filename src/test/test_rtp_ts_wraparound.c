@@ -49,7 +49,9 @@
 	} while(0)
 
 
-static bool run_test(bool be_verbose, const unsigned int incr);
+static bool run_test(bool be_verbose,
+                     const unsigned int incr,
+                     const bool is_timer);
 
 
 /**
@@ -85,7 +87,7 @@ int main(int argc, char *argv[])
 
 	/* run the test with irregular increment */
 	trace(verbose, "test TS wraparound with irregular increment\n");
-	if(!run_test(verbose, 0))
+	if(!run_test(verbose, 0, false))
 	{
 		fprintf(stderr, "failed to handle RTP TS wraparound with irregular "
 		        "increment\n");
@@ -94,7 +96,7 @@ int main(int argc, char *argv[])
 
 	/* run the test with power-of-two increment */
 	trace(verbose, "test TS wraparound with power-of-two increment\n");
-	if(!run_test(verbose, 256))
+	if(!run_test(verbose, 256, false))
 	{
 		fprintf(stderr, "failed to handle RTP TS wraparound with power-of-two "
 		        "increment\n");
@@ -103,13 +105,23 @@ int main(int argc, char *argv[])
 
 	/* run the test with non-power-of-two increment */
 	trace(verbose, "test TS wraparound with non-power-of-two increment\n");
-	if(!run_test(verbose, 257))
+	if(!run_test(verbose, 257, false))
 	{
 		fprintf(stderr, "failed to handle RTP TS wraparound with "
 		        "non-power-of-two increment\n");
 		goto error;
 	}
 
+	/* run the tests again with timer-based compression */
+	trace(verbose, "test TS wraparound with timer-based compression\n");
+	if(!run_test(verbose, 0, true) ||
+	   !run_test(verbose, 257, true))
+	{
+		fprintf(stderr, "failed to handle RTP TS wraparound with timer-based "
+		        "compression\n");
+		goto error;
+	}
+
 	/* test succeeds */
 	trace(verbose, "all tests are successful\n");
 	is_failure = 0;
@@ -124,9 +136,13 @@ error:
  *
  * @param be_verbose  Whether to print traces or not
  * @param incr        Increment between TS values
+ * @param is_timer    Whether to use timer-based compression, packets are
+ *                    then received every 20 ms
  * @return            true if test succeeds, false otherwise
  */
-bool run_test(bool be_verbose, const unsigned int incr)
+bool run_test(bool be_verbose,
+              const unsigned int incr,
+              const bool is_timer)
 {
 	struct ts_sc_comp ts_sc_comp;      /* the RTP TS encoding context */
 	struct ts_sc_decomp *ts_sc_decomp; /* the RTP TS decoding context */
@@ -143,7 +159,8 @@ bool run_test(bool be_verbose, const unsigned int incr)
 	uint64_t i;
 
 	/* create the RTP TS encoding context */
-	ret = c_create_sc(&ts_sc_comp, ROHC_WLSB_WINDOW_WIDTH, NULL, NULL);
+	ret = c_create_sc(&ts_sc_comp, NULL, ROHC_WLSB_WINDOW_WIDTH, is_timer, 0,
+	                  NULL, NULL);
 	if(ret != 1)
 	{
 		fprintf(stderr, "failed to initialize the RTP TS encoding context\n");
@@ -151,7 +168,7 @@ bool run_test(bool be_verbose, const unsigned int incr)
 	}
 
 	/* create the RTP TS decoding context */
-	ts_sc_decomp = d_create_sc(NULL, NULL);
+	ts_sc_decomp = d_create_sc(NULL, NULL, NULL);
 	if(ts_sc_decomp == NULL)
 	{
 		fprintf(stderr, "failed to initialize the RTP TS decoding context\n");
@@ -177,6 +194,7 @@ bool run_test(bool be_verbose, const unsigned int incr)
 		size_t required_bits_more_than_2;
 		uint32_t required_bits_mask;
 		uint32_t ts_stride;
+		struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
 
 		/* value to encode/decode */
 		if(incr == 0)
@@ -202,8 +220,15 @@ bool run_test(bool be_verbose, const unsigned int incr)
 		trace(be_verbose, "\t#%" PRIu64 ": encode value 0x%08x (+%u) ...\n",
 		      i, value, real_incr);
 
+		/* packets are received every 20 ms with timer-based compression */
+		if(is_timer)
+		{
+			arrival_time.sec = 1 + (i * 20) / 1000;
+			arrival_time.nsec = ((i * 20) % 1000) * 1000000;
+		}
+
 		/* update encoding context */
-		c_add_ts(&ts_sc_comp, value, i);
+		c_add_ts(&ts_sc_comp, value, i, arrival_time);
 
 		/* transmit the required bits wrt to encoding state */
 		switch(ts_sc_comp.state)
@@ -251,6 +276,10 @@ bool run_test(bool be_verbose, const unsigned int incr)
 					goto destroy_ts_sc_decomp;
 				}
 				d_record_ts_stride(ts_sc_decomp, ts_stride);
+				if(is_timer)
+				{
+					d_record_time_stride(ts_sc_decomp, get_time_stride(&ts_sc_comp));
+				}
 				break;
 
 			case SEND_SCALED:
@@ -293,7 +322,8 @@ bool run_test(bool be_verbose, const unsigned int incr)
 
 					/* decode the received TS_SCALED value */
 					if(!ts_decode_scaled_bits(ts_sc_decomp, value_encoded,
-					                          required_bits, &value_decoded))
+					                          required_bits, arrival_time,
+					                          &value_decoded))
 					{
 						trace(be_verbose, "failed to decode received TS_SCALED\n");
 						goto destroy_ts_sc_decomp;
@@ -324,7 +354,7 @@ bool run_test(bool be_verbose, const unsigned int incr)
 		}
 
 		/* update decoding context */
-		ts_update_context(ts_sc_decomp, value_decoded, i);
+		ts_update_context(ts_sc_decomp, value_decoded, i, arrival_time);
 	}
 
 	/* test succeeds */
@@ -200,7 +200,7 @@ bool run_test8_with_shift_param(bool be_verbose, const short p)
 	uint32_t i;
 
 	/* create the W-LSB encoding context */
-	wlsb = c_create_wlsb(8, ROHC_WLSB_WINDOW_WIDTH, p);
+	wlsb = c_create_wlsb(NULL, 8, ROHC_WLSB_WINDOW_WIDTH, p);
 	if(wlsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -210,7 +210,7 @@ bool run_test8_with_shift_param(bool be_verbose, const short p)
 	/* init the LSB decoding context with value 0 */
 	value8 = 0;
 	trace(be_verbose, "\tinitialize with 8 bits of value 0x%02x ...\n", value8);
-	lsb = rohc_lsb_new(8);
+	lsb = rohc_lsb_new(NULL, 8);
 	if(lsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate LSB decoding context\n");
@@ -269,7 +269,7 @@ bool run_test16_with_shift_param(bool be_verbose, const short p)
 	uint32_t i;
 
 	/* create the W-LSB encoding context */
-	wlsb = c_create_wlsb(16, ROHC_WLSB_WINDOW_WIDTH, p);
+	wlsb = c_create_wlsb(NULL, 16, ROHC_WLSB_WINDOW_WIDTH, p);
 	if(wlsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -279,7 +279,7 @@ bool run_test16_with_shift_param(bool be_verbose, const short p)
 	/* init the LSB decoding context with value 0 */
 	value16 = 0;
 	trace(be_verbose, "\tinitialize with 16 bits of value 0x%04x ...\n", value16);
-	lsb = rohc_lsb_new(16);
+	lsb = rohc_lsb_new(NULL, 16);
 	if(lsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate LSB decoding context\n");
@@ -339,7 +339,7 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	uint64_t i;
 
 	/* create the W-LSB encoding context */
-	wlsb = c_create_wlsb(32, ROHC_WLSB_WINDOW_WIDTH, p);
+	wlsb = c_create_wlsb(NULL, 32, ROHC_WLSB_WINDOW_WIDTH, p);
 	if(wlsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding context\n");
@@ -349,7 +349,7 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	/* init the LSB decoding context with value 0 */
 	value32 = 0;
 	trace(be_verbose, "\tinitialize with 32 bits of value 0x%08x ...\n", value32);
-	lsb = rohc_lsb_new(32);
+	lsb = rohc_lsb_new(NULL, 32);
 	if(lsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate LSB decoding context\n");
@@ -383,7 +383,7 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	c_destroy_wlsb(wlsb);
 
 	/* create the W-LSB encoding context again */
-	wlsb = c_create_wlsb(32, ROHC_WLSB_WINDOW_WIDTH, p);
+	wlsb = c_create_wlsb(NULL, 32, ROHC_WLSB_WINDOW_WIDTH, p);
 	if(wlsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding\n");
@@ -393,7 +393,7 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	/* init the LSB decoding context with value 0xffffffff - 100 - 3 */
 	value32 = 0xffffffff - 100 - 3;
 	trace(be_verbose, "\tinitialize with 32 bits of value 0x%08x ...\n", value32);
-	lsb = rohc_lsb_new(32);
+	lsb = rohc_lsb_new(NULL, 32);
 	if(lsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate LSB decoding context\n");
@@ -428,7 +428,7 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	c_destroy_wlsb(wlsb);
 
 	/* create the W-LSB encoding context again */
-	wlsb = c_create_wlsb(32, 64U, p);
+	wlsb = c_create_wlsb(NULL, 32, 64U, p);
 	if(wlsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate W-LSB encoding\n");
@@ -439,7 +439,7 @@ bool run_test32_with_shift_param(bool be_verbose, const short p)
 	value32 = 0xffffffff - 4500 - 1700;
 	trace(be_verbose, "\tinitialize with 32 bits of value 0x%08x ...\n",
 	      value32);
-	lsb = rohc_lsb_new(32);
+	lsb = rohc_lsb_new(NULL, 32);
 	if(lsb == NULL)
 	{
 		fprintf(stderr, "no memory to allocate LSB decoding context\n");
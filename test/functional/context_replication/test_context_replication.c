@@ -0,0 +1,445 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_context_replication.c
+ * @brief  Check that the new TCP contexts replicate the existing ones
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses the packets of one first TCP connection, then
+ * the packets of a second TCP connection between the same hosts. The first
+ * packets of the second connection shall be IR-CR packets that are smaller
+ * than the IR packets of the first connection. The decompressor shall
+ * decompress all the packets. The test is run with small and large CIDs.
+ */
+
+#include "test.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdarg.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The max size of the packets */
+#define TEST_MAX_PKT_SIZE  1500U
+
+/** The number of packets compressed for every TCP connection */
+#define TEST_PKTS_NR  10U
+
+/** The length of the payload of the generated packets */
+#define TEST_PAYLOAD_LEN  20U
+
+
+/* prototypes of private functions */
+static void usage(void);
+static int test_context_replication(const rohc_cid_type_t cid_type,
+                                    const rohc_cid_t max_cid);
+static bool compress_flow(struct rohc_comp *const comp,
+                          struct rohc_decomp *const decomp,
+                          const size_t flow,
+                          size_t *const ir_len);
+static size_t build_packet(const size_t flow,
+                           const size_t pkt_num,
+                           uint8_t *const buf)
+	__attribute__((nonnull(3)));
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Check that the new TCP contexts replicate the existing ones
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	int status = 1;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc != 1)
+	{
+		usage();
+		goto error;
+	}
+
+	status = test_context_replication(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX);
+	if(status != 0)
+	{
+		goto error;
+	}
+	status = test_context_replication(ROHC_LARGE_CID, ROHC_LARGE_CID_MAX);
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "Check that the new TCP contexts replicate the existing ones\n"
+	        "\n"
+	        "usage: test_context_replication [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  -h           Print this usage and exit\n");
+}
+
+
+/**
+ * @brief Compress two TCP connections between the same hosts
+ *
+ * @param cid_type  The type of CIDs used by the compressor/decompressor
+ * @param max_cid   The maximum CID used by the compressor/decompressor
+ * @return          0 in case of success, 1 in case of failure
+ */
+static int test_context_replication(const rohc_cid_type_t cid_type,
+                                    const rohc_cid_t max_cid)
+{
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	size_t ir_len;
+	size_t ir_cr_len;
+	int is_failure = 1;
+
+	fprintf(stderr, "test with %s CIDs\n",
+	        cid_type == ROHC_SMALL_CID ? "small" : "large");
+
+	/* initialize the random generator with the same number to ease debugging */
+	srand(4 /* chosen by fair dice roll, guaranteed to be random */);
+
+	/* create the ROHC compressor with context replication enabled */
+	comp = rohc_comp_new2(cid_type, max_cid, gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "compressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_features(comp, ROHC_COMP_FEATURE_CONTEXT_REPLICATION))
+	{
+		fprintf(stderr, "failed to enable the context replication\n");
+		goto destroy_comp;
+	}
+
+	/* create the ROHC decompressor in uni-directional mode */
+	decomp = rohc_decomp_new2(cid_type, max_cid, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "decompressor\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	/* the first connection cannot replicate any context */
+	if(!compress_flow(comp, decomp, 0, &ir_len))
+	{
+		goto destroy_decomp;
+	}
+
+	/* the second connection replicates the first one */
+	if(!compress_flow(comp, decomp, 1, &ir_cr_len))
+	{
+		goto destroy_decomp;
+	}
+	if(ir_cr_len >= ir_len)
+	{
+		fprintf(stderr, "%zu-byte IR-CR packet is not smaller than %zu-byte IR "
+		        "packet\n", ir_cr_len, ir_len);
+		goto destroy_decomp;
+	}
+
+	/* everything went fine */
+	fprintf(stderr, "all packets decompressed, %zu-byte IR-CR packet instead "
+	        "of %zu-byte IR packet\n", ir_cr_len, ir_len);
+	is_failure = 0;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Compress and decompress TEST_PKTS_NR packets of one TCP connection
+ *
+ * The first connection shall start with IR packets, the next ones with IR-CR
+ * packets.
+ *
+ * @param comp         The ROHC compressor
+ * @param decomp       The ROHC decompressor
+ * @param flow         The number of the TCP connection
+ * @param[out] ir_len  The length of the first ROHC packet of the connection
+ * @return             true if all packets were successfully compressed and
+ *                     decompressed, false otherwise
+ */
+static bool compress_flow(struct rohc_comp *const comp,
+                          struct rohc_decomp *const decomp,
+                          const size_t flow,
+                          size_t *const ir_len)
+{
+	const rohc_packet_t expected_ir_type =
+		(flow == 0 ? ROHC_PACKET_IR : ROHC_PACKET_IR_CR);
+	size_t pkt_num;
+
+	for(pkt_num = 0; pkt_num < TEST_PKTS_NR; pkt_num++)
+	{
+		uint8_t ip_buffer[TEST_MAX_PKT_SIZE];
+		struct rohc_buf ip_packet =
+			rohc_buf_init_empty(ip_buffer, TEST_MAX_PKT_SIZE);
+		uint8_t rohc_buffer[TEST_MAX_PKT_SIZE];
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, TEST_MAX_PKT_SIZE);
+		uint8_t uncomp_buffer[TEST_MAX_PKT_SIZE];
+		struct rohc_buf uncomp_packet =
+			rohc_buf_init_empty(uncomp_buffer, TEST_MAX_PKT_SIZE);
+		rohc_comp_last_packet_info2_t info;
+
+		ip_packet.len = build_packet(flow, pkt_num, ip_buffer);
+
+		if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "flow #%zu: failed to compress packet #%zu\n",
+			        flow, pkt_num + 1);
+			goto error;
+		}
+		memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+		info.version_major = 0;
+		info.version_minor = 0;
+		if(!rohc_comp_get_last_packet_info2(comp, &info))
+		{
+			fprintf(stderr, "flow #%zu: failed to get information on packet "
+			        "#%zu\n", flow, pkt_num + 1);
+			goto error;
+		}
+		fprintf(stderr, "flow #%zu: packet #%zu compressed as %zu-byte %s "
+		        "packet\n", flow, pkt_num + 1, rohc_packet.len,
+		        rohc_get_packet_descr(info.packet_type));
+		if(pkt_num == 0)
+		{
+			if(info.packet_type != expected_ir_type)
+			{
+				fprintf(stderr, "flow #%zu: %s packet expected, %s packet sent\n",
+				        flow, rohc_get_packet_descr(expected_ir_type),
+				        rohc_get_packet_descr(info.packet_type));
+				goto error;
+			}
+			*ir_len = rohc_packet.len;
+		}
+
+		if(rohc_decompress3(decomp, rohc_packet, &uncomp_packet,
+		                    NULL, NULL) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "flow #%zu: failed to decompress packet #%zu\n",
+			        flow, pkt_num + 1);
+			goto error;
+		}
+		if(uncomp_packet.len != ip_packet.len ||
+		   memcmp(rohc_buf_data(uncomp_packet), rohc_buf_data(ip_packet),
+		          ip_packet.len) != 0)
+		{
+			fprintf(stderr, "flow #%zu: decompressed packet #%zu does not "
+			        "match the original packet\n", flow, pkt_num + 1);
+			goto error;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Build one IPv4/TCP packet of the given TCP connection
+ *
+ * All the connections are established between the same hosts, only the
+ * source port and the TCP sequence numbers differ.
+ *
+ * @param flow     The number of the TCP connection
+ * @param pkt_num  The number of the packet in the connection
+ * @param[out] buf The buffer for the packet
+ * @return         The length of the packet
+ */
+static size_t build_packet(const size_t flow,
+                           const size_t pkt_num,
+                           uint8_t *const buf)
+{
+	const size_t ip_hdr_len = 20;
+	const size_t tcp_hdr_len = 20;
+	const size_t len = ip_hdr_len + tcp_hdr_len + TEST_PAYLOAD_LEN;
+	const uint16_t sport = 12345 + flow;
+	const uint32_t seq = 0x10000000 * (flow + 1) + pkt_num * TEST_PAYLOAD_LEN;
+	uint32_t sum = 0;
+	size_t i;
+
+	/* TCP header */
+	buf[ip_hdr_len + 0] = (sport >> 8) & 0xff; /* source port */
+	buf[ip_hdr_len + 1] = sport & 0xff;
+	buf[ip_hdr_len + 2] = 0x00; /* destination port 80 */
+	buf[ip_hdr_len + 3] = 0x50;
+	buf[ip_hdr_len + 4] = (seq >> 24) & 0xff; /* sequence number */
+	buf[ip_hdr_len + 5] = (seq >> 16) & 0xff;
+	buf[ip_hdr_len + 6] = (seq >> 8) & 0xff;
+	buf[ip_hdr_len + 7] = seq & 0xff;
+	buf[ip_hdr_len + 8] = 0x20; /* ACK number */
+	buf[ip_hdr_len + 9] = 0x00;
+	buf[ip_hdr_len + 10] = 0x00;
+	buf[ip_hdr_len + 11] = 0x01;
+	buf[ip_hdr_len + 12] = 0x50; /* data offset */
+	buf[ip_hdr_len + 13] = 0x18; /* flags PSH and ACK */
+	buf[ip_hdr_len + 14] = 0x72; /* window */
+	buf[ip_hdr_len + 15] = 0x10;
+	buf[ip_hdr_len + 16] = 0x12; /* checksum, not checked */
+	buf[ip_hdr_len + 17] = (0x34 + pkt_num) & 0xff;
+	buf[ip_hdr_len + 18] = 0x00; /* urgent pointer */
+	buf[ip_hdr_len + 19] = 0x00;
+
+	/* payload */
+	for(i = ip_hdr_len + tcp_hdr_len; i < len; i++)
+	{
+		buf[i] = (pkt_num + i) & 0xff;
+	}
+
+	/* IPv4 header with an IP-ID that increases by one for every packet */
+	buf[0] = 0x45;
+	buf[1] = 0x00;
+	buf[2] = (len >> 8) & 0xff;
+	buf[3] = len & 0xff;
+	buf[4] = (flow << 4) & 0xff;
+	buf[5] = pkt_num & 0xff;
+	buf[6] = 0x40; /* DF */
+	buf[7] = 0x00;
+	buf[8] = 64; /* TTL */
+	buf[9] = 6; /* TCP */
+	buf[10] = 0x00; /* checksum computed below */
+	buf[11] = 0x00;
+	buf[12] = 192; /* source address 192.168.0.1 */
+	buf[13] = 168;
+	buf[14] = 0;
+	buf[15] = 1;
+	buf[16] = 192; /* destination address 192.168.0.2 */
+	buf[17] = 168;
+	buf[18] = 0;
+	buf[19] = 2;
+	for(i = 0; i < ip_hdr_len; i += 2)
+	{
+		sum += (buf[i] << 8) | buf[i + 1];
+	}
+	while((sum >> 16) != 0)
+	{
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+	buf[10] = (~sum >> 8) & 0xff;
+	buf[11] = ~sum & 0xff;
+
+	return len;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return rand();
+}
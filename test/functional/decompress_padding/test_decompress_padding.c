@@ -99,6 +99,16 @@ int main(int argc, char *argv[])
 		rohc_buf_init_full(rohc_feedback_padded2, rohc_feedback_padded2_len,
 		                   arrival_time);
 
+	/* a ROHC packet with 2 feedback items and 11-byte padding prepended */
+	uint8_t rohc_feedback_padded11[] = {
+		0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0,
+		0xe0, 0xe0, 0xe0, 0xf4, 0x20, 0x00, 0x11, 0xe9,
+		0xf4, 0x20, 0x00, 0x12, 0xe8 };
+	const size_t rohc_feedback_padded11_len = 11 + 5 + 5;
+	const struct rohc_buf rohc_feedback_padded11_pkt =
+		rohc_buf_init_full(rohc_feedback_padded11, rohc_feedback_padded11_len,
+		                   arrival_time);
+
 	/* a ROHC IR packet with 1-byte padding prepended and feedback data */
 	uint8_t rohc_ir_feedback_padded1[] = {
 		0xe0, 0xf4, 0x20, 0x00, 0x11, 0xe9,
@@ -126,6 +136,15 @@ int main(int argc, char *argv[])
 		rohc_buf_init_full(rohc_padding_only, rohc_padding_only_len,
 		                   arrival_time);
 
+	/* a ROHC padding-only packet longer than 8 bytes */
+	uint8_t rohc_padding_only13[] = {
+		0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0, 0xe0,
+		0xe0, 0xe0, 0xe0, 0xe0, 0xe0 };
+	const size_t rohc_padding_only13_len = 13;
+	const struct rohc_buf rohc_padding_only13_pkt =
+		rohc_buf_init_full(rohc_padding_only13, rohc_padding_only13_len,
+		                   arrival_time);
+
 	int status = 1;
 
 	/* parse program arguments, print the help message in case of failure */
@@ -146,6 +165,9 @@ int main(int argc, char *argv[])
 	fprintf(stderr, "decompress rohc_feedback_padded2\n");
 	status = test_decomp(rohc_feedback_padded2_pkt);
 	assert(status == 0);
+	fprintf(stderr, "decompress rohc_feedback_padded11\n");
+	status = test_decomp(rohc_feedback_padded11_pkt);
+	assert(status == 0);
 	fprintf(stderr, "decompress rohc_ir_feedback_padded1\n");
 	status = test_decomp(rohc_ir_feedback_padded1_pkt);
 	assert(status == 0);
@@ -156,6 +178,9 @@ int main(int argc, char *argv[])
 	fprintf(stderr, "decompress rohc_padding_only\n");
 	status = test_decomp(rohc_padding_only_pkt);
 	assert(status != 0);
+	fprintf(stderr, "decompress rohc_padding_only13\n");
+	status = test_decomp(rohc_padding_only13_pkt);
+	assert(status != 0);
 
 	/* everything went fine */
 	status = 0;
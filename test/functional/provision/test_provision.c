@@ -0,0 +1,564 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_provision.c
+ * @brief  Check that the contexts are provisioned out of band
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application provisions the compression context of a few flows from
+ * their first packets, then provisions the decompression contexts from the
+ * descriptions built by the compressor. The next packets of the flows are
+ * then compressed and decompressed: the decompressor shall decompress all
+ * of them, and the compressor shall never send IR packets.
+ */
+
+#include "test.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdarg.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The max size of the packets */
+#define TEST_MAX_PKT_SIZE  1500U
+
+/** The number of packets the contexts are provisioned from */
+#define TEST_PROVISION_PKTS_NR  3U
+
+/** The number of packets compressed after the provisioning */
+#define TEST_PKTS_NR  10U
+
+/** The length of the payload of the generated packets */
+#define TEST_PAYLOAD_LEN  20U
+
+
+/** The flows compressed by the test */
+enum test_flow
+{
+	TEST_FLOW_IP,   /**< IPv4 with an unassigned protocol (IP-only profile) */
+	TEST_FLOW_UDP,  /**< IPv4/UDP (UDP profile) */
+	TEST_FLOW_TCP,  /**< IPv4/TCP (TCP profile) */
+	TEST_FLOWS_NR,  /**< The number of flows */
+};
+
+/** The profiles of the flows */
+static const rohc_profile_t test_flow_profiles[TEST_FLOWS_NR] =
+{
+	[TEST_FLOW_IP] = ROHC_PROFILE_IP,
+	[TEST_FLOW_UDP] = ROHC_PROFILE_UDP,
+	[TEST_FLOW_TCP] = ROHC_PROFILE_TCP,
+};
+
+
+/* prototypes of private functions */
+static void usage(void);
+static int test_provision(void);
+static bool provision_flows(struct rohc_comp *const comp,
+                            struct rohc_decomp *const decomp);
+static bool compress_flows(struct rohc_comp *const comp,
+                           struct rohc_decomp *const decomp);
+static size_t build_packet(const enum test_flow flow,
+                           const size_t pkt_num,
+                           uint8_t *const buf)
+	__attribute__((nonnull(3)));
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Check that the contexts are provisioned out of band
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	int status = 1;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc != 1)
+	{
+		usage();
+		goto error;
+	}
+
+	status = test_provision();
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "Check that the contexts are provisioned out of band\n"
+	        "\n"
+	        "usage: test_provision [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  -h           Print this usage and exit\n");
+}
+
+
+/**
+ * @brief Provision the contexts of the flows, then compress the flows
+ *
+ * @return  0 in case of success, 1 in case of failure
+ */
+static int test_provision(void)
+{
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	int is_failure = 1;
+
+	/* initialize the random generator with the same number to ease debugging */
+	srand(4 /* chosen by fair dice roll, guaranteed to be random */);
+
+	/* create the ROHC compressor */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX,
+	                      gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "compressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                              ROHC_PROFILE_UDPLITE, ROHC_PROFILE_RTP,
+	                              ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+
+	/* create the ROHC decompressor in uni-directional mode */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "decompressor\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                                ROHC_PROFILE_UDPLITE, ROHC_PROFILE_RTP,
+	                                ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	/* provision the contexts on both sides, then compress the flows: no IR
+	 * packet is expected */
+	if(!provision_flows(comp, decomp))
+	{
+		goto destroy_decomp;
+	}
+	if(!compress_flows(comp, decomp))
+	{
+		goto destroy_decomp;
+	}
+
+	/* everything went fine */
+	fprintf(stderr, "all packets decompressed after the provisioning, no IR "
+	        "packet sent\n");
+	is_failure = 0;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Provision the contexts of every flow in the compressor and in the
+ *        decompressor from the first packets of the flow
+ *
+ * The context of every flow uses the CID that follows the number of the flow.
+ *
+ * @param comp    The ROHC compressor
+ * @param decomp  The ROHC decompressor
+ * @return        true if all contexts were provisioned, false otherwise
+ */
+static bool provision_flows(struct rohc_comp *const comp,
+                            struct rohc_decomp *const decomp)
+{
+	enum test_flow flow;
+
+	for(flow = 0; flow < TEST_FLOWS_NR; flow++)
+	{
+		const rohc_cid_t cid = flow + 1;
+		uint8_t ip_buffers[TEST_PROVISION_PKTS_NR][TEST_MAX_PKT_SIZE];
+		struct rohc_buf ip_packets[TEST_PROVISION_PKTS_NR];
+		uint8_t descr_buffer[TEST_MAX_PKT_SIZE];
+		struct rohc_buf descr =
+			rohc_buf_init_empty(descr_buffer, TEST_MAX_PKT_SIZE);
+		uint8_t descr2_buffer[TEST_MAX_PKT_SIZE];
+		struct rohc_buf descr2 =
+			rohc_buf_init_empty(descr2_buffer, TEST_MAX_PKT_SIZE);
+
+		size_t i;
+
+		for(i = 0; i < TEST_PROVISION_PKTS_NR; i++)
+		{
+			ip_packets[i].time.sec = 0;
+			ip_packets[i].time.nsec = 0;
+			ip_packets[i].data = ip_buffers[i];
+			ip_packets[i].max_len = TEST_MAX_PKT_SIZE;
+			ip_packets[i].offset = 0;
+			ip_packets[i].len = build_packet(flow, i, ip_buffers[i]);
+		}
+
+		/* the packet shall match the profile */
+		if(rohc_comp_provision_context(comp, cid, (flow == TEST_FLOW_UDP ?
+		                               ROHC_PROFILE_TCP : ROHC_PROFILE_UDP),
+		                               ip_packets, TEST_PROVISION_PKTS_NR,
+		                               &descr))
+		{
+			fprintf(stderr, "flow #%d: provisioning with the wrong profile "
+			        "unexpectedly succeeded\n", flow);
+			goto error;
+		}
+
+		if(!rohc_comp_provision_context(comp, cid, test_flow_profiles[flow],
+		                                ip_packets, TEST_PROVISION_PKTS_NR,
+		                                &descr))
+		{
+			fprintf(stderr, "flow #%d: failed to provision the compression "
+			        "context\n", flow);
+			goto error;
+		}
+		fprintf(stderr, "flow #%d: context with CID %zu described in %zu "
+		        "bytes\n", flow, cid, descr.len);
+
+		/* the CID shall be unused */
+		if(rohc_comp_provision_context(comp, cid, test_flow_profiles[flow],
+		                               ip_packets, TEST_PROVISION_PKTS_NR,
+		                               &descr2))
+		{
+			fprintf(stderr, "flow #%d: provisioning a used CID unexpectedly "
+			        "succeeded\n", flow);
+			goto error;
+		}
+
+		/* the description shall be one valid IR header */
+		descr_buffer[descr.len - 1] ^= 0xff;
+		if(rohc_decomp_provision_context(decomp, descr))
+		{
+			fprintf(stderr, "flow #%d: provisioning from a corrupted "
+			        "description unexpectedly succeeded\n", flow);
+			goto error;
+		}
+		descr_buffer[descr.len - 1] ^= 0xff;
+		descr.len--;
+		if(rohc_decomp_provision_context(decomp, descr))
+		{
+			fprintf(stderr, "flow #%d: provisioning from a truncated "
+			        "description unexpectedly succeeded\n", flow);
+			goto error;
+		}
+		descr.len++;
+
+		if(!rohc_decomp_provision_context(decomp, descr))
+		{
+			fprintf(stderr, "flow #%d: failed to provision the decompression "
+			        "context\n", flow);
+			goto error;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Compress and decompress TEST_PKTS_NR packets of every flow
+ *
+ * @param comp    The ROHC compressor
+ * @param decomp  The ROHC decompressor
+ * @return        true if all packets were successfully compressed and
+ *                decompressed without IR packets, false otherwise
+ */
+static bool compress_flows(struct rohc_comp *const comp,
+                           struct rohc_decomp *const decomp)
+{
+	size_t pkt_num;
+
+	for(pkt_num = TEST_PROVISION_PKTS_NR;
+	    pkt_num < (TEST_PROVISION_PKTS_NR + TEST_PKTS_NR); pkt_num++)
+	{
+		enum test_flow flow;
+
+		for(flow = 0; flow < TEST_FLOWS_NR; flow++)
+		{
+			uint8_t ip_buffer[TEST_MAX_PKT_SIZE];
+			struct rohc_buf ip_packet =
+				rohc_buf_init_empty(ip_buffer, TEST_MAX_PKT_SIZE);
+			uint8_t rohc_buffer[TEST_MAX_PKT_SIZE];
+			struct rohc_buf rohc_packet =
+				rohc_buf_init_empty(rohc_buffer, TEST_MAX_PKT_SIZE);
+			uint8_t uncomp_buffer[TEST_MAX_PKT_SIZE];
+			struct rohc_buf uncomp_packet =
+				rohc_buf_init_empty(uncomp_buffer, TEST_MAX_PKT_SIZE);
+			rohc_comp_last_packet_info2_t info;
+
+			ip_packet.len = build_packet(flow, pkt_num, ip_buffer);
+
+			if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "flow #%d: failed to compress packet #%zu\n",
+				        flow, pkt_num + 1);
+				goto error;
+			}
+			memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+			info.version_major = 0;
+			info.version_minor = 0;
+			if(!rohc_comp_get_last_packet_info2(comp, &info))
+			{
+				fprintf(stderr, "flow #%d: failed to get information on packet "
+				        "#%zu\n", flow, pkt_num + 1);
+				goto error;
+			}
+			fprintf(stderr, "flow #%d: packet #%zu compressed as %zu-byte %s "
+			        "packet\n", flow, pkt_num + 1, rohc_packet.len,
+			        rohc_get_packet_descr(info.packet_type));
+			if(info.packet_type == ROHC_PACKET_IR ||
+			   info.packet_type == ROHC_PACKET_IR_DYN)
+			{
+				fprintf(stderr, "flow #%d: unexpected %s packet after the "
+				        "provisioning\n", flow,
+				        rohc_get_packet_descr(info.packet_type));
+				goto error;
+			}
+
+			if(rohc_decompress3(decomp, rohc_packet, &uncomp_packet,
+			                    NULL, NULL) != ROHC_STATUS_OK)
+			{
+				fprintf(stderr, "flow #%d: failed to decompress packet #%zu\n",
+				        flow, pkt_num + 1);
+				goto error;
+			}
+			if(uncomp_packet.len != ip_packet.len ||
+			   memcmp(rohc_buf_data(uncomp_packet), rohc_buf_data(ip_packet),
+			          ip_packet.len) != 0)
+			{
+				fprintf(stderr, "flow #%d: decompressed packet #%zu does not "
+				        "match the original packet\n", flow, pkt_num + 1);
+				goto error;
+			}
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Build one packet of the given flow
+ *
+ * @param flow     The flow of the packet
+ * @param pkt_num  The number of the packet in the flow
+ * @param[out] buf The buffer for the packet
+ * @return         The length of the packet
+ */
+static size_t build_packet(const enum test_flow flow,
+                           const size_t pkt_num,
+                           uint8_t *const buf)
+{
+	const size_t ip_hdr_len = 20;
+	size_t l4_hdr_len;
+	size_t len;
+	uint32_t sum = 0;
+	size_t i;
+
+	/* transport header */
+	switch(flow)
+	{
+		case TEST_FLOW_UDP:
+			l4_hdr_len = 8;
+			buf[ip_hdr_len + 0] = 0x30; /* source port 12345 */
+			buf[ip_hdr_len + 1] = 0x39;
+			buf[ip_hdr_len + 2] = 0xd4; /* destination port 54321 */
+			buf[ip_hdr_len + 3] = 0x31;
+			buf[ip_hdr_len + 4] = 0x00; /* length */
+			buf[ip_hdr_len + 5] = l4_hdr_len + TEST_PAYLOAD_LEN;
+			buf[ip_hdr_len + 6] = 0x00; /* no checksum */
+			buf[ip_hdr_len + 7] = 0x00;
+			break;
+		case TEST_FLOW_TCP:
+		{
+			const uint32_t seq = 0x10000000 + pkt_num * TEST_PAYLOAD_LEN;
+			l4_hdr_len = 20;
+			buf[ip_hdr_len + 0] = 0x30; /* source port 12345 */
+			buf[ip_hdr_len + 1] = 0x39;
+			buf[ip_hdr_len + 2] = 0x00; /* destination port 80 */
+			buf[ip_hdr_len + 3] = 0x50;
+			buf[ip_hdr_len + 4] = (seq >> 24) & 0xff; /* sequence number */
+			buf[ip_hdr_len + 5] = (seq >> 16) & 0xff;
+			buf[ip_hdr_len + 6] = (seq >> 8) & 0xff;
+			buf[ip_hdr_len + 7] = seq & 0xff;
+			buf[ip_hdr_len + 8] = 0x20; /* ACK number */
+			buf[ip_hdr_len + 9] = 0x00;
+			buf[ip_hdr_len + 10] = 0x00;
+			buf[ip_hdr_len + 11] = 0x01;
+			buf[ip_hdr_len + 12] = 0x50; /* data offset */
+			buf[ip_hdr_len + 13] = 0x18; /* flags PSH and ACK */
+			buf[ip_hdr_len + 14] = 0x72; /* window */
+			buf[ip_hdr_len + 15] = 0x10;
+			buf[ip_hdr_len + 16] = 0x12; /* checksum, not checked */
+			buf[ip_hdr_len + 17] = (0x34 + pkt_num) & 0xff;
+			buf[ip_hdr_len + 18] = 0x00; /* urgent pointer */
+			buf[ip_hdr_len + 19] = 0x00;
+			break;
+		}
+		case TEST_FLOW_IP:
+		default:
+			l4_hdr_len = 0;
+			break;
+	}
+	len = ip_hdr_len + l4_hdr_len + TEST_PAYLOAD_LEN;
+
+	/* payload */
+	for(i = ip_hdr_len + l4_hdr_len; i < len; i++)
+	{
+		buf[i] = (pkt_num + i) & 0xff;
+	}
+
+	/* IPv4 header with an IP-ID that increases by one for every packet */
+	buf[0] = 0x45;
+	buf[1] = 0x00;
+	buf[2] = (len >> 8) & 0xff;
+	buf[3] = len & 0xff;
+	buf[4] = (flow << 4) & 0xff;
+	buf[5] = pkt_num & 0xff;
+	buf[6] = 0x40; /* DF */
+	buf[7] = 0x00;
+	buf[8] = 64; /* TTL */
+	buf[9] = (flow == TEST_FLOW_UDP ? 17 : (flow == TEST_FLOW_TCP ? 6 : 134));
+	buf[10] = 0x00; /* checksum computed below */
+	buf[11] = 0x00;
+	buf[12] = 192; /* source address 192.168.0.1 */
+	buf[13] = 168;
+	buf[14] = 0;
+	buf[15] = 1;
+	buf[16] = 192; /* destination address 192.168.0.2 */
+	buf[17] = 168;
+	buf[18] = 0;
+	buf[19] = 2;
+	for(i = 0; i < ip_hdr_len; i += 2)
+	{
+		sum += (buf[i] << 8) | buf[i + 1];
+	}
+	while((sum >> 16) != 0)
+	{
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+	buf[10] = (~sum >> 8) & 0xff;
+	buf[11] = ~sum & 0xff;
+
+	return len;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return rand();
+}
+
@@ -0,0 +1,686 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_r_mode.c
+ * @brief  Check the R-mode of the RFC 3095 profiles with several flows
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses and decompresses one flow of packets for the
+ * IP-only, UDP and RTP profiles. The decompressor runs in R-mode and its
+ * feedback is delivered to the compressor after every packet. The TTL/HL of
+ * the IP header changes during the flow. Every decompressed packet shall
+ * match the original one, and the R-mode packets shall be used: R-0 packets
+ * for the IP-only and UDP profiles, R-0-CRC packets for the RTP profile. The
+ * test is run with small and large CIDs.
+ */
+
+#include "test.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdarg.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The max size of the packets */
+#define TEST_MAX_PKT_SIZE  1500U
+
+/** The number of packets compressed for every flow */
+#define TEST_PKTS_NR  300U
+
+/** The length of the payload of the generated packets */
+#define TEST_PAYLOAD_LEN  20U
+
+/** The UDP destination port of the RTP flow */
+#define TEST_RTP_PORT  1234U
+
+
+/** The flows to compress */
+typedef enum
+{
+	TEST_FLOW_IPV4         = 0, /**< IPv4 only */
+	TEST_FLOW_IPV4_UDP     = 1, /**< IPv4/UDP */
+	TEST_FLOW_IPV6_UDP     = 2, /**< IPv6/UDP */
+	TEST_FLOW_IPV4_UDP_RTP = 3, /**< IPv4/UDP/RTP */
+	TEST_FLOWS_NR          = 4, /**< The number of flows */
+} test_flow_t;
+
+
+/* prototypes of private functions */
+static void usage(void);
+static int test_r_mode(const rohc_cid_type_t cid_type,
+                       const rohc_cid_t max_cid);
+static bool compress_flow(struct rohc_comp *const comp,
+                          struct rohc_decomp *const decomp,
+                          const test_flow_t flow);
+static size_t build_packet(const test_flow_t flow,
+                           const size_t pkt_num,
+                           uint8_t *const buf)
+	__attribute__((nonnull(3)));
+static size_t build_ipv4_hdr(const test_flow_t flow,
+                             const size_t pkt_num,
+                             const uint8_t protocol,
+                             const size_t payload_len,
+                             uint8_t *const buf)
+	__attribute__((nonnull(5)));
+static size_t build_ipv6_hdr(const test_flow_t flow,
+                             const size_t pkt_num,
+                             const uint8_t next_header,
+                             const size_t payload_len,
+                             uint8_t *const buf)
+	__attribute__((nonnull(5)));
+static size_t build_udp_hdr(const test_flow_t flow,
+                            const size_t pkt_num,
+                            const size_t payload_len,
+                            uint8_t *const buf)
+	__attribute__((nonnull(4)));
+static size_t build_rtp_hdr(const size_t pkt_num,
+                            uint8_t *const buf)
+	__attribute__((nonnull(2)));
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+static bool rohc_comp_rtp_cb(const unsigned char *const ip,
+                             const unsigned char *const udp,
+                             const unsigned char *const payload,
+                             const unsigned int payload_size,
+                             void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Check the R-mode of the RFC 3095 profiles with several flows
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	int status = 1;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc != 1)
+	{
+		usage();
+		goto error;
+	}
+
+	status = test_r_mode(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX);
+	if(status != 0)
+	{
+		goto error;
+	}
+	status = test_r_mode(ROHC_LARGE_CID, ROHC_LARGE_CID_MAX);
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "Check the R-mode of the RFC 3095 profiles with several flows\n"
+	        "\n"
+	        "usage: test_r_mode [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  -h           Print this usage and exit\n");
+}
+
+
+/**
+ * @brief Compress and decompress all the flows
+ *
+ * @param cid_type  The type of CIDs used by the compressor/decompressor
+ * @param max_cid   The maximum CID used by the compressor/decompressor
+ * @return          0 in case of success, 1 in case of failure
+ */
+static int test_r_mode(const rohc_cid_type_t cid_type,
+                       const rohc_cid_t max_cid)
+{
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	test_flow_t flow;
+	int is_failure = 1;
+
+	fprintf(stderr, "test with %s CIDs\n",
+	        cid_type == ROHC_SMALL_CID ? "small" : "large");
+
+	/* initialize the random generator with the same number to ease debugging */
+	srand(4 /* chosen by fair dice roll, guaranteed to be random */);
+
+	/* create the ROHC compressor */
+	comp = rohc_comp_new2(cid_type, max_cid, gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "compressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
+	                              ROHC_PROFILE_IP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	{
+		fprintf(stderr, "failed to set the callback RTP detection\n");
+		goto destroy_comp;
+	}
+
+	/* create the ROHC decompressor in bi-directional reliable mode */
+	decomp = rohc_decomp_new2(cid_type, max_cid, ROHC_R_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "decompressor\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_RTP, ROHC_PROFILE_UDP,
+	                                ROHC_PROFILE_IP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	for(flow = 0; flow < TEST_FLOWS_NR; flow++)
+	{
+		if(!compress_flow(comp, decomp, flow))
+		{
+			goto destroy_decomp;
+		}
+	}
+
+	/* everything went fine */
+	fprintf(stderr, "all packets decompressed\n");
+	is_failure = 0;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Compress and decompress TEST_PKTS_NR packets of one flow
+ *
+ * The feedback generated by the decompressor is delivered to the compressor
+ * after every packet.
+ *
+ * @param comp    The ROHC compressor
+ * @param decomp  The ROHC decompressor
+ * @param flow    The flow
+ * @return        true if all packets were successfully compressed and
+ *                decompressed with the expected packets, false otherwise
+ */
+static bool compress_flow(struct rohc_comp *const comp,
+                          struct rohc_decomp *const decomp,
+                          const test_flow_t flow)
+{
+	const int expected_profile =
+		(flow == TEST_FLOW_IPV4 ? ROHC_PROFILE_IP :
+		 (flow == TEST_FLOW_IPV4_UDP_RTP ? ROHC_PROFILE_RTP : ROHC_PROFILE_UDP));
+	size_t pkt_types_nr[ROHC_PACKET_MAX] = { 0 };
+	size_t feedbacks_nr = 0;
+	size_t pkt_num;
+
+	for(pkt_num = 0; pkt_num < TEST_PKTS_NR; pkt_num++)
+	{
+		uint8_t ip_buffer[TEST_MAX_PKT_SIZE];
+		struct rohc_buf ip_packet =
+			rohc_buf_init_empty(ip_buffer, TEST_MAX_PKT_SIZE);
+		uint8_t rohc_buffer[TEST_MAX_PKT_SIZE];
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffer, TEST_MAX_PKT_SIZE);
+		uint8_t uncomp_buffer[TEST_MAX_PKT_SIZE];
+		struct rohc_buf uncomp_packet =
+			rohc_buf_init_empty(uncomp_buffer, TEST_MAX_PKT_SIZE);
+		uint8_t feedback_buffer[TEST_MAX_PKT_SIZE];
+		struct rohc_buf feedback_send =
+			rohc_buf_init_empty(feedback_buffer, TEST_MAX_PKT_SIZE);
+		rohc_comp_last_packet_info2_t info;
+
+		ip_packet.len = build_packet(flow, pkt_num, ip_buffer);
+
+		if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "flow #%d: failed to compress packet #%zu\n",
+			        flow, pkt_num + 1);
+			goto error;
+		}
+		memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+		info.version_major = 0;
+		info.version_minor = 0;
+		if(!rohc_comp_get_last_packet_info2(comp, &info))
+		{
+			fprintf(stderr, "flow #%d: failed to get information on packet "
+			        "#%zu\n", flow, pkt_num + 1);
+			goto error;
+		}
+		fprintf(stderr, "flow #%d: packet #%zu compressed as %zu-byte %s "
+		        "packet in %s\n", flow, pkt_num + 1, rohc_packet.len,
+		        rohc_get_packet_descr(info.packet_type),
+		        rohc_get_mode_descr(info.context_mode));
+		if(info.profile_id != expected_profile)
+		{
+			fprintf(stderr, "flow #%d: packet #%zu compressed with profile 0x%04x "
+			        "instead of profile 0x%04x\n", flow, pkt_num + 1,
+			        info.profile_id, expected_profile);
+			goto error;
+		}
+		pkt_types_nr[info.packet_type]++;
+
+		if(rohc_decompress3(decomp, rohc_packet, &uncomp_packet,
+		                    NULL, &feedback_send) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "flow #%d: failed to decompress packet #%zu\n",
+			        flow, pkt_num + 1);
+			goto error;
+		}
+		if(uncomp_packet.len != ip_packet.len ||
+		   memcmp(rohc_buf_data(uncomp_packet), rohc_buf_data(ip_packet),
+		          ip_packet.len) != 0)
+		{
+			fprintf(stderr, "flow #%d: decompressed packet #%zu does not "
+			        "match the original packet\n", flow, pkt_num + 1);
+			goto error;
+		}
+
+		/* deliver the feedback to the compressor */
+		if(!rohc_buf_is_empty(feedback_send))
+		{
+			if(!rohc_comp_deliver_feedback2(comp, feedback_send))
+			{
+				fprintf(stderr, "flow #%d: failed to deliver the feedback for "
+				        "packet #%zu\n", flow, pkt_num + 1);
+				goto error;
+			}
+			feedbacks_nr++;
+		}
+	}
+
+	/* the flow starts with IR packets, then the compressor transits to
+	 * R-mode and sends R-mode packets once the context is acknowledged */
+	if(pkt_types_nr[ROHC_PACKET_IR] == 0 || feedbacks_nr == 0)
+	{
+		fprintf(stderr, "flow #%d: IR packets and feedbacks expected\n", flow);
+		goto error;
+	}
+	if(flow == TEST_FLOW_IPV4_UDP_RTP)
+	{
+		if(pkt_types_nr[ROHC_PACKET_R_0] != 0 ||
+		   pkt_types_nr[ROHC_PACKET_R_0_CRC] < (TEST_PKTS_NR / 2))
+		{
+			fprintf(stderr, "flow #%d: R-0-CRC packets and no R-0 packet "
+			        "expected\n", flow);
+			goto error;
+		}
+	}
+	else if(pkt_types_nr[ROHC_PACKET_R_0] < (TEST_PKTS_NR / 2) ||
+	        pkt_types_nr[ROHC_PACKET_R_0_CRC] == 0)
+	{
+		fprintf(stderr, "flow #%d: mostly R-0 packets and some R-0-CRC packets "
+		        "expected\n", flow);
+		goto error;
+	}
+	if(pkt_types_nr[ROHC_PACKET_UO_0] != 0 ||
+	   pkt_types_nr[ROHC_PACKET_UO_1] != 0 ||
+	   pkt_types_nr[ROHC_PACKET_UO_1_RTP] != 0 ||
+	   pkt_types_nr[ROHC_PACKET_UO_1_ID] != 0 ||
+	   pkt_types_nr[ROHC_PACKET_UO_1_TS] != 0)
+	{
+		fprintf(stderr, "flow #%d: no UO-0 nor UO-1* packet expected\n", flow);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Build one packet of the given flow
+ *
+ * @param flow     The flow
+ * @param pkt_num  The number of the packet in the flow
+ * @param[out] buf The buffer for the packet
+ * @return         The length of the packet
+ */
+static size_t build_packet(const test_flow_t flow,
+                           const size_t pkt_num,
+                           uint8_t *const buf)
+{
+	const size_t udp_hdr_len = 8;
+	const size_t rtp_hdr_len = 12;
+	size_t len = 0;
+	size_t i;
+
+	switch(flow)
+	{
+		case TEST_FLOW_IPV4:
+			len += build_ipv4_hdr(flow, pkt_num, 253 /* experimentation */,
+			                      TEST_PAYLOAD_LEN, buf + len);
+			break;
+		case TEST_FLOW_IPV4_UDP:
+			len += build_ipv4_hdr(flow, pkt_num, 17 /* UDP */,
+			                      udp_hdr_len + TEST_PAYLOAD_LEN, buf + len);
+			len += build_udp_hdr(flow, pkt_num, TEST_PAYLOAD_LEN, buf + len);
+			break;
+		case TEST_FLOW_IPV6_UDP:
+			len += build_ipv6_hdr(flow, pkt_num, 17 /* UDP */,
+			                      udp_hdr_len + TEST_PAYLOAD_LEN, buf + len);
+			len += build_udp_hdr(flow, pkt_num, TEST_PAYLOAD_LEN, buf + len);
+			break;
+		case TEST_FLOW_IPV4_UDP_RTP:
+			len += build_ipv4_hdr(flow, pkt_num, 17 /* UDP */,
+			                      udp_hdr_len + rtp_hdr_len + TEST_PAYLOAD_LEN,
+			                      buf + len);
+			len += build_udp_hdr(flow, pkt_num, rtp_hdr_len + TEST_PAYLOAD_LEN,
+			                     buf + len);
+			len += build_rtp_hdr(pkt_num, buf + len);
+			break;
+		case TEST_FLOWS_NR:
+		default:
+			assert(0);
+			break;
+	}
+
+	/* payload */
+	for(i = 0; i < TEST_PAYLOAD_LEN; i++)
+	{
+		buf[len + i] = (pkt_num + i) & 0xff;
+	}
+	len += TEST_PAYLOAD_LEN;
+
+	return len;
+}
+
+
+/**
+ * @brief Build one IPv4 header with a sequential IP-ID
+ *
+ * The TTL changes at the middle of the flow.
+ *
+ * @param flow         The flow, it selects the source address
+ * @param pkt_num      The number of the packet in the flow
+ * @param protocol     The protocol after the IPv4 header
+ * @param payload_len  The length of the IPv4 payload
+ * @param[out] buf     The buffer for the header
+ * @return             The length of the header
+ */
+static size_t build_ipv4_hdr(const test_flow_t flow,
+                             const size_t pkt_num,
+                             const uint8_t protocol,
+                             const size_t payload_len,
+                             uint8_t *const buf)
+{
+	const size_t ip_hdr_len = 20;
+	const size_t len = ip_hdr_len + payload_len;
+	const uint16_t ip_id = 0x1000 + pkt_num;
+	uint32_t sum = 0;
+	size_t i;
+
+	buf[0] = 0x45;
+	buf[1] = 0x00;
+	buf[2] = (len >> 8) & 0xff;
+	buf[3] = len & 0xff;
+	buf[4] = (ip_id >> 8) & 0xff;
+	buf[5] = ip_id & 0xff;
+	buf[6] = 0x40; /* DF */
+	buf[7] = 0x00;
+	buf[8] = (pkt_num < (TEST_PKTS_NR / 2) ? 64 : 63); /* TTL */
+	buf[9] = protocol;
+	buf[10] = 0x00; /* checksum computed below */
+	buf[11] = 0x00;
+	buf[12] = 192; /* source address 192.168.<flow>.1 */
+	buf[13] = 168;
+	buf[14] = flow;
+	buf[15] = 1;
+	buf[16] = 192; /* destination address 192.168.0.2 */
+	buf[17] = 168;
+	buf[18] = 0;
+	buf[19] = 2;
+	for(i = 0; i < ip_hdr_len; i += 2)
+	{
+		sum += (buf[i] << 8) | buf[i + 1];
+	}
+	while((sum >> 16) != 0)
+	{
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+	buf[10] = (~sum >> 8) & 0xff;
+	buf[11] = ~sum & 0xff;
+
+	return ip_hdr_len;
+}
+
+
+/**
+ * @brief Build one IPv6 header
+ *
+ * The Hop Limit changes at the middle of the flow.
+ *
+ * @param flow         The flow, it selects the source address
+ * @param pkt_num      The number of the packet in the flow
+ * @param next_header  The protocol after the IPv6 header
+ * @param payload_len  The length of the IPv6 payload
+ * @param[out] buf     The buffer for the header
+ * @return             The length of the header
+ */
+static size_t build_ipv6_hdr(const test_flow_t flow,
+                             const size_t pkt_num,
+                             const uint8_t next_header,
+                             const size_t payload_len,
+                             uint8_t *const buf)
+{
+	const size_t ip_hdr_len = 40;
+	size_t i;
+
+	buf[0] = 0x60; /* version 6, TC 0x0a, flow label 0x12345 */
+	buf[1] = 0xa1;
+	buf[2] = 0x23;
+	buf[3] = 0x45;
+	buf[4] = (payload_len >> 8) & 0xff;
+	buf[5] = payload_len & 0xff;
+	buf[6] = next_header;
+	buf[7] = (pkt_num < (TEST_PKTS_NR / 2) ? 64 : 63); /* Hop Limit */
+	for(i = 0; i < 16; i++)
+	{
+		buf[8 + i] = 0x20 + i;  /* source address */
+		buf[24 + i] = 0x40 + i; /* destination address */
+	}
+	buf[23] = flow;
+
+	return ip_hdr_len;
+}
+
+
+/**
+ * @brief Build one UDP header
+ *
+ * The UDP checksum is disabled for IPv4, and changes with every packet for
+ * IPv6 (its value is not checked by the library).
+ *
+ * @param flow         The flow
+ * @param pkt_num      The number of the packet in the flow
+ * @param payload_len  The length of the UDP payload
+ * @param[out] buf     The buffer for the header
+ * @return             The length of the header
+ */
+static size_t build_udp_hdr(const test_flow_t flow,
+                            const size_t pkt_num,
+                            const size_t payload_len,
+                            uint8_t *const buf)
+{
+	const size_t udp_hdr_len = 8;
+	const size_t len = udp_hdr_len + payload_len;
+	const uint16_t dport =
+		(flow == TEST_FLOW_IPV4_UDP_RTP ? TEST_RTP_PORT : 5678);
+	const uint16_t check = (flow == TEST_FLOW_IPV6_UDP ? 0x8000 + pkt_num : 0);
+
+	buf[0] = 0x12; /* source port 0x1234 */
+	buf[1] = 0x34;
+	buf[2] = (dport >> 8) & 0xff;
+	buf[3] = dport & 0xff;
+	buf[4] = (len >> 8) & 0xff;
+	buf[5] = len & 0xff;
+	buf[6] = (check >> 8) & 0xff;
+	buf[7] = check & 0xff;
+
+	return udp_hdr_len;
+}
+
+
+/**
+ * @brief Build one RTP header
+ *
+ * The SN increases by one and the TS by 160 with every packet.
+ *
+ * @param pkt_num  The number of the packet in the flow
+ * @param[out] buf The buffer for the header
+ * @return         The length of the header
+ */
+static size_t build_rtp_hdr(const size_t pkt_num,
+                            uint8_t *const buf)
+{
+	const size_t rtp_hdr_len = 12;
+	const uint16_t sn = 0x2000 + pkt_num;
+	const uint32_t ts = 0x10000000 + pkt_num * 160;
+
+	buf[0] = 0x80; /* version 2, no padding, no extension, no CSRC */
+	buf[1] = 0x00; /* no marker, payload type 0 */
+	buf[2] = (sn >> 8) & 0xff;
+	buf[3] = sn & 0xff;
+	buf[4] = (ts >> 24) & 0xff;
+	buf[5] = (ts >> 16) & 0xff;
+	buf[6] = (ts >> 8) & 0xff;
+	buf[7] = ts & 0xff;
+	buf[8] = 0x12; /* SSRC */
+	buf[9] = 0x34;
+	buf[10] = 0x56;
+	buf[11] = 0x78;
+
+	return rtp_hdr_len;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return rand();
+}
+
+
+/**
+ * @brief The RTP detection callback
+ *
+ * The UDP packets sent to port TEST_RTP_PORT carry RTP.
+ *
+ * @param ip           The innermost IP packet
+ * @param udp          The UDP header of the packet
+ * @param payload      The UDP payload of the packet
+ * @param payload_size The size of the UDP payload (in bytes)
+ * @param rtp_private  An optional private context
+ * @return             true if the packet is an RTP packet, false otherwise
+ */
+static bool rohc_comp_rtp_cb(const unsigned char *const ip,
+                             const unsigned char *const udp,
+                             const unsigned char *const payload,
+                             const unsigned int payload_size,
+                             void *const rtp_private)
+{
+	return (udp != NULL && udp[2] == ((TEST_RTP_PORT >> 8) & 0xff) &&
+	        udp[3] == (TEST_RTP_PORT & 0xff));
+}
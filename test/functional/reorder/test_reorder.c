@@ -0,0 +1,570 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_reorder.c
+ * @brief  Check the decompression of reordered packets
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses one flow of packets for the UDP and RTP
+ * profiles in U-mode. Once the context is established, the ROHC packets
+ * are delivered to the decompressor in groups of 4 packets where the first
+ * packet comes late: 1, 2, 0, 3. With a reorder window, every decompressed
+ * packet shall match the original one and the late packets shall be
+ * reported. Without reorder window, some late packets shall fail.
+ */
+
+#include "test.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdarg.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+
+
+/** The max size of the packets */
+#define TEST_MAX_PKT_SIZE  200U
+
+/** The number of packets compressed for every flow */
+#define TEST_PKTS_NR  200U
+
+/** The number of packets delivered in order at the beginning of the flow */
+#define TEST_IN_ORDER_PKTS_NR  20U
+
+/** The size of the groups of reordered packets */
+#define TEST_GROUP_LEN  4U
+
+/** The reorder window of the decompressor */
+#define TEST_REORDER_WINDOW  4U
+
+/** The length of the payload of the generated packets */
+#define TEST_PAYLOAD_LEN  20U
+
+/** The UDP destination port of the RTP flow */
+#define TEST_RTP_PORT  1234U
+
+
+/** The flows to compress */
+typedef enum
+{
+	TEST_FLOW_IPV4_UDP     = 0, /**< IPv4/UDP */
+	TEST_FLOW_IPV4_UDP_RTP = 1, /**< IPv4/UDP/RTP */
+	TEST_FLOWS_NR          = 2, /**< The number of flows */
+} test_flow_t;
+
+
+/* prototypes of private functions */
+static void usage(void);
+static int test_reorder(const size_t reorder_window);
+static bool compress_flow(struct rohc_comp *const comp,
+                          struct rohc_decomp *const decomp,
+                          const size_t reorder_window,
+                          const test_flow_t flow);
+static size_t get_pkt_num(const size_t delivery_num)
+	__attribute__((warn_unused_result, const));
+static size_t build_packet(const test_flow_t flow,
+                           const size_t pkt_num,
+                           uint8_t *const buf)
+	__attribute__((nonnull(3)));
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+static bool rohc_comp_rtp_cb(const unsigned char *const ip,
+                             const unsigned char *const udp,
+                             const unsigned char *const payload,
+                             const unsigned int payload_size,
+                             void *const rtp_private)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Check the decompression of reordered packets
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	int status = 1;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc != 1)
+	{
+		usage();
+		goto error;
+	}
+
+	status = test_reorder(TEST_REORDER_WINDOW);
+	if(status != 0)
+	{
+		goto error;
+	}
+	status = test_reorder(0);
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "Check the decompression of reordered packets\n"
+	        "\n"
+	        "usage: test_reorder [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  -h           Print this usage and exit\n");
+}
+
+
+/**
+ * @brief Compress and decompress all the flows
+ *
+ * @param reorder_window  The reorder window of the decompressor
+ * @return                0 in case of success, 1 in case of failure
+ */
+static int test_reorder(const size_t reorder_window)
+{
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	size_t window;
+	test_flow_t flow;
+	int is_failure = 1;
+
+	fprintf(stderr, "test with a reorder window of %zu packets\n",
+	        reorder_window);
+
+	/* initialize the random generator with the same number to ease debugging */
+	srand(4 /* chosen by fair dice roll, guaranteed to be random */);
+
+	/* create the ROHC compressor */
+	comp = rohc_comp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, gen_random_num,
+	                      NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "compressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_RTP, ROHC_PROFILE_UDP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_set_rtp_detection_cb(comp, rohc_comp_rtp_cb, NULL))
+	{
+		fprintf(stderr, "failed to set the callback RTP detection\n");
+		goto destroy_comp;
+	}
+
+	/* create the ROHC decompressor in unidirectional mode */
+	decomp = rohc_decomp_new2(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "decompressor\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_RTP, ROHC_PROFILE_UDP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	/* set the reorder window */
+	if(!rohc_decomp_set_reorder_window(decomp, reorder_window))
+	{
+		fprintf(stderr, "failed to set the reorder window\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_get_reorder_window(decomp, &window) ||
+	   window != reorder_window)
+	{
+		fprintf(stderr, "failed to get the reorder window\n");
+		goto destroy_decomp;
+	}
+
+	for(flow = 0; flow < TEST_FLOWS_NR; flow++)
+	{
+		if(!compress_flow(comp, decomp, reorder_window, flow))
+		{
+			goto destroy_decomp;
+		}
+	}
+
+	/* everything went fine */
+	fprintf(stderr, "all packets decompressed as expected\n");
+	is_failure = 0;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Compress TEST_PKTS_NR packets of one flow, then decompress them
+ *        out of order
+ *
+ * @param comp            The ROHC compressor
+ * @param decomp          The ROHC decompressor
+ * @param reorder_window  The reorder window of the decompressor
+ * @param flow            The flow
+ * @return                true if the packets were decompressed as expected,
+ *                        false otherwise
+ */
+static bool compress_flow(struct rohc_comp *const comp,
+                          struct rohc_decomp *const decomp,
+                          const size_t reorder_window,
+                          const test_flow_t flow)
+{
+	static uint8_t rohc_buffers[TEST_PKTS_NR][TEST_MAX_PKT_SIZE];
+	size_t rohc_lens[TEST_PKTS_NR];
+	size_t late_pkts_nr = 0;
+	size_t failures_nr = 0;
+	size_t delivery_num;
+	size_t pkt_num;
+
+	/* compress all the packets of the flow in order */
+	for(pkt_num = 0; pkt_num < TEST_PKTS_NR; pkt_num++)
+	{
+		uint8_t ip_buffer[TEST_MAX_PKT_SIZE];
+		struct rohc_buf ip_packet =
+			rohc_buf_init_empty(ip_buffer, TEST_MAX_PKT_SIZE);
+		struct rohc_buf rohc_packet =
+			rohc_buf_init_empty(rohc_buffers[pkt_num], TEST_MAX_PKT_SIZE);
+
+		ip_packet.len = build_packet(flow, pkt_num, ip_buffer);
+		if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "flow #%d: failed to compress packet #%zu\n",
+			        flow, pkt_num + 1);
+			goto error;
+		}
+		rohc_lens[pkt_num] = rohc_packet.len;
+	}
+
+	/* decompress the packets out of order */
+	for(delivery_num = 0; delivery_num < TEST_PKTS_NR; delivery_num++)
+	{
+		const size_t cur_pkt_num = get_pkt_num(delivery_num);
+		const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+		uint8_t ip_buffer[TEST_MAX_PKT_SIZE];
+		struct rohc_buf ip_packet =
+			rohc_buf_init_empty(ip_buffer, TEST_MAX_PKT_SIZE);
+		const struct rohc_buf rohc_packet =
+			rohc_buf_init_full(rohc_buffers[cur_pkt_num], rohc_lens[cur_pkt_num],
+			                   arrival_time);
+		uint8_t uncomp_buffer[TEST_MAX_PKT_SIZE];
+		struct rohc_buf uncomp_packet =
+			rohc_buf_init_empty(uncomp_buffer, TEST_MAX_PKT_SIZE);
+		rohc_decomp_last_packet_info_t info;
+
+		pkt_num = cur_pkt_num;
+		ip_packet.len = build_packet(flow, pkt_num, ip_buffer);
+
+		if(rohc_decompress3(decomp, rohc_packet, &uncomp_packet,
+		                    NULL, NULL) != ROHC_STATUS_OK)
+		{
+			fprintf(stderr, "flow #%d: failed to decompress packet #%zu\n",
+			        flow, pkt_num + 1);
+			failures_nr++;
+			continue;
+		}
+		if(uncomp_packet.len != ip_packet.len ||
+		   memcmp(rohc_buf_data(uncomp_packet), rohc_buf_data(ip_packet),
+		          ip_packet.len) != 0)
+		{
+			fprintf(stderr, "flow #%d: decompressed packet #%zu does not "
+			        "match the original packet\n", flow, pkt_num + 1);
+			failures_nr++;
+			continue;
+		}
+
+		memset(&info, 0, sizeof(rohc_decomp_last_packet_info_t));
+		info.version_major = 0;
+		info.version_minor = 0;
+		if(!rohc_decomp_get_last_packet_info(decomp, &info))
+		{
+			fprintf(stderr, "flow #%d: failed to get information on packet "
+			        "#%zu\n", flow, pkt_num + 1);
+			goto error;
+		}
+		if(info.nr_misordered_packets > 0)
+		{
+			fprintf(stderr, "flow #%d: packet #%zu decompressed %lu packet(s) "
+			        "late\n", flow, pkt_num + 1, info.nr_misordered_packets);
+			late_pkts_nr++;
+		}
+	}
+
+	/* with a reorder window, all packets shall be decompressed and all the
+	 * late packets shall be reported; without reorder window, some late
+	 * packets shall fail */
+	if(reorder_window > 0)
+	{
+		const size_t expected_late_pkts_nr =
+			(TEST_PKTS_NR - TEST_IN_ORDER_PKTS_NR) / TEST_GROUP_LEN;
+
+		if(failures_nr != 0 || late_pkts_nr != expected_late_pkts_nr)
+		{
+			fprintf(stderr, "flow #%d: %zu failures and %zu late packets, while "
+			        "0 failure and %zu late packets expected\n", flow,
+			        failures_nr, late_pkts_nr, expected_late_pkts_nr);
+			goto error;
+		}
+	}
+	else if(failures_nr == 0)
+	{
+		fprintf(stderr, "flow #%d: failures expected without reorder "
+		        "window\n", flow);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the number of the packet delivered at the given position
+ *
+ * The first TEST_IN_ORDER_PKTS_NR packets are delivered in order, then the
+ * first packet of every group of TEST_GROUP_LEN packets comes after the
+ * next 2 packets.
+ *
+ * @param delivery_num  The position of the packet in the delivery order
+ * @return              The number of the packet in the flow
+ */
+static size_t get_pkt_num(const size_t delivery_num)
+{
+	const size_t group_pos[TEST_GROUP_LEN] = { 1, 2, 0, 3 };
+	size_t group_start;
+
+	if(delivery_num < TEST_IN_ORDER_PKTS_NR)
+	{
+		return delivery_num;
+	}
+	group_start = delivery_num - ((delivery_num - TEST_IN_ORDER_PKTS_NR) %
+	                              TEST_GROUP_LEN);
+
+	return group_start + group_pos[delivery_num - group_start];
+}
+
+
+/**
+ * @brief Build one packet of the given flow
+ *
+ * The IPv4 header carries a sequential IP-ID. The RTP header carries a SN
+ * that increases by one and a TS that increases by 160 with every packet.
+ *
+ * @param flow     The flow
+ * @param pkt_num  The number of the packet in the flow
+ * @param[out] buf The buffer for the packet
+ * @return         The length of the packet
+ */
+static size_t build_packet(const test_flow_t flow,
+                           const size_t pkt_num,
+                           uint8_t *const buf)
+{
+	const size_t ip_hdr_len = 20;
+	const size_t udp_hdr_len = 8;
+	const size_t rtp_hdr_len = (flow == TEST_FLOW_IPV4_UDP_RTP ? 12 : 0);
+	const size_t udp_len = udp_hdr_len + rtp_hdr_len + TEST_PAYLOAD_LEN;
+	const size_t len = ip_hdr_len + udp_len;
+	const uint16_t ip_id = 0x1000 + pkt_num;
+	const uint16_t dport =
+		(flow == TEST_FLOW_IPV4_UDP_RTP ? TEST_RTP_PORT : 5678);
+	uint32_t sum = 0;
+	size_t i;
+
+	/* IPv4 header */
+	buf[0] = 0x45;
+	buf[1] = 0x00;
+	buf[2] = (len >> 8) & 0xff;
+	buf[3] = len & 0xff;
+	buf[4] = (ip_id >> 8) & 0xff;
+	buf[5] = ip_id & 0xff;
+	buf[6] = 0x40; /* DF */
+	buf[7] = 0x00;
+	buf[8] = 64; /* TTL */
+	buf[9] = 17; /* UDP */
+	buf[10] = 0x00; /* checksum computed below */
+	buf[11] = 0x00;
+	buf[12] = 192; /* source address 192.168.<flow>.1 */
+	buf[13] = 168;
+	buf[14] = flow;
+	buf[15] = 1;
+	buf[16] = 192; /* destination address 192.168.0.2 */
+	buf[17] = 168;
+	buf[18] = 0;
+	buf[19] = 2;
+	for(i = 0; i < ip_hdr_len; i += 2)
+	{
+		sum += (buf[i] << 8) | buf[i + 1];
+	}
+	while((sum >> 16) != 0)
+	{
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+	buf[10] = (~sum >> 8) & 0xff;
+	buf[11] = ~sum & 0xff;
+
+	/* UDP header without checksum */
+	buf[20] = 0x12; /* source port 0x1234 */
+	buf[21] = 0x34;
+	buf[22] = (dport >> 8) & 0xff;
+	buf[23] = dport & 0xff;
+	buf[24] = (udp_len >> 8) & 0xff;
+	buf[25] = udp_len & 0xff;
+	buf[26] = 0x00;
+	buf[27] = 0x00;
+
+	/* RTP header */
+	if(flow == TEST_FLOW_IPV4_UDP_RTP)
+	{
+		const uint16_t sn = 0x2000 + pkt_num;
+		const uint32_t ts = 0x10000000 + pkt_num * 160;
+
+		buf[28] = 0x80; /* version 2, no padding, no extension, no CSRC */
+		buf[29] = 0x00; /* no marker, payload type 0 */
+		buf[30] = (sn >> 8) & 0xff;
+		buf[31] = sn & 0xff;
+		buf[32] = (ts >> 24) & 0xff;
+		buf[33] = (ts >> 16) & 0xff;
+		buf[34] = (ts >> 8) & 0xff;
+		buf[35] = ts & 0xff;
+		buf[36] = 0x12; /* SSRC */
+		buf[37] = 0x34;
+		buf[38] = 0x56;
+		buf[39] = 0x78;
+	}
+
+	/* payload */
+	for(i = 0; i < TEST_PAYLOAD_LEN; i++)
+	{
+		buf[ip_hdr_len + udp_hdr_len + rtp_hdr_len + i] = (pkt_num + i) & 0xff;
+	}
+
+	return len;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return rand();
+}
+
+
+/**
+ * @brief The RTP detection callback
+ *
+ * The UDP packets sent to port TEST_RTP_PORT carry RTP.
+ *
+ * @param ip           The innermost IP packet
+ * @param udp          The UDP header of the packet
+ * @param payload      The UDP payload of the packet
+ * @param payload_size The size of the UDP payload (in bytes)
+ * @param rtp_private  An optional private context
+ * @return             true if the packet is an RTP packet, false otherwise
+ */
+static bool rohc_comp_rtp_cb(const unsigned char *const ip,
+                             const unsigned char *const udp,
+                             const unsigned char *const payload,
+                             const unsigned int payload_size,
+                             void *const rtp_private)
+{
+	return (udp != NULL && udp[2] == ((TEST_RTP_PORT >> 8) & 0xff) &&
+	        udp[3] == (TEST_RTP_PORT & 0xff));
+}
@@ -0,0 +1,794 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_rohcv2_ip.c
+ * @brief  Check the ROHCv2 IP-only profile with several IP flows
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The application compresses and decompresses one flow of IP packets for
+ * every kind of IP flow: IPv4 with sequential, swapped, random and zero
+ * IP-IDs, IPv6, and tunnels of IPv4 in IPv4 or IPv6. The TTL/HL of the
+ * headers changes during the flow and the IP-ID jumps from time to time.
+ * Every decompressed packet shall match the original one, and the ROHCv2
+ * packets with the smallest headers shall be used. The test is run with
+ * small and large CIDs.
+ *
+ * Once all the flows are compressed, an ACK establishes the feedback channel
+ * for the first IP flow. Then a NACK and a STATIC-NACK are delivered to the
+ * compressor: it shall repair the context with co_repair packets, then with
+ * IR packets.
+ */
+
+#include "test.h"
+#include "config.h" /* for HAVE_*_H */
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <stdarg.h>
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_comp.h>
+#include <rohc_decomp.h>
+#include "feedback.h" /* for enum rohc_feedback_ack_type */
+
+
+/** The max size of the packets */
+#define TEST_MAX_PKT_SIZE  1500U
+
+/** The number of packets compressed for every IP flow */
+#define TEST_PKTS_NR  200U
+
+/** The length of the payload of the generated packets */
+#define TEST_PAYLOAD_LEN  20U
+
+
+/** The IP flows to compress */
+typedef enum
+{
+	TEST_FLOW_IPV4_SEQ       = 0, /**< IPv4 with sequential IP-ID */
+	TEST_FLOW_IPV4_SEQ_SWAP  = 1, /**< IPv4 with byte-swapped sequential IP-ID */
+	TEST_FLOW_IPV4_RAND      = 2, /**< IPv4 with random IP-ID */
+	TEST_FLOW_IPV4_ZERO      = 3, /**< IPv4 with zero IP-ID */
+	TEST_FLOW_IPV6           = 4, /**< IPv6 */
+	TEST_FLOW_IPV4_IN_IPV4   = 5, /**< IPv4 with sequential IP-ID in IPv4 */
+	TEST_FLOW_IPV4_IN_IPV6   = 6, /**< IPv4 with sequential IP-ID in IPv6 */
+	TEST_FLOWS_NR            = 7, /**< The number of IP flows */
+} test_flow_t;
+
+
+/* prototypes of private functions */
+static void usage(void);
+static int test_rohcv2_ip(const rohc_cid_type_t cid_type,
+                          const rohc_cid_t max_cid);
+static bool compress_flow(struct rohc_comp *const comp,
+                          struct rohc_decomp *const decomp,
+                          const test_flow_t flow);
+static bool compress_pkt(struct rohc_comp *const comp,
+                         struct rohc_decomp *const decomp,
+                         const test_flow_t flow,
+                         const size_t pkt_num,
+                         rohc_packet_t *const packet_type)
+	__attribute__((nonnull(1, 2, 5)));
+static bool deliver_feedback(struct rohc_comp *const comp,
+                             const rohc_cid_type_t cid_type,
+                             const enum rohc_feedback_ack_type ack_type)
+	__attribute__((nonnull(1)));
+static bool check_nack(struct rohc_comp *const comp,
+                       struct rohc_decomp *const decomp,
+                       const rohc_cid_type_t cid_type,
+                       const enum rohc_feedback_ack_type ack_type,
+                       const size_t first_pkt_num,
+                       const rohc_packet_t exp_packet_type);
+static uint8_t compute_crc8(const uint8_t *const data, const size_t len)
+	__attribute__((nonnull(1)));
+static size_t build_packet(const test_flow_t flow,
+                           const size_t pkt_num,
+                           uint8_t *const buf)
+	__attribute__((nonnull(3)));
+static size_t build_ipv4_hdr(const test_flow_t flow,
+                             const size_t pkt_num,
+                             const uint16_t ip_id,
+                             const bool df,
+                             const uint8_t protocol,
+                             const size_t payload_len,
+                             uint8_t *const buf)
+	__attribute__((nonnull(7)));
+static size_t build_ipv6_hdr(const test_flow_t flow,
+                             const size_t pkt_num,
+                             const uint8_t next_header,
+                             const size_t payload_len,
+                             uint8_t *const buf)
+	__attribute__((nonnull(5)));
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+	__attribute__((format(printf, 5, 6), nonnull(5)));
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+	__attribute__((nonnull(1)));
+
+
+/**
+ * @brief Check the ROHCv2 IP-only profile with several IP flows
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure
+ */
+int main(int argc, char *argv[])
+{
+	int status = 1;
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc != 1)
+	{
+		usage();
+		goto error;
+	}
+
+	status = test_rohcv2_ip(ROHC_SMALL_CID, ROHC_SMALL_CID_MAX);
+	if(status != 0)
+	{
+		goto error;
+	}
+	status = test_rohcv2_ip(ROHC_LARGE_CID, ROHC_LARGE_CID_MAX);
+
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "Check the ROHCv2 IP-only profile with several IP flows\n"
+	        "\n"
+	        "usage: test_rohcv2_ip [OPTIONS]\n"
+	        "\n"
+	        "options:\n"
+	        "  -h           Print this usage and exit\n");
+}
+
+
+/**
+ * @brief Compress and decompress all the IP flows
+ *
+ * @param cid_type  The type of CIDs used by the compressor/decompressor
+ * @param max_cid   The maximum CID used by the compressor/decompressor
+ * @return          0 in case of success, 1 in case of failure
+ */
+static int test_rohcv2_ip(const rohc_cid_type_t cid_type,
+                          const rohc_cid_t max_cid)
+{
+	struct rohc_comp *comp;
+	struct rohc_decomp *decomp;
+	test_flow_t flow;
+	size_t pkt_num;
+	int is_failure = 1;
+
+	fprintf(stderr, "test with %s CIDs\n",
+	        cid_type == ROHC_SMALL_CID ? "small" : "large");
+
+	/* initialize the random generator with the same number to ease debugging */
+	srand(4 /* chosen by fair dice roll, guaranteed to be random */);
+
+	/* create the ROHC compressor */
+	comp = rohc_comp_new2(cid_type, max_cid, gen_random_num, NULL);
+	if(comp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC compressor\n");
+		goto error;
+	}
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "compressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHCv2_PROFILE_IP, -1))
+	{
+		fprintf(stderr, "failed to enable the compression profiles\n");
+		goto destroy_comp;
+	}
+
+	/* create the ROHC decompressor in uni-directional mode */
+	decomp = rohc_decomp_new2(cid_type, max_cid, ROHC_U_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "failed to create the ROHC decompressor\n");
+		goto destroy_comp;
+	}
+	if(!rohc_decomp_set_traces_cb2(decomp, print_rohc_traces, NULL))
+	{
+		fprintf(stderr, "failed to set the callback for traces on "
+		        "decompressor\n");
+		goto destroy_decomp;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHCv2_PROFILE_IP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	for(flow = 0; flow < TEST_FLOWS_NR; flow++)
+	{
+		if(!compress_flow(comp, decomp, flow))
+		{
+			goto destroy_decomp;
+		}
+	}
+
+	/* ACK: the feedback channel is established, the compressor goes back to
+	 * the IR state to change from U-mode to O-mode, then to the SO state */
+	if(!deliver_feedback(comp, cid_type, ROHC_FEEDBACK_ACK))
+	{
+		goto destroy_decomp;
+	}
+	for(pkt_num = TEST_PKTS_NR; pkt_num < (TEST_PKTS_NR + 10); pkt_num++)
+	{
+		rohc_packet_t packet_type;
+
+		if(!compress_pkt(comp, decomp, TEST_FLOW_IPV4_SEQ, pkt_num, &packet_type))
+		{
+			goto destroy_decomp;
+		}
+	}
+
+	/* NACK: the dynamic part of the context is repaired with co_repair */
+	if(!check_nack(comp, decomp, cid_type, ROHC_FEEDBACK_NACK,
+	               TEST_PKTS_NR + 10, ROHC_PACKET_CO_REPAIR))
+	{
+		goto destroy_decomp;
+	}
+
+	/* STATIC-NACK: the whole context is repaired with IR */
+	if(!check_nack(comp, decomp, cid_type, ROHC_FEEDBACK_STATIC_NACK,
+	               TEST_PKTS_NR + 20, ROHC_PACKET_IR))
+	{
+		goto destroy_decomp;
+	}
+
+	/* everything went fine */
+	fprintf(stderr, "all packets decompressed\n");
+	is_failure = 0;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return is_failure;
+}
+
+
+/**
+ * @brief Compress and decompress TEST_PKTS_NR packets of one IP flow
+ *
+ * @param comp    The ROHC compressor
+ * @param decomp  The ROHC decompressor
+ * @param flow    The IP flow
+ * @return        true if all packets were successfully compressed and
+ *                decompressed with the expected packets, false otherwise
+ */
+static bool compress_flow(struct rohc_comp *const comp,
+                          struct rohc_decomp *const decomp,
+                          const test_flow_t flow)
+{
+	size_t pkt_types_nr[ROHC_PACKET_MAX] = { 0 };
+	size_t pkt_num;
+
+	for(pkt_num = 0; pkt_num < TEST_PKTS_NR; pkt_num++)
+	{
+		rohc_packet_t packet_type;
+
+		if(!compress_pkt(comp, decomp, flow, pkt_num, &packet_type))
+		{
+			goto error;
+		}
+		pkt_types_nr[packet_type]++;
+	}
+
+	/* the flow starts with IR packets, then the smallest packets are used
+	 * once the TTL/HL does not change anymore */
+	if(pkt_types_nr[ROHC_PACKET_IR] == 0 ||
+	   pkt_types_nr[ROHC_PACKET_CO_COMMON] == 0)
+	{
+		fprintf(stderr, "flow #%d: IR and co_common packets expected\n", flow);
+		goto error;
+	}
+	if(flow == TEST_FLOW_IPV4_SEQ ||
+	   flow == TEST_FLOW_IPV4_SEQ_SWAP ||
+	   flow == TEST_FLOW_IPV4_IN_IPV4 ||
+	   flow == TEST_FLOW_IPV4_IN_IPV6)
+	{
+		if(pkt_types_nr[ROHC_PACKET_NORTP_PT_1_SEQ_ID] == 0 ||
+		   pkt_types_nr[ROHC_PACKET_NORTP_PT_2_SEQ_ID] == 0)
+		{
+			fprintf(stderr, "flow #%d: pt_1_seq_id and pt_2_seq_id packets "
+			        "expected\n", flow);
+			goto error;
+		}
+	}
+	else if(pkt_types_nr[ROHC_PACKET_PT_0_CRC3] == 0)
+	{
+		fprintf(stderr, "flow #%d: pt_0_crc3 packets expected\n", flow);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Compress and decompress one packet of one IP flow
+ *
+ * @param comp              The ROHC compressor
+ * @param decomp            The ROHC decompressor
+ * @param flow              The IP flow
+ * @param pkt_num           The number of the packet in the flow
+ * @param[out] packet_type  The type of the ROHC packet
+ * @return                  true if the packet was successfully compressed
+ *                          and decompressed, false otherwise
+ */
+static bool compress_pkt(struct rohc_comp *const comp,
+                         struct rohc_decomp *const decomp,
+                         const test_flow_t flow,
+                         const size_t pkt_num,
+                         rohc_packet_t *const packet_type)
+{
+	uint8_t ip_buffer[TEST_MAX_PKT_SIZE];
+	struct rohc_buf ip_packet =
+		rohc_buf_init_empty(ip_buffer, TEST_MAX_PKT_SIZE);
+	uint8_t rohc_buffer[TEST_MAX_PKT_SIZE];
+	struct rohc_buf rohc_packet =
+		rohc_buf_init_empty(rohc_buffer, TEST_MAX_PKT_SIZE);
+	uint8_t uncomp_buffer[TEST_MAX_PKT_SIZE];
+	struct rohc_buf uncomp_packet =
+		rohc_buf_init_empty(uncomp_buffer, TEST_MAX_PKT_SIZE);
+	rohc_comp_last_packet_info2_t info;
+
+	ip_packet.len = build_packet(flow, pkt_num, ip_buffer);
+
+	if(rohc_compress4(comp, ip_packet, &rohc_packet) != ROHC_STATUS_OK)
+	{
+		fprintf(stderr, "flow #%d: failed to compress packet #%zu\n",
+		        flow, pkt_num + 1);
+		goto error;
+	}
+	memset(&info, 0, sizeof(rohc_comp_last_packet_info2_t));
+	info.version_major = 0;
+	info.version_minor = 0;
+	if(!rohc_comp_get_last_packet_info2(comp, &info))
+	{
+		fprintf(stderr, "flow #%d: failed to get information on packet "
+		        "#%zu\n", flow, pkt_num + 1);
+		goto error;
+	}
+	fprintf(stderr, "flow #%d: packet #%zu compressed as %zu-byte %s "
+	        "packet\n", flow, pkt_num + 1, rohc_packet.len,
+	        rohc_get_packet_descr(info.packet_type));
+	if(info.profile_id != ROHCv2_PROFILE_IP)
+	{
+		fprintf(stderr, "flow #%d: packet #%zu compressed with profile 0x%04x "
+		        "instead of the ROHCv2 IP-only profile\n", flow, pkt_num + 1,
+		        info.profile_id);
+		goto error;
+	}
+	*packet_type = info.packet_type;
+
+	if(rohc_decompress3(decomp, rohc_packet, &uncomp_packet,
+	                    NULL, NULL) != ROHC_STATUS_OK)
+	{
+		fprintf(stderr, "flow #%d: failed to decompress packet #%zu\n",
+		        flow, pkt_num + 1);
+		goto error;
+	}
+	if(uncomp_packet.len != ip_packet.len ||
+	   memcmp(rohc_buf_data(uncomp_packet), rohc_buf_data(ip_packet),
+	          ip_packet.len) != 0)
+	{
+		fprintf(stderr, "flow #%d: decompressed packet #%zu does not "
+		        "match the original packet\n", flow, pkt_num + 1);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Deliver one FEEDBACK-2 to the compressor
+ *
+ * The FEEDBACK-2 of RFC 6846 is delivered for the context of the first IP
+ * flow, that uses CID 0.
+ *
+ * @param comp      The ROHC compressor
+ * @param cid_type  The type of CIDs used by the compressor
+ * @param ack_type  The type of feedback: ACK, NACK or STATIC-NACK
+ * @return          true if the feedback was successfully delivered,
+ *                  false otherwise
+ */
+static bool deliver_feedback(struct rohc_comp *const comp,
+                             const rohc_cid_type_t cid_type,
+                             const enum rohc_feedback_ack_type ack_type)
+{
+	const uint16_t msn = 0x1234;
+	uint8_t feedback_buffer[6];
+	struct rohc_buf feedback =
+		rohc_buf_init_empty(feedback_buffer, sizeof(feedback_buffer));
+
+	/* feedback header, then large CID 0 if any, then FEEDBACK-2 data */
+	feedback_buffer[feedback.len++] = 0xf0;
+	if(cid_type == ROHC_LARGE_CID)
+	{
+		feedback_buffer[feedback.len++] = 0x00;
+	}
+	feedback_buffer[feedback.len++] = (ack_type << 6) | ((msn >> 8) & 0x3f);
+	feedback_buffer[feedback.len++] = msn & 0xff;
+	feedback_buffer[feedback.len++] = 0x00; /* CRC computed below */
+	feedback_buffer[0] |= feedback.len - 1;
+	feedback_buffer[feedback.len - 1] =
+		compute_crc8(feedback_buffer + 1, feedback.len - 1);
+
+	fprintf(stderr, "flow #%d: deliver %s\n", TEST_FLOW_IPV4_SEQ,
+	        ack_type == ROHC_FEEDBACK_ACK ? "ACK" :
+	        (ack_type == ROHC_FEEDBACK_NACK ? "NACK" : "STATIC-NACK"));
+	if(!rohc_comp_deliver_feedback2(comp, feedback))
+	{
+		fprintf(stderr, "flow #%d: failed to deliver the feedback\n",
+		        TEST_FLOW_IPV4_SEQ);
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Deliver one NACK to the compressor and check the repair
+ *
+ * The next packets of the first IP flow shall be of the given type, then
+ * the compressor shall go back to smaller packets.
+ *
+ * @param comp             The ROHC compressor
+ * @param decomp           The ROHC decompressor
+ * @param cid_type         The type of CIDs used by the compressor
+ * @param ack_type         The type of NACK: NACK or STATIC-NACK
+ * @param first_pkt_num    The number of the next packet in the flow
+ * @param exp_packet_type  The type of the packets expected after the NACK
+ * @return                 true if the compressor repaired the context as
+ *                         expected, false otherwise
+ */
+static bool check_nack(struct rohc_comp *const comp,
+                       struct rohc_decomp *const decomp,
+                       const rohc_cid_type_t cid_type,
+                       const enum rohc_feedback_ack_type ack_type,
+                       const size_t first_pkt_num,
+                       const rohc_packet_t exp_packet_type)
+{
+	const test_flow_t flow = TEST_FLOW_IPV4_SEQ;
+	size_t exp_pkts_nr = 0;
+	size_t pkt_num;
+
+	if(!deliver_feedback(comp, cid_type, ack_type))
+	{
+		goto error;
+	}
+
+	for(pkt_num = first_pkt_num; pkt_num < (first_pkt_num + 10); pkt_num++)
+	{
+		rohc_packet_t packet_type;
+
+		if(!compress_pkt(comp, decomp, flow, pkt_num, &packet_type))
+		{
+			goto error;
+		}
+		if(packet_type == exp_packet_type)
+		{
+			if(exp_pkts_nr != (pkt_num - first_pkt_num))
+			{
+				fprintf(stderr, "flow #%d: packet #%zu of type %s after other "
+				        "packet types\n", flow, pkt_num + 1,
+				        rohc_get_packet_descr(packet_type));
+				goto error;
+			}
+			exp_pkts_nr++;
+		}
+	}
+
+	/* the first packets after the NACK repair the context, the next ones
+	 * do not */
+	if(exp_pkts_nr == 0 || exp_pkts_nr == 10)
+	{
+		fprintf(stderr, "flow #%d: %zu %s packets after the feedback\n", flow,
+		        exp_pkts_nr, rohc_get_packet_descr(exp_packet_type));
+		goto error;
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Compute the 8-bit CRC of one feedback
+ *
+ * @param data  The data to compute the CRC on
+ * @param len   The length of the data
+ * @return      The 8-bit CRC
+ */
+static uint8_t compute_crc8(const uint8_t *const data, const size_t len)
+{
+	uint8_t crc = 0xff;
+	size_t i;
+
+	for(i = 0; i < len; i++)
+	{
+		size_t bit;
+
+		crc ^= data[i];
+		for(bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 1) ? ((crc >> 1) ^ 0xe0) : (crc >> 1);
+		}
+	}
+
+	return crc;
+}
+
+
+/**
+ * @brief Build one IP packet of the given IP flow
+ *
+ * The TTL/HL changes at the middle of the flow. The sequential IP-ID
+ * increases by one for every packet and jumps by 5 or 15 every 20 packets,
+ * so that the IP-ID offset may be encoded on 4 or 6 bits.
+ *
+ * @param flow     The IP flow
+ * @param pkt_num  The number of the packet in the flow
+ * @param[out] buf The buffer for the packet
+ * @return         The length of the packet
+ */
+static size_t build_packet(const test_flow_t flow,
+                           const size_t pkt_num,
+                           uint8_t *const buf)
+{
+	const uint16_t seq_ip_id =
+		0x1000 + pkt_num + ((pkt_num + 20) / 40) * 5 + (pkt_num / 40) * 15;
+	const uint8_t payload_proto = 17; /* UDP, not compressed by the profile */
+	size_t len = 0;
+	size_t i;
+
+	switch(flow)
+	{
+		case TEST_FLOW_IPV4_SEQ:
+			len += build_ipv4_hdr(flow, pkt_num, seq_ip_id, true,
+			                      payload_proto, TEST_PAYLOAD_LEN, buf + len);
+			break;
+		case TEST_FLOW_IPV4_SEQ_SWAP:
+			len += build_ipv4_hdr(flow, pkt_num,
+			                      ((seq_ip_id & 0xff) << 8) | (seq_ip_id >> 8),
+			                      false, payload_proto, TEST_PAYLOAD_LEN,
+			                      buf + len);
+			break;
+		case TEST_FLOW_IPV4_RAND:
+			len += build_ipv4_hdr(flow, pkt_num, rand() & 0xffff, false,
+			                      payload_proto, TEST_PAYLOAD_LEN, buf + len);
+			break;
+		case TEST_FLOW_IPV4_ZERO:
+			len += build_ipv4_hdr(flow, pkt_num, 0, true,
+			                      payload_proto, TEST_PAYLOAD_LEN, buf + len);
+			break;
+		case TEST_FLOW_IPV6:
+			len += build_ipv6_hdr(flow, pkt_num, payload_proto,
+			                      TEST_PAYLOAD_LEN, buf + len);
+			break;
+		case TEST_FLOW_IPV4_IN_IPV4:
+			len += build_ipv4_hdr(flow, 0, 0, true, 4 /* IPv4 */,
+			                      20 + TEST_PAYLOAD_LEN, buf + len);
+			len += build_ipv4_hdr(flow, pkt_num, seq_ip_id, true,
+			                      payload_proto, TEST_PAYLOAD_LEN, buf + len);
+			break;
+		case TEST_FLOW_IPV4_IN_IPV6:
+			len += build_ipv6_hdr(flow, pkt_num, 4 /* IPv4 */,
+			                      20 + TEST_PAYLOAD_LEN, buf + len);
+			len += build_ipv4_hdr(flow, 0, seq_ip_id, true,
+			                      payload_proto, TEST_PAYLOAD_LEN, buf + len);
+			break;
+		case TEST_FLOWS_NR:
+		default:
+			assert(0);
+			break;
+	}
+
+	/* payload */
+	for(i = 0; i < TEST_PAYLOAD_LEN; i++)
+	{
+		buf[len + i] = (pkt_num + i) & 0xff;
+	}
+	len += TEST_PAYLOAD_LEN;
+
+	return len;
+}
+
+
+/**
+ * @brief Build one IPv4 header
+ *
+ * @param flow         The IP flow, it selects the source address
+ * @param pkt_num      The number of the packet in the flow
+ * @param ip_id        The IP-ID of the header
+ * @param df           Whether the Don't Fragment (DF) flag is set
+ * @param protocol     The protocol after the IPv4 header
+ * @param payload_len  The length of the IPv4 payload
+ * @param[out] buf     The buffer for the header
+ * @return             The length of the header
+ */
+static size_t build_ipv4_hdr(const test_flow_t flow,
+                             const size_t pkt_num,
+                             const uint16_t ip_id,
+                             const bool df,
+                             const uint8_t protocol,
+                             const size_t payload_len,
+                             uint8_t *const buf)
+{
+	const size_t ip_hdr_len = 20;
+	const size_t len = ip_hdr_len + payload_len;
+	uint32_t sum = 0;
+	size_t i;
+
+	buf[0] = 0x45;
+	buf[1] = 0x00;
+	buf[2] = (len >> 8) & 0xff;
+	buf[3] = len & 0xff;
+	buf[4] = (ip_id >> 8) & 0xff;
+	buf[5] = ip_id & 0xff;
+	buf[6] = (df ? 0x40 : 0x00);
+	buf[7] = 0x00;
+	buf[8] = (pkt_num < (TEST_PKTS_NR / 2) ? 64 : 63); /* TTL */
+	buf[9] = protocol;
+	buf[10] = 0x00; /* checksum computed below */
+	buf[11] = 0x00;
+	buf[12] = 192; /* source address 192.168.<flow>.1 */
+	buf[13] = 168;
+	buf[14] = flow;
+	buf[15] = 1;
+	buf[16] = 192; /* destination address 192.168.0.2 */
+	buf[17] = 168;
+	buf[18] = 0;
+	buf[19] = 2;
+	for(i = 0; i < ip_hdr_len; i += 2)
+	{
+		sum += (buf[i] << 8) | buf[i + 1];
+	}
+	while((sum >> 16) != 0)
+	{
+		sum = (sum & 0xffff) + (sum >> 16);
+	}
+	buf[10] = (~sum >> 8) & 0xff;
+	buf[11] = ~sum & 0xff;
+
+	return ip_hdr_len;
+}
+
+
+/**
+ * @brief Build one IPv6 header
+ *
+ * @param flow         The IP flow, it selects the source address
+ * @param pkt_num      The number of the packet in the flow
+ * @param next_header  The protocol after the IPv6 header
+ * @param payload_len  The length of the IPv6 payload
+ * @param[out] buf     The buffer for the header
+ * @return             The length of the header
+ */
+static size_t build_ipv6_hdr(const test_flow_t flow,
+                             const size_t pkt_num,
+                             const uint8_t next_header,
+                             const size_t payload_len,
+                             uint8_t *const buf)
+{
+	const size_t ip_hdr_len = 40;
+	size_t i;
+
+	buf[0] = 0x60; /* version 6, TC 0x0a, flow label 0x12345 */
+	buf[1] = 0xa1;
+	buf[2] = 0x23;
+	buf[3] = 0x45;
+	buf[4] = (payload_len >> 8) & 0xff;
+	buf[5] = payload_len & 0xff;
+	buf[6] = next_header;
+	buf[7] = (pkt_num < (TEST_PKTS_NR / 2) ? 64 : 63); /* Hop Limit */
+	for(i = 0; i < 16; i++)
+	{
+		buf[8 + i] = 0x20 + i;  /* source address */
+		buf[24 + i] = 0x40 + i; /* destination address */
+	}
+	buf[23] = flow;
+
+	return ip_hdr_len;
+}
+
+
+/**
+ * @brief Callback to print traces of the ROHC library
+ *
+ * @param priv_ctxt  An optional private context, may be NULL
+ * @param level      The priority level of the trace
+ * @param entity     The entity that emitted the trace among:
+ *                    \li ROHC_TRACE_COMP
+ *                    \li ROHC_TRACE_DECOMP
+ * @param profile    The ID of the ROHC compression/decompression profile
+ *                   the trace is related to
+ * @param format     The format string of the trace
+ */
+static void print_rohc_traces(void *const priv_ctxt,
+                              const rohc_trace_level_t level,
+                              const rohc_trace_entity_t entity,
+                              const int profile,
+                              const char *const format,
+                              ...)
+{
+	va_list args;
+
+	va_start(args, format);
+	vfprintf(stdout, format, args);
+	va_end(args);
+}
+
+
+/**
+ * @brief Generate a random number
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              A random number
+ */
+static int gen_random_num(const struct rohc_comp *const comp,
+                          void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return rand();
+}
@@ -62,6 +62,8 @@
 static void usage(void);
 static int test_comp_and_decomp(const size_t ip_packet_len,
                                 const size_t mrru,
+                                const bool no_copy,
+                                const bool bulk,
                                 const bool is_comp_expected_ok,
                                 const size_t expected_segments_nr);
 static void print_rohc_traces(void *const priv_ctxt,
@@ -100,7 +102,8 @@ int main(int argc, char *argv[])
 
 	/* test ROHC segments with small packet (wrt output buffer) and large MRRU
 	 * => no segmentation needed */
-	status = test_comp_and_decomp(100, TEST_MAX_ROHC_SIZE * 2, true, 0);
+	status = test_comp_and_decomp(100, TEST_MAX_ROHC_SIZE * 2, false, false,
+	                              true, 0);
 	if(status != 0)
 	{
 		goto error;
@@ -109,7 +112,15 @@ int main(int argc, char *argv[])
 	/* test ROHC segments with large packet (wrt output buffer) and large MRRU,
 	 * => segmentation needed */
 	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE,
-	                               TEST_MAX_ROHC_SIZE * 2, true, 2);
+	                               TEST_MAX_ROHC_SIZE * 2, false, false, true, 2);
+	if(status != 0)
+	{
+		goto error;
+	}
+
+	/* same test without copying the payload in the compressor */
+	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE,
+	                               TEST_MAX_ROHC_SIZE * 2, true, false, true, 2);
 	if(status != 0)
 	{
 		goto error;
@@ -117,7 +128,8 @@ int main(int argc, char *argv[])
 
 	/* test ROHC segments with large packet (wrt output buffer) and MRRU = 0,
 	 * ie. segments disabled => segmentation needed but impossible */
-	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE, 0, false, 0);
+	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE, 0, false, false, false,
+	                               0);
 	if(status != 0)
 	{
 		goto error;
@@ -126,7 +138,29 @@ int main(int argc, char *argv[])
 	/* test ROHC segments with very large packet (wrt output buffer) and large
 	 * MRRU => segmentation needed, more than 2 segments expected */
 	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE * 2,
-	                               TEST_MAX_ROHC_SIZE * 3, true, 3);
+	                               TEST_MAX_ROHC_SIZE * 3, false, false, true, 3);
+	if(status != 0)
+	{
+		goto error;
+	}
+
+	/* same test without copying the payload in the compressor */
+	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE * 2,
+	                               TEST_MAX_ROHC_SIZE * 3, true, false, true, 3);
+	if(status != 0)
+	{
+		goto error;
+	}
+
+	/* same tests with all the segments retrieved at once */
+	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE * 2,
+	                               TEST_MAX_ROHC_SIZE * 3, false, true, true, 3);
+	if(status != 0)
+	{
+		goto error;
+	}
+	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE * 2,
+	                               TEST_MAX_ROHC_SIZE * 3, true, true, true, 3);
 	if(status != 0)
 	{
 		goto error;
@@ -135,7 +169,7 @@ int main(int argc, char *argv[])
 	/* test ROHC segments with very large packet (wrt output buffer) and large
 	 * MRRU (but not large enough) => segmentation needed, but MRRU forbids it */
 	status |= test_comp_and_decomp(TEST_MAX_ROHC_SIZE * 2, TEST_MAX_ROHC_SIZE,
-	                               false, 0);
+	                               false, false, false, 0);
 	if(status != 0)
 	{
 		goto error;
@@ -168,6 +202,10 @@ static void usage(void)
  * @param ip_packet_len         The size of the IP packet to generate for the
  *                              test
  * @param mrru                  The MRRU for the test
+ * @param no_copy               Whether the compressor shall not copy the
+ *                              payload of the packets to segment
+ * @param bulk                  Whether all the segments shall be retrieved at
+ *                              once or one by one
  * @param is_comp_expected_ok   Whether compression is expected to be
  *                              successful or not?
  * @parma expected_segments_nr  The number of ROHC segments that we expect
@@ -177,6 +215,8 @@ static void usage(void)
  */
 static int test_comp_and_decomp(const size_t ip_packet_len,
                                 const size_t mrru,
+                                const bool no_copy,
+                                const bool bulk,
                                 const bool is_comp_expected_ok,
                                 const size_t expected_segments_nr)
 {
@@ -246,6 +286,14 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 		goto destroy_comp;
 	}
 
+	/* do not copy the payload of the packets to segment if asked for */
+	if(no_copy &&
+	   !rohc_comp_set_features(comp, ROHC_COMP_FEATURE_SEGMENT_NO_COPY))
+	{
+		fprintf(stderr, "failed to enable the no-copy segmentation\n");
+		goto destroy_comp;
+	}
+
 //! [set compressor MRRU]
 	/* set the MRRU at compressor */
 	if(!rohc_comp_set_mrru(comp, mrru))
@@ -340,32 +388,74 @@ static int test_comp_and_decomp(const size_t ip_packet_len,
 		        "packet\n");
 		assert(rohc_packet.len == 0);
 
-//! [segment ROHC packet #2]
-		/* get the segments */
-		while((status = rohc_comp_get_segment2(comp, &rohc_packet)) == ROHC_STATUS_SEGMENT)
+		/* get all the segments at once if asked for, then decompress the
+		 * non-final ones: the final one is decompressed below */
+		if(bulk)
 		{
-			/* new ROHC segment retrieved */
-//! [segment ROHC packet #2]
-			fprintf(stderr, "\t%zu-byte ROHC segment generated\n",
-			        rohc_packet.len);
-			segments_nr++;
-
-			/* decompress segment */
-			status = rohc_decompress3(decomp, rohc_packet, &uncomp_packet,
-			                          NULL, NULL);
-			if(status != ROHC_STATUS_OK)
+			struct rohc_buf_vec segments[3];
+			size_t bulk_nr;
+
+			bulk_nr = rohc_comp_get_segments(comp, TEST_MAX_ROHC_SIZE, segments, 3);
+			if(bulk_nr == 0)
 			{
-				fprintf(stderr, "\tfailed to decompress ROHC segment packet\n");
+				fprintf(stderr, "\tfailed to get all the ROHC segments at once\n");
 				goto destroy_decomp;
 			}
-//! [segment ROHC packet #3]
-			if(uncomp_packet.len > 0)
+			for(i = 0; i < bulk_nr; i++)
 			{
-				fprintf(stderr, "\tdecompression of ROHC segment succeeded while "
-				        "it should have not\n");
-				goto destroy_decomp;
+				rohc_packet.len = 0;
+				if(!rohc_buf_vec_linearize(&segments[i], &rohc_packet))
+				{
+					fprintf(stderr, "\tfailed to copy ROHC segment #%zu\n", i + 1);
+					goto destroy_decomp;
+				}
+				if((i + 1) == bulk_nr)
+				{
+					break;
+				}
+				fprintf(stderr, "\t%zu-byte ROHC segment retrieved at once\n",
+				        rohc_packet.len);
+				segments_nr++;
+
+				status = rohc_decompress3(decomp, rohc_packet, &uncomp_packet,
+				                          NULL, NULL);
+				if(status != ROHC_STATUS_OK || uncomp_packet.len > 0)
+				{
+					fprintf(stderr, "\tunexpected decompression of ROHC segment\n");
+					goto destroy_decomp;
+				}
+			}
+			status = ROHC_STATUS_OK;
+		}
+		else
+		{
+//! [segment ROHC packet #2]
+			/* get the segments */
+			while((status = rohc_comp_get_segment2(comp, &rohc_packet)) == ROHC_STATUS_SEGMENT)
+			{
+				/* new ROHC segment retrieved */
+//! [segment ROHC packet #2]
+				fprintf(stderr, "\t%zu-byte ROHC segment generated\n",
+				        rohc_packet.len);
+				segments_nr++;
+
+				/* decompress segment */
+				status = rohc_decompress3(decomp, rohc_packet, &uncomp_packet,
+				                          NULL, NULL);
+				if(status != ROHC_STATUS_OK)
+				{
+					fprintf(stderr, "\tfailed to decompress ROHC segment packet\n");
+					goto destroy_decomp;
+				}
+//! [segment ROHC packet #3]
+				if(uncomp_packet.len > 0)
+				{
+					fprintf(stderr, "\tdecompression of ROHC segment succeeded while "
+					        "it should have not\n");
+					goto destroy_decomp;
+				}
+				rohc_packet.len = 0;
 			}
-			rohc_packet.len = 0;
 		}
 		if(status != ROHC_STATUS_OK)
 		{
@@ -24,6 +24,12 @@
  *
  * Test the ROHC decompression performed by the ROHC library with a flow of
  * ROHC packets that were generated by another ROHC implementation.
+ *
+ * With the --bench option, the flow is then replayed several times to compare
+ * the library with the other implementation: the decompression of the ROHC
+ * packets of the other implementation and the compression of the reference
+ * uncompressed packets by the library are timed, and the bytes on the wire
+ * and the CPU time per packet of both ROHC flows are reported side by side.
  */
 
 #include "test.h"
@@ -43,6 +49,7 @@
 #include <errno.h>
 #include <assert.h>
 #include <stdarg.h>
+#include <time.h>
 
 /* includes for network headers */
 #include <protocols/ipv4.h>
@@ -64,6 +71,18 @@ for ./configure ? If yes, check configure output and config.log"
 #include <rohc_comp.h>
 #include <rohc_decomp.h>
 
+/* load the captures in memory for the benchmark */
+#include "test_capture.h"
+
+
+/** The results of one ROHC flow for the throughput comparison */
+struct bench_flow
+{
+	size_t bytes;        /**< The number of bytes on the wire per round */
+	uint64_t comp_ns;    /**< The CPU time spent in compression, 0 if none */
+	uint64_t decomp_ns;  /**< The CPU time spent in decompression, 0 if none */
+};
+
 
 /* prototypes of private functions */
 static void usage(void);
@@ -81,10 +100,43 @@ static int test_decomp_one(struct rohc_decomp *const decomp,
                            const size_t cmp_size,
                            const size_t link_len_cmp);
 
+static int bench_all(const rohc_cid_type_t cid_type,
+                     const size_t wlsb_width,
+                     const size_t max_contexts,
+                     const char *const src_filename,
+                     const char *const cmp_filename,
+                     const size_t rounds)
+	__attribute__((warn_unused_result, nonnull(4, 5)));
+static bool bench_decomp_flow(const rohc_cid_type_t cid_type,
+                              const size_t max_contexts,
+                              const struct rohc_buf *const rohc_pkts,
+                              const size_t pkts_nr,
+                              uint64_t *const decomp_ns)
+	__attribute__((warn_unused_result, nonnull(3, 5)));
+static void bench_print_flow(const char *const descr,
+                             const struct bench_flow *const flow,
+                             const size_t pkts_nr,
+                             const size_t rounds)
+	__attribute__((nonnull(1, 2)));
+static bool get_ip_packet(const struct test_capture_pkt *const pkt,
+                          const size_t link_len,
+                          struct rohc_buf *const ip_packet)
+	__attribute__((warn_unused_result, nonnull(1, 3)));
+static inline uint64_t bench_get_cpu_ns(void)
+	__attribute__((warn_unused_result));
+
+static struct rohc_comp * create_compressor(const rohc_cid_type_t cid_type,
+                                            const size_t wlsb_width,
+                                            const size_t max_contexts)
+	__attribute__((warn_unused_result));
 static struct rohc_decomp * create_decompressor(const rohc_cid_type_t cid_type,
                                                 const size_t max_contexts)
 	__attribute__((warn_unused_result));
 
+static int gen_false_random_num(const struct rohc_comp *const comp,
+                                void *const user_context)
+	__attribute__((nonnull(1)));
+
 static void print_rohc_traces(void *const priv_ctxt,
                               const rohc_trace_level_t level,
                               const rohc_trace_entity_t entity,
@@ -127,6 +179,7 @@ int main(int argc, char *argv[])
 	char *cmp_filename = NULL;
 	int max_contexts = ROHC_SMALL_CID_MAX + 1;
 	int wlsb_width = 4;
+	int bench_rounds = 0;
 	int status = 1;
 	rohc_cid_type_t cid_type;
 	int args_used;
@@ -199,6 +252,26 @@ int main(int argc, char *argv[])
 			wlsb_width = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--bench"))
+		{
+			/* get the number of times the flow shall be replayed to compare the
+			 * library with the other implementation */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --bench takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			bench_rounds = atoi(argv[1]);
+			if(bench_rounds <= 0)
+			{
+				fprintf(stderr, "invalid number of rounds %d for --bench: should be "
+				        "a positive integer\n\n", bench_rounds);
+				usage();
+				goto error;
+			}
+			args_used++;
+		}
 		else if(cid_type_name == NULL)
 		{
 			/* get the type of CID to use within the ROHC library */
@@ -273,10 +346,27 @@ int main(int argc, char *argv[])
 		goto error;
 	}
 
+	/* the benchmark compresses the reference uncompressed packets */
+	if(bench_rounds > 0 && cmp_filename == NULL)
+	{
+		fprintf(stderr, "option --bench requires the uncompressed packets of "
+		        "option -c\n\n");
+		usage();
+		goto error;
+	}
+
 	/* test ROHC decompression with the packets from the file */
 	status = test_decomp_all(cid_type, wlsb_width, max_contexts,
 	                         src_filename, cmp_filename);
 
+	/* compare the library with the other implementation, only if the library
+	 * decompressed all the packets of the other implementation correctly */
+	if(status == 0 && bench_rounds > 0)
+	{
+		status = bench_all(cid_type, wlsb_width, max_contexts,
+		                   src_filename, cmp_filename, bench_rounds);
+	}
+
 error:
 	return status;
 }
@@ -307,6 +397,10 @@ static void usage(void)
 	        "  --max-contexts NUM      The maximum number of ROHC contexts to\n"
 	        "                          simultaneously use during the test\n"
 	        "  --wlsb-width NUM        The width of the WLSB window to use\n"
+	        "  --bench ROUNDS          Replay the flow ROUNDS times to compare the\n"
+	        "                          bytes on the wire and the CPU time per\n"
+	        "                          packet of the library with the other\n"
+	        "                          implementation (requires -c)\n"
 	        "  -v, --verbose           Run the test in verbose mode\n");
 }
 
@@ -736,6 +830,447 @@ error:
 }
 
 
+/**
+ * @brief Compare the ROHC library with another ROHC implementation
+ *
+ * The two captures are loaded in memory, then they are replayed \e rounds
+ * times with new compressors and decompressors at every round:
+ *  \li the ROHC packets generated by the other implementation are
+ *      decompressed,
+ *  \li the reference uncompressed packets are compressed by the library,
+ *  \li the ROHC packets generated by the library are decompressed.
+ *
+ * Only the CPU time spent in the library is accounted, the creation and the
+ * destruction of the compressors and decompressors are not.
+ *
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param wlsb_width    The width of the WLSB window to use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @param src_filename  The name of the PCAP file that contains the
+ *                      ROHC packets of the other implementation
+ * @param cmp_filename  The name of the PCAP file that contains the
+ *                      reference uncompressed packets
+ * @param rounds        The number of times the flow is replayed
+ * @return              0 in case of success,
+ *                      1 in case of failure
+ */
+static int bench_all(const rohc_cid_type_t cid_type,
+                     const size_t wlsb_width,
+                     const size_t max_contexts,
+                     const char *const src_filename,
+                     const char *const cmp_filename,
+                     const size_t rounds)
+{
+	char errbuf[TEST_CAPTURE_ERRBUF_SIZE];
+	struct test_capture src_capture;
+	struct test_capture cmp_capture;
+	struct rohc_buf *other_pkts;
+	struct rohc_buf *ip_pkts;
+	struct rohc_buf *lib_pkts;
+	uint8_t *lib_pkts_buf = NULL;
+	size_t lib_pkts_buf_len = 0;
+	size_t pkts_nr;
+
+	struct bench_flow uncomp_flow = { .bytes = 0, .comp_ns = 0, .decomp_ns = 0 };
+	struct bench_flow other_flow = { .bytes = 0, .comp_ns = 0, .decomp_ns = 0 };
+	struct bench_flow lib_flow = { .bytes = 0, .comp_ns = 0, .decomp_ns = 0 };
+
+	uint8_t rohc_buffer[MAX_ROHC_SIZE];
+	size_t round;
+	size_t i;
+	int status = 1;
+
+	printf("=== benchmark: start\n");
+
+	/* load the two captures in memory */
+	if(!test_capture_load(&src_capture, src_filename, errbuf))
+	{
+		printf("failed to load the source capture: %s\n", errbuf);
+		goto error;
+	}
+	if(!test_capture_load(&cmp_capture, cmp_filename, errbuf))
+	{
+		printf("failed to load the comparison capture: %s\n", errbuf);
+		goto unload_src;
+	}
+	if(src_capture.pkts_nr == 0 || src_capture.pkts_nr != cmp_capture.pkts_nr)
+	{
+		printf("the source and comparison captures shall contain the same "
+		       "non-zero number of packets (%zu != %zu)\n",
+		       src_capture.pkts_nr, cmp_capture.pkts_nr);
+		goto unload_cmp;
+	}
+	pkts_nr = src_capture.pkts_nr;
+
+	/* index the ROHC and IP packets without their link layer headers */
+	other_pkts = calloc(3 * pkts_nr, sizeof(struct rohc_buf));
+	if(other_pkts == NULL)
+	{
+		printf("failed to allocate memory for the packets\n");
+		goto unload_cmp;
+	}
+	ip_pkts = other_pkts + pkts_nr;
+	lib_pkts = ip_pkts + pkts_nr;
+	for(i = 0; i < pkts_nr; i++)
+	{
+		const struct test_capture_pkt *const src_pkt = &(src_capture.pkts[i]);
+		const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+		const struct rohc_buf src_frame =
+			rohc_buf_init_full(src_pkt->data, src_pkt->caplen, arrival_time);
+
+		/* the correctness test already checked the ROHC packets */
+		other_pkts[i] = src_frame;
+		rohc_buf_pull(&other_pkts[i], src_capture.link_len);
+		other_flow.bytes += other_pkts[i].len;
+
+		if(!get_ip_packet(&(cmp_capture.pkts[i]), cmp_capture.link_len,
+		                  &ip_pkts[i]))
+		{
+			printf("bad uncompressed packet #%zu (len = %u, caplen = %u)\n",
+			       i + 1, cmp_capture.pkts[i].len, cmp_capture.pkts[i].caplen);
+			goto free_pkts;
+		}
+		uncomp_flow.bytes += ip_pkts[i].len;
+	}
+
+	for(round = 0; round < rounds; round++)
+	{
+		struct rohc_comp *comp;
+		uint64_t decomp_ns;
+
+		/* decompress the ROHC packets of the other implementation */
+		if(!bench_decomp_flow(cid_type, max_contexts, other_pkts, pkts_nr,
+		                      &decomp_ns))
+		{
+			printf("failed to decompress the ROHC flow of the other "
+			       "implementation\n");
+			goto free_lib_pkts;
+		}
+		other_flow.decomp_ns += decomp_ns;
+
+		/* compress the uncompressed packets with the library */
+		comp = create_compressor(cid_type, wlsb_width, max_contexts);
+		if(comp == NULL)
+		{
+			printf("failed to create the compressor\n");
+			goto free_lib_pkts;
+		}
+		for(i = 0; i < pkts_nr; i++)
+		{
+			struct rohc_buf rohc_packet =
+				rohc_buf_init_empty(rohc_buffer, MAX_ROHC_SIZE);
+			const uint64_t start_ns = bench_get_cpu_ns();
+			rohc_status_t ret;
+
+			ret = rohc_compress4(comp, ip_pkts[i], &rohc_packet);
+			lib_flow.comp_ns += bench_get_cpu_ns() - start_ns;
+			if(ret != ROHC_STATUS_OK)
+			{
+				printf("failed to compress packet #%zu\n", i + 1);
+				rohc_comp_free(comp);
+				goto free_lib_pkts;
+			}
+
+			/* the compressor generates the same ROHC flow at every round, keep
+			 * the one of the first round to decompress it */
+			if(round == 0)
+			{
+				uint8_t *const new_buf =
+					realloc(lib_pkts_buf, lib_pkts_buf_len + rohc_packet.len);
+				if(new_buf == NULL)
+				{
+					printf("failed to allocate memory for ROHC packet #%zu\n", i + 1);
+					rohc_comp_free(comp);
+					goto free_lib_pkts;
+				}
+				lib_pkts_buf = new_buf;
+				memcpy(lib_pkts_buf + lib_pkts_buf_len, rohc_buf_data(rohc_packet),
+				       rohc_packet.len);
+				lib_pkts[i].offset = lib_pkts_buf_len;
+				lib_pkts[i].len = rohc_packet.len;
+				lib_pkts_buf_len += rohc_packet.len;
+				lib_flow.bytes += rohc_packet.len;
+			}
+		}
+		rohc_comp_free(comp);
+
+		/* the buffer may move while it grows during the first round */
+		if(round == 0)
+		{
+			for(i = 0; i < pkts_nr; i++)
+			{
+				lib_pkts[i].data = lib_pkts_buf;
+				lib_pkts[i].max_len = lib_pkts_buf_len;
+			}
+		}
+
+		/* decompress the ROHC packets of the library */
+		if(!bench_decomp_flow(cid_type, max_contexts, lib_pkts, pkts_nr,
+		                      &decomp_ns))
+		{
+			printf("failed to decompress the ROHC flow of the library\n");
+			goto free_lib_pkts;
+		}
+		lib_flow.decomp_ns += decomp_ns;
+	}
+
+	/* report the ROHC flows side by side */
+	printf("=== benchmark: %zu rounds of %zu packets\n", rounds, pkts_nr);
+	printf("===\t%-14s %10s %14s %16s %18s\n", "flow", "bytes",
+	       "bytes/packet", "comp ns/packet", "decomp ns/packet");
+	bench_print_flow("uncompressed", &uncomp_flow, pkts_nr, rounds);
+	bench_print_flow("other ROHC", &other_flow, pkts_nr, rounds);
+	bench_print_flow("ROHC library", &lib_flow, pkts_nr, rounds);
+	printf("=== benchmark: success\n");
+	printf("\n");
+
+	status = 0;
+
+free_lib_pkts:
+	free(lib_pkts_buf);
+free_pkts:
+	free(other_pkts);
+unload_cmp:
+	test_capture_unload(&cmp_capture);
+unload_src:
+	test_capture_unload(&src_capture);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Decompress one ROHC flow with a new decompressor
+ *
+ * @param cid_type        The type of CIDs the decompressor shall use
+ * @param max_contexts    The maximum number of ROHC contexts to use
+ * @param rohc_pkts       The ROHC packets to decompress
+ * @param pkts_nr         The number of ROHC packets to decompress
+ * @param[out] decomp_ns  The CPU time spent in decompression (in ns)
+ * @return                true if all the packets were decompressed,
+ *                        false otherwise
+ */
+static bool bench_decomp_flow(const rohc_cid_type_t cid_type,
+                              const size_t max_contexts,
+                              const struct rohc_buf *const rohc_pkts,
+                              const size_t pkts_nr,
+                              uint64_t *const decomp_ns)
+{
+	uint8_t uncomp_buffer[MAX_ROHC_SIZE];
+	struct rohc_decomp *decomp;
+	size_t i;
+
+	decomp = create_decompressor(cid_type, max_contexts);
+	if(decomp == NULL)
+	{
+		printf("failed to create the decompressor\n");
+		goto error;
+	}
+
+	*decomp_ns = 0;
+	for(i = 0; i < pkts_nr; i++)
+	{
+		struct rohc_buf uncomp_packet =
+			rohc_buf_init_empty(uncomp_buffer, MAX_ROHC_SIZE);
+		const uint64_t start_ns = bench_get_cpu_ns();
+		rohc_status_t ret;
+
+		ret = rohc_decompress3(decomp, rohc_pkts[i], &uncomp_packet, NULL, NULL);
+		*decomp_ns += bench_get_cpu_ns() - start_ns;
+		if(ret != ROHC_STATUS_OK)
+		{
+			printf("failed to decompress packet #%zu\n", i + 1);
+			goto free_decomp;
+		}
+	}
+
+	rohc_decomp_free(decomp);
+	return true;
+
+free_decomp:
+	rohc_decomp_free(decomp);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Print the results of one flow of the benchmark
+ *
+ * @param descr    The description of the flow
+ * @param flow     The results of the flow
+ * @param pkts_nr  The number of packets of the flow
+ * @param rounds   The number of times the flow was replayed
+ */
+static void bench_print_flow(const char *const descr,
+                             const struct bench_flow *const flow,
+                             const size_t pkts_nr,
+                             const size_t rounds)
+{
+	const double timed_pkts_nr = ((double) pkts_nr) * rounds;
+	char comp_ns[32];
+	char decomp_ns[32];
+
+	/* the uncompressed flow is not timed and the flow of the other
+	 * implementation was not compressed on this host */
+	if(flow->comp_ns > 0)
+	{
+		snprintf(comp_ns, sizeof(comp_ns), "%.1f", flow->comp_ns / timed_pkts_nr);
+	}
+	else
+	{
+		snprintf(comp_ns, sizeof(comp_ns), "-");
+	}
+	if(flow->decomp_ns > 0)
+	{
+		snprintf(decomp_ns, sizeof(decomp_ns), "%.1f",
+		         flow->decomp_ns / timed_pkts_nr);
+	}
+	else
+	{
+		snprintf(decomp_ns, sizeof(decomp_ns), "-");
+	}
+
+	printf("===\t%-14s %10zu %14.1f %16s %18s\n", descr, flow->bytes,
+	       ((double) flow->bytes) / pkts_nr, comp_ns, decomp_ns);
+}
+
+
+/**
+ * @brief Get the IP packet of one captured frame
+ *
+ * Skip the link layer header and the Ethernet padding after the IP packet.
+ *
+ * @param pkt            The captured frame (link layer included)
+ * @param link_len       The length of the link layer header before IP data
+ * @param[out] ip_packet The IP packet
+ * @return               true if the frame contains one IP packet,
+ *                       false if the frame is malformed
+ */
+static bool get_ip_packet(const struct test_capture_pkt *const pkt,
+                          const size_t link_len,
+                          struct rohc_buf *const ip_packet)
+{
+	const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+	const struct rohc_buf frame =
+		rohc_buf_init_full(pkt->data, pkt->caplen, arrival_time);
+
+	/* check frame length */
+	if(pkt->len <= link_len || pkt->len != pkt->caplen)
+	{
+		goto error;
+	}
+
+	/* skip the link layer header */
+	*ip_packet = frame;
+	rohc_buf_pull(ip_packet, link_len);
+
+	/* check for padding after the IP packet in the Ethernet payload */
+	if(link_len == ETHER_HDR_LEN && pkt->len == ETHER_FRAME_MIN_LEN)
+	{
+		uint8_t version;
+		uint16_t tot_len;
+
+		version = (rohc_buf_byte(*ip_packet) >> 4) & 0x0f;
+		if(version == 4)
+		{
+			const struct ipv4_hdr *const ip =
+				(struct ipv4_hdr *) rohc_buf_data(*ip_packet);
+			tot_len = ntohs(ip->tot_len);
+		}
+		else
+		{
+			const struct ipv6_hdr *const ip =
+				(struct ipv6_hdr *) rohc_buf_data(*ip_packet);
+			tot_len = sizeof(struct ipv6_hdr) + ntohs(ip->plen);
+		}
+
+		if(tot_len < ip_packet->len)
+		{
+			/* the Ethernet frame has some bytes of padding after the IP packet */
+			ip_packet->len = tot_len;
+		}
+	}
+
+	return true;
+
+error:
+	return false;
+}
+
+
+/**
+ * @brief Get the CPU time consumed by the process
+ *
+ * @return  The CPU time (in ns)
+ */
+static inline uint64_t bench_get_cpu_ns(void)
+{
+	struct timespec now;
+
+	if(clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now) != 0)
+	{
+		return 0;
+	}
+	return ((uint64_t) now.tv_sec) * 1000000000U + now.tv_nsec;
+}
+
+
+/**
+ * @brief Create and configure a ROHC compressor
+ *
+ * @param cid_type      The type of CIDs the compressor shall use
+ * @param wlsb_width    The width of the WLSB window to use
+ * @param max_contexts  The maximum number of ROHC contexts to use
+ * @return              The new ROHC compressor
+ */
+static struct rohc_comp * create_compressor(const rohc_cid_type_t cid_type,
+                                            const size_t wlsb_width,
+                                            const size_t max_contexts)
+{
+	struct rohc_comp *comp;
+
+	/* create the compressor */
+	comp = rohc_comp_new2(cid_type, max_contexts - 1, gen_false_random_num, NULL);
+	if(comp == NULL)
+	{
+		printf("failed to create compressor\n");
+		goto error;
+	}
+
+	/* set the callback for traces */
+	if(!rohc_comp_set_traces_cb2(comp, print_rohc_traces, NULL))
+	{
+		printf("failed to set trace callback\n");
+		goto destroy_comp;
+	}
+
+	/* enable compression profiles */
+	if(!rohc_comp_enable_profiles(comp, ROHC_PROFILE_UNCOMPRESSED,
+	                              ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                              ROHC_PROFILE_UDPLITE, ROHC_PROFILE_RTP,
+	                              ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		printf("failed to enable the profiles\n");
+		goto destroy_comp;
+	}
+
+	/* set the WLSB window width */
+	if(!rohc_comp_set_wlsb_window_width(comp, wlsb_width))
+	{
+		printf("failed to set the WLSB window width\n");
+		goto destroy_comp;
+	}
+
+	return comp;
+
+destroy_comp:
+	rohc_comp_free(comp);
+error:
+	return NULL;
+}
+
+
 /**
  * @brief Create and configure a ROHC decompressor
  *
@@ -782,6 +1317,25 @@ error:
 }
 
 
+/**
+ * @brief Generate a false random number for testing the ROHC library
+ *
+ * The compressor then generates the same ROHC flow at every round of the
+ * benchmark.
+ *
+ * @param comp          The ROHC compressor
+ * @param user_context  Should always be NULL
+ * @return              Always 0
+ */
+static int gen_false_random_num(const struct rohc_comp *const comp,
+                                void *const user_context)
+{
+	assert(comp != NULL);
+	assert(user_context == NULL);
+	return 0;
+}
+
+
 /**
  * @brief Callback to print traces of the ROHC library
  *
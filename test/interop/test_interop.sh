@@ -29,9 +29,12 @@
 #            test library with (separators '/' are replaced by '_')
 #
 # Script arguments:
-#    test_interop_STREAM.sh [verbose]
+#    test_interop_STREAM.sh [verbose|bench [ROUNDS]]
 # where:
 #   verbose          prints the traces of test application
+#   bench            compares the bytes on the wire and the CPU time per
+#                    packet of the library with the other implementation,
+#                    the flow is replayed ROUNDS times (default: 1000)
 #
 
 # skip test in case of cross-compilation
@@ -48,6 +51,7 @@ test -z "${AWK}" && AWK="`which awk`"
 # parse arguments
 SCRIPT="$0"
 VERBOSE="$1"
+BENCH_ROUNDS="${2:-1000}"
 if [ "x$MAKELEVEL" != "x" ] ; then
 	BASEDIR="${srcdir}"
 	APP="./test_interop${CROSS_COMPILATION_EXEEXT}"
@@ -83,9 +87,17 @@ fi
 CMD="${CROSS_COMPILATION_EMULATOR} ${APP} -c ${CAPTURE_COMPARE}"
 if [ "${VERBOSE}" = "verbose" ] ; then
 	CMD="${CMD} --verbose"
+elif [ "${VERBOSE}" = "bench" ] ; then
+	CMD="${CMD} --bench ${BENCH_ROUNDS}"
 fi
 CMD="${CMD} smallcid ${CAPTURE_SOURCE}"
 
+# the benchmark is not run under valgrind
+if [ "${VERBOSE}" = "bench" ] ; then
+	${CMD}
+	exit $?
+fi
+
 # source valgrind-related functions
 . ${BASEDIR}/../valgrind.sh
 
@@ -71,6 +71,17 @@
  * The program optionally compares the ROHC packets generated with the ones
  * given as input to the program.
  *
+ * Digests
+ * -------
+ *
+ * With the --digest option, the ROHC packets generated are checked against
+ * the digests stored in a small text file instead: one line per ROHC packet
+ * with the FNV-1a hash of the packet and the rolling hash of all the packets
+ * up to it. The capture of the reference ROHC packets is loaded only if one
+ * digest does not match, to compare the packet byte per byte and print the
+ * differences. The --digest-output option writes the digests of the ROHC
+ * packets generated.
+ *
  * Output
  * ------
  *
@@ -80,6 +91,22 @@
  * comparison and shutdown).
  *
  * The program optionally outputs the ROHC packets in a PCAP packet.
+ *
+ * Batch mode
+ * ----------
+ *
+ * With the --batch option, the program runs all the tests listed in a file,
+ * several of them at the same time in worker processes. Every test is run
+ * in its own process, so that a crash does not stop the other tests. The
+ * result of every test is printed as soon as it ends, then a summary of all
+ * the tests.
+ *
+ * Timing
+ * ------
+ *
+ * With the --timing option, the program measures the time spent in the
+ * compression and decompression functions of the library and prints the
+ * resulting packet rates, for every test in batch mode.
  */
 
 #include "test.h"
@@ -99,12 +126,26 @@
 #include <errno.h>
 #include <assert.h>
 #include <stdarg.h>
+#include <time.h>
+#include <inttypes.h>
+#if HAVE_UNISTD_H == 1
+#  include <unistd.h>
+#endif
+#if HAVE_SYS_WAIT_H == 1 && HAVE_SYS_MMAN_H == 1
+#  include <sys/types.h>
+#  include <sys/wait.h>
+#  include <sys/mman.h>
+#endif
 
 /* includes for network headers */
 #include <protocols/ipv4.h>
 #include <protocols/ipv6.h>
 #include <protocols/udp.h>
 
+/* the PCAP captures are loaded in memory, libpcap only writes the output
+ * capture */
+#include "test_capture.h"
+
 /* include for the PCAP library */
 #if HAVE_PCAP_PCAP_H == 1
 #  include <pcap/pcap.h>
@@ -123,6 +164,92 @@ for ./configure ? If yes, check configure output and config.log"
 /** The maximum number of source PCAP dump files */
 #define SRC_FILENAMES_MAX_NR  2U
 
+/** The maximum length of the paths of the captures in batch mode */
+#define BATCH_PATH_MAX_LEN  1024U
+
+/** The maximum number of worker processes in batch mode */
+#define BATCH_JOBS_MAX_NR  256U
+
+/** The initial value of the FNV-1a hashes of the digests */
+#define TEST_DIGEST_INIT  0xcbf29ce484222325ULL
+
+/** The FNV-1a prime of the digests */
+#define TEST_DIGEST_PRIME  0x100000001b3ULL
+
+
+/** The time spent in the ROHC library and the packets that went through it */
+struct test_timing
+{
+	uint64_t comp_ns;        /**< The time spent compressing (in ns) */
+	size_t comp_pkts_nr;     /**< The number of compressed packets */
+	size_t comp_bytes;       /**< The number of bytes before compression */
+	uint64_t decomp_ns;      /**< The time spent decompressing (in ns) */
+	size_t decomp_pkts_nr;   /**< The number of decompressed packets */
+	size_t decomp_bytes;     /**< The number of bytes after decompression */
+};
+
+
+/** The digests of one ROHC packet */
+struct test_digest
+{
+	uint64_t pkt;       /**< The hash of the ROHC packet */
+	uint64_t rolling;   /**< The hash of all the ROHC packets up to this one */
+};
+
+
+/** The digests of the ROHC packets of one test */
+struct test_digests
+{
+	/** The digests to check the ROHC packets against, NULL if not checked */
+	struct test_digest *pkts;
+	/** The number of digests to check the ROHC packets against */
+	size_t pkts_nr;
+	/** The number of ROHC packets generated so far */
+	size_t pkt_id;
+	/** The rolling hash of the ROHC packets generated so far */
+	uint64_t rolling;
+	/** The file to write the digests of the ROHC packets in, NULL if none */
+	FILE *output;
+
+	/** The capture to compare the ROHC packets with if one digest does not
+	 *  match, NULL if none */
+	const char *cmp_filename;
+	/** The capture to compare the ROHC packets with, loaded on mismatch */
+	struct test_capture cmp_capture;
+	/** Whether the capture to compare the ROHC packets with was loaded */
+	bool is_cmp_loaded;
+};
+
+
+/** One test of a batch */
+struct batch_test
+{
+	/** The type of CID to use */
+	rohc_cid_type_t cid_type;
+	/** The name of the type of CID */
+	char cid_type_name[10];
+	/** The maximum number of ROHC contexts to use */
+	int max_contexts;
+	/** The width of the WLSB window to use */
+	int wlsb_width;
+	/** The capture with the packets to compress/decompress */
+	char src_filename[BATCH_PATH_MAX_LEN];
+	/** The capture with the ROHC packets to compare with */
+	char cmp_filename[BATCH_PATH_MAX_LEN];
+	/** The digests of the ROHC packets to compare with, empty if none */
+	char digest_filename[BATCH_PATH_MAX_LEN];
+};
+
+
+/** The result of one test of a batch, shared with the worker process */
+struct batch_result
+{
+	/** The exit code of the test */
+	int status;
+	/** The timing of the test */
+	struct test_timing timing;
+};
+
 /** print text on console if not in quiet mode */
 #define trace(format, ...) \
 	do { \
@@ -142,7 +269,9 @@ static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
                                 const size_t src_filenames_nr,
                                 char *ofilename,
                                 char *cmp_filename,
-                                const char *rohc_size_ofilename);
+                                const char *rohc_size_ofilename,
+                                const char *const digest_filename,
+                                const char *const digest_ofilename);
 static int compress_decompress(struct rohc_comp *comp,
                                struct rohc_decomp *decomp,
                                struct rohc_comp *const comp_associated,
@@ -158,6 +287,7 @@ static int compress_decompress(struct rohc_comp *comp,
                                int cmp_size,
                                int link_len_cmp,
                                FILE *size_output_file,
+                               struct test_digests *const digests,
                                const struct rohc_buf feedback_send_by_me,
                                struct rohc_buf *const feedback_send_by_other);
 
@@ -188,18 +318,18 @@ static bool rohc_comp_rtp_cb(const unsigned char *const ip,
                              void *const rtp_private)
 	__attribute__((warn_unused_result));
 
-static pcap_t * open_pcap_file(const char *const descr,
-                               const char *const filename,
-                               size_t *const link_len)
+static bool open_pcap_file(const char *const descr,
+                           const char *const filename,
+                           struct test_capture *const capture)
 	__attribute__((nonnull(1, 2, 3), warn_unused_result));
-static bool get_next_packet(pcap_t **const pcap_handle,
+static bool get_next_packet(struct test_capture *const capture,
+                            size_t *const pkt_id,
                             const char *const src_filenames[],
                             const size_t src_filenames_nr,
                             size_t *const src_filenames_id,
                             struct pcap_pkthdr *const header,
-                            size_t *const link_len,
                             const uint8_t **const packet)
-	__attribute__((nonnull(1, 2, 4, 5, 6, 7), warn_unused_result));
+	__attribute__((nonnull(1, 2, 3, 5, 6, 7), warn_unused_result));
 
 static void show_rohc_stats(struct rohc_comp *comp1, struct rohc_decomp *decomp1,
                             struct rohc_comp *comp2, struct rohc_decomp *decomp2);
@@ -219,6 +349,45 @@ static void show_rohc_decomp_profile(const struct rohc_decomp *const decomp,
 static int compare_packets(unsigned char *pkt1, int pkt1_size,
                            unsigned char *pkt2, int pkt2_size);
 
+static uint64_t test_digest_hash(uint64_t hash,
+                                 const uint8_t *const data,
+                                 const size_t len)
+	__attribute__((warn_unused_result, nonnull(2)));
+static uint64_t test_digest_roll(const uint64_t rolling, const uint64_t pkt)
+	__attribute__((warn_unused_result));
+static bool load_digests(const char *const filename,
+                         struct test_digests *const digests)
+	__attribute__((warn_unused_result, nonnull(1, 2)));
+static bool compare_digests(struct test_digests *const digests,
+                            const uint64_t pkt_digest,
+                            const struct rohc_buf rohc_packet,
+                            const bool no_comparison)
+	__attribute__((warn_unused_result, nonnull(1)));
+
+static inline uint64_t test_get_ns(void)
+	__attribute__((warn_unused_result));
+static void print_timing(const struct test_timing *const test_timing)
+	__attribute__((nonnull(1)));
+
+#if HAVE_SYS_WAIT_H == 1 && HAVE_SYS_MMAN_H == 1
+static int run_batch(const char *const batch_filename,
+                     const size_t jobs_nr,
+                     const bool no_comparison,
+                     const bool ignore_malformed,
+                     const bool update_digests)
+	__attribute__((nonnull(1), warn_unused_result));
+static bool load_batch(const char *const batch_filename,
+                       struct batch_test **const tests,
+                       size_t *const tests_nr)
+	__attribute__((nonnull(1, 2, 3), warn_unused_result));
+static int run_batch_test(const struct batch_test *const test,
+                          const bool no_comparison,
+                          const bool ignore_malformed,
+                          const bool update_digests,
+                          struct test_timing *const test_timing)
+	__attribute__((nonnull(1, 5), warn_unused_result));
+#endif
+
 
 /** Whether the application runs in verbose mode or not */
 static enum
@@ -231,6 +400,12 @@ static enum
 /** The number of warnings emitted by the ROHC library */
 static size_t nr_rohc_warnings = 0;
 
+/** Whether to measure the time spent in the ROHC library or not */
+static bool do_timing = false;
+
+/** The time spent in the ROHC library during the test */
+static struct test_timing timing;
+
 
 /**
  * @brief Main function for the ROHC test program
@@ -250,6 +425,11 @@ int main(int argc, char *argv[])
 	char *src_filenames[SRC_FILENAMES_MAX_NR] = { NULL };
 	char *ofilename = NULL;
 	char *cmp_filename = NULL;
+	char *digest_filename = NULL;
+	char *digest_ofilename = NULL;
+	char *batch_filename = NULL;
+	bool update_digests = false;
+	int jobs_nr = 0;
 	int max_contexts = ROHC_SMALL_CID_MAX + 1;
 	int wlsb_width = 4;
 	bool no_comparison = false;
@@ -323,6 +503,37 @@ int main(int argc, char *argv[])
 			cmp_filename = argv[1];
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--digest"))
+		{
+			/* get the name of the file where the digests of the ROHC packets
+			 * used for comparison are stored */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --digest takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			digest_filename = argv[1];
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--digest-output"))
+		{
+			/* get the name of the file to store the digests of the ROHC
+			 * packets */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --digest-output takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			digest_ofilename = argv[1];
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--update-digests"))
+		{
+			/* write the digests of the ROHC packets in batch mode */
+			update_digests = true;
+		}
 		else if(!strcmp(*argv, "--no-comparison"))
 		{
 			/* do not exit with error code if comparison is not possible */
@@ -362,6 +573,35 @@ int main(int argc, char *argv[])
 			max_contexts = atoi(argv[1]);
 			args_used++;
 		}
+		else if(!strcmp(*argv, "--timing"))
+		{
+			/* measure the time spent in the library */
+			do_timing = true;
+		}
+		else if(!strcmp(*argv, "--batch"))
+		{
+			/* get the name of the file that lists the tests to run */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --batch takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			batch_filename = argv[1];
+			args_used++;
+		}
+		else if(!strcmp(*argv, "--jobs"))
+		{
+			/* get the number of worker processes in batch mode */
+			if(argc <= 1)
+			{
+				fprintf(stderr, "option --jobs takes one argument\n\n");
+				usage();
+				goto error;
+			}
+			jobs_nr = atoi(argv[1]);
+			args_used++;
+		}
 		else if(!strcmp(*argv, "--wlsb-width"))
 		{
 			/* get the width of the WLSB window the test should use */
@@ -401,6 +641,48 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	/* run the tests listed in the batch file if asked */
+	if(batch_filename != NULL)
+	{
+		if(cid_type_name != NULL || ofilename != NULL || cmp_filename != NULL ||
+		   rohc_size_ofilename != NULL || digest_filename != NULL ||
+		   digest_ofilename != NULL)
+		{
+			fprintf(stderr, "option --batch cannot be used with CID_TYPE, FLOW "
+			        "and the -o, -c, --rohc-size-output, --digest and "
+			        "--digest-output options\n\n");
+			usage();
+			goto error;
+		}
+#if HAVE_SYS_WAIT_H == 1 && HAVE_SYS_MMAN_H == 1
+		if(jobs_nr == 0)
+		{
+#if defined(_SC_NPROCESSORS_ONLN)
+			jobs_nr = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+			jobs_nr = min(max(jobs_nr, 1), (int) BATCH_JOBS_MAX_NR);
+		}
+		if(jobs_nr < 0 || (size_t) jobs_nr > BATCH_JOBS_MAX_NR)
+		{
+			fprintf(stderr, "invalid number of jobs %d: should be in range "
+			        "[1, %u]\n", jobs_nr, BATCH_JOBS_MAX_NR);
+			goto error;
+		}
+		status = run_batch(batch_filename, jobs_nr, no_comparison,
+		                   ignore_malformed, update_digests);
+#else
+		fprintf(stderr, "option --batch is not supported on this platform\n");
+#endif
+		goto error;
+	}
+	else if(update_digests)
+	{
+		fprintf(stderr, "option --update-digests requires option --batch, use "
+		        "--digest-output otherwise\n\n");
+		usage();
+		goto error;
+	}
+
 	/* check CID type */
 	if(cid_type_name == NULL)
 	{
@@ -462,7 +744,13 @@ int main(int argc, char *argv[])
 	                              no_comparison, ignore_malformed,
 	                              (const char *const *) src_filenames, src_filenames_nr,
 	                              ofilename, cmp_filename,
-	                              rohc_size_ofilename);
+	                              rohc_size_ofilename, digest_filename,
+	                              digest_ofilename);
+
+	if(do_timing)
+	{
+		print_timing(&timing);
+	}
 
 	trace("=== number of warnings/errors emitted by the library: %zu\n",
 	      nr_rohc_warnings);
@@ -493,6 +781,7 @@ static void usage(void)
 	        "                          of IP packets\n"
 	        "\n"
 	        "usage: test_non_regression [OPTIONS] CID_TYPE FLOW [FLOW]\n"
+	        "   or: test_non_regression [OPTIONS] --batch FILE\n"
 	        "\n"
 	        "with:\n"
 	        "  CID_TYPE                The type of CID to use among 'smallcid'\n"
@@ -507,6 +796,11 @@ static void usage(void)
 	        "                          (PCAP format)\n"
 	        "  -c FILE                 Compare the generated ROHC packets with the\n"
 	        "                          ROHC packets stored in FILE (PCAP format)\n"
+	        "  --digest FILE           Compare the digests of the generated ROHC\n"
+	        "                          packets with the ones stored in FILE, the\n"
+	        "                          packets of -c are compared on mismatch only\n"
+	        "  --digest-output FILE    Save the digests of the generated ROHC\n"
+	        "                          packets in FILE\n"
 	        "  --rohc-size-output FILE Save the sizes of ROHC packets in FILE\n"
 	        "  --max-contexts NUM      The maximum number of ROHC contexts to\n"
 	        "                          simultaneously use during the test\n"
@@ -514,6 +808,15 @@ static void usage(void)
 	        "  --no-comparison         Is comparison with ROHC reference optional for test\n"
 	        "  --ignore-malformed      Ignore malformed packets for test\n"
 	        "  --assert-on-error       Stop the test after the very first encountered error\n"
+	        "  --timing                Print the packet rates of the compression and\n"
+	        "                          the decompression\n"
+	        "  --batch FILE            Run the tests listed in FILE, one test per\n"
+	        "                          line with the fields CID_TYPE MAX_CONTEXTS\n"
+	        "                          WLSB_WIDTH FLOW COMPARE_FLOW [DIGEST]\n"
+	        "  --jobs NUM              The number of tests run at the same time in\n"
+	        "                          batch mode (default: number of CPUs)\n"
+	        "  --update-digests        Write the DIGEST files in batch mode instead\n"
+	        "                          of using them\n"
 	        "  --verbose               Run the test in verbose mode\n"
 	        "  --quiet                 Run the test in silent mode\n");
 }
@@ -788,6 +1091,9 @@ static void show_rohc_decomp_profile(const struct rohc_decomp *const decomp,
  * @param link_len_cmp     The length of the link layer header before ROHC data
  * @param size_output_file The name of the text file to output the sizes of
  *                         the ROHC packets
+ * @param digests          The digests to compare the ROHC packet with and/or
+ *                         to record the digests of the ROHC packet in,
+ *                         NULL if none
  * @return                 1 if the process is successful
  *                         0 if the decompressed packet doesn't match the
  *                         original one
@@ -810,6 +1116,7 @@ static int compress_decompress(struct rohc_comp *comp,
                                int cmp_size,
                                int link_len_cmp,
                                FILE *size_output_file,
+                               struct test_digests *const digests,
                                const struct rohc_buf feedback_send_by_me,
                                struct rohc_buf *const feedback_send_by_other)
 {
@@ -839,6 +1146,8 @@ static int compress_decompress(struct rohc_comp *comp,
 	struct rohc_buf rcvd_feedback =
 		rohc_buf_init_empty(rcvd_feedback_buffer, MAX_ROHC_SIZE);
 
+	uint64_t pkt_digest = 0;
+	uint64_t start_ns = 0;
 	int status = 1;
 	rohc_status_t ret;
 
@@ -925,7 +1234,17 @@ static int compress_decompress(struct rohc_comp *comp,
 
 	/* compress the IP packet into a ROHC packet */
 	trace("=== ROHC compression: start\n");
+	if(do_timing)
+	{
+		start_ns = test_get_ns();
+	}
 	ret = rohc_compress4(comp, ip_packet, &rohc_packet);
+	if(do_timing)
+	{
+		timing.comp_ns += test_get_ns() - start_ns;
+		timing.comp_pkts_nr++;
+		timing.comp_bytes += ip_packet.len;
+	}
 	if(ret != ROHC_STATUS_OK)
 	{
 		trace("=== ROHC compression: failure\n");
@@ -984,9 +1303,34 @@ static int compress_decompress(struct rohc_comp *comp,
 		        rohc_packet.len, last_packet_info.packet_type);
 	}
 
+	/* compute the digests of the ROHC packet and record them if asked */
+	if(digests != NULL)
+	{
+		pkt_digest = test_digest_hash(TEST_DIGEST_INIT, rohc_buf_data(rohc_packet),
+		                              rohc_packet.len);
+		digests->rolling = test_digest_roll(digests->rolling, pkt_digest);
+		if(digests->output != NULL)
+		{
+			fprintf(digests->output, "%016" PRIx64 " %016" PRIx64 "\n",
+			        pkt_digest, digests->rolling);
+		}
+	}
+
 	/* compare the ROHC packets with the ones given by the user if asked */
 	trace("=== ROHC comparison: start\n");
-	if(cmp_packet != NULL && cmp_size > link_len_cmp)
+	if(digests != NULL && digests->pkts != NULL)
+	{
+		if(!compare_digests(digests, pkt_digest, rohc_packet, no_comparison))
+		{
+			trace("=== ROHC comparison: failure\n");
+			status = 0;
+		}
+		else
+		{
+			trace("=== ROHC comparison: success\n");
+		}
+	}
+	else if(cmp_packet != NULL && cmp_size > link_len_cmp)
 	{
 		if(!compare_packets(cmp_packet + link_len_cmp, cmp_size - link_len_cmp,
 		                    rohc_buf_data(rohc_packet), rohc_packet.len))
@@ -1007,11 +1351,25 @@ static int compress_decompress(struct rohc_comp *comp,
 			status = 0;
 		}
 	}
+	if(digests != NULL)
+	{
+		digests->pkt_id++;
+	}
 
 	/* decompress the ROHC packet */
 	trace("=== ROHC decompression: start\n");
+	if(do_timing)
+	{
+		start_ns = test_get_ns();
+	}
 	ret = rohc_decompress3(decomp, rohc_packet, &decomp_packet,
 	                       &rcvd_feedback, feedback_send_by_other);
+	if(do_timing)
+	{
+		timing.decomp_ns += test_get_ns() - start_ns;
+		timing.decomp_pkts_nr++;
+		timing.decomp_bytes += decomp_packet.len;
+	}
 	if(ret != ROHC_STATUS_OK)
 	{
 		size_t i;
@@ -1088,6 +1446,12 @@ exit:
  *                             ROHC packets used for comparison
  * @param rohc_size_ofilename  The name of the text file to output the sizes
  *                             of the ROHC packets
+ * @param digest_filename      The name of the file that contains the digests
+ *                             of the ROHC packets used for comparison, the
+ *                             packets of \e cmp_filename are then compared
+ *                             on mismatch only
+ * @param digest_ofilename     The name of the file to output the digests of
+ *                             the ROHC packets
  * @return                     0 in case of success,
  *                             1 in case of failure,
  *                             77 if test is skipped
@@ -1101,20 +1465,26 @@ static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
                                 const size_t src_filenames_nr,
                                 char *ofilename,
                                 char *cmp_filename,
-                                const char *rohc_size_ofilename)
+                                const char *rohc_size_ofilename,
+                                const char *const digest_filename,
+                                const char *const digest_ofilename)
 {
-	char errbuf[PCAP_ERRBUF_SIZE];
 	size_t src_filenames_id = 0;
-	pcap_t *handle;
-	pcap_t *cmp_handle;
+	struct test_capture capture;
+	size_t pkt_id = 0;
+	struct test_capture cmp_capture;
+	bool with_cmp = false;
+	size_t cmp_pkt_id = 0;
+	pcap_t *dump_handle;
 	pcap_dumper_t *dumper;
-	size_t link_len_src = 0;
-	size_t link_len_cmp = 0;
 	struct pcap_pkthdr header;
 	struct pcap_pkthdr cmp_header;
 
 	FILE *rohc_size_output_file;
 
+	struct test_digests digests;
+	struct test_digests *digests_used;
+
 	const uint8_t *packet;
 	unsigned char *cmp_packet;
 
@@ -1141,43 +1511,100 @@ static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
 
 	trace("=== initialization:\n");
 
-	/* open the source dump file */
-	handle = open_pcap_file("source", src_filenames[0], &link_len_src);
-	if(handle == NULL)
+	/* load the source dump file */
+	if(!open_pcap_file("source", src_filenames[0], &capture))
 	{
 		status = 77; /* skip test */
 		goto error;
 	}
 
-	/* open the network dump file for ROHC storage if asked */
+	/* open the network dump file for ROHC storage if asked, with the link
+	 * layer of the source dump file */
 	if(ofilename != NULL)
 	{
-		dumper = pcap_dump_open(handle, ofilename);
+		int link_layer_type;
+
+		if(capture.link_type == TEST_CAPTURE_LINK_ETHER)
+		{
+			link_layer_type = DLT_EN10MB;
+		}
+		else if(capture.link_type == TEST_CAPTURE_LINK_LINUX_SLL)
+		{
+			link_layer_type = DLT_LINUX_SLL;
+		}
+		else if(capture.link_type == TEST_CAPTURE_LINK_NULL)
+		{
+			link_layer_type = DLT_NULL;
+		}
+		else /* TEST_CAPTURE_LINK_RAW */
+		{
+			link_layer_type = DLT_RAW;
+		}
+
+		dump_handle = pcap_open_dead(link_layer_type, capture.snaplen);
+		if(dump_handle == NULL)
+		{
+			trace("failed to open dump file '%s'\n", ofilename);
+			status = 77; /* skip test */
+			goto close_input;
+		}
+		dumper = pcap_dump_open(dump_handle, ofilename);
 		if(dumper == NULL)
 		{
-			trace("failed to open dump file '%s': %s\n", ofilename, errbuf);
+			trace("failed to open dump file '%s': %s\n", ofilename,
+			      pcap_geterr(dump_handle));
+			pcap_close(dump_handle);
 			status = 77; /* skip test */
 			goto close_input;
 		}
 	}
 	else
 	{
+		dump_handle = NULL;
 		dumper = NULL;
 	}
 
-	/* open the ROHC comparison dump file if asked */
-	if(cmp_filename != NULL)
+	/* load the digests of the ROHC packets if asked, the ROHC comparison
+	 * dump file is then loaded on mismatch only */
+	memset(&digests, 0, sizeof(struct test_digests));
+	digests.rolling = TEST_DIGEST_INIT;
+	if(digest_filename != NULL)
 	{
-		cmp_handle = open_pcap_file("comparison", cmp_filename, &link_len_cmp);
-		if(cmp_handle == NULL)
+		if(!load_digests(digest_filename, &digests))
 		{
 			status = 77; /* skip test */
 			goto close_output;
 		}
+		digests.cmp_filename = cmp_filename;
 	}
-	else
+
+	/* open the file in which to write the digests of the ROHC packets if
+	 * asked */
+	if(digest_ofilename != NULL)
+	{
+		digests.output = fopen(digest_ofilename, "w");
+		if(digests.output == NULL)
+		{
+			trace("failed to open file '%s' to output the digests of ROHC "
+			      "packets: %s (%d)\n", digest_ofilename, strerror(errno), errno);
+			status = 77; /* skip test */
+			goto free_digests;
+		}
+		fprintf(digests.output, "# ROHC packet digests: PACKET_HASH "
+		        "ROLLING_HASH, one ROHC packet per line\n");
+	}
+	digests_used = (digest_filename != NULL || digest_ofilename != NULL ?
+	                &digests : NULL);
+
+	/* load the ROHC comparison dump file if asked */
+	if(cmp_filename != NULL && digest_filename == NULL)
 	{
-		cmp_handle = NULL;
+		if(!open_pcap_file("comparison", cmp_filename, &cmp_capture))
+		{
+			status = 77; /* skip test */
+			goto free_digests;
+		}
+		with_cmp = true;
 	}
 
 	/* open the file in which to write the sizes of the ROHC packets if asked */
@@ -1233,15 +1660,17 @@ static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
 
 	/* for each packet in the dump */
 	counter = 0;
-	while(get_next_packet(&handle, src_filenames, src_filenames_nr,
-	                      &src_filenames_id, &header, &link_len_src, &packet))
+	while(get_next_packet(&capture, &pkt_id, src_filenames, src_filenames_nr,
+	                      &src_filenames_id, &header, &packet))
 	{
 		counter++;
 
 		/* get next ROHC packet from the comparison dump file if asked */
-		if(cmp_handle != NULL)
+		if(with_cmp && cmp_pkt_id < cmp_capture.pkts_nr)
 		{
-			cmp_packet = (unsigned char *) pcap_next(cmp_handle, &cmp_header);
+			cmp_packet = cmp_capture.pkts[cmp_pkt_id].data;
+			cmp_header.caplen = cmp_capture.pkts[cmp_pkt_id].caplen;
+			cmp_pkt_id++;
 		}
 		else
 		{
@@ -1251,11 +1680,12 @@ static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
 
 		/* compress & decompress from compressor 1 to decompressor 1 */
 		ret = compress_decompress(comp1, decomp1, comp2, 1, counter,
-		                          header, packet, link_len_src,
+		                          header, packet, capture.link_len,
 		                          no_comparison, ignore_malformed,
 		                          dumper,
-		                          cmp_packet, cmp_header.caplen, link_len_cmp,
-		                          rohc_size_output_file,
+		                          cmp_packet, cmp_header.caplen,
+		                          (with_cmp ? cmp_capture.link_len : 0),
+		                          rohc_size_output_file, digests_used,
 		                          feedback2_data, &feedback1_data);
 		if(ret == -1)
 		{
@@ -1283,9 +1713,11 @@ static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
 		rohc_buf_reset(&feedback2_data);
 
 		/* get next ROHC packet from the comparison dump file if asked */
-		if(cmp_handle != NULL)
+		if(with_cmp && cmp_pkt_id < cmp_capture.pkts_nr)
 		{
-			cmp_packet = (unsigned char *) pcap_next(cmp_handle, &cmp_header);
+			cmp_packet = cmp_capture.pkts[cmp_pkt_id].data;
+			cmp_header.caplen = cmp_capture.pkts[cmp_pkt_id].caplen;
+			cmp_pkt_id++;
 		}
 		else
 		{
@@ -1295,11 +1727,12 @@ static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
 
 		/* compress & decompress from compressor 2 to decompressor 2 */
 		ret = compress_decompress(comp2, decomp2, comp1, 2, counter,
-		                          header, packet, link_len_src,
+		                          header, packet, capture.link_len,
 		                          no_comparison, ignore_malformed,
 		                          dumper,
-		                          cmp_packet, cmp_header.caplen, link_len_cmp,
-		                          rohc_size_output_file,
+		                          cmp_packet, cmp_header.caplen,
+		                          (with_cmp ? cmp_capture.link_len : 0),
+		                          rohc_size_output_file, digests_used,
 		                          feedback1_data, &feedback2_data);
 		if(ret == -1)
 		{
@@ -1327,6 +1760,19 @@ static int test_comp_and_decomp(const rohc_cid_type_t cid_type,
 		rohc_buf_reset(&feedback1_data);
 	}
 
+	/* all the ROHC packets of the digests shall be generated */
+	if(digests.pkts != NULL && digests.pkt_id < digests.pkts_nr)
+	{
+		trace("=== ROHC comparison: only %zu ROHC packets generated, but %zu "
+		      "digests expected\n", digests.pkt_id, digests.pkts_nr);
+		nb_ref++;
+	}
+	if(digests_used != NULL)
+	{
+		trace("=== rolling digest of the %zu ROHC packets: %016" PRIx64 "\n",
+		      digests.pkt_id, digests.rolling);
+	}
+
 	/* show the compression/decompression results */
 	trace("=== summary:\n");
 	trace("===\tprocessed:            %d\n", 2 * counter);
@@ -1363,20 +1809,28 @@ close_output_size:
 		fclose(rohc_size_output_file);
 	}
 close_comparison:
-	if(cmp_handle != NULL)
+	if(with_cmp)
+	{
+		test_capture_unload(&cmp_capture);
+	}
+free_digests:
+	if(digests.output != NULL)
+	{
+		fclose(digests.output);
+	}
+	if(digests.is_cmp_loaded)
 	{
-		pcap_close(cmp_handle);
+		test_capture_unload(&digests.cmp_capture);
 	}
+	free(digests.pkts);
 close_output:
 	if(dumper != NULL)
 	{
 		pcap_dump_close(dumper);
+		pcap_close(dump_handle);
 	}
 close_input:
-	if(handle != NULL)
-	{
-		pcap_close(handle);
-	}
+	test_capture_unload(&capture);
 error:
 	return status;
 }
@@ -1610,117 +2064,84 @@ static bool rohc_comp_rtp_cb(const unsigned char *const ip __attribute__((unused
 
 
 /**
- * @brief Open a PCAP dump file
+ * @brief Load a PCAP dump file in memory
  *
  * @param descr          A description for the PCAP dump to open
  * @param filename       The file name of the PCAP dump file to open
- * @param[out] link_len  The length of the link layer detected in the PCAP dump
- *                       in case of success
- * @return               The handle on the opened PCAP dump file in case of success,
- *                       NULL in case of error
+ * @param[out] capture   The PCAP dump loaded in memory in case of success
+ * @return               true in case of success, false in case of error
  */
-static pcap_t * open_pcap_file(const char *const descr,
-                               const char *const filename,
-                               size_t *const link_len)
+static bool open_pcap_file(const char *const descr,
+                           const char *const filename,
+                           struct test_capture *const capture)
 {
-	char errbuf[PCAP_ERRBUF_SIZE];
-	int link_layer_type;
-	pcap_t *handle;
+	char errbuf[TEST_CAPTURE_ERRBUF_SIZE];
 
-	/* open the source dump file */
-	handle = pcap_open_offline(filename, errbuf);
-	if(handle == NULL)
+	/* load the dump file, the link layer is resolved once for all */
+	if(!test_capture_load(capture, filename, errbuf))
 	{
 		trace("failed to open the %s pcap file: %s\n", descr, errbuf);
-		goto error;
-	}
-
-	/* link layer in the source dump must be Ethernet */
-	link_layer_type = pcap_datalink(handle);
-	if(link_layer_type != DLT_EN10MB &&
-	   link_layer_type != DLT_LINUX_SLL &&
-	   link_layer_type != DLT_RAW &&
-	   link_layer_type != DLT_NULL)
-	{
-		trace("link layer type %d not supported in %s dump (supported = "
-		      "%d, %d, %d, %d)\n", link_layer_type, descr, DLT_EN10MB,
-		      DLT_LINUX_SLL, DLT_RAW, DLT_NULL);
-		goto close_input;
-	}
-
-	if(link_layer_type == DLT_EN10MB)
-	{
-		*link_len = ETHER_HDR_LEN;
-	}
-	else if(link_layer_type == DLT_LINUX_SLL)
-	{
-		*link_len = LINUX_COOKED_HDR_LEN;
-	}
-	else if(link_layer_type == DLT_NULL)
-	{
-		*link_len = BSD_LOOPBACK_HDR_LEN;
-	}
-	else /* DLT_RAW */
-	{
-		*link_len = 0;
+		return false;
 	}
 
-	return handle;
-
-close_input:
-	pcap_close(handle);
-error:
-	return NULL;
+	return true;
 }
 
 
 /**
  * @brief Get the next packet from source captures
  *
+ * The next source capture is loaded when all the packets of the current one
+ * were read.
+ *
+ * @param capture           The current source capture
+ * @param pkt_id            The index of the next packet in the current capture
+ * @param src_filenames     The names of the source captures
+ * @param src_filenames_nr  The number of source captures
+ * @param src_filenames_id  The index of the current source capture
+ * @param[out] header       The PCAP header of the next packet
+ * @param[out] packet       The next packet (link layer included)
+ * @return                  true if a packet was found, false if there is no
+ *                          more packet or in case of error
  */
-static bool get_next_packet(pcap_t **const pcap_handle,
+static bool get_next_packet(struct test_capture *const capture,
+                            size_t *const pkt_id,
                             const char *const src_filenames[],
                             const size_t src_filenames_nr,
                             size_t *const src_filenames_id,
                             struct pcap_pkthdr *const header,
-                            size_t *const link_len,
                             const uint8_t **const packet)
 {
-	assert((*pcap_handle) != NULL);
-
-	/* get the next packet in the current PCAP dump */
-	*packet = (const uint8_t *) pcap_next(*pcap_handle, header);
+	const struct test_capture_pkt *pkt;
 
 	/* if there is no more packet in the current PCAP dump file, try next one */
-	if((*packet) == NULL)
+	while((*pkt_id) >= capture->pkts_nr)
 	{
-		/* close current PCAP dump file */
-		pcap_close(*pcap_handle);
-		*pcap_handle = NULL;
-
 		/* is there another PCAP dump file? */
-		(*src_filenames_id)++;
-		if((*src_filenames_id) >= src_filenames_nr)
+		if(((*src_filenames_id) + 1) >= src_filenames_nr)
 		{
 			goto no_more_packet;
 		}
 
-		/* open next PCAP dump file */
-		*pcap_handle = open_pcap_file("source", src_filenames[*src_filenames_id],
-		                              link_len);
-		if((*pcap_handle) == NULL)
+		/* replace the current PCAP dump file by the next one */
+		test_capture_unload(capture);
+		(*src_filenames_id)++;
+		if(!open_pcap_file("source", src_filenames[*src_filenames_id], capture))
 		{
 			goto error;
 		}
-
-		/* get the next packet in the current PCAP dump */
-		*packet = (const uint8_t *) pcap_next(*pcap_handle, header);
-		if((*packet) == NULL)
-		{
-			goto no_more_packet;
-		}
+		*pkt_id = 0;
 	}
 
+	/* get the next packet in the current PCAP dump */
+	pkt = &(capture->pkts[*pkt_id]);
+	(*pkt_id)++;
+	header->ts.tv_sec = pkt->ts_sec;
+	header->ts.tv_usec = pkt->ts_usec;
+	header->caplen = pkt->caplen;
+	header->len = pkt->len;
+	*packet = pkt->data;
+
 	return true;
 
 no_more_packet:
@@ -1826,3 +2247,629 @@ skip:
 	return valid;
 }
 
+
+/**
+ * @brief Hash the given data with the FNV-1a hash of the digests
+ *
+ * @param hash  The hash of the previous data, \ref TEST_DIGEST_INIT if none
+ * @param data  The data to hash
+ * @param len   The length of the data to hash
+ * @return      The hash of the previous data and the given data
+ */
+static uint64_t test_digest_hash(uint64_t hash,
+                                 const uint8_t *const data,
+                                 const size_t len)
+{
+	size_t i;
+
+	for(i = 0; i < len; i++)
+	{
+		hash ^= data[i];
+		hash *= TEST_DIGEST_PRIME;
+	}
+
+	return hash;
+}
+
+
+/**
+ * @brief Add the hash of one ROHC packet to the rolling hash of a stream
+ *
+ * @param rolling  The rolling hash of the previous ROHC packets of the stream
+ * @param pkt      The hash of the next ROHC packet of the stream
+ * @return         The rolling hash of the stream up to the ROHC packet
+ */
+static uint64_t test_digest_roll(const uint64_t rolling, const uint64_t pkt)
+{
+	uint8_t pkt_bytes[sizeof(uint64_t)];
+	size_t i;
+
+	/* hash the bytes of the packet hash in the same order on all platforms */
+	for(i = 0; i < sizeof(uint64_t); i++)
+	{
+		pkt_bytes[i] = (pkt >> (i * 8)) & 0xff;
+	}
+
+	return test_digest_hash(rolling, pkt_bytes, sizeof(uint64_t));
+}
+
+
+/**
+ * @brief Load the digests of the ROHC packets from the given file
+ *
+ * The file lists the digests of one ROHC packet per line: the hash of the
+ * packet and the rolling hash of the stream up to the packet, in hexadecimal
+ * and separated by one space. Lines that start with # are ignored. The
+ * rolling hashes are checked, so that a corrupted file is detected.
+ *
+ * @param filename      The file that contains the digests
+ * @param[out] digests  The digests loaded, to be freed by the caller
+ * @return              true if the digests were successfully loaded,
+ *                      false otherwise
+ */
+static bool load_digests(const char *const filename,
+                         struct test_digests *const digests)
+{
+	size_t pkts_max_nr = 0;
+	size_t line_num = 0;
+	uint64_t rolling = TEST_DIGEST_INIT;
+	char line[100];
+	FILE *file;
+
+	digests->pkts = NULL;
+	digests->pkts_nr = 0;
+
+	file = fopen(filename, "r");
+	if(file == NULL)
+	{
+		trace("failed to open the digest file '%s': %s (%d)\n", filename,
+		      strerror(errno), errno);
+		goto error;
+	}
+
+	while(fgets(line, sizeof(line), file) != NULL)
+	{
+		struct test_digest *digest;
+
+		line_num++;
+		if(line[0] == '#' || line[0] == '\n' || line[0] == '\0')
+		{
+			continue;
+		}
+
+		/* grow the list of digests if needed */
+		if(digests->pkts_nr >= pkts_max_nr)
+		{
+			const size_t new_max_nr = max(pkts_max_nr * 2, 1024);
+			struct test_digest *const new_pkts =
+				realloc(digests->pkts, new_max_nr * sizeof(struct test_digest));
+			if(new_pkts == NULL)
+			{
+				trace("failed to allocate memory for %zu digests\n", new_max_nr);
+				goto free_digests;
+			}
+			digests->pkts = new_pkts;
+			pkts_max_nr = new_max_nr;
+		}
+		digest = &(digests->pkts[digests->pkts_nr]);
+
+		if(sscanf(line, "%" SCNx64 " %" SCNx64, &digest->pkt,
+		          &digest->rolling) != 2)
+		{
+			trace("%s:%zu: malformed digests, 2 hashes expected\n", filename,
+			      line_num);
+			goto free_digests;
+		}
+		rolling = test_digest_roll(rolling, digest->pkt);
+		if(digest->rolling != rolling)
+		{
+			trace("%s:%zu: rolling hash %016" PRIx64 " does not match the "
+			      "previous digests, %016" PRIx64 " expected\n", filename,
+			      line_num, digest->rolling, rolling);
+			goto free_digests;
+		}
+
+		digests->pkts_nr++;
+	}
+	if(ferror(file))
+	{
+		trace("failed to read the digest file '%s'\n", filename);
+		goto free_digests;
+	}
+
+	fclose(file);
+	return true;
+
+free_digests:
+	free(digests->pkts);
+	digests->pkts = NULL;
+	digests->pkts_nr = 0;
+	fclose(file);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Compare one ROHC packet with its digest
+ *
+ * If the digest does not match, the ROHC packet is compared with the
+ * reference ROHC packet, to print the differences. The capture of the
+ * reference ROHC packets is loaded on the first mismatch only.
+ *
+ * @param digests        The digests of the ROHC packets
+ * @param pkt_digest     The hash of the ROHC packet
+ * @param rohc_packet    The ROHC packet
+ * @param no_comparison  Whether comparison with ROHC reference is optional
+ * @return               Whether the ROHC packet matches its reference
+ */
+static bool compare_digests(struct test_digests *const digests,
+                            const uint64_t pkt_digest,
+                            const struct rohc_buf rohc_packet,
+                            const bool no_comparison)
+{
+	const struct test_capture_pkt *cmp_pkt;
+	size_t link_len_cmp;
+
+	if(digests->pkt_id >= digests->pkts_nr)
+	{
+		trace("no digest available for ROHC packet #%zu\n", digests->pkt_id + 1);
+		return no_comparison;
+	}
+	if(digests->pkts[digests->pkt_id].pkt == pkt_digest)
+	{
+		trace("digest %016" PRIx64 " of ROHC packet #%zu matches\n", pkt_digest,
+		      digests->pkt_id + 1);
+		return true;
+	}
+	trace("digest %016" PRIx64 " of ROHC packet #%zu does not match the "
+	      "expected digest %016" PRIx64 "\n", pkt_digest, digests->pkt_id + 1,
+	      digests->pkts[digests->pkt_id].pkt);
+
+	/* fall back to the full comparison with the reference ROHC packet */
+	if(digests->cmp_filename == NULL)
+	{
+		trace("no reference ROHC packet available (run with the -c option)\n");
+		return false;
+	}
+	if(!digests->is_cmp_loaded)
+	{
+		if(!open_pcap_file("comparison", digests->cmp_filename,
+		                   &digests->cmp_capture))
+		{
+			return false;
+		}
+		digests->is_cmp_loaded = true;
+	}
+	link_len_cmp = digests->cmp_capture.link_len;
+	if(digests->pkt_id >= digests->cmp_capture.pkts_nr ||
+	   digests->cmp_capture.pkts[digests->pkt_id].caplen <= link_len_cmp)
+	{
+		trace("no reference ROHC packet #%zu available\n", digests->pkt_id + 1);
+		return false;
+	}
+	cmp_pkt = &(digests->cmp_capture.pkts[digests->pkt_id]);
+
+	return compare_packets(cmp_pkt->data + link_len_cmp,
+	                       cmp_pkt->caplen - link_len_cmp,
+	                       rohc_buf_data(rohc_packet), rohc_packet.len);
+}
+
+
+/**
+ * @brief Get the current time of the monotonic clock
+ *
+ * @return  The current time (in ns)
+ */
+static inline uint64_t test_get_ns(void)
+{
+	struct timespec now;
+
+	if(clock_gettime(CLOCK_MONOTONIC, &now) != 0)
+	{
+		return 0;
+	}
+	return ((uint64_t) now.tv_sec) * 1000000000U + now.tv_nsec;
+}
+
+
+/**
+ * @brief Print the packet rates of the compression and the decompression
+ *
+ * @param test_timing  The time spent in the library and the packets
+ */
+static void print_timing(const struct test_timing *const test_timing)
+{
+	printf("=== timing: compression of %zu packets (%zu bytes) in %llu ns: "
+	       "%.0f packets/s\n", test_timing->comp_pkts_nr, test_timing->comp_bytes,
+	       (unsigned long long) test_timing->comp_ns,
+	       test_timing->comp_ns == 0 ? 0.0 :
+	       ((double) test_timing->comp_pkts_nr) * 1e9 / test_timing->comp_ns);
+	printf("=== timing: decompression of %zu packets (%zu bytes) in %llu ns: "
+	       "%.0f packets/s\n", test_timing->decomp_pkts_nr,
+	       test_timing->decomp_bytes, (unsigned long long) test_timing->decomp_ns,
+	       test_timing->decomp_ns == 0 ? 0.0 :
+	       ((double) test_timing->decomp_pkts_nr) * 1e9 / test_timing->decomp_ns);
+}
+
+
+#if HAVE_SYS_WAIT_H == 1 && HAVE_SYS_MMAN_H == 1
+
+/**
+ * @brief Run the tests listed in the given batch file
+ *
+ * Every test is run in its own worker process, \e jobs_nr tests are run at
+ * the same time. The workers write the results in memory shared with the
+ * main process. The result of every test is printed when the test ends, in
+ * the format of the Automake test harness.
+ *
+ * @param batch_filename    The file that lists the tests to run
+ * @param jobs_nr           The number of tests to run at the same time
+ * @param no_comparison     Whether comparison with ROHC reference is optional
+ * @param ignore_malformed  Whether malformed packets are ignored
+ * @return                  0 if all the tests succeeded or were skipped,
+ *                          1 otherwise
+ */
+static int run_batch(const char *const batch_filename,
+                     const size_t jobs_nr,
+                     const bool no_comparison,
+                     const bool ignore_malformed,
+                     const bool update_digests)
+{
+	struct batch_test *tests;
+	size_t tests_nr;
+	struct batch_result *results;
+	pid_t jobs[BATCH_JOBS_MAX_NR];
+	size_t jobs_tests[BATCH_JOBS_MAX_NR];
+	size_t running_nr = 0;
+	size_t next_test = 0;
+	size_t pass_nr = 0;
+	size_t skip_nr = 0;
+	size_t fail_nr = 0;
+	size_t i;
+	int status = 1;
+
+	assert(jobs_nr > 0);
+	assert(jobs_nr <= BATCH_JOBS_MAX_NR);
+
+	if(!load_batch(batch_filename, &tests, &tests_nr))
+	{
+		goto error;
+	}
+
+	/* the workers write their results in memory shared with the main
+	 * process */
+	results = mmap(NULL, max(tests_nr, 1) * sizeof(struct batch_result),
+	               PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if(results == MAP_FAILED)
+	{
+		fprintf(stderr, "failed to allocate shared memory for %zu results: "
+		        "%s (%d)\n", tests_nr, strerror(errno), errno);
+		goto free_tests;
+	}
+
+	while(next_test < tests_nr || running_nr > 0)
+	{
+		const struct batch_test *test;
+		const struct batch_result *result;
+		const char *result_descr;
+		int wstatus;
+		pid_t pid;
+
+		/* start another test if a worker is available */
+		if(next_test < tests_nr && running_nr < jobs_nr)
+		{
+			/* the test failed until the worker tells otherwise */
+			results[next_test].status = 1;
+
+			/* do not let the worker print the buffered output again */
+			fflush(stdout);
+			fflush(stderr);
+
+			pid = fork();
+			if(pid < 0)
+			{
+				fprintf(stderr, "failed to start worker process: %s (%d)\n",
+				        strerror(errno), errno);
+				break;
+			}
+			else if(pid == 0)
+			{
+				/* worker process: run one test, then report its result */
+				results[next_test].status =
+					run_batch_test(&tests[next_test], no_comparison, ignore_malformed,
+					               update_digests, &results[next_test].timing);
+				exit(results[next_test].status);
+			}
+			jobs[running_nr] = pid;
+			jobs_tests[running_nr] = next_test;
+			running_nr++;
+			next_test++;
+			continue;
+		}
+
+		/* wait for the end of one test */
+		pid = waitpid(-1, &wstatus, 0);
+		if(pid < 0)
+		{
+			if(errno == EINTR)
+			{
+				continue;
+			}
+			fprintf(stderr, "failed to wait for worker processes: %s (%d)\n",
+			        strerror(errno), errno);
+			break;
+		}
+		for(i = 0; i < running_nr && jobs[i] != pid; i++)
+		{
+		}
+		if(i >= running_nr)
+		{
+			continue;
+		}
+		test = &tests[jobs_tests[i]];
+		result = &results[jobs_tests[i]];
+		running_nr--;
+		jobs[i] = jobs[running_nr];
+		jobs_tests[i] = jobs_tests[running_nr];
+
+		/* the worker crashed if it did not exit normally */
+		if(!WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != result->status)
+		{
+			result_descr = "FAIL";
+			fail_nr++;
+		}
+		else if(result->status == 0)
+		{
+			result_descr = "PASS";
+			pass_nr++;
+		}
+		else if(result->status == 77)
+		{
+			result_descr = "SKIP";
+			skip_nr++;
+		}
+		else
+		{
+			result_descr = "FAIL";
+			fail_nr++;
+		}
+		printf("%s: %s %s maxcontexts%d wlsb%d", result_descr, test->src_filename,
+		       test->cid_type_name, test->max_contexts, test->wlsb_width);
+		if(do_timing && result->timing.comp_ns > 0 && result->timing.decomp_ns > 0)
+		{
+			printf(" (comp %.0f packets/s, decomp %.0f packets/s)",
+			       ((double) result->timing.comp_pkts_nr) * 1e9 /
+			       result->timing.comp_ns,
+			       ((double) result->timing.decomp_pkts_nr) * 1e9 /
+			       result->timing.decomp_ns);
+		}
+		printf("\n");
+	}
+
+	/* the tests that were not run failed */
+	fail_nr += tests_nr - (pass_nr + skip_nr + fail_nr + running_nr);
+
+	/* wait for the tests still running if the batch was aborted */
+	while(running_nr > 0)
+	{
+		if(waitpid(-1, NULL, 0) < 0 && errno != EINTR)
+		{
+			break;
+		}
+		running_nr--;
+		fail_nr++;
+	}
+
+	printf("# TOTAL: %zu\n", tests_nr);
+	printf("# PASS:  %zu\n", pass_nr);
+	printf("# SKIP:  %zu\n", skip_nr);
+	printf("# FAIL:  %zu\n", fail_nr);
+
+	if(fail_nr == 0)
+	{
+		status = 0;
+	}
+
+	munmap(results, max(tests_nr, 1) * sizeof(struct batch_result));
+free_tests:
+	free(tests);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Load the tests listed in the given batch file
+ *
+ * The file lists one test per line with the fields CID_TYPE MAX_CONTEXTS
+ * WLSB_WIDTH FLOW COMPARE_FLOW [DIGEST] separated by spaces. Empty lines and
+ * lines that start with # are ignored.
+ *
+ * @param batch_filename  The file that lists the tests to run
+ * @param[out] tests      The tests, to be freed by the caller
+ * @param[out] tests_nr   The number of tests
+ * @return                true if the batch file was successfully loaded,
+ *                        false otherwise
+ */
+static bool load_batch(const char *const batch_filename,
+                       struct batch_test **const tests,
+                       size_t *const tests_nr)
+{
+	char line[BATCH_PATH_MAX_LEN * 3 + 100];
+	size_t tests_max_nr = 0;
+	size_t line_num = 0;
+	FILE *batch_file;
+
+	*tests = NULL;
+	*tests_nr = 0;
+
+	batch_file = fopen(batch_filename, "r");
+	if(batch_file == NULL)
+	{
+		fprintf(stderr, "failed to open batch file '%s': %s (%d)\n",
+		        batch_filename, strerror(errno), errno);
+		goto error;
+	}
+
+	while(fgets(line, sizeof(line), batch_file) != NULL)
+	{
+		struct batch_test *test;
+		int ret;
+
+		line_num++;
+		if(line[0] == '#' || line[0] == '\n' || line[0] == '\0')
+		{
+			continue;
+		}
+
+		/* grow the list of tests if needed */
+		if((*tests_nr) >= tests_max_nr)
+		{
+			const size_t new_max_nr = max(tests_max_nr * 2, 64);
+			struct batch_test *const new_tests =
+				realloc(*tests, new_max_nr * sizeof(struct batch_test));
+			if(new_tests == NULL)
+			{
+				fprintf(stderr, "failed to allocate memory for %zu tests\n",
+				        new_max_nr);
+				goto free_tests;
+			}
+			*tests = new_tests;
+			tests_max_nr = new_max_nr;
+		}
+		test = &((*tests)[*tests_nr]);
+
+		test->digest_filename[0] = '\0';
+		ret = sscanf(line, "%9s %d %d %1023s %1023s %1023s", test->cid_type_name,
+		             &test->max_contexts, &test->wlsb_width, test->src_filename,
+		             test->cmp_filename, test->digest_filename);
+		if(ret != 5 && ret != 6)
+		{
+			fprintf(stderr, "%s:%zu: malformed test, 5 or 6 fields expected\n",
+			        batch_filename, line_num);
+			goto free_tests;
+		}
+		if(!strcmp(test->cid_type_name, "smallcid"))
+		{
+			test->cid_type = ROHC_SMALL_CID;
+			ret = (test->max_contexts >= 1 &&
+			       test->max_contexts <= (ROHC_SMALL_CID_MAX + 1));
+		}
+		else if(!strcmp(test->cid_type_name, "largecid"))
+		{
+			test->cid_type = ROHC_LARGE_CID;
+			ret = (test->max_contexts >= 1 &&
+			       test->max_contexts <= (ROHC_LARGE_CID_MAX + 1));
+		}
+		else
+		{
+			fprintf(stderr, "%s:%zu: invalid CID type '%s', only 'smallcid' "
+			        "and 'largecid' expected\n", batch_filename, line_num,
+			        test->cid_type_name);
+			goto free_tests;
+		}
+		if(!ret)
+		{
+			fprintf(stderr, "%s:%zu: invalid maximum number of ROHC contexts "
+			        "%d\n", batch_filename, line_num, test->max_contexts);
+			goto free_tests;
+		}
+		if(test->wlsb_width <= 0 ||
+		   (test->wlsb_width & (test->wlsb_width - 1)) != 0)
+		{
+			fprintf(stderr, "%s:%zu: invalid WLSB width %d: should be a "
+			        "positive power of two\n", batch_filename, line_num,
+			        test->wlsb_width);
+			goto free_tests;
+		}
+
+		(*tests_nr)++;
+	}
+	if(ferror(batch_file))
+	{
+		fprintf(stderr, "failed to read batch file '%s'\n", batch_filename);
+		goto free_tests;
+	}
+
+	fclose(batch_file);
+	return true;
+
+free_tests:
+	free(*tests);
+	*tests = NULL;
+	*tests_nr = 0;
+	fclose(batch_file);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Run one test of a batch in the current worker process
+ *
+ * The traces of the test are discarded: run the test alone to get them.
+ *
+ * @param test                The test to run
+ * @param no_comparison       Whether comparison with ROHC reference is
+ *                            optional
+ * @param ignore_malformed    Whether malformed packets are ignored
+ * @param update_digests      Whether the digests of the test shall be
+ *                            written instead of being used
+ * @param[out] test_timing    The time spent in the library during the test
+ * @return                    The exit code of the test
+ */
+static int run_batch_test(const struct batch_test *const test,
+                          const bool no_comparison,
+                          const bool ignore_malformed,
+                          const bool update_digests,
+                          struct test_timing *const test_timing)
+{
+	char src_filename[BATCH_PATH_MAX_LEN];
+	char cmp_filename[BATCH_PATH_MAX_LEN];
+	const char *src_filenames[SRC_FILENAMES_MAX_NR] = { src_filename };
+	const char *digest_filename = NULL;
+	const char *digest_ofilename = NULL;
+	int status;
+
+	/* the library warnings are printed on stdout even in quiet mode */
+	verbosity = VERBOSITY_NONE;
+	if(freopen("/dev/null", "w", stdout) == NULL)
+	{
+		return 1;
+	}
+	nr_rohc_warnings = 0;
+	memset(&timing, 0, sizeof(struct test_timing));
+
+	memcpy(src_filename, test->src_filename, BATCH_PATH_MAX_LEN);
+	memcpy(cmp_filename, test->cmp_filename, BATCH_PATH_MAX_LEN);
+
+	/* the ROHC packets are compared with the capture if the digests do not
+	 * exist yet or shall be updated */
+	if(test->digest_filename[0] != '\0')
+	{
+		if(update_digests)
+		{
+			digest_ofilename = test->digest_filename;
+		}
+		else if(access(test->digest_filename, R_OK) == 0)
+		{
+			digest_filename = test->digest_filename;
+		}
+	}
+
+	status = test_comp_and_decomp(test->cid_type, test->wlsb_width,
+	                              test->max_contexts, no_comparison,
+	                              ignore_malformed, src_filenames, 1, NULL,
+	                              cmp_filename, NULL, digest_filename,
+	                              digest_ofilename);
+	if(nr_rohc_warnings > 0)
+	{
+		status = 1;
+	}
+	memcpy(test_timing, &timing, sizeof(struct test_timing));
+
+	return status;
+}
+
+#endif /* HAVE_SYS_WAIT_H == 1 && HAVE_SYS_MMAN_H == 1 */
@@ -0,0 +1,63 @@
+#!/bin/sh
+#
+# Copyright 2016 Didier Barvaux
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#
+#
+# Run all the RFC3095 and RFC6846 non-regression tests in one batch of the
+# test_non_regression program, so that the tests run in parallel worker
+# processes instead of one process per test.
+#
+# One test is run for every ROHC reference capture found next to a
+# source.pcap capture. Every argument of the script is given to the
+# test_non_regression program, eg. --jobs NUM or --timing.
+#
+# The ROHC packets of one test are checked against the digests stored in
+# the .digest file next to the ROHC reference capture if it exists, the
+# reference capture is then loaded on mismatch only. The --update-digests
+# argument writes the .digest files.
+#
+# Environment variables:
+#    TEST_NON_REGRESSION   the path to the test_non_regression program
+#
+
+BASEDIR="${srcdir:-$( dirname "$0" )}"
+APP="${TEST_NON_REGRESSION:-$( dirname "$0" )/test_non_regression}"
+
+batch="$( mktemp )" || exit 1
+trap 'rm -f "${batch}"' EXIT
+
+# list the tests in the batch file: one test for every ROHC reference
+# capture, the maximum number of contexts 0 stands for the maximum CID,
+# the digests of the reference capture are used if they exist
+find "${BASEDIR}/rfc3095/inputs" "${BASEDIR}/rfc6846/inputs" \
+     -name 'rohc_maxcontexts*_wlsb*_*cid.pcap' | sort | \
+awk '{
+	dir = $0 ; sub(/\/[^\/]*$/, "", dir)
+	params = substr($0, length(dir) + 2)
+	sub(/^rohc_maxcontexts/, "", params) ; sub(/\.pcap$/, "", params)
+	split(params, fields, "_")
+	max_contexts = fields[1] ; sub(/^wlsb/, "", fields[2])
+	if(max_contexts == 0) {
+		max_contexts = (fields[3] == "smallcid" ? 16 : 16384)
+	}
+	if(system("test -f \"" dir "/source.pcap\"") == 0) {
+		digest = $0 ; sub(/\.pcap$/, ".digest", digest)
+		print fields[3], max_contexts, fields[2], dir "/source.pcap", $0, digest
+	}
+}' > "${batch}" || exit 1
+
+${CROSS_COMPILATION_EMULATOR} "${APP}" --batch "${batch}" "$@"
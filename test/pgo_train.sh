@@ -0,0 +1,73 @@
+#!/bin/sh
+#
+# Copyright 2016 Didier Barvaux
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2.1 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+#
+
+#
+# Run the training workload of the profile-guided optimizations (PGO).
+#
+# Do not use this script directly, run configure with --enable-rohc-tests
+# and --enable-app-performance, then build the library with the profiles
+# collected by the training workload:
+#   ./configure --enable-rohc-tests --enable-app-performance
+#   make pgo
+#
+# The training workload is made of:
+#  - all the RFC3095 and RFC6846 non-regression captures, that cover every
+#    profile and most packet types,
+#  - one stream of many mixed flows generated by rohc_gen_stream, compressed
+#    then decompressed with many contexts.
+#
+# The stream is generated with a fixed seed, so the training workload is the
+# same from one run to another.
+#
+# Environment variables:
+#    TEST_NON_REGRESSION     the path to the test_non_regression program
+#    ROHC_GEN_STREAM         the path to the rohc_gen_stream program
+#    ROHC_TEST_PERFORMANCE   the path to the rohc_test_performance program
+#    PGO_PACKETS             the number of packets of the generated stream
+#                            (default: 200000)
+#
+
+BASEDIR="$( dirname "$0" )"
+TEST_NON_REGRESSION="${TEST_NON_REGRESSION:-${BASEDIR}/non_regression/test_non_regression}"
+ROHC_GEN_STREAM="${ROHC_GEN_STREAM:-${BASEDIR}/../app/performance/rohc_gen_stream}"
+ROHC_TEST_PERFORMANCE="${ROHC_TEST_PERFORMANCE:-${BASEDIR}/../app/performance/rohc_test_performance}"
+PGO_PACKETS="${PGO_PACKETS:-200000}"
+
+STREAM_OPTS="--flows 4096 --mix rtp:6,udp:2,tcp:1,esp:1 --interleave random \
+             --churn 0.001 --burst 2 --payload-size 20-200 --seed 1"
+ROHC_OPTS="--cid-type largecid --max-contexts 1024"
+
+tmpdir="$( mktemp -d )" || exit 1
+trap 'rm -rf "${tmpdir}"' EXIT
+
+echo "train with the non-regression captures..." >&2
+TEST_NON_REGRESSION="${TEST_NON_REGRESSION}" \
+	"${BASEDIR}/non_regression/test_non_regression_parallel.sh" >/dev/null || exit 1
+
+echo "train with ${PGO_PACKETS} packets of many mixed flows..." >&2
+${CROSS_COMPILATION_EMULATOR} "${ROHC_GEN_STREAM}" ${STREAM_OPTS} \
+	uncomp ${PGO_PACKETS} "${tmpdir}/uncomp.pcap" >/dev/null || exit 1
+${CROSS_COMPILATION_EMULATOR} "${ROHC_GEN_STREAM}" ${STREAM_OPTS} ${ROHC_OPTS} \
+	comp ${PGO_PACKETS} "${tmpdir}/rohc.pcap" >/dev/null || exit 1
+${CROSS_COMPILATION_EMULATOR} "${ROHC_TEST_PERFORMANCE}" --max-contexts 1024 \
+	comp largecid "${tmpdir}/uncomp.pcap" >/dev/null || exit 1
+${CROSS_COMPILATION_EMULATOR} "${ROHC_TEST_PERFORMANCE}" --max-contexts 1024 \
+	decomp largecid "${tmpdir}/rohc.pcap" >/dev/null || exit 1
+
+echo "training workload completed" >&2
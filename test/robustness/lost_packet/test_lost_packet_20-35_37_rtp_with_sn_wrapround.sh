@@ -0,0 +1 @@
+test_lost_packet_repair.sh
\ No newline at end of file
@@ -0,0 +1,498 @@
+/*
+ * Copyright 2026 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   bench_malformed_rohc_packets.c
+ * @brief  Measure the worst-case work of the decompressor on malformed packets
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The ROHC packets of the given captures are decompressed again and again
+ * with deterministic mutations: bit flips, truncations, and long prefixes of
+ * padding bytes or of feedback items. Every call to the decompressor is
+ * timed, and the worst and the mean costs per byte of ROHC packet are
+ * reported. A worst case far above the mean reveals some input that makes
+ * the decompressor work much more than the size of the packet justifies.
+ */
+
+#include "config.h" /* for HAVE_*_H */
+#include "test.h"
+
+/* system includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <time.h>
+
+/* include for the PCAP library */
+#if HAVE_PCAP_PCAP_H == 1
+#  include <pcap/pcap.h>
+#elif HAVE_PCAP_H == 1
+#  include <pcap.h>
+#else
+#  error "pcap.h header not found, did you specified --enable-rohc-tests \
+for ./configure ? If yes, check configure output and config.log"
+#endif
+
+/* ROHC includes */
+#include <rohc.h>
+#include <rohc_decomp.h>
+
+
+/** The default number of mutation rounds over all the packets */
+#define BENCH_ROUNDS_DEFAULT  100U
+
+/** The number of bytes of the prefixes added in front of the packets */
+#define BENCH_PREFIX_LEN  256U
+
+/** The mutations applied to the packets of the captures */
+typedef enum
+{
+	BENCH_MUT_NONE          = 0, /**< The packet as captured */
+	BENCH_MUT_BIT_FLIP      = 1, /**< One to eight random bits flipped */
+	BENCH_MUT_TRUNCATE      = 2, /**< The packet truncated at a random byte */
+	BENCH_MUT_PADDING       = 3, /**< The packet behind many padding bytes */
+	BENCH_MUT_FEEDBACKS     = 4, /**< The packet behind many feedback items */
+	BENCH_MUT_MAX
+} bench_mut_t;
+
+/** The names of the mutations for the report */
+static const char *const bench_mut_descrs[BENCH_MUT_MAX] =
+{
+	[BENCH_MUT_NONE]      = "none",
+	[BENCH_MUT_BIT_FLIP]  = "bit flips",
+	[BENCH_MUT_TRUNCATE]  = "truncation",
+	[BENCH_MUT_PADDING]   = "padding prefix",
+	[BENCH_MUT_FEEDBACKS] = "feedback prefix",
+};
+
+/** One ROHC packet loaded from a capture */
+struct bench_pkt
+{
+	uint8_t *data;  /**< The bytes of the ROHC packet */
+	size_t len;     /**< The length of the ROHC packet */
+};
+
+/** The statistics of one mutation */
+struct bench_stats
+{
+	uint64_t calls_nr;     /**< The number of decompressions */
+	uint64_t failures_nr;  /**< The number of failed decompressions */
+	uint64_t bytes_nr;     /**< The number of decompressed bytes */
+	uint64_t cost_total;   /**< The cost of all the decompressions */
+	double worst_per_byte; /**< The worst cost per byte of one decompression */
+	size_t worst_len;      /**< The length of the packet of the worst cost */
+};
+
+
+/* prototypes of private functions */
+static void usage(void);
+static bool bench_load(const char *const filename,
+                       struct bench_pkt **const pkts,
+                       size_t *const pkts_nr)
+	__attribute__((warn_unused_result, nonnull(1, 2, 3)));
+static size_t bench_mutate(const struct bench_pkt *const pkt,
+                           const bench_mut_t mut,
+                           uint32_t *const seed,
+                           uint8_t *const out,
+                           const size_t out_max)
+	__attribute__((warn_unused_result, nonnull(1, 3, 4)));
+static uint32_t bench_rand(uint32_t *const seed)
+	__attribute__((warn_unused_result, nonnull(1)));
+static inline uint64_t bench_get_cost(void)
+	__attribute__((warn_unused_result));
+
+
+/**
+ * @brief Main function for the ROHC benchmark program
+ *
+ * @param argc The number of program arguments
+ * @param argv The program arguments
+ * @return     The unix return code:
+ *              \li 0 in case of success,
+ *              \li 1 in case of failure,
+ *              \li 77 in case benchmark is skipped
+ */
+int main(int argc, char *argv[])
+{
+	struct bench_stats stats[BENCH_MUT_MAX];
+	struct bench_pkt *pkts = NULL;
+	size_t pkts_nr = 0;
+	unsigned int rounds_nr = BENCH_ROUNDS_DEFAULT;
+	uint32_t seed = 0x5eed;
+	struct rohc_decomp *decomp;
+	int args_used;
+	int status = 1;
+	size_t i;
+
+	memset(stats, 0, sizeof(stats));
+
+	/* parse program arguments, print the help message in case of failure */
+	if(argc <= 1)
+	{
+		usage();
+		goto error;
+	}
+
+	for(argc--, argv++; argc > 0; argc -= args_used, argv += args_used)
+	{
+		args_used = 1;
+
+		if(!strcmp(*argv, "-h"))
+		{
+			usage();
+			goto error;
+		}
+		else if(!strcmp(*argv, "-n"))
+		{
+			if(argc <= 1 || atoi(argv[1]) <= 0)
+			{
+				fprintf(stderr, "option -n takes one positive argument\n\n");
+				usage();
+				goto error;
+			}
+			rounds_nr = atoi(argv[1]);
+			args_used++;
+		}
+		else if(!bench_load(*argv, &pkts, &pkts_nr))
+		{
+			status = 77; /* skip benchmark */
+			goto free_pkts;
+		}
+	}
+
+	if(pkts_nr == 0)
+	{
+		fprintf(stderr, "no ROHC packet loaded\n\n");
+		usage();
+		goto free_pkts;
+	}
+
+	/* create the decompressor, without traces to measure the library only */
+	decomp = rohc_decomp_new2(ROHC_LARGE_CID, ROHC_LARGE_CID_MAX, ROHC_O_MODE);
+	if(decomp == NULL)
+	{
+		fprintf(stderr, "cannot create the decompressor\n");
+		goto free_pkts;
+	}
+	if(!rohc_decomp_enable_profiles(decomp, ROHC_PROFILE_UNCOMPRESSED,
+	                                ROHC_PROFILE_UDP, ROHC_PROFILE_IP,
+	                                ROHC_PROFILE_UDPLITE, ROHC_PROFILE_RTP,
+	                                ROHC_PROFILE_ESP, ROHC_PROFILE_TCP, -1))
+	{
+		fprintf(stderr, "failed to enable the decompression profiles\n");
+		goto destroy_decomp;
+	}
+
+	/* decompress all the packets with every mutation, many times */
+	for(unsigned int round = 0; round < rounds_nr; round++)
+	{
+		for(i = 0; i < pkts_nr; i++)
+		{
+			for(bench_mut_t mut = BENCH_MUT_NONE; mut < BENCH_MUT_MAX; mut++)
+			{
+				uint8_t rohc_buffer[MAX_ROHC_SIZE];
+				uint8_t ip_buffer[MAX_ROHC_SIZE];
+				const struct rohc_ts arrival_time = { .sec = 0, .nsec = 0 };
+				const size_t len =
+					bench_mutate(&pkts[i], mut, &seed, rohc_buffer, MAX_ROHC_SIZE);
+				const struct rohc_buf rohc_packet =
+					rohc_buf_init_full(rohc_buffer, len, arrival_time);
+				struct rohc_buf ip_packet =
+					rohc_buf_init_empty(ip_buffer, MAX_ROHC_SIZE);
+				rohc_status_t ret;
+				uint64_t cost_start;
+				uint64_t cost;
+
+				if(len == 0)
+				{
+					continue;
+				}
+
+				cost_start = bench_get_cost();
+				ret = rohc_decompress3(decomp, rohc_packet, &ip_packet, NULL, NULL);
+				cost = bench_get_cost() - cost_start;
+
+				stats[mut].calls_nr++;
+				if(ret != ROHC_STATUS_OK)
+				{
+					stats[mut].failures_nr++;
+				}
+				stats[mut].bytes_nr += len;
+				stats[mut].cost_total += cost;
+				if(((double) cost) / len > stats[mut].worst_per_byte)
+				{
+					stats[mut].worst_per_byte = ((double) cost) / len;
+					stats[mut].worst_len = len;
+				}
+			}
+		}
+	}
+
+	/* print the report */
+#if defined(__x86_64__) || defined(__i386__)
+	printf("cost unit: CPU cycles\n");
+#else
+	printf("cost unit: nanoseconds\n");
+#endif
+	printf("%-16s %10s %10s %14s %14s %10s\n", "mutation", "calls",
+	       "failures", "mean/byte", "worst/byte", "worst len");
+	for(bench_mut_t mut = BENCH_MUT_NONE; mut < BENCH_MUT_MAX; mut++)
+	{
+		if(stats[mut].calls_nr == 0)
+		{
+			continue;
+		}
+		printf("%-16s %10llu %10llu %14.2f %14.2f %10zu\n", bench_mut_descrs[mut],
+		       (unsigned long long) stats[mut].calls_nr,
+		       (unsigned long long) stats[mut].failures_nr,
+		       ((double) stats[mut].cost_total) / stats[mut].bytes_nr,
+		       stats[mut].worst_per_byte, stats[mut].worst_len);
+	}
+
+	status = 0;
+
+destroy_decomp:
+	rohc_decomp_free(decomp);
+free_pkts:
+	for(i = 0; i < pkts_nr; i++)
+	{
+		free(pkts[i].data);
+	}
+	free(pkts);
+error:
+	return status;
+}
+
+
+/**
+ * @brief Print usage of the benchmark application
+ */
+static void usage(void)
+{
+	fprintf(stderr,
+	        "ROHC decompression benchmark: measure the worst-case work of the\n"
+	        "                              decompressor on malformed packets\n"
+	        "\n"
+	        "usage: bench_malformed_rohc_packets -h\n"
+	        "       bench_malformed_rohc_packets [-n ROUNDS] FLOW...\n"
+	        "\n"
+	        "with:\n"
+	        "  FLOW                The flows of Ethernet/ROHC frames to mutate\n"
+	        "                      and decompress (in PCAP format)\n"
+	        "\n"
+	        "options:\n"
+	        "  -h                  Print this usage and exit\n"
+	        "  -n ROUNDS           The number of mutation rounds over all the\n"
+	        "                      packets (default: %u)\n",
+	        BENCH_ROUNDS_DEFAULT);
+}
+
+
+/**
+ * @brief Load the ROHC packets of the given capture
+ *
+ * @param filename      The name of the PCAP file that contains the packets
+ * @param[in,out] pkts  The loaded packets, the new ones are appended
+ * @param[in,out] pkts_nr  The number of loaded packets
+ * @return              true if the capture was loaded, false otherwise
+ */
+static bool bench_load(const char *const filename,
+                       struct bench_pkt **const pkts,
+                       size_t *const pkts_nr)
+{
+	char errbuf[PCAP_ERRBUF_SIZE];
+	struct pcap_pkthdr header;
+	const unsigned char *packet;
+	pcap_t *handle;
+	int link_layer_type;
+	size_t link_len;
+
+	handle = pcap_open_offline(filename, errbuf);
+	if(handle == NULL)
+	{
+		fprintf(stderr, "failed to open the source pcap file: %s\n", errbuf);
+		goto error;
+	}
+
+	link_layer_type = pcap_datalink(handle);
+	if(link_layer_type == DLT_EN10MB)
+	{
+		link_len = ETHER_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_LINUX_SLL)
+	{
+		link_len = LINUX_COOKED_HDR_LEN;
+	}
+	else if(link_layer_type == DLT_RAW)
+	{
+		link_len = 0;
+	}
+	else
+	{
+		fprintf(stderr, "link layer type %d not supported in source dump "
+		        "'%s'\n", link_layer_type, filename);
+		goto close_input;
+	}
+
+	while((packet = pcap_next(handle, &header)) != NULL)
+	{
+		struct bench_pkt *new_pkts;
+
+		if(header.len <= link_len || header.len != header.caplen ||
+		   (header.len - link_len) > MAX_ROHC_SIZE)
+		{
+			continue;
+		}
+
+		new_pkts = realloc(*pkts, ((*pkts_nr) + 1) * sizeof(struct bench_pkt));
+		if(new_pkts == NULL)
+		{
+			fprintf(stderr, "failed to allocate memory for packets\n");
+			goto close_input;
+		}
+		*pkts = new_pkts;
+
+		(*pkts)[*pkts_nr].len = header.len - link_len;
+		(*pkts)[*pkts_nr].data = malloc((*pkts)[*pkts_nr].len);
+		if((*pkts)[*pkts_nr].data == NULL)
+		{
+			fprintf(stderr, "failed to allocate memory for packet\n");
+			goto close_input;
+		}
+		memcpy((*pkts)[*pkts_nr].data, packet + link_len, (*pkts)[*pkts_nr].len);
+		(*pkts_nr)++;
+	}
+
+	pcap_close(handle);
+	return true;
+
+close_input:
+	pcap_close(handle);
+error:
+	return false;
+}
+
+
+/**
+ * @brief Build a mutated copy of the given ROHC packet
+ *
+ * @param pkt       The ROHC packet to mutate
+ * @param mut       The mutation to apply
+ * @param seed      The state of the pseudo-random generator
+ * @param out       The buffer for the mutated packet
+ * @param out_max   The length of the buffer for the mutated packet
+ * @return          The length of the mutated packet,
+ *                  0 if the mutation cannot be applied to the packet
+ */
+static size_t bench_mutate(const struct bench_pkt *const pkt,
+                           const bench_mut_t mut,
+                           uint32_t *const seed,
+                           uint8_t *const out,
+                           const size_t out_max)
+{
+	size_t len = 0;
+	size_t i;
+
+	switch(mut)
+	{
+		case BENCH_MUT_NONE:
+			memcpy(out, pkt->data, pkt->len);
+			len = pkt->len;
+			break;
+		case BENCH_MUT_BIT_FLIP:
+		{
+			const size_t flips_nr = 1 + (bench_rand(seed) % 8);
+			memcpy(out, pkt->data, pkt->len);
+			len = pkt->len;
+			for(i = 0; i < flips_nr; i++)
+			{
+				const size_t bit = bench_rand(seed) % (len * 8);
+				out[bit / 8] ^= 1U << (bit % 8);
+			}
+			break;
+		}
+		case BENCH_MUT_TRUNCATE:
+			if(pkt->len > 1)
+			{
+				len = 1 + (bench_rand(seed) % (pkt->len - 1));
+				memcpy(out, pkt->data, len);
+			}
+			break;
+		case BENCH_MUT_PADDING:
+			if((BENCH_PREFIX_LEN + pkt->len) <= out_max)
+			{
+				memset(out, 0xe0, BENCH_PREFIX_LEN);
+				memcpy(out + BENCH_PREFIX_LEN, pkt->data, pkt->len);
+				len = BENCH_PREFIX_LEN + pkt->len;
+			}
+			break;
+		case BENCH_MUT_FEEDBACKS:
+			if((BENCH_PREFIX_LEN + pkt->len) <= out_max)
+			{
+				/* FEEDBACK-1 items of 2 bytes each */
+				for(i = 0; i < BENCH_PREFIX_LEN; i += 2)
+				{
+					out[i] = 0xf1;
+					out[i + 1] = bench_rand(seed) & 0xff;
+				}
+				memcpy(out + BENCH_PREFIX_LEN, pkt->data, pkt->len);
+				len = BENCH_PREFIX_LEN + pkt->len;
+			}
+			break;
+		default:
+			break;
+	}
+
+	return len;
+}
+
+
+/**
+ * @brief Get the next value of the deterministic pseudo-random generator
+ *
+ * @param seed  The state of the generator
+ * @return      The next pseudo-random value
+ */
+static uint32_t bench_rand(uint32_t *const seed)
+{
+	/* xorshift32 */
+	*seed ^= (*seed) << 13;
+	*seed ^= (*seed) >> 17;
+	*seed ^= (*seed) << 5;
+	return *seed;
+}
+
+
+/**
+ * @brief Get the current cost counter
+ *
+ * @return  The CPU cycle counter on x86, the monotonic clock in nanoseconds
+ *          on the other architectures
+ */
+static inline uint64_t bench_get_cost(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t) ts.tv_sec) * 1000000000U + ts.tv_nsec;
+#endif
+}
@@ -48,6 +48,10 @@
  *
  * At the end of the test, compressor A shall be in O-Mode. If not, feedback
  * data was somehow lost because of the compression failure at compressor B.
+ *
+ * The test is run twice: once with the feedback prepended to the output
+ * buffer by the application, once with the feedback registered on the
+ * compressor B with rohc_comp_piggyback_feedback().
  */
 
 #include "test.h"
@@ -79,7 +83,7 @@
 
 /* prototypes of private functions */
 static void usage(void);
-static int test_comp_and_decomp(void);
+static int test_comp_and_decomp(const bool use_piggyback_api);
 static void print_rohc_traces(void *const priv_ctxt,
                               const rohc_trace_level_t level,
                               const rohc_trace_entity_t entity,
@@ -120,7 +124,11 @@ int main(int argc, char *argv[])
 	}
 
 	/* test ROHC feedback handling */
-	status = test_comp_and_decomp();
+	status = test_comp_and_decomp(false);
+	if(status == 0)
+	{
+		status = test_comp_and_decomp(true);
+	}
 
 error:
 	return status;
@@ -147,10 +155,13 @@ static void usage(void)
  * @brief Test the way the ROHC library handles feedbacks being piggybacked
  *        when a compression error occurs
  *
- * @return  0 in case of success,
- *          1 in case of failure
+ * @param use_piggyback_api  Whether the feedback is registered on the
+ *                           compressor instead of being prepended to the
+ *                           output buffer
+ * @return                   0 in case of success,
+ *                           1 in case of failure
  */
-static int test_comp_and_decomp(void)
+static int test_comp_and_decomp(const bool use_piggyback_api)
 {
 	/* compressors and decompressors used during the test */
 	struct rohc_comp *compA;
@@ -357,8 +368,20 @@ static int test_comp_and_decomp(void)
 
 	/* piggyback the feedback to send along the ROHC packet that compressor B
 	 * is going to generate */
-	rohc_buf_append_buf(&rohc_packet, feedback_send);
-	rohc_buf_pull(&rohc_packet, feedback_send.len);
+	if(use_piggyback_api)
+	{
+		if(!rohc_comp_piggyback_feedback(compB, feedback_send))
+		{
+			fprintf(stderr, "failed to register the feedback to piggyback on "
+			        "compressor B\n");
+			goto destroy_decompB;
+		}
+	}
+	else
+	{
+		rohc_buf_append_buf(&rohc_packet, feedback_send);
+		rohc_buf_pull(&rohc_packet, feedback_send.len);
+	}
 
 	/* fail to compress the IP packet with the ROHC compressor B: compressor B
 	 * shall not change the piggybacked feedback data */
@@ -384,7 +407,13 @@ static int test_comp_and_decomp(void)
 	fprintf(stderr, "compression with compressor B is successful\n");
 
 	/* feedback was correctly piggybacked */
-	rohc_buf_push(&rohc_packet, feedback_send.len);
+	if(!use_piggyback_api)
+	{
+		rohc_buf_push(&rohc_packet, feedback_send.len);
+	}
+	assert(rohc_packet.len > feedback_send.len);
+	assert(memcmp(rohc_buf_data(rohc_packet), rohc_buf_data(feedback_send),
+	              feedback_send.len) == 0);
 	feedback_send.len = 0;
 
 	/* decompress the generated ROHC packet with the ROHC decompressor B:
@@ -0,0 +1,405 @@
+/*
+ * Copyright 2016 Didier Barvaux
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/**
+ * @file   test_capture.h
+ * @brief  Load a PCAP capture in memory for the test applications
+ * @author Didier Barvaux <didier@barvaux.org>
+ *
+ * The whole capture is mapped in memory (or read at once if the platform
+ * does not provide mmap), then the packet records are indexed once for all.
+ * The applications then iterate over the packets of the capture without any
+ * system call and without the libpcap.
+ *
+ * The packets are mapped privately and writable: the applications may
+ * modify them in place without modifying the capture file.
+ *
+ * Only the classic PCAP format is supported, with micro- or nanosecond
+ * timestamps and in both byte orders. The PCAPNG format is not supported.
+ */
+
+#ifndef ROHC_TEST_CAPTURE__H
+#define ROHC_TEST_CAPTURE__H
+
+#include "config.h" /* for HAVE_*_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#if HAVE_SYS_MMAN_H == 1
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+
+/** The size of the buffer for the error messages of the capture loader */
+#define TEST_CAPTURE_ERRBUF_SIZE  256U
+
+/** The length of the global header of a PCAP capture */
+#define TEST_CAPTURE_HDR_LEN  24U
+
+/** The length of the header of a packet record in a PCAP capture */
+#define TEST_CAPTURE_REC_HDR_LEN  16U
+
+
+/** The link layers supported by the capture loader */
+typedef enum
+{
+	TEST_CAPTURE_LINK_RAW       = 0, /**< Raw IP packets */
+	TEST_CAPTURE_LINK_ETHER     = 1, /**< Ethernet */
+	TEST_CAPTURE_LINK_LINUX_SLL = 2, /**< Linux Cooked Sockets */
+	TEST_CAPTURE_LINK_NULL      = 3, /**< BSD loopback encapsulation */
+} test_capture_link_t;
+
+
+/** One packet of a capture loaded in memory */
+struct test_capture_pkt
+{
+	uint8_t *data;     /**< The packet, link layer header included */
+	uint32_t caplen;   /**< The number of captured bytes */
+	uint32_t len;      /**< The length of the packet on the wire */
+	uint32_t ts_sec;   /**< The capture timestamp (seconds) */
+	uint32_t ts_usec;  /**< The capture timestamp (microseconds) */
+};
+
+
+/** A PCAP capture loaded in memory */
+struct test_capture
+{
+	uint8_t *buf;                    /**< The content of the capture file */
+	size_t buf_len;                  /**< The length of the capture file */
+	bool is_mapped;                  /**< Whether the file is mapped or read */
+
+	test_capture_link_t link_type;   /**< The link layer of the packets */
+	size_t link_len;                 /**< The length of the link layer header */
+	uint32_t link_type_pcap;         /**< The PCAP LINKTYPE_ of the capture */
+	uint32_t snaplen;                /**< The snapshot length of the capture */
+
+	struct test_capture_pkt *pkts;   /**< The index of the packets */
+	size_t pkts_nr;                  /**< The number of packets */
+};
+
+
+/**
+ * @brief Read a 32-bit field of the capture in host byte order
+ *
+ * @param data        The field to read, may be unaligned
+ * @param is_swapped  Whether the capture was written with the other byte order
+ * @return            The value of the field
+ */
+static inline uint32_t test_capture_get32(const uint8_t *const data,
+                                          const bool is_swapped)
+{
+	uint32_t value;
+
+	memcpy(&value, data, sizeof(uint32_t));
+	if(is_swapped)
+	{
+		value = ((value & 0x000000ffU) << 24) |
+		        ((value & 0x0000ff00U) <<  8) |
+		        ((value & 0x00ff0000U) >>  8) |
+		        ((value & 0xff000000U) >> 24);
+	}
+
+	return value;
+}
+
+
+/**
+ * @brief Map or read the content of the capture file in memory
+ *
+ * @param capture  The capture to load
+ * @param filename The name of the PCAP file
+ * @param errbuf   The buffer for the error message in case of failure
+ * @return         true in case of success, false otherwise
+ */
+static inline bool test_capture_read(struct test_capture *const capture,
+                                     const char *const filename,
+                                     char *const errbuf)
+{
+#if HAVE_SYS_MMAN_H == 1
+	struct stat file_stat;
+	void *map;
+	int fd;
+
+	fd = open(filename, O_RDONLY);
+	if(fd < 0)
+	{
+		snprintf(errbuf, TEST_CAPTURE_ERRBUF_SIZE, "%s: %s", filename,
+		         strerror(errno));
+		goto error;
+	}
+	if(fstat(fd, &file_stat) != 0)
+	{
+		snprintf(errbuf, TEST_CAPTURE_ERRBUF_SIZE, "%s: %s", filename,
+		         strerror(errno));
+		goto close_file;
+	}
+	if(file_stat.st_size < (off_t) TEST_CAPTURE_HDR_LEN)
+	{
+		snprintf(errbuf, TEST_CAPTURE_ERRBUF_SIZE, "%s: file too short for a "
+		         "PCAP capture (%lld bytes)", filename,
+		         (long long) file_stat.st_size);
+		goto close_file;
+	}
+
+	/* private mapping, so that the packets may be modified in place */
+	map = mmap(NULL, file_stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+	           fd, 0);
+	if(map == MAP_FAILED)
+	{
+		snprintf(errbuf, TEST_CAPTURE_ERRBUF_SIZE, "%s: failed to map the file "
+		         "in memory: %s", filename, strerror(errno));
+		goto close_file;
+	}
+	close(fd);
+
+	capture->buf = map;
+	capture->buf_len = file_stat.st_size;
+	capture->is_mapped = true;
+
+	return true;
+
+close_file:
+	close(fd);
+error:
+	return false;
+#else
+	FILE *file;
+	long file_len;
+
+	file = fopen(filename, "rb");
+	if(file == NULL)
+	{
+		snprintf(errbuf, TEST_CAPTURE_ERRBUF_SIZE, "%s: %s", filename,
+		         strerror(errno));
+		goto error;
+	}
+	if(fseek(file, 0, SEEK_END) != 0 || (file_len = ftell(file)) < 0 ||
+	   fseek(file, 0, SEEK_SET) != 0)
+	{
+		snprintf(errbuf, TEST_CAPTURE_ERRBUF_SIZE, "%s: %s", filename,
+		         strerror(errno));
+		goto close_file;
+	}
+	if(file_len < (long) TEST_CAPTURE_HDR_LEN)
+	{
+		snprintf(errbuf, TEST_CAPTURE_ERRBUF_SIZE, "%s: file too short for a "
+		         "PCAP capture (%ld bytes)", filename, file_len);
+		goto close_file;
+	}
+
+	capture->buf = malloc(file_len);
+	if(capture->buf == NULL)
+	{
+		snprintf(errbuf, TEST_CAPTURE_ERRBUF_SIZE, "%s: failed to allocate "
+		         "%ld bytes of memory", filename, file_len);
+		goto close_file;
+	}
+	if(fread(capture->buf, 1, file_len, file) != (size_t) file_len)
+	{
+		snprintf(errbuf, TEST_CAPTURE_ERRBUF_SIZE, "%s: failed to read the "
+		         "file", filename);
+		goto free_buf;
+	}
+	fclose(file);
+
+	capture->buf_len = file_len;
+	capture->is_mapped = false;
+
+	return true;
+
+free_buf:
+	free(capture->buf);
+	capture->buf = NULL;
+close_file:
+	fclose(file);
+error:
+	return false;
+#endif
+}
+
+
+/**
+ * @brief Release the memory of a capture loaded by \ref test_capture_load
+ *
+ * @param capture  The capture to unload
+ */
+static inline void test_capture_unload(struct test_capture *const capture)
+{
+	free(capture->pkts);
+	capture->pkts = NULL;
+	capture->pkts_nr = 0;
+
+	if(capture->buf != NULL)
+	{
+#if HAVE_SYS_MMAN_H == 1
+		if(capture->is_mapped)
+		{
+			munmap(capture->buf, capture->buf_len);
+		}
+		else
+#endif
+		{
+			free(capture->buf);
+		}
+		capture->buf = NULL;
+	}
+	capture->buf_len = 0;
+}
+
+
+/**
+ * @brief Load a PCAP capture in memory and index its packets
+ *
+ * The link layer of the capture is resolved once for all. A truncated last
+ * packet record ends the capture and the nanosecond timestamps are truncated
+ * to microseconds, like libpcap does.
+ *
+ * @param capture  The capture to load
+ * @param filename The name of the PCAP file
+ * @param errbuf   The buffer for the error message in case of failure,
+ *                 at least \ref TEST_CAPTURE_ERRBUF_SIZE bytes long
+ * @return         true in case of success, false otherwise
+ */
+static inline bool test_capture_load(struct test_capture *const capture,
+                                     const char *const filename,
+                                     char *const errbuf)
+{
+	bool is_swapped;
+	bool is_nsec;
+	uint32_t magic;
+	size_t offset;
+	size_t pkts_nr;
+	size_t i;
+
+	memset(capture, 0, sizeof(struct test_capture));
+
+	if(!test_capture_read(capture, filename, errbuf))
+	{
+		goto error;
+	}
+
+	/* the magic number gives the byte order and the timestamp precision */
+	magic = test_capture_get32(capture->buf, false);
+	if(magic == 0xa1b2c3d4U || magic == 0xa1b23c4dU)
+	{
+		is_swapped = false;
+		is_nsec = (magic == 0xa1b23c4dU);
+	}
+	else if(magic == 0xd4c3b2a1U || magic == 0x4d3cb2a1U)
+	{
+		is_swapped = true;
+		is_nsec = (magic == 0x4d3cb2a1U);
+	}
+	else
+	{
+		snprintf(errbuf, TEST_CAPTURE_ERRBUF_SIZE, "%s: unknown file format "
+		         "(magic 0x%08x), only PCAP captures are supported", filename,
+		         magic);
+		goto unload;
+	}
+	capture->snaplen = test_capture_get32(capture->buf + 16, is_swapped);
+
+	/* resolve the link layer once for all, the upper bits of the field may
+	 * contain the FCS length */
+	capture->link_type_pcap =
+		test_capture_get32(capture->buf + 20, is_swapped) & 0x03ffffffU;
+	switch(capture->link_type_pcap)
+	{
+		case 1: /* LINKTYPE_ETHERNET */
+			capture->link_type = TEST_CAPTURE_LINK_ETHER;
+			capture->link_len = 14;
+			break;
+		case 113: /* LINKTYPE_LINUX_SLL */
+			capture->link_type = TEST_CAPTURE_LINK_LINUX_SLL;
+			capture->link_len = 16;
+			break;
+		case 0: /* LINKTYPE_NULL */
+			capture->link_type = TEST_CAPTURE_LINK_NULL;
+			capture->link_len = 4;
+			break;
+		case 12: /* DLT_RAW of most platforms */
+		case 101: /* LINKTYPE_RAW */
+			capture->link_type = TEST_CAPTURE_LINK_RAW;
+			capture->link_len = 0;
+			break;
+		default:
+			snprintf(errbuf, TEST_CAPTURE_ERRBUF_SIZE, "%s: link layer type %u "
+			         "not supported", filename, capture->link_type_pcap);
+			goto unload;
+	}
+
+	/* count the complete packet records */
+	pkts_nr = 0;
+	offset = TEST_CAPTURE_HDR_LEN;
+	while((capture->buf_len - offset) >= TEST_CAPTURE_REC_HDR_LEN)
+	{
+		const uint32_t caplen =
+			test_capture_get32(capture->buf + offset + 8, is_swapped);
+
+		if((capture->buf_len - offset - TEST_CAPTURE_REC_HDR_LEN) < caplen)
+		{
+			break;
+		}
+		offset += TEST_CAPTURE_REC_HDR_LEN + caplen;
+		pkts_nr++;
+	}
+
+	/* build the index of the packets */
+	if(pkts_nr > 0)
+	{
+		capture->pkts = calloc(pkts_nr, sizeof(struct test_capture_pkt));
+		if(capture->pkts == NULL)
+		{
+			snprintf(errbuf, TEST_CAPTURE_ERRBUF_SIZE, "%s: failed to allocate "
+			         "the index of %zu packets", filename, pkts_nr);
+			goto unload;
+		}
+	}
+	offset = TEST_CAPTURE_HDR_LEN;
+	for(i = 0; i < pkts_nr; i++)
+	{
+		struct test_capture_pkt *const pkt = &(capture->pkts[i]);
+		const uint8_t *const rec_hdr = capture->buf + offset;
+		const uint32_t ts_frac = test_capture_get32(rec_hdr + 4, is_swapped);
+
+		pkt->ts_sec = test_capture_get32(rec_hdr, is_swapped);
+		pkt->ts_usec = (is_nsec ? ts_frac / 1000U : ts_frac);
+		pkt->caplen = test_capture_get32(rec_hdr + 8, is_swapped);
+		pkt->len = test_capture_get32(rec_hdr + 12, is_swapped);
+		pkt->data = capture->buf + offset + TEST_CAPTURE_REC_HDR_LEN;
+		offset += TEST_CAPTURE_REC_HDR_LEN + pkt->caplen;
+	}
+	capture->pkts_nr = pkts_nr;
+
+	return true;
+
+unload:
+	test_capture_unload(capture);
+error:
+	return false;
+}
+
+#endif
+